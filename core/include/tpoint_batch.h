@@ -0,0 +1,57 @@
+/*****************************************************************************
+ *
+ * tpoint_batch.h
+ *	  Multithreaded batch versions of the kernels on the segments of
+ *	  temporal points.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TPOINT_BATCH_H__
+#define __TPOINT_BATCH_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************************/
+
+/* Two synchronized segments of temporal points */
+typedef struct
+{
+	double		start1[3];		/* start point of the first segment */
+	double		end1[3];		/* end point of the first segment */
+	double		start2[3];		/* start point of the second segment */
+	double		end2[3];		/* end point of the second segment */
+	int64_t		lower;			/* start timestamp of both segments */
+	int64_t		upper;			/* end timestamp of both segments */
+} TPointSegmentPair;
+
+/* Result of the temporal dwithin of a pair of segments */
+typedef struct
+{
+	int			solutions;		/* result of tpoint_segment_dwithin */
+	int64_t		t1;				/* start of the solution period */
+	int64_t		t2;				/* end of the solution period */
+} TPointSegmentResult;
+
+/* Coordinates of a set of points, stored as one array per coordinate */
+typedef struct
+{
+	const double *x;			/* x coordinates */
+	const double *y;			/* y coordinates */
+	const double *z;			/* z coordinates, NULL for 2D points */
+} TPointCoords;
+
+extern void tpoint_batch_dwithin(const TPointSegmentPair *pairs, int count,
+	bool hasz, double d, TPointSegmentResult *results, int nthreads);
+extern void tpoint_batch_mindist(const TPointCoords *start1,
+	const TPointCoords *end1, const TPointCoords *start2,
+	const TPointCoords *end2, int count, double *results, int nthreads);
+
+/*****************************************************************************/
+
+#endif
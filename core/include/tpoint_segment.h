@@ -0,0 +1,35 @@
+/*****************************************************************************
+ *
+ * tpoint_segment.h
+ *	  Kernels on the segments of temporal points that do not depend on a
+ *	  PostgreSQL backend.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TPOINT_SEGMENT_H__
+#define __TPOINT_SEGMENT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************************/
+
+/* Result of tpoint_segment_dwithin for segments at a constant distance */
+#define TPOINT_SEGMENT_PARALLEL		(-1)
+
+extern int tpoint_segment_dwithin(const double *start1, const double *end1,
+	const double *start2, const double *end2, bool hasz, int64_t lower,
+	int64_t upper, double d, int64_t *t1, int64_t *t2);
+extern double tpoint_segment_mindist(const double *start1,
+	const double *end1, const double *start2, const double *end2, bool hasz);
+extern void tpoint_segment_lengths(const double *x, const double *y,
+	const double *z, int count, double *lengths);
+
+/*****************************************************************************/
+
+#endif
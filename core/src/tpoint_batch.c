@@ -0,0 +1,190 @@
+/*****************************************************************************
+ *
+ * tpoint_batch.c
+ *	  Multithreaded batch versions of the kernels on the segments of
+ *	  temporal points.
+ *
+ * A batch is split into chunks of consecutive elements. The threads of the
+ * batch take the next chunk from a shared atomic counter until there are no
+ * chunks left, so that threads that are given cheap chunks, e.g., pairs of
+ * segments that are never within the distance, process more of them. The
+ * kernels do not have any global state, so they can be called concurrently.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "tpoint_batch.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "tpoint_segment.h"
+
+/* Number of elements taken at once by a thread */
+#define BATCH_CHUNK		1024
+
+/*****************************************************************************
+ * Thread pool
+ *****************************************************************************/
+
+/*
+ * Run the function worker on the batch arg with nthreads threads, including
+ * the calling one, where the batch has count elements. The worker takes the
+ * chunks of the batch from its atomic counter. If some thread cannot be
+ * created the batch is completed by the other ones.
+ */
+static void
+tpoint_batch_run(void *(*worker)(void *), void *arg, int count, int nthreads)
+{
+	/* No more threads than chunks */
+	int nchunks = (count + BATCH_CHUNK - 1) / BATCH_CHUNK;
+	if (nthreads > nchunks)
+		nthreads = nchunks;
+	pthread_t *threads = nthreads > 1 ?
+		malloc(sizeof(pthread_t) * (nthreads - 1)) : NULL;
+	int started = 0;
+	if (threads != NULL)
+	{
+		for (int i = 0; i < nthreads - 1; i++)
+		{
+			if (pthread_create(&threads[started], NULL, worker, arg) == 0)
+				started++;
+		}
+	}
+	worker(arg);
+	for (int i = 0; i < started; i++)
+		pthread_join(threads[i], NULL);
+	free(threads);
+}
+
+/*****************************************************************************
+ * Temporal dwithin
+ *****************************************************************************/
+
+typedef struct
+{
+	const TPointSegmentPair *pairs;	/* input pairs of segments */
+	TPointSegmentResult *results;	/* output results */
+	int			count;				/* number of pairs */
+	bool		hasz;				/* the points have Z */
+	double		d;					/* distance */
+	atomic_int	next;				/* start of the next chunk to process */
+} DwithinBatch;
+
+static void *
+tpoint_batch_dwithin_worker(void *arg)
+{
+	DwithinBatch *batch = (DwithinBatch *) arg;
+	int start;
+	while ((start = atomic_fetch_add(&batch->next, BATCH_CHUNK)) < batch->count)
+	{
+		int end = start + BATCH_CHUNK < batch->count ?
+			start + BATCH_CHUNK : batch->count;
+		for (int i = start; i < end; i++)
+		{
+			const TPointSegmentPair *pair = &batch->pairs[i];
+			TPointSegmentResult *result = &batch->results[i];
+			result->solutions = tpoint_segment_dwithin(pair->start1,
+				pair->end1, pair->start2, pair->end2, batch->hasz,
+				pair->lower, pair->upper, batch->d, &result->t1, &result->t2);
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Compute the temporal dwithin of count pairs of segments into the array
+ * results using nthreads threads, including the calling one. The result of
+ * each pair is the one of tpoint_segment_dwithin, t1 and t2 are only set when
+ * there are solutions.
+ */
+void
+tpoint_batch_dwithin(const TPointSegmentPair *pairs, int count, bool hasz,
+	double d, TPointSegmentResult *results, int nthreads)
+{
+	DwithinBatch batch;
+	batch.pairs = pairs;
+	batch.results = results;
+	batch.count = count;
+	batch.hasz = hasz;
+	batch.d = d;
+	atomic_init(&batch.next, 0);
+	tpoint_batch_run(tpoint_batch_dwithin_worker, &batch, count, nthreads);
+}
+
+/*****************************************************************************
+ * Minimum distance
+ *****************************************************************************/
+
+typedef struct
+{
+	const TPointCoords *start1;	/* start points of the first segments */
+	const TPointCoords *end1;	/* end points of the first segments */
+	const TPointCoords *start2;	/* start points of the second segments */
+	const TPointCoords *end2;	/* end points of the second segments */
+	double	   *results;		/* output distances */
+	int			count;			/* number of pairs */
+	atomic_int	next;			/* start of the next chunk to process */
+} MindistBatch;
+
+static void
+tpoint_coords_get(const TPointCoords *coords, int i, double *point)
+{
+	point[0] = coords->x[i];
+	point[1] = coords->y[i];
+	point[2] = coords->z != NULL ? coords->z[i] : 0;
+}
+
+static void *
+tpoint_batch_mindist_worker(void *arg)
+{
+	MindistBatch *batch = (MindistBatch *) arg;
+	bool hasz = batch->start1->z != NULL;
+	int start;
+	while ((start = atomic_fetch_add(&batch->next, BATCH_CHUNK)) < batch->count)
+	{
+		int end = start + BATCH_CHUNK < batch->count ?
+			start + BATCH_CHUNK : batch->count;
+		for (int i = start; i < end; i++)
+		{
+			double start1[3], end1[3], start2[3], end2[3];
+			tpoint_coords_get(batch->start1, i, start1);
+			tpoint_coords_get(batch->end1, i, end1);
+			tpoint_coords_get(batch->start2, i, start2);
+			tpoint_coords_get(batch->end2, i, end2);
+			batch->results[i] = tpoint_segment_mindist(start1, end1,
+				start2, end2, hasz);
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Compute the minimum distance of count pairs of synchronized segments into
+ * the array results using nthreads threads, including the calling one. The
+ * i-th pair moves from start1[i] to end1[i] and from start2[i] to end2[i].
+ * The points are 2D if the z arrays are NULL, which must then be the case
+ * for the four sets of coordinates.
+ */
+void
+tpoint_batch_mindist(const TPointCoords *start1, const TPointCoords *end1,
+	const TPointCoords *start2, const TPointCoords *end2, int count,
+	double *results, int nthreads)
+{
+	MindistBatch batch;
+	batch.start1 = start1;
+	batch.end1 = end1;
+	batch.start2 = start2;
+	batch.end2 = end2;
+	batch.results = results;
+	batch.count = count;
+	atomic_init(&batch.next, 0);
+	tpoint_batch_run(tpoint_batch_mindist_worker, &batch, count, nthreads);
+}
+
+/*****************************************************************************/
@@ -0,0 +1,205 @@
+/*****************************************************************************
+ *
+ * tpoint_segment.c
+ *	  Kernels on the segments of temporal points that do not depend on a
+ *	  PostgreSQL backend.
+ *
+ * The functions in this file only use the C library. They take the
+ * coordinates of the points as arrays of doubles and the timestamps as
+ * 64-bit integers, which is the representation of TimestampTz, so that they
+ * can be used both by the extension and by programs that process temporal
+ * points outside of the database.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "tpoint_segment.h"
+
+#include <math.h>
+#include <stddef.h>
+
+/* Same tolerance as the EPSILON of the extension */
+#define SEGMENT_EPSILON		1.0E-06
+
+/*****************************************************************************
+ * Temporal dwithin
+ *****************************************************************************/
+
+/*
+ * Find the instants t1 and t2 during which two segments of temporal points
+ * that move linearly from start1 to end1 and from start2 to end2 during the
+ * period [lower, upper] are at distance at most d. The points have two
+ * coordinates, or three if hasz is true.
+ *
+ * Returns 0 if the segments are never within the distance, 1 if they are
+ * within the distance at the single instant t1, and 2 if they are within
+ * the distance during the period [t1, t2]. When the points move in the same
+ * direction at the same speed their distance is constant and the function
+ * returns TPOINT_SEGMENT_PARALLEL without setting t1 and t2. The caller then
+ * compares the distance between the start points with d, possibly with a
+ * geodetic distance function.
+ */
+int
+tpoint_segment_dwithin(const double *start1, const double *end1,
+	const double *start2, const double *end2, bool hasz, int64_t lower,
+	int64_t upper, double d, int64_t *t1, int64_t *t2)
+{
+	/* To reduce problems related to floating point arithmetic, lower and upper
+	   are shifted, respectively, to 0 and 1 before computing the solutions
+	   of the quadratic equation */
+	double duration = upper - lower;
+	/* The points move along each coordinate as
+	 * p1(t) = (end1 - start1) * t + start1
+	 * p2(t) = (end2 - start2) * t + start2
+	 * so that the square of the distance between them is a * t^2 + b * t + c
+	 * where the coefficients are summed over the coordinates */
+	int dims = hasz ? 3 : 2;
+	double sa = 0, sb = 0, sc = 0;
+	for (int i = 0; i < dims; i++)
+	{
+		double a1 = end1[i] - start1[i];
+		double c1 = start1[i];
+		double a2 = end2[i] - start2[i];
+		double c2 = start2[i];
+		sa += (a1 - a2) * (a1 - a2);
+		sb += 2 * (a1 - a2) * (c1 - c2);
+		sc += (c1 - c2) * (c1 - c2);
+	}
+	/* distance function = d */
+	long double a = sa;
+	long double b = sb;
+	long double c = sc - (d * d);
+	/* They are parallel, moving in the same direction at the same speed */
+	if (a == 0)
+		return TPOINT_SEGMENT_PARALLEL;
+	/* Solving the quadratic equation for distance = d */
+	long double discriminant = b * b - 4 * a * c;
+
+	/* One solution */
+	if (discriminant == 0)
+	{
+		long double t5 = (-1 * b) / (2 * a);
+		if (t5 < 0.0 || t5 > 1.0)
+			return 0;
+		*t1 = lower + (long) (t5 * duration);
+		return 1;
+	}
+	/* No solution */
+	if (discriminant < 0)
+		return 0;
+	/* At most two solutions depending on whether they are within the time
+	 * interval. A mixture of quadratic formula and Viète formula is applied
+	 * to improve precision */
+	long double t5, t6;
+	if (b >= 0)
+	{
+		t5 = (-1 * b - sqrtl(discriminant)) / (2 * a);
+		t6 = (2 * c ) / (-1 * b - sqrtl(discriminant));
+	}
+	else
+	{
+		t5 = (2 * c ) / (-1 * b + sqrtl(discriminant));
+		t6 = (-1 * b + sqrtl(discriminant)) / (2 * a);
+	}
+
+	/* If the two intervals do not intersect */
+	if (0.0 > t6 || t5 > 1.0)
+		return 0;
+	/* Compute the intersection of the two intervals */
+	long double t7 = t5 > 0.0 ? t5 : 0.0;
+	long double t8 = t6 < 1.0 ? t6 : 1.0;
+	*t1 = lower + (long) (t7 * duration);
+	if (fabsl(t7 - t8) < SEGMENT_EPSILON)
+		return 1;
+	*t2 = lower + (long) (t8 * duration);
+	return 2;
+}
+
+/*****************************************************************************
+ * Minimum distance
+ *****************************************************************************/
+
+/*
+ * Return the minimum distance between two segments of temporal points that
+ * move linearly and synchronously from start1 to end1 and from start2 to
+ * end2. The points have two coordinates, or three if hasz is true.
+ *
+ * The position of the second point relative to the first one moves linearly
+ * from start1 - start2 by the relative velocity (end1 - start1) -
+ * (end2 - start2), so that the square of their distance is a * t^2 + b * t + c
+ * for t in [0, 1]. Its minimum is at t = -b / (2 * a) clamped to [0, 1].
+ */
+double
+tpoint_segment_mindist(const double *start1, const double *end1,
+	const double *start2, const double *end2, bool hasz)
+{
+	int dims = hasz ? 3 : 2;
+	double a = 0, b = 0;
+	for (int i = 0; i < dims; i++)
+	{
+		double p = start1[i] - start2[i];
+		double v = (end1[i] - start1[i]) - (end2[i] - start2[i]);
+		a += v * v;
+		b += 2 * v * p;
+	}
+	double t = 0;
+	/* When a is 0 the points move in parallel and the distance is constant */
+	if (a > 0)
+	{
+		t = -b / (2 * a);
+		if (t < 0)
+			t = 0;
+		else if (t > 1)
+			t = 1;
+	}
+	double dist = 0;
+	for (int i = 0; i < dims; i++)
+	{
+		double p = start1[i] - start2[i];
+		double v = (end1[i] - start1[i]) - (end2[i] - start2[i]);
+		double q = p + v * t;
+		dist += q * q;
+	}
+	return sqrt(dist);
+}
+
+/*****************************************************************************
+ * Length
+ *****************************************************************************/
+
+/*
+ * Compute the lengths of the count - 1 segments of the polyline whose
+ * vertices have the coordinates given in the arrays x, y, and z into the
+ * array lengths. The array z is NULL for 2D points. The lengths are computed
+ * in one pass over the arrays without branches.
+ */
+void
+tpoint_segment_lengths(const double *x, const double *y, const double *z,
+	int count, double *lengths)
+{
+	if (z != NULL)
+	{
+		for (int i = 0; i < count - 1; i++)
+		{
+			double dx = x[i + 1] - x[i];
+			double dy = y[i + 1] - y[i];
+			double dz = z[i + 1] - z[i];
+			lengths[i] = sqrt((dx * dx) + (dy * dy) + (dz * dz));
+		}
+	}
+	else
+	{
+		for (int i = 0; i < count - 1; i++)
+		{
+			double dx = x[i + 1] - x[i];
+			double dy = y[i + 1] - y[i];
+			lengths[i] = sqrt((dx * dx) + (dy * dy));
+		}
+	}
+}
+
+/*****************************************************************************/
@@ -0,0 +1,173 @@
+/*****************************************************************************
+ *
+ * tpoint_batch_test.c
+ *	  Tests of the multithreaded batch kernels on temporal points.
+ *
+ * The results computed with several threads must be identical to those
+ * computed pair by pair with the serial kernel. The minimum distances are
+ * also compared with distances sampled along the segments and with the
+ * results of tdwithin.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tpoint_batch.h"
+#include "tpoint_segment.h"
+
+#define COUNT		100000
+#define DAY			INT64_C(86400000000)
+
+/* Deterministic pseudo-random coordinates in [0, 10) */
+static unsigned int seed = 1;
+
+static double
+random_coord(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return (double) ((seed >> 16) & 0x7FFF) / 0x8000 * 10;
+}
+
+static int
+test_dwithin(bool hasz, int nthreads)
+{
+	TPointSegmentPair *pairs = malloc(sizeof(TPointSegmentPair) * COUNT);
+	TPointSegmentResult *results = malloc(sizeof(TPointSegmentResult) * COUNT);
+	for (int i = 0; i < COUNT; i++)
+	{
+		TPointSegmentPair *pair = &pairs[i];
+		for (int j = 0; j < 3; j++)
+		{
+			pair->start1[j] = random_coord();
+			pair->end1[j] = random_coord();
+			pair->start2[j] = random_coord();
+			/* Some pairs move in parallel */
+			pair->end2[j] = (i % 100 == 0) ?
+				pair->start2[j] + pair->end1[j] - pair->start1[j] :
+				random_coord();
+		}
+		pair->lower = i * DAY;
+		pair->upper = (i + 1) * DAY;
+	}
+	tpoint_batch_dwithin(pairs, COUNT, hasz, 2.5, results, nthreads);
+	int failures = 0;
+	for (int i = 0; i < COUNT; i++)
+	{
+		TPointSegmentPair *pair = &pairs[i];
+		int64_t t1, t2;
+		int solutions = tpoint_segment_dwithin(pair->start1, pair->end1,
+			pair->start2, pair->end2, hasz, pair->lower, pair->upper, 2.5,
+			&t1, &t2);
+		if (solutions != results[i].solutions ||
+			(solutions > 0 && t1 != results[i].t1) ||
+			(solutions > 1 && t2 != results[i].t2))
+			failures++;
+	}
+	if (failures > 0)
+		fprintf(stderr, "FAILED: dwithin %s with %d threads, %d pairs differ\n",
+			hasz ? "3D" : "2D", nthreads, failures);
+	free(pairs);
+	free(results);
+	return failures;
+}
+
+/* Minimal distance between the points of a pair sampled at 1001 instants */
+static double
+sampled_mindist(const double *start1, const double *end1,
+	const double *start2, const double *end2, bool hasz)
+{
+	int dims = hasz ? 3 : 2;
+	double result = INFINITY;
+	for (int k = 0; k <= 1000; k++)
+	{
+		double t = k / 1000.0, dist = 0;
+		for (int j = 0; j < dims; j++)
+		{
+			double p1 = start1[j] + (end1[j] - start1[j]) * t;
+			double p2 = start2[j] + (end2[j] - start2[j]) * t;
+			dist += (p1 - p2) * (p1 - p2);
+		}
+		if (sqrt(dist) < result)
+			result = sqrt(dist);
+	}
+	return result;
+}
+
+static int
+test_mindist(bool hasz, int nthreads)
+{
+	/* One array per coordinate of each of the four sets of points */
+	double *coords = malloc(sizeof(double) * COUNT * 12);
+	TPointCoords sets[4];
+	for (int k = 0; k < 4; k++)
+	{
+		sets[k].x = coords + COUNT * (3 * k);
+		sets[k].y = coords + COUNT * (3 * k + 1);
+		sets[k].z = hasz ? coords + COUNT * (3 * k + 2) : NULL;
+	}
+	for (int i = 0; i < COUNT * 12; i++)
+		coords[i] = random_coord();
+	double *results = malloc(sizeof(double) * COUNT);
+	tpoint_batch_mindist(&sets[0], &sets[1], &sets[2], &sets[3], COUNT,
+		results, nthreads);
+	int failures = 0;
+	for (int i = 0; i < COUNT; i++)
+	{
+		double p[4][3];
+		for (int k = 0; k < 4; k++)
+		{
+			p[k][0] = sets[k].x[i];
+			p[k][1] = sets[k].y[i];
+			p[k][2] = coords[COUNT * (3 * k + 2) + i];
+		}
+		double dist = tpoint_segment_mindist(p[0], p[1], p[2], p[3], hasz);
+		if (dist != results[i])
+		{
+			failures++;
+			continue;
+		}
+		/* The sampled distances are never smaller and are close to it */
+		if (i % 100 == 0)
+		{
+			double sampled = sampled_mindist(p[0], p[1], p[2], p[3], hasz);
+			if (sampled < dist - 1e-9 || sampled > dist + 0.05)
+				failures++;
+		}
+		/* The points are within a distance if and only if it is at least
+		 * the minimum distance, apart from rounding */
+		int64_t t1, t2;
+		int solutions = tpoint_segment_dwithin(p[0], p[1], p[2], p[3], hasz,
+			0, DAY, 2.5, &t1, &t2);
+		if ((dist < 2.5 - 1e-6 && solutions == 0) ||
+			(dist > 2.5 + 1e-6 && solutions > 0))
+			failures++;
+	}
+	if (failures > 0)
+		fprintf(stderr, "FAILED: mindist %s with %d threads, %d pairs differ\n",
+			hasz ? "3D" : "2D", nthreads, failures);
+	free(coords);
+	free(results);
+	return failures;
+}
+
+int
+main(void)
+{
+	int failures = 0;
+	int nthreads[] = {1, 2, 8};
+	for (int i = 0; i < 3; i++)
+	{
+		failures += test_dwithin(false, nthreads[i]);
+		failures += test_dwithin(true, nthreads[i]);
+		failures += test_mindist(false, nthreads[i]);
+		failures += test_mindist(true, nthreads[i]);
+	}
+	return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,129 @@
+/*****************************************************************************
+ *
+ * tpoint_segment_test.c
+ *	  Tests of the kernels on the segments of temporal points.
+ *
+ * The cases of tdwithin are those documented in tpoint_tempspatialrels.c,
+ * with the timestamps expressed in days from 2000-01-01.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tpoint_segment.h"
+
+#define DAY		INT64_C(86400000000)
+
+static int failures = 0;
+
+static void
+check(bool cond, const char *what)
+{
+	if (! cond)
+	{
+		fprintf(stderr, "FAILED: %s\n", what);
+		failures++;
+	}
+}
+
+static void
+test_dwithin(void)
+{
+	int64_t t1, t2;
+	int n;
+
+	/* The solution period overlaps the start of the segment */
+	double a1[] = {3, 3}, b1[] = {5, 5}, a2[] = {3, 3}, b2[] = {5, 3};
+	n = tpoint_segment_dwithin(a1, b1, a2, b2, false, 2 * DAY, 4 * DAY, 1,
+		&t1, &t2);
+	check(n == 2 && t1 == 2 * DAY && t2 == 3 * DAY, "dwithin at start");
+
+	/* The solution period overlaps the end of the segment */
+	double c1[] = {1, 1}, d1[] = {3, 3}, c2[] = {1, 3}, d2[] = {3, 3};
+	n = tpoint_segment_dwithin(c1, d1, c2, d2, false, 0, 2 * DAY, 1,
+		&t1, &t2);
+	check(n == 2 && t1 == DAY && t2 == 2 * DAY, "dwithin at end");
+
+	/* The solution period is a single instant */
+	double e1[] = {4, 4}, f1[] = {5, 5}, e2[] = {4, 3}, f2[] = {5, 3};
+	n = tpoint_segment_dwithin(e1, f1, e2, f2, false, 3 * DAY, 4 * DAY, 1,
+		&t1, &t2);
+	check(n == 1 && t1 == 3 * DAY, "dwithin at an instant");
+
+	/* The segments are never within the distance */
+	double g1[] = {0, 0}, h1[] = {1, 0}, g2[] = {0, 5}, h2[] = {1, 6};
+	n = tpoint_segment_dwithin(g1, h1, g2, h2, false, 0, DAY, 1, &t1, &t2);
+	check(n == 0, "dwithin far apart");
+
+	/* Segments at a constant distance */
+	double i1[] = {0, 0}, j1[] = {2, 0}, i2[] = {0, 1}, j2[] = {2, 1};
+	n = tpoint_segment_dwithin(i1, j1, i2, j2, false, 0, DAY, 1, &t1, &t2);
+	check(n == TPOINT_SEGMENT_PARALLEL, "dwithin parallel");
+
+	/* The third coordinate is taken into account */
+	double k1[] = {0, 0, 0}, l1[] = {2, 0, 0}, k2[] = {2, 0, 0.5},
+		l2[] = {0, 0, 0.5};
+	n = tpoint_segment_dwithin(k1, l1, k2, l2, true, 0, DAY, 1, &t1, &t2);
+	check(n == 2 && llabs(t1 - DAY / 2 + (int64_t) (sqrt(0.75) / 4 * DAY)) <= 1 &&
+		llabs(t2 - DAY / 2 - (int64_t) (sqrt(0.75) / 4 * DAY)) <= 1,
+		"dwithin 3D");
+	n = tpoint_segment_dwithin(k1, l1, k2, l2, true, 0, DAY, 0.25, &t1, &t2);
+	check(n == 0, "dwithin 3D beyond");
+}
+
+static void
+test_mindist(void)
+{
+	/* The points cross each other */
+	double a1[] = {0, 0}, b1[] = {2, 0}, a2[] = {2, 0}, b2[] = {0, 0};
+	check(tpoint_segment_mindist(a1, b1, a2, b2, false) == 0, "mindist cross");
+
+	/* The minimum is inside the segments */
+	double c1[] = {0, 0}, d1[] = {2, 0}, c2[] = {2, 1}, d2[] = {0, 1};
+	check(tpoint_segment_mindist(c1, d1, c2, d2, false) == 1,
+		"mindist inside");
+
+	/* The minimum is at the end of the segments */
+	double e1[] = {0, 0}, f1[] = {1, 0}, e2[] = {4, 4}, f2[] = {4, 0};
+	check(tpoint_segment_mindist(e1, f1, e2, f2, false) == 3, "mindist end");
+
+	/* Segments at a constant distance */
+	double g1[] = {0, 0}, h1[] = {2, 0}, g2[] = {0, 1}, h2[] = {2, 1};
+	check(tpoint_segment_mindist(g1, h1, g2, h2, false) == 1,
+		"mindist parallel");
+
+	/* The third coordinate is taken into account */
+	double k1[] = {0, 0, 0}, l1[] = {2, 0, 0}, k2[] = {2, 0, 0.5},
+		l2[] = {0, 0, 0.5};
+	check(tpoint_segment_mindist(k1, l1, k2, l2, true) == 0.5, "mindist 3D");
+	check(tpoint_segment_mindist(k1, l1, k2, l2, false) == 0, "mindist 2D");
+}
+
+static void
+test_lengths(void)
+{
+	double x[] = {0, 3, 3}, y[] = {0, 4, 4}, z[] = {0, 0, 2};
+	double lengths[2];
+	tpoint_segment_lengths(x, y, NULL, 3, lengths);
+	check(lengths[0] == 5 && lengths[1] == 0, "lengths 2D");
+	tpoint_segment_lengths(x, y, z, 3, lengths);
+	check(lengths[0] == 5 && lengths[1] == 2, "lengths 3D");
+}
+
+int
+main(void)
+{
+	test_dwithin();
+	test_mindist();
+	test_lengths();
+	if (failures > 0)
+		fprintf(stderr, "%d test(s) failed\n", failures);
+	return failures > 0 ? 1 : 0;
+}
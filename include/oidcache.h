@@ -4,8 +4,10 @@
  *	  Functions for building a cache of Oids.
  *
  * The temporal extension builds a cache of OIDs in global arrays in order to 
- * avoid (slow) lookups. The global arrays are initialized at the loading 
- * of the extension.
+ * avoid (slow) lookups. The entries of the arrays are filled the first time
+ * they are requested. When the extension is loaded through 
+ * shared_preload_libraries, the operator OIDs are also shared between the
+ * backends through a hash table in shared memory.
  *
  * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
  *		Universite Libre de Bruxelles
@@ -109,11 +111,12 @@ typedef enum
 } CachedOp;
 
 
+extern void oidcache_init(void);
 extern Oid type_oid(CachedType t);
 extern Oid oper_oid(CachedOp op, CachedType lt, CachedType rt);
-extern void populate_oidcache();
 
 extern Datum fill_opcache(PG_FUNCTION_ARGS);
+extern Datum oidcache_stats(PG_FUNCTION_ARGS);
 
 #endif /* TEMPORAL_OIDCACHE_H */
 
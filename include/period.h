@@ -62,6 +62,7 @@ extern Datum period_timespan(PG_FUNCTION_ARGS);
 extern Datum period_eq(PG_FUNCTION_ARGS);
 extern Datum period_ne(PG_FUNCTION_ARGS);
 extern Datum period_cmp(PG_FUNCTION_ARGS);
+extern Datum period_sortsupport(PG_FUNCTION_ARGS);
 extern Datum period_lt(PG_FUNCTION_ARGS);
 extern Datum period_le(PG_FUNCTION_ARGS);
 extern Datum period_ge(PG_FUNCTION_ARGS);
@@ -75,6 +76,50 @@ extern bool period_le_internal(Period *p1, Period *p2);
 extern bool period_ge_internal(Period *p1, Period *p2);
 extern bool period_gt_internal(Period *p1, Period *p2);
 
+/*
+ * Canonical representation of a period bound: its timestamp together with
+ * its rank among the bounds at the same timestamp, which is -1 for an
+ * exclusive upper bound, that is just before the timestamp, 0 for an
+ * inclusive bound, and 1 for an exclusive lower bound, that is just after
+ * the timestamp. The representations are compared without branching on the
+ * flags of the bounds.
+ */
+#define PERIOD_BOUND_RANK(lower, inclusive) \
+	((1 - (int) (inclusive)) * (2 * (int) (lower) - 1))
+
+static inline int
+period_cmp_bound_ranks(TimestampTz t1, int rank1, TimestampTz t2, int rank2)
+{
+	int cmp = (t1 > t2) - (t1 < t2);
+	int rankcmp = (rank1 > rank2) - (rank1 < rank2);
+	return cmp != 0 ? cmp : rankcmp;
+}
+
+/* Lower bound of the first period is less than or equal to the upper bound
+ * of the second one */
+static inline bool
+period_lower_le_upper(const Period *p1, const Period *p2)
+{
+	return period_cmp_bound_ranks(p1->lower, PERIOD_BOUND_RANK(true, p1->lower_inc),
+		p2->upper, PERIOD_BOUND_RANK(false, p2->upper_inc)) <= 0;
+}
+
+/* Overlap and containment of periods expressed on their canonical bounds */
+static inline bool
+period_overlaps_period(const Period *p1, const Period *p2)
+{
+	return period_lower_le_upper(p1, p2) & period_lower_le_upper(p2, p1);
+}
+
+static inline bool
+period_contains_period(const Period *p1, const Period *p2)
+{
+	return (period_cmp_bound_ranks(p1->lower, PERIOD_BOUND_RANK(true, p1->lower_inc),
+			p2->lower, PERIOD_BOUND_RANK(true, p2->lower_inc)) <= 0) &
+		(period_cmp_bound_ranks(p1->upper, PERIOD_BOUND_RANK(false, p1->upper_inc),
+			p2->upper, PERIOD_BOUND_RANK(false, p2->upper_inc)) >= 0);
+}
+
 /* Assorted support functions */
 
 extern void period_deserialize(Period *p, PeriodBound *lower, PeriodBound *upper);
@@ -91,6 +136,8 @@ extern float8 period_to_secs(TimestampTz t1, TimestampTz t2);
 extern Interval *period_timespan_internal(Period *p);
 extern Period **periodarr_normalize(Period **periods, int count, int *newcount);
 extern Period *period_super_union(Period *p1, Period *p2);
+extern int periodarr_overlaps_period(const Period *periods, int count,
+	const Period *p, bool *result);
 
 /* Used for GiST and SP-GiST */
 
@@ -25,6 +25,8 @@ extern Period *periodset_per_n(PeriodSet *ps, int index);
 extern Period *periodset_bbox(PeriodSet *ps);
 extern PeriodSet *periodset_from_periodarr_internal(Period **periods, 
 	int count, bool normalize);
+extern PeriodSet *periodset_from_periods_internal(const Period *periods,
+	int count);
 extern PeriodSet *periodset_copy(PeriodSet *ps);
 extern bool periodset_find_timestamp(PeriodSet *ps, TimestampTz t, int *pos);
 
@@ -75,6 +77,7 @@ extern PeriodSet *periodset_shift_internal(PeriodSet *ps, Interval *interval);
 /* Functions for defining B-tree index */
 
 extern Datum periodset_cmp(PG_FUNCTION_ARGS);
+extern Datum periodset_sortsupport(PG_FUNCTION_ARGS);
 extern Datum periodset_eq(PG_FUNCTION_ARGS);
 extern Datum periodset_ne(PG_FUNCTION_ARGS);
 extern Datum periodset_lt(PG_FUNCTION_ARGS);
@@ -19,6 +19,27 @@
 
 /*****************************************************************************/
 
+/* Deserialized range */
+
+typedef struct
+{
+	TypeCacheEntry *typcache;
+	RangeBound	lower;
+	RangeBound	upper;
+	bool		empty;
+} RangeBounds;
+
+/* Deserialized range argument of a function kept in fn_extra */
+
+typedef struct
+{
+	bool		stable;		/* the argument does not change across calls */
+	bool		valid;		/* the bounds below have been computed */
+	RangeBounds bounds;
+} RangeBoundsCache;
+
+/*****************************************************************************/
+
 extern const char *range_to_string(RangeType *range);
 extern Datum lower_datum(RangeType *range);
 extern Datum upper_datum(RangeType *range);
@@ -27,6 +48,15 @@ extern bool upper_inc(RangeType *range);
 extern RangeType *range_make(Datum from, Datum to, bool lower_inc, bool upper_inc, Oid basetypid);
 extern RangeType **rangearr_normalize(RangeType **ranges, int *count);
 
+extern void range_bounds_deserialize(RangeBounds *bounds, RangeType *r);
+extern RangeBounds *rangearr_bounds(RangeType **ranges, int *count);
+extern int rangearr_bounds_find(const RangeBounds *normbounds, int count,
+	RangeBound *bound);
+extern void range_bounds_fn(RangeBounds *bounds, FunctionCallInfo fcinfo, int argno);
+extern bool range_bounds_contains_elem(const RangeBounds *bounds, Datum val);
+extern bool rangearr_bounds_contains_elem(const RangeBounds *normbounds, int count,
+	Datum val);
+
 extern Datum intrange_canonical(PG_FUNCTION_ARGS);
 
 extern Datum range_left_elem(PG_FUNCTION_ARGS);
@@ -41,6 +71,12 @@ extern bool range_right_elem_internal(TypeCacheEntry *typcache, RangeType *r, Da
 extern bool range_overright_elem_internal(TypeCacheEntry *typcache, RangeType *r, Datum val);
 extern bool range_adjacent_elem_internal(TypeCacheEntry *typcache, RangeType *r, Datum val);
 
+extern bool range_left_elem_bounds(const RangeBounds *bounds, Datum val);
+extern bool range_overleft_elem_bounds(const RangeBounds *bounds, Datum val);
+extern bool range_right_elem_bounds(const RangeBounds *bounds, Datum val);
+extern bool range_overright_elem_bounds(const RangeBounds *bounds, Datum val);
+extern bool range_adjacent_elem_bounds(const RangeBounds *bounds, Datum val);
+
 extern Datum elem_left_range(PG_FUNCTION_ARGS);
 extern Datum elem_overleft_range(PG_FUNCTION_ARGS);
 extern Datum elem_right_range(PG_FUNCTION_ARGS);
@@ -50,6 +86,9 @@ extern Datum elem_adjacent_range(PG_FUNCTION_ARGS);
 extern bool elem_overleft_range_internal(TypeCacheEntry *typcache, Datum r, RangeType *val);
 extern bool elem_overright_range_internal(TypeCacheEntry *typcache, Datum r, RangeType *val);
 
+extern bool elem_overleft_range_bounds(Datum val, const RangeBounds *bounds);
+extern bool elem_overright_range_bounds(Datum val, const RangeBounds *bounds);
+
 /*****************************************************************************/
 
 #endif
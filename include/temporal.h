@@ -83,20 +83,44 @@ struct temporal_duration_struct
 #define MOBDB_FLAGS_GET_Z(flags) 			((bool) (((flags) & 0x08)>>3))
 #define MOBDB_FLAGS_GET_T(flags) 			((bool) (((flags) & 0x10)>>4))
 #define MOBDB_FLAGS_GET_GEODETIC(flags) 	((bool) (((flags) & 0x20)>>5))
+/* The following flag is only used for TemporalSeq */
+#define MOBDB_FLAGS_GET_COMPRESSED(flags) 	((bool) (((flags) & 0x40)>>6))
+/* The following flag is only used for TemporalSeq of temporal points whose
+ * trajectory is not precomputed */
+#define MOBDB_FLAGS_GET_NOTRAJ(flags) 		((bool) (((flags) & 0x80)>>7))
+/* The following flag is only used for compressed TemporalSeq whose
+ * instants are kept as fixed-size records */
+#define MOBDB_FLAGS_GET_PACKED(flags) 		((bool) (((flags) & 0x100)>>8))
+/* The following flag is only used for TemporalSeq whose summary is
+ * stored after the bounding box */
+#define MOBDB_FLAGS_GET_SUMMARY(flags) 		((bool) (((flags) & 0x200)>>9))
 
 #define MOBDB_FLAGS_SET_LINEAR(flags, value) \
-	((flags) = (value) ? ((flags) | 0x01) : ((flags) & 0xFE))
+	((flags) = (value) ? ((flags) | 0x01) : ((flags) & ~0x01))
 /* The following flag is only used for TemporalInst */
 #define MOBDB_FLAGS_SET_BYVAL(flags, value) \
-	((flags) = (value) ? ((flags) | 0x02) : ((flags) & 0xFD))
+	((flags) = (value) ? ((flags) | 0x02) : ((flags) & ~0x02))
 #define MOBDB_FLAGS_SET_X(flags, value) \
-	((flags) = (value) ? ((flags) | 0x04) : ((flags) & 0xFB))
+	((flags) = (value) ? ((flags) | 0x04) : ((flags) & ~0x04))
 #define MOBDB_FLAGS_SET_Z(flags, value) \
-	((flags) = (value) ? ((flags) | 0x08) : ((flags) & 0xF7))
+	((flags) = (value) ? ((flags) | 0x08) : ((flags) & ~0x08))
 #define MOBDB_FLAGS_SET_T(flags, value) \
-	((flags) = (value) ? ((flags) | 0x10) : ((flags) & 0xEF))
+	((flags) = (value) ? ((flags) | 0x10) : ((flags) & ~0x10))
 #define MOBDB_FLAGS_SET_GEODETIC(flags, value) \
-	((flags) = (value) ? ((flags) | 0x20) : ((flags) & 0xDF))
+	((flags) = (value) ? ((flags) | 0x20) : ((flags) & ~0x20))
+/* The following flag is only used for TemporalSeq */
+#define MOBDB_FLAGS_SET_COMPRESSED(flags, value) \
+	((flags) = (value) ? ((flags) | 0x40) : ((flags) & ~0x40))
+/* The following flag is only used for TemporalSeq */
+#define MOBDB_FLAGS_SET_NOTRAJ(flags, value) \
+	((flags) = (value) ? ((flags) | 0x80) : ((flags) & ~0x80))
+/* The following flag is only used for compressed TemporalSeq whose
+ * instants are kept as fixed-size records */
+#define MOBDB_FLAGS_SET_PACKED(flags, value) \
+	((flags) = (value) ? ((flags) | 0x100) : ((flags) & ~0x100))
+/* The following flag is only used for TemporalSeq */
+#define MOBDB_FLAGS_SET_SUMMARY(flags, value) \
+	((flags) = (value) ? ((flags) | 0x200) : ((flags) & ~0x200))
 
 /*****************************************************************************
  * Struct definitions
@@ -176,6 +200,15 @@ typedef struct
 	size_t		offsets[1];		/* beginning of variable-length data */
 } TemporalSeq;
 
+/* Summary of a TemporalSeq that is precomputed when it is constructed */
+
+typedef struct
+{
+	double		integral;		/* integral of temporal numbers */
+	double		length;			/* length of temporal points with linear
+								   interpolation */
+} TemporalSeqSummary;
+
 /* Temporal Sequence Set */
 
 typedef struct 
@@ -186,9 +219,17 @@ typedef struct
 	Oid 		valuetypid;		/* base type's OID (4 bytes) */
 	int32 		count;			/* number of TemporalSeq elements */
 	int32 		totalcount;		/* total number of TemporalInst elements in all TemporalSeq elements */
+	int16		format;			/* format of the value */
 	size_t		offsets[1];		/* beginning of variable-length data */
 } TemporalS;
 
+/*
+ * Flag of the sequence sets whose offsets are followed by a directory of the
+ * periods of their sequences. It is never set in the values of the first
+ * on-disk format, whose header is padded with zeroes at that position.
+ */
+#define TEMPORALS_PERIODS	0x0001
+
 /* bboxunion - Union type for all types of bounding boxes */
 
 union bboxunion 
@@ -227,6 +268,29 @@ typedef struct double4
 
 typedef int (*qsort_comparator) (const void *a, const void *b);
 
+/* Iterator over the instants of a temporal value of any duration */
+
+typedef struct
+{
+	Temporal   *temp;			/* temporal value */
+	int			i;				/* index of the current sequence of a TemporalS */
+	int			j;				/* index of the next instant */
+	TemporalSeq *seq;			/* current sequence of a TemporalS */
+} TemporalInstIterator;
+
+/* Breakdown of the bytes of a temporal value by their use */
+
+typedef struct
+{
+	size_t		headers;		/* headers of the value and its sequences, and padding */
+	size_t		offsets;		/* arrays of offsets and of periods of the sequences */
+	size_t		instant_headers;	/* headers of the instants without the timestamps */
+	size_t		timestamps;		/* timestamps of the instants */
+	size_t		base_values;	/* values of the instants */
+	size_t		bbox;			/* bounding boxes */
+	size_t		trajectory;		/* precomputed trajectories of temporal points */
+} TemporalLayout;
+
 /*****************************************************************************
  * fmgr macros temporal types
  *****************************************************************************/
@@ -249,13 +313,33 @@ typedef int (*qsort_comparator) (const void *a, const void *b);
 
 /* Temporal types */
 
-#define DatumGetTemporal(X)			((Temporal *) PG_DETOAST_DATUM(X))
+/* Compressed sequences are decompressed and sequence sets in the first
+ * on-disk format are converted when the value is fetched */
+#ifdef WITH_STATS
+#define DatumGetTemporal(X)			pg_getarg_temporal((Temporal *) temporal_stat_detoast(X))
+#else
+#define DatumGetTemporal(X)			pg_getarg_temporal((Temporal *) PG_DETOAST_DATUM(X))
+#endif
 #define DatumGetTemporalInst(X)		((TemporalInst *) PG_DETOAST_DATUM(X))
 #define DatumGetTemporalI(X)		((TemporalI *) PG_DETOAST_DATUM(X))
 #define DatumGetTemporalSeq(X)		((TemporalSeq *) PG_DETOAST_DATUM(X))
 #define DatumGetTemporalS(X)		((TemporalS *) PG_DETOAST_DATUM(X))
 
-#define PG_GETARG_TEMPORAL(i)		((Temporal *) PG_GETARG_VARLENA_P(i))
+#ifdef WITH_STATS
+#define PG_GETARG_TEMPORAL(i)		DatumGetTemporal(PG_GETARG_DATUM(i))
+#else
+#define PG_GETARG_TEMPORAL(i)		pg_getarg_temporal((Temporal *) PG_GETARG_VARLENA_P(i))
+#endif
+
+/* Compressed sequences are not decompressed by the functions that only read
+ * their number of instants, their period, or their bounding box */
+#ifdef WITH_STATS
+#define PG_GETARG_TEMPORAL_HEADER(i) \
+	pg_getarg_temporal_header((Temporal *) temporal_stat_detoast(PG_GETARG_DATUM(i)))
+#else
+#define PG_GETARG_TEMPORAL_HEADER(i) \
+	pg_getarg_temporal_header((Temporal *) PG_GETARG_VARLENA_P(i))
+#endif
 
 #define PG_GETARG_ANYDATUM(i) (get_typlen(get_fn_expr_argtype(fcinfo->flinfo, i)) == -1 ? \
 	PointerGetDatum(PG_GETARG_VARLENA_P(i)) : PG_GETARG_DATUM(i))
@@ -286,6 +370,11 @@ typedef int (*qsort_comparator) (const void *a, const void *b);
 
 extern Temporal *temporal_copy(Temporal *temp);
 extern Temporal *pg_getarg_temporal(Temporal *temp);
+extern Temporal *pg_getarg_temporal_header(Temporal *temp);
+extern Temporal *temporal_getarg_slice(FunctionCallInfo fcinfo, int i, Period *p);
+extern struct varlena *temporal_stat_detoast(Datum value);
+extern void temporalinst_iterator_init(TemporalInstIterator *it, Temporal *temp);
+extern TemporalInst *temporalinst_iterator_next(TemporalInstIterator *it);
 extern bool intersection_temporal_temporal(Temporal *temp1, Temporal *temp2, 
 	Temporal **inter1, Temporal **inter2);
 extern bool synchronize_temporal_temporal(Temporal *temp1, Temporal *temp2, 
@@ -308,7 +397,9 @@ extern bool temporal_type_oid(Oid temptypid);
 
 /* Trajectory functions */
 
+extern bool precompute_trajectory;
 extern bool type_has_precomputed_trajectory(Oid valuetypid);
+extern bool precompute_summary;
 
 /* Parameter tests */
 
@@ -337,8 +428,15 @@ extern Datum temporalinst_constructor(PG_FUNCTION_ARGS);
 extern Datum temporali_constructor(PG_FUNCTION_ARGS);
 extern Datum tlinearseq_constructor(PG_FUNCTION_ARGS);
 extern Datum temporalseq_constructor(PG_FUNCTION_ARGS);
+extern Datum tfloatseq_from_arrays(PG_FUNCTION_ARGS);
 extern Datum temporals_constructor(PG_FUNCTION_ARGS);
 
+/* Merge functions */
+
+extern Datum temporal_merge(PG_FUNCTION_ARGS);
+extern Datum temporal_merge_array(PG_FUNCTION_ARGS);
+extern Temporal *temporalarr_merge(Temporal **temparr, int count);
+
 /* Cast functions */
 
 extern Datum tint_to_tfloat(PG_FUNCTION_ARGS);
@@ -351,6 +449,7 @@ extern Temporal *tint_to_tfloat_internal(Temporal *temp);
 extern Datum temporal_duration(PG_FUNCTION_ARGS);
 extern Datum temporal_interpolation(PG_FUNCTION_ARGS);
 extern Datum temporal_mem_size(PG_FUNCTION_ARGS);
+extern Datum temporal_mem_layout(PG_FUNCTION_ARGS);
 extern Datum temporal_get_values(PG_FUNCTION_ARGS);
 extern Datum temporal_get_time(PG_FUNCTION_ARGS);
 extern Datum temporalinst_get_value(PG_FUNCTION_ARGS);
@@ -370,6 +469,7 @@ extern Datum temporal_start_timestamp(PG_FUNCTION_ARGS);
 extern Datum temporal_end_timestamp(PG_FUNCTION_ARGS);
 extern Datum temporal_timestamp_n(PG_FUNCTION_ARGS);
 extern Datum temporal_shift(PG_FUNCTION_ARGS);
+extern Datum temporal_tscale(PG_FUNCTION_ARGS);
 
 extern Datum temporal_ever_eq(PG_FUNCTION_ARGS);
 extern Datum temporal_ever_ne(PG_FUNCTION_ARGS);
@@ -419,13 +519,23 @@ extern Datum temporal_intersects_timestamp(PG_FUNCTION_ARGS);
 extern Datum temporal_intersects_timestampset(PG_FUNCTION_ARGS);
 extern Datum temporal_intersects_period(PG_FUNCTION_ARGS);
 extern Datum temporal_intersects_periodset(PG_FUNCTION_ARGS);
+extern Datum distance_timestamp_temporal(PG_FUNCTION_ARGS);
+extern Datum distance_temporal_timestamp(PG_FUNCTION_ARGS);
  
 extern Temporal *temporal_at_min_internal(Temporal *temp);
 extern TemporalInst *temporal_at_timestamp_internal(Temporal *temp, TimestampTz t);
+extern Temporal *temporal_at_period_internal(Temporal *temp, Period *p);
 extern Temporal *temporal_at_periodset_internal(Temporal *temp, PeriodSet *ps);
 extern void temporal_period(Period *p, Temporal *temp);
-extern char *temporal_to_string(Temporal *temp, char *(*value_out)(Oid, Datum));
+extern double temporal_timestamp_distance_internal(Temporal *temp, TimestampTz t);
+extern void temporal_to_string_buf(StringInfo buf, Temporal *temp,
+	void (*value_out)(StringInfo, Oid, Datum));
+extern char *temporal_to_string(Temporal *temp,
+	void (*value_out)(StringInfo, Oid, Datum));
 extern void temporal_bbox(void *box, const Temporal *temp);
+extern bool temporal_bbox_slice(Datum value, void *box, Period *period,
+	int *numinst);
+extern void temporal_bbox_datum(void *box, Datum value);
 
 /* Comparison functions */
 
@@ -435,6 +545,7 @@ extern Datum temporal_eq(PG_FUNCTION_ARGS);
 extern Datum temporal_ge(PG_FUNCTION_ARGS);
 extern Datum temporal_gt(PG_FUNCTION_ARGS);
 extern Datum temporal_cmp(PG_FUNCTION_ARGS);
+extern Datum temporal_sortsupport(PG_FUNCTION_ARGS);
 extern Datum temporal_hash(PG_FUNCTION_ARGS);
 
 extern uint32 temporal_hash_internal(const Temporal *temp);
@@ -22,31 +22,113 @@
 /* SkipList - Internal type for computing aggregates */
 
 #define SKIPLIST_MAXLEVEL 32
-#define SKIPLIST_INITIAL_CAPACITY 1024
-#define SKIPLIST_GROW 2
-#define SKIPLIST_INITIAL_FREELIST 32
-
+#define SKIPLIST_INITIAL_CAPACITY 4096
+#define SKIPLIST_GROW 1
+
+/*
+ * Elements only store as many forward links as their height. They are 
+ * allocated in an arena and referred to by their offset in it, expressed
+ * in units of MAXIMUM_ALIGNOF bytes. The head and the tail can grow up to
+ * SKIPLIST_MAXLEVEL.
+ */
 typedef struct
 {
 	Temporal *value;
 	int height;
-	int next[SKIPLIST_MAXLEVEL];
+	int next[FLEXIBLE_ARRAY_MEMBER];
 } Elem;
 
+#define SKIPLIST_ELEM_WORDS(height) \
+	((int) (MAXALIGN(offsetof(Elem, next) + sizeof(int) * (height)) / \
+		MAXIMUM_ALIGNOF))
+
 typedef struct
 {
-	int capacity;
-	int next;
+	int capacity;                   /* Size of the arena in words */
+	int next;                       /* First unused word of the arena */
 	int length;
-	int *freed;
-	int freecount;
-	int freecap;
+	int freed[SKIPLIST_MAXLEVEL];   /* Free lists of elements by height */
 	int tail;
+	bool lastvalid;                 /* True when last is up to date */
+	int last[SKIPLIST_MAXLEVEL];    /* Last element before the tail by level */
 	void *extra;
 	size_t extrasize;
-	Elem *elems;
+	char *arena;
 } SkipList;
 
+/*
+ * TimeBins - Internal type for computing bucketed aggregates
+ *
+ * Bins have a constant width and are numbered from the PostgreSQL epoch 
+ * 2000-01-01 00:00:00 UTC. The state is a flat varlena so that it can be 
+ * serialized as is and combined by adding the bins of equal number.
+ */
+
+typedef struct
+{
+	int64 count;         /* Number of values defined in the bin */
+	double sum;          /* Sum of the values at the start of the bin */
+} TimeBin;
+
+typedef struct
+{
+	int32 vl_len_;       /* Varlena header (do not touch directly!) */
+	int32 count;         /* Number of bins */
+	Oid valuetypid;      /* Type of the sum, InvalidOid for a count */
+	int64 size;          /* Width of the bins in microseconds */
+	int64 first;         /* Number of the first bin */
+	TimeBin bins[FLEXIBLE_ARRAY_MEMBER];
+} TimeBins;
+
+/*
+ * SketchBins - Internal type for computing approximate bucketed aggregates
+ *
+ * Each bin keeps a sketch of fixed size, which is a HyperLogLog for the
+ * distinct count and a t-digest for the percentiles. As for TimeBins, the
+ * state is a flat varlena combined by merging the bins of equal number.
+ */
+
+#define SKETCH_HLL           1
+#define SKETCH_TDIGEST       2
+
+/* Standard error of the distinct count of 1.04 / sqrt(HLL_REGISTERS) */
+#define HLL_BITS             12
+#define HLL_REGISTERS        (1 << HLL_BITS)
+
+#define TDIGEST_COMPRESSION  100
+#define TDIGEST_CAPACITY     (2 * TDIGEST_COMPRESSION)
+
+typedef struct
+{
+	uint8 registers[HLL_REGISTERS];
+} HLLBin;
+
+typedef struct
+{
+	double mean;         /* Mean of the values in the centroid */
+	double weight;       /* Number of values in the centroid */
+} TDigestCentroid;
+
+typedef struct
+{
+	int32 count;         /* Number of centroids */
+	double weight;       /* Number of values in the bin */
+	double min;          /* Minimum and maximum values */
+	double max;
+	TDigestCentroid centroids[TDIGEST_CAPACITY];
+} TDigestBin;
+
+typedef struct
+{
+	int32 vl_len_;       /* Varlena header (do not touch directly!) */
+	int32 count;         /* Number of bins */
+	int32 kind;          /* SKETCH_HLL or SKETCH_TDIGEST */
+	double fraction;     /* Fraction of the percentiles */
+	int64 size;          /* Width of the bins in microseconds */
+	int64 first;         /* Number of the first bin */
+	char bins[FLEXIBLE_ARRAY_MEMBER];
+} SketchBins;
+
 /*****************************************************************************/
 
 extern Datum datum_min_int32(Datum l, Datum r);
@@ -72,6 +154,9 @@ extern void aggstate_set_extra(FunctionCallInfo fcinfo, SkipList *state,
 
 extern SkipList *temporalseq_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state, 
 	TemporalSeq *seq, Datum (*func)(Datum, Datum), bool interpoint);
+extern SkipList *temporalseqarr_tagg_transfn(FunctionCallInfo fcinfo, 
+	SkipList *state, TemporalSeq **sequences, int count, 
+	Datum (*func)(Datum, Datum), bool crossings);
 extern SkipList *temporal_tagg_combinefn(FunctionCallInfo fcinfo, SkipList *state1,
 	SkipList *state2, Datum (*func)(Datum, Datum), bool crossings);
 
@@ -109,6 +194,22 @@ extern Datum ttext_tmin_combinefn(PG_FUNCTION_ARGS);
 extern Datum ttext_tmax_transfn(PG_FUNCTION_ARGS);
 extern Datum ttext_tmax_combinefn(PG_FUNCTION_ARGS);
 
+extern int64 timebin_number(TimestampTz t, int64 size);
+extern int64 bucket_interval_size(Interval *interval);
+
+extern Datum temporal_tcount_bucket_transfn(PG_FUNCTION_ARGS);
+extern Datum tnumber_tsum_bucket_transfn(PG_FUNCTION_ARGS);
+extern Datum temporal_bucket_combinefn(PG_FUNCTION_ARGS);
+extern Datum temporal_bucket_finalfn(PG_FUNCTION_ARGS);
+extern Datum temporal_bucket_serialize(PG_FUNCTION_ARGS);
+extern Datum temporal_bucket_deserialize(PG_FUNCTION_ARGS);
+
+extern Datum temporal_tcount_distinct_transfn(PG_FUNCTION_ARGS);
+extern Datum tnumber_tpercentile_transfn(PG_FUNCTION_ARGS);
+extern Datum temporal_sketch_combinefn(PG_FUNCTION_ARGS);
+extern Datum temporal_tcount_distinct_finalfn(PG_FUNCTION_ARGS);
+extern Datum tnumber_tpercentile_finalfn(PG_FUNCTION_ARGS);
+
 /*****************************************************************************/
 
 #endif
@@ -19,6 +19,24 @@
 #include <parser/parse_oper.h>
 #include <statistics/extended_stats_internal.h>
 
+#include "temporal.h"
+
+/*
+ * Two-dimensional histogram of the value and time dimensions of temporal 
+ * numbers, which is not defined by PostgreSQL and thus it is necessary to
+ * define a new stakind
+ */
+#define STATISTIC_KIND_TBOX_HISTOGRAM  10
+
+/* Maximum number of buckets of each dimension of the histogram */
+#define TBOX_HIST_MAX_BINS  32
+
+/*
+ * Histogram of the number of instants of the values, which measures the 
+ * cost of processing them and is not defined by PostgreSQL
+ */
+#define STATISTIC_KIND_NUM_INSTANTS_HISTOGRAM  11
+
 /* 
  * Extra data for compute_stats function 
  * Structure based on the ArrayAnalyzeExtraData from file array_typanalyze.c
@@ -93,6 +111,10 @@ extern void temporalinst_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc
 extern void temporals_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	int samplerows, double totalrows);
 
+extern int temporal_stored_instants(const Temporal *temp);
+extern void num_instants_compute_stats(VacAttrStats *stats, int non_null_cnt, 
+	int *slot_idx, float8 *num_instants);
+
 /*****************************************************************************/
 
 extern Datum temporal_analyze(PG_FUNCTION_ARGS);
@@ -17,11 +17,28 @@
 #include <catalog/pg_type.h>
 #include <utils/rangetypes.h>
 #include "temporal.h"
+#include "rangetypes_ext.h"
 
 /*****************************************************************************/
 
+/* Bounding box of an argument of a function kept in fn_extra */
+
+typedef struct
+{
+	bool		stable;		/* the argument does not change across calls */
+	bool		valid;		/* the box below has been computed */
+	bool		found;		/* the argument has a bounding box */
+	union bboxunion box;	/* box computed from the argument */
+} BoxCache;
+
+extern BoxCache *box_cache_fn(FunctionCallInfo fcinfo, int argno);
+extern void box_cache_set(BoxCache *cache, const void *box, size_t size,
+	bool found);
+
 extern void number_to_box(TBOX *box, Datum value, Oid valuetypid);
 extern void range_to_tbox_internal(TBOX *box, RangeType *r);
+extern void range_to_tbox_fn(TBOX *box, FunctionCallInfo fcinfo, int argno);
+extern void range_bounds_to_tbox(TBOX *box, const RangeBounds *bounds);
 extern void int_to_tbox_internal(TBOX *box, int i);
 extern void float_to_tbox_internal(TBOX *box, double d);
 extern void intrange_to_tbox_internal(TBOX *box, RangeType *range);
@@ -54,12 +71,15 @@ extern void temporals_make_bbox(void *bbox, TemporalSeq **seqs, int count);
 /* Shift the bounding box of a Temporal with an Interval */
 
 extern void shift_bbox(void *box, Oid valuetypid, Interval *interval);
+extern void tscale_bbox(void *box, Oid valuetypid, TimestampTz origin,
+	double scale);
 
 /* Expand the bounding box of a Temporal with a TemporalInst */
 
 extern bool temporali_expand_bbox(void *box, TemporalI *ti, TemporalInst *inst);
 extern bool temporalseq_expand_bbox(void *box, TemporalSeq *seq, TemporalInst *inst);
 extern bool temporals_expand_bbox(void *box, TemporalS *ts, TemporalInst *inst);
+extern void temporalseq_bbox_append(void *box, TemporalInst *inst);
 
 extern Datum int_to_tbox(PG_FUNCTION_ARGS);
 extern Datum float_to_tbox(PG_FUNCTION_ARGS);
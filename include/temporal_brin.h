@@ -0,0 +1,35 @@
+/*****************************************************************************
+ *
+ * temporal_brin.h
+ *	  BRIN inclusion index for time types and temporal numbers
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_BRIN_H__
+#define __TEMPORAL_BRIN_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+/* Columns of the summary of the BRIN inclusion operator classes, as defined
+ * in the file brin_inclusion.c */
+
+#define	INCLUSION_UNION				0
+#define	INCLUSION_UNMERGEABLE		1
+#define	INCLUSION_CONTAINS_EMPTY	2
+
+extern Datum brin_period_merge(PG_FUNCTION_ARGS);
+extern Datum brin_tbox_merge(PG_FUNCTION_ARGS);
+extern Datum brin_tnumber_add_value(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
@@ -0,0 +1,38 @@
+/*****************************************************************************
+ *
+ * temporal_cache.h
+ *	  Query-scoped cache of detoasted temporal values
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_CACHE_H__
+#define __TEMPORAL_CACHE_H__
+
+#include <postgres.h>
+#include <fmgr.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+/* Maximum value of the mobilitydb.detoast_cache_size parameter */
+#define TEMPORAL_CACHE_MAX		64
+
+extern int detoast_cache_size;
+
+/*
+ * Get a temporal argument through the cache. The value must neither be
+ * freed nor returned by the function, and it remains valid until the next
+ * call to the macro.
+ */
+#define PG_GETARG_TEMPORAL_CACHED(i)	temporal_cache_getarg(PG_GETARG_DATUM(i))
+
+extern Temporal *temporal_cache_getarg(Datum value);
+
+/*****************************************************************************/
+
+#endif
@@ -44,6 +44,19 @@ extern Datum tge_base_temporal(PG_FUNCTION_ARGS);
 extern Datum tge_temporal_base(PG_FUNCTION_ARGS);
 extern Datum tge_temporal_temporal(PG_FUNCTION_ARGS);
 
+extern Datum ever_eq_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum always_eq_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum ever_ne_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum always_ne_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum ever_lt_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum always_lt_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum ever_le_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum always_le_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum ever_gt_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum always_gt_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum ever_ge_temporal_temporal(PG_FUNCTION_ARGS);
+extern Datum always_ge_temporal_temporal(PG_FUNCTION_ARGS);
+
 extern Temporal * tcomp_temporal_base(Temporal *temp, Datum value, Oid datumtypid,
 	Datum (*func)(Datum, Datum, Oid, Oid), bool invert);
 
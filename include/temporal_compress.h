@@ -0,0 +1,36 @@
+/*****************************************************************************
+ *
+ * temporal_compress.h
+ *	  Compressed representation of temporal sequences.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_COMPRESS_H__
+#define __TEMPORAL_COMPRESS_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+extern bool temporalseq_compressible(TemporalSeq *seq);
+extern TemporalSeq *temporalseq_compress(TemporalSeq *seq);
+extern TemporalSeq *temporalseq_decompress(TemporalSeq *seq);
+extern TemporalSeq *temporalseq_pack(TemporalSeq *seq);
+extern Temporal *temporal_typmod_pack(Temporal *temp, int32 typmod);
+extern size_t temporalseq_compressed_stream_size(TemporalSeq *seq);
+extern size_t temporalseq_compressed_bbox_size(TemporalSeq *seq);
+extern void temporalseq_compressed_bbox(void *box, TemporalSeq *seq);
+
+extern Datum temporal_compress(PG_FUNCTION_ARGS);
+extern Datum temporal_is_compressed(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
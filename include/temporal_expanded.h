@@ -0,0 +1,56 @@
+/*****************************************************************************
+ *
+ * temporal_expanded.h
+ *	  Expanded representation of temporal sequences.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_EXPANDED_H__
+#define __TEMPORAL_EXPANDED_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include <utils/expandeddatum.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+/* Expanded TemporalSeq */
+
+typedef struct
+{
+	ExpandedObjectHeader hdr;	/* standard header of expanded objects */
+	int			magic;			/* magic number for sanity checks */
+	Oid 		valuetypid;		/* base type's OID */
+	bool		lower_inc;		/* lower bound of the period is inclusive? */
+	bool		upper_inc;		/* upper bound of the period is inclusive? */
+	bool		linear;			/* linear interpolation? */
+	bool		seqset;			/* flattened into a sequence set? */
+	int32 		count;			/* number of instants */
+	int32 		maxcount;		/* allocated size of the instants array */
+	TemporalInst **instants;	/* instants of the sequence */
+	TemporalSeq *fvalue;		/* flat value whose instants are referenced */
+	Temporal	*flat;			/* cached flat value, NULL if not computed */
+	union bboxunion bbox;		/* bounding box, expanded on each append */
+	bool		hasbbox;		/* is the bounding box computed? */
+} ExpandedTemporalSeq;
+
+#define ETS_MAGIC 0x4D4F4253	/* ID for debugging crosschecks */
+
+/*****************************************************************************/
+
+extern Datum expand_temporalseq(TemporalSeq *seq, MemoryContext parentcontext);
+extern void expanded_temporalseq_append_instant(ExpandedTemporalSeq *eseq,
+	TemporalInst *inst);
+extern bool expanded_temporal_at_period(Temporal *temp, Period *p,
+	MemoryContext objcxt, Datum *result);
+extern ExpandedTemporalSeq *expanded_temporalseq_get(Datum value);
+
+/*****************************************************************************/
+
+#endif
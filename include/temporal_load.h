@@ -0,0 +1,48 @@
+/*****************************************************************************
+ *
+ * temporal_load.h
+ *	  Bulk load of temporal values from files
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_LOAD_H__
+#define __TEMPORAL_LOAD_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include <fmgr.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+#define LOAD_MAX_VALUES		3
+
+/* Values read from a line of a file */
+
+typedef struct
+{
+	TimestampTz t;
+	double values[LOAD_MAX_VALUES];
+} LoadPoint;
+
+/* Function building an instant from the values read */
+
+typedef TemporalInst *(*LoadInstMake)(const LoadPoint *point, int nvalues,
+	Datum arg);
+
+/*****************************************************************************/
+
+extern void temporal_load_csv(FunctionCallInfo fcinfo, text *filename,
+	bool header, text *delimiter, int minvalues, int maxvalues,
+	LoadInstMake make, Datum arg);
+
+extern Datum tfloat_load_csv(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
@@ -0,0 +1,86 @@
+/*****************************************************************************
+ *
+ * temporal_probes.h
+ *	  Static tracing probes in the hot paths
+ *
+ * When the extension is compiled with WITH_DTRACE, the macros below define
+ * USDT probes of the provider mobilitydb using the sys/sdt.h header of
+ * SystemTap, which are understood by DTrace, SystemTap, perf and the eBPF
+ * tools, e.g.
+ *		bpftrace -e 'usdt:/path/to/libMobilityDB.so:mobilitydb:sync__start
+ *			{ @start[tid] = nsecs; } ...'
+ * Otherwise the macros expand to nothing. The probes and their arguments are
+ *
+ *	sync__start(int count1, int count2)
+ *	sync__done(int count, int size)
+ *		Synchronized lifted functions on two temporal values, with the number
+ *		of instants of the arguments and of the result and the size of the
+ *		result, which is 0 when the values do not intersect in time
+ *	seq__make__start(int count)
+ *	seq__make__done(int count, int size)
+ *		Construction of a temporal sequence from an array of instants
+ *	trajectory__start(int count)
+ *	trajectory__done(int size)
+ *		Construction of the trajectory of a temporal point sequence
+ *	agg__transfn__start(int count)
+ *	agg__transfn__done(int length)
+ *		Transition functions of the temporal aggregates, with the number of
+ *		instants of the value added and the length of the resulting state
+ *	geos__start(int size1, int size2)
+ *	geos__done()
+ *		Calls to the PostGIS functions using GEOS, with the sizes of the
+ *		geometries
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_PROBES_H__
+#define __TEMPORAL_PROBES_H__
+
+#ifdef WITH_DTRACE
+
+#include <sys/sdt.h>
+
+#define TRACE_MOBILITYDB_SYNC_START(count1, count2) \
+	DTRACE_PROBE2(mobilitydb, sync__start, (int) (count1), (int) (count2))
+#define TRACE_MOBILITYDB_SYNC_DONE(count, size) \
+	DTRACE_PROBE2(mobilitydb, sync__done, (int) (count), (int) (size))
+#define TRACE_MOBILITYDB_SEQ_MAKE_START(count) \
+	DTRACE_PROBE1(mobilitydb, seq__make__start, (int) (count))
+#define TRACE_MOBILITYDB_SEQ_MAKE_DONE(count, size) \
+	DTRACE_PROBE2(mobilitydb, seq__make__done, (int) (count), (int) (size))
+#define TRACE_MOBILITYDB_TRAJECTORY_START(count) \
+	DTRACE_PROBE1(mobilitydb, trajectory__start, (int) (count))
+#define TRACE_MOBILITYDB_TRAJECTORY_DONE(size) \
+	DTRACE_PROBE1(mobilitydb, trajectory__done, (int) (size))
+#define TRACE_MOBILITYDB_AGG_TRANSFN_START(count) \
+	DTRACE_PROBE1(mobilitydb, agg__transfn__start, (int) (count))
+#define TRACE_MOBILITYDB_AGG_TRANSFN_DONE(length) \
+	DTRACE_PROBE1(mobilitydb, agg__transfn__done, (int) (length))
+#define TRACE_MOBILITYDB_GEOS_START(size1, size2) \
+	DTRACE_PROBE2(mobilitydb, geos__start, (int) (size1), (int) (size2))
+#define TRACE_MOBILITYDB_GEOS_DONE() \
+	DTRACE_PROBE(mobilitydb, geos__done)
+
+#else
+
+#define TRACE_MOBILITYDB_SYNC_START(count1, count2)	((void) 0)
+#define TRACE_MOBILITYDB_SYNC_DONE(count, size)		((void) 0)
+#define TRACE_MOBILITYDB_SEQ_MAKE_START(count)		((void) 0)
+#define TRACE_MOBILITYDB_SEQ_MAKE_DONE(count, size)	((void) 0)
+#define TRACE_MOBILITYDB_TRAJECTORY_START(count)	((void) 0)
+#define TRACE_MOBILITYDB_TRAJECTORY_DONE(size)		((void) 0)
+#define TRACE_MOBILITYDB_AGG_TRANSFN_START(count)	((void) 0)
+#define TRACE_MOBILITYDB_AGG_TRANSFN_DONE(length)	((void) 0)
+#define TRACE_MOBILITYDB_GEOS_START(size1, size2)	((void) 0)
+#define TRACE_MOBILITYDB_GEOS_DONE()				((void) 0)
+
+#endif
+
+/*****************************************************************************/
+
+#endif
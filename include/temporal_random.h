@@ -0,0 +1,57 @@
+/*****************************************************************************
+ *
+ * temporal_random.h
+ *	  Generation of random temporal values for benchmarks
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_RANDOM_H__
+#define __TEMPORAL_RANDOM_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+/* Number of centers of the clustered distribution */
+#define RANDOM_CLUSTERS		8
+
+/* Distributions of the values of the random temporal values */
+
+typedef enum
+{
+	RANDOM_UNIFORM,			/* Independent values uniformly distributed */
+	RANDOM_WALK,			/* Random walk */
+	RANDOM_CLUSTERED,		/* Random walk around one of a few centers */
+	RANDOM_ROAD				/* Random walk along a grid of roads */
+} RandomDist;
+
+/* State of the pseudorandom number generator */
+
+typedef struct
+{
+	uint64 s;
+} RandomState;
+
+/*****************************************************************************/
+
+extern void random_init(RandomState *state, int64 seed);
+extern double random_double(RandomState *state);
+extern double random_gaussian(RandomState *state);
+extern double random_reflect(double value, double low, double high);
+extern RandomDist random_distribution(text *name);
+extern int64 random_step_usecs(Interval *step);
+extern TimestampTz random_start(RandomState *state, TimestampTz lower,
+	TimestampTz upper, int64 step, int count);
+
+extern Datum random_tfloat_seq(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
@@ -48,10 +48,18 @@ extern Selectivity temporals_sel(PlannerInfo *root, VariableStatData *vardata,
 extern double var_eq_const(VariableStatData *vardata, Oid operator,
 	Datum constval, bool constisnull, bool varonleft, bool negate);
 
+extern HeapTuple temporal_stats_tuple(Oid relid, text *attname, 
+	Oid *atttypid);
+extern bool temporal_stats_scalar_extent(HeapTuple stats_tuple, Oid typid, 
+	Datum *min, Datum *max);
+extern bool temporal_stats_time_extent(HeapTuple stats_tuple, 
+	TimestampTz *tmin, TimestampTz *tmax);
+
 /*****************************************************************************/
 
 extern Datum temporal_sel(PG_FUNCTION_ARGS);
 extern Datum temporal_joinsel(PG_FUNCTION_ARGS);
+extern Datum temporal_estimated_num_instants(PG_FUNCTION_ARGS);
 
 /*****************************************************************************/
 
@@ -0,0 +1,105 @@
+/*****************************************************************************
+ *
+ * temporal_stats.h
+ *	  Counters of the work done by the core functions in a backend
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_STATS_H__
+#define __TEMPORAL_STATS_H__
+
+#include <postgres.h>
+#include <access/stratnum.h>
+#include <catalog/pg_type.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+/*
+ * The counters are only updated when the extension is compiled with
+ * WITH_STATS and the setting mobilitydb.stats is on, otherwise the macros
+ * below expand to nothing or do nothing
+ */
+typedef struct
+{
+	uint64 instants;			/* Instants of the arguments of the lifted
+								   functions and of the temporal aggregates */
+	uint64 sync_segments;		/* Segments of synchronized sequences */
+	uint64 crossings;			/* Crossings computed between segments */
+	uint64 geos_calls;			/* Calls to PostGIS functions using GEOS */
+	uint64 lifting_bytes;		/* Bytes of the arenas of the lifted functions */
+	uint64 skiplist_splices;	/* Splices of the skiplists of the aggregates */
+	uint64 detoast_bytes;		/* Bytes of the detoasted temporal values */
+} MobdbStats;
+
+extern bool mobdb_stats_enabled;
+
+#ifdef WITH_STATS
+extern MobdbStats mobdb_stats;
+#define MOBDB_STAT_ADD(counter, n) \
+	(mobdb_stats_enabled ? (void) (mobdb_stats.counter += (n)) : (void) 0)
+#else
+#define MOBDB_STAT_ADD(counter, n)	((void) 0)
+#endif
+
+#define MOBDB_STAT_INC(counter)		MOBDB_STAT_ADD(counter, 1)
+#define MOBDB_STAT_INSTANTS(temp)	MOBDB_STAT_ADD(instants, temporal_stat_instants(temp))
+
+/*****************************************************************************/
+
+/*
+ * Operator classes whose consistent functions update the index counters.
+ * The order must be kept in sync with the names in temporal_stats.c.
+ */
+typedef enum
+{
+	STAT_GIST_PERIOD,
+	STAT_SPGIST_PERIOD,
+	STAT_GIST_TEMPORAL,
+	STAT_SPGIST_TEMPORAL,
+	STAT_GIST_TNUMBER,
+	STAT_SPGIST_TNUMBER,
+	STAT_GIST_TPOINT,
+	STAT_SPGIST_TPOINT
+} MobdbStatIndex;
+
+#define STAT_INDEX_OPCLASSES		8
+/* Strategy numbers are at most RTOverBackStrategyNumber */
+#define STAT_INDEX_STRATEGIES		36
+
+typedef struct
+{
+	uint64 calls;				/* Calls to the consistent function */
+	uint64 internal_calls;		/* Calls on the internal pages of GiST */
+	uint64 leaf_calls;			/* Calls on leaf entries */
+	uint64 leaf_matches;		/* Leaf entries returned by the index */
+	uint64 leaf_rechecks;		/* Leaf entries returned with recheck */
+} MobdbIndexStats;
+
+#ifdef WITH_STATS
+extern MobdbIndexStats mobdb_index_stats[STAT_INDEX_OPCLASSES][STAT_INDEX_STRATEGIES];
+#define MOBDB_STAT_INDEX(opclass, strategy, leaf, match, recheck) \
+	(mobdb_stats_enabled ? \
+	temporal_stat_index(opclass, strategy, leaf, match, recheck) : (void) 0)
+#else
+#define MOBDB_STAT_INDEX(opclass, strategy, leaf, match, recheck)	((void) 0)
+#endif
+
+/*****************************************************************************/
+
+extern uint64 temporal_stat_instants(Temporal *temp);
+extern void temporal_stat_index(MobdbStatIndex opclass, StrategyNumber strategy,
+	bool leaf, bool match, bool recheck);
+
+extern Datum mobdb_stat_activity(PG_FUNCTION_ARGS);
+extern Datum mobdb_stat_reset(PG_FUNCTION_ARGS);
+extern Datum mobdb_stat_index(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
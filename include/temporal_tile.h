@@ -0,0 +1,29 @@
+/*****************************************************************************
+ *
+ * temporal_tile.h
+ *	  Split of temporal values according to time buckets
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TEMPORAL_TILE_H__
+#define __TEMPORAL_TILE_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+extern Datum timestamp_time_bucket(PG_FUNCTION_ARGS);
+extern Datum period_time_bucket(PG_FUNCTION_ARGS);
+extern Datum temporal_time_split_srf(PG_FUNCTION_ARGS);
+extern Datum temporal_tsample(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
@@ -16,12 +16,25 @@
 #include <postgres.h>
 #include <catalog/pg_type.h>
 #include <utils/rangetypes.h>
+#include <utils/sortsupport.h>
 #include "timetypes.h"
 #include "temporal.h"
 #include "postgis.h"
 
 /*****************************************************************************/
 
+/* Descriptor of a base type resolved once from its Oid */
+
+typedef struct
+{
+	Oid			type;			/* Oid of the base type */
+	bool		byval;			/* Is the type passed by value? */
+	int			typlen;			/* Length of the type, -1 for varlena types */
+	bool		linear;			/* Does the type allow linear interpolation? */
+	bool		(*eq)(Datum, Datum);	/* Equality function */
+	bool		(*lt)(Datum, Datum);	/* Less than function, NULL if none */
+} BaseTypeInfo;
+
 /* Miscellaneous functions */
 
 extern void _PG_init(void);
@@ -31,6 +44,25 @@ extern bool get_typbyval_fast(Oid type);
 extern int get_typlen_fast(Oid type);
 extern Datum datum_copy(Datum value, Oid type);
 extern double datum_double(Datum d, Oid valuetypid);
+extern int64 zorder_key(const double *values, const double *mins, 
+	const double *maxs, int ndims);
+extern float4 float4_round_down(double d);
+extern float4 float4_round_up(double d);
+extern int32 timestamp_span_seconds(TimestampTz tmin, TimestampTz tmax);
+extern TimestampTz timestamp_span_upper(TimestampTz tmin, int32 span);
+extern TimestampTz timestamp_shift(TimestampTz t, Interval *interval);
+extern TimestampTz timestamp_tscale(TimestampTz t, TimestampTz origin,
+	double scale);
+extern const BaseTypeInfo *base_type_info(Oid type);
+extern MemoryContext temporal_arena_create(void);
+extern void temporal_arena_delete(MemoryContext arena);
+
+/* Abbreviated keys for sortsupport */
+
+extern Datum timestamp_abbrev_key(TimestampTz t);
+extern Datum double_abbrev_key(double d);
+extern void sortsupport_set_abbrev(SortSupport ssup,
+	Datum (*converter)(Datum, SortSupport));
 
 /* PostgreSQL call helpers */
 
@@ -38,8 +70,12 @@ extern Datum call_input(Oid type, char *str);
 extern char *call_output(Oid type, Datum value);
 extern bytea *call_send(Oid type, Datum value);
 extern Datum call_recv(Oid type, StringInfo buf);
+extern void timestamptz_to_string_buf(StringInfo buf, TimestampTz t);
+extern void datum_to_string_buf(StringInfo buf, Oid type, Datum value);
 extern Datum call_function1(PGFunction func, Datum arg1);
 extern Datum call_function2(PGFunction func, Datum arg1, Datum arg2);
+extern Datum call_function2_cached(FmgrInfo *flinfo, PGFunction func,
+	Datum arg1, Datum arg2);
 extern Datum call_function3(PGFunction func, Datum arg1, Datum arg2, Datum arg3);
 extern Datum call_function4(PGFunction func, Datum arg1, Datum arg2, Datum arg3, Datum arg4);
 
@@ -66,6 +102,7 @@ extern void periodarr_sort(Period **periods, int count);
 extern void rangearr_sort(RangeType **ranges, int count);
 extern void temporalinstarr_sort(TemporalInst **instants, int count);
 extern void temporalseqarr_sort(TemporalSeq **sequences, int count);
+extern double double_select(double *values, int count, int k);
 
 /* Remove duplicate functions */
 
@@ -75,6 +112,7 @@ extern int timestamp_remove_duplicates(TimestampTz *values, int count);
 /* Text functions */
 
 extern int text_cmp(text *arg1, text *arg2, Oid collid);
+extern bool text_eq(text *arg1, text *arg2);
 
 /* Comparison functions on datums */
 
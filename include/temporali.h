@@ -17,6 +17,7 @@
 #include <catalog/pg_type.h>
 #include <utils/rangetypes.h>
 #include "temporal.h"
+#include "rangetypes_ext.h"
 
 /*****************************************************************************/
 
@@ -37,7 +38,8 @@ extern bool intersection_temporali_temporali(TemporalI *ti1, TemporalI *ti2,
 
 /* Input/output functions */
 
-extern char *temporali_to_string(TemporalI *ti, char *(*value_out)(Oid, Datum));
+extern void temporali_to_string_buf(StringInfo buf, TemporalI *ti,
+	void (*value_out)(StringInfo, Oid, Datum));
 extern void temporali_write(TemporalI *ti, StringInfo buf);
 extern TemporalI *temporali_read(StringInfo buf, Oid valuetypid);
 
@@ -71,7 +73,10 @@ extern ArrayType *temporali_instants_array(TemporalI *ti);
 extern TimestampTz temporali_start_timestamp(TemporalI *ti);
 extern TimestampTz temporali_end_timestamp(TemporalI *ti);
 extern ArrayType *temporali_timestamps(TemporalI *ti);
+extern void temporali_layout(TemporalI *ti, TemporalLayout *layout);
 extern TemporalI *temporali_shift(TemporalI *ti, Interval *interval);
+extern TemporalI *temporali_tscale(TemporalI *ti, TimestampTz origin,
+	double scale);
 
 extern bool temporali_ever_eq(TemporalI *ti, Datum value);
 extern bool temporali_ever_lt(TemporalI *ti, Datum value);
@@ -87,10 +92,10 @@ extern TemporalI *temporali_at_value(TemporalI *ti, Datum value);
 extern TemporalI *temporali_minus_value(TemporalI *ti, Datum value);
 extern TemporalI *temporali_at_values(TemporalI *ti, Datum *values, int count);
 extern TemporalI *temporali_minus_values(TemporalI *ti, Datum *values, int count);
-extern TemporalI *tnumberi_at_range(TemporalI *ti, RangeType *range);
-extern TemporalI *tnumberi_minus_range(TemporalI *ti, RangeType *range);
-extern TemporalI *tnumberi_at_ranges(TemporalI *ti, RangeType **normranges, int count);
-extern TemporalI *tnumberi_minus_ranges(TemporalI *ti, RangeType **normranges, int count);
+extern TemporalI *tnumberi_at_range(TemporalI *ti, const RangeBounds *bounds);
+extern TemporalI *tnumberi_minus_range(TemporalI *ti, const RangeBounds *bounds);
+extern TemporalI *tnumberi_at_ranges(TemporalI *ti, const RangeBounds *normbounds, int count);
+extern TemporalI *tnumberi_minus_ranges(TemporalI *ti, const RangeBounds *normbounds, int count);
 extern TemporalI *temporali_at_min(TemporalI *ti);
 extern TemporalI *temporali_minus_min(TemporalI *ti);
 extern TemporalI *temporali_at_max(TemporalI *ti);
@@ -17,19 +17,23 @@
 #include <catalog/pg_type.h>
 #include <utils/rangetypes.h>
 #include "temporal.h"
+#include "rangetypes_ext.h"
 #include "postgis.h"
 
 /*****************************************************************************/
  
 extern TemporalInst *temporalinst_make(Datum value, TimestampTz t, Oid valuetypid);
 extern TemporalInst *temporalinst_copy(TemporalInst *inst);
+extern TemporalInst **temporalinstarr_from_model(TemporalInst *model, 
+	const TimestampTz *times, int count);
 extern Datum* temporalinst_value_ptr(TemporalInst *inst);
 extern Datum temporalinst_value(TemporalInst *inst);
 extern Datum temporalinst_value_copy(TemporalInst *inst);
 
 /* Input/output functions */
 
-char *temporalinst_to_string(TemporalInst *inst, char *(*value_out)(Oid, Datum));
+extern void temporalinst_to_string_buf(StringInfo buf, TemporalInst *inst,
+	void (*value_out)(StringInfo, Oid, Datum));
 extern void temporalinst_write(TemporalInst *inst, StringInfo buf);
 extern TemporalInst *temporalinst_read(StringInfo buf, Oid valuetypid);
 
@@ -61,6 +65,7 @@ extern PeriodSet *temporalinst_get_time(TemporalInst *inst);
 extern void temporalinst_bbox(void *box, TemporalInst *inst);
 extern void temporalinst_period(Period *p, TemporalInst *inst);
 extern ArrayType *temporalinst_timestamps(TemporalInst *inst);
+extern void temporalinst_layout(TemporalInst *inst, TemporalLayout *layout);
 extern ArrayType *temporalinst_instants_array(TemporalInst *inst);
 extern TemporalInst *temporalinst_shift(TemporalInst *inst, Interval *interval);
 
@@ -78,8 +83,8 @@ extern TemporalInst *temporalinst_at_value(TemporalInst *inst, Datum val);
 extern TemporalInst *temporalinst_minus_value(TemporalInst *inst, Datum val);
 extern TemporalInst *temporalinst_at_values(TemporalInst *inst, Datum *values, int count);
 extern TemporalInst *temporalinst_minus_values(TemporalInst *inst, Datum *values, int count);
-extern TemporalInst *tnumberinst_at_range(TemporalInst *inst, RangeType *range);
-extern TemporalInst *tnumberinst_minus_range(TemporalInst *inst, RangeType *range);
+extern TemporalInst *tnumberinst_at_range(TemporalInst *inst, const RangeBounds *bounds);
+extern TemporalInst *tnumberinst_minus_range(TemporalInst *inst, const RangeBounds *bounds);
 
 extern TemporalInst *temporalinst_at_timestamp(TemporalInst *inst, TimestampTz t);
 extern bool temporalinst_value_at_timestamp(TemporalInst *inst, TimestampTz t, Datum *result);
@@ -91,8 +96,8 @@ extern TemporalInst *temporalinst_minus_period(TemporalInst *inst, Period *p);
 extern TemporalInst *temporalinst_at_periodset(TemporalInst *inst, PeriodSet *ps);
 extern TemporalInst *temporalinst_minus_periodset(TemporalInst *inst, PeriodSet *ps);
 
-extern TemporalInst *tnumberinst_at_ranges(TemporalInst *inst, RangeType **normranges, int count);
-extern TemporalInst *tnumberinst_minus_ranges(TemporalInst *inst, RangeType **normranges, int count);
+extern TemporalInst *tnumberinst_at_ranges(TemporalInst *inst, const RangeBounds *normbounds, int count);
+extern TemporalInst *tnumberinst_minus_ranges(TemporalInst *inst, const RangeBounds *normbounds, int count);
 
 extern bool temporalinst_intersects_timestamp(TemporalInst *inst, TimestampTz t);
 extern bool temporalinst_intersects_timestampset(TemporalInst *inst, TimestampSet *ts);
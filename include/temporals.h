@@ -17,15 +17,22 @@
 #include <catalog/pg_type.h>
 #include <utils/rangetypes.h>
 #include "temporal.h"
+#include "rangetypes_ext.h"
 
 /*****************************************************************************/
 
 /* General functions */
 
 extern TemporalSeq *temporals_seq_n(TemporalS *ts, int index);
+extern Period *temporals_period_n(TemporalS *ts, int index);
 extern TemporalS *temporals_from_temporalseqarr(TemporalSeq **sequences, 
 	int count, bool linear, bool normalize);
+extern TemporalS *temporals_from_temporalseqarr_trusted(TemporalSeq **sequences,
+	int count, bool linear, bool normalize);
+extern TemporalS *tnumbers_from_base_periodarr(Datum value, Oid valuetypid,
+	const Period *periods, int count, bool linear);
 extern TemporalS *temporals_copy(TemporalS *ts);
+extern TemporalS *temporals_with_periods(TemporalS *ts);
 extern bool temporals_find_timestamp(TemporalS *ts, TimestampTz t, int *pos);
 extern double temporals_interval_double(TemporalS *ts);
 
@@ -57,7 +64,8 @@ extern bool synchronize_temporals_temporals(TemporalS *ts1, TemporalS *ts2,
 
 /* Input/output functions */
 
-extern char *temporals_to_string(TemporalS *ts, char *(*value_out)(Oid, Datum));
+extern void temporals_to_string_buf(StringInfo buf, TemporalS *ts,
+	void (*value_out)(StringInfo, Oid, Datum));
 extern void temporals_write(TemporalS *ts, StringInfo buf);
 extern TemporalS *temporals_read(StringInfo buf, Oid valuetypid);
 
@@ -100,7 +108,10 @@ extern int temporals_num_timestamps(TemporalS *ts);
 extern bool temporals_timestamp_n(TemporalS *ts, int n, TimestampTz *result);
 extern TimestampTz *temporals_timestamps1(TemporalS *ts, int *count);
 extern ArrayType *temporals_timestamps(TemporalS *ts);
+extern void temporals_layout(TemporalS *ts, TemporalLayout *layout);
 extern TemporalS *temporals_shift(TemporalS *ts, Interval *interval);
+extern TemporalS *temporals_tscale(TemporalS *ts, TimestampTz origin,
+	double scale);
 
 extern bool temporals_ever_eq(TemporalS *ts, Datum value);
 extern bool temporals_ever_lt(TemporalS *ts, Datum value);
@@ -116,10 +127,10 @@ extern TemporalS *temporals_at_value(TemporalS *ts, Datum value);
 extern TemporalS *temporals_minus_value(TemporalS *ts, Datum value);
 extern TemporalS *temporals_at_values(TemporalS *ts, Datum *values, int count);
 extern TemporalS *temporals_minus_values(TemporalS *ts, Datum *values, int count);
-extern TemporalS *tnumbers_at_range(TemporalS *ts, RangeType *range);
-extern TemporalS *tnumbers_minus_range(TemporalS *ts, RangeType *range);
-extern TemporalS *tnumbers_at_ranges(TemporalS *ts, RangeType **normranges, int count);
-extern TemporalS *tnumbers_minus_ranges(TemporalS *ts, RangeType **normranges, int count);
+extern TemporalS *tnumbers_at_range(TemporalS *ts, const RangeBounds *bounds);
+extern TemporalS *tnumbers_minus_range(TemporalS *ts, const RangeBounds *bounds);
+extern TemporalS *tnumbers_at_ranges(TemporalS *ts, const RangeBounds *normbounds, int count);
+extern TemporalS *tnumbers_minus_ranges(TemporalS *ts, const RangeBounds *normbounds, int count);
 extern TemporalS *temporals_at_min(TemporalS *ts);
 extern TemporalS *temporals_minus_min(TemporalS *ts);
 extern TemporalS *temporals_at_max(TemporalS *ts);
@@ -129,6 +140,7 @@ extern bool temporals_value_at_timestamp(TemporalS *ts, TimestampTz t, Datum *re
 extern TemporalS *temporals_minus_timestamp(TemporalS *ts, TimestampTz t);
 extern TemporalI *temporals_at_timestampset(TemporalS *ts, TimestampSet *ts1);
 extern TemporalS *temporals_minus_timestampset(TemporalS *ts, TimestampSet *ts1);
+extern int temporals_overlapping_seq(TemporalS *ts, Period *p);
 extern TemporalS *temporals_at_period(TemporalS *ts, Period *p);
 extern TemporalS *temporals_minus_period(TemporalS *ts, Period *p);
 extern TemporalS *temporals_at_periodset(TemporalS *ts, PeriodSet *ps);
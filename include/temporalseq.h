@@ -17,14 +17,47 @@
 #include <catalog/pg_type.h>
 #include <utils/rangetypes.h>
 #include "temporal.h"
+#include "rangetypes_ext.h"
+
+/*****************************************************************************/
+
+/* Cursor over the synchronized segments of two temporal sequences */
+
+typedef struct
+{
+	TemporalSeq *seq1;
+	TemporalSeq *seq2;
+	Period		inter;		/* intersection of the periods of the sequences */
+	int			i;			/* next instant of seq1 */
+	int			j;			/* next instant of seq2 */
+	bool		first;		/* no segment has been returned yet */
+	bool		last;		/* the end of the intersection has been reached */
+	TemporalInst *start1;	/* synchronized instants at the start and at */
+	TemporalInst *start2;	/* the end of the current segments */
+	TemporalInst *end1;
+	TemporalInst *end2;
+	bool		freestart1;	/* the instants have been interpolated and */
+	bool		freestart2;	/* must be freed */
+	bool		freeend1;
+	bool		freeend2;
+	bool		lower_inc;	/* bounds of the current segments */
+	bool		upper_inc;
+} SyncSeqCursor;
 
 /*****************************************************************************/
 
 extern TemporalInst *temporalseq_inst_n(TemporalSeq *seq, int index);
 extern TemporalSeq *temporalseq_from_temporalinstarr(TemporalInst **instants, 
 	int count, bool lower_inc, bool upper_inc, bool linear, bool normalize);
+extern TemporalSeq *temporalseq_from_temporalinstarr1(TemporalInst **instants, 
+	int count, bool lower_inc, bool upper_inc, bool linear, bool normalize,
+	const void *bbox);
+extern TemporalSeq *temporalseq_from_temporalinstarr_trusted(
+	TemporalInst **instants, int count, bool lower_inc, bool upper_inc,
+	bool linear, bool normalize);
 extern TemporalSeq *temporalseq_copy(TemporalSeq *seq);
 extern int temporalseq_find_timestamp(TemporalSeq *seq, TimestampTz t);
+extern bool temporalseq_fetch_slice(Datum value, Period *p, TemporalSeq **result);
 extern Datum temporalseq_value_at_timestamp1(TemporalInst *inst1, 
 	TemporalInst *inst2, bool linear, TimestampTz t);
 extern TemporalSeq **temporalseqarr_normalize(TemporalSeq **sequences, int count, 
@@ -47,6 +80,10 @@ extern bool intersection_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq
 
 extern bool synchronize_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2, 
 	TemporalSeq **sync1, TemporalSeq **sync2, bool interpoint);
+extern bool temporalseq_sync_cursor_init(SyncSeqCursor *cursor,
+	TemporalSeq *seq1, TemporalSeq *seq2);
+extern bool temporalseq_sync_cursor_next(SyncSeqCursor *cursor);
+extern void temporalseq_sync_cursor_end(SyncSeqCursor *cursor);
 
 extern bool tpointseq_intersect_at_timestamp(TemporalInst *start1, TemporalInst *end1, 
 	bool linear1, TemporalInst *start2, TemporalInst *end2, bool linear2, TimestampTz *t);
@@ -55,12 +92,16 @@ extern bool temporalseq_intersect_at_timestamp(TemporalInst *start1, TemporalIns
 
 /* Input/output functions */
 
-extern char *temporalseq_to_string(TemporalSeq *seq, bool component, char *(*value_out)(Oid, Datum));
+extern void temporalseq_to_string_buf(StringInfo buf, TemporalSeq *seq,
+	bool component, void (*value_out)(StringInfo, Oid, Datum));
 extern void temporalseq_write(TemporalSeq *seq, StringInfo buf);
 extern TemporalSeq *temporalseq_read(StringInfo buf, Oid valuetypid);
 
 /* Append function */
 
+extern void temporalseq_ensure_append(TemporalInst *inst1, TemporalInst *inst);
+extern bool temporalseq_append_replaces(TemporalInst *inst1, TemporalInst *inst2, 
+	TemporalInst *inst, bool linear);
 extern TemporalSeq *temporalseq_append_instant(TemporalSeq *seq, TemporalInst *inst);
 
 /* Cast functions */
@@ -83,6 +124,8 @@ extern ArrayType *temporalseq_values(TemporalSeq *seq);
 extern int tfloatseq_ranges1(RangeType **result, TemporalSeq *seq);
 extern PeriodSet *temporalseq_get_time(TemporalSeq *seq);
 extern void *temporalseq_bbox_ptr(TemporalSeq *seq);
+extern TemporalSeqSummary *temporalseq_summary_ptr(TemporalSeq *seq);
+extern void temporalseq_update_summary(TemporalSeq *seq);
 extern void temporalseq_bbox(void *box, TemporalSeq *seq);
 extern RangeType *tfloatseq_range(TemporalSeq *seq);
 extern ArrayType *tfloatseq_ranges(TemporalSeq *seq);
@@ -95,9 +138,15 @@ extern ArrayType *temporalseq_instants_array(TemporalSeq *seq);
 extern TimestampTz temporalseq_start_timestamp(TemporalSeq *seq);
 extern TimestampTz temporalseq_end_timestamp(TemporalSeq *seq);
 extern TimestampTz *temporalseq_timestamps1(TemporalSeq *seq);
+extern double *tnumberseq_values_double(TemporalSeq *seq);
 extern ArrayType *temporalseq_timestamps(TemporalSeq *seq);
+extern void temporalseq_layout(TemporalSeq *seq, TemporalLayout *layout);
 extern TemporalSeq *temporalseq_shift(TemporalSeq *seq, 
 	Interval *interval);
+extern void temporalseq_tscale1(TemporalSeq *seq, TimestampTz origin,
+	double scale);
+extern TemporalSeq *temporalseq_tscale(TemporalSeq *seq, TimestampTz origin,
+	double scale);
 
 extern bool temporalseq_ever_eq(TemporalSeq *seq, Datum value);
 extern bool temporalseq_ever_lt(TemporalSeq *seq, Datum value);
@@ -111,6 +160,8 @@ extern bool temporalseq_always_le(TemporalSeq *seq, Datum value);
 
 extern bool tlinearseq_timestamp_at_value(TemporalInst *inst1, TemporalInst *inst2, 
 	Datum value, Oid valuetypid, TimestampTz *t);
+extern int tnumberseq_at_value_periods(TemporalSeq *seq, double value,
+	Period *periods, int count);
 extern int temporalseq_at_value2(TemporalSeq **result, TemporalSeq *seq, Datum value);
 extern TemporalS *temporalseq_at_value(TemporalSeq *seq, Datum value);
 extern int temporalseq_minus_value2(TemporalSeq **result, TemporalSeq *seq, Datum value);
@@ -121,18 +172,22 @@ extern TemporalS *temporalseq_at_values(TemporalSeq *seq, Datum *values, int cou
 extern int temporalseq_minus_values1(TemporalSeq **result, TemporalSeq *seq, Datum *values, 
 	int count);
 extern TemporalS *temporalseq_minus_values(TemporalSeq *seq, Datum *values, int count);
-extern int tnumberseq_at_range2(TemporalSeq **result, TemporalSeq *seq, RangeType *range);
-extern TemporalS *tnumberseq_at_range(TemporalSeq *seq, RangeType *range);
-extern int tnumberseq_minus_range1(TemporalSeq **result, TemporalSeq *seq, RangeType *range);
-extern TemporalS *tnumberseq_minus_range(TemporalSeq *seq, RangeType *range);
+extern int tnumberseq_at_range2(TemporalSeq **result, TemporalSeq *seq,
+	const RangeBounds *bounds);
+extern TemporalS *tnumberseq_at_range(TemporalSeq *seq, const RangeBounds *bounds);
+extern int tnumberseq_minus_range1(TemporalSeq **result, TemporalSeq *seq,
+	const RangeBounds *bounds);
+extern TemporalS *tnumberseq_minus_range(TemporalSeq *seq, const RangeBounds *bounds);
 extern int tnumberseq_at_ranges1(TemporalSeq **result, TemporalSeq *seq, 
-	RangeType **normranges, int count);
+	const RangeBounds *normbounds, int count);
 extern TemporalS *tnumberseq_at_ranges(TemporalSeq *seq, 
-	RangeType **normranges, int count);
+	const RangeBounds *normbounds, int count);
 extern int tnumberseq_minus_ranges1(TemporalSeq **result, TemporalSeq *seq, 
-	RangeType **normranges, int count);
+	const RangeBounds *normbounds, int count);
 extern TemporalS *tnumberseq_minus_ranges(TemporalSeq *seq,
-	RangeType **normranges, int count);
+	const RangeBounds *normbounds, int count);
+extern int tnumberseq_minmax_bound_periods(TemporalSeq *seq, double value,
+	Period *periods, int count);
 extern int temporalseq_at_minmax(TemporalSeq **result, TemporalSeq *seq, Datum value);
 extern TemporalS *temporalseq_at_min(TemporalSeq *seq);
 extern TemporalS *temporalseq_minus_min(TemporalSeq *seq);
@@ -145,10 +200,14 @@ extern bool temporalseq_value_at_timestamp(TemporalSeq *seq, TimestampTz t, Datu
 extern int temporalseq_minus_timestamp1(TemporalSeq **result, TemporalSeq *seq, 
 	TimestampTz t);
 extern TemporalS *temporalseq_minus_timestamp(TemporalSeq *seq, TimestampTz t);
+extern int temporalseq_at_timestampset1(TemporalInst **result, TemporalSeq *seq,
+	TimestampSet *ts);
 extern TemporalI *temporalseq_at_timestampset(TemporalSeq *seq, TimestampSet *ts);
 extern int temporalseq_minus_timestampset1(TemporalSeq **result, TemporalSeq *seq, 
 	TimestampSet *ts);
 extern TemporalS *temporalseq_minus_timestampset(TemporalSeq *seq, TimestampSet *ts);
+extern TemporalInst **temporalseq_at_period_instants(TemporalSeq *seq,
+	const Period *inter, int *n, int *count);
 extern TemporalSeq *temporalseq_at_period(TemporalSeq *seq, Period *p);
 extern TemporalS *temporalseq_minus_period(TemporalSeq *seq, Period *p);
 extern int temporalseq_at_periodset1(TemporalSeq **result, TemporalSeq *seq, PeriodSet *ps);
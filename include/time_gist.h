@@ -27,6 +27,17 @@ extern Datum gist_period_penalty(PG_FUNCTION_ARGS);
 extern Datum gist_period_picksplit(PG_FUNCTION_ARGS);
 extern Datum gist_period_same(PG_FUNCTION_ARGS);
 extern Datum gist_period_fetch(PG_FUNCTION_ARGS);
+extern Datum gist_period_distance(PG_FUNCTION_ARGS);
+
+extern Datum gist_periodset_multi_consistent(PG_FUNCTION_ARGS);
+extern Datum gist_periodset_multi_union(PG_FUNCTION_ARGS);
+extern Datum gist_periodset_multi_compress(PG_FUNCTION_ARGS);
+extern Datum gist_periodset_multi_penalty(PG_FUNCTION_ARGS);
+extern Datum gist_periodset_multi_picksplit(PG_FUNCTION_ARGS);
+extern Datum gist_periodset_multi_same(PG_FUNCTION_ARGS);
+extern Datum gist_periodset_multi_distance(PG_FUNCTION_ARGS);
+
+extern int gist_max_periods;
 
 extern bool index_leaf_consistent_time(Period *key, Period *query, StrategyNumber strategy);
 extern bool index_internal_consistent_period(Period *key, Period *query, StrategyNumber strategy);
@@ -23,6 +23,8 @@
 
 extern double calc_period_hist_selectivity(VariableStatData *vardata,
 	Period *constval, CachedOp cachedOp);
+extern double calc_periodset_hist_selectivity(VariableStatData *vardata,
+	PeriodSet *ps, CachedOp cachedOp);
 extern double calc_period_hist_selectivity_scalar(PeriodBound *constbound,
 	PeriodBound *hist, int hist_nvalues, bool equal);
 extern double calc_period_hist_selectivity_contained(PeriodBound *lower,
@@ -34,6 +36,8 @@ extern double calc_period_hist_selectivity_contains(PeriodBound *lower,
 extern double calc_period_hist_selectivity_adjacent(PeriodBound *lower,
 	PeriodBound *upper, PeriodBound *hist_lower,
 	PeriodBound *hist_upper, int hist_nvalues);
+extern double calc_period_hist_joinselectivity(VariableStatData *vardata1,
+	VariableStatData *vardata2);
 
 extern int length_hist_bsearch(Datum *length_hist_values,
 	int length_hist_nvalues, double value, bool equal);
@@ -287,6 +287,8 @@ extern Datum intersection_periodset_periodset(PG_FUNCTION_ARGS);
 
 extern TimestampSet *intersection_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet *ts2);
 extern TimestampSet *intersection_timestampset_period_internal(TimestampSet *ts, Period *p);
+extern bool intersection_period_period_internal1(Period *result, const Period *p1,
+	const Period *p2);
 extern Period *intersection_period_period_internal(Period *p1, Period *p2);
 extern PeriodSet *intersection_period_periodset_internal(Period *p, PeriodSet *ps);
 extern PeriodSet *intersection_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2);
@@ -323,6 +325,17 @@ extern PeriodSet *minus_periodset_timestampset_internal(PeriodSet *ps, Timestamp
 extern PeriodSet *minus_periodset_period_internal(PeriodSet *ps, Period *p);
 extern PeriodSet *minus_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2);
 
+extern Datum distance_timestamp_timestampset(PG_FUNCTION_ARGS);
+extern Datum distance_timestamp_period(PG_FUNCTION_ARGS);
+extern Datum distance_timestamp_periodset(PG_FUNCTION_ARGS);
+extern Datum distance_timestampset_timestamp(PG_FUNCTION_ARGS);
+extern Datum distance_period_timestamp(PG_FUNCTION_ARGS);
+extern Datum distance_periodset_timestamp(PG_FUNCTION_ARGS);
+
+extern double period_timestamp_distance_internal(const Period *p, TimestampTz t);
+extern double timestampset_timestamp_distance_internal(TimestampSet *ts, TimestampTz t);
+extern double periodset_timestamp_distance_internal(PeriodSet *ps, TimestampTz t);
+
 #endif
 
 /*****************************************************************************/
\ No newline at end of file
@@ -21,6 +21,7 @@
 
 /* assorted support functions */
 
+extern TimestampTz *timestampset_times_ptr(TimestampSet *ts);
 extern TimestampTz timestampset_time_n(TimestampSet *ts, int index);
 extern Period *timestampset_bbox(TimestampSet *ts);
 extern TimestampSet *timestampset_from_timestamparr_internal(TimestampTz *times, int count);
@@ -62,6 +63,7 @@ extern TimestampSet *timestampset_shift_internal(TimestampSet *ts, Interval *int
 /* Functions for defining B-tree index */
 
 extern Datum timestampset_cmp(PG_FUNCTION_ARGS);
+extern Datum timestampset_sortsupport(PG_FUNCTION_ARGS);
 extern Datum timestampset_eq(PG_FUNCTION_ARGS);
 extern Datum timestampset_ne(PG_FUNCTION_ARGS);
 extern Datum timestampset_lt(PG_FUNCTION_ARGS);
@@ -44,21 +44,33 @@ typedef struct
 {
 	int32 vl_len_;				/* varlena header (do not touch directly!) */
 	int32 count;				/* number of Period elements */
+	int16 flags;				/* format of the value */
  	/* variable-length data follows */
 } PeriodSet;
 
 typedef struct 
 {
 	int32 vl_len_;				/* varlena header (do not touch directly!) */
-	int32 count;				/* number of Period elements */
+	int32 count;				/* number of TimestampTz elements */
+	int16 flags;				/* format of the value */
  	/* variable-length data follows */
 } TimestampSet;
 
+/*
+ * Flag of the period sets and the timestamp sets whose components are
+ * stored in a packed array. It is never set in the values of the first
+ * on-disk format, whose header was followed by an array of offsets.
+ */
+#define TIME_PACKED			0x0001
+
+extern PeriodSet *periodset_packed(PeriodSet *ps);
+extern TimestampSet *timestampset_packed(TimestampSet *ts);
+
 /*
  * fmgr macros for time types
  */
 
-#define DatumGetTimestampSet(X)		((TimestampSet *) DatumGetPointer(X))
+#define DatumGetTimestampSet(X)		timestampset_packed((TimestampSet *) DatumGetPointer(X))
 #define TimestampSetGetDatum(X)		PointerGetDatum(X)
 #define PG_GETARG_TIMESTAMPSET(n)	DatumGetTimestampSet(PG_GETARG_POINTER(n))
 #define PG_RETURN_TIMESTAMPSET(x)	PG_RETURN_POINTER(x)
@@ -68,7 +80,7 @@ typedef struct
 #define PG_GETARG_PERIOD(n)			DatumGetPeriod(PG_GETARG_POINTER(n))
 #define PG_RETURN_PERIOD(x)			PG_RETURN_POINTER(x)
 
-#define DatumGetPeriodSet(X)		((PeriodSet *) DatumGetPointer(X))
+#define DatumGetPeriodSet(X)		periodset_packed((PeriodSet *) DatumGetPointer(X))
 #define PeriodSetGetDatum(X)		PointerGetDatum(X)
 #define PG_GETARG_PERIODSET(n)		DatumGetPeriodSet(PG_GETARG_POINTER(n))
 #define PG_RETURN_PERIODSET(x)		PG_RETURN_POINTER(x)
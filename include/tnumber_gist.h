@@ -19,12 +19,35 @@
 
 /*****************************************************************************/
 
+/* Compact GiST key for temporal numbers */
+
+typedef struct
+{
+	float4		xmin;			/* minimum number value rounded down */
+	float4		xmax;			/* maximum number value rounded up */
+	TimestampTz	tmin;			/* minimum timestamp */
+	int32		tspan;			/* seconds until the maximum timestamp rounded 
+								 * up, -1 if unbounded */
+	int16		flags;			/* flags */
+} TBOXF;
+
+/*****************************************************************************/
+
 extern Datum gist_tbox_union(PG_FUNCTION_ARGS);
 extern Datum gist_tbox_penalty(PG_FUNCTION_ARGS);
 extern Datum gist_tbox_picksplit(PG_FUNCTION_ARGS);
 extern Datum gist_tnumber_consistent(PG_FUNCTION_ARGS);
 extern Datum gist_tnumber_compress(PG_FUNCTION_ARGS);
 extern Datum gist_tbox_same(PG_FUNCTION_ARGS);
+extern Datum gist_tnumber_distance(PG_FUNCTION_ARGS);
+extern Datum tbox_zorder(PG_FUNCTION_ARGS);
+extern Datum tnumber_zorder(PG_FUNCTION_ARGS);
+
+extern Datum tboxf_in(PG_FUNCTION_ARGS);
+extern Datum tboxf_out(PG_FUNCTION_ARGS);
+extern Datum gist_tnumber_compact_consistent(PG_FUNCTION_ARGS);
+extern Datum gist_tnumber_compact_compress(PG_FUNCTION_ARGS);
+extern Datum gist_tnumber_compact_decompress(PG_FUNCTION_ARGS);
 
 /* The following functions are also called by IndexSpgistTnumber.c */
 extern bool index_leaf_consistent_tbox(TBOX *key, TBOX *query, StrategyNumber strategy);
@@ -21,6 +21,7 @@
 
 extern Datum tnumber_sel(PG_FUNCTION_ARGS);
 extern Datum tnumber_joinsel(PG_FUNCTION_ARGS);
+extern Datum tnumber_estimated_tbox(PG_FUNCTION_ARGS);
 
 /*****************************************************************************/
 
@@ -96,6 +96,11 @@ extern void temporalgeom_init();
 
 extern Datum tpoint_in(PG_FUNCTION_ARGS);
 
+/* Constructor functions */
+
+extern Datum tpointseq_from_xyt_arrays(PG_FUNCTION_ARGS);
+extern Datum tpointseq_from_xyzt_arrays(PG_FUNCTION_ARGS);
+
 /* Accessor functions */
 
 extern Datum tpoint_values(PG_FUNCTION_ARGS);
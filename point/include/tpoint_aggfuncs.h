@@ -15,6 +15,67 @@
 
 #include <postgres.h>
 #include <catalog/pg_type.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+/*
+ * CentroidState - Internal type for computing the temporal centroid
+ *
+ * The points of the aggregated values are kept in a flat array in which the
+ * points of a sequence are contiguous. The state is a varlena so that it can
+ * be serialized as is and combined by concatenating the points.
+ */
+
+#define CENTROID_FIRST       0x01  /* First point of a sequence */
+#define CENTROID_LAST        0x02  /* Last point of a sequence */
+#define CENTROID_LOWER_INC   0x04  /* Lower bound of the sequence is inclusive */
+#define CENTROID_UPPER_INC   0x08  /* Upper bound of the sequence is inclusive */
+
+typedef struct
+{
+	TimestampTz t;
+	double x;
+	double y;
+	double z;
+	int32 flags;
+} CentroidPoint;
+
+typedef struct
+{
+	int32 vl_len_;       /* Varlena header (do not touch directly!) */
+	int32 srid;
+	bool hasz;
+	bool linear;
+	int16 duration;      /* TEMPORALINST for instants, TEMPORALSEQ otherwise */
+	int32 count;         /* Number of points */
+	int32 capacity;      /* Number of points allocated */
+	CentroidPoint points[FLEXIBLE_ARRAY_MEMBER];
+} CentroidState;
+
+/*
+ * TripState - Internal type for assembling trips from points and timestamps
+ */
+
+typedef struct
+{
+	TimestampTz t;
+	double x;
+	double y;
+	double z;
+	bool first;          /* First point of a trip */
+} TripPoint;
+
+typedef struct
+{
+	int32 srid;
+	bool hasz;
+	int64 maxgap;        /* Maximum gap in microseconds, -1 for none */
+	double maxdist;      /* Maximum distance, -1 for none */
+	int32 count;         /* Number of points */
+	int32 capacity;      /* Number of points allocated */
+	TripPoint points[FLEXIBLE_ARRAY_MEMBER];
+} TripState;
 
 /*****************************************************************************/
 
@@ -23,8 +84,13 @@ extern Datum tpoint_extent_combinefn(PG_FUNCTION_ARGS);
 
 extern Datum tpoint_tcentroid_transfn(PG_FUNCTION_ARGS);
 extern Datum tpoint_tcentroid_combinefn(PG_FUNCTION_ARGS);
+extern Datum tpoint_tcentroid_serialize(PG_FUNCTION_ARGS);
+extern Datum tpoint_tcentroid_deserialize(PG_FUNCTION_ARGS);
 extern Datum tpoint_tcentroid_finalfn(PG_FUNCTION_ARGS);
 
+extern Datum tpoint_seqset_agg_transfn(PG_FUNCTION_ARGS);
+extern Datum tpoint_seqset_agg_finalfn(PG_FUNCTION_ARGS);
+
 /*****************************************************************************/
 
 #endif
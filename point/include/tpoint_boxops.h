@@ -38,6 +38,7 @@ extern void tpointinst_make_stbox(STBOX *box, Datum value, TimestampTz t);
 extern void tpointinstarr_to_stbox(STBOX *box, TemporalInst **inst, int count);
 extern void tpointseqarr_to_stbox(STBOX *box, TemporalSeq **seq, int count);
 
+extern void tpointinst_expand_stbox(STBOX *box, TemporalInst *inst);
 extern void tpoint_expand_stbox(STBOX *box, Temporal *temp, TemporalInst *inst);
 
 /* Functions for expanding the bounding box */
@@ -54,6 +55,8 @@ extern Datum geo_timestamp_to_stbox(PG_FUNCTION_ARGS);
 extern Datum geo_period_to_stbox(PG_FUNCTION_ARGS);
 
 extern bool geo_to_stbox_internal(STBOX *box, GSERIALIZED *gs);
+extern bool geo_to_stbox_fn(STBOX *box, GSERIALIZED *gs,
+	FunctionCallInfo fcinfo, int argno);
 extern void timestamp_to_stbox_internal(STBOX *box, TimestampTz t);
 extern void timestampset_to_stbox_internal(STBOX *box, TimestampSet *ps);
 extern void period_to_stbox_internal(STBOX *box, Period *p);
@@ -0,0 +1,27 @@
+/*****************************************************************************
+ *
+ * tpoint_brin.h
+ *	  BRIN inclusion index for temporal points
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TPOINT_BRIN_H__
+#define __TPOINT_BRIN_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+extern Datum brin_stbox_merge(PG_FUNCTION_ARGS);
+extern Datum brin_tpoint_add_value(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
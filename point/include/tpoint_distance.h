@@ -15,10 +15,19 @@
 
 #include <postgres.h>
 #include <catalog/pg_type.h>
+#include <utils/guc.h>
 #include "temporal.h"
 
 /*****************************************************************************/
 
+/* Models of the Earth for the distance between geography points */
+
+#define GEODETIC_SPHEROID	0
+#define GEODETIC_SPHERE		1
+
+extern int geodetic_distance;
+extern const struct config_enum_entry geodetic_distance_options[];
+
 extern Datum geom_distance2d(Datum geom1, Datum geom2);
 extern Datum geom_distance3d(Datum geom1, Datum geom2);
 extern Datum geog_distance(Datum geog1, Datum geog2);
@@ -32,6 +41,11 @@ extern bool tpointseq_min_dist_at_timestamp(TemporalInst *start1, TemporalInst *
 
 extern Temporal *distance_tpoint_tpoint_internal(Temporal *temp1, Temporal *temp2);
 
+extern Datum frechet_distance_tpoint_tpoint(PG_FUNCTION_ARGS);
+extern Datum dtw_distance_tpoint_tpoint(PG_FUNCTION_ARGS);
+extern Datum frechet_dwithin_tpoint_tpoint(PG_FUNCTION_ARGS);
+extern Datum dtw_dwithin_tpoint_tpoint(PG_FUNCTION_ARGS);
+
 /*****************************************************************************/
 
 #endif
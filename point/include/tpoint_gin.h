@@ -0,0 +1,45 @@
+/*****************************************************************************
+ *
+ * tpoint_gin.h
+ *	  Multi-entry GIN index for temporal points.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse, 
+ * 		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TPOINT_GIN_H__
+#define __TPOINT_GIN_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+/* Strategy numbers of the GIN operator class, one per type of query since
+ * the extractQuery method does not receive the type of its argument */
+
+#define GIN_OVERLAPS_GEOM_STRATEGY		1
+#define GIN_OVERLAPS_STBOX_STRATEGY		2
+#define GIN_OVERLAPS_TPOINT_STRATEGY	3
+#define GIN_CONTAINED_GEOM_STRATEGY		4
+#define GIN_CONTAINED_STBOX_STRATEGY	5
+#define GIN_CONTAINED_TPOINT_STRATEGY	6
+
+extern int gin_max_boxes;
+
+extern STBOX *tpoint_split_stboxes(Temporal *temp, int count, int *newcount);
+
+extern Datum tpoint_split_stboxes_sql(PG_FUNCTION_ARGS);
+extern Datum gin_stbox_cmp(PG_FUNCTION_ARGS);
+extern Datum gin_tpoint_extract_value(PG_FUNCTION_ARGS);
+extern Datum gin_tpoint_extract_query(PG_FUNCTION_ARGS);
+extern Datum gin_tpoint_compare_partial(PG_FUNCTION_ARGS);
+extern Datum gin_tpoint_consistent(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
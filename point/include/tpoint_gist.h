@@ -20,12 +20,41 @@
 
 /*****************************************************************************/
 
+/* Compact GiST key for temporal points */
+
+typedef struct
+{
+	float4		xmin;			/* minimum x value rounded down */
+	float4		xmax;			/* maximum x value rounded up */
+	float4		ymin;			/* minimum y value rounded down */
+	float4		ymax;			/* maximum y value rounded up */
+	float4		zmin;			/* minimum z value rounded down */
+	float4		zmax;			/* maximum z value rounded up */
+	TimestampTz	tmin;			/* minimum timestamp */
+	int32		tspan;			/* seconds until the maximum timestamp rounded 
+								 * up, -1 if unbounded */
+	int16		flags;			/* flags */
+} STBOXF;
+
+/*****************************************************************************/
+
+extern double gist_time_weight;
+
 extern Datum gist_tpoint_consistent(PG_FUNCTION_ARGS);
 extern Datum gist_tpoint_union(PG_FUNCTION_ARGS);
 extern Datum gist_tpoint_penalty(PG_FUNCTION_ARGS);
 extern Datum gist_tpoint_picksplit(PG_FUNCTION_ARGS);
 extern Datum gist_tpoint_same(PG_FUNCTION_ARGS);
 extern Datum gist_tpoint_compress(PG_FUNCTION_ARGS);
+extern Datum gist_tpoint_distance(PG_FUNCTION_ARGS);
+extern Datum stbox_zorder(PG_FUNCTION_ARGS);
+extern Datum tpoint_zorder(PG_FUNCTION_ARGS);
+
+extern Datum stboxf_in(PG_FUNCTION_ARGS);
+extern Datum stboxf_out(PG_FUNCTION_ARGS);
+extern Datum gist_tpoint_compact_consistent(PG_FUNCTION_ARGS);
+extern Datum gist_tpoint_compact_compress(PG_FUNCTION_ARGS);
+extern Datum gist_tpoint_compact_decompress(PG_FUNCTION_ARGS);
 
 /* The following functions are also called by IndexSpgistTPoint.c */
 extern bool index_tpoint_recheck(StrategyNumber strategy);
@@ -0,0 +1,30 @@
+/*****************************************************************************
+ *
+ * tpoint_incremental.h
+ *	  Incremental computation of temporal relationships over streams of
+ *	  temporal points
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TPOINT_INCREMENTAL_H__
+#define __TPOINT_INCREMENTAL_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+extern Datum tintersects_append_tpoint_geo(PG_FUNCTION_ARGS);
+extern Datum tdwithin_append_tpoint_geo(PG_FUNCTION_ARGS);
+extern Datum tdwithin_append_tpoint_tpoint(PG_FUNCTION_ARGS);
+extern Datum distance_append_tpoint_tpoint(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
@@ -0,0 +1,26 @@
+/*****************************************************************************
+ *
+ * tpoint_load.h
+ *	  Bulk load of temporal points from files
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TPOINT_LOAD_H__
+#define __TPOINT_LOAD_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+extern Datum tgeompoint_load_csv(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
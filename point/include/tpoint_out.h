@@ -15,6 +15,7 @@
 
 #include <postgres.h>
 #include <catalog/pg_type.h>
+#include <lib/stringinfo.h>
 
 /*****************************************************************************/
 
@@ -29,6 +30,8 @@ extern Datum tpoint_as_binary(PG_FUNCTION_ARGS);
 extern Datum tpoint_as_ewkb(PG_FUNCTION_ARGS);
 extern Datum tpoint_as_hexewkb(PG_FUNCTION_ARGS);
 
+extern void point_hexewkb_buf(StringInfo buf, Datum value);
+
 /*****************************************************************************/
 
 #endif
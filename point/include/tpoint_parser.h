@@ -19,6 +19,7 @@
 
 /*****************************************************************************/
 
+extern bool geometry_point_parse_fast(const char *str, Datum *result);
 extern STBOX *stbox_parse(char **str);
 extern Temporal *tpoint_parse(char **str, Oid basetype);
 
@@ -0,0 +1,26 @@
+/*****************************************************************************
+ *
+ * tpoint_random.h
+ *	  Generation of random temporal points for benchmarks
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TPOINT_RANDOM_H__
+#define __TPOINT_RANDOM_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+extern Datum random_tgeompoint_seq(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
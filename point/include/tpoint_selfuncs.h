@@ -111,6 +111,7 @@ typedef struct ND_STATS_T
 
 extern Datum tpoint_sel(PG_FUNCTION_ARGS);
 extern Datum tpoint_joinsel(PG_FUNCTION_ARGS);
+extern Datum tpoint_estimated_stbox(PG_FUNCTION_ARGS);
 
 /*****************************************************************************/
 
@@ -41,6 +41,10 @@ extern POINT2D datum_get_point2d(Datum value);
 extern POINT3DZ datum_get_point3dz(Datum value);
 extern bool datum_point_eq(Datum geopoint1, Datum geopoint2);
 extern GSERIALIZED* geometry_serialize(LWGEOM* geom);
+extern GSERIALIZED *gspoint_make(double x, double y, double z, bool hasz,
+	bool geodetic, int32 srid);
+extern TemporalInst *tpointinst_make(double x, double y, double z, bool hasz,
+	bool geodetic, int32 srid, TimestampTz t);
 
 /* Functions for spatial reference systems */
 
@@ -65,6 +69,8 @@ extern TemporalS *tgeogpoints_to_tgeompoints(TemporalS *ts);
 extern Datum tpoint_trajectory(PG_FUNCTION_ARGS);
 
 extern Datum tpoint_trajectory_internal(Temporal *temp);
+extern Datum tpoint_trajectory_cached(FunctionCallInfo fcinfo, Temporal *temp,
+	int argno, bool *tofree);
 extern Datum tpointseq_make_trajectory(TemporalInst **instants, int count, bool linear);
 extern Datum tpointseq_trajectory_append(TemporalSeq *seq, TemporalInst *inst, bool replace);
 
@@ -77,6 +83,8 @@ extern Datum tpoints_trajectory(TemporalS *ts);
 
 /* Length, speed, time-weighted centroid, and temporal azimuth functions */
 
+extern double tpointseg_length(TemporalInst *inst1, TemporalInst *inst2);
+extern double tpointseq_length(TemporalSeq *seq);
 extern Datum tpoint_length(PG_FUNCTION_ARGS);
 extern Datum tpoint_cumulative_length(PG_FUNCTION_ARGS);
 extern Datum tpoint_speed(PG_FUNCTION_ARGS);
@@ -87,10 +95,17 @@ extern Datum tgeompointi_twcentroid(TemporalI *ti);
 extern Datum tgeompointseq_twcentroid(TemporalSeq *seq);
 extern Datum tgeompoints_twcentroid(TemporalS *ts);
 
+/* Simplification functions */
+
+extern Datum tpoint_simplify(PG_FUNCTION_ARGS);
+extern Datum tpoint_speed_simplify(PG_FUNCTION_ARGS);
+
 /* Restriction functions */
 
 extern Datum tpoint_at_geometry(PG_FUNCTION_ARGS);
+extern Datum tpoint_at_geometries(PG_FUNCTION_ARGS);
 extern Datum tpoint_minus_geometry(PG_FUNCTION_ARGS);
+extern Datum tpoint_at_stbox(PG_FUNCTION_ARGS);
 
 extern TemporalSeq **tpointseq_at_geometry2(TemporalSeq *seq, Datum geo, int *count);
 
@@ -103,6 +118,7 @@ extern Datum NAI_tpoint_tpoint(PG_FUNCTION_ARGS);
 extern Datum NAD_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum NAD_tpoint_geo(PG_FUNCTION_ARGS);
 extern Datum NAD_tpoint_tpoint(PG_FUNCTION_ARGS);
+extern Datum NAD_tpointarr_tpointarr(PG_FUNCTION_ARGS);
 
 extern Datum shortestline_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum shortestline_tpoint_geo(PG_FUNCTION_ARGS);
@@ -16,6 +16,8 @@
 #include <postgres.h>
 #include <catalog/pg_type.h>
 
+#include "temporal.h"
+
 /*****************************************************************************/
 
 extern Datum geom_contains(Datum geom1, Datum geom2);
@@ -40,6 +42,11 @@ extern Datum geog_coveredby(Datum geog1, Datum geog2);
 extern Datum geog_intersects(Datum geog1, Datum geog2);
 extern Datum geog_dwithin(Datum geog1, Datum geog2, Datum dist);
 
+extern bool stbox_spatial_far(const STBOX *box1, const STBOX *box2, double d,
+	bool hasz);
+extern bool segments_spatial_far(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
+	double d, bool hasz);
+
 extern Datum contains_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum contains_tpoint_geo(PG_FUNCTION_ARGS);
 extern Datum contains_tpoint_tpoint(PG_FUNCTION_ARGS);
@@ -14,7 +14,9 @@
 #define __TPOINT_TEMPSPATIALRELS_H__
 
 #include <postgres.h>
+#include <liblwgeom.h>
 #include <catalog/pg_type.h>
+#include "temporal.h"
 
 /*****************************************************************************/
 
@@ -62,6 +64,14 @@ extern Datum trelate_pattern_geo_tpoint(PG_FUNCTION_ARGS);
 extern Datum trelate_pattern_tpoint_geo(PG_FUNCTION_ARGS);
 extern Datum trelate_pattern_tpoint_tpoint(PG_FUNCTION_ARGS);
 
+extern Datum tdwithin_join_tpoint_tpoint(PG_FUNCTION_ARGS);
+
+extern Temporal *tintersects_tpoint_geo_internal(Temporal *temp, GSERIALIZED *gs);
+extern Temporal *tdwithin_tpoint_geo_internal(Temporal *temp, GSERIALIZED *gs,
+	Datum dist);
+extern Temporal *tdwithin_tpoint_tpoint_internal(Temporal *temp1, Temporal *temp2,
+	Datum dist);
+
 /*****************************************************************************/
 
 #endif
@@ -0,0 +1,29 @@
+/*****************************************************************************
+ *
+ * tpoint_tile.h
+ *	  Split of temporal points according to a spatiotemporal grid
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#ifndef __TPOINT_TILE_H__
+#define __TPOINT_TILE_H__
+
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include "temporal.h"
+
+/*****************************************************************************/
+
+extern Datum tpoint_space_time_split(PG_FUNCTION_ARGS);
+extern Datum tpoint_tile_keys(PG_FUNCTION_ARGS);
+extern Datum stbox_tile_keys(PG_FUNCTION_ARGS);
+extern Datum tpoint_as_mvtgeom(PG_FUNCTION_ARGS);
+
+/*****************************************************************************/
+
+#endif
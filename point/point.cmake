@@ -4,12 +4,15 @@ add_definitions(-DWITH_POSTGIS)
 include_directories("point/include")
 
 set(SRCPOINT
+point/src/debug/random_tpoint.c
 point/src/stbox.c
 point/src/tpoint_aggfuncs.c
 point/src/tpoint_boxops.c
 point/src/tpoint_parser.c
 point/src/tpoint_posops.c
 point/src/tpoint_gist.c
+point/src/tpoint_gin.c
+point/src/tpoint_brin.c
 point/src/tpoint_spgist.c
 point/src/projection_gk.c
 point/src/tpoint_spatialfuncs.c
@@ -21,6 +24,9 @@ point/src/tpoint_out.c
 point/src/tpoint_analyze.c
 point/src/tpoint_selfuncs.c
 point/src/tpoint_tempspatialrels.c
+point/src/tpoint_tile.c
+point/src/tpoint_incremental.c
+point/src/tpoint_load.c
 )
 
 set(SQLPOINT
@@ -38,6 +44,12 @@ point/src/sql/66_tpoint_spatialrels.in.sql
 point/src/sql/68_tpoint_tempspatialrels.in.sql
 point/src/sql/70_tpoint_gist.in.sql
 point/src/sql/72_tpoint_spgist.in.sql
+point/src/sql/74_tpoint_gin.in.sql
+point/src/sql/76_tpoint_brin.in.sql
+point/src/sql/78_tpoint_tile.in.sql
+point/src/sql/80_tpoint_incremental.in.sql
+point/src/sql/82_tpoint_load.in.sql
+point/src/sql/84_tpoint_random.in.sql
 )
 
 target_sources(${CMAKE_PROJECT_NAME} PRIVATE ${SRCPOINT})
@@ -0,0 +1,193 @@
+/*****************************************************************************
+ *
+ * random_tpoint.c
+ *	  Generation of random temporal points for benchmarks
+ *
+ * The points of the sequences are in the spatial extent of a box and their
+ * timestamps start at a random timestamp of its period. The distributions
+ * are the following ones, where the distances are relative to the extent of
+ * the box and the points that would leave it are reflected at its sides.
+ * - uniform: independent points uniformly distributed
+ * - walk: random walk with normally distributed steps
+ * - clustered: random walk that is attracted by one of a few centers of the
+ *   box, which are the same for all the sequences generated in the box
+ * - road: walk at a random speed along the lines of a grid, with a random
+ *   turn at each crossing, which mimics the trips on a road network
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "tpoint_random.h"
+
+#include <math.h>
+#include <utils/timestamp.h>
+
+#include "temporaltypes.h"
+#include "temporal_random.h"
+#include "tpoint.h"
+#include "tpoint_spatialfuncs.h"
+
+/* Number of lines of the grid of roads along each axis */
+#define RANDOM_ROAD_LINES	20
+
+/* Random walk along the lines of a grid */
+
+typedef struct
+{
+	double pos[2];			/* Position */
+	int axis;				/* Axis along which the point moves */
+	int dir;				/* Direction of the move, 1 or -1 */
+} RoadWalk;
+
+/*
+ * Move the point along the grid by the distance, turning at random at the
+ * crossings and at the sides of the box
+ */
+static void
+road_walk_move(RandomState *state, RoadWalk *walk, double dist,
+	const double *low, const double *spacing)
+{
+	while (dist > 0)
+	{
+		int a = walk->axis;
+		/* Next line of the grid crossed along the axis */
+		double k = (walk->pos[a] - low[a]) / spacing[a];
+		double next = walk->dir > 0 ? floor(k + 1e-9) + 1 : ceil(k - 1e-9) - 1;
+		if (next < 0 || next > RANDOM_ROAD_LINES)
+		{
+			walk->dir = -walk->dir;
+			continue;
+		}
+		double d = fabs(low[a] + next * spacing[a] - walk->pos[a]);
+		if (d > dist)
+		{
+			walk->pos[a] += walk->dir * dist;
+			return;
+		}
+		walk->pos[a] = low[a] + next * spacing[a];
+		dist -= d;
+		/* Go straight with probability 1/2, otherwise turn left or right */
+		double u = random_double(state);
+		if (u >= 0.5)
+		{
+			walk->axis = 1 - a;
+			walk->dir = u < 0.75 ? 1 : -1;
+		}
+	}
+}
+
+PG_FUNCTION_INFO_V1(random_tgeompoint_seq);
+
+PGDLLEXPORT Datum
+random_tgeompoint_seq(PG_FUNCTION_ARGS)
+{
+	STBOX *box = PG_GETARG_STBOX_P(0);
+	int count = PG_GETARG_INT32(1);
+	int64 step = random_step_usecs(PG_GETARG_INTERVAL_P(2));
+	RandomDist dist = random_distribution(PG_GETARG_TEXT_PP(3));
+	int64 seed = PG_GETARG_INT64(4);
+	int32 srid = PG_GETARG_INT32(5);
+	if (MOBDB_FLAGS_GET_GEODETIC(box->flags))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The box must not be geodetic")));
+	if (! MOBDB_FLAGS_GET_X(box->flags) || ! MOBDB_FLAGS_GET_T(box->flags))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The box must have space and time dimensions")));
+	if (count <= 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The number of instants must be positive")));
+
+	bool hasz = MOBDB_FLAGS_GET_Z(box->flags) != 0;
+	int dims = hasz ? 3 : 2;
+	double low[3] = {box->xmin, box->ymin, hasz ? box->zmin : 0};
+	double high[3] = {box->xmax, box->ymax, hasz ? box->zmax : 0};
+	double width[3];
+	for (int j = 0; j < 3; j++)
+		width[j] = high[j] - low[j];
+
+	double center[3] = {0, 0, 0};
+	if (dist == RANDOM_CLUSTERED)
+	{
+		/* The centers only depend on the box, the seed chooses one */
+		RandomState cstate, sstate;
+		random_init(&sstate, seed);
+		int n = (int) (random_double(&sstate) * RANDOM_CLUSTERS);
+		random_init(&cstate, 0);
+		for (int i = 0; i <= n; i++)
+			for (int j = 0; j < 3; j++)
+				center[j] = low[j] + random_double(&cstate) * width[j];
+	}
+	RandomState state;
+	random_init(&state, seed);
+	TimestampTz t = random_start(&state, box->tmin, box->tmax, step, count);
+	double pos[3];
+	for (int j = 0; j < 3; j++)
+		pos[j] = dist == RANDOM_CLUSTERED ? center[j] :
+			low[j] + random_double(&state) * width[j];
+
+	RoadWalk walk;
+	double spacing[2];
+	double speed = 0;
+	if (dist == RANDOM_ROAD)
+	{
+		if (width[0] <= 0 || width[1] <= 0)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				errmsg("The box must have a positive extent for the road distribution")));
+		/* Start at a random crossing at a random speed */
+		for (int j = 0; j < 2; j++)
+		{
+			spacing[j] = width[j] / RANDOM_ROAD_LINES;
+			walk.pos[j] = low[j] + spacing[j] *
+				floor(random_double(&state) * (RANDOM_ROAD_LINES + 1));
+		}
+		walk.axis = random_double(&state) < 0.5 ? 0 : 1;
+		walk.dir = random_double(&state) < 0.5 ? 1 : -1;
+		speed = Max(spacing[0], spacing[1]) * (0.1 + 0.4 * random_double(&state));
+		pos[0] = walk.pos[0];
+		pos[1] = walk.pos[1];
+	}
+
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
+	for (int i = 0; i < count; i++)
+	{
+		if (i > 0)
+		{
+			if (dist == RANDOM_ROAD)
+			{
+				road_walk_move(&state, &walk, speed *
+					(0.5 + random_double(&state)), low, spacing);
+				pos[0] = walk.pos[0];
+				pos[1] = walk.pos[1];
+			}
+			else
+			{
+				for (int j = 0; j < dims; j++)
+				{
+					if (dist == RANDOM_UNIFORM)
+						pos[j] = low[j] + random_double(&state) * width[j];
+					else if (dist == RANDOM_WALK)
+						pos[j] += random_gaussian(&state) * width[j] * 0.01;
+					else /* dist == RANDOM_CLUSTERED */
+						pos[j] = center[j] + (pos[j] - center[j]) * 0.9 +
+							random_gaussian(&state) * width[j] * 0.02;
+					pos[j] = random_reflect(pos[j], low[j], high[j]);
+				}
+			}
+		}
+		instants[i] = tpointinst_make(pos[0], pos[1], pos[2], hasz, false,
+			srid, t);
+		t += step;
+	}
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, count,
+		true, true, true, false);
+	for (int i = 0; i < count; i++)
+		pfree(instants[i]);
+	pfree(instants);
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************/
@@ -0,0 +1,53 @@
+-------------------------------------------------------------------------------
+-- Timed query workload over the big test tables of temporal points
+-------------------------------------------------------------------------------
+-- This file adds the queries on temporal points to the workload defined in
+-- src/debug/workload.sql, which must be loaded first, e.g.
+--	select create_test_tables_tpoint_big(10000);
+--	select workload_setup_tpoint();
+--	select workload_run();
+-------------------------------------------------------------------------------
+
+INSERT INTO workload_query VALUES
+('index_tgeompoint_stbox', 'index scan',
+'SELECT count(*) FROM tbl_tgeompoint_big
+WHERE temp && stbox(10, 10, 20, 20)'),
+('index_tgeompoint_geom_period', 'index scan',
+'SELECT count(*) FROM tbl_tgeompoint_big
+WHERE temp && stbox(ST_MakeEnvelope(10, 10, 20, 20), period ''[2001-03-01, 2001-04-01]'')'),
+('index_tgeompointseq_stbox', 'index scan',
+'SELECT count(*) FROM tbl_tgeompointseq_big
+WHERE seq && stbox(10, 10, 20, 20)'),
+('join_tgeompoint_dwithin', 'spatial join',
+'SELECT count(*) FROM tbl_tgeompoint_big t1, tbl_tgeompoint_big t2
+WHERE t1.k < t2.k AND expandSpatial(t1.temp, 1) && t2.temp AND
+dwithin(t1.temp, t2.temp, 1)'),
+('join_tgeompoint_grid', 'spatial join',
+'SELECT count(*) FROM generate_series(0, 90, 10) AS x,
+generate_series(0, 90, 10) AS y, tbl_tgeompoint_big t
+WHERE t.temp && ST_MakeEnvelope(x, y, x + 10, y + 10) AND
+intersects(t.temp, ST_MakeEnvelope(x, y, x + 10, y + 10))'),
+('agg_tgeompoint_extent', 'aggregate',
+'SELECT extent(temp) FROM tbl_tgeompoint_big'),
+('agg_tgeompointseq_tcentroid', 'aggregate',
+'SELECT numInstants(tcentroid(seq)) FROM tbl_tgeompointseq_big'),
+('window_tgeompoint_extent', 'window aggregate',
+'SELECT count(w) FROM (SELECT extent(temp) OVER (ORDER BY k
+ROWS BETWEEN 9 PRECEDING AND CURRENT ROW) AS w FROM tbl_tgeompoint_big) AS t')
+ON CONFLICT (name) DO UPDATE SET kind = EXCLUDED.kind, query = EXCLUDED.query;
+
+-------------------------------------------------------------------------------
+
+DROP FUNCTION IF EXISTS workload_setup_tpoint();
+CREATE OR REPLACE FUNCTION workload_setup_tpoint()
+RETURNS text AS $$
+BEGIN
+CREATE INDEX IF NOT EXISTS tbl_tgeompoint_big_gist_idx ON tbl_tgeompoint_big USING GIST(temp);
+CREATE INDEX IF NOT EXISTS tbl_tgeompointseq_big_spgist_idx ON tbl_tgeompointseq_big USING SPGIST(seq);
+ANALYZE tbl_tgeompoint_big;
+ANALYZE tbl_tgeompointseq_big;
+RETURN 'The End';
+END;
+$$ LANGUAGE 'plpgsql';
+
+-------------------------------------------------------------------------------
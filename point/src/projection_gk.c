@@ -111,49 +111,42 @@ BLRauenberg (double x, double y, double z)
 	return result;
 }
 
-/* Get Datum from 2D point */
-
-static Datum
-point2d_get_datum(POINT2D point2D)
-{
-	LWPOINT *p = lwpoint_make2d(4326, point2D.x, point2D.y);
-	GSERIALIZED *result = geometry_serialize((LWGEOM *)p);
-
-	return PointerGetDatum(result);
-}
-
-static Datum
-gk(Datum inst)
+/*
+ * Transform in place arrays of WGS84 longitudes and latitudes into Gauss
+ * Krueger coordinates. The points are processed in two passes over the
+ * arrays: the first one converts them into geocentric coordinates in the
+ * Bessel datum and has no branches, the second one iterates to find the
+ * Bessel latitude and projects the result.
+ */
+static void
+gk_transform_arrays(double *x, double *y, int count)
 {
 	eqwgs = (awgs * awgs - bwgs * bwgs) / (awgs * awgs);
 	eqbes = (abes * abes - bbes * bbes) / (abes * abes);
-	POINT2D point2D = datum_get_point2d(inst);
-	POINT2D result;
-	double x = point2D.x;
-	double y = point2D.y;
-	double a = (x / 180) * Pi;
-	double b = (y / 180) * Pi;
-	double l1 = a;
-	double b1 = b;
-
-	a = awgs;
-
-	double eq = eqwgs;
-	double N = a / sqrt(1 - eq * sin(b1) * sin(b1));
-	double Xq = (N + h1) * cos(b1) * cos(l1);
-	double Yq = (N + h1) * cos(b1) * sin(l1);
-	double Zq = ((1 - eq) * N + h1) * sin(b1);
-
-	POINT3D p = HelmertTransformation(Xq, Yq, Zq);
-	double X = p.x;
-	double Y = p.y;
-	double Z = p.z;
-
-	p = BLRauenberg(X, Y, Z);
-	double b2 = p.x;
-	double l2 = p.y;
-	result = BesselBLToGaussKrueger(b2, l2);
-	return point2d_get_datum(result);
+	double *z = palloc(sizeof(double) * count);
+	for (int i = 0; i < count; i++)
+	{
+		double l1 = (x[i] / 180) * Pi;
+		double b1 = (y[i] / 180) * Pi;
+		double sinb1 = sin(b1);
+		double cosb1 = cos(b1);
+		double N = awgs / sqrt(1 - eqwgs * sinb1 * sinb1);
+		double Xq = (N + h1) * cosb1 * cos(l1);
+		double Yq = (N + h1) * cosb1 * sin(l1);
+		double Zq = ((1 - eqwgs) * N + h1) * sinb1;
+		POINT3D p = HelmertTransformation(Xq, Yq, Zq);
+		x[i] = p.x;
+		y[i] = p.y;
+		z[i] = p.z;
+	}
+	for (int i = 0; i < count; i++)
+	{
+		POINT3D p = BLRauenberg(x[i], y[i], z[i]);
+		POINT2D p2d = BesselBLToGaussKrueger(p.x, p.y);
+		x[i] = p2d.x;
+		y[i] = p2d.y;
+	}
+	pfree(z);
 }
 
 /* Transform geometry to Gauss Kruger Projection */
@@ -171,8 +164,7 @@ geometry_transform_gk_internal(GSERIALIZED *gs)
 		else
 		{
 			POINT2D point2D	= gs_get_point2d(gs);
-			Datum geom = gk(point2d_get_datum(point2D));
-			point2D	= datum_get_point2d(geom);
+			gk_transform_arrays(&point2D.x, &point2D.y, 1);
 			lwpoint = lwpoint_make2d(4326, point2D.x, point2D.y);
 		}
 		result = geometry_serialize((LWGEOM *)lwpoint);
@@ -188,26 +180,28 @@ geometry_transform_gk_internal(GSERIALIZED *gs)
 		}
 		else
 		{
-			LWPOINT *lwpoint = NULL;
 			LWGEOM *lwgeom = lwgeom_from_gserialized(gs);
-			line = lwgeom_as_lwline(lwgeom);
-			uint32_t numPoints = line->points->npoints;
-			LWPOINT **points = palloc(sizeof(LWPOINT *) * numPoints);
+			POINTARRAY *points = lwgeom_as_lwline(lwgeom)->points;
+			uint32_t numPoints = points->npoints;
+			double *x = palloc(sizeof(double) * numPoints);
+			double *y = palloc(sizeof(double) * numPoints);
 			for (uint32_t i = 0; i < numPoints; i++)
 			{
-				lwpoint = lwline_get_lwpoint((LWLINE*)lwgeom, i);
-				Datum point2d_datum = PointerGetDatum(gserialized_from_lwgeom(lwpoint_as_lwgeom(lwpoint), 0));
-				Datum geom = gk(point2d_datum);
-				POINT2D point2D	= datum_get_point2d(geom);
-				points[i] = lwpoint_make2d(4326, point2D.x, point2D.y);
+				const POINT2D *point2D = getPoint2d_cp(points, i);
+				x[i] = point2D->x;
+				y[i] = point2D->y;
 			}
-
-			line = lwline_from_ptarray(4326, numPoints, points);
+			gk_transform_arrays(x, y, numPoints);
+			POINTARRAY *pa = ptarray_construct(false, false, numPoints);
+			for (uint32_t i = 0; i < numPoints; i++)
+			{
+				POINT4D p = { x[i], y[i], 0, 0 };
+				ptarray_set_point4d(pa, i, &p);
+			}
+			line = lwline_construct(4326, NULL, pa);
 			result = geometry_serialize(lwline_as_lwgeom(line));
-			lwline_free(line);lwpoint_free(lwpoint);lwgeom_free(lwgeom);
-			for( uint32_t i = 0; i < numPoints; i++)
-				lwpoint_free(points[i]);
-			pfree(points);
+			lwline_free(line); lwgeom_free(lwgeom);
+			pfree(x); pfree(y);
 		}
 	}
 	else
@@ -217,13 +211,41 @@ geometry_transform_gk_internal(GSERIALIZED *gs)
 	return result;
 }
 
+/*
+ * Transform an array of instants at once, the coordinates of all the
+ * instants are gathered into contiguous arrays for the projection
+ */
+static TemporalInst **
+tgeompointinstarr_transform_gk(TemporalInst **instants, int count)
+{
+	double *x = palloc(sizeof(double) * count);
+	double *y = palloc(sizeof(double) * count);
+	for (int i = 0; i < count; i++)
+	{
+		POINT2D point2D = datum_get_point2d(temporalinst_value(instants[i]));
+		x[i] = point2D.x;
+		y[i] = point2D.y;
+	}
+	gk_transform_arrays(x, y, count);
+	TemporalInst **result = palloc(sizeof(TemporalInst *) * count);
+	for (int i = 0; i < count; i++)
+	{
+		LWPOINT *lwpoint = lwpoint_make2d(4326, x[i], y[i]);
+		GSERIALIZED *gs = geometry_serialize((LWGEOM *)lwpoint);
+		result[i] = temporalinst_make(PointerGetDatum(gs), instants[i]->t,
+			type_oid(T_GEOMETRY));
+		lwpoint_free(lwpoint); pfree(gs);
+	}
+	pfree(x); pfree(y);
+	return result;
+}
+
 static TemporalInst *
 tgeompointinst_transform_gk(TemporalInst *inst)
 {
-	Datum geom = gk(temporalinst_value(inst));
-	TemporalInst *result = temporalinst_make(geom, inst->t,
-		type_oid(T_GEOMETRY));
-	pfree(DatumGetPointer(geom));
+	TemporalInst **instants = tgeompointinstarr_transform_gk(&inst, 1);
+	TemporalInst *result = instants[0];
+	pfree(instants);
 	return result;
 }
 
@@ -232,15 +254,13 @@ tgeompointi_transform_gk_internal(TemporalI *ti)
 {
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
 	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		instants[i] = tgeompointinst_transform_gk(inst);
-	}
-	TemporalI *result = temporali_from_temporalinstarr(instants, ti->count);
+		instants[i] = temporali_inst_n(ti, i);
+	TemporalInst **transf = tgeompointinstarr_transform_gk(instants, ti->count);
+	TemporalI *result = temporali_from_temporalinstarr(transf, ti->count);
 
 	for (int i = 0; i < ti->count; i++)
-		pfree(instants[i]);
-	pfree(instants);
+		pfree(transf[i]);
+	pfree(transf); pfree(instants);
 
 	return result;
 }
@@ -250,47 +270,53 @@ tgeompointseq_transform_gk_internal(TemporalSeq *seq)
 {
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
 	for (int i = 0; i < seq->count; i++)
-	{
-		TemporalInst *inst = temporalseq_inst_n(seq, i);
-		instants[i] = tgeompointinst_transform_gk(inst);
-	}
-	TemporalSeq *result = temporalseq_from_temporalinstarr(instants,
+		instants[i] = temporalseq_inst_n(seq, i);
+	TemporalInst **transf = tgeompointinstarr_transform_gk(instants, seq->count);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(transf,
 		seq->count, seq->period.lower_inc, seq->period.upper_inc, 
 		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
 
 	for (int i = 0; i < seq->count; i++)
-		pfree(instants[i]);
-	pfree(instants);
+		pfree(transf[i]);
+	pfree(transf); pfree(instants);
 
 	return result;
 }
 
+/*
+ * The instants of all the sequences are projected together, the sequences
+ * are then rebuilt from consecutive slices of the result
+ */
 static TemporalS *
 tgeompoints_transform_gk_internal(TemporalS *ts)
 {
-	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ts->totalcount);
+	int k = 0;
 	for (int i = 0; i < ts->count; i++)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts, i);
-		TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
 		for (int j = 0; j < seq->count; j++)
-		{
-			TemporalInst *inst = temporalseq_inst_n(seq, j);
-			instants[j] = tgeompointinst_transform_gk(inst);
-		}
-		sequences[i] = temporalseq_from_temporalinstarr(instants,
+			instants[k++] = temporalseq_inst_n(seq, j);
+	}
+	TemporalInst **transf = tgeompointinstarr_transform_gk(instants, k);
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
+	k = 0;
+	for (int i = 0; i < ts->count; i++)
+	{
+		TemporalSeq *seq = temporals_seq_n(ts, i);
+		sequences[i] = temporalseq_from_temporalinstarr(&transf[k],
 			seq->count, seq->period.lower_inc, seq->period.upper_inc, 
 			MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
-		for (int j = 0; j < seq->count; j++)
-			pfree(instants[j]);
-		pfree(instants);
+		k += seq->count;
 	}
 	TemporalS *result = temporals_from_temporalseqarr(sequences,
 		ts->count, MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
 
+	for (int i = 0; i < k; i++)
+		pfree(transf[i]);
 	for (int i = 0; i < ts->count; i++)
 		pfree(sequences[i]);
-	pfree(sequences);
+	pfree(transf); pfree(sequences); pfree(instants);
 
 	return result;
 }
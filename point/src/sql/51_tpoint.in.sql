@@ -144,6 +144,18 @@ CREATE FUNCTION tgeogpointseq(tgeogpoint[], lower_inc boolean DEFAULT true,
 	RETURNS tgeogpoint
 	AS 'MODULE_PATHNAME', 'temporalseq_constructor'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tgeompointseq(x float8[], y float8[], t timestamptz[],
+	srid integer DEFAULT 0, lower_inc boolean DEFAULT true, 
+	upper_inc boolean DEFAULT true, linear boolean DEFAULT true)
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'tpointseq_from_xyt_arrays'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tgeompointseq(x float8[], y float8[], z float8[], 
+	t timestamptz[], srid integer DEFAULT 0, lower_inc boolean DEFAULT true, 
+	upper_inc boolean DEFAULT true, linear boolean DEFAULT true)
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'tpointseq_from_xyzt_arrays'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION tgeompoints(tgeompoint[])
 	RETURNS tgeompoint
@@ -219,6 +231,41 @@ CREATE FUNCTION appendInstant(tgeogpoint, tgeogpoint)
 	AS 'MODULE_PATHNAME', 'temporal_append_instant'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION merge(tgeompoint, tgeompoint)
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'temporal_merge'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION merge(tgeogpoint, tgeogpoint)
+	RETURNS tgeogpoint
+	AS 'MODULE_PATHNAME', 'temporal_merge'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION merge(tgeompoint[])
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'temporal_merge_array'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION merge(tgeogpoint[])
+	RETURNS tgeogpoint
+	AS 'MODULE_PATHNAME', 'temporal_merge_array'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION compress(tgeompoint)
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'temporal_compress'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION compress(tgeogpoint)
+	RETURNS tgeogpoint
+	AS 'MODULE_PATHNAME', 'temporal_compress'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION isCompressed(tgeompoint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'temporal_is_compressed'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION isCompressed(tgeogpoint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'temporal_is_compressed'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /******************************************************************************
  * Functions
  ******************************************************************************/
@@ -249,6 +296,20 @@ CREATE FUNCTION memSize(tgeogpoint)
 	RETURNS int
 	AS 'MODULE_PATHNAME', 'temporal_mem_size'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION memLayout(tgeompoint, OUT total integer, OUT disk integer,
+		OUT compression float, OUT headers integer, OUT offsets integer,
+		OUT instant_headers integer, OUT timestamps integer,
+		OUT base_values integer, OUT bbox integer, OUT trajectory integer)
+	RETURNS record
+	AS 'MODULE_PATHNAME', 'temporal_mem_layout'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION memLayout(tgeogpoint, OUT total integer, OUT disk integer,
+		OUT compression float, OUT headers integer, OUT offsets integer,
+		OUT instant_headers integer, OUT timestamps integer,
+		OUT base_values integer, OUT bbox integer, OUT trajectory integer)
+	RETURNS record
+	AS 'MODULE_PATHNAME', 'temporal_mem_layout'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 -- value is a reserved word in SQL
 CREATE FUNCTION getValue(tgeompoint)
@@ -297,6 +358,15 @@ CREATE FUNCTION shift(tgeogpoint, interval)
 	AS 'MODULE_PATHNAME', 'temporal_shift'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION tscale(tgeompoint, interval)
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'temporal_tscale'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tscale(tgeogpoint, interval)
+	RETURNS tgeogpoint
+	AS 'MODULE_PATHNAME', 'temporal_tscale'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION startValue(tgeompoint)
 	RETURNS geometry(Point)
 	AS 'MODULE_PATHNAME', 'temporal_start_value'
@@ -708,6 +778,44 @@ CREATE FUNCTION intersectsPeriodSet(tgeogpoint, periodset)
 	AS 'MODULE_PATHNAME', 'temporal_intersects_periodset'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION distance(timestamptz, tgeompoint)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_timestamp_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION distance(tgeompoint, timestamptz)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_temporal_timestamp'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION distance(timestamptz, tgeogpoint)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_timestamp_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION distance(tgeogpoint, timestamptz)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_temporal_timestamp'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = timestamptz, RIGHTARG = tgeompoint,
+	COMMUTATOR = <->
+);
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = tgeompoint, RIGHTARG = timestamptz,
+	COMMUTATOR = <->
+);
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = timestamptz, RIGHTARG = tgeogpoint,
+	COMMUTATOR = <->
+);
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = tgeogpoint, RIGHTARG = timestamptz,
+	COMMUTATOR = <->
+);
+
 /******************************************************************************
  * Comparison functions and B-tree indexing
  ******************************************************************************/
@@ -791,7 +899,8 @@ CREATE OPERATOR CLASS tgeompoint_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	tgeompoint_cmp(tgeompoint, tgeompoint);
+		FUNCTION	1	tgeompoint_cmp(tgeompoint, tgeompoint),
+		FUNCTION	2	temporal_sortsupport(internal);
 
 /******************************************************************************/
 
@@ -868,7 +977,8 @@ CREATE OPERATOR CLASS tgeogpoint_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	tgeogpoint_cmp(tgeogpoint, tgeogpoint);
+		FUNCTION	1	tgeogpoint_cmp(tgeogpoint, tgeogpoint),
+		FUNCTION	2	temporal_sortsupport(internal);
 
 /******************************************************************************/
 
@@ -121,16 +121,39 @@ CREATE FUNCTION azimuth(tgeogpoint)
 
 /*****************************************************************************/
 
+CREATE FUNCTION simplify(tgeompoint, float, synchronized boolean DEFAULT TRUE)
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'tpoint_simplify'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION speedSimplify(tgeompoint, float)
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'tpoint_speed_simplify'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************/
+
 CREATE FUNCTION atGeometry(tgeompoint, geometry)
 	RETURNS tgeompoint
 	AS 'MODULE_PATHNAME', 'tpoint_at_geometry'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION atGeometries(tgeompoint, ids integer[], geoms geometry[],
+		OUT id integer, OUT trip tgeompoint)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'tpoint_at_geometries'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION minusGeometry(tgeompoint, geometry)
 	RETURNS tgeompoint
 	AS 'MODULE_PATHNAME', 'tpoint_minus_geometry'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION atStbox(tgeompoint, stbox)
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'tpoint_at_stbox'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
 
 CREATE FUNCTION NearestApproachInstant(geometry, tgeompoint)
@@ -171,6 +194,11 @@ CREATE FUNCTION nearestApproachDistance(tgeompoint, tgeompoint)
 	RETURNS float
 	AS 'MODULE_PATHNAME', 'NAD_tpoint_tpoint'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION nearestApproachDistance(tgeompoint[], tgeompoint[],
+		OUT i integer, OUT distance float)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'NAD_tpointarr_tpointarr'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION nearestApproachDistance(geography, tgeogpoint)
 	RETURNS float
@@ -80,4 +80,44 @@ CREATE OPERATOR <-> (
 	COMMUTATOR = <->
 );
 
+/*****************************************************************************
+ * Trajectory similarity
+ *****************************************************************************/
+
+CREATE FUNCTION frechetDistance(tgeompoint, tgeompoint)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'frechet_distance_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDistance(tgeogpoint, tgeogpoint)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'frechet_distance_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION dynamicTimeWarp(tgeompoint, tgeompoint)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'dtw_distance_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynamicTimeWarp(tgeogpoint, tgeogpoint)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'dtw_distance_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION frechetDWithin(tgeompoint, tgeompoint, dist float)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'frechet_dwithin_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDWithin(tgeogpoint, tgeogpoint, dist float)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'frechet_dwithin_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION dynamicTimeWarpDWithin(tgeompoint, tgeompoint, dist float)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'dtw_dwithin_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynamicTimeWarpDWithin(tgeogpoint, tgeogpoint, dist float)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'dtw_dwithin_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /******************************************************************************/
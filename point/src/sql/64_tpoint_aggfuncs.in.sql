@@ -36,6 +36,13 @@ CREATE AGGREGATE extent(tgeogpoint) (
 	PARALLEL = safe
 );
 
+/* Extent estimated from the statistics of a column */
+
+CREATE FUNCTION estimatedSTBox(regclass, text)
+	RETURNS stbox
+	AS 'MODULE_PATHNAME', 'tpoint_estimated_stbox'
+	LANGUAGE C STABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
 
 CREATE FUNCTION tcount_transfn(internal, tgeompoint)
@@ -102,6 +109,14 @@ CREATE FUNCTION tcentroid_combinefn(internal, internal)
 	RETURNS internal
 	AS 'MODULE_PATHNAME', 'tpoint_tcentroid_combinefn'
 	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcentroid_serialize(internal)
+	RETURNS bytea
+	AS 'MODULE_PATHNAME', 'tpoint_tcentroid_serialize'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tcentroid_deserialize(bytea, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'tpoint_tcentroid_deserialize'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tcentroid_finalfn(internal)
 	RETURNS tgeompoint
 	AS 'MODULE_PATHNAME', 'tpoint_tcentroid_finalfn'
@@ -112,8 +127,104 @@ CREATE AGGREGATE tcentroid(tgeompoint) (
 	STYPE = internal,
 	COMBINEFUNC = tcentroid_combinefn,
 	FINALFUNC = tcentroid_finalfn,
-	SERIALFUNC = tagg_serialize,
-	DESERIALFUNC = tagg_deserialize,
+	SERIALFUNC = tcentroid_serialize,
+	DESERIALFUNC = tcentroid_deserialize,
+	PARALLEL = SAFE
+);
+
+/*****************************************************************************/
+
+/* The points must be given in increasing order of time, e.g.,
+ * tgeompointseqset_agg(geom, t, interval '5 minutes', 100 ORDER BY t) */
+
+CREATE FUNCTION tgeompointseqset_agg_transfn(internal, geometry, timestamptz,
+		interval, float)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'tpoint_seqset_agg_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tgeompointseqset_agg_finalfn(internal)
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'tpoint_seqset_agg_finalfn'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE tgeompointseqset_agg(geometry, timestamptz, interval, float) (
+	SFUNC = tgeompointseqset_agg_transfn,
+	STYPE = internal,
+	FINALFUNC = tgeompointseqset_agg_finalfn
+);
+
+/*****************************************************************************/
+
+CREATE FUNCTION tcount_transfn(internal, tgeompoint, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_transfn(internal, tgeogpoint, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE tcount(tgeompoint, interval) (
+	SFUNC = tcount_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbucket_combinefn,
+	FINALFUNC = tint_tbucket_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount(tgeogpoint, interval) (
+	SFUNC = tcount_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbucket_combinefn,
+	FINALFUNC = tint_tbucket_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+
+CREATE FUNCTION tcount_distinct_transfn(internal, tgeompoint, anyelement, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_distinct_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, tgeogpoint, anyelement, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_distinct_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE tcountDistinct(tgeompoint, anyelement, interval) (
+	SFUNC = tcount_distinct_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tsketch_combinefn,
+	FINALFUNC = tcount_distinct_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(tgeogpoint, anyelement, interval) (
+	SFUNC = tcount_distinct_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tsketch_combinefn,
+	FINALFUNC = tcount_distinct_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+
+/* The values are collected into an array which is merged at the end */
+
+CREATE AGGREGATE merge(tgeompoint) (
+	SFUNC = array_append,
+	STYPE = tgeompoint[],
+	COMBINEFUNC = array_cat,
+	FINALFUNC = merge,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE merge(tgeogpoint) (
+	SFUNC = array_append,
+	STYPE = tgeogpoint[],
+	COMBINEFUNC = array_cat,
+	FINALFUNC = merge,
 	PARALLEL = SAFE
 );
 
@@ -14,7 +14,9 @@
  *		covers, coveredby, intersects, dwithin
  * All these relationships, excepted disjoint and relate, will automatically 
  * include a bounding box comparison that will make use of any spatial, 
- * temporal, or spatiotemporal indexes that are available.
+ * temporal, or spatiotemporal indexes that are available. This is not the
+ * case for the relationships between two temporal points since they return
+ * NULL when the temporal points do not intersect in time.
  * N.B. In the current version of Postgis (2.4) the only index operator 
  * implemented for geography is &&
  *
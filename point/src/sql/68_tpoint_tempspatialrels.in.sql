@@ -10,6 +10,10 @@
  *		ttouches, twithin, tdwithin, and trelate (with 2 and 3 arguments)
  * The following relationships are supported for temporal geography points:
  *		tcovers, tcoveredby, tintersects, tdwithin
+ * Contrary to the relationships in file tpoint_spatialrels.sql, these 
+ * relationships cannot include a bounding box comparison since their result
+ * is not a Boolean. A condition such as tdwithin(temp, geo, d) ?= true is 
+ * equivalent to dwithin(temp, geo, d), which does include it.
  *
  * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse, 
  *		Universite Libre de Bruxelles
@@ -231,6 +235,19 @@ CREATE FUNCTION tdwithin(tgeogpoint, tgeogpoint, dist float8)
 	AS 'MODULE_PATHNAME', 'tdwithin_tpoint_tpoint'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+/*****************************************************************************/
+
+CREATE FUNCTION tdwithinJoin(tgeompoint[], tgeompoint[], dist float8,
+		OUT i integer, OUT j integer, OUT tdwithin tbool)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'tdwithin_join_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tdwithinJoin(tgeogpoint[], tgeogpoint[], dist float8,
+		OUT i integer, OUT j integer, OUT tdwithin tbool)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'tdwithin_join_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************
  * trelate (2 arguments)
  *****************************************************************************/
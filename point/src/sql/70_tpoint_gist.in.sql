@@ -38,6 +38,14 @@ CREATE FUNCTION gist_tpoint_same(stbox, stbox, internal)
 	RETURNS internal
 	AS 'MODULE_PATHNAME', 'gist_tpoint_same'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tgeompoint_distance(internal, tgeompoint, smallint, oid, internal)
+	RETURNS float8
+	AS 'MODULE_PATHNAME', 'gist_tpoint_distance'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tgeogpoint_distance(internal, tgeogpoint, smallint, oid, internal)
+	RETURNS float8
+	AS 'MODULE_PATHNAME', 'gist_tpoint_distance'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR CLASS gist_tgeompoint_ops
 	DEFAULT FOR TYPE tgeompoint USING gist AS
@@ -90,6 +98,8 @@ CREATE OPERATOR CLASS gist_tgeompoint_ops
 	OPERATOR	12		|&> (tgeompoint, geometry),  
 	OPERATOR	12		|&> (tgeompoint, stbox),  
 	OPERATOR	12		|&> (tgeompoint, tgeompoint),  
+	-- distance in time
+	OPERATOR	15		<-> (tgeompoint, timestamptz) FOR ORDER BY pg_catalog.float_ops,
 	-- nearest approach distance
 	OPERATOR	25		|=| (tgeompoint, geometry) FOR ORDER BY pg_catalog.float_ops,
 --	OPERATOR	25		|=| (tgeompoint, stbox) FOR ORDER BY pg_catalog.float_ops,
@@ -124,7 +134,8 @@ CREATE OPERATOR CLASS gist_tgeompoint_ops
 	FUNCTION	3	gist_tpoint_compress(internal),
 	FUNCTION	5	gist_tpoint_penalty(internal, internal, internal),
 	FUNCTION	6	gist_tpoint_picksplit(internal, internal),
-	FUNCTION	7	gist_tpoint_same(stbox, stbox, internal);
+	FUNCTION	7	gist_tpoint_same(stbox, stbox, internal),
+	FUNCTION	8	gist_tgeompoint_distance(internal, tgeompoint, smallint, oid, internal);
 	
 CREATE OPERATOR CLASS gist_tgeogpoint_ops
 	DEFAULT FOR TYPE tgeogpoint USING gist AS
@@ -145,6 +156,8 @@ CREATE OPERATOR CLASS gist_tgeogpoint_ops
 	OPERATOR	8		<@ (tgeogpoint, geography),  
 	OPERATOR	8		<@ (tgeogpoint, stbox),  
 	OPERATOR	8		<@ (tgeogpoint, tgeogpoint),  
+	-- distance in time
+	OPERATOR	15		<-> (tgeogpoint, timestamptz) FOR ORDER BY pg_catalog.float_ops,
 	-- distance
 --	OPERATOR	25		<-> (tgeogpoint, geography) FOR ORDER BY pg_catalog.float_ops,
 --	OPERATOR	25		<-> (tgeogpoint, stbox) FOR ORDER BY pg_catalog.float_ops,
@@ -167,6 +180,213 @@ CREATE OPERATOR CLASS gist_tgeogpoint_ops
 	FUNCTION	3	gist_tpoint_compress(internal),
 	FUNCTION	5	gist_tpoint_penalty(internal, internal, internal),
 	FUNCTION	6	gist_tpoint_picksplit(internal, internal),
-	FUNCTION	7	gist_tpoint_same(stbox, stbox, internal);
+	FUNCTION	7	gist_tpoint_same(stbox, stbox, internal),
+	FUNCTION	8	gist_tgeogpoint_distance(internal, tgeogpoint, smallint, oid, internal);
 	
 /******************************************************************************/
+
+/******************************************************************************
+ * Operator classes with compact keys
+ * The keys store the spatial bounds in float4 rounded outwards and the time 
+ * span in seconds rounded up, which makes the indexes smaller at the expense
+ * of rechecking all the results.
+ ******************************************************************************/
+
+CREATE TYPE stboxf;
+
+CREATE FUNCTION stboxf_in(cstring)
+	RETURNS stboxf
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stboxf_out(stboxf)
+	RETURNS cstring
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE TYPE stboxf (
+	internallength = 40,
+	input = stboxf_in,
+	output = stboxf_out,
+	storage = plain,
+	alignment = double
+);
+
+CREATE FUNCTION gist_tgeompoint_compact_consistent(internal, tgeompoint, smallint, oid, internal)
+	RETURNS bool
+	AS 'MODULE_PATHNAME', 'gist_tpoint_compact_consistent'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tgeogpoint_compact_consistent(internal, tgeogpoint, smallint, oid, internal)
+	RETURNS bool
+	AS 'MODULE_PATHNAME', 'gist_tpoint_compact_consistent'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tpoint_compact_compress(internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_tpoint_compact_compress'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tpoint_compact_decompress(internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_tpoint_compact_decompress'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_stboxf_same(stboxf, stboxf, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_tpoint_same'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS gist_tgeompoint_compact_ops
+	FOR TYPE tgeompoint USING gist AS
+	STORAGE stboxf,
+	-- strictly left
+	OPERATOR	1		<< (tgeompoint, geometry),  
+	OPERATOR	1		<< (tgeompoint, stbox),  
+	OPERATOR	1		<< (tgeompoint, tgeompoint),  
+	-- overlaps or left
+	OPERATOR	2		&< (tgeompoint, geometry),  
+	OPERATOR	2		&< (tgeompoint, stbox),  
+	OPERATOR	2		&< (tgeompoint, tgeompoint),  
+	-- overlaps	
+	OPERATOR	3		&& (tgeompoint, geometry),  
+	OPERATOR	3		&& (tgeompoint, stbox),  
+	OPERATOR	3		&& (tgeompoint, tgeompoint),  
+	-- overlaps or right
+	OPERATOR	4		&> (tgeompoint, geometry),  
+	OPERATOR	4		&> (tgeompoint, stbox),  
+	OPERATOR	4		&> (tgeompoint, tgeompoint),  
+  	-- strictly right
+	OPERATOR	5		>> (tgeompoint, geometry),  
+	OPERATOR	5		>> (tgeompoint, stbox),  
+	OPERATOR	5		>> (tgeompoint, tgeompoint),  
+  	-- same
+	OPERATOR	6		~= (tgeompoint, geometry),  
+	OPERATOR	6		~= (tgeompoint, stbox),  
+	OPERATOR	6		~= (tgeompoint, tgeompoint),  
+	-- contains
+	OPERATOR	7		@> (tgeompoint, geometry),  
+	OPERATOR	7		@> (tgeompoint, stbox),  
+	OPERATOR	7		@> (tgeompoint, tgeompoint),  
+	-- contained by
+	OPERATOR	8		<@ (tgeompoint, geometry),  
+	OPERATOR	8		<@ (tgeompoint, stbox),  
+	OPERATOR	8		<@ (tgeompoint, tgeompoint),  
+	-- overlaps or below
+	OPERATOR	9		&<| (tgeompoint, geometry),  
+	OPERATOR	9		&<| (tgeompoint, stbox),  
+	OPERATOR	9		&<| (tgeompoint, tgeompoint),  
+	-- strictly below
+	OPERATOR	10		<<| (tgeompoint, geometry),  
+	OPERATOR	10		<<| (tgeompoint, stbox),  
+	OPERATOR	10		<<| (tgeompoint, tgeompoint),  
+	-- strictly above
+	OPERATOR	11		|>> (tgeompoint, geometry),  
+	OPERATOR	11		|>> (tgeompoint, stbox),  
+	OPERATOR	11		|>> (tgeompoint, tgeompoint),  
+	-- overlaps or above
+	OPERATOR	12		|&> (tgeompoint, geometry),  
+	OPERATOR	12		|&> (tgeompoint, stbox),  
+	OPERATOR	12		|&> (tgeompoint, tgeompoint),  
+	-- distance in time
+	OPERATOR	15		<-> (tgeompoint, timestamptz) FOR ORDER BY pg_catalog.float_ops,
+	-- nearest approach distance
+	OPERATOR	25		|=| (tgeompoint, geometry) FOR ORDER BY pg_catalog.float_ops,
+--	OPERATOR	25		|=| (tgeompoint, stbox) FOR ORDER BY pg_catalog.float_ops,
+	OPERATOR	25		|=| (tgeompoint, tgeompoint) FOR ORDER BY pg_catalog.float_ops,
+	-- overlaps or before
+	OPERATOR	28		&<# (tgeompoint, stbox),
+	OPERATOR	28		&<# (tgeompoint, tgeompoint),
+	-- strictly before
+	OPERATOR	29		<<# (tgeompoint, stbox),
+	OPERATOR	29		<<# (tgeompoint, tgeompoint),
+	-- strictly after
+	OPERATOR	30		#>> (tgeompoint, stbox),
+	OPERATOR	30		#>> (tgeompoint, tgeompoint),
+	-- overlaps or after
+	OPERATOR	31		#&> (tgeompoint, stbox),
+	OPERATOR	31		#&> (tgeompoint, tgeompoint),
+	-- overlaps or front
+	OPERATOR	32		&</ (tgeompoint, stbox),
+	OPERATOR	32		&</ (tgeompoint, tgeompoint),
+	-- strictly front
+	OPERATOR	33		<</ (tgeompoint, stbox),
+	OPERATOR	33		<</ (tgeompoint, tgeompoint),
+	-- strictly back
+	OPERATOR	34		/>> (tgeompoint, stbox),
+	OPERATOR	34		/>> (tgeompoint, tgeompoint),
+	-- overlaps or back
+	OPERATOR	35		/&> (tgeompoint, stbox),
+	OPERATOR	35		/&> (tgeompoint, tgeompoint),
+	-- functions
+	FUNCTION	1	gist_tgeompoint_compact_consistent(internal, tgeompoint, smallint, oid, internal),
+	FUNCTION	2	gist_tpoint_union(internal, internal),
+	FUNCTION	3	gist_tpoint_compact_compress(internal),
+	FUNCTION	4	gist_tpoint_compact_decompress(internal),
+	FUNCTION	5	gist_tpoint_penalty(internal, internal, internal),
+	FUNCTION	6	gist_tpoint_picksplit(internal, internal),
+	FUNCTION	7	gist_stboxf_same(stboxf, stboxf, internal),
+	FUNCTION	8	gist_tgeompoint_distance(internal, tgeompoint, smallint, oid, internal);
+
+CREATE OPERATOR CLASS gist_tgeogpoint_compact_ops
+	FOR TYPE tgeogpoint USING gist AS
+	STORAGE stboxf,
+	-- overlaps
+	OPERATOR	3		&& (tgeogpoint, geography),  
+	OPERATOR	3		&& (tgeogpoint, stbox),  
+	OPERATOR	3		&& (tgeogpoint, tgeogpoint),  
+  	-- same
+	OPERATOR	6		~= (tgeogpoint, geography),  
+	OPERATOR	6		~= (tgeogpoint, stbox),  
+	OPERATOR	6		~= (tgeogpoint, tgeogpoint),  
+	-- contains
+	OPERATOR	7		@> (tgeogpoint, geography),  
+	OPERATOR	7		@> (tgeogpoint, stbox),  
+	OPERATOR	7		@> (tgeogpoint, tgeogpoint),  
+	-- contained by
+	OPERATOR	8		<@ (tgeogpoint, geography),  
+	OPERATOR	8		<@ (tgeogpoint, stbox),  
+	OPERATOR	8		<@ (tgeogpoint, tgeogpoint),  
+	-- distance in time
+	OPERATOR	15		<-> (tgeogpoint, timestamptz) FOR ORDER BY pg_catalog.float_ops,
+	-- distance
+--	OPERATOR	25		<-> (tgeogpoint, geography) FOR ORDER BY pg_catalog.float_ops,
+--	OPERATOR	25		<-> (tgeogpoint, stbox) FOR ORDER BY pg_catalog.float_ops,
+--	OPERATOR	25		<-> (tgeogpoint, tgeogpoint) FOR ORDER BY pg_catalog.float_ops,
+	-- overlaps or before
+	OPERATOR	28		&<# (tgeogpoint, stbox),
+	OPERATOR	28		&<# (tgeogpoint, tgeogpoint),
+	-- strictly before
+	OPERATOR	29		<<# (tgeogpoint, stbox),
+	OPERATOR	29		<<# (tgeogpoint, tgeogpoint),
+	-- strictly after
+	OPERATOR	30		#>> (tgeogpoint, stbox),
+	OPERATOR	30		#>> (tgeogpoint, tgeogpoint),
+	-- overlaps or after
+	OPERATOR	31		#&> (tgeogpoint, stbox),
+	OPERATOR	31		#&> (tgeogpoint, tgeogpoint),
+	-- functions
+	FUNCTION	1	gist_tgeogpoint_compact_consistent(internal, tgeogpoint, smallint, oid, internal),
+	FUNCTION	2	gist_tpoint_union(internal, internal),
+	FUNCTION	3	gist_tpoint_compact_compress(internal),
+	FUNCTION	4	gist_tpoint_compact_decompress(internal),
+	FUNCTION	5	gist_tpoint_penalty(internal, internal, internal),
+	FUNCTION	6	gist_tpoint_picksplit(internal, internal),
+	FUNCTION	7	gist_stboxf_same(stboxf, stboxf, internal),
+	FUNCTION	8	gist_tgeogpoint_distance(internal, tgeogpoint, smallint, oid, internal);
+
+/******************************************************************************/
+
+/******************************************************************************
+ * Sort key for building GiST indexes
+ ******************************************************************************/
+
+CREATE FUNCTION zorder(stbox, stbox)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'stbox_zorder'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION zorder(tgeompoint, stbox)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'tpoint_zorder'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION zorder(tgeogpoint, stbox)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'tpoint_zorder'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/******************************************************************************/
@@ -0,0 +1,59 @@
+/*****************************************************************************
+ *
+ * tpoint_gin.sql
+ *	  Multi-entry GIN index for temporal points.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse, 
+ * 		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+CREATE FUNCTION splitSTBoxes(tgeompoint, integer)
+	RETURNS stbox[]
+	AS 'MODULE_PATHNAME', 'tpoint_split_stboxes_sql'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/******************************************************************************/
+
+CREATE FUNCTION gin_stbox_cmp(stbox, stbox)
+	RETURNS integer
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gin_tgeompoint_extract_value(tgeompoint, internal, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gin_tpoint_extract_value'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gin_tgeompoint_extract_query(tgeompoint, internal, smallint, internal, internal, internal, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gin_tpoint_extract_query'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gin_tgeompoint_consistent(internal, smallint, tgeompoint, integer, internal, internal, internal, internal)
+	RETURNS bool
+	AS 'MODULE_PATHNAME', 'gin_tpoint_consistent'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gin_stbox_compare_partial(stbox, stbox, smallint, internal)
+	RETURNS integer
+	AS 'MODULE_PATHNAME', 'gin_tpoint_compare_partial'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS gin_tgeompoint_ops
+	FOR TYPE tgeompoint USING gin AS
+	STORAGE stbox,
+	-- overlaps
+	OPERATOR	1		&& (tgeompoint, geometry),
+	OPERATOR	2		&& (tgeompoint, stbox),
+	OPERATOR	3		&& (tgeompoint, tgeompoint),
+	-- contained by
+	OPERATOR	4		<@ (tgeompoint, geometry),
+	OPERATOR	5		<@ (tgeompoint, stbox),
+	OPERATOR	6		<@ (tgeompoint, tgeompoint),
+	-- functions
+	FUNCTION	1	gin_stbox_cmp(stbox, stbox),
+	FUNCTION	2	gin_tgeompoint_extract_value(tgeompoint, internal, internal),
+	FUNCTION	3	gin_tgeompoint_extract_query(tgeompoint, internal, smallint, internal, internal, internal, internal),
+	FUNCTION	4	gin_tgeompoint_consistent(internal, smallint, tgeompoint, integer, internal, internal, internal, internal),
+	FUNCTION	5	gin_stbox_compare_partial(stbox, stbox, smallint, internal);
+
+/******************************************************************************/
@@ -0,0 +1,78 @@
+/*****************************************************************************
+ *
+ * tpoint_brin.sql
+ *	  BRIN inclusion index for temporal points
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse, 
+ * 		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+CREATE FUNCTION brin_stbox_merge(stbox, stbox)
+	RETURNS stbox
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION brin_tpoint_add_value(internal, internal, internal, internal)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS brin_tgeompoint_inclusion_ops
+	DEFAULT FOR TYPE tgeompoint USING brin AS
+	-- overlaps
+	OPERATOR	3		&& (tgeompoint, stbox),
+	OPERATOR	3		&& (tgeompoint, tgeompoint),
+	-- same
+	OPERATOR	6		~= (tgeompoint, stbox),
+	OPERATOR	6		~= (tgeompoint, tgeompoint),
+	-- contains
+	OPERATOR	7		@> (tgeompoint, stbox),
+	OPERATOR	7		@> (tgeompoint, tgeompoint),
+	-- contained by
+	OPERATOR	8		<@ (tgeompoint, stbox),
+	OPERATOR	8		<@ (tgeompoint, tgeompoint),
+	-- operators applied to the summary of a range of pages
+	OPERATOR	3		&& (stbox, stbox),
+	OPERATOR	3		&& (stbox, tgeompoint),
+	OPERATOR	7		@> (stbox, stbox),
+	OPERATOR	7		@> (stbox, tgeompoint),
+	-- functions
+	FUNCTION	1	brin_inclusion_opcinfo(internal),
+	FUNCTION	2	brin_tpoint_add_value(internal, internal, internal, internal),
+	FUNCTION	3	brin_inclusion_consistent(internal, internal, internal),
+	FUNCTION	4	brin_inclusion_union(internal, internal, internal),
+	FUNCTION	11	brin_stbox_merge(stbox, stbox),
+	STORAGE stbox;
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS brin_tgeogpoint_inclusion_ops
+	DEFAULT FOR TYPE tgeogpoint USING brin AS
+	-- overlaps
+	OPERATOR	3		&& (tgeogpoint, stbox),
+	OPERATOR	3		&& (tgeogpoint, tgeogpoint),
+	-- same
+	OPERATOR	6		~= (tgeogpoint, stbox),
+	OPERATOR	6		~= (tgeogpoint, tgeogpoint),
+	-- contains
+	OPERATOR	7		@> (tgeogpoint, stbox),
+	OPERATOR	7		@> (tgeogpoint, tgeogpoint),
+	-- contained by
+	OPERATOR	8		<@ (tgeogpoint, stbox),
+	OPERATOR	8		<@ (tgeogpoint, tgeogpoint),
+	-- operators applied to the summary of a range of pages
+	OPERATOR	3		&& (stbox, stbox),
+	OPERATOR	3		&& (stbox, tgeogpoint),
+	OPERATOR	7		@> (stbox, stbox),
+	OPERATOR	7		@> (stbox, tgeogpoint),
+	-- functions
+	FUNCTION	1	brin_inclusion_opcinfo(internal),
+	FUNCTION	2	brin_tpoint_add_value(internal, internal, internal, internal),
+	FUNCTION	3	brin_inclusion_consistent(internal, internal, internal),
+	FUNCTION	4	brin_inclusion_union(internal, internal, internal),
+	FUNCTION	11	brin_stbox_merge(stbox, stbox),
+	STORAGE stbox;
+
+/******************************************************************************/
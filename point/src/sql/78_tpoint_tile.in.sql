@@ -0,0 +1,66 @@
+/*****************************************************************************
+ *
+ * tpoint_tile.sql
+ *	  Split of temporal points according to a spatiotemporal grid
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+CREATE FUNCTION spaceTimeSplit(tgeompoint, cellsize float, duration interval,
+		sorigin geometry DEFAULT 'Point(0 0)',
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00',
+		OUT cellx integer, OUT celly integer, OUT bucket timestamptz,
+		OUT fragment tgeompoint)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'tpoint_space_time_split'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION timeSplit(tgeompoint, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00',
+		OUT bucket timestamptz, OUT fragment tgeompoint)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'temporal_time_split_srf'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION timeSplit(tgeogpoint, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00',
+		OUT bucket timestamptz, OUT fragment tgeogpoint)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'temporal_time_split_srf'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION tsample(tgeompoint, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00')
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'temporal_tsample'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(tgeogpoint, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00')
+	RETURNS tgeogpoint
+	AS 'MODULE_PATHNAME', 'temporal_tsample'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION tileKeys(tgeompoint, cellsize float, duration interval,
+		sorigin geometry DEFAULT 'Point(0 0)',
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00')
+	RETURNS bigint[]
+	AS 'MODULE_PATHNAME', 'tpoint_tile_keys'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tileKeys(stbox, cellsize float, duration interval,
+		sorigin geometry DEFAULT 'Point(0 0)',
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00')
+	RETURNS bigint[]
+	AS 'MODULE_PATHNAME', 'stbox_tile_keys'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION asMVTGeom(tgeompoint, bounds stbox, extent integer DEFAULT 4096,
+		buffer integer DEFAULT 256, clip boolean DEFAULT true,
+		OUT geom geometry, OUT times float8[])
+	RETURNS record
+	AS 'MODULE_PATHNAME', 'tpoint_as_mvtgeom'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************/
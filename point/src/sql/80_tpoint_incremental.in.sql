@@ -0,0 +1,47 @@
+/*****************************************************************************
+ *
+ * tpoint_incremental.sql
+ *	  Incremental computation of temporal relationships over streams of
+ *	  temporal points
+ *
+ * The first argument of the functions is the previous result, which is NULL
+ * for the first call. The functions only compute the relationship from the
+ * instant at which the previous result ends, e.g.,
+ *	UPDATE trips SET inzone = tintersectsAppend(inzone, trip, zone)
+ * after new instants have been added to trip with appendInstant.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+CREATE FUNCTION tintersectsAppend(tbool, tgeompoint, geometry)
+	RETURNS tbool
+	AS 'MODULE_PATHNAME', 'tintersects_append_tpoint_geo'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tintersectsAppend(tbool, tgeogpoint, geography)
+	RETURNS tbool
+	AS 'MODULE_PATHNAME', 'tintersects_append_tpoint_geo'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE FUNCTION tdwithinAppend(tbool, tgeompoint, geometry, dist float8)
+	RETURNS tbool
+	AS 'MODULE_PATHNAME', 'tdwithin_append_tpoint_geo'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tdwithinAppend(tbool, tgeompoint, tgeompoint, dist float8)
+	RETURNS tbool
+	AS 'MODULE_PATHNAME', 'tdwithin_append_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE FUNCTION distanceAppend(tfloat, tgeompoint, tgeompoint)
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'distance_append_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION distanceAppend(tfloat, tgeogpoint, tgeogpoint)
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'distance_append_tpoint_tpoint'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+/*****************************************************************************/
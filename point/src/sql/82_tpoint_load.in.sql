@@ -0,0 +1,22 @@
+/*****************************************************************************
+ *
+ * tpoint_load.sql
+ *	  Bulk load of temporal points from files
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+/* The lines of the file are of the form id,t,x,y or id,t,x,y,z */
+
+CREATE FUNCTION loadTGeomPoint(filename text, srid integer DEFAULT 0,
+		header boolean DEFAULT true, delimiter text DEFAULT ',',
+		OUT id text, OUT trip tgeompoint)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'tgeompoint_load_csv'
+	LANGUAGE C VOLATILE STRICT;
+
+/*****************************************************************************/
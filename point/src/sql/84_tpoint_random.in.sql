@@ -0,0 +1,22 @@
+/*****************************************************************************
+ *
+ * tpoint_random.sql
+ *	  Generation of random temporal points for benchmarks
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+/* The distribution is one of uniform, walk, clustered, and road */
+
+CREATE FUNCTION random_tgeompoint_seq(stbox, count integer,
+		step interval DEFAULT '1 minute', distribution text DEFAULT 'uniform',
+		seed bigint DEFAULT 0, srid integer DEFAULT 0)
+	RETURNS tgeompoint
+	AS 'MODULE_PATHNAME', 'random_tgeompoint_seq'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************/
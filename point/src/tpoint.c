@@ -18,6 +18,7 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_compress.h"
 #include "lifting.h"
 #include "temporal_compops.h"
 #include "stbox.h"
@@ -398,6 +399,8 @@ PGDLLEXPORT Datum tpoint_enforce_typmod(PG_FUNCTION_ARGS)
 	int32 typmod = PG_GETARG_INT32(1);
 	/* Check if geometry typmod is consistent with the supplied one.  */
 	temp = tpoint_valid_typmod(temp, typmod);
+	/* Store the sequences of the column in packed form */
+	temp = temporal_typmod_pack(temp, typmod);
 	PG_RETURN_POINTER(temp);
 }
 
@@ -424,6 +427,79 @@ tpointinst_constructor(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+/* Construct a temporal sequence point from arrays of coordinates and an
+ * array of timestamps. A single point is serialized and copied into all the 
+ * instants, whose coordinates are then set in place. */
+
+static Datum
+tpointseq_from_arrays_internal(FunctionCallInfo fcinfo, bool hasz)
+{
+	int ndims = hasz ? 3 : 2;
+	ArrayType *arrays[4];
+	for (int i = 0; i <= ndims; i++)
+		arrays[i] = PG_GETARG_ARRAYTYPE_P(i);
+	int srid = PG_GETARG_INT32(ndims + 1);
+	bool lower_inc = PG_GETARG_BOOL(ndims + 2);
+	bool upper_inc = PG_GETARG_BOOL(ndims + 3);
+	bool linear = PG_GETARG_BOOL(ndims + 4);
+	int count = ArrayGetNItems(ARR_NDIM(arrays[0]), ARR_DIMS(arrays[0]));
+	if (count == 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("A temporal sequence must have at least one temporal instant")));
+	for (int i = 1; i <= ndims; i++)
+	{
+		if (ArrayGetNItems(ARR_NDIM(arrays[i]), ARR_DIMS(arrays[i])) != count)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("The input arrays must have the same number of elements")));
+	}
+
+	Datum *coords[3];
+	for (int i = 0; i < ndims; i++)
+		coords[i] = datumarr_extract(arrays[i], &count);
+	TimestampTz *times = timestamparr_extract(arrays[ndims], &count);
+	/* Serialize the model point with the SRID and the dimensionality */
+	LWPOINT *lwpoint = hasz ? lwpoint_make3dz(srid, 0, 0, 0) :
+		lwpoint_make2d(srid, 0, 0);
+	GSERIALIZED *gs = geometry_serialize((LWGEOM *) lwpoint);
+	TemporalInst *model = temporalinst_make(PointerGetDatum(gs), times[0],
+		type_oid(T_GEOMETRY));
+	TemporalInst **instants = temporalinstarr_from_model(model, times, count);
+	for (int i = 0; i < count; i++)
+	{
+		GSERIALIZED *point = (GSERIALIZED *) temporalinst_value_ptr(instants[i]);
+		double *pt = (double *)((uint8_t *) point->data + 8);
+		for (int j = 0; j < ndims; j++)
+			pt[j] = DatumGetFloat8(coords[j][i]);
+	}
+	Temporal *result = (Temporal *)temporalseq_from_temporalinstarr(instants, 
+		count, lower_inc, upper_inc, linear, true);
+
+	pfree(instants[0]); pfree(instants); pfree(model);
+	lwpoint_free(lwpoint); pfree(gs);
+	for (int i = 0; i < ndims; i++)
+		pfree(coords[i]);
+	pfree(times);
+	for (int i = 0; i <= ndims; i++)
+		PG_FREE_IF_COPY(arrays[i], i);
+	PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(tpointseq_from_xyt_arrays);
+
+PGDLLEXPORT Datum
+tpointseq_from_xyt_arrays(PG_FUNCTION_ARGS) 
+{
+	return tpointseq_from_arrays_internal(fcinfo, false);
+}
+
+PG_FUNCTION_INFO_V1(tpointseq_from_xyzt_arrays);
+
+PGDLLEXPORT Datum
+tpointseq_from_xyzt_arrays(PG_FUNCTION_ARGS) 
+{
+	return tpointseq_from_arrays_internal(fcinfo, true);
+}
+
 /*****************************************************************************
  * Accessor functions
  *****************************************************************************/
@@ -436,7 +512,7 @@ PG_FUNCTION_INFO_V1(tpoint_stbox);
 PGDLLEXPORT Datum
 tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Temporal *temp = PG_GETARG_TEMPORAL_HEADER(0);
 	STBOX *result = palloc0(sizeof(STBOX));
 	temporal_bbox(result, temp);
 	PG_FREE_IF_COPY(temp, 0);
@@ -3,7 +3,8 @@
  * tpoint_aggfuncs.c
  *	Aggregate functions for temporal points.
  *
- * The only functions currently provided are extent and temporal centroid.
+ * The functions currently provided are extent, temporal centroid, and the
+ * assembly of trips from points and timestamps.
  *
  * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
  *	  Universite Libre de Bruxelles
@@ -15,158 +16,18 @@
 #include "tpoint_aggfuncs.h"
 
 #include <assert.h>
+#include <math.h>
+#include <utils/memutils.h>
+#include <utils/timestamp.h>
 
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
-#include "doublen.h"
-#include "temporal_aggfuncs.h"
+#include "temporal_probes.h"
+#include "temporal_stats.h"
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
 
-/*****************************************************************************
- * Generic functions
- *****************************************************************************/
-
-struct GeoAggregateState
-{
-	int32_t srid;
-	bool hasz;
-};
-
-static void
-geoaggstate_check(SkipList *state, int32_t srid, bool hasz)
-{
-	if(! state)
-		return;
-	struct GeoAggregateState *extra = state->extra;
-	if (extra && extra->srid != srid)
-		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-			errmsg("Geometries must have the same SRID for temporal aggregation")));
-	if (extra && extra->hasz != hasz)
-		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-			errmsg("Geometries must have the same dimensionality for temporal aggregation")));
-}
-
-static void 
-geoaggstate_check_as(SkipList *state1, SkipList *state2)
-{
-	struct GeoAggregateState *extra2 = state2->extra;
-	if (extra2)
-		geoaggstate_check(state1, extra2->srid, extra2->hasz);
-}
-
-static void
-geoaggstate_check_t(SkipList *state, Temporal *t)
-{
-	geoaggstate_check(state, tpoint_srid_internal(t), MOBDB_FLAGS_GET_Z(t->flags) != 0);
-}
-
-/*****************************************************************************/
-
-/*
- * Transform a temporal point type into a temporal double3/double4 type for 
- * performing centroid aggregation 
- */
-static TemporalInst *
-tpointinst_transform_tcentroid(TemporalInst *inst)
-{
-	TemporalInst *result;
-	if (MOBDB_FLAGS_GET_Z(inst->flags))
-	{
-		POINT3DZ point = datum_get_point3dz(temporalinst_value(inst));
-		double4 dvalue;
-		double4_set(&dvalue, point.x, point.y, point.z, 1);
-		result = temporalinst_make(PointerGetDatum(&dvalue), inst->t,
-			type_oid(T_DOUBLE4));
-	}
-	else 
-	{
-		POINT2D point = datum_get_point2d(temporalinst_value(inst));
-		double3 dvalue;
-		double3_set(&dvalue, point.x, point.y, 1);
-		result = temporalinst_make(PointerGetDatum(&dvalue), inst->t,
-			type_oid(T_DOUBLE3));
-	}
-	return result;
-}
-
-static TemporalInst **
-tpointi_transform_tcentroid(TemporalI *ti)
-{
-	TemporalInst **result = palloc(sizeof(TemporalInst *) * ti->count);
-	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		result[i] = tpointinst_transform_tcentroid(inst);
-	}
-	return result;
-}
-
-static TemporalSeq *
-tpointseq_transform_tcentroid(TemporalSeq *seq)
-{
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
-	for (int i = 0; i < seq->count; i++)
-	{
-		TemporalInst *inst = temporalseq_inst_n(seq, i);
-		instants[i] = tpointinst_transform_tcentroid(inst);
-	}
-	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, 
-		seq->count, seq->period.lower_inc, seq->period.upper_inc, 
-		MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
-	
-	for (int i = 0; i < seq->count; i++)
-		pfree(instants[i]);
-	pfree(instants);
-		
-	return result;
-}
-
-static TemporalSeq **
-tpoints_transform_tcentroid(TemporalS *ts)
-{
-	TemporalSeq **result = palloc(sizeof(TemporalSeq *) * ts->count);
-	for (int i = 0; i < ts->count; i++)
-	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		result[i] = tpointseq_transform_tcentroid(seq);
-	}
-	return result;
-}
-
-/* Dispatch function  */
-
-static Temporal **
-tpoint_transform_tcentroid(Temporal *temp, int *count)
-{
-	Temporal **result = NULL;
-	if (temp->duration == TEMPORALINST) 
-	{
-		result = palloc(sizeof(Temporal *));
-		result[0] = (Temporal *)tpointinst_transform_tcentroid((TemporalInst *)temp);
-		*count = 1;
-	}
-	else if (temp->duration == TEMPORALI)
-	{
-		result = (Temporal **)tpointi_transform_tcentroid((TemporalI *) temp);
-		*count = ((TemporalI *)temp)->count;
-	} 
-	else if (temp->duration == TEMPORALSEQ)
-	{
-		result = palloc(sizeof(Temporal *));
-		result[0] = (Temporal *)tpointseq_transform_tcentroid((TemporalSeq *) temp);
-		*count = 1;
-	}
-	else if (temp->duration == TEMPORALS)
-	{
-		result = (Temporal **)tpoints_transform_tcentroid((TemporalS *) temp);
-		*count = ((TemporalS *)temp)->count;
-	}
-	assert(result != NULL);
-	return result;
-}
-
 /*****************************************************************************
  * Extent
  *****************************************************************************/
@@ -282,54 +143,179 @@ tpoint_extent_combinefn(PG_FUNCTION_ARGS)
  * Centroid
  *****************************************************************************/
 
-PG_FUNCTION_INFO_V1(tpoint_tcentroid_transfn);
+/*
+ * The points of the aggregated values are accumulated in the flat array of 
+ * a CentroidState without any intermediate temporal value. The transition 
+ * and combine functions only append points, the centroid is computed by the
+ * final function in a single sweep over the points sorted by timestamp, 
+ * which keeps the running sums of the coordinates and the number of values
+ * defined just before, at, and just after each timestamp.
+ */
 
-PGDLLEXPORT Datum
-tpoint_tcentroid_transfn(PG_FUNCTION_ARGS)
+static CentroidState *
+tcentroid_state_alloc(FunctionCallInfo fcinfo, CentroidState *state, 
+	int count)
 {
-	SkipList *state = PG_ARGISNULL(0) ? NULL : 
-		(SkipList *) PG_GETARG_POINTER(0);
-	if (PG_ARGISNULL(1))
+	MemoryContext aggctx;
+	if (!AggCheckCallContext(fcinfo, &aggctx))
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+				errmsg("Operation not supported")));
+	int capacity = state == NULL ? count : state->count + count;
+	if (state != NULL && capacity <= state->capacity)
+		return state;
+	if (state != NULL)
+		capacity = Max(capacity, state->capacity * 2);
+	if ((size_t) capacity > (MaxAllocSize - sizeof(CentroidState)) / 
+			sizeof(CentroidPoint))
+		ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+			errmsg("Too many points for temporal centroid")));
+	size_t memsize = offsetof(CentroidState, points) + 
+		sizeof(CentroidPoint) * capacity;
+	CentroidState *result;
+	if (state == NULL)
+		result = MemoryContextAllocZero(aggctx, memsize);
+	else
+		result = repalloc(state, memsize);
+	SET_VARSIZE(result, memsize);
+	result->capacity = capacity;
+	return result;
+}
+
+static void
+tpointinst_tcentroid_point(CentroidPoint *point, TemporalInst *inst, 
+	bool hasz, int flags)
+{
+	point->t = inst->t;
+	if (hasz)
 	{
-		if (state)
-			PG_RETURN_POINTER(state);
-		else
-			PG_RETURN_NULL();
+		POINT3DZ p = datum_get_point3dz(temporalinst_value(inst));
+		point->x = p.x;
+		point->y = p.y;
+		point->z = p.z;
 	}
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
+	else
+	{
+		POINT2D p = datum_get_point2d(temporalinst_value(inst));
+		point->x = p.x;
+		point->y = p.y;
+		point->z = 0;
+	}
+	point->flags = flags;
+}
 
-	geoaggstate_check_t(state, temp);
-	Datum (*func)(Datum, Datum) = MOBDB_FLAGS_GET_Z(temp->flags) ?
-		&datum_sum_double4 : &datum_sum_double3;
+static int
+tpointseq_tcentroid_points(CentroidPoint *points, TemporalSeq *seq, 
+	bool hasz)
+{
+	for (int i = 0; i < seq->count; i++)
+	{
+		int flags = 0;
+		if (i == 0)
+			flags |= CENTROID_FIRST | 
+				(seq->period.lower_inc ? CENTROID_LOWER_INC : 0);
+		if (i == seq->count - 1)
+			flags |= CENTROID_LAST | 
+				(seq->period.upper_inc ? CENTROID_UPPER_INC : 0);
+		tpointinst_tcentroid_point(&points[i], temporalseq_inst_n(seq, i),
+			hasz, flags);
+	}
+	return seq->count;
+}
 
-	int count;
-	Temporal **temporals = tpoint_transform_tcentroid(temp, &count);
-	if (state)
+/* Append the points of a temporal point to the state */
+
+static CentroidState *
+tpoint_tcentroid_state_add(FunctionCallInfo fcinfo, CentroidState *state, 
+	Temporal *temp)
+{
+	int32_t srid = tpoint_srid_internal(temp);
+	bool hasz = MOBDB_FLAGS_GET_Z(temp->flags) != 0;
+	int16 duration = (temp->duration == TEMPORALINST || 
+		temp->duration == TEMPORALI) ? TEMPORALINST : TEMPORALSEQ;
+	bool linear = duration == TEMPORALSEQ && 
+		MOBDB_FLAGS_GET_LINEAR(temp->flags);
+	if (state != NULL)
 	{
-		if (skiplist_headval(state)->duration != temporals[0]->duration)
+		if (state->srid != srid)
+			ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+				errmsg("Geometries must have the same SRID for temporal aggregation")));
+		if (state->hasz != hasz)
+			ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+				errmsg("Geometries must have the same dimensionality for temporal aggregation")));
+		if (state->duration != duration)
 			ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
 				errmsg("Cannot aggregate temporal values of different duration")));
-		if (MOBDB_FLAGS_GET_LINEAR(skiplist_headval(state)->flags) != 
-				MOBDB_FLAGS_GET_LINEAR(temporals[0]->flags))
+		if (state->linear != linear)
 			ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
 				errmsg("Cannot aggregate temporal values of different interpolation")));
+	}
 
-		skiplist_splice(fcinfo, state, temporals, count, func, false);
+	int count;
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+		count = 1;
+	else if (temp->duration == TEMPORALI)
+		count = ((TemporalI *)temp)->count;
+	else if (temp->duration == TEMPORALSEQ)
+		count = ((TemporalSeq *)temp)->count;
+	else /* temp->duration == TEMPORALS */
+		count = ((TemporalS *)temp)->totalcount;
+
+	bool isnew = state == NULL;
+	state = tcentroid_state_alloc(fcinfo, state, count);
+	if (isnew)
+	{
+		state->srid = srid;
+		state->hasz = hasz;
+		state->linear = linear;
+		state->duration = duration;
 	}
-	else
+
+	CentroidPoint *points = &state->points[state->count];
+	int flags = CENTROID_FIRST | CENTROID_LAST | CENTROID_LOWER_INC | 
+		CENTROID_UPPER_INC;
+	if (temp->duration == TEMPORALINST)
+		tpointinst_tcentroid_point(&points[0], (TemporalInst *)temp, hasz, 
+			flags);
+	else if (temp->duration == TEMPORALI)
 	{
-		state = skiplist_make(fcinfo, temporals, count);
-		struct GeoAggregateState extra =
-		{
-			.srid = tpoint_srid_internal(temp),
-			.hasz = MOBDB_FLAGS_GET_Z(temp->flags) != 0
-		};
-		aggstate_set_extra(fcinfo, state, &extra, sizeof(struct GeoAggregateState));
+		TemporalI *ti = (TemporalI *)temp;
+		for (int i = 0; i < ti->count; i++)
+			tpointinst_tcentroid_point(&points[i], temporali_inst_n(ti, i), 
+				hasz, flags);
 	}
+	else if (temp->duration == TEMPORALSEQ)
+		tpointseq_tcentroid_points(points, (TemporalSeq *)temp, hasz);
+	else /* temp->duration == TEMPORALS */
+	{
+		TemporalS *ts = (TemporalS *)temp;
+		int k = 0;
+		for (int i = 0; i < ts->count; i++)
+			k += tpointseq_tcentroid_points(&points[k], temporals_seq_n(ts, i),
+				hasz);
+	}
+	state->count += count;
+	return state;
+}
 
-	for (int i = 0; i< count; i++)
-		pfree(temporals[i]);
-	pfree(temporals);		
+PG_FUNCTION_INFO_V1(tpoint_tcentroid_transfn);
+
+PGDLLEXPORT Datum
+tpoint_tcentroid_transfn(PG_FUNCTION_ARGS)
+{
+	CentroidState *state = PG_ARGISNULL(0) ? NULL : 
+		(CentroidState *) PG_GETARG_POINTER(0);
+	if (PG_ARGISNULL(1))
+	{
+		if (state)
+			PG_RETURN_POINTER(state);
+		else
+			PG_RETURN_NULL();
+	}
+	Temporal *temp = PG_GETARG_TEMPORAL(1);
+	TRACE_MOBILITYDB_AGG_TRANSFN_START(temporal_stat_instants(temp));
+	state = tpoint_tcentroid_state_add(fcinfo, state, temp);
+	TRACE_MOBILITYDB_AGG_TRANSFN_DONE(state->count);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_POINTER(state);
 }
@@ -342,119 +328,382 @@ PG_FUNCTION_INFO_V1(tpoint_tcentroid_combinefn);
 PGDLLEXPORT Datum
 tpoint_tcentroid_combinefn(PG_FUNCTION_ARGS)
 {
-	SkipList *state1 = PG_ARGISNULL(0) ? NULL : 
-		(SkipList *) PG_GETARG_POINTER(0);
-	SkipList *state2 = PG_ARGISNULL(1) ? NULL :
-		(SkipList *) PG_GETARG_POINTER(1);
-
-	geoaggstate_check_as(state1, state2);
-	struct GeoAggregateState *extra = NULL;
-	if (state1 && state1->extra) 
-		extra = state1->extra;
-	if (state2 && state2->extra) 
-		extra = state2->extra;
-	assert(extra != NULL);
-	Datum (*func)(Datum, Datum) = extra->hasz ?
-		&datum_sum_double4 : &datum_sum_double3;
-	SkipList *result = temporal_tagg_combinefn(fcinfo, state1, state2, 
-		func, false);
+	CentroidState *state1 = PG_ARGISNULL(0) ? NULL : 
+		(CentroidState *) PG_GETARG_POINTER(0);
+	CentroidState *state2 = PG_ARGISNULL(1) ? NULL :
+		(CentroidState *) PG_GETARG_POINTER(1);
+	if (! state1)
+		PG_RETURN_POINTER(state2);
+	if (! state2)
+		PG_RETURN_POINTER(state1);
+
+	if (state1->srid != state2->srid)
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+			errmsg("Geometries must have the same SRID for temporal aggregation")));
+	if (state1->hasz != state2->hasz)
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+			errmsg("Geometries must have the same dimensionality for temporal aggregation")));
+	if (state1->duration != state2->duration)
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+			errmsg("Cannot aggregate temporal values of different duration")));
+	if (state1->linear != state2->linear)
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+			errmsg("Cannot aggregate temporal values of different interpolation")));
 
-	PG_RETURN_POINTER(result);
+	state1 = tcentroid_state_alloc(fcinfo, state1, state2->count);
+	memcpy(&state1->points[state1->count], state2->points, 
+		sizeof(CentroidPoint) * state2->count);
+	state1->count += state2->count;
+	PG_RETURN_POINTER(state1);
 }
 
 /*****************************************************************************/
+/* Centroid serialize and deserialize functions */
+
+PG_FUNCTION_INFO_V1(tpoint_tcentroid_serialize);
+
+PGDLLEXPORT Datum
+tpoint_tcentroid_serialize(PG_FUNCTION_ARGS)
+{
+	CentroidState *state = (CentroidState *) PG_GETARG_POINTER(0);
+	size_t memsize = offsetof(CentroidState, points) + 
+		sizeof(CentroidPoint) * state->count;
+	CentroidState *result = palloc(memsize);
+	memcpy(result, state, memsize);
+	SET_VARSIZE(result, memsize);
+	result->capacity = state->count;
+	PG_RETURN_BYTEA_P(result);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_tcentroid_deserialize);
+
+PGDLLEXPORT Datum
+tpoint_tcentroid_deserialize(PG_FUNCTION_ARGS)
+{
+	bytea *data = PG_GETARG_BYTEA_P(0);
+	MemoryContext aggctx;
+	if (!AggCheckCallContext(fcinfo, &aggctx))
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+				errmsg("Operation not supported")));
+	CentroidState *result = MemoryContextAlloc(aggctx, VARSIZE(data));
+	memcpy(result, data, VARSIZE(data));
+	PG_RETURN_POINTER(result);
+}
 
+/*****************************************************************************/
 /* Centroid final function */
 
-TemporalI *
-tpointinst_tcentroid_finalfn(TemporalInst **instants, int count)
+/* Running sums of the coordinates of the points defined at some time */
+
+typedef struct
+{
+	double x;
+	double y;
+	double z;
+	int count;
+} CentroidSum;
+
+typedef struct
 {
-	TemporalInst **newinstants = palloc(sizeof(TemporalInst *) * count);
-	for (int i = 0; i < count; i++)
+	TimestampTz t;
+	int pos;             /* Position of the point in the state */
+} CentroidEvent;
+
+static int
+centroid_event_cmp(const CentroidEvent *e1, const CentroidEvent *e2)
+{
+	int result = timestamp_cmp_internal(e1->t, e2->t);
+	if (result == 0)
+		/* Keep the order of the aggregated values for the same rounding */
+		result = (e1->pos < e2->pos) ? -1 : ((e1->pos > e2->pos) ? 1 : 0);
+	return result;
+}
+
+static CentroidEvent *
+tcentroid_state_events(CentroidState *state)
+{
+	CentroidEvent *result = palloc(sizeof(CentroidEvent) * state->count);
+	for (int i = 0; i < state->count; i++)
 	{
-		TemporalInst *inst = instants[i];
-		Datum value = 0;
-		assert(inst->valuetypid == type_oid(T_DOUBLE4) || 
-			inst->valuetypid == type_oid(T_DOUBLE3));
-		if (inst->valuetypid == type_oid(T_DOUBLE4))
-		{
-			double4 *value4 = (double4 *)DatumGetPointer(temporalinst_value(inst));
-			assert(value4->d != 0);
-			double valuea = value4->a / value4->d;
-			double valueb = value4->b / value4->d;
-			double valuec = value4->c / value4->d;
-			value = call_function3(LWGEOM_makepoint, Float8GetDatum(valuea),
-				Float8GetDatum(valueb), Float8GetDatum(valuec));
-		}
-		else if (inst->valuetypid == type_oid(T_DOUBLE3))
-		{
-			double3 *value3 = (double3 *)DatumGetPointer(temporalinst_value(inst));
-			assert(value3->c != 0);
-			double valuea = value3->a / value3->c;
-			double valueb = value3->b / value3->c;
-			value = call_function2(LWGEOM_makepoint, Float8GetDatum(valuea),
-				Float8GetDatum(valueb));
-		}
-		newinstants[i] = temporalinst_make(value, inst->t, type_oid(T_GEOMETRY));
-		pfree(DatumGetPointer(value));
+		result[i].t = state->points[i].t;
+		result[i].pos = i;
 	}
-	TemporalI *result = temporali_from_temporalinstarr(newinstants, count);
+	qsort(result, (size_t) state->count, sizeof(CentroidEvent),
+		(qsort_comparator) &centroid_event_cmp);
+	return result;
+}
 
-	for (int i = 0; i < count; i++)
-		pfree(newinstants[i]);
-	pfree(newinstants);
-	
+/*
+ * The sums are compared up to EPSILON. The order in which the points are
+ * added differs between serial and parallel aggregation, so that the sums
+ * may differ in the last bits for the same values.
+ */
+static bool
+centroid_sum_eq(CentroidSum *sum1, CentroidSum *sum2)
+{
+	return sum1->count == sum2->count && 
+		fabs(sum1->x - sum2->x) <= EPSILON && 
+		fabs(sum1->y - sum2->y) <= EPSILON && 
+		fabs(sum1->z - sum2->z) <= EPSILON;
+}
+
+/* Add to the sum the difference of two points, either of which may be NULL */
+
+static void
+centroid_sum_add(CentroidSum *sum, CentroidPoint *plus, CentroidPoint *minus)
+{
+	if (plus != NULL)
+	{
+		sum->x += plus->x;
+		sum->y += plus->y;
+		sum->z += plus->z;
+		sum->count++;
+	}
+	if (minus != NULL)
+	{
+		sum->x -= minus->x;
+		sum->y -= minus->y;
+		sum->z -= minus->z;
+		sum->count--;
+	}
+}
+
+static void
+centroid_sum_plus(CentroidSum *result, CentroidSum *sum, CentroidSum *delta)
+{
+	result->x = sum->x + delta->x;
+	result->y = sum->y + delta->y;
+	result->z = sum->z + delta->z;
+	result->count = sum->count + delta->count;
+}
+
+static TemporalInst *
+centroid_sum_instant(CentroidSum *sum, TimestampTz t, bool hasz)
+{
+	Datum value;
+	if (hasz)
+		value = call_function3(LWGEOM_makepoint, 
+			Float8GetDatum(sum->x / sum->count),
+			Float8GetDatum(sum->y / sum->count), 
+			Float8GetDatum(sum->z / sum->count));
+	else
+		value = call_function2(LWGEOM_makepoint, 
+			Float8GetDatum(sum->x / sum->count),
+			Float8GetDatum(sum->y / sum->count));
+	TemporalInst *result = temporalinst_make(value, t, type_oid(T_GEOMETRY));
+	pfree(DatumGetPointer(value));
+	return result;
+}
+
+/* Centroid of instant values, the points at equal timestamps are averaged */
+
+static TemporalI *
+tcentroid_state_instants(CentroidState *state, CentroidEvent *events)
+{
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * state->count);
+	int count = 0;
+	int i = 0;
+	while (i < state->count)
+	{
+		TimestampTz t = events[i].t;
+		CentroidSum sum;
+		memset(&sum, 0, sizeof(CentroidSum));
+		while (i < state->count && events[i].t == t)
+			centroid_sum_add(&sum, &state->points[events[i++].pos], NULL);
+		instants[count++] = centroid_sum_instant(&sum, t, state->hasz);
+	}
+	TemporalI *result = temporali_from_temporalinstarr(instants, count);
+	for (int j = 0; j < count; j++)
+		pfree(instants[j]);
+	pfree(instants);
 	return result;
 }
 
-TemporalS *
-tpointseq_tcentroid_finalfn(TemporalSeq **sequences, int count)
+/* Sequences of the result being constructed */
+
+typedef struct
+{
+	bool hasz;
+	bool linear;
+	TemporalInst **instants;
+	int ninstants;
+	bool lower_inc;
+	bool open;           /* True when the current sequence is not finished */
+	CentroidSum cur;     /* Last value of the current sequence */
+	TemporalSeq **sequences;
+	int nsequences;
+} CentroidResult;
+
+static void
+centroid_result_append(CentroidResult *cr, TimestampTz t, CentroidSum *sum)
+{
+	cr->instants[cr->ninstants++] = centroid_sum_instant(sum, t, cr->hasz);
+	cr->cur = *sum;
+}
+
+static void
+centroid_result_open(CentroidResult *cr, TimestampTz t, CentroidSum *sum,
+	bool lower_inc)
+{
+	cr->ninstants = 0;
+	centroid_result_append(cr, t, sum);
+	cr->lower_inc = lower_inc;
+	cr->open = true;
+}
+
+static void
+centroid_result_close(CentroidResult *cr, TimestampTz t, CentroidSum *sum,
+	bool upper_inc)
+{
+	centroid_result_append(cr, t, sum);
+	cr->sequences[cr->nsequences++] = temporalseq_from_temporalinstarr(
+		cr->instants, cr->ninstants, cr->lower_inc, upper_inc, cr->linear, 
+		true);
+	for (int i = 0; i < cr->ninstants; i++)
+		pfree(cr->instants[i]);
+	cr->ninstants = 0;
+	cr->open = false;
+}
+
+static void
+centroid_result_instant(CentroidResult *cr, TimestampTz t, CentroidSum *sum)
+{
+	centroid_result_open(cr, t, sum, true);
+	cr->sequences[cr->nsequences++] = temporalseq_from_temporalinstarr(
+		cr->instants, 1, true, true, cr->linear, false);
+	pfree(cr->instants[0]);
+	cr->ninstants = 0;
+	cr->open = false;
+}
+
+/*
+ * Centroid of sequence values. At each timestamp the points of the 
+ * sequences give the change of the sums just before, at, and just after
+ * the timestamp with respect to the sums just before it. With linear 
+ * interpolation the sums between two timestamps are obtained from the sum 
+ * of the slopes of the segments crossing them. The result is a set of 
+ * ordered and non-overlapping sequences whose instants are collinear 
+ * except at the timestamps where the set of segments changes.
+ */
+static TemporalS *
+tcentroid_state_sequences(CentroidState *state, CentroidEvent *events)
 {
-	TemporalSeq **newsequences = palloc(sizeof(TemporalSeq *) * count);
-	for (int i = 0; i < count; i++)
+	bool linear = state->linear;
+	CentroidResult cr;
+	memset(&cr, 0, sizeof(CentroidResult));
+	cr.hasz = state->hasz;
+	cr.linear = linear;
+	/* Each timestamp adds at most two instants to the current sequence and
+	 * finishes at most two sequences */
+	cr.instants = palloc(sizeof(TemporalInst *) * (state->count + 1));
+	cr.sequences = palloc(sizeof(TemporalSeq *) * 2 * state->count);
+
+	CentroidSum before, at, after;
+	memset(&after, 0, sizeof(CentroidSum));
+	double slopex = 0, slopey = 0, slopez = 0;
+	TimestampTz prevt = events[0].t;
+	int i = 0;
+	while (i < state->count)
 	{
-		TemporalSeq *seq = sequences[i];
-		TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
-		for (int j = 0; j < seq->count; j++)
+		TimestampTz t = events[i].t;
+		double duration = (double) (t - prevt);
+		before = after;
+		before.x += slopex * duration;
+		before.y += slopey * duration;
+		before.z += slopez * duration;
+		/* The changes are added apart so that they cancel out exactly */
+		CentroidSum dat, dafter;
+		memset(&dat, 0, sizeof(CentroidSum));
+		memset(&dafter, 0, sizeof(CentroidSum));
+		for ( ; i < state->count && events[i].t == t; i++)
 		{
-			TemporalInst *inst = temporalseq_inst_n(seq, j);
-			Datum value = 0;
-			assert(inst->valuetypid == type_oid(T_DOUBLE4) || 
-				inst->valuetypid == type_oid(T_DOUBLE3));
-			if (inst->valuetypid == type_oid(T_DOUBLE4))
+			CentroidPoint *p = &state->points[events[i].pos];
+			bool first = (p->flags & CENTROID_FIRST) != 0;
+			bool last = (p->flags & CENTROID_LAST) != 0;
+			CentroidPoint *left = first ? NULL : (linear ? p : p - 1);
+			CentroidPoint *point = (first && !(p->flags & CENTROID_LOWER_INC)) ||
+				(last && !(p->flags & CENTROID_UPPER_INC)) ? NULL : p;
+			CentroidPoint *right = last ? NULL : p;
+			centroid_sum_add(&dat, point, left);
+			centroid_sum_add(&dafter, right, left);
+			if (linear && ! first)
 			{
-				double4 *value4 = (double4 *)DatumGetPointer(temporalinst_value(inst));
-				double valuea = value4->a / value4->d;
-				double valueb = value4->b / value4->d;
-				double valuec = value4->c / value4->d;
-				value = call_function3(LWGEOM_makepoint, Float8GetDatum(valuea),
-					Float8GetDatum(valueb), Float8GetDatum(valuec));
+				double d = (double) (p->t - (p - 1)->t);
+				slopex -= (p->x - (p - 1)->x) / d;
+				slopey -= (p->y - (p - 1)->y) / d;
+				slopez -= (p->z - (p - 1)->z) / d;
 			}
-			else if (inst->valuetypid == type_oid(T_DOUBLE3))
+			if (linear && ! last)
 			{
-				double3 *value3 = (double3 *)DatumGetPointer(temporalinst_value(inst));
-				double valuea = value3->a / value3->c;
-				double valueb = value3->b / value3->c;
-				value = call_function2(LWGEOM_makepoint, Float8GetDatum(valuea),
-					Float8GetDatum(valueb));
+				double d = (double) ((p + 1)->t - p->t);
+				slopex += ((p + 1)->x - p->x) / d;
+				slopey += ((p + 1)->y - p->y) / d;
+				slopez += ((p + 1)->z - p->z) / d;
 			}
-			instants[j] = temporalinst_make(value, inst->t, type_oid(T_GEOMETRY));
-			pfree(DatumGetPointer(value));
 		}
-		newsequences[i] = temporalseq_from_temporalinstarr(instants, 
-			seq->count, seq->period.lower_inc, seq->period.upper_inc, 
-			MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
-		for (int j = 0; j < seq->count; j++)
-			pfree(instants[j]);
-		pfree(instants);
+		centroid_sum_plus(&at, &before, &dat);
+		centroid_sum_plus(&after, &before, &dafter);
+		if (after.count == 0)
+		{
+			/* Avoid propagating rounding errors to the next sequences */
+			memset(&after, 0, sizeof(CentroidSum));
+			slopex = slopey = slopez = 0;
+		}
+		prevt = t;
+
+		bool hasat = at.count > 0;
+		bool hasafter = after.count > 0;
+		bool atafter = hasat && hasafter && centroid_sum_eq(&at, &after);
+		if (cr.open)
+		{
+			if (! linear && atafter)
+			{
+				/* The value changes at the timestamp */
+				if (! centroid_sum_eq(&at, &cr.cur))
+					centroid_result_append(&cr, t, &at);
+				continue;
+			}
+			if (linear && hasat && centroid_sum_eq(&at, &before))
+			{
+				if (hasafter && centroid_sum_eq(&after, &before))
+				{
+					centroid_result_append(&cr, t, &at);
+					continue;
+				}
+				centroid_result_close(&cr, t, &at, true);
+				if (hasafter)
+					centroid_result_open(&cr, t, &after, false);
+				continue;
+			}
+			if (! linear && hasat)
+				centroid_result_close(&cr, t, &at, true);
+			else
+				centroid_result_close(&cr, t, linear ? &before : &cr.cur, 
+					false);
+			if (! linear)
+			{
+				if (hasafter)
+					centroid_result_open(&cr, t, &after, false);
+				continue;
+			}
+		}
+		if (atafter)
+		{
+			centroid_result_open(&cr, t, &at, true);
+			continue;
+		}
+		if (hasat)
+			centroid_result_instant(&cr, t, &at);
+		if (hasafter)
+			centroid_result_open(&cr, t, &after, false);
 	}
-	TemporalS *result = temporals_from_temporalseqarr(newsequences, count, 
-		MOBDB_FLAGS_GET_LINEAR(newsequences[0]->flags), true);
 
-	for (int i = 0; i < count; i++)
-		pfree(newsequences[i]);
-	pfree(newsequences);
-	
+	TemporalS *result = temporals_from_temporalseqarr(cr.sequences, 
+		cr.nsequences, linear, true);
+	for (int j = 0; j < cr.nsequences; j++)
+		pfree(cr.sequences[j]);
+	pfree(cr.sequences);
+	pfree(cr.instants);
 	return result;
 }
 
@@ -464,27 +713,197 @@ PGDLLEXPORT Datum
 tpoint_tcentroid_finalfn(PG_FUNCTION_ARGS)
 {
 	/* The final function is strict, we do not need to test for null values */
-	SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
-	if (state->length == 0)
+	CentroidState *state = (CentroidState *) PG_GETARG_POINTER(0);
+	if (state->count == 0)
 		PG_RETURN_NULL();
 
-	Temporal **values = skiplist_values(state);
-	Temporal *result = NULL;
-	assert(values[0]->duration == TEMPORALINST ||
-		values[0]->duration == TEMPORALSEQ);
-	if (values[0]->duration == TEMPORALINST)
-		result = (Temporal *)tpointinst_tcentroid_finalfn(
-			(TemporalInst **)values, state->length);
-	else if (values[0]->duration == TEMPORALSEQ)
-		result = (Temporal *)tpointseq_tcentroid_finalfn(
-			(TemporalSeq **)values, state->length);
-
-	int32_t srid = ((struct GeoAggregateState *) state->extra)->srid;
-	Temporal *sridresult = tpoint_set_srid_internal(result, srid);
-	pfree(values);
+	CentroidEvent *events = tcentroid_state_events(state);
+	Temporal *result;
+	if (state->duration == TEMPORALINST)
+		result = (Temporal *)tcentroid_state_instants(state, events);
+	else
+		result = (Temporal *)tcentroid_state_sequences(state, events);
+
+	Temporal *sridresult = tpoint_set_srid_internal(result, state->srid);
+	pfree(events);
 	pfree(result);
 
 	PG_RETURN_POINTER(sridresult);
 }
 
+/*****************************************************************************
+ * Trip assembly
+ *****************************************************************************/
+
+/*
+ * The points and timestamps given in increasing order of time are kept in
+ * a flat array of the state, in which the first point of each trip is
+ * marked. A new trip starts when the time elapsed or the distance from the
+ * previous point is greater than the maximum gap or the maximum distance, 
+ * where a null threshold is not taken into account. The final function
+ * builds the trips as the linear sequences of a single sequence set.
+ */
+
+static int64
+trip_interval_usecs(Interval *interval)
+{
+	int64 result = interval->time + ((int64) interval->month * DAYS_PER_MONTH +
+		interval->day) * USECS_PER_DAY;
+	if (result < 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The maximum gap must not be negative")));
+	return result;
+}
+
+static TripState *
+trip_state_make(FunctionCallInfo fcinfo, int32 srid, bool hasz)
+{
+	MemoryContext aggctx;
+	if (!AggCheckCallContext(fcinfo, &aggctx))
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+				errmsg("Operation not supported")));
+	int capacity = 64;
+	TripState *result = MemoryContextAllocZero(aggctx,
+		offsetof(TripState, points) + sizeof(TripPoint) * capacity);
+	result->srid = srid;
+	result->hasz = hasz;
+	result->capacity = capacity;
+	result->maxgap = -1;
+	result->maxdist = -1;
+	if (! PG_ARGISNULL(3))
+		result->maxgap = trip_interval_usecs(PG_GETARG_INTERVAL_P(3));
+	if (! PG_ARGISNULL(4))
+	{
+		result->maxdist = PG_GETARG_FLOAT8(4);
+		if (result->maxdist < 0)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				errmsg("The maximum distance must not be negative")));
+	}
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(tpoint_seqset_agg_transfn);
+
+PGDLLEXPORT Datum
+tpoint_seqset_agg_transfn(PG_FUNCTION_ARGS)
+{
+	TripState *state = PG_ARGISNULL(0) ? NULL : 
+		(TripState *) PG_GETARG_POINTER(0);
+	if (PG_ARGISNULL(1) || PG_ARGISNULL(2))
+	{
+		if (state)
+			PG_RETURN_POINTER(state);
+		else
+			PG_RETURN_NULL();
+	}
+	GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
+	TimestampTz t = PG_GETARG_TIMESTAMPTZ(2);
+	ensure_point_type(gs);
+	ensure_non_empty(gs);
+	ensure_has_not_M(gs);
+	int32 srid = gserialized_get_srid(gs);
+	bool hasz = FLAGS_GET_Z(gs->flags) != 0;
+
+	if (state == NULL)
+		state = trip_state_make(fcinfo, srid, hasz);
+	else
+	{
+		if (state->srid != srid)
+			ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+				errmsg("Geometries must have the same SRID for temporal aggregation")));
+		if (state->hasz != hasz)
+			ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+				errmsg("Geometries must have the same dimensionality for temporal aggregation")));
+		if (state->count == state->capacity)
+		{
+			if ((size_t) state->capacity * 2 > (MaxAllocSize -
+					offsetof(TripState, points)) / sizeof(TripPoint))
+				ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+					errmsg("Too many points for trip assembly")));
+			state->capacity *= 2;
+			state = repalloc(state, offsetof(TripState, points) + 
+				sizeof(TripPoint) * state->capacity);
+		}
+	}
+
+	TripPoint *point = &state->points[state->count];
+	point->t = t;
+	if (hasz)
+	{
+		POINT3DZ p = datum_get_point3dz(PointerGetDatum(gs));
+		point->x = p.x;
+		point->y = p.y;
+		point->z = p.z;
+	}
+	else
+	{
+		POINT2D p = datum_get_point2d(PointerGetDatum(gs));
+		point->x = p.x;
+		point->y = p.y;
+		point->z = 0;
+	}
+	point->first = true;
+	if (state->count > 0)
+	{
+		TripPoint *prev = point - 1;
+		if (timestamp_cmp_internal(prev->t, t) >= 0)
+		{
+			char *t1 = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(prev->t));
+			char *t2 = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(t));
+			ereport(ERROR, (errcode(ERRCODE_RESTRICT_VIOLATION), 
+				errmsg("Timestamps for temporal value must be increasing: %s, %s", t1, t2)));
+		}
+		double dx = point->x - prev->x, dy = point->y - prev->y,
+			dz = point->z - prev->z;
+		point->first = (state->maxgap >= 0 && t - prev->t > state->maxgap) ||
+			(state->maxdist >= 0 &&
+				sqrt(dx * dx + dy * dy + dz * dz) > state->maxdist);
+	}
+	state->count++;
+	PG_FREE_IF_COPY(gs, 1);
+	PG_RETURN_POINTER(state);
+}
+
+PG_FUNCTION_INFO_V1(tpoint_seqset_agg_finalfn);
+
+PGDLLEXPORT Datum
+tpoint_seqset_agg_finalfn(PG_FUNCTION_ARGS)
+{
+	/* The final function is strict, we do not need to test for null values */
+	TripState *state = (TripState *) PG_GETARG_POINTER(0);
+	if (state->count == 0)
+		PG_RETURN_NULL();
+
+	int nseqs = 0;
+	for (int i = 0; i < state->count; i++)
+		if (state->points[i].first)
+			nseqs++;
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * nseqs);
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * state->count);
+	int k = 0;
+	int i = 0;
+	while (i < state->count)
+	{
+		int n = 0;
+		do
+		{
+			TripPoint *point = &state->points[i++];
+			instants[n++] = tpointinst_make(point->x, point->y, point->z,
+				state->hasz, false, state->srid, point->t);
+		} while (i < state->count && ! state->points[i].first);
+		sequences[k++] = temporalseq_from_temporalinstarr(instants, n,
+			true, true, true, true);
+		for (int j = 0; j < n; j++)
+			pfree(instants[j]);
+	}
+	TemporalS *result = temporals_from_temporalseqarr(sequences, nseqs,
+		true, true);
+
+	for (int j = 0; j < nseqs; j++)
+		pfree(sequences[j]);
+	pfree(sequences);
+	pfree(instants);
+	PG_RETURN_POINTER(result);
+}
+
 /*****************************************************************************/
@@ -21,6 +21,11 @@
  * 		- stanumbers stores the ND histrogram of occurrence of features.
  * For the time dimension, the statistics collected in Slots 3 and 4 depend on 
  * the duration. Please refer to file temporal_analyze.c for more information.
+ * - Slot 5
+ * 		- stakind contains the type of statistics which is 
+ * 		  STATISTIC_KIND_NUM_INSTANTS_HISTOGRAM.
+ * 		- stavalues stores the histogram of the number of instants.
+ * 		- stanumbers stores the average number of instants.
  * 
  * Portions Copyright (c) 2020, Esteban Zimanyi, Mahmoud Sakr, Mohamed Bakli,
  *		Universite Libre de Bruxelles
@@ -35,6 +40,7 @@
 #include <access/htup_details.h>
 #include <executor/spi.h>
 #include <float.h>
+#include <math.h>
 
 #include "period.h"
 #include "time_analyze.h"
@@ -855,6 +861,7 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	ND_BOX sample_extent;			/* Extent of the raw sample */
 	int   ndims = 2;				/* Dimensionality of the sample */
 	float8 *time_lengths;
+	float8 *num_instants;
 	PeriodBound *time_lowers,
 		   *time_uppers;
 
@@ -876,6 +883,7 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	time_lowers = (PeriodBound *) palloc(sizeof(PeriodBound) * sample_rows);
 	time_uppers = (PeriodBound *) palloc(sizeof(PeriodBound) * sample_rows);
 	time_lengths = (float8 *) palloc(sizeof(float8) * sample_rows);
+	num_instants = (float8 *) palloc(sizeof(float8) * sample_rows);
 
 	/*
 	 * First scan:
@@ -891,11 +899,13 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	{
 		Datum value;
 		Temporal *temp;
+		int numinst;
 		GSERIALIZED *traj;
 		Period period;
 		PeriodBound period_lower,
 				period_upper;
 		GBOX gbox;
+		STBOX box;
 		ND_BOX *nd_box;
 		bool is_null;
 		bool is_copy;
@@ -909,18 +919,84 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 			continue;
 		}
 
-		/* Get temporal point */
-		temp = DatumGetTemporal(value);
+		/* 
+		 * Get the bounding box and the period of out-of-line values from the
+		 * slices of the datum containing them, which avoids detoasting the
+		 * whole value for computing its trajectory
+		 */
+		if (temporal_bbox_slice(value, &box, &period, &numinst))
+		{
+			is_copy = false;
+			traj = NULL;
+
+			/* How many bytes does this sample use? */
+			total_width += VARSIZE_ANY(DatumGetPointer(value));
+
+			/* Check bounds for validity (finite and not NaN) */
+			if (! isfinite(box.xmin) || ! isfinite(box.xmax) || 
+				! isfinite(box.ymin) || ! isfinite(box.ymax) ||
+				(MOBDB_FLAGS_GET_Z(box.flags) && 
+				 (! isfinite(box.zmin) || ! isfinite(box.zmax))))
+				continue;
 
-		/* TO VERIFY */
-		is_copy = VARATT_IS_EXTENDED(temp);
+			/* Convert the box to n-d box, where the z dimension is kept
+			 * only in 3D mode as for the trajectory */
+			nd_box = palloc0(sizeof(ND_BOX));
+			nd_box_init(nd_box);
+			nd_box->min[0] = (float4) box.xmin;
+			nd_box->max[0] = (float4) box.xmax;
+			nd_box->min[1] = (float4) box.ymin;
+			nd_box->max[1] = (float4) box.ymax;
+			if (MOBDB_FLAGS_GET_Z(box.flags))
+			{
+				nd_box->min[2] = (float4) box.zmin;
+				nd_box->max[2] = (float4) box.zmax;
+				ndims = 3;
+			}
+		}
+		else
+		{
+			/* Get temporal point */
+			temp = DatumGetTemporal(value);
+
+			/* TO VERIFY */
+			is_copy = VARATT_IS_EXTENDED(temp);
+
+			/* How many bytes does this sample use? */
+			total_width += VARSIZE(temp);
+
+			/* Get trajectory and period from temporal point */
+			traj = (GSERIALIZED *) DatumGetPointer(tpoint_values_internal(temp));
+			temporal_period(&period, temp);
+			numinst = temporal_stored_instants(temp);
+
+			/* Read the bounds from the trajectory. */
+			if (LW_FAILURE == gserialized_get_gbox_p(traj, &gbox))
+			{
+				/* Skip empties too. */
+				continue;
+			}
+
+			/* Check bounds for validity (finite and not NaN) */
+			if (! gbox_is_valid(&gbox))
+			{
+				continue;
+			}
 
-		/* How many bytes does this sample use? */
-		total_width += VARSIZE(temp);
+			/* If we're in 2D/3D mode, zero out the higher dimensions for "safety" 
+			 * If we're in 3D mode set ndims to 3 */
+			if (! MOBDB_FLAGS_GET_Z(temp->flags))
+				gbox.zmin = gbox.zmax = gbox.mmin = gbox.mmax = 0.0;
+			else
+			{
+				gbox.mmin = gbox.mmax = 0.0;
+				ndims = 3;
+			}
 
-		/* Get trajectory and period from temporal point */
-		traj = (GSERIALIZED *) DatumGetPointer(tpoint_values_internal(temp));
-		temporal_period(&period, temp);
+			/* Convert gbox to n-d box */
+			nd_box = palloc0(sizeof(ND_BOX));
+			nd_box_from_gbox(&gbox, nd_box);
+		}
 
 		/* Remember time bounds and length for further usage in histograms */
 		period_deserialize(&period, &period_lower, &period_upper);
@@ -928,33 +1004,7 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		time_uppers[notnull_cnt] = period_upper;
 		time_lengths[notnull_cnt] = period_to_secs(period_upper.val, 
 			period_lower.val);
-
-		/* Read the bounds from the trajectory. */
-		if (LW_FAILURE == gserialized_get_gbox_p(traj, &gbox))
-		{
-			/* Skip empties too. */
-			continue;
-		}
-
-		/* Check bounds for validity (finite and not NaN) */
-		if (! gbox_is_valid(&gbox))
-		{
-			continue;
-		}
-
-		/* If we're in 2D/3D mode, zero out the higher dimensions for "safety" 
-		 * If we're in 3D mode set ndims to 3 */
-		if (! MOBDB_FLAGS_GET_Z(temp->flags))
-			gbox.zmin = gbox.zmax = gbox.mmin = gbox.mmax = 0.0;
-		else
-		{
-			gbox.mmin = gbox.mmax = 0.0;
-			ndims = 3;
-		}
-
-		/* Convert gbox to n-d box */
-		nd_box = palloc0(sizeof(ND_BOX));
-		nd_box_from_gbox(&gbox, nd_box);
+		num_instants[notnull_cnt] = (float8) numinst;
 
 		/* Cache n-d bounding box */
 		sample_boxes[notnull_cnt] = nd_box;
@@ -979,7 +1029,8 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		/* Free up memory if our sample temporal point was copied */
 		if (is_copy)
 			pfree(temp);
-		pfree(traj);
+		if (traj != NULL)
+			pfree(traj);
 
 		/* Give backend a chance of interrupting us */
 		vacuum_delay_point();
@@ -1007,6 +1058,10 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		/* Compute statistics for time dimension */
 		period_compute_stats1(stats, notnull_cnt, &slot_idx,
 			time_lowers, time_uppers, time_lengths);
+
+		/* Compute statistics for the number of instants */
+		num_instants_compute_stats(stats, notnull_cnt, &slot_idx, 
+			num_instants);
 	}
 	else if (null_cnt > 0)
 	{
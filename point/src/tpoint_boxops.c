@@ -28,6 +28,7 @@
 #include "timestampset.h"
 #include "periodset.h"
 #include "temporaltypes.h"
+#include "temporal_boxops.h"
 #include "temporal_util.h"
 #include "tpoint.h"
 #include "stbox.h"
@@ -68,6 +69,26 @@ geo_to_stbox_internal(STBOX *box, GSERIALIZED *gs)
 	return true;
 }
 
+/*
+ * Get the box of the geometry/geography argument of a function call, which
+ * is computed only once when the argument does not change across the calls
+ * of the expression (see box_cache_fn)
+ */
+bool
+geo_to_stbox_fn(STBOX *box, GSERIALIZED *gs, FunctionCallInfo fcinfo,
+	int argno)
+{
+	BoxCache *cache = box_cache_fn(fcinfo, argno);
+	if (cache != NULL && cache->valid)
+	{
+		memcpy(box, &cache->box.g, sizeof(STBOX));
+		return cache->found;
+	}
+	bool found = geo_to_stbox_internal(box, gs);
+	box_cache_set(cache, box, sizeof(STBOX), found);
+	return found;
+}
+
 PG_FUNCTION_INFO_V1(geo_to_stbox);
 
 PGDLLEXPORT Datum
@@ -420,15 +441,21 @@ tpointseqarr_to_stbox(STBOX *box, TemporalSeq **sequences, int count)
  *****************************************************************************/
 
 void
-tpoint_expand_stbox(STBOX *box, Temporal *temp, TemporalInst *inst)
+tpointinst_expand_stbox(STBOX *box, TemporalInst *inst)
 {
-	temporal_bbox(box, temp);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
 	temporalinst_bbox(&box1, inst);
 	stbox_expand(box, &box1);
 }
 
+void
+tpoint_expand_stbox(STBOX *box, Temporal *temp, TemporalInst *inst)
+{
+	temporal_bbox(box, temp);
+	tpointinst_expand_stbox(box, inst);
+}
+
 /*****************************************************************************
  * Functions for expanding the bounding box
  *****************************************************************************/
@@ -471,13 +498,11 @@ PG_FUNCTION_INFO_V1(tpoint_expand_spatial);
 PGDLLEXPORT Datum
 tpoint_expand_spatial(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	double d = PG_GETARG_FLOAT8(1);
 	STBOX box;
 	memset(&box, 0, sizeof(STBOX));
-	temporal_bbox(&box, temp);
+	temporal_bbox_datum(&box, PG_GETARG_DATUM(0));
 	STBOX *result = stbox_expand_spatial_internal(&box, d);
-	PG_FREE_IF_COPY(temp, 0);	
 	PG_RETURN_POINTER(result);
 }
 
@@ -520,13 +545,11 @@ PG_FUNCTION_INFO_V1(tpoint_expand_temporal);
 PGDLLEXPORT Datum
 tpoint_expand_temporal(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Datum interval = PG_GETARG_DATUM(1);
 	STBOX box;
 	memset(&box, 0, sizeof(STBOX));
-	temporal_bbox(&box, temp);
+	temporal_bbox_datum(&box, PG_GETARG_DATUM(0));
 	STBOX *result = stbox_expand_temporal_internal(&box, interval);
-	PG_FREE_IF_COPY(temp, 0);	
 	PG_RETURN_POINTER(result);
 }
 
@@ -546,7 +569,7 @@ overlaps_bbox_geo_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -565,12 +588,10 @@ PGDLLEXPORT Datum
 overlaps_bbox_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = overlaps_stbox_stbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -589,7 +610,7 @@ overlaps_bbox_tpoint_geo(PG_FUNCTION_ARGS)
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
 	temporal_bbox(&box1, temp);
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -606,13 +627,11 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tpoint_stbox);
 PGDLLEXPORT Datum
 overlaps_bbox_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = overlaps_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -652,7 +671,7 @@ contains_bbox_geo_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -671,12 +690,10 @@ PGDLLEXPORT Datum
 contains_bbox_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = contains_stbox_stbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -694,7 +711,7 @@ contains_bbox_tpoint_geo(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -712,13 +729,11 @@ PG_FUNCTION_INFO_V1(contains_bbox_tpoint_stbox);
 PGDLLEXPORT Datum
 contains_bbox_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = contains_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -758,7 +773,7 @@ contained_bbox_geo_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -777,12 +792,10 @@ PGDLLEXPORT Datum
 contained_bbox_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = contained_stbox_stbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -800,7 +813,7 @@ contained_bbox_tpoint_geo(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -818,13 +831,11 @@ PG_FUNCTION_INFO_V1(contained_bbox_tpoint_stbox);
 PGDLLEXPORT Datum
 contained_bbox_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = contained_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -864,7 +875,7 @@ same_bbox_geo_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -883,12 +894,10 @@ PGDLLEXPORT Datum
 same_bbox_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = same_stbox_stbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -906,7 +915,7 @@ same_bbox_tpoint_geo(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -924,13 +933,11 @@ PG_FUNCTION_INFO_V1(same_bbox_tpoint_stbox);
 PGDLLEXPORT Datum
 same_bbox_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = same_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -0,0 +1,135 @@
+/*****************************************************************************
+ *
+ * tpoint_brin.c
+ *	  BRIN inclusion index for temporal points
+ *
+ * The operator classes below use the generic inclusion functions of
+ * PostgreSQL, which summarize each range of pages with a spatiotemporal box
+ * computed by the function brin_tpoint_add_value. The Z dimension is kept
+ * in the summary only when all values of the range have it, since otherwise
+ * the overlaps operator would not test the values without Z on their common
+ * dimensions with the query.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "tpoint_brin.h"
+
+#include <access/brin_tuple.h>
+#include <utils/datum.h>
+#include <utils/timestamp.h>
+
+#include "temporaltypes.h"
+#include "temporal_brin.h"
+#include "tpoint.h"
+
+/*****************************************************************************
+ * Merge function
+ *****************************************************************************/
+
+/*
+ * Increase the spatiotemporal box to include the second one
+ */
+static void
+stbox_expand_brin(STBOX *box, const STBOX *addon)
+{
+	box->xmin = Min(box->xmin, addon->xmin);
+	box->xmax = Max(box->xmax, addon->xmax);
+	box->ymin = Min(box->ymin, addon->ymin);
+	box->ymax = Max(box->ymax, addon->ymax);
+	box->zmin = Min(box->zmin, addon->zmin);
+	box->zmax = Max(box->zmax, addon->zmax);
+	box->tmin = Min(box->tmin, addon->tmin);
+	box->tmax = Max(box->tmax, addon->tmax);
+	MOBDB_FLAGS_SET_Z(box->flags, MOBDB_FLAGS_GET_Z(box->flags) &&
+		MOBDB_FLAGS_GET_Z(addon->flags));
+}
+
+/*
+ * Returns true if the first spatiotemporal box contains the second one
+ */
+static bool
+stbox_contains_brin(const STBOX *box1, const STBOX *box2)
+{
+	if (MOBDB_FLAGS_GET_Z(box1->flags) && (!MOBDB_FLAGS_GET_Z(box2->flags) ||
+		box2->zmin < box1->zmin || box1->zmax < box2->zmax))
+		return false;
+	return box1->xmin <= box2->xmin && box2->xmax <= box1->xmax &&
+		box1->ymin <= box2->ymin && box2->ymax <= box1->ymax &&
+		box1->tmin <= box2->tmin && box2->tmax <= box1->tmax;
+}
+
+/*
+ * Returns the smallest spatiotemporal box that contains the two boxes
+ */
+
+PG_FUNCTION_INFO_V1(brin_stbox_merge);
+
+PGDLLEXPORT Datum
+brin_stbox_merge(PG_FUNCTION_ARGS)
+{
+	STBOX *box1 = PG_GETARG_STBOX_P(0);
+	STBOX *box2 = PG_GETARG_STBOX_P(1);
+	STBOX *result = palloc(sizeof(STBOX));
+	memcpy(result, box1, sizeof(STBOX));
+	stbox_expand_brin(result, box2);
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Add value function
+ *****************************************************************************/
+
+/*
+ * Enlarges the summary of a range of pages to include the bounding box of
+ * a new temporal point. Returns true if the summary has been modified.
+ */
+
+PG_FUNCTION_INFO_V1(brin_tpoint_add_value);
+
+PGDLLEXPORT Datum
+brin_tpoint_add_value(PG_FUNCTION_ARGS)
+{
+	BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+	Datum newval = PG_GETARG_DATUM(2);
+	bool isnull = PG_GETARG_BOOL(3);
+	Temporal *temp;
+	STBOX box, *union_box;
+
+	/* Record that we saw a null if it is the first one */
+	if (isnull)
+	{
+		if (column->bv_hasnulls)
+			PG_RETURN_BOOL(false);
+		column->bv_hasnulls = true;
+		PG_RETURN_BOOL(true);
+	}
+
+	temp = DatumGetTemporal(newval);
+	memset(&box, 0, sizeof(STBOX));
+	temporal_bbox(&box, temp);
+
+	/* If the summary is empty, store the bounding box */
+	if (column->bv_allnulls)
+	{
+		column->bv_values[INCLUSION_UNION] = datumCopy(PointerGetDatum(&box),
+			false, sizeof(STBOX));
+		column->bv_values[INCLUSION_UNMERGEABLE] = BoolGetDatum(false);
+		column->bv_values[INCLUSION_CONTAINS_EMPTY] = BoolGetDatum(false);
+		column->bv_allnulls = false;
+		PG_RETURN_BOOL(true);
+	}
+
+	/* Otherwise, enlarge the stored box if it does not contain the new one */
+	union_box = DatumGetSTboxP(column->bv_values[INCLUSION_UNION]);
+	if (stbox_contains_brin(union_box, &box))
+		PG_RETURN_BOOL(false);
+	stbox_expand_brin(union_box, &box);
+	PG_RETURN_BOOL(true);
+}
+
+/*****************************************************************************/
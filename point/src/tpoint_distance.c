@@ -12,11 +12,16 @@
 
 #include "tpoint_distance.h"
 
+#include <math.h>
+#include <utils/builtins.h>
+
 #include "temporaltypes.h"
+#include "temporal_stats.h"
 #include "oidcache.h"
 #include "temporal_util.h"
 #include "lifting.h"
 #include "tpoint.h"
+#include "stbox.h"
 #include "tpoint_spatialfuncs.h"
 
 /*****************************************************************************
@@ -37,13 +42,130 @@ geom_distance3d(Datum geom1, Datum geom2)
 	return call_function2(distance3d, geom1, geom2);
 }
 
+/*
+ * Distance between two geography points of the default SRID computed on the
+ * raw longitudes and latitudes, which avoids building the spheroid and the
+ * LWGEOM values of PostGIS for every pair of points. The spheroid is the
+ * WGS 84 one and the distance is computed with the inverse formula of
+ * Vincenty, which only fails to converge for nearly antipodal points, while
+ * the sphere has the mean radius of the spheroid as in PostGIS. The model is
+ * a superuser setting because it changes the result of immutable functions.
+ */
+
+int geodetic_distance = GEODETIC_SPHEROID;
+
+const struct config_enum_entry geodetic_distance_options[] =
+{
+	{"spheroid", GEODETIC_SPHEROID, false},
+	{"sphere", GEODETIC_SPHERE, false},
+	{NULL, 0, false}
+};
+
+#define WGS84_FLATTENING	(1.0 / WGS84_INVERSE_FLATTENING)
+#define WGS84_SECOND_ECCENTRICITY_SQ \
+	((WGS84_MAJOR_AXIS * WGS84_MAJOR_AXIS - WGS84_MINOR_AXIS * WGS84_MINOR_AXIS) / \
+	(WGS84_MINOR_AXIS * WGS84_MINOR_AXIS))
+#define VINCENTY_MAX_ITERATIONS	200
+#define VINCENTY_TOLERANCE		1e-12
+
+static double
+geodetic_sphere_distance(const POINT2D *p1, const POINT2D *p2)
+{
+	double lat1 = p1->y * M_PI / 180.0;
+	double lat2 = p2->y * M_PI / 180.0;
+	double dlon = (p2->x - p1->x) * M_PI / 180.0;
+	double sin_lat1 = sin(lat1), cos_lat1 = cos(lat1);
+	double sin_lat2 = sin(lat2), cos_lat2 = cos(lat2);
+	double a1 = cos_lat2 * sin(dlon);
+	double a2 = cos_lat1 * sin_lat2 - sin_lat1 * cos_lat2 * cos(dlon);
+	double a = sqrt(a1 * a1 + a2 * a2);
+	double b = sin_lat1 * sin_lat2 + cos_lat1 * cos_lat2 * cos(dlon);
+	return atan2(a, b) * WGS84_RADIUS;
+}
+
+static bool
+geodetic_spheroid_distance(const POINT2D *p1, const POINT2D *p2,
+	double *result)
+{
+	double f = WGS84_FLATTENING;
+	double L = (p2->x - p1->x) * M_PI / 180.0;
+	double U1 = atan((1.0 - f) * tan(p1->y * M_PI / 180.0));
+	double U2 = atan((1.0 - f) * tan(p2->y * M_PI / 180.0));
+	double sin_U1 = sin(U1), cos_U1 = cos(U1);
+	double sin_U2 = sin(U2), cos_U2 = cos(U2);
+	double lambda = L, sin_sigma, cos_sigma, sigma, cos_sq_alpha, cos_2sigma_m;
+	int i = 0;
+	while (true)
+	{
+		double sin_lambda = sin(lambda), cos_lambda = cos(lambda);
+		double t1 = cos_U2 * sin_lambda;
+		double t2 = cos_U1 * sin_U2 - sin_U1 * cos_U2 * cos_lambda;
+		sin_sigma = sqrt(t1 * t1 + t2 * t2);
+		/* Coincident points */
+		if (sin_sigma == 0)
+		{
+			*result = 0;
+			return true;
+		}
+		cos_sigma = sin_U1 * sin_U2 + cos_U1 * cos_U2 * cos_lambda;
+		sigma = atan2(sin_sigma, cos_sigma);
+		double sin_alpha = cos_U1 * cos_U2 * sin_lambda / sin_sigma;
+		cos_sq_alpha = 1.0 - sin_alpha * sin_alpha;
+		/* Both points on the equator */
+		cos_2sigma_m = (cos_sq_alpha != 0) ?
+			cos_sigma - 2.0 * sin_U1 * sin_U2 / cos_sq_alpha : 0;
+		double C = f / 16.0 * cos_sq_alpha * (4.0 + f * (4.0 - 3.0 * cos_sq_alpha));
+		double lambda_prev = lambda;
+		lambda = L + (1.0 - C) * f * sin_alpha * (sigma + C * sin_sigma *
+			(cos_2sigma_m + C * cos_sigma * (-1.0 + 2.0 * cos_2sigma_m * cos_2sigma_m)));
+		if (fabs(lambda - lambda_prev) < VINCENTY_TOLERANCE)
+			break;
+		if (++i == VINCENTY_MAX_ITERATIONS)
+			return false;
+	}
+	double u_sq = cos_sq_alpha * WGS84_SECOND_ECCENTRICITY_SQ;
+	double A = 1.0 + u_sq / 16384.0 * (4096.0 + u_sq * (-768.0 + u_sq *
+		(320.0 - 175.0 * u_sq)));
+	double B = u_sq / 1024.0 * (256.0 + u_sq * (-128.0 + u_sq * (74.0 - 47.0 * u_sq)));
+	double delta_sigma = B * sin_sigma * (cos_2sigma_m + B / 4.0 *
+		(cos_sigma * (-1.0 + 2.0 * cos_2sigma_m * cos_2sigma_m) -
+		B / 6.0 * cos_2sigma_m * (-3.0 + 4.0 * sin_sigma * sin_sigma) *
+		(-3.0 + 4.0 * cos_2sigma_m * cos_2sigma_m)));
+	*result = WGS84_MINOR_AXIS * A * (sigma - delta_sigma);
+	return true;
+}
+
+static inline bool
+geog_is_plain_point(GSERIALIZED *gs)
+{
+	return gserialized_get_type(gs) == POINTTYPE &&
+		! FLAGS_GET_BBOX(gs->flags) && gserialized_get_srid(gs) == SRID_DEFAULT &&
+		! gserialized_is_empty(gs);
+}
+
 /* Distance between two geographies */
 
 Datum
 geog_distance(Datum geog1, Datum geog2)
 {
-	return call_function4(geography_distance, geog1, geog2, 
-		Float8GetDatum(0.0), BoolGetDatum(true));
+	GSERIALIZED *gs1 = (GSERIALIZED *) DatumGetPointer(geog1);
+	GSERIALIZED *gs2 = (GSERIALIZED *) DatumGetPointer(geog2);
+	if (geog_is_plain_point(gs1) && geog_is_plain_point(gs2))
+	{
+		POINT2D p1 = datum_get_point2d(geog1);
+		POINT2D p2 = datum_get_point2d(geog2);
+		double result;
+		bool found = true;
+		if (geodetic_distance == GEODETIC_SPHERE)
+			result = geodetic_sphere_distance(&p1, &p2);
+		else
+			found = geodetic_spheroid_distance(&p1, &p2, &result);
+		/* Knock off nanometer differences as PostGIS does */
+		if (found)
+			return Float8GetDatum(round(result * 1e12) / 1e12);
+	}
+	return call_function4(geography_distance, geog1, geog2,
+		Float8GetDatum(0.0), BoolGetDatum(geodetic_distance == GEODETIC_SPHEROID));
 }
 
 /*****************************************************************************/
@@ -381,4 +503,202 @@ distance_tpoint_tpoint(PG_FUNCTION_ARGS)
 }
 
 /*****************************************************************************/
-	
\ No newline at end of file
+	
+/*****************************************************************************
+ * Trajectory similarity
+ * The discrete Frechet distance and the dynamic time warping distance are
+ * computed on the instants of the temporal points regardless of their
+ * timestamps, with a dynamic programming algorithm that keeps a single row
+ * of the matrix of the couplings. When a bound is given, the computation is
+ * abandoned as soon as a lower bound of the distance exceeds it. The lower
+ * bounds are given by the distances between the first and the last instants,
+ * by the distance between the spatial extents of the bounding boxes for
+ * temporal geometry points, and by the minimum of each row of the matrix,
+ * since the values of the couplings never decrease along a row.
+ *****************************************************************************/
+
+typedef double (*point_distance_func)(Datum, Datum);
+
+static double
+point_distance2d(Datum value1, Datum value2)
+{
+	POINT2D p1 = datum_get_point2d(value1);
+	POINT2D p2 = datum_get_point2d(value2);
+	return hypot(p1.x - p2.x, p1.y - p2.y);
+}
+
+static double
+point_distance3d(Datum value1, Datum value2)
+{
+	POINT3DZ p1 = datum_get_point3dz(value1);
+	POINT3DZ p2 = datum_get_point3dz(value2);
+	double dx = p1.x - p2.x, dy = p1.y - p2.y, dz = p1.z - p2.z;
+	return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+static double
+point_distance_geog(Datum value1, Datum value2)
+{
+	return DatumGetFloat8(geog_distance(value1, value2));
+}
+
+/* Values of the instants of a temporal point */
+
+static Datum *
+tpoint_similarity_values(Temporal *temp, int *count)
+{
+	Datum *result = palloc(sizeof(Datum) * temporal_stat_instants(temp));
+	TemporalInstIterator it;
+	TemporalInst *inst;
+	int k = 0;
+	temporalinst_iterator_init(&it, temp);
+	while ((inst = temporalinst_iterator_next(&it)) != NULL)
+		result[k++] = temporalinst_value(inst);
+	*count = k;
+	return result;
+}
+
+/*
+ * Distance between the spatial extents of the bounding boxes of two temporal
+ * geometry points, which is a lower bound of the distance between any point
+ * of the first one and any point of the second one
+ */
+static double
+tpoint_similarity_box_distance(Temporal *temp1, Temporal *temp2)
+{
+	STBOX box1, box2;
+	memset(&box1, 0, sizeof(STBOX));
+	memset(&box2, 0, sizeof(STBOX));
+	temporal_bbox(&box1, temp1);
+	temporal_bbox(&box2, temp2);
+	double dx = Max(0.0, Max(box1.xmin - box2.xmax, box2.xmin - box1.xmax));
+	double dy = Max(0.0, Max(box1.ymin - box2.ymax, box2.ymin - box1.ymax));
+	double dz = 0.0;
+	if (MOBDB_FLAGS_GET_Z(box1.flags))
+		dz = Max(0.0, Max(box1.zmin - box2.zmax, box2.zmin - box1.zmax));
+	return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/*
+ * Discrete Frechet distance (when frechet is true) or dynamic time warping
+ * distance between two temporal points. The function returns infinity when
+ * the distance is known to be greater than the bound.
+ */
+static double
+tpoint_similarity_internal(Temporal *temp1, Temporal *temp2, bool frechet,
+	double bound)
+{
+	point_distance_func func;
+	bool geodetic = temp1->valuetypid == type_oid(T_GEOGRAPHY);
+	if (geodetic)
+		func = &point_distance_geog;
+	else if (MOBDB_FLAGS_GET_Z(temp1->flags))
+		func = &point_distance3d;
+	else
+		func = &point_distance2d;
+
+	int count1, count2;
+	Datum *values1 = tpoint_similarity_values(temp1, &count1);
+	Datum *values2 = tpoint_similarity_values(temp2, &count2);
+	double result = get_float8_infinity();
+
+	/* Lower bounds before filling the matrix */
+	double first = func(values1[0], values2[0]);
+	double last = (count1 == 1 && count2 == 1) ? first :
+		func(values1[count1 - 1], values2[count2 - 1]);
+	double lower = frechet ? Max(first, last) :
+		(count1 == 1 && count2 == 1) ? first : first + last;
+	if (lower <= bound && ! geodetic)
+	{
+		double boxdist = tpoint_similarity_box_distance(temp1, temp2);
+		lower = Max(lower, frechet ? boxdist :
+			boxdist * Max(count1, count2));
+	}
+	if (lower > bound)
+	{
+		pfree(values1); pfree(values2);
+		return result;
+	}
+
+	/* The couplings of the previous row are kept in row and overwritten */
+	double *row = palloc(sizeof(double) * count2);
+	bool abandoned = false;
+	for (int i = 0; i < count1 && ! abandoned; i++)
+	{
+		double diag = 0.0, rowmin = get_float8_infinity();
+		for (int j = 0; j < count2; j++)
+		{
+			double dist = func(values1[i], values2[j]);
+			double prev;
+			if (i == 0 && j == 0)
+				prev = 0.0;
+			else if (i == 0)
+				prev = row[j - 1];
+			else if (j == 0)
+				prev = row[j];
+			else
+				prev = Min(diag, Min(row[j], row[j - 1]));
+			diag = row[j];
+			row[j] = frechet ? Max(dist, prev) : dist + prev;
+			rowmin = Min(rowmin, row[j]);
+		}
+		if (rowmin > bound)
+			abandoned = true;
+	}
+	if (! abandoned && row[count2 - 1] <= bound)
+		result = row[count2 - 1];
+
+	pfree(values1); pfree(values2); pfree(row);
+	return result;
+}
+
+static double
+tpoint_similarity_getargs(FunctionCallInfo fcinfo, bool frechet, double bound)
+{
+	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
+	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
+	ensure_same_srid_tpoint(temp1, temp2);
+	ensure_same_dimensionality_tpoint(temp1, temp2);
+	double result = tpoint_similarity_internal(temp1, temp2, frechet, bound);
+	PG_FREE_IF_COPY(temp1, 0);
+	PG_FREE_IF_COPY(temp2, 1);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(frechet_distance_tpoint_tpoint);
+
+PGDLLEXPORT Datum
+frechet_distance_tpoint_tpoint(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_FLOAT8(tpoint_similarity_getargs(fcinfo, true,
+		get_float8_infinity()));
+}
+
+PG_FUNCTION_INFO_V1(dtw_distance_tpoint_tpoint);
+
+PGDLLEXPORT Datum
+dtw_distance_tpoint_tpoint(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_FLOAT8(tpoint_similarity_getargs(fcinfo, false,
+		get_float8_infinity()));
+}
+
+PG_FUNCTION_INFO_V1(frechet_dwithin_tpoint_tpoint);
+
+PGDLLEXPORT Datum
+frechet_dwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
+{
+	double dist = PG_GETARG_FLOAT8(2);
+	PG_RETURN_BOOL(tpoint_similarity_getargs(fcinfo, true, dist) <= dist);
+}
+
+PG_FUNCTION_INFO_V1(dtw_dwithin_tpoint_tpoint);
+
+PGDLLEXPORT Datum
+dtw_dwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
+{
+	double dist = PG_GETARG_FLOAT8(2);
+	PG_RETURN_BOOL(tpoint_similarity_getargs(fcinfo, false, dist) <= dist);
+}
+
+/*****************************************************************************/
@@ -0,0 +1,368 @@
+/*****************************************************************************
+ *
+ * tpoint_gin.c
+ *	  Multi-entry GIN index for temporal points.
+ *
+ * A single bounding box is a poor approximation of a long trajectory. The
+ * index below splits each temporal point into several boxes, each one
+ * covering consecutive instants, and indexes all of them as the keys of the
+ * value. The maximum number of boxes per value is given by the parameter
+ * mobilitydb.gin_max_boxes.
+ *
+ * GIN keys are kept in a B-tree, and thus the boxes are ordered by a time
+ * level, which is the binary logarithm of their duration in seconds, and
+ * then by their minimum timestamp. Since a box of a level L has a duration
+ * of at most 2^L seconds, the boxes overlapping a query in time are found
+ * for each level in a range that starts 2^L seconds before the query and
+ * ends at the end of the query. The query thus performs one partial match
+ * scan per level, and the spatial dimensions are tested on the keys of the
+ * range by the comparePartial method.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ * 		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "tpoint_gin.h"
+
+#include <access/gin.h>
+#include <utils/array.h>
+#include <utils/builtins.h>
+#include <utils/timestamp.h>
+
+#include "temporaltypes.h"
+#include "oidcache.h"
+#include "temporal_util.h"
+#include "tpoint.h"
+#include "tpoint_boxops.h"
+
+/* Levels of durations up to 2^GIN_MAX_LEVEL seconds, and a last level for
+ * the longer or unbounded ones */
+#define GIN_MAX_LEVEL		40
+#define GIN_NUM_LEVELS		(GIN_MAX_LEVEL + 2)
+
+/**
+ * @brief Value of the mobilitydb.gin_max_boxes parameter which states the
+ *		maximum number of boxes indexed for each temporal point. Changing it
+ *		only affects the values indexed afterwards.
+ */
+int gin_max_boxes = 16;
+
+/* Query of a partial match scan */
+typedef struct
+{
+	int			level;			/* time level of the scan */
+	StrategyNumber strategy;	/* strategy of the query */
+	STBOX		box;			/* bounding box of the query */
+} GinTpointQuery;
+
+/*****************************************************************************
+ * Splitting of a temporal point into boxes
+ *****************************************************************************/
+
+/*
+ * Splits the sequence into count boxes having the same number of segments.
+ * Consecutive boxes share the instant between them. Returns the number of
+ * boxes, which is smaller than count when the sequence has less segments.
+ */
+static int
+tpointseq_split_stboxes(STBOX *result, TemporalSeq *seq, int count)
+{
+	TemporalInst **instants = temporalseq_instants(seq);
+	int segs = seq->count - 1;
+	if (segs == 0)
+	{
+		memset(result, 0, sizeof(STBOX));
+		tpointinstarr_to_stbox(result, instants, 1);
+		pfree(instants);
+		return 1;
+	}
+	if (count > segs)
+		count = segs;
+	for (int i = 0; i < count; i++)
+	{
+		int start = (int) ((int64) i * segs / count);
+		int end = (int) ((int64) (i + 1) * segs / count);
+		memset(&result[i], 0, sizeof(STBOX));
+		tpointinstarr_to_stbox(&result[i], &instants[start], end - start + 1);
+	}
+	pfree(instants);
+	return count;
+}
+
+/*
+ * Splits the temporal point into at most count boxes. Each sequence of a
+ * sequence set is given a number of boxes proportional to its number of
+ * instants, and at least one of them.
+ */
+STBOX *
+tpoint_split_stboxes(Temporal *temp, int count, int *newcount)
+{
+	STBOX *result;
+	if (temp->duration == TEMPORALINST)
+	{
+		TemporalInst *inst = (TemporalInst *) temp;
+		result = palloc0(sizeof(STBOX));
+		tpointinst_make_stbox(result, temporalinst_value(inst), inst->t);
+		*newcount = 1;
+	}
+	else if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *) temp;
+		TemporalInst **instants = temporali_instants(ti);
+		if (count > ti->count)
+			count = ti->count;
+		result = palloc0(sizeof(STBOX) * count);
+		for (int i = 0; i < count; i++)
+		{
+			int start = (int) ((int64) i * ti->count / count);
+			int end = (int) ((int64) (i + 1) * ti->count / count);
+			tpointinstarr_to_stbox(&result[i], &instants[start], end - start);
+		}
+		pfree(instants);
+		*newcount = count;
+	}
+	else if (temp->duration == TEMPORALSEQ)
+	{
+		result = palloc(sizeof(STBOX) * count);
+		*newcount = tpointseq_split_stboxes(result, (TemporalSeq *) temp, count);
+	}
+	else /* temp->duration == TEMPORALS */
+	{
+		TemporalS *ts = (TemporalS *) temp;
+		result = palloc(sizeof(STBOX) * (count + ts->count));
+		int k = 0;
+		for (int i = 0; i < ts->count; i++)
+		{
+			TemporalSeq *seq = temporals_seq_n(ts, i);
+			int seqcount = (int) ((int64) count * seq->count / ts->totalcount);
+			k += tpointseq_split_stboxes(&result[k], seq, Max(seqcount, 1));
+		}
+		*newcount = k;
+	}
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(tpoint_split_stboxes_sql);
+
+PGDLLEXPORT Datum
+tpoint_split_stboxes_sql(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	int count = PG_GETARG_INT32(1);
+	if (count <= 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The number of boxes must be greater than 0")));
+	int newcount;
+	STBOX *boxes = tpoint_split_stboxes(temp, count, &newcount);
+	Datum *values = palloc(sizeof(Datum) * newcount);
+	for (int i = 0; i < newcount; i++)
+		values[i] = PointerGetDatum(&boxes[i]);
+	ArrayType *result = construct_array(values, newcount, type_oid(T_STBOX),
+		sizeof(STBOX), false, 'd');
+	pfree(values); pfree(boxes);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * GIN methods
+ *****************************************************************************/
+
+/*
+ * Time level of a box, that is, the smallest L such that the duration of
+ * the box is at most 2^L seconds
+ */
+static int
+stbox_gin_level(const STBOX *box)
+{
+	if (TIMESTAMP_NOT_FINITE(box->tmin) || TIMESTAMP_NOT_FINITE(box->tmax))
+		return GIN_MAX_LEVEL + 1;
+	int64 duration = box->tmax - box->tmin;
+	for (int level = 0; level <= GIN_MAX_LEVEL; level++)
+	{
+		if (duration <= (USECS_PER_SEC << level))
+			return level;
+	}
+	return GIN_MAX_LEVEL + 1;
+}
+
+/*
+ * Total order of the keys by level, minimum timestamp, and then the other
+ * bounds
+ */
+static int
+stbox_gin_cmp(const STBOX *box1, const STBOX *box2)
+{
+	int level1 = stbox_gin_level(box1), level2 = stbox_gin_level(box2);
+	if (level1 != level2)
+		return level1 < level2 ? -1 : 1;
+	int cmp = timestamp_cmp_internal(box1->tmin, box2->tmin);
+	if (cmp != 0)
+		return cmp;
+	cmp = timestamp_cmp_internal(box1->tmax, box2->tmax);
+	if (cmp == 0)
+		cmp = float8_cmp_internal(box1->xmin, box2->xmin);
+	if (cmp == 0)
+		cmp = float8_cmp_internal(box1->xmax, box2->xmax);
+	if (cmp == 0)
+		cmp = float8_cmp_internal(box1->ymin, box2->ymin);
+	if (cmp == 0)
+		cmp = float8_cmp_internal(box1->ymax, box2->ymax);
+	if (cmp == 0)
+		cmp = float8_cmp_internal(box1->zmin, box2->zmin);
+	if (cmp == 0)
+		cmp = float8_cmp_internal(box1->zmax, box2->zmax);
+	if (cmp == 0 && box1->flags != box2->flags)
+		cmp = box1->flags < box2->flags ? -1 : 1;
+	return cmp;
+}
+
+PG_FUNCTION_INFO_V1(gin_stbox_cmp);
+
+PGDLLEXPORT Datum
+gin_stbox_cmp(PG_FUNCTION_ARGS)
+{
+	STBOX *box1 = PG_GETARG_STBOX_P(0);
+	STBOX *box2 = PG_GETARG_STBOX_P(1);
+	PG_RETURN_INT32(stbox_gin_cmp(box1, box2));
+}
+
+PG_FUNCTION_INFO_V1(gin_tpoint_extract_value);
+
+PGDLLEXPORT Datum
+gin_tpoint_extract_value(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	int32 *nkeys = (int32 *) PG_GETARG_POINTER(1);
+	int count;
+	STBOX *boxes = tpoint_split_stboxes(temp, gin_max_boxes, &count);
+	Datum *keys = palloc(sizeof(Datum) * count);
+	for (int i = 0; i < count; i++)
+		keys[i] = PointerGetDatum(&boxes[i]);
+	*nkeys = count;
+	PG_RETURN_POINTER(keys);
+}
+
+/*
+ * Returns one partial match key per time level. The key of a level L is the
+ * smallest key of the level whose box may overlap the query in time.
+ */
+PG_FUNCTION_INFO_V1(gin_tpoint_extract_query);
+
+PGDLLEXPORT Datum
+gin_tpoint_extract_query(PG_FUNCTION_ARGS)
+{
+	int32 *nkeys = (int32 *) PG_GETARG_POINTER(1);
+	StrategyNumber strategy = PG_GETARG_UINT16(2);
+	bool **pmatch = (bool **) PG_GETARG_POINTER(3);
+	Pointer **extra_data = (Pointer **) PG_GETARG_POINTER(4);
+	STBOX query;
+	memset(&query, 0, sizeof(STBOX));
+	switch (strategy)
+	{
+		case GIN_OVERLAPS_GEOM_STRATEGY:
+		case GIN_CONTAINED_GEOM_STRATEGY:
+			if (!geo_to_stbox_internal(&query, PG_GETARG_GSERIALIZED_P(0)))
+			{
+				/* An empty geometry does not match any value */
+				*nkeys = 0;
+				PG_RETURN_POINTER(NULL);
+			}
+			break;
+		case GIN_OVERLAPS_STBOX_STRATEGY:
+		case GIN_CONTAINED_STBOX_STRATEGY:
+			memcpy(&query, PG_GETARG_STBOX_P(0), sizeof(STBOX));
+			break;
+		case GIN_OVERLAPS_TPOINT_STRATEGY:
+		case GIN_CONTAINED_TPOINT_STRATEGY:
+			temporal_bbox(&query, PG_GETARG_TEMPORAL(0));
+			break;
+		default:
+			elog(ERROR, "unrecognized strategy number: %d", strategy);
+	}
+
+	Datum *keys = palloc(sizeof(Datum) * GIN_NUM_LEVELS);
+	*pmatch = palloc(sizeof(bool) * GIN_NUM_LEVELS);
+	*extra_data = palloc(sizeof(Pointer) * GIN_NUM_LEVELS);
+	for (int level = 0; level < GIN_NUM_LEVELS; level++)
+	{
+		GinTpointQuery *q = palloc(sizeof(GinTpointQuery));
+		q->level = level;
+		q->strategy = strategy;
+		q->box = query;
+		STBOX *key = palloc0(sizeof(STBOX));
+		if (level > GIN_MAX_LEVEL)
+			key->tmin = key->tmax = DT_NOBEGIN;
+		else
+		{
+			TimestampTz length = USECS_PER_SEC << level;
+			/* The boxes of the level starting at or before this instant end
+			 * before the query */
+			if (MOBDB_FLAGS_GET_T(query.flags) && 
+				! TIMESTAMP_NOT_FINITE(query.tmin))
+				key->tmin = query.tmin - length - 1;
+			else
+				key->tmin = DT_NOBEGIN + 1;
+			key->tmax = key->tmin + length;
+		}
+		keys[level] = PointerGetDatum(key);
+		(*pmatch)[level] = true;
+		(*extra_data)[level] = (Pointer) q;
+	}
+	*nkeys = GIN_NUM_LEVELS;
+	PG_RETURN_POINTER(keys);
+}
+
+/*
+ * Compares a key with a partial match key. Returns 0 if the key may
+ * satisfy the query, a negative value if it does not satisfy it and the
+ * scan must continue, and a positive value if the scan must stop.
+ */
+PG_FUNCTION_INFO_V1(gin_tpoint_compare_partial);
+
+PGDLLEXPORT Datum
+gin_tpoint_compare_partial(PG_FUNCTION_ARGS)
+{
+	STBOX *key = PG_GETARG_STBOX_P(1);
+	GinTpointQuery *q = (GinTpointQuery *) PG_GETARG_POINTER(3);
+	if (stbox_gin_level(key) != q->level)
+		PG_RETURN_INT32(1);
+	if (MOBDB_FLAGS_GET_T(q->box.flags) && key->tmin > q->box.tmax)
+		PG_RETURN_INT32(1);
+	bool result;
+	/* Since all the boxes of a value are contained in its bounding box,
+	 * the boxes of a value contained in the query are all contained in it */
+	if (q->strategy == GIN_CONTAINED_GEOM_STRATEGY ||
+		q->strategy == GIN_CONTAINED_STBOX_STRATEGY ||
+		q->strategy == GIN_CONTAINED_TPOINT_STRATEGY)
+		result = contained_stbox_stbox_internal(key, &q->box);
+	else
+		result = overlaps_stbox_stbox_internal(key, &q->box);
+	PG_RETURN_INT32(result ? 0 : -1);
+}
+
+/*
+ * A value may satisfy the query if any of its boxes does. The results are
+ * always rechecked.
+ */
+PG_FUNCTION_INFO_V1(gin_tpoint_consistent);
+
+PGDLLEXPORT Datum
+gin_tpoint_consistent(PG_FUNCTION_ARGS)
+{
+	bool *check = (bool *) PG_GETARG_POINTER(0);
+	int32 nkeys = PG_GETARG_INT32(3);
+	bool *recheck = (bool *) PG_GETARG_POINTER(5);
+	*recheck = true;
+	for (int i = 0; i < nkeys; i++)
+	{
+		if (check[i])
+			PG_RETURN_BOOL(true);
+	}
+	PG_RETURN_BOOL(false);
+}
+
+/*****************************************************************************/
@@ -12,11 +12,17 @@
 
 #include "tpoint_gist.h"
 
+#include <math.h>
 #include <utils/timestamp.h>
 #include <access/gist.h>
 
 #include "temporaltypes.h"
 #include "oidcache.h"
+#include "period.h"
+#include "timeops.h"
+#include "stbox.h"
+#include "temporal_util.h"
+#include "temporal_stats.h"
 #include "tpoint.h"
 #include "tpoint_boxops.h"
 #include "tpoint_posops.h"
@@ -33,6 +39,15 @@
 #define FLOAT8_MAX(a,b)  (FLOAT8_GT(a, b) ? (a) : (b))
 #define FLOAT8_MIN(a,b)  (FLOAT8_LT(a, b) ? (a) : (b))
 
+/**
+ * @brief Value of the mobilitydb.gist_time_weight parameter which states the
+ *		number of units of space equivalent to one second when the extents of
+ *		the boxes along the spatial and temporal dimensions are combined by
+ *		the penalty and picksplit methods. Changing it only affects the
+ *		entries inserted afterwards.
+ */
+double gist_time_weight = 1.0;
+
 /*****************************************************************************
  * Leaf-level consistent method for temporal points using a stbox
  *****************************************************************************/
@@ -235,57 +250,66 @@ index_tpoint_recheck(StrategyNumber strategy)
 	}
 }
 
-PG_FUNCTION_INFO_V1(gist_tpoint_consistent);
-
-PGDLLEXPORT Datum
-gist_tpoint_consistent(PG_FUNCTION_ARGS)
+/*
+ * Transform the query argument of a consistent function into a box 
+ * initializing the dimensions that must not be taken into account by the 
+ * operators to infinity. Returns false if the query is empty.
+ */
+static bool
+gist_tpoint_query(FunctionCallInfo fcinfo, STBOX *query)
 {
-	GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
 	StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
 	Oid subtype = PG_GETARG_OID(3);
-	bool *recheck = (bool *) PG_GETARG_POINTER(4), result;
-	STBOX *key = (STBOX *)DatumGetPointer(entry->key), 
-		query;
-	
-	/* Determine whether the index is lossy depending on the strategy */
-	*recheck = index_tpoint_recheck(strategy);
-	
-	if (key == NULL)
-		PG_RETURN_BOOL(false);
-	
-	/*
-	 * Transform the query into a box initializing the dimensions that must
-	 * not be taken into account by the operators to infinity.
-	 */
 	if (subtype == type_oid(T_GEOMETRY) || subtype == type_oid(T_GEOGRAPHY))
 	{
 		/* Since function gist_tpoint_consistent is strict, query is not NULL */
-		if (!geo_to_stbox_internal(&query, PG_GETARG_GSERIALIZED_P(1)))
-			PG_RETURN_BOOL(false);										  
+		if (!geo_to_stbox_internal(query, PG_GETARG_GSERIALIZED_P(1)))
+			return false;
 	}
 	else if (subtype == type_oid(T_STBOX))
 	{
 		STBOX *box = PG_GETARG_STBOX_P(1);
 		if (box == NULL)
-			PG_RETURN_BOOL(false);
-		memcpy(&query, box, sizeof(STBOX));
+			return false;
+		memcpy(query, box, sizeof(STBOX));
 	}
 	else if (temporal_type_oid(subtype))
 	{
 		Temporal *temp = PG_GETARG_TEMPORAL(1);
 		if (temp == NULL)
-			PG_RETURN_BOOL(false);
-		temporal_bbox(&query, temp);
+			return false;
+		temporal_bbox(query, temp);
 		PG_FREE_IF_COPY(temp, 1);
 	}
 	else
 		elog(ERROR, "unrecognized strategy number: %d", strategy);
+	return true;
+}
+
+PG_FUNCTION_INFO_V1(gist_tpoint_consistent);
+
+PGDLLEXPORT Datum
+gist_tpoint_consistent(PG_FUNCTION_ARGS)
+{
+	GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+	bool *recheck = (bool *) PG_GETARG_POINTER(4), result;
+	STBOX *key = (STBOX *)DatumGetPointer(entry->key), 
+		query;
+	
+	/* Determine whether the index is lossy depending on the strategy */
+	*recheck = index_tpoint_recheck(strategy);
+	
+	if (key == NULL || !gist_tpoint_query(fcinfo, &query))
+		PG_RETURN_BOOL(false);
 	
 	if (GIST_LEAF(entry))
 		result = index_leaf_consistent_stbox(key, &query, strategy);
 	else
 		result = gist_internal_consistent_stbox(key, &query, strategy);
 		
+	MOBDB_STAT_INDEX(STAT_GIST_TPOINT, strategy, GIST_LEAF(entry), result,
+		*recheck);
 	PG_RETURN_BOOL(result);
 }
 
@@ -363,6 +387,29 @@ rt_stbox_union(STBOX *n, const STBOX *a, const STBOX *b)
 	n->tmin = timestamp_cmp_internal(a->tmin, b->tmin) < 0 ? a->tmin : b->tmin;
 }
 
+/*
+ * Extents of a stbox along its dimensions for penalty-calculation purposes,
+ * where the extent along the time dimension is weighted by gist_time_weight.
+ * Returns the number of extents, which only include the dimensions of the
+ * box.
+ */
+static int
+stbox_extents(const STBOX *box, double *extents)
+{
+	int count = 0;
+	if (MOBDB_FLAGS_GET_X(box->flags))
+	{
+		extents[count++] = box->xmax - box->xmin;
+		extents[count++] = box->ymax - box->ymin;
+		if (MOBDB_FLAGS_GET_Z(box->flags))
+			extents[count++] = box->zmax - box->zmin;
+	}
+	if (MOBDB_FLAGS_GET_T(box->flags))
+		extents[count++] = (double) (box->tmax - box->tmin) / USECS_PER_SEC *
+			gist_time_weight;
+	return count;
+}
+
 /*
  * Size of a stbox for penalty-calculation purposes.
  * The result can be +Infinity, but not NaN.
@@ -370,27 +417,47 @@ rt_stbox_union(STBOX *n, const STBOX *a, const STBOX *b)
 static double
 size_stbox(const STBOX *box)
 {
+	double extents[4];
+	int count = stbox_extents(box, extents);
 	/*
 	 * Check for zero-width cases.  Note that we define the size of a zero-
 	 * by-infinity box as zero.  It's important to special-case this somehow,
 	 * as naively multiplying infinity by zero will produce NaN.
 	 *
 	 * The less-than cases should not happen, but if they do, say "zero".
-	 */
-	if (FLOAT8_LE(box->xmax, box->xmin) || FLOAT8_LE(box->ymax, box->ymin) ||
-		FLOAT8_LE(box->zmax, box->zmin) ||
-		timestamp_cmp_internal(box->tmax, box->tmin) <= 0)
-		return 0.0;
-	
-	/*
 	 * We treat NaN as larger than +Infinity, so any distance involving a NaN
-	 * and a non-NaN is infinite.  Note the previous check eliminated the
-	 * possibility that the low fields are NaNs.
+	 * and a non-NaN is infinite.
 	 */
-	if (isnan(box->xmax) || isnan(box->ymax) || isnan(box->zmax))
-		return get_float8_infinity();
-	return (box->xmax - box->xmin) * (box->ymax - box->ymin) * 
-		(box->zmax - box->zmin) * (box->tmax - box->tmin);
+	double result = 1.0;
+	for (int i = 0; i < count; i++)
+	{
+		if (FLOAT8_LE(extents[i], 0.0))
+			return 0.0;
+		if (isnan(extents[i]))
+			return get_float8_infinity();
+		result *= extents[i];
+	}
+	return result;
+}
+
+/*
+ * Margin of a stbox, that is, the sum of its extents, for penalty-calculation
+ * purposes. The result can be +Infinity, but not NaN.
+ */
+static double
+margin_stbox(const STBOX *box)
+{
+	double extents[4];
+	int count = stbox_extents(box, extents);
+	double result = 0.0;
+	for (int i = 0; i < count; i++)
+	{
+		if (isnan(extents[i]))
+			return get_float8_infinity();
+		if (FLOAT8_GT(extents[i], 0.0))
+			result += extents[i];
+	}
+	return result;
 }
 
 /*
@@ -404,12 +471,37 @@ stbox_penalty(const STBOX *original, const STBOX *new)
 	
 	memset(&unionbox, 0, sizeof(STBOX));
 	rt_stbox_union(&unionbox, original, new);
+	unionbox.flags = original->flags;
 	return size_stbox(&unionbox) - size_stbox(original);
 }
 
+/*
+ * Encode a non-negative penalty into a float such that the penalties of a
+ * higher realm are greater than all the penalties of a lower realm. The two
+ * high-order bits of the exponent of the float, which are only needed for
+ * huge values, are replaced by the realm, and the remaining bits are shifted
+ * right, which keeps the order of the penalties within a realm.
+ */
+static float
+pack_penalty(double value, uint32 realm)
+{
+	float f = (float) value;
+	uint32 bits;
+	memcpy(&bits, &f, sizeof(float));
+	bits = (realm << 29) | (bits >> 2);
+	memcpy(&f, &bits, sizeof(float));
+	return f;
+}
+
 /*
  * The GiST Penalty method for boxes (also used for points)
- * As in the R-tree paper, we use change in area as our penalty metric
+ *
+ * As in the R-tree paper, we use the change in volume as our penalty metric.
+ * This change is zero for the boxes that are flat along a dimension, e.g.,
+ * the boxes of instants or of points that do not move, which are frequent in
+ * the leaves. As in the R*-tree, the change in margin then breaks the ties,
+ * so that such boxes are inserted where they enlarge the existing boxes the
+ * least instead of in the first subtree.
  */
 PG_FUNCTION_INFO_V1(gist_tpoint_penalty);
 
@@ -421,8 +513,19 @@ gist_tpoint_penalty(PG_FUNCTION_ARGS)
 	float *result = (float *) PG_GETARG_POINTER(2);
 	STBOX *origstbox = (STBOX *) DatumGetPointer(origentry->key);
 	STBOX *newbox = (STBOX *) DatumGetPointer(newentry->key);
+	STBOX unionbox;
 	
-	*result = (float) stbox_penalty(origstbox, newbox);
+	memset(&unionbox, 0, sizeof(STBOX));
+	rt_stbox_union(&unionbox, origstbox, newbox);
+	unionbox.flags = origstbox->flags;
+	double volume = size_stbox(&unionbox) - size_stbox(origstbox);
+	if (volume > 0.0)
+		*result = pack_penalty(volume, 2);
+	else
+	{
+		double margin = margin_stbox(&unionbox) - margin_stbox(origstbox);
+		*result = (margin > 0.0) ? pack_penalty(margin, 1) : 0.0;
+	}
 	PG_RETURN_POINTER(result);
 }
 
@@ -505,7 +608,8 @@ typedef struct
 typedef struct
 {
 	int			entriesCount;	/* total number of entries being split */
-	STBOX		boundingBox;	/* minimum bounding box across all entries */
+	double		extent[4];		/* width of the minimum bounding box across
+								 * all entries along each axis */
 	
 	/* Information about currently selected split follows */
 	
@@ -530,6 +634,69 @@ typedef struct
 				upper;
 } SplitInterval;
 
+/*
+ * Bounds of the boxes of the entries being split, stored by axis so that
+ * the loops over the entries read contiguous arrays of doubles, which the
+ * compiler can vectorize, instead of dereferencing each key for each axis
+ */
+typedef struct
+{
+	int			count;
+	double	   *lower[4];		/* lower bounds along the x, y, z and t axes */
+	double	   *upper[4];		/* upper bounds along the same axes */
+} SplitBoxes;
+
+static void
+split_boxes_make(SplitBoxes *boxes, GistEntryVector *entryvec, int nentries)
+{
+	boxes->count = nentries;
+	for (int dim = 0; dim < 4; dim++)
+	{
+		boxes->lower[dim] = palloc(sizeof(double) * nentries);
+		boxes->upper[dim] = palloc(sizeof(double) * nentries);
+	}
+	for (int i = 0; i < nentries; i++)
+	{
+		STBOX *box = (STBOX *)DatumGetPointer(
+			entryvec->vector[i + FirstOffsetNumber].key);
+		boxes->lower[0][i] = box->xmin;
+		boxes->upper[0][i] = box->xmax;
+		boxes->lower[1][i] = box->ymin;
+		boxes->upper[1][i] = box->ymax;
+		boxes->lower[2][i] = box->zmin;
+		boxes->upper[2][i] = box->zmax;
+		boxes->lower[3][i] = (double) box->tmin;
+		boxes->upper[3][i] = (double) box->tmax;
+	}
+}
+
+static void
+split_boxes_free(SplitBoxes *boxes)
+{
+	for (int dim = 0; dim < 4; dim++)
+	{
+		pfree(boxes->lower[dim]);
+		pfree(boxes->upper[dim]);
+	}
+}
+
+/* Width of the bounding box of all the entries along an axis */
+
+static double
+split_boxes_extent(const SplitBoxes *boxes, int dim)
+{
+	const double *lower = boxes->lower[dim];
+	const double *upper = boxes->upper[dim];
+	double		min = lower[0],
+				max = upper[0];
+	for (int i = 1; i < boxes->count; i++)
+	{
+		min = Min(min, lower[i]);
+		max = Max(max, upper[i]);
+	}
+	return max - min;
+}
+
 /*
  * Interval comparison function by lower bound of the interval;
  */
@@ -615,16 +782,13 @@ g_stbox_consider_split(ConsiderSplitContext *context, int dimNum,
 		 * overlaps. We switch dimension if find less overlap (non-negative)
 		 * or less range with same overlap.
 		 */
-		if (dimNum == 0)
-			range = context->boundingBox.xmax - context->boundingBox.xmin;
-		else if (dimNum == 1)
-			range = context->boundingBox.ymax - context->boundingBox.ymin;
-		else if (dimNum == 2)
-			range = context->boundingBox.zmax - context->boundingBox.zmin;
-		else
-			range = context->boundingBox.tmax - context->boundingBox.tmin;
+		range = context->extent[dimNum];
 		
 		overlap = (float4) ((leftUpper - rightLower) / range);
+
+		/* The ranges of different axes are compared in the same units */
+		if (dimNum == 3)
+			range = range / USECS_PER_SEC * gist_time_weight;
 		
 		/* If there is no previous selection, select this */
 		if (context->first)
@@ -740,6 +904,7 @@ gist_tpoint_picksplit(PG_FUNCTION_ARGS)
 	bool 		hasz;
 	SplitInterval *intervalsLower,
 				*intervalsUpper;
+	SplitBoxes	boxes;
 	CommonEntry *commonEntries;
 	
 	memset(&context, 0, sizeof(ConsiderSplitContext));
@@ -751,21 +916,18 @@ gist_tpoint_picksplit(PG_FUNCTION_ARGS)
 	intervalsLower = (SplitInterval *) palloc(nentries * sizeof(SplitInterval));
 	intervalsUpper = (SplitInterval *) palloc(nentries * sizeof(SplitInterval));
 	
-	/*
-	 * Calculate the overall minimum bounding box over all the entries.
-	 */
-	for (i = FirstOffsetNumber; i <= maxoff; i = OffsetNumberNext(i))
-	{
-		box = (STBOX *)DatumGetPointer(entryvec->vector[i].key);
-		if (i == FirstOffsetNumber)
-			context.boundingBox = *box;
-		else
-			adjust_stbox(&context.boundingBox, box);
-	}
-
 	/* Determine whether there is a Z dimension */
 	box = (STBOX *)DatumGetPointer(entryvec->vector[FirstOffsetNumber].key);
 	hasz = MOBDB_FLAGS_GET_Z(box->flags);
+
+	/*
+	 * Collect the bounds of the entries by axis and calculate the overall
+	 * minimum bounding box over all the entries.
+	 */
+	split_boxes_make(&boxes, entryvec, nentries);
+	for (dim = 0; dim < 4; dim++)
+		context.extent[dim] = (dim == 2 && !hasz) ? 0.0 :
+			split_boxes_extent(&boxes, dim);
 	
 	/*
 	 * Iterate over axes for optimal split searching.
@@ -783,29 +945,10 @@ gist_tpoint_picksplit(PG_FUNCTION_ARGS)
 			continue;
 		
 		/* Project each entry as an interval on the selected axis. */
-		for (i = FirstOffsetNumber; i <= maxoff; i = OffsetNumberNext(i))
+		for (i1 = 0; i1 < nentries; i1++)
 		{
-			box = (STBOX *)DatumGetPointer(entryvec->vector[i].key);
-			if (dim == 0)
-			{
-				intervalsLower[i - FirstOffsetNumber].lower = box->xmin;
-				intervalsLower[i - FirstOffsetNumber].upper = box->xmax;
-			}
-			else if (dim == 1)
-			{
-				intervalsLower[i - FirstOffsetNumber].lower = box->ymin;
-				intervalsLower[i - FirstOffsetNumber].upper = box->ymax;
-			}
-			else if (dim == 2)
-			{
-				intervalsLower[i - FirstOffsetNumber].lower = box->zmin;
-				intervalsLower[i - FirstOffsetNumber].upper = box->zmax;
-			}
-			else
-			{
-				intervalsLower[i - FirstOffsetNumber].lower = box->tmin;
-				intervalsLower[i - FirstOffsetNumber].upper = box->tmax;
-			}
+			intervalsLower[i1].lower = boxes.lower[dim][i1];
+			intervalsLower[i1].upper = boxes.upper[dim][i1];
 		}
 		
 		/*
@@ -930,6 +1073,7 @@ gist_tpoint_picksplit(PG_FUNCTION_ARGS)
 	 */
 	if (context.first)
 	{
+		split_boxes_free(&boxes);
 		fallafterSplit(entryvec, v);
 		PG_RETURN_POINTER(v);
 	}
@@ -991,26 +1135,8 @@ gist_tpoint_picksplit(PG_FUNCTION_ARGS)
 		 * Get upper and lower bounds along selected axis.
 		 */
 		box = (STBOX *)DatumGetPointer(entryvec->vector[i].key);
-		if (context.dim == 0)
-		{
-			lower = box->xmin;
-			upper = box->xmax;
-		}
-		else if (context.dim == 1)
-		{
-			lower = box->ymin;
-			upper = box->ymax;
-		}
-		else if (context.dim == 2 && hasz)
-		{
-			lower = box->zmin;
-			upper = box->zmax;
-		}
-		else
-		{
-			lower = box->tmin;
-			upper = box->tmax;
-		}
+		lower = boxes.lower[context.dim][i - FirstOffsetNumber];
+		upper = boxes.upper[context.dim][i - FirstOffsetNumber];
 		
 		if (FLOAT8_LE(upper, context.leftUpper))
 		{
@@ -1094,6 +1220,7 @@ gist_tpoint_picksplit(PG_FUNCTION_ARGS)
 		}
 	}
 	
+	split_boxes_free(&boxes);
 	v->spl_ldatum = PointerGetDatum(leftBox);
 	v->spl_rdatum = PointerGetDatum(rightBox);
 	PG_RETURN_POINTER(v);
@@ -1155,4 +1282,268 @@ gist_tpoint_compress(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(entry);
 }
 
+/*****************************************************************************
+ * Distance method for temporal points
+ *****************************************************************************/
+
+/*
+ * Returns the distance between the spatial dimensions of the boxes, which 
+ * is a lower bound of the nearest approach distance between the values they
+ * bound. Boxes whose periods do not intersect are at an infinite distance, 
+ * since the nearest approach distance of two temporal points without common
+ * timestamps is null, and null values are ordered last.
+ */
+static double
+stbox_distance_internal(const STBOX *box1, const STBOX *box2)
+{
+	if (MOBDB_FLAGS_GET_T(box1->flags) && MOBDB_FLAGS_GET_T(box2->flags) &&
+		(box1->tmax < box2->tmin || box2->tmax < box1->tmin))
+		return get_float8_infinity();
+	if (! MOBDB_FLAGS_GET_X(box1->flags) || ! MOBDB_FLAGS_GET_X(box2->flags))
+		return 0.0;
+	double dx = Max(0.0, Max(box1->xmin - box2->xmax, box2->xmin - box1->xmax));
+	double dy = Max(0.0, Max(box1->ymin - box2->ymax, box2->ymin - box1->ymax));
+	double dz = 0.0;
+	if (MOBDB_FLAGS_GET_Z(box1->flags) && MOBDB_FLAGS_GET_Z(box2->flags))
+		dz = Max(0.0, Max(box1->zmin - box2->zmax, box2->zmin - box1->zmax));
+	return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/*
+ * The GiST distance method for the nearest approach distance operator |=|
+ * and for the distance operator <-> between a temporal point and a
+ * timestamp. The distances of the leaf keys are lower bounds and must be
+ * rechecked.
+ */
+PG_FUNCTION_INFO_V1(gist_tpoint_distance);
+
+PGDLLEXPORT Datum
+gist_tpoint_distance(PG_FUNCTION_ARGS)
+{
+	GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+	bool *recheck = (bool *) PG_GETARG_POINTER(4);
+	STBOX *key = (STBOX *)DatumGetPointer(entry->key), 
+		query;
+	
+	if (GIST_LEAF(entry))
+		*recheck = true;
+	
+	if (strategy == RTKNNSearchStrategyNumber)
+	{
+		if (key == NULL || ! MOBDB_FLAGS_GET_T(key->flags))
+			PG_RETURN_FLOAT8(get_float8_infinity());
+		Period p;
+		period_set(&p, key->tmin, key->tmax, true, true);
+		PG_RETURN_FLOAT8(period_timestamp_distance_internal(&p,
+			PG_GETARG_TIMESTAMPTZ(1)));
+	}
+
+	if (key == NULL || !gist_tpoint_query(fcinfo, &query))
+		PG_RETURN_FLOAT8(get_float8_infinity());
+	
+	PG_RETURN_FLOAT8(stbox_distance_internal(key, &query));
+}
+
+/*****************************************************************************
+ * GiST methods for compact keys
+ * The keys of the gist_tgeompoint_compact_ops and gist_tgeogpoint_compact_ops
+ * operator classes are STBOXF values, which store the spatial bounds in 
+ * float4 rounded outwards and the time span in seconds rounded up. The keys
+ * are expanded into STBOX values by the decompress method so that the other
+ * methods are shared with the default operator classes.
+ *****************************************************************************/
+
+static void
+stbox_to_stboxf(STBOXF *result, const STBOX *box)
+{
+	memset(result, 0, sizeof(STBOXF));
+	result->flags = box->flags;
+	if (MOBDB_FLAGS_GET_X(box->flags))
+	{
+		result->xmin = float4_round_down(box->xmin);
+		result->xmax = float4_round_up(box->xmax);
+		result->ymin = float4_round_down(box->ymin);
+		result->ymax = float4_round_up(box->ymax);
+		result->zmin = float4_round_down(box->zmin);
+		result->zmax = float4_round_up(box->zmax);
+	}
+	if (MOBDB_FLAGS_GET_T(box->flags))
+	{
+		result->tmin = box->tmin;
+		result->tspan = timestamp_span_seconds(box->tmin, box->tmax);
+	}
+}
+
+static void
+stboxf_to_stbox(STBOX *result, const STBOXF *box)
+{
+	memset(result, 0, sizeof(STBOX));
+	result->flags = box->flags;
+	result->xmin = box->xmin;
+	result->xmax = box->xmax;
+	result->ymin = box->ymin;
+	result->ymax = box->ymax;
+	result->zmin = box->zmin;
+	result->zmax = box->zmax;
+	if (MOBDB_FLAGS_GET_T(box->flags))
+	{
+		result->tmin = box->tmin;
+		result->tmax = timestamp_span_upper(box->tmin, box->tspan);
+	}
+}
+
+/*
+ * Although stboxf is an internal type, the output function is implemented 
+ * for debugging purposes.
+ */
+PG_FUNCTION_INFO_V1(stboxf_in);
+
+PGDLLEXPORT Datum
+stboxf_in(PG_FUNCTION_ARGS)
+{
+	ereport(ERROR,(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+		errmsg("function stboxf_in not implemented")));
+	PG_RETURN_POINTER(NULL);
+}
+
+PG_FUNCTION_INFO_V1(stboxf_out);
+
+PGDLLEXPORT Datum
+stboxf_out(PG_FUNCTION_ARGS)
+{
+	STBOXF *key = (STBOXF *) PG_GETARG_POINTER(0);
+	STBOX box;
+	stboxf_to_stbox(&box, key);
+	return DirectFunctionCall1(stbox_out, PointerGetDatum(&box));
+}
+
+/*
+ * Since the keys are larger than the original boxes, the tests on the leaf 
+ * pages are those of the internal pages and all results must be rechecked
+ */
+PG_FUNCTION_INFO_V1(gist_tpoint_compact_consistent);
+
+PGDLLEXPORT Datum
+gist_tpoint_compact_consistent(PG_FUNCTION_ARGS)
+{
+	GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+	bool *recheck = (bool *) PG_GETARG_POINTER(4);
+	STBOX *key = (STBOX *)DatumGetPointer(entry->key), 
+		query;
+	
+	*recheck = true;
+	
+	if (key == NULL || !gist_tpoint_query(fcinfo, &query))
+		PG_RETURN_BOOL(false);
+	
+	PG_RETURN_BOOL(gist_internal_consistent_stbox(key, &query, strategy));
+}
+
+/*
+ * Both the leaf keys and the union keys computed by the other methods are
+ * compressed
+ */
+PG_FUNCTION_INFO_V1(gist_tpoint_compact_compress);
+
+PGDLLEXPORT Datum
+gist_tpoint_compact_compress(PG_FUNCTION_ARGS)
+{
+	GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+	STBOXF *key = palloc(sizeof(STBOXF));
+	if (entry->leafkey)
+	{
+		Temporal *temp = DatumGetTemporal(entry->key);
+		STBOX box;
+		memset(&box, 0, sizeof(STBOX));
+		temporal_bbox(&box, temp);
+		stbox_to_stboxf(key, &box);
+	}
+	else
+		stbox_to_stboxf(key, (STBOX *) DatumGetPointer(entry->key));
+	gistentryinit(*retval, PointerGetDatum(key), entry->rel, entry->page, 
+		entry->offset, false);
+	PG_RETURN_POINTER(retval);
+}
+
+PG_FUNCTION_INFO_V1(gist_tpoint_compact_decompress);
+
+PGDLLEXPORT Datum
+gist_tpoint_compact_decompress(PG_FUNCTION_ARGS)
+{
+	GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+	STBOX *box = palloc(sizeof(STBOX));
+	stboxf_to_stbox(box, (STBOXF *) DatumGetPointer(entry->key));
+	gistentryinit(*retval, PointerGetDatum(box), entry->rel, entry->page, 
+		entry->offset, false);
+	PG_RETURN_POINTER(retval);
+}
+
+/*****************************************************************************
+ * Sort key for building GiST indexes
+ * PostgreSQL 11 cannot build GiST indexes from sorted input. Sorting the 
+ * table on the key below before building the index, e.g., with
+ *   CREATE TABLE sorted AS SELECT * FROM tbl 
+ *   ORDER BY zorder(temp, estimatedSTBox('tbl', 'temp'));
+ * makes consecutive insertions fall into the same pages, which reduces the
+ * time of the build and the overlap of the resulting pages.
+ *****************************************************************************/
+
+/*
+ * Returns the position of the center of the box on a Z-order curve over 
+ * the x, y, and time dimensions of the extent. The z dimension is not 
+ * taken into account since the 63 bits of the key would leave too few 
+ * bits for each dimension.
+ */
+static int64
+stbox_zorder_internal(const STBOX *box, const STBOX *extent)
+{
+	double values[3], mins[3], maxs[3];
+	int ndims = 0;
+	if (MOBDB_FLAGS_GET_X(box->flags) && MOBDB_FLAGS_GET_X(extent->flags))
+	{
+		values[ndims] = box->xmin / 2 + box->xmax / 2;
+		mins[ndims] = extent->xmin;
+		maxs[ndims++] = extent->xmax;
+		values[ndims] = box->ymin / 2 + box->ymax / 2;
+		mins[ndims] = extent->ymin;
+		maxs[ndims++] = extent->ymax;
+	}
+	if (MOBDB_FLAGS_GET_T(box->flags) && MOBDB_FLAGS_GET_T(extent->flags))
+	{
+		values[ndims] = (double) box->tmin / 2 + (double) box->tmax / 2;
+		mins[ndims] = (double) extent->tmin;
+		maxs[ndims++] = (double) extent->tmax;
+	}
+	return zorder_key(values, mins, maxs, ndims);
+}
+
+PG_FUNCTION_INFO_V1(stbox_zorder);
+
+PGDLLEXPORT Datum
+stbox_zorder(PG_FUNCTION_ARGS)
+{
+	STBOX *box = PG_GETARG_STBOX_P(0);
+	STBOX *extent = PG_GETARG_STBOX_P(1);
+	PG_RETURN_INT64(stbox_zorder_internal(box, extent));
+}
+
+PG_FUNCTION_INFO_V1(tpoint_zorder);
+
+PGDLLEXPORT Datum
+tpoint_zorder(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	STBOX *extent = PG_GETARG_STBOX_P(1);
+	STBOX box;
+	memset(&box, 0, sizeof(STBOX));
+	temporal_bbox(&box, temp);
+	int64 result = stbox_zorder_internal(&box, extent);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_INT64(result);
+}
+
 /*****************************************************************************/
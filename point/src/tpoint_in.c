@@ -13,362 +13,610 @@
 #include "tpoint_in.h"
 
 #include <float.h>
-#include <json-c/json.h>
+#include <lib/stringinfo.h>
+#include <utils/builtins.h>
 
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_parser.h"
 #include "postgis.h"
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
 
 /*****************************************************************************
  * Input in MFJSON format 
+ *
+ * The MF-JSON string is parsed in a single pass, without building a JSON
+ * tree. The members of the objects are handled as they are read, in any 
+ * order, and the coordinates and the timestamps are directly accumulated 
+ * in growable arrays. Unknown members, such as "stBoundedBy", are skipped.
  *****************************************************************************/
 
-/* 
- * We don't include <utils/builtins.h> to avoid collisions with json-c/json.h 
- *
- * This function is taken from PostGIS file lwgeom_in_geojson.c
- */
-static char*
-text2cstring(const text *textptr)
+/* Kind of the value of the 'coordinates' and 'datetimes' members */
+#define MFJSON_NONE		0
+#define MFJSON_SINGLE	1
+#define MFJSON_ARRAY	2
+
+/* Coordinates, timestamps, and bounds read for an instant or a sequence */
+typedef struct
+{
+	int coordkind;
+	int timekind;
+	int npoints;
+	int ntimes;
+	int maxpoints;
+	int maxtimes;
+	POINT3DZ *points;
+	bool *hasz;
+	TimestampTz *times;
+	bool haslower;
+	bool hasupper;
+	bool lower_inc;
+	bool upper_inc;
+} MFJSONSeq;
+
+/* State of the parser */
+typedef struct
+{
+	char *cur;				/* Current position in the string */
+	char *type;				/* Value of the 'type' member */
+	bool hasinterp;			/* Is there an 'interpolations' member? */
+	int ninterp;			/* Number of interpolations */
+	char *interp;			/* First interpolation */
+	bool hascrs;			/* Is there a 'crs.type' member? */
+	char *srs;				/* Value of the 'crs.properties.name' member */
+	MFJSONSeq main;			/* Members of the top-level object */
+	bool hasseqs;			/* Is there a 'sequences' member? */
+	int nseqs;
+	int maxseqs;
+	MFJSONSeq *seqs;
+} MFJSONParser;
+
+static void
+mfjson_error(void)
 {
-	size_t size = VARSIZE_ANY_EXHDR(textptr);
-	char *str = palloc(size + 1);
-	memcpy(str, VARDATA(textptr), size);
-	str[size]='\0';
-	return str;
+	ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+		errmsg("Error while processing MFJSON string")));
 }
 
-/* Function taken from PostGIS file lwin_geojson.c */
+static void
+mfjson_ws(MFJSONParser *p)
+{
+	while (*p->cur == ' ' || *p->cur == '\t' || *p->cur == '\n' || 
+		*p->cur == '\r')
+		p->cur++;
+}
+
+static char
+mfjson_peek(MFJSONParser *p)
+{
+	mfjson_ws(p);
+	return *p->cur;
+}
 
-static json_object *
-findMemberByName(json_object *poObj, const char *pszName )
+static bool
+mfjson_char(MFJSONParser *p, char c)
 {
-	json_object *poTmp = poObj;
-	json_object_iter it;
+	if (mfjson_peek(p) != c)
+		return false;
+	p->cur++;
+	return true;
+}
 
-	if (pszName == NULL || poObj == NULL)
-		return NULL;
+static void
+mfjson_expect(MFJSONParser *p, char c)
+{
+	if (! mfjson_char(p, c))
+		mfjson_error();
+}
 
-	it.key = NULL;
-	it.val = NULL;
-	it.entry = NULL;
+/* Parse a string, which is returned without the quotes and unescaped */
 
-	if (json_object_get_object(poTmp) != NULL)
+static char *
+mfjson_string(MFJSONParser *p)
+{
+	mfjson_expect(p, '"');
+	StringInfoData buf;
+	initStringInfo(&buf);
+	while (*p->cur != '"')
 	{
-		if (json_object_get_object(poTmp)->head == NULL)
+		char c = *p->cur++;
+		if (c == '\0')
+			mfjson_error();
+		if (c != '\\')
 		{
-			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-				errmsg("Invalid MFJSON string")));
-			return NULL;
+			appendStringInfoChar(&buf, c);
+			continue;
 		}
-		for (it.entry = json_object_get_object(poTmp)->head;
-				( it.entry ?
-				  ( it.key = (char*)it.entry->k,
-					it.val = (json_object*)it.entry->v, it.entry) : 0);
-				it.entry = it.entry->next)
+		c = *p->cur++;
+		if (c == 'b') appendStringInfoChar(&buf, '\b');
+		else if (c == 'f') appendStringInfoChar(&buf, '\f');
+		else if (c == 'n') appendStringInfoChar(&buf, '\n');
+		else if (c == 'r') appendStringInfoChar(&buf, '\r');
+		else if (c == 't') appendStringInfoChar(&buf, '\t');
+		else if (c == '"' || c == '\\' || c == '/') 
+			appendStringInfoChar(&buf, c);
+		else if (c == 'u')
 		{
-			if (strcasecmp(it.key, pszName) == 0)
-				return it.val;
+			unsigned int code = 0;
+			for (int i = 0; i < 4; i++)
+			{
+				c = *p->cur++;
+				code <<= 4;
+				if (c >= '0' && c <= '9') code |= c - '0';
+				else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+				else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+				else mfjson_error();
+			}
+			/* Encode the code point in UTF-8 */
+			if (code < 0x80)
+				appendStringInfoChar(&buf, (char) code);
+			else if (code < 0x800)
+			{
+				appendStringInfoChar(&buf, (char) (0xC0 | (code >> 6)));
+				appendStringInfoChar(&buf, (char) (0x80 | (code & 0x3F)));
+			}
+			else
+			{
+				appendStringInfoChar(&buf, (char) (0xE0 | (code >> 12)));
+				appendStringInfoChar(&buf, (char) (0x80 | ((code >> 6) & 0x3F)));
+				appendStringInfoChar(&buf, (char) (0x80 | (code & 0x3F)));
+			}
 		}
+		else
+			mfjson_error();
 	}
-	return NULL;
+	p->cur++;
+	return buf.data;
 }
 
-static Datum
-parse_mfjson_coord(json_object *poObj)
+/* 
+ * Advance to the next member of an object whose opening brace has been 
+ * consumed, returning false at the closing brace 
+ */
+static bool
+mfjson_member(MFJSONParser *p, bool first, char **key)
 {
-	if (json_type_array != json_object_get_type(poObj))
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid coordinate array in MFJSON string")));
+	if (mfjson_char(p, '}'))
+		return false;
+	if (! first)
+		mfjson_expect(p, ',');
+	*key = mfjson_string(p);
+	mfjson_expect(p, ':');
+	return true;
+}
 
-	const int numcoord = json_object_array_length(poObj);
-	if (numcoord < 2)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Too few coordinates in MFJSON string")));
-	else if (numcoord > 3)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Too many coordinates in MFJSON string")));
+/* 
+ * Advance to the next element of an array whose opening bracket has been 
+ * consumed, returning false at the closing bracket
+ */
+static bool
+mfjson_element(MFJSONParser *p, bool first)
+{
+	if (mfjson_char(p, ']'))
+		return false;
+	if (! first)
+		mfjson_expect(p, ',');
+	return true;
+}
 
-	double x, y, z;
-	Datum result;
-	json_object *poObjCoord = NULL;
+static bool
+mfjson_number(MFJSONParser *p, double *result)
+{
+	char c = mfjson_peek(p);
+	if (c != '-' && (c < '0' || c > '9'))
+		return false;
+	/* Do not accept the extensions of strtod such as Infinity */
+	char *end = p->cur;
+	while ((*end >= '0' && *end <= '9') || *end == '.' || *end == '-' || 
+			*end == '+' || *end == 'e' || *end == 'E')
+		end++;
+	char *end1;
+	*result = strtod(p->cur, &end1);
+	if (end1 != end)
+		return false;
+	p->cur = end;
+	return true;
+}
 
-	/* Read X coordinate */
-	poObjCoord = json_object_array_get_idx(poObj, 0);
-	x = json_object_get_double(poObjCoord);
+static bool
+mfjson_bool(MFJSONParser *p, bool *result)
+{
+	mfjson_ws(p);
+	if (strncmp(p->cur, "true", 4) == 0)
+	{
+		p->cur += 4;
+		*result = true;
+		return true;
+	}
+	if (strncmp(p->cur, "false", 5) == 0)
+	{
+		p->cur += 5;
+		*result = false;
+		return true;
+	}
+	return false;
+}
 
-	/* Read Y coordinate */
-	poObjCoord = json_object_array_get_idx(poObj, 1);
-	y = json_object_get_double(poObjCoord);
+/* Skip a value of any type */
 
-	if (numcoord == 3)
+static void
+mfjson_skip(MFJSONParser *p)
+{
+	char c = mfjson_peek(p);
+	char *key;
+	double d;
+	if (c == '"')
+		pfree(mfjson_string(p));
+	else if (c == '{')
 	{
-		/* Read Z coordinate */
-		poObjCoord = json_object_array_get_idx(poObj, 2);
-		z = json_object_get_double(poObjCoord);
-		result = call_function3(LWGEOM_makepoint, Float8GetDatum(x),
-			Float8GetDatum(y), Float8GetDatum(z));
+		p->cur++;
+		for (bool first = true; mfjson_member(p, first, &key); first = false)
+		{
+			pfree(key);
+			mfjson_skip(p);
+		}
 	}
-	else 
-		result = call_function2(LWGEOM_makepoint, Float8GetDatum(x),
-			Float8GetDatum(y));
-	return result;
+	else if (c == '[')
+	{
+		p->cur++;
+		for (bool first = true; mfjson_element(p, first); first = false)
+			mfjson_skip(p);
+	}
+	else if (strncmp(p->cur, "true", 4) == 0 || strncmp(p->cur, "null", 4) == 0)
+		p->cur += 4;
+	else if (strncmp(p->cur, "false", 5) == 0)
+		p->cur += 5;
+	else if (! mfjson_number(p, &d))
+		mfjson_error();
 }
 
-/* TODO MAKE POSSIBLE TO CALL THIS FUNCTION */
-static Datum *
-parse_mfjson_points(json_object *mfjson, int *count)
+/* Parse a coordinate array whose opening bracket has been consumed */
+
+static void
+mfjson_coord(MFJSONParser *p, MFJSONSeq *seq)
 {
-	json_object *mfjsonTmp = mfjson;
-	json_object *coordinates = NULL;
-	coordinates = findMemberByName(mfjsonTmp, "coordinates");
-	if (coordinates == NULL)
+	double coords[3];
+	int numcoord = 0;
+	for (bool first = true; mfjson_element(p, first); first = false)
+	{
+		double d;
+		if (! mfjson_number(p, &d))
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("Invalid coordinate array in MFJSON string")));
+		if (numcoord == 3)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("Too many coordinates in MFJSON string")));
+		coords[numcoord++] = d;
+	}
+	if (numcoord < 2)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Unable to find 'coordinates' in MFJSON string")));
-	if (json_object_get_type(coordinates) != json_type_array)
+			errmsg("Too few coordinates in MFJSON string")));
+	if (seq->npoints == seq->maxpoints)
+	{
+		seq->maxpoints *= 2;
+		seq->points = repalloc(seq->points, sizeof(POINT3DZ) * seq->maxpoints);
+		seq->hasz = repalloc(seq->hasz, sizeof(bool) * seq->maxpoints);
+	}
+	seq->points[seq->npoints].x = coords[0];
+	seq->points[seq->npoints].y = coords[1];
+	seq->points[seq->npoints].z = (numcoord == 3) ? coords[2] : 0;
+	seq->hasz[seq->npoints++] = (numcoord == 3);
+}
+
+static void
+mfjson_coordinates(MFJSONParser *p, MFJSONSeq *seq)
+{
+	if (! mfjson_char(p, '['))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Invalid 'coordinates' array in MFJSON string")));
+	seq->npoints = 0;
+	if (mfjson_peek(p) != '[')
+	{
+		/* Single coordinate array of an instant */
+		seq->coordkind = MFJSON_SINGLE;
+		mfjson_coord(p, seq);
+		return;
+	}
+	seq->coordkind = MFJSON_ARRAY;
+	for (bool first = true; mfjson_element(p, first); first = false)
+	{
+		if (! mfjson_char(p, '['))
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("Invalid coordinate array in MFJSON string")));
+		mfjson_coord(p, seq);
+	}
+}
 
-	int numpoints = json_object_array_length(coordinates);
-	if (numpoints < 1)
+static void
+mfjson_datetime(MFJSONParser *p, MFJSONSeq *seq)
+{
+	if (mfjson_peek(p) != '"')
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid value of 'coordinates' array in MFJSON string")));
-	
-	Datum *values = palloc(sizeof(Datum) * numpoints);
-	for (int i = 0; i < numpoints; ++i)
+			errmsg("Invalid 'datetimes' value in MFJSON string")));
+	char *str = mfjson_string(p);
+	char *ptr = str;
+	if (seq->ntimes == seq->maxtimes)
+	{
+		seq->maxtimes *= 2;
+		seq->times = repalloc(seq->times, sizeof(TimestampTz) * seq->maxtimes);
+	}
+	seq->times[seq->ntimes++] = timestamp_parse(&ptr);
+	pfree(str);
+}
+
+static void
+mfjson_datetimes(MFJSONParser *p, MFJSONSeq *seq)
+{
+	seq->ntimes = 0;
+	if (! mfjson_char(p, '['))
 	{
-		json_object *coords = NULL;
-		coords = json_object_array_get_idx(coordinates, i);
-		values[i] = parse_mfjson_coord(coords);
+		seq->timekind = MFJSON_SINGLE;
+		mfjson_datetime(p, seq);
+		return;
 	}
-	*count = numpoints;
-	return values;
+	seq->timekind = MFJSON_ARRAY;
+	for (bool first = true; mfjson_element(p, first); first = false)
+		mfjson_datetime(p, seq);
 }
-/* */
 
-static TimestampTz *
-parse_mfjson_datetimes(json_object *mfjson, int *count)
+static void
+mfjson_seq_init(MFJSONSeq *seq)
 {
-	json_object *datetimes = NULL;
-	datetimes = findMemberByName(mfjson, "datetimes");
-	if (datetimes == NULL)
+	memset(seq, 0, sizeof(MFJSONSeq));
+	seq->maxpoints = seq->maxtimes = 64;
+	seq->points = palloc(sizeof(POINT3DZ) * seq->maxpoints);
+	seq->hasz = palloc(sizeof(bool) * seq->maxpoints);
+	seq->times = palloc(sizeof(TimestampTz) * seq->maxtimes);
+}
+
+/* 
+ * Handle a member of an instant or a sequence, returning false if the 
+ * member is not one of them
+ */
+static bool
+mfjson_seq_member(MFJSONParser *p, MFJSONSeq *seq, const char *key)
+{
+	if (strcasecmp(key, "coordinates") == 0)
+		mfjson_coordinates(p, seq);
+	else if (strcasecmp(key, "datetimes") == 0)
+		mfjson_datetimes(p, seq);
+	else if (strcasecmp(key, "lower_inc") == 0)
+	{
+		if (! mfjson_bool(p, &seq->lower_inc))
 			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-				errmsg("Unable to find 'datetimes' in MFJSON string")));
-	if (json_object_get_type(datetimes) != json_type_array)
+				errmsg("Invalid 'lower_inc' value in MFJSON string")));
+		seq->haslower = true;
+	}
+	else if (strcasecmp(key, "upper_inc") == 0)
+	{
+		if (! mfjson_bool(p, &seq->upper_inc))
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("Invalid 'upper_inc' value in MFJSON string")));
+		seq->hasupper = true;
+	}
+	else
+		return false;
+	return true;
+}
+
+static void
+mfjson_sequences(MFJSONParser *p)
+{
+	if (! mfjson_char(p, '['))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid 'datetimes' array in MFJSON string")));
+			errmsg("Invalid 'sequences' array in MFJSON string")));
+	p->hasseqs = true;
+	p->nseqs = 0;
+	for (bool first = true; mfjson_element(p, first); first = false)
+	{
+		if (p->nseqs == p->maxseqs)
+		{
+			p->maxseqs = p->maxseqs ? p->maxseqs * 2 : 16;
+			p->seqs = p->seqs ? 
+				repalloc(p->seqs, sizeof(MFJSONSeq) * p->maxseqs) :
+				palloc(sizeof(MFJSONSeq) * p->maxseqs);
+		}
+		MFJSONSeq *seq = &p->seqs[p->nseqs++];
+		mfjson_seq_init(seq);
+		mfjson_expect(p, '{');
+		char *key;
+		for (bool first1 = true; mfjson_member(p, first1, &key); first1 = false)
+		{
+			if (! mfjson_seq_member(p, seq, key))
+				mfjson_skip(p);
+			pfree(key);
+		}
+	}
+}
 
-	int numdates = json_object_array_length(datetimes);
-	if (numdates < 1)
+static void
+mfjson_interpolations(MFJSONParser *p)
+{
+	p->hasinterp = true;
+	if (! mfjson_char(p, '['))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid value of 'datetimes' array in MFJSON string")));
-	
-	TimestampTz *times = palloc(sizeof(TimestampTz) * numdates);
-	for (int i = 0; i < numdates; i++)
+			errmsg("Invalid 'interpolations' value in MFJSON string")));
+	p->ninterp = 0;
+	for (bool first = true; mfjson_element(p, first); first = false)
+	{
+		if (mfjson_peek(p) != '"')
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("Invalid 'interpolations' value in MFJSON string")));
+		char *interp = mfjson_string(p);
+		if (p->ninterp++ == 0)
+			p->interp = interp;
+		else
+			pfree(interp);
+	}
+}
+
+static void
+mfjson_crs(MFJSONParser *p)
+{
+	char *key, *key1;
+	mfjson_expect(p, '{');
+	for (bool first = true; mfjson_member(p, first, &key); first = false)
+	{
+		if (strcasecmp(key, "type") == 0)
+		{
+			p->hascrs = true;
+			mfjson_skip(p);
+		}
+		else if (strcasecmp(key, "properties") == 0 && mfjson_char(p, '{'))
+		{
+			for (bool first1 = true; mfjson_member(p, first1, &key1); first1 = false)
+			{
+				if (strcasecmp(key1, "name") == 0 && mfjson_peek(p) == '"')
+					p->srs = mfjson_string(p);
+				else
+					mfjson_skip(p);
+				pfree(key1);
+			}
+		}
+		else
+			mfjson_skip(p);
+		pfree(key);
+	}
+}
+
+/* Parse the top-level object of the MF-JSON string */
+
+static void
+mfjson_parse(MFJSONParser *p)
+{
+	char *key;
+	mfjson_expect(p, '{');
+	for (bool first = true; mfjson_member(p, first, &key); first = false)
 	{
-		char datetime[33];
-		json_object* datevalue = NULL;
-		datevalue = json_object_array_get_idx(datetimes, i);
-		const char *strdatevalue = json_object_get_string(datevalue);
-		if (strdatevalue)
+		if (strcasecmp(key, "type") == 0)
 		{
-			strcpy(datetime, strdatevalue);
-			/* Replace 'T' by ' ' before converting to timestamptz */
-			datetime[10] = ' ';
-			times[i] = call_input(TIMESTAMPTZOID, datetime);
+			if (mfjson_peek(p) != '"')
+				ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+					errmsg("Invalid 'type' value in MFJSON string")));
+			p->type = mfjson_string(p);
 		}
+		else if (strcasecmp(key, "interpolations") == 0)
+			mfjson_interpolations(p);
+		else if (strcasecmp(key, "sequences") == 0)
+			mfjson_sequences(p);
+		else if (strcasecmp(key, "crs") == 0)
+			mfjson_crs(p);
+		else if (! mfjson_seq_member(p, &p->main, key))
+			mfjson_skip(p);
+		pfree(key);
 	}
-	*count = numdates;
-	return times;
+	if (mfjson_peek(p) != '\0')
+		mfjson_error();
 }
 
 /*****************************************************************************/
 
 static TemporalInst *
-tpointinst_from_mfjson(json_object *mfjson)
+mfjson_instant(MFJSONSeq *seq, int i)
 {
-	/* Get coordinates */
-	json_object *coordinates = findMemberByName(mfjson, "coordinates");
-	if (coordinates == NULL)
+	POINT3DZ *point = &seq->points[i];
+	LWPOINT *lwpoint = seq->hasz[i] ? 
+		lwpoint_make3dz(SRID_UNKNOWN, point->x, point->y, point->z) :
+		lwpoint_make2d(SRID_UNKNOWN, point->x, point->y);
+	GSERIALIZED *gs = geometry_serialize((LWGEOM *) lwpoint);
+	TemporalInst *result = temporalinst_make(PointerGetDatum(gs), 
+		seq->times[i], type_oid(T_GEOMETRY));
+	lwpoint_free(lwpoint);
+	pfree(gs);
+	return result;
+}
+
+/* Construct the instants of an instant set or a sequence */
+
+static TemporalInst **
+mfjson_instants(MFJSONSeq *seq)
+{
+	if (seq->coordkind == MFJSON_NONE)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Unable to find 'coordinates' in MFJSON string")));
-	Datum value = parse_mfjson_coord(coordinates);
-
-	/* Get datetimes 
-	 * The maximum length of a datetime is 32 characters, e.g.,
-	 *  "2019-08-06T18:35:48.021455+02:30" 
-	 */
-	char str[33];
-	json_object *datetimes = findMemberByName(mfjson, "datetimes");
-	if (datetimes == NULL)
+	if (seq->coordkind == MFJSON_SINGLE)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Invalid coordinate array in MFJSON string")));
+	if (seq->npoints < 1)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Invalid value of 'coordinates' array in MFJSON string")));
+	if (seq->timekind == MFJSON_NONE)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Unable to find 'datetimes' in MFJSON string")));
-	const char *strdatetimes = json_object_get_string(datetimes);
-	if (!strdatetimes)
+	if (seq->timekind == MFJSON_SINGLE)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid 'datetimes' value in MFJSON string")));
-	strcpy(str, strdatetimes);
-	/* Replace 'T' by ' ' before converting to timestamptz */
-	str[10] = ' ';
-	TimestampTz t = call_input(TIMESTAMPTZOID, str);
-	TemporalInst *result = temporalinst_make(value, t, type_oid(T_GEOMETRY));
-	pfree(DatumGetPointer(value));
+			errmsg("Invalid 'datetimes' array in MFJSON string")));
+	if (seq->ntimes < 1)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Invalid value of 'datetimes' array in MFJSON string")));
+	if (seq->npoints != seq->ntimes)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Distinct number of elements in 'coordinates' and 'datetimes' arrays")));
+
+	TemporalInst **result = palloc(sizeof(TemporalInst *) * seq->npoints);
+	for (int i = 0; i < seq->npoints; i++)
+		result[i] = mfjson_instant(seq, i);
 	return result;
 }
 
-static TemporalI *
-tpointi_from_mfjson(json_object *mfjson)
+static TemporalInst *
+tpointinst_from_mfjson(MFJSONSeq *seq)
 {
-	Datum *values;
-
-	/* Get coordinates */
-	int numpoints;
-	values = parse_mfjson_points(mfjson, &numpoints);
-
-	/* Get datetimes */
-	int numdates;
-	TimestampTz *times = parse_mfjson_datetimes(mfjson, &numdates);
-
-	if (numpoints != numdates)
+	if (seq->coordkind == MFJSON_NONE)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Distinct number of elements in 'coordinates' and 'datetimes' arrays")));
-
-	/* Construct the temporal point */
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * numpoints);
-	for (int i = 0; i < numpoints; i++)
-		instants[i] = temporalinst_make(values[i], times[i], type_oid(T_GEOMETRY));
-	TemporalI *result = temporali_from_temporalinstarr(instants, numpoints);
+			errmsg("Unable to find 'coordinates' in MFJSON string")));
+	if (seq->coordkind != MFJSON_SINGLE)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Invalid coordinate array in MFJSON string")));
+	if (seq->timekind == MFJSON_NONE)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Unable to find 'datetimes' in MFJSON string")));
+	return mfjson_instant(seq, 0);
+}
 
-	for (int i = 0; i < numpoints; i++)
-	{
+static TemporalI *
+tpointi_from_mfjson(MFJSONSeq *seq)
+{
+	TemporalInst **instants = mfjson_instants(seq);
+	TemporalI *result = temporali_from_temporalinstarr(instants, seq->npoints);
+	for (int i = 0; i < seq->npoints; i++)
 		pfree(instants[i]);
-		pfree(DatumGetPointer(values[i]));
-	}
 	pfree(instants);
 	return result;
 }
 
 static TemporalSeq *
-tpointseq_from_mfjson(json_object *mfjson, bool linear)
+tpointseq_from_mfjson(MFJSONSeq *seq, bool linear)
 {
-	Datum *values;
-
-	/* Get coordinates */
-	int numpoints;
-	values = parse_mfjson_points(mfjson, &numpoints);
-
-	/* Get datetimes */
-	int numdates;
-	TimestampTz *times = parse_mfjson_datetimes(mfjson, &numdates);
-
-	if (numpoints != numdates)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Distinct number of elements in 'coordinates' and 'datetimes' arrays")));
-
-	json_object *lowerinc = NULL;
-	lowerinc = findMemberByName(mfjson, "lower_inc");
-	if (lowerinc == NULL)
+	TemporalInst **instants = mfjson_instants(seq);
+	if (! seq->haslower)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Unable to find 'lower_inc' in MFJSON string")));
-	bool lower_inc = (bool) json_object_get_boolean(lowerinc);
-
-	json_object *upperinc = NULL;
-	upperinc = findMemberByName(mfjson, "upper_inc");
-	if (upperinc == NULL)
+	if (! seq->hasupper)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Unable to find 'upper_inc' in MFJSON string")));
-	bool upper_inc = (bool) json_object_get_boolean(upperinc);
-
-	/* Construct the temporal point */
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * numpoints);
-	for (int i = 0; i < numpoints; i++)
-		instants[i] = temporalinst_make(values[i], times[i], type_oid(T_GEOMETRY));
-	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, numpoints, 
-		lower_inc, upper_inc, linear, true);
-
-	for (int i = 0; i < numpoints; i++)
-	{
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, 
+		seq->npoints, seq->lower_inc, seq->upper_inc, linear, true);
+	for (int i = 0; i < seq->npoints; i++)
 		pfree(instants[i]);
-		pfree(DatumGetPointer(values[i]));
-	}
 	pfree(instants);
-	pfree(values);
-	pfree(times);
 	return result;
 }
 
 static TemporalS *
-tpoints_from_mfjson(json_object *mfjson, bool linear)
+tpoints_from_mfjson(MFJSONParser *p, bool linear)
 {
-	json_object *seqs = NULL;
-	seqs = findMemberByName(mfjson, "sequences");
-	if (seqs == NULL)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Unable to find 'sequences' in MFJSON string")));
-	if (json_object_get_type(seqs) != json_type_array)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid 'sequences' array in MFJSON string")));
-	int numseqs = json_object_array_length(seqs);
-	if (numseqs < 1)
+	if (p->nseqs < 1)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Invalid value of 'sequences' array in MFJSON string")));
-
-	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * numseqs);
-	for (int i = 0; i < numseqs; i++)
-	{
-		Datum *values;
-		TimestampTz *times;
-
-		json_object* seqvalue = NULL;
-		seqvalue = json_object_array_get_idx(seqs, i);
-
-		/* Get coordinates */
-		int numpoints;
-		values = parse_mfjson_points(seqvalue, &numpoints);
-		
-		/* Get datetimes */
-		int numdates;
-		times = parse_mfjson_datetimes(seqvalue, &numdates);
-
-		if (numpoints != numdates)
-			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-				errmsg("Distinct number of elements in 'coordinates' and 'datetimes'")));
-
-		json_object *lowerinc = NULL;
-		lowerinc = findMemberByName(seqvalue, "lower_inc");
-		if (lowerinc == NULL)
-			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-				errmsg("Unable to find 'lower_inc' in MFJSON string")));
-		bool lower_inc = (bool) json_object_get_boolean(lowerinc);
-
-		json_object *upperinc = NULL;
-		upperinc = findMemberByName(seqvalue, "upper_inc");
-		if (upperinc == NULL)
-			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-				errmsg("Unable to find 'upper_inc' in MFJSON string")));
-		bool upper_inc = (bool) json_object_get_boolean(upperinc);
-
-		/* Construct the temporal point */
-		TemporalInst **instants = palloc(sizeof(TemporalInst *) * numpoints);
-		for (int j = 0; j < numpoints; j++)
-			instants[j] = temporalinst_make(values[j], times[j], type_oid(T_GEOMETRY));
-		sequences[i] = temporalseq_from_temporalinstarr(instants, numpoints, 
-			lower_inc, upper_inc, linear, true);
-		for (int j = 0; j < numpoints; j++)
-		{
-			pfree(instants[j]);
-			pfree(DatumGetPointer(values[j]));
-		}
-		pfree(instants);
-		pfree(values);
-		pfree(times);
-	}
-	TemporalS *result = temporals_from_temporalseqarr(sequences, numseqs, 
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * p->nseqs);
+	for (int i = 0; i < p->nseqs; i++)
+		sequences[i] = tpointseq_from_mfjson(&p->seqs[i], linear);
+	TemporalS *result = temporals_from_temporalseqarr(sequences, p->nseqs, 
 		linear, true);
-	for (int i = 0; i < numseqs; i++)
+	for (int i = 0; i < p->nseqs; i++)
 		pfree(sequences[i]);
 	pfree(sequences);
 	return result;
@@ -380,46 +628,24 @@ PGDLLEXPORT Datum
 tpoint_from_mfjson(PG_FUNCTION_ARGS)
 {
 	Temporal *temp;
-	text *mfjson_input;
-	char *mfjson;
-	char *srs = NULL;
 
 	/* Get the mfjson stream */
-	mfjson_input = PG_GETARG_TEXT_P(0);
-	mfjson = text2cstring(mfjson_input);
-
-	json_tokener *jstok = NULL;
-	json_object *poObj = NULL;
-	json_object *poObjType = NULL;
-	json_object *poObjInterp = NULL;
-	json_object *poObjInterp1 = NULL;
-	json_object *poObjDates = NULL;
-	json_object *poObjSrs = NULL;
-
-	/* Begin to parse json */
-	jstok = json_tokener_new();
-	poObj = json_tokener_parse_ex(jstok, mfjson, -1);
-	if (jstok->err != json_tokener_success)
-	{
-		char err[256];
-		snprintf(err, 256, "%s (at offset %d)", json_tokener_error_desc(jstok->err), jstok->char_offset);
-		json_tokener_free(jstok);
-		json_object_put(poObj);
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Error while processing MFJSON string")));
-	}
-	json_tokener_free(jstok);
-	
+	text *mfjson_input = PG_GETARG_TEXT_P(0);
+	char *mfjson = text_to_cstring(mfjson_input);
+
+	MFJSONParser parser;
+	memset(&parser, 0, sizeof(MFJSONParser));
+	parser.cur = mfjson;
+	mfjson_seq_init(&parser.main);
+	mfjson_parse(&parser);
+
 	/*
 	 * Ensure that it is a moving point
 	 */
-	poObjType = findMemberByName(poObj, "type");
-	if (poObjType == NULL)
+	if (parser.type == NULL)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Unable to find 'type' in MFJSON string")));
-
-	const char *pszType = json_object_get_string(poObjType);
-	if (strcmp(pszType, "MovingPoint") != 0)
+	if (strcmp(parser.type, "MovingPoint") != 0)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Invalid 'type' value in MFJSON string")));
 
@@ -427,83 +653,38 @@ tpoint_from_mfjson(PG_FUNCTION_ARGS)
 	 * Determine duration of temporal point and dispatch to the 
 	 *  corresponding parse function 
 	 */
-	poObjInterp = findMemberByName(poObj, "interpolations");
-	if (poObjInterp == NULL)
+	if (! parser.hasinterp)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Unable to find 'interpolations' in MFJSON string")));
-
-	if (json_object_get_type(poObjInterp) != json_type_array)
+	if (parser.ninterp != 1)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
 			errmsg("Invalid 'interpolations' value in MFJSON string")));
-
-	const int nSize = json_object_array_length(poObjInterp);
-	if (nSize != 1)
-		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-			errmsg("Invalid 'interpolations' value in MFJSON string")));
-
-	/* Read interpolation value */
-	poObjInterp1 = json_object_array_get_idx(poObjInterp, 0);
-	const char *pszInterp = json_object_get_string(poObjInterp1);
-	if (pszInterp)
+	if (strcmp(parser.interp, "Discrete") == 0)
 	{
-		if (strcmp(pszInterp, "Discrete") == 0)
-		{
-			poObjDates = findMemberByName(poObj, "datetimes");
-			if (poObjDates != NULL &&
-				json_object_get_type(poObjDates) == json_type_array)
-				temp = (Temporal *)tpointi_from_mfjson(poObj);
-			else
-				temp = (Temporal *)tpointinst_from_mfjson(poObj);
-		}
-		else if (strcmp(pszInterp, "Stepwise") == 0)
-		{
-			json_object *poObjSeqs = findMemberByName(poObj, "sequences");
-			if (poObjSeqs != NULL)
-				temp = (Temporal *)tpoints_from_mfjson(poObj, false);
-			else
-				temp = (Temporal *)tpointseq_from_mfjson(poObj, false);
-		}
-		else if (strcmp(pszInterp, "Linear") == 0)
-		{
-			json_object *poObjSeqs = findMemberByName(poObj, "sequences");
-			if (poObjSeqs != NULL)
-				temp = (Temporal *)tpoints_from_mfjson(poObj, true);
-			else
-				temp = (Temporal *)tpointseq_from_mfjson(poObj, true);
-		}
+		if (parser.main.timekind == MFJSON_ARRAY)
+			temp = (Temporal *)tpointi_from_mfjson(&parser.main);
 		else
-			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
-				errmsg("Invalid MFJSON string")));
+			temp = (Temporal *)tpointinst_from_mfjson(&parser.main);
 	}
-
-	/* Parse crs and set SRID of temporal point */
-	poObjSrs = findMemberByName(poObj, "crs");
-	if (poObjSrs != NULL)
+	else if (strcmp(parser.interp, "Stepwise") == 0 || 
+		strcmp(parser.interp, "Linear") == 0)
 	{
-		json_object *poObjSrsType = findMemberByName(poObjSrs, "type");
-		if (poObjSrsType != NULL)
-		{
-			json_object *poObjSrsProps = findMemberByName(poObjSrs, "properties");
-			if (poObjSrsProps)
-			{
-				json_object *poNameURL = findMemberByName(poObjSrsProps, "name");
-				if (poNameURL)
-				{
-					const char *pszName = json_object_get_string(poNameURL);
-					if (pszName)
-					{
-						srs = palloc(strlen(pszName) + 1);
-						strcpy(srs, pszName);
-					}
-				}
-			}
-		}
+		bool linear = strcmp(parser.interp, "Linear") == 0;
+		if (parser.hasseqs)
+			temp = (Temporal *)tpoints_from_mfjson(&parser, linear);
+		else
+			temp = (Temporal *)tpointseq_from_mfjson(&parser.main, linear);
 	}
+	else
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("Invalid MFJSON string")));
+	pfree(mfjson);
+
+	/* Set SRID of temporal point */
 	Temporal *result;
-	if (srs)
+	if (parser.hascrs && parser.srs)
 	{
-		result = tpoint_set_srid_internal(temp, getSRIDbySRS(srs));
-		pfree(srs);
+		result = tpoint_set_srid_internal(temp, getSRIDbySRS(parser.srs));
 		pfree(temp);
 	}
 	else
@@ -676,6 +857,37 @@ tpoint_type_from_wkb_state(wkb_parse_state *s, uint8_t wkb_type)
 	}
 }
 
+/**
+* Read the coordinates and the timestamp of an instant and advance the parse
+* state forward. The caller must have verified that the data exists.
+* When the input is in the machine byte order the values are copied in 
+* bulk, otherwise each of them is swapped.
+*/
+static TemporalInst *
+tpointinst_from_wkb_point(wkb_parse_state *s)
+{
+	double coords[3];
+	TimestampTz t;
+	int ndims = (s->has_z) ? 3 : 2;
+	if (! s->swap_bytes)
+	{
+		memcpy(coords, s->pos, ndims * WKB_DOUBLE_SIZE);
+		s->pos += ndims * WKB_DOUBLE_SIZE;
+		memcpy(&t, s->pos, WKB_TIMESTAMP_SIZE);
+		s->pos += WKB_TIMESTAMP_SIZE;
+	}
+	else
+	{
+		for (int i = 0; i < ndims; i++)
+			coords[i] = double_from_wkb_state(s);
+		t = timestamp_from_wkb_state(s);
+	}
+	/* Create the instant with the SRID writing the coordinates directly */
+	int srid = (s->has_srid) ? s->srid : SRID_UNKNOWN;
+	return tpointinst_make(coords[0], coords[1], s->has_z ? coords[2] : 0,
+		s->has_z, false, srid, t);
+}
+
 /**
 * TemporalInst
 * Read a WKB Temporal, starting just after the endian byte,
@@ -687,39 +899,13 @@ tpoint_type_from_wkb_state(wkb_parse_state *s, uint8_t wkb_type)
 static TemporalInst * 
 tpointinst_from_wkb_state(wkb_parse_state *s)
 {
-	double x, y, z;
 	/* Count the dimensions. */
 	uint32_t ndims = (s->has_z) ? 3 : 2;
 	/* Does the data we want to read exist? */
 	size_t size = (ndims * WKB_DOUBLE_SIZE) + WKB_TIMESTAMP_SIZE;
 	wkb_parse_state_check(s, size);
 	/* Parse the coordinates and create the point */
-	Datum value = 0;
-	if (s->has_z)
-	{
-		x = double_from_wkb_state(s);
-		y = double_from_wkb_state(s);
-		z = double_from_wkb_state(s);
-		value = call_function3(LWGEOM_makepoint, Float8GetDatum(x),
-			Float8GetDatum(y), Float8GetDatum(z));
-
-	}
-	else 
-	{
-		x = double_from_wkb_state(s);
-		y = double_from_wkb_state(s);
-		value = call_function2(LWGEOM_makepoint, Float8GetDatum(x),
-			Float8GetDatum(y));
-	}
-	TimestampTz t = timestamp_from_wkb_state(s);
-	if (s->has_srid)
-	{
-		GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(value);
-		gserialized_set_srid(gs, s->srid);
-	}
-	TemporalInst *result = temporalinst_make(value, t, type_oid(T_GEOMETRY));
-	pfree(DatumGetPointer(value));
-	return result;
+	return tpointinst_from_wkb_point(s);
 }
 
 static TemporalI * 
@@ -735,35 +921,7 @@ tpointi_from_wkb_state(wkb_parse_state *s)
 	/* Parse the instants */
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
 	for (int i = 0; i < count; i++)
-	{
-		double x, y, z;
-		/* Parse the coordinates and create the point */
-		Datum value = 0;
-		if (s->has_z)
-		{
-			x = double_from_wkb_state(s);
-			y = double_from_wkb_state(s);
-			z = double_from_wkb_state(s);
-			value = call_function3(LWGEOM_makepoint, Float8GetDatum(x),
-				Float8GetDatum(y), Float8GetDatum(z));
-
-		}
-		else 
-		{
-			x = double_from_wkb_state(s);
-			y = double_from_wkb_state(s);
-			value = call_function2(LWGEOM_makepoint, Float8GetDatum(x),
-				Float8GetDatum(y));
-		}
-		TimestampTz t = timestamp_from_wkb_state(s);
-		if (s->has_srid)
-		{
-			GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(value);
-			gserialized_set_srid(gs, s->srid);
-		}
-		instants[i] = temporalinst_make(value, t, type_oid(T_GEOMETRY));
-		pfree(DatumGetPointer(value));
-	}
+		instants[i] = tpointinst_from_wkb_point(s);
 	TemporalI *result = temporali_from_temporalinstarr(instants, count); 
 	for (int i = 0; i < count; i++)
 		pfree(instants[i]);
@@ -801,35 +959,7 @@ tpointseq_from_wkb_state(wkb_parse_state *s)
 	/* Parse the instants */
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
 	for (int i = 0; i < count; i++)
-	{
-		double x, y, z;
-		/* Parse the coordinates and create the point */
-		Datum value = 0;
-		if (s->has_z)
-		{
-			x = double_from_wkb_state(s);
-			y = double_from_wkb_state(s);
-			z = double_from_wkb_state(s);
-			value = call_function3(LWGEOM_makepoint, Float8GetDatum(x),
-				Float8GetDatum(y), Float8GetDatum(z));
-
-		}
-		else 
-		{
-			x = double_from_wkb_state(s);
-			y = double_from_wkb_state(s);
-			value = call_function2(LWGEOM_makepoint, Float8GetDatum(x),
-				Float8GetDatum(y));
-		}
-		TimestampTz t = timestamp_from_wkb_state(s);
-		if (s->has_srid)
-		{
-			GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(value);
-			gserialized_set_srid(gs, s->srid);
-		}
-		instants[i] = temporalinst_make(value, t, type_oid(T_GEOMETRY));
-		pfree(DatumGetPointer(value));
-	}
+		instants[i] = tpointinst_from_wkb_point(s);
 	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, count, 
 		lower_inc, upper_inc, s->linear, true); 
 	for (int i = 0; i < count; i++)
@@ -861,35 +991,7 @@ tpoints_from_wkb_state(wkb_parse_state *s)
 		/* Parse the instants */
 		TemporalInst **instants = palloc(sizeof(TemporalInst *) * countinst);
 		for (int j = 0; j < countinst; j++)
-		{
-			double x, y, z;
-			/* Parse the coordinates and create the point */
-			Datum value = 0;
-			if (s->has_z)
-			{
-				x = double_from_wkb_state(s);
-				y = double_from_wkb_state(s);
-				z = double_from_wkb_state(s);
-				value = call_function3(LWGEOM_makepoint, Float8GetDatum(x),
-					Float8GetDatum(y), Float8GetDatum(z));
-
-			}
-			else 
-			{
-				x = double_from_wkb_state(s);
-				y = double_from_wkb_state(s);
-				value = call_function2(LWGEOM_makepoint, Float8GetDatum(x),
-					Float8GetDatum(y));
-			}
-			TimestampTz t = timestamp_from_wkb_state(s);
-			if (s->has_srid)
-			{
-				GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(value);
-				gserialized_set_srid(gs, s->srid);
-			}
-			instants[j] = temporalinst_make(value, t, type_oid(T_GEOMETRY));
-			pfree(DatumGetPointer(value));
-		}
+			instants[j] = tpointinst_from_wkb_point(s);
 		sequences[i] = temporalseq_from_temporalinstarr(instants, countinst,
 			lower_inc, upper_inc, s->linear, true); 
 		for (int j = 0; j < countinst; j++)
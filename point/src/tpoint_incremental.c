@@ -0,0 +1,294 @@
+/*****************************************************************************
+ *
+ * tpoint_incremental.c
+ *	  Incremental computation of temporal relationships over streams of
+ *	  temporal points
+ *
+ * A continuous query keeps up to date the result of a temporal relationship
+ * over temporal points that grow at their end, e.g., with appendInstant, as
+ * new positions are received. Instead of recomputing the relationship over
+ * the whole temporal points at every update, the functions in this file take
+ * as first argument the previous result, which may be NULL, and only compute
+ * the relationship from the instant at which the previous result ends. Only
+ * the corresponding instants of the temporal points are read when they are
+ * stored out of line in a TOAST table and are not compressed. The result of
+ * the new instants is then appended to the previous result. The value of the
+ * previous result at its last instant is kept, which supposes that the values
+ * of the temporal points before this instant have not changed since the
+ * previous result was computed.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "tpoint_incremental.h"
+
+#include <utils/timestamp.h>
+
+#include "period.h"
+#include "temporaltypes.h"
+#include "temporal_util.h"
+#include "tpoint.h"
+#include "tpoint_spatialfuncs.h"
+#include "tpoint_distance.h"
+#include "tpoint_tempspatialrels.h"
+
+/*****************************************************************************
+ * Generic functions
+ *****************************************************************************/
+
+/* Array of the sequences of a temporal sequence or sequence set */
+
+static TemporalSeq **
+temporal_append_sequences(Temporal *temp, int *count)
+{
+	if (temp->duration == TEMPORALSEQ)
+	{
+		TemporalSeq **result = palloc(sizeof(TemporalSeq *));
+		result[0] = (TemporalSeq *) temp;
+		*count = 1;
+		return result;
+	}
+	*count = ((TemporalS *) temp)->count;
+	return temporals_sequences((TemporalS *) temp);
+}
+
+/*
+ * Get the temporal point of the argument restricted to the period, reading
+ * only the instants needed when possible
+ */
+static Temporal *
+temporal_append_getarg(FunctionCallInfo fcinfo, int i, Period *p)
+{
+	Temporal *temp = temporal_getarg_slice(fcinfo, i, p);
+	if (temp == NULL)
+		return NULL;
+	Temporal *result = temporal_at_period_internal(temp, p);
+	PG_FREE_IF_COPY(temp, i);
+	return result;
+}
+
+/*
+ * Append to the previous result the result for the new instants, which
+ * starts at the instant at which the previous result ends or after it.
+ * When both results contain this instant, the sequences are joined if
+ * their values at this instant are equal, otherwise the instant is removed
+ * from the new result.
+ */
+static Temporal *
+temporal_append_result(Temporal *prev, Temporal *tail)
+{
+	bool linear = MOBDB_FLAGS_GET_LINEAR(prev->flags);
+	int count1, count2;
+	TemporalSeq **sequences1 = temporal_append_sequences(prev, &count1);
+	TemporalSeq **sequences2 = temporal_append_sequences(tail, &count2);
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * (count1 + count2));
+	int k = 0;
+	for (int i = 0; i < count1 - 1; i++)
+		sequences[k++] = sequences1[i];
+	TemporalSeq *last = sequences1[count1 - 1];
+	TemporalSeq *first = sequences2[0];
+	TemporalSeq *newseq = NULL;
+	int start = 0;
+	if (last->period.upper_inc && first->period.lower_inc &&
+		timestamp_cmp_internal(last->period.upper, first->period.lower) == 0)
+	{
+		TemporalInst **instants = palloc(sizeof(TemporalInst *) *
+			(last->count + first->count));
+		int n = 0;
+		Datum value1 = temporalinst_value(temporalseq_inst_n(last, last->count - 1));
+		Datum value2 = temporalinst_value(temporalseq_inst_n(first, 0));
+		if (datum_eq(value1, value2, prev->valuetypid))
+		{
+			for (int i = 0; i < last->count; i++)
+				instants[n++] = temporalseq_inst_n(last, i);
+			for (int i = 1; i < first->count; i++)
+				instants[n++] = temporalseq_inst_n(first, i);
+			newseq = temporalseq_from_temporalinstarr(instants, n,
+				last->period.lower_inc, first->period.upper_inc, linear, true);
+			sequences[k++] = newseq;
+		}
+		else
+		{
+			sequences[k++] = last;
+			if (first->count > 1)
+			{
+				for (int i = 0; i < first->count; i++)
+					instants[n++] = temporalseq_inst_n(first, i);
+				newseq = temporalseq_from_temporalinstarr(instants, n,
+					false, first->period.upper_inc, linear, true);
+				sequences[k++] = newseq;
+			}
+		}
+		pfree(instants);
+		start = 1;
+	}
+	else
+		sequences[k++] = last;
+	for (int i = start; i < count2; i++)
+		sequences[k++] = sequences2[i];
+	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+		linear, true);
+
+	if (newseq != NULL)
+		pfree(newseq);
+	pfree(sequences1); pfree(sequences2); pfree(sequences);
+	/* Keep the duration of the previous result when possible */
+	if (prev->duration == TEMPORALSEQ && result->count == 1)
+	{
+		TemporalSeq *seq = temporalseq_copy(temporals_seq_n(result, 0));
+		pfree(result);
+		return (Temporal *) seq;
+	}
+	return (Temporal *) result;
+}
+
+/*
+ * Generic function for the incremental temporal relationships. The first
+ * argument is the previous result, the second one is a temporal point, and
+ * the third one is a temporal point when temporal2 is true or a geometry
+ * otherwise. The function func computes the relationship over the temporal
+ * point and the third argument using the additional parameter param.
+ */
+static Datum
+temporal_append_rel(FunctionCallInfo fcinfo, bool temporal2, Datum param,
+	Temporal *(*func)(Temporal *, Datum, Datum))
+{
+	if (PG_ARGISNULL(1) || PG_ARGISNULL(2))
+		PG_RETURN_NULL();
+	Temporal *prev = PG_ARGISNULL(0) ? NULL : PG_GETARG_TEMPORAL(0);
+	Temporal *result = NULL;
+	if (prev == NULL || prev->duration == TEMPORALINST ||
+		prev->duration == TEMPORALI)
+	{
+		/* Compute the relationship over the whole arguments */
+		Temporal *temp1 = PG_GETARG_TEMPORAL(1);
+		Pointer arg2 = temporal2 ? (Pointer) PG_GETARG_TEMPORAL(2) :
+			(Pointer) PG_GETARG_GSERIALIZED_P(2);
+		result = func(temp1, PointerGetDatum(arg2), param);
+		PG_FREE_IF_COPY(temp1, 1);
+		PG_FREE_IF_COPY(arg2, 2);
+		if (result == NULL)
+			result = prev;
+		if (result == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(result);
+	}
+
+	/* Restrict the arguments to the instants from the end of the previous
+	 * result */
+	Period p;
+	temporal_period(&p, prev);
+	period_set(&p, p.upper, DT_NOEND, true, true);
+	Temporal *temp1 = temporal_append_getarg(fcinfo, 1, &p);
+	Pointer arg2 = NULL;
+	if (temporal2)
+		arg2 = (Pointer) temporal_append_getarg(fcinfo, 2, &p);
+	else
+		arg2 = (Pointer) PG_GETARG_GSERIALIZED_P(2);
+	Temporal *tail = NULL;
+	if (temp1 != NULL && arg2 != NULL)
+		tail = func(temp1, PointerGetDatum(arg2), param);
+	if (tail != NULL &&
+		(tail->duration == TEMPORALSEQ || tail->duration == TEMPORALS))
+		result = temporal_append_result(prev, tail);
+	else
+		result = prev;
+
+	if (temp1 != NULL)
+		pfree(temp1);
+	if (temporal2 && arg2 != NULL)
+		pfree(arg2);
+	else if (! temporal2)
+		PG_FREE_IF_COPY(arg2, 2);
+	if (tail != NULL)
+		pfree(tail);
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Temporal relationships
+ *****************************************************************************/
+
+static Temporal *
+tintersects_append(Temporal *temp, Datum geo, Datum param)
+{
+	GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(geo);
+	ensure_same_srid_tpoint_gs(temp, gs);
+	ensure_same_dimensionality_tpoint_gs(temp, gs);
+	if (gserialized_is_empty(gs))
+		return NULL;
+	return tintersects_tpoint_geo_internal(temp, gs);
+}
+
+static Temporal *
+tdwithin_append_geo(Temporal *temp, Datum geo, Datum dist)
+{
+	GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(geo);
+	ensure_same_srid_tpoint_gs(temp, gs);
+	ensure_same_dimensionality_tpoint_gs(temp, gs);
+	if (gserialized_is_empty(gs))
+		return NULL;
+	return tdwithin_tpoint_geo_internal(temp, gs, dist);
+}
+
+static Temporal *
+tdwithin_append_tpoint(Temporal *temp1, Datum temp2, Datum dist)
+{
+	return tdwithin_tpoint_tpoint_internal(temp1,
+		(Temporal *) DatumGetPointer(temp2), dist);
+}
+
+static Temporal *
+distance_append_tpoint(Temporal *temp1, Datum temp2, Datum param)
+{
+	Temporal *temp = (Temporal *) DatumGetPointer(temp2);
+	ensure_same_srid_tpoint(temp1, temp);
+	ensure_same_dimensionality_tpoint(temp1, temp);
+	return distance_tpoint_tpoint_internal(temp1, temp);
+}
+
+PG_FUNCTION_INFO_V1(tintersects_append_tpoint_geo);
+
+PGDLLEXPORT Datum
+tintersects_append_tpoint_geo(PG_FUNCTION_ARGS)
+{
+	return temporal_append_rel(fcinfo, false, (Datum) 0,
+		&tintersects_append);
+}
+
+PG_FUNCTION_INFO_V1(tdwithin_append_tpoint_geo);
+
+PGDLLEXPORT Datum
+tdwithin_append_tpoint_geo(PG_FUNCTION_ARGS)
+{
+	if (PG_ARGISNULL(3))
+		PG_RETURN_NULL();
+	return temporal_append_rel(fcinfo, false, PG_GETARG_DATUM(3),
+		&tdwithin_append_geo);
+}
+
+PG_FUNCTION_INFO_V1(tdwithin_append_tpoint_tpoint);
+
+PGDLLEXPORT Datum
+tdwithin_append_tpoint_tpoint(PG_FUNCTION_ARGS)
+{
+	if (PG_ARGISNULL(3))
+		PG_RETURN_NULL();
+	return temporal_append_rel(fcinfo, true, PG_GETARG_DATUM(3),
+		&tdwithin_append_tpoint);
+}
+
+PG_FUNCTION_INFO_V1(distance_append_tpoint_tpoint);
+
+PGDLLEXPORT Datum
+distance_append_tpoint_tpoint(PG_FUNCTION_ARGS)
+{
+	return temporal_append_rel(fcinfo, true, (Datum) 0,
+		&distance_append_tpoint);
+}
+
+/*****************************************************************************/
@@ -0,0 +1,47 @@
+/*****************************************************************************
+ *
+ * tpoint_load.c
+ *	  Bulk load of temporal points from files
+ *
+ * The lines of the files give the identifier of an object, a timestamp, and
+ * the X, Y, and optionally Z coordinates of the object at this timestamp.
+ * The instants are built directly from the coordinates.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "tpoint_load.h"
+
+#include "temporal_load.h"
+#include "tpoint.h"
+#include "tpoint_spatialfuncs.h"
+
+/*****************************************************************************/
+
+static TemporalInst *
+tgeompointinst_load_make(const LoadPoint *point, int nvalues, Datum srid)
+{
+	return tpointinst_make(point->values[0], point->values[1],
+		nvalues == 3 ? point->values[2] : 0, nvalues == 3, false,
+		DatumGetInt32(srid), point->t);
+}
+
+PG_FUNCTION_INFO_V1(tgeompoint_load_csv);
+
+PGDLLEXPORT Datum
+tgeompoint_load_csv(PG_FUNCTION_ARGS)
+{
+	text *filename = PG_GETARG_TEXT_PP(0);
+	int32 srid = PG_GETARG_INT32(1);
+	bool header = PG_GETARG_BOOL(2);
+	text *delimiter = PG_GETARG_TEXT_PP(3);
+	temporal_load_csv(fcinfo, filename, header, delimiter, 2, 3,
+		&tgeompointinst_load_make, Int32GetDatum(srid));
+	PG_RETURN_NULL();
+}
+
+/*****************************************************************************/
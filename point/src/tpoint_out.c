@@ -68,23 +68,39 @@ ewkt_out(Oid type, Datum value)
 	return result;
 }
 
+/*
+ * Append a point in Well-Known Text (WKT) format to the buffer, with the
+ * same result as wkt_out but without building a LWGEOM
+ */
+static void
+wkt_out_buf(StringInfo buf, Oid type, Datum value)
+{
+	GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(value);
+	int dims = FLAGS_GET_Z(gs->flags) ? 3 : 2;
+	/* The coordinates of a point follow its type and its number of points */
+	const double *coords = (const double *) ((uint8_t *) gs->data + 8);
+	char str[OUT_DOUBLE_BUFFER_SIZE];
+	appendStringInfoString(buf, dims == 3 ? "POINT Z (" : "POINT(");
+	for (int i = 0; i < dims; i++)
+	{
+		if (i > 0)
+			appendStringInfoChar(buf, ' ');
+		lwprint_double(coords[i], DBL_DIG, str, OUT_DOUBLE_BUFFER_SIZE);
+		appendStringInfoString(buf, str);
+	}
+	appendStringInfoChar(buf, ')');
+}
+
 /* Output a temporal point in WKT format */
 
 static text *
 tpoint_as_text_internal(Temporal *temp)
 {
-	char *str = NULL;
-	ensure_valid_duration(temp->duration);
-	if (temp->duration == TEMPORALINST)
-		str = temporalinst_to_string((TemporalInst *)temp, &wkt_out);
-	else if (temp->duration == TEMPORALI)
-		str = temporali_to_string((TemporalI *)temp, &wkt_out);
-	else if (temp->duration == TEMPORALSEQ)
-		str = temporalseq_to_string((TemporalSeq *)temp, false, &wkt_out);
-	else if (temp->duration == TEMPORALS)
-		str = temporals_to_string((TemporalS *)temp, &wkt_out);
-	text *result = cstring_to_text(str);
-	pfree(str);
+	StringInfoData buf;
+	initStringInfo(&buf);
+	temporal_to_string_buf(&buf, temp, &wkt_out_buf);
+	text *result = cstring_to_text_with_len(buf.data, buf.len);
+	pfree(buf.data);
 	return result;
 }
 
@@ -99,33 +115,20 @@ tpoint_as_text(PG_FUNCTION_ARGS)
 	PG_RETURN_TEXT_P(result);
 }
 
-/* Output a temporal point in WKT format */
+/* Output a temporal point in EWKT format */
 
 static text *
 tpoint_as_ewkt_internal(Temporal *temp)
 {
 	int srid = tpoint_srid_internal(temp);
-	char str1[20];
+	StringInfoData buf;
+	initStringInfo(&buf);
 	if (srid > 0)
-		sprintf(str1, "SRID=%d%c", srid,
+		appendStringInfo(&buf, "SRID=%d%c", srid,
 			MOBDB_FLAGS_GET_LINEAR(temp->flags) ? ';' : ',');
-	else
-		str1[0] = '\0';
-	char *str2 = NULL;
-	ensure_valid_duration(temp->duration);
-	if (temp->duration == TEMPORALINST)
-		str2 = temporalinst_to_string((TemporalInst *)temp, &wkt_out);
-	else if (temp->duration == TEMPORALI)
-		str2 = temporali_to_string((TemporalI *)temp, &wkt_out);
-	else if (temp->duration == TEMPORALSEQ)
-		str2 = temporalseq_to_string((TemporalSeq *)temp, false, &wkt_out);
-	else if (temp->duration == TEMPORALS)
-		str2 = temporals_to_string((TemporalS *)temp, &wkt_out);
-	char *str = (char *) palloc(strlen(str1) + strlen(str2) + 1);
-	strcpy(str, str1);
-	strcat(str, str2);
-	text *result = cstring_to_text(str);
-	pfree(str2); pfree(str);
+	temporal_to_string_buf(&buf, temp, &wkt_out_buf);
+	text *result = cstring_to_text_with_len(buf.data, buf.len);
+	pfree(buf.data);
 	return result;
 }
 
@@ -260,328 +263,178 @@ tpointarr_as_ewkt(PG_FUNCTION_ARGS)
 
 /*****************************************************************************
  * Output in MFJSON format 
+ *
+ * The MF-JSON string is written in a single pass into a growable buffer.
  *****************************************************************************/
 
 /*
  * Handle coordinate array
- * Returns maximum size of rendered coordinate array in bytes.
  */
-static size_t
-coordinates_mfjson_size(int npoints, bool hasz, int precision)
+static void
+coordinates_mfjson_buf(StringInfo buf, TemporalInst *inst, int precision)
 {
-	assert(precision <= OUT_MAX_DOUBLE_PRECISION);
-	if (hasz)
-		return (OUT_MAX_DIGS_DOUBLE + precision + sizeof(","))
-			* 3 * npoints + sizeof(",[]");
-	else
-		return (OUT_MAX_DIGS_DOUBLE + precision + sizeof(","))
-			* 2 * npoints + sizeof(",[]");
-}
-
-static size_t
-coordinates_mfjson_buf(char *output, TemporalInst *inst, int precision)
-{
-	char *ptr;
 	char x[OUT_DOUBLE_BUFFER_SIZE];
 	char y[OUT_DOUBLE_BUFFER_SIZE];
 	char z[OUT_DOUBLE_BUFFER_SIZE];
 
 	assert (precision <= OUT_MAX_DOUBLE_PRECISION);
-	ptr = output;
-
+	GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(temporalinst_value(inst));
 	if (!MOBDB_FLAGS_GET_Z(inst->flags))
 	{
-		POINT2D pt = datum_get_point2d(temporalinst_value(inst));
+		POINT2D pt = gs_get_point2d(gs);
 		lwprint_double(pt.x, precision, x, OUT_DOUBLE_BUFFER_SIZE);
 		lwprint_double(pt.y, precision, y, OUT_DOUBLE_BUFFER_SIZE);
-		ptr += sprintf(ptr, "[%s,%s]", x, y);
+		appendStringInfo(buf, "[%s,%s]", x, y);
 	}
 	else
 	{
-		POINT3DZ pt = datum_get_point3dz(temporalinst_value(inst));
+		POINT3DZ pt = gs_get_point3dz(gs);
 		lwprint_double(pt.x, precision, x, OUT_DOUBLE_BUFFER_SIZE);
 		lwprint_double(pt.y, precision, y, OUT_DOUBLE_BUFFER_SIZE);
 		lwprint_double(pt.z, precision, z, OUT_DOUBLE_BUFFER_SIZE);
-		ptr += sprintf(ptr, "[%s,%s,%s]", x, y, z);
+		appendStringInfo(buf, "[%s,%s,%s]", x, y, z);
 	}
-	return (ptr - output);
 }
 
 /*
  * Handle datetimes array
- * Returns maximum size of datetimes array in bytes.
  * Example: "datetimes":["2019-08-06T18:35:48.021455+02:30","2019-08-06T18:45:18.476983+02:30"],
- * 32 characters for the timestamptz + 2 double quotes + 1 comma
  */
-static size_t
-datetimes_mfjson_size(int npoints)
-{
-	return sizeof("\"2019-08-06T18:35:48.021455+02:30\",") * npoints + sizeof("[],");
-}
-
-static size_t
-datetimes_mfjson_buf(char *output, TemporalInst *inst)
+static void
+datetimes_mfjson_buf(StringInfo buf, TemporalInst *inst)
 {
-	char *ptr = output;
-	char *t = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(inst->t));
+	char *t = DatumGetCString(DirectFunctionCall1(timestamptz_out, 
+		TimestampTzGetDatum(inst->t)));
 	/* Replace ' ' by 'T' as separator between date and time parts */
 	t[10] = 'T';
-	ptr += sprintf(ptr, "\"%s\"", t);
+	appendStringInfo(buf, "\"%s\"", t);
 	pfree(t);
-	return (ptr - output);
 }
 
 /*
  * Handle SRS
  */
-static size_t
-srs_mfjson_size(char *srs)
+static void
+srs_mfjson_buf(StringInfo buf, char *srs)
 {
-	size_t size = sizeof("'crs':{'type':'name',");
-	size += sizeof("'properties':{'name':''}},");
-	size += strlen(srs) * sizeof(char);
-	return size;
-}
-
-static size_t
-srs_mfjson_buf(char *output, char *srs)
-{
-	char *ptr = output;
-	ptr += sprintf(ptr, "\"crs\":{\"type\":\"name\",");
-	ptr += sprintf(ptr, "\"properties\":{\"name\":\"%s\"}},", srs);
-	return (ptr - output);
+	appendStringInfoString(buf, "\"crs\":{\"type\":\"name\",");
+	appendStringInfo(buf, "\"properties\":{\"name\":\"%s\"}},", srs);
 }
 
 /*
  * Handle Bbox
  */
-static size_t
-bbox_mfjson_size(int hasz, int precision)
-{
-	/* The maximum size of a timestamptz is 35 characters, e.g., "2019-08-06 23:18:16.195062-09:30" */
-	size_t size = sizeof("'stBoundedBy':{'period':{'begin':,'end':}},") +
-		sizeof("\"2019-08-06T18:35:48.021455+02:30\",") * 2;
-	if (!hasz)
-	{
-		size += sizeof("'bbox':[,,,],");
-		size +=	2 * 2 * (OUT_MAX_DIGS_DOUBLE + precision);
-	}
-	else
-	{
-		size += sizeof("\"bbox\":[,,,,,],");
-		size +=	2 * 3 * (OUT_MAX_DIGS_DOUBLE + precision);
-	}
-	return size;
-}
-
-static size_t
-bbox_mfjson_buf(char *output, STBOX *bbox, int hasz, int precision)
+static void
+bbox_mfjson_buf(StringInfo buf, STBOX *bbox, int hasz, int precision)
 {
-	char *ptr = output;
-	ptr += sprintf(ptr, "\"stBoundedBy\":{");
+	appendStringInfoString(buf, "\"stBoundedBy\":{");
 	if (!hasz)
-		ptr += sprintf(ptr, "\"bbox\":[%.*f,%.*f,%.*f,%.*f],",
+		appendStringInfo(buf, "\"bbox\":[%.*f,%.*f,%.*f,%.*f],",
 			precision, bbox->xmin, precision, bbox->ymin,
 			precision, bbox->xmax, precision, bbox->ymax);
 	else
-		ptr += sprintf(ptr, "\"bbox\":[%.*f,%.*f,%.*f,%.*f,%.*f,%.*f],",
+		appendStringInfo(buf, "\"bbox\":[%.*f,%.*f,%.*f,%.*f,%.*f,%.*f],",
 			precision, bbox->xmin, precision, bbox->ymin, precision, bbox->zmin,
 			precision, bbox->xmax, precision, bbox->ymax, precision, bbox->zmax);
-	char *begin = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(bbox->tmin));
-	char *end = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(bbox->tmax));
-	ptr += sprintf(ptr, "\"period\":{\"begin\":\"%s\",\"end\":\"%s\"}},", begin, end);
+	char *begin = DatumGetCString(DirectFunctionCall1(timestamptz_out, 
+		TimestampTzGetDatum(bbox->tmin)));
+	char *end = DatumGetCString(DirectFunctionCall1(timestamptz_out, 
+		TimestampTzGetDatum(bbox->tmax)));
+	appendStringInfo(buf, "\"period\":{\"begin\":\"%s\",\"end\":\"%s\"}},", begin, end);
 	pfree(begin); pfree(end);
-	return (ptr - output);
-}
-
-/*****************************************************************************/
-
-static size_t
-tpointinst_as_mfjson_size(const TemporalInst *inst, int precision, STBOX *bbox, char *srs)
-{
-	size_t size = coordinates_mfjson_size(1, MOBDB_FLAGS_GET_Z(inst->flags), precision);
-	size += datetimes_mfjson_size(1);
-	size += sizeof("{'type':'MovingPoint',");
-	size += sizeof("'coordinates':,'datetimes':,'interpolations':['Discrete']}");
-	if (srs) size += srs_mfjson_size(srs);
-	if (bbox) size += bbox_mfjson_size(MOBDB_FLAGS_GET_Z(inst->flags), precision);
-	return size;
 }
 
-static size_t
-tpointinst_as_mfjson_buf(TemporalInst *inst, int precision, STBOX *bbox, char *srs, char *output)
-{
-	char *ptr = output;
-	ptr += sprintf(ptr, "{\"type\":\"MovingPoint\",");
-	if (srs) ptr += srs_mfjson_buf(ptr, srs);
-	if (bbox) ptr += bbox_mfjson_buf(ptr, bbox, MOBDB_FLAGS_GET_Z(inst->flags), precision);
-	ptr += sprintf(ptr, "\"coordinates\":");
-	ptr += coordinates_mfjson_buf(ptr, inst, precision);
-	ptr += sprintf(ptr, ",\"datetimes\":");
-	ptr += datetimes_mfjson_buf(ptr, inst);
-	ptr += sprintf(ptr, ",\"interpolations\":[\"Discrete\"]}");
-	return (ptr - output);
-}
+/* Write the header shared by all durations */
 
-static char *
-tpointinst_as_mfjson(TemporalInst *inst, int precision, STBOX *bbox, char *srs)
+static void
+header_mfjson_buf(StringInfo buf, Temporal *temp, int precision, STBOX *bbox, 
+	char *srs)
 {
-	size_t size = tpointinst_as_mfjson_size(inst, precision, bbox, srs);
-	char *output = palloc(size);
-	tpointinst_as_mfjson_buf(inst, precision, bbox, srs, output);
-	return output;
+	appendStringInfoString(buf, "{\"type\":\"MovingPoint\",");
+	if (srs) srs_mfjson_buf(buf, srs);
+	if (bbox) bbox_mfjson_buf(buf, bbox, MOBDB_FLAGS_GET_Z(temp->flags), precision);
 }
 
-/*****************************************************************************/
-
-static size_t
-tpointi_as_mfjson_size(const TemporalI *ti, int precision, STBOX *bbox, char *srs)
-{
-	size_t size = coordinates_mfjson_size(ti->count, MOBDB_FLAGS_GET_Z(ti->flags), precision);
-	size += datetimes_mfjson_size(ti->count);
-	size += sizeof("{'type':'MovingPoint',");
-	size += sizeof("'coordinates':[],'datetimes':[],'interpolations':['Discrete']}");
-	if (srs) size += srs_mfjson_size(srs);
-	if (bbox) size += bbox_mfjson_size(MOBDB_FLAGS_GET_Z(ti->flags), precision);
-	return size;
-}
+/* Write the coordinates and the datetimes of a sequence */
 
-static size_t
-tpointi_as_mfjson_buf(TemporalI *ti, int precision, STBOX *bbox, char *srs, char *output)
+static void
+tpointseq_mfjson_buf(StringInfo buf, TemporalSeq *seq, int precision)
 {
-	char *ptr = output;
-	ptr += sprintf(ptr, "{\"type\":\"MovingPoint\",");
-	if (srs) ptr += srs_mfjson_buf(ptr, srs);
-	if (bbox) ptr += bbox_mfjson_buf(ptr, bbox, MOBDB_FLAGS_GET_Z(ti->flags), precision);
-	ptr += sprintf(ptr, "\"coordinates\":[");
-	for (int i = 0; i < ti->count; i++)
+	appendStringInfoString(buf, "\"coordinates\":[");
+	for (int i = 0; i < seq->count; i++)
 	{
-		if (i) ptr += sprintf(ptr, ",");
-		ptr += coordinates_mfjson_buf(ptr, temporali_inst_n(ti, i), precision);
+		if (i) appendStringInfoChar(buf, ',');
+		coordinates_mfjson_buf(buf, temporalseq_inst_n(seq, i), precision);
 	}
-	ptr += sprintf(ptr, "],\"datetimes\":[");
-	for (int i = 0; i < ti->count; i++)
+	appendStringInfoString(buf, "],\"datetimes\":[");
+	for (int i = 0; i < seq->count; i++)
 	{
-		if (i) ptr += sprintf(ptr, ",");
-		ptr += datetimes_mfjson_buf(ptr, temporali_inst_n(ti, i));
+		if (i) appendStringInfoChar(buf, ',');
+		datetimes_mfjson_buf(buf, temporalseq_inst_n(seq, i));
 	}
-	ptr += sprintf(ptr, "],\"interpolations\":[\"Discrete\"]}");
-	return (ptr - output);
-}
-
-static char *
-tpointi_as_mfjson(TemporalI *ti, int precision, STBOX *bbox, char *srs)
-{
-	size_t size = tpointi_as_mfjson_size(ti, precision, bbox, srs);
-	char *output = palloc(size);
-	tpointi_as_mfjson_buf(ti, precision, bbox, srs, output);
-	return output;
+	appendStringInfo(buf, "],\"lower_inc\":%s,\"upper_inc\":%s",
+		seq->period.lower_inc ? "true" : "false", seq->period.upper_inc ? "true" : "false");
 }
 
 /*****************************************************************************/
 
-static size_t
-tpointseq_as_mfjson_size(const TemporalSeq *seq, int precision, STBOX *bbox, char *srs)
+static void
+tpointinst_as_mfjson_buf(StringInfo buf, TemporalInst *inst, int precision, 
+	STBOX *bbox, char *srs)
 {
-	size_t size = coordinates_mfjson_size(seq->count, MOBDB_FLAGS_GET_Z(seq->flags), precision);
-	size += datetimes_mfjson_size(seq->count);
-	size += sizeof("{'type':'MovingPoint',");
-	/* We reserve space for the largest strings, i.e., 'false' and "Stepwise" */
-	size += sizeof("'coordinates':[],'datetimes':[],'lower_inc':false,'upper_inc':false,interpolations':['Stepwise']}");
-	if (srs) size += srs_mfjson_size(srs);
-	if (bbox) size += bbox_mfjson_size(MOBDB_FLAGS_GET_Z(seq->flags), precision);
-	return size;
+	header_mfjson_buf(buf, (Temporal *) inst, precision, bbox, srs);
+	appendStringInfoString(buf, "\"coordinates\":");
+	coordinates_mfjson_buf(buf, inst, precision);
+	appendStringInfoString(buf, ",\"datetimes\":");
+	datetimes_mfjson_buf(buf, inst);
+	appendStringInfoString(buf, ",\"interpolations\":[\"Discrete\"]}");
 }
 
-static size_t
-tpointseq_as_mfjson_buf(TemporalSeq *seq, int precision, STBOX *bbox, char *srs, char *output)
+static void
+tpointi_as_mfjson_buf(StringInfo buf, TemporalI *ti, int precision, 
+	STBOX *bbox, char *srs)
 {
-	char *ptr = output;
-	ptr += sprintf(ptr, "{\"type\":\"MovingPoint\",");
-	if (srs) ptr += srs_mfjson_buf(ptr, srs);
-	if (bbox) ptr += bbox_mfjson_buf(ptr, bbox, MOBDB_FLAGS_GET_Z(seq->flags), precision);
-	ptr += sprintf(ptr, "\"coordinates\":[");
-	for (int i = 0; i < seq->count; i++)
+	header_mfjson_buf(buf, (Temporal *) ti, precision, bbox, srs);
+	appendStringInfoString(buf, "\"coordinates\":[");
+	for (int i = 0; i < ti->count; i++)
 	{
-		if (i) ptr += sprintf(ptr, ",");
-		ptr += coordinates_mfjson_buf(ptr, temporalseq_inst_n(seq, i), precision);
+		if (i) appendStringInfoChar(buf, ',');
+		coordinates_mfjson_buf(buf, temporali_inst_n(ti, i), precision);
 	}
-	ptr += sprintf(ptr, "],\"datetimes\":[");
-	for (int i = 0; i < seq->count; i++)
+	appendStringInfoString(buf, "],\"datetimes\":[");
+	for (int i = 0; i < ti->count; i++)
 	{
-		if (i) ptr += sprintf(ptr, ",");
-		ptr += datetimes_mfjson_buf(ptr, temporalseq_inst_n(seq, i));
+		if (i) appendStringInfoChar(buf, ',');
+		datetimes_mfjson_buf(buf, temporali_inst_n(ti, i));
 	}
-	ptr += sprintf(ptr, "],\"lower_inc\":%s,\"upper_inc\":%s,\"interpolations\":[\"%s\"]}",
-		seq->period.lower_inc ? "true" : "false", seq->period.upper_inc ? "true" : "false",
-		MOBDB_FLAGS_GET_LINEAR(seq->flags) ? "Linear" : "Stepwise");
-	return (ptr - output);
+	appendStringInfoString(buf, "],\"interpolations\":[\"Discrete\"]}");
 }
 
-static char *
-tpointseq_as_mfjson(TemporalSeq *seq, int precision, STBOX *bbox, char *srs)
+static void
+tpointseq_as_mfjson_buf(StringInfo buf, TemporalSeq *seq, int precision, 
+	STBOX *bbox, char *srs)
 {
-	size_t size = tpointseq_as_mfjson_size(seq, precision, bbox, srs);
-	char *output = palloc(size);
-	tpointseq_as_mfjson_buf(seq, precision, bbox, srs, output);
-	return output;
-}
-
-/*****************************************************************************/
-
-static size_t
-tpoints_as_mfjson_size(TemporalS *ts, int precision, STBOX *bbox, char *srs)
-{
-	size_t size = sizeof("{'type':'MovingPoint','sequences':[],");
-	size += sizeof("{'coordinates':[],'datetimes':[],'lower_inc':false,'upper_inc':false},") * ts->count;
-	size += coordinates_mfjson_size(ts->totalcount, MOBDB_FLAGS_GET_Z(ts->flags), precision);
-	size += datetimes_mfjson_size(ts->totalcount);
-	/* We reserve space for the largest interpolation string, i.e., "Stepwise" */
-	size += sizeof(",interpolations':['Stepwise']}");
-	if (srs) size += srs_mfjson_size(srs);
-	if (bbox) size += bbox_mfjson_size(MOBDB_FLAGS_GET_Z(ts->flags), precision);
-	return size;
+	header_mfjson_buf(buf, (Temporal *) seq, precision, bbox, srs);
+	tpointseq_mfjson_buf(buf, seq, precision);
+	appendStringInfo(buf, ",\"interpolations\":[\"%s\"]}",
+		MOBDB_FLAGS_GET_LINEAR(seq->flags) ? "Linear" : "Stepwise");
 }
 
-static size_t
-tpoints_as_mfjson_buf(TemporalS *ts, int precision, STBOX *bbox, char *srs, char *output)
+static void
+tpoints_as_mfjson_buf(StringInfo buf, TemporalS *ts, int precision, 
+	STBOX *bbox, char *srs)
 {
-	char *ptr = output;
-	ptr += sprintf(ptr, "{\"type\":\"MovingPoint\",");
-	if (srs) ptr += srs_mfjson_buf(ptr, srs);
-	if (bbox) ptr += bbox_mfjson_buf(ptr, bbox, MOBDB_FLAGS_GET_Z(ts->flags), precision);
-	ptr += sprintf(ptr, "\"sequences\":[");
+	header_mfjson_buf(buf, (Temporal *) ts, precision, bbox, srs);
+	appendStringInfoString(buf, "\"sequences\":[");
 	for (int i = 0; i < ts->count; i++)
 	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		if (i) ptr += sprintf(ptr, ",");
-		ptr += sprintf(ptr, "{\"coordinates\":[");
-		for (int j = 0; j < seq->count; j++)
-		{
-			if (j) ptr += sprintf(ptr, ",");
-			ptr += coordinates_mfjson_buf(ptr, temporalseq_inst_n(seq, j), precision);
-		}
-		ptr += sprintf(ptr, "],\"datetimes\":[");
-		for (int j = 0; j < seq->count; j++)
-		{
-			if (j) ptr += sprintf(ptr, ",");
-			ptr += datetimes_mfjson_buf(ptr, temporalseq_inst_n(seq, j));
-		}
-		ptr += sprintf(ptr, "],\"lower_inc\":%s,\"upper_inc\":%s}",
-			seq->period.lower_inc ? "true" : "false", seq->period.upper_inc ? "true" : "false");
+		if (i) appendStringInfoChar(buf, ',');
+		appendStringInfoChar(buf, '{');
+		tpointseq_mfjson_buf(buf, temporals_seq_n(ts, i), precision);
+		appendStringInfoChar(buf, '}');
 	}
-	ptr += sprintf(ptr, "],\"interpolations\":[\"%s\"]}",
+	appendStringInfo(buf, "],\"interpolations\":[\"%s\"]}",
 		MOBDB_FLAGS_GET_LINEAR(ts->flags) ? "Linear" : "Stepwise");
-	return (ptr - output);
-}
-
-static char *
-tpoints_as_mfjson(TemporalS *ts, int precision, STBOX *bbox, char *srs)
-{
-	size_t size = tpoints_as_mfjson_size(ts, precision, bbox, srs);
-	char *output = palloc(size);
-	tpoints_as_mfjson_buf(ts, precision, bbox, srs, output);
-	return output;
 }
 
 /*****************************************************************************/
@@ -650,17 +503,19 @@ tpoint_as_mfjson(PG_FUNCTION_ARGS)
 		bbox = &tmp;
 	}
 
-	char *mfjson = NULL;
+	StringInfoData buf;
+	initStringInfo(&buf);
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST)
-		mfjson = tpointinst_as_mfjson((TemporalInst *)temp, precision, bbox, srs);
+		tpointinst_as_mfjson_buf(&buf, (TemporalInst *)temp, precision, bbox, srs);
 	else if (temp->duration == TEMPORALI)
-		mfjson = tpointi_as_mfjson((TemporalI *)temp, precision, bbox, srs);
+		tpointi_as_mfjson_buf(&buf, (TemporalI *)temp, precision, bbox, srs);
 	else if (temp->duration == TEMPORALSEQ)
-		mfjson = tpointseq_as_mfjson((TemporalSeq *)temp, precision, bbox, srs);
+		tpointseq_as_mfjson_buf(&buf, (TemporalSeq *)temp, precision, bbox, srs);
 	else if (temp->duration == TEMPORALS)
-		mfjson = tpoints_as_mfjson((TemporalS *)temp, precision, bbox, srs);
-	text *result = cstring_to_text(mfjson);
+		tpoints_as_mfjson_buf(&buf, (TemporalS *)temp, precision, bbox, srs);
+	text *result = cstring_to_text_with_len(buf.data, buf.len);
+	pfree(buf.data);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_TEXT_P(result);
 }
@@ -678,28 +533,25 @@ tpoint_as_mfjson(PG_FUNCTION_ARGS)
 #define WKT_EXTENDED 0x04
 
 /*
-* Look-up table for hex writer
-*/
-static char *hexchr = "0123456789ABCDEF";
-
-/*
-* Endian
+* Look-up table for the hex writer giving the two hex digits of every byte
 */
-static uint8_t *
-endian_to_wkb_buf(uint8_t *buf, uint8_t variant)
-{
-	if (variant & WKB_HEX)
-	{
-		buf[0] = '0';
-		buf[1] = ((variant & WKB_NDR) ? (uint8_t) '1' : (uint8_t) '0');
-		return buf + 2;
-	}
-	else
-	{
-		buf[0] = ((variant & WKB_NDR) ? (uint8_t) 1 : (uint8_t) 0);
-		return buf + 1;
-	}
-}
+static const char hexbyte[513] =
+	"000102030405060708090A0B0C0D0E0F"
+	"101112131415161718191A1B1C1D1E1F"
+	"202122232425262728292A2B2C2D2E2F"
+	"303132333435363738393A3B3C3D3E3F"
+	"404142434445464748494A4B4C4D4E4F"
+	"505152535455565758595A5B5C5D5E5F"
+	"606162636465666768696A6B6C6D6E6F"
+	"707172737475767778797A7B7C7D7E7F"
+	"808182838485868788898A8B8C8D8E8F"
+	"909192939495969798999A9B9C9D9E9F"
+	"A0A1A2A3A4A5A6A7A8A9AAABACADAEAF"
+	"B0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+	"C0C1C2C3C4C5C6C7C8C9CACBCCCDCECF"
+	"D0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+	"E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEF"
+	"F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
 
 /*
 * SwapBytes?
@@ -719,254 +571,107 @@ wkb_swap_bytes(uint8_t variant)
 /*
 * Integer32
 */
-static uint8_t*
-integer_to_wkb_buf(const int ival, uint8_t *buf, uint8_t variant)
+static inline uint8_t *
+integer_to_wkb_buf(const int ival, uint8_t *buf, bool swap)
 {
-	char *iptr = (char*)(&ival);
-	int i = 0;
-
-	if (sizeof(int) != WKB_INT_SIZE)
-		elog(ERROR, "Machine int size is not %d bytes!", WKB_INT_SIZE);
-
-	if (variant & WKB_HEX)
+	const uint8_t *iptr = (const uint8_t *) &ival;
+	/* Machine/request arch mismatch, so flip byte order */
+	if (swap)
 	{
-		int swap = wkb_swap_bytes(variant);
-		/* Machine/request arch mismatch, so flip byte order */
-		for (i = 0; i < WKB_INT_SIZE; i++)
-		{
-			int j = (swap ? WKB_INT_SIZE - 1 - i : i);
-			uint8_t b = (uint8_t) iptr[j];
-			/* Top four bits to 0-F */
-			buf[2*i] = (uint8_t) hexchr[b >> 4];
-			/* Bottom four bits to 0-F */
-			buf[2*i + 1] = (uint8_t) hexchr[b & 0x0F];
-		}
-		return buf + (2 * WKB_INT_SIZE);
+		for (int i = 0; i < WKB_INT_SIZE; i++)
+			buf[i] = iptr[WKB_INT_SIZE - 1 - i];
 	}
+	/* If machine arch and requested arch match, don't flip byte order */
 	else
-	{
-		/* Machine/request arch mismatch, so flip byte order */
-		if (wkb_swap_bytes(variant))
-		{
-			for (i = 0; i < WKB_INT_SIZE; i++)
-			{
-				buf[i] = (uint8_t) iptr[WKB_INT_SIZE - 1 - i];
-			}
-		}
-		/* If machine arch and requested arch match, don't flip byte order */
-		else
-		{
-			memcpy(buf, iptr, WKB_INT_SIZE);
-		}
-		return buf + WKB_INT_SIZE;
-	}
+		memcpy(buf, iptr, WKB_INT_SIZE);
+	return buf + WKB_INT_SIZE;
 }
 
 /*
-* Float64
+* Array of 8-byte words, i.e., coordinates of type double and timestamps.
+* When the requested byte order is the one of the machine the array is 
+* copied in bulk.
 */
-static uint8_t*
-double_to_wkb_buf(const double d, uint8_t *buf, uint8_t variant)
-{
-	char *dptr = (char*)(&d);
-	int i = 0;
-
-	if (sizeof(double) != WKB_DOUBLE_SIZE)
-	{
-		elog(ERROR, "Machine double size is not %d bytes!", WKB_DOUBLE_SIZE);
-	}
-
-	if (variant & WKB_HEX)
-	{
-		int swap =  wkb_swap_bytes(variant);
-		/* Machine/request arch mismatch, so flip byte order */
-		for (i = 0; i < WKB_DOUBLE_SIZE; i++)
-		{
-			int j = (swap ? WKB_DOUBLE_SIZE - 1 - i : i);
-			uint8_t b = (uint8_t) dptr[j];
-			/* Top four bits to 0-F */
-			buf[2*i] = (uint8_t) hexchr[b >> 4];
-			/* Bottom four bits to 0-F */
-			buf[2*i + 1] = (uint8_t) hexchr[b & 0x0F];
-		}
-		return buf + (2 * WKB_DOUBLE_SIZE);
-	}
-	else
-	{
-		/* Machine/request arch mismatch, so flip byte order */
-		if (wkb_swap_bytes(variant))
-		{
-			for (i = 0; i < WKB_DOUBLE_SIZE; i++)
-			{
-				buf[i] = (uint8_t) dptr[WKB_DOUBLE_SIZE - 1 - i];
-			}
-		}
-		/* If machine arch and requested arch match, don't flip byte order */
-		else
-		{
-			memcpy(buf, dptr, WKB_DOUBLE_SIZE);
-		}
-		return buf + WKB_DOUBLE_SIZE;
-	}
-}
-
-/*
- * TimestampTz aka int64
- */
-static uint8_t*
-timestamp_to_wkb_buf(const TimestampTz t, uint8_t *buf, uint8_t variant)
+static inline uint8_t *
+words_to_wkb_buf(const void *words, int count, uint8_t *buf, bool swap)
 {
-	char *tptr = (char*)(&t);
-	int i = 0;
-
-	if (sizeof(double) != WKB_DOUBLE_SIZE)
-	{
-		elog(ERROR, "Machine timestamp size is not %d bytes!", WKB_DOUBLE_SIZE);
-	}
-
-	if (variant & WKB_HEX)
+	const uint8_t *wptr = (const uint8_t *) words;
+	/* Machine/request arch mismatch, so flip byte order */
+	if (swap)
 	{
-		int swap =  wkb_swap_bytes(variant);
-		/* Machine/request arch mismatch, so flip byte order */
-		for (i = 0; i < WKB_DOUBLE_SIZE; i++)
+		for (int i = 0; i < count; i++)
 		{
-			int j = (swap ? WKB_DOUBLE_SIZE - 1 - i : i);
-			uint8_t b = (uint8_t) tptr[j];
-			/* Top four bits to 0-F */
-			buf[2*i] = (uint8_t)hexchr[b >> 4];
-			/* Bottom four bits to 0-F */
-			buf[2*i + 1] = (uint8_t) hexchr[b & 0x0F];
+			for (int j = 0; j < WKB_DOUBLE_SIZE; j++)
+				buf[j] = wptr[WKB_DOUBLE_SIZE - 1 - j];
+			buf += WKB_DOUBLE_SIZE;
+			wptr += WKB_DOUBLE_SIZE;
 		}
-		return buf + (2 * WKB_DOUBLE_SIZE);
-	}
-	else
-	{
-		/* Machine/request arch mismatch, so flip byte order */
-		if (wkb_swap_bytes(variant))
-		{
-			for (i = 0; i < WKB_DOUBLE_SIZE; i++)
-			{
-				buf[i] = (uint8_t) tptr[WKB_DOUBLE_SIZE - 1 - i];
-			}
-		}
-		/* If machine arch and requested arch match, don't flip byte order */
-		else
-		{
-			memcpy(buf, tptr, WKB_DOUBLE_SIZE);
-		}
-		return buf + WKB_DOUBLE_SIZE;
+		return buf;
 	}
+	/* If machine arch and requested arch match, don't flip byte order */
+	memcpy(buf, wptr, (size_t) count * WKB_DOUBLE_SIZE);
+	return buf + (size_t) count * WKB_DOUBLE_SIZE;
 }
 
 static bool
-tpoint_wkb_needs_srid(Temporal *temp, uint8_t variant)
+tpoint_wkb_needs_srid(const Temporal *temp, uint8_t variant)
 {
 	/* We can only add an SRID if the geometry has one, and the
 	   WKB form is extended */
-	if ((variant & WKB_EXTENDED) && tpoint_srid_internal(temp) != SRID_UNKNOWN)
+	if ((variant & WKB_EXTENDED) && tpoint_srid_internal((Temporal *) temp) != SRID_UNKNOWN)
 		return true;
 
 	/* Everything else doesn't get an SRID */
 	return false;
 }
 
+/*
+* Size of the binary WKB, which only depends on the header of the value
+*/
 static size_t
-tpointinstarr_to_wkb_size(int npoints, bool hasz, uint8_t variant)
-{
-	int dims = 2;
-	size_t size = 0;
-	if (hasz)
-		dims = 3;
-	/* size of the TemporalInst array */
-	size += dims * npoints * WKB_DOUBLE_SIZE +
-		npoints * WKB_TIMESTAMP_SIZE;
-	return size;
-}
-
-static size_t
-tpointinst_to_wkb_size(TemporalInst *inst, uint8_t variant)
+tpoint_to_wkb_size(const Temporal *temp, uint8_t variant)
 {
+	int dims = MOBDB_FLAGS_GET_Z(temp->flags) ? 3 : 2;
+	size_t inst_size = dims * WKB_DOUBLE_SIZE + WKB_TIMESTAMP_SIZE;
 	/* Endian flag + temporal flag */
 	size_t size = WKB_BYTE_SIZE * 2;
 	/* Extended WKB needs space for optional SRID integer */
-	if (tpoint_wkb_needs_srid((Temporal *)inst, variant))
-		size += WKB_INT_SIZE;
-	/* TemporalInst */
-	size += tpointinstarr_to_wkb_size(1, MOBDB_FLAGS_GET_Z(inst->flags),
-		variant);
-	return size;
-}
-
-static size_t
-tpointi_to_wkb_size(TemporalI *ti, uint8_t variant)
-{
-	/* Endian flag + duration flag */
-	size_t size = WKB_BYTE_SIZE * 2;
-	/* Extended WKB needs space for optional SRID integer */
-	if (tpoint_wkb_needs_srid((Temporal *)ti, variant))
-		size += WKB_INT_SIZE;
-	/* Include the number of instants */
-	size += WKB_INT_SIZE;
-	/* Include the TemporalInst array */
-	size += tpointinstarr_to_wkb_size(ti->count, MOBDB_FLAGS_GET_Z(ti->flags),
-		variant);
-	return size;
-}
-
-static size_t
-tpointseq_to_wkb_size(TemporalSeq *seq, uint8_t variant)
-{
-	/* Endian flag + duration flag */
-	size_t size = WKB_BYTE_SIZE * 2;
-	/* Extended WKB needs space for optional SRID integer */
-	if (tpoint_wkb_needs_srid((Temporal *)seq, variant))
-		size += WKB_INT_SIZE;
-	/* Include the number of instants and the period bounds flag */
-	size += WKB_INT_SIZE + WKB_BYTE_SIZE;
-	/* Include the TemporalInst array */
-	size += tpointinstarr_to_wkb_size(seq->count, MOBDB_FLAGS_GET_Z(seq->flags),
-		variant);
-	return size;
-}
-
-static size_t
-tpoints_to_wkb_size(TemporalS *ts, uint8_t variant)
-{
-	/* Endian flag + duration flag */
-	size_t size = WKB_BYTE_SIZE * 2;
-	/* Extended WKB needs space for optional SRID integer */
-	if (tpoint_wkb_needs_srid((Temporal *)ts, variant))
+	if (tpoint_wkb_needs_srid(temp, variant))
 		size += WKB_INT_SIZE;
-	/* Include the number of sequences */
-	size += WKB_INT_SIZE;
-	/* For each sequence include the number of instants and the period bounds flag */
-	size += ts->count * (WKB_INT_SIZE + WKB_BYTE_SIZE);
-	/* Include all the TemporalInst of all the sequences */
-	size += tpointinstarr_to_wkb_size(ts->totalcount, MOBDB_FLAGS_GET_Z(ts->flags),
-		variant);
-	return size;
-}
-
-static size_t
-tpoint_to_wkb_size(const Temporal *temp, uint8_t variant)
-{
-	size_t size = 0;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST)
-		size = tpointinst_to_wkb_size((TemporalInst *)temp, variant);
+		size += inst_size;
 	else if (temp->duration == TEMPORALI)
-		size = tpointi_to_wkb_size((TemporalI *)temp, variant);
+	{
+		TemporalI *ti = (TemporalI *) temp;
+		/* Number of instants + the TemporalInst array */
+		size += WKB_INT_SIZE + ti->count * inst_size;
+	}
 	else if (temp->duration == TEMPORALSEQ)
-		size = tpointseq_to_wkb_size((TemporalSeq *)temp, variant);
-	else if (temp->duration == TEMPORALS)
-		size = tpoints_to_wkb_size((TemporalS *)temp, variant);
+	{
+		TemporalSeq *seq = (TemporalSeq *) temp;
+		/* Number of instants + the period bounds flag + the TemporalInst array */
+		size += WKB_INT_SIZE + WKB_BYTE_SIZE + seq->count * inst_size;
+	}
+	else /* temp->duration == TEMPORALS */
+	{
+		TemporalS *ts = (TemporalS *) temp;
+		/* Number of sequences + for each sequence the number of instants and 
+		 * the period bounds flag + all the TemporalInst of all the sequences */
+		size += WKB_INT_SIZE + ts->count * (WKB_INT_SIZE + WKB_BYTE_SIZE) +
+			ts->totalcount * inst_size;
+	}
 	return size;
 }
 
 static uint8_t *
-tpoint_wkb_type(Temporal *temp, uint8_t *buf, uint8_t variant)
+tpoint_wkb_header(const Temporal *temp, uint8_t *buf, uint8_t variant, 
+	bool swap)
 {
 	uint8_t wkb_flags = 0;
+	/* Set the endian flag */
+	*buf++ = (variant & WKB_NDR) ? (uint8_t) 1 : (uint8_t) 0;
+	/* Set the temporal and interpolation flags */
 	if (variant & WKB_EXTENDED)
 	{
 		if (MOBDB_FLAGS_GET_Z(temp->flags))
@@ -976,241 +681,110 @@ tpoint_wkb_type(Temporal *temp, uint8_t *buf, uint8_t variant)
 		if (MOBDB_FLAGS_GET_LINEAR(temp->flags))
 			wkb_flags |= WKB_LINEAR_INTERP;
 	}
-	if (variant & WKB_HEX)
-	{
-		buf[0] = (uint8_t) hexchr[wkb_flags >> 4];
-		buf[1] = (uint8_t) hexchr[temp->duration];
-		return buf + 2;
-	}
-	else
-	{
-		buf[0] = (uint8_t) temp->duration + wkb_flags;
-		return buf + 1;
-	}
-}
-
-static uint8_t *
-tpointinst_to_wkb_buf(TemporalInst *inst, uint8_t *buf, uint8_t variant)
-{
-	/* Set the endian flag */
-	buf = endian_to_wkb_buf(buf, variant);
-	/* Set the temporal flags */
-	buf = tpoint_wkb_type((Temporal *)inst, buf, variant);
-	/* Set the optional SRID for extended variant */
-	if (tpoint_wkb_needs_srid((Temporal *)inst, variant))
-		buf = integer_to_wkb_buf(tpoint_srid_internal((Temporal *)inst), buf, variant);
-	/* Set the coordinates */
-	if (MOBDB_FLAGS_GET_Z(inst->flags))
-	{
-		POINT3DZ point = datum_get_point3dz(temporalinst_value(inst));
-		buf = double_to_wkb_buf(point.x, buf, variant);
-		buf = double_to_wkb_buf(point.y, buf, variant);
-		buf = double_to_wkb_buf(point.z, buf, variant);
-	}
-	else
-	{
-		POINT2D point = datum_get_point2d(temporalinst_value(inst));
-		buf = double_to_wkb_buf(point.x, buf, variant);
-		buf = double_to_wkb_buf(point.y, buf, variant);
-	}
-	buf = timestamp_to_wkb_buf(inst->t, buf, variant);
-	return buf;
-}
-
-static uint8_t *
-tpointi_to_wkb_buf(TemporalI *ti, uint8_t *buf, uint8_t variant)
-{
-	/* Set the endian flag */
-	buf = endian_to_wkb_buf(buf, variant);
-	/* Set the temporal flags */
-	buf = tpoint_wkb_type((Temporal *)ti, buf, variant);
+	*buf++ = (uint8_t) temp->duration + wkb_flags;
 	/* Set the optional SRID for extended variant */
-	if (tpoint_wkb_needs_srid((Temporal *)ti, variant))
-		buf = integer_to_wkb_buf(tpoint_srid_internal((Temporal *)ti), buf, variant);
-	/* Set the count */
-	buf = integer_to_wkb_buf(ti->count, buf, variant);
-	/* Set the TemporalInst array */
-	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		/* Set the coordinates */
-		if (MOBDB_FLAGS_GET_Z(inst->flags))
-		{
-			POINT3DZ point = datum_get_point3dz(temporalinst_value(inst));
-			buf = double_to_wkb_buf(point.x, buf, variant);
-			buf = double_to_wkb_buf(point.y, buf, variant);
-			buf = double_to_wkb_buf(point.z, buf, variant);
-		}
-		else
-		{
-			POINT2D point = datum_get_point2d(temporalinst_value(inst));
-			buf = double_to_wkb_buf(point.x, buf, variant);
-			buf = double_to_wkb_buf(point.y, buf, variant);
-		}
-		buf = timestamp_to_wkb_buf(inst->t, buf, variant);
-	}
+	if (wkb_flags & WKB_SRIDFLAG)
+		buf = integer_to_wkb_buf(tpoint_srid_internal((Temporal *) temp), buf, swap);
 	return buf;
 }
 
-static uint8_t *
-tpointseq_wkb_bounds(TemporalSeq *seq, uint8_t *buf, uint8_t variant)
+static inline uint8_t *
+tpointseq_wkb_bounds(const TemporalSeq *seq, uint8_t *buf)
 {
 	uint8_t wkb_flags = 0;
 	if (seq->period.lower_inc)
 		wkb_flags |= WKB_LOWER_INC;
 	if (seq->period.upper_inc)
 		wkb_flags |= WKB_UPPER_INC;
-	if (variant & WKB_HEX)
-	{
-		buf[0] = '0';
-		buf[1] = (uint8_t) hexchr[wkb_flags];
-		return buf + 2;
-	}
-	else
-	{
-		buf[0] = wkb_flags;
-		return buf + 1;
-	}
+	*buf = wkb_flags;
+	return buf + 1;
 }
 
-static uint8_t *
-tpointseq_to_wkb_buf(TemporalSeq *seq, uint8_t *buf, uint8_t variant)
+/*
+* Write the coordinates and the timestamp of an instant. The coordinates
+* are read directly from the serialized point.
+*/
+static inline uint8_t *
+tpointinst_point_to_wkb_buf(const TemporalInst *inst, int dims, uint8_t *buf, 
+	bool swap)
 {
-	/* Set the endian flag */
-	buf = endian_to_wkb_buf(buf, variant);
-	/* Set the temporal flags and interpolation */
-	buf = tpoint_wkb_type((Temporal *)seq, buf, variant);
-	/* Set the optional SRID for extended variant */
-	if (tpoint_wkb_needs_srid((Temporal *)seq, variant))
-		buf = integer_to_wkb_buf(tpoint_srid_internal((Temporal *)seq), buf, variant);
-	/* Set the count */
-	buf = integer_to_wkb_buf(seq->count, buf, variant);
-	/* Set the period bounds */
-	buf = tpointseq_wkb_bounds(seq, buf, variant);
-	/* Set the TemporalInst array */
-	for (int i = 0; i < seq->count; i++)
-	{
-		TemporalInst *inst = temporalseq_inst_n(seq, i);
-		/* Set the coordinates */
-		if (MOBDB_FLAGS_GET_Z(inst->flags))
-		{
-			POINT3DZ point = datum_get_point3dz(temporalinst_value(inst));
-			buf = double_to_wkb_buf(point.x, buf, variant);
-			buf = double_to_wkb_buf(point.y, buf, variant);
-			buf = double_to_wkb_buf(point.z, buf, variant);
-		}
-		else
-		{
-			POINT2D point = datum_get_point2d(temporalinst_value(inst));
-			buf = double_to_wkb_buf(point.x, buf, variant);
-			buf = double_to_wkb_buf(point.y, buf, variant);
-		}
-		buf = timestamp_to_wkb_buf(inst->t, buf, variant);
-	}
-	return buf;
+	GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(
+		temporalinst_value((TemporalInst *) inst));
+	buf = words_to_wkb_buf((uint8_t *) gs->data + 8, dims, buf, swap);
+	return words_to_wkb_buf(&inst->t, 1, buf, swap);
 }
 
 static uint8_t *
-tpoints_to_wkb_buf(TemporalS *ts, uint8_t *buf, uint8_t variant)
+tpointseq_instants_to_wkb_buf(const TemporalSeq *seq, uint8_t *buf, bool swap)
 {
-	/* Set the endian flag */
-	buf = endian_to_wkb_buf(buf, variant);
-	/* Set the temporal and interpolation flags */
-	buf = tpoint_wkb_type((Temporal *)ts, buf, variant);
-	/* Set the optional SRID for extended variant */
-	if (tpoint_wkb_needs_srid((Temporal *)ts, variant))
-		buf = integer_to_wkb_buf(tpoint_srid_internal((Temporal *)ts), buf, variant);
+	int dims = MOBDB_FLAGS_GET_Z(seq->flags) ? 3 : 2;
 	/* Set the count */
-	buf = integer_to_wkb_buf(ts->count, buf, variant);
-	/* Set the sequences */
-	for (int i = 0; i < ts->count; i++)
+	buf = integer_to_wkb_buf(seq->count, buf, swap);
+	/* Set the period bounds */
+	buf = tpointseq_wkb_bounds(seq, buf);
+	/* Set the TemporalInst array */
+	for (int i = 0; i < seq->count; i++)
 	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		/* Set the number of instants */
-		buf = integer_to_wkb_buf(seq->count, buf, variant);
-		/* Set the period bounds */
-		buf = tpointseq_wkb_bounds(seq, buf, variant);
-		for (int j = 0; j < seq->count; j++)
-		{
-			TemporalInst *inst = temporalseq_inst_n(seq, j);
-			/* Set the coordinates */
-			if (MOBDB_FLAGS_GET_Z(inst->flags))
-			{
-				POINT3DZ point = datum_get_point3dz(temporalinst_value(inst));
-				buf = double_to_wkb_buf(point.x, buf, variant);
-				buf = double_to_wkb_buf(point.y, buf, variant);
-				buf = double_to_wkb_buf(point.z, buf, variant);
-			}
-			else
-			{
-				POINT2D point = datum_get_point2d(temporalinst_value(inst));
-				buf = double_to_wkb_buf(point.x, buf, variant);
-				buf = double_to_wkb_buf(point.y, buf, variant);
-			}
-			buf = timestamp_to_wkb_buf(inst->t, buf, variant);
-		}
+		TemporalInst *inst = temporalseq_inst_n((TemporalSeq *) seq, i);
+		buf = tpointinst_point_to_wkb_buf(inst, dims, buf, swap);
 	}
 	return buf;
 }
 
+/*
+* Write the binary WKB of the temporal point in a single pass 
+*/
 static uint8_t *
 tpoint_to_wkb_buf(const Temporal *temp, uint8_t *buf, uint8_t variant)
 {
+	bool swap = wkb_swap_bytes(variant);
+	int dims = MOBDB_FLAGS_GET_Z(temp->flags) ? 3 : 2;
+	buf = tpoint_wkb_header(temp, buf, variant, swap);
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST)
-		return tpointinst_to_wkb_buf((TemporalInst *)temp, buf, variant);
+		buf = tpointinst_point_to_wkb_buf((TemporalInst *) temp, dims, buf, swap);
 	else if (temp->duration == TEMPORALI)
-		return tpointi_to_wkb_buf((TemporalI *)temp, buf, variant);
+	{
+		TemporalI *ti = (TemporalI *) temp;
+		/* Set the count */
+		buf = integer_to_wkb_buf(ti->count, buf, swap);
+		/* Set the TemporalInst array */
+		for (int i = 0; i < ti->count; i++)
+		{
+			TemporalInst *inst = temporali_inst_n(ti, i);
+			buf = tpointinst_point_to_wkb_buf(inst, dims, buf, swap);
+		}
+	}
 	else if (temp->duration == TEMPORALSEQ)
-		return tpointseq_to_wkb_buf((TemporalSeq *)temp, buf, variant);
+		buf = tpointseq_instants_to_wkb_buf((TemporalSeq *) temp, buf, swap);
 	else if (temp->duration == TEMPORALS)
-		return tpoints_to_wkb_buf((TemporalS *)temp, buf, variant);
-	return NULL; /* make compiler quiet */
+	{
+		TemporalS *ts = (TemporalS *) temp;
+		/* Set the count */
+		buf = integer_to_wkb_buf(ts->count, buf, swap);
+		/* Set the sequences */
+		for (int i = 0; i < ts->count; i++)
+			buf = tpointseq_instants_to_wkb_buf(temporals_seq_n(ts, i), buf, swap);
+	}
+	return buf;
 }
 
 /**
-* Convert Temporal to a char* in WKB format. Caller is responsible for freeing
-* the returned array.
+* Convert Temporal to a varlena in WKB format. The result is a bytea for the
+* binary variants and a text for the hex variant.
 *
 * @param variant. Unsigned bitmask value. Accepts one of: WKB_ISO, WKB_EXTENDED, WKB_SFSQL.
 * Accepts any of: WKB_NDR, WKB_HEX. For example: Variant = (WKB_ISO | WKB_NDR) would
 * return the little-endian ISO form of WKB. For Example: Variant = (WKB_EXTENDED | WKB_HEX)
 * would return the big-endian extended form of WKB, as hex-encoded ASCII (the "canonical form").
-* @param size_out If supplied, will return the size of the returned memory segment,
-* including the null terminator in the case of ASCII.
+*
+* The WKB is written directly into the result. For the hex variant the 
+* binary WKB is written into the second half of the result and then encoded 
+* in place from the front using a table of the hex digits of every byte.
 */
-
-static uint8_t *
-tpoint_to_wkb(const Temporal *temp, uint8_t variant, size_t *size_out)
+static struct varlena *
+tpoint_to_wkb(const Temporal *temp, uint8_t variant)
 {
-	size_t buf_size;
-	uint8_t *buf = NULL;
-	uint8_t *wkb_out = NULL;
-
-	/* Initialize output size */
-	if (size_out) *size_out = 0;
-
-	if (temp == NULL)
-	{
-		elog(ERROR, "Cannot convert NULL into WKB.");
-		return NULL;
-	}
-
-	/* Calculate the required size of the output buffer */
-	buf_size = tpoint_to_wkb_size(temp, variant);
-
-	if (buf_size == 0)
-	{
-		elog(ERROR, "Error calculating output WKB buffer size.");
-		return NULL;
-	}
-
-	/* Hex string takes twice as much space as binary + a null character */
-	if (variant & WKB_HEX)
-	{
-		buf_size = 2 * buf_size + 1;
-	}
-
 	/* If neither or both variants are specified, choose the native order */
 	if (! (variant & WKB_NDR || variant & WKB_XDR) ||
 		   (variant & WKB_NDR && variant & WKB_XDR))
@@ -1221,78 +795,64 @@ tpoint_to_wkb(const Temporal *temp, uint8_t variant, size_t *size_out)
 			variant = variant | (uint8_t) WKB_XDR;
 	}
 
-	/* Allocate the buffer */
-	buf = palloc(buf_size);
-
-	if (buf == NULL)
-	{
-		elog(ERROR, "Unable to allocate %lu bytes for WKB output buffer.", buf_size);
-		return NULL;
-	}
-
-	/* Retain a pointer to the front of the buffer for later */
-	wkb_out = buf;
+	/* Calculate the required size of the output buffer */
+	size_t size = tpoint_to_wkb_size(temp, variant);
+	/* Hex string takes twice as much space as binary */
+	size_t out_size = (variant & WKB_HEX) ? 2 * size : size;
+	struct varlena *result = palloc(out_size + VARHDRSZ);
+	SET_VARSIZE(result, out_size + VARHDRSZ);
+	uint8_t *out = (uint8_t *) VARDATA(result);
+	uint8_t *wkb = out + (out_size - size);
 
 	/* Write the WKB into the output buffer */
-	buf = tpoint_to_wkb_buf(temp, buf, variant);
+	uint8_t *end = tpoint_to_wkb_buf(temp, wkb, variant);
+	/* The buffer pointer should now land at the end of the allocated buffer space */
+	if (size != (size_t) (end - wkb))
+		elog(ERROR, "Output WKB is not the same size as the allocated buffer.");
 
-	/* Null the last byte if this is a hex output */
+	/* Reading byte i before writing positions 2i and 2i+1 never overwrites 
+	 * a byte that is still to be read */
 	if (variant & WKB_HEX)
 	{
-		*buf = '\0';
-		buf++;
-	}
-
-	/* The buffer pointer should now land at the end of the allocated buffer space. Let's check. */
-	if (buf_size != (size_t) (buf - wkb_out))
-	{
-		elog(ERROR, "Output WKB is not the same size as the allocated buffer.");
-		pfree(wkb_out);
-		return NULL;
+		for (size_t i = 0; i < size; i++)
+		{
+			const char *hex = &hexbyte[2 * wkb[i]];
+			out[2 * i] = (uint8_t) hex[0];
+			out[2 * i + 1] = (uint8_t) hex[1];
+		}
 	}
-
-	/* Report output size */
-	if (size_out) *size_out = buf_size;
-
-	return wkb_out;
+	return result;
 }
 
-/*
- * This will have no 'SRID=#;'
- */
-PG_FUNCTION_INFO_V1(tpoint_as_binary);
-
-PGDLLEXPORT Datum
-tpoint_as_binary(PG_FUNCTION_ARGS)
+/* Get the variant from the optional endianness argument */
+static uint8_t
+tpoint_wkb_endian_variant(FunctionCallInfo fcinfo)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	uint8_t *wkb;
-	size_t wkb_size;
 	uint8_t variant = 0;
- 	bytea *result;
-	text *type;
 	/* If user specified endianness, respect it */
 	if ((PG_NARGS() > 1) && (!PG_ARGISNULL(1)))
 	{
-		type = PG_GETARG_TEXT_P(1);
-
+		text *type = PG_GETARG_TEXT_P(1);
 		if (! strncmp(VARDATA(type), "xdr", 3) ||
 			! strncmp(VARDATA(type), "XDR", 3))
 			variant = variant | (uint8_t) WKB_XDR;
 		else
 			variant = variant | (uint8_t) WKB_NDR;
 	}
-	wkb_size = VARSIZE_ANY_EXHDR(temp);
-	/* Create WKB hex string */
-	wkb = tpoint_to_wkb(temp, variant, &wkb_size);
+	return variant;
+}
 
-	/* Prepare the PgSQL text return type */
-	result = palloc(wkb_size + VARHDRSZ);
-	memcpy(VARDATA(result), wkb, wkb_size);
-	SET_VARSIZE(result, wkb_size + VARHDRSZ);
+/*
+ * This will have no 'SRID=#;'
+ */
+PG_FUNCTION_INFO_V1(tpoint_as_binary);
 
-	/* Clean up and return */
-	pfree(wkb);
+PGDLLEXPORT Datum
+tpoint_as_binary(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	uint8_t variant = tpoint_wkb_endian_variant(fcinfo);
+	bytea *result = (bytea *) tpoint_to_wkb(temp, variant);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BYTEA_P(result);
 }
@@ -1306,33 +866,9 @@ PGDLLEXPORT Datum
 tpoint_as_ewkb(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	uint8_t *wkb;
-	size_t wkb_size;
-	uint8_t variant = 0;
- 	bytea *result;
-	text *type;
-	/* If user specified endianness, respect it */
-	if ((PG_NARGS() > 1) && (!PG_ARGISNULL(1)))
-	{
-		type = PG_GETARG_TEXT_P(1);
-
-		if (! strncmp(VARDATA(type), "xdr", 3) ||
-			! strncmp(VARDATA(type), "XDR", 3))
-			variant = variant | (uint8_t) WKB_XDR;
-		else
-			variant = variant | (uint8_t) WKB_NDR;
-	}
-	wkb_size = VARSIZE_ANY_EXHDR(temp);
-	/* Create WKB hex string */
-	wkb = tpoint_to_wkb(temp, variant | (uint8_t) WKB_EXTENDED, &wkb_size);
-
-	/* Prepare the PgSQL text return type */
-	result = palloc(wkb_size + VARHDRSZ);
-	memcpy(VARDATA(result), wkb, wkb_size);
-	SET_VARSIZE(result, wkb_size + VARHDRSZ);
-
-	/* Clean up and return */
-	pfree(wkb);
+	uint8_t variant = tpoint_wkb_endian_variant(fcinfo);
+	bytea *result = (bytea *) tpoint_to_wkb(temp, 
+		variant | (uint8_t) WKB_EXTENDED);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BYTEA_P(result);
 }
@@ -1346,36 +882,56 @@ PGDLLEXPORT Datum
 tpoint_as_hexewkb(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	char *hexwkb;
-	size_t hexwkb_size;
-	uint8_t variant = 0;
-	text *result;
-	text *type;
-	size_t text_size;
-	/* If user specified endianness, respect it */
-	if ((PG_NARGS() > 1) && (!PG_ARGISNULL(1)))
-	{
-		type = PG_GETARG_TEXT_P(1);
-		if (! strncmp(VARDATA(type), "xdr", 3) ||
-			! strncmp(VARDATA(type), "XDR", 3))
-			variant = variant | (uint8_t) WKB_XDR;
-		else
-			variant = variant | (uint8_t) WKB_NDR;
-	}
+	uint8_t variant = tpoint_wkb_endian_variant(fcinfo);
+	text *result = (text *) tpoint_to_wkb(temp, 
+		variant | (uint8_t) WKB_EXTENDED | (uint8_t) WKB_HEX);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_TEXT_P(result);
+}
 
-	/* Create WKB hex string */
-	hexwkb = (char *)tpoint_to_wkb(temp, variant | (uint8_t) WKB_EXTENDED | (uint8_t) WKB_HEX, &hexwkb_size);
+/*****************************************************************************
+ * Output of the instants of the temporal points
+ *****************************************************************************/
 
-	/* Prepare the PgSQL text return type */
-	text_size = hexwkb_size - 1 + VARHDRSZ;
-	result = palloc(text_size);
-	memcpy(VARDATA(result), hexwkb, hexwkb_size - 1);
-	SET_VARSIZE(result, text_size);
+/* EWKB type flags of PostGIS */
+#define EWKB_ZFLAG			0x80000000
+#define EWKB_SRIDFLAG		0x20000000
 
-	/* Clean up and return */
-	pfree(hexwkb);
-	PG_FREE_IF_COPY(temp, 0);
-	PG_RETURN_TEXT_P(result);
+/**
+ * @brief Append a point to the buffer in hexadecimal Extended Well-Known
+ *		Binary (EWKB) format, with the same result as the output function
+ *		of the geometry and geography types
+ * @note The point is written in the byte order of the machine, which is
+ *		the default order of the output function
+ */
+void
+point_hexewkb_buf(StringInfo buf, Datum value)
+{
+	GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(value);
+	int dims = FLAGS_GET_Z(gs->flags) ? 3 : 2;
+	int srid = gserialized_get_srid(gs);
+	uint32_t type = POINTTYPE;
+	if (dims == 3)
+		type |= EWKB_ZFLAG;
+	if (srid != SRID_UNKNOWN)
+		type |= EWKB_SRIDFLAG;
+	uint8_t wkb[WKB_BYTE_SIZE + 2 * WKB_INT_SIZE + 3 * WKB_DOUBLE_SIZE];
+	uint8_t *ptr = wkb;
+	*ptr++ = (uint8_t) getMachineEndian();
+	ptr = integer_to_wkb_buf((int) type, ptr, false);
+	if (srid != SRID_UNKNOWN)
+		ptr = integer_to_wkb_buf(srid, ptr, false);
+	ptr = words_to_wkb_buf((uint8_t *) gs->data + 8, dims, ptr, false);
+	int size = (int) (ptr - wkb);
+	enlargeStringInfo(buf, 2 * size);
+	char *out = buf->data + buf->len;
+	for (int i = 0; i < size; i++)
+	{
+		*out++ = hexbyte[2 * wkb[i]];
+		*out++ = hexbyte[2 * wkb[i] + 1];
+	}
+	buf->len += 2 * size;
+	buf->data[buf->len] = '\0';
 }
 
 /*****************************************************************************/
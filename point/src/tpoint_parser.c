@@ -12,11 +12,15 @@
 
 #include "tpoint_parser.h"
 
+#include <math.h>
+#include <port/pg_bswap.h>
+
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
 #include "temporal_parser.h"
+#include "postgis.h"
 #include "stbox.h"
 
 /*****************************************************************************/
@@ -242,37 +246,267 @@ stbox_parse(char **str)
 
 /*****************************************************************************/
 
-static TemporalInst *
-tpointinst_parse(char **str, Oid basetype, bool end, int *tpoint_srid) 
+/* Parse a coordinate of a point, leaving NaN and Infinity to PostGIS */
+
+static bool
+p_coord(const char **str, double *result)
+{
+	while (**str == ' ')
+		*str += 1;
+	const char *p = *str;
+	while ((*p >= '0' && *p <= '9') || *p == '.' || *p == '-' || *p == '+' ||
+			*p == 'e' || *p == 'E')
+		p++;
+	if (p == *str)
+		return false;
+	char *end;
+	*result = strtod(*str, &end);
+	if (end != p)
+		return false;
+	*str = p;
+	return true;
+}
+
+/*
+ * Fast path parser for points in WKT or EWKT format, such as 
+ * 'SRID=4326;Point(1 1)' or 'Point Z(1 1 1)', which avoids the function 
+ * manager round trip of the PostGIS input function and the construction of
+ * an LWGEOM for every instant. On success the string is advanced after the
+ * closing parenthesis and the spaces that follow it. Returns false for any
+ * other input, which is then given to the input function of the base type.
+ */
+static bool
+point_parse_fast(const char **str, int *srid, bool *hasz, double *x,
+	double *y, double *z)
+{
+	const char *p = *str;
+	*srid = SRID_UNKNOWN;
+	*hasz = false;
+	*z = 0;
+
+	while (*p == ' ')
+		p++;
+	if (strncasecmp(p, "SRID=", 5) == 0)
+	{
+		p += 5;
+		char *end;
+		long value = strtol(p, &end, 10);
+		if (end == p || *end != ';' || value < 0 || value > SRID_USER_MAXIMUM)
+			return false;
+		*srid = (int) value;
+		p = end + 1;
+	}
+	if (strncasecmp(p, "POINT", 5) != 0)
+		return false;
+	p += 5;
+	while (*p == ' ')
+		p++;
+	if (*p == 'Z' || *p == 'z')
+	{
+		*hasz = true;
+		p++;
+		while (*p == ' ')
+			p++;
+	}
+	if (*p++ != '(' || ! p_coord(&p, x) || *p != ' ' || ! p_coord(&p, y))
+		return false;
+	while (*p == ' ')
+		p++;
+	if (*p != ')')
+	{
+		/* A third coordinate without Z is also a 3D point */
+		if (! p_coord(&p, z))
+			return false;
+		*hasz = true;
+		while (*p == ' ')
+			p++;
+	}
+	else if (*hasz)
+		return false;
+	if (*p++ != ')')
+		return false;
+	while (*p == ' ')
+		p++;
+	*str = p;
+	return true;
+}
+
+/* Flags of the type of a geometry in EWKB format */
+#define EWKB_ZFLAG		0x80000000
+#define EWKB_MFLAG		0x40000000
+#define EWKB_SRIDFLAG	0x20000000
+
+static int
+hex_digit(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	return -1;
+}
+
+/*
+ * Fast path parser for points in hexadecimal EWKB format, which is the
+ * output format of geometries. On success the string is advanced after the
+ * hexadecimal digits. Returns false for any other input, including empty
+ * points, which is then given to the input function of the base type.
+ */
+static bool
+point_parse_hexewkb_fast(const char **str, int *srid, bool *hasz, double *x,
+	double *y, double *z)
+{
+	/* Endian, type, SRID, and three coordinates */
+	uint8_t wkb[1 + 4 + 4 + 3 * 8];
+	const char *p = *str;
+	int size = 0;
+	while (size < (int) sizeof(wkb))
+	{
+		int hi = hex_digit(p[0]);
+		if (hi < 0)
+			break;
+		int lo = hex_digit(p[1]);
+		if (lo < 0)
+			return false;
+		wkb[size++] = (uint8_t) ((hi << 4) | lo);
+		p += 2;
+	}
+	if (hex_digit(*p) >= 0 || size < 1 + 4 + 2 * 8 || wkb[0] > 1)
+		return false;
+
+	bool swap = (wkb[0] == 1) != (getMachineEndian() == NDR);
+	uint8_t *pos = wkb + 1;
+	uint32_t type;
+	memcpy(&type, pos, 4);
+	if (swap)
+		type = pg_bswap32(type);
+	pos += 4;
+	if (type & EWKB_MFLAG)
+		return false;
+	*hasz = (type & EWKB_ZFLAG) != 0;
+	bool has_srid = (type & EWKB_SRIDFLAG) != 0;
+	type &= 0x0FFFFFFF;
+	/* Accept the 3D points in ISO format */
+	if (type == 1001)
+	{
+		*hasz = true;
+		type = POINTTYPE;
+	}
+	if (type != POINTTYPE || size != 1 + 4 + (has_srid ? 4 : 0) + (*hasz ? 3 : 2) * 8)
+		return false;
+	*srid = SRID_UNKNOWN;
+	if (has_srid)
+	{
+		uint32_t value;
+		memcpy(&value, pos, 4);
+		if (swap)
+			value = pg_bswap32(value);
+		pos += 4;
+		*srid = clamp_srid((int) value);
+	}
+	double coords[3] = {0, 0, 0};
+	for (int i = 0; i < (*hasz ? 3 : 2); i++)
+	{
+		uint64 value;
+		memcpy(&value, pos, 8);
+		if (swap)
+			value = pg_bswap64(value);
+		memcpy(&coords[i], &value, 8);
+		pos += 8;
+		/* Empty points have NaN coordinates */
+		if (isnan(coords[i]))
+			return false;
+	}
+	*x = coords[0];
+	*y = coords[1];
+	*z = coords[2];
+	*str = p;
+	return true;
+}
+
+bool
+geometry_point_parse_fast(const char *str, Datum *result)
+{
+	int srid;
+	bool hasz;
+	double x, y, z;
+	const char *p = str;
+	if ((! point_parse_fast(&p, &srid, &hasz, &x, &y, &z) || *p != '\0') &&
+		(! point_parse_hexewkb_fast(&str, &srid, &hasz, &x, &y, &z) ||
+			*str != '\0'))
+		return false;
+	*result = PointerGetDatum(gspoint_make(x, y, z, hasz, false, srid));
+	return true;
+}
+
+/*****************************************************************************/
+
+/* Check the SRID of an instant with respect to the one of the temporal point */
+
+static int
+tpointinst_parse_srid(Oid basetype, int geo_srid, int *tpoint_srid)
 {
-	p_whitespace(str);
-	/* The next instruction will throw an exception if it fails */
-	Datum geo = basetype_parse(str, basetype); 
-	GSERIALIZED *gs = (GSERIALIZED *)PG_DETOAST_DATUM(geo);
-	int geo_srid = gserialized_get_srid(gs);
-	ensure_point_type(gs);
-	ensure_non_empty(gs);
-	ensure_has_not_M(gs);
 	if (*tpoint_srid != SRID_UNKNOWN && geo_srid != SRID_UNKNOWN && *tpoint_srid != geo_srid)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Geometry SRID (%d) does not match temporal type SRID (%d)", 
 			geo_srid, *tpoint_srid)));
+	int unknown = (basetype == type_oid(T_GEOMETRY)) ? SRID_UNKNOWN :
+		SRID_DEFAULT;
+	if (*tpoint_srid != SRID_UNKNOWN && geo_srid == unknown)
+		return *tpoint_srid;
+	if (*tpoint_srid == SRID_UNKNOWN && geo_srid != unknown)
+		*tpoint_srid = geo_srid;
+	return geo_srid;
+}
+
+static TemporalInst *
+tpointinst_parse(char **str, Oid basetype, bool end, int *tpoint_srid) 
+{
+	p_whitespace(str);
+	TemporalInst *result;
+	int srid;
+	bool hasz;
+	double x, y, z;
+	const char *p = *str;
+	bool fast = false;
 	if (basetype == type_oid(T_GEOMETRY))
 	{
-		if (*tpoint_srid != SRID_UNKNOWN && geo_srid == SRID_UNKNOWN)
-			gserialized_set_srid(gs, *tpoint_srid);
-		if (*tpoint_srid == SRID_UNKNOWN && geo_srid != SRID_UNKNOWN)
-			*tpoint_srid = geo_srid;
+		fast = point_parse_fast(&p, &srid, &hasz, &x, &y, &z) && *p == '@';
+		if (! fast)
+		{
+			p = *str;
+			fast = point_parse_hexewkb_fast(&p, &srid, &hasz, &x, &y, &z) &&
+				*p == '@';
+		}
+	}
+	if (fast)
+	{
+		/* Write the coordinates directly in the instant */
+		srid = tpointinst_parse_srid(basetype, srid, tpoint_srid);
+		*str = (char *) p + 1;
+		/* The next instruction will throw an exception if it fails */
+		TimestampTz t = timestamp_parse(str);
+		result = tpointinst_make(x, y, z, hasz, false, srid, t);
 	}
 	else
 	{
-		if (*tpoint_srid != SRID_UNKNOWN && geo_srid == SRID_DEFAULT)
-			gserialized_set_srid(gs, *tpoint_srid);
-		if (*tpoint_srid == SRID_UNKNOWN && geo_srid != SRID_DEFAULT)
-			*tpoint_srid = geo_srid;
+		/* The next instruction will throw an exception if it fails */
+		Datum geo = basetype_parse(str, basetype); 
+		GSERIALIZED *gs = (GSERIALIZED *)PG_DETOAST_DATUM(geo);
+		ensure_point_type(gs);
+		ensure_non_empty(gs);
+		ensure_has_not_M(gs);
+		int geo_srid = gserialized_get_srid(gs);
+		srid = tpointinst_parse_srid(basetype, geo_srid, tpoint_srid);
+		if (srid != geo_srid)
+			gserialized_set_srid(gs, srid);
+		/* The next instruction will throw an exception if it fails */
+		TimestampTz t = timestamp_parse(str);
+		result = temporalinst_make(PointerGetDatum(gs), t, basetype);
+		pfree(gs);
 	}
-	/* The next instruction will throw an exception if it fails */
-	TimestampTz t = timestamp_parse(str);
 	if (end)
 	{
 		/* Ensure there is no more input */
@@ -281,8 +515,53 @@ tpointinst_parse(char **str, Oid basetype, bool end, int *tpoint_srid)
 			ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 				errmsg("Could not parse temporal value")));
 	}
-	TemporalInst *result = temporalinst_make(PointerGetDatum(gs), t, basetype);
-	pfree(gs);
+	return result;
+}
+
+/*
+ * Parse a list of instants separated by commas in a single pass, collecting
+ * them in an array that is enlarged as needed
+ */
+static TemporalInst **
+tpointinst_parse_list(char **str, Oid basetype, int *tpoint_srid, int *count)
+{
+	int maxcount = 16;
+	TemporalInst **result = palloc(sizeof(TemporalInst *) * maxcount);
+	*count = 0;
+	do
+	{
+		if (*count == maxcount)
+		{
+			maxcount *= 2;
+			result = repalloc(result, sizeof(TemporalInst *) * maxcount);
+		}
+		result[(*count)++] = tpointinst_parse(str, basetype, false,
+			tpoint_srid);
+	} while (p_comma(str));
+	return result;
+}
+
+/*
+ * Parse the instants of an instant set or a sequence. When the SRID of the
+ * temporal point is given by an instant after the first one, the instants
+ * are parsed again so that all of them have this SRID.
+ */
+static TemporalInst **
+tpointinst_parse_instants(char **str, Oid basetype, int *tpoint_srid,
+	int *count)
+{
+	char *bak = *str;
+	int srid = *tpoint_srid;
+	TemporalInst **result = tpointinst_parse_list(str, basetype, tpoint_srid,
+		count);
+	if (*tpoint_srid != srid && *count > 1)
+	{
+		for (int i = 0; i < *count; i++)
+			pfree(result[i]);
+		pfree(result);
+		*str = bak;
+		result = tpointinst_parse_list(str, basetype, tpoint_srid, count);
+	}
 	return result;
 }
 
@@ -294,17 +573,9 @@ tpointi_parse(char **str, Oid basetype, int *tpoint_srid)
 	 * to call this function in the dispatch function tpoint_parse */
 	p_obrace(str);
 
-	/* First parsing */
-	char *bak = *str;
-	TemporalInst *inst = tpointinst_parse(str, basetype, false, tpoint_srid);
-	int count = 1;
-	while (p_comma(str)) 
-	{
-		count++;
-		pfree(inst);
-		inst = tpointinst_parse(str, basetype, false, tpoint_srid);
-	}
-	pfree(inst);
+	int count;
+	TemporalInst **insts = tpointinst_parse_instants(str, basetype,
+		tpoint_srid, &count);
 	if (!p_cbrace(str))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse temporal value")));
@@ -313,15 +584,6 @@ tpointi_parse(char **str, Oid basetype, int *tpoint_srid)
 	if (**str != 0)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse temporal value")));
-	/* Second parsing */
-	*str = bak;
-	TemporalInst **insts = palloc(sizeof(TemporalInst *) * count);
-	for (int i = 0; i < count; i++) 
-	{
-		p_comma(str);
-		insts[i] = tpointinst_parse(str, basetype, false, tpoint_srid);
-	}
-	p_cbrace(str);
 	TemporalI *result = temporali_from_temporalinstarr(insts, count);
 
 	for (int i = 0; i < count; i++)
@@ -343,17 +605,9 @@ tpointseq_parse(char **str, Oid basetype, bool linear, bool end, int *tpoint_sri
 	else if (p_oparen(str))
 		lower_inc = false;
 
-	/* First parsing */
-	char *bak = *str;
-	TemporalInst *inst = tpointinst_parse(str, basetype, false, tpoint_srid);
-	int count = 1;
-	while (p_comma(str)) 
-	{
-		count++;
-		pfree(inst);
-		inst = tpointinst_parse(str, basetype, false, tpoint_srid);
-	}
-	pfree(inst);
+	int count;
+	TemporalInst **insts = tpointinst_parse_instants(str, basetype,
+		tpoint_srid, &count);
 	if (p_cbracket(str))
 		upper_inc = true;
 	else if (p_cparen(str))
@@ -369,17 +623,6 @@ tpointseq_parse(char **str, Oid basetype, bool linear, bool end, int *tpoint_sri
 			ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 				errmsg("Could not parse temporal value")));
 	}
-	/* Second parsing */
-	*str = bak; 
-	TemporalInst **insts = palloc(sizeof(TemporalInst *) * count);
-	for (int i = 0; i < count; i++) 
-	{
-		p_comma(str);
-		insts[i] = tpointinst_parse(str, basetype, false, tpoint_srid);
-	}
-
-	p_cbracket(str);
-	p_cparen(str);
 
 	TemporalSeq *result = temporalseq_from_temporalinstarr(insts, 
 		count, lower_inc, upper_inc, linear, true);
@@ -391,6 +634,28 @@ tpointseq_parse(char **str, Oid basetype, bool linear, bool end, int *tpoint_sri
 	return result;
 }
 
+/* Parse a list of sequences separated by commas in a single pass */
+
+static TemporalSeq **
+tpointseq_parse_list(char **str, Oid basetype, bool linear, int *tpoint_srid,
+	int *count)
+{
+	int maxcount = 4;
+	TemporalSeq **result = palloc(sizeof(TemporalSeq *) * maxcount);
+	*count = 0;
+	do
+	{
+		if (*count == maxcount)
+		{
+			maxcount *= 2;
+			result = repalloc(result, sizeof(TemporalSeq *) * maxcount);
+		}
+		result[(*count)++] = tpointseq_parse(str, basetype, linear, false,
+			tpoint_srid);
+	} while (p_comma(str));
+	return result;
+}
+
 static TemporalS *
 tpoints_parse(char **str, Oid basetype, bool linear, int *tpoint_srid) 
 {
@@ -399,17 +664,20 @@ tpoints_parse(char **str, Oid basetype, bool linear, int *tpoint_srid)
 	 * to call this function in the dispatch function tpoint_parse */
 	p_obrace(str);
 
-	/* First parsing */
 	char *bak = *str;
-	TemporalSeq *seq = tpointseq_parse(str, basetype, linear, false, tpoint_srid);
-	int count = 1;
-	while (p_comma(str)) 
+	int srid = *tpoint_srid;
+	int count;
+	TemporalSeq **seqs = tpointseq_parse_list(str, basetype, linear,
+		tpoint_srid, &count);
+	if (*tpoint_srid != srid && count > 1)
 	{
-		count++;
-		pfree(seq);
-		seq = tpointseq_parse(str, basetype, linear, false, tpoint_srid);
+		/* The SRID is given by a sequence after the first one */
+		for (int i = 0; i < count; i++)
+			pfree(seqs[i]);
+		pfree(seqs);
+		*str = bak;
+		seqs = tpointseq_parse_list(str, basetype, linear, tpoint_srid, &count);
 	}
-	pfree(seq);
 	if (!p_cbrace(str))
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse temporal value")));
@@ -418,15 +686,6 @@ tpoints_parse(char **str, Oid basetype, bool linear, int *tpoint_srid)
 	if (**str != 0)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse temporal value")));
-	/* Second parsing */
-	*str = bak;
-	TemporalSeq **seqs = palloc(sizeof(TemporalSeq *) * count);
-	for (int i = 0; i < count; i++) 
-	{
-		p_comma(str);
-		seqs[i] = tpointseq_parse(str, basetype, linear, false, tpoint_srid);
-	}
-	p_cbrace(str);
 	TemporalS *result = temporals_from_temporalseqarr(seqs, count, 
 		linear, true);
 
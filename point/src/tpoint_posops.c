@@ -440,7 +440,7 @@ left_geom_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -465,7 +465,7 @@ overleft_geom_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -490,7 +490,7 @@ right_geom_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -515,7 +515,7 @@ overright_geom_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -540,7 +540,7 @@ below_geom_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -565,7 +565,7 @@ overbelow_geom_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -590,7 +590,7 @@ above_geom_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -615,7 +615,7 @@ overabove_geom_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -641,7 +641,7 @@ front_geom_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -667,7 +667,7 @@ overfront_geom_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -692,7 +692,7 @@ back_geom_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -718,7 +718,7 @@ overback_geom_tpoint(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box1, gs))
+	if (!geo_to_stbox_fn(&box1, gs, fcinfo, 0))
 	{
 		PG_FREE_IF_COPY(gs, 0);
 		PG_FREE_IF_COPY(temp, 1);
@@ -746,7 +746,7 @@ left_tpoint_geom(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -771,7 +771,7 @@ overleft_tpoint_geom(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -796,7 +796,7 @@ right_tpoint_geom(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -821,7 +821,7 @@ overright_tpoint_geom(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -846,7 +846,7 @@ below_tpoint_geom(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -871,7 +871,7 @@ overbelow_tpoint_geom(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -896,7 +896,7 @@ above_tpoint_geom(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -921,7 +921,7 @@ overabove_tpoint_geom(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -947,7 +947,7 @@ front_tpoint_geom(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -973,7 +973,7 @@ overfront_tpoint_geom(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -999,7 +999,7 @@ back_tpoint_geom(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -1025,7 +1025,7 @@ overback_tpoint_geom(PG_FUNCTION_ARGS)
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	if (!geo_to_stbox_fn(&box2, gs, fcinfo, 1))
 	{
 		PG_FREE_IF_COPY(temp, 0);
 		PG_FREE_IF_COPY(gs, 1);
@@ -1049,12 +1049,10 @@ left_stbox_tpoint(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(0);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = left_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1066,12 +1064,10 @@ overleft_stbox_tpoint(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(0);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = overleft_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1083,12 +1079,10 @@ right_stbox_tpoint(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(0);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = right_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1100,12 +1094,10 @@ overright_stbox_tpoint(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(0);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = overright_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1117,12 +1109,10 @@ below_stbox_tpoint(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(0);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = below_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1134,12 +1124,10 @@ overbelow_stbox_tpoint(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(0);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = overbelow_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1151,12 +1139,10 @@ above_stbox_tpoint(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(0);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = above_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1168,12 +1154,10 @@ overabove_stbox_tpoint(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(0);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = overabove_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1183,15 +1167,13 @@ PGDLLEXPORT Datum
 front_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool hasz = MOBDB_FLAGS_GET_Z(box->flags) && MOBDB_FLAGS_GET_Z(box1.flags);
 	bool result = false;
 	if (hasz)
 		result = front_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 1);
 	if (!hasz)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1203,15 +1185,13 @@ PGDLLEXPORT Datum
 overfront_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool hasz = MOBDB_FLAGS_GET_Z(box->flags) && MOBDB_FLAGS_GET_Z(box1.flags);
 	bool result = false;
 	if (hasz)
 		result = overfront_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 1);
 	if (!hasz)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1223,15 +1203,13 @@ PGDLLEXPORT Datum
 back_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool hasz = MOBDB_FLAGS_GET_Z(box->flags) && MOBDB_FLAGS_GET_Z(box1.flags);
 	bool result = false;
 	if (hasz)
 		result = back_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 1);
 	if (!hasz)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1243,15 +1221,13 @@ PGDLLEXPORT Datum
 overback_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool hasz = MOBDB_FLAGS_GET_Z(box->flags) && MOBDB_FLAGS_GET_Z(box1.flags);
 	bool result = false;
 	if (hasz)
 		result = overback_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 1);
 	if (!hasz)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1263,17 +1239,15 @@ PGDLLEXPORT Datum
 before_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	bool hast = MOBDB_FLAGS_GET_T(box->flags);
 	bool result = false;
 	if (hast)
 	{
 		STBOX box1;
 		memset(&box1, 0, sizeof(STBOX));
-		temporal_bbox(&box1, temp);
+		temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 		result = before_stbox_stbox_internal(box, &box1);
 	}
-	PG_FREE_IF_COPY(temp, 1);
 	if (!hast)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1285,17 +1259,15 @@ PGDLLEXPORT Datum
 overbefore_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	bool hast = MOBDB_FLAGS_GET_T(box->flags);
 	bool result = false;
 	if (hast)
 	{
 		STBOX box1;
 		memset(&box1, 0, sizeof(STBOX));
-		temporal_bbox(&box1, temp);
+		temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 		result = overbefore_stbox_stbox_internal(box, &box1);
 	}
-	PG_FREE_IF_COPY(temp, 1);
 	if (!hast)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1307,17 +1279,15 @@ PGDLLEXPORT Datum
 after_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	bool hast = MOBDB_FLAGS_GET_T(box->flags);
 	bool result = false;
 	if (hast)
 	{
 		STBOX box1;
 		memset(&box1, 0, sizeof(STBOX));
-		temporal_bbox(&box1, temp);
+		temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 		result = after_stbox_stbox_internal(box, &box1);
 	}
-	PG_FREE_IF_COPY(temp, 1);
 	if (!hast)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1329,17 +1299,15 @@ PGDLLEXPORT Datum
 overafter_stbox_tpoint(PG_FUNCTION_ARGS)
 {
 	STBOX *box = PG_GETARG_STBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	bool hast = MOBDB_FLAGS_GET_T(box->flags);
 	bool result = false;
 	if (hast)
 	{
 		STBOX box1;
 		memset(&box1, 0, sizeof(STBOX));
-		temporal_bbox(&box1, temp);
+		temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 		result = overafter_stbox_stbox_internal(box, &box1);
 	}
-	PG_FREE_IF_COPY(temp, 1);
 	if (!hast)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1356,12 +1324,10 @@ left_tpoint_stbox(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = left_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1373,12 +1339,10 @@ overleft_tpoint_stbox(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = overleft_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1390,12 +1354,10 @@ right_tpoint_stbox(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = right_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1407,12 +1369,10 @@ overright_tpoint_stbox(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = overright_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1424,12 +1384,10 @@ below_tpoint_stbox(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = below_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1441,12 +1399,10 @@ overbelow_tpoint_stbox(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = overbelow_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1458,12 +1414,10 @@ above_tpoint_stbox(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = above_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1475,12 +1429,10 @@ overabove_tpoint_stbox(PG_FUNCTION_ARGS)
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	if (! MOBDB_FLAGS_GET_X(box->flags))
 		PG_RETURN_NULL();
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = overabove_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1489,16 +1441,14 @@ PG_FUNCTION_INFO_V1(front_tpoint_stbox);
 PGDLLEXPORT Datum
 front_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool hasz = MOBDB_FLAGS_GET_Z(box->flags) && MOBDB_FLAGS_GET_Z(box1.flags);
 	bool result = false;
 	if (hasz)
 		result = front_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	if (!hasz)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1509,16 +1459,14 @@ PG_FUNCTION_INFO_V1(overfront_tpoint_stbox);
 PGDLLEXPORT Datum
 overfront_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool hasz = MOBDB_FLAGS_GET_Z(box->flags) && MOBDB_FLAGS_GET_Z(box1.flags);
 	bool result = false;
 	if (hasz)
 		result = overfront_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	if (!hasz)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1529,16 +1477,14 @@ PG_FUNCTION_INFO_V1(back_tpoint_stbox);
 PGDLLEXPORT Datum
 back_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool hasz = MOBDB_FLAGS_GET_Z(box->flags) && MOBDB_FLAGS_GET_Z(box1.flags);
 	bool result = false;
 	if (hasz)
 		result = back_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	if (!hasz)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1549,16 +1495,14 @@ PG_FUNCTION_INFO_V1(overback_tpoint_stbox);
 PGDLLEXPORT Datum
 overback_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool hasz = MOBDB_FLAGS_GET_Z(box->flags) && MOBDB_FLAGS_GET_Z(box1.flags);
 	bool result = false;
 	if (hasz)
 		result = overback_stbox_stbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	if (!hasz)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1569,7 +1513,6 @@ PG_FUNCTION_INFO_V1(before_tpoint_stbox);
 PGDLLEXPORT Datum
 before_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	bool hast = MOBDB_FLAGS_GET_T(box->flags);
 	bool result = false;
@@ -1577,10 +1520,9 @@ before_tpoint_stbox(PG_FUNCTION_ARGS)
 	{
 		STBOX box1;
 		memset(&box1, 0, sizeof(STBOX));
-		temporal_bbox(&box1, temp);
+		temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 		result = before_stbox_stbox_internal(&box1, box);
 	}
-	PG_FREE_IF_COPY(temp, 0);
 	if (!hast)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1591,7 +1533,6 @@ PG_FUNCTION_INFO_V1(overbefore_tpoint_stbox);
 PGDLLEXPORT Datum
 overbefore_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	bool hast = MOBDB_FLAGS_GET_T(box->flags);
 	bool result = false;
@@ -1599,10 +1540,9 @@ overbefore_tpoint_stbox(PG_FUNCTION_ARGS)
 	{
 		STBOX box1;
 		memset(&box1, 0, sizeof(STBOX));
-		temporal_bbox(&box1, temp);
+		temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 		result = overbefore_stbox_stbox_internal(&box1, box);
 	}
-	PG_FREE_IF_COPY(temp, 0);
 	if (!hast)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1613,7 +1553,6 @@ PG_FUNCTION_INFO_V1(after_tpoint_stbox);
 PGDLLEXPORT Datum
 after_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	bool hast = MOBDB_FLAGS_GET_T(box->flags);
 	bool result = false;
@@ -1621,10 +1560,9 @@ after_tpoint_stbox(PG_FUNCTION_ARGS)
 	{
 		STBOX box1;
 		memset(&box1, 0, sizeof(STBOX));
-		temporal_bbox(&box1, temp);
+		temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 		result = after_stbox_stbox_internal(&box1, box);
 	}
-	PG_FREE_IF_COPY(temp, 0);
 	if (!hast)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1635,7 +1573,6 @@ PG_FUNCTION_INFO_V1(overafter_tpoint_stbox);
 PGDLLEXPORT Datum
 overafter_tpoint_stbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	STBOX *box = PG_GETARG_STBOX_P(1);
 	bool hast = MOBDB_FLAGS_GET_T(box->flags);
 	bool result = false;
@@ -1643,10 +1580,9 @@ overafter_tpoint_stbox(PG_FUNCTION_ARGS)
 	{
 		STBOX box1;
 		memset(&box1, 0, sizeof(STBOX));
-		temporal_bbox(&box1, temp);
+		temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 		result = overafter_stbox_stbox_internal(&box1, box);
 	}
-	PG_FREE_IF_COPY(temp, 0);
 	if (!hast)
 		PG_RETURN_NULL();
 	PG_RETURN_BOOL(result);
@@ -1904,16 +1840,12 @@ PG_FUNCTION_INFO_V1(before_tpoint_tpoint);
 PGDLLEXPORT Datum
 before_tpoint_tpoint(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = before_stbox_stbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1922,16 +1854,12 @@ PG_FUNCTION_INFO_V1(overbefore_tpoint_tpoint);
 PGDLLEXPORT Datum
 overbefore_tpoint_tpoint(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = overbefore_stbox_stbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1940,16 +1868,12 @@ PG_FUNCTION_INFO_V1(after_tpoint_tpoint);
 PGDLLEXPORT Datum
 after_tpoint_tpoint(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = after_stbox_stbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1958,16 +1882,12 @@ PG_FUNCTION_INFO_V1(overafter_tpoint_tpoint);
 PGDLLEXPORT Datum
 overafter_tpoint_tpoint(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	STBOX box1, box2;
 	memset(&box1, 0, sizeof(STBOX));
 	memset(&box2, 0, sizeof(STBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = overafter_stbox_stbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -14,9 +14,13 @@
 
 #include <assert.h>
 #include <float.h>
+#include <math.h>
+#include <access/htup_details.h>
+#include <utils/syscache.h>
 
 #include "period.h"
 #include "temporal_selfuncs.h"
+#include "time_selfuncs.h"
 #include "stbox.h"
 #include "tpoint.h"
 #include "tpoint_boxops.h"
@@ -959,12 +963,310 @@ tpoint_sel(PG_FUNCTION_ARGS)
 	PG_RETURN_FLOAT8(selec);
 }
 
+/*****************************************************************************
+ * Join selectivity
+ *****************************************************************************/
+
+/*
+ * Returns a copy of the N-dimensional histogram of a column, or NULL if the
+ * column has no such statistics
+ */
+static ND_STATS *
+tpoint_nd_stats(VariableStatData *vardata)
+{
+	ND_STATS *result;
+	AttStatsSlot sslot;
+
+	/* Currently PostGIS does not set the associated staopN so we
+	 * can pass InvalidOid */
+	if (!(HeapTupleIsValid(vardata->statsTuple) &&
+		  get_attstatsslot(&sslot, vardata->statsTuple, STATISTIC_KIND_ND, 
+			InvalidOid, ATTSTATSSLOT_NUMBERS)))
+		return NULL;
+
+	/* Clone the stats here so we can release the attstatsslot immediately */
+	result = palloc(sizeof(float4) * sslot.nnumbers);
+	memcpy(result, sslot.numbers, sizeof(float4) * sslot.nnumbers);
+	free_attstatsslot(&sslot);
+	return result;
+}
+
+/*
+ * Given two statistics histograms, what is the selectivity of a join driven
+ * by the && operator on their spatial dimensions?
+ *
+ * Join selectivity is defined as the number of rows returned by the join
+ * operator divided by the number of rows that an unconstrained join would 
+ * return (nrows1*nrows2). To get the estimate, we iterate through the cells 
+ * of the smaller histogram that overlap the extent of the larger one, and 
+ * for each cell we sum the products of its count with the counts of the 
+ * cells of the other histogram it overlaps, pro-rated by the overlap ratio.
+ *
+ * Function adapted from PostGIS function estimate_join_selectivity in file 
+ * gserialized_estimate.c
+ */
+static float8
+calc_geo_joinselectivity(const ND_STATS *s1, const ND_STATS *s2)
+{
+	int ncells1, ncells2;
+	int ndims1, ndims2, ndims;
+	double ntuples_max;
+	ND_IBOX ibox1, ibox2;
+	int at1[ND_DIMS];
+	int at2[ND_DIMS];
+	double min1[ND_DIMS];
+	double cellsize1[ND_DIMS];
+	double min2[ND_DIMS];
+	double cellsize2[ND_DIMS];
+	int d;
+	double val = 0;
+	float8 selectivity;
+
+	/* Drive the summation loop with the smaller histogram */
+	ncells1 = (int) roundf(s1->histogram_cells);
+	ncells2 = (int) roundf(s2->histogram_cells);
+	if (ncells1 > ncells2)
+	{
+		const ND_STATS *stats_tmp = s1;
+		s1 = s2;
+		s2 = stats_tmp;
+	}
+
+	ndims1 = (int) roundf(s1->ndims);
+	ndims2 = (int) roundf(s2->ndims);
+	ndims = Max(ndims1, ndims2);
+
+	/* If the extents do not intersect, the join is very very selective */
+	if (! nd_box_intersects(&(s1->extent), &(s2->extent), ndims))
+		return 0.0;
+
+	/* Find the cells of the smaller histogram that overlap the larger one */
+	if (! nd_box_overlap(s1, &(s2->extent), &ibox1))
+		return FALLBACK_ND_JOINSEL;
+
+	/* Work out some measurements of the histograms */
+	for (d = 0; d < ndims1; d++)
+	{
+		at1[d] = ibox1.min[d];
+		min1[d] = s1->extent.min[d];
+		cellsize1[d] = (s1->extent.max[d] - s1->extent.min[d]) / s1->size[d];
+	}
+	for (d = 0; d < ndims2; d++)
+	{
+		min2[d] = s2->extent.min[d];
+		cellsize2[d] = (s2->extent.max[d] - s2->extent.min[d]) / s2->size[d];
+	}
+
+	/* For each affected cell of s1... */
+	do
+	{
+		double val1;
+		ND_BOX nd_cell1;
+
+		/* Construct the physical coordinates of this cell */
+		nd_box_init(&nd_cell1);
+		for (d = 0; d < ndims1; d++)
+		{
+			nd_cell1.min[d] = (float4) (min1[d] + (at1[d]+0) * cellsize1[d]);
+			nd_cell1.max[d] = (float4) (min1[d] + (at1[d]+1) * cellsize1[d]);
+		}
+
+		/* Find the cells of s2 that cell1 overlaps */
+		nd_box_overlap(s2, &nd_cell1, &ibox2);
+		for (d = 0; d < ndims2; d++)
+			at2[d] = ibox2.min[d];
+
+		val1 = s1->value[nd_stats_value_index(s1, at1)];
+
+		/* For each overlapped cell of s2... */
+		do
+		{
+			double ratio2, val2;
+			ND_BOX nd_cell2;
+
+			nd_box_init(&nd_cell2);
+			for (d = 0; d < ndims2; d++)
+			{
+				nd_cell2.min[d] = (float4) (min2[d] + (at2[d]+0) * cellsize2[d]);
+				nd_cell2.max[d] = (float4) (min2[d] + (at2[d]+1) * cellsize2[d]);
+			}
+
+			/* Multiply the cell counts, scaled by overlap ratio */
+			ratio2 = nd_box_ratio_overlaps(&nd_cell1, &nd_cell2, ndims);
+			val2 = s2->value[nd_stats_value_index(s2, at2)];
+			val += val1 * (val2 * ratio2);
+		}
+		while (nd_increment(&ibox2, ndims2, at2));
+	}
+	while (nd_increment(&ibox1, ndims1, at1));
+
+	/* Scale the count of the samples up to a full table estimate */
+	val *= (s1->table_features / s1->sample_features);
+	val *= (s2->table_features / s2->sample_features);
+
+	/* The selectivity is the estimated number of rows divided by the 
+	 * maximum number of rows that the join can return */
+	ntuples_max = s1->table_features * s2->table_features;
+	selectivity = val / ntuples_max;
+
+	/* Guard against over-estimates and crazy numbers */
+	if (isnan(selectivity) || ! isfinite(selectivity) || selectivity < 0.0)
+		selectivity = FALLBACK_ND_JOINSEL;
+	else if (selectivity > 1.0)
+		selectivity = 1.0;
+
+	return selectivity;
+}
+
+/*
+ * Returns the fraction of non-null values of a column
+ */
+static double
+tpoint_notnull_frac(VariableStatData *vardata)
+{
+	if (!HeapTupleIsValid(vardata->statsTuple))
+		return 1.0;
+	return 1.0 - ((Form_pg_statistic) GETSTRUCT(vardata->statsTuple))->stanullfrac;
+}
+
+/*
+ * Estimate the join selectivity of the operators for temporal points by
+ * comparing the statistics of the two columns. The selectivity of the 
+ * spatial dimension is computed from their N-dimensional histograms and
+ * the one of the time dimension from their histograms of period bounds,
+ * and both are multiplied as for the restriction selectivity. As for the
+ * restriction selectivity, the statistics do not allow us to differentiate
+ * between the bounding box operators, and thus all of them are estimated as
+ * the overlaps operator. Default estimates are used for the position 
+ * operators.
+ */
+
 PG_FUNCTION_INFO_V1(tpoint_joinsel);
 
 PGDLLEXPORT Datum
 tpoint_joinsel(PG_FUNCTION_ARGS)
 {
-	PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
+	PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+	Oid operator = PG_GETARG_OID(1);
+	List *args = (List *) PG_GETARG_POINTER(2);
+	JoinType jointype = (JoinType) PG_GETARG_INT16(3);
+	SpecialJoinInfo *sjinfo = (SpecialJoinInfo *) PG_GETARG_POINTER(4);
+	VariableStatData vardata1, vardata2;
+	bool join_is_reversed, found = false;
+	ND_STATS *nd_stats1, *nd_stats2;
+	CachedOp cachedOp;
+	Selectivity selec = 1.0;
+
+	/*
+	 * Get enumeration value associated to the operator
+	 */
+	if (!tpoint_cachedop(operator, &cachedOp))
+		PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
+
+	/* Only bounding box operators on inner joins are estimated */
+	if (jointype != JOIN_INNER || !(cachedOp == OVERLAPS_OP || 
+		cachedOp == CONTAINS_OP || cachedOp == CONTAINED_OP || 
+		cachedOp == SAME_OP))
+		PG_RETURN_FLOAT8(default_tpoint_selectivity(cachedOp));
+
+	get_join_variables(root, args, sjinfo, &vardata1, &vardata2, 
+		&join_is_reversed);
+
+	/*
+	 * Estimate selectivity for the spatial dimension, which already takes
+	 * into account the null values
+	 */
+	nd_stats1 = tpoint_nd_stats(&vardata1);
+	nd_stats2 = tpoint_nd_stats(&vardata2);
+	if (nd_stats1 != NULL && nd_stats2 != NULL)
+	{
+		selec *= calc_geo_joinselectivity(nd_stats1, nd_stats2);
+		found = true;
+	}
+	if (nd_stats1 != NULL)
+		pfree(nd_stats1);
+	if (nd_stats2 != NULL)
+		pfree(nd_stats2);
+
+	/*
+	 * Estimate selectivity for the time dimension, which is computed for the
+	 * non-null values
+	 */
+	double time_selec = calc_period_hist_joinselectivity(&vardata1, &vardata2);
+	if (time_selec >= 0.0)
+	{
+		selec *= time_selec;
+		if (!found)
+			selec *= tpoint_notnull_frac(&vardata1) * 
+				tpoint_notnull_frac(&vardata2);
+		found = true;
+	}
+
+	ReleaseVariableStats(vardata1);
+	ReleaseVariableStats(vardata2);
+	if (!found)
+		PG_RETURN_FLOAT8(default_tpoint_selectivity(cachedOp));
+	CLAMP_PROBABILITY(selec);
+	PG_RETURN_FLOAT8(selec);
+}
+
+/*****************************************************************************/
+
+/*
+ * Returns the extent of a temporal point column estimated from the 
+ * statistics collected by ANALYZE, which avoids scanning the table. As for
+ * the PostGIS function ST_EstimatedExtent, the spatial extent is the one of
+ * the N-dimensional histogram, which excludes the outliers of the sample.
+ * Returns NULL if the column has not been analyzed.
+ */
+
+PG_FUNCTION_INFO_V1(tpoint_estimated_stbox);
+
+PGDLLEXPORT Datum
+tpoint_estimated_stbox(PG_FUNCTION_ARGS)
+{
+	Oid relid = PG_GETARG_OID(0);
+	text *attname = PG_GETARG_TEXT_P(1);
+	Oid atttypid;
+	HeapTuple stats_tuple = temporal_stats_tuple(relid, attname, &atttypid);
+	if (atttypid != type_oid(T_TGEOMPOINT) && 
+		atttypid != type_oid(T_TGEOGPOINT))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The column must be a temporal point")));
+	if (stats_tuple == NULL)
+		PG_RETURN_NULL();
+
+	STBOX *result = palloc0(sizeof(STBOX));
+	AttStatsSlot sslot;
+	if (get_attstatsslot(&sslot, stats_tuple, STATISTIC_KIND_ND, InvalidOid,
+			ATTSTATSSLOT_NUMBERS))
+	{
+		ND_STATS *nd_stats = (ND_STATS *) sslot.numbers;
+		result->xmin = nd_stats->extent.min[X_DIM];
+		result->xmax = nd_stats->extent.max[X_DIM];
+		result->ymin = nd_stats->extent.min[Y_DIM];
+		result->ymax = nd_stats->extent.max[Y_DIM];
+		if (nd_stats->ndims > 2)
+		{
+			result->zmin = nd_stats->extent.min[Z_DIM];
+			result->zmax = nd_stats->extent.max[Z_DIM];
+			MOBDB_FLAGS_SET_Z(result->flags, true);
+		}
+		MOBDB_FLAGS_SET_X(result->flags, true);
+		MOBDB_FLAGS_SET_GEODETIC(result->flags, 
+			atttypid == type_oid(T_TGEOGPOINT));
+		free_attstatsslot(&sslot);
+	}
+	if (temporal_stats_time_extent(stats_tuple, &result->tmin, &result->tmax))
+		MOBDB_FLAGS_SET_T(result->flags, true);
+	ReleaseSysCache(stats_tuple);
+
+	if (! MOBDB_FLAGS_GET_X(result->flags) && ! MOBDB_FLAGS_GET_T(result->flags))
+	{
+		pfree(result);
+		PG_RETURN_NULL();
+	}
+	PG_RETURN_POINTER(result);
 }
 
 /*****************************************************************************/
@@ -14,19 +14,32 @@
 
 #include <assert.h>
 #include <float.h>
+#include <math.h>
+#include <funcapi.h>
+#include <miscadmin.h>
+#include <utils/array.h>
 #include <utils/builtins.h>
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
+#include <utils/tuplestore.h>
 
 #include "periodset.h"
 #include "timeops.h"
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_cache.h"
+#include "temporal_expanded.h"
+#include "temporal_probes.h"
+#include "temporal_stats.h"
 #include "lifting.h"
+#include "temporal_boxops.h"
 #include "tnumber_mathfuncs.h"
 #include "tpoint.h"
 #include "tpoint_boxops.h"
 #include "tpoint_distance.h"
+#include "tpoint_batch.h"
+#include "tpoint_segment.h"
 
 /*****************************************************************************
  * Parameter tests
@@ -232,12 +245,79 @@ geometry_serialize(LWGEOM *geom)
 	return result;
 }
 
+/*
+ * Write a point without bounding box in serialized form. The size of the
+ * buffer must be at least the one given by gspoint_size.
+ */
+
+static size_t
+gspoint_size(bool hasz)
+{
+	/* Header, type and number of points, and coordinates */
+	return 8 + 8 + (hasz ? 3 : 2) * sizeof(double);
+}
+
+static void
+gspoint_write(GSERIALIZED *gs, double x, double y, double z, bool hasz,
+	bool geodetic, int32 srid)
+{
+	SET_VARSIZE(gs, gspoint_size(hasz));
+	gserialized_set_srid(gs, srid);
+	gs->flags = gflags(hasz, false, geodetic);
+	uint32_t *header = (uint32_t *) gs->data;
+	header[0] = POINTTYPE;
+	header[1] = 1;
+	double *coords = (double *) (gs->data + 8);
+	coords[0] = x;
+	coords[1] = y;
+	if (hasz)
+		coords[2] = z;
+}
+
+/* Serialize a point without building an LWGEOM */
+
+GSERIALIZED *
+gspoint_make(double x, double y, double z, bool hasz, bool geodetic,
+	int32 srid)
+{
+	GSERIALIZED *result = palloc0(gspoint_size(hasz));
+	gspoint_write(result, x, y, z, hasz, geodetic, srid);
+	return result;
+}
+
+/*
+ * Construct a temporal instant point writing the coordinates directly in
+ * the instant. This is equivalent to calling temporalinst_make with the
+ * result of gspoint_make.
+ */
+TemporalInst *
+tpointinst_make(double x, double y, double z, bool hasz, bool geodetic,
+	int32 srid, TimestampTz t)
+{
+	size_t value_offset = double_pad(sizeof(TemporalInst));
+	size_t size = value_offset + double_pad(gspoint_size(hasz));
+	TemporalInst *result = palloc0(size);
+	gspoint_write((GSERIALIZED *) ((char *) result + value_offset), x, y, z,
+		hasz, geodetic, srid);
+	result->duration = TEMPORALINST;
+	result->valuetypid = geodetic ? type_oid(T_GEOGRAPHY) : 
+		type_oid(T_GEOMETRY);
+	result->t = t;
+	SET_VARSIZE(result, size);
+	MOBDB_FLAGS_SET_BYVAL(result->flags, false);
+	MOBDB_FLAGS_SET_LINEAR(result->flags, true);
+	MOBDB_FLAGS_SET_Z(result->flags, hasz);
+	MOBDB_FLAGS_SET_GEODETIC(result->flags, geodetic);
+	return result;
+}
+
 /* Call to PostGIS external functions */
 
 static Datum
 datum_transform(Datum value, Datum srid)
 {
-	return call_function2(transform, value, srid);
+	static FmgrInfo flinfo;
+	return call_function2_cached(&flinfo, transform, value, srid);
 }
 
 static Datum
@@ -356,6 +436,8 @@ tpointseq_set_srid(TemporalSeq *seq, int32 srid)
 		GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(temporalinst_value(inst));
 		gserialized_set_srid(gs, srid);
 	}
+	/* The geodetic length depends on the spheroid of the SRID */
+	temporalseq_update_summary(result);
 	return result;
 }
 
@@ -363,16 +445,16 @@ static TemporalS *
 tpoints_set_srid(TemporalS *ts, int32 srid)
 {
 	TemporalS *result = temporals_copy(ts);
-	for (int i = 0; i < ts->count; i++)
+	TemporalInstIterator it;
+	TemporalInst *inst;
+	temporalinst_iterator_init(&it, (Temporal *)result);
+	while ((inst = temporalinst_iterator_next(&it)) != NULL)
 	{
-		TemporalSeq *seq = temporals_seq_n(result, i);
-		for (int j = 0; j < seq->count; j++)
-		{
-			TemporalInst *inst = temporalseq_inst_n(seq, j);
-			GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(temporalinst_value(inst));
-			gserialized_set_srid(gs, srid);
-		}
+		GSERIALIZED *gs = (GSERIALIZED *)DatumGetPointer(temporalinst_value(inst));
+		gserialized_set_srid(gs, srid);
 	}
+	for (int i = 0; i < result->count; i++)
+		temporalseq_update_summary(temporals_seq_n(result, i));
 	return result;
 }
 
@@ -416,6 +498,129 @@ tgeompointinst_transform(TemporalInst *inst, Datum srid)
 		type_oid(T_GEOMETRY));
 }
 
+/*
+ * Transform an array of instants of a temporal geometry point with a single
+ * call to PostGIS. The points are gathered into one multipoint so that the
+ * projection between the two spatial reference systems is looked up once
+ * for the whole array instead of once per instant.
+ */
+static TemporalInst **
+tgeompointinstarr_transform(TemporalInst **instants, int count, int srid_in,
+	Datum srid)
+{
+	bool hasz = MOBDB_FLAGS_GET_Z(instants[0]->flags);
+	POINTARRAY *pa = ptarray_construct(hasz, false, count);
+	for (int i = 0; i < count; i++)
+	{
+		Datum value = temporalinst_value(instants[i]);
+		POINT4D p;
+		if (hasz)
+		{
+			POINT3DZ p3d = datum_get_point3dz(value);
+			p.x = p3d.x; p.y = p3d.y; p.z = p3d.z;
+		}
+		else
+		{
+			POINT2D p2d = datum_get_point2d(value);
+			p.x = p2d.x; p.y = p2d.y; p.z = 0;
+		}
+		p.m = 0;
+		ptarray_set_point4d(pa, i, &p);
+	}
+	LWMPOINT *mpoint = lwmpoint_construct(srid_in, pa);
+	GSERIALIZED *gs = geometry_serialize((LWGEOM *) mpoint);
+	Datum trans = datum_transform(PointerGetDatum(gs), srid);
+	LWMPOINT *mtrans = lwgeom_as_lwmpoint(lwgeom_from_gserialized(
+		(GSERIALIZED *) DatumGetPointer(trans)));
+
+	TemporalInst **result = palloc(sizeof(TemporalInst *) * count);
+	for (int i = 0; i < count; i++)
+	{
+		LWGEOM *point = (LWGEOM *) mtrans->geoms[i];
+		lwgeom_set_srid(point, DatumGetInt32(srid));
+		GSERIALIZED *gspoint = geometry_serialize(point);
+		result[i] = temporalinst_make(PointerGetDatum(gspoint), instants[i]->t,
+			type_oid(T_GEOMETRY));
+		pfree(gspoint);
+	}
+	lwmpoint_free(mpoint); ptarray_free(pa);
+	lwmpoint_free(mtrans);
+	pfree(gs); pfree(DatumGetPointer(trans));
+	return result;
+}
+
+static TemporalI *
+tgeompointi_transform(TemporalI *ti, Datum srid)
+{
+	int srid_in = tpoint_srid_internal((Temporal *) ti);
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
+	for (int i = 0; i < ti->count; i++)
+		instants[i] = temporali_inst_n(ti, i);
+	TemporalInst **transf = tgeompointinstarr_transform(instants, ti->count,
+		srid_in, srid);
+	TemporalI *result = temporali_from_temporalinstarr(transf, ti->count);
+	for (int i = 0; i < ti->count; i++)
+		pfree(transf[i]);
+	pfree(transf); pfree(instants);
+	return result;
+}
+
+static TemporalSeq *
+tgeompointseq_transform(TemporalSeq *seq, Datum srid)
+{
+	int srid_in = tpoint_srid_internal((Temporal *) seq);
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
+	for (int i = 0; i < seq->count; i++)
+		instants[i] = temporalseq_inst_n(seq, i);
+	TemporalInst **transf = tgeompointinstarr_transform(instants, seq->count,
+		srid_in, srid);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(transf,
+		seq->count, seq->period.lower_inc, seq->period.upper_inc,
+		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
+	for (int i = 0; i < seq->count; i++)
+		pfree(transf[i]);
+	pfree(transf); pfree(instants);
+	return result;
+}
+
+/*
+ * The instants of all the sequences are transformed together and the
+ * sequences are then rebuilt from consecutive slices of the result
+ */
+static TemporalS *
+tgeompoints_transform(TemporalS *ts, Datum srid)
+{
+	int srid_in = tpoint_srid_internal((Temporal *) ts);
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ts->totalcount);
+	int k = 0;
+	for (int i = 0; i < ts->count; i++)
+	{
+		TemporalSeq *seq = temporals_seq_n(ts, i);
+		for (int j = 0; j < seq->count; j++)
+			instants[k++] = temporalseq_inst_n(seq, j);
+	}
+	TemporalInst **transf = tgeompointinstarr_transform(instants, k,
+		srid_in, srid);
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
+	k = 0;
+	for (int i = 0; i < ts->count; i++)
+	{
+		TemporalSeq *seq = temporals_seq_n(ts, i);
+		sequences[i] = temporalseq_from_temporalinstarr(&transf[k],
+			seq->count, seq->period.lower_inc, seq->period.upper_inc,
+			MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
+		k += seq->count;
+	}
+	TemporalS *result = temporals_from_temporalseqarr(sequences, ts->count,
+		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
+	for (int i = 0; i < k; i++)
+		pfree(transf[i]);
+	for (int i = 0; i < ts->count; i++)
+		pfree(sequences[i]);
+	pfree(transf); pfree(sequences); pfree(instants);
+	return result;
+}
+
 PG_FUNCTION_INFO_V1(tpoint_transform);
 
 PGDLLEXPORT Datum
@@ -423,8 +628,18 @@ tpoint_transform(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Datum srid = PG_GETARG_DATUM(1);
-	Temporal *result = tfunc2_temporal(temp, srid, &datum_transform,
-		type_oid(T_GEOMETRY));
+	Temporal *result;
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+		result = (Temporal *) tgeompointinst_transform((TemporalInst *) temp,
+			srid);
+	else if (temp->duration == TEMPORALI)
+		result = (Temporal *) tgeompointi_transform((TemporalI *) temp, srid);
+	else if (temp->duration == TEMPORALSEQ)
+		result = (Temporal *) tgeompointseq_transform((TemporalSeq *) temp,
+			srid);
+	else /* temp->duration == TEMPORALS */
+		result = (Temporal *) tgeompoints_transform((TemporalS *) temp, srid);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_POINTER(result);
 }
@@ -435,6 +650,173 @@ tpoint_transform(PG_FUNCTION_ARGS)
  * since the geography point keeps a bounding box
  *****************************************************************************/
 
+/*
+ * The serialized points of a temporal geometry point and of a temporal
+ * geography point only differ in their SRID and their geodetic flag. The
+ * conversion between the two copies the instants and rewrites these fields
+ * in place instead of casting each point. The precomputed trajectory of a
+ * sequence is cast once instead of being recomputed from the converted
+ * points, and the bounding box is computed from it as in the constructor of
+ * sequences. Points having a bounding box and, when converting to geography,
+ * points outside the range [-180 -90, 180 90], which PostGIS coerces into 
+ * range, are left to the casts of PostGIS.
+ */
+
+/* Can the point of the instant be converted in place? */
+
+static bool
+tpointinst_convertible(TemporalInst *inst, bool geodetic)
+{
+	Datum value = temporalinst_value(inst);
+	if (FLAGS_GET_BBOX(((GSERIALIZED *) DatumGetPointer(value))->flags))
+		return false;
+	if (! geodetic)
+		return true;
+	POINT2D point = datum_get_point2d(value);
+	return point.x >= -180.0 && point.x <= 180.0 &&
+		point.y >= -90.0 && point.y <= 90.0;
+}
+
+static bool
+tpoint_convertible(Temporal *temp, bool geodetic)
+{
+	TemporalInstIterator it;
+	TemporalInst *inst;
+	temporalinst_iterator_init(&it, temp);
+	while ((inst = temporalinst_iterator_next(&it)) != NULL)
+		if (! tpointinst_convertible(inst, geodetic))
+			return false;
+	return true;
+}
+
+/* Rewrite in place the SRID and the geodetic flag of an instant */
+
+static void
+tpointinst_set_geodetic(TemporalInst *inst, Oid valuetypid, int srid,
+	bool geodetic)
+{
+	GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(temporalinst_value(inst));
+	gserialized_set_srid(gs, srid);
+	FLAGS_SET_GEODETIC(gs->flags, geodetic);
+	inst->valuetypid = valuetypid;
+	MOBDB_FLAGS_SET_GEODETIC(inst->flags, geodetic);
+}
+
+static TemporalInst *
+tpointinst_convert_geodetic(TemporalInst *inst, int srid, bool geodetic)
+{
+	TemporalInst *result = temporalinst_copy(inst);
+	tpointinst_set_geodetic(result, 
+		type_oid(geodetic ? T_GEOGRAPHY : T_GEOMETRY), srid, geodetic);
+	return result;
+}
+
+static TemporalI *
+tpointi_convert_geodetic(TemporalI *ti, int srid, bool geodetic)
+{
+	Oid valuetypid = type_oid(geodetic ? T_GEOGRAPHY : T_GEOMETRY);
+	TemporalI *result = temporali_copy(ti);
+	result->valuetypid = valuetypid;
+	MOBDB_FLAGS_SET_GEODETIC(result->flags, geodetic);
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
+	for (int i = 0; i < ti->count; i++)
+	{
+		instants[i] = temporali_inst_n(result, i);
+		tpointinst_set_geodetic(instants[i], valuetypid, srid, geodetic);
+	}
+	/* The box of a geography is computed on geocentric coordinates */
+	STBOX *box = temporali_bbox_ptr(result);
+	memset(box, 0, sizeof(STBOX));
+	temporali_make_bbox(box, instants, ti->count);
+	pfree(instants);
+	return result;
+}
+
+static TemporalSeq *
+tpointseq_convert_geodetic(TemporalSeq *seq, int srid, bool geodetic)
+{
+	Oid valuetypid = type_oid(geodetic ? T_GEOGRAPHY : T_GEOMETRY);
+	/* The trajectory, if any, is the last component of the sequence and 
+	 * its size may change */
+	bool hastraj = ! MOBDB_FLAGS_GET_NOTRAJ(seq->flags);
+	size_t prefix = VARSIZE(seq), size = VARSIZE(seq);
+	Datum traj = 0; /* keep compiler quiet */
+	if (hastraj)
+	{
+		Datum traj1 = tpointseq_trajectory(seq);
+		prefix = (char *) DatumGetPointer(traj1) - (char *) seq;
+		traj = geodetic ? geom_to_geog(traj1) : geog_to_geom(traj1);
+		size = prefix + double_pad(VARSIZE(DatumGetPointer(traj)));
+	}
+	TemporalSeq *result = palloc0(size);
+	memcpy(result, seq, prefix);
+	SET_VARSIZE(result, size);
+	result->valuetypid = valuetypid;
+	MOBDB_FLAGS_SET_GEODETIC(result->flags, geodetic);
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
+	for (int i = 0; i < seq->count; i++)
+	{
+		instants[i] = temporalseq_inst_n(result, i);
+		tpointinst_set_geodetic(instants[i], valuetypid, srid, geodetic);
+	}
+	/* The box of a geography is computed on geocentric coordinates */
+	STBOX *box = temporalseq_bbox_ptr(result);
+	memset(box, 0, sizeof(STBOX));
+	if (hastraj)
+	{
+		memcpy((char *) result + prefix, DatumGetPointer(traj),
+			VARSIZE(DatumGetPointer(traj)));
+		geo_to_stbox_internal(box, (GSERIALIZED *) DatumGetPointer(traj));
+		box->tmin = result->period.lower;
+		box->tmax = result->period.upper;
+		MOBDB_FLAGS_SET_T(box->flags, true);
+		pfree(DatumGetPointer(traj));
+	}
+	else
+		temporalseq_make_bbox(box, instants, seq->count,
+			seq->period.lower_inc, seq->period.upper_inc);
+	/* The summary copied with the prefix has the length of the original type,
+	 * planar for geometries and geodetic for geographies */
+	temporalseq_update_summary(result);
+	pfree(instants);
+	return result;
+}
+
+static TemporalS *
+tpoints_convert_geodetic(TemporalS *ts, int srid, bool geodetic)
+{
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
+	for (int i = 0; i < ts->count; i++)
+		sequences[i] = tpointseq_convert_geodetic(temporals_seq_n(ts, i),
+			srid, geodetic);
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences,
+		ts->count, MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
+	for (int i = 0; i < ts->count; i++)
+		pfree(sequences[i]);
+	pfree(sequences);
+	return result;
+}
+
+static Temporal *
+tpoint_convert_geodetic(Temporal *temp, int srid, bool geodetic)
+{
+	Temporal *result;
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+		result = (Temporal *) tpointinst_convert_geodetic(
+			(TemporalInst *) temp, srid, geodetic);
+	else if (temp->duration == TEMPORALI)
+		result = (Temporal *) tpointi_convert_geodetic((TemporalI *) temp,
+			srid, geodetic);
+	else if (temp->duration == TEMPORALSEQ)
+		result = (Temporal *) tpointseq_convert_geodetic((TemporalSeq *) temp,
+			srid, geodetic);
+	else /* temp->duration == TEMPORALS */
+		result = (Temporal *) tpoints_convert_geodetic((TemporalS *) temp,
+			srid, geodetic);
+	return result;
+}
+
 /* Geometry to Geography */
 
 PG_FUNCTION_INFO_V1(tgeompoint_to_tgeogpoint);
@@ -443,8 +825,21 @@ PGDLLEXPORT Datum
 tgeompoint_to_tgeogpoint(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	Temporal *result = tfunc1_temporal(temp, &geom_to_geog,
-		type_oid(T_GEOGRAPHY));
+	Temporal *result;
+	if (tpoint_convertible(temp, true))
+	{
+		/* The cast of the first point checks the SRID of the geography,
+		 * which is set to the default one when it is unknown */
+		TemporalInstIterator it;
+		temporalinst_iterator_init(&it, temp);
+		Datum geog = geom_to_geog(temporalinst_value(
+			temporalinst_iterator_next(&it)));
+		int srid = gserialized_get_srid((GSERIALIZED *) DatumGetPointer(geog));
+		pfree(DatumGetPointer(geog));
+		result = tpoint_convert_geodetic(temp, srid, true);
+	}
+	else
+		result = tfunc1_temporal(temp, &geom_to_geog, type_oid(T_GEOGRAPHY));
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_POINTER(result);
 }
@@ -456,18 +851,24 @@ tgeompoint_to_tgeogpoint(PG_FUNCTION_ARGS)
 TemporalInst *
 tgeogpointinst_to_tgeompointinst(TemporalInst *inst)
 {
+	if (tpointinst_convertible(inst, false))
+		return tpointinst_convert_geodetic(inst, tpointinst_srid(inst), false);
 	return tfunc1_temporalinst(inst, &geog_to_geom, type_oid(T_GEOMETRY));
 }
 
 TemporalSeq *
 tgeogpointseq_to_tgeompointseq(TemporalSeq *seq)
 {
+	if (tpoint_convertible((Temporal *) seq, false))
+		return tpointseq_convert_geodetic(seq, tpointseq_srid(seq), false);
 	return tfunc1_temporalseq(seq, &geog_to_geom, type_oid(T_GEOMETRY));
 }
 
 TemporalS *
 tgeogpoints_to_tgeompoints(TemporalS *ts)
 {
+	if (tpoint_convertible((Temporal *) ts, false))
+		return tpoints_convert_geodetic(ts, tpoints_srid(ts), false);
 	return tfunc1_temporals(ts, &geog_to_geom, type_oid(T_GEOMETRY));
 }
 
@@ -477,8 +878,9 @@ PGDLLEXPORT Datum
 tgeogpoint_to_tgeompoint(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	Temporal *result = tfunc1_temporal(temp, &geog_to_geom,
-		type_oid(T_GEOMETRY));
+	Temporal *result = tpoint_convertible(temp, false) ?
+		tpoint_convert_geodetic(temp, tpoint_srid_internal(temp), false) :
+		tfunc1_temporal(temp, &geog_to_geom, type_oid(T_GEOMETRY));
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_POINTER(result);
 }
@@ -569,6 +971,7 @@ tpointseq_make_trajectory(TemporalInst **instants, int count, bool linear)
 {
 	Oid valuetypid = instants[0]->valuetypid;
 	ensure_point_base_type(valuetypid);
+	TRACE_MOBILITYDB_TRAJECTORY_START(count);
 	bool geometry = (valuetypid == type_oid(T_GEOMETRY));
 	Datum *points = palloc(sizeof(Datum) * count);
 	int k;
@@ -631,19 +1034,176 @@ tpointseq_make_trajectory(TemporalInst **instants, int count, bool linear)
 		for (int i = 0; i < k; i++)
 			pfree(DatumGetPointer(points[i]));
 	pfree(points);
+	TRACE_MOBILITYDB_TRAJECTORY_DONE(VARSIZE(DatumGetPointer(result)));
 	return result;	
 }
 
-/* Get the precomputed trajectory of a tpointseq */
+/* Compute the trajectory of a tpointseq whose trajectory is not precomputed */
+
+static Datum
+tpointseq_compute_trajectory(TemporalSeq *seq)
+{
+	TemporalInst **instants = temporalseq_instants(seq);
+	Datum result = tpointseq_make_trajectory(instants, seq->count,
+		MOBDB_FLAGS_GET_LINEAR(seq->flags));
+	pfree(instants);
+	return result;
+}
+
+/* Get the trajectory of a tpointseq. The result must not be freed: it is 
+ * either the precomputed trajectory stored in the sequence or, when it is 
+ * not precomputed, a trajectory computed in the current memory context */
 
 Datum
 tpointseq_trajectory(TemporalSeq *seq)
 {
+	if (MOBDB_FLAGS_GET_NOTRAJ(seq->flags))
+		return tpointseq_compute_trajectory(seq);
 	void *traj = (char *)(&seq->offsets[seq->count + 2]) + 	/* start of data */
 			seq->offsets[seq->count + 1];					/* offset */
 	return PointerGetDatum(traj);
 }
 
+/*
+ * Functions expanding the serialized trajectory of a geometry sequence with
+ * a new point without deserializing it. The serialized linestring contains 
+ * its type and number of points followed by the coordinates and the 
+ * serialized multipoint contains its type and number of points followed by 
+ * the serialized points, each one containing its type and number of points
+ * (that is, 1) followed by the coordinates. In both cases this comes after 
+ * the optional bounding box of the geometry.
+ */
+
+/* Size of the bounding box of a serialized geometry */
+
+static size_t
+gserialized_bbox_size(GSERIALIZED *gs)
+{
+	return FLAGS_GET_BBOX(gs->flags) ? gbox_serialized_size(gs->flags) : 0;
+}
+
+/* Equality of the coordinates of two points */
+
+static inline bool
+coords_eq(const double *coords1, const double *coords2, int ndims)
+{
+	for (int i = 0; i < ndims; i++)
+		if (coords1[i] != coords2[i])
+			return false;
+	return true;
+}
+
+/* Copy a serialized geometry while reserving extra space at the end */
+
+static GSERIALIZED *
+gserialized_copy_expand(GSERIALIZED *gs, size_t extra)
+{
+	GSERIALIZED *result = palloc(VARSIZE(gs) + extra);
+	memcpy(result, gs, VARSIZE(gs));
+	SET_VARSIZE(result, VARSIZE(gs) + extra);
+	return result;
+}
+
+/* Expand the bounding box of a serialized geometry, if any, with a point */
+
+static void
+gserialized_bbox_expand(GSERIALIZED *gs, const double *coords, int ndims)
+{
+	if (! FLAGS_GET_BBOX(gs->flags))
+		return;
+	float *fbox = (float *) gs->data;
+	bool inside = true;
+	for (int i = 0; i < ndims && inside; i++)
+		inside = fbox[2 * i] <= coords[i] && coords[i] <= fbox[2 * i + 1];
+	if (inside)
+		return;
+	/* The box is stored with float precision, rounded outwards */
+	GBOX box;
+	memset(&box, 0, sizeof(GBOX));
+	box.flags = gflags(ndims == 3, false, false);
+	box.xmin = Min(fbox[0], coords[0]); box.xmax = Max(fbox[1], coords[0]);
+	box.ymin = Min(fbox[2], coords[1]); box.ymax = Max(fbox[3], coords[1]);
+	if (ndims == 3)
+	{
+		box.zmin = Min(fbox[4], coords[2]); box.zmax = Max(fbox[5], coords[2]);
+	}
+	gbox_float_round(&box);
+	fbox[0] = (float) box.xmin; fbox[1] = (float) box.xmax;
+	fbox[2] = (float) box.ymin; fbox[3] = (float) box.ymax;
+	if (ndims == 3)
+	{
+		fbox[4] = (float) box.zmin; fbox[5] = (float) box.zmax;
+	}
+}
+
+/* Add or replace the last point of a serialized linestring */
+
+static Datum
+gserialized_line_append(GSERIALIZED *gsline, const double *coords, int ndims,
+	bool replace)
+{
+	size_t ptsize = ndims * sizeof(double);
+	uint8_t *data = (uint8_t *) gsline->data + gserialized_bbox_size(gsline);
+	uint32_t npoints;
+	memcpy(&npoints, data + sizeof(uint32_t), sizeof(uint32_t));
+	size_t lastpos = (data - (uint8_t *) gsline) + 2 * sizeof(uint32_t) + 
+		(npoints - 1) * ptsize;
+	GSERIALIZED *result;
+	if (replace)
+	{
+		result = gserialized_copy_expand(gsline, 0);
+		memcpy((uint8_t *) result + lastpos, coords, ptsize);
+	}
+	/* Two consecutive points that are equal are not repeated */
+	else if (coords_eq((const double *) ((uint8_t *) gsline + lastpos), coords, 
+		ndims))
+		return PointerGetDatum(gserialized_copy(gsline));
+	else
+	{
+		result = gserialized_copy_expand(gsline, ptsize);
+		npoints++;
+		memcpy((uint8_t *) result + (data - (uint8_t *) gsline) + 
+			sizeof(uint32_t), &npoints, sizeof(uint32_t));
+		memcpy((uint8_t *) result + lastpos + ptsize, coords, ptsize);
+	}
+	/* When a point replaces the last one of the line it is collinear with 
+	 * the last two points, so expanding the box keeps it exact */
+	gserialized_bbox_expand(result, coords, ndims);
+	return PointerGetDatum(result);
+}
+
+/* Add a point to a serialized multipoint unless it is already in it */
+
+static Datum
+gserialized_multipoint_append(GSERIALIZED *gsmpoint, const double *coords,
+	int ndims)
+{
+	size_t ptsize = ndims * sizeof(double);
+	size_t geomsize = 2 * sizeof(uint32_t) + ptsize;
+	uint8_t *data = (uint8_t *) gsmpoint->data + gserialized_bbox_size(gsmpoint);
+	uint32_t ngeoms;
+	memcpy(&ngeoms, data + sizeof(uint32_t), sizeof(uint32_t));
+	uint8_t *geom = data + 2 * sizeof(uint32_t);
+	for (uint32_t i = 0; i < ngeoms; i++)
+	{
+		if (coords_eq((const double *) (geom + 2 * sizeof(uint32_t)), coords,
+				ndims))
+			return PointerGetDatum(gserialized_copy(gsmpoint));
+		geom += geomsize;
+	}
+	GSERIALIZED *result = gserialized_copy_expand(gsmpoint, geomsize);
+	size_t datapos = data - (uint8_t *) gsmpoint;
+	ngeoms++;
+	memcpy((uint8_t *) result + datapos + sizeof(uint32_t), &ngeoms, 
+		sizeof(uint32_t));
+	uint8_t *newgeom = (uint8_t *) result + (geom - (uint8_t *) gsmpoint);
+	uint32_t header[2] = {POINTTYPE, 1};
+	memcpy(newgeom, header, 2 * sizeof(uint32_t));
+	memcpy(newgeom + 2 * sizeof(uint32_t), coords, ptsize);
+	gserialized_bbox_expand(result, coords, ndims);
+	return PointerGetDatum(result);
+}
+
 /* Add or replace a point to the trajectory of a sequence */
 
 Datum
@@ -652,6 +1212,22 @@ tpointseq_trajectory_append(TemporalSeq *seq, TemporalInst *inst, bool replace)
 	Datum traj = tpointseq_trajectory(seq);
 	Datum point = temporalinst_value(inst);
 	GSERIALIZED *gstraj = (GSERIALIZED *)PointerGetDatum(traj);
+	/* The trajectory of a geometry sequence is expanded in place. A line 
+	 * without a bounding box to which a point is added is serialized again
+	 * so that it gets its bounding box as any other trajectory. */
+	if (gserialized_get_type(gstraj) != POINTTYPE && 
+		! FLAGS_GET_GEODETIC(gstraj->flags) &&
+		(FLAGS_GET_BBOX(gstraj->flags) || replace))
+	{
+		int ndims = FLAGS_GET_Z(gstraj->flags) ? 3 : 2;
+		double coords[3];
+		GSERIALIZED *gspoint = (GSERIALIZED *) DatumGetPointer(point);
+		memcpy(coords, (uint8_t *) gspoint->data + 8, ndims * sizeof(double));
+		if (gserialized_get_type(gstraj) == MULTIPOINTTYPE)
+			return gserialized_multipoint_append(gstraj, coords, ndims);
+		else
+			return gserialized_line_append(gstraj, coords, ndims, replace);
+	}
 	if (gserialized_get_type(gstraj) == POINTTYPE)
 	{
 		if (datum_point_eq(traj, point))
@@ -718,11 +1294,13 @@ tpointseq_trajectory_append(TemporalSeq *seq, TemporalInst *inst, bool replace)
 	}
 }
 
-/* Copy the precomputed trajectory of a tpointseq */
+/* Copy the trajectory of a tpointseq */
 
 Datum
 tpointseq_trajectory_copy(TemporalSeq *seq)
 {
+	if (MOBDB_FLAGS_GET_NOTRAJ(seq->flags))
+		return tpointseq_compute_trajectory(seq);
 	void *traj = (char *)(&seq->offsets[seq->count + 2]) + 	/* start of data */
 			seq->offsets[seq->count + 1];					/* offset */
 	return PointerGetDatum(gserialized_copy(traj));
@@ -866,6 +1444,68 @@ tpoint_trajectory_internal(Temporal *temp)
 	return result;
 }
 
+/* 
+ * Trajectory of a temporal point cached in the fn_extra of the calling
+ * function, which avoids recomputing the trajectory of a temporal point
+ * argument that is the same for all the rows of a query, e.g., when it is
+ * compared with the geometries of another table. As for the boxes kept by
+ * box_cache_fn, the trajectory is only cached when the argument argno is a
+ * constant or a parameter of the query. The cached trajectory is then
+ * identified by the address and the size of the argument, which are compared
+ * instead of the whole value. When tofree is set on return the caller must
+ * free the trajectory, otherwise it must not be freed.
+ */
+typedef struct
+{
+	bool stable;			/* The argument does not change across calls */
+	const Temporal *temp;	/* Address of the argument, not a copy */
+	Size size;				/* Size of the argument */
+	Datum traj;				/* Its trajectory, 0 if not yet computed */
+} TrajectoryCache;
+
+Datum
+tpoint_trajectory_cached(FunctionCallInfo fcinfo, Temporal *temp, int argno,
+	bool *tofree)
+{
+	*tofree = false;
+	/* The precomputed trajectory of a sequence does not need to be cached */
+	if (temp->duration == TEMPORALSEQ && 
+		! MOBDB_FLAGS_GET_NOTRAJ(temp->flags))
+		return tpointseq_trajectory((TemporalSeq *) temp);
+
+	FmgrInfo *flinfo = fcinfo->flinfo;
+	TrajectoryCache *cache = flinfo != NULL ? 
+		(TrajectoryCache *) flinfo->fn_extra : NULL;
+	if (flinfo != NULL && cache == NULL)
+	{
+		cache = MemoryContextAllocZero(flinfo->fn_mcxt, 
+			sizeof(TrajectoryCache));
+		cache->stable = get_fn_expr_arg_stable(flinfo, argno);
+		flinfo->fn_extra = cache;
+	}
+	if (cache == NULL || ! cache->stable)
+	{
+		*tofree = true;
+		return tpoint_trajectory_internal(temp);
+	}
+	if (cache->traj != 0 && cache->temp == temp && 
+		cache->size == VARSIZE(temp))
+		return cache->traj;
+
+	/* First call or new copy of the argument */
+	Datum traj = tpoint_trajectory_internal(temp);
+	if (cache->traj != 0)
+		pfree(DatumGetPointer(cache->traj));
+	MemoryContext oldcontext = MemoryContextSwitchTo(flinfo->fn_mcxt);
+	cache->traj = PointerGetDatum(gserialized_copy(
+		(GSERIALIZED *) DatumGetPointer(traj)));
+	MemoryContextSwitchTo(oldcontext);
+	cache->temp = temp;
+	cache->size = VARSIZE(temp);
+	pfree(DatumGetPointer(traj));
+	return cache->traj;
+}
+
 PG_FUNCTION_INFO_V1(tpoint_trajectory);
 
 PGDLLEXPORT Datum
@@ -881,26 +1521,129 @@ tpoint_trajectory(PG_FUNCTION_ARGS)
  * Length functions
  *****************************************************************************/
 
-/* Length traversed by the temporal point */
+/*
+ * Copy the coordinates of the instants of a temporal point sequence into the
+ * arrays x, y, and z when the sequence has Z, which must have room for
+ * seq->count values. The coordinates are read directly from the serialized
+ * points, after their bounding box, if any.
+ */
+static void
+tpointseq_coords(TemporalSeq *seq, double *x, double *y, double *z)
+{
+	for (int i = 0; i < seq->count; i++)
+	{
+		GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(
+			temporalinst_value(temporalseq_inst_n(seq, i)));
+		const double *coords = (const double *) ((uint8_t *) gs->data +
+			gserialized_bbox_size(gs) + 8);
+		x[i] = coords[0];
+		y[i] = coords[1];
+		if (z != NULL)
+			z[i] = coords[2];
+	}
+}
 
-static double
-tpointseq_length(TemporalSeq *seq)
+/*
+ * Compute the planar length of the segments of a temporal point sequence
+ * into the array lengths, which must have room for seq->count - 1 values.
+ * As LWGEOM_length_linestring, the length is computed in 3D when the
+ * sequence has Z. The lengths are computed by the kernel of the core
+ * library in one pass over the arrays of coordinates.
+ */
+static void
+tpointseq_segment_lengths(TemporalSeq *seq, double *lengths)
 {
-	assert(MOBDB_FLAGS_GET_LINEAR(seq->flags));
-	Datum traj = tpointseq_trajectory(seq);
-	GSERIALIZED *gstraj = (GSERIALIZED *)DatumGetPointer(traj);
-	if (gserialized_get_type(gstraj) == POINTTYPE)
-		return 0;
-	
-	/* We are sure that the trajectory is a line */
-	double result = 0.0;
+	bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+	double *x = palloc(sizeof(double) * seq->count);
+	double *y = palloc(sizeof(double) * seq->count);
+	double *z = hasz ? palloc(sizeof(double) * seq->count) : NULL;
+	tpointseq_coords(seq, x, y, z);
+	tpoint_segment_lengths(x, y, z, seq->count, lengths);
+	pfree(x); pfree(y);
+	if (hasz)
+		pfree(z);
+}
+
+/*
+ * Compute the geodetic length of the segments of a temporal geography point
+ * sequence into the array lengths, which must have room for seq->count - 1
+ * values
+ */
+static void
+tgeogpointseq_segment_lengths(TemporalSeq *seq, double *lengths)
+{
+	Datum value1 = temporalinst_value(temporalseq_inst_n(seq, 0));
+	for (int i = 0; i < seq->count - 1; i++)
+	{
+		Datum value2 = temporalinst_value(temporalseq_inst_n(seq, i + 1));
+		if (datum_point_eq(value1, value2))
+			lengths[i] = 0;
+		else
+		{
+			Datum traj = geompoint_trajectory(value1, value2);
+			lengths[i] = DatumGetFloat8(call_function2(geography_length, traj,
+				BoolGetDatum(true)));
+			pfree(DatumGetPointer(traj));
+		}
+		value1 = value2;
+	}
+}
+
+/*
+ * Planar length of the segment defined by two instants of a temporal
+ * geometry point, computed as in tpointseq_segment_lengths
+ */
+double
+tpointseg_length(TemporalInst *inst1, TemporalInst *inst2)
+{
+	GSERIALIZED *gs1 = (GSERIALIZED *) DatumGetPointer(temporalinst_value(inst1));
+	GSERIALIZED *gs2 = (GSERIALIZED *) DatumGetPointer(temporalinst_value(inst2));
+	const double *coords1 = (const double *) ((uint8_t *) gs1->data +
+		gserialized_bbox_size(gs1) + 8);
+	const double *coords2 = (const double *) ((uint8_t *) gs2->data +
+		gserialized_bbox_size(gs2) + 8);
+	double dx = coords2[0] - coords1[0];
+	double dy = coords2[1] - coords1[1];
+	if (MOBDB_FLAGS_GET_Z(inst1->flags))
+	{
+		double dz = coords2[2] - coords1[2];
+		return sqrt((dx * dx) + (dy * dy) + (dz * dz));
+	}
+	return sqrt((dx * dx) + (dy * dy));
+}
+
+/* Length traversed by the temporal point */
+
+double
+tpointseq_length(TemporalSeq *seq)
+{
+	assert(MOBDB_FLAGS_GET_LINEAR(seq->flags));
+	if (seq->count == 1)
+		return 0;
+	TemporalSeqSummary *summary = temporalseq_summary_ptr(seq);
+	if (summary != NULL)
+		return summary->length;
+
 	ensure_point_base_type(seq->valuetypid);
-	if (seq->valuetypid == type_oid(T_GEOMETRY))
-		/* The next function call works for 2D and 3D */
-		result = DatumGetFloat8(call_function1(LWGEOM_length_linestring, traj));
-	else if (seq->valuetypid == type_oid(T_GEOGRAPHY))
-		result = DatumGetFloat8(call_function2(geography_length, traj,
+	if (seq->valuetypid == type_oid(T_GEOGRAPHY))
+	{
+		Datum traj = tpointseq_trajectory(seq);
+		GSERIALIZED *gstraj = (GSERIALIZED *)DatumGetPointer(traj);
+		if (gserialized_get_type(gstraj) == POINTTYPE)
+			return 0;
+		/* We are sure that the trajectory is a line */
+		return DatumGetFloat8(call_function2(geography_length, traj,
 			BoolGetDatum(true)));
+	}
+
+	/* Sum the lengths of the segments in the same order as 
+	 * LWGEOM_length_linestring does */
+	double *lengths = palloc(sizeof(double) * (seq->count - 1));
+	tpointseq_segment_lengths(seq, lengths);
+	double result = 0.0;
+	for (int i = 0; i < seq->count - 1; i++)
+		result += lengths[i];
+	pfree(lengths);
 	return result;
 }
 
@@ -919,7 +1662,20 @@ PG_FUNCTION_INFO_V1(tpoint_length);
 PGDLLEXPORT Datum
 tpoint_length(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	/* Sum the lengths of the segments of a view of a geometry sequence */
+	ExpandedTemporalSeq *eseq = expanded_temporalseq_get(PG_GETARG_DATUM(0));
+	if (eseq != NULL && eseq->valuetypid == type_oid(T_GEOMETRY))
+	{
+		double result = 0.0;
+		if (eseq->linear)
+		{
+			for (int i = 0; i < eseq->count - 1; i++)
+				result += tpointseg_length(eseq->instants[i], eseq->instants[i + 1]);
+		}
+		PG_RETURN_FLOAT8(result);
+	}
+
+	Temporal *temp = PG_GETARG_TEMPORAL_CACHED(0);
 	double result = 0.0;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST || temp->duration == TEMPORALI ||
@@ -930,7 +1686,6 @@ tpoint_length(PG_FUNCTION_ARGS)
 		result = tpointseq_length((TemporalSeq *)temp);	
 	else if (temp->duration == TEMPORALS)
 		result = tpoints_length((TemporalS *)temp);	
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_FLOAT8(result);
 }
 
@@ -990,27 +1745,20 @@ tpointseq_cumulative_length(TemporalSeq *seq, double prevlength)
 	else
 	/* Linear interpolation */
 	{
-		TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
-		Datum value1 = temporalinst_value(inst1);
+		/* Stream over contiguous arrays of timestamps and segment lengths */
+		TimestampTz *times = temporalseq_timestamps1(seq);
+		double *lengths = palloc(sizeof(double) * (seq->count - 1));
+		tpointseq_segment_lengths(seq, lengths);
 		double length = prevlength;
-		instants[0] = temporalinst_make(Float8GetDatum(length), inst1->t,
+		instants[0] = temporalinst_make(Float8GetDatum(length), times[0],
 				FLOAT8OID);
 		for (int i = 1; i < seq->count; i++)
 		{
-			TemporalInst *inst2 = temporalseq_inst_n(seq, i);
-			Datum value2 = temporalinst_value(inst2);
-			if (datum_ne(value1, value2, inst1->valuetypid))
-			{
-				Datum line = geompoint_trajectory(value1, value2);
-				/* The next function works for 2D and 3D */
-				length += DatumGetFloat8(call_function1(LWGEOM_length_linestring, line));	
-				pfree(DatumGetPointer(line));
-			}
-			instants[i] = temporalinst_make(Float8GetDatum(length), inst2->t,
+			length += lengths[i - 1];
+			instants[i] = temporalinst_make(Float8GetDatum(length), times[i],
 				FLOAT8OID);
-			inst1 = inst2;
-			value1 = value2;
 		}
+		pfree(times); pfree(lengths);
 	}
 	TemporalSeq *result = temporalseq_from_temporalinstarr(instants,
 		seq->count, seq->period.lower_inc, seq->period.upper_inc,
@@ -1050,7 +1798,7 @@ PG_FUNCTION_INFO_V1(tpoint_cumulative_length);
 PGDLLEXPORT Datum
 tpoint_cumulative_length(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Temporal *temp = PG_GETARG_TEMPORAL_CACHED(0);
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST)
@@ -1061,7 +1809,6 @@ tpoint_cumulative_length(PG_FUNCTION_ARGS)
 		result = (Temporal *)tpointseq_cumulative_length((TemporalSeq *)temp, 0);	
 	else if (temp->duration == TEMPORALS)
 		result = (Temporal *)tpoints_cumulative_length((TemporalS *)temp);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_POINTER(result);
 }
 
@@ -1090,34 +1837,21 @@ tpointseq_speed(TemporalSeq *seq)
 	else
 	/* Linear interpolation */
 	{
-		TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
-		Datum value1 = temporalinst_value(inst1);
+		TimestampTz *times = temporalseq_timestamps1(seq);
+		double *lengths = palloc(sizeof(double) * (seq->count - 1));
+		ensure_point_base_type(seq->valuetypid);
+		if (seq->valuetypid == type_oid(T_GEOMETRY))
+			tpointseq_segment_lengths(seq, lengths);
+		else
+			tgeogpointseq_segment_lengths(seq, lengths);
 		double speed;
 		for (int i = 0; i < seq->count - 1; i++)
 		{
-			TemporalInst *inst2 = temporalseq_inst_n(seq, i + 1);
-			Datum value2 = temporalinst_value(inst2);
-			if (datum_point_eq(value1, value2))
-				speed = 0;
-			else
-			{
-				Datum traj = geompoint_trajectory(value1, value2);
-				double length = 0.0; /* Make compiler quiet */
-				ensure_point_base_type(seq->valuetypid);
-				if (seq->valuetypid == type_oid(T_GEOMETRY))
-					/* The next function works for 2D and 3D */
-					length = DatumGetFloat8(call_function1(LWGEOM_length_linestring, traj));
-				else if (seq->valuetypid == type_oid(T_GEOGRAPHY))
-					length = DatumGetFloat8(call_function2(geography_length, traj,
-						BoolGetDatum(true)));
-				pfree(DatumGetPointer(traj));
-				speed = length / ((double)(inst2->t - inst1->t) / 1000000);
-			}
-			instants[i] = temporalinst_make(Float8GetDatum(speed), inst1->t,
+			speed = lengths[i] / ((double)(times[i + 1] - times[i]) / 1000000);
+			instants[i] = temporalinst_make(Float8GetDatum(speed), times[i],
 				FLOAT8OID);
-			inst1 = inst2;
-			value1 = value2;
-		}			
+		}
+		pfree(times); pfree(lengths);
 		instants[seq->count - 1] = temporalinst_make(Float8GetDatum(speed),
 			seq->period.upper, FLOAT8OID);
 	}
@@ -1161,7 +1895,7 @@ PG_FUNCTION_INFO_V1(tpoint_speed);
 PGDLLEXPORT Datum
 tpoint_speed(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Temporal *temp = PG_GETARG_TEMPORAL_CACHED(0);
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST || temp->duration == TEMPORALI)
@@ -1170,7 +1904,6 @@ tpoint_speed(PG_FUNCTION_ARGS)
 		result = (Temporal *)tpointseq_speed((TemporalSeq *)temp);	
 	else if (temp->duration == TEMPORALS)
 		result = (Temporal *)tpoints_speed((TemporalS *)temp);	
-	PG_FREE_IF_COPY(temp, 0);
 	if (result == NULL)
 		PG_RETURN_NULL();
 	PG_RETURN_POINTER(result);
@@ -1586,210 +2319,891 @@ tpoint_azimuth(PG_FUNCTION_ARGS)
 }
 
 /*****************************************************************************
- * Restriction functions
- * N.B. In the current version of PostGIS (2.5) there is no true ST_Intersection
- * function for geography
+ * Simplification functions
+ *
+ * The Douglas-Peucker algorithm keeps the first and the last instants of a
+ * sequence and then, for each pair of consecutive instants kept, keeps the
+ * instant between them that is the farthest from the segment joining them
+ * as long as its distance is greater than the tolerance. When the distance
+ * is synchronized, the distance of an instant is measured with respect to
+ * the point of the segment at the same timestamp, which ensures that the
+ * simplified sequence is within the tolerance of the original one at every
+ * instant. The speed simplification keeps an instant when the speed after
+ * it differs by more than the tolerance from the speed since the last
+ * instant kept.
  *****************************************************************************/
 
-/* Restrict a temporal point to a geometry */
-
-static TemporalInst *
-tpointinst_at_geometry(TemporalInst *inst, Datum geom)
-{
-	if (!DatumGetBool(call_function2(intersects, temporalinst_value(inst), geom)))
-		return NULL;
-	return temporalinst_copy(inst);
-}
-
-static TemporalI *
-tpointi_at_geometry(TemporalI *ti, Datum geom)
-{
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
-	int k = 0;
-	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		if (DatumGetBool(call_function2(intersects, temporalinst_value(inst), geom)))
-			instants[k++] = inst;
-	}
-	TemporalI *result = NULL;
-	if (k != 0)
-		result = temporali_from_temporalinstarr(instants, k);
-	/* We do not need to pfree the instants */
-	pfree(instants);
-	return result;
-}
+#define SIMPLIFY_DP		0
+#define SIMPLIFY_SED	1
+#define SIMPLIFY_SPEED	2
 
 /*
- * This function assumes that inst1 and inst2 have equal SRID and that the
- * points and the geometry are in 2D
+ * Distance between the instant i and the segment of the sequence joining
+ * the instants a and b, either synchronized or spatial
  */
-static TemporalSeq **
-tpointseq_at_geometry1(TemporalInst *inst1, TemporalInst *inst2, bool linear,
-	bool lower_inc, bool upper_inc, Datum geom, int *count)
+static double
+simplify_dist(const double *x, const double *y, const double *z,
+	const TimestampTz *times, int a, int b, int i, bool synchronized)
 {
-	Datum value1 = temporalinst_value(inst1);
-	Datum value2 = temporalinst_value(inst2);
-
-	/* Constant segment or stepwise interpolation */
-	bool equal = datum_point_eq(value1, value2);
-	if (equal || ! linear)
+	double dx = x[b] - x[a];
+	double dy = y[b] - y[a];
+	double dz = (z != NULL) ? z[b] - z[a] : 0;
+	double fraction;
+	if (synchronized)
+		fraction = (double) (times[i] - times[a]) / 
+			(double) (times[b] - times[a]);
+	else
 	{
-		if (!DatumGetBool(call_function2(intersects, value1, geom)))
+		double len2 = (dx * dx) + (dy * dy) + (dz * dz);
+		if (len2 == 0)
+			fraction = 0;
+		else
 		{
-			*count = 0;
-			return NULL;
+			fraction = ((x[i] - x[a]) * dx + (y[i] - y[a]) * dy +
+				((z != NULL) ? (z[i] - z[a]) * dz : 0)) / len2;
+			fraction = Max(0, Min(1, fraction));
 		}
-
-		TemporalInst *instants[2];
-		instants[0] = inst1;
-		instants[1] = equal ? inst2 :
-			temporalinst_make(value1, inst2->t, inst1->valuetypid);
-		TemporalSeq **result = palloc(sizeof(TemporalSeq *));
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, upper_inc, linear, false);
-		*count = 1;
-		if (! equal)
-			pfree(instants[1]);
-		return result;
-	}
-
-	/* Look for intersections */
-	Datum line = geompoint_trajectory(value1, value2);
-	Datum intersections = call_function2(intersection, line, geom);
-	if (DatumGetBool(call_function1(LWGEOM_isempty, intersections)))
-	{
-		pfree(DatumGetPointer(line));
-		pfree(DatumGetPointer(intersections));
-		*count = 0;
-		return NULL;
 	}
+	double ex = x[a] + dx * fraction - x[i];
+	double ey = y[a] + dy * fraction - y[i];
+	double ez = (z != NULL) ? z[a] + dz * fraction - z[i] : 0;
+	return sqrt((ex * ex) + (ey * ey) + (ez * ez));
+}
 
-	int countinter = DatumGetInt32(call_function1(
-		LWGEOM_numgeometries_collection, intersections));
-	TemporalInst *instants[2];
-	TemporalSeq **result = palloc(sizeof(TemporalSeq *) * countinter);
-	double duration = (double)(inst2->t - inst1->t);
-	int k = 0;
-	for (int i = 1; i <= countinter; i++)
+/*
+ * Mark in the array keep the instants kept by the Douglas-Peucker algorithm.
+ * The recursion is replaced by an explicit stack of pairs of instants, which
+ * holds at most count pairs since each pair splits at an instant kept.
+ */
+static void
+simplify_douglas_peucker(const double *x, const double *y, const double *z,
+	const TimestampTz *times, int count, double eps, bool synchronized,
+	bool *keep)
+{
+	int *stack = palloc(sizeof(int) * 2 * count);
+	int top = 0;
+	keep[0] = keep[count - 1] = true;
+	stack[top++] = 0;
+	stack[top++] = count - 1;
+	while (top > 0)
 	{
-		/* Find the i-th intersection */
-		Datum inter = call_function2(LWGEOM_geometryn_collection,
-			intersections, Int32GetDatum(i));
-		GSERIALIZED *gsinter = (GSERIALIZED *) PG_DETOAST_DATUM(inter);
-
-		/* Each intersection is either a point or a linestring with two points */
-		if (gserialized_get_type(gsinter) == POINTTYPE)
+		int b = stack[--top];
+		int a = stack[--top];
+		double dmax = -1;
+		int imax = -1;
+		for (int i = a + 1; i < b; i++)
 		{
-			double fraction = DatumGetFloat8(call_function2(
-				LWGEOM_line_locate_point, line, inter));
-			TimestampTz t = inst1->t + (long) (duration * fraction);
-			/* If the intersection is not at an exclusive bound */
-			if ((lower_inc || t > inst1->t) && (upper_inc || t < inst2->t))
+			double d = simplify_dist(x, y, z, times, a, b, i, synchronized);
+			if (d > dmax)
 			{
-				/* Restriction at timestamp done to avoid floating point imprecision */
-				instants[0] = temporalseq_at_timestamp1(inst1, inst2, linear, t);
-				result[k++] = temporalseq_from_temporalinstarr(instants, 1,
-					true, true, linear, false);
-				pfree(instants[0]);
+				dmax = d;
+				imax = i;
 			}
 		}
-		else
+		if (imax > 0 && dmax > eps)
 		{
-			Datum point1 = call_function2(LWGEOM_pointn_linestring,
-				inter, Int32GetDatum(1));
-			Datum point2 = call_function2(LWGEOM_pointn_linestring,
-				inter, Int32GetDatum(2));
-			double fraction1 = DatumGetFloat8(call_function2(
-				LWGEOM_line_locate_point, line, point1));
-			double fraction2 = DatumGetFloat8(call_function2(
-				LWGEOM_line_locate_point, line, point2));
-			TimestampTz t1 = inst1->t + (long) (duration * fraction1);
-			TimestampTz t2 = inst1->t + (long) (duration * fraction2);
-			TimestampTz lower1 = Min(t1, t2);
-			TimestampTz upper1 = Max(t1, t2);
-			/* Restriction at timestamp done to avoid floating point imprecision */
-			instants[0] = temporalseq_at_timestamp1(inst1, inst2, linear, lower1);
-			instants[1] = temporalseq_at_timestamp1(inst1, inst2, linear, upper1);
-			bool lower_inc1 = timestamp_cmp_internal(lower1, inst1->t) == 0 ?
-				lower_inc : true;
-			bool upper_inc1 = timestamp_cmp_internal(upper1, inst2->t) == 0 ?
-				upper_inc : true;
-			result[k++] = temporalseq_from_temporalinstarr(instants, 2,
-					lower_inc1, upper_inc1, linear, false);
-			pfree(instants[0]); pfree(instants[1]);
-			pfree(DatumGetPointer(point1)); pfree(DatumGetPointer(point2));
+			keep[imax] = true;
+			stack[top++] = a;
+			stack[top++] = imax;
+			stack[top++] = imax;
+			stack[top++] = b;
 		}
-		POSTGIS_FREE_IF_COPY_P(gsinter, DatumGetPointer(inter));
 	}
+	pfree(stack);
+}
 
-	pfree(DatumGetPointer(line));
-	pfree(DatumGetPointer(intersections));
-
-	if (k == 0)
-	{
-		pfree(result);
-		*count = 0;
-		return NULL;
-	}
+/* Speed in units per second between the instants a and b */
 
-	temporalseqarr_sort(result, k);
-	*count = k;
-	return result;
+static double
+simplify_speed(const double *x, const double *y, const double *z,
+	const TimestampTz *times, int a, int b)
+{
+	double dx = x[b] - x[a];
+	double dy = y[b] - y[a];
+	double dz = (z != NULL) ? z[b] - z[a] : 0;
+	return sqrt((dx * dx) + (dy * dy) + (dz * dz)) / 
+		((double) (times[b] - times[a]) / 1000000);
 }
 
-TemporalSeq **
-tpointseq_at_geometry2(TemporalSeq *seq, Datum geom, int *count)
+/*
+ * Mark in the array keep the instants kept by the speed simplification
+ */
+static void
+simplify_speed_threshold(const double *x, const double *y, const double *z,
+	const TimestampTz *times, int count, double eps, bool *keep)
 {
-	/* Instantaneous sequence */
-	if (seq->count == 1)
+	keep[0] = keep[count - 1] = true;
+	int last = 0;
+	for (int i = 1; i < count - 1; i++)
 	{
-		/* Due to the bounding box test in the calling function we are sure
-		 * that the point intersects the geometry */
-		TemporalSeq **result = palloc(sizeof(TemporalSeq *));
-		result[0] = temporalseq_copy(seq);
-		*count = 1;
-		return result;
+		double speed1 = simplify_speed(x, y, z, times, last, i);
+		double speed2 = simplify_speed(x, y, z, times, i, i + 1);
+		if (fabs(speed2 - speed1) > eps)
+		{
+			keep[i] = true;
+			last = i;
+		}
 	}
+}
 
-	/* Temporal sequence has at least 2 instants */
-	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
-	TemporalSeq ***sequences = palloc(sizeof(TemporalSeq *) * (seq->count - 1));
-	int *countseqs = palloc0(sizeof(int) * (seq->count - 1));
-	int totalseqs = 0;
-	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
-	bool lower_inc = seq->period.lower_inc;
-	for (int i = 0; i < seq->count - 1; i++)
-	{
-		TemporalInst *inst2 = temporalseq_inst_n(seq, i + 1);
-		bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false;
-		sequences[i] = tpointseq_at_geometry1(inst1, inst2, linear,
-			lower_inc, upper_inc, geom, &countseqs[i]);
-		totalseqs += countseqs[i];
-		inst1 = inst2;
-		lower_inc = true;
-	}
-	if (totalseqs == 0)
-	{
-		pfree(countseqs);
-		pfree(sequences);
-		*count = 0;
-		return NULL;
-	}
+static TemporalSeq *
+tpointseq_simplify(TemporalSeq *seq, double eps, int method)
+{
+	if (seq->count <= 2 || ! MOBDB_FLAGS_GET_LINEAR(seq->flags))
+		return temporalseq_copy(seq);
 
-	TemporalSeq **result = palloc(sizeof(TemporalSeq *) * totalseqs);
+	/* Stream over contiguous arrays of timestamps and coordinates */
+	bool hasz = MOBDB_FLAGS_GET_Z(seq->flags);
+	TimestampTz *times = temporalseq_timestamps1(seq);
+	double *x = palloc(sizeof(double) * seq->count);
+	double *y = palloc(sizeof(double) * seq->count);
+	double *z = hasz ? palloc(sizeof(double) * seq->count) : NULL;
+	tpointseq_coords(seq, x, y, z);
+	bool *keep = palloc0(sizeof(bool) * seq->count);
+	if (method == SIMPLIFY_SPEED)
+		simplify_speed_threshold(x, y, z, times, seq->count, eps, keep);
+	else
+		simplify_douglas_peucker(x, y, z, times, seq->count, eps,
+			method == SIMPLIFY_SED, keep);
+
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
 	int k = 0;
-	for (int i = 0; i < seq->count - 1; i++)
-	{
-		for (int j = 0; j < countseqs[i]; j++)
-			result[k++] = sequences[i][j];
-		if (sequences[i] != NULL)
-			pfree(sequences[i]);
-	}
+	for (int i = 0; i < seq->count; i++)
+		if (keep[i])
+			instants[k++] = temporalseq_inst_n(seq, i);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, k,
+		seq->period.lower_inc, seq->period.upper_inc, true, true);
 
-	pfree(countseqs);
-	pfree(sequences);
-	*count = totalseqs;
+	pfree(instants); pfree(keep); pfree(times);
+	pfree(x); pfree(y);
+	if (hasz)
+		pfree(z);
+	return result;
+}
+
+static TemporalS *
+tpoints_simplify(TemporalS *ts, double eps, int method)
+{
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
+	for (int i = 0; i < ts->count; i++)
+		sequences[i] = tpointseq_simplify(temporals_seq_n(ts, i), eps, method);
+	TemporalS *result = temporals_from_temporalseqarr(sequences, ts->count,
+		MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
+
+	for (int i = 0; i < ts->count; i++)
+		pfree(sequences[i]);
+	pfree(sequences);
+
+	return result;
+}
+
+static Temporal *
+tpoint_simplify_internal(Temporal *temp, double eps, int method)
+{
+	if (eps < 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The tolerance must be greater than or equal to zero")));
+
+	Temporal *result;
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST || temp->duration == TEMPORALI)
+		result = temporal_copy(temp);
+	else if (temp->duration == TEMPORALSEQ)
+		result = (Temporal *)tpointseq_simplify((TemporalSeq *)temp, eps,
+			method);
+	else /* temp->duration == TEMPORALS */
+		result = (Temporal *)tpoints_simplify((TemporalS *)temp, eps, method);
+	return result;
+}
+
+/*
+ * Simplify a temporal point with the Douglas-Peucker algorithm, using
+ * either the synchronized or the spatial distance
+ */
+
+PG_FUNCTION_INFO_V1(tpoint_simplify);
+
+PGDLLEXPORT Datum
+tpoint_simplify(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	double eps = PG_GETARG_FLOAT8(1);
+	bool synchronized = PG_GETARG_BOOL(2);
+	Temporal *result = tpoint_simplify_internal(temp, eps,
+		synchronized ? SIMPLIFY_SED : SIMPLIFY_DP);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_POINTER(result);
+}
+
+/*
+ * Simplify a temporal point by removing the instants where the speed does
+ * not change by more than the tolerance
+ */
+
+PG_FUNCTION_INFO_V1(tpoint_speed_simplify);
+
+PGDLLEXPORT Datum
+tpoint_speed_simplify(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	double eps = PG_GETARG_FLOAT8(1);
+	Temporal *result = tpoint_simplify_internal(temp, eps, SIMPLIFY_SPEED);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Segment-wise clipping of temporal points with polygons
+ *
+ * When the geometry is a 2D polygon or multipolygon, the restriction of a
+ * segment is computed without calling the intersection function of PostGIS.
+ * The edges of all the rings of the geometry are packed into an R-tree that
+ * is built once per sequence. For each segment, the edges whose bounding box
+ * overlaps the one of the segment give the fractions at which the segment
+ * enters or leaves the geometry, and the midpoint of each piece between two
+ * consecutive fractions tells whether the piece is inside the geometry.
+ *****************************************************************************/
+
+#define CLIP_NODE_CAPACITY	16
+#define CLIP_MAX_LEVELS		16
+
+typedef struct
+{
+	double		xmin;
+	double		ymin;
+	double		xmax;
+	double		ymax;
+} ClipBox;
+
+typedef struct
+{
+	POINT2D		a;
+	POINT2D		b;
+} ClipEdge;
+
+/* Levels of a packed R-tree, where levels[0] contains the bounding boxes of
+ * the indexed items in the order in which they were packed */
+typedef struct
+{
+	int			nlevels;
+	int			levelcount[CLIP_MAX_LEVELS];
+	ClipBox    *levels[CLIP_MAX_LEVELS];
+} ClipRTree;
+
+/* Edges of a polygonal geometry and their packed R-tree */
+typedef struct
+{
+	int			nedges;
+	ClipEdge   *edges;
+	ClipRTree	rtree;
+} ClipPolygon;
+
+/* Fraction of a segment at which it meets the boundary of the geometry */
+typedef struct
+{
+	double		fraction;
+	bool		boundary;
+} ClipFraction;
+
+static inline double
+clip_cross(double x1, double y1, double x2, double y2)
+{
+	return x1 * y2 - y1 * x2;
+}
+
+static inline bool
+clip_box_overlaps(const ClipBox *box1, const ClipBox *box2)
+{
+	return box1->xmin <= box2->xmax && box2->xmin <= box1->xmax &&
+		box1->ymin <= box2->ymax && box2->ymin <= box1->ymax;
+}
+
+static void
+clip_box_of_edge(ClipBox *box, const ClipEdge *edge)
+{
+	box->xmin = Min(edge->a.x, edge->b.x);
+	box->xmax = Max(edge->a.x, edge->b.x);
+	box->ymin = Min(edge->a.y, edge->b.y);
+	box->ymax = Max(edge->a.y, edge->b.y);
+}
+
+static int
+clip_edge_xcmp(const void *e1, const void *e2)
+{
+	const ClipEdge *edge1 = (const ClipEdge *) e1;
+	const ClipEdge *edge2 = (const ClipEdge *) e2;
+	double x1 = edge1->a.x + edge1->b.x;
+	double x2 = edge2->a.x + edge2->b.x;
+	return (x1 < x2) ? -1 : ((x1 > x2) ? 1 : 0);
+}
+
+static int
+clip_edge_ycmp(const void *e1, const void *e2)
+{
+	const ClipEdge *edge1 = (const ClipEdge *) e1;
+	const ClipEdge *edge2 = (const ClipEdge *) e2;
+	double y1 = edge1->a.y + edge1->b.y;
+	double y2 = edge2->a.y + edge2->b.y;
+	return (y1 < y2) ? -1 : ((y1 > y2) ? 1 : 0);
+}
+
+static int
+clip_fraction_cmp(const void *f1, const void *f2)
+{
+	double d1 = ((const ClipFraction *) f1)->fraction;
+	double d2 = ((const ClipFraction *) f2)->fraction;
+	return (d1 < d2) ? -1 : ((d1 > d2) ? 1 : 0);
+}
+
+static void
+clip_add_rings(ClipEdge *edges, int *nedges, const LWPOLY *poly)
+{
+	for (uint32_t i = 0; i < poly->nrings; i++)
+	{
+		POINTARRAY *ring = poly->rings[i];
+		for (uint32_t j = 0; j + 1 < ring->npoints; j++)
+		{
+			ClipEdge *edge = &edges[*nedges];
+			getPoint2d_p(ring, j, &edge->a);
+			getPoint2d_p(ring, j + 1, &edge->b);
+			/* Degenerate edges do not contribute to the boundary */
+			if (edge->a.x != edge->b.x || edge->a.y != edge->b.y)
+				(*nedges)++;
+		}
+	}
+}
+
+/*
+ * Build the upper levels of a packed R-tree whose leaves are the n boxes,
+ * which have been sorted with the sort-tile-recursive algorithm
+ */
+static void
+clip_rtree_make(ClipRTree *tree, ClipBox *leaves, int n)
+{
+	tree->levels[0] = leaves;
+	tree->levelcount[0] = n;
+	int level = 0;
+	while (tree->levelcount[level] > CLIP_NODE_CAPACITY &&
+		level + 1 < CLIP_MAX_LEVELS)
+	{
+		int count = tree->levelcount[level];
+		int parents = (count + CLIP_NODE_CAPACITY - 1) / CLIP_NODE_CAPACITY;
+		ClipBox *children = tree->levels[level];
+		ClipBox *nodes = palloc(sizeof(ClipBox) * parents);
+		for (int i = 0; i < parents; i++)
+		{
+			int first = i * CLIP_NODE_CAPACITY;
+			int last = Min(first + CLIP_NODE_CAPACITY, count);
+			nodes[i] = children[first];
+			for (int j = first + 1; j < last; j++)
+			{
+				nodes[i].xmin = Min(nodes[i].xmin, children[j].xmin);
+				nodes[i].xmax = Max(nodes[i].xmax, children[j].xmax);
+				nodes[i].ymin = Min(nodes[i].ymin, children[j].ymin);
+				nodes[i].ymax = Max(nodes[i].ymax, children[j].ymax);
+			}
+		}
+		level++;
+		tree->levels[level] = nodes;
+		tree->levelcount[level] = parents;
+	}
+	tree->nlevels = level + 1;
+}
+
+static void
+clip_rtree_free(ClipRTree *tree)
+{
+	for (int i = 0; i < tree->nlevels; i++)
+		pfree(tree->levels[i]);
+}
+
+/*
+ * Returns the edges of a 2D polygon or multipolygon indexed by an R-tree,
+ * or NULL if the geometry is of another type, in which case the restriction
+ * is computed with PostGIS
+ */
+static ClipPolygon *
+clip_polygon_make(Datum geom)
+{
+	GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(geom);
+	int type = gserialized_get_type(gs);
+	if ((type != POLYGONTYPE && type != MULTIPOLYGONTYPE) ||
+		FLAGS_GET_Z(gs->flags) || gserialized_is_empty(gs))
+		return NULL;
+
+	LWGEOM *lwgeom = lwgeom_from_gserialized(gs);
+	int npoints = lwgeom_count_vertices(lwgeom);
+	ClipPolygon *result = palloc(sizeof(ClipPolygon));
+	result->edges = palloc(sizeof(ClipEdge) * npoints);
+	result->nedges = 0;
+	if (type == POLYGONTYPE)
+		clip_add_rings(result->edges, &result->nedges, lwgeom_as_lwpoly(lwgeom));
+	else
+	{
+		LWMPOLY *mpoly = lwgeom_as_lwmpoly(lwgeom);
+		for (uint32_t i = 0; i < mpoly->ngeoms; i++)
+			clip_add_rings(result->edges, &result->nedges, mpoly->geoms[i]);
+	}
+	lwgeom_free(lwgeom);
+	int n = result->nedges;
+
+	/* Sort-tile-recursive packing of the edges into leaves */
+	qsort(result->edges, n, sizeof(ClipEdge), &clip_edge_xcmp);
+	int nleaves = (n + CLIP_NODE_CAPACITY - 1) / CLIP_NODE_CAPACITY;
+	int slice = CLIP_NODE_CAPACITY * (int) ceil(sqrt((double) nleaves));
+	for (int i = 0; i < n; i += slice)
+		qsort(&result->edges[i], Min(slice, n - i), sizeof(ClipEdge),
+			&clip_edge_ycmp);
+
+	ClipBox *leaves = palloc(sizeof(ClipBox) * n);
+	for (int i = 0; i < n; i++)
+		clip_box_of_edge(&leaves[i], &result->edges[i]);
+	clip_rtree_make(&result->rtree, leaves, n);
+	return result;
+}
+
+static void
+clip_polygon_free(ClipPolygon *poly)
+{
+	clip_rtree_free(&poly->rtree);
+	pfree(poly->edges);
+	pfree(poly);
+}
+
+/*
+ * Collect in result the leaves whose bounding box overlaps the query box
+ */
+static void
+clip_rtree_search1(const ClipRTree *tree, int level, int node,
+	const ClipBox *query, int *result, int *count)
+{
+	if (! clip_box_overlaps(&tree->levels[level][node], query))
+		return;
+	if (level == 0)
+	{
+		result[(*count)++] = node;
+		return;
+	}
+	int first = node * CLIP_NODE_CAPACITY;
+	int last = Min(first + CLIP_NODE_CAPACITY, tree->levelcount[level - 1]);
+	for (int i = first; i < last; i++)
+		clip_rtree_search1(tree, level - 1, i, query, result, count);
+}
+
+static int
+clip_rtree_search(const ClipRTree *tree, const ClipBox *query, int *result)
+{
+	int count = 0;
+	int top = tree->nlevels - 1;
+	for (int i = 0; i < tree->levelcount[top]; i++)
+		clip_rtree_search1(tree, top, i, query, result, &count);
+	return count;
+}
+
+/*
+ * Returns 1, 0, or -1 depending on whether the point is in the interior,
+ * on the boundary, or in the exterior of the geometry. Rays are cast in the
+ * direction of the X axis so only the edges to the right of the point are
+ * considered.
+ */
+static int
+clip_point_location(const ClipPolygon *poly, const POINT2D *p, int *edges)
+{
+	ClipBox query = { p->x, p->y, DBL_MAX, p->y };
+	int count = clip_rtree_search(&poly->rtree, &query, edges);
+	bool inside = false;
+	for (int i = 0; i < count; i++)
+	{
+		const ClipEdge *edge = &poly->edges[edges[i]];
+		const POINT2D *a = &edge->a, *b = &edge->b;
+		if (clip_cross(b->x - a->x, b->y - a->y, p->x - a->x, p->y - a->y) == 0 &&
+			Min(a->x, b->x) <= p->x && p->x <= Max(a->x, b->x) &&
+			Min(a->y, b->y) <= p->y && p->y <= Max(a->y, b->y))
+			return 0;
+		if ((a->y > p->y) != (b->y > p->y))
+		{
+			double x = a->x + (p->y - a->y) * (b->x - a->x) / (b->y - a->y);
+			if (p->x < x)
+				inside = ! inside;
+		}
+	}
+	return inside ? 1 : -1;
+}
+
+static bool
+clip_point_intersects(const ClipPolygon *poly, const POINT2D *p)
+{
+	int *edges = palloc(sizeof(int) * Max(poly->nedges, 1));
+	bool result = clip_point_location(poly, p, edges) >= 0;
+	pfree(edges);
+	return result;
+}
+
+/*
+ * Restrict a linear segment to a polygonal geometry. The fractions of the
+ * segment at its endpoints and at its intersections with the edges of the
+ * geometry split the segment into pieces that are either completely inside
+ * or completely outside the geometry.
+ */
+static TemporalSeq **
+tpointseq_clip_segment(TemporalInst *inst1, TemporalInst *inst2,
+	bool lower_inc, bool upper_inc, const ClipPolygon *poly, int *count)
+{
+	POINT2D a = datum_get_point2d(temporalinst_value(inst1));
+	POINT2D b = datum_get_point2d(temporalinst_value(inst2));
+	double rx = b.x - a.x, ry = b.y - a.y;
+	ClipBox query = { Min(a.x, b.x), Min(a.y, b.y), Max(a.x, b.x), Max(a.y, b.y) };
+	int *edges = palloc(sizeof(int) * Max(poly->nedges, 1));
+	int countedges = clip_rtree_search(&poly->rtree, &query, edges);
+	ClipFraction *fractions = palloc(sizeof(ClipFraction) * (2 * countedges + 2));
+	int nfrac = 0;
+	fractions[nfrac].fraction = 0.0;
+	fractions[nfrac++].boundary = false;
+	fractions[nfrac].fraction = 1.0;
+	fractions[nfrac++].boundary = false;
+	for (int i = 0; i < countedges; i++)
+	{
+		const ClipEdge *edge = &poly->edges[edges[i]];
+		double sx = edge->b.x - edge->a.x, sy = edge->b.y - edge->a.y;
+		double qx = edge->a.x - a.x, qy = edge->a.y - a.y;
+		double denom = clip_cross(rx, ry, sx, sy);
+		double num = clip_cross(qx, qy, rx, ry);
+		if (denom != 0)
+		{
+			double t = clip_cross(qx, qy, sx, sy) / denom;
+			double u = num / denom;
+			if (t >= 0.0 && t <= 1.0 && u >= 0.0 && u <= 1.0)
+			{
+				fractions[nfrac].fraction = t;
+				fractions[nfrac++].boundary = true;
+			}
+		}
+		else if (num == 0)
+		{
+			/* Collinear edge: keep the overlap of both segments, if any */
+			double rr = rx * rx + ry * ry;
+			double t1 = (qx * rx + qy * ry) / rr;
+			double t2 = ((edge->b.x - a.x) * rx + (edge->b.y - a.y) * ry) / rr;
+			double lower = Max(Min(t1, t2), 0.0);
+			double upper = Min(Max(t1, t2), 1.0);
+			if (lower <= upper)
+			{
+				fractions[nfrac].fraction = lower;
+				fractions[nfrac++].boundary = true;
+				fractions[nfrac].fraction = upper;
+				fractions[nfrac++].boundary = true;
+			}
+		}
+	}
+	qsort(fractions, nfrac, sizeof(ClipFraction), &clip_fraction_cmp);
+	int k = 0;
+	for (int i = 1; i < nfrac; i++)
+	{
+		if (fractions[i].fraction == fractions[k].fraction)
+			fractions[k].boundary |= fractions[i].boundary;
+		else
+			fractions[++k] = fractions[i];
+	}
+	nfrac = k + 1;
+
+	/* Classify the pieces between consecutive fractions by their midpoint */
+	bool *inpiece = palloc(sizeof(bool) * nfrac);
+	for (int i = 0; i < nfrac - 1; i++)
+	{
+		double f = (fractions[i].fraction + fractions[i + 1].fraction) / 2;
+		POINT2D p = { a.x + rx * f, a.y + ry * f };
+		inpiece[i] = clip_point_location(poly, &p, edges) >= 0;
+	}
+
+	TemporalSeq **result = palloc(sizeof(TemporalSeq *) * nfrac);
+	TemporalInst *instants[2];
+	double duration = (double)(inst2->t - inst1->t);
+	k = 0;
+	int i = 0;
+	while (i < nfrac)
+	{
+		TimestampTz lower1 = inst1->t + (TimestampTz) (duration * fractions[i].fraction);
+		TimestampTz upper1 = lower1;
+		bool touches;
+		if (i < nfrac - 1 && inpiece[i])
+		{
+			/* Merge the consecutive pieces inside the geometry */
+			while (i < nfrac - 1 && inpiece[i])
+				i++;
+			upper1 = inst1->t + (TimestampTz) (duration * fractions[i].fraction);
+			touches = true;
+		}
+		else if (fractions[i].boundary)
+			touches = true;
+		else
+		{
+			/* Only the endpoints of the segment are not on the boundary */
+			POINT2D p = (i == 0) ? a : b;
+			touches = clip_point_location(poly, &p, edges) >= 0;
+		}
+		i++;
+		/* Skip the instants that are already in the previous piece */
+		if (! touches || (k > 0 && upper1 <= result[k - 1]->period.upper))
+			continue;
+
+		/* Restriction at timestamp done to avoid floating point imprecision */
+		if (lower1 < upper1)
+		{
+			instants[0] = temporalseq_at_timestamp1(inst1, inst2, true, lower1);
+			instants[1] = temporalseq_at_timestamp1(inst1, inst2, true, upper1);
+			bool lower_inc1 = timestamp_cmp_internal(lower1, inst1->t) == 0 ?
+				lower_inc : true;
+			bool upper_inc1 = timestamp_cmp_internal(upper1, inst2->t) == 0 ?
+				upper_inc : true;
+			result[k++] = temporalseq_from_temporalinstarr(instants, 2,
+				lower_inc1, upper_inc1, true, false);
+			pfree(instants[0]); pfree(instants[1]);
+		}
+		/* If the intersection is not at an exclusive bound */
+		else if ((lower_inc || lower1 > inst1->t) && (upper_inc || lower1 < inst2->t))
+		{
+			instants[0] = temporalseq_at_timestamp1(inst1, inst2, true, lower1);
+			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
+				true, true, true, false);
+			pfree(instants[0]);
+		}
+	}
+
+	pfree(edges); pfree(fractions); pfree(inpiece);
+	if (k == 0)
+	{
+		pfree(result);
+		*count = 0;
+		return NULL;
+	}
+	*count = k;
+	return result;
+}
+
+/*****************************************************************************
+ * Restriction functions
+ * N.B. In the current version of PostGIS (2.5) there is no true ST_Intersection
+ * function for geography
+ *****************************************************************************/
+
+/* Restrict a temporal point to a geometry */
+
+static TemporalInst *
+tpointinst_at_geometry(TemporalInst *inst, Datum geom)
+{
+	if (!DatumGetBool(call_function2(intersects, temporalinst_value(inst), geom)))
+		return NULL;
+	return temporalinst_copy(inst);
+}
+
+static TemporalI *
+tpointi_at_geometry(TemporalI *ti, Datum geom)
+{
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
+	int k = 0;
+	for (int i = 0; i < ti->count; i++)
+	{
+		TemporalInst *inst = temporali_inst_n(ti, i);
+		if (DatumGetBool(call_function2(intersects, temporalinst_value(inst), geom)))
+			instants[k++] = inst;
+	}
+	TemporalI *result = NULL;
+	if (k != 0)
+		result = temporali_from_temporalinstarr(instants, k);
+	/* We do not need to pfree the instants */
+	pfree(instants);
+	return result;
+}
+
+/*
+ * This function assumes that inst1 and inst2 have equal SRID and that the
+ * points and the geometry are in 2D
+ */
+static TemporalSeq **
+tpointseq_at_geometry1(TemporalInst *inst1, TemporalInst *inst2, bool linear,
+	bool lower_inc, bool upper_inc, Datum geom, const ClipPolygon *poly,
+	int *count)
+{
+	Datum value1 = temporalinst_value(inst1);
+	Datum value2 = temporalinst_value(inst2);
+
+	/* Constant segment or stepwise interpolation */
+	bool equal = datum_point_eq(value1, value2);
+	if (equal || ! linear)
+	{
+		bool inter;
+		if (poly != NULL)
+		{
+			POINT2D p = datum_get_point2d(value1);
+			inter = clip_point_intersects(poly, &p);
+		}
+		else
+			inter = DatumGetBool(call_function2(intersects, value1, geom));
+		if (! inter)
+		{
+			*count = 0;
+			return NULL;
+		}
+
+		TemporalInst *instants[2];
+		instants[0] = inst1;
+		instants[1] = equal ? inst2 :
+			temporalinst_make(value1, inst2->t, inst1->valuetypid);
+		TemporalSeq **result = palloc(sizeof(TemporalSeq *));
+		result[0] = temporalseq_from_temporalinstarr(instants, 2,
+			lower_inc, upper_inc, linear, false);
+		*count = 1;
+		if (! equal)
+			pfree(instants[1]);
+		return result;
+	}
+
+	/* Polygonal geometry */
+	if (poly != NULL)
+		return tpointseq_clip_segment(inst1, inst2, lower_inc, upper_inc,
+			poly, count);
+
+	/* Look for intersections */
+	Datum line = geompoint_trajectory(value1, value2);
+	MOBDB_STAT_INC(geos_calls);
+	Datum intersections = call_function2(intersection, line, geom);
+	if (DatumGetBool(call_function1(LWGEOM_isempty, intersections)))
+	{
+		pfree(DatumGetPointer(line));
+		pfree(DatumGetPointer(intersections));
+		*count = 0;
+		return NULL;
+	}
+
+	int countinter = DatumGetInt32(call_function1(
+		LWGEOM_numgeometries_collection, intersections));
+	TemporalInst *instants[2];
+	TemporalSeq **result = palloc(sizeof(TemporalSeq *) * countinter);
+	double duration = (double)(inst2->t - inst1->t);
+	int k = 0;
+	for (int i = 1; i <= countinter; i++)
+	{
+		/* Find the i-th intersection */
+		Datum inter = call_function2(LWGEOM_geometryn_collection,
+			intersections, Int32GetDatum(i));
+		GSERIALIZED *gsinter = (GSERIALIZED *) PG_DETOAST_DATUM(inter);
+
+		/* Each intersection is either a point or a linestring with two points */
+		if (gserialized_get_type(gsinter) == POINTTYPE)
+		{
+			double fraction = DatumGetFloat8(call_function2(
+				LWGEOM_line_locate_point, line, inter));
+			TimestampTz t = inst1->t + (long) (duration * fraction);
+			/* If the intersection is not at an exclusive bound */
+			if ((lower_inc || t > inst1->t) && (upper_inc || t < inst2->t))
+			{
+				/* Restriction at timestamp done to avoid floating point imprecision */
+				instants[0] = temporalseq_at_timestamp1(inst1, inst2, linear, t);
+				result[k++] = temporalseq_from_temporalinstarr(instants, 1,
+					true, true, linear, false);
+				pfree(instants[0]);
+			}
+		}
+		else
+		{
+			Datum point1 = call_function2(LWGEOM_pointn_linestring,
+				inter, Int32GetDatum(1));
+			Datum point2 = call_function2(LWGEOM_pointn_linestring,
+				inter, Int32GetDatum(2));
+			double fraction1 = DatumGetFloat8(call_function2(
+				LWGEOM_line_locate_point, line, point1));
+			double fraction2 = DatumGetFloat8(call_function2(
+				LWGEOM_line_locate_point, line, point2));
+			TimestampTz t1 = inst1->t + (long) (duration * fraction1);
+			TimestampTz t2 = inst1->t + (long) (duration * fraction2);
+			TimestampTz lower1 = Min(t1, t2);
+			TimestampTz upper1 = Max(t1, t2);
+			/* Restriction at timestamp done to avoid floating point imprecision */
+			instants[0] = temporalseq_at_timestamp1(inst1, inst2, linear, lower1);
+			instants[1] = temporalseq_at_timestamp1(inst1, inst2, linear, upper1);
+			bool lower_inc1 = timestamp_cmp_internal(lower1, inst1->t) == 0 ?
+				lower_inc : true;
+			bool upper_inc1 = timestamp_cmp_internal(upper1, inst2->t) == 0 ?
+				upper_inc : true;
+			result[k++] = temporalseq_from_temporalinstarr(instants, 2,
+					lower_inc1, upper_inc1, linear, false);
+			pfree(instants[0]); pfree(instants[1]);
+			pfree(DatumGetPointer(point1)); pfree(DatumGetPointer(point2));
+		}
+		POSTGIS_FREE_IF_COPY_P(gsinter, DatumGetPointer(inter));
+	}
+
+	pfree(DatumGetPointer(line));
+	pfree(DatumGetPointer(intersections));
+
+	if (k == 0)
+	{
+		pfree(result);
+		*count = 0;
+		return NULL;
+	}
+
+	temporalseqarr_sort(result, k);
+	*count = k;
+	return result;
+}
+
+TemporalSeq **
+tpointseq_at_geometry2(TemporalSeq *seq, Datum geom, int *count)
+{
+	/* Instantaneous sequence */
+	if (seq->count == 1)
+	{
+		/* Due to the bounding box test in the calling function we are sure
+		 * that the point intersects the geometry */
+		TemporalSeq **result = palloc(sizeof(TemporalSeq *));
+		result[0] = temporalseq_copy(seq);
+		*count = 1;
+		return result;
+	}
+
+	/* Temporal sequence has at least 2 instants */
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	ClipPolygon *poly = MOBDB_FLAGS_GET_Z(seq->flags) ? NULL :
+		clip_polygon_make(geom);
+	TemporalSeq ***sequences = palloc(sizeof(TemporalSeq *) * (seq->count - 1));
+	int *countseqs = palloc0(sizeof(int) * (seq->count - 1));
+	int totalseqs = 0;
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	bool lower_inc = seq->period.lower_inc;
+	for (int i = 0; i < seq->count - 1; i++)
+	{
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i + 1);
+		bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false;
+		sequences[i] = tpointseq_at_geometry1(inst1, inst2, linear,
+			lower_inc, upper_inc, geom, poly, &countseqs[i]);
+		totalseqs += countseqs[i];
+		inst1 = inst2;
+		lower_inc = true;
+	}
+	if (poly != NULL)
+		clip_polygon_free(poly);
+	if (totalseqs == 0)
+	{
+		pfree(countseqs);
+		pfree(sequences);
+		*count = 0;
+		return NULL;
+	}
+
+	TemporalSeq **result = palloc(sizeof(TemporalSeq *) * totalseqs);
+	int k = 0;
+	for (int i = 0; i < seq->count - 1; i++)
+	{
+		for (int j = 0; j < countseqs[i]; j++)
+			result[k++] = sequences[i][j];
+		if (sequences[i] != NULL)
+			pfree(sequences[i]);
+	}
+
+	pfree(countseqs);
+	pfree(sequences);
+	*count = totalseqs;
 	return result;
 }
 
@@ -1907,6 +3321,370 @@ tpoint_at_geometry(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Restriction of a temporal point to a set of zones
+ *
+ * The zones, given as arrays of identifiers and geometries, are indexed by a
+ * packed R-tree over their bounding boxes, and the polygonal zones keep the
+ * R-tree over their edges used for clipping. Both are built once and kept
+ * in fn_extra while the function is called with the same arrays, e.g., when
+ * they are computed by a subquery. The temporal point is then traversed
+ * once, each segment being only restricted to the zones whose bounding box
+ * overlaps the one of the segment.
+ *****************************************************************************/
+
+/* Leaf of the R-tree of the zones before packing */
+typedef struct
+{
+	ClipBox		box;
+	int			zone;
+} ZoneEntry;
+
+typedef struct
+{
+	MemoryContext mcxt;			/* Context of the cache */
+	ArrayType  *ids;			/* Copies of the arguments, which are compared */
+	ArrayType  *geoms;			/* byte by byte with those of the next call */
+	int			count;			/* Number of zones */
+	int32	   *zoneids;
+	GSERIALIZED **zonegeoms;
+	ClipPolygon **polys;		/* NULL for the zones that are not 2D polygons */
+	int			nentries;		/* Number of non-empty zones */
+	int		   *entries;		/* Zone of each leaf of the R-tree */
+	ClipRTree	rtree;
+} ZoneCache;
+
+/* Pieces of the temporal point in a zone */
+typedef struct
+{
+	int			count;
+	int			maxcount;
+	Temporal  **pieces;
+} ZoneParts;
+
+static int
+zone_entry_xcmp(const void *e1, const void *e2)
+{
+	const ClipBox *box1 = &((const ZoneEntry *) e1)->box;
+	const ClipBox *box2 = &((const ZoneEntry *) e2)->box;
+	double x1 = box1->xmin + box1->xmax;
+	double x2 = box2->xmin + box2->xmax;
+	return (x1 < x2) ? -1 : ((x1 > x2) ? 1 : 0);
+}
+
+static int
+zone_entry_ycmp(const void *e1, const void *e2)
+{
+	const ClipBox *box1 = &((const ZoneEntry *) e1)->box;
+	const ClipBox *box2 = &((const ZoneEntry *) e2)->box;
+	double y1 = box1->ymin + box1->ymax;
+	double y2 = box2->ymin + box2->ymax;
+	return (y1 < y2) ? -1 : ((y1 > y2) ? 1 : 0);
+}
+
+static ArrayType *
+zone_array_copy(ArrayType *array)
+{
+	ArrayType *result = palloc(VARSIZE(array));
+	memcpy(result, array, VARSIZE(array));
+	return result;
+}
+
+static bool
+zone_array_eq(ArrayType *array1, ArrayType *array2)
+{
+	return VARSIZE(array1) == VARSIZE(array2) &&
+		memcmp(array1, array2, VARSIZE(array1)) == 0;
+}
+
+static ZoneCache *
+zone_cache_make(ArrayType *ids, ArrayType *geoms, MemoryContext parent)
+{
+	if (ARR_HASNULL(ids) || ARR_HASNULL(geoms))
+		ereport(ERROR, (errcode(ERRCODE_NULL_VALUE_NOT_ALLOWED),
+			errmsg("The arrays of zones must not contain nulls")));
+	if (ArrayGetNItems(ARR_NDIM(ids), ARR_DIMS(ids)) !=
+		ArrayGetNItems(ARR_NDIM(geoms), ARR_DIMS(geoms)))
+		ereport(ERROR, (errcode(ERRCODE_ARRAY_SUBSCRIPT_ERROR),
+			errmsg("The arrays of identifiers and geometries must have the same length")));
+
+	MemoryContext mcxt = AllocSetContextCreate(parent, "zone cache",
+		ALLOCSET_DEFAULT_SIZES);
+	MemoryContext oldcontext = MemoryContextSwitchTo(mcxt);
+	ZoneCache *result = palloc(sizeof(ZoneCache));
+	result->mcxt = mcxt;
+	result->ids = zone_array_copy(ids);
+	result->geoms = zone_array_copy(geoms);
+	Datum *idvalues, *geomvalues;
+	int count;
+	deconstruct_array(result->ids, INT4OID, 4, true, 'i', &idvalues,
+		NULL, &count);
+	deconstruct_array(result->geoms, ARR_ELEMTYPE(geoms), -1, false, 'd',
+		&geomvalues, NULL, &count);
+	result->count = count;
+	result->zoneids = palloc(sizeof(int32) * Max(count, 1));
+	result->zonegeoms = palloc(sizeof(GSERIALIZED *) * Max(count, 1));
+	result->polys = palloc(sizeof(ClipPolygon *) * Max(count, 1));
+	ZoneEntry *entries = palloc(sizeof(ZoneEntry) * Max(count, 1));
+	int n = 0;
+	for (int i = 0; i < count; i++)
+	{
+		GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(geomvalues[i]);
+		result->zoneids[i] = DatumGetInt32(idvalues[i]);
+		result->zonegeoms[i] = gs;
+		result->polys[i] = NULL;
+		if (gserialized_is_empty(gs))
+			continue;
+		result->polys[i] = clip_polygon_make(geomvalues[i]);
+		STBOX box;
+		memset(&box, 0, sizeof(STBOX));
+		geo_to_stbox_internal(&box, gs);
+		entries[n].box.xmin = box.xmin;
+		entries[n].box.ymin = box.ymin;
+		entries[n].box.xmax = box.xmax;
+		entries[n].box.ymax = box.ymax;
+		entries[n++].zone = i;
+	}
+
+	/* Sort-tile-recursive packing of the zones into leaves */
+	qsort(entries, n, sizeof(ZoneEntry), &zone_entry_xcmp);
+	int nleaves = (n + CLIP_NODE_CAPACITY - 1) / CLIP_NODE_CAPACITY;
+	int slice = CLIP_NODE_CAPACITY * (int) ceil(sqrt((double) nleaves));
+	for (int i = 0; i < n; i += slice)
+		qsort(&entries[i], Min(slice, n - i), sizeof(ZoneEntry),
+			&zone_entry_ycmp);
+	ClipBox *leaves = palloc(sizeof(ClipBox) * Max(n, 1));
+	result->entries = palloc(sizeof(int) * Max(n, 1));
+	for (int i = 0; i < n; i++)
+	{
+		leaves[i] = entries[i].box;
+		result->entries[i] = entries[i].zone;
+	}
+	clip_rtree_make(&result->rtree, leaves, n);
+	result->nentries = n;
+	pfree(entries); pfree(idvalues); pfree(geomvalues);
+	MemoryContextSwitchTo(oldcontext);
+	return result;
+}
+
+/*
+ * Zones cached in the fn_extra of the calling function, which are rebuilt
+ * when the arrays differ from those of the previous call
+ */
+static ZoneCache *
+zone_cache_get(FunctionCallInfo fcinfo, ArrayType *ids, ArrayType *geoms)
+{
+	ZoneCache *cache = (ZoneCache *) fcinfo->flinfo->fn_extra;
+	if (cache != NULL && zone_array_eq(cache->ids, ids) &&
+		zone_array_eq(cache->geoms, geoms))
+		return cache;
+	if (cache != NULL)
+	{
+		fcinfo->flinfo->fn_extra = NULL;
+		MemoryContextDelete(cache->mcxt);
+	}
+	cache = zone_cache_make(ids, geoms, fcinfo->flinfo->fn_mcxt);
+	fcinfo->flinfo->fn_extra = cache;
+	return cache;
+}
+
+static void
+zone_parts_add(ZoneParts *parts, Temporal *piece)
+{
+	if (parts->count == parts->maxcount)
+	{
+		parts->maxcount = Max(parts->maxcount * 2, 4);
+		parts->pieces = (parts->pieces == NULL) ?
+			palloc(sizeof(Temporal *) * parts->maxcount) :
+			repalloc(parts->pieces, sizeof(Temporal *) * parts->maxcount);
+	}
+	parts->pieces[parts->count++] = piece;
+}
+
+/*
+ * Does the point intersect the zone? The zone is one of those returned by
+ * the R-tree and is therefore not empty.
+ */
+static bool
+zone_point_intersects(const ZoneCache *cache, int zone, Datum value)
+{
+	if (cache->polys[zone] != NULL)
+	{
+		POINT2D p = datum_get_point2d(value);
+		return clip_point_intersects(cache->polys[zone], &p);
+	}
+	return DatumGetBool(call_function2(intersects, value,
+		PointerGetDatum(cache->zonegeoms[zone])));
+}
+
+/*
+ * Add the instant to the zones it intersects. The instants are not copied.
+ */
+static void
+tpointinst_at_zones(const ZoneCache *cache, TemporalInst *inst,
+	ZoneParts *parts, int *leaves)
+{
+	Datum value = temporalinst_value(inst);
+	POINT2D p = datum_get_point2d(value);
+	ClipBox query = { p.x, p.y, p.x, p.y };
+	int count = clip_rtree_search(&cache->rtree, &query, leaves);
+	for (int i = 0; i < count; i++)
+	{
+		int zone = cache->entries[leaves[i]];
+		if (zone_point_intersects(cache, zone, value))
+			zone_parts_add(&parts[zone], (Temporal *) inst);
+	}
+}
+
+/*
+ * Add the pieces of the sequence in the zones in a single pass over its
+ * segments
+ */
+static void
+tpointseq_at_zones(const ZoneCache *cache, TemporalSeq *seq,
+	ZoneParts *parts, int *leaves)
+{
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	/* Instantaneous sequence */
+	if (seq->count == 1)
+	{
+		Datum value = temporalinst_value(inst1);
+		POINT2D p = datum_get_point2d(value);
+		ClipBox query = { p.x, p.y, p.x, p.y };
+		int count = clip_rtree_search(&cache->rtree, &query, leaves);
+		for (int i = 0; i < count; i++)
+		{
+			int zone = cache->entries[leaves[i]];
+			if (zone_point_intersects(cache, zone, value))
+				zone_parts_add(&parts[zone], (Temporal *) temporalseq_copy(seq));
+		}
+		return;
+	}
+
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	bool lower_inc = seq->period.lower_inc;
+	for (int i = 0; i < seq->count - 1; i++)
+	{
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i + 1);
+		bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false;
+		POINT2D a = datum_get_point2d(temporalinst_value(inst1));
+		POINT2D b = datum_get_point2d(temporalinst_value(inst2));
+		ClipBox query = { Min(a.x, b.x), Min(a.y, b.y), Max(a.x, b.x), Max(a.y, b.y) };
+		int count = clip_rtree_search(&cache->rtree, &query, leaves);
+		for (int j = 0; j < count; j++)
+		{
+			int zone = cache->entries[leaves[j]];
+			int countseqs;
+			TemporalSeq **sequences = tpointseq_at_geometry1(inst1, inst2,
+				linear, lower_inc, upper_inc,
+				PointerGetDatum(cache->zonegeoms[zone]), cache->polys[zone],
+				&countseqs);
+			for (int k = 0; k < countseqs; k++)
+				zone_parts_add(&parts[zone], (Temporal *) sequences[k]);
+			if (sequences != NULL)
+				pfree(sequences);
+		}
+		inst1 = inst2;
+		lower_inc = true;
+	}
+}
+
+/*
+ * Restrict a temporal point to each zone of a set. The function returns one
+ * row per zone that the temporal point intersects, composed of the
+ * identifier of the zone and the restriction of the temporal point to it,
+ * which is the same as the result of atGeometry.
+ */
+
+PG_FUNCTION_INFO_V1(tpoint_at_geometries);
+
+PGDLLEXPORT Datum
+tpoint_at_geometries(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	ArrayType *ids = PG_GETARG_ARRAYTYPE_P(1);
+	ArrayType *geoms = PG_GETARG_ARRAYTYPE_P(2);
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext oldcontext;
+
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo) ||
+		!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("set-valued function called in context that cannot accept a set")));
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("function returning record called in context "
+				"that cannot accept type record")));
+	ZoneCache *cache = zone_cache_get(fcinfo, ids, geoms);
+	for (int i = 0; i < cache->count; i++)
+	{
+		ensure_same_srid_tpoint_gs(temp, cache->zonegeoms[i]);
+		ensure_same_dimensionality_tpoint_gs(temp, cache->zonegeoms[i]);
+	}
+
+	ZoneParts *parts = palloc0(sizeof(ZoneParts) * Max(cache->count, 1));
+	int *leaves = palloc(sizeof(int) * Max(cache->nentries, 1));
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+		tpointinst_at_zones(cache, (TemporalInst *) temp, parts, leaves);
+	else if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *) temp;
+		for (int i = 0; i < ti->count; i++)
+			tpointinst_at_zones(cache, temporali_inst_n(ti, i), parts, leaves);
+	}
+	else if (temp->duration == TEMPORALSEQ)
+		tpointseq_at_zones(cache, (TemporalSeq *) temp, parts, leaves);
+	else if (temp->duration == TEMPORALS)
+	{
+		TemporalS *ts = (TemporalS *) temp;
+		for (int i = 0; i < ts->count; i++)
+			tpointseq_at_zones(cache, temporals_seq_n(ts, i), parts, leaves);
+	}
+	pfree(leaves);
+
+	oldcontext = MemoryContextSwitchTo(rsinfo->econtext->ecxt_per_query_memory);
+	tupdesc = BlessTupleDesc(CreateTupleDescCopy(tupdesc));
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+	MemoryContextSwitchTo(oldcontext);
+
+	bool linear = MOBDB_FLAGS_GET_LINEAR(temp->flags);
+	for (int i = 0; i < cache->count; i++)
+	{
+		ZoneParts *zone = &parts[i];
+		if (zone->count == 0)
+			continue;
+		Temporal *result;
+		if (temp->duration == TEMPORALINST)
+			result = (Temporal *) temporalinst_copy((TemporalInst *) zone->pieces[0]);
+		else if (temp->duration == TEMPORALI)
+			result = (Temporal *) temporali_from_temporalinstarr(
+				(TemporalInst **) zone->pieces, zone->count);
+		else
+		{
+			result = (Temporal *) temporals_from_temporalseqarr(
+				(TemporalSeq **) zone->pieces, zone->count, linear, true);
+			for (int j = 0; j < zone->count; j++)
+				pfree(zone->pieces[j]);
+		}
+		Datum values[2];
+		bool isnull[2] = {false, false};
+		values[0] = Int32GetDatum(cache->zoneids[i]);
+		values[1] = PointerGetDatum(result);
+		tuplestore_putvalues(tupstore, tupdesc, values, isnull);
+		pfree(result);
+		pfree(zone->pieces);
+	}
+	pfree(parts);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_NULL();
+}
+
 /*****************************************************************************/
 
 /* Restrict a temporal point to the complement of a geometry */
@@ -2049,51 +3827,290 @@ tpoints_minus_geometry(TemporalS *ts, GSERIALIZED *gs, STBOX *box2)
 	return result;
 }
 
-PG_FUNCTION_INFO_V1(tpoint_minus_geometry);
+PG_FUNCTION_INFO_V1(tpoint_minus_geometry);
+
+PGDLLEXPORT Datum
+tpoint_minus_geometry(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
+	ensure_same_srid_tpoint_gs(temp, gs);
+	ensure_same_dimensionality_tpoint_gs(temp, gs);
+	/* Bounding box test */
+	STBOX box1, box2;
+	memset(&box1, 0, sizeof(STBOX));
+	memset(&box2, 0, sizeof(STBOX));
+	if (!geo_to_stbox_internal(&box2, gs))
+	{
+		Temporal *copy = temporal_copy(temp) ;
+		PG_FREE_IF_COPY(temp, 0);
+		PG_FREE_IF_COPY(gs, 1);
+		PG_RETURN_POINTER(copy);
+	}
+	temporal_bbox(&box1, temp);
+	if (!overlaps_stbox_stbox_internal(&box1, &box2))
+	{
+		Temporal *copy = temporal_copy(temp) ;
+		PG_FREE_IF_COPY(temp, 0);
+		PG_FREE_IF_COPY(gs, 1);
+		PG_RETURN_POINTER(copy);
+	}
+
+	Temporal *result = NULL;
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+		result = (Temporal *)tpointinst_minus_geometry((TemporalInst *)temp,
+			PointerGetDatum(gs));
+	else if (temp->duration == TEMPORALI)
+		result = (Temporal *)tpointi_minus_geometry((TemporalI *)temp,
+			PointerGetDatum(gs));
+	else if (temp->duration == TEMPORALSEQ)
+		result = (Temporal *)tpointseq_minus_geometry((TemporalSeq *)temp,
+			PointerGetDatum(gs));
+	else if (temp->duration == TEMPORALS)
+		result = (Temporal *)tpoints_minus_geometry((TemporalS *)temp, gs, &box2);
+
+	PG_FREE_IF_COPY(temp, 0);
+	PG_FREE_IF_COPY(gs, 1);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Restriction to an STBOX
+ *
+ * The segments of the sequences are clipped to the spatial bounds of the box
+ * with the Liang-Barsky algorithm, which gives the fractions of a segment at
+ * which it enters and leaves the box. The temporal point is then restricted
+ * to the periods during which it is inside the box without building the
+ * geometry of the box nor calling GEOS.
+ *****************************************************************************/
+
+/* Coordinates of a point, where z is only set for 3D points */
+
+static void
+stbox_clip_coords(TemporalInst *inst, bool hasz, double *coords)
+{
+	if (hasz)
+	{
+		POINT3DZ p = gs_get_point3dz((GSERIALIZED *)
+			DatumGetPointer(temporalinst_value(inst)));
+		coords[0] = p.x; coords[1] = p.y; coords[2] = p.z;
+	}
+	else
+	{
+		POINT2D p = datum_get_point2d(temporalinst_value(inst));
+		coords[0] = p.x; coords[1] = p.y;
+	}
+}
+
+static bool
+stbox_clip_point(const STBOX *box, TemporalInst *inst, bool hasz)
+{
+	double p[3];
+	stbox_clip_coords(inst, hasz, p);
+	return p[0] >= box->xmin && p[0] <= box->xmax &&
+		p[1] >= box->ymin && p[1] <= box->ymax &&
+		(! hasz || (p[2] >= box->zmin && p[2] <= box->zmax));
+}
+
+/*
+ * Clip the segment defined by the two instants to the spatial bounds of the
+ * box. Returns false if the segment is outside of the box and otherwise sets
+ * the fractions of the segment at which it enters and leaves the box.
+ */
+static bool
+stbox_clip_segment(const STBOX *box, TemporalInst *inst1, TemporalInst *inst2,
+	bool hasz, double *enter, double *leave)
+{
+	double p1[3], p2[3];
+	stbox_clip_coords(inst1, hasz, p1);
+	stbox_clip_coords(inst2, hasz, p2);
+	double lo[3] = {box->xmin, box->ymin, box->zmin};
+	double hi[3] = {box->xmax, box->ymax, box->zmax};
+	*enter = 0.0;
+	*leave = 1.0;
+	for (int k = 0; k < (hasz ? 3 : 2); k++)
+	{
+		double d = p2[k] - p1[k];
+		if (d == 0.0)
+		{
+			if (p1[k] < lo[k] || p1[k] > hi[k])
+				return false;
+			continue;
+		}
+		double r1 = (lo[k] - p1[k]) / d;
+		double r2 = (hi[k] - p1[k]) / d;
+		*enter = Max(*enter, Min(r1, r2));
+		*leave = Min(*leave, Max(r1, r2));
+		if (*enter > *leave)
+			return false;
+	}
+	return true;
+}
+
+/*
+ * Add a period to the array of periods keeping them disjoint, where the
+ * periods are added in increasing order of time and a period is merged with
+ * the previous one when they are adjacent
+ */
+static void
+stbox_clip_add_period(Period *periods, int *count, TimestampTz lower,
+	TimestampTz upper, bool lower_inc, bool upper_inc)
+{
+	if (*count > 0 &&
+		timestamp_cmp_internal(periods[*count - 1].upper, lower) == 0)
+	{
+		periods[*count - 1].upper = upper;
+		periods[*count - 1].upper_inc = upper_inc;
+		return;
+	}
+	period_set(&periods[(*count)++], lower, upper, lower_inc, upper_inc);
+}
+
+/* Periods during which the sequence is inside the box */
+
+static void
+tpointseq_stbox_periods(TemporalSeq *seq, const STBOX *box, bool hasz,
+	Period *periods, int *count)
+{
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	if (seq->count == 1)
+	{
+		if (stbox_clip_point(box, inst1, hasz))
+			stbox_clip_add_period(periods, count, inst1->t, inst1->t,
+				true, true);
+		return;
+	}
+
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	for (int i = 1; i < seq->count; i++)
+	{
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
+		if (! linear)
+		{
+			/* The value of the segment is the one of its first instant */
+			if (stbox_clip_point(box, inst1, hasz))
+				stbox_clip_add_period(periods, count, inst1->t, inst2->t,
+					true, false);
+		}
+		else
+		{
+			double enter, leave;
+			if (stbox_clip_segment(box, inst1, inst2, hasz, &enter, &leave))
+			{
+				double duration = (double) (inst2->t - inst1->t);
+				stbox_clip_add_period(periods, count,
+					inst1->t + (TimestampTz) (duration * enter),
+					inst1->t + (TimestampTz) (duration * leave), true, true);
+			}
+		}
+		inst1 = inst2;
+	}
+	/* Last instant of a sequence with stepwise interpolation */
+	if (! linear && stbox_clip_point(box, inst1, hasz))
+		stbox_clip_add_period(periods, count, inst1->t, inst1->t, true, true);
+}
+
+static Temporal *
+tpoint_at_stbox_internal(Temporal *temp, const STBOX *box, bool hasz)
+{
+	if (temp->duration == TEMPORALINST)
+		return stbox_clip_point(box, (TemporalInst *) temp, hasz) ?
+			(Temporal *) temporalinst_copy((TemporalInst *) temp) : NULL;
+
+	if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *) temp;
+		TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
+		int k = 0;
+		for (int i = 0; i < ti->count; i++)
+		{
+			TemporalInst *inst = temporali_inst_n(ti, i);
+			if (stbox_clip_point(box, inst, hasz))
+				instants[k++] = inst;
+		}
+		TemporalI *result = k == 0 ? NULL :
+			temporali_from_temporalinstarr(instants, k);
+		pfree(instants);
+		return (Temporal *) result;
+	}
+
+	/* Sequence or sequence set */
+	Period *periods;
+	int count = 0;
+	if (temp->duration == TEMPORALSEQ)
+	{
+		TemporalSeq *seq = (TemporalSeq *) temp;
+		periods = palloc(sizeof(Period) * seq->count);
+		tpointseq_stbox_periods(seq, box, hasz, periods, &count);
+	}
+	else
+	{
+		TemporalS *ts = (TemporalS *) temp;
+		periods = palloc(sizeof(Period) * ts->totalcount);
+		for (int i = 0; i < ts->count; i++)
+		{
+			TemporalSeq *seq = temporals_seq_n(ts, i);
+			/* Bounding box test */
+			if (overlaps_stbox_stbox_internal(temporalseq_bbox_ptr(seq), box))
+				tpointseq_stbox_periods(seq, box, hasz, periods, &count);
+		}
+	}
+	Temporal *result = NULL;
+	if (count > 0)
+	{
+		PeriodSet *ps = periodset_from_periods_internal(periods, count);
+		result = temporal_at_periodset_internal(temp, ps);
+		pfree(ps);
+	}
+	pfree(periods);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(tpoint_at_stbox);
 
 PGDLLEXPORT Datum
-tpoint_minus_geometry(PG_FUNCTION_ARGS)
+tpoint_at_stbox(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(1);
-	ensure_same_srid_tpoint_gs(temp, gs);
-	ensure_same_dimensionality_tpoint_gs(temp, gs);
+	STBOX *box = PG_GETARG_STBOX_P(1);
+	if (MOBDB_FLAGS_GET_GEODETIC(box->flags))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The box must not be geodetic")));
 	/* Bounding box test */
-	STBOX box1, box2;
+	STBOX box1;
 	memset(&box1, 0, sizeof(STBOX));
-	memset(&box2, 0, sizeof(STBOX));
-	if (!geo_to_stbox_internal(&box2, gs))
+	temporal_bbox(&box1, temp);
+	if (!overlaps_stbox_stbox_internal(&box1, box))
 	{
-		Temporal *copy = temporal_copy(temp) ;
 		PG_FREE_IF_COPY(temp, 0);
-		PG_FREE_IF_COPY(gs, 1);
-		PG_RETURN_POINTER(copy);
+		PG_RETURN_NULL();
 	}
-	temporal_bbox(&box1, temp);
-	if (!overlaps_stbox_stbox_internal(&box1, &box2))
+
+	/* Restriction to the period of the box */
+	Temporal *temp1 = temp;
+	if (MOBDB_FLAGS_GET_T(box->flags))
 	{
-		Temporal *copy = temporal_copy(temp) ;
-		PG_FREE_IF_COPY(temp, 0);
-		PG_FREE_IF_COPY(gs, 1);
-		PG_RETURN_POINTER(copy);
+		Period p;
+		period_set(&p, box->tmin, box->tmax, true, true);
+		temp1 = temporal_at_period_internal(temp, &p);
 	}
 
-	Temporal *result = NULL;
-	ensure_valid_duration(temp->duration);
-	if (temp->duration == TEMPORALINST)
-		result = (Temporal *)tpointinst_minus_geometry((TemporalInst *)temp,
-			PointerGetDatum(gs));
-	else if (temp->duration == TEMPORALI)
-		result = (Temporal *)tpointi_minus_geometry((TemporalI *)temp,
-			PointerGetDatum(gs));
-	else if (temp->duration == TEMPORALSEQ)
-		result = (Temporal *)tpointseq_minus_geometry((TemporalSeq *)temp,
-			PointerGetDatum(gs));
-	else if (temp->duration == TEMPORALS)
-		result = (Temporal *)tpoints_minus_geometry((TemporalS *)temp, gs, &box2);
+	Temporal *result;
+	if (temp1 == NULL || ! MOBDB_FLAGS_GET_X(box->flags))
+		result = (temp1 == temp) ? temporal_copy(temp) : temp1;
+	else
+	{
+		bool hasz = MOBDB_FLAGS_GET_Z(temp->flags) &&
+			MOBDB_FLAGS_GET_Z(box->flags);
+		result = tpoint_at_stbox_internal(temp1, box, hasz);
+		if (temp1 != temp)
+			pfree(temp1);
+	}
 
 	PG_FREE_IF_COPY(temp, 0);
-	PG_FREE_IF_COPY(gs, 1);
 	if (result == NULL)
 		PG_RETURN_NULL();
 	PG_RETURN_POINTER(result);
@@ -2376,6 +4393,364 @@ NAI_tpoint_geo(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Branch-and-bound computation of the nearest approach between two temporal
+ * geometry points with linear interpolation. Instead of computing the
+ * temporal distance, every pair of segments that are synchronized during a
+ * period is given a lower bound of its distance, namely the distance between
+ * the bounding boxes of the two segments. The pairs are visited by
+ * increasing lower bound and the visit stops as soon as the lower bound
+ * exceeds the best distance found so far.
+ *****************************************************************************/
+
+typedef struct
+{
+	double		lb;			/* Lower bound of the distance */
+	TemporalSeq *seq1;		/* Sequence of the first segment */
+	TemporalSeq *seq2;		/* Sequence of the second segment */
+	int			i;			/* Start instant of the first segment */
+	int			j;			/* Start instant of the second segment */
+	TimestampTz lower;		/* Start of the synchronization period */
+	TimestampTz upper;		/* End of the synchronization period */
+} NASegmentPair;
+
+static int
+NA_segment_pair_cmp(const void *p1, const void *p2)
+{
+	double lb1 = ((const NASegmentPair *) p1)->lb;
+	double lb2 = ((const NASegmentPair *) p2)->lb;
+	return (lb1 < lb2) ? -1 : ((lb1 > lb2) ? 1 : 0);
+}
+
+/* Bounding box of the segment of a sequence starting at the i-th instant */
+
+static void
+NA_segment_box(TemporalSeq *seq, int i, bool hasz, double *min, double *max)
+{
+	int i2 = Min(i + 1, seq->count - 1);
+	Datum value1 = temporalinst_value(temporalseq_inst_n(seq, i));
+	Datum value2 = temporalinst_value(temporalseq_inst_n(seq, i2));
+	if (hasz)
+	{
+		POINT3DZ p1 = datum_get_point3dz(value1);
+		POINT3DZ p2 = datum_get_point3dz(value2);
+		min[0] = Min(p1.x, p2.x); max[0] = Max(p1.x, p2.x);
+		min[1] = Min(p1.y, p2.y); max[1] = Max(p1.y, p2.y);
+		min[2] = Min(p1.z, p2.z); max[2] = Max(p1.z, p2.z);
+	}
+	else
+	{
+		POINT2D p1 = datum_get_point2d(value1);
+		POINT2D p2 = datum_get_point2d(value2);
+		min[0] = Min(p1.x, p2.x); max[0] = Max(p1.x, p2.x);
+		min[1] = Min(p1.y, p2.y); max[1] = Max(p1.y, p2.y);
+		min[2] = max[2] = 0;
+	}
+}
+
+/* Distance between the bounding boxes of two segments */
+
+static double
+NA_segment_pair_lb(TemporalSeq *seq1, int i, TemporalSeq *seq2, int j,
+	bool hasz)
+{
+	double min1[3], max1[3], min2[3], max2[3];
+	NA_segment_box(seq1, i, hasz, min1, max1);
+	NA_segment_box(seq2, j, hasz, min2, max2);
+	double result = 0;
+	for (int k = 0; k < 3; k++)
+	{
+		double gap = Max(min1[k] - max2[k], min2[k] - max1[k]);
+		if (gap > 0)
+			result += gap * gap;
+	}
+	return sqrt(result);
+}
+
+/*
+ * Append to the array the pairs of segments of the two sequences that are
+ * synchronized during a period contained in the intersection of the
+ * periods of the sequences
+ */
+static void
+NA_tpointseq_tpointseq_pairs(TemporalSeq *seq1, TemporalSeq *seq2, bool hasz,
+	NASegmentPair **pairs, int *count, int *maxcount)
+{
+	Period *inter = intersection_period_period_internal(&seq1->period,
+		&seq2->period);
+	if (inter == NULL)
+		return;
+
+	int i = 0, j = 0;
+	while (i < seq1->count - 2 && temporalseq_inst_n(seq1, i + 1)->t <= inter->lower)
+		i++;
+	while (j < seq2->count - 2 && temporalseq_inst_n(seq2, j + 1)->t <= inter->lower)
+		j++;
+	TimestampTz lower = inter->lower;
+	while (true)
+	{
+		TimestampTz next1 = (i < seq1->count - 1) ?
+			temporalseq_inst_n(seq1, i + 1)->t : inter->upper;
+		TimestampTz next2 = (j < seq2->count - 1) ?
+			temporalseq_inst_n(seq2, j + 1)->t : inter->upper;
+		TimestampTz upper = Min(Min(next1, next2), inter->upper);
+		if (*count == *maxcount)
+		{
+			*maxcount *= 2;
+			*pairs = repalloc(*pairs, sizeof(NASegmentPair) * (*maxcount));
+		}
+		NASegmentPair *pair = &(*pairs)[(*count)++];
+		pair->lb = NA_segment_pair_lb(seq1, i, seq2, j, hasz);
+		pair->seq1 = seq1;
+		pair->seq2 = seq2;
+		pair->i = i;
+		pair->j = j;
+		pair->lower = lower;
+		pair->upper = upper;
+		if (upper >= inter->upper)
+			break;
+		if (next1 == upper)
+			i++;
+		if (next2 == upper)
+			j++;
+		lower = upper;
+	}
+	pfree(inter);
+}
+
+/* Value of the segment of a sequence starting at the i-th instant */
+
+static TemporalInst *
+NA_segment_at_timestamp(TemporalSeq *seq, int i, TimestampTz t, bool *tofree)
+{
+	TemporalInst *inst1 = temporalseq_inst_n(seq, i);
+	*tofree = false;
+	if (t == inst1->t || i == seq->count - 1)
+		return inst1;
+	TemporalInst *inst2 = temporalseq_inst_n(seq, i + 1);
+	if (t == inst2->t)
+		return inst2;
+	*tofree = true;
+	return temporalseq_at_timestamp1(inst1, inst2, true, t);
+}
+
+/*
+ * Minimum distance of a pair of synchronized segments that is reached first,
+ * computed at the bounds of the synchronization period and at the turning
+ * point as in the temporal distance
+ */
+static double
+NA_segment_pair_mindist(NASegmentPair *pair, Datum (*func)(Datum, Datum),
+	TimestampTz *t)
+{
+	bool tofree1, tofree2, tofree3, tofree4;
+	TemporalInst *start1 = NA_segment_at_timestamp(pair->seq1, pair->i,
+		pair->lower, &tofree1);
+	TemporalInst *start2 = NA_segment_at_timestamp(pair->seq2, pair->j,
+		pair->lower, &tofree2);
+	double result = DatumGetFloat8(func(temporalinst_value(start1),
+		temporalinst_value(start2)));
+	*t = pair->lower;
+	if (pair->lower < pair->upper)
+	{
+		TemporalInst *end1 = NA_segment_at_timestamp(pair->seq1, pair->i,
+			pair->upper, &tofree3);
+		TemporalInst *end2 = NA_segment_at_timestamp(pair->seq2, pair->j,
+			pair->upper, &tofree4);
+		TimestampTz intertime;
+		if (tpointseq_min_dist_at_timestamp(start1, end1, start2, end2,
+			&intertime))
+		{
+			Datum inter1 = temporalseq_value_at_timestamp1(start1, end1,
+				true, intertime);
+			Datum inter2 = temporalseq_value_at_timestamp1(start2, end2,
+				true, intertime);
+			double dist = DatumGetFloat8(func(inter1, inter2));
+			if (dist < result)
+			{
+				result = dist;
+				*t = intertime;
+			}
+			pfree(DatumGetPointer(inter1)); pfree(DatumGetPointer(inter2));
+		}
+		double dist = DatumGetFloat8(func(temporalinst_value(end1),
+			temporalinst_value(end2)));
+		if (dist < result)
+		{
+			result = dist;
+			*t = pair->upper;
+		}
+		if (tofree3)
+			pfree(end1);
+		if (tofree4)
+			pfree(end2);
+	}
+	if (tofree1)
+		pfree(start1);
+	if (tofree2)
+		pfree(start2);
+	return result;
+}
+
+/* Sequences composing a temporal sequence or a temporal sequence set */
+
+static TemporalSeq **
+NA_tpoint_sequences(Temporal *temp, int *count)
+{
+	TemporalSeq **result;
+	if (temp->duration == TEMPORALSEQ)
+	{
+		result = palloc(sizeof(TemporalSeq *));
+		result[0] = (TemporalSeq *) temp;
+		*count = 1;
+	}
+	else
+	{
+		TemporalS *ts = (TemporalS *) temp;
+		result = palloc(sizeof(TemporalSeq *) * ts->count);
+		for (int i = 0; i < ts->count; i++)
+			result[i] = temporals_seq_n(ts, i);
+		*count = ts->count;
+	}
+	return result;
+}
+
+/*
+ * Returns true if the nearest approach between the two temporal points can
+ * be computed by the branch-and-bound algorithm
+ */
+static bool
+NA_tpoint_tpoint_bb_applicable(Temporal *temp1, Temporal *temp2)
+{
+	return temp1->valuetypid == type_oid(T_GEOMETRY) &&
+		(temp1->duration == TEMPORALSEQ || temp1->duration == TEMPORALS) &&
+		(temp2->duration == TEMPORALSEQ || temp2->duration == TEMPORALS) &&
+		MOBDB_FLAGS_GET_LINEAR(temp1->flags) &&
+		MOBDB_FLAGS_GET_LINEAR(temp2->flags);
+}
+
+/*
+ * Computes the minimum distance between two temporal points and the first
+ * timestamp at which it is reached. Returns false if the temporal points
+ * do not intersect on time.
+ */
+static bool
+NA_tpoint_tpoint_bb(Temporal *temp1, Temporal *temp2, double *mindist,
+	TimestampTz *tmin)
+{
+	bool hasz = MOBDB_FLAGS_GET_Z(temp1->flags);
+	Datum (*func)(Datum, Datum) = hasz ? &geom_distance3d : &geom_distance2d;
+	int count1, count2;
+	TemporalSeq **sequences1 = NA_tpoint_sequences(temp1, &count1);
+	TemporalSeq **sequences2 = NA_tpoint_sequences(temp2, &count2);
+
+	/* Collect the synchronized segments of the overlapping sequences */
+	int count = 0, maxcount = 64;
+	NASegmentPair *pairs = palloc(sizeof(NASegmentPair) * maxcount);
+	int i = 0, j = 0;
+	while (i < count1 && j < count2)
+	{
+		TemporalSeq *seq1 = sequences1[i];
+		TemporalSeq *seq2 = sequences2[j];
+		NA_tpointseq_tpointseq_pairs(seq1, seq2, hasz, &pairs, &count,
+			&maxcount);
+		int cmp = timestamp_cmp_internal(seq1->period.upper, seq2->period.upper);
+		if (cmp == 0)
+		{
+			i++; j++;
+		}
+		else if (cmp < 0)
+			i++;
+		else
+			j++;
+	}
+	pfree(sequences1); pfree(sequences2);
+	if (count == 0)
+	{
+		pfree(pairs);
+		return false;
+	}
+
+	/* Visit the pairs by increasing lower bound */
+	qsort(pairs, count, sizeof(NASegmentPair), &NA_segment_pair_cmp);
+	*mindist = DBL_MAX;
+	*tmin = DT_NOEND;
+	for (int k = 0; k < count && pairs[k].lb <= *mindist; k++)
+	{
+		TimestampTz t;
+		double dist = NA_segment_pair_mindist(&pairs[k], func, &t);
+		/* Ties are broken by the first timestamp as for temporal_at_min */
+		if (dist < *mindist || (dist == *mindist && t < *tmin))
+		{
+			*mindist = dist;
+			*tmin = t;
+		}
+	}
+	pfree(pairs);
+	return true;
+}
+
+/*
+ * Nearest approach distance between a temporal geometry point sequence set
+ * and a geometry. The sequences are visited by increasing distance between
+ * their bounding box and the one of the geometry, and the trajectory of a
+ * sequence is only compared with the geometry if this distance does not
+ * exceed the best distance found so far. This also avoids computing the
+ * trajectory of the whole sequence set.
+ */
+
+typedef struct
+{
+	double		lb;			/* Lower bound of the distance */
+	TemporalSeq *seq;
+} NASequenceBound;
+
+static int
+NA_sequence_bound_cmp(const void *p1, const void *p2)
+{
+	double lb1 = ((const NASequenceBound *) p1)->lb;
+	double lb2 = ((const NASequenceBound *) p2)->lb;
+	return (lb1 < lb2) ? -1 : ((lb1 > lb2) ? 1 : 0);
+}
+
+static Datum
+NAD_tgeompoints_geo(TemporalS *ts, GSERIALIZED *gs, Datum (*func)(Datum, Datum))
+{
+	STBOX box;
+	memset(&box, 0, sizeof(STBOX));
+	/* Non-empty geometries have a bounding box */
+	geo_to_stbox_internal(&box, gs);
+	bool hasz = MOBDB_FLAGS_GET_Z(ts->flags) && MOBDB_FLAGS_GET_Z(box.flags);
+	NASequenceBound *bounds = palloc(sizeof(NASequenceBound) * ts->count);
+	for (int i = 0; i < ts->count; i++)
+	{
+		TemporalSeq *seq = temporals_seq_n(ts, i);
+		STBOX *box1 = temporalseq_bbox_ptr(seq);
+		double gapx = Max(box1->xmin - box.xmax, box.xmin - box1->xmax);
+		double gapy = Max(box1->ymin - box.ymax, box.ymin - box1->ymax);
+		double gapz = hasz ? Max(box1->zmin - box.zmax, box.zmin - box1->zmax) : 0;
+		gapx = Max(gapx, 0); gapy = Max(gapy, 0); gapz = Max(gapz, 0);
+		bounds[i].lb = sqrt(gapx * gapx + gapy * gapy + gapz * gapz);
+		bounds[i].seq = seq;
+	}
+	qsort(bounds, ts->count, sizeof(NASequenceBound), &NA_sequence_bound_cmp);
+	double result = DBL_MAX;
+	for (int i = 0; i < ts->count && bounds[i].lb <= result; i++)
+	{
+		TemporalSeq *seq = bounds[i].seq;
+		Datum traj = tpointseq_trajectory(seq);
+		double dist = DatumGetFloat8(func(traj, PointerGetDatum(gs)));
+		if (MOBDB_FLAGS_GET_NOTRAJ(seq->flags))
+			pfree(DatumGetPointer(traj));
+		if (dist < result)
+			result = dist;
+	}
+	pfree(bounds);
+	return Float8GetDatum(result);
+}
+
+/*****************************************************************************/
+
 PG_FUNCTION_INFO_V1(NAI_tpoint_tpoint);
 
 PGDLLEXPORT Datum
@@ -2386,6 +4761,18 @@ NAI_tpoint_tpoint(PG_FUNCTION_ARGS)
 	ensure_same_srid_tpoint(temp1, temp2);
 	ensure_same_dimensionality_tpoint(temp1, temp2);
 	TemporalInst *result = NULL;
+	if (NA_tpoint_tpoint_bb_applicable(temp1, temp2))
+	{
+		double mindist;
+		TimestampTz t;
+		if (NA_tpoint_tpoint_bb(temp1, temp2, &mindist, &t))
+			result = temporal_at_timestamp_internal(temp1, t);
+		PG_FREE_IF_COPY(temp1, 0);
+		PG_FREE_IF_COPY(temp2, 1);
+		if (result == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(result);
+	}
 	Temporal *dist = distance_tpoint_tpoint_internal(temp1, temp2);
 	if (dist != NULL)
 	{
@@ -2433,10 +4820,16 @@ NAD_geo_tpoint(PG_FUNCTION_ARGS)
 	else
 		func = &geog_distance;
 
-	Datum traj = tpoint_trajectory_internal(temp);
-	Datum result = func(traj, PointerGetDatum(gs));
+	Datum result;
+	if (temp->duration == TEMPORALS && temp->valuetypid == type_oid(T_GEOMETRY))
+		result = NAD_tgeompoints_geo((TemporalS *)temp, gs, func);
+	else
+	{
+		Datum traj = tpoint_trajectory_internal(temp);
+		result = func(traj, PointerGetDatum(gs));
+		pfree(DatumGetPointer(traj));
+	}
 
-	pfree(DatumGetPointer(traj));
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_DATUM(result);
@@ -2470,10 +4863,16 @@ NAD_tpoint_geo(PG_FUNCTION_ARGS)
 	else
 		func = &geog_distance;
 
-	Datum traj = tpoint_trajectory_internal(temp);
-	Datum result = func(traj, PointerGetDatum(gs));
+	Datum result;
+	if (temp->duration == TEMPORALS && temp->valuetypid == type_oid(T_GEOMETRY))
+		result = NAD_tgeompoints_geo((TemporalS *)temp, gs, func);
+	else
+	{
+		Datum traj = tpoint_trajectory_internal(temp);
+		result = func(traj, PointerGetDatum(gs));
+		pfree(DatumGetPointer(traj));
+	}
 
-	pfree(DatumGetPointer(traj));
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
 	PG_RETURN_DATUM(result);
@@ -2490,6 +4889,17 @@ NAD_tpoint_tpoint(PG_FUNCTION_ARGS)
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	ensure_same_srid_tpoint(temp1, temp2);
 	ensure_same_dimensionality_tpoint(temp1, temp2);
+	if (NA_tpoint_tpoint_bb_applicable(temp1, temp2))
+	{
+		double mindist;
+		TimestampTz t;
+		bool found = NA_tpoint_tpoint_bb(temp1, temp2, &mindist, &t);
+		PG_FREE_IF_COPY(temp1, 0);
+		PG_FREE_IF_COPY(temp2, 1);
+		if (! found)
+			PG_RETURN_NULL();
+		PG_RETURN_FLOAT8(mindist);
+	}
 	Temporal *dist = distance_tpoint_tpoint_internal(temp1, temp2);
 	if (dist == NULL)
 	{
@@ -2505,6 +4915,254 @@ NAD_tpoint_tpoint(PG_FUNCTION_ARGS)
 	PG_RETURN_DATUM(result);
 }
 
+/*****************************************************************************
+ * Nearest approach distance of the pairs of two arrays
+ * The synchronized segments of all the pairs are gathered into one array per
+ * coordinate and their minimum distances are computed with a single call to
+ * the batch kernel of the core library. The segments of a stepwise sequence
+ * are constant, the ones of an instant or an instant set are reduced to a
+ * point.
+ *****************************************************************************/
+
+/* Coordinates of the start and end points of the segments of each side */
+typedef struct
+{
+	double	   *x[4];			/* x coordinates of start1, end1, start2, end2 */
+	double	   *y[4];			/* y coordinates of start1, end1, start2, end2 */
+	double	   *z[4];			/* z coordinates, NULL for 2D points */
+	int			count;			/* number of segments */
+} NADSegments;
+
+/* Maximum number of segments of a synchronized temporal point */
+static int
+tpoint_nad_segment_max(Temporal *temp)
+{
+	if (temp->duration == TEMPORALINST)
+		return 1;
+	if (temp->duration == TEMPORALI)
+		return ((TemporalI *) temp)->count;
+	if (temp->duration == TEMPORALSEQ)
+		return ((TemporalSeq *) temp)->count + 1;
+	TemporalS *ts = (TemporalS *) temp;
+	int result = 0;
+	for (int i = 0; i < ts->count; i++)
+		result += temporals_seq_n(ts, i)->count + 1;
+	return result;
+}
+
+static void
+tpoint_nad_point_set(NADSegments *segs, int side, TemporalInst *inst)
+{
+	Datum value = temporalinst_value(inst);
+	if (segs->z[side] != NULL)
+	{
+		POINT3DZ p = datum_get_point3dz(value);
+		segs->x[side][segs->count] = p.x;
+		segs->y[side][segs->count] = p.y;
+		segs->z[side][segs->count] = p.z;
+	}
+	else
+	{
+		POINT2D p = datum_get_point2d(value);
+		segs->x[side][segs->count] = p.x;
+		segs->y[side][segs->count] = p.y;
+	}
+}
+
+static void
+tpoint_nad_segment_add(NADSegments *segs, TemporalInst *start1,
+	TemporalInst *end1, TemporalInst *start2, TemporalInst *end2)
+{
+	tpoint_nad_point_set(segs, 0, start1);
+	tpoint_nad_point_set(segs, 1, end1);
+	tpoint_nad_point_set(segs, 2, start2);
+	tpoint_nad_point_set(segs, 3, end2);
+	segs->count++;
+}
+
+static void
+tpointseq_nad_segments(NADSegments *segs, TemporalSeq *seq1,
+	TemporalSeq *seq2)
+{
+	bool linear1 = MOBDB_FLAGS_GET_LINEAR(seq1->flags);
+	bool linear2 = MOBDB_FLAGS_GET_LINEAR(seq2->flags);
+	TemporalInst *start1 = temporalseq_inst_n(seq1, 0);
+	TemporalInst *start2 = temporalseq_inst_n(seq2, 0);
+	if (seq1->count == 1)
+	{
+		tpoint_nad_segment_add(segs, start1, start1, start2, start2);
+		return;
+	}
+	for (int i = 1; i < seq1->count; i++)
+	{
+		TemporalInst *end1 = temporalseq_inst_n(seq1, i);
+		TemporalInst *end2 = temporalseq_inst_n(seq2, i);
+		tpoint_nad_segment_add(segs, start1, linear1 ? end1 : start1,
+			start2, linear2 ? end2 : start2);
+		start1 = end1;
+		start2 = end2;
+	}
+	/* The value of a stepwise sequence at an inclusive upper bound is not
+	 * the end of its last segment */
+	if ((! linear1 || ! linear2) && seq1->period.upper_inc)
+		tpoint_nad_segment_add(segs, start1, start1, start2, start2);
+}
+
+static void
+tpoint_nad_segments(NADSegments *segs, Temporal *sync1, Temporal *sync2)
+{
+	if (sync1->duration == TEMPORALINST)
+		tpoint_nad_segment_add(segs, (TemporalInst *) sync1,
+			(TemporalInst *) sync1, (TemporalInst *) sync2,
+			(TemporalInst *) sync2);
+	else if (sync1->duration == TEMPORALI)
+	{
+		for (int i = 0; i < ((TemporalI *) sync1)->count; i++)
+		{
+			TemporalInst *inst1 = temporali_inst_n((TemporalI *) sync1, i);
+			TemporalInst *inst2 = temporali_inst_n((TemporalI *) sync2, i);
+			tpoint_nad_segment_add(segs, inst1, inst1, inst2, inst2);
+		}
+	}
+	else if (sync1->duration == TEMPORALSEQ)
+		tpointseq_nad_segments(segs, (TemporalSeq *) sync1,
+			(TemporalSeq *) sync2);
+	else
+	{
+		for (int i = 0; i < ((TemporalS *) sync1)->count; i++)
+			tpointseq_nad_segments(segs,
+				temporals_seq_n((TemporalS *) sync1, i),
+				temporals_seq_n((TemporalS *) sync2, i));
+	}
+}
+
+/*
+ * Nearest approach distance of the temporal geometry points at the same
+ * position of two arrays. The function returns one row per pair, composed
+ * of the position of the pair in the arrays and of the nearest approach
+ * distance, which is NULL when the temporal points do not overlap in time.
+ * The batch kernel is run in the calling backend only.
+ */
+PG_FUNCTION_INFO_V1(NAD_tpointarr_tpointarr);
+
+PGDLLEXPORT Datum
+NAD_tpointarr_tpointarr(PG_FUNCTION_ARGS)
+{
+	ArrayType *array1 = PG_GETARG_ARRAYTYPE_P(0);
+	ArrayType *array2 = PG_GETARG_ARRAYTYPE_P(1);
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext oldcontext;
+
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo) ||
+		!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("set-valued function called in context that cannot accept a set")));
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("function returning record called in context "
+				"that cannot accept type record")));
+
+	int count1, count2;
+	Temporal **temparr1 = temporalarr_extract(array1, &count1);
+	Temporal **temparr2 = temporalarr_extract(array2, &count2);
+	if (count1 != count2)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The input arrays must have the same number of elements")));
+
+	/* Synchronize the pairs and count their segments */
+	Temporal **sync1 = palloc(sizeof(Temporal *) * Max(count1, 1));
+	Temporal **sync2 = palloc(sizeof(Temporal *) * Max(count1, 1));
+	int total = 0;
+	for (int i = 0; i < count1; i++)
+	{
+		ensure_same_srid_tpoint(temparr1[0], temparr1[i]);
+		ensure_same_srid_tpoint(temparr1[i], temparr2[i]);
+		ensure_same_dimensionality_tpoint(temparr1[0], temparr1[i]);
+		ensure_same_dimensionality_tpoint(temparr1[i], temparr2[i]);
+		if (! synchronize_temporal_temporal(temparr1[i], temparr2[i],
+				&sync1[i], &sync2[i], false))
+		{
+			sync1[i] = sync2[i] = NULL;
+			continue;
+		}
+		total += tpoint_nad_segment_max(sync1[i]);
+	}
+
+	/* Gather the segments and compute their minimum distances */
+	bool hasz = count1 > 0 && MOBDB_FLAGS_GET_Z(temparr1[0]->flags);
+	NADSegments segs;
+	for (int i = 0; i < 4; i++)
+	{
+		segs.x[i] = palloc(sizeof(double) * Max(total, 1));
+		segs.y[i] = palloc(sizeof(double) * Max(total, 1));
+		segs.z[i] = hasz ? palloc(sizeof(double) * Max(total, 1)) : NULL;
+	}
+	segs.count = 0;
+	int *ends = palloc(sizeof(int) * Max(count1, 1));
+	for (int i = 0; i < count1; i++)
+	{
+		if (sync1[i] != NULL)
+			tpoint_nad_segments(&segs, sync1[i], sync2[i]);
+		ends[i] = segs.count;
+	}
+	TPointCoords coords[4];
+	for (int i = 0; i < 4; i++)
+	{
+		coords[i].x = segs.x[i];
+		coords[i].y = segs.y[i];
+		coords[i].z = segs.z[i];
+	}
+	double *dists = palloc(sizeof(double) * Max(segs.count, 1));
+	tpoint_batch_mindist(&coords[0], &coords[1], &coords[2], &coords[3],
+		segs.count, dists, 1);
+
+	oldcontext = MemoryContextSwitchTo(rsinfo->econtext->ecxt_per_query_memory);
+	tupdesc = BlessTupleDesc(CreateTupleDescCopy(tupdesc));
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+	MemoryContextSwitchTo(oldcontext);
+
+	int start = 0;
+	for (int i = 0; i < count1; i++)
+	{
+		Datum values[2];
+		bool isnull[2] = {false, false};
+		values[0] = Int32GetDatum(i + 1);
+		if (sync1[i] == NULL)
+		{
+			values[1] = (Datum) 0;
+			isnull[1] = true;
+		}
+		else
+		{
+			double mindist = dists[start];
+			for (int j = start + 1; j < ends[i]; j++)
+				mindist = Min(mindist, dists[j]);
+			values[1] = Float8GetDatum(mindist);
+			pfree(sync1[i]); pfree(sync2[i]);
+		}
+		start = ends[i];
+		tuplestore_putvalues(tupstore, tupdesc, values, isnull);
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		pfree(segs.x[i]); pfree(segs.y[i]);
+		if (hasz)
+			pfree(segs.z[i]);
+	}
+	pfree(dists); pfree(ends);
+	pfree(sync1); pfree(sync2);
+	pfree(temparr1); pfree(temparr2);
+	PG_FREE_IF_COPY(array1, 0);
+	PG_FREE_IF_COPY(array2, 1);
+	return (Datum) 0;
+}
+
 /*****************************************************************************
  * ShortestLine
  *****************************************************************************/
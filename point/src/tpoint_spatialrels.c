@@ -25,9 +25,12 @@
 
 #include "tpoint_spatialrels.h"
 
+#include "timeops.h"
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_probes.h"
+#include "temporal_stats.h"
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
 #include "tpoint_distance.h"
@@ -38,54 +41,75 @@
  * covers and coveredby are inverse to each other
  *****************************************************************************/
 
+/*
+ * Call a PostGIS function using GEOS, counting the call and firing the
+ * tracing probes. The function info is cached when flinfo is not NULL.
+ */
+static Datum
+geos_call2(FmgrInfo *flinfo, PGFunction func, Datum geom1, Datum geom2)
+{
+	MOBDB_STAT_INC(geos_calls);
+	TRACE_MOBILITYDB_GEOS_START(VARSIZE_ANY(DatumGetPointer(geom1)),
+		VARSIZE_ANY(DatumGetPointer(geom2)));
+	Datum result = flinfo != NULL ?
+		call_function2_cached(flinfo, func, geom1, geom2) :
+		call_function2(func, geom1, geom2);
+	TRACE_MOBILITYDB_GEOS_DONE();
+	return result;
+}
+
 Datum
 geom_contains(Datum geom1, Datum geom2)
 {
-	return call_function2(contains, geom1, geom2);
+	static FmgrInfo flinfo;
+	return geos_call2(&flinfo, contains, geom1, geom2);
 }
 
 Datum
 geom_containsproperly(Datum geom1, Datum geom2)
 {
-	return call_function2(containsproperly, geom1, geom2);
+	static FmgrInfo flinfo;
+	return geos_call2(&flinfo, containsproperly, geom1, geom2);
 }
 
 Datum
 geom_covers(Datum geom1, Datum geom2)
 {
-	return call_function2(covers, geom1, geom2);
+	static FmgrInfo flinfo;
+	return geos_call2(&flinfo, covers, geom1, geom2);
 }
 
 Datum
 geom_coveredby(Datum geom1, Datum geom2)
 {
-	return call_function2(coveredby, geom1, geom2);
+	return geos_call2(NULL, coveredby, geom1, geom2);
 }
 
 Datum
 geom_crosses(Datum geom1, Datum geom2)
 {
-	return call_function2(crosses, geom1, geom2);
+	return geos_call2(NULL, crosses, geom1, geom2);
 }
 
 /* ST_Relate(A,B) = 'FF*FF****' */
 Datum
 geom_disjoint(Datum geom1, Datum geom2)
 {
-	return call_function2(disjoint, geom1, geom2);
+	return geos_call2(NULL, disjoint, geom1, geom2);
 }
 
 Datum
 geom_equals(Datum geom1, Datum geom2)
 {
-	return call_function2(ST_Equals, geom1, geom2);
+	return geos_call2(NULL, ST_Equals, geom1, geom2);
 }
 
 /* ST_Intersects(g1, g2 ) --> Not (ST_Disjoint(g1, g2 )) */
 Datum
 geom_intersects2d(Datum geom1, Datum geom2)
 {
-	return call_function2(intersects, geom1, geom2);
+	static FmgrInfo flinfo;
+	return geos_call2(&flinfo, intersects, geom1, geom2);
 }
 
 Datum
@@ -97,21 +121,21 @@ geom_intersects3d(Datum geom1, Datum geom2)
 Datum
 geom_overlaps(Datum geom1, Datum geom2)
 {
-	return call_function2(overlaps, geom1, geom2);
+	return geos_call2(NULL, overlaps, geom1, geom2);
 }
 
 /* ST_Relate(A,B) = 'FT*******' or 'F**T*****' or 'F***T****' */
 Datum
 geom_touches(Datum geom1, Datum geom2)
 {
-	return call_function2(touches, geom1, geom2);
+	return geos_call2(NULL, touches, geom1, geom2);
 }
 
 /* ST_Relate(A,B) = 'T*F**F***' */
 Datum
 geom_within(Datum geom1, Datum geom2)
 {
-	return call_function2(contains, geom2, geom1);
+	return geos_call2(NULL, contains, geom2, geom1);
 }
 
 Datum
@@ -129,13 +153,18 @@ geom_dwithin3d(Datum geom1, Datum geom2, Datum dist)
 Datum
 geom_relate(Datum geom1, Datum geom2)
 {
-	return call_function2(relate_full, geom1, geom2); 
+	return geos_call2(NULL, relate_full, geom1, geom2);
 }
 
 Datum
 geom_relate_pattern(Datum geom1, Datum geom2, Datum pattern)
 {
-	return call_function3(relate_pattern, geom1, geom2, pattern); 
+	MOBDB_STAT_INC(geos_calls);
+	TRACE_MOBILITYDB_GEOS_START(VARSIZE_ANY(DatumGetPointer(geom1)),
+		VARSIZE_ANY(DatumGetPointer(geom2)));
+	Datum result = call_function3(relate_pattern, geom1, geom2, pattern);
+	TRACE_MOBILITYDB_GEOS_DONE();
+	return result;
 }
 
 /*****************************************************************************/
@@ -167,6 +196,68 @@ geog_dwithin(Datum geog1, Datum geog2, Datum dist)
 		BoolGetDatum(true));
 }
 
+/*****************************************************************************
+ * Bounding box pruning for the dwithin relationships
+ *****************************************************************************/
+
+/*
+ * Returns the gap between the ranges of coordinates [a1, a2] and [b1, b2],
+ * whose bounds may be given in any order, or 0 if the ranges overlap
+ */
+static double
+coord_gap(double a1, double a2, double b1, double b2)
+{
+	double gap = Max(Min(b1, b2) - Max(a1, a2), Min(a1, a2) - Max(b1, b2));
+	return Max(gap, 0.0);
+}
+
+/*
+ * Returns true if the spatial dimensions of the bounding boxes of two 
+ * temporal points are farther apart than the distance, in which case the 
+ * temporal points cannot be within the distance at any instant
+ */
+bool
+stbox_spatial_far(const STBOX *box1, const STBOX *box2, double d, bool hasz)
+{
+	double dx = coord_gap(box1->xmin, box1->xmax, box2->xmin, box2->xmax);
+	double dy = coord_gap(box1->ymin, box1->ymax, box2->ymin, box2->ymax);
+	double dz = hasz ? 
+		coord_gap(box1->zmin, box1->zmax, box2->zmin, box2->zmax) : 0.0;
+	return dx * dx + dy * dy + dz * dz > d * d;
+}
+
+/*
+ * Returns true if the bounding boxes of two segments defined by their start
+ * and end points are farther apart than the distance, in which case the 
+ * segments cannot be within the distance at any instant
+ */
+bool
+segments_spatial_far(Datum sv1, Datum ev1, Datum sv2, Datum ev2, double d, 
+	bool hasz)
+{
+	double dx, dy, dz = 0.0;
+	if (hasz)
+	{
+		POINT3DZ p1 = datum_get_point3dz(sv1);
+		POINT3DZ p2 = datum_get_point3dz(ev1);
+		POINT3DZ p3 = datum_get_point3dz(sv2);
+		POINT3DZ p4 = datum_get_point3dz(ev2);
+		dx = coord_gap(p1.x, p2.x, p3.x, p4.x);
+		dy = coord_gap(p1.y, p2.y, p3.y, p4.y);
+		dz = coord_gap(p1.z, p2.z, p3.z, p4.z);
+	}
+	else
+	{
+		POINT2D p1 = datum_get_point2d(sv1);
+		POINT2D p2 = datum_get_point2d(ev1);
+		POINT2D p3 = datum_get_point2d(sv2);
+		POINT2D p4 = datum_get_point2d(ev2);
+		dx = coord_gap(p1.x, p2.x, p3.x, p4.x);
+		dy = coord_gap(p1.y, p2.y, p3.y, p4.y);
+	}
+	return dx * dx + dy * dy + dz * dz > d * d;
+}
+
 /*****************************************************************************
  * Generic dwithin functions when both temporal points are moving
  * The functions suppose that the temporal points are synchronized
@@ -185,6 +276,13 @@ dwithin_tpointseq_tpointseq1(TemporalInst *start1, TemporalInst *end1, bool line
 	/* If both instants are constant compute the function at the start instant */
 	if (datum_point_eq(sv1, ev1) &&	datum_point_eq(sv2, ev2))
 		return DatumGetBool(func(sv1, sv2, param));
+
+	/* The segments of planar points cannot be within the distance if their
+	 * bounding boxes are farther apart */
+	if (func != &geog_dwithin &&
+		segments_spatial_far(sv1, linear1 ? ev1 : sv1, sv2, linear2 ? ev2 : sv2,
+			DatumGetFloat8(param), MOBDB_FLAGS_GET_Z(start1->flags)))
+		return false;
 	
 	/* Determine whether there is a local minimum between lower and upper */
 	TimestampTz crosstime;
@@ -248,23 +346,32 @@ dwithin_tpoints_tpoints(TemporalS *ts1, TemporalS *ts2, Datum d,
  * this, they have the same timeframe and they are of the same duration.
  *****************************************************************************/
 
+/* The trajectory of the temporal point is cached in the calling function
+ * when the temporal point is constant in a query */
+
 static Datum
-spatialrel_tpoint_geo(Temporal *temp, Datum geo,
+spatialrel_tpoint_geo(FunctionCallInfo fcinfo, Temporal *temp, Datum geo,
 	Datum (*func)(Datum, Datum), bool invert)
 {
-	Datum traj = tpoint_trajectory_internal(temp);
+	bool tofree;
+	Datum traj = tpoint_trajectory_cached(fcinfo, temp, invert ? 1 : 0,
+		&tofree);
 	Datum result = invert ? func(geo, traj) : func(traj, geo);
-	pfree(DatumGetPointer(traj));
+	if (tofree)
+		pfree(DatumGetPointer(traj));
 	return result;
 }
  
 static Datum
-spatialrel3_tpoint_geo(Temporal *temp, Datum geo, Datum param,
-	Datum (*func)(Datum, Datum, Datum), bool invert)
+spatialrel3_tpoint_geo(FunctionCallInfo fcinfo, Temporal *temp, Datum geo, 
+	Datum param, Datum (*func)(Datum, Datum, Datum), bool invert)
 {
-	Datum traj = tpoint_trajectory_internal(temp);
+	bool tofree;
+	Datum traj = tpoint_trajectory_cached(fcinfo, temp, invert ? 1 : 0,
+		&tofree);
 	Datum result = invert ? func(geo, traj, param) : func(traj, geo, param);
-	pfree(DatumGetPointer(traj));
+	if (tofree)
+		pfree(DatumGetPointer(traj));
 	return result;
 }
 
@@ -309,7 +416,7 @@ contains_geo_tpoint(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(temp, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_contains, true);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -331,7 +438,7 @@ contains_tpoint_geo(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(gs, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_contains, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -381,7 +488,7 @@ containsproperly_geo_tpoint(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(temp, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_containsproperly, true);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -403,7 +510,7 @@ containsproperly_tpoint_geo(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(gs, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_containsproperly, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -459,7 +566,7 @@ covers_geo_tpoint(PG_FUNCTION_ARGS)
 		func = &geom_covers;
 	else if (temp->valuetypid == type_oid(T_GEOGRAPHY))
 		func = &geog_covers;
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		func, true);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -487,7 +594,7 @@ covers_tpoint_geo(PG_FUNCTION_ARGS)
 		func = &geom_covers;
 	else if (temp->valuetypid == type_oid(T_GEOGRAPHY))
 		func = &geog_covers;
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		func, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -551,7 +658,7 @@ coveredby_geo_tpoint(PG_FUNCTION_ARGS)
 		func = &geom_coveredby;
 	else if (temp->valuetypid == type_oid(T_GEOGRAPHY))
 		func = &geog_coveredby;
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		func, false);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -579,7 +686,7 @@ coveredby_tpoint_geo(PG_FUNCTION_ARGS)
 		func = &geom_coveredby;
 	else if (temp->valuetypid == type_oid(T_GEOGRAPHY))
 		func = &geog_coveredby;
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		func, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -637,7 +744,7 @@ crosses_geo_tpoint(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(temp, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_crosses, true);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -659,7 +766,7 @@ crosses_tpoint_geo(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(gs, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_crosses, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -709,7 +816,7 @@ disjoint_geo_tpoint(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(temp, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_disjoint, true);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -731,7 +838,7 @@ disjoint_tpoint_geo(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(gs, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_disjoint, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -781,7 +888,7 @@ equals_geo_tpoint(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(temp, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_equals, true);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -803,7 +910,7 @@ equals_tpoint_geo(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(gs, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_equals, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -864,7 +971,7 @@ intersects_geo_tpoint(PG_FUNCTION_ARGS)
 	}
 	else if (temp->valuetypid == type_oid(T_GEOGRAPHY))
 		func = &geog_intersects;
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		func, true);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -897,7 +1004,7 @@ intersects_tpoint_geo(PG_FUNCTION_ARGS)
 	}
 	else if (temp->valuetypid == type_oid(T_GEOGRAPHY))
 		func = &geog_intersects;
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs),
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs),
 		func, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -955,7 +1062,7 @@ overlaps_geo_tpoint(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(temp, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_overlaps, true);			
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -977,7 +1084,7 @@ overlaps_tpoint_geo(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(gs, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_overlaps, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -1027,7 +1134,7 @@ touches_geo_tpoint(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(temp, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_touches, true);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -1049,7 +1156,7 @@ touches_tpoint_geo(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(gs, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_touches, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -1099,7 +1206,7 @@ within_geo_tpoint(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(temp, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_within, true);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -1121,7 +1228,7 @@ within_tpoint_geo(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(gs, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_within, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -1183,7 +1290,7 @@ dwithin_geo_tpoint(PG_FUNCTION_ARGS)
 	}
 	else if (temp->valuetypid == type_oid(T_GEOGRAPHY))
 		func = &geog_dwithin;
-	Datum result = spatialrel3_tpoint_geo(temp, PointerGetDatum(gs), dist,
+	Datum result = spatialrel3_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), dist,
 		func, true);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -1217,7 +1324,7 @@ dwithin_tpoint_geo(PG_FUNCTION_ARGS)
 	}
 	else if (temp->valuetypid == type_oid(T_GEOGRAPHY))
 		func = &geog_dwithin;
-	Datum result = spatialrel3_tpoint_geo(temp, PointerGetDatum(gs), dist,
+	Datum result = spatialrel3_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), dist,
 		func, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -1234,6 +1341,32 @@ dwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
 	Datum dist = PG_GETARG_DATUM(2);
 	ensure_same_srid_tpoint(temp1, temp2);
 	ensure_same_dimensionality_tpoint(temp1, temp2);
+	/* The result is false if the spatial dimensions of the bounding boxes 
+	 * of planar points are farther apart than the distance. In that case 
+	 * two sequences need not be synchronized since it is enough to know 
+	 * whether their periods intersect */
+	bool far = false;
+	if (temp1->valuetypid == type_oid(T_GEOMETRY))
+	{
+		STBOX box1, box2;
+		memset(&box1, 0, sizeof(STBOX));
+		memset(&box2, 0, sizeof(STBOX));
+		temporal_bbox(&box1, temp1);
+		temporal_bbox(&box2, temp2);
+		far = stbox_spatial_far(&box1, &box2, DatumGetFloat8(dist),
+			MOBDB_FLAGS_GET_Z(temp1->flags));
+	}
+	if (far && temp1->duration == TEMPORALSEQ && 
+		temp2->duration == TEMPORALSEQ)
+	{
+		bool overlaps = overlaps_period_period_internal(
+			&((TemporalSeq *)temp1)->period, &((TemporalSeq *)temp2)->period);
+		PG_FREE_IF_COPY(temp1, 0);
+		PG_FREE_IF_COPY(temp2, 1);
+		if (! overlaps)
+			PG_RETURN_NULL();
+		PG_RETURN_BOOL(false);
+	}
 	Temporal *sync1, *sync2;
 	/* Returns false if the temporal points do not intersect in time 
 	 * The last parameter crossing must be set to false */
@@ -1243,6 +1376,13 @@ dwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(temp2, 1);
 		PG_RETURN_NULL();
 	}
+	if (far)
+	{
+		pfree(sync1); pfree(sync2); 
+		PG_FREE_IF_COPY(temp1, 0);
+		PG_FREE_IF_COPY(temp2, 1);
+		PG_RETURN_BOOL(false);
+	}
 	Datum (*func)(Datum, Datum, Datum) = NULL;
 	ensure_point_base_type(temp1->valuetypid);
 	if (temp1->valuetypid == type_oid(T_GEOMETRY))
@@ -1291,7 +1431,7 @@ relate_geo_tpoint(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(temp, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_relate, false);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -1313,7 +1453,7 @@ relate_tpoint_geo(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(gs, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
+	Datum result = spatialrel_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), 
 		&geom_relate, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -1364,7 +1504,7 @@ relate_pattern_geo_tpoint(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(temp, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel3_tpoint_geo(temp, PointerGetDatum(gs), pattern,
+	Datum result = spatialrel3_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), pattern,
 		&geom_relate_pattern, true);
 	PG_FREE_IF_COPY(gs, 0);
 	PG_FREE_IF_COPY(temp, 1);
@@ -1387,7 +1527,7 @@ relate_pattern_tpoint_geo(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(gs, 1);
 		PG_RETURN_NULL();
 	}
-	Datum result = spatialrel3_tpoint_geo(temp, PointerGetDatum(gs), pattern,
+	Datum result = spatialrel3_tpoint_geo(fcinfo, temp, PointerGetDatum(gs), pattern,
 		&geom_relate_pattern, false);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
@@ -28,6 +28,12 @@
  *				|								|
  *			  FRONT							  BACK
  *
+ * The Z dimension of the boxes is meaningless for planar temporal points.
+ * Therefore, when none of the boxes to split has Z dimension, the space is
+ * split instead into 64 quadrants in the 6-dimensional space of the X, Y,
+ * and T dimensions, which results in shallower trees.  The number of nodes
+ * of an inner tuple tells which of the two splits has been used.
+ *
  * We are using STBOX data type as the prefix, but we are treating them
  * as points in 8-dimensional space, because 4D boxes are not enough
  * to represent the octant boundaries in 8D space.  They however are
@@ -78,6 +84,8 @@
 
 #include "temporaltypes.h"
 #include "oidcache.h"
+#include "temporal_stats.h"
+#include "temporal_util.h"
 #include "tpoint.h"
 #include "tpoint_boxops.h"
 #include "tpoint_gist.h"
@@ -90,24 +98,6 @@ typedef struct
 	STBOX	right;
 } CubeSTbox;
 
-/*
- * Comparator for qsort
- *
- * We don't need to use the floating point macros in here, because this is
- * only going to be used in a place to affect the performance of the index,
- * not the correctness.
- */
-static int
-compareDoubles(const void *a, const void *b)
-{
-	double		x = *(double *) a;
-	double		y = *(double *) b;
-
-	if (x == y)
-		return 0;
-	return (x > y) ? 1 : -1;
-}
-
 /*
  * Calculate the octant
  *
@@ -147,6 +137,52 @@ getOctant8D(STBOX *centroid, STBOX *inBox)
 	return octant;
 }
 
+/*
+ * Calculate the quadrant of a box without Z dimension
+ *
+ * The quadrant is 8 bit unsigned integer with the 6 lower bits in use.
+ * This function accepts 2 STBOX as input.  The bits are set by comparing a
+ * corner of the box in the X, Y, and T dimensions. This makes 64 quadrants
+ * in total.
+ */
+static uint8
+getQuadrant6D(STBOX *centroid, STBOX *inBox)
+{
+	uint8 quadrant = 0;
+
+	if (inBox->xmin > centroid->xmin)
+		quadrant |= 0x20;
+
+	if (inBox->xmax > centroid->xmax)
+		quadrant |= 0x10;
+
+	if (inBox->ymin > centroid->ymin)
+		quadrant |= 0x08;
+
+	if (inBox->ymax > centroid->ymax)
+		quadrant |= 0x04;
+
+	if (inBox->tmin > centroid->tmin)
+		quadrant |= 0x02;
+
+	if (inBox->tmax > centroid->tmax)
+		quadrant |= 0x01;
+
+	return quadrant;
+}
+
+/*
+ * Calculate the node of a box in an inner tuple with the given number
+ * of nodes
+ */
+static uint8
+getNode(STBOX *centroid, STBOX *inBox, int nNodes)
+{
+	if (nNodes == 64)
+		return getQuadrant6D(centroid, inBox);
+	return getOctant8D(centroid, inBox);
+}
+
 /*
  * Initialize the traversal value
  *
@@ -231,6 +267,52 @@ nextCubeSTbox(CubeSTbox *cube_stbox, STBOX *centroid, uint8 octant)
 	return next_cube_stbox;
 }
 
+/*
+ * Calculate the next traversal value for an inner tuple without Z dimension
+ *
+ * The Z bounds of the traversal value are those of the parent, since the
+ * quadrant does not restrict the Z dimension of the boxes.
+ */
+static CubeSTbox *
+nextCubeSTbox6D(CubeSTbox *cube_stbox, STBOX *centroid, uint8 quadrant)
+{
+	CubeSTbox *next_cube_stbox = (CubeSTbox *) palloc(sizeof(CubeSTbox));
+
+	memcpy(next_cube_stbox, cube_stbox, sizeof(CubeSTbox));
+
+	if (quadrant & 0x20)
+		next_cube_stbox->left.xmin = centroid->xmin;
+	else
+		next_cube_stbox->left.xmax = centroid->xmin;
+
+	if (quadrant & 0x10)
+		next_cube_stbox->right.xmin = centroid->xmax;
+	else
+		next_cube_stbox->right.xmax = centroid->xmax;
+
+	if (quadrant & 0x08)
+		next_cube_stbox->left.ymin = centroid->ymin;
+	else
+		next_cube_stbox->left.ymax = centroid->ymin;
+
+	if (quadrant & 0x04)
+		next_cube_stbox->right.ymin = centroid->ymax;
+	else
+		next_cube_stbox->right.ymax = centroid->ymax;
+
+	if (quadrant & 0x02)
+		next_cube_stbox->left.tmin = centroid->tmin;
+	else
+		next_cube_stbox->left.tmax = centroid->tmin;
+
+	if (quadrant & 0x01)
+		next_cube_stbox->right.tmin = centroid->tmax;
+	else
+		next_cube_stbox->right.tmax = centroid->tmax;
+
+	return next_cube_stbox;
+}
+
 /* Can any cube from cube_stbox overlap with query? */
 static bool
 overlap8D(CubeSTbox *cube_stbox, STBOX *query)
@@ -423,7 +505,7 @@ spgist_tpoint_choose(PG_FUNCTION_ARGS)
 
 	/* nodeN will be set by core, when allTheSame. */
 	if (!in->allTheSame)
-		out->result.matchNode.nodeN = getOctant8D(centroid, box);
+		out->result.matchNode.nodeN = getNode(centroid, box, in->nNodes);
 
 	PG_RETURN_VOID();
 }
@@ -432,7 +514,9 @@ spgist_tpoint_choose(PG_FUNCTION_ARGS)
  * SP-GiST pick-split function
  *
  * It splits a list of boxes into octants by choosing a central 8D
- * point as the median of the coordinates of the boxes.
+ * point as the median of the coordinates of the boxes.  When none of the
+ * boxes has Z dimension, they are split into quadrants of the 6D space
+ * instead.
  *****************************************************************************/
 
 PG_FUNCTION_INFO_V1(spgist_tpoint_picksplit);
@@ -452,12 +536,15 @@ spgist_tpoint_picksplit(PG_FUNCTION_ARGS)
 	double *highZs = palloc(sizeof(double) * in->nTuples);
 	double *lowTs = palloc(sizeof(double) * in->nTuples);
 	double *highTs = palloc(sizeof(double) * in->nTuples);
+	bool hasz = false;
 	
 	/* Calculate median of all 8D coordinates */
 	for (i = 0; i < in->nTuples; i++)
 	{
 		STBOX *box = DatumGetSTboxP(in->datums[i]);
 
+		hasz |= MOBDB_FLAGS_GET_Z(box->flags);
+
 		lowXs[i] = box->xmin;
 		highXs[i] = box->xmax;
 		lowYs[i] = box->ymin;
@@ -468,33 +555,27 @@ spgist_tpoint_picksplit(PG_FUNCTION_ARGS)
 		highTs[i] = (double) box->tmax;
 	}
 
-	qsort(lowXs, (size_t) in->nTuples, sizeof(double), compareDoubles);
-	qsort(highXs, (size_t) in->nTuples, sizeof(double), compareDoubles);
-	qsort(lowYs, (size_t) in->nTuples, sizeof(double), compareDoubles);
-	qsort(highYs, (size_t) in->nTuples, sizeof(double), compareDoubles);
-	qsort(lowZs, (size_t) in->nTuples, sizeof(double), compareDoubles);
-	qsort(highZs, (size_t) in->nTuples, sizeof(double), compareDoubles);
-	qsort(lowTs, (size_t) in->nTuples, sizeof(double), compareDoubles);
-	qsort(highTs, (size_t) in->nTuples, sizeof(double), compareDoubles);
-
 	median = in->nTuples / 2;
 
 	centroid = palloc0(sizeof(STBOX));
 
-	centroid->xmin = lowXs[median];
-	centroid->xmax = highXs[median];
-	centroid->ymin = lowYs[median];
-	centroid->ymax = highYs[median];
-	centroid->zmin = lowZs[median];
-	centroid->zmax = highZs[median];
-	centroid->tmin = (TimestampTz) lowTs[median];
-	centroid->tmax = (TimestampTz) highTs[median];
+	centroid->xmin = double_select(lowXs, in->nTuples, median);
+	centroid->xmax = double_select(highXs, in->nTuples, median);
+	centroid->ymin = double_select(lowYs, in->nTuples, median);
+	centroid->ymax = double_select(highYs, in->nTuples, median);
+	if (hasz)
+	{
+		centroid->zmin = double_select(lowZs, in->nTuples, median);
+		centroid->zmax = double_select(highZs, in->nTuples, median);
+	}
+	centroid->tmin = (TimestampTz) double_select(lowTs, in->nTuples, median);
+	centroid->tmax = (TimestampTz) double_select(highTs, in->nTuples, median);
 
 	/* Fill the output */
 	out->hasPrefix = true;
 	out->prefixDatum = STboxPGetDatum(centroid);
 
-	out->nNodes = 256;
+	out->nNodes = hasz ? 256 : 64;
 	out->nodeLabels = NULL;		/* We don't need node labels. */
 
 	out->mapTuplesToNodes = palloc(sizeof(int) * in->nTuples);
@@ -507,7 +588,7 @@ spgist_tpoint_picksplit(PG_FUNCTION_ARGS)
 	for (i = 0; i < in->nTuples; i++)
 	{
 		STBOX *box = DatumGetSTboxP(in->datums[i]);
-		uint8 octant = getOctant8D(centroid, box);
+		uint8 octant = getNode(centroid, box, out->nNodes);
 		out->leafTupleDatums[i] = STboxPGetDatum(box);
 		out->mapTuplesToNodes[i] = octant;
 	}
@@ -598,7 +679,9 @@ spgist_tpoint_inner_consistent(PG_FUNCTION_ARGS)
 
 	for (octant = 0; octant < in->nNodes; octant++)
 	{
-		CubeSTbox *next_cube_stbox = nextCubeSTbox(cube_stbox, centroid, (uint8) octant);
+		CubeSTbox *next_cube_stbox = (in->nNodes == 64) ?
+			nextCubeSTbox6D(cube_stbox, centroid, (uint8) octant) :
+			nextCubeSTbox(cube_stbox, centroid, (uint8) octant);
 		bool flag = true;
 		for (i = 0; i < in->nkeys; i++)
 		{
@@ -748,6 +831,8 @@ spgist_tpoint_leaf_consistent(PG_FUNCTION_ARGS)
 		else
 			elog(ERROR, "unrecognized strategy: %d", strategy);
 
+		MOBDB_STAT_INDEX(STAT_SPGIST_TPOINT, strategy, true, res, out->recheck);
+
 		/* If any check is failed, we have found our answer. */
 		if (!res)
 			break;
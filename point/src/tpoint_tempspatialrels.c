@@ -20,7 +20,10 @@
 
 #include "tpoint_tempspatialrels.h"
 
+#include <funcapi.h>
+#include <miscadmin.h>
 #include <utils/timestamp.h>
+#include <utils/tuplestore.h>
 
 #include "period.h"
 #include "periodset.h"
@@ -28,10 +31,12 @@
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_stats.h"
 #include "lifting.h"
 #include "tpoint.h"
 #include "tpoint_spatialfuncs.h"
 #include "tpoint_spatialrels.h"
+#include "tpoint_segment.h"
 
 /*****************************************************************************
  * Generic functions for computing the temporal spatial relationships 
@@ -174,6 +179,7 @@ tspatialrel_tpointseq_geo1(TemporalInst *inst1, TemporalInst *inst2, bool linear
 	
 	/* Look for intersections */
 	Datum line = geompoint_trajectory(value1, value2);
+	MOBDB_STAT_INC(geos_calls);
 	Datum intersections = call_function2(intersection, line, geo);
 	if (call_function1(LWGEOM_isempty, intersections))
 	{	
@@ -419,6 +425,7 @@ tspatialrel3_tpointseq_geo1(TemporalInst *inst1, TemporalInst *inst2,
 	
 	/* Look for intersections */
 	Datum line = geompoint_trajectory(value1, value2);
+	MOBDB_STAT_INC(geos_calls);
 	Datum intersections = call_function2(intersection, line, geo);
 	if (call_function1(LWGEOM_isempty, intersections))
 	{	
@@ -673,6 +680,7 @@ tdwithin_tpointseq_geo1(TemporalSeq *seq, Datum geo, Datum dist, int *count)
 	
 	/* Restrict to the buffered geometry */
 	TemporalInst *instants[2];
+	MOBDB_STAT_INC(geos_calls);
 	Datum geo_buffer = call_function2(buffer, geo, dist);
 	int count1;
 	TemporalSeq **atbuffer = tpointseq_at_geometry2(seq, geo_buffer, &count1);
@@ -804,7 +812,7 @@ tdwithin_tpoints_geo(TemporalS *ts, Datum geo, Datum dist)
 	return result;
 }
 
-static Temporal *
+Temporal *
 tdwithin_tpoint_geo_internal(Temporal *temp, GSERIALIZED *gs, Datum dist)
 {
 	Datum (*func)(Datum, Datum, Datum) = NULL;
@@ -953,89 +961,35 @@ tdwithin_tpointseq_tpointseq1(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
 	TimestampTz lower, TimestampTz upper, double d, bool hasz,
 	Datum (*func)(Datum, Datum, Datum), TimestampTz *t1, TimestampTz *t2)
 {
-	/* To reduce problems related to floating point arithmetic, lower and upper
-	   are shifted, respectively, to 0 and 1 before computing the solutions
-	   of the quadratic equation */
-	double duration = upper - lower;
-	long double a, b, c;
+	double p1[3], p2[3], p3[3], p4[3];
 	if (hasz) /* 3D */
 	{
-		POINT3DZ p1 = datum_get_point3dz(sv1);
-		POINT3DZ p2 = datum_get_point3dz(ev1);
-		POINT3DZ p3 = datum_get_point3dz(sv2);
-		POINT3DZ p4 = datum_get_point3dz(ev2);
-
-		/* per1 functions
- 		* x(t) = a1 * t + c1
- 		* y(t) = a2 * t + c2
-		* z(t) = a3 * t + c3 */
-		double a1 = (p2.x - p1.x);
-		double c1 = p1.x;
-		double a2 = (p2.y - p1.y);
-		double c2 = p1.y;
-		double a3 = (p2.z - p1.z);
-		double c3 = p1.z;
-
-		/* per2 functions
-		 * x(t) = a4 * t + c4
-		 * y(t) = a5 * t + c5
-		 * z(t) = a6 * t + c6 */
-		double a4 = (p4.x - p3.x);
-		double c4 = p3.x;
-		double a5 = (p4.y - p3.y);
-		double c5 = p3.y;
-		double a6 = (p4.z - p3.z);
-		double c6 = p3.z;
-
-		/* compute the distance function */
-		double a_x = (a1 - a4) * (a1 - a4);
-		double a_y = (a2 - a5) * (a2 - a5);
-		double a_z = (a3 - a6) * (a3 - a6);
-		double b_x = 2 * (a1 - a4) * (c1 - c4);
-		double b_y = 2 * (a2 - a5) * (c2 - c5);
-		double b_z = 2 * (a3 - a6) * (c3 - c6);
-		double c_x = (c1 - c4) * (c1 - c4);
-		double c_y = (c2 - c5) * (c2 - c5);
-		double c_z = (c3 - c6) * (c3 - c6);
-		/* distance function = d */
-		a = a_x + a_y + a_z;
-		b = b_x + b_y + b_z;
-		c = c_x + c_y + c_z - (d * d);
+		POINT3DZ q1 = datum_get_point3dz(sv1);
+		POINT3DZ q2 = datum_get_point3dz(ev1);
+		POINT3DZ q3 = datum_get_point3dz(sv2);
+		POINT3DZ q4 = datum_get_point3dz(ev2);
+		p1[0] = q1.x; p1[1] = q1.y; p1[2] = q1.z;
+		p2[0] = q2.x; p2[1] = q2.y; p2[2] = q2.z;
+		p3[0] = q3.x; p3[1] = q3.y; p3[2] = q3.z;
+		p4[0] = q4.x; p4[1] = q4.y; p4[2] = q4.z;
 	}
 	else /* 2D */
 	{
-		POINT2D p1 = datum_get_point2d(sv1);
-		POINT2D p2 = datum_get_point2d(ev1);
-		POINT2D p3 = datum_get_point2d(sv2);
-		POINT2D p4 = datum_get_point2d(ev2);
-		/* per1 functions
-		 * x(t) = a1 * t + c1
-		 * y(t) = a2 * t + c2 */
-		double a1 = (p2.x - p1.x);
-		double c1 = p1.x;
-		double a2 = (p2.y - p1.y);
-		double c2 = p1.y;
-		/* per2 functions
-		 * x(t) = a3 * t + c3
-		 * y(t) = a4 * t + c4 */
-		double a3 = (p4.x - p3.x);
-		double c3 = p3.x;
-		double a4 = (p4.y - p3.y);
-		double c4 = p3.y;
-		/* compute the distance function */
-		double a_x = (a1 - a3) * (a1 - a3);
-		double a_y = (a2 - a4) * (a2 - a4);
-		double b_x = 2 * (a1 - a3) * (c1 - c3);
-		double b_y = 2 * (a2 - a4) * (c2 - c4);
-		double c_x = (c1 - c3) * (c1 - c3);
-		double c_y = (c2 - c4) * (c2 - c4);
-		/* distance function = d */
-		a = a_x + a_y;
-		b = b_x + b_y;
-		c = c_x + c_y - (d * d);
-	}
-	/* They are parallel, moving in the same direction at the same speed */
-	if (a == 0)
+		POINT2D q1 = datum_get_point2d(sv1);
+		POINT2D q2 = datum_get_point2d(ev1);
+		POINT2D q3 = datum_get_point2d(sv2);
+		POINT2D q4 = datum_get_point2d(ev2);
+		p1[0] = q1.x; p1[1] = q1.y;
+		p2[0] = q2.x; p2[1] = q2.y;
+		p3[0] = q3.x; p3[1] = q3.y;
+		p4[0] = q4.x; p4[1] = q4.y;
+	}
+	int64_t r1, r2;
+	int solutions = tpoint_segment_dwithin(p1, p2, p3, p4, hasz, lower, upper,
+		d, &r1, &r2);
+	/* The distance is constant, it is tested with the distance function of
+	 * the points, which may be geodetic */
+	if (solutions == TPOINT_SEGMENT_PARALLEL)
 	{
 		if (!func(sv1, sv2, Float8GetDatum(d)))
 			return 0;
@@ -1043,55 +997,11 @@ tdwithin_tpointseq_tpointseq1(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
 		*t2 = upper;
 		return 2;
 	}
-	/* Solving the quadratic equation for distance = d */
-	long double discriminant = b * b - 4 * a * c;
-
-	/* One solution */
-	if (discriminant == 0)
-	{
-		long double t5 = (-1 * b) / (2 * a);
-		if (t5 < 0.0 || t5 > 1.0)
-			return 0;
-		*t1 = lower + (long) (t5 * duration);
-		return 1;
-	}
-	/* No solution */
-	if (discriminant < 0)
-		return 0;
-	else
-	/* At most two solutions depending on whether they are within the time interval */
-	{
-		/* Apply a mixture of quadratic formula and Viète formula to improve precision */
-		long double t5, t6;
-		if (b >= 0)
-		{
-			t5 = (-1 * b - sqrtl(discriminant)) / (2 * a);
-			t6 = (2 * c ) / (-1 * b - sqrtl(discriminant));
-		}
-		else
-		{
-			t5 = (2 * c ) / (-1 * b + sqrtl(discriminant));
-			t6 = (-1 * b + sqrtl(discriminant)) / (2 * a);
-		}
-
-		/* If the two intervals do not intersect */
-		if (0.0 > t6 || t5 > 1.0) 
-			return 0;
-		/* Compute the intersection of the two intervals */
-		long double t7 = Max(0.0, t5);
-		long double t8 = Min(1.0, t6);
-		if (fabsl(t7 - t8) < EPSILON)
-		{
-			*t1 = lower + (long) (t7 * duration);
-			return 1;			
-		}
-		else
-		{
-			*t1 = lower + (long) (t7 * duration);
-			*t2 = lower + (long) (t8 * duration);
-			return 2;
-		}
-	}
+	if (solutions > 0)
+		*t1 = (TimestampTz) r1;
+	if (solutions > 1)
+		*t2 = (TimestampTz) r2;
+	return solutions;
 }
 
 /* The following function supposes that the two temporal values are synchronized.
@@ -1147,12 +1057,18 @@ tdwithin_tpointseq_tpointseq2(TemporalSeq **result,
 		return upper_inc ? 2 : 1;
 	}
 
-	/* Find the instants t1 and t2 (if any) during which the dwithin function is true */
+	/* Find the instants t1 and t2 (if any) during which the dwithin function 
+	 * is true, unless the segments are too far apart for having any */
 	TimestampTz t1, t2;
 	Datum sev1 = linear1 ? ev1 : sv1;
 	Datum sev2 = linear2 ? ev2 : sv2;
-	int solutions = tdwithin_tpointseq_tpointseq1(sv1, sev1, sv2, sev2,
-		lower, upper, DatumGetFloat8(d), hasz, func, &t1, &t2);
+	int solutions = 0;
+	if (! segments_spatial_far(sv1, sev1, sv2, sev2, DatumGetFloat8(d), hasz))
+	{
+		MOBDB_STAT_INC(crossings);
+		solutions = tdwithin_tpointseq_tpointseq1(sv1, sev1, sv2, sev2,
+			lower, upper, DatumGetFloat8(d), hasz, func, &t1, &t2);
+	}
 
 	/* No instant is returned */
 	int k;
@@ -1289,89 +1205,111 @@ tdwithin_tpointseq_tpointseq2(TemporalSeq **result,
 	return k;
 }
 
+/*
+ * Returns the temporal Boolean that is false during the period, which is 
+ * the result of the tdwithin relationship when the temporal points are 
+ * farther apart than the distance
+ */
+static TemporalSeq *
+tdwithin_false_period(const Period *p)
+{
+	TemporalInst *instants[2];
+	instants[0] = temporalinst_make(BoolGetDatum(false), p->lower, BOOLOID);
+	instants[1] = temporalinst_make(BoolGetDatum(false), p->upper, BOOLOID);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, 
+		p->lower == p->upper ? 1 : 2, p->lower_inc, p->upper_inc, false, false);
+	pfree(instants[0]); pfree(instants[1]);
+	return result;
+}
+
+/*
+ * Compute the tdwithin relationship between two sequences that are not
+ * synchronized, whose synchronized segments are obtained with a cursor. 
+ * Returns the number of sequences added to the array, which must have 
+ * space for 4 * (seq1->count + seq2->count) sequences.
+ */
 static int
-tdwithin_tpointseq_tpointseq3(TemporalSeq **result, TemporalSeq *seq1, TemporalSeq *seq2,
-	Datum d, Datum (*func)(Datum, Datum, Datum))
+tdwithin_tpointseq_tpointseq_sync(TemporalSeq **result, TemporalSeq *seq1, 
+	TemporalSeq *seq2, Datum d, Datum (*func)(Datum, Datum, Datum), bool far)
 {
-	if (seq1->count == 1)
+	SyncSeqCursor cursor;
+	if (!temporalseq_sync_cursor_init(&cursor, seq1, seq2))
+		return 0;
+
+	int k = 0;
+	if (far)
+		result[k++] = tdwithin_false_period(&cursor.inter);
+	/* If the two sequences intersect at an instant */
+	else if (timestamp_cmp_internal(cursor.inter.lower, cursor.inter.upper) == 0)
 	{
-		TemporalInst *inst1 = temporalseq_inst_n(seq1, 0);
-		TemporalInst *inst2 = temporalseq_inst_n(seq2, 0);
 		TemporalInst *inst = temporalinst_make(
-			func(temporalinst_value(inst1), temporalinst_value(inst2), d),
-			inst1->t, BOOLOID);
-		result[0] = temporalseq_from_temporalinstarr(&inst, 1,
+			func(temporalinst_value(cursor.end1), 
+				temporalinst_value(cursor.end2), d),
+			cursor.inter.lower, BOOLOID);
+		result[k++] = temporalseq_from_temporalinstarr(&inst, 1,
 			true, true, false, false);
 		pfree(inst);
-		return 1;
 	}
-
-	int k = 0;
-	TemporalInst *start1 = temporalseq_inst_n(seq1, 0);
-	TemporalInst *start2 = temporalseq_inst_n(seq2, 0);
-	bool lower_inc = seq1->period.lower_inc;
-	bool linear1 = MOBDB_FLAGS_GET_LINEAR(seq1->flags);
-	bool linear2 = MOBDB_FLAGS_GET_LINEAR(seq2->flags);
-	for (int i = 1; i < seq1->count; i++)
-	{
-		TemporalInst *end1 = temporalseq_inst_n(seq1, i);
-		TemporalInst *end2 = temporalseq_inst_n(seq2, i);
-		bool upper_inc = (i == seq1->count - 1) ? seq1->period.upper_inc : false;
-		/* The next step adds between one and three sequences */
-		k += tdwithin_tpointseq_tpointseq2(&result[k], start1, end1,
-			linear1, start2, end2, linear2, lower_inc, upper_inc, d, func);
-		start1 = end1;
-		start2 = end2;
-		lower_inc = true;
+	else
+	{
+		bool linear1 = MOBDB_FLAGS_GET_LINEAR(seq1->flags);
+		bool linear2 = MOBDB_FLAGS_GET_LINEAR(seq2->flags);
+		while (temporalseq_sync_cursor_next(&cursor))
+			/* The next step adds between one and four sequences */
+			k += tdwithin_tpointseq_tpointseq2(&result[k], cursor.start1, 
+				cursor.end1, linear1, cursor.start2, cursor.end2, linear2, 
+				cursor.lower_inc, cursor.upper_inc, d, func);
 	}
+	temporalseq_sync_cursor_end(&cursor);
 	return k;
 }
 
+/*
+ * Compute the tdwithin relationship between two arrays of sequences ordered
+ * by time, which are traversed in the order of the upper bounds of their
+ * periods without materializing the synchronized sequences.
+ * Returns NULL if the sequences do not intersect in time.
+ */
 static TemporalS *
-tdwithin_tpointseq_tpointseq(TemporalSeq *seq1, TemporalSeq *seq2, Datum param,
-	Datum (*func)(Datum, Datum, Datum))
-{
-	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * seq1->count * 4);
-	int count = tdwithin_tpointseq_tpointseq3(sequences, seq1, seq2, 
-		param, func);
-	TemporalS *result = temporals_from_temporalseqarr(sequences, count, 
-		false, true);
-	
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
-		
-	return result;
-}
-
-/* The following function supposes that the two temporal values are synchronized.
-   This should be ensured by the calling function. */
-
-static TemporalS *
-tdwithin_tpoints_tpoints(TemporalS *ts1, TemporalS *ts2, Datum d,
-	Datum (*func)(Datum, Datum, Datum))
+tdwithin_tpointseqarr_tpointseqarr(TemporalSeq **sequences1, int count1, 
+	TemporalSeq **sequences2, int count2, Datum d, 
+	Datum (*func)(Datum, Datum, Datum), bool far)
 {
-	/* Singleton sequence set */
-	if (ts1->count == 1)
-		return tdwithin_tpointseq_tpointseq(temporals_seq_n(ts1, 0), 
-			temporals_seq_n(ts2, 0), d, func);
-
-	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts1->totalcount * 4);
-	int k = 0;
-	for (int i = 0; i < ts1->count; i++)
-	{
-		TemporalSeq *seq1 = temporals_seq_n(ts1, i);
-		TemporalSeq *seq2 = temporals_seq_n(ts2, i);
-		k += tdwithin_tpointseq_tpointseq3(&sequences[k], seq1, seq2, d,
-			func);
+	int maxcount = 16;
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * maxcount);
+	int i = 0, j = 0, k = 0;
+	while (i < count1 && j < count2)
+	{
+		TemporalSeq *seq1 = sequences1[i];
+		TemporalSeq *seq2 = sequences2[j];
+		int newcount = 4 * (seq1->count + seq2->count);
+		if (k + newcount > maxcount)
+		{
+			maxcount = Max(maxcount * 2, k + newcount);
+			sequences = repalloc(sequences, sizeof(TemporalSeq *) * maxcount);
+		}
+		k += tdwithin_tpointseq_tpointseq_sync(&sequences[k], seq1, seq2, d, 
+			func, far);
+		/* Advance the sequence that ends first, since the other one may
+		 * overlap the next sequences of the first operand */
+		int cmp = period_cmp_bounds(seq1->period.upper, seq2->period.upper,
+			false, false, seq1->period.upper_inc, seq2->period.upper_inc);
+		if (cmp == 0)
+		{
+			i++; j++;
+		}
+		else if (cmp < 0)
+			i++;
+		else
+			j++;
 	}
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
-		false, true);
+	TemporalS *result = NULL;
+	if (k > 0)
+		result = temporals_from_temporalseqarr(sequences, k, false, true);
 
-	for (int i = 0; i < k; i++)
+	for (i = 0; i < k; i++)
 		pfree(sequences[i]);
 	pfree(sequences); 
-	
 	return result;
 }
 
@@ -1852,6 +1790,23 @@ tintersects_geo_tpoint(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+Temporal *
+tintersects_tpoint_geo_internal(Temporal *temp, GSERIALIZED *gs)
+{
+	Datum (*func)(Datum, Datum) = 0;
+	if (temp->valuetypid == type_oid(T_GEOMETRY))
+	{
+		if (MOBDB_FLAGS_GET_Z(temp->flags))
+			func = &geom_intersects3d;
+		else
+			func = &geom_intersects2d;
+	}
+	else if (temp->valuetypid == type_oid(T_GEOGRAPHY))
+		func = &geog_intersects;
+	return tspatialrel_tpoint_geo(temp, PointerGetDatum(gs), func, BOOLOID,
+		false);
+}
+
 PG_FUNCTION_INFO_V1(tintersects_tpoint_geo);
 
 PGDLLEXPORT Datum
@@ -1867,18 +1822,7 @@ tintersects_tpoint_geo(PG_FUNCTION_ARGS)
 		PG_FREE_IF_COPY(gs, 1);
 		PG_RETURN_NULL();
 	}
-	Datum (*func)(Datum, Datum) = 0;
-	if (temp->valuetypid == type_oid(T_GEOMETRY))
-	{
-		if (MOBDB_FLAGS_GET_Z(temp->flags))
-			func = &geom_intersects3d;
-		else
-			func = &geom_intersects2d;
-	}
-	else if (temp->valuetypid == type_oid(T_GEOGRAPHY))
-		func = &geog_intersects;
-	Temporal *result = tspatialrel_tpoint_geo(temp, PointerGetDatum(gs), 
-		func, BOOLOID, false);
+	Temporal *result = tintersects_tpoint_geo_internal(temp, gs);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_FREE_IF_COPY(gs, 1);
 	PG_RETURN_POINTER(result);
@@ -2094,26 +2038,28 @@ tdwithin_tpoint_geo(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
-PG_FUNCTION_INFO_V1(tdwithin_tpoint_tpoint);
-
-PGDLLEXPORT Datum
-tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
+/*
+ * Temporal dwithin of two temporal points, returns NULL if the temporal
+ * points do not intersect in time
+ */
+Temporal *
+tdwithin_tpoint_tpoint_internal(Temporal *temp1, Temporal *temp2, Datum dist)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	Datum dist = PG_GETARG_DATUM(2);
 	ensure_same_srid_tpoint(temp1, temp2);
 	ensure_same_dimensionality_tpoint(temp1, temp2);
-	Temporal *sync1, *sync2;
-	/* Return false if the temporal points do not intersect in time
-	   The last parameter crossing must be set to false  */
-	if (!synchronize_temporal_temporal(temp1, temp2, &sync1, &sync2, false))
+	/* The result is false at every instant if the spatial dimensions of the
+	 * bounding boxes of planar points are farther apart than the distance */
+	bool far = false;
+	if (temp1->valuetypid == type_oid(T_GEOMETRY))
 	{
-		PG_FREE_IF_COPY(temp1, 0);
-		PG_FREE_IF_COPY(temp2, 1);
-		PG_RETURN_NULL();
+		STBOX box1, box2;
+		memset(&box1, 0, sizeof(STBOX));
+		memset(&box2, 0, sizeof(STBOX));
+		temporal_bbox(&box1, temp1);
+		temporal_bbox(&box2, temp2);
+		far = stbox_spatial_far(&box1, &box2, DatumGetFloat8(dist),
+			MOBDB_FLAGS_GET_Z(temp1->flags));
 	}
-
 	Datum (*func)(Datum, Datum, Datum) = NULL;
 	ensure_point_base_type(temp1->valuetypid);
 	if (temp1->valuetypid == type_oid(T_GEOMETRY))
@@ -2126,6 +2072,36 @@ tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
 	else if (temp1->valuetypid == type_oid(T_GEOGRAPHY))
 		func = &geog_dwithin;
 
+	/* Sequences and sequence sets are synchronized on the fly segment by
+	 * segment instead of materializing the synchronized values. In that case
+	 * the result is false on the intersection of the periods of the
+	 * sequences if the temporal points are far apart */
+	if ((temp1->duration == TEMPORALSEQ || temp1->duration == TEMPORALS) &&
+		(temp2->duration == TEMPORALSEQ || temp2->duration == TEMPORALS))
+	{
+		TemporalSeq **sequences1 = temp1->duration == TEMPORALSEQ ?
+			(TemporalSeq **) &temp1 : temporals_sequences((TemporalS *) temp1);
+		TemporalSeq **sequences2 = temp2->duration == TEMPORALSEQ ?
+			(TemporalSeq **) &temp2 : temporals_sequences((TemporalS *) temp2);
+		int count1 = temp1->duration == TEMPORALSEQ ? 1 : 
+			((TemporalS *) temp1)->count;
+		int count2 = temp2->duration == TEMPORALSEQ ? 1 : 
+			((TemporalS *) temp2)->count;
+		TemporalS *result = tdwithin_tpointseqarr_tpointseqarr(sequences1, 
+			count1, sequences2, count2, dist, func, far);
+		if (temp1->duration == TEMPORALS)
+			pfree(sequences1);
+		if (temp2->duration == TEMPORALS)
+			pfree(sequences2);
+		return (Temporal *) result;
+	}
+
+	Temporal *sync1, *sync2;
+	/* Return NULL if the temporal points do not intersect in time
+	   The last parameter crossing must be set to false  */
+	if (!synchronize_temporal_temporal(temp1, temp2, &sync1, &sync2, false))
+		return NULL;
+
 	Temporal *result = NULL;
 	ensure_valid_duration(sync1->duration);
 	if (sync1->duration == TEMPORALINST)
@@ -2136,16 +2112,24 @@ tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
 		result = (Temporal *)sync_tfunc3_temporali_temporali(
 			(TemporalI *)sync1, (TemporalI *)sync2, dist, func, 
 			BOOLOID);
-	else if (sync1->duration == TEMPORALSEQ)
-		result = (Temporal *)tdwithin_tpointseq_tpointseq(
-			(TemporalSeq *)sync1, (TemporalSeq *)sync2, dist, func);
-	else if (sync1->duration == TEMPORALS)
-		result = (Temporal *)tdwithin_tpoints_tpoints(
-			(TemporalS *)sync1, (TemporalS *)sync2, dist, func);
 
 	pfree(sync1); pfree(sync2); 
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(tdwithin_tpoint_tpoint);
+
+PGDLLEXPORT Datum
+tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
+{
+	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
+	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
+	Datum dist = PG_GETARG_DATUM(2);
+	Temporal *result = tdwithin_tpoint_tpoint_internal(temp1, temp2, dist);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
+	if (result == NULL)
+		PG_RETURN_NULL();
 	PG_RETURN_POINTER(result);
 }
 
@@ -2284,4 +2268,142 @@ trelate_pattern_tpoint_tpoint(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Spatiotemporal join
+ * The pairs of temporal points of two arrays that are within a distance of
+ * each other at some instant are found by sweeping the temporal points in
+ * the order of the start of their bounding boxes. The temporal points whose
+ * bounding box has not ended at the current start are kept in an active list
+ * for each array, and the temporal relationship is only computed for the
+ * pairs of active temporal points whose bounding boxes intersect in time and,
+ * for temporal geometry points, whose spatial extents are not farther apart
+ * than the distance.
+ *****************************************************************************/
+
+typedef struct
+{
+	Temporal   *temp;			/* temporal point */
+	STBOX		box;			/* bounding box of the temporal point */
+	int			side;			/* 0 or 1 for the first or the second array */
+	int			index;			/* position of the temporal point in its array */
+} SweepItem;
+
+static int
+sweep_item_cmp(const void *a, const void *b)
+{
+	const SweepItem *item1 = (const SweepItem *) a;
+	const SweepItem *item2 = (const SweepItem *) b;
+	if (item1->box.tmin != item2->box.tmin)
+		return (item1->box.tmin < item2->box.tmin) ? -1 : 1;
+	if (item1->side != item2->side)
+		return (item1->side < item2->side) ? -1 : 1;
+	return (item1->index < item2->index) ? -1 :
+		((item1->index > item2->index) ? 1 : 0);
+}
+
+/*
+ * Temporal points of two arrays and the temporal relationship tdwithin
+ * between them for the pairs that are within the distance at some instant.
+ * The function returns one row per pair, composed of the positions of the
+ * temporal points in their arrays and of the temporal relationship.
+ */
+PG_FUNCTION_INFO_V1(tdwithin_join_tpoint_tpoint);
+
+PGDLLEXPORT Datum
+tdwithin_join_tpoint_tpoint(PG_FUNCTION_ARGS)
+{
+	ArrayType *array1 = PG_GETARG_ARRAYTYPE_P(0);
+	ArrayType *array2 = PG_GETARG_ARRAYTYPE_P(1);
+	Datum dist = PG_GETARG_DATUM(2);
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext oldcontext;
+
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo) ||
+		!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("set-valued function called in context that cannot accept a set")));
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("function returning record called in context "
+				"that cannot accept type record")));
+
+	int count1, count2;
+	Temporal **temparr1 = temporalarr_extract(array1, &count1);
+	Temporal **temparr2 = temporalarr_extract(array2, &count2);
+	SweepItem *items = palloc(sizeof(SweepItem) * (count1 + count2));
+	int count = 0;
+	for (int i = 0; i < count1 + count2; i++)
+	{
+		SweepItem *item = &items[count++];
+		item->side = (i < count1) ? 0 : 1;
+		item->index = (i < count1) ? i : i - count1;
+		item->temp = (i < count1) ? temparr1[i] : temparr2[i - count1];
+		ensure_same_srid_tpoint(items[0].temp, item->temp);
+		ensure_same_dimensionality_tpoint(items[0].temp, item->temp);
+		memset(&item->box, 0, sizeof(STBOX));
+		temporal_bbox(&item->box, item->temp);
+	}
+	qsort(items, count, sizeof(SweepItem), &sweep_item_cmp);
+
+	oldcontext = MemoryContextSwitchTo(rsinfo->econtext->ecxt_per_query_memory);
+	tupdesc = BlessTupleDesc(CreateTupleDescCopy(tupdesc));
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+	MemoryContextSwitchTo(oldcontext);
+
+	bool planar = count > 0 &&
+		items[0].temp->valuetypid == type_oid(T_GEOMETRY);
+	bool hasz = count > 0 && MOBDB_FLAGS_GET_Z(items[0].temp->flags);
+	SweepItem **active[2];
+	int nactive[2] = {0, 0};
+	active[0] = palloc(sizeof(SweepItem *) * Max(count1, 1));
+	active[1] = palloc(sizeof(SweepItem *) * Max(count2, 1));
+	for (int i = 0; i < count; i++)
+	{
+		SweepItem *item = &items[i];
+		int other = 1 - item->side;
+		/* Remove the items of the other array that ended before the start
+		 * of the current one, keeping the order of the remaining ones */
+		int k = 0;
+		for (int j = 0; j < nactive[other]; j++)
+			if (active[other][j]->box.tmax >= item->box.tmin)
+				active[other][k++] = active[other][j];
+		nactive[other] = k;
+		for (int j = 0; j < nactive[other]; j++)
+		{
+			SweepItem *cand = active[other][j];
+			if (planar && stbox_spatial_far(&item->box, &cand->box,
+					DatumGetFloat8(dist), hasz))
+				continue;
+			SweepItem *item1 = (item->side == 0) ? item : cand;
+			SweepItem *item2 = (item->side == 0) ? cand : item;
+			Temporal *result = tdwithin_tpoint_tpoint_internal(item1->temp,
+				item2->temp, dist);
+			if (result == NULL)
+				continue;
+			if (temporal_ever_eq_internal(result, BoolGetDatum(true)))
+			{
+				Datum values[3];
+				bool isnull[3] = {false, false, false};
+				values[0] = Int32GetDatum(item1->index + 1);
+				values[1] = Int32GetDatum(item2->index + 1);
+				values[2] = PointerGetDatum(result);
+				tuplestore_putvalues(tupstore, tupdesc, values, isnull);
+			}
+			pfree(result);
+		}
+		active[item->side][nactive[item->side]++] = item;
+	}
+
+	pfree(active[0]); pfree(active[1]);
+	pfree(items); pfree(temparr1); pfree(temparr2);
+	PG_FREE_IF_COPY(array1, 0);
+	PG_FREE_IF_COPY(array2, 1);
+	return (Datum) 0;
+}
+
 /*****************************************************************************/
@@ -0,0 +1,976 @@
+/*****************************************************************************
+ *
+ * tpoint_tile.c
+ *	  Split of temporal points according to a spatiotemporal grid
+ *
+ * The space is split into square cells of a given size and the time into
+ * buckets of a given duration, both aligned with an origin. Each sequence of
+ * a temporal point is traversed once and the instants at which its segments
+ * cross the boundaries of the cells and of the buckets are computed
+ * analytically. This splits the sequence into pieces, each one contained in
+ * a single tile, that is, a cell during a bucket. The pieces of a tile are
+ * then obtained by restricting the sequence to their periods. Every instant
+ * of the temporal point belongs to exactly one tile: the instant at which the
+ * point crosses a boundary belongs to the tile that starts at it.
+ *
+ * The tiles traversed by a temporal point can also be encoded as keys for
+ * indexing them with GIN.
+ *
+ * The file also contains the output of temporal points as geometries of a
+ * Mapbox vector tile (MVT), whose coordinates are relative to the tile. The
+ * instants are transformed, clipped to the tile and quantized in a single
+ * pass, keeping the timestamp of every vertex of the result.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "tpoint_tile.h"
+
+#include <math.h>
+#include <funcapi.h>
+#include <miscadmin.h>
+#include <access/htup_details.h>
+#include <utils/array.h>
+#include <utils/memutils.h>
+#include <utils/timestamp.h>
+#include <utils/tuplestore.h>
+
+#include "period.h"
+#include "temporaltypes.h"
+#include "temporal_aggfuncs.h"
+#include "temporal_util.h"
+#include "tpoint.h"
+#include "tpoint_spatialfuncs.h"
+
+/* Grid according to which a temporal point is split */
+
+typedef struct
+{
+	double xorigin;			/* Origin of the cells */
+	double yorigin;
+	double size;			/* Size of the cells */
+	TimestampTz torigin;	/* Origin of the buckets */
+	int64 duration;			/* Duration of the buckets in microseconds */
+} SplitGrid;
+
+/* Piece of a temporal point contained in a single tile */
+
+typedef struct
+{
+	int32 cellx;			/* Column of the cell */
+	int32 celly;			/* Row of the cell */
+	int64 bucket;			/* Number of the bucket */
+	int pos;				/* Position of the piece in the temporal point */
+	TemporalInst *inst;		/* Piece of an instant or an instant set */
+	TemporalSeq *seq;		/* Sequence of the piece and its period */
+	Period period;
+} SplitPiece;
+
+typedef struct
+{
+	SplitPiece *pieces;
+	int count;
+	int maxcount;
+} SplitState;
+
+/*****************************************************************************/
+
+/* Number of the cell containing the coordinate */
+
+static int32
+split_cell(double value, double origin, double size)
+{
+	double number = floor((value - origin) / size);
+	if (number < PG_INT32_MIN || number > PG_INT32_MAX)
+		ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+			errmsg("Too many cells, use a larger cell size")));
+	return (int32) number;
+}
+
+/* Set the grid from the arguments of the functions */
+
+static void
+split_grid_set(SplitGrid *grid, double size, Interval *duration,
+	GSERIALIZED *sorigin, TimestampTz torigin)
+{
+	if (size <= 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The cell size must be positive")));
+	ensure_point_type(sorigin);
+	ensure_non_empty(sorigin);
+	POINT2D origin = gs_get_point2d(sorigin);
+	grid->xorigin = origin.x;
+	grid->yorigin = origin.y;
+	grid->size = size;
+	grid->torigin = torigin;
+	grid->duration = bucket_interval_size(duration);
+}
+
+/* Add a new piece to the state and return it */
+
+static SplitPiece *
+split_piece_new(SplitState *state, const SplitGrid *grid, POINT2D *p,
+	TimestampTz t)
+{
+	if (state->count == state->maxcount)
+	{
+		state->maxcount *= 2;
+		state->pieces = repalloc(state->pieces,
+			sizeof(SplitPiece) * state->maxcount);
+	}
+	SplitPiece *result = &state->pieces[state->count];
+	memset(result, 0, sizeof(SplitPiece));
+	result->cellx = split_cell(p->x, grid->xorigin, grid->size);
+	result->celly = split_cell(p->y, grid->yorigin, grid->size);
+	result->bucket = timebin_number(t - grid->torigin, grid->duration);
+	result->pos = state->count++;
+	return result;
+}
+
+/*
+ * Add a piece of a sequence in which the point is located at p at the
+ * timestamp t. The piece is merged with the previous one when they are
+ * contiguous pieces of the same sequence in the same tile.
+ */
+static void
+split_seq_piece(SplitState *state, const SplitGrid *grid, TemporalSeq *seq,
+	POINT2D *p, TimestampTz t, TimestampTz lower, TimestampTz upper,
+	bool lower_inc, bool upper_inc)
+{
+	if (state->count > 0)
+	{
+		SplitPiece *last = &state->pieces[state->count - 1];
+		if (last->seq == seq && last->period.upper == lower &&
+			last->cellx == split_cell(p->x, grid->xorigin, grid->size) &&
+			last->celly == split_cell(p->y, grid->yorigin, grid->size) &&
+			last->bucket == timebin_number(t - grid->torigin, grid->duration))
+		{
+			last->period.upper = upper;
+			last->period.upper_inc = upper_inc;
+			return;
+		}
+	}
+	SplitPiece *piece = split_piece_new(state, grid, p, t);
+	piece->seq = seq;
+	period_set(&piece->period, lower, upper, lower_inc, upper_inc);
+}
+
+static int
+timestamp_sort_cmp(const void *a, const void *b)
+{
+	TimestampTz t1 = *(const TimestampTz *) a;
+	TimestampTz t2 = *(const TimestampTz *) b;
+	return (t1 < t2) ? -1 : ((t1 > t2) ? 1 : 0);
+}
+
+/*
+ * Add to the cuts the timestamps in (t1, t2) at which a segment going from
+ * the coordinate value1 to value2 crosses the lines of the grid
+ */
+static int
+split_segment_cuts(double value1, double value2, double origin, double size,
+	TimestampTz t1, TimestampTz t2, TimestampTz **cuts, int ncuts,
+	int *maxcuts)
+{
+	if (value1 == value2)
+		return ncuts;
+	double lo = Min(value1, value2), hi = Max(value1, value2);
+	for (double k = floor((lo - origin) / size) + 1; ; k++)
+	{
+		double line = origin + k * size;
+		if (line >= hi)
+			break;
+		if (line <= lo)
+			continue;
+		double fraction = (line - value1) / (value2 - value1);
+		TimestampTz t = t1 + (TimestampTz) ((double) (t2 - t1) * fraction);
+		if (t <= t1 || t >= t2)
+			continue;
+		if (ncuts == *maxcuts)
+		{
+			*maxcuts *= 2;
+			*cuts = repalloc(*cuts, sizeof(TimestampTz) * *maxcuts);
+		}
+		(*cuts)[ncuts++] = t;
+	}
+	return ncuts;
+}
+
+static void
+tpointseq_split(SplitState *state, const SplitGrid *grid, TemporalSeq *seq)
+{
+	if (seq->count == 1)
+	{
+		TemporalInst *inst = temporalseq_inst_n(seq, 0);
+		POINT2D p = datum_get_point2d(temporalinst_value(inst));
+		split_seq_piece(state, grid, seq, &p, inst->t, inst->t, inst->t,
+			true, true);
+		return;
+	}
+
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	int maxcuts = 16;
+	TimestampTz *cuts = palloc(sizeof(TimestampTz) * maxcuts);
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	POINT2D p1 = datum_get_point2d(temporalinst_value(inst1));
+	for (int i = 1; i < seq->count; i++)
+	{
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
+		POINT2D p2 = datum_get_point2d(temporalinst_value(inst2));
+		TimestampTz t1 = inst1->t, t2 = inst2->t;
+
+		/* Boundaries of the buckets */
+		int ncuts = 0;
+		TimestampTz bound = grid->torigin + (timebin_number(t1 - grid->torigin,
+			grid->duration) + 1) * grid->duration;
+		for (; bound < t2; bound += grid->duration)
+		{
+			if (ncuts == maxcuts)
+			{
+				maxcuts *= 2;
+				cuts = repalloc(cuts, sizeof(TimestampTz) * maxcuts);
+			}
+			cuts[ncuts++] = bound;
+		}
+		/* Boundaries of the cells, which are only crossed inside the segment
+		 * with linear interpolation */
+		if (linear)
+		{
+			ncuts = split_segment_cuts(p1.x, p2.x, grid->xorigin, grid->size,
+				t1, t2, &cuts, ncuts, &maxcuts);
+			ncuts = split_segment_cuts(p1.y, p2.y, grid->yorigin, grid->size,
+				t1, t2, &cuts, ncuts, &maxcuts);
+		}
+		if (ncuts > 1)
+			qsort(cuts, ncuts, sizeof(TimestampTz), &timestamp_sort_cmp);
+
+		/* Each piece between two consecutive cuts is in a single tile, which
+		 * is the one of its middle point */
+		TimestampTz lower = t1;
+		for (int j = 0; j <= ncuts; j++)
+		{
+			TimestampTz upper = (j < ncuts) ? cuts[j] : t2;
+			if (upper <= lower)
+				continue;
+			TimestampTz middle = lower + (upper - lower) / 2;
+			POINT2D p = p1;
+			if (linear)
+			{
+				double fraction = (double) (middle - t1) / (double) (t2 - t1);
+				p.x = p1.x + (p2.x - p1.x) * fraction;
+				p.y = p1.y + (p2.y - p1.y) * fraction;
+			}
+			bool lower_inc = (lower == seq->period.lower) ?
+				seq->period.lower_inc : true;
+			/* With stepwise interpolation the value at the inclusive upper
+			 * bound is the last value, which is added below */
+			bool upper_inc = (upper == seq->period.upper) ?
+				seq->period.upper_inc && linear : false;
+			split_seq_piece(state, grid, seq, &p, middle, lower, upper,
+				lower_inc, upper_inc);
+			lower = upper;
+		}
+		inst1 = inst2;
+		p1 = p2;
+	}
+	if (! linear && seq->period.upper_inc)
+		split_seq_piece(state, grid, seq, &p1, inst1->t, inst1->t, inst1->t,
+			true, true);
+	pfree(cuts);
+}
+
+static void
+tpoint_split(SplitState *state, const SplitGrid *grid, Temporal *temp)
+{
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+	{
+		TemporalInst *inst = (TemporalInst *) temp;
+		POINT2D p = datum_get_point2d(temporalinst_value(inst));
+		split_piece_new(state, grid, &p, inst->t)->inst = inst;
+	}
+	else if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *) temp;
+		for (int i = 0; i < ti->count; i++)
+		{
+			TemporalInst *inst = temporali_inst_n(ti, i);
+			POINT2D p = datum_get_point2d(temporalinst_value(inst));
+			split_piece_new(state, grid, &p, inst->t)->inst = inst;
+		}
+	}
+	else if (temp->duration == TEMPORALSEQ)
+		tpointseq_split(state, grid, (TemporalSeq *) temp);
+	else /* temp->duration == TEMPORALS */
+	{
+		TemporalS *ts = (TemporalS *) temp;
+		for (int i = 0; i < ts->count; i++)
+			tpointseq_split(state, grid, temporals_seq_n(ts, i));
+	}
+}
+
+/* Sort the pieces by tile and then by their position in the temporal value */
+
+static int
+split_piece_cmp(const void *a, const void *b)
+{
+	const SplitPiece *p1 = (const SplitPiece *) a;
+	const SplitPiece *p2 = (const SplitPiece *) b;
+	if (p1->cellx != p2->cellx)
+		return (p1->cellx < p2->cellx) ? -1 : 1;
+	if (p1->celly != p2->celly)
+		return (p1->celly < p2->celly) ? -1 : 1;
+	if (p1->bucket != p2->bucket)
+		return (p1->bucket < p2->bucket) ? -1 : 1;
+	return (p1->pos < p2->pos) ? -1 : ((p1->pos > p2->pos) ? 1 : 0);
+}
+
+/* Fragment of the temporal point composed of the count pieces of a tile */
+
+static Temporal *
+split_fragment(SplitPiece *pieces, int count, bool linear)
+{
+	if (pieces[0].inst != NULL)
+	{
+		if (count == 1)
+			return temporal_copy((Temporal *) pieces[0].inst);
+		TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
+		for (int i = 0; i < count; i++)
+			instants[i] = pieces[i].inst;
+		TemporalI *result = temporali_from_temporalinstarr(instants, count);
+		pfree(instants);
+		return (Temporal *) result;
+	}
+
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * count);
+	int k = 0;
+	for (int i = 0; i < count; i++)
+	{
+		TemporalSeq *seq = temporalseq_at_period(pieces[i].seq,
+			&pieces[i].period);
+		if (seq != NULL)
+			sequences[k++] = seq;
+	}
+	Temporal *result = NULL;
+	if (k == 1)
+		result = (Temporal *) sequences[0];
+	else if (k > 1)
+	{
+		result = (Temporal *) temporals_from_temporalseqarr(sequences, k,
+			linear, true);
+		for (int i = 0; i < k; i++)
+			pfree(sequences[i]);
+	}
+	pfree(sequences);
+	return result;
+}
+
+/*
+ * Split a temporal point into fragments according to a grid of square cells
+ * and of time buckets. The function returns one row per tile traversed by
+ * the temporal point, composed of the column and the row of the cell, the
+ * start of the bucket, and the fragment of the temporal point in the tile.
+ */
+
+PG_FUNCTION_INFO_V1(tpoint_space_time_split);
+
+PGDLLEXPORT Datum
+tpoint_space_time_split(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	double size = PG_GETARG_FLOAT8(1);
+	Interval *duration = PG_GETARG_INTERVAL_P(2);
+	GSERIALIZED *sorigin = PG_GETARG_GSERIALIZED_P(3);
+	TimestampTz torigin = PG_GETARG_TIMESTAMPTZ(4);
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext oldcontext;
+
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo) ||
+		!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("set-valued function called in context that cannot accept a set")));
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("function returning record called in context "
+				"that cannot accept type record")));
+	SplitGrid grid;
+	split_grid_set(&grid, size, duration, sorigin, torigin);
+	if (gserialized_get_srid(sorigin) != SRID_UNKNOWN)
+		ensure_same_srid_tpoint_gs(temp, sorigin);
+
+	SplitState state;
+	state.count = 0;
+	state.maxcount = 64;
+	state.pieces = palloc(sizeof(SplitPiece) * state.maxcount);
+	tpoint_split(&state, &grid, temp);
+	qsort(state.pieces, state.count, sizeof(SplitPiece), &split_piece_cmp);
+
+	oldcontext = MemoryContextSwitchTo(rsinfo->econtext->ecxt_per_query_memory);
+	tupdesc = BlessTupleDesc(CreateTupleDescCopy(tupdesc));
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+	MemoryContextSwitchTo(oldcontext);
+
+	bool linear = MOBDB_FLAGS_GET_LINEAR(temp->flags);
+	for (int i = 0; i < state.count; )
+	{
+		int j = i + 1;
+		while (j < state.count &&
+			state.pieces[i].cellx == state.pieces[j].cellx &&
+			state.pieces[i].celly == state.pieces[j].celly &&
+			state.pieces[i].bucket == state.pieces[j].bucket)
+			j++;
+		Temporal *fragment = split_fragment(&state.pieces[i], j - i, linear);
+		if (fragment != NULL)
+		{
+			Datum values[4];
+			bool isnull[4] = {false, false, false, false};
+			values[0] = Int32GetDatum(state.pieces[i].cellx);
+			values[1] = Int32GetDatum(state.pieces[i].celly);
+			values[2] = TimestampTzGetDatum(grid.torigin +
+				state.pieces[i].bucket * grid.duration);
+			values[3] = PointerGetDatum(fragment);
+			tuplestore_putvalues(tupstore, tupdesc, values, isnull);
+			pfree(fragment);
+		}
+		i = j;
+	}
+	pfree(state.pieces);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_NULL();
+}
+
+/*****************************************************************************
+ * Tile keys
+ *
+ * The tiles traversed by a temporal point are encoded as 64-bit keys, which
+ * can be indexed with the GIN operator class of the arrays of bigint on an
+ * expression such as tileKeys(trip, 1000, '1 hour'). The column and the row
+ * of the cell are kept in 21 bits each and the number of the bucket in 22
+ * bits, so that tiles that are far apart may have the same key. The overlap
+ * of the keys of a temporal point and of a box is thus a filter that must
+ * be followed by an exact predicate.
+ *****************************************************************************/
+
+static int64
+tile_key(int32 cellx, int32 celly, int64 bucket)
+{
+	return (int64) ((((uint64) cellx & 0x1FFFFF) << 43) |
+		(((uint64) celly & 0x1FFFFF) << 22) | ((uint64) bucket & 0x3FFFFF));
+}
+
+static int
+int64_sort_cmp(const void *a, const void *b)
+{
+	int64 k1 = *(const int64 *) a;
+	int64 k2 = *(const int64 *) b;
+	return (k1 < k2) ? -1 : ((k1 > k2) ? 1 : 0);
+}
+
+/* Array of the distinct keys, which are sorted in place */
+
+static ArrayType *
+tile_keys_array(int64 *keys, int count)
+{
+	qsort(keys, count, sizeof(int64), &int64_sort_cmp);
+	Datum *values = palloc(sizeof(Datum) * count);
+	int k = 0;
+	for (int i = 0; i < count; i++)
+	{
+		if (k == 0 || keys[i] != keys[i - 1])
+			values[k++] = Int64GetDatum(keys[i]);
+	}
+	ArrayType *result = datumarr_to_array(values, k, INT8OID);
+	pfree(values);
+	return result;
+}
+
+/*
+ * Keys of the tiles traversed by a temporal point. The tiles are those of
+ * the pieces obtained when splitting the temporal point.
+ */
+
+PG_FUNCTION_INFO_V1(tpoint_tile_keys);
+
+PGDLLEXPORT Datum
+tpoint_tile_keys(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	double size = PG_GETARG_FLOAT8(1);
+	Interval *duration = PG_GETARG_INTERVAL_P(2);
+	GSERIALIZED *sorigin = PG_GETARG_GSERIALIZED_P(3);
+	TimestampTz torigin = PG_GETARG_TIMESTAMPTZ(4);
+
+	SplitGrid grid;
+	split_grid_set(&grid, size, duration, sorigin, torigin);
+	if (gserialized_get_srid(sorigin) != SRID_UNKNOWN)
+		ensure_same_srid_tpoint_gs(temp, sorigin);
+
+	SplitState state;
+	state.count = 0;
+	state.maxcount = 64;
+	state.pieces = palloc(sizeof(SplitPiece) * state.maxcount);
+	tpoint_split(&state, &grid, temp);
+	int64 *keys = palloc(sizeof(int64) * state.count);
+	for (int i = 0; i < state.count; i++)
+		keys[i] = tile_key(state.pieces[i].cellx, state.pieces[i].celly,
+			state.pieces[i].bucket);
+	ArrayType *result = tile_keys_array(keys, state.count);
+	pfree(keys);
+	pfree(state.pieces);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_POINTER(result);
+}
+
+/*
+ * Keys of the tiles intersecting a box, including those that only touch it
+ * at their lower boundary, which are traversed by the temporal points that
+ * only touch the box at its upper boundary
+ */
+
+PG_FUNCTION_INFO_V1(stbox_tile_keys);
+
+PGDLLEXPORT Datum
+stbox_tile_keys(PG_FUNCTION_ARGS)
+{
+	STBOX *box = PG_GETARG_STBOX_P(0);
+	double size = PG_GETARG_FLOAT8(1);
+	Interval *duration = PG_GETARG_INTERVAL_P(2);
+	GSERIALIZED *sorigin = PG_GETARG_GSERIALIZED_P(3);
+	TimestampTz torigin = PG_GETARG_TIMESTAMPTZ(4);
+
+	if (! MOBDB_FLAGS_GET_X(box->flags) || ! MOBDB_FLAGS_GET_T(box->flags))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The box must have X and T dimensions")));
+	SplitGrid grid;
+	split_grid_set(&grid, size, duration, sorigin, torigin);
+
+	int32 xmin = split_cell(box->xmin, grid.xorigin, grid.size);
+	int32 xmax = split_cell(box->xmax, grid.xorigin, grid.size);
+	int32 ymin = split_cell(box->ymin, grid.yorigin, grid.size);
+	int32 ymax = split_cell(box->ymax, grid.yorigin, grid.size);
+	int64 tmin = timebin_number(box->tmin - grid.torigin, grid.duration);
+	int64 tmax = timebin_number(box->tmax - grid.torigin, grid.duration);
+	double count = ((double) xmax - xmin + 1) * ((double) ymax - ymin + 1) *
+		((double) (tmax - tmin) + 1);
+	if (count > (double) (MaxAllocSize / sizeof(Datum)))
+		ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+			errmsg("Too many tiles, use a larger cell size or duration")));
+
+	int64 *keys = palloc(sizeof(int64) * (size_t) count);
+	int k = 0;
+	for (int32 i = xmin; i <= xmax; i++)
+		for (int32 j = ymin; j <= ymax; j++)
+			for (int64 b = tmin; b <= tmax; b++)
+				keys[k++] = tile_key(i, j, b);
+	ArrayType *result = tile_keys_array(keys, k);
+	pfree(keys);
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Vector tiles
+ *****************************************************************************/
+
+/* Transformation from the coordinates of the bounds to those of the tile */
+
+typedef struct
+{
+	double xmin;			/* Bounds of the tile */
+	double ymax;
+	double xscale;			/* Tile units per coordinate unit */
+	double yscale;
+	double lo;				/* Extent of the tile including the buffer */
+	double hi;
+	bool clip;				/* The geometry is clipped to the buffered tile */
+} MVTTile;
+
+/* Vertices of the geometry being built and their timestamps */
+
+typedef struct
+{
+	POINT4D *points;
+	double *times;
+	int count;
+	int maxcount;
+	int start;				/* First vertex of the current line */
+	int *lines;				/* Number of vertices of each line */
+	int nlines;
+	int maxlines;
+} MVTState;
+
+/* Number of seconds since 1970-01-01 00:00:00+00 of a timestamp */
+
+static double
+mvt_epoch(TimestampTz t)
+{
+	return (double) t / USECS_PER_SEC +
+		((double) (POSTGRES_EPOCH_JDATE - UNIX_EPOCH_JDATE) * SECS_PER_DAY);
+}
+
+static POINT2D
+mvt_transform(const MVTTile *tile, POINT2D *p)
+{
+	POINT2D result;
+	result.x = (p->x - tile->xmin) * tile->xscale;
+	/* The y axis of the tile points downwards */
+	result.y = (tile->ymax - p->y) * tile->yscale;
+	return result;
+}
+
+static bool
+mvt_inside(const MVTTile *tile, POINT2D *p)
+{
+	return ! tile->clip || (p->x >= tile->lo && p->x <= tile->hi &&
+		p->y >= tile->lo && p->y <= tile->hi);
+}
+
+/*
+ * Add a vertex to the current line or to the points, unless it is equal to
+ * the previous one once the coordinates are rounded to the grid of the tile
+ */
+static void
+mvt_add_vertex(MVTState *state, POINT2D *p, TimestampTz t)
+{
+	double x = rint(p->x), y = rint(p->y);
+	if (state->count > state->start &&
+		state->points[state->count - 1].x == x &&
+		state->points[state->count - 1].y == y)
+		return;
+	if (state->count == state->maxcount)
+	{
+		state->maxcount *= 2;
+		state->points = repalloc(state->points,
+			sizeof(POINT4D) * state->maxcount);
+		state->times = repalloc(state->times, sizeof(double) * state->maxcount);
+	}
+	POINT4D *point = &state->points[state->count];
+	point->x = x;
+	point->y = y;
+	point->z = point->m = 0;
+	state->times[state->count++] = mvt_epoch(t);
+}
+
+/*
+ * End the current line. A line with a single vertex, such as the one of a
+ * sequence with a single instant, is kept and output as a point.
+ */
+static void
+mvt_end_line(MVTState *state)
+{
+	int count = state->count - state->start;
+	if (count == 0)
+		return;
+	if (state->nlines == state->maxlines)
+	{
+		state->maxlines *= 2;
+		state->lines = repalloc(state->lines, sizeof(int) * state->maxlines);
+	}
+	state->lines[state->nlines++] = count;
+	state->start = state->count;
+}
+
+/*
+ * Clip the segment from p1 to p2 to the buffered tile using the Liang-Barsky
+ * algorithm. Returns false if the segment is outside of the tile and
+ * otherwise sets the fractions of the segment at which it enters and leaves
+ * the tile.
+ */
+static bool
+mvt_clip_segment(const MVTTile *tile, POINT2D *p1, POINT2D *p2,
+	double *enter, double *leave)
+{
+	double dx = p2->x - p1->x, dy = p2->y - p1->y;
+	double pk[4] = {-dx, dx, -dy, dy};
+	double qk[4] = {p1->x - tile->lo, tile->hi - p1->x, p1->y - tile->lo,
+		tile->hi - p1->y};
+	*enter = 0.0;
+	*leave = 1.0;
+	if (! tile->clip)
+		return true;
+	for (int k = 0; k < 4; k++)
+	{
+		if (pk[k] == 0.0)
+		{
+			if (qk[k] < 0.0)
+				return false;
+			continue;
+		}
+		double r = qk[k] / pk[k];
+		if (pk[k] < 0.0)
+			*enter = Max(*enter, r);
+		else
+			*leave = Min(*leave, r);
+		if (*enter > *leave)
+			return false;
+	}
+	return true;
+}
+
+static void
+mvt_add_instant(MVTState *state, const MVTTile *tile, TemporalInst *inst)
+{
+	POINT2D p = datum_get_point2d(temporalinst_value(inst));
+	p = mvt_transform(tile, &p);
+	if (mvt_inside(tile, &p))
+		mvt_add_vertex(state, &p, inst->t);
+}
+
+/*
+ * Add the lines of a sequence with linear interpolation. A line ends each
+ * time the sequence leaves the buffered tile.
+ */
+static void
+mvt_add_tpointseq(MVTState *state, const MVTTile *tile, TemporalSeq *seq)
+{
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	if (seq->count == 1)
+	{
+		mvt_add_instant(state, tile, inst1);
+		mvt_end_line(state);
+		return;
+	}
+	POINT2D p1 = datum_get_point2d(temporalinst_value(inst1));
+	p1 = mvt_transform(tile, &p1);
+	for (int i = 1; i < seq->count; i++)
+	{
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
+		POINT2D p2 = datum_get_point2d(temporalinst_value(inst2));
+		p2 = mvt_transform(tile, &p2);
+		double enter, leave;
+		if (mvt_clip_segment(tile, &p1, &p2, &enter, &leave))
+		{
+			double duration = (double) (inst2->t - inst1->t);
+			if (enter > 0.0)
+				mvt_end_line(state);
+			POINT2D p;
+			p.x = p1.x + (p2.x - p1.x) * enter;
+			p.y = p1.y + (p2.y - p1.y) * enter;
+			mvt_add_vertex(state, &p, inst1->t +
+				(TimestampTz) (duration * enter));
+			p.x = p1.x + (p2.x - p1.x) * leave;
+			p.y = p1.y + (p2.y - p1.y) * leave;
+			mvt_add_vertex(state, &p, inst1->t +
+				(TimestampTz) (duration * leave));
+			if (leave < 1.0)
+				mvt_end_line(state);
+		}
+		else
+			mvt_end_line(state);
+		inst1 = inst2;
+		p1 = p2;
+	}
+	mvt_end_line(state);
+}
+
+static void
+mvt_add_tpoint(MVTState *state, const MVTTile *tile, Temporal *temp)
+{
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+		mvt_add_instant(state, tile, (TemporalInst *) temp);
+	else if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *) temp;
+		for (int i = 0; i < ti->count; i++)
+			mvt_add_instant(state, tile, temporali_inst_n(ti, i));
+	}
+	else if (! MOBDB_FLAGS_GET_LINEAR(temp->flags))
+	{
+		/* The positions of a stepwise sequence are output as points */
+		if (temp->duration == TEMPORALSEQ)
+		{
+			TemporalSeq *seq = (TemporalSeq *) temp;
+			for (int i = 0; i < seq->count; i++)
+				mvt_add_instant(state, tile, temporalseq_inst_n(seq, i));
+		}
+		else
+		{
+			TemporalS *ts = (TemporalS *) temp;
+			for (int i = 0; i < ts->count; i++)
+			{
+				TemporalSeq *seq = temporals_seq_n(ts, i);
+				for (int j = 0; j < seq->count; j++)
+					mvt_add_instant(state, tile, temporalseq_inst_n(seq, j));
+			}
+		}
+	}
+	else if (temp->duration == TEMPORALSEQ)
+		mvt_add_tpointseq(state, tile, (TemporalSeq *) temp);
+	else /* temp->duration == TEMPORALS */
+	{
+		TemporalS *ts = (TemporalS *) temp;
+		for (int i = 0; i < ts->count; i++)
+			mvt_add_tpointseq(state, tile, temporals_seq_n(ts, i));
+	}
+}
+
+/*
+ * Geometry composed of the points or the lines of the state. The lines with
+ * a single vertex are output as points, and the result is a geometry
+ * collection if there are both points and lines.
+ */
+
+static LWGEOM *
+mvt_geometry(MVTState *state, bool lines)
+{
+	if (! lines)
+	{
+		if (state->count == 1)
+			return (LWGEOM *) lwpoint_make2d(SRID_UNKNOWN,
+				state->points[0].x, state->points[0].y);
+		LWGEOM **points = palloc(sizeof(LWGEOM *) * state->count);
+		for (int i = 0; i < state->count; i++)
+			points[i] = (LWGEOM *) lwpoint_make2d(SRID_UNKNOWN,
+				state->points[i].x, state->points[i].y);
+		return (LWGEOM *) lwcollection_construct(MULTIPOINTTYPE, SRID_UNKNOWN,
+			NULL, (uint32_t) state->count, points);
+	}
+	LWGEOM **geoms = palloc(sizeof(LWGEOM *) * state->nlines);
+	bool haspoints = false, haslines = false;
+	int k = 0;
+	for (int i = 0; i < state->nlines; i++)
+	{
+		if (state->lines[i] == 1)
+		{
+			geoms[i] = (LWGEOM *) lwpoint_make2d(SRID_UNKNOWN,
+				state->points[k].x, state->points[k].y);
+			k++;
+			haspoints = true;
+			continue;
+		}
+		POINTARRAY *pa = ptarray_construct(false, false,
+			(uint32_t) state->lines[i]);
+		for (int j = 0; j < state->lines[i]; j++)
+			ptarray_set_point4d(pa, (uint32_t) j, &state->points[k++]);
+		geoms[i] = (LWGEOM *) lwline_construct(SRID_UNKNOWN, NULL, pa);
+		haslines = true;
+	}
+	if (state->nlines == 1)
+	{
+		LWGEOM *result = geoms[0];
+		pfree(geoms);
+		return result;
+	}
+	uint8_t type = (haspoints && haslines) ? COLLECTIONTYPE :
+		(haspoints ? MULTIPOINTTYPE : MULTILINETYPE);
+	return (LWGEOM *) lwcollection_construct(type, SRID_UNKNOWN,
+		NULL, (uint32_t) state->nlines, geoms);
+}
+
+/*
+ * Transform a temporal point into the coordinate space of a vector tile
+ * whose bounds are given by the spatial dimension of the box. The time
+ * dimension of the box, if any, restricts the temporal point. The function
+ * returns the geometry of the temporal point in the tile and the timestamps
+ * of its vertices as the number of seconds since 1970-01-01 00:00:00+00, or
+ * NULL if the temporal point does not intersect the tile.
+ */
+
+PG_FUNCTION_INFO_V1(tpoint_as_mvtgeom);
+
+PGDLLEXPORT Datum
+tpoint_as_mvtgeom(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	STBOX *bounds = PG_GETARG_STBOX_P(1);
+	int32 extent = PG_GETARG_INT32(2);
+	int32 buffer = PG_GETARG_INT32(3);
+	bool clip = PG_GETARG_BOOL(4);
+	TupleDesc tupdesc;
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("function returning record called in context "
+				"that cannot accept type record")));
+	if (! MOBDB_FLAGS_GET_X(bounds->flags))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The bounds must have X and Y dimensions")));
+	if (bounds->xmax <= bounds->xmin || bounds->ymax <= bounds->ymin)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The bounds must have a positive width and height")));
+	if (extent <= 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The extent must be positive")));
+	if (buffer < 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The buffer must be positive or zero")));
+
+	MVTTile tile;
+	tile.xmin = bounds->xmin;
+	tile.ymax = bounds->ymax;
+	tile.xscale = extent / (bounds->xmax - bounds->xmin);
+	tile.yscale = extent / (bounds->ymax - bounds->ymin);
+	tile.lo = - (double) buffer;
+	tile.hi = (double) extent + buffer;
+	tile.clip = clip;
+
+	/* Filter the temporal points that do not intersect the buffered tile */
+	STBOX box;
+	memset(&box, 0, sizeof(STBOX));
+	temporal_bbox(&box, temp);
+	double xbuffer = buffer / tile.xscale, ybuffer = buffer / tile.yscale;
+	if (clip && (box.xmax < bounds->xmin - xbuffer ||
+		box.xmin > bounds->xmax + xbuffer ||
+		box.ymax < bounds->ymin - ybuffer || box.ymin > bounds->ymax + ybuffer))
+	{
+		PG_FREE_IF_COPY(temp, 0);
+		PG_RETURN_NULL();
+	}
+	Temporal *temp1 = temp;
+	if (MOBDB_FLAGS_GET_T(bounds->flags))
+	{
+		Period p;
+		period_set(&p, bounds->tmin, bounds->tmax, true, true);
+		temp1 = temporal_at_period_internal(temp, &p);
+		if (temp1 == NULL)
+		{
+			PG_FREE_IF_COPY(temp, 0);
+			PG_RETURN_NULL();
+		}
+	}
+
+	MVTState state;
+	state.count = state.start = state.nlines = 0;
+	state.maxcount = state.maxlines = 64;
+	state.points = palloc(sizeof(POINT4D) * state.maxcount);
+	state.times = palloc(sizeof(double) * state.maxcount);
+	state.lines = palloc(sizeof(int) * state.maxlines);
+	bool lines = MOBDB_FLAGS_GET_LINEAR(temp1->flags) &&
+		(temp1->duration == TEMPORALSEQ || temp1->duration == TEMPORALS);
+	mvt_add_tpoint(&state, &tile, temp1);
+	if (temp1 != temp)
+		pfree(temp1);
+	if (state.count == 0)
+	{
+		pfree(state.points); pfree(state.times); pfree(state.lines);
+		PG_FREE_IF_COPY(temp, 0);
+		PG_RETURN_NULL();
+	}
+
+	LWGEOM *geom = mvt_geometry(&state, lines);
+	Datum *times = palloc(sizeof(Datum) * state.count);
+	for (int i = 0; i < state.count; i++)
+		times[i] = Float8GetDatum(state.times[i]);
+	Datum values[2];
+	bool isnull[2] = {false, false};
+	values[0] = PointerGetDatum(geometry_serialize(geom));
+	values[1] = PointerGetDatum(datumarr_to_array(times, state.count,
+		FLOAT8OID));
+	HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
+	lwgeom_free(geom);
+	pfree(times);
+	pfree(state.points); pfree(state.times); pfree(state.lines);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
+/*****************************************************************************/
@@ -13,6 +13,10 @@ SELECT stbox 'GEODSTBOX T(( , , 2001-01-03), ( , , 2001-01-03))';
 
 SELECT stbox 'STBOX ZT((5,6,7,2001-01-08), (1,2,3,2001-01-04))';
 
+SELECT zorder(stbox 'STBOX T((1,1,2001-01-01),(1,1,2001-01-01))', stbox 'STBOX T((1,1,2001-01-01),(11,11,2001-01-11))');
+SELECT zorder(stbox 'STBOX T((11,11,2001-01-11),(11,11,2001-01-11))', stbox 'STBOX T((1,1,2001-01-01),(11,11,2001-01-11))');
+SELECT zorder(stbox 'STBOX T((1,1,2001-01-02),(3,3,2001-01-03))', stbox 'STBOX T((1,1,2001-01-01),(11,11,2001-01-11))') < zorder(stbox 'STBOX T((9,9,2001-01-02),(11,11,2001-01-03))', stbox 'STBOX T((1,1,2001-01-01),(11,11,2001-01-11))');
+
 /* Errors */
 SELECT stbox 'AAA(1, 2, 3)';
 SELECT stbox 'stbox(1, 2, 3)';
@@ -8,6 +8,7 @@ SELECT asText(tgeompoint 'Point(1 1)@2012-01-01 08:00:00');
 SELECT asText(tgeompoint '  Point(2 2)@2012-01-01 08:00:00  ');
 SELECT asText(tgeogpoint 'Point(1 1)@2012-01-01 08:00:00');
 SELECT asText(tgeogpoint '  Point(2 2) @ 2012-01-01 08:00:00  ');
+SELECT asText(tgeompoint '0101000000000000000000F03F000000000000F03F@2012-01-01 08:00:00');
 /* Errors */
 SELECT tgeompoint 'TRUE@2012-01-01 08:00:00';
 SELECT tgeogpoint 'ABC@2012-01-01 08:00:00';
@@ -86,6 +87,7 @@ SELECT tgeogpoint '{[Point(1 1)@2001-01-01 08:00:00],[Point(2 2)@2001-01-01 08:0
 SELECT asewkt(tgeompoint 'SRID=4326;[Point(0 1)@2000-01-01, Point(0 1)@2000-01-02]');
 SELECT asewkt(tgeompoint '[SRID=4326;Point(0 1)@2000-01-01, Point(0 1)@2000-01-02]');
 SELECT asewkt(tgeompoint '[SRID=4326;Point(0 1)@2000-01-01, SRID=4326;Point(0 1)@2000-01-02]');
+SELECT asewkt(tgeompoint '[Point(0 1)@2000-01-01, SRID=4326;Point(0 1)@2000-01-02]');
 
 SELECT asewkt(tgeompoint 'SRID=4326;{[Point(0 1)@2000-01-01], [Point(0 1)@2000-01-02]}');
 SELECT asewkt(tgeompoint '{[SRID=4326;Point(0 1)@2000-01-01], [Point(0 1)@2000-01-02]}');
@@ -1266,3 +1268,27 @@ SELECT tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(
 SELECT tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}' >= tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}';
 
 ------------------------------------------------------------------------------
+SELECT compress(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]') = tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]';
+SELECT compress(tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03]') = tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03]';
+SELECT compress(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]') = tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]';
+SELECT isCompressed(compress(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]'));
+SELECT stbox(compress(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]')) = stbox(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]');
+SELECT asewkt(tgeompoint 'SRID=4326;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]'::tgeompoint(Sequence, Point, 4326));
+SELECT asText(tgeogpoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02]'::tgeogpoint(Sequence, PointZ));
+
+-- Input of points with and without the fast path parser
+SELECT asewkt(tgeompoint '[SRID=4326;Point Z(1 2 3)@2000-01-01 08:00:00+02, Point(1.5 2.5 -3e2)@2000-01-02]');
+SELECT asewkt(tgeompoint '0101000000000000000000F03F000000000000F03F@2000-01-01');
+
+-- Sequence constructors from arrays of coordinates and timestamps
+SELECT asewkt(tgeompointseq(ARRAY[1, 2, 3]::float8[], ARRAY[1, 2, 1]::float8[], ARRAY[timestamptz '2000-01-01', '2000-01-02', '2000-01-03']));
+SELECT asewkt(tgeompointseq(ARRAY[1, 2]::float8[], ARRAY[1, 2]::float8[], ARRAY[3, 4]::float8[], ARRAY[timestamptz '2000-01-01', '2000-01-02'], 4326));
+SELECT tgeompointseq(ARRAY[1, 2]::float8[], ARRAY[1]::float8[], ARRAY[timestamptz '2000-01-01', '2000-01-02']);
+
+-- Trajectory expanded when appending an instant
+SELECT ST_AsText(trajectory(appendInstant(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', tgeompoint 'Point(3 1)@2000-01-04')));
+SELECT ST_AsText(trajectory(appendInstant(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-03]', tgeompoint 'Point(4 0)@2000-01-04')));
+SELECT Box2D(trajectory(appendInstant(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-03]', tgeompoint 'Point(4 0)@2000-01-04')));
+SELECT ST_AsText(trajectory(appendInstant(tgeompoint 'Interp=Stepwise;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]', tgeompoint 'Point(1 1)@2000-01-03')));
+SELECT ST_AsText(trajectory(appendInstant(tgeompoint 'Interp=Stepwise;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]', tgeompoint 'Point(3 0)@2000-01-03')));
+SELECT Box2D(trajectory(appendInstant(tgeompoint 'Interp=Stepwise;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]', tgeompoint 'Point(3 0)@2000-01-03')));
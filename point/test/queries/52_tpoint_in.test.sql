@@ -27,5 +27,11 @@ SELECT asEWKT(fromEWKB(asEWKB(tgeompoint 'SRID=4326;Point(1 2 3)@2000-01-01')));
 SELECT asEWKT(fromEWKB(asEWKB(tgeompoint 'SRID=4326;{Point(1 2 3)@2000-01-01, Point(4 5 6)@2000-01-02}')));
 SELECT asEWKT(fromEWKB(asEWKB(tgeompoint 'SRID=4326;[Point(1 2 3)@2000-01-01, Point(4 5 6)@2000-01-02]')));
 SELECT asEWKT(fromEWKB(asEWKB(tgeompoint 'SRID=4326;{[Point(1 2 3)@2000-01-01, Point(4 5 6)@2000-01-02],[Point(1 2 3)@2000-01-03, Point(4 5 6)@2000-01-04]}')));
+SELECT asEWKT(fromEWKB(asEWKB(tgeompoint 'SRID=4326;{[Point(1 2 3)@2000-01-01, Point(4 5 6)@2000-01-02],[Point(1 2 3)@2000-01-03, Point(4 5 6)@2000-01-04]}', 'XDR')));
 
 -----------------------------------------------------------------------
+
+-- Members in any order, unknown members skipped
+SELECT asEWKT(fromMFJSON('{"interpolations":["Linear"], "type":"MovingPoint", "stBoundedBy":{"bbox":[1,2,3,4]}, "lower_inc":true, "upper_inc":false, "datetimes":["2000-01-01T00:00:00+00","2000-01-02T00:00:00+00"], "coordinates":[[1,2],[3.5e0,4]]}'));
+SELECT fromMFJSON('{"type":"MovingPoint","coordinates":[1,2],');
+SELECT fromMFJSON('{"type":"MovingPoint","coordinates":[1],"datetimes":"2000-01-01","interpolations":["Discrete"]}');
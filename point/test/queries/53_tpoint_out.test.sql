@@ -72,6 +72,8 @@ SELECT asMFJSON(tgeompoint 'SRID=123456;Point(50.813810 4.384260)@2019-01-01 18:
 SELECT asBinary(tgeompoint 'Point(1 1)@2000-01-01');
 SELECT asEWKB(tgeompoint 'SRID=4326;Point(1 1)@2000-01-01');
 SELECT asHexEWKB(tgeompoint 'SRID=4326;Point(1 1)@2000-01-01');
+SELECT asHexEWKB(tgeompoint 'SRID=4326;Point(1 1)@2000-01-01', 'XDR');
+SELECT asHexEWKB(tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02]', 'XDR');
 
 -------------------------------------------------------------------------------
 
@@ -32,6 +32,7 @@ SELECT startValue(transform(setSRID(tgeompoint 'Point(1 1 1)@2000-01-01', 5676),
 SELECT startValue(transform(setSRID(tgeompoint '{Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03}', 5676), 4326)) = st_transform(geometry 'SRID=5676;Point(1 1 1)', 4326);
 SELECT startValue(transform(setSRID(tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03]', 5676), 4326)) = st_transform(geometry 'SRID=5676;Point(1 1 1)', 4326);
 SELECT startValue(transform(setSRID(tgeompoint '{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}', 5676), 4326)) = st_transform(geometry 'SRID=5676;Point(1 1 1)', 4326);
+SELECT endValue(transform(setSRID(tgeompoint '{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}', 5676), 4326)) = st_transform(geometry 'SRID=5676;Point(3 3 3)', 4326);
 
 --------------------------------------------------------
 
@@ -251,6 +252,16 @@ SELECT round(degrees(azimuth(tgeompoint '(Point(0 0)@2000-01-01, Point(1 1)@2000
 
 --------------------------------------------------------
 
+SELECT asText(simplify(tgeompoint 'Point(1 1)@2000-01-01', 1));
+SELECT asText(simplify(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0.1)@2000-01-02, Point(2 0)@2000-01-03]', 0.5));
+SELECT asText(simplify(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0.1)@2000-01-02, Point(2 0)@2000-01-03]', 0.05));
+SELECT asText(simplify(tgeompoint '{[Point(0 0)@2000-01-01, Point(1 0.1)@2000-01-02, Point(2 0)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', 0.5));
+SELECT asText(simplify(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-01 01:00:00, Point(2 0)@2000-01-03]', 0.5));
+SELECT asText(simplify(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-01 01:00:00, Point(2 0)@2000-01-03]', 0.5, false));
+SELECT asText(speedSimplify(tgeompoint '[Point(0 0)@2000-01-01 00:00:00, Point(1 0.1)@2000-01-01 00:00:01, Point(2 0)@2000-01-01 00:00:02, Point(12 0)@2000-01-01 00:00:03]', 5));
+
+--------------------------------------------------------
+
 -- 2D
 SELECT asText(atGeometry(tgeompoint 'Point(1 1)@2000-01-01', geometry 'Linestring(0 0,3 3)'));
 SELECT asText(atGeometry(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}', geometry 'Linestring(0 0,3 3)'));
@@ -283,11 +294,34 @@ SELECT asText(atGeometry(tgeompoint '[Point(1 1)@2000-01-01]', geometry 'Linestr
 SELECT asText(atGeometry(tgeompoint '[Point(1 1)@2000-01-01]', geometry 'Linestring(2 2,3 3)'));
 SELECT asText(atGeometry(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]}', geometry 'Linestring(0 1,1 2)'));
 SELECT asText(atGeometry(tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02)', geometry 'Linestring(1 1,2 2)'));
+-- Polygons
+SELECT asText(atGeometry(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', geometry 'Polygon((1 -1,3 -1,3 1,1 1,1 -1))'));
+SELECT asText(atGeometry(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', geometry 'Polygon((0 -1,4 -1,4 1,0 1,0 -1),(1 -0.5,3 -0.5,3 0.5,1 0.5,1 -0.5))'));
+SELECT asText(atGeometry(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', geometry 'MultiPolygon(((1 -1,2 -1,2 1,1 1,1 -1)),((3 -1,4 -1,4 1,3 1,3 -1)))'));
+SELECT asText(atGeometry(tgeompoint '[Point(0 2)@2000-01-01, Point(4 2)@2000-01-05]', geometry 'Polygon((1 0,2 2,3 0,1 0))'));
+SELECT asText(atGeometry(tgeompoint '[Point(0 1)@2000-01-01, Point(4 1)@2000-01-05]', geometry 'Polygon((1 -1,3 -1,3 1,1 1,1 -1))'));
 
 /* Errors */
 SELECT atGeometry(tgeompoint 'Point(1 1)@2000-01-01', geometry 'SRID=5676;Linestring(1 1,2 2)');
 SELECT atGeometry(tgeompoint 'Point(1 1)@2000-01-01', geometry 'Linestring(1 1 1,2 2 2)');
 
+-- Zones
+SELECT id, asText(trip) FROM atGeometries(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]',
+  ARRAY[1, 2, 3, 4], ARRAY[geometry 'Polygon((1 -1,2 -1,2 1,1 1,1 -1))', 'Polygon((2 -1,4 -1,4 1,2 1,2 -1))',
+  'Polygon((10 10,11 10,11 11,10 10))', 'Linestring(0 -1,0 1)']);
+SELECT id, asText(trip) FROM atGeometries(tgeompoint '{Point(1 0)@2000-01-01, Point(3 0)@2000-01-02, Point(20 20)@2000-01-03}',
+  ARRAY[1, 2], ARRAY[geometry 'Polygon((0 -1,2 -1,2 1,0 1,0 -1))', 'Polygon((1 -1,4 -1,4 1,1 1,1 -1))']);
+SELECT k, id, asText(trip)
+FROM (VALUES (1, tgeompoint '{[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05], [Point(3 0)@2000-01-06]}'),
+  (2, tgeompoint '[Point(5 0)@2000-01-01, Point(3 0)@2000-01-03]')) t(k, temp),
+  atGeometries(temp, ARRAY[1, 2], ARRAY[geometry 'Polygon((1 -1,2 -1,2 1,1 1,1 -1))', 'Polygon((2 -1,4 -1,4 1,2 1,2 -1))'])
+ORDER BY k, id;
+/* Errors */
+SELECT * FROM atGeometries(tgeompoint 'Point(1 1)@2000-01-01', ARRAY[1, 2], ARRAY[geometry 'Point(1 1)']);
+SELECT * FROM atGeometries(tgeompoint 'Point(1 1)@2000-01-01', ARRAY[1], ARRAY[NULL::geometry]);
+SELECT * FROM atGeometries(tgeompoint 'Point(1 1)@2000-01-01', ARRAY[1], ARRAY[geometry 'SRID=5676;Point(1 1)']);
+SELECT * FROM atGeometries(tgeompoint 'Point(1 1)@2000-01-01', ARRAY[1], ARRAY[geometry 'Point(1 1 1)']);
+
 -- 2D
 SELECT asText(minusGeometry(tgeompoint 'Point(1 1)@2000-01-01', geometry 'Linestring(0 0,3 3)'));
 SELECT asText(minusGeometry(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}', geometry 'Linestring(0 0,3 3)'));
@@ -317,6 +351,7 @@ SELECT asText(minusGeometry(tgeompoint 'Interp=Stepwise;{[Point(1 1 1)@2000-01-0
 
 SELECT asText(minusGeometry(tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02)', geometry 'Linestring(0 1,2 1)'));
 SELECT asText(minusGeometry(tgeompoint '{[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02)}', geometry 'Linestring(0 1,2 1)'));
+SELECT asText(minusGeometry(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', geometry 'Polygon((1 -1,3 -1,3 1,1 1,1 -1))'));
 
 /* Errors */
 SELECT minusGeometry(tgeompoint 'Point(1 1)@2000-01-01', geometry 'SRID=5676;Linestring(1 1,2 2)');
@@ -324,6 +359,19 @@ SELECT minusGeometry(tgeompoint 'Point(1 1)@2000-01-01', geometry 'Linestring(1
 
 --------------------------------------------------------
 
+SELECT asText(atStbox(tgeompoint 'Point(1 1)@2000-01-01', stbox 'STBOX((0,0),(2,2))'));
+SELECT asText(atStbox(tgeompoint '{Point(1 1)@2000-01-01, Point(3 3)@2000-01-02}', stbox 'STBOX((0,0),(2,2))'));
+SELECT asText(atStbox(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', stbox 'STBOX((1,-1),(3,1))'));
+SELECT asText(atStbox(tgeompoint 'Interp=Stepwise;[Point(0 0)@2000-01-01, Point(2 0)@2000-01-02, Point(4 0)@2000-01-03]', stbox 'STBOX((1,-1),(3,1))'));
+SELECT asText(atStbox(tgeompoint '{[Point(1 1 1)@2000-01-01, Point(3 3 3)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}', stbox 'STBOX Z((0,0,0),(2,2,2))'));
+SELECT asText(atStbox(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', stbox 'STBOX T((1,-1,2000-01-03),(3,1,2000-01-05))'));
+SELECT asText(atStbox(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', stbox 'STBOX((5,5),(6,6))'));
+
+/* Errors */
+SELECT atStbox(tgeompoint 'Point(1 1)@2000-01-01', stbox 'GEODSTBOX((1,1,1),(2,2,2))');
+
+--------------------------------------------------------
+
 SELECT asText(NearestApproachInstant(tgeompoint 'Point(1 1)@2000-01-01', geometry 'Linestring(0 0,3 3)'));
 SELECT asText(NearestApproachInstant(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}', geometry 'Linestring(0 0,3 3)'));
 SELECT asText(NearestApproachInstant(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', geometry 'Linestring(0 0,3 3)'));
@@ -386,6 +434,8 @@ SELECT asText(NearestApproachInstant(tgeompoint 'Point(1 1)@2000-01-01', tgeompo
 SELECT asText(NearestApproachInstant(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}', tgeompoint '{[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}'));
 SELECT asText(NearestApproachInstant(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', tgeompoint '{[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}'));
 SELECT asText(NearestApproachInstant(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', tgeompoint '{[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}'));
+SELECT asText(NearestApproachInstant(tgeompoint '[Point(0 0)@2000-01-01, Point(10 0)@2000-01-11]', tgeompoint '[Point(0 5)@2000-01-01, Point(5 1)@2000-01-06, Point(10 5)@2000-01-11]'));
+SELECT asText(NearestApproachInstant(tgeompoint '{[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03],[Point(8 0)@2000-01-09, Point(10 0)@2000-01-11]}', tgeompoint '[Point(0 3)@2000-01-01, Point(10 3)@2000-01-11]'));
 
 SELECT asText(NearestApproachInstant(tgeompoint 'Point(1 1 1)@2000-01-01', tgeompoint 'Point(2 2 2)@2000-01-01'));
 SELECT asText(NearestApproachInstant(tgeompoint '{Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03}', tgeompoint 'Point(2 2 2)@2000-01-01'));
@@ -552,6 +602,9 @@ SELECT round(NearestApproachDistance(tgeompoint 'Point(1 1)@2000-01-01', tgeompo
 SELECT round(NearestApproachDistance(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}', tgeompoint '{[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}')::numeric, 6);
 SELECT round(NearestApproachDistance(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', tgeompoint '{[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}')::numeric, 6);
 SELECT round(NearestApproachDistance(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', tgeompoint '{[Point(2 2)@2000-01-01, Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}')::numeric, 6);
+SELECT round(NearestApproachDistance(tgeompoint '[Point(0 0)@2000-01-01, Point(10 0)@2000-01-11]', tgeompoint '[Point(0 5)@2000-01-01, Point(5 1)@2000-01-06, Point(10 5)@2000-01-11]')::numeric, 6);
+SELECT round(NearestApproachDistance(tgeompoint '{[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03],[Point(8 0)@2000-01-09, Point(10 0)@2000-01-11]}', tgeompoint '[Point(0 3)@2000-01-01, Point(10 3)@2000-01-11]')::numeric, 6);
+SELECT round(NearestApproachDistance(tgeompoint '{[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02],[Point(10 0)@2000-01-03, Point(11 0)@2000-01-04]}', geometry 'Point(13 0)')::numeric, 6);
 
 SELECT round(NearestApproachDistance(tgeompoint 'Point(1 1 1)@2000-01-01', tgeompoint 'Point(2 2 2)@2000-01-01')::numeric, 6);
 SELECT round(NearestApproachDistance(tgeompoint '{Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03}', tgeompoint 'Point(2 2 2)@2000-01-01')::numeric, 6);
@@ -760,6 +813,12 @@ SELECT NearestApproachDistance(geometry 'Linestring(1 1 1,2 2 2)', tgeompoint 'P
 SELECT NearestApproachDistance(tgeompoint 'Point(1 1)@2000-01-01', tgeompoint 'SRID=5676;Point(1 1)@2000-01-01');
 SELECT NearestApproachDistance(tgeompoint 'Point(1 1)@2000-01-01', tgeompoint 'Point(1 1 1)@2000-01-01');
 
+SELECT array_agg(distance ORDER BY i) FROM nearestApproachDistance(ARRAY[tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]', '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]'], ARRAY[tgeompoint '[Point(2 1)@2000-01-01, Point(0 1)@2000-01-03]', '[Point(0 0)@2000-01-03, Point(1 1)@2000-01-04]']);
+SELECT bool_and(abs(n.distance - nearestApproachDistance(a1[n.i], a2[n.i])) <= 1e-6) FROM (SELECT ARRAY[tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', '{Point(1 1)@2000-01-01, Point(3 3)@2000-01-03}', '{[Point(0 0)@2000-01-01, Point(2 2)@2000-01-02], [Point(3 3)@2000-01-03, Point(4 4)@2000-01-04]}', 'Point(1 0)@2000-01-02'] AS a1, ARRAY[tgeompoint 'Interp=Stepwise;[Point(2 3)@2000-01-01, Point(2 1)@2000-01-03, Point(2 0.5)@2000-01-05]', '{[Point(0 0)@2000-01-01, Point(2 2)@2000-01-02], [Point(3 2)@2000-01-03, Point(4 4)@2000-01-04]}', '{[Point(2 0)@2000-01-01, Point(0 2)@2000-01-02], [Point(4 3)@2000-01-03, Point(3 3)@2000-01-04]}', '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-03]'] AS a2) t, nearestApproachDistance(a1, a2) n;
+SELECT round(distance::numeric, 6) FROM nearestApproachDistance(ARRAY[tgeompoint '[Point(0 0 0)@2012-01-01, Point(1 1 1)@2012-01-03, Point(0 0 0)@2012-01-05)'], ARRAY[tgeompoint '[Point(2 0 0)@2012-01-02, Point(1 1 1)@2012-01-04, Point(2 2 2)@2012-01-06)']);
+SELECT * FROM nearestApproachDistance(ARRAY[tgeompoint 'Point(1 1)@2000-01-01'], ARRAY[tgeompoint 'Point(1 1)@2000-01-01', 'Point(2 2)@2000-01-01']);
+SELECT * FROM nearestApproachDistance(ARRAY[tgeompoint 'Point(1 1)@2000-01-01'], ARRAY[tgeompoint 'Point(1 1 1)@2000-01-01']);
+
 --------------------------------------------------------
 
 SELECT ST_AsTexT(ShortestLine(tgeompoint 'Point(1 1)@2000-01-01', geometry 'Linestring(0 0,3 3)'));
@@ -976,3 +1035,22 @@ POLYGON M((1 1 946681200,1 2 946681200,2 2 946681200,2 1 946681200,1 1 946681200
 
 -------------------------------------------------------------------------------
 
+
+-- Trajectory computed when it is needed
+SET mobilitydb.precompute_trajectory = off;
+SELECT ST_AsText(trajectory(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]'));
+SELECT ST_AsText(trajectory(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}'));
+SELECT ST_AsText(trajectory(tgeompoint 'Interp=Stepwise;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]'));
+SELECT ST_AsText(trajectory(appendInstant(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]', tgeompoint 'Point(3 1)@2000-01-03')));
+SELECT length(tgeompoint '[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02]');
+SELECT intersects(tgeompoint '[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02]', geometry 'Linestring(0 4,3 0)');
+RESET mobilitydb.precompute_trajectory;
+
+-- Length kept in the summary of the sequences
+SET mobilitydb.precompute_summary = on;
+SELECT length(tgeompoint '[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02, Point(3 0)@2000-01-03]');
+SELECT length(appendInstant(tgeompoint '[Point(0 0)@2000-01-01, Point(3 4)@2000-01-02]', tgeompoint 'Point(3 0)@2000-01-03'));
+-- The summary is recomputed when converting between geometry and geography
+SELECT length(tgeompoint '[Point(0 0)@2000-01-01, Point(0 1)@2000-01-02]'::tgeogpoint) = length(tgeogpoint '[Point(0 0)@2000-01-01, Point(0 1)@2000-01-02]');
+SELECT length(tgeogpoint '[Point(0 0)@2000-01-01, Point(0 1)@2000-01-02]'::tgeompoint);
+RESET mobilitydb.precompute_summary;
@@ -125,6 +125,25 @@ SELECT count(*) FROM tbl_tgeompoint3D t1,
 ( SELECT * FROM tbl_tgeompoint3D LIMIT 10 ) t2 
 WHERE NearestApproachDistance(t1.temp, t2.temp) IS NOT NULL;
 
+SELECT count(distance) FROM (
+SELECT array_agg(t1.temp ORDER BY t1.k, t2.k) AS a1, array_agg(t2.temp ORDER BY t1.k, t2.k) AS a2
+FROM tbl_tgeompoint t1, ( SELECT * FROM tbl_tgeompoint LIMIT 10 ) t2
+WHERE t1.temp IS NOT NULL AND t2.temp IS NOT NULL ) t, nearestApproachDistance(a1, a2);
+SELECT count(*) FROM (
+SELECT array_agg(t1.temp ORDER BY t1.k, t2.k) AS a1, array_agg(t2.temp ORDER BY t1.k, t2.k) AS a2
+FROM tbl_tgeompoint t1, ( SELECT * FROM tbl_tgeompoint LIMIT 10 ) t2
+WHERE t1.temp IS NOT NULL AND t2.temp IS NOT NULL ) t, nearestApproachDistance(a1, a2) n
+WHERE abs(n.distance - nearestApproachDistance(a1[n.i], a2[n.i])) > 1e-6;
+SELECT count(distance) FROM (
+SELECT array_agg(t1.temp ORDER BY t1.k, t2.k) AS a1, array_agg(t2.temp ORDER BY t1.k, t2.k) AS a2
+FROM tbl_tgeompoint3D t1, ( SELECT * FROM tbl_tgeompoint3D LIMIT 10 ) t2
+WHERE t1.temp IS NOT NULL AND t2.temp IS NOT NULL ) t, nearestApproachDistance(a1, a2);
+SELECT count(*) FROM (
+SELECT array_agg(t1.temp ORDER BY t1.k, t2.k) AS a1, array_agg(t2.temp ORDER BY t1.k, t2.k) AS a2
+FROM tbl_tgeompoint3D t1, ( SELECT * FROM tbl_tgeompoint3D LIMIT 10 ) t2
+WHERE t1.temp IS NOT NULL AND t2.temp IS NOT NULL ) t, nearestApproachDistance(a1, a2) n
+WHERE abs(n.distance - nearestApproachDistance(a1[n.i], a2[n.i])) > 1e-6;
+
 SELECT count(*) FROM tbl_tgeogpoint, 
 ( SELECT * FROM tbl_geography LIMIT 10 ) t
 WHERE NearestApproachDistance(temp, g) IS NOT NULL;
@@ -224,4 +243,45 @@ SELECT (temp::geography)::tgeogpoint FROM tbl_tgeogpoint3D LIMIT 10;
 -- set parallel_setup_cost=100;
 set force_parallel_mode=off;
 
+-- Values stored out of line through the detoast cache
+
+CREATE TABLE tbl_tgeompoint_toast(k int, trip tgeompoint);
+ALTER TABLE tbl_tgeompoint_toast ALTER COLUMN trip SET STORAGE EXTERNAL;
+INSERT INTO tbl_tgeompoint_toast
+SELECT k, tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(k + i, 0),
+  timestamptz '2001-01-01' + (i - 1) * interval '1 minute') ORDER BY i))
+FROM generate_series(1, 3) k, generate_series(1, 1000) i GROUP BY k;
+SELECT k, length(trip), timespan(trip), ST_AsText(startValue(trip)),
+  ST_AsText(valueAtTimestamp(trip, '2001-01-01 00:10:00')),
+  round((twavg(speed(trip)) * 60)::numeric, 6)
+FROM tbl_tgeompoint_toast ORDER BY k;
+SET mobilitydb.detoast_cache_size = 0;
+SELECT k, length(trip), timespan(trip), ST_AsText(startValue(trip)),
+  ST_AsText(valueAtTimestamp(trip, '2001-01-01 00:10:00')),
+  round((twavg(speed(trip)) * 60)::numeric, 6)
+FROM tbl_tgeompoint_toast ORDER BY k;
+SET mobilitydb.detoast_cache_size = 1;
+SELECT k, length(trip), timespan(trip), ST_AsText(startValue(trip)),
+  ST_AsText(valueAtTimestamp(trip, '2001-01-01 00:10:00')),
+  round((twavg(speed(trip)) * 60)::numeric, 6)
+FROM tbl_tgeompoint_toast ORDER BY k;
+RESET mobilitydb.detoast_cache_size;
+
+-- Time restrictions returned as views of the values
+
+SELECT k, numInstants(atPeriod(trip, p)), length(atPeriod(trip, p)),
+  timespan(atPeriod(trip, p)), ST_AsText(startValue(atPeriod(trip, p))),
+  ST_AsText(endValue(atPeriod(trip, p))),
+  startTimestamp(atPeriod(trip, p)), endTimestamp(atPeriod(trip, p))
+FROM tbl_tgeompoint_toast,
+  (SELECT period '[2001-01-01 00:10:30, 2001-01-01 00:20:00)' AS p) t
+ORDER BY k;
+SELECT asText(atPeriod(trip, '[2001-01-01 00:10:30, 2001-01-01 00:12:00)'))
+FROM tbl_tgeompoint_toast WHERE k = 1;
+SELECT asText(appendInstant(atPeriod(trip,
+  '[2001-01-01 00:10:30, 2001-01-01 00:12:00)'),
+  tgeompoint 'Point(20 0)@2001-01-01 00:13:00'))
+FROM tbl_tgeompoint_toast WHERE k = 1;
+DROP TABLE tbl_tgeompoint_toast;
+
 -------------------------------------------------------------------------------
@@ -49,7 +49,12 @@ SELECT expandSpatial(stbox 'GEODSTBOX((1.0, 2.0, 3.0), (1.0, 2.0, 3.0))', 0.5);
 SELECT expandTemporal(stbox 'STBOX T((1.0, 2.0, 2000-01-03), (1.0, 2.0, 2000-01-03))', '1 day');
 SELECT expandTemporal(stbox 'STBOX ZT((1.0, 2.0, 3.0, 2000-01-04), (1.0, 2.0, 3.0, 2000-01-04))', '1 day');
 SELECT expandTemporal(stbox 'GEODSTBOX T((1.0, 2.0, 3.0, 2000-01-04), (1.0, 2.0, 3.0, 2000-01-04))', '1 day');
+
+SELECT splitSTBoxes(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-03, Point(4 4)@2000-01-04]', 2);
+SELECT array_length(splitSTBoxes(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-03, Point(4 4)@2000-01-04]', 10), 1);
+SELECT array_length(splitSTBoxes(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02], [Point(3 1)@2000-01-03, Point(4 4)@2000-01-04]}', 10), 1);
 /* Errors */
+SELECT splitSTBoxes(tgeompoint 'Point(1 1)@2000-01-01', 0);
 SELECT expandTemporal(stbox 'STBOX((1.0, 2.0), (1.0, 2.0))', '1 day');
 SELECT expandTemporal(stbox 'STBOX Z((1.0, 2.0, 3.0), (1.0, 2.0, 3.0))', '1 day');
 SELECT expandTemporal(stbox 'GEODSTBOX((1.0, 2.0, 3.0), (1.0, 2.0, 3.0))', '1 day');
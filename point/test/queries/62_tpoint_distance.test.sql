@@ -41,6 +41,10 @@ SELECT round(geography 'Point(1 1)' <-> tgeogpoint 'Point(2.5 2.5)@2000-01-01',
 SELECT round(geography 'Point(1 1)' <-> tgeogpoint '{Point(2.5 2.5)@2000-01-01, Point(1.5 1.5)@2000-01-02, Point(2.5 2.5)@2000-01-03}', 6);
 SELECT round(geography 'Point(1 1)' <-> tgeogpoint '[Point(2.5 2.5)@2000-01-01, Point(1.5 1.5)@2000-01-02, Point(2.5 2.5)@2000-01-03]', 6);
 SELECT round(geography 'Point(1 1)' <-> tgeogpoint '{[Point(2.5 2.5)@2000-01-01, Point(1.5 1.5)@2000-01-02, Point(2.5 2.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}', 6);
+-- Distance on a sphere
+SET mobilitydb.geodetic_distance = sphere;
+SELECT round(geography 'Point(1 1)' <-> tgeogpoint '{Point(2.5 2.5)@2000-01-01, Point(1.5 1.5)@2000-01-02}', 6);
+RESET mobilitydb.geodetic_distance;
 
 SELECT round(geography 'Point empty' <-> tgeogpoint 'Point(2.5 2.5)@2000-01-01', 6);
 SELECT round(geography 'Point empty' <-> tgeogpoint '{Point(2.5 2.5)@2000-01-01, Point(1.5 1.5)@2000-01-02, Point(2.5 2.5)@2000-01-03}', 6);
@@ -165,5 +169,18 @@ SELECT round(tgeogpoint '{Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5)@2000
 SELECT round(tgeogpoint '[Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5)@2000-01-02, Point(1.5 1.5 1.5)@2000-01-03]' <-> tgeogpoint '{[Point(2.5 2.5 2.5)@2000-01-01, Point(1.5 1.5 1.5)@2000-01-02, Point(2.5 2.5 2.5)@2000-01-03],[Point(3.5 3.5 3.5)@2000-01-04, Point(3.5 3.5 3.5)@2000-01-05]}', 6);
 SELECT round(tgeogpoint '{[Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5)@2000-01-02, Point(1.5 1.5 1.5)@2000-01-03],[Point(3.5 3.5 3.5)@2000-01-04, Point(3.5 3.5 3.5)@2000-01-05]}' <-> tgeogpoint '{[Point(2.5 2.5 2.5)@2000-01-01, Point(1.5 1.5 1.5)@2000-01-02, Point(2.5 2.5 2.5)@2000-01-03],[Point(3.5 3.5 3.5)@2000-01-04, Point(3.5 3.5 3.5)@2000-01-05]}', 6);
 
+SELECT round(frechetDistance(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02, Point(2 0)@2000-01-03]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03]')::numeric, 6);
+SELECT round(dynamicTimeWarp(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02, Point(2 0)@2000-01-03]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03]')::numeric, 6);
+SELECT round(frechetDistance(tgeompoint 'Point(0 0 0)@2000-01-01', tgeompoint '{Point(1 2 2)@2000-01-01, Point(0 0 3)@2000-01-02}')::numeric, 6);
+SELECT round(dynamicTimeWarp(tgeompoint 'Point(0 0 0)@2000-01-01', tgeompoint '{Point(1 2 2)@2000-01-01, Point(0 0 3)@2000-01-02}')::numeric, 6);
+SELECT frechetDWithin(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02, Point(2 0)@2000-01-03]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03]', 1.5);
+SELECT frechetDWithin(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02, Point(2 0)@2000-01-03]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03]', 1);
+SELECT frechetDWithin(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02]', tgeompoint '[Point(10 10)@2000-01-01, Point(11 10)@2000-01-02]', 5);
+SELECT dynamicTimeWarpDWithin(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02, Point(2 0)@2000-01-03]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03]', 3.5);
+SELECT dynamicTimeWarpDWithin(tgeompoint '[Point(0 0)@2000-01-01, Point(1 0)@2000-01-02, Point(2 0)@2000-01-03]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03]', 3);
+
+/* Errors */
+SELECT frechetDistance(tgeompoint 'SRID=5676;Point(1 1)@2000-01-01', tgeompoint 'Point(1 1)@2000-01-01');
+
 -------------------------------------------------------------------------------
 
@@ -9,6 +9,42 @@ SELECT asText(tcentroid(temp)) FROM (VALUES
   (tgeompoint '[Point(3 3 3)@2000-01-03, Point(4 4 4)@2000-01-04)'),
   (tgeompoint '[Point(2 2 2)@2000-01-02, Point(3 3 3)@2000-01-03)')) t(temp);
 
+SELECT asText(tcentroid(temp)) FROM (VALUES (tgeompoint '[Point(1 1)@2000-01-01, Point(3 3)@2000-01-03]'), (tgeompoint '[Point(5 5)@2000-01-02, Point(5 5)@2000-01-04]')) t(temp);
+SELECT asText(tcentroid(temp)) FROM (VALUES (tgeompoint '{Point(1 1)@2000-01-01, Point(3 3)@2000-01-02}'), (tgeompoint 'Point(3 5)@2000-01-01')) t(temp);
+
+CREATE TABLE tbl_tgeompoint_estimated(temp tgeompoint);
+INSERT INTO tbl_tgeompoint_estimated SELECT format('[Point(%s %s)@2000-01-%s, Point(%s %s)@2000-01-%s]', k, k, k, k + 1, k + 1, k + 1)::tgeompoint FROM generate_series(1, 10) k;
+SELECT estimatedSTBox('tbl_tgeompoint_estimated', 'temp');
+ANALYZE tbl_tgeompoint_estimated;
+SELECT period(b), Xmin(b) <= 1 AND Ymin(b) <= 1 AND Xmax(b) >= 11 AND Ymax(b) >= 11 FROM (SELECT estimatedSTBox('tbl_tgeompoint_estimated', 'temp') b) t;
+SELECT estimatedNumInstants('tbl_tgeompoint_estimated', 'temp');
+DROP TABLE tbl_tgeompoint_estimated;
+CREATE TABLE tbl_tgeompoint_estimated_ext(temp tgeompoint);
+ALTER TABLE tbl_tgeompoint_estimated_ext ALTER COLUMN temp SET STORAGE EXTERNAL;
+INSERT INTO tbl_tgeompoint_estimated_ext SELECT tgeompointseq(array_agg(tgeompointinst(ST_MakePoint(k + i % 2, k + i % 2), timestamptz '2000-01-01' + k * interval '1 day' + i * interval '1 minute') ORDER BY i)) FROM generate_series(1, 3) k, generate_series(1, 2000) i GROUP BY k;
+ANALYZE tbl_tgeompoint_estimated_ext;
+SELECT period(b), Xmin(b) <= 1 AND Ymin(b) <= 1 AND Xmax(b) >= 4 AND Ymax(b) >= 4 FROM (SELECT estimatedSTBox('tbl_tgeompoint_estimated_ext', 'temp') b) t;
+SELECT estimatedNumInstants('tbl_tgeompoint_estimated_ext', 'temp');
+DROP TABLE tbl_tgeompoint_estimated_ext;
+
+SELECT asText(tgeompointseqset_agg(geom, t, interval '1 hour', 10 ORDER BY t)) FROM (VALUES 
+  (geometry 'Point(2 5)', timestamptz '2000-01-01 03:00'),
+  (geometry 'Point(0 0)', timestamptz '2000-01-01 00:00'),
+  (geometry 'Point(50 5)', timestamptz '2000-01-01 04:00'),
+  (geometry 'Point(1 1)', timestamptz '2000-01-01 00:10'),
+  (geometry 'Point(3 5)', timestamptz '2000-01-01 03:30'),
+  (geometry 'Point(2 0)', timestamptz '2000-01-01 00:20')) t(geom, t);
+SELECT asText(tgeompointseqset_agg(geom, t, interval '1 hour', NULL ORDER BY t)) FROM (VALUES 
+  (geometry 'Point(2 5)', timestamptz '2000-01-01 03:00'),
+  (geometry 'Point(0 0)', timestamptz '2000-01-01 00:00'),
+  (geometry 'Point(50 5)', timestamptz '2000-01-01 04:00'),
+  (geometry 'Point(1 1)', timestamptz '2000-01-01 00:10'),
+  (geometry 'Point(3 5)', timestamptz '2000-01-01 03:30'),
+  (geometry 'Point(2 0)', timestamptz '2000-01-01 00:20')) t(geom, t);
+SELECT asText(tgeompointseqset_agg(geom, t, NULL, NULL ORDER BY t)) FROM (VALUES 
+  (geometry 'Point(1 1 1)', timestamptz '2000-01-02'),
+  (geometry 'Point(0 0 0)', timestamptz '2000-01-01')) t(geom, t);
+
 /* Errors */
 SELECT asText(tcentroid(temp)) FROM (VALUES 
   (tgeompoint 'Point(0 0)@2000-01-01'),
@@ -23,4 +59,13 @@ SELECT asText(tcentroid(temp)) FROM (VALUES
   (tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02}'),
   ('Point(2 2 2)@2000-01-01')) t(temp);
 
+SELECT asText(tgeompointseqset_agg(geom, t, NULL, NULL)) FROM (VALUES 
+  (geometry 'Point(1 1)', timestamptz '2000-01-02'),
+  (geometry 'Point(0 0)', timestamptz '2000-01-01')) t(geom, t);
+SELECT asText(tgeompointseqset_agg(geom, t, NULL, NULL ORDER BY t)) FROM (VALUES 
+  (geometry 'Point(0 0)', timestamptz '2000-01-01'),
+  (geometry 'Point(1 1 1)', timestamptz '2000-01-02')) t(geom, t);
+SELECT asText(tgeompointseqset_agg(geom, t, NULL, -1 ORDER BY t)) FROM (VALUES 
+  (geometry 'Point(0 0)', timestamptz '2000-01-01')) t(geom, t);
+
 -------------------------------------------------------------------------------
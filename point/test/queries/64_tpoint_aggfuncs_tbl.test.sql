@@ -51,6 +51,20 @@ SELECT numSequences(tcount(ts)) FROM tbl_tgeompoints;
 SELECT k%10, numSequences(tcentroid(ts)) FROM tbl_tgeompoints GROUP BY k%10 ORDER BY k%10;
 SELECT k%10, numSequences(tcount(ts)) FROM tbl_tgeompoints GROUP BY k%10 ORDER BY k%10;
 
+CREATE TEMPORARY TABLE tbl_tcentroid_serial AS SELECT tcentroid(seq) AS temp FROM tbl_tgeompointseq;
+SET parallel_setup_cost = 0;
+SET parallel_tuple_cost = 0;
+SET min_parallel_table_scan_size = 0;
+SET max_parallel_workers_per_gather = 2;
+CREATE TEMPORARY TABLE tbl_tcentroid_parallel AS SELECT tcentroid(seq) AS temp FROM tbl_tgeompointseq;
+RESET parallel_setup_cost;
+RESET parallel_tuple_cost;
+RESET min_parallel_table_scan_size;
+RESET max_parallel_workers_per_gather;
+SELECT numSequences(s.temp) = numSequences(p.temp) AS sequences, numInstants(s.temp) = numInstants(p.temp) AS instants, getTime(s.temp) = getTime(p.temp) AS time, maxValue(distance(s.temp, p.temp)) < 1e-9 AS dist FROM tbl_tcentroid_serial s, tbl_tcentroid_parallel p;
+DROP TABLE tbl_tcentroid_serial;
+DROP TABLE tbl_tcentroid_parallel;
+
 SELECT numInstants(tcentroid(inst)) FROM tbl_tgeompoint3Dinst;
 SELECT numInstants(tcount(inst)) FROM tbl_tgeompoint3Dinst;
 SELECT k%10, numInstants(tcentroid(inst)) FROM tbl_tgeompoint3Dinst GROUP BY k%10 ORDER BY k%10;
@@ -1059,6 +1059,12 @@ SELECT tdwithin(tgeompoint 'Point(1 1 1)@2000-01-01', tgeompoint '{[Point(1 1 1)
 SELECT tdwithin(tgeompoint '{Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03}', tgeompoint '{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}', 2);
 SELECT tdwithin(tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03]', tgeompoint '{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}', 2);
 SELECT tdwithin(tgeompoint '{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}', tgeompoint '{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03],[Point(3 3 3)@2000-01-04, Point(3 3 3)@2000-01-05]}', 2);
+-- Temporal points whose bounding boxes or segments are farther apart than the distance
+SELECT tdwithin(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', tgeompoint '[Point(10 10)@2000-01-02, Point(20 20)@2000-01-04]', 2);
+SELECT tdwithin(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02],[Point(1 1)@2000-01-03, Point(1 1)@2000-01-04]}', tgeompoint '{[Point(10 10)@2000-01-01, Point(20 20)@2000-01-05]}', 2);
+SELECT tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(0 1)@2000-01-02, Point(10 1)@2000-01-03]', tgeompoint '[Point(10 0)@2000-01-01, Point(10 1)@2000-01-02, Point(20 1)@2000-01-03]', 2);
+SELECT tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', tgeompoint '{[Point(0 1)@2000-01-01, Point(1 1)@2000-01-02],[Point(2 5)@2000-01-03, Point(3 5)@2000-01-04]}', 2);
+SELECT tdwithin(tgeompoint '{[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05],[Point(5 0)@2000-01-06, Point(6 0)@2000-01-07]}', tgeompoint '{[Point(0 1)@2000-01-01, Point(1 1)@2000-01-02],[Point(2 5)@2000-01-03, Point(3 5)@2000-01-04],[Point(5 1)@2000-01-06, Point(6 1)@2000-01-07]}', 2);
 
 SELECT tdwithin(tgeogpoint 'Point(1.5 1.5)@2000-01-01', tgeogpoint 'Point(1.5 1.5)@2000-01-01', 2);
 SELECT tdwithin(tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03}', tgeogpoint 'Point(1.5 1.5)@2000-01-01', 2);
@@ -1297,4 +1303,7 @@ SELECT trelate(geometry 'Point(1 1 1)', tgeompoint 'Point(1 1)@2000-01-01', 'T**
 SELECT trelate(tgeompoint 'Point(1 1 1)@2000-01-01', geometry 'Point(1 1)', 'T*****FF*');
 SELECT trelate(tgeompoint 'Point(1 1 1)@2000-01-01', tgeompoint 'Point(1 1)@2000-01-01', 'T*****FF*');
 
+SELECT i, j, getTime(atValue(tdwithin, true)) FROM tdwithinJoin(ARRAY[tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]', '[Point(10 10)@2000-01-01, Point(11 10)@2000-01-02]'], ARRAY[tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03]', '[Point(0 0)@2000-01-05, Point(1 1)@2000-01-06]', '[Point(10.5 10)@2000-01-01, Point(10.5 10)@2000-01-02]'], 1) ORDER BY i, j;
+SELECT count(*) FROM tdwithinJoin(ARRAY[tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]'], ARRAY[tgeompoint '[Point(0 3)@2000-01-01, Point(2 3)@2000-01-03]', '[Point(0 0)@2000-01-04, Point(2 0)@2000-01-05]'], 1);
+
 -------------------------------------------------------------------------------
@@ -19,6 +19,50 @@ SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp @> geometry 'Linestring(1 1
 SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <@ geometry 'Linestring(1 1 1,10 10 10)';
 SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp ~= geometry 'Linestring(1 1 1,10 10 10)';
 
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp << geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp &< geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp >> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp &> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <<| geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp &<| geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp |>> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp |&> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <</ geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp &</ geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp />> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp /&> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp |&> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <<# period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp &<# period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp #>> period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp #&> period '[2001-01-01, 2001-02-01]';
+SELECT (SELECT array_agg(d) FROM (SELECT temp |=| geometry 'Point(50 50 50)' AS d FROM tbl_tgeompoint3D_big ORDER BY temp |=| geometry 'Point(50 50 50)' LIMIT 5) t1) = (SELECT array_agg(d) FROM (SELECT temp |=| geometry 'Point(50 50 50)' AS d FROM tbl_tgeompoint3D_big ORDER BY (temp |=| geometry 'Point(50 50 50)') + 0 LIMIT 5) t2);
+
+SELECT count(*) FROM tbl_tgeogpoint3D_big WHERE temp && geography 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeogpoint3D_big WHERE temp @> geography 'Linestring(1 1,10 10)';
+SELECT count(*) FROM tbl_tgeogpoint3D_big WHERE temp <@ geography 'Linestring(1 1,10 10)';
+SELECT count(*) FROM tbl_tgeogpoint3D_big WHERE temp ~= geography 'Linestring(1 1,10 10)';
+SELECT count(*) FROM tbl_tgeogpoint3D_big WHERE temp <<# period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tgeogpoint3D_big WHERE temp &<# period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tgeogpoint3D_big WHERE temp #>> period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tgeogpoint3D_big WHERE temp #&> period '[2001-01-01, 2001-02-01]';
+
+SELECT (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tgeompoint3D_big ORDER BY temp <-> timestamptz '2001-06-01' LIMIT 5) t1) = (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tgeompoint3D_big ORDER BY (temp <-> timestamptz '2001-06-01') + 0 LIMIT 5) t2);
+SELECT (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tgeogpoint3D_big ORDER BY temp <-> timestamptz '2001-06-01' LIMIT 5) t1) = (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tgeogpoint3D_big ORDER BY (temp <-> timestamptz '2001-06-01') + 0 LIMIT 5) t2);
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_gist_idx;
+DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_gist_idx;
+
+-------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tgeompoint3D_big_gist_idx ON tbl_tgeompoint3D_big USING GIST(temp gist_tgeompoint_compact_ops);
+CREATE INDEX tbl_tgeogpoint3D_big_gist_idx ON tbl_tgeogpoint3D_big USING GIST(temp gist_tgeogpoint_compact_ops);
+
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp && geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp @> geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <@ geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp ~= geometry 'Linestring(1 1 1,10 10 10)';
+
 SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp << geometry 'Linestring(1 1 1,10 10 10)';
 SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp &< geometry 'Linestring(1 1 1,10 10 10)';
 SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp >> geometry 'Linestring(1 1 1,10 10 10)';
@@ -51,6 +95,30 @@ DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_gist_idx;
 
 -------------------------------------------------------------------------------
 
+CREATE INDEX tbl_tgeompoint3D_big_gin_idx ON tbl_tgeompoint3D_big USING GIN(temp gin_tgeompoint_ops);
+
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp && geometry 'Linestring(1 1 1,10 10 10)';
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <@ geometry 'Linestring(1 1 1,10 10 10)';
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_gin_idx;
+
+-------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tgeompoint3D_big_brin_idx ON tbl_tgeompoint3D_big USING BRIN(temp);
+CREATE INDEX tbl_tgeogpoint3D_big_brin_idx ON tbl_tgeogpoint3D_big USING BRIN(temp);
+
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp && geometry 'Linestring(1 1 1,10 10 10)'::stbox;
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp @> geometry 'Linestring(1 1 1,10 10 10)'::stbox;
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp <@ geometry 'Linestring(1 1 1,10 10 10)'::stbox;
+SELECT count(*) FROM tbl_tgeompoint3D_big WHERE temp ~= geometry 'Linestring(1 1 1,10 10 10)'::stbox;
+
+SELECT count(*) FROM tbl_tgeogpoint3D_big WHERE temp && geography 'Linestring(1 1 1,10 10 10)'::stbox;
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_brin_idx;
+DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_brin_idx;
+
+-------------------------------------------------------------------------------
+
 CREATE INDEX tbl_tgeompoint3D_big_spgist_idx ON tbl_tgeompoint3D_big USING SPGIST(temp);
 CREATE INDEX tbl_tgeogpoint3D_big_spgist_idx ON tbl_tgeogpoint3D_big USING SPGIST(temp);
 
@@ -90,3 +158,29 @@ DROP INDEX IF EXISTS tbl_tgeompoint3D_big_spgist_idx;
 DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_spgist_idx;
 
 -------------------------------------------------------------------------------
+
+CREATE TABLE tbl_tgeompoint2D_grid AS SELECT k, tgeompointinst(ST_Point(k % 100, k / 100), timestamptz '2001-01-01' + k * interval '1 hour') AS temp FROM generate_series(1, 10000) k;
+CREATE INDEX tbl_tgeompoint2D_grid_spgist_idx ON tbl_tgeompoint2D_grid USING SPGIST(temp);
+
+SELECT count(*) FROM tbl_tgeompoint2D_grid WHERE temp && geometry 'Polygon((10 10,10 20,20 20,20 10,10 10))';
+SELECT count(*) FROM tbl_tgeompoint2D_grid WHERE temp <@ geometry 'Polygon((10 10,10 20,20 20,20 10,10 10))';
+SELECT count(*) FROM tbl_tgeompoint2D_grid WHERE temp << geometry 'Point(5 5)';
+SELECT count(*) FROM tbl_tgeompoint2D_grid WHERE temp && period '[2001-01-01, 2001-01-02]';
+
+DROP TABLE tbl_tgeompoint2D_grid;
+
+-------------------------------------------------------------------------------
+
+SET mobilitydb.gist_time_weight = 0.001;
+CREATE TABLE tbl_tgeompoint2D_grid AS SELECT k, tgeompointinst(ST_Point(k % 100, k / 100), timestamptz '2001-01-01' + k * interval '1 hour') AS temp FROM generate_series(1, 10000) k;
+CREATE INDEX tbl_tgeompoint2D_grid_gist_idx ON tbl_tgeompoint2D_grid USING GIST(temp);
+
+SELECT count(*) FROM tbl_tgeompoint2D_grid WHERE temp && geometry 'Polygon((10 10,10 20,20 20,20 10,10 10))';
+SELECT count(*) FROM tbl_tgeompoint2D_grid WHERE temp <@ geometry 'Polygon((10 10,10 20,20 20,20 10,10 10))';
+SELECT count(*) FROM tbl_tgeompoint2D_grid WHERE temp << geometry 'Point(5 5)';
+SELECT count(*) FROM tbl_tgeompoint2D_grid WHERE temp && period '[2001-01-01, 2001-01-02]';
+
+DROP TABLE tbl_tgeompoint2D_grid;
+RESET mobilitydb.gist_time_weight;
+
+-------------------------------------------------------------------------------
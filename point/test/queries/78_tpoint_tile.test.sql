@@ -0,0 +1,37 @@
+-------------------------------------------------------------------------------
+
+SELECT count(*) FROM spaceTimeSplit(tgeompoint '[Point(0.5 0.5)@2000-01-01, Point(2.5 0.5)@2000-01-03]', 1, '1 day');
+SELECT asText(fragment) FROM spaceTimeSplit(tgeompoint '[Point(0.5 0.5)@2000-01-01, Point(2.5 0.5)@2000-01-03]', 1, '1 day') WHERE cellx = 1 AND bucket = '2000-01-02';
+SELECT asText(fragment) FROM spaceTimeSplit(tgeompoint '[Point(0.5 0.5)@2000-01-01, Point(2.5 0.5)@2000-01-03]', 1, '1 day') WHERE cellx = 2;
+SELECT count(*) FROM spaceTimeSplit(tgeompoint '[Point(0.5 0.5)@2000-01-01, Point(1.5 0.5)@2000-01-02, Point(0.5 0.5)@2000-01-03]', 1, '1 week');
+SELECT asText(fragment) FROM spaceTimeSplit(tgeompoint '[Point(0.5 0.5)@2000-01-01, Point(1.5 0.5)@2000-01-02, Point(0.5 0.5)@2000-01-03]', 1, '1 week') WHERE cellx = 0;
+SELECT asText(fragment) FROM spaceTimeSplit(tgeompoint '[Point(0.5 0.5)@2000-01-01, Point(1.5 0.5)@2000-01-02, Point(0.5 0.5)@2000-01-03]', 1, '1 week') WHERE cellx = 1;
+SELECT asText(fragment) FROM spaceTimeSplit(tgeompoint '[Point(0.5 0.5)@2000-01-01, Point(1.5 0.5)@2000-01-02, Point(0.5 0.5)@2000-01-03]', 1, '1 week', geometry 'Point(0.5 0)') WHERE cellx = 0;
+SELECT asText(fragment) FROM spaceTimeSplit(tgeompoint '{Point(0.5 0.5)@2000-01-01, Point(1.5 1.5)@2000-01-02, Point(0.5 0.5)@2000-01-03}', 1, '1 week') WHERE cellx = 0;
+SELECT asText(fragment) FROM spaceTimeSplit(tgeompoint 'Interp=Stepwise;[Point(0.5 0.5)@2000-01-01, Point(1.5 0.5)@2000-01-02]', 1, '1 week') WHERE cellx = 1;
+
+SELECT asText(fragment) FROM timeSplit(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]', '1 day') WHERE bucket = '2000-01-01';
+SELECT asText(tsample(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]', '1 day'));
+
+SELECT st_astext(geom), times FROM asMVTGeom(tgeompoint '[Point(0 0)@2000-01-01, Point(10 10)@2000-01-02]', stbox 'STBOX((0, 0), (10, 10))', 10, 0);
+SELECT st_astext(geom), times FROM asMVTGeom(tgeompoint '[Point(-10 5)@2000-01-01, Point(10 5)@2000-01-03]', stbox 'STBOX((0, 0), (10, 10))', 10, 0);
+SELECT st_astext(geom), times FROM asMVTGeom(tgeompoint '[Point(-10 5)@2000-01-01, Point(10 5)@2000-01-03]', stbox 'STBOX((0, 0), (10, 10))', 10, 0, false);
+SELECT st_astext(geom), times FROM asMVTGeom(tgeompoint '{Point(1 1)@2000-01-01, Point(20 20)@2000-01-02}', stbox 'STBOX((0, 0), (10, 10))', 10, 0);
+SELECT st_astext(geom), times FROM asMVTGeom(tgeompoint '[Point(1 1)@2000-01-01, Point(9 9)@2000-01-03]', stbox 'STBOX T((0, 0, 2000-01-01), (10, 10, 2000-01-02))', 10, 0);
+SELECT st_astext(geom), times FROM asMVTGeom(tgeompoint '[Point(1 1)@2000-01-01]', stbox 'STBOX((0, 0), (10, 10))', 10, 0);
+SELECT st_astext(geom), times FROM asMVTGeom(tgeompoint '{[Point(1 1)@2000-01-01, Point(5 1)@2000-01-02], [Point(8 8)@2000-01-03]}', stbox 'STBOX((0, 0), (10, 10))', 10, 0);
+SELECT geom IS NULL FROM asMVTGeom(tgeompoint 'Point(20 20)@2000-01-01', stbox 'STBOX((0, 0), (10, 10))', 10, 0);
+
+SELECT tileKeys(tgeompoint 'Point(0.5 1.5)@2000-01-02', 1, '1 day');
+SELECT cardinality(tileKeys(tgeompoint '[Point(0.5 0.5)@2000-01-01, Point(2.5 0.5)@2000-01-03]', 1, '1 day'));
+SELECT tileKeys(tgeompoint '[Point(0.5 0.5)@2000-01-01, Point(2.5 0.5)@2000-01-03]', 1, '1 day') && tileKeys(stbox 'STBOX T((1, 0, 2000-01-02), (1.5, 0.5, 2000-01-02))', 1, '1 day');
+SELECT tileKeys(tgeompoint '[Point(0.5 0.5)@2000-01-01, Point(2.5 0.5)@2000-01-03]', 1, '1 day') && tileKeys(stbox 'STBOX T((0, 0, 2000-01-02), (0.9, 0.9, 2000-01-03))', 1, '1 day');
+SELECT cardinality(tileKeys(stbox 'STBOX T((0, 0, 2000-01-01), (2, 1, 2000-01-02))', 1, '1 day'));
+
+/* Errors */
+SELECT asMVTGeom(tgeompoint 'Point(1 1)@2000-01-01', stbox 'STBOX((0, 0), (10, 10))', 0);
+SELECT tileKeys(tgeompoint 'Point(1 1)@2000-01-01', 0, '1 day');
+SELECT tileKeys(stbox 'STBOX((0, 0), (1, 1))', 1, '1 day');
+SELECT tileKeys(stbox 'STBOX T((0, 0, 2000-01-01), (1000000, 1000000, 2000-01-02))', 0.001, '1 day');
+
+-------------------------------------------------------------------------------
@@ -0,0 +1,11 @@
+-------------------------------------------------------------------------------
+
+SELECT tintersectsAppend(NULL, tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-04]', geometry 'Linestring(1 0,1 1,2 1,2 0)');
+SELECT tintersectsAppend(tintersects(tgeompoint '[Point(0 1)@2000-01-01, Point(1 1)@2000-01-02 12:00]', geometry 'Linestring(1 0,1 1,2 1,2 0)'), tgeompoint '[Point(0 1)@2000-01-01, Point(1 1)@2000-01-02 12:00, Point(2 1)@2000-01-04]', geometry 'Linestring(1 0,1 1,2 1,2 0)');
+SELECT tintersectsAppend(tbool '{[f@2000-01-01, f@2000-01-05]}', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-04]', geometry 'Point(1 1)');
+SELECT tintersectsAppend(NULL, NULL, geometry 'Point(1 1)') IS NULL;
+
+SELECT tdwithinAppend(tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03]', 1.5), tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03, Point(4 0)@2000-01-05]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03, Point(2 3)@2000-01-05]', 1.5) = tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03, Point(4 0)@2000-01-05]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03, Point(2 3)@2000-01-05]', 1.5);
+SELECT tdwithinAppend(tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]', geometry 'Point(4 1)', 1.5), tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03, Point(4 0)@2000-01-05]', geometry 'Point(4 1)', 1.5) = tdwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03, Point(4 0)@2000-01-05]', geometry 'Point(4 1)', 1.5);
+SELECT distanceAppend(distance(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03]'), tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03, Point(4 0)@2000-01-05]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03, Point(2 3)@2000-01-05]') = distance(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03, Point(4 0)@2000-01-05]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03, Point(2 3)@2000-01-05]');
+SELECT distanceAppend(NULL, tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03, Point(4 0)@2000-01-05]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03, Point(2 3)@2000-01-05]') = distance(tgeompoint '[Point(0 0)@2000-01-01, Point(2 0)@2000-01-03, Point(4 0)@2000-01-05]', tgeompoint '[Point(0 1)@2000-01-01, Point(2 1)@2000-01-03, Point(2 3)@2000-01-05]');
@@ -0,0 +1,17 @@
+-------------------------------------------------------------------------------
+
+COPY (VALUES ('b', timestamptz '2000-01-01 00:00', 1, 1), ('a', '2000-01-01 00:00', 0, 0),
+  ('a', '2000-01-01 00:20', 2, 0), ('b', '2000-01-01 00:10', 2, 3), ('a', '2000-01-01 00:10', 1, 1))
+  TO '/tmp/tgeompoint_load.csv' (FORMAT CSV, HEADER);
+COPY (VALUES ('a', timestamptz '2000-01-01 00:00', 0, 0, 0), ('a', '2000-01-01 00:10', 1, 1, 1))
+  TO '/tmp/tgeompoint_load_z.csv' (FORMAT CSV, HEADER);
+COPY (VALUES ('a,2000-01-01 00:00:00+00,0,0'), ('a,2000-01-01 00:10:00+00,1,1,1'))
+  TO '/tmp/tgeompoint_load_err.csv';
+
+SELECT id, asText(trip) FROM loadTGeomPoint('/tmp/tgeompoint_load.csv');
+SELECT id, asEWKT(trip) FROM loadTGeomPoint('/tmp/tgeompoint_load_z.csv', 5676);
+
+/* Errors */
+SELECT id, asText(trip) FROM loadTGeomPoint('/tmp/tgeompoint_load_err.csv', 0, false);
+
+-------------------------------------------------------------------------------
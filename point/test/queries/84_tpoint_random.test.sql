@@ -0,0 +1,20 @@
+-------------------------------------------------------------------------------
+
+SELECT numInstants(random_tgeompoint_seq('STBOX T((0, 0, 2001-01-01), (100, 100, 2001-01-02))', 1000));
+SELECT random_tgeompoint_seq('STBOX T((0, 0, 2001-01-01), (100, 100, 2001-01-02))', 100, '1 minute', 'road', 1) =
+  random_tgeompoint_seq('STBOX T((0, 0, 2001-01-01), (100, 100, 2001-01-02))', 100, '1 minute', 'road', 1);
+SELECT random_tgeompoint_seq('STBOX T((0, 0, 2001-01-01), (100, 100, 2001-01-02))', 100, '1 minute', 'road', 1) =
+  random_tgeompoint_seq('STBOX T((0, 0, 2001-01-01), (100, 100, 2001-01-02))', 100, '1 minute', 'road', 2);
+SELECT d, stbox 'STBOX T((0, 0, 2001-01-01), (100, 100, 2001-01-02))' @> temp FROM (
+  SELECT d, random_tgeompoint_seq('STBOX T((0, 0, 2001-01-01), (100, 100, 2001-01-02))', 1000, '1 minute', d, 7) AS temp
+  FROM unnest(ARRAY['uniform', 'walk', 'clustered', 'road']) d) t;
+SELECT d, stbox 'STBOX ZT((0, 0, 0, 2001-01-01), (100, 100, 10, 2001-01-02))' @> temp, SRID(temp) FROM (
+  SELECT d, random_tgeompoint_seq('STBOX ZT((0, 0, 0, 2001-01-01), (100, 100, 10, 2001-01-02))', 100, '1 minute', d, 7, 5676) AS temp
+  FROM unnest(ARRAY['uniform', 'road']) d) t;
+
+/* Errors */
+SELECT random_tgeompoint_seq(stbox 'STBOX((0, 0), (100, 100))', 10);
+SELECT random_tgeompoint_seq(stbox 'GEODSTBOX T((0, 0, 0, 2001-01-01), (1, 1, 1, 2001-01-02))', 10);
+SELECT random_tgeompoint_seq(stbox 'STBOX T((0, 0, 2001-01-01), (100, 0, 2001-01-02))', 10, '1 minute', 'road');
+
+-------------------------------------------------------------------------------
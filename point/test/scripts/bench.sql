@@ -0,0 +1,56 @@
+/*****************************************************************************
+ *
+ * bench.sql
+ *	  Micro-benchmarks of the core temporal point kernels
+ *
+ * This file is run by bench.sh after the benchmarks of the temporal types,
+ * whose generators of synthetic sequences and function bench_run it uses.
+ *
+ *****************************************************************************/
+
+SET client_min_messages TO WARNING;
+SELECT setseed(0.5);
+
+-------------------------------------------------------------------------------
+
+CREATE OR REPLACE FUNCTION bench_tgeompointseq(size int, shift interval)
+	RETURNS tgeompoint AS $$
+	SELECT tgeompointseq(bench_walk(size), bench_walk(size),
+		bench_timestamps(size, shift));
+$$ LANGUAGE SQL STRICT;
+
+-------------------------------------------------------------------------------
+
+CREATE OR REPLACE FUNCTION bench_tpoint(sizes int[])
+	RETURNS TABLE(kernel text, size int, instants bigint, ms float,
+		ns_per_instant float) AS $$
+DECLARE
+	card int;
+	seq1 tgeompoint;
+	seq2 tgeompoint;
+	txt text;
+BEGIN
+	foreach card in array sizes
+	loop
+		seq1 = bench_tgeompointseq(card, interval '0 seconds');
+		seq2 = bench_tgeompointseq(card, interval '30 seconds');
+		txt = asText(seq1);
+
+		/* tdwithin_tpointseq_tpointseq, instants of both arguments */
+		RETURN QUERY SELECT * FROM bench_run('tdwithin_tpointseq_tpointseq',
+			card, 2 * card, format(
+			'SELECT count(tdwithin(s.seq1, s.seq2, 0.5)) '
+			'FROM (SELECT %L::tgeompoint AS seq1, %L::tgeompoint AS seq2 '
+			'OFFSET 0) AS s', seq1, seq2));
+
+		/* tgeompoint_in */
+		RETURN QUERY SELECT * FROM bench_run('tgeompoint_in', card, card, format(
+			'SELECT count(s.txt::tgeompoint) '
+			'FROM (SELECT %L::text AS txt OFFSET 0) AS s', txt));
+	end loop;
+END;
+$$ LANGUAGE plpgsql STRICT;
+
+SELECT * FROM bench_tpoint(:'sizes');
+
+-------------------------------------------------------------------------------
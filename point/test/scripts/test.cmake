@@ -19,3 +19,4 @@ foreach(file ${geom_testfiles})
 	set_tests_properties(${TESTNAME} PROPERTIES RESOURCE_LOCK DBLOCK)
 endforeach()
 
+list(APPEND BENCHFILES "${PROJECT_SOURCE_DIR}/point/test/scripts/bench.sql")
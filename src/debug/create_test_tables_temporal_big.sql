@@ -428,7 +428,7 @@ create table tbl_tbool_big(k, temp) as
 
 drop table if exists tbl_tint_big;
 create table tbl_tint_big(k, temp) as
-(select k, inst from tbl_tinttinst_big order by k limit size / 4) union all
+(select k, inst from tbl_tintinst_big order by k limit size / 4) union all
 (select k + size / 4, ti from tbl_tinti_big order by k limit size / 4) union all
 (select k + size / 2, seq from tbl_tintseq_big order by k limit size / 4) union all
 (select k + size / 4 * 3, ts from tbl_tints_big order by k limit size / 4);
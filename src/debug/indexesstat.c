@@ -1,8 +1,16 @@
 /*****************************************************************************
  *
- * spgiststat.c
- *		Function belonging to the initial implementation of SP-GiST taken from
+ * indexesstat.c
+ *		Functions reporting the structure of GiST and SP-GiST indexes
+ *
+ * The function spgiststat belongs to the initial implementation of SP-GiST
+ * taken from
  *		https://www.postgresql.org/message-id/29780.1324160816@sss.pgh.pa.us
+ * The function mobdb_index_stats reports for each level of a GiST or an
+ * SP-GiST index the number of pages and tuples, the average volume of the
+ * keys, and the ratio of pairs of sibling keys that overlap. It can be used
+ * to assess the quality of the split of an index and to decide whether it
+ * is worth rebuilding the index.
  *
  * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse, 
  * 		Universite Libre de Bruxelles
@@ -12,13 +20,26 @@
  *****************************************************************************/
 
 #include <postgres.h>
+#include <access/gist.h>
 #include <access/hash.h>
 #include <access/heapam.h>
+#include <access/spgist_private.h>
 #include <catalog/namespace.h>
+#include <funcapi.h>
+#include <miscadmin.h>
 #include <utils/builtins.h>
 #include <utils/rel.h>
+#include <utils/tuplestore.h>
 #include <utils/varlena.h>
-// #include <access/spgist_private.h>
+
+#include "temporaltypes.h"
+#include "oidcache.h"
+#include "temporal_boxops.h"
+#include "period.h"
+#include "timeops.h"
+#ifdef WITH_POSTGIS
+#include "tpoint_boxops.h"
+#endif
 
 /* These definitions are taken from <catalog/pg_am.h> */
 #define GIST_AM_OID 783
@@ -27,49 +48,8 @@
 /* This definition is taken from <catalog/pg_class.h> */
 #define		  RELKIND_INDEX			  'i'	/* secondary index */
 
-/* These definition are taken from <access/spgist_private.h> */
-
-/*
- * Contents of page special space on SPGiST index pages
- */
-typedef struct SpGistPageOpaqueData
-{
-	uint16		flags;			/* see bit definitions below */
-	uint16		nRedirection;	/* number of redirection tuples on page */
-	uint16		nPlaceholder;	/* number of placeholder tuples on page */
-	/* note there's no count of either LIVE or DEAD tuples ... */
-	uint16		spgist_page_id; /* for identification of SP-GiST indexes */
-} SpGistPageOpaqueData;
-
-typedef SpGistPageOpaqueData *SpGistPageOpaque;
-
-typedef struct SpGistInnerTupleData
-{
-	unsigned int tupstate:2,	/* LIVE/REDIRECT/DEAD/PLACEHOLDER */
-				allTheSame:1,	/* all nodes in tuple are equivalent */
-				nNodes:13,		/* number of nodes within inner tuple */
-				prefixSize:16;	/* size of prefix, or 0 if none */
-	uint16		size;			/* total size of inner tuple */
-	/* On most machines there will be a couple of wasted bytes here */
-	/* prefix datum follows, then nodes */
-} SpGistInnerTupleData;
-
-typedef SpGistInnerTupleData *SpGistInnerTuple;
-
-/* Flag bits in page special space */
-#define SPGIST_META			(1<<0)
-#define SPGIST_DELETED		(1<<1)	/* never set, but keep for afterwards
-									 * compatibility */
-#define SPGIST_LEAF			(1<<2)
-#define SPGIST_NULLS		(1<<3)
-
-#define SpGistPageGetOpaque(page) ((SpGistPageOpaque) PageGetSpecialPointer(page))
-#define SpGistPageIsMeta(page) (SpGistPageGetOpaque(page)->flags & SPGIST_META)
-#define SpGistPageIsDeleted(page) (SpGistPageGetOpaque(page)->flags & SPGIST_DELETED)
-#define SpGistPageIsLeaf(page) (SpGistPageGetOpaque(page)->flags & SPGIST_LEAF)
-#define SpGistPageStoresNulls(page) (SpGistPageGetOpaque(page)->flags & SPGIST_NULLS)
-
-#define SPGIST_ROOT_BLKNO		 (1)	/* root for normal entries */
+/* This definition is taken from <access/gist_private.h> */
+#define GIST_ROOT_BLKNO		0
 
 #define IS_INDEX(r) ((r)->rd_rel->relkind == RELKIND_INDEX)
 #define IS_GIST(r) ((r)->rd_rel->relam == GIST_AM_OID)
@@ -202,4 +182,456 @@ spgiststat(PG_FUNCTION_ARGS)
 			 nLeafRedirect, nInnerRedirect);
 
 	PG_RETURN_TEXT_P(CStringGetTextDatum(res));
-}
\ No newline at end of file
+}
+/*****************************************************************************
+ * Statistics of the levels of GiST and SP-GiST indexes
+ *****************************************************************************/
+
+/* Types of the keys whose volume and overlap can be computed */
+typedef enum
+{
+	INDEXKEY_OTHER,
+	INDEXKEY_PERIOD,
+	INDEXKEY_TBOX,
+	INDEXKEY_STBOX
+} IndexKeyType;
+
+/* Statistics of a level of an index */
+typedef struct
+{
+	int64		pages;			/* number of pages */
+	int64		innerTuples;	/* number of inner tuples */
+	int64		leafTuples;		/* number of leaf tuples */
+	double		usedSpace;		/* used space of the pages, only for GiST */
+	double		volume;			/* sum of the volumes of the keys */
+	int64		nkeys;			/* number of keys with a volume */
+	int64		pairs;			/* number of pairs of sibling keys */
+	int64		overlaps;		/* number of pairs of sibling keys that overlap */
+} IndexLevelStats;
+
+/*
+ * Returns the type of keys of the index given the Oid of their type
+ */
+static IndexKeyType
+index_key_type(Oid typid)
+{
+	if (typid == type_oid(T_PERIOD))
+		return INDEXKEY_PERIOD;
+	if (typid == type_oid(T_TBOX))
+		return INDEXKEY_TBOX;
+#ifdef WITH_POSTGIS
+	if (typid == type_oid(T_STBOX))
+		return INDEXKEY_STBOX;
+#endif
+	return INDEXKEY_OTHER;
+}
+
+/*
+ * Returns the volume of a key, which is the product of the extent of its
+ * dimensions, where the time dimension is expressed in seconds
+ */
+static double
+index_key_volume(IndexKeyType keytype, Datum key)
+{
+	double result = 1.0;
+	if (keytype == INDEXKEY_PERIOD)
+	{
+		Period *p = DatumGetPeriod(key);
+		result = (double) (p->upper - p->lower) / USECS_PER_SEC;
+	}
+	else if (keytype == INDEXKEY_TBOX)
+	{
+		TBOX *box = DatumGetTboxP(key);
+		if (MOBDB_FLAGS_GET_X(box->flags))
+			result *= box->xmax - box->xmin;
+		if (MOBDB_FLAGS_GET_T(box->flags))
+			result *= (double) (box->tmax - box->tmin) / USECS_PER_SEC;
+	}
+#ifdef WITH_POSTGIS
+	else if (keytype == INDEXKEY_STBOX)
+	{
+		STBOX *box = DatumGetSTboxP(key);
+		if (MOBDB_FLAGS_GET_X(box->flags))
+			result *= (box->xmax - box->xmin) * (box->ymax - box->ymin);
+		if (MOBDB_FLAGS_GET_Z(box->flags))
+			result *= box->zmax - box->zmin;
+		if (MOBDB_FLAGS_GET_T(box->flags))
+			result *= (double) (box->tmax - box->tmin) / USECS_PER_SEC;
+	}
+#endif
+	return result;
+}
+
+/*
+ * Returns true if the two keys overlap
+ */
+static bool
+index_key_overlaps(IndexKeyType keytype, Datum key1, Datum key2)
+{
+	if (keytype == INDEXKEY_PERIOD)
+		return overlaps_period_period_internal(DatumGetPeriod(key1),
+			DatumGetPeriod(key2));
+	if (keytype == INDEXKEY_TBOX)
+		return overlaps_tbox_tbox_internal(DatumGetTboxP(key1),
+			DatumGetTboxP(key2));
+#ifdef WITH_POSTGIS
+	if (keytype == INDEXKEY_STBOX)
+		return overlaps_stbox_stbox_internal(DatumGetSTboxP(key1),
+			DatumGetSTboxP(key2));
+#endif
+	return false;
+}
+
+/*
+ * Add to the statistics of a level the volume of the keys and the overlap
+ * between each pair of them
+ */
+static void
+index_level_keys(IndexLevelStats *stats, IndexKeyType keytype, Datum *keys,
+	int nkeys)
+{
+	int i, j;
+	if (keytype == INDEXKEY_OTHER)
+		return;
+	if (keytype == INDEXKEY_PERIOD)
+	{
+		/* Copy the keys into an array to use the batched predicate */
+		Period *periods = palloc(sizeof(Period) * nkeys);
+		for (i = 0; i < nkeys; i++)
+			periods[i] = *DatumGetPeriod(keys[i]);
+		for (i = 0; i < nkeys; i++)
+		{
+			stats->volume += index_key_volume(keytype, keys[i]);
+			stats->overlaps += periodarr_overlaps_period(&periods[i + 1],
+				nkeys - i - 1, &periods[i], NULL);
+		}
+		pfree(periods);
+		stats->nkeys += nkeys;
+		stats->pairs += (int64) nkeys * (nkeys - 1) / 2;
+		return;
+	}
+	for (i = 0; i < nkeys; i++)
+	{
+		stats->volume += index_key_volume(keytype, keys[i]);
+		for (j = i + 1; j < nkeys; j++)
+		{
+			if (index_key_overlaps(keytype, keys[i], keys[j]))
+				stats->overlaps++;
+		}
+	}
+	stats->nkeys += nkeys;
+	stats->pairs += (int64) nkeys * (nkeys - 1) / 2;
+}
+
+/*
+ * Returns the statistics of the level, enlarging the array if needed
+ */
+static IndexLevelStats *
+index_level_stats(IndexLevelStats **levels, int *maxlevels, int level)
+{
+	if (level >= *maxlevels)
+	{
+		int newmax = *maxlevels * 2;
+		*levels = repalloc(*levels, sizeof(IndexLevelStats) * newmax);
+		memset(*levels + *maxlevels, 0,
+			sizeof(IndexLevelStats) * (newmax - *maxlevels));
+		*maxlevels = newmax;
+	}
+	return &(*levels)[level];
+}
+
+/*
+ * Collect the statistics of the levels of a GiST index, which are traversed
+ * in breadth-first order starting from the root page. Returns the number of
+ * levels.
+ */
+static int
+gist_index_stats(Relation index, IndexLevelStats **levels, int *maxlevels)
+{
+	TupleDesc tupdesc = RelationGetDescr(index);
+	IndexKeyType keytype = index_key_type(TupleDescAttr(tupdesc, 0)->atttypid);
+	int pageSize = BLCKSZ - SizeOfPageHeaderData -
+		MAXALIGN(sizeof(GISTPageOpaqueData));
+	BlockNumber *current = palloc(sizeof(BlockNumber)),
+		*next;
+	int ncurrent = 1, nnext, maxnext, level = 0;
+
+	current[0] = GIST_ROOT_BLKNO;
+	while (ncurrent > 0)
+	{
+		IndexLevelStats *stats = index_level_stats(levels, maxlevels, level);
+		int i;
+		maxnext = 64;
+		nnext = 0;
+		next = palloc(sizeof(BlockNumber) * maxnext);
+		for (i = 0; i < ncurrent; i++)
+		{
+			Buffer buffer = ReadBuffer(index, current[i]);
+			Page page;
+			OffsetNumber offset, maxoff;
+			Datum *keys;
+			int nkeys = 0;
+
+			LockBuffer(buffer, GIST_SHARE);
+			page = BufferGetPage(buffer);
+			if (PageIsNew(page) || GistPageIsDeleted(page))
+			{
+				UnlockReleaseBuffer(buffer);
+				continue;
+			}
+			stats->pages++;
+			stats->usedSpace += pageSize - PageGetExactFreeSpace(page);
+			maxoff = PageGetMaxOffsetNumber(page);
+			keys = palloc(sizeof(Datum) * (maxoff + 1));
+			for (offset = FirstOffsetNumber; offset <= maxoff; offset++)
+			{
+				ItemId iid = PageGetItemId(page, offset);
+				IndexTuple itup;
+				Datum key;
+				bool isnull;
+
+				if (ItemIdIsDead(iid))
+					continue;
+				itup = (IndexTuple) PageGetItem(page, iid);
+				if (GistPageIsLeaf(page))
+					stats->leafTuples++;
+				else
+				{
+					stats->innerTuples++;
+					if (nnext == maxnext)
+					{
+						maxnext *= 2;
+						next = repalloc(next, sizeof(BlockNumber) * maxnext);
+					}
+					next[nnext++] = ItemPointerGetBlockNumber(&(itup->t_tid));
+				}
+				key = index_getattr(itup, 1, tupdesc, &isnull);
+				if (!isnull)
+					keys[nkeys++] = key;
+			}
+			index_level_keys(stats, keytype, keys, nkeys);
+			pfree(keys);
+			UnlockReleaseBuffer(buffer);
+		}
+		pfree(current);
+		current = next;
+		ncurrent = nnext;
+		level++;
+	}
+	pfree(current);
+	return level;
+}
+
+/*
+ * Collect the statistics of the levels of an SP-GiST index, which are
+ * traversed in breadth-first order starting from the root inner tuple.
+ * The level of a tuple is its depth in the tree, and thus the pages of a
+ * level are those containing at least one of its tuples. Only the leaf
+ * tuples of the same node, which are chained in a leaf page, are siblings.
+ * The separate tree of null values is not traversed.
+ * Returns the number of levels.
+ */
+static int
+spgist_index_stats(Relation index, IndexLevelStats **levels, int *maxlevels)
+{
+	SpGistCache *cache = spgGetCache(index);
+	IndexKeyType keytype = index_key_type(cache->attLeafType.type);
+	BlockNumber totalPages = RelationGetNumberOfBlocks(index);
+	bool *visited = palloc(sizeof(bool) * totalPages);
+	ItemPointerData *current = palloc(sizeof(ItemPointerData)),
+		*next;
+	int ncurrent = 1, maxcurrent = 1, nnext, maxnext, level = 0;
+
+	ItemPointerSet(&current[0], SPGIST_ROOT_BLKNO, FirstOffsetNumber);
+	while (ncurrent > 0)
+	{
+		IndexLevelStats *stats = index_level_stats(levels, maxlevels, level);
+		int i;
+		memset(visited, 0, sizeof(bool) * totalPages);
+		maxnext = 64;
+		nnext = 0;
+		next = palloc(sizeof(ItemPointerData) * maxnext);
+		/* The array current may grow with the redirections */
+		for (i = 0; i < ncurrent; i++)
+		{
+			BlockNumber blkno = ItemPointerGetBlockNumber(&current[i]);
+			OffsetNumber offset = ItemPointerGetOffsetNumber(&current[i]);
+			Buffer buffer = ReadBuffer(index, blkno);
+			Page page;
+
+			LockBuffer(buffer, BUFFER_LOCK_SHARE);
+			page = BufferGetPage(buffer);
+			if (PageIsNew(page) || SpGistPageIsDeleted(page) ||
+				offset > PageGetMaxOffsetNumber(page))
+			{
+				UnlockReleaseBuffer(buffer);
+				continue;
+			}
+			if (!visited[blkno])
+			{
+				visited[blkno] = true;
+				stats->pages++;
+			}
+
+			if (SpGistPageIsLeaf(page))
+			{
+				/* The root page is a leaf page if the index is small, in
+				 * that case all the tuples of the page are siblings */
+				bool root = (blkno == SPGIST_ROOT_BLKNO);
+				OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+				Datum *keys = palloc(sizeof(Datum) * (maxoff + 1));
+				int nkeys = 0;
+				while (offset != InvalidOffsetNumber && offset <= maxoff)
+				{
+					SpGistLeafTuple lt = (SpGistLeafTuple) PageGetItem(page,
+						PageGetItemId(page, offset));
+					if (lt->tupstate == SPGIST_LIVE)
+					{
+						stats->leafTuples++;
+						keys[nkeys++] = PointerGetDatum(SGLTDATAPTR(lt));
+					}
+					else if (lt->tupstate == SPGIST_REDIRECT && !root)
+					{
+						if (ncurrent == maxcurrent)
+						{
+							maxcurrent *= 2;
+							current = repalloc(current,
+								sizeof(ItemPointerData) * maxcurrent);
+						}
+						current[ncurrent++] = ((SpGistDeadTuple) lt)->pointer;
+						break;
+					}
+					offset = root ? offset + 1 : lt->nextOffset;
+				}
+				index_level_keys(stats, keytype, keys, nkeys);
+				pfree(keys);
+			}
+			else
+			{
+				SpGistInnerTuple it = (SpGistInnerTuple) PageGetItem(page,
+					PageGetItemId(page, offset));
+				SpGistNodeTuple node;
+				int j;
+
+				if (it->tupstate == SPGIST_REDIRECT)
+				{
+					if (ncurrent == maxcurrent)
+					{
+						maxcurrent *= 2;
+						current = repalloc(current,
+							sizeof(ItemPointerData) * maxcurrent);
+					}
+					current[ncurrent++] = ((SpGistDeadTuple) it)->pointer;
+				}
+				else if (it->tupstate == SPGIST_LIVE)
+				{
+					stats->innerTuples++;
+					SGITITERATE(it, j, node)
+					{
+						if (!ItemPointerIsValid(&node->t_tid))
+							continue;
+						if (nnext == maxnext)
+						{
+							maxnext *= 2;
+							next = repalloc(next,
+								sizeof(ItemPointerData) * maxnext);
+						}
+						next[nnext++] = node->t_tid;
+					}
+				}
+			}
+			UnlockReleaseBuffer(buffer);
+		}
+		pfree(current);
+		current = next;
+		ncurrent = nnext;
+		maxcurrent = maxnext;
+		level++;
+	}
+	pfree(current);
+	pfree(visited);
+	return level;
+}
+
+/*
+ * Returns a row with the statistics of each level of a GiST or an SP-GiST
+ * index, the level of the root being 0
+ */
+
+PG_FUNCTION_INFO_V1(mobdb_index_stats);
+
+PGDLLEXPORT Datum
+mobdb_index_stats(PG_FUNCTION_ARGS)
+{
+	Oid indexoid = PG_GETARG_OID(0);
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext oldcontext;
+	Relation index;
+	IndexLevelStats *levels;
+	int maxlevels = 8, nlevels, i;
+	bool gist;
+	int pageSize = BLCKSZ - SizeOfPageHeaderData -
+		MAXALIGN(sizeof(GISTPageOpaqueData));
+
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo) ||
+		!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("set-valued function called in context that cannot accept a set")));
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("function returning record called in context "
+				"that cannot accept type record")));
+
+	index = relation_open(indexoid, AccessShareLock);
+	if (!IS_INDEX(index) || (!IS_GIST(index) && !IS_SPGIST(index)))
+		ereport(ERROR, (errcode(ERRCODE_WRONG_OBJECT_TYPE),
+			errmsg("relation \"%s\" is not a GiST or an SP-GiST index",
+				RelationGetRelationName(index))));
+	gist = IS_GIST(index);
+
+	levels = palloc0(sizeof(IndexLevelStats) * maxlevels);
+	nlevels = gist ? gist_index_stats(index, &levels, &maxlevels) :
+		spgist_index_stats(index, &levels, &maxlevels);
+	relation_close(index, AccessShareLock);
+
+	oldcontext = MemoryContextSwitchTo(rsinfo->econtext->ecxt_per_query_memory);
+	tupdesc = BlessTupleDesc(CreateTupleDescCopy(tupdesc));
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+	MemoryContextSwitchTo(oldcontext);
+
+	for (i = 0; i < nlevels; i++)
+	{
+		IndexLevelStats *stats = &levels[i];
+		Datum values[7];
+		bool isnull[7] = {false, false, false, false, false, false, false};
+
+		values[0] = Int32GetDatum(i);
+		values[1] = Int64GetDatum(stats->pages);
+		values[2] = Int64GetDatum(stats->innerTuples);
+		values[3] = Int64GetDatum(stats->leafTuples);
+		/* The pages of SP-GiST indexes are shared by several levels */
+		if (gist && stats->pages > 0)
+			values[4] = Float8GetDatum(stats->usedSpace /
+				((double) pageSize * stats->pages));
+		else
+			isnull[4] = true;
+		if (stats->nkeys > 0)
+			values[5] = Float8GetDatum(stats->volume / stats->nkeys);
+		else
+			isnull[5] = true;
+		if (stats->pairs > 0)
+			values[6] = Float8GetDatum((double) stats->overlaps / stats->pairs);
+		else
+			isnull[6] = true;
+		tuplestore_putvalues(tupstore, tupdesc, values, isnull);
+	}
+	pfree(levels);
+	PG_RETURN_NULL();
+}
+
+/*****************************************************************************/
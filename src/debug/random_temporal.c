@@ -0,0 +1,199 @@
+/*****************************************************************************
+ *
+ * random_temporal.c
+ *	  Generation of random temporal values for benchmarks
+ *
+ * These functions generate in a single call temporal sequences with a given
+ * number of instants, which is much faster than the PL/pgSQL functions of
+ * the file random_temporal.sql for the large tables used in benchmarks. The
+ * values are generated by a pseudorandom number generator that is seeded by
+ * an argument of the functions, so that the same seed always gives the same
+ * value on any platform. The generator is splitmix64, which is fast and
+ * sufficient for generating test data, but not for cryptographic purposes.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_random.h"
+
+#include <math.h>
+#include <utils/builtins.h>
+#include <utils/timestamp.h>
+
+#include "period.h"
+#include "temporaltypes.h"
+
+/*****************************************************************************
+ * Pseudorandom number generator
+ *****************************************************************************/
+
+void
+random_init(RandomState *state, int64 seed)
+{
+	state->s = (uint64) seed;
+}
+
+static uint64
+random_next(RandomState *state)
+{
+	uint64 z = (state->s += UINT64CONST(0x9E3779B97F4A7C15));
+	z = (z ^ (z >> 30)) * UINT64CONST(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27)) * UINT64CONST(0x94D049BB133111EB);
+	return z ^ (z >> 31);
+}
+
+/* Random number uniformly distributed in [0, 1) */
+
+double
+random_double(RandomState *state)
+{
+	return (double) (random_next(state) >> 11) * (1.0 / (UINT64CONST(1) << 53));
+}
+
+/* Random number normally distributed with mean 0 and variance 1 */
+
+double
+random_gaussian(RandomState *state)
+{
+	double u1 = 1.0 - random_double(state);
+	double u2 = random_double(state);
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/* Reflect a value into the interval [low, high] */
+
+double
+random_reflect(double value, double low, double high)
+{
+	double width = high - low;
+	if (width <= 0)
+		return low;
+	double v = fmod(value - low, 2.0 * width);
+	if (v < 0)
+		v += 2.0 * width;
+	if (v > width)
+		v = 2.0 * width - v;
+	return low + v;
+}
+
+RandomDist
+random_distribution(text *name)
+{
+	char *str = text_to_cstring(name);
+	RandomDist result;
+	if (pg_strcasecmp(str, "uniform") == 0)
+		result = RANDOM_UNIFORM;
+	else if (pg_strcasecmp(str, "walk") == 0)
+		result = RANDOM_WALK;
+	else if (pg_strcasecmp(str, "clustered") == 0)
+		result = RANDOM_CLUSTERED;
+	else if (pg_strcasecmp(str, "road") == 0)
+		result = RANDOM_ROAD;
+	else
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("Unknown distribution: %s", str)));
+	pfree(str);
+	return result;
+}
+
+int64
+random_step_usecs(Interval *step)
+{
+	int64 result = step->time + ((int64) step->month * DAYS_PER_MONTH +
+		step->day) * USECS_PER_DAY;
+	if (result <= 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The step must be positive")));
+	return result;
+}
+
+/*
+ * Random start of a sequence of count instants separated by the step, such
+ * that the sequence ends before the upper bound when possible
+ */
+TimestampTz
+random_start(RandomState *state, TimestampTz lower, TimestampTz upper,
+	int64 step, int count)
+{
+	double span = (double) upper - (double) lower - (double) step * (count - 1);
+	if (span <= 0)
+		return lower;
+	return lower + (TimestampTz) (random_double(state) * span);
+}
+
+/*****************************************************************************
+ * Temporal floats
+ *****************************************************************************/
+
+PG_FUNCTION_INFO_V1(random_tfloat_seq);
+
+PGDLLEXPORT Datum
+random_tfloat_seq(PG_FUNCTION_ARGS)
+{
+	double low = PG_GETARG_FLOAT8(0);
+	double high = PG_GETARG_FLOAT8(1);
+	Period *p = PG_GETARG_PERIOD(2);
+	int count = PG_GETARG_INT32(3);
+	int64 step = random_step_usecs(PG_GETARG_INTERVAL_P(4));
+	RandomDist dist = random_distribution(PG_GETARG_TEXT_PP(5));
+	int64 seed = PG_GETARG_INT64(6);
+	if (low > high)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The lower bound must be less than or equal to the upper bound")));
+	if (count <= 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The number of instants must be positive")));
+	if (dist == RANDOM_ROAD)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The road distribution is only defined for temporal points")));
+
+	double width = high - low;
+	double center = 0;
+	if (dist == RANDOM_CLUSTERED)
+	{
+		/* The centers only depend on the bounds, the seed chooses one */
+		RandomState cstate;
+		random_init(&cstate, 0);
+		double centers[RANDOM_CLUSTERS];
+		for (int i = 0; i < RANDOM_CLUSTERS; i++)
+			centers[i] = low + random_double(&cstate) * width;
+		RandomState sstate;
+		random_init(&sstate, seed);
+		center = centers[random_next(&sstate) % RANDOM_CLUSTERS];
+	}
+	RandomState state;
+	random_init(&state, seed);
+	TimestampTz t = random_start(&state, p->lower, p->upper, step, count);
+	double value = dist == RANDOM_CLUSTERED ? center :
+		low + random_double(&state) * width;
+
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
+	for (int i = 0; i < count; i++)
+	{
+		if (i > 0)
+		{
+			if (dist == RANDOM_UNIFORM)
+				value = low + random_double(&state) * width;
+			else if (dist == RANDOM_WALK)
+				value += random_gaussian(&state) * width * 0.01;
+			else /* dist == RANDOM_CLUSTERED */
+				value = center + (value - center) * 0.9 +
+					random_gaussian(&state) * width * 0.02;
+			value = random_reflect(value, low, high);
+		}
+		instants[i] = temporalinst_make(Float8GetDatum(value), t, FLOAT8OID);
+		t += step;
+	}
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, count,
+		true, true, true, false);
+	for (int i = 0; i < count; i++)
+		pfree(instants[i]);
+	pfree(instants);
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************/
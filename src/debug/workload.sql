@@ -0,0 +1,190 @@
+-------------------------------------------------------------------------------
+-- Timed query workload over the big test tables
+-------------------------------------------------------------------------------
+-- The queries of the workload are stored in the table workload_query. Each
+-- run of the workload executes every query with EXPLAIN (ANALYZE, BUFFERS)
+-- and records in the table workload_result the planning and execution times,
+-- the buffers and the shape of the plan of its fastest execution. A run can
+-- be saved as the baseline and later runs compared against it, which reports
+-- both the changes of plan and the changes of execution time.
+--
+-- The tables are created by the functions in create_test_tables_temporal_big.sql
+-- and point/src/debug/create_test_tables_tpoint_big.sql, e.g.
+--	select create_test_tables_temporal_big(10000);
+--	select workload_setup();
+--	select workload_run();
+--	select workload_save_baseline();
+--	... change the code or the indexes, reinstall, and then
+--	select workload_run();
+--	select * from workload_compare();
+-------------------------------------------------------------------------------
+
+CREATE TABLE IF NOT EXISTS workload_query (
+	name text PRIMARY KEY,
+	kind text NOT NULL,
+	query text NOT NULL
+);
+
+CREATE TABLE IF NOT EXISTS workload_result (
+	run timestamptz NOT NULL,
+	name text NOT NULL,
+	plan text,
+	planning_ms float,
+	execution_ms float,
+	shared_hit bigint,
+	shared_read bigint,
+	rows bigint,
+	PRIMARY KEY (run, name)
+);
+
+CREATE TABLE IF NOT EXISTS workload_baseline (
+	name text PRIMARY KEY,
+	plan text,
+	planning_ms float,
+	execution_ms float,
+	shared_hit bigint,
+	shared_read bigint,
+	rows bigint
+);
+
+-------------------------------------------------------------------------------
+
+INSERT INTO workload_query VALUES
+('index_tfloat_tbox', 'index scan',
+'SELECT count(*) FROM tbl_tfloat_big
+WHERE temp && tbox(floatrange ''[10, 20]'', period ''[2001-03-01, 2001-04-01]'')'),
+('index_tfloat_period', 'index scan',
+'SELECT count(*) FROM tbl_tfloat_big
+WHERE temp && period ''[2001-06-01, 2001-06-15]'''),
+('index_tfloat_contained', 'index scan',
+'SELECT count(*) FROM tbl_tfloat_big
+WHERE temp <@ tbox(floatrange ''[0, 100]'', period ''[2001-01-01, 2001-07-01]'')'),
+('index_tint_period', 'index scan',
+'SELECT count(*) FROM tbl_tint_big
+WHERE temp && period ''[2001-06-01, 2001-06-15]'''),
+('index_period', 'index scan',
+'SELECT count(*) FROM tbl_period_big
+WHERE p && period ''[2001-06-01, 2001-06-15]'''),
+('join_tfloat_overlaps', 'join',
+'SELECT count(*) FROM tbl_tfloat_big t1, tbl_tfloat_big t2
+WHERE t1.k < t2.k AND t1.temp && t2.temp'),
+('agg_tfloat_extent', 'aggregate',
+'SELECT extent(temp) FROM tbl_tfloat_big'),
+('agg_tfloat_tcount', 'aggregate',
+'SELECT numInstants(tcount(temp)) FROM tbl_tfloat_big'),
+('agg_tfloatseq_tsum_bucket', 'aggregate',
+'SELECT numInstants(tsum(seq, interval ''1 week'')) FROM tbl_tfloatseq_big'),
+('window_tfloat_tcount', 'window aggregate',
+'SELECT count(w) FROM (SELECT tcount(temp) OVER (ORDER BY k
+ROWS BETWEEN 9 PRECEDING AND CURRENT ROW) AS w FROM tbl_tfloat_big) AS t'),
+('window_tfloat_extent', 'window aggregate',
+'SELECT count(w) FROM (SELECT extent(temp) OVER (PARTITION BY k % 10
+ORDER BY k) AS w FROM tbl_tfloat_big) AS t')
+ON CONFLICT (name) DO UPDATE SET kind = EXCLUDED.kind, query = EXCLUDED.query;
+
+-------------------------------------------------------------------------------
+
+DROP FUNCTION IF EXISTS workload_setup();
+CREATE OR REPLACE FUNCTION workload_setup()
+RETURNS text AS $$
+BEGIN
+CREATE INDEX IF NOT EXISTS tbl_tfloat_big_gist_idx ON tbl_tfloat_big USING GIST(temp);
+CREATE INDEX IF NOT EXISTS tbl_tint_big_spgist_idx ON tbl_tint_big USING SPGIST(temp);
+CREATE INDEX IF NOT EXISTS tbl_period_big_gist_idx ON tbl_period_big USING GIST(p);
+ANALYZE tbl_tfloat_big;
+ANALYZE tbl_tint_big;
+ANALYZE tbl_period_big;
+ANALYZE tbl_tfloatseq_big;
+RETURN 'The End';
+END;
+$$ LANGUAGE 'plpgsql';
+
+-- Node types of a plan in JSON format with the indexes used
+DROP FUNCTION IF EXISTS workload_plan_shape(json);
+CREATE OR REPLACE FUNCTION workload_plan_shape(plan json)
+RETURNS text AS $$
+DECLARE
+	children text;
+BEGIN
+	SELECT string_agg(workload_plan_shape(p), ', ') INTO children
+	FROM json_array_elements(plan->'Plans') AS p;
+	RETURN (plan->>'Node Type') || coalesce(' on ' || (plan->>'Index Name'), '') ||
+		coalesce(' (' || children || ')', '');
+END;
+$$ LANGUAGE 'plpgsql' IMMUTABLE;
+
+-- Run each query of the workload loops times and keep its fastest execution
+DROP FUNCTION IF EXISTS workload_run(int);
+CREATE OR REPLACE FUNCTION workload_run(loops int DEFAULT 3)
+RETURNS timestamptz AS $$
+DECLARE
+	runtime timestamptz = clock_timestamp();
+	q record;
+	result json;
+	best json;
+BEGIN
+FOR q IN SELECT * FROM workload_query ORDER BY name
+LOOP
+	best = NULL;
+	FOR i IN 1..loops
+	LOOP
+		EXECUTE 'EXPLAIN (ANALYZE, BUFFERS, FORMAT JSON) ' || q.query INTO result;
+		IF best IS NULL OR (result->0->>'Execution Time')::float <
+				(best->0->>'Execution Time')::float THEN
+			best = result;
+		END IF;
+	END LOOP;
+	INSERT INTO workload_result VALUES (runtime, q.name,
+		workload_plan_shape(best->0->'Plan'),
+		(best->0->>'Planning Time')::float,
+		(best->0->>'Execution Time')::float,
+		(best->0->'Plan'->>'Shared Hit Blocks')::bigint,
+		(best->0->'Plan'->>'Shared Read Blocks')::bigint,
+		(best->0->'Plan'->>'Actual Rows')::bigint);
+END LOOP;
+RETURN runtime;
+END;
+$$ LANGUAGE 'plpgsql' STRICT;
+
+-- Save a run, by default the last one, as the baseline
+DROP FUNCTION IF EXISTS workload_save_baseline(timestamptz);
+CREATE OR REPLACE FUNCTION workload_save_baseline(runtime timestamptz DEFAULT NULL)
+RETURNS text AS $$
+BEGIN
+IF runtime IS NULL THEN
+	SELECT max(run) INTO runtime FROM workload_result;
+END IF;
+DELETE FROM workload_baseline;
+INSERT INTO workload_baseline
+SELECT name, plan, planning_ms, execution_ms, shared_hit, shared_read, rows
+FROM workload_result WHERE run = runtime;
+RETURN 'The End';
+END;
+$$ LANGUAGE 'plpgsql';
+
+/*
+ * Compare a run, by default the last one, against the baseline. A query is
+ * reported as slower or faster when the ratio of its execution times differs
+ * from 1 by more than the tolerance.
+ */
+DROP FUNCTION IF EXISTS workload_compare(timestamptz, float);
+CREATE OR REPLACE FUNCTION workload_compare(runtime timestamptz DEFAULT NULL,
+	tolerance float DEFAULT 0.2)
+RETURNS TABLE(name text, status text, baseline_ms float, execution_ms float,
+	ratio float, plan_changed boolean, rows_changed boolean) AS $$
+	SELECT b.name,
+		CASE
+			WHEN r.name IS NULL THEN 'missing'
+			WHEN r.execution_ms > b.execution_ms * (1 + tolerance) THEN 'slower'
+			WHEN r.execution_ms < b.execution_ms * (1 - tolerance) THEN 'faster'
+			ELSE 'same'
+		END,
+		b.execution_ms, r.execution_ms,
+		round((r.execution_ms / nullif(b.execution_ms, 0))::numeric, 2)::float,
+		r.plan IS DISTINCT FROM b.plan, r.rows IS DISTINCT FROM b.rows
+	FROM workload_baseline b LEFT JOIN workload_result r ON r.name = b.name AND
+		r.run = coalesce(runtime, (SELECT max(run) FROM workload_result))
+	ORDER BY b.name;
+$$ LANGUAGE SQL;
+
+-------------------------------------------------------------------------------
@@ -64,12 +64,15 @@
 
 #include "lifting.h"
 
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
 
 #include "period.h"
 #include "timeops.h"
 #include "temporaltypes.h"
 #include "temporal_util.h"
+#include "temporal_probes.h"
+#include "temporal_stats.h"
 
 /*****************************************************************************
  * Functions where the argument is a temporal type. 
@@ -149,6 +152,7 @@ tfunc1_temporal(Temporal *temp, Datum (*func)(Datum), Oid valuetypid)
 {
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
+	MOBDB_STAT_INSTANTS(temp);
 	if (temp->duration == TEMPORALINST)
 		result = (Temporal *)tfunc1_temporalinst((TemporalInst *)temp,
 			func, valuetypid);
@@ -244,6 +248,7 @@ tfunc2_temporal(Temporal *temp, Datum param,
 {
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
+	MOBDB_STAT_INSTANTS(temp);
 	if (temp->duration == TEMPORALINST)
 		result = (Temporal *)tfunc2_temporalinst((TemporalInst *)temp,
 			param, func, valuetypid);
@@ -344,6 +349,7 @@ tfunc2_temporal_base(Temporal *temp, Datum d,
 {
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
+	MOBDB_STAT_INSTANTS(temp);
 	if (temp->duration == TEMPORALINST)
 		result = (Temporal *)tfunc2_temporalinst_base((TemporalInst *)temp, d, 
 			func, valuetypid, invert);
@@ -523,6 +529,7 @@ tfunc4_temporal_base(Temporal *temp, Datum value,
 {
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
+	MOBDB_STAT_INSTANTS(temp);
 	if (temp->duration == TEMPORALINST)
 		result = (Temporal *)tfunc4_temporalinst_base((TemporalInst *)temp, 
 			value, func, datumtypid, valuetypid, inverted);
@@ -545,6 +552,8 @@ tfunc4_temporal_base(Temporal *temp, Datum value,
  * These functions suppose that the sequence has linear interpolation.
  *****************************************************************************/
 
+/* The intermediate values computed by this function are not freed since
+ * they are allocated in the arena of the calling function */
 static int
 tfunc4_temporalseq_base_cross1(TemporalSeq **result, TemporalInst *start,
 	TemporalInst *end, bool lower_inc, bool upper_inc, Datum value, 
@@ -567,8 +576,6 @@ tfunc4_temporalseq_base_cross1(TemporalSeq **result, TemporalInst *start,
 		/* Result has stepwise interpolation */
 		result[0] = temporalseq_from_temporalinstarr(instants, 2, 
 			lower_inc, upper_inc, false, false);
-		FREE_DATUM(startresult, valuetypid);
-		pfree(instants[0]); pfree(instants[1]);
 		return 1;
 	}
 	
@@ -585,7 +592,6 @@ tfunc4_temporalseq_base_cross1(TemporalSeq **result, TemporalInst *start,
 			/* Result has stepwise interpolation */
 			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
 				true, true, false, false);
-			pfree(instants[0]);
 		}
 		/* Find the middle time between start and the end instant and compute
 		 * the function at that point */
@@ -600,8 +606,6 @@ tfunc4_temporalseq_base_cross1(TemporalSeq **result, TemporalInst *start,
 		/* Result has stepwise interpolation */
 		result[k++] = temporalseq_from_temporalinstarr(instants, 2,
 			false, false, false, false);			
-		pfree(instants[0]); pfree(instants[1]);
-		FREE_DATUM(intvalue, start->valuetypid); FREE_DATUM(intresult, valuetypid);
 		/* Compute the function at the end instant */
 		if (upper_inc)
 		{
@@ -612,14 +616,12 @@ tfunc4_temporalseq_base_cross1(TemporalSeq **result, TemporalInst *start,
 			/* Result has stepwise interpolation */
 			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
 				true, true, false, false);
-			pfree(instants[0]);
-			FREE_DATUM(endresult, valuetypid); 
 		}
-		FREE_DATUM(startresult, valuetypid); 
 		return k;
 	}
 	
 	/* Determine whether there is a crossing */
+	MOBDB_STAT_INC(crossings);
 	TimestampTz crosstime;
 	bool hascross = tlinearseq_timestamp_at_value(start, end, value, 
 		datumtypid, &crosstime);
@@ -634,8 +636,6 @@ tfunc4_temporalseq_base_cross1(TemporalSeq **result, TemporalInst *start,
 		/* Result has stepwise interpolation */
 		result[0] = temporalseq_from_temporalinstarr(instants, 2,
 			lower_inc, upper_inc, false, false);
-		FREE_DATUM(startresult, valuetypid); 
-		pfree(instants[0]); pfree(instants[1]); 
 		return 1;
 	}
 
@@ -646,8 +646,6 @@ tfunc4_temporalseq_base_cross1(TemporalSeq **result, TemporalInst *start,
 	/* Result has stepwise interpolation */
 	result[0] = temporalseq_from_temporalinstarr(instants, 2, 
 		lower_inc, false, false, false);
-	FREE_DATUM(startresult, valuetypid);
-	pfree(instants[0]); pfree(instants[1]); 
 	/* Compute the function at the crossing. Due to floating point precision 
 	 * we cannot compute the function at the crosstime as follows
 			startresult = temporalseq_value_at_timestamp1(start, end, true, crosstime);
@@ -658,8 +656,6 @@ tfunc4_temporalseq_base_cross1(TemporalSeq **result, TemporalInst *start,
 	/* Result has stepwise interpolation */
 	result[1] = temporalseq_from_temporalinstarr(instants, 1, 
 		true, true, false, false);
-	FREE_DATUM(value2, valuetypid);
-	pfree(instants[0]); 
 	/* Find the middle time between start and the end instant and compute
 	 * the function at that point */
 	TimestampTz inttime = crosstime + ((end->t - crosstime)/2);
@@ -673,8 +669,6 @@ tfunc4_temporalseq_base_cross1(TemporalSeq **result, TemporalInst *start,
 	/* Result has stepwise interpolation */
 	result[2] = temporalseq_from_temporalinstarr(instants, 2, 
 		false, upper_inc, false, false);
-	pfree(instants[0]); pfree(instants[1]);
-	FREE_DATUM(startresult, valuetypid); FREE_DATUM(value2, valuetypid); 
 	return 3;
 }
 
@@ -719,16 +713,16 @@ tfunc4_temporalseq_base_cross(TemporalSeq *seq, Datum value,
 	Datum (*func)(Datum, Datum, Oid, Oid), Oid datumtypid, 
 	Oid valuetypid, bool invert)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * seq->count * 3);
 	int count = tfunc4_temporalseq_base_cross2(sequences, seq, value, 
 		func, datumtypid, valuetypid, invert);
+	MemoryContextSwitchTo(oldctx);
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
 		false, true);
-
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	temporal_arena_delete(arena);
 	
 	return result;
 }
@@ -738,6 +732,8 @@ tfunc4_temporals_base_cross(TemporalS *ts, Datum value,
 	Datum (*func)(Datum, Datum, Oid, Oid), Oid datumtypid, 
 	Oid valuetypid, bool invert)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->totalcount * 3);
 	int k = 0;
 	for (int i = 0; i < ts->count; i++)
@@ -746,13 +742,11 @@ tfunc4_temporals_base_cross(TemporalS *ts, Datum value,
 		k += tfunc4_temporalseq_base_cross2(&sequences[k], seq, value,
 			func, datumtypid, valuetypid, invert);
 	}
+	MemoryContextSwitchTo(oldctx);
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		false, true);
-
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	temporal_arena_delete(arena);
 	
 	return result;
 }
@@ -998,25 +992,22 @@ sync_tfunc2_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 	Datum (*func)(Datum, Datum), Oid valuetypid, bool linear,
 	bool (*interpoint)(TemporalInst *, TemporalInst *, TemporalInst *, TemporalInst *, TimestampTz *))
 {
-	/* Test whether the bounding period of the two temporal values overlap */
-	Period *inter = intersection_period_period_internal(&seq1->period, 
-		&seq2->period);
-	if (inter == NULL)
+	/* The synchronized segments of the sequences are computed on the fly */
+	SyncSeqCursor cursor;
+	if (!temporalseq_sync_cursor_init(&cursor, seq1, seq2))
 		return NULL;
 	
 	/* If the two sequences intersect at an instant */
-	if (timestamp_cmp_internal(inter->lower, inter->upper) == 0)
+	if (timestamp_cmp_internal(cursor.inter.lower, cursor.inter.upper) == 0)
 	{
-		Datum value1, value2;
-		temporalseq_value_at_timestamp(seq1, inter->lower, &value1);
-		temporalseq_value_at_timestamp(seq2, inter->lower, &value2);
-		Datum value = func(value1, value2);
-		TemporalInst *inst = temporalinst_make(value, inter->lower, valuetypid);
-		/* Result has stepwise interpolation */
+		Datum value = func(temporalinst_value(cursor.end1), 
+			temporalinst_value(cursor.end2));
+		TemporalInst *inst = temporalinst_make(value, cursor.inter.lower, 
+			valuetypid);
 		TemporalSeq *result = temporalseq_from_temporalinstarr(&inst, 1, 
 			true, true, linear, false);
-		FREE_DATUM(value1, seq1->valuetypid); FREE_DATUM(value2, seq2->valuetypid);
-		FREE_DATUM(value, valuetypid); pfree(inst); pfree(inter);
+		temporalseq_sync_cursor_end(&cursor);
+		FREE_DATUM(value, valuetypid); pfree(inst);
 		return result;
 	}
 	
@@ -1028,94 +1019,46 @@ sync_tfunc2_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 	 * where X, I, and * are values computed, respectively at synchronization points, 
 	 * intermediate points, and common points
 	 */
-	TemporalInst *inst1 = temporalseq_inst_n(seq1, 0);
-	TemporalInst *inst2 = temporalseq_inst_n(seq2, 0);
-	TemporalInst *tofreeinst = NULL;
-	int i = 0, j = 0, k = 0, l = 0;
-	if (timestamp_cmp_internal(inst1->t, inter->lower) < 0)
-	{
-		inst1 = temporalseq_at_timestamp(seq1, inter->lower);
-		tofreeinst = inst1;
-		i = temporalseq_find_timestamp(seq1, inter->lower);
-	}
-	else if (timestamp_cmp_internal(inst2->t, inter->lower) < 0)
-	{
-		inst2 = temporalseq_at_timestamp(seq2, inter->lower);
-		tofreeinst = inst2;
-		j = temporalseq_find_timestamp(seq2, inter->lower);
-	}
-	int count = (seq1->count - i + seq2->count - j) * 2;
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
+	int count = (seq1->count + seq2->count) * 2;
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
-	TemporalInst **tofree = palloc(sizeof(TemporalInst *) * count);
-	if (tofreeinst != NULL)
-		tofree[l++] = tofreeinst;
-	TemporalInst *prev1, *prev2;
 	Datum inter1, inter2, value;
 	TimestampTz intertime;
-	while (i < seq1->count && j < seq2->count &&
-		(timestamp_cmp_internal(inst1->t, inter->upper) <= 0 ||
-		timestamp_cmp_internal(inst2->t, inter->upper) <= 0))
-	{
-		int cmp = timestamp_cmp_internal(inst1->t, inst2->t);
-		if (cmp == 0)
-		{
-			i++; j++;
-		}
-		else if (cmp < 0)
-		{
-			i++;
-			inst2 = temporalseq_at_timestamp(seq2, inst1->t);
-			tofree[l++] = inst2;
-		}
-		else 
-		{
-			j++;
-			inst1 = temporalseq_at_timestamp(seq1, inst2->t);
-			tofree[l++] = inst1;
-		}
-		/* If not the first instant compute the function on the potential
-		   intermediate point before adding the new instants */
-		if (interpoint != NULL && k > 0 && 
-			interpoint(prev1, inst1, prev2, inst2, &intertime))
+	int k = 0;
+	value = func(temporalinst_value(cursor.end1), 
+			temporalinst_value(cursor.end2));
+	instants[k++] = temporalinst_make(value, cursor.end1->t, valuetypid);
+	while (temporalseq_sync_cursor_next(&cursor))
+	{
+		/* Compute the function on the potential intermediate point before 
+		   adding the new instants */
+		if (interpoint != NULL && interpoint(cursor.start1, cursor.end1,
+			cursor.start2, cursor.end2, &intertime))
 		{
-			inter1 = temporalseq_value_at_timestamp1(prev1, inst1, 
-				MOBDB_FLAGS_GET_LINEAR(seq1->flags), intertime);
-			inter2 = temporalseq_value_at_timestamp1(prev2, inst2, 
-				MOBDB_FLAGS_GET_LINEAR(seq2->flags), intertime);
+			inter1 = temporalseq_value_at_timestamp1(cursor.start1, 
+				cursor.end1, MOBDB_FLAGS_GET_LINEAR(seq1->flags), intertime);
+			inter2 = temporalseq_value_at_timestamp1(cursor.start2, 
+				cursor.end2, MOBDB_FLAGS_GET_LINEAR(seq2->flags), intertime);
 			value = func(inter1, inter2);
 			instants[k++] = temporalinst_make(value, intertime, valuetypid);
-			FREE_DATUM(inter1, seq1->valuetypid); FREE_DATUM(inter2, seq2->valuetypid);
-			FREE_DATUM(value, valuetypid);
 		}
-		value = func(temporalinst_value(inst1), temporalinst_value(inst2));
-		instants[k++] = temporalinst_make(value, inst1->t, valuetypid);
-		FREE_DATUM(value, valuetypid);
-		if (i == seq1->count || j == seq2->count)
-			break;
-		prev1 = inst1; prev2 = inst2;
-		inst1 = temporalseq_inst_n(seq1, i);
-		inst2 = temporalseq_inst_n(seq2, j);
+		value = func(temporalinst_value(cursor.end1), 
+			temporalinst_value(cursor.end2));
+		instants[k++] = temporalinst_make(value, cursor.end1->t, valuetypid);
 	}
-	/* We are sure that k != 0 due to the period intersection test above */
+	temporalseq_sync_cursor_end(&cursor);
 	/* The last two values of sequences with stepwise interpolation and  
 	   exclusive upper bound must be equal */
-	if (!linear && !inter->upper_inc && k > 1)
+	if (!linear && !cursor.inter.upper_inc && k > 1)
 	{
-		tofree[l++] = instants[k - 1];
 		value = temporalinst_value(instants[k - 2]);
 		instants[k - 1] = temporalinst_make(value, instants[k - 1]->t, valuetypid); 		
 	}
-
-   TemporalSeq *result = temporalseq_from_temporalinstarr(instants, k, 
-		inter->lower_inc, inter->upper_inc, linear, true);
-	
-	for (i = 0; i < k; i++)
-		pfree(instants[i]); 
-	pfree(instants);
-	for (i = 0; i < l; i++)
-		pfree(tofree[i]);
-	pfree(tofree); pfree(inter);
-
+	MemoryContextSwitchTo(oldctx);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, k, 
+		cursor.inter.lower_inc, cursor.inter.upper_inc, linear, true);
+	temporal_arena_delete(arena);
 	return result; 
 }
 
@@ -1238,6 +1181,10 @@ sync_tfunc2_temporal_temporal(Temporal *temp1, Temporal *temp2,
 	Temporal *result = NULL;
 	ensure_valid_duration(temp1->duration);
 	ensure_valid_duration(temp2->duration);
+	MOBDB_STAT_INSTANTS(temp1);
+	MOBDB_STAT_INSTANTS(temp2);
+	TRACE_MOBILITYDB_SYNC_START(temporal_stat_instants(temp1),
+		temporal_stat_instants(temp2));
 	if (temp1->duration == TEMPORALINST && temp2->duration == TEMPORALINST) 
 		result = (Temporal *)sync_tfunc2_temporalinst_temporalinst(
 			(TemporalInst *)temp1, (TemporalInst *)temp2,
@@ -1306,6 +1253,8 @@ sync_tfunc2_temporal_temporal(Temporal *temp1, Temporal *temp2,
 			(TemporalS *)temp1, (TemporalS *)temp2,
 			func, valuetypid, linear, interpoint);
 
+	TRACE_MOBILITYDB_SYNC_DONE(result == NULL ? 0 : temporal_stat_instants(result),
+		result == NULL ? 0 : VARSIZE(result));
 	return result;
 }
 
@@ -1794,6 +1743,10 @@ sync_tfunc3_temporal_temporal(Temporal *temp1, Temporal *temp2,
 	Temporal *result = NULL;
 	ensure_valid_duration(temp1->duration);
 	ensure_valid_duration(temp2->duration);
+	MOBDB_STAT_INSTANTS(temp1);
+	MOBDB_STAT_INSTANTS(temp2);
+	TRACE_MOBILITYDB_SYNC_START(temporal_stat_instants(temp1),
+		temporal_stat_instants(temp2));
 	if (temp1->duration == TEMPORALINST && temp2->duration == TEMPORALINST) 
 		result = (Temporal *)sync_tfunc3_temporalinst_temporalinst(
 			(TemporalInst *)temp1, (TemporalInst *)temp2,
@@ -1862,6 +1815,8 @@ sync_tfunc3_temporal_temporal(Temporal *temp1, Temporal *temp2,
 			(TemporalS *)temp1, (TemporalS *)temp2,
 			param, func, valuetypid, linear, interpoint);
 
+	TRACE_MOBILITYDB_SYNC_DONE(result == NULL ? 0 : temporal_stat_instants(result),
+		result == NULL ? 0 : VARSIZE(result));
 	return result;
 }
 */
@@ -2112,25 +2067,22 @@ sync_tfunc4_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 	Datum (*func)(Datum, Datum, Oid, Oid), Oid valuetypid, bool linear,
 	bool (*interpoint)(TemporalInst *, TemporalInst *, TemporalInst *, TemporalInst *, TimestampTz *))
 {
-	/* Test whether the bounding period of the two temporal values overlap */
-	Period *inter = intersection_period_period_internal(&seq1->period, 
-		&seq2->period);
-	if (inter == NULL)
+	/* The synchronized segments of the sequences are computed on the fly */
+	SyncSeqCursor cursor;
+	if (!temporalseq_sync_cursor_init(&cursor, seq1, seq2))
 		return NULL;
 	
 	/* If the two sequences intersect at an instant */
-	if (timestamp_cmp_internal(inter->lower, inter->upper) == 0)
+	if (timestamp_cmp_internal(cursor.inter.lower, cursor.inter.upper) == 0)
 	{
-		Datum value1, value2;
-		temporalseq_value_at_timestamp(seq1, inter->lower, &value1);
-		temporalseq_value_at_timestamp(seq2, inter->lower, &value2);
-		Datum value = func(value1, value2, 
-			seq1->valuetypid, seq2->valuetypid);
-		TemporalInst *inst = temporalinst_make(value, inter->lower, valuetypid);
+		Datum value = func(temporalinst_value(cursor.end1), 
+			temporalinst_value(cursor.end2), seq1->valuetypid, seq2->valuetypid);
+		TemporalInst *inst = temporalinst_make(value, cursor.inter.lower, 
+			valuetypid);
 		TemporalSeq *result = temporalseq_from_temporalinstarr(&inst, 1, 
 			true, true, linear, false);
-		FREE_DATUM(value1, seq1->valuetypid); FREE_DATUM(value2, seq2->valuetypid);
-		FREE_DATUM(value, valuetypid); pfree(inst); pfree(inter);
+		temporalseq_sync_cursor_end(&cursor);
+		FREE_DATUM(value, valuetypid); pfree(inst);
 		return result;
 	}
 	
@@ -2142,95 +2094,46 @@ sync_tfunc4_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 	 * where X, I, and * are values computed, respectively at synchronization points, 
 	 * intermediate points, and common points
 	 */
-	TemporalInst *inst1 = temporalseq_inst_n(seq1, 0);
-	TemporalInst *inst2 = temporalseq_inst_n(seq2, 0);
-	TemporalInst *tofreeinst = NULL;
-	int i = 0, j = 0, k = 0, l = 0;
-	if (timestamp_cmp_internal(inst1->t, inter->lower) < 0)
-	{
-		inst1 = temporalseq_at_timestamp(seq1, inter->lower);
-		tofreeinst = inst1;
-		i = temporalseq_find_timestamp(seq1, inter->lower);
-	}
-	else if (timestamp_cmp_internal(inst2->t, inter->lower) < 0)
-	{
-		inst2 = temporalseq_at_timestamp(seq2, inter->lower);
-		tofreeinst = inst2;
-		j = temporalseq_find_timestamp(seq2, inter->lower);
-	}
-	int count = (seq1->count - i + seq2->count - j) * 2;
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
+	int count = (seq1->count + seq2->count) * 2;
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
-	TemporalInst **tofree = palloc(sizeof(TemporalInst *) * count);
-	if (tofreeinst != NULL)
-		tofree[l++] = tofreeinst;
-	TemporalInst *prev1, *prev2;
 	Datum inter1, inter2, value;
 	TimestampTz intertime;
-	while (i < seq1->count && j < seq2->count &&
-		(timestamp_cmp_internal(inst1->t, inter->upper) <= 0 ||
-		timestamp_cmp_internal(inst2->t, inter->upper) <= 0))
-	{
-		int cmp = timestamp_cmp_internal(inst1->t, inst2->t);
-		if (cmp == 0)
-		{
-			i++; j++;
-		}
-		else if (cmp < 0)
-		{
-			i++;
-			inst2 = temporalseq_at_timestamp(seq2, inst1->t);
-			tofree[l++] = inst2;
-		}
-		else 
-		{
-			j++;
-			inst1 = temporalseq_at_timestamp(seq1, inst2->t);
-			tofree[l++] = inst1;
-		}
-		/* If not the first instant compute the function on the potential
-		   intermediate point before adding the new instants */
-		if (interpoint != NULL && k > 0 && 
-			interpoint(prev1, inst1, prev2, inst2, &intertime))
+	int k = 0;
+	value = func(temporalinst_value(cursor.end1), 
+			temporalinst_value(cursor.end2), seq1->valuetypid, seq2->valuetypid);
+	instants[k++] = temporalinst_make(value, cursor.end1->t, valuetypid);
+	while (temporalseq_sync_cursor_next(&cursor))
+	{
+		/* Compute the function on the potential intermediate point before 
+		   adding the new instants */
+		if (interpoint != NULL && interpoint(cursor.start1, cursor.end1,
+			cursor.start2, cursor.end2, &intertime))
 		{
-			inter1 = temporalseq_value_at_timestamp1(prev1, inst1, 
-				MOBDB_FLAGS_GET_LINEAR(seq1->flags), intertime);
-			inter2 = temporalseq_value_at_timestamp1(prev2, inst2, 
-				MOBDB_FLAGS_GET_LINEAR(seq2->flags), intertime);
+			inter1 = temporalseq_value_at_timestamp1(cursor.start1, 
+				cursor.end1, MOBDB_FLAGS_GET_LINEAR(seq1->flags), intertime);
+			inter2 = temporalseq_value_at_timestamp1(cursor.start2, 
+				cursor.end2, MOBDB_FLAGS_GET_LINEAR(seq2->flags), intertime);
 			value = func(inter1, inter2, seq1->valuetypid, seq2->valuetypid);
 			instants[k++] = temporalinst_make(value, intertime, valuetypid);
-			FREE_DATUM(inter1, seq1->valuetypid); FREE_DATUM(inter2, seq2->valuetypid);
-			FREE_DATUM(value, valuetypid);
 		}
-		value = func(temporalinst_value(inst1), temporalinst_value(inst2), 
-			seq1->valuetypid, seq2->valuetypid);
-		instants[k++] = temporalinst_make(value, inst1->t, valuetypid);
-		FREE_DATUM(value, valuetypid);
-		if (i == seq1->count || j == seq2->count)
-			break;
-		prev1 = inst1; prev2 = inst2;
-		inst1 = temporalseq_inst_n(seq1, i);
-		inst2 = temporalseq_inst_n(seq2, j);
+		value = func(temporalinst_value(cursor.end1), 
+			temporalinst_value(cursor.end2), seq1->valuetypid, seq2->valuetypid);
+		instants[k++] = temporalinst_make(value, cursor.end1->t, valuetypid);
 	}
-	/* We are sure that k != 0 due to the period intersection test above */
+	temporalseq_sync_cursor_end(&cursor);
 	/* The last two values of sequences with stepwise interpolation and  
 	   exclusive upper bound must be equal */
-	if (!linear && !inter->upper_inc && k > 1)
+	if (!linear && !cursor.inter.upper_inc && k > 1)
 	{
-		tofree[l++] = instants[k - 1];
 		value = temporalinst_value(instants[k - 2]);
 		instants[k - 1] = temporalinst_make(value, instants[k - 1]->t, valuetypid); 		
 	}
-
-   TemporalSeq *result = temporalseq_from_temporalinstarr(instants, k, 
-		inter->lower_inc, inter->upper_inc, linear, true);
-	
-	for (i = 0; i < k; i++)
-		pfree(instants[i]); 
-	pfree(instants);
-	for (i = 0; i < l; i++)
-		pfree(tofree[i]);
-	pfree(tofree); pfree(inter);
-
+	MemoryContextSwitchTo(oldctx);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, k, 
+		cursor.inter.lower_inc, cursor.inter.upper_inc, linear, true);
+	temporal_arena_delete(arena);
 	return result; 
 }
 
@@ -2352,6 +2255,10 @@ sync_tfunc4_temporal_temporal(Temporal *temp1, Temporal *temp2,
 	Temporal *result = NULL;
 	ensure_valid_duration(temp1->duration);
 	ensure_valid_duration(temp2->duration);
+	MOBDB_STAT_INSTANTS(temp1);
+	MOBDB_STAT_INSTANTS(temp2);
+	TRACE_MOBILITYDB_SYNC_START(temporal_stat_instants(temp1),
+		temporal_stat_instants(temp2));
 	if (temp1->duration == TEMPORALINST && temp2->duration == TEMPORALINST) 
 		result = (Temporal *)sync_tfunc4_temporalinst_temporalinst(
 			(TemporalInst *)temp1, (TemporalInst *)temp2,
@@ -2420,6 +2327,8 @@ sync_tfunc4_temporal_temporal(Temporal *temp1, Temporal *temp2,
 			(TemporalS *)temp1, (TemporalS *)temp2,
 			func, valuetypid, linear, interpoint);
 
+	TRACE_MOBILITYDB_SYNC_DONE(result == NULL ? 0 : temporal_stat_instants(result),
+		result == NULL ? 0 : VARSIZE(result));
 	return result;
 }
 
@@ -2429,7 +2338,9 @@ sync_tfunc4_temporal_temporal(Temporal *temp1, Temporal *temp2,
  * Version for 2 arguments.
  *****************************************************************************/
 
-/* This function is called when at least one segment has linear interpolation */
+/* This function is called when at least one segment has linear interpolation.
+ * The intermediate values computed by this function are not freed since
+ * they are allocated in the arena of the calling function */
 static int
 sync_tfunc2_temporalseq_temporalseq_cross1(TemporalSeq **result,
 	TemporalInst *start1, TemporalInst *end1, bool linear1,
@@ -2437,6 +2348,7 @@ sync_tfunc2_temporalseq_temporalseq_cross1(TemporalSeq **result,
 	bool lower_inc, bool upper_inc,
 	Datum (*func)(Datum, Datum), Oid valuetypid)
 {
+	MOBDB_STAT_INC(sync_segments);
 	Datum startvalue1 = temporalinst_value(start1);
 	Datum endvalue1 = temporalinst_value(end1);
 	Datum startvalue2 = temporalinst_value(start2);
@@ -2455,8 +2367,6 @@ sync_tfunc2_temporalseq_temporalseq_cross1(TemporalSeq **result,
 		/* Result has stepwise interpolation */
 		result[0] = temporalseq_from_temporalinstarr(instants, 2, 
 			lower_inc, upper_inc, false, false);
-		pfree(instants[0]); pfree(instants[1]);
-		FREE_DATUM(startresult, valuetypid); 
 		return 1;
 	}
 
@@ -2474,8 +2384,6 @@ sync_tfunc2_temporalseq_temporalseq_cross1(TemporalSeq **result,
 			/* Result has stepwise interpolation */
 			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
 				true, true, false, false);
-			pfree(instants[0]);
-			FREE_DATUM(startresult, valuetypid);
 		}
 		/* Find the middle time between start and the end instant and compute
 		 * the function at that point */
@@ -2488,10 +2396,6 @@ sync_tfunc2_temporalseq_temporalseq_cross1(TemporalSeq **result,
 		/* Result has stepwise interpolation */
 		result[k++] = temporalseq_from_temporalinstarr(instants, 2,
 			false, false, false, false);			
-		pfree(instants[0]); pfree(instants[1]);
-		FREE_DATUM(value1, start1->valuetypid);
-		FREE_DATUM(value2, start1->valuetypid);
-		FREE_DATUM(intresult, valuetypid); 
 		/* Compute the function at the end instant */
 		if (upper_inc)
 		{
@@ -2500,14 +2404,12 @@ sync_tfunc2_temporalseq_temporalseq_cross1(TemporalSeq **result,
 			/* Result has stepwise interpolation */
 			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
 				true, true, false, false);
-			pfree(instants[0]);
-			FREE_DATUM(endresult, valuetypid); 
 		}
-		FREE_DATUM(startresult, valuetypid); 
 		return k;
 	}
 
 	/* Determine whether there is a crossing */
+	MOBDB_STAT_INC(crossings);
 	TimestampTz crosstime;
 	bool hascross;
 	if (! linear1)
@@ -2530,7 +2432,6 @@ sync_tfunc2_temporalseq_temporalseq_cross1(TemporalSeq **result,
 		/* Result has stepwise interpolation */
 		result[k++] = temporalseq_from_temporalinstarr(instants, 2,
 			lower_inc, false, false, false);
-		pfree(instants[0]); pfree(instants[1]); 
 		if (upper_inc)
 		{
 			Datum endresult = func(endvalue1, endvalue2);
@@ -2538,10 +2439,7 @@ sync_tfunc2_temporalseq_temporalseq_cross1(TemporalSeq **result,
 			/* Result has stepwise interpolation */
 			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
 				true, true, false, false);
-			pfree(instants[0]);
-			FREE_DATUM(endresult, valuetypid); 
 		}
-		FREE_DATUM(startresult, valuetypid); 
 		return k;
 	}
 
@@ -2551,7 +2449,6 @@ sync_tfunc2_temporalseq_temporalseq_cross1(TemporalSeq **result,
 	/* Result has stepwise interpolation */
 	result[0] = temporalseq_from_temporalinstarr(instants, 2,
 		lower_inc, false, false, false);		
-	pfree(instants[0]); pfree(instants[1]);
 	/* Find the values at the local minimum/maximum */
 	Datum cross1 = temporalseq_value_at_timestamp1(start1, end1, linear1, crosstime);
 	Datum cross2 = temporalseq_value_at_timestamp1(start2, end2, linear2, crosstime);
@@ -2560,18 +2457,12 @@ sync_tfunc2_temporalseq_temporalseq_cross1(TemporalSeq **result,
 	/* Result has stepwise interpolation */
 	result[1] = temporalseq_from_temporalinstarr(instants, 1,
 		true, true, false, false);
-	pfree(instants[0]); 
 	Datum endresult = func(endvalue1, endvalue2);
 	instants[0] = temporalinst_make(endresult, crosstime, valuetypid);
 	instants[1] = temporalinst_make(endresult, end1->t, valuetypid);
 	/* Result has stepwise interpolation */
 	result[2] = temporalseq_from_temporalinstarr(instants, 2,
 		false, upper_inc, false, false);
-	pfree(instants[0]); pfree(instants[1]);
-	FREE_DATUM(startresult, valuetypid); FREE_DATUM(endresult, valuetypid);
-	FREE_DATUM(cross1, start1->valuetypid); 
-	FREE_DATUM(cross2, start1->valuetypid);
-	FREE_DATUM(cross, valuetypid); 
 	return 3;
 }
 
@@ -2596,28 +2487,21 @@ sync_tfunc2_temporalseq_temporalseq_cross2(TemporalSeq **result, TemporalSeq *se
 		/* Result has stepwise interpolation */
 		result[0] = temporalseq_from_temporalinstarr(&inst, 1, true, true, 
 			false, false);
-		FREE_DATUM(startresult, seq1->valuetypid);
-		FREE_DATUM(value2, seq2->valuetypid);
-		FREE_DATUM(value, valuetypid); pfree(inst); pfree(inter);
 		return 1;
 	}
 
 	/* General case */
-	TemporalInst **tofree = palloc(sizeof(TemporalInst *) * 
-		(seq1->count + seq2->count) * 2);
 	TemporalInst *start1 = temporalseq_inst_n(seq1, 0);
 	TemporalInst *start2 = temporalseq_inst_n(seq2, 0);
-	int i = 1, j = 1, k = 0, l = 0;
+	int i = 1, j = 1, k = 0;
 	if (timestamp_cmp_internal(start1->t, inter->lower) < 0)
 	{
 		start1 = temporalseq_at_timestamp(seq1, inter->lower);
-		tofree[l++] = start1;
 		i = temporalseq_find_timestamp(seq1, inter->lower) + 1;
 	}
 	else if (timestamp_cmp_internal(start2->t, inter->lower) < 0)
 	{
 		start2 = temporalseq_at_timestamp(seq2, inter->lower);
-		tofree[l++] = start2;
 		j = temporalseq_find_timestamp(seq2, inter->lower) + 1;
 	}
 	bool lower_inc = inter->lower_inc;
@@ -2635,14 +2519,12 @@ sync_tfunc2_temporalseq_temporalseq_cross2(TemporalSeq **result, TemporalSeq *se
 			i++;
 			end2 = temporalseq_at_timestamp1(start2, end2,
 				MOBDB_FLAGS_GET_LINEAR(seq2->flags), end1->t);
-			tofree[l++] = end2;
 		}
 		else
 		{
 			j++;
 			end1 = temporalseq_at_timestamp1(start1, end1,
 				MOBDB_FLAGS_GET_LINEAR(seq1->flags), end2->t);
-			tofree[l++] = end1;
 		}
 		bool upper_inc = (timestamp_cmp_internal(end1->t, inter->upper) == 0) ? 
 			inter->upper_inc : false;
@@ -2655,7 +2537,6 @@ sync_tfunc2_temporalseq_temporalseq_cross2(TemporalSeq **result, TemporalSeq *se
 		start2 = end2;
 		lower_inc = true;
 	}
-	pfree(inter);
 	return k;
 }
 
@@ -2663,18 +2544,23 @@ TemporalS *
 sync_tfunc2_temporalseq_temporalseq_cross(TemporalSeq *seq1, TemporalSeq *seq2, 
 	Datum (*func)(Datum, Datum), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(seq1->count + seq2->count) * 3);
 	int count = sync_tfunc2_temporalseq_temporalseq_cross2(sequences,
 		seq1, seq2, func, valuetypid); 
 	if (count == 0)
+	{
+		MemoryContextSwitchTo(oldctx);
+		temporal_arena_delete(arena);
 		return NULL;
+	}
+	MemoryContextSwitchTo(oldctx);
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
 		false, true);
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	temporal_arena_delete(arena);
 	return result;
 }
 
@@ -2686,6 +2572,8 @@ TemporalS *
 sync_tfunc2_temporals_temporalseq_cross(TemporalS *ts, TemporalSeq *seq, 
 	Datum (*func)(Datum, Datum), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(ts->totalcount + seq->count) * 3);
 	int k = 0;
@@ -2697,16 +2585,15 @@ sync_tfunc2_temporals_temporalseq_cross(TemporalS *ts, TemporalSeq *seq,
 	}
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextSwitchTo(oldctx);
+		temporal_arena_delete(arena);
 		return NULL;
 	}
+	MemoryContextSwitchTo(oldctx);
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		false, true);
-
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	temporal_arena_delete(arena);
 	
 	return result;
 }
@@ -2722,6 +2609,8 @@ TemporalS *
 sync_tfunc2_temporals_temporals_cross(TemporalS *ts1, TemporalS *ts2, 
 	Datum (*func)(Datum, Datum), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(ts1->totalcount + ts2->totalcount) * 3);
 	int i = 0, j = 0, k = 0;
@@ -2742,16 +2631,15 @@ sync_tfunc2_temporals_temporals_cross(TemporalS *ts1, TemporalS *ts2,
 	}
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextSwitchTo(oldctx);
+		temporal_arena_delete(arena);
 		return NULL;
 	}
+	MemoryContextSwitchTo(oldctx);
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		false, true);
-
-	for (i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	temporal_arena_delete(arena);
 	
 	return result;
 }
@@ -2766,6 +2654,10 @@ sync_tfunc2_temporal_temporal_cross(Temporal *temp1, Temporal *temp2,
 	Temporal *result = NULL;
 	ensure_valid_duration(temp1->duration);
 	ensure_valid_duration(temp2->duration);
+	MOBDB_STAT_INSTANTS(temp1);
+	MOBDB_STAT_INSTANTS(temp2);
+	TRACE_MOBILITYDB_SYNC_START(temporal_stat_instants(temp1),
+		temporal_stat_instants(temp2));
 	if (temp1->duration == TEMPORALINST && temp2->duration == TEMPORALINST) 
 		result = (Temporal *)sync_tfunc2_temporalinst_temporalinst(
 			(TemporalInst *)temp1, (TemporalInst *)temp2, func, valuetypid);
@@ -2818,6 +2710,8 @@ sync_tfunc2_temporal_temporal_cross(Temporal *temp1, Temporal *temp2,
 		result = (Temporal *)sync_tfunc2_temporals_temporals_cross(
 			(TemporalS *)temp1, (TemporalS *)temp2, func, valuetypid);
 
+	TRACE_MOBILITYDB_SYNC_DONE(result == NULL ? 0 : temporal_stat_instants(result),
+		result == NULL ? 0 : VARSIZE(result));
 	return result;
 }
 
@@ -2825,7 +2719,9 @@ sync_tfunc2_temporal_temporal_cross(Temporal *temp1, Temporal *temp2,
  * TemporalSeq and <Type>
  *****************************************************************************/
 
-/* This function is called when at least one segment has linear interpolation */
+/* This function is called when at least one segment has linear interpolation.
+ * The intermediate values computed by this function are not freed since
+ * they are allocated in the arena of the calling function */
 static int
 sync_tfunc3_temporalseq_temporalseq_cross1(TemporalSeq **result,
 	TemporalInst *start1, TemporalInst *end1, bool linear1,
@@ -2833,6 +2729,7 @@ sync_tfunc3_temporalseq_temporalseq_cross1(TemporalSeq **result,
 	bool lower_inc, bool upper_inc, Datum param,
 	Datum (*func)(Datum, Datum, Datum), Oid valuetypid)
 {
+	MOBDB_STAT_INC(sync_segments);
 	Datum startvalue1 = temporalinst_value(start1);
 	Datum endvalue1 = temporalinst_value(end1);
 	Datum startvalue2 = temporalinst_value(start2);
@@ -2851,8 +2748,6 @@ sync_tfunc3_temporalseq_temporalseq_cross1(TemporalSeq **result,
 		/* Result has stepwise interpolation */
 		result[0] = temporalseq_from_temporalinstarr(instants, 2, 
 			lower_inc, upper_inc, false, false);
-		pfree(instants[0]); pfree(instants[1]);
-		FREE_DATUM(startresult, valuetypid); 
 		return 1;
 	}
 
@@ -2870,8 +2765,6 @@ sync_tfunc3_temporalseq_temporalseq_cross1(TemporalSeq **result,
 			/* Result has stepwise interpolation */
 			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
 				true, true, false, false);
-			pfree(instants[0]);
-			FREE_DATUM(startresult, valuetypid);
 		}
 		/* Find the middle time between start and the end instant and compute
 		 * the function at that point */
@@ -2884,9 +2777,6 @@ sync_tfunc3_temporalseq_temporalseq_cross1(TemporalSeq **result,
 		/* Result has stepwise interpolation */
 		result[k++] = temporalseq_from_temporalinstarr(instants, 2,
 			false, false, false, false);			
-		pfree(instants[0]); pfree(instants[1]);
-		FREE_DATUM(value1, start1->valuetypid); FREE_DATUM(value2, start1->valuetypid);
-		FREE_DATUM(intresult, valuetypid); 
 		/* Compute the function at the end instant */
 		if (upper_inc)
 		{
@@ -2895,14 +2785,12 @@ sync_tfunc3_temporalseq_temporalseq_cross1(TemporalSeq **result,
 			/* Result has stepwise interpolation */
 			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
 				true, true, false, false);
-			pfree(instants[0]);
-			FREE_DATUM(endresult, valuetypid); 
 		}
-		FREE_DATUM(startresult, valuetypid); 
 		return k;
 	}
 
 	/* Determine whether there is a crossing */
+	MOBDB_STAT_INC(crossings);
 	TimestampTz crosstime;
 	bool hascross;
 	if (! linear1)
@@ -2926,7 +2814,6 @@ sync_tfunc3_temporalseq_temporalseq_cross1(TemporalSeq **result,
 		/* Result has stepwise interpolation */
 		result[k++] = temporalseq_from_temporalinstarr(instants, 2,
 			lower_inc, false, false, false);
-		pfree(instants[0]); pfree(instants[1]); 
 		/* Compute the function at the end instant if inclusive upper bound */
 		if (upper_inc)
 		{
@@ -2935,10 +2822,7 @@ sync_tfunc3_temporalseq_temporalseq_cross1(TemporalSeq **result,
 			/* Result has stepwise interpolation */
 			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
 				true, true, false, false);
-			pfree(instants[0]);
-			FREE_DATUM(endresult, valuetypid); 
 		}
-		FREE_DATUM(startresult, valuetypid); 
 		return k;
 	}
 
@@ -2948,7 +2832,6 @@ sync_tfunc3_temporalseq_temporalseq_cross1(TemporalSeq **result,
 	/* Result has stepwise interpolation */
 	result[0] = temporalseq_from_temporalinstarr(instants, 2,
 		lower_inc, false, false, false);		
-	pfree(instants[0]); pfree(instants[1]);
 	/* Find the values at the local minimum/maximum */
 	Datum cross1 = temporalseq_value_at_timestamp1(start1, end1, linear1, crosstime);
 	Datum cross2 = temporalseq_value_at_timestamp1(start2, end2, linear2, crosstime);
@@ -2957,18 +2840,12 @@ sync_tfunc3_temporalseq_temporalseq_cross1(TemporalSeq **result,
 	/* Result has stepwise interpolation */
 	result[1] = temporalseq_from_temporalinstarr(instants, 1,
 		true, true, false, false);
-	pfree(instants[0]); 
 	Datum endresult = func(endvalue1, endvalue2, param);
 	instants[0] = temporalinst_make(endresult, crosstime, valuetypid);
 	instants[1] = temporalinst_make(endresult, end1->t, valuetypid);
 	/* Result has stepwise interpolation */
 	result[2] = temporalseq_from_temporalinstarr(instants, 2,
 		false, upper_inc, false, false);
-	pfree(instants[0]); pfree(instants[1]);
-	FREE_DATUM(startresult, valuetypid); FREE_DATUM(endresult, valuetypid); 
-	FREE_DATUM(cross1, start1->valuetypid); 
-	FREE_DATUM(cross2, start1->valuetypid); 
-	FREE_DATUM(cross, valuetypid); 
 	return 3;
 }
 
@@ -2994,27 +2871,21 @@ sync_tfunc3_temporalseq_temporalseq_cross2(TemporalSeq **result,
 		/* Result has stepwise interpolation */
 		result[0] = temporalseq_from_temporalinstarr(&inst, 1, true, true,
 			false, false);
-		FREE_DATUM(value1, seq1->valuetypid); FREE_DATUM(value2, seq2->valuetypid);
-		FREE_DATUM(value, valuetypid); pfree(inst); pfree(inter);
 		return 1;
 	}
 
 	/* General case */
-	TemporalInst **tofree = palloc(sizeof(TemporalInst *) * 
-		(seq1->count + seq2->count) * 2);
 	TemporalInst *start1 = temporalseq_inst_n(seq1, 0);
 	TemporalInst *start2 = temporalseq_inst_n(seq2, 0);
-	int i = 1, j = 1, k = 0, l = 0;
+	int i = 1, j = 1, k = 0;
 	if (timestamp_cmp_internal(start1->t, inter->lower) < 0)
 	{
 		start1 = temporalseq_at_timestamp(seq1, inter->lower);
-		tofree[l++] = start1;
 		i = temporalseq_find_timestamp(seq1, inter->lower) + 1;
 	}
 	else if (timestamp_cmp_internal(start2->t, inter->lower) < 0)
 	{
 		start2 = temporalseq_at_timestamp(seq2, inter->lower);
-		tofree[l++] = start2;
 		j = temporalseq_find_timestamp(seq2, inter->lower) + 1;
 	}
 	bool lower_inc = inter->lower_inc;
@@ -3032,14 +2903,12 @@ sync_tfunc3_temporalseq_temporalseq_cross2(TemporalSeq **result,
 			i++;
 			end2 = temporalseq_at_timestamp1(start2, end2,
 				MOBDB_FLAGS_GET_LINEAR(seq2->flags), end1->t);
-			tofree[l++] = end2;
 		}
 		else
 		{
 			j++;
 			end1 = temporalseq_at_timestamp1(start1, end1,
 				MOBDB_FLAGS_GET_LINEAR(seq1->flags), end2->t);
-			tofree[l++] = end1;
 		}
 		bool upper_inc = (timestamp_cmp_internal(end1->t, inter->upper) == 0) ? 
 			inter->upper_inc : false;
@@ -3052,7 +2921,6 @@ sync_tfunc3_temporalseq_temporalseq_cross2(TemporalSeq **result,
 		start2 = end2;
 		lower_inc = true;
 	}
-	pfree(inter);
 	return k;
 }
 
@@ -3061,19 +2929,24 @@ TemporalS *
 sync_tfunc3_temporalseq_temporalseq_cross(TemporalSeq *seq1, TemporalSeq *seq2, 
 	Datum param, Datum (*func)(Datum, Datum, Datum), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(seq1->count + seq2->count) * 3);
 	int count = sync_tfunc3_temporalseq_temporalseq_cross2(sequences,
 		seq1, seq2, param, func, valuetypid); 
 	if (count == 0)
+	{
+		MemoryContextSwitchTo(oldctx);
+		temporal_arena_delete(arena);
 		return NULL;
+	}
+	MemoryContextSwitchTo(oldctx);
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
 		false, true);
 		
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	temporal_arena_delete(arena);
 	return result;
 }
 
@@ -3085,6 +2958,8 @@ TemporalS *
 sync_tfunc3_temporals_temporalseq_cross(TemporalS *ts, TemporalSeq *seq, 
 	Datum param, Datum (*func)(Datum, Datum, Datum), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(ts->totalcount + seq->count) * 3);
 	int k = 0;
@@ -3096,16 +2971,15 @@ sync_tfunc3_temporals_temporalseq_cross(TemporalS *ts, TemporalSeq *seq,
 	}
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextSwitchTo(oldctx);
+		temporal_arena_delete(arena);
 		return NULL;
 	}
+	MemoryContextSwitchTo(oldctx);
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		false, true);
-
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	temporal_arena_delete(arena);
 	
 	return result;
 }
@@ -3130,6 +3004,8 @@ sync_tfunc3_temporals_temporals_cross(TemporalS *ts1, TemporalS *ts2,
 		return NULL;
 	
 	/* General case */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) *
 		(ts1->totalcount + ts2->totalcount) * 3);
 	int i = 0, j = 0, k = 0;
@@ -3150,16 +3026,15 @@ sync_tfunc3_temporals_temporals_cross(TemporalS *ts1, TemporalS *ts2,
 	}
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextSwitchTo(oldctx);
+		temporal_arena_delete(arena);
 		return NULL;
 	}
+	MemoryContextSwitchTo(oldctx);
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		false, true);
-
-	for (i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	temporal_arena_delete(arena);
 	
 	return result;
 }
@@ -3175,6 +3050,10 @@ sync_tfunc3_temporal_temporal_cross(Temporal *temp1, Temporal *temp2,
 	Temporal *result = NULL;
 	ensure_valid_duration(temp1->duration);
 	ensure_valid_duration(temp2->duration);
+	MOBDB_STAT_INSTANTS(temp1);
+	MOBDB_STAT_INSTANTS(temp2);
+	TRACE_MOBILITYDB_SYNC_START(temporal_stat_instants(temp1),
+		temporal_stat_instants(temp2));
 	if (temp1->duration == TEMPORALINST && temp2->duration == TEMPORALINST) 
 		result = (Temporal *)sync_tfunc3_temporalinst_temporalinst(
 			(TemporalInst *)temp1, (TemporalInst *)temp2, param, func, valuetypid);
@@ -3227,6 +3106,8 @@ sync_tfunc3_temporal_temporal_cross(Temporal *temp1, Temporal *temp2,
 		result = (Temporal *)sync_tfunc3_temporals_temporals_cross(
 				(TemporalS *)temp1, (TemporalS *)temp2, param, func, valuetypid);
 
+	TRACE_MOBILITYDB_SYNC_DONE(result == NULL ? 0 : temporal_stat_instants(result),
+		result == NULL ? 0 : VARSIZE(result));
 	return result;
 }
 
@@ -3234,7 +3115,9 @@ sync_tfunc3_temporal_temporal_cross(Temporal *temp1, Temporal *temp2,
  * TemporalSeq and <Type>
  *****************************************************************************/
 
-/* This function is called when at least one segment has linear interpolation */
+/* This function is called when at least one segment has linear interpolation.
+ * The intermediate values computed by this function are not freed since
+ * they are allocated in the arena of the calling function */
 static int
 sync_tfunc4_temporalseq_temporalseq_cross1(TemporalSeq **result,
 	TemporalInst *start1, TemporalInst *end1, bool linear1,
@@ -3242,6 +3125,7 @@ sync_tfunc4_temporalseq_temporalseq_cross1(TemporalSeq **result,
 	bool lower_inc, bool upper_inc,
 	Datum (*func)(Datum, Datum, Oid, Oid), Oid valuetypid)
 {
+	MOBDB_STAT_INC(sync_segments);
 	Datum startvalue1 = temporalinst_value(start1);
 	Datum endvalue1 = temporalinst_value(end1);
 	Datum startvalue2 = temporalinst_value(start2);
@@ -3261,8 +3145,6 @@ sync_tfunc4_temporalseq_temporalseq_cross1(TemporalSeq **result,
 		/* Result has stepwise interpolation */
 		result[0] = temporalseq_from_temporalinstarr(instants, 2, 
 			lower_inc, upper_inc, false, false);
-		pfree(instants[0]); pfree(instants[1]);
-		FREE_DATUM(startresult, valuetypid); 
 		return 1;
 	}
 
@@ -3280,8 +3162,6 @@ sync_tfunc4_temporalseq_temporalseq_cross1(TemporalSeq **result,
 			/* Result has stepwise interpolation */
 			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
 				true, true, false, false);
-			pfree(instants[0]);
-			FREE_DATUM(startresult, valuetypid);
 		}
 		/* Find the middle time between start and the end instant and compute
 		 * the function at that point */
@@ -3295,10 +3175,6 @@ sync_tfunc4_temporalseq_temporalseq_cross1(TemporalSeq **result,
 		/* Result has stepwise interpolation */
 		result[k++] = temporalseq_from_temporalinstarr(instants, 2,
 			false, false, false, false);			
-		pfree(instants[0]); pfree(instants[1]);
-		FREE_DATUM(value1, start1->valuetypid); 
-		FREE_DATUM(value2, start1->valuetypid);
-		FREE_DATUM(intresult, valuetypid); 
 		/* Compute the function at the end instant */
 		if (upper_inc)
 		{
@@ -3308,14 +3184,12 @@ sync_tfunc4_temporalseq_temporalseq_cross1(TemporalSeq **result,
 			/* Result has stepwise interpolation */
 			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
 				true, true, false, false);
-			pfree(instants[0]);
-			FREE_DATUM(endresult, valuetypid); 
 		}
-		FREE_DATUM(startresult, valuetypid); 
 		return k;
 	}
 
 	/* Determine whether there is a crossing */
+	MOBDB_STAT_INC(crossings);
 	TimestampTz crosstime;
 	bool hascross;
 	if (! linear1)
@@ -3338,7 +3212,6 @@ sync_tfunc4_temporalseq_temporalseq_cross1(TemporalSeq **result,
 		/* Result has stepwise interpolation */
 		result[k++] = temporalseq_from_temporalinstarr(instants, 2,
 			lower_inc, false, false, false);
-		pfree(instants[0]); pfree(instants[1]); 
 		if (upper_inc)
 		{
 			Datum endresult = func(endvalue1, endvalue2, 
@@ -3347,10 +3220,7 @@ sync_tfunc4_temporalseq_temporalseq_cross1(TemporalSeq **result,
 			/* Result has stepwise interpolation */
 			result[k++] = temporalseq_from_temporalinstarr(instants, 1,
 				true, true, false, false);
-			pfree(instants[0]);
-			FREE_DATUM(endresult, valuetypid); 
 		}
-		FREE_DATUM(startresult, valuetypid); 
 		return k;
 	}
 
@@ -3360,7 +3230,6 @@ sync_tfunc4_temporalseq_temporalseq_cross1(TemporalSeq **result,
 	/* Result has stepwise interpolation */
 	result[0] = temporalseq_from_temporalinstarr(instants, 2,
 		lower_inc, false, false, false);		
-	pfree(instants[0]); pfree(instants[1]);
 	/* Find the values at the local minimum/maximum */
 	Datum cross1 = temporalseq_value_at_timestamp1(start1, end1, linear1, crosstime);
 	Datum cross2 = temporalseq_value_at_timestamp1(start2, end2, linear2, crosstime);
@@ -3369,7 +3238,6 @@ sync_tfunc4_temporalseq_temporalseq_cross1(TemporalSeq **result,
 	/* Result has stepwise interpolation */
 	result[1] = temporalseq_from_temporalinstarr(instants, 1,
 		true, true, false, false);
-	pfree(instants[0]); 
 	Datum endresult = func(endvalue1, endvalue2, end1->valuetypid, 
 		end2->valuetypid);
 	instants[0] = temporalinst_make(endresult, crosstime, valuetypid);
@@ -3377,11 +3245,6 @@ sync_tfunc4_temporalseq_temporalseq_cross1(TemporalSeq **result,
 	/* Result has stepwise interpolation */
 	result[2] = temporalseq_from_temporalinstarr(instants, 2,
 		false, upper_inc, false, false);
-	pfree(instants[0]); pfree(instants[1]);
-	FREE_DATUM(startresult, valuetypid); FREE_DATUM(endresult, valuetypid); 
-	FREE_DATUM(cross1, start1->valuetypid); 
-	FREE_DATUM(cross2, start1->valuetypid); 
-	FREE_DATUM(cross, valuetypid); 
 	return 3;
 }
 
@@ -3407,28 +3270,21 @@ sync_tfunc4_temporalseq_temporalseq_cross2(TemporalSeq **result,
 		/* Result has stepwise interpolation */
 		result[0] = temporalseq_from_temporalinstarr(&inst, 1, true, true, 
 			false, false);
-		FREE_DATUM(value1, seq1->valuetypid); 
-		FREE_DATUM(value2, seq2->valuetypid);
-		FREE_DATUM(value, valuetypid); pfree(inst); pfree(inter);
 		return 1;
 	}
 
 	/* General case */
-	TemporalInst **tofree = palloc(sizeof(TemporalInst *) * 
-		(seq1->count + seq2->count) * 2);
 	TemporalInst *start1 = temporalseq_inst_n(seq1, 0);
 	TemporalInst *start2 = temporalseq_inst_n(seq2, 0);
-	int i = 1, j = 1, k = 0, l = 0;
+	int i = 1, j = 1, k = 0;
 	if (timestamp_cmp_internal(start1->t, inter->lower) < 0)
 	{
 		start1 = temporalseq_at_timestamp(seq1, inter->lower);
-		tofree[l++] = start1;
 		i = temporalseq_find_timestamp(seq1, inter->lower) + 1;
 	}
 	else if (timestamp_cmp_internal(start2->t, inter->lower) < 0)
 	{
 		start2 = temporalseq_at_timestamp(seq2, inter->lower);
-		tofree[l++] = start2;
 		j = temporalseq_find_timestamp(seq2, inter->lower) + 1;
 	}
 	bool lower_inc = inter->lower_inc;
@@ -3446,14 +3302,12 @@ sync_tfunc4_temporalseq_temporalseq_cross2(TemporalSeq **result,
 			i++;
 			end2 = temporalseq_at_timestamp1(start2, end2, 
 				MOBDB_FLAGS_GET_LINEAR(seq2->flags), end1->t);
-			tofree[l++] = end2;
 		}
 		else
 		{
 			j++;
 			end1 = temporalseq_at_timestamp1(start1, end1,
 				MOBDB_FLAGS_GET_LINEAR(seq1->flags), end2->t);
-			tofree[l++] = end1;
 		}
 		bool upper_inc = (timestamp_cmp_internal(end1->t, inter->upper) == 0) ? 
 			inter->upper_inc : false;
@@ -3466,7 +3320,6 @@ sync_tfunc4_temporalseq_temporalseq_cross2(TemporalSeq **result,
 		start2 = end2;
 		lower_inc = true;
 	}
-	pfree(inter);
 	return k;
 }
 
@@ -3474,19 +3327,24 @@ TemporalS *
 sync_tfunc4_temporalseq_temporalseq_cross(TemporalSeq *seq1, TemporalSeq *seq2, 
 	Datum (*func)(Datum, Datum, Oid, Oid), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
 		(seq1->count + seq2->count) * 3);
 	int count = sync_tfunc4_temporalseq_temporalseq_cross2(sequences,
 		seq1, seq2, func, valuetypid);
 	if (count == 0)
+	{
+		MemoryContextSwitchTo(oldctx);
+		temporal_arena_delete(arena);
 		return NULL;
+	}
+	MemoryContextSwitchTo(oldctx);
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
 		false, true);
 		
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	temporal_arena_delete(arena);
 	return result;
 }
 
@@ -3498,6 +3356,8 @@ TemporalS *
 sync_tfunc4_temporals_temporalseq_cross(TemporalS *ts, TemporalSeq *seq, 
 	Datum (*func)(Datum, Datum, Oid, Oid), Oid valuetypid)
 {
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) *
 		(ts->totalcount + seq->count) * 3);
 	int k = 0;
@@ -3509,16 +3369,15 @@ sync_tfunc4_temporals_temporalseq_cross(TemporalS *ts, TemporalSeq *seq,
 	}
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextSwitchTo(oldctx);
+		temporal_arena_delete(arena);
 		return NULL;
 	}
+	MemoryContextSwitchTo(oldctx);
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		false, true);
-
-	for (int i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	temporal_arena_delete(arena);
 	
 	return result;
 }
@@ -3542,6 +3401,8 @@ sync_tfunc4_temporals_temporals_cross(TemporalS *ts1, TemporalS *ts2,
 		return NULL;
 	
 	/* General case */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) *
 		(ts1->totalcount + ts2->totalcount) * 3);
 	int i = 0, j = 0, k = 0;
@@ -3562,16 +3423,15 @@ sync_tfunc4_temporals_temporals_cross(TemporalS *ts1, TemporalS *ts2,
 	}
 	if (k == 0)
 	{
-		pfree(sequences);
+		MemoryContextSwitchTo(oldctx);
+		temporal_arena_delete(arena);
 		return NULL;
 	}
+	MemoryContextSwitchTo(oldctx);
 	/* Result has stepwise interpolation */
 	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
 		false, true);
-
-	for (i = 0; i < k; i++)
-		pfree(sequences[i]);
-	pfree(sequences); 
+	temporal_arena_delete(arena);
 	
 	return result;
 }
@@ -3588,6 +3448,10 @@ sync_tfunc4_temporal_temporal_cross(Temporal *temp1, Temporal *temp2,
 	Temporal *result = NULL;
 	ensure_valid_duration(temp1->duration);
 	ensure_valid_duration(temp2->duration);
+	MOBDB_STAT_INSTANTS(temp1);
+	MOBDB_STAT_INSTANTS(temp2);
+	TRACE_MOBILITYDB_SYNC_START(temporal_stat_instants(temp1),
+		temporal_stat_instants(temp2));
 	if (temp1->duration == TEMPORALINST && temp2->duration == TEMPORALINST) 
 		result = (Temporal *)sync_tfunc4_temporalinst_temporalinst(
 			(TemporalInst *)temp1, (TemporalInst *)temp2, func, valuetypid);
@@ -3652,6 +3516,8 @@ sync_tfunc4_temporal_temporal_cross(Temporal *temp1, Temporal *temp2,
 			(Temporal *)sync_tfunc4_temporals_temporals(
 				(TemporalS *)temp1, (TemporalS *)temp2, func, valuetypid, linear, false);
 
+	TRACE_MOBILITYDB_SYNC_DONE(result == NULL ? 0 : temporal_stat_instants(result),
+		result == NULL ? 0 : VARSIZE(result));
 	return result;
 }
 
@@ -15,13 +15,21 @@
 #include <access/heapam.h>
 #include <access/htup_details.h>
 #include <catalog/namespace.h>
+#include <funcapi.h>
+#include <miscadmin.h>
+#include <storage/ipc.h>
+#include <storage/lwlock.h>
+#include <storage/shmem.h>
+#include <utils/hsearch.h>
+#include <utils/inval.h>
 #include <utils/rel.h>
+#include <utils/syscache.h>
 
 #include "temporaltypes.h"
 
 /*****************************************************************************
- * Global arrays for caching the OIDs in order to avoid (slow) lookups.
- * These arrays are initialized at the loading of the extension
+ * Names of the types and the operators whose OIDs are cached in order to 
+ * avoid (slow) lookups
  *****************************************************************************/
 
 const char *_type_names[] = 
@@ -93,54 +101,118 @@ const char *_op_names[] =
 
 /*****************************************************************************
  * Functions for the Oid cache
+ *
+ * The cache is populated lazily, one entry at a time, the first time the
+ * entry is requested. When the extension is loaded through 
+ * shared_preload_libraries, the operator Oids computed by a backend are also
+ * stored in a hash table in shared memory, so that new backends do not need
+ * to look them up again in the catalog.
+ *
+ * Operators that are not found are not cached, so that they are found once
+ * they are created, e.g., by a CREATE EXTENSION postgis after the lookup.
+ * The cache of the backend is also cleared when a type or an operator is
+ * dropped or altered.
  *****************************************************************************/
 
+#define NUM_CACHED_TYPES (sizeof(_type_names) / sizeof(char *))
+#define NUM_CACHED_OPS (sizeof(_op_names) / sizeof(char *))
+
+/* Maximum number of operators kept in shared memory */
+#define OIDCACHE_SHMEM_SIZE 16384
+
 /* Global variables */
 
-bool _ready = false;
-Oid _type_oids[sizeof(_type_names) / sizeof(char *)];
-Oid _op_oids[sizeof(_op_names) / sizeof(char *)]
-	[sizeof(_type_names) / sizeof(char *)]
-	[sizeof(_type_names) / sizeof(char *)];
+Oid _type_oids[NUM_CACHED_TYPES];
+Oid _op_oids[NUM_CACHED_OPS][NUM_CACHED_TYPES][NUM_CACHED_TYPES];
+bool _op_cached[NUM_CACHED_OPS][NUM_CACHED_TYPES][NUM_CACHED_TYPES];
 
-/* Fetch in the cache the oid of a type */
+/* Statistics reported by the oidcache_stats function */
+static int64 _oidcache_hits = 0;
+static int64 _oidcache_shared_hits = 0;
+static int64 _oidcache_misses = 0;
 
-Oid 
-type_oid(CachedType t) 
+/*
+ * Entry of the shared hash table. The entries are identified by the Oids 
+ * of the database and the argument types, not by their number in the 
+ * cache, so that the entries of a dropped and recreated extension or of
+ * another database are never confused.
+ */
+typedef struct
 {
-	if (!_ready)
-		populate_oidcache();
-	return _type_oids[t];
+	Oid dbid;
+	int32 op;
+	Oid ltypid;
+	Oid rtypid;
+} OidCacheKey;
+
+typedef struct
+{
+	OidCacheKey key;
+	Oid oproid;
+} OidCacheEntry;
+
+static HTAB *_oidcache_shared = NULL;
+static LWLock *_oidcache_lock = NULL;
+static shmem_startup_hook_type prev_shmem_startup_hook = NULL;
+
+/* Create the shared hash table when the shared memory is initialized */
+
+static void
+oidcache_shmem_startup(void)
+{
+	if (prev_shmem_startup_hook)
+		prev_shmem_startup_hook();
+
+	HASHCTL info;
+	memset(&info, 0, sizeof(info));
+	info.keysize = sizeof(OidCacheKey);
+	info.entrysize = sizeof(OidCacheEntry);
+	LWLockAcquire(AddinShmemInitLock, LW_EXCLUSIVE);
+	_oidcache_shared = ShmemInitHash("MobilityDB oid cache",
+		OIDCACHE_SHMEM_SIZE, OIDCACHE_SHMEM_SIZE, &info, 
+		HASH_ELEM | HASH_BLOBS);
+	_oidcache_lock = &(GetNamedLWLockTranche("mobilitydb_oidcache"))->lock;
+	LWLockRelease(AddinShmemInitLock);
 }
 
-/* Fetch in the cache the oid of an operator */
+/* Clear the cache of the backend on the invalidation of a type or operator */
 
-Oid 
-oper_oid(CachedOp op, CachedType lt, CachedType rt)
+static void
+oidcache_invalidate(Datum arg, int cacheid, uint32 hashvalue)
 {
-	if (!_ready)
-		populate_oidcache();
-	return _op_oids[op][lt][rt];
+	memset(_type_oids, 0, sizeof(_type_oids));
+	memset(_op_cached, 0, sizeof(_op_cached));
 }
 
-/* Populate the oid cache */
+/* 
+ * Register the invalidation of the oid cache and request its shared memory.
+ * The shared memory is only possible when the library is loaded through
+ * shared_preload_libraries, otherwise each backend keeps its own cache.
+ */
 
-static void 
-populate_types()
+void
+oidcache_init(void)
 {
-	int n = sizeof(_type_names) / sizeof(char *);
-	for (int i = 0; i < n; i++)
-	{
-		_type_oids[i] = TypenameGetTypid(_type_names[i]);
-		if (!_type_oids[i])
-			ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-					errmsg("No Oid for type %s", _type_names[i])));
-	}
+	CacheRegisterSyscacheCallback(TYPEOID, oidcache_invalidate, (Datum) 0);
+	CacheRegisterSyscacheCallback(OPEROID, oidcache_invalidate, (Datum) 0);
+	if (!process_shared_preload_libraries_in_progress)
+		return;
+	RequestAddinShmemSpace(hash_estimate_size(OIDCACHE_SHMEM_SIZE,
+		sizeof(OidCacheEntry)));
+	RequestNamedLWLockTranche("mobilitydb_oidcache", 1);
+	prev_shmem_startup_hook = shmem_startup_hook;
+	shmem_startup_hook = oidcache_shmem_startup;
 }
 
-void 
-populate_oidcache() 
+/* 
+ * Look up the oid of a type or of an operator in the catalog. The extension
+ * is assumed to be installed in the public schema.
+ */
+
+static Oid
+lookup_oid(const char *opname, Oid ltypid, Oid rtypid, const char *typname)
 {
+	Oid result = InvalidOid;
 	Oid namespaceId = LookupNamespaceNoError("public") ;
 	OverrideSearchPath* overridePath = GetOverrideSearchPath(CurrentMemoryContext);
 	overridePath->schemas = lcons_oid(namespaceId, overridePath->schemas);
@@ -148,33 +220,14 @@ populate_oidcache()
 
 	PG_TRY();
 	{
-
-		populate_types();
-		bzero(_op_oids, sizeof(_op_oids));
-
-		/*
-		 * This fetches the pre-computed operator cache from the catalog where
-		 * it is stored in a table. See the fill_opcache function below.
-		 */
-		Oid catalog = RelnameGetRelid("pg_temporal_opcache");
-		Relation rel = heap_open(catalog, AccessShareLock);
-		TupleDesc tupDesc = rel->rd_att;
-		ScanKeyData scandata;
-		HeapScanDesc scan = heap_beginscan_catalog(rel, 0, &scandata);
-		HeapTuple tuple = heap_getnext(scan, ForwardScanDirection);
-		while (HeapTupleIsValid(tuple))
+		if (opname == NULL)
+			result = TypenameGetTypid(typname);
+		else
 		{
-			bool isnull = false;
-			int32 i = DatumGetInt32(heap_getattr(tuple, 1, tupDesc, &isnull));
-			int32 j = DatumGetInt32(heap_getattr(tuple, 2, tupDesc, &isnull));
-			int32 k = DatumGetInt32(heap_getattr(tuple, 3, tupDesc, &isnull));
-			_op_oids[i][j][k] = DatumGetObjectId(heap_getattr(tuple, 4, tupDesc, &isnull));
-			tuple = heap_getnext(scan, ForwardScanDirection);
+			List* lst = list_make1(makeString((char *) opname));
+			result = OpernameGetOprid(lst, ltypid, rtypid);
+			list_free(lst);
 		}
-		heap_endscan(scan);
-		heap_close(rel, AccessShareLock);
-		_ready = true;
-
 		PopOverrideSearchPath() ;
 	}
 	PG_CATCH();
@@ -183,6 +236,113 @@ populate_oidcache()
 		PG_RE_THROW();
 	}
 	PG_END_TRY();
+	return result;
+}
+
+/* Fetch in the cache the oid of a type */
+
+Oid 
+type_oid(CachedType t) 
+{
+	if (_type_oids[t])
+	{
+		_oidcache_hits++;
+		return _type_oids[t];
+	}
+	_oidcache_misses++;
+	Oid result = lookup_oid(NULL, InvalidOid, InvalidOid, _type_names[t]);
+	if (!result)
+		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+				errmsg("No Oid for type %s", _type_names[t])));
+	_type_oids[t] = result;
+	return result;
+}
+
+/* Fetch in the cache the oid of an operator */
+
+Oid 
+oper_oid(CachedOp op, CachedType lt, CachedType rt)
+{
+	if (_op_cached[op][lt][rt])
+	{
+		_oidcache_hits++;
+		return _op_oids[op][lt][rt];
+	}
+
+	OidCacheKey key;
+	memset(&key, 0, sizeof(key));
+	key.dbid = MyDatabaseId;
+	key.op = op;
+	key.ltypid = type_oid(lt);
+	key.rtypid = type_oid(rt);
+	Oid result = InvalidOid;
+	bool found = false;
+	if (_oidcache_shared)
+	{
+		LWLockAcquire(_oidcache_lock, LW_SHARED);
+		OidCacheEntry *entry = hash_search(_oidcache_shared, &key, HASH_FIND, 
+			&found);
+		if (found)
+			result = entry->oproid;
+		LWLockRelease(_oidcache_lock);
+	}
+	if (found)
+		_oidcache_shared_hits++;
+	else
+	{
+		_oidcache_misses++;
+		result = lookup_oid(_op_names[op], key.ltypid, key.rtypid, NULL);
+		if (result == InvalidOid)
+			return result;
+		if (_oidcache_shared)
+		{
+			LWLockAcquire(_oidcache_lock, LW_EXCLUSIVE);
+			/* The entry is not cached when the shared hash table is full */
+			OidCacheEntry *entry = hash_search(_oidcache_shared, &key, 
+				HASH_ENTER_NULL, &found);
+			if (entry != NULL)
+				entry->oproid = result;
+			LWLockRelease(_oidcache_lock);
+		}
+	}
+	_op_oids[op][lt][rt] = result;
+	_op_cached[op][lt][rt] = true;
+	return result;
+}
+
+/* Populate the oid cache */
+
+static void 
+populate_types()
+{
+	for (int i = 0; i < (int) NUM_CACHED_TYPES; i++)
+		type_oid(i);
+}
+
+/*
+ * Report the number of lookups answered by the cache of the backend, by the
+ * shared cache, and by the catalog since the start of the backend
+ */
+PG_FUNCTION_INFO_V1(oidcache_stats);
+
+PGDLLEXPORT Datum 
+oidcache_stats(PG_FUNCTION_ARGS) 
+{
+	TupleDesc tupdesc;
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("function returning record called in context "
+				"that cannot accept type record")));
+	tupdesc = BlessTupleDesc(tupdesc);
+
+	bool isnull[] = {false, false, false, false};
+	Datum values[4];
+	values[0] = Int64GetDatum(_oidcache_hits);
+	values[1] = Int64GetDatum(_oidcache_shared_hits);
+	values[2] = Int64GetDatum(_oidcache_misses);
+	values[3] = BoolGetDatum(_oidcache_shared != NULL);
+	HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
+	PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
 }
 
 /*
@@ -202,8 +362,8 @@ fill_opcache(PG_FUNCTION_ARGS)
 	Datum data[] = {0, 0, 0, 0};
 
 	populate_types();
-	int32 m = sizeof(_op_names) / sizeof(char *);
-	int32 n = sizeof(_type_names) / sizeof(char *);
+	int32 m = NUM_CACHED_OPS;
+	int32 n = NUM_CACHED_TYPES;
 	for (int32 i = 0; i < m; i++)
 	{
 		List* lst = list_make1(makeString((char *) _op_names[i]));
@@ -93,39 +93,17 @@ period_deserialize(Period *p, PeriodBound *lower, PeriodBound *upper)
  * There is only one case where two boundaries compare equal but are not
  * identical: when both bounds are inclusive and hold the same value,
  * but one is an upper bound and the other a lower bound.
+ *
+ * These cases are encoded in the rank of the canonical representation of
+ * the bounds, so that the comparison does not branch on the flags.
  */
 
 int
 period_cmp_bounds(TimestampTz t1, TimestampTz t2, bool lower1, bool lower2, 
 	bool inclusive1, bool inclusive2)
 {
-	int32		result;
-
-	/* Compare the values */
-	result = timestamp_cmp_internal(t1, t2);
-
-	/*
-	 * If the comparison is not equal and the bounds are both inclusive or 
-	 * both exclusive, we're done. If they compare equal, we still have to 
-	 * consider whether the boundaries are inclusive or exclusive. 
-	*/
-	if (result == 0)
-	{
-		if (!inclusive1 && !inclusive2)
-		{
-			/* both are exclusive */
-			if (lower1 == lower2)
-				return 0;
-			else
-				return lower1 ? 1 : -1;
-		}
-		else if (!inclusive1)
-			return lower1 ? 1 : -1;
-		else if (!inclusive2)
-			return lower2 ? -1 : 1;
-	}	
-	
-	return result;
+	return period_cmp_bound_ranks(t1, PERIOD_BOUND_RANK(lower1, inclusive1),
+		t2, PERIOD_BOUND_RANK(lower2, inclusive2));
 }
 
 /*
@@ -337,6 +315,29 @@ period_super_union(Period *p1, Period *p2)
 	return period_make(result_lower, result_upper, 
 		result_lower_inc, result_upper_inc);
 }
+
+/*
+ * Batched overlaps predicate between an array of periods and a period. If
+ * result is not NULL, the value of the predicate for the i-th period is set
+ * in result[i]. The function returns the number of periods that overlap the
+ * period. The loop does not branch on the periods, so that the predicate is
+ * evaluated on all of them, e.g., on the keys of an index page.
+ */
+
+int
+periodarr_overlaps_period(const Period *periods, int count, const Period *p,
+	bool *result)
+{
+	int n = 0;
+	for (int i = 0; i < count; i++)
+	{
+		bool overlaps = period_overlaps_period(&periods[i], p);
+		if (result != NULL)
+			result[i] = overlaps;
+		n += overlaps;
+	}
+	return n;
+}
  
 /*****************************************************************************
  * Input/output functions
@@ -705,6 +706,31 @@ period_cmp(PG_FUNCTION_ARGS)
 	PG_RETURN_INT32(period_cmp_internal(p1, p2));	
 }
 
+/* Sortsupport comparator, which avoids the function call overhead */
+static int
+period_fastcmp(Datum x, Datum y, SortSupport ssup)
+{
+	return period_cmp_internal(DatumGetPeriod(x), DatumGetPeriod(y));
+}
+
+/* The abbreviated key is the lower bound, compared first by period_cmp */
+static Datum
+period_abbrev_convert(Datum original, SortSupport ssup)
+{
+	return timestamp_abbrev_key(DatumGetPeriod(original)->lower);
+}
+
+PG_FUNCTION_INFO_V1(period_sortsupport);
+
+PGDLLEXPORT Datum
+period_sortsupport(PG_FUNCTION_ARGS)
+{
+	SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+	ssup->comparator = period_fastcmp;
+	sortsupport_set_abbrev(ssup, period_abbrev_convert);
+	PG_RETURN_VOID();
+}
+
 /* inequality operators using the period_cmp function */
 bool
 period_lt_internal(Period *p1, Period *p2)
@@ -30,33 +30,26 @@
 /* 
  * The memory structure of a PeriodSet with, e.g., 3 periods is as follows
  *
- *  --------------------------------------------------------------------
- *	( PeriodSet | offset_0 | offset_1 | offset_2 | offset_3 | )_X | ...
  *	--------------------------------------------------------------------
+ *	( PeriodSet )_X | Period_0 | Period_1 | Period_2 | bbox |
  *	--------------------------------------------------------------------
- *	(( Period_0 )_Y | ( Period_1 )_Y | ( Period_2 )_Y | ( bbox )_Y )_X |
- *	--------------------------------------------------------------------
  *
- * where the X are unused bytes added for double padding, the Y are unused bytes 
- * added for int4 padding, offset_0 to offset_2 are offsets for the corresponding 
- * periods, and offset_3 is the offset for the bounding box which is a Period.
+ * where the X are unused bytes added for double padding and bbox is the
+ * bounding box which is a Period. Since the periods have a fixed size, they
+ * are stored in a packed array that can be accessed directly.
+ *
+ * The first on-disk format kept instead an array of offsets to the periods
+ * and to the bounding box after the header. Such values are recognized
+ * because the TIME_PACKED flag is not set, since the first offset is always
+ * zero, and they are converted to the packed format when they are read.
  */
- 
-/* Pointer to array of offsets of the PeriodSet */
-
-static size_t *
-periodset_offsets_ptr(PeriodSet *ps)
-{
-	return (size_t *) (((char *)ps) + sizeof(PeriodSet));
-}
 
 /* Pointer to the first period */
 
-static char * 
-periodset_data_ptr(PeriodSet *ps)
+static Period *
+periodset_periods_ptr(PeriodSet *ps)
 {
-	return (char *)ps + double_pad(sizeof(PeriodSet) + 
-		sizeof(size_t) * (ps->count + 1));
+	return (Period *) ((char *)ps + double_pad(sizeof(PeriodSet)));
 }
 
 /* N-th Period of a PeriodSet */
@@ -64,8 +57,7 @@ periodset_data_ptr(PeriodSet *ps)
 Period *
 periodset_per_n(PeriodSet *ps, int index)
 {
-	size_t *offsets = periodset_offsets_ptr(ps);
-	return (Period *) (periodset_data_ptr(ps) + offsets[index]);
+	return &periodset_periods_ptr(ps)[index];
 }
 
 /* Bounding box of a PeriodSet */
@@ -73,9 +65,7 @@ periodset_per_n(PeriodSet *ps, int index)
 Period *
 periodset_bbox(PeriodSet *ps) 
 {
-	size_t *offsets = periodset_offsets_ptr(ps);
-	assert(offsets[ps->count] != 0);
-	return (Period *)(periodset_data_ptr(ps) + offsets[ps->count]);
+	return &periodset_periods_ptr(ps)[ps->count];
 }
 
 /* Construct a PeriodSet from an array of Period */
@@ -83,7 +73,6 @@ periodset_bbox(PeriodSet *ps)
 PeriodSet *
 periodset_from_periodarr_internal(Period **periods, int count, bool normalize)
 {
-	Period bbox;
 	/* Test the validity of the periods */
 	for (int i = 0; i < count - 1; i++)
 	{
@@ -98,27 +87,20 @@ periodset_from_periodarr_internal(Period **periods, int count, bool normalize)
 	int newcount = count;
 	if (normalize && count > 1)
 		newperiods = periodarr_normalize(periods, count, &newcount);
-	size_t memsize = double_pad(sizeof(Period)) * (newcount + 1);
-	/* Array of pointers containing the pointers to the component Period,
-	   and a pointer to the bbox */
-	size_t pdata = double_pad(sizeof(PeriodSet) + (newcount + 1) * sizeof(size_t));
-	PeriodSet *result = palloc0(pdata + memsize);
-	SET_VARSIZE(result, pdata + memsize);
+	size_t pdata = double_pad(sizeof(PeriodSet));
+	size_t memsize = pdata + sizeof(Period) * (newcount + 1);
+	PeriodSet *result = palloc0(memsize);
+	SET_VARSIZE(result, memsize);
 	result->count = newcount;
+	result->flags = TIME_PACKED;
 
-	size_t *offsets = periodset_offsets_ptr(result);
-	size_t pos = 0;	
+	Period *resperiods = periodset_periods_ptr(result);
 	for (int i = 0; i < newcount; i++)
-	{
-		memcpy(((char *) result) + pdata + pos, newperiods[i], sizeof(Period));
-		offsets[i] = pos;
-		pos += double_pad(sizeof(Period));
-	}
+		resperiods[i] = *newperiods[i];
 	/* Precompute the bounding box */
-	period_set(&bbox, newperiods[0]->lower, newperiods[newcount - 1]->upper,
-		newperiods[0]->lower_inc, newperiods[newcount - 1]->upper_inc);
-	offsets[newcount] = pos;
-	memcpy(((char *) result) + pdata + pos, &bbox, sizeof(Period));
+	period_set(&resperiods[newcount], newperiods[0]->lower,
+		newperiods[newcount - 1]->upper, newperiods[0]->lower_inc,
+		newperiods[newcount - 1]->upper_inc);
 	/* Normalize */
 	if (normalize && count > 1)
 	{
@@ -129,6 +111,50 @@ periodset_from_periodarr_internal(Period **periods, int count, bool normalize)
 	return result;
 }
 
+/*
+ * Construct a PeriodSet from an array of ordered and normalized periods,
+ * such as those produced by merging two period sets. The periods are
+ * copied directly into the result without validity test or normalization.
+ */
+
+PeriodSet *
+periodset_from_periods_internal(const Period *periods, int count)
+{
+	size_t pdata = double_pad(sizeof(PeriodSet));
+	size_t memsize = pdata + sizeof(Period) * (count + 1);
+	PeriodSet *result = palloc0(memsize);
+	SET_VARSIZE(result, memsize);
+	result->count = count;
+	result->flags = TIME_PACKED;
+
+	Period *resperiods = periodset_periods_ptr(result);
+	memcpy(resperiods, periods, sizeof(Period) * count);
+	period_set(&resperiods[count], periods[0].lower, periods[count - 1].upper,
+		periods[0].lower_inc, periods[count - 1].upper_inc);
+	return result;
+}
+
+/*
+ * Returns the period set in the packed format, converting the values in the
+ * first on-disk format
+ */
+
+PeriodSet *
+periodset_packed(PeriodSet *ps)
+{
+	if (ps->flags & TIME_PACKED)
+		return ps;
+	size_t *offsets = (size_t *) (((char *)ps) + sizeof(int32) * 2);
+	char *data = (char *)ps + double_pad(sizeof(int32) * 2 +
+		sizeof(size_t) * (ps->count + 1));
+	Period *periods = palloc(sizeof(Period) * ps->count);
+	for (int i = 0; i < ps->count; i++)
+		memcpy(&periods[i], data + offsets[i], sizeof(Period));
+	PeriodSet *result = periodset_from_periods_internal(periods, ps->count);
+	pfree(periods);
+	return result;
+}
+
 PeriodSet *
 periodset_copy(PeriodSet *ps)
 {
@@ -745,6 +771,42 @@ periodset_cmp(PG_FUNCTION_ARGS)
 	PG_RETURN_INT32(cmp);
 }
 
+/* Sortsupport comparator, which avoids the function call overhead */
+static int
+periodset_fastcmp(Datum x, Datum y, SortSupport ssup)
+{
+	PeriodSet *ps1 = DatumGetPeriodSet(x);
+	PeriodSet *ps2 = DatumGetPeriodSet(y);
+	int cmp = periodset_cmp_internal(ps1, ps2);
+	if ((Pointer) ps1 != DatumGetPointer(x))
+		pfree(ps1);
+	if ((Pointer) ps2 != DatumGetPointer(y))
+		pfree(ps2);
+	return cmp;
+}
+
+/* The abbreviated key is the lower bound of the first period */
+static Datum
+periodset_abbrev_convert(Datum original, SortSupport ssup)
+{
+	PeriodSet *ps = DatumGetPeriodSet(original);
+	Datum result = timestamp_abbrev_key(periodset_per_n(ps, 0)->lower);
+	if ((Pointer) ps != DatumGetPointer(original))
+		pfree(ps);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(periodset_sortsupport);
+
+PGDLLEXPORT Datum
+periodset_sortsupport(PG_FUNCTION_ARGS)
+{
+	SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+	ssup->comparator = periodset_fastcmp;
+	sortsupport_set_abbrev(ssup, periodset_abbrev_convert);
+	PG_RETURN_VOID();
+}
+
 /* 
  * Equality operator
  * The internal B-tree comparator is not used to increase efficiency 
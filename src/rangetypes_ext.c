@@ -14,6 +14,7 @@
 
 #include <assert.h>
 #include <utils/builtins.h>
+#include <utils/datum.h>
 
 #include "temporal.h"
 #include "oidcache.h"
@@ -228,188 +229,356 @@ intrange_canonical(PG_FUNCTION_ARGS)
 	PG_RETURN_RANGE_P(range_serialize(typcache, &lower, &upper, false));
 }
 
-/*****************************************************************************/
+/*****************************************************************************
+ * Deserialized ranges
+ *****************************************************************************/
+
+/* Deserialize the range */
+
+void
+range_bounds_deserialize(RangeBounds *bounds, RangeType *r)
+{
+	bounds->typcache = lookup_type_cache(RangeTypeGetOid(r),
+		TYPECACHE_RANGE_INFO);
+	if (bounds->typcache->rngelemtype == NULL)
+		elog(ERROR, "type %u is not a range type", RangeTypeGetOid(r));
+	range_deserialize(bounds->typcache, r, &bounds->lower, &bounds->upper,
+		&bounds->empty);
+}
+
+/*
+ * Deserialize an array of ranges. The empty ranges are removed and the
+ * number of ranges kept is returned in count.
+ */
+
+RangeBounds *
+rangearr_bounds(RangeType **ranges, int *count)
+{
+	RangeBounds *result = palloc(sizeof(RangeBounds) * *count);
+	int k = 0;
+	for (int i = 0; i < *count; i++)
+	{
+		range_bounds_deserialize(&result[k], ranges[i]);
+		if (! result[k].empty)
+			k++;
+	}
+	*count = k;
+	return result;
+}
+
+/*
+ * Returns the position of the first range that is not strictly before the
+ * bound. The ranges are assumed to be normalized and nonempty, so that
+ * their upper bounds are increasing.
+ */
+
+int
+rangearr_bounds_find(const RangeBounds *normbounds, int count,
+	RangeBound *bound)
+{
+	int first = 0, last = count;
+	while (first < last)
+	{
+		int middle = (first + last) / 2;
+		RangeBound upper = normbounds[middle].upper;
+		if (range_cmp_bounds(normbounds[middle].typcache, &upper, bound) < 0)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	return first;
+}
+
+/* Does one of the normalized ranges contain the element? */
 
-/* strictly left of element? (internal version) */
 bool
-range_left_elem_internal(TypeCacheEntry *typcache, RangeType *r, Datum val)
+rangearr_bounds_contains_elem(const RangeBounds *normbounds, int count,
+	Datum val)
 {
-	RangeBound	lower,
-				upper;
-	bool		empty;
+	RangeBound bound;
+	bound.val = val;
+	bound.infinite = false;
+	bound.inclusive = true;
+	bound.lower = true;
+	int pos = rangearr_bounds_find(normbounds, count, &bound);
+	return pos < count && range_bounds_contains_elem(&normbounds[pos], val);
+}
+
+/*
+ * Get the deserialized bounds of the range argument of a function call.
+ * When the argument does not change across the calls of the expression,
+ * as is the case for a query constant, the range is deserialized only once
+ * and its bounds are kept in fn_extra, which is therefore not available
+ * for other purposes in the calling function.
+ */
+void
+range_bounds_fn(RangeBounds *bounds, FunctionCallInfo fcinfo, int argno)
+{
+	FmgrInfo *flinfo = fcinfo->flinfo;
+	if (flinfo == NULL)
+	{
+		range_bounds_deserialize(bounds, PG_GETARG_RANGE_P(argno));
+		return;
+	}
+
+	RangeBoundsCache *cache = (RangeBoundsCache *) flinfo->fn_extra;
+	if (cache == NULL)
+	{
+		cache = MemoryContextAllocZero(flinfo->fn_mcxt,
+			sizeof(RangeBoundsCache));
+		cache->stable = get_fn_expr_arg_stable(flinfo, argno);
+		flinfo->fn_extra = cache;
+	}
+	if (! cache->valid)
+	{
+		range_bounds_deserialize(bounds, PG_GETARG_RANGE_P(argno));
+		if (! cache->stable)
+			return;
+		/* Copy the bounds into the memory context of the function */
+		TypeCacheEntry *elemcache = bounds->typcache->rngelemtype;
+		MemoryContext oldcontext = MemoryContextSwitchTo(flinfo->fn_mcxt);
+		cache->bounds = *bounds;
+		if (! bounds->empty && ! bounds->lower.infinite)
+			cache->bounds.lower.val = datumCopy(bounds->lower.val,
+				elemcache->typbyval, elemcache->typlen);
+		if (! bounds->empty && ! bounds->upper.infinite)
+			cache->bounds.upper.val = datumCopy(bounds->upper.val,
+				elemcache->typbyval, elemcache->typlen);
+		MemoryContextSwitchTo(oldcontext);
+		cache->valid = true;
+	}
+	*bounds = cache->bounds;
+}
+
+/* Does the range contain the element? */
+
+bool
+range_bounds_contains_elem(const RangeBounds *bounds, Datum val)
+{
+	TypeCacheEntry *typcache = bounds->typcache;
 	int32		cmp;
 
-	range_deserialize(typcache, r, &lower, &upper, &empty);
+	if (bounds->empty)
+		return false;
+
+	if (!bounds->lower.infinite)
+	{
+		cmp = DatumGetInt32(FunctionCall2Coll(&typcache->rng_cmp_proc_finfo,
+											  typcache->rng_collation,
+											  bounds->lower.val, val));
+		if (cmp > 0 || (cmp == 0 && !bounds->lower.inclusive))
+			return false;
+	}
+
+	if (!bounds->upper.infinite)
+	{
+		cmp = DatumGetInt32(FunctionCall2Coll(&typcache->rng_cmp_proc_finfo,
+											  typcache->rng_collation,
+											  bounds->upper.val, val));
+		if (cmp < 0 || (cmp == 0 && !bounds->upper.inclusive))
+			return false;
+	}
+
+	return true;
+}
+
+/*****************************************************************************/
+
+/* strictly left of element? (deserialized version) */
+bool
+range_left_elem_bounds(const RangeBounds *bounds, Datum val)
+{
+	TypeCacheEntry *typcache = bounds->typcache;
+	int32		cmp;
 
 	/* An empty range is neither left nor right any other range */
-	if (empty)
+	if (bounds->empty)
 		return false;
 
-	if (!upper.infinite)
+	if (!bounds->upper.infinite)
 	{
 		cmp = DatumGetInt32(FunctionCall2Coll(&typcache->rng_cmp_proc_finfo,
 											  typcache->rng_collation,
-											  upper.val, val));
+											  bounds->upper.val, val));
 		if (cmp < 0 ||
-			(cmp == 0 && !upper.inclusive))
+			(cmp == 0 && !bounds->upper.inclusive))
 			return true;
 	}
 
 	return false;
 }
 
+/* strictly left of element? (internal version) */
+bool
+range_left_elem_internal(TypeCacheEntry *typcache, RangeType *r, Datum val)
+{
+	RangeBounds bounds;
+	bounds.typcache = typcache;
+	range_deserialize(typcache, r, &bounds.lower, &bounds.upper, &bounds.empty);
+	return range_left_elem_bounds(&bounds, val);
+}
+
 /* strictly left of element? */
 PG_FUNCTION_INFO_V1(range_left_elem);
 
 PGDLLEXPORT Datum
 range_left_elem(PG_FUNCTION_ARGS)
 {
-	RangeType  *r = PG_GETARG_RANGE_P(0);
 	Datum		val = PG_GETARG_DATUM(1);
-	TypeCacheEntry *typcache;
+	RangeBounds bounds;
 
-	typcache = range_get_typcache(fcinfo, RangeTypeGetOid(r));
+	range_bounds_fn(&bounds, fcinfo, 0);
 
-	PG_RETURN_BOOL(range_left_elem_internal(typcache, r, val));
+	PG_RETURN_BOOL(range_left_elem_bounds(&bounds, val));
 }
 
-/* does not extend to right of element? (internal version) */
+/* does not extend to right of element? (deserialized version) */
 bool
-range_overleft_elem_internal(TypeCacheEntry *typcache, RangeType *r, Datum val)
+range_overleft_elem_bounds(const RangeBounds *bounds, Datum val)
 {
-	RangeBound	lower,
-				upper;
-	bool		empty;
-
-	range_deserialize(typcache, r, &lower, &upper, &empty);
+	TypeCacheEntry *typcache = bounds->typcache;
 
 	/* An empty range is neither left nor right any element */
-	if (empty)
+	if (bounds->empty)
 		return false;
 
-	if (!upper.infinite)
+	if (!bounds->upper.infinite)
 	{
 		if (DatumGetInt32(FunctionCall2Coll(&typcache->rng_cmp_proc_finfo,
 											typcache->rng_collation,
-											upper.val, val)) <= 0)
+											bounds->upper.val, val)) <= 0)
 			return true;
 	}
 
 	return false;
 }
 
+/* does not extend to right of element? (internal version) */
+bool
+range_overleft_elem_internal(TypeCacheEntry *typcache, RangeType *r, Datum val)
+{
+	RangeBounds bounds;
+	bounds.typcache = typcache;
+	range_deserialize(typcache, r, &bounds.lower, &bounds.upper, &bounds.empty);
+	return range_overleft_elem_bounds(&bounds, val);
+}
+
 /* does not extend to right of element? */
 PG_FUNCTION_INFO_V1(range_overleft_elem);
 
 PGDLLEXPORT Datum
 range_overleft_elem(PG_FUNCTION_ARGS)
 {
-	RangeType  *r = PG_GETARG_RANGE_P(0);
 	Datum		val = PG_GETARG_DATUM(1);
-	TypeCacheEntry *typcache;
+	RangeBounds bounds;
 
-	typcache = range_get_typcache(fcinfo, RangeTypeGetOid(r));
+	range_bounds_fn(&bounds, fcinfo, 0);
 
-	PG_RETURN_BOOL(range_overleft_elem_internal(typcache, r, val));
+	PG_RETURN_BOOL(range_overleft_elem_bounds(&bounds, val));
 }
 
-/* strictly right of element? (internal version) */
+/* strictly right of element? (deserialized version) */
 bool
-range_right_elem_internal(TypeCacheEntry *typcache, RangeType *r, Datum val)
+range_right_elem_bounds(const RangeBounds *bounds, Datum val)
 {
-	RangeBound	lower,
-				upper;
-	bool		empty;
+	TypeCacheEntry *typcache = bounds->typcache;
 	int32		cmp;
 
-	range_deserialize(typcache, r, &lower, &upper, &empty);
-
 	/* An empty range is neither left nor right any other range */
-	if (empty)
+	if (bounds->empty)
 		return false;
 
-	if (!lower.infinite)
+	if (!bounds->lower.infinite)
 	{
 		cmp = DatumGetInt32(FunctionCall2Coll(&typcache->rng_cmp_proc_finfo,
 											  typcache->rng_collation,
-											  lower.val, val));
+											  bounds->lower.val, val));
 		if (cmp > 0 ||
-			(cmp == 0 && !lower.inclusive))
+			(cmp == 0 && !bounds->lower.inclusive))
 			return true;
 	}
 
 	return false;
 }
 
+/* strictly right of element? (internal version) */
+bool
+range_right_elem_internal(TypeCacheEntry *typcache, RangeType *r, Datum val)
+{
+	RangeBounds bounds;
+	bounds.typcache = typcache;
+	range_deserialize(typcache, r, &bounds.lower, &bounds.upper, &bounds.empty);
+	return range_right_elem_bounds(&bounds, val);
+}
+
 /* strictly right of element? */
 PG_FUNCTION_INFO_V1(range_right_elem);
 
 PGDLLEXPORT Datum
 range_right_elem(PG_FUNCTION_ARGS)
 {
-	RangeType  *r = PG_GETARG_RANGE_P(0);
 	Datum		val = PG_GETARG_DATUM(1);
-	TypeCacheEntry *typcache;
+	RangeBounds bounds;
 
-	typcache = range_get_typcache(fcinfo, RangeTypeGetOid(r));
+	range_bounds_fn(&bounds, fcinfo, 0);
 
-	PG_RETURN_BOOL(range_right_elem_internal(typcache, r, val));
+	PG_RETURN_BOOL(range_right_elem_bounds(&bounds, val));
 }
 
-/* does not extend to left of element? (internal version) */
+/* does not extend to left of element? (deserialized version) */
 bool
-range_overright_elem_internal(TypeCacheEntry *typcache, RangeType *r, Datum val)
+range_overright_elem_bounds(const RangeBounds *bounds, Datum val)
 {
-	RangeBound	lower,
-				upper;
-	bool		empty;
-
-	range_deserialize(typcache, r, &lower, &upper, &empty);
+	TypeCacheEntry *typcache = bounds->typcache;
 
 	/* An empty range is neither left nor right any element */
-	if (empty)
+	if (bounds->empty)
 		return false;
 
-	if (!lower.infinite)
+	if (!bounds->lower.infinite)
 	{
 		if (DatumGetInt32(FunctionCall2Coll(&typcache->rng_cmp_proc_finfo,
 											typcache->rng_collation,
-											lower.val, val)) >= 0)
+											bounds->lower.val, val)) >= 0)
 			return true;
 	}
 
 	return false;
 }
 
+/* does not extend to left of element? (internal version) */
+bool
+range_overright_elem_internal(TypeCacheEntry *typcache, RangeType *r, Datum val)
+{
+	RangeBounds bounds;
+	bounds.typcache = typcache;
+	range_deserialize(typcache, r, &bounds.lower, &bounds.upper, &bounds.empty);
+	return range_overright_elem_bounds(&bounds, val);
+}
+
 /* does not extend to left of element? */
 PG_FUNCTION_INFO_V1(range_overright_elem);
 
 Datum
 range_overright_elem(PG_FUNCTION_ARGS)
 {
-	RangeType  *r = PG_GETARG_RANGE_P(0);
 	Datum		val = PG_GETARG_DATUM(1);
-	TypeCacheEntry *typcache;
+	RangeBounds bounds;
 
-	typcache = range_get_typcache(fcinfo, RangeTypeGetOid(r));
+	range_bounds_fn(&bounds, fcinfo, 0);
 
-	PG_RETURN_BOOL(range_overright_elem_internal(typcache, r, val));
+	PG_RETURN_BOOL(range_overright_elem_bounds(&bounds, val));
 }
 
-/* adjacent to element (but not overlapping)? (internal version) */
+/* adjacent to element (but not overlapping)? (deserialized version) */
 bool
-range_adjacent_elem_internal(TypeCacheEntry *typcache, RangeType *r, Datum val)
+range_adjacent_elem_bounds(const RangeBounds *bounds, Datum val)
 {
-	RangeBound	lower,
-				upper;
-	bool		empty;
 	RangeBound 	elembound;
 	bool		isadj;
 
-	range_deserialize(typcache, r, &lower, &upper, &empty);
-
 	/* An empty range is not adjacent to any element */
-	if (empty)
+	if (bounds->empty)
 		return false;
 
 	/*
@@ -420,9 +589,20 @@ range_adjacent_elem_internal(TypeCacheEntry *typcache, RangeType *r, Datum val)
 	elembound.infinite = false;
 	elembound.inclusive = true;
 	elembound.lower = true;
-	isadj = bounds_adjacent(typcache, upper, elembound);
+	isadj = bounds_adjacent(bounds->typcache, bounds->upper, elembound);
 	elembound.lower = false;
-	return (isadj || bounds_adjacent(typcache, elembound, lower));
+	return (isadj || bounds_adjacent(bounds->typcache, elembound,
+		bounds->lower));
+}
+
+/* adjacent to element (but not overlapping)? (internal version) */
+bool
+range_adjacent_elem_internal(TypeCacheEntry *typcache, RangeType *r, Datum val)
+{
+	RangeBounds bounds;
+	bounds.typcache = typcache;
+	range_deserialize(typcache, r, &bounds.lower, &bounds.upper, &bounds.empty);
+	return range_adjacent_elem_bounds(&bounds, val);
 }
 
 /* adjacent to element (but not overlapping)? */
@@ -431,13 +611,12 @@ PG_FUNCTION_INFO_V1(range_adjacent_elem);
 PGDLLEXPORT Datum
 range_adjacent_elem(PG_FUNCTION_ARGS)
 {
-	RangeType  *r = PG_GETARG_RANGE_P(0);
 	Datum		val = PG_GETARG_DATUM(1);
-	TypeCacheEntry *typcache;
+	RangeBounds bounds;
 
-	typcache = range_get_typcache(fcinfo, RangeTypeGetOid(r));
+	range_bounds_fn(&bounds, fcinfo, 0);
 
-	PG_RETURN_BOOL(range_adjacent_elem_internal(typcache, r, val));
+	PG_RETURN_BOOL(range_adjacent_elem_bounds(&bounds, val));
 }
 
 /******************************************************************************/
@@ -449,39 +628,44 @@ PGDLLEXPORT Datum
 elem_left_range(PG_FUNCTION_ARGS)
 {
 	Datum		val = PG_GETARG_DATUM(0);
-	RangeType  *r = PG_GETARG_RANGE_P(1);
-	TypeCacheEntry *typcache;
+	RangeBounds bounds;
 
-	typcache = range_get_typcache(fcinfo, RangeTypeGetOid(r));
+	range_bounds_fn(&bounds, fcinfo, 1);
 
-	PG_RETURN_BOOL(range_right_elem_internal(typcache, r, val));
+	PG_RETURN_BOOL(range_right_elem_bounds(&bounds, val));
 }
 
-/* element does not extend to right of? (internal version) */
+/* element does not extend to right of? (deserialized version) */
 bool
-elem_overleft_range_internal(TypeCacheEntry *typcache, Datum val, RangeType *r)
+elem_overleft_range_bounds(Datum val, const RangeBounds *bounds)
 {
-	RangeBound	lower,
-				upper;
-	bool		empty;
-
-	range_deserialize(typcache, r, &lower, &upper, &empty);
+	TypeCacheEntry *typcache = bounds->typcache;
 
 	/* An empty range is neither left nor right any element */
-	if (empty)
+	if (bounds->empty)
 		return false;
 
-	if (!upper.infinite)
+	if (!bounds->upper.infinite)
 	{
 		if (DatumGetInt32(FunctionCall2Coll(&typcache->rng_cmp_proc_finfo,
 											typcache->rng_collation,
-											val, upper.val)) <= 0)
+											val, bounds->upper.val)) <= 0)
 			return true;
 	}
 
 	return false;
 }
 
+/* element does not extend to right of? (internal version) */
+bool
+elem_overleft_range_internal(TypeCacheEntry *typcache, Datum val, RangeType *r)
+{
+	RangeBounds bounds;
+	bounds.typcache = typcache;
+	range_deserialize(typcache, r, &bounds.lower, &bounds.upper, &bounds.empty);
+	return elem_overleft_range_bounds(val, &bounds);
+}
+
 /* element does not extend to right of? */
 PG_FUNCTION_INFO_V1(elem_overleft_range);
 
@@ -489,12 +673,11 @@ PGDLLEXPORT Datum
 elem_overleft_range(PG_FUNCTION_ARGS)
 {
 	Datum		val = PG_GETARG_DATUM(0);
-	RangeType  *r = PG_GETARG_RANGE_P(1);
-	TypeCacheEntry *typcache;
+	RangeBounds bounds;
 
-	typcache = range_get_typcache(fcinfo, RangeTypeGetOid(r));
+	range_bounds_fn(&bounds, fcinfo, 1);
 
-	PG_RETURN_BOOL(elem_overleft_range_internal(typcache, val, r));
+	PG_RETURN_BOOL(elem_overleft_range_bounds(val, &bounds));
 }
 
 /* element strictly right of? */
@@ -504,39 +687,44 @@ PGDLLEXPORT Datum
 elem_right_range(PG_FUNCTION_ARGS)
 {
 	Datum		val = PG_GETARG_DATUM(0);
-	RangeType  *r = PG_GETARG_RANGE_P(1);
-	TypeCacheEntry *typcache;
+	RangeBounds bounds;
 
-	typcache = range_get_typcache(fcinfo, RangeTypeGetOid(r));
+	range_bounds_fn(&bounds, fcinfo, 1);
 
-	PG_RETURN_BOOL(range_left_elem_internal(typcache, r, val));
+	PG_RETURN_BOOL(range_left_elem_bounds(&bounds, val));
 }
 
-/* element does not extend to left of? (internal version) */
+/* element does not extend to left of? (deserialized version) */
 bool
-elem_overright_range_internal(TypeCacheEntry *typcache, Datum val, RangeType *r)
+elem_overright_range_bounds(Datum val, const RangeBounds *bounds)
 {
-	RangeBound	lower,
-				upper;
-	bool		empty;
-
-	range_deserialize(typcache, r, &lower, &upper, &empty);
+	TypeCacheEntry *typcache = bounds->typcache;
 
 	/* An empty range is neither left nor right any element */
-	if (empty)
+	if (bounds->empty)
 		return false;
 
-	if (!lower.infinite)
+	if (!bounds->lower.infinite)
 	{
 		if (DatumGetInt32(FunctionCall2Coll(&typcache->rng_cmp_proc_finfo,
 											typcache->rng_collation,
-											val, lower.val)) >= 0)
+											val, bounds->lower.val)) >= 0)
 			return true;
 	}
 
 	return false;
 }
 
+/* element does not extend to left of? (internal version) */
+bool
+elem_overright_range_internal(TypeCacheEntry *typcache, Datum val, RangeType *r)
+{
+	RangeBounds bounds;
+	bounds.typcache = typcache;
+	range_deserialize(typcache, r, &bounds.lower, &bounds.upper, &bounds.empty);
+	return elem_overright_range_bounds(val, &bounds);
+}
+
 PG_FUNCTION_INFO_V1(elem_overright_range);
 
 /* element does not extend the left of? */
@@ -544,12 +732,11 @@ Datum
 elem_overright_range(PG_FUNCTION_ARGS)
 {
 	Datum		val = PG_GETARG_DATUM(0);
-	RangeType  *r = PG_GETARG_RANGE_P(1);
-	TypeCacheEntry *typcache;
+	RangeBounds bounds;
 
-	typcache = range_get_typcache(fcinfo, RangeTypeGetOid(r));
+	range_bounds_fn(&bounds, fcinfo, 1);
 
-	PG_RETURN_BOOL(elem_overright_range_internal(typcache, val, r));
+	PG_RETURN_BOOL(elem_overright_range_bounds(val, &bounds));
 }
 
 /* element adjacent to? */
@@ -559,12 +746,11 @@ PGDLLEXPORT Datum
 elem_adjacent_range(PG_FUNCTION_ARGS)
 {
 	Datum		val = PG_GETARG_DATUM(0);
-	RangeType  *r = PG_GETARG_RANGE_P(1);
-	TypeCacheEntry *typcache;
+	RangeBounds bounds;
 
-	typcache = range_get_typcache(fcinfo, RangeTypeGetOid(r));
+	range_bounds_fn(&bounds, fcinfo, 1);
 
-	PG_RETURN_BOOL(range_adjacent_elem_internal(typcache, r, val));
+	PG_RETURN_BOOL(range_adjacent_elem_bounds(&bounds, val));
 }
 
 /******************************************************************************/
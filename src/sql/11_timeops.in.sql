@@ -1460,4 +1460,70 @@ CREATE OPERATOR * (
 	COMMUTATOR = *
 );
 
+/*****************************************************************************
+ * Distance operators
+ * The distance is the number of seconds between the timestamp and the
+ * nearest timestamp of the time value
+ *****************************************************************************/
+
+CREATE FUNCTION distance(timestamptz, timestampset)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_timestamp_timestampset'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION distance(timestampset, timestamptz)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_timestampset_timestamp'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = timestamptz, RIGHTARG = timestampset,
+	COMMUTATOR = <->
+);
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = timestampset, RIGHTARG = timestamptz,
+	COMMUTATOR = <->
+);
+
+CREATE FUNCTION distance(timestamptz, period)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_timestamp_period'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION distance(period, timestamptz)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_period_timestamp'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = timestamptz, RIGHTARG = period,
+	COMMUTATOR = <->
+);
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = period, RIGHTARG = timestamptz,
+	COMMUTATOR = <->
+);
+
+CREATE FUNCTION distance(timestamptz, periodset)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_timestamp_periodset'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION distance(periodset, timestamptz)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_periodset_timestamp'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = timestamptz, RIGHTARG = periodset,
+	COMMUTATOR = <->
+);
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = periodset, RIGHTARG = timestamptz,
+	COMMUTATOR = <->
+);
+
 /*****************************************************************************/
@@ -38,6 +38,10 @@ CREATE FUNCTION gist_period_fetch(internal)
 	RETURNS internal
 	AS 'MODULE_PATHNAME'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; 
+CREATE FUNCTION gist_period_distance(internal, timestamptz, smallint, oid, internal)
+	RETURNS float8
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; 
 
 CREATE OPERATOR CLASS gist_timestampset_ops
 	DEFAULT FOR TYPE timestampset USING gist AS
@@ -53,6 +57,8 @@ CREATE OPERATOR CLASS gist_timestampset_ops
 	OPERATOR	8		<@ (timestampset, timestampset),
 	OPERATOR	8		<@ (timestampset, period),
 	OPERATOR	8		<@ (timestampset, periodset),
+	-- distance in time
+	OPERATOR	15		<-> (timestampset, timestamptz) FOR ORDER BY pg_catalog.float_ops,
 	-- overlaps or before
 	OPERATOR	28		&<# (timestampset, timestamptz),
 	OPERATOR	28		&<# (timestampset, timestampset),
@@ -79,7 +85,8 @@ CREATE OPERATOR CLASS gist_timestampset_ops
 	FUNCTION	3	gist_timestampset_compress(internal),
 	FUNCTION	5	gist_period_penalty(internal, internal, internal),
 	FUNCTION	6	gist_period_picksplit(internal, internal),
-	FUNCTION	7	gist_period_same(period, period, internal);
+	FUNCTION	7	gist_period_same(period, period, internal),
+	FUNCTION	8	gist_period_distance(internal, timestamptz, smallint, oid, internal);
 	
 /******************************************************************************/
 
@@ -107,6 +114,8 @@ CREATE OPERATOR CLASS gist_period_ops
 	-- contained by
 	OPERATOR	8		<@ (period, period),
 	OPERATOR	8		<@ (period, periodset),
+	-- distance in time
+	OPERATOR	15		<-> (period, timestamptz) FOR ORDER BY pg_catalog.float_ops,
 	-- overlaps or before
 	OPERATOR	28		&<# (period, timestamptz),
 	OPERATOR	28		&<# (period, timestampset),
@@ -134,6 +143,7 @@ CREATE OPERATOR CLASS gist_period_ops
 	FUNCTION	5	gist_period_penalty(internal, internal, internal),
 	FUNCTION	6	gist_period_picksplit(internal, internal),
 	FUNCTION	7	gist_period_same(period, period, internal),
+	FUNCTION	8	gist_period_distance(internal, timestamptz, smallint, oid, internal),
 	FUNCTION	9	gist_period_fetch(internal);
 	
 /******************************************************************************/
@@ -162,6 +172,8 @@ CREATE OPERATOR CLASS gist_periodset_ops
 	-- contained by
 	OPERATOR	8		<@ (periodset, period),
 	OPERATOR	8		<@ (periodset, periodset),
+	-- distance in time
+	OPERATOR	15		<-> (periodset, timestamptz) FOR ORDER BY pg_catalog.float_ops,
 	-- overlaps or before
 	OPERATOR	28		&<# (periodset, timestamptz),
 	OPERATOR	28		&<# (periodset, timestampset),
@@ -188,6 +200,85 @@ CREATE OPERATOR CLASS gist_periodset_ops
 	FUNCTION	3	gist_periodset_compress(internal),
 	FUNCTION	5	gist_period_penalty(internal, internal, internal),
 	FUNCTION	6	gist_period_picksplit(internal, internal),
-	FUNCTION	7	gist_period_same(period, period, internal);
+	FUNCTION	7	gist_period_same(period, period, internal),
+	FUNCTION	8	gist_period_distance(internal, timestamptz, smallint, oid, internal);
+
+/******************************************************************************/
+
+CREATE FUNCTION gist_periodset_multi_consistent(internal, periodset, smallint, oid, internal)
+	RETURNS bool
+	AS 'MODULE_PATHNAME', 'gist_periodset_multi_consistent'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_periodset_multi_union(internal, internal)
+	RETURNS periodset
+	AS 'MODULE_PATHNAME', 'gist_periodset_multi_union'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_periodset_multi_compress(internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_periodset_multi_compress'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_periodset_multi_penalty(internal, internal, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_periodset_multi_penalty'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_periodset_multi_picksplit(internal, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_periodset_multi_picksplit'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_periodset_multi_same(periodset, periodset, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_periodset_multi_same'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_periodset_multi_distance(internal, timestamptz, smallint, oid, internal)
+	RETURNS float8
+	AS 'MODULE_PATHNAME', 'gist_periodset_multi_distance'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+-- The keys are period sets with at most mobilitydb.gist_max_periods periods
+CREATE OPERATOR CLASS gist_periodset_multi_ops
+	FOR TYPE periodset USING gist AS
+	STORAGE periodset,
+	-- overlaps
+	OPERATOR	3		&& (periodset, timestampset),
+	OPERATOR	3		&& (periodset, period),
+	OPERATOR	3		&& (periodset, periodset),
+	-- contains
+	OPERATOR	7		@> (periodset, timestamptz),
+	OPERATOR	7		@> (periodset, timestampset),
+	OPERATOR	7		@> (periodset, period),
+	OPERATOR	7		@> (periodset, periodset),
+	-- contained by
+	OPERATOR	8		<@ (periodset, period),
+	OPERATOR	8		<@ (periodset, periodset),
+	-- distance in time
+	OPERATOR	15		<-> (periodset, timestamptz) FOR ORDER BY pg_catalog.float_ops,
+	-- overlaps or before
+	OPERATOR	28		&<# (periodset, timestamptz),
+	OPERATOR	28		&<# (periodset, timestampset),
+	OPERATOR	28		&<# (periodset, period),
+	OPERATOR	28		&<# (periodset, periodset),
+	-- strictly before
+	OPERATOR	29		<<# (periodset, timestamptz),
+	OPERATOR	29		<<# (periodset, timestampset),
+	OPERATOR	29		<<# (periodset, period),
+	OPERATOR	29		<<# (periodset, periodset),
+	-- strictly after
+	OPERATOR	30		#>> (periodset, timestamptz),
+	OPERATOR	30		#>> (periodset, timestampset),
+	OPERATOR	30		#>> (periodset, period),
+	OPERATOR	30		#>> (periodset, periodset),
+	-- overlaps or after
+	OPERATOR	31		#&> (periodset, timestamptz),
+	OPERATOR	31		#&> (periodset, timestampset),
+	OPERATOR	31		#&> (periodset, period),
+	OPERATOR	31		#&> (periodset, periodset),
+	-- functions
+	FUNCTION	1	gist_periodset_multi_consistent(internal, periodset, smallint, oid, internal),
+	FUNCTION	2	gist_periodset_multi_union(internal, internal),
+	FUNCTION	3	gist_periodset_multi_compress(internal),
+	FUNCTION	5	gist_periodset_multi_penalty(internal, internal, internal),
+	FUNCTION	6	gist_periodset_multi_picksplit(internal, internal),
+	FUNCTION	7	gist_periodset_multi_same(periodset, periodset, internal),
+	FUNCTION	8	gist_periodset_multi_distance(internal, timestamptz, smallint, oid, internal);
 
 /******************************************************************************/
@@ -254,6 +254,11 @@ CREATE FUNCTION tfloatseq(tfloat[], lower_inc boolean DEFAULT true,
 	RETURNS tfloat
 	AS 'MODULE_PATHNAME', 'temporalseq_constructor'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tfloatseq(float8[], timestamptz[], lower_inc boolean DEFAULT true, 
+	upper_inc boolean DEFAULT true, linear boolean DEFAULT true)
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'tfloatseq_from_arrays'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION ttextseq(ttext[], lower_inc boolean DEFAULT true, 
 	upper_inc boolean DEFAULT true)
 	RETURNS ttext
@@ -414,6 +419,69 @@ CREATE FUNCTION appendInstant(ttext, ttext)
 	AS 'MODULE_PATHNAME', 'temporal_append_instant'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION merge(tbool, tbool)
+	RETURNS tbool
+	AS 'MODULE_PATHNAME', 'temporal_merge'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION merge(tint, tint)
+	RETURNS tint
+	AS 'MODULE_PATHNAME', 'temporal_merge'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION merge(tfloat, tfloat)
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'temporal_merge'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION merge(ttext, ttext)
+	RETURNS ttext
+	AS 'MODULE_PATHNAME', 'temporal_merge'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION merge(tbool[])
+	RETURNS tbool
+	AS 'MODULE_PATHNAME', 'temporal_merge_array'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION merge(tint[])
+	RETURNS tint
+	AS 'MODULE_PATHNAME', 'temporal_merge_array'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION merge(tfloat[])
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'temporal_merge_array'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION merge(ttext[])
+	RETURNS ttext
+	AS 'MODULE_PATHNAME', 'temporal_merge_array'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/******************************************************************************
+ * Compression functions
+ ******************************************************************************/
+
+CREATE FUNCTION compress(tbool)
+	RETURNS tbool
+	AS 'MODULE_PATHNAME', 'temporal_compress'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION compress(tint)
+	RETURNS tint
+	AS 'MODULE_PATHNAME', 'temporal_compress'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION compress(tfloat)
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'temporal_compress'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION isCompressed(tbool)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'temporal_is_compressed'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION isCompressed(tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'temporal_is_compressed'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION isCompressed(tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'temporal_is_compressed'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /******************************************************************************
  * Accessor functions
  ******************************************************************************/
@@ -468,6 +536,34 @@ CREATE FUNCTION memSize(ttext)
 	RETURNS int
 	AS 'MODULE_PATHNAME', 'temporal_mem_size'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION memLayout(tbool, OUT total integer, OUT disk integer,
+		OUT compression float, OUT headers integer, OUT offsets integer,
+		OUT instant_headers integer, OUT timestamps integer,
+		OUT base_values integer, OUT bbox integer, OUT trajectory integer)
+	RETURNS record
+	AS 'MODULE_PATHNAME', 'temporal_mem_layout'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION memLayout(tint, OUT total integer, OUT disk integer,
+		OUT compression float, OUT headers integer, OUT offsets integer,
+		OUT instant_headers integer, OUT timestamps integer,
+		OUT base_values integer, OUT bbox integer, OUT trajectory integer)
+	RETURNS record
+	AS 'MODULE_PATHNAME', 'temporal_mem_layout'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION memLayout(tfloat, OUT total integer, OUT disk integer,
+		OUT compression float, OUT headers integer, OUT offsets integer,
+		OUT instant_headers integer, OUT timestamps integer,
+		OUT base_values integer, OUT bbox integer, OUT trajectory integer)
+	RETURNS record
+	AS 'MODULE_PATHNAME', 'temporal_mem_layout'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION memLayout(ttext, OUT total integer, OUT disk integer,
+		OUT compression float, OUT headers integer, OUT offsets integer,
+		OUT instant_headers integer, OUT timestamps integer,
+		OUT base_values integer, OUT bbox integer, OUT trajectory integer)
+	RETURNS record
+	AS 'MODULE_PATHNAME', 'temporal_mem_layout'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 -- values is a reserved word in SQL
 CREATE FUNCTION getValue(tbool)
@@ -899,6 +995,23 @@ CREATE FUNCTION shift(ttext, interval)
 	AS 'MODULE_PATHNAME', 'temporal_shift'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION tscale(tbool, interval)
+	RETURNS tbool
+	AS 'MODULE_PATHNAME', 'temporal_tscale'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tscale(tint, interval)
+	RETURNS tint
+	AS 'MODULE_PATHNAME', 'temporal_tscale'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tscale(tfloat, interval)
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'temporal_tscale'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tscale(ttext, interval)
+	RETURNS ttext
+	AS 'MODULE_PATHNAME', 'temporal_tscale'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 -------------------------------------------------------------------------------
 -- Restriction functions
 -------------------------------------------------------------------------------
@@ -1716,6 +1829,80 @@ CREATE FUNCTION intersectsPeriodSet(ttext, periodset)
 	AS 'MODULE_PATHNAME', 'temporal_intersects_periodset'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION distance(timestamptz, tbool)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_timestamp_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION distance(tbool, timestamptz)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_temporal_timestamp'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION distance(timestamptz, tint)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_timestamp_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION distance(tint, timestamptz)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_temporal_timestamp'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION distance(timestamptz, tfloat)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_timestamp_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION distance(tfloat, timestamptz)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_temporal_timestamp'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION distance(timestamptz, ttext)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_timestamp_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION distance(ttext, timestamptz)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'distance_temporal_timestamp'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = timestamptz, RIGHTARG = tbool,
+	COMMUTATOR = <->
+);
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = tbool, RIGHTARG = timestamptz,
+	COMMUTATOR = <->
+);
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = timestamptz, RIGHTARG = tint,
+	COMMUTATOR = <->
+);
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = tint, RIGHTARG = timestamptz,
+	COMMUTATOR = <->
+);
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = timestamptz, RIGHTARG = tfloat,
+	COMMUTATOR = <->
+);
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = tfloat, RIGHTARG = timestamptz,
+	COMMUTATOR = <->
+);
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = timestamptz, RIGHTARG = ttext,
+	COMMUTATOR = <->
+);
+CREATE OPERATOR <-> (
+	PROCEDURE = distance,
+	LEFTARG = ttext, RIGHTARG = timestamptz,
+	COMMUTATOR = <->
+);
+
 CREATE FUNCTION integral(tint)
 	RETURNS float
 	AS 'MODULE_PATHNAME', 'tnumber_integral'
@@ -1766,6 +1953,10 @@ CREATE FUNCTION tbool_cmp(tbool, tbool)
 	RETURNS integer
 	AS 'MODULE_PATHNAME', 'temporal_cmp'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION temporal_sortsupport(internal)
+	RETURNS void
+	AS 'MODULE_PATHNAME', 'temporal_sortsupport'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR < (
 	LEFTARG = tbool, RIGHTARG = tbool,
@@ -1817,7 +2008,8 @@ CREATE OPERATOR CLASS tbool_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	tbool_cmp(tbool, tbool);
+		FUNCTION	1	tbool_cmp(tbool, tbool),
+		FUNCTION	2	temporal_sortsupport(internal);
 
 /*****************************************************************************/
 
@@ -1900,7 +2092,8 @@ CREATE OPERATOR CLASS tint_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	tint_cmp(tint, tint);
+		FUNCTION	1	tint_cmp(tint, tint),
+		FUNCTION	2	temporal_sortsupport(internal);
 
 /*****************************************************************************/
 
@@ -1983,7 +2176,8 @@ CREATE OPERATOR CLASS tfloat_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	tfloat_cmp(tfloat, tfloat);
+		FUNCTION	1	tfloat_cmp(tfloat, tfloat),
+		FUNCTION	2	temporal_sortsupport(internal);
 		
 /******************************************************************************/
 
@@ -2066,7 +2260,8 @@ CREATE OPERATOR CLASS ttext_ops
 		OPERATOR	3	=,
 		OPERATOR	4	>=,
 		OPERATOR	5	>,
-		FUNCTION	1	ttext_cmp(ttext, ttext);
+		FUNCTION	1	ttext_cmp(ttext, ttext),
+		FUNCTION	2	temporal_sortsupport(internal);
 
 /******************************************************************************/
 
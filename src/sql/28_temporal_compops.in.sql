@@ -907,3 +907,609 @@ CREATE OPERATOR #>= (
 );
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Ever/always comparison of two temporal values
+ *****************************************************************************/
+
+CREATE FUNCTION ever_eq(tbool, tbool)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_eq_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_eq(tint, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_eq_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_eq(tint, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_eq_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_eq(tfloat, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_eq_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_eq(tfloat, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_eq_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_eq(ttext, ttext)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_eq_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR ?= (
+	PROCEDURE = ever_eq,
+	LEFTARG = tbool, RIGHTARG = tbool,
+	COMMUTATOR = ?=, NEGATOR = %<>
+);
+CREATE OPERATOR ?= (
+	PROCEDURE = ever_eq,
+	LEFTARG = tint, RIGHTARG = tint,
+	COMMUTATOR = ?=, NEGATOR = %<>
+);
+CREATE OPERATOR ?= (
+	PROCEDURE = ever_eq,
+	LEFTARG = tint, RIGHTARG = tfloat,
+	COMMUTATOR = ?=, NEGATOR = %<>
+);
+CREATE OPERATOR ?= (
+	PROCEDURE = ever_eq,
+	LEFTARG = tfloat, RIGHTARG = tint,
+	COMMUTATOR = ?=, NEGATOR = %<>
+);
+CREATE OPERATOR ?= (
+	PROCEDURE = ever_eq,
+	LEFTARG = tfloat, RIGHTARG = tfloat,
+	COMMUTATOR = ?=, NEGATOR = %<>
+);
+CREATE OPERATOR ?= (
+	PROCEDURE = ever_eq,
+	LEFTARG = ttext, RIGHTARG = ttext,
+	COMMUTATOR = ?=, NEGATOR = %<>
+);
+
+CREATE FUNCTION always_eq(tbool, tbool)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_eq_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_eq(tint, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_eq_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_eq(tint, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_eq_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_eq(tfloat, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_eq_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_eq(tfloat, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_eq_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_eq(ttext, ttext)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_eq_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR %= (
+	PROCEDURE = always_eq,
+	LEFTARG = tbool, RIGHTARG = tbool,
+	COMMUTATOR = %=, NEGATOR = ?<>
+);
+CREATE OPERATOR %= (
+	PROCEDURE = always_eq,
+	LEFTARG = tint, RIGHTARG = tint,
+	COMMUTATOR = %=, NEGATOR = ?<>
+);
+CREATE OPERATOR %= (
+	PROCEDURE = always_eq,
+	LEFTARG = tint, RIGHTARG = tfloat,
+	COMMUTATOR = %=, NEGATOR = ?<>
+);
+CREATE OPERATOR %= (
+	PROCEDURE = always_eq,
+	LEFTARG = tfloat, RIGHTARG = tint,
+	COMMUTATOR = %=, NEGATOR = ?<>
+);
+CREATE OPERATOR %= (
+	PROCEDURE = always_eq,
+	LEFTARG = tfloat, RIGHTARG = tfloat,
+	COMMUTATOR = %=, NEGATOR = ?<>
+);
+CREATE OPERATOR %= (
+	PROCEDURE = always_eq,
+	LEFTARG = ttext, RIGHTARG = ttext,
+	COMMUTATOR = %=, NEGATOR = ?<>
+);
+
+CREATE FUNCTION ever_ne(tbool, tbool)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_ne_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_ne(tint, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_ne_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_ne(tint, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_ne_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_ne(tfloat, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_ne_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_ne(tfloat, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_ne_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_ne(ttext, ttext)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_ne_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR ?<> (
+	PROCEDURE = ever_ne,
+	LEFTARG = tbool, RIGHTARG = tbool,
+	COMMUTATOR = ?<>, NEGATOR = %=
+);
+CREATE OPERATOR ?<> (
+	PROCEDURE = ever_ne,
+	LEFTARG = tint, RIGHTARG = tint,
+	COMMUTATOR = ?<>, NEGATOR = %=
+);
+CREATE OPERATOR ?<> (
+	PROCEDURE = ever_ne,
+	LEFTARG = tint, RIGHTARG = tfloat,
+	COMMUTATOR = ?<>, NEGATOR = %=
+);
+CREATE OPERATOR ?<> (
+	PROCEDURE = ever_ne,
+	LEFTARG = tfloat, RIGHTARG = tint,
+	COMMUTATOR = ?<>, NEGATOR = %=
+);
+CREATE OPERATOR ?<> (
+	PROCEDURE = ever_ne,
+	LEFTARG = tfloat, RIGHTARG = tfloat,
+	COMMUTATOR = ?<>, NEGATOR = %=
+);
+CREATE OPERATOR ?<> (
+	PROCEDURE = ever_ne,
+	LEFTARG = ttext, RIGHTARG = ttext,
+	COMMUTATOR = ?<>, NEGATOR = %=
+);
+
+CREATE FUNCTION always_ne(tbool, tbool)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_ne_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_ne(tint, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_ne_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_ne(tint, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_ne_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_ne(tfloat, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_ne_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_ne(tfloat, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_ne_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_ne(ttext, ttext)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_ne_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR %<> (
+	PROCEDURE = always_ne,
+	LEFTARG = tbool, RIGHTARG = tbool,
+	COMMUTATOR = %<>, NEGATOR = ?=
+);
+CREATE OPERATOR %<> (
+	PROCEDURE = always_ne,
+	LEFTARG = tint, RIGHTARG = tint,
+	COMMUTATOR = %<>, NEGATOR = ?=
+);
+CREATE OPERATOR %<> (
+	PROCEDURE = always_ne,
+	LEFTARG = tint, RIGHTARG = tfloat,
+	COMMUTATOR = %<>, NEGATOR = ?=
+);
+CREATE OPERATOR %<> (
+	PROCEDURE = always_ne,
+	LEFTARG = tfloat, RIGHTARG = tint,
+	COMMUTATOR = %<>, NEGATOR = ?=
+);
+CREATE OPERATOR %<> (
+	PROCEDURE = always_ne,
+	LEFTARG = tfloat, RIGHTARG = tfloat,
+	COMMUTATOR = %<>, NEGATOR = ?=
+);
+CREATE OPERATOR %<> (
+	PROCEDURE = always_ne,
+	LEFTARG = ttext, RIGHTARG = ttext,
+	COMMUTATOR = %<>, NEGATOR = ?=
+);
+
+CREATE FUNCTION ever_lt(tint, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_lt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_lt(tint, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_lt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_lt(tfloat, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_lt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_lt(tfloat, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_lt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_lt(ttext, ttext)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_lt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR ?< (
+	PROCEDURE = ever_lt,
+	LEFTARG = tint, RIGHTARG = tint,
+	COMMUTATOR = ?>, NEGATOR = %>=
+);
+CREATE OPERATOR ?< (
+	PROCEDURE = ever_lt,
+	LEFTARG = tint, RIGHTARG = tfloat,
+	COMMUTATOR = ?>, NEGATOR = %>=
+);
+CREATE OPERATOR ?< (
+	PROCEDURE = ever_lt,
+	LEFTARG = tfloat, RIGHTARG = tint,
+	COMMUTATOR = ?>, NEGATOR = %>=
+);
+CREATE OPERATOR ?< (
+	PROCEDURE = ever_lt,
+	LEFTARG = tfloat, RIGHTARG = tfloat,
+	COMMUTATOR = ?>, NEGATOR = %>=
+);
+CREATE OPERATOR ?< (
+	PROCEDURE = ever_lt,
+	LEFTARG = ttext, RIGHTARG = ttext,
+	COMMUTATOR = ?>, NEGATOR = %>=
+);
+
+CREATE FUNCTION always_lt(tint, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_lt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_lt(tint, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_lt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_lt(tfloat, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_lt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_lt(tfloat, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_lt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_lt(ttext, ttext)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_lt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR %< (
+	PROCEDURE = always_lt,
+	LEFTARG = tint, RIGHTARG = tint,
+	COMMUTATOR = %>, NEGATOR = ?>=
+);
+CREATE OPERATOR %< (
+	PROCEDURE = always_lt,
+	LEFTARG = tint, RIGHTARG = tfloat,
+	COMMUTATOR = %>, NEGATOR = ?>=
+);
+CREATE OPERATOR %< (
+	PROCEDURE = always_lt,
+	LEFTARG = tfloat, RIGHTARG = tint,
+	COMMUTATOR = %>, NEGATOR = ?>=
+);
+CREATE OPERATOR %< (
+	PROCEDURE = always_lt,
+	LEFTARG = tfloat, RIGHTARG = tfloat,
+	COMMUTATOR = %>, NEGATOR = ?>=
+);
+CREATE OPERATOR %< (
+	PROCEDURE = always_lt,
+	LEFTARG = ttext, RIGHTARG = ttext,
+	COMMUTATOR = %>, NEGATOR = ?>=
+);
+
+CREATE FUNCTION ever_le(tint, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_le_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_le(tint, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_le_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_le(tfloat, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_le_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_le(tfloat, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_le_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_le(ttext, ttext)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_le_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR ?<= (
+	PROCEDURE = ever_le,
+	LEFTARG = tint, RIGHTARG = tint,
+	COMMUTATOR = ?>=, NEGATOR = %>
+);
+CREATE OPERATOR ?<= (
+	PROCEDURE = ever_le,
+	LEFTARG = tint, RIGHTARG = tfloat,
+	COMMUTATOR = ?>=, NEGATOR = %>
+);
+CREATE OPERATOR ?<= (
+	PROCEDURE = ever_le,
+	LEFTARG = tfloat, RIGHTARG = tint,
+	COMMUTATOR = ?>=, NEGATOR = %>
+);
+CREATE OPERATOR ?<= (
+	PROCEDURE = ever_le,
+	LEFTARG = tfloat, RIGHTARG = tfloat,
+	COMMUTATOR = ?>=, NEGATOR = %>
+);
+CREATE OPERATOR ?<= (
+	PROCEDURE = ever_le,
+	LEFTARG = ttext, RIGHTARG = ttext,
+	COMMUTATOR = ?>=, NEGATOR = %>
+);
+
+CREATE FUNCTION always_le(tint, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_le_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_le(tint, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_le_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_le(tfloat, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_le_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_le(tfloat, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_le_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_le(ttext, ttext)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_le_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR %<= (
+	PROCEDURE = always_le,
+	LEFTARG = tint, RIGHTARG = tint,
+	COMMUTATOR = %>=, NEGATOR = ?>
+);
+CREATE OPERATOR %<= (
+	PROCEDURE = always_le,
+	LEFTARG = tint, RIGHTARG = tfloat,
+	COMMUTATOR = %>=, NEGATOR = ?>
+);
+CREATE OPERATOR %<= (
+	PROCEDURE = always_le,
+	LEFTARG = tfloat, RIGHTARG = tint,
+	COMMUTATOR = %>=, NEGATOR = ?>
+);
+CREATE OPERATOR %<= (
+	PROCEDURE = always_le,
+	LEFTARG = tfloat, RIGHTARG = tfloat,
+	COMMUTATOR = %>=, NEGATOR = ?>
+);
+CREATE OPERATOR %<= (
+	PROCEDURE = always_le,
+	LEFTARG = ttext, RIGHTARG = ttext,
+	COMMUTATOR = %>=, NEGATOR = ?>
+);
+
+CREATE FUNCTION ever_gt(tint, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_gt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_gt(tint, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_gt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_gt(tfloat, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_gt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_gt(tfloat, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_gt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_gt(ttext, ttext)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_gt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR ?> (
+	PROCEDURE = ever_gt,
+	LEFTARG = tint, RIGHTARG = tint,
+	COMMUTATOR = ?<, NEGATOR = %<=
+);
+CREATE OPERATOR ?> (
+	PROCEDURE = ever_gt,
+	LEFTARG = tint, RIGHTARG = tfloat,
+	COMMUTATOR = ?<, NEGATOR = %<=
+);
+CREATE OPERATOR ?> (
+	PROCEDURE = ever_gt,
+	LEFTARG = tfloat, RIGHTARG = tint,
+	COMMUTATOR = ?<, NEGATOR = %<=
+);
+CREATE OPERATOR ?> (
+	PROCEDURE = ever_gt,
+	LEFTARG = tfloat, RIGHTARG = tfloat,
+	COMMUTATOR = ?<, NEGATOR = %<=
+);
+CREATE OPERATOR ?> (
+	PROCEDURE = ever_gt,
+	LEFTARG = ttext, RIGHTARG = ttext,
+	COMMUTATOR = ?<, NEGATOR = %<=
+);
+
+CREATE FUNCTION always_gt(tint, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_gt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_gt(tint, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_gt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_gt(tfloat, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_gt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_gt(tfloat, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_gt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_gt(ttext, ttext)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_gt_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR %> (
+	PROCEDURE = always_gt,
+	LEFTARG = tint, RIGHTARG = tint,
+	COMMUTATOR = %<, NEGATOR = ?<=
+);
+CREATE OPERATOR %> (
+	PROCEDURE = always_gt,
+	LEFTARG = tint, RIGHTARG = tfloat,
+	COMMUTATOR = %<, NEGATOR = ?<=
+);
+CREATE OPERATOR %> (
+	PROCEDURE = always_gt,
+	LEFTARG = tfloat, RIGHTARG = tint,
+	COMMUTATOR = %<, NEGATOR = ?<=
+);
+CREATE OPERATOR %> (
+	PROCEDURE = always_gt,
+	LEFTARG = tfloat, RIGHTARG = tfloat,
+	COMMUTATOR = %<, NEGATOR = ?<=
+);
+CREATE OPERATOR %> (
+	PROCEDURE = always_gt,
+	LEFTARG = ttext, RIGHTARG = ttext,
+	COMMUTATOR = %<, NEGATOR = ?<=
+);
+
+CREATE FUNCTION ever_ge(tint, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_ge_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_ge(tint, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_ge_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_ge(tfloat, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_ge_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_ge(tfloat, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_ge_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ever_ge(ttext, ttext)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'ever_ge_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR ?>= (
+	PROCEDURE = ever_ge,
+	LEFTARG = tint, RIGHTARG = tint,
+	COMMUTATOR = ?<=, NEGATOR = %<
+);
+CREATE OPERATOR ?>= (
+	PROCEDURE = ever_ge,
+	LEFTARG = tint, RIGHTARG = tfloat,
+	COMMUTATOR = ?<=, NEGATOR = %<
+);
+CREATE OPERATOR ?>= (
+	PROCEDURE = ever_ge,
+	LEFTARG = tfloat, RIGHTARG = tint,
+	COMMUTATOR = ?<=, NEGATOR = %<
+);
+CREATE OPERATOR ?>= (
+	PROCEDURE = ever_ge,
+	LEFTARG = tfloat, RIGHTARG = tfloat,
+	COMMUTATOR = ?<=, NEGATOR = %<
+);
+CREATE OPERATOR ?>= (
+	PROCEDURE = ever_ge,
+	LEFTARG = ttext, RIGHTARG = ttext,
+	COMMUTATOR = ?<=, NEGATOR = %<
+);
+
+CREATE FUNCTION always_ge(tint, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_ge_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_ge(tint, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_ge_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_ge(tfloat, tint)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_ge_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_ge(tfloat, tfloat)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_ge_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION always_ge(ttext, ttext)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME', 'always_ge_temporal_temporal'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR %>= (
+	PROCEDURE = always_ge,
+	LEFTARG = tint, RIGHTARG = tint,
+	COMMUTATOR = %<=, NEGATOR = ?<
+);
+CREATE OPERATOR %>= (
+	PROCEDURE = always_ge,
+	LEFTARG = tint, RIGHTARG = tfloat,
+	COMMUTATOR = %<=, NEGATOR = ?<
+);
+CREATE OPERATOR %>= (
+	PROCEDURE = always_ge,
+	LEFTARG = tfloat, RIGHTARG = tint,
+	COMMUTATOR = %<=, NEGATOR = ?<
+);
+CREATE OPERATOR %>= (
+	PROCEDURE = always_ge,
+	LEFTARG = tfloat, RIGHTARG = tfloat,
+	COMMUTATOR = %<=, NEGATOR = ?<
+);
+CREATE OPERATOR %>= (
+	PROCEDURE = always_ge,
+	LEFTARG = ttext, RIGHTARG = ttext,
+	COMMUTATOR = %<=, NEGATOR = ?<
+);
+
+/*****************************************************************************/
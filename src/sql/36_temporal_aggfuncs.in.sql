@@ -62,6 +62,20 @@ CREATE AGGREGATE extent(tfloat) (
 	PARALLEL = safe
 );
 
+/* Extent estimated from the statistics of a column */
+
+CREATE FUNCTION estimatedTBox(regclass, text)
+	RETURNS tbox
+	AS 'MODULE_PATHNAME', 'tnumber_estimated_tbox'
+	LANGUAGE C STABLE STRICT PARALLEL SAFE;
+
+/* Average number of instants estimated from the statistics of a column */
+
+CREATE FUNCTION estimatedNumInstants(regclass, text)
+	RETURNS float
+	AS 'MODULE_PATHNAME', 'temporal_estimated_num_instants'
+	LANGUAGE C STABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
 
 CREATE FUNCTION tagg_serialize(internal)
@@ -363,3 +377,237 @@ CREATE AGGREGATE tcount(ttext) (
 );
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Bucketed aggregates
+ *****************************************************************************/
+
+CREATE FUNCTION tbucket_combinefn(internal, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_bucket_combinefn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tbucket_serialize(internal)
+	RETURNS bytea
+	AS 'MODULE_PATHNAME', 'temporal_bucket_serialize'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tbucket_deserialize(bytea, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_bucket_deserialize'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tint_tbucket_finalfn(internal)
+	RETURNS tint
+	AS 'MODULE_PATHNAME', 'temporal_bucket_finalfn'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tfloat_tbucket_finalfn(internal)
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'temporal_bucket_finalfn'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION tcount_transfn(internal, tbool, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_transfn(internal, tint, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_transfn(internal, tfloat, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_transfn(internal, ttext, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_bucket_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tsum_transfn(internal, tint, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'tnumber_tsum_bucket_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tsum_transfn(internal, tfloat, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'tnumber_tsum_bucket_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE tcount(tbool, interval) (
+	SFUNC = tcount_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbucket_combinefn,
+	FINALFUNC = tint_tbucket_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount(tint, interval) (
+	SFUNC = tcount_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbucket_combinefn,
+	FINALFUNC = tint_tbucket_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount(tfloat, interval) (
+	SFUNC = tcount_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbucket_combinefn,
+	FINALFUNC = tint_tbucket_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tcount(ttext, interval) (
+	SFUNC = tcount_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbucket_combinefn,
+	FINALFUNC = tint_tbucket_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tsum(tint, interval) (
+	SFUNC = tsum_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbucket_combinefn,
+	FINALFUNC = tint_tbucket_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tsum(tfloat, interval) (
+	SFUNC = tsum_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tbucket_combinefn,
+	FINALFUNC = tfloat_tbucket_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+
+/*****************************************************************************
+ * Approximate bucketed aggregates
+ *****************************************************************************/
+
+CREATE FUNCTION tsketch_combinefn(internal, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_sketch_combinefn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_finalfn(internal)
+	RETURNS tint
+	AS 'MODULE_PATHNAME', 'temporal_tcount_distinct_finalfn'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpercentile_finalfn(internal)
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'tnumber_tpercentile_finalfn'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, tbool, anyelement, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_distinct_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, tint, anyelement, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_distinct_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, tfloat, anyelement, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_distinct_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, ttext, anyelement, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'temporal_tcount_distinct_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tpercentile_transfn(internal, tint, float, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'tnumber_tpercentile_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tpercentile_transfn(internal, tfloat, float, interval)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'tnumber_tpercentile_transfn'
+	LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE tcountDistinct(tbool, anyelement, interval) (
+	SFUNC = tcount_distinct_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tsketch_combinefn,
+	FINALFUNC = tcount_distinct_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(tint, anyelement, interval) (
+	SFUNC = tcount_distinct_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tsketch_combinefn,
+	FINALFUNC = tcount_distinct_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(tfloat, anyelement, interval) (
+	SFUNC = tcount_distinct_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tsketch_combinefn,
+	FINALFUNC = tcount_distinct_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(ttext, anyelement, interval) (
+	SFUNC = tcount_distinct_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tsketch_combinefn,
+	FINALFUNC = tcount_distinct_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tpercentile(tint, float, interval) (
+	SFUNC = tpercentile_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tsketch_combinefn,
+	FINALFUNC = tpercentile_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE tpercentile(tfloat, float, interval) (
+	SFUNC = tpercentile_transfn,
+	STYPE = internal,
+	COMBINEFUNC = tsketch_combinefn,
+	FINALFUNC = tpercentile_finalfn,
+	SERIALFUNC = tbucket_serialize,
+	DESERIALFUNC = tbucket_deserialize,
+	PARALLEL = SAFE
+);
+
+/* The values are collected into an array which is merged at the end */
+
+CREATE AGGREGATE merge(tbool) (
+	SFUNC = array_append,
+	STYPE = tbool[],
+	COMBINEFUNC = array_cat,
+	FINALFUNC = merge,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE merge(tint) (
+	SFUNC = array_append,
+	STYPE = tint[],
+	COMBINEFUNC = array_cat,
+	FINALFUNC = merge,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE merge(tfloat) (
+	SFUNC = array_append,
+	STYPE = tfloat[],
+	COMBINEFUNC = array_cat,
+	FINALFUNC = merge,
+	PARALLEL = SAFE
+);
+CREATE AGGREGATE merge(ttext) (
+	SFUNC = array_append,
+	STYPE = ttext[],
+	COMBINEFUNC = array_cat,
+	FINALFUNC = merge,
+	PARALLEL = SAFE
+);
+
+/*****************************************************************************/
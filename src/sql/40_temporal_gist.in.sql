@@ -51,6 +51,8 @@ CREATE OPERATOR CLASS gist_tbool_ops
 	-- contained by
 	OPERATOR	8		<@ (tbool, period),
 	OPERATOR	8		<@ (tbool, tbool),
+	-- distance in time
+	OPERATOR	15		<-> (tbool, timestamptz) FOR ORDER BY pg_catalog.float_ops,
 	-- overlaps or before
 	OPERATOR	28		&<# (tbool, period),
 	OPERATOR	28		&<# (tbool, tbool),
@@ -69,7 +71,8 @@ CREATE OPERATOR CLASS gist_tbool_ops
 	FUNCTION	3	gist_tbool_compress(internal),
 	FUNCTION	5	gist_period_penalty(internal, internal, internal),
 	FUNCTION	6	gist_period_picksplit(internal, internal),
-	FUNCTION	7	gist_period_same(period, period, internal);
+	FUNCTION	7	gist_period_same(period, period, internal),
+	FUNCTION	8	gist_period_distance(internal, timestamptz, smallint, oid, internal);
 
 /******************************************************************************/
 
@@ -81,6 +84,10 @@ CREATE FUNCTION gist_tint_compress(internal)
 	RETURNS internal
 	AS 'MODULE_PATHNAME', 'gist_tnumber_compress'
 	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tnumber_distance(internal, timestamptz, smallint, oid, internal)
+	RETURNS float8
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR CLASS gist_tint_ops
 	DEFAULT FOR TYPE tint USING gist AS
@@ -125,6 +132,8 @@ CREATE OPERATOR CLASS gist_tint_ops
 	OPERATOR	8		<@ (tint, tbox),
 	OPERATOR	8		<@ (tint, tint),
 	OPERATOR	8		<@ (tint, tfloat),
+	-- distance in time
+	OPERATOR	15		<-> (tint, timestamptz) FOR ORDER BY pg_catalog.float_ops,
 	-- overlaps or before
 	OPERATOR	28		&<# (tint, tbox),
 	OPERATOR	28		&<# (tint, tint),
@@ -147,7 +156,8 @@ CREATE OPERATOR CLASS gist_tint_ops
 	FUNCTION	3	gist_tint_compress(internal),
 	FUNCTION	5	gist_tbox_penalty(internal, internal, internal),
 	FUNCTION	6	gist_tbox_picksplit(internal, internal),
-	FUNCTION	7	gist_tbox_same(tbox, tbox, internal);
+	FUNCTION	7	gist_tbox_same(tbox, tbox, internal),
+	FUNCTION	8	gist_tnumber_distance(internal, timestamptz, smallint, oid, internal);
 
 /******************************************************************************/
 
@@ -203,6 +213,8 @@ CREATE OPERATOR CLASS gist_tfloat_ops
 	OPERATOR	8		<@ (tfloat, tbox),
 	OPERATOR	8		<@ (tfloat, tint),
 	OPERATOR	8		<@ (tfloat, tfloat),
+	-- distance in time
+	OPERATOR	15		<-> (tfloat, timestamptz) FOR ORDER BY pg_catalog.float_ops,
 	-- overlaps or before
 	OPERATOR	28		&<# (tfloat, tbox),
 	OPERATOR	28		&<# (tfloat, tint),
@@ -225,7 +237,8 @@ CREATE OPERATOR CLASS gist_tfloat_ops
 	FUNCTION	3	gist_tfloat_compress(internal),
 	FUNCTION	5	gist_tbox_penalty(internal, internal, internal),
 	FUNCTION	6	gist_tbox_picksplit(internal, internal),
-	FUNCTION	7	gist_tbox_same(tbox, tbox, internal);
+	FUNCTION	7	gist_tbox_same(tbox, tbox, internal),
+	FUNCTION	8	gist_tnumber_distance(internal, timestamptz, smallint, oid, internal);
 
 /******************************************************************************/
 
@@ -253,6 +266,8 @@ CREATE OPERATOR CLASS gist_ttext_ops
 	-- contained by
 	OPERATOR	8		<@ (ttext, period),
 	OPERATOR	8		<@ (ttext, ttext),
+	-- distance in time
+	OPERATOR	15		<-> (ttext, timestamptz) FOR ORDER BY pg_catalog.float_ops,
 	-- overlaps or before
 	OPERATOR	28		&<# (ttext, period),
 	OPERATOR	28		&<# (ttext, ttext),
@@ -271,6 +286,216 @@ CREATE OPERATOR CLASS gist_ttext_ops
 	FUNCTION	3	gist_ttext_compress(internal),
 	FUNCTION	5	gist_period_penalty(internal, internal, internal),
 	FUNCTION	6	gist_period_picksplit(internal, internal),
-	FUNCTION	7	gist_period_same(period, period, internal);
+	FUNCTION	7	gist_period_same(period, period, internal),
+	FUNCTION	8	gist_period_distance(internal, timestamptz, smallint, oid, internal);
+
+/******************************************************************************/
+
+/******************************************************************************
+ * Operator classes with compact keys
+ * The keys store the value bounds in float4 rounded outwards and the time 
+ * span in seconds rounded up, which makes the indexes smaller.
+ ******************************************************************************/
+
+CREATE TYPE tboxf;
+
+CREATE FUNCTION tboxf_in(cstring)
+	RETURNS tboxf
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tboxf_out(tboxf)
+	RETURNS cstring
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE TYPE tboxf (
+	internallength = 24,
+	input = tboxf_in,
+	output = tboxf_out,
+	storage = plain,
+	alignment = double
+);
+
+CREATE FUNCTION gist_tint_compact_consistent(internal, tint, smallint, oid, internal)
+	RETURNS bool
+	AS 'MODULE_PATHNAME', 'gist_tnumber_compact_consistent'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tfloat_compact_consistent(internal, tfloat, smallint, oid, internal)
+	RETURNS bool
+	AS 'MODULE_PATHNAME', 'gist_tnumber_compact_consistent'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tnumber_compact_compress(internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_tnumber_compact_compress'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tnumber_compact_decompress(internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_tnumber_compact_decompress'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_tboxf_same(tboxf, tboxf, internal)
+	RETURNS internal
+	AS 'MODULE_PATHNAME', 'gist_tbox_same'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS gist_tint_compact_ops
+	FOR TYPE tint USING gist AS
+	STORAGE tboxf,
+	-- strictly left
+	OPERATOR	1		<< (tint, intrange),
+	OPERATOR	1		<< (tint, tbox),
+	OPERATOR	1		<< (tint, tint),
+	OPERATOR	1		<< (tint, tfloat),
+ 	-- overlaps or left
+	OPERATOR	2		&< (tint, intrange),
+	OPERATOR	2		&< (tint, tbox),
+	OPERATOR	2		&< (tint, tint),
+	OPERATOR	2		&< (tint, tfloat),
+	-- overlaps
+	OPERATOR	3		&& (tint, intrange),
+	OPERATOR	3		&& (tint, tbox),
+	OPERATOR	3		&& (tint, tint),
+	OPERATOR	3		&& (tint, tfloat),
+	-- overlaps or right
+	OPERATOR	4		&> (tint, intrange),
+	OPERATOR	4		&> (tint, tbox),
+	OPERATOR	4		&> (tint, tint),
+	OPERATOR	4		&> (tint, tfloat),
+	-- strictly right
+	OPERATOR	5		>> (tint, intrange),
+	OPERATOR	5		>> (tint, tbox),
+	OPERATOR	5		>> (tint, tint),
+	OPERATOR	5		>> (tint, tfloat),
+  	-- same
+	OPERATOR	6		~= (tint, intrange),
+	OPERATOR	6		~= (tint, tbox),
+	OPERATOR	6		~= (tint, tint),
+	OPERATOR	6		~= (tint, tfloat),
+	-- contains
+	OPERATOR	7		@> (tint, intrange),
+	OPERATOR	7		@> (tint, tbox),
+	OPERATOR	7		@> (tint, tint),
+	OPERATOR	7		@> (tint, tfloat),
+	-- contained by
+	OPERATOR	8		<@ (tint, intrange),
+	OPERATOR	8		<@ (tint, tbox),
+	OPERATOR	8		<@ (tint, tint),
+	OPERATOR	8		<@ (tint, tfloat),
+	-- distance in time
+	OPERATOR	15		<-> (tint, timestamptz) FOR ORDER BY pg_catalog.float_ops,
+	-- overlaps or before
+	OPERATOR	28		&<# (tint, tbox),
+	OPERATOR	28		&<# (tint, tint),
+	OPERATOR	28		&<# (tint, tfloat),
+	-- strictly before
+	OPERATOR	29		<<# (tint, tbox),
+	OPERATOR	29		<<# (tint, tint),
+	OPERATOR	29		<<# (tint, tfloat),
+	-- strictly after
+	OPERATOR	30		#>> (tint, tbox),
+	OPERATOR	30		#>> (tint, tint),
+	OPERATOR	30		#>> (tint, tfloat),
+	-- overlaps or after
+	OPERATOR	31		#&> (tint, tbox),
+	OPERATOR	31		#&> (tint, tint),
+	OPERATOR	31		#&> (tint, tfloat),
+	-- functions
+	FUNCTION	1	gist_tint_compact_consistent(internal, tint, smallint, oid, internal),
+	FUNCTION	2	gist_tbox_union(internal, internal),
+	FUNCTION	3	gist_tnumber_compact_compress(internal),
+	FUNCTION	4	gist_tnumber_compact_decompress(internal),
+	FUNCTION	5	gist_tbox_penalty(internal, internal, internal),
+	FUNCTION	6	gist_tbox_picksplit(internal, internal),
+	FUNCTION	7	gist_tboxf_same(tboxf, tboxf, internal),
+	FUNCTION	8	gist_tnumber_distance(internal, timestamptz, smallint, oid, internal);
+
+CREATE OPERATOR CLASS gist_tfloat_compact_ops
+	FOR TYPE tfloat USING gist AS
+	STORAGE tboxf,
+	-- strictly left
+	OPERATOR	1		<< (tfloat, floatrange),
+	OPERATOR	1		<< (tfloat, tbox),
+	OPERATOR	1		<< (tfloat, tint),
+	OPERATOR	1		<< (tfloat, tfloat),
+ 	-- overlaps or left
+	OPERATOR	2		&< (tfloat, floatrange),
+	OPERATOR	2		&< (tfloat, tbox),
+	OPERATOR	2		&< (tfloat, tint),
+	OPERATOR	2		&< (tfloat, tfloat),
+	-- overlaps
+	OPERATOR	3		&& (tfloat, floatrange),
+	OPERATOR	3		&& (tfloat, tbox),
+	OPERATOR	3		&& (tfloat, tint),
+	OPERATOR	3		&& (tfloat, tfloat),
+	-- overlaps or right
+	OPERATOR	4		&> (tfloat, floatrange),
+	OPERATOR	4		&> (tfloat, tbox),
+	OPERATOR	4		&> (tfloat, tint),
+	OPERATOR	4		&> (tfloat, tfloat),
+	-- strictly right
+	OPERATOR	5		>> (tfloat, floatrange),
+	OPERATOR	5		>> (tfloat, tbox),
+	OPERATOR	5		>> (tfloat, tint),
+	OPERATOR	5		>> (tfloat, tfloat),
+  	-- same
+	OPERATOR	6		~= (tfloat, floatrange),
+	OPERATOR	6		~= (tfloat, tbox),
+	OPERATOR	6		~= (tfloat, tint),
+	OPERATOR	6		~= (tfloat, tfloat),
+	-- contains
+	OPERATOR	7		@> (tfloat, floatrange),
+	OPERATOR	7		@> (tfloat, tbox),
+	OPERATOR	7		@> (tfloat, tint),
+	OPERATOR	7		@> (tfloat, tfloat),
+	-- contained by
+	OPERATOR	8		<@ (tfloat, floatrange),
+	OPERATOR	8		<@ (tfloat, tbox),
+	OPERATOR	8		<@ (tfloat, tint),
+	OPERATOR	8		<@ (tfloat, tfloat),
+	-- distance in time
+	OPERATOR	15		<-> (tfloat, timestamptz) FOR ORDER BY pg_catalog.float_ops,
+	-- overlaps or before
+	OPERATOR	28		&<# (tfloat, tbox),
+	OPERATOR	28		&<# (tfloat, tint),
+	OPERATOR	28		&<# (tfloat, tfloat),
+	-- strictly before
+	OPERATOR	29		<<# (tfloat, tbox),
+	OPERATOR	29		<<# (tfloat, tint),
+	OPERATOR	29		<<# (tfloat, tfloat),
+	-- strictly after
+	OPERATOR	30		#>> (tfloat, tbox),
+	OPERATOR	30		#>> (tfloat, tint),
+	OPERATOR	30		#>> (tfloat, tfloat),
+	-- overlaps or after
+	OPERATOR	31		#&> (tfloat, tbox),
+	OPERATOR	31		#&> (tfloat, tint),
+	OPERATOR	31		#&> (tfloat, tfloat),
+	-- functions
+	FUNCTION	1	gist_tfloat_compact_consistent(internal, tfloat, smallint, oid, internal),
+	FUNCTION	2	gist_tbox_union(internal, internal),
+	FUNCTION	3	gist_tnumber_compact_compress(internal),
+	FUNCTION	4	gist_tnumber_compact_decompress(internal),
+	FUNCTION	5	gist_tbox_penalty(internal, internal, internal),
+	FUNCTION	6	gist_tbox_picksplit(internal, internal),
+	FUNCTION	7	gist_tboxf_same(tboxf, tboxf, internal),
+	FUNCTION	8	gist_tnumber_distance(internal, timestamptz, smallint, oid, internal);
+
+/******************************************************************************/
+
+/******************************************************************************
+ * Sort key for building GiST indexes
+ ******************************************************************************/
+
+CREATE FUNCTION zorder(tbox, tbox)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'tbox_zorder'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION zorder(tint, tbox)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'tnumber_zorder'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION zorder(tfloat, tbox)
+	RETURNS bigint
+	AS 'MODULE_PATHNAME', 'tnumber_zorder'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 /******************************************************************************/
@@ -0,0 +1,120 @@
+/*****************************************************************************
+ *
+ * temporal_brin.sql
+ *		BRIN inclusion index for time types and temporal numbers
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse, 
+ * 		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+CREATE FUNCTION brin_period_merge(period, period)
+	RETURNS period
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS brin_period_inclusion_ops
+	DEFAULT FOR TYPE period USING brin AS
+	-- overlaps
+	OPERATOR	3		&& (period, timestampset),
+	OPERATOR	3		&& (period, period),
+	OPERATOR	3		&& (period, periodset),
+	-- contains
+	OPERATOR	7		@> (period, timestamptz),
+	OPERATOR	7		@> (period, timestampset),
+	OPERATOR	7		@> (period, period),
+	OPERATOR	7		@> (period, periodset),
+	-- contained by
+	OPERATOR	8		<@ (period, period),
+	OPERATOR	8		<@ (period, periodset),
+	-- functions
+	FUNCTION	1	brin_inclusion_opcinfo(internal),
+	FUNCTION	2	brin_inclusion_add_value(internal, internal, internal, internal),
+	FUNCTION	3	brin_inclusion_consistent(internal, internal, internal),
+	FUNCTION	4	brin_inclusion_union(internal, internal, internal),
+	FUNCTION	11	brin_period_merge(period, period),
+	FUNCTION	13	temporal_contains(period, period),
+	STORAGE period;
+
+/******************************************************************************/
+
+CREATE FUNCTION brin_tbox_merge(tbox, tbox)
+	RETURNS tbox
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION brin_tnumber_add_value(internal, internal, internal, internal)
+	RETURNS boolean
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS brin_tint_inclusion_ops
+	DEFAULT FOR TYPE tint USING brin AS
+	-- overlaps
+	OPERATOR	3		&& (tint, tbox),
+	OPERATOR	3		&& (tint, tint),
+	OPERATOR	3		&& (tint, tfloat),
+	-- same
+	OPERATOR	6		~= (tint, tbox),
+	OPERATOR	6		~= (tint, tint),
+	OPERATOR	6		~= (tint, tfloat),
+	-- contains
+	OPERATOR	7		@> (tint, tbox),
+	OPERATOR	7		@> (tint, tint),
+	OPERATOR	7		@> (tint, tfloat),
+	-- contained by
+	OPERATOR	8		<@ (tint, tbox),
+	OPERATOR	8		<@ (tint, tint),
+	OPERATOR	8		<@ (tint, tfloat),
+	-- operators applied to the summary of a range of pages
+	OPERATOR	3		&& (tbox, tbox),
+	OPERATOR	3		&& (tbox, tint),
+	OPERATOR	3		&& (tbox, tfloat),
+	OPERATOR	7		@> (tbox, tbox),
+	OPERATOR	7		@> (tbox, tint),
+	OPERATOR	7		@> (tbox, tfloat),
+	-- functions
+	FUNCTION	1	brin_inclusion_opcinfo(internal),
+	FUNCTION	2	brin_tnumber_add_value(internal, internal, internal, internal),
+	FUNCTION	3	brin_inclusion_consistent(internal, internal, internal),
+	FUNCTION	4	brin_inclusion_union(internal, internal, internal),
+	FUNCTION	11	brin_tbox_merge(tbox, tbox),
+	STORAGE tbox;
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS brin_tfloat_inclusion_ops
+	DEFAULT FOR TYPE tfloat USING brin AS
+	-- overlaps
+	OPERATOR	3		&& (tfloat, tbox),
+	OPERATOR	3		&& (tfloat, tint),
+	OPERATOR	3		&& (tfloat, tfloat),
+	-- same
+	OPERATOR	6		~= (tfloat, tbox),
+	OPERATOR	6		~= (tfloat, tint),
+	OPERATOR	6		~= (tfloat, tfloat),
+	-- contains
+	OPERATOR	7		@> (tfloat, tbox),
+	OPERATOR	7		@> (tfloat, tint),
+	OPERATOR	7		@> (tfloat, tfloat),
+	-- contained by
+	OPERATOR	8		<@ (tfloat, tbox),
+	OPERATOR	8		<@ (tfloat, tint),
+	OPERATOR	8		<@ (tfloat, tfloat),
+	-- operators applied to the summary of a range of pages
+	OPERATOR	3		&& (tbox, tbox),
+	OPERATOR	3		&& (tbox, tint),
+	OPERATOR	3		&& (tbox, tfloat),
+	OPERATOR	7		@> (tbox, tbox),
+	OPERATOR	7		@> (tbox, tint),
+	OPERATOR	7		@> (tbox, tfloat),
+	-- functions
+	FUNCTION	1	brin_inclusion_opcinfo(internal),
+	FUNCTION	2	brin_tnumber_add_value(internal, internal, internal, internal),
+	FUNCTION	3	brin_inclusion_consistent(internal, internal, internal),
+	FUNCTION	4	brin_inclusion_union(internal, internal, internal),
+	FUNCTION	11	brin_tbox_merge(tbox, tbox),
+	STORAGE tbox;
+
+/******************************************************************************/
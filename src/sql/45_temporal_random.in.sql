@@ -0,0 +1,22 @@
+/*****************************************************************************
+ *
+ * temporal_random.sql
+ *	  Generation of random temporal values for benchmarks
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+/* The distribution is one of uniform, walk, and clustered */
+
+CREATE FUNCTION random_tfloat_seq(low float, high float, period, count integer,
+		step interval DEFAULT '1 minute', distribution text DEFAULT 'uniform',
+		seed bigint DEFAULT 0)
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'random_tfloat_seq'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************/
@@ -0,0 +1,20 @@
+/*****************************************************************************
+ *
+ * temporal_indexstats.sql
+ *		Statistics of the structure of GiST and SP-GiST indexes
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse, 
+ * 		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+CREATE FUNCTION mobdb_index_stats(index regclass, OUT level integer,
+		OUT pages bigint, OUT inner_tuples bigint, OUT leaf_tuples bigint,
+		OUT fill_ratio float, OUT avg_volume float, OUT overlap float)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C VOLATILE STRICT PARALLEL SAFE;
+
+/*****************************************************************************/
@@ -0,0 +1,33 @@
+/*****************************************************************************
+ *
+ * temporal_stats.sql
+ *		Counters of the work done by the core functions in a backend
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ * 		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+CREATE FUNCTION mobdb_stat_activity(OUT instants bigint,
+		OUT sync_segments bigint, OUT crossings bigint, OUT geos_calls bigint,
+		OUT lifting_bytes bigint, OUT skiplist_splices bigint,
+		OUT detoast_bytes bigint, OUT enabled boolean)
+	RETURNS record
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
+CREATE FUNCTION mobdb_stat_reset()
+	RETURNS void
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
+CREATE FUNCTION mobdb_stat_index(OUT opclass text, OUT strategy integer,
+		OUT calls bigint, OUT internal_calls bigint, OUT leaf_calls bigint,
+		OUT leaf_matches bigint, OUT leaf_rechecks bigint)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME'
+	LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
+/*****************************************************************************/
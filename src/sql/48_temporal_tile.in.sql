@@ -0,0 +1,82 @@
+/*****************************************************************************
+ *
+ * temporal_tile.sql
+ *	  Split of temporal values according to time buckets
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Time buckets
+ *****************************************************************************/
+
+CREATE FUNCTION timeBucket(timestamptz, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00')
+	RETURNS timestamptz
+	AS 'MODULE_PATHNAME', 'timestamp_time_bucket'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION timeBucket(period, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00')
+	RETURNS timestamptz
+	AS 'MODULE_PATHNAME', 'period_time_bucket'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************
+ * Time split
+ *****************************************************************************/
+
+CREATE FUNCTION timeSplit(tbool, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00',
+		OUT bucket timestamptz, OUT fragment tbool)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'temporal_time_split_srf'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION timeSplit(tint, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00',
+		OUT bucket timestamptz, OUT fragment tint)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'temporal_time_split_srf'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION timeSplit(tfloat, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00',
+		OUT bucket timestamptz, OUT fragment tfloat)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'temporal_time_split_srf'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION timeSplit(ttext, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00',
+		OUT bucket timestamptz, OUT fragment ttext)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'temporal_time_split_srf'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************
+ * Time sampling
+ *****************************************************************************/
+
+CREATE FUNCTION tsample(tbool, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00')
+	RETURNS tbool
+	AS 'MODULE_PATHNAME', 'temporal_tsample'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(tint, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00')
+	RETURNS tint
+	AS 'MODULE_PATHNAME', 'temporal_tsample'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(tfloat, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00')
+	RETURNS tfloat
+	AS 'MODULE_PATHNAME', 'temporal_tsample'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tsample(ttext, duration interval,
+		torigin timestamptz DEFAULT '2000-01-01 00:00:00+00')
+	RETURNS ttext
+	AS 'MODULE_PATHNAME', 'temporal_tsample'
+	LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************/
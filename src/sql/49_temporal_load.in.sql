@@ -0,0 +1,21 @@
+/*****************************************************************************
+ *
+ * temporal_load.sql
+ *	  Bulk load of temporal values from files
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+/* The lines of the file are of the form id,t,value */
+
+CREATE FUNCTION loadTFloat(filename text, header boolean DEFAULT true,
+		delimiter text DEFAULT ',', OUT id text, OUT temp tfloat)
+	RETURNS SETOF record
+	AS 'MODULE_PATHNAME', 'tfloat_load_csv'
+	LANGUAGE C VOLATILE STRICT;
+
+/*****************************************************************************/
@@ -25,4 +25,9 @@ CREATE FUNCTION fill_opcache()
 
 SELECT fill_opcache();
 
+CREATE FUNCTION oidcache_stats(OUT hits bigint, OUT shared_hits bigint,
+		OUT misses bigint, OUT shared boolean)
+	AS 'MODULE_PATHNAME', 'oidcache_stats'
+	LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
 /******************************************************************************/
@@ -17,20 +17,32 @@
 #include <access/htup_details.h>
 #include <access/tuptoaster.h>
 #include <catalog/namespace.h>
+#include <funcapi.h>
+#include <lib/binaryheap.h>
 #include <libpq/pqformat.h>
 #include <utils/builtins.h>
 #include <utils/fmgroids.h>
 #include <utils/lsyscache.h>
+#include <utils/memutils.h>
 #include <utils/rel.h>
 #include <utils/timestamp.h>
 
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "timeops.h"
 #include "temporal_boxops.h"
+#include "temporal_cache.h"
 #include "temporal_parser.h"
+#include "temporal_compress.h"
+#include "temporal_expanded.h"
+#include "temporal_stats.h"
 #include "rangetypes_ext.h"
 
+#ifdef WITH_POSTGIS
+#include "tpoint_spatialfuncs.h"
+#endif
+
 /*****************************************************************************
  * Typmod 
  *****************************************************************************/
@@ -138,6 +150,92 @@ temporal_copy(Temporal *temp)
 	return result;
 }
 
+/* 
+ * Initialize an iterator over the instants of a temporal value. The iterator
+ * does not allocate memory, the instants are returned in place. A typical use
+ * is as follows
+ *
+ *		TemporalInstIterator it;
+ *		TemporalInst *inst;
+ *		temporalinst_iterator_init(&it, temp);
+ *		while ((inst = temporalinst_iterator_next(&it)) != NULL)
+ *			...
+ */
+void
+temporalinst_iterator_init(TemporalInstIterator *it, Temporal *temp)
+{
+	ensure_valid_duration(temp->duration);
+	it->temp = temp;
+	it->i = 0;
+	it->j = 0;
+	it->seq = NULL;
+}
+
+/* 
+ * Next instant of the iterator, or NULL when all the instants have been
+ * returned
+ */
+TemporalInst *
+temporalinst_iterator_next(TemporalInstIterator *it)
+{
+	Temporal *temp = it->temp;
+	if (temp->duration == TEMPORALINST)
+		return (it->j++ == 0) ? (TemporalInst *)temp : NULL;
+	if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *)temp;
+		return (it->j < ti->count) ? temporali_inst_n(ti, it->j++) : NULL;
+	}
+	if (temp->duration == TEMPORALSEQ)
+	{
+		TemporalSeq *seq = (TemporalSeq *)temp;
+		return (it->j < seq->count) ? temporalseq_inst_n(seq, it->j++) : NULL;
+	}
+	/* temp->duration == TEMPORALS */
+	TemporalS *ts = (TemporalS *)temp;
+	while (it->i < ts->count)
+	{
+		if (it->seq == NULL)
+			it->seq = temporals_seq_n(ts, it->i);
+		if (it->j < it->seq->count)
+			return temporalseq_inst_n(it->seq, it->j++);
+		it->i++;
+		it->j = 0;
+		it->seq = NULL;
+	}
+	return NULL;
+}
+
+/* 
+ * Get a temporal value passed as argument, decompressing it if needed.
+ * Sequence sets in the first on-disk format are converted to the current one.
+ * This function is called by the PG_GETARG_TEMPORAL and DatumGetTemporal
+ * macros after detoasting the value.
+ */
+Temporal *
+pg_getarg_temporal(Temporal *temp)
+{
+	if (temp->duration == TEMPORALSEQ && MOBDB_FLAGS_GET_COMPRESSED(temp->flags))
+		return (Temporal *) temporalseq_decompress((TemporalSeq *) temp);
+	if (temp->duration == TEMPORALS)
+		return (Temporal *) temporals_with_periods((TemporalS *) temp);
+	return temp;
+}
+
+/*
+ * Same as pg_getarg_temporal but compressed sequences are returned as they
+ * are. Their header has the same layout as the one of TemporalSeq up to the
+ * period and temporal_bbox reads their bounding box, so that the functions
+ * that only need these can be applied to them.
+ */
+Temporal *
+pg_getarg_temporal_header(Temporal *temp)
+{
+	if (temp->duration == TEMPORALSEQ && MOBDB_FLAGS_GET_COMPRESSED(temp->flags))
+		return temp;
+	return pg_getarg_temporal(temp);
+}
+
 /* 
  * intersection two temporal values
  * Returns false if the values do not overlap on time
@@ -438,9 +536,24 @@ base_oid_from_temporal(Oid temptypid)
  * Trajectory functions
  *****************************************************************************/
 
+/**
+ * @brief Value of the mobilitydb.precompute_trajectory parameter which states
+ * 		whether the trajectory of temporal point sequences is computed when
+ * 		they are constructed. Otherwise it is computed when it is needed.
+ */
+bool precompute_trajectory = true;
+
+/**
+ * @brief Value of the mobilitydb.precompute_summary parameter which states
+ * 		whether the integral of temporal number sequences and the length of
+ * 		temporal point sequences are computed when they are constructed
+ * 		and stored after their bounding box
+ */
+bool precompute_summary = false;
+
 /**
  * @brief Returns true if the temporal type corresponding to the Oid of the 
- *		base type has its trajectory precomputed 
+ *		base type may have its trajectory precomputed 
  */
 bool
 type_has_precomputed_trajectory(Oid valuetypid) 
@@ -641,27 +754,56 @@ temporal_in(PG_FUNCTION_ARGS)
 	if (PG_NARGS() > 2 && !PG_ARGISNULL(2)) 
 		temp_typmod = PG_GETARG_INT32(2);
 	if (temp_typmod >= 0)
+	{
 		result = temporal_valid_typmod(result, temp_typmod);
+		result = temporal_typmod_pack(result, temp_typmod);
+	}
 	PG_RETURN_POINTER(result);
 }
 
+/* Expected size of the string representation of an instant */
+#define TEMPORALINST_STRING_SIZE	64
+
 /**
- * @brief Generic output function for temporal types (dispatch function)
+ * @brief Append the string representation of the temporal value to the 
+ *		buffer (dispatch function)
+ * @note The buffer is first enlarged to the expected size of the result so 
+ *		that it is usually not reallocated while the instants are written
  */
-char *
-temporal_to_string(Temporal *temp, char *(*value_out)(Oid, Datum))
+void
+temporal_to_string_buf(StringInfo buf, Temporal *temp,
+	void (*value_out)(StringInfo, Oid, Datum))
 {
-	char *result = NULL;
 	ensure_valid_duration(temp->duration);
+	Size count = 1;
+	if (temp->duration == TEMPORALI) 
+		count = ((TemporalI *)temp)->count;
+	else if (temp->duration == TEMPORALSEQ) 
+		count = ((TemporalSeq *)temp)->count;
+	else if (temp->duration == TEMPORALS) 
+		count = ((TemporalS *)temp)->totalcount;
+	enlargeStringInfo(buf, (int) Min(count * TEMPORALINST_STRING_SIZE, 
+		MaxAllocSize / 2));
 	if (temp->duration == TEMPORALINST) 
-		result = temporalinst_to_string((TemporalInst *)temp, value_out);
+		temporalinst_to_string_buf(buf, (TemporalInst *)temp, value_out);
 	else if (temp->duration == TEMPORALI) 
-		result = temporali_to_string((TemporalI *)temp, value_out);
+		temporali_to_string_buf(buf, (TemporalI *)temp, value_out);
 	else if (temp->duration == TEMPORALSEQ) 
-		result = temporalseq_to_string((TemporalSeq *)temp, false, value_out);
+		temporalseq_to_string_buf(buf, (TemporalSeq *)temp, false, value_out);
 	else if (temp->duration == TEMPORALS) 
-		result = temporals_to_string((TemporalS *)temp, value_out);
-	return result;
+		temporals_to_string_buf(buf, (TemporalS *)temp, value_out);
+}
+
+/**
+ * @brief Generic output function for temporal types
+ */
+char *
+temporal_to_string(Temporal *temp, void (*value_out)(StringInfo, Oid, Datum))
+{
+	StringInfoData buf;
+	initStringInfo(&buf);
+	temporal_to_string_buf(&buf, temp, value_out);
+	return buf.data;
 }
 
 PG_FUNCTION_INFO_V1(temporal_out);
@@ -672,27 +814,318 @@ PGDLLEXPORT Datum
 temporal_out(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	char *result = temporal_to_string(temp, &call_output);
+	char *result = temporal_to_string(temp, &datum_to_string_buf);
 	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_CSTRING(result);
 }
 
+/*****************************************************************************
+ * Compact binary format
+ *
+ * The first byte of the binary representation of a temporal value is its 
+ * duration. In the compact format the duration is combined with the 
+ * TEMPORAL_WIRE_COMPACT bit and followed by the version of the format, the 
+ * flags, and the SRID, which are thus sent once for the whole value. 
+ * Then come the timestamps of all the instants of an instant set or of a 
+ * sequence, followed by their values, so that the values of the common base 
+ * types, including the coordinates of the points, are sent raw instead of 
+ * through the send and receive functions of the base type. The values of
+ * the other base types are sent with their size, as in the previous format, 
+ * which can still be received.
+ *****************************************************************************/
+
+#define TEMPORAL_WIRE_COMPACT	0x80
+#define TEMPORAL_WIRE_VERSION	1
+
+#define TEMPORAL_WIRE_LINEAR	0x01
+#define TEMPORAL_WIRE_Z			0x02
+#define TEMPORAL_WIRE_GEODETIC	0x04
+
+static void
+temporal_write_value(Datum value, Oid valuetypid, uint8 wireflags, 
+	StringInfo buf)
+{
+	if (valuetypid == BOOLOID)
+		pq_sendbyte(buf, DatumGetBool(value) ? (uint8) 1 : (uint8) 0);
+	else if (valuetypid == INT4OID)
+		pq_sendint32(buf, (uint32) DatumGetInt32(value));
+	else if (valuetypid == FLOAT8OID)
+		pq_sendfloat8(buf, DatumGetFloat8(value));
+	else if (valuetypid == type_oid(T_DOUBLE2))
+	{
+		double2 *d = (double2 *) DatumGetPointer(value);
+		pq_sendfloat8(buf, d->a);
+		pq_sendfloat8(buf, d->b);
+	}
+	else if (valuetypid == type_oid(T_DOUBLE3))
+	{
+		double3 *d = (double3 *) DatumGetPointer(value);
+		pq_sendfloat8(buf, d->a);
+		pq_sendfloat8(buf, d->b);
+		pq_sendfloat8(buf, d->c);
+	}
+	else if (valuetypid == type_oid(T_DOUBLE4))
+	{
+		double4 *d = (double4 *) DatumGetPointer(value);
+		pq_sendfloat8(buf, d->a);
+		pq_sendfloat8(buf, d->b);
+		pq_sendfloat8(buf, d->c);
+		pq_sendfloat8(buf, d->d);
+	}
+#ifdef WITH_POSTGIS
+	else if (valuetypid == type_oid(T_GEOMETRY) || 
+		valuetypid == type_oid(T_GEOGRAPHY))
+	{
+		GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(value);
+		if (wireflags & TEMPORAL_WIRE_Z)
+		{
+			POINT3DZ point = gs_get_point3dz(gs);
+			pq_sendfloat8(buf, point.x);
+			pq_sendfloat8(buf, point.y);
+			pq_sendfloat8(buf, point.z);
+		}
+		else
+		{
+			POINT2D point = gs_get_point2d(gs);
+			pq_sendfloat8(buf, point.x);
+			pq_sendfloat8(buf, point.y);
+		}
+	}
+#endif
+	else
+	{
+		bytea *bv = call_send(valuetypid, value);
+		pq_sendint32(buf, VARSIZE(bv) - VARHDRSZ);
+		pq_sendbytes(buf, VARDATA(bv), VARSIZE(bv) - VARHDRSZ);
+		pfree(bv);
+	}
+}
+
+static Datum
+temporal_read_value(StringInfo buf, Oid valuetypid, uint8 wireflags, 
+	int32 srid)
+{
+	if (valuetypid == BOOLOID)
+		return BoolGetDatum(pq_getmsgbyte(buf) != 0);
+	if (valuetypid == INT4OID)
+		return Int32GetDatum((int32) pq_getmsgint(buf, 4));
+	if (valuetypid == FLOAT8OID)
+		return Float8GetDatum(pq_getmsgfloat8(buf));
+	if (valuetypid == type_oid(T_DOUBLE2))
+	{
+		double2 *d = palloc(sizeof(double2));
+		d->a = pq_getmsgfloat8(buf);
+		d->b = pq_getmsgfloat8(buf);
+		return PointerGetDatum(d);
+	}
+	if (valuetypid == type_oid(T_DOUBLE3))
+	{
+		double3 *d = palloc(sizeof(double3));
+		d->a = pq_getmsgfloat8(buf);
+		d->b = pq_getmsgfloat8(buf);
+		d->c = pq_getmsgfloat8(buf);
+		return PointerGetDatum(d);
+	}
+	if (valuetypid == type_oid(T_DOUBLE4))
+	{
+		double4 *d = palloc(sizeof(double4));
+		d->a = pq_getmsgfloat8(buf);
+		d->b = pq_getmsgfloat8(buf);
+		d->c = pq_getmsgfloat8(buf);
+		d->d = pq_getmsgfloat8(buf);
+		return PointerGetDatum(d);
+	}
+#ifdef WITH_POSTGIS
+	if (valuetypid == type_oid(T_GEOMETRY) || 
+		valuetypid == type_oid(T_GEOGRAPHY))
+	{
+		double x = pq_getmsgfloat8(buf);
+		double y = pq_getmsgfloat8(buf);
+		LWPOINT *lwpoint;
+		if (wireflags & TEMPORAL_WIRE_Z)
+			lwpoint = lwpoint_make3dz(srid, x, y, pq_getmsgfloat8(buf));
+		else
+			lwpoint = lwpoint_make2d(srid, x, y);
+		if (wireflags & TEMPORAL_WIRE_GEODETIC)
+			lwgeom_set_geodetic((LWGEOM *) lwpoint, true);
+		Datum result = PointerGetDatum(geometry_serialize((LWGEOM *) lwpoint));
+		lwpoint_free(lwpoint);
+		return result;
+	}
+#endif
+	int size = pq_getmsgint(buf, 4);
+	StringInfoData buf2 =
+	{
+		.cursor = 0,
+		.len = size,
+		.maxlen = size,
+		.data = buf->data + buf->cursor
+	};	
+	Datum result = call_recv(valuetypid, &buf2);
+	buf->cursor += size;
+	return result;
+}
+
+/* Write the timestamps and then the values of an array of instants */
+
+static void
+temporalinstarr_write_compact(TemporalInst **instants, int count, 
+	uint8 wireflags, StringInfo buf)
+{
+	for (int i = 0; i < count; i++)
+		pq_sendint64(buf, instants[i]->t);
+	for (int i = 0; i < count; i++)
+		temporal_write_value(temporalinst_value(instants[i]), 
+			instants[i]->valuetypid, wireflags, buf);
+}
+
+/* The instants are allocated in the current memory context */
+
+static TemporalInst **
+temporalinstarr_read_compact(StringInfo buf, Oid valuetypid, int count, 
+	uint8 wireflags, int32 srid)
+{
+	TimestampTz *times = palloc(sizeof(TimestampTz) * count);
+	for (int i = 0; i < count; i++)
+		times[i] = (TimestampTz) pq_getmsgint64(buf);
+	TemporalInst **result = palloc(sizeof(TemporalInst *) * count);
+	for (int i = 0; i < count; i++)
+	{
+		Datum value = temporal_read_value(buf, valuetypid, wireflags, srid);
+		result[i] = temporalinst_make(value, times[i], valuetypid);
+	}
+	pfree(times);
+	return result;
+}
+
+static void
+temporalseq_write_compact(TemporalSeq *seq, uint8 wireflags, StringInfo buf)
+{
+	pq_sendint32(buf, (uint32) seq->count);
+	pq_sendbyte(buf, seq->period.lower_inc ? (uint8) 1 : (uint8) 0);
+	pq_sendbyte(buf, seq->period.upper_inc ? (uint8) 1 : (uint8) 0);
+	TemporalInst **instants = temporalseq_instants(seq);
+	temporalinstarr_write_compact(instants, seq->count, wireflags, buf);
+	pfree(instants);
+}
+
+static TemporalSeq *
+temporalseq_read_compact(StringInfo buf, Oid valuetypid, uint8 wireflags, 
+	int32 srid)
+{
+	int count = (int) pq_getmsgint(buf, 4);
+	bool lower_inc = (char) pq_getmsgbyte(buf);
+	bool upper_inc = (char) pq_getmsgbyte(buf);
+	TemporalInst **instants = temporalinstarr_read_compact(buf, valuetypid,
+		count, wireflags, srid);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, count,
+		lower_inc, upper_inc, wireflags & TEMPORAL_WIRE_LINEAR, true);
+	for (int i = 0; i < count; i++)
+		pfree(instants[i]);
+	pfree(instants);
+	return result;
+}
+
+static void
+temporal_write_compact(Temporal *temp, StringInfo buf)
+{
+	uint8 wireflags = 0;
+	int32 srid = 0;
+	if (MOBDB_FLAGS_GET_LINEAR(temp->flags))
+		wireflags |= TEMPORAL_WIRE_LINEAR;
+#ifdef WITH_POSTGIS
+	if (temp->valuetypid == type_oid(T_GEOMETRY) || 
+		temp->valuetypid == type_oid(T_GEOGRAPHY))
+	{
+		if (MOBDB_FLAGS_GET_Z(temp->flags))
+			wireflags |= TEMPORAL_WIRE_Z;
+		if (MOBDB_FLAGS_GET_GEODETIC(temp->flags))
+			wireflags |= TEMPORAL_WIRE_GEODETIC;
+		srid = tpoint_srid_internal(temp);
+	}
+#endif
+	pq_sendbyte(buf, TEMPORAL_WIRE_COMPACT | (uint8) temp->duration);
+	pq_sendbyte(buf, TEMPORAL_WIRE_VERSION);
+	pq_sendbyte(buf, wireflags);
+	pq_sendint32(buf, (uint32) srid);
+	if (temp->duration == TEMPORALINST)
+	{
+		TemporalInst *inst = (TemporalInst *) temp;
+		temporalinstarr_write_compact(&inst, 1, wireflags, buf);
+	}
+	else if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *) temp;
+		pq_sendint32(buf, (uint32) ti->count);
+		TemporalInst **instants = temporali_instants(ti);
+		temporalinstarr_write_compact(instants, ti->count, wireflags, buf);
+		pfree(instants);
+	}
+	else if (temp->duration == TEMPORALSEQ)
+		temporalseq_write_compact((TemporalSeq *) temp, wireflags, buf);
+	else if (temp->duration == TEMPORALS)
+	{
+		TemporalS *ts = (TemporalS *) temp;
+		pq_sendint32(buf, (uint32) ts->count);
+		for (int i = 0; i < ts->count; i++)
+			temporalseq_write_compact(temporals_seq_n(ts, i), wireflags, buf);
+	}
+}
+
+static Temporal *
+temporal_read_compact(StringInfo buf, Oid valuetypid, int16 duration)
+{
+	uint8 version = (uint8) pq_getmsgbyte(buf);
+	if (version != TEMPORAL_WIRE_VERSION)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+			errmsg("Unsupported version of the binary format: %d", version)));
+	uint8 wireflags = (uint8) pq_getmsgbyte(buf);
+	int32 srid = (int32) pq_getmsgint(buf, 4);
+	Temporal *result = NULL;
+	if (duration == TEMPORALINST)
+	{
+		TemporalInst **instants = temporalinstarr_read_compact(buf, 
+			valuetypid, 1, wireflags, srid);
+		result = (Temporal *) instants[0];
+		pfree(instants);
+	}
+	else if (duration == TEMPORALI)
+	{
+		int count = (int) pq_getmsgint(buf, 4);
+		TemporalInst **instants = temporalinstarr_read_compact(buf, 
+			valuetypid, count, wireflags, srid);
+		result = (Temporal *) temporali_from_temporalinstarr(instants, count);
+		for (int i = 0; i < count; i++)
+			pfree(instants[i]);
+		pfree(instants);
+	}
+	else if (duration == TEMPORALSEQ)
+		result = (Temporal *) temporalseq_read_compact(buf, valuetypid, 
+			wireflags, srid);
+	else if (duration == TEMPORALS)
+	{
+		int count = (int) pq_getmsgint(buf, 4);
+		TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * count);
+		for (int i = 0; i < count; i++)
+			sequences[i] = temporalseq_read_compact(buf, valuetypid, 
+				wireflags, srid);
+		result = (Temporal *) temporals_from_temporalseqarr(sequences, count,
+			wireflags & TEMPORAL_WIRE_LINEAR, false);
+		for (int i = 0; i < count; i++)
+			pfree(sequences[i]);
+		pfree(sequences);
+	}
+	return result;
+}
+
 /**
  * @brief Generic send function for temporal types (dispatch function)
  */
 void
 temporal_write(Temporal *temp, StringInfo buf)
 {
-	pq_sendbyte(buf, (uint8) temp->duration);
 	ensure_valid_duration(temp->duration);
-	if (temp->duration == TEMPORALINST)
-		temporalinst_write((TemporalInst *) temp, buf);
-	else if (temp->duration == TEMPORALI)
-		temporali_write((TemporalI *) temp, buf);
-	else if (temp->duration == TEMPORALSEQ)
-		temporalseq_write((TemporalSeq *) temp, buf);
-	else if (temp->duration == TEMPORALS)
-		temporals_write((TemporalS *) temp, buf);
+	temporal_write_compact(temp, buf);
 }
 
 PG_FUNCTION_INFO_V1(temporal_send);
@@ -717,6 +1150,13 @@ Temporal *
 temporal_read(StringInfo buf, Oid valuetypid)
 {
 	int16 type = (int16) pq_getmsgbyte(buf);
+	if (type & TEMPORAL_WIRE_COMPACT)
+	{
+		type &= ~TEMPORAL_WIRE_COMPACT;
+		ensure_valid_duration(type);
+		return temporal_read_compact(buf, valuetypid, type);
+	}
+	/* Format used before the compact binary format */
 	Temporal *result = NULL;
 	ensure_valid_duration(type);
 	if (type == TEMPORALINST)
@@ -809,10 +1249,13 @@ PG_FUNCTION_INFO_V1(temporal_enforce_typmod);
  */
 PGDLLEXPORT Datum temporal_enforce_typmod(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	/* Do not decompress the value, only the header is needed */
+	Temporal *temp = (Temporal *) PG_GETARG_VARLENA_P(0);
 	int32 typmod = PG_GETARG_INT32(1);
 	/* Check if temporal typmod is consistent with the supplied one */
 	temp = temporal_valid_typmod(temp, typmod);
+	/* Store the sequences of the column in packed form */
+	temp = temporal_typmod_pack(temp, typmod);
 	PG_RETURN_POINTER(temp);
 }
 
@@ -951,6 +1394,56 @@ temporalseq_constructor(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+/* Make a temporal float sequence from an array of values and an array of
+ * timestamps */
+
+PG_FUNCTION_INFO_V1(tfloatseq_from_arrays);
+/**
+ * @brief Returns a temporal float sequence from an array of values and an
+ * 		array of timestamps without constructing the instants one by one
+ */
+PGDLLEXPORT Datum
+tfloatseq_from_arrays(PG_FUNCTION_ARGS)
+{
+	ArrayType *valarr = PG_GETARG_ARRAYTYPE_P(0);
+	ArrayType *timearr = PG_GETARG_ARRAYTYPE_P(1);
+	bool lower_inc = PG_GETARG_BOOL(2);
+	bool upper_inc = PG_GETARG_BOOL(3);
+	bool linear = PG_GETARG_BOOL(4);
+	int count = ArrayGetNItems(ARR_NDIM(valarr), ARR_DIMS(valarr));
+	if (count == 0)
+	{
+		PG_FREE_IF_COPY(valarr, 0);
+		PG_FREE_IF_COPY(timearr, 1);
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("A temporal sequence must have at least one temporal instant")));
+	}
+	if (ArrayGetNItems(ARR_NDIM(timearr), ARR_DIMS(timearr)) != count)
+	{
+		PG_FREE_IF_COPY(valarr, 0);
+		PG_FREE_IF_COPY(timearr, 1);
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("The input arrays must have the same number of elements")));
+	}
+
+	Datum *values = datumarr_extract(valarr, &count);
+	TimestampTz *times = timestamparr_extract(timearr, &count);
+	/* The values are passed by value and thus directly set in the instants */
+	TemporalInst *model = temporalinst_make(Float8GetDatum(0), times[0],
+		FLOAT8OID);
+	TemporalInst **instants = temporalinstarr_from_model(model, times, count);
+	for (int i = 0; i < count; i++)
+		*temporalinst_value_ptr(instants[i]) = values[i];
+	Temporal *result = (Temporal *)temporalseq_from_temporalinstarr(instants, 
+		count, lower_inc, upper_inc, linear, true);
+
+	pfree(instants[0]); pfree(instants); pfree(model);
+	pfree(values); pfree(times);
+	PG_FREE_IF_COPY(valarr, 0);
+	PG_FREE_IF_COPY(timearr, 1);
+	PG_RETURN_POINTER(result);
+}
+
 /* Make a TemporalS from an array of TemporalSeq */
 
 PG_FUNCTION_INFO_V1(temporals_constructor);
@@ -1009,12 +1502,43 @@ PG_FUNCTION_INFO_V1(temporal_append_instant);
 PGDLLEXPORT Datum
 temporal_append_instant(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Temporal *inst = PG_GETARG_TEMPORAL(1);
 	if (inst->duration != TEMPORALINST) 
 		ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR), 
 			errmsg("The second argument must be of instant duration")));
+
+	/* Append in place to a read-write expanded sequence */
+	if (VARATT_IS_EXTERNAL_EXPANDED_RW(DatumGetPointer(PG_GETARG_DATUM(0))))
+	{
+		ExpandedTemporalSeq *eseq = (ExpandedTemporalSeq *) 
+			DatumGetEOHP(PG_GETARG_DATUM(0));
+		/* Views of a sequence set are flattened below */
+		if (! eseq->seqset)
+		{
+			expanded_temporalseq_append_instant(eseq, (TemporalInst *)inst);
+			PG_FREE_IF_COPY(inst, 1);
+			PG_RETURN_DATUM(EOHPGetRWDatum(&eseq->hdr));
+		}
+	}
+
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	assert(temp->valuetypid == inst->valuetypid);
+	/* Expand the sequence so that subsequent appends are done in place.
+	 * When the function is the transition function of an aggregate, the
+	 * object is created in the aggregate context, so that it is kept as the
+	 * transition value without being copied */
+	if (temp->duration == TEMPORALSEQ)
+	{
+		MemoryContext aggcontext;
+		if (! AggCheckCallContext(fcinfo, &aggcontext))
+			aggcontext = CurrentMemoryContext;
+		Datum result = expand_temporalseq((TemporalSeq *)temp, aggcontext);
+		expanded_temporalseq_append_instant(
+			(ExpandedTemporalSeq *) DatumGetEOHP(result), (TemporalInst *)inst);
+		PG_FREE_IF_COPY(temp, 0);
+		PG_FREE_IF_COPY(inst, 1);
+		PG_RETURN_DATUM(result);
+	}
 
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
@@ -1036,6 +1560,321 @@ temporal_append_instant(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Merge functions
+ ****************************************************************************/
+
+/*
+ * Fragment of a merge, whose items are its instants when the result is a
+ * temporal instant set and its sequences otherwise, together with the
+ * position of the next item to merge
+ */
+typedef struct
+{
+	Temporal **items;
+	int count;
+	int pos;
+	bool converted;			/* The items are sequences built from instants */
+} MergeFragment;
+
+static TimestampTz
+merge_item_lower(Temporal *item, bool *lower_inc)
+{
+	if (item->duration == TEMPORALINST)
+	{
+		*lower_inc = true;
+		return ((TemporalInst *) item)->t;
+	}
+	*lower_inc = ((TemporalSeq *) item)->period.lower_inc;
+	return ((TemporalSeq *) item)->period.lower;
+}
+
+/*
+ * Comparator of the binary heap of the fragments, whose first element is the
+ * fragment whose next item starts first. Since the binary heap returns the
+ * greatest element first, the comparison is reversed.
+ */
+static int
+merge_fragment_cmp(Datum a, Datum b, void *arg)
+{
+	MergeFragment *frags = (MergeFragment *) arg;
+	MergeFragment *frag1 = &frags[DatumGetInt32(a)];
+	MergeFragment *frag2 = &frags[DatumGetInt32(b)];
+	bool lower_inc1, lower_inc2;
+	TimestampTz t1 = merge_item_lower(frag1->items[frag1->pos], &lower_inc1);
+	TimestampTz t2 = merge_item_lower(frag2->items[frag2->pos], &lower_inc2);
+	int cmp = timestamp_cmp_internal(t1, t2);
+	if (cmp == 0 && lower_inc1 != lower_inc2)
+		cmp = lower_inc1 ? -1 : 1;
+	return -cmp;
+}
+
+static void
+merge_ensure_same_value(Datum value1, Datum value2, Oid valuetypid)
+{
+	if (! datum_eq(value1, value2, valuetypid))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The temporal values have different value at their overlapping timestamp")));
+}
+
+/* Whether the first sequence restricted to the period of the second one is
+ * equal to the second one */
+
+static bool
+merge_temporalseq_covers(TemporalSeq *seq1, TemporalSeq *seq2)
+{
+	if (! contains_period_period_internal(&seq1->period, &seq2->period))
+		return false;
+	TemporalSeq *seq = temporalseq_at_period(seq1, &seq2->period);
+	bool result = (seq != NULL && temporalseq_eq(seq, seq2));
+	if (seq != NULL)
+		pfree(seq);
+	return result;
+}
+
+/*
+ * Append a sequence to the merged sequences, whose last one does not start
+ * after it. Sequences sharing the instant at which the previous one ends
+ * are joined. Overlapping sequences are only accepted when one of them is
+ * a fragment of the other one, e.g., when the same fragment is merged twice.
+ * Returns the new number of merged sequences.
+ */
+static int
+merge_append_seq(TemporalSeq **sequences, int k, TemporalSeq *seq,
+	TemporalSeq **joined, int *njoined)
+{
+	TemporalSeq *last = sequences[k - 1];
+	int cmp = timestamp_cmp_internal(last->period.upper, seq->period.lower);
+	if (cmp < 0 || (cmp == 0 &&
+		(! last->period.upper_inc || ! seq->period.lower_inc)))
+	{
+		sequences[k++] = seq;
+		return k;
+	}
+	if (cmp == 0)
+	{
+		merge_ensure_same_value(
+			temporalinst_value(temporalseq_inst_n(last, last->count - 1)),
+			temporalinst_value(temporalseq_inst_n(seq, 0)), seq->valuetypid);
+		if (seq->count == 1)
+			return k;
+		if (last->count == 1)
+		{
+			sequences[k - 1] = seq;
+			return k;
+		}
+		TemporalInst **instants = palloc(sizeof(TemporalInst *) *
+			(last->count + seq->count - 1));
+		int n = 0;
+		for (int i = 0; i < last->count; i++)
+			instants[n++] = temporalseq_inst_n(last, i);
+		for (int i = 1; i < seq->count; i++)
+			instants[n++] = temporalseq_inst_n(seq, i);
+		TemporalSeq *newseq = temporalseq_from_temporalinstarr(instants, n,
+			last->period.lower_inc, seq->period.upper_inc,
+			MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
+		pfree(instants);
+		joined[(*njoined)++] = newseq;
+		sequences[k - 1] = newseq;
+		return k;
+	}
+	if (merge_temporalseq_covers(last, seq))
+		return k;
+	if (merge_temporalseq_covers(seq, last))
+	{
+		sequences[k - 1] = seq;
+		return k;
+	}
+	ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+		errmsg("The temporal values cannot overlap on time")));
+}
+
+/*
+ * Merge an array of temporal values. The result is a temporal instant or
+ * instant set if all the values are instants or instant sets, otherwise it
+ * is a temporal sequence or sequence set. The instants and the sequences of the values are merged in
+ * a single pass using a binary heap of the values keyed by the start of
+ * their next item, and the result is normalized when it is built.
+ */
+Temporal *
+temporalarr_merge(Temporal **temparr, int count)
+{
+	/* Determine the duration and the interpolation of the result */
+	bool seqmode = false, linear = false;
+	for (int i = 0; i < count; i++)
+	{
+		if (temparr[i]->duration != TEMPORALSEQ &&
+			temparr[i]->duration != TEMPORALS)
+			continue;
+		if (! seqmode)
+		{
+			seqmode = true;
+			linear = MOBDB_FLAGS_GET_LINEAR(temparr[i]->flags);
+		}
+		else if (MOBDB_FLAGS_GET_LINEAR(temparr[i]->flags) != linear)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				errmsg("Input values must have the same interpolation")));
+	}
+
+	/* Items of the fragments */
+	MergeFragment *frags = palloc(sizeof(MergeFragment) * count);
+	int totalcount = 0;
+	for (int i = 0; i < count; i++)
+	{
+		Temporal *temp = temparr[i];
+		MergeFragment *frag = &frags[i];
+		frag->pos = 0;
+		frag->converted = false;
+		ensure_valid_duration(temp->duration);
+		if (temp->duration == TEMPORALINST || temp->duration == TEMPORALI)
+		{
+			frag->count = temp->duration == TEMPORALINST ? 1 :
+				((TemporalI *) temp)->count;
+			frag->items = palloc(sizeof(Temporal *) * frag->count);
+			for (int j = 0; j < frag->count; j++)
+			{
+				TemporalInst *inst = temp->duration == TEMPORALINST ?
+					(TemporalInst *) temp : temporali_inst_n((TemporalI *) temp, j);
+				frag->items[j] = seqmode ? 
+					(Temporal *) temporalseq_from_temporalinstarr(&inst, 1,
+						true, true, linear, false) :
+					(Temporal *) inst;
+			}
+			frag->converted = seqmode;
+		}
+		else if (temp->duration == TEMPORALSEQ)
+		{
+			frag->count = 1;
+			frag->items = palloc(sizeof(Temporal *));
+			frag->items[0] = temp;
+		}
+		else
+		{
+			frag->count = ((TemporalS *) temp)->count;
+			frag->items = (Temporal **) temporals_sequences((TemporalS *) temp);
+		}
+		totalcount += frag->count;
+	}
+
+	binaryheap *heap = binaryheap_allocate(count, merge_fragment_cmp, frags);
+	for (int i = 0; i < count; i++)
+		binaryheap_add_unordered(heap, Int32GetDatum(i));
+	binaryheap_build(heap);
+
+	Temporal **items = palloc(sizeof(Temporal *) * totalcount);
+	TemporalSeq **joined = seqmode ?
+		palloc(sizeof(TemporalSeq *) * totalcount) : NULL;
+	int k = 0, njoined = 0;
+	while (! binaryheap_empty(heap))
+	{
+		int i = DatumGetInt32(binaryheap_first(heap));
+		MergeFragment *frag = &frags[i];
+		Temporal *item = frag->items[frag->pos++];
+		if (frag->pos < frag->count)
+			binaryheap_replace_first(heap, Int32GetDatum(i));
+		else
+			binaryheap_remove_first(heap);
+		if (k == 0)
+			items[k++] = item;
+		else if (seqmode)
+			k = merge_append_seq((TemporalSeq **) items, k, (TemporalSeq *) item,
+				joined, &njoined);
+		else
+		{
+			TemporalInst *last = (TemporalInst *) items[k - 1];
+			TemporalInst *inst = (TemporalInst *) item;
+			if (timestamp_cmp_internal(last->t, inst->t) == 0)
+				merge_ensure_same_value(temporalinst_value(last),
+					temporalinst_value(inst), inst->valuetypid);
+			else
+				items[k++] = item;
+		}
+	}
+
+	Temporal *result;
+	if (! seqmode)
+		result = (k == 1) ?
+			(Temporal *) temporalinst_copy((TemporalInst *) items[0]) :
+			(Temporal *) temporali_from_temporalinstarr((TemporalInst **) items, k);
+	else
+	{
+		TemporalS *ts = temporals_from_temporalseqarr((TemporalSeq **) items, k,
+			linear, true);
+		if (ts->count == 1)
+		{
+			result = (Temporal *) temporalseq_copy(temporals_seq_n(ts, 0));
+			pfree(ts);
+		}
+		else
+			result = (Temporal *) ts;
+	}
+
+	for (int i = 0; i < njoined; i++)
+		pfree(joined[i]);
+	for (int i = 0; i < count; i++)
+	{
+		if (frags[i].converted)
+			for (int j = 0; j < frags[i].count; j++)
+				pfree(frags[i].items[j]);
+		pfree(frags[i].items);
+	}
+	if (joined != NULL)
+		pfree(joined);
+	pfree(items); pfree(frags);
+	binaryheap_free(heap);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(temporal_merge);
+/**
+ * @brief Merge two temporal values, any of which may be null
+ */
+PGDLLEXPORT Datum
+temporal_merge(PG_FUNCTION_ARGS)
+{
+	if (PG_ARGISNULL(0) && PG_ARGISNULL(1))
+		PG_RETURN_NULL();
+	if (PG_ARGISNULL(0) || PG_ARGISNULL(1))
+	{
+		Temporal *temp = PG_ARGISNULL(0) ? PG_GETARG_TEMPORAL(1) :
+			PG_GETARG_TEMPORAL(0);
+		PG_RETURN_POINTER(temp);
+	}
+	Temporal *temparr[2];
+	temparr[0] = PG_GETARG_TEMPORAL(0);
+	temparr[1] = PG_GETARG_TEMPORAL(1);
+	Temporal *result = temporalarr_merge(temparr, 2);
+	PG_FREE_IF_COPY(temparr[0], 0);
+	PG_FREE_IF_COPY(temparr[1], 1);
+	PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(temporal_merge_array);
+/**
+ * @brief Merge an array of temporal values, ignoring the null elements
+ */
+PGDLLEXPORT Datum
+temporal_merge_array(PG_FUNCTION_ARGS)
+{
+	ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+	Datum *values;
+	bool *nulls;
+	int count;
+	deconstruct_array(array, ARR_ELEMTYPE(array), -1, false, 'd', 
+		&values, &nulls, &count);
+	Temporal **temparr = palloc(sizeof(Temporal *) * count);
+	int k = 0;
+	for (int i = 0; i < count; i++)
+		if (! nulls[i])
+			temparr[k++] = DatumGetTemporal(values[i]);
+	Temporal *result = k == 0 ? NULL : temporalarr_merge(temparr, k);
+	pfree(temparr); pfree(values); pfree(nulls);
+	PG_FREE_IF_COPY(array, 0);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
 /*****************************************************************************
  * Cast functions
  *****************************************************************************/
@@ -1130,7 +1969,7 @@ PG_FUNCTION_INFO_V1(temporal_to_period);
 PGDLLEXPORT Datum
 temporal_to_period(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Temporal *temp = PG_GETARG_TEMPORAL_HEADER(0);
 	Period *result = (Period *) palloc(sizeof(Period));
 	temporal_period(result, temp);
 	PG_FREE_IF_COPY(temp, 0);
@@ -1327,6 +2166,59 @@ temporal_mem_size(PG_FUNCTION_ARGS)
 	PG_RETURN_DATUM(result);
 }
 
+PG_FUNCTION_INFO_V1(temporal_mem_layout);
+/**
+ * @brief Returns the breakdown of the bytes of the temporal value by their
+ * use, together with its size on disk and the ratio of its TOAST compression.
+ * Compressed sequences are not decompressed and the size of their bit stream
+ * is reported as base values.
+ */
+PGDLLEXPORT Datum
+temporal_mem_layout(PG_FUNCTION_ARGS)
+{
+	TupleDesc tupdesc;
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("function returning record called in context "
+				"that cannot accept type record")));
+	tupdesc = BlessTupleDesc(tupdesc);
+
+	Size disk = toast_datum_size(PG_GETARG_DATUM(0));
+	/* Do not use PG_GETARG_TEMPORAL, it decompresses the argument */
+	Temporal *temp = (Temporal *) PG_GETARG_VARLENA_P(0);
+	ensure_valid_duration(temp->duration);
+	TemporalLayout layout;
+	memset(&layout, 0, sizeof(TemporalLayout));
+	if (temp->duration == TEMPORALINST)
+		temporalinst_layout((TemporalInst *)temp, &layout);
+	else if (temp->duration == TEMPORALI)
+		temporali_layout((TemporalI *)temp, &layout);
+	else if (temp->duration == TEMPORALSEQ)
+		temporalseq_layout((TemporalSeq *)temp, &layout);
+	else if (temp->duration == TEMPORALS)
+		temporals_layout((TemporalS *)temp, &layout);
+	size_t total = VARSIZE(temp);
+	layout.headers = total - layout.offsets - layout.instant_headers -
+		layout.timestamps - layout.base_values - layout.bbox - layout.trajectory;
+
+	Datum values[10];
+	bool isnull[10] = {false, false, false, false, false, false, false, false,
+		false, false};
+	values[0] = Int32GetDatum((int32) total);
+	values[1] = Int32GetDatum((int32) disk);
+	values[2] = Float8GetDatum((double) total / disk);
+	values[3] = Int32GetDatum((int32) layout.headers);
+	values[4] = Int32GetDatum((int32) layout.offsets);
+	values[5] = Int32GetDatum((int32) layout.instant_headers);
+	values[6] = Int32GetDatum((int32) layout.timestamps);
+	values[7] = Int32GetDatum((int32) layout.base_values);
+	values[8] = Int32GetDatum((int32) layout.bbox);
+	values[9] = Int32GetDatum((int32) layout.trajectory);
+	HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
 /**
  * @brief Returns the values taken by the temporal value (dispatch function)
  */
@@ -1499,6 +2391,161 @@ temporal_bbox(void *box, const Temporal *temp)
 		temporals_bbox(box, (TemporalS *)temp);
 }
 
+/**
+ * @brief Copy in the last argument the bytes of a datum starting at the 
+ *		position by fetching only the corresponding slice
+ */
+static void
+temporal_slice_copy(Datum value, size_t pos, size_t size, void *result)
+{
+	struct varlena *slice = PG_DETOAST_DATUM_SLICE(value, pos - VARHDRSZ, size);
+	MOBDB_STAT_ADD(detoast_bytes, VARSIZE(slice));
+	memcpy(result, VARDATA(slice), size);
+	pfree(slice);
+}
+
+/**
+ * @brief Set the arguments to the bounding box, the period, and the number
+ *		of instants of the temporal value by fetching only the slices of the
+ *		datum containing them instead of detoasting the whole value
+ * @return False if the value is not stored out of line without compression,
+ *		in which case the caller must detoast the whole value. As for the
+ *		function temporalseq_fetch_slice, PostgreSQL must decompress the
+ *		whole datum to return a slice of a compressed value.
+ */
+static bool
+temporal_bbox_slice1(Datum value, Oid *valuetypid, void *box, Period *period,
+	int *numinst)
+{
+	struct varlena *attr = (struct varlena *) DatumGetPointer(value);
+	if (! VARATT_IS_EXTERNAL_ONDISK(attr))
+		return false;
+	struct varatt_external toast_pointer;
+	VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+	if (VARATT_EXTERNAL_IS_COMPRESSED(toast_pointer))
+		return false;
+
+	/* Header of the datum, which is the largest for TemporalSeq */
+	TemporalSeq *header = (TemporalSeq *) PG_DETOAST_DATUM_SLICE(value, 0,
+		offsetof(TemporalSeq, offsets) - VARHDRSZ);
+	MOBDB_STAT_ADD(detoast_bytes, VARSIZE(header));
+	*valuetypid = header->valuetypid;
+	size_t bboxsize = temporal_bbox_size(header->valuetypid);
+	/* Sequence sets in the first on-disk format have no directory of
+	 * periods and are detoasted */
+	if (bboxsize == 0 || MOBDB_FLAGS_GET_COMPRESSED(header->flags) ||
+		(header->duration != TEMPORALI && header->duration != TEMPORALSEQ &&
+		 header->duration != TEMPORALS) ||
+		(header->duration == TEMPORALS &&
+		 ! (((TemporalS *) header)->format & TEMPORALS_PERIODS)))
+	{
+		pfree(header);
+		return false;
+	}
+
+	/* Position of the array of offsets and of the start of the data, as
+	 * in the functions temporali_bbox_ptr, temporalseq_bbox_ptr, and 
+	 * temporals_bbox_ptr */
+	int count;
+	size_t offsets, datastart;
+	if (header->duration == TEMPORALI)
+	{
+		count = *numinst = ((TemporalI *) header)->count;
+		offsets = offsetof(TemporalI, offsets);
+		datastart = offsets + (count + 1) * sizeof(size_t);
+	}
+	else if (header->duration == TEMPORALSEQ)
+	{
+		count = *numinst = header->count;
+		offsets = offsetof(TemporalSeq, offsets);
+		datastart = offsets + (count + 2) * sizeof(size_t);
+	}
+	else
+	{
+		count = ((TemporalS *) header)->count;
+		*numinst = ((TemporalS *) header)->totalcount;
+		offsets = offsetof(TemporalS, offsets);
+		datastart = offsets + (count + 1) * sizeof(size_t) + 
+			double_pad(sizeof(Period) * count);
+	}
+
+	/* Bounding box, whose offset follows those of the elements. The one of
+	 * a sequence whose bounding box is a period is its period. */
+	if (header->duration == TEMPORALSEQ && bboxsize == sizeof(Period))
+		memcpy(box, &header->period, sizeof(Period));
+	else
+	{
+		size_t bboxoffset;
+		temporal_slice_copy(value, offsets + count * sizeof(size_t), 
+			sizeof(size_t), &bboxoffset);
+		temporal_slice_copy(value, datastart + bboxoffset, bboxsize, box);
+	}
+
+	/* Period, which is not needed for computing the abbreviated keys */
+	if (period == NULL)
+		;
+	else if (header->duration == TEMPORALI)
+	{
+		/* Timestamps of the first and the last instants */
+		size_t first, last;
+		temporal_slice_copy(value, offsets, sizeof(size_t), &first);
+		temporal_slice_copy(value, offsets + (count - 1) * sizeof(size_t), 
+			sizeof(size_t), &last);
+		TimestampTz lower, upper;
+		temporal_slice_copy(value, datastart + first + 
+			offsetof(TemporalInst, t), sizeof(TimestampTz), &lower);
+		temporal_slice_copy(value, datastart + last + 
+			offsetof(TemporalInst, t), sizeof(TimestampTz), &upper);
+		period_set(period, lower, upper, true, true);
+	}
+	else if (header->duration == TEMPORALSEQ)
+		memcpy(period, &header->period, sizeof(Period));
+	else
+	{
+		/* Periods of the first and the last sequences */
+		size_t periods = offsets + (count + 1) * sizeof(size_t);
+		Period first, last;
+		temporal_slice_copy(value, periods, sizeof(Period), &first);
+		temporal_slice_copy(value, periods + (count - 1) * sizeof(Period), 
+			sizeof(Period), &last);
+		period_set(period, first.lower, last.upper, first.lower_inc, 
+			last.upper_inc);
+	}
+	pfree(header);
+	return true;
+}
+
+bool
+temporal_bbox_slice(Datum value, void *box, Period *period, int *numinst)
+{
+	Oid valuetypid;
+	return temporal_bbox_slice1(value, &valuetypid, box, period, numinst);
+}
+
+/**
+ * @brief Set the first argument to the bounding box of the temporal value
+ *		in the datum. The bounding box of out-of-line values is fetched from
+ *		the slices of the datum containing it, and the datum is only copied
+ *		when it is compressed or has a short header. Contrary to 
+ *		DatumGetTemporal, compressed sequences are not decompressed since
+ *		their bounding box is kept in their header.
+ */
+void
+temporal_bbox_datum(void *box, Datum value)
+{
+	Oid valuetypid;
+	int numinst;
+	if (temporal_bbox_slice1(value, &valuetypid, box, NULL, &numinst))
+		return;
+	Temporal *temp = (Temporal *) PG_DETOAST_DATUM(value);
+	Temporal *temp1 = pg_getarg_temporal_header(temp);
+	temporal_bbox(box, temp1);
+	if (temp1 != temp)
+		pfree(temp1);
+	if ((Pointer) temp != DatumGetPointer(value))
+		pfree(temp);
+}
+
 PG_FUNCTION_INFO_V1(tnumber_to_tbox);
 /**
  * @brief Returns the bounding box of the temporal value
@@ -1506,7 +2553,7 @@ PG_FUNCTION_INFO_V1(tnumber_to_tbox);
 PGDLLEXPORT Datum
 tnumber_to_tbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Temporal *temp = PG_GETARG_TEMPORAL_HEADER(0);
 	TBOX *result = palloc0(sizeof(TBOX));
 	temporal_bbox(result, temp);
 	PG_FREE_IF_COPY(temp, 0);
@@ -1566,7 +2613,10 @@ PG_FUNCTION_INFO_V1(temporal_start_value);
 PGDLLEXPORT Datum
 temporal_start_value(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	ExpandedTemporalSeq *eseq = expanded_temporalseq_get(PG_GETARG_DATUM(0));
+	if (eseq != NULL)
+		PG_RETURN_DATUM(temporalinst_value_copy(eseq->instants[0]));
+	Temporal *temp = PG_GETARG_TEMPORAL_CACHED(0);
 	Datum result = 0;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST) 
@@ -1580,7 +2630,6 @@ temporal_start_value(PG_FUNCTION_ARGS)
 		TemporalSeq *seq = temporals_seq_n((TemporalS *)temp, 0);
 		result = temporalinst_value_copy(temporalseq_inst_n(seq, 0));
 	}
-	PG_FREE_IF_COPY(temp, 0);	
 	PG_RETURN_DATUM(result);
 }
 
@@ -1591,7 +2640,10 @@ PG_FUNCTION_INFO_V1(temporal_end_value);
 PGDLLEXPORT Datum
 temporal_end_value(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	ExpandedTemporalSeq *eseq = expanded_temporalseq_get(PG_GETARG_DATUM(0));
+	if (eseq != NULL)
+		PG_RETURN_DATUM(temporalinst_value_copy(eseq->instants[eseq->count - 1]));
+	Temporal *temp = PG_GETARG_TEMPORAL_CACHED(0);
 	Datum result = 0;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST) 
@@ -1607,7 +2659,6 @@ temporal_end_value(PG_FUNCTION_ARGS)
 		TemporalSeq *seq = temporals_seq_n((TemporalS *)temp, ((TemporalS *)temp)->count - 1);
 		result = temporalinst_value_copy(temporalseq_inst_n(seq, seq->count - 1));
 	}
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_DATUM(result);
 }
 
@@ -1640,9 +2691,8 @@ PG_FUNCTION_INFO_V1(temporal_min_value);
 PGDLLEXPORT Datum
 temporal_min_value(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Temporal *temp = PG_GETARG_TEMPORAL_CACHED(0);
 	Datum result = temporal_min_value_internal(temp);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_DATUM(result);
 }
 
@@ -1653,7 +2703,7 @@ PG_FUNCTION_INFO_V1(temporal_max_value);
 Datum
 temporal_max_value(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Temporal *temp = PG_GETARG_TEMPORAL_CACHED(0);
 	Datum result = 0;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST) 
@@ -1667,7 +2717,6 @@ temporal_max_value(PG_FUNCTION_ARGS)
 	else if (temp->duration == TEMPORALS) 
 		result = datum_copy(temporals_max_value((TemporalS *)temp),
 			temp->valuetypid);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_DATUM(result);
 }
 
@@ -1678,7 +2727,15 @@ PG_FUNCTION_INFO_V1(temporal_timespan);
 PGDLLEXPORT Datum
 temporal_timespan(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	ExpandedTemporalSeq *eseq = expanded_temporalseq_get(PG_GETARG_DATUM(0));
+	if (eseq != NULL)
+	{
+		Period p;
+		period_set(&p, eseq->instants[0]->t, eseq->instants[eseq->count - 1]->t,
+			eseq->lower_inc, eseq->upper_inc);
+		PG_RETURN_POINTER(period_timespan_internal(&p));
+	}
+	Temporal *temp = PG_GETARG_TEMPORAL_CACHED(0);
 	Datum result = 0;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST || temp->duration == TEMPORALI) 
@@ -1692,7 +2749,6 @@ temporal_timespan(PG_FUNCTION_ARGS)
 		result = temporalseq_timespan((TemporalSeq *)temp);
 	else if (temp->duration == TEMPORALS) 
 		result = temporals_timespan((TemporalS *)temp);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_DATUM(result);
 }
 
@@ -1820,7 +2876,10 @@ PG_FUNCTION_INFO_V1(temporal_num_instants);
 PGDLLEXPORT Datum
 temporal_num_instants(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	ExpandedTemporalSeq *eseq = expanded_temporalseq_get(PG_GETARG_DATUM(0));
+	if (eseq != NULL)
+		PG_RETURN_INT32(eseq->count);
+	Temporal *temp = PG_GETARG_TEMPORAL_HEADER(0);
 	int result = 0;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST) 
@@ -1979,7 +3038,10 @@ PG_FUNCTION_INFO_V1(temporal_start_timestamp);
 PGDLLEXPORT Datum
 temporal_start_timestamp(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	ExpandedTemporalSeq *eseq = expanded_temporalseq_get(PG_GETARG_DATUM(0));
+	if (eseq != NULL)
+		PG_RETURN_TIMESTAMPTZ(eseq->instants[0]->t);
+	Temporal *temp = PG_GETARG_TEMPORAL_HEADER(0);
 	TimestampTz result = temporal_start_timestamp_internal(temp);
 	PG_FREE_IF_COPY(temp, 0);	
 	PG_RETURN_TIMESTAMPTZ(result);
@@ -1992,7 +3054,10 @@ PG_FUNCTION_INFO_V1(temporal_end_timestamp);
 PGDLLEXPORT Datum
 temporal_end_timestamp(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	ExpandedTemporalSeq *eseq = expanded_temporalseq_get(PG_GETARG_DATUM(0));
+	if (eseq != NULL)
+		PG_RETURN_TIMESTAMPTZ(eseq->instants[eseq->count - 1]->t);
+	Temporal *temp = PG_GETARG_TEMPORAL_HEADER(0);
 	TimestampTz result = 0;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST) 
@@ -2014,7 +3079,7 @@ PG_FUNCTION_INFO_V1(temporal_num_timestamps);
 PGDLLEXPORT Datum
 temporal_num_timestamps(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Temporal *temp = PG_GETARG_TEMPORAL_HEADER(0);
 	int result = 0;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST) 
@@ -2118,6 +3183,43 @@ temporal_shift(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+PG_FUNCTION_INFO_V1(temporal_tscale);
+/**
+ * @brief Scale the time span of the temporal value to an interval, keeping
+ *		its start timestamp
+ */
+PGDLLEXPORT Datum
+temporal_tscale(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Interval *duration = PG_GETARG_INTERVAL_P(1);
+	ensure_valid_duration(temp->duration);
+	Period p;
+	temporal_period(&p, temp);
+	TimestampTz upper = timestamp_shift(p.lower, duration);
+	if (upper <= p.lower)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+			errmsg("The interval must be positive")));
+	/* A temporal value with a single timestamp is not scaled */
+	if (p.lower == p.upper)
+	{
+		Temporal *result = temporal_copy(temp);
+		PG_FREE_IF_COPY(temp, 0);
+		PG_RETURN_POINTER(result);
+	}
+
+	double scale = (double) (upper - p.lower) / (double) (p.upper - p.lower);
+	Temporal *result = NULL;
+	if (temp->duration == TEMPORALI) 
+		result = (Temporal *)temporali_tscale((TemporalI *)temp, p.lower, scale);
+	else if (temp->duration == TEMPORALSEQ) 
+		result = (Temporal *)temporalseq_tscale((TemporalSeq *)temp, p.lower, scale);
+	else if (temp->duration == TEMPORALS) 
+		result = (Temporal *)temporals_tscale((TemporalS *)temp, p.lower, scale);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_POINTER(result);
+}
+
 /*****************************************************************************
  * Ever/always comparison operators
  *****************************************************************************/
@@ -2588,23 +3690,28 @@ PGDLLEXPORT Datum
 tnumber_at_range(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	RangeType *range = PG_GETARG_RANGE_P(1);
+	RangeBounds bounds;
+	range_bounds_fn(&bounds, fcinfo, 1);
+	if (bounds.empty)
+	{
+		PG_FREE_IF_COPY(temp, 0);
+		PG_RETURN_NULL();
+	}
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST) 
 		result = (Temporal *)tnumberinst_at_range(
-			(TemporalInst *)temp, range);
+			(TemporalInst *)temp, &bounds);
 	else if (temp->duration == TEMPORALI) 
 		result = (Temporal *)tnumberi_at_range(
-			(TemporalI *)temp, range);
+			(TemporalI *)temp, &bounds);
 	else if (temp->duration == TEMPORALSEQ) 
 		result = (Temporal *)tnumberseq_at_range(
-			(TemporalSeq *)temp, range);
+			(TemporalSeq *)temp, &bounds);
 	else if (temp->duration == TEMPORALS) 
 		result = (Temporal *)tnumbers_at_range(
-			(TemporalS *)temp, range);
+			(TemporalS *)temp, &bounds);
 	PG_FREE_IF_COPY(temp, 0);
-	PG_FREE_IF_COPY(range, 1);
 	if (result == NULL)
 		PG_RETURN_NULL();
 	PG_RETURN_POINTER(result);
@@ -2618,23 +3725,29 @@ PGDLLEXPORT Datum
 tnumber_minus_range(PG_FUNCTION_ARGS)
 {
 	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	RangeType *range = PG_GETARG_RANGE_P(1);
+	RangeBounds bounds;
+	range_bounds_fn(&bounds, fcinfo, 1);
+	if (bounds.empty)
+	{
+		Temporal *result = temporal_copy(temp);
+		PG_FREE_IF_COPY(temp, 0);
+		PG_RETURN_POINTER(result);
+	}
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST) 
 		result = (Temporal *)tnumberinst_minus_range(
-			(TemporalInst *)temp, range);
+			(TemporalInst *)temp, &bounds);
 	else if (temp->duration == TEMPORALI) 
 		result = (Temporal *)tnumberi_minus_range(
-			(TemporalI *)temp, range);
+			(TemporalI *)temp, &bounds);
 	else if (temp->duration == TEMPORALSEQ) 
 		result = (Temporal *)tnumberseq_minus_range(
-			(TemporalSeq *)temp, range);
+			(TemporalSeq *)temp, &bounds);
 	else if (temp->duration == TEMPORALS) 
 		result = (Temporal *)tnumbers_minus_range(
-			(TemporalS *)temp, range);
+			(TemporalS *)temp, &bounds);
 	PG_FREE_IF_COPY(temp, 0);
-	PG_FREE_IF_COPY(range, 1);
 	if (result == NULL)
 		PG_RETURN_NULL();
 	PG_RETURN_POINTER(result);
@@ -2662,21 +3775,27 @@ tnumber_at_ranges(PG_FUNCTION_ARGS)
 	int newcount = count;
 	if (count > 1)
 		normranges = rangearr_normalize(ranges, &newcount);
+	int boundcount = newcount;
+	RangeBounds *normbounds = rangearr_bounds(normranges, &boundcount);
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
-	if (temp->duration == TEMPORALINST) 
+	/* All the ranges are empty */
+	if (boundcount == 0)
+		result = NULL;
+	else if (temp->duration == TEMPORALINST) 
 		result = (Temporal *)tnumberinst_at_ranges(
-			(TemporalInst *)temp, normranges, newcount);
+			(TemporalInst *)temp, normbounds, boundcount);
 	else if (temp->duration == TEMPORALI) 
 		result = (Temporal *)tnumberi_at_ranges(
-			(TemporalI *)temp, normranges, newcount);
+			(TemporalI *)temp, normbounds, boundcount);
 	else if (temp->duration == TEMPORALSEQ) 
 		result = (Temporal *)tnumberseq_at_ranges(
-			(TemporalSeq *)temp, normranges, newcount);
+			(TemporalSeq *)temp, normbounds, boundcount);
 	else if (temp->duration == TEMPORALS) 
 		result = (Temporal *)tnumbers_at_ranges(
-			(TemporalS *)temp, normranges, newcount);
+			(TemporalS *)temp, normbounds, boundcount);
 
+	pfree(normbounds);
 	pfree(ranges);
 	if (count > 1)
 	{
@@ -2714,21 +3833,27 @@ tnumber_minus_ranges(PG_FUNCTION_ARGS)
 	int newcount = count;
 	if (count > 1)
 		normranges = rangearr_normalize(ranges, &newcount);
+	int boundcount = newcount;
+	RangeBounds *normbounds = rangearr_bounds(normranges, &boundcount);
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
-	if (temp->duration == TEMPORALINST) 
+	/* All the ranges are empty */
+	if (boundcount == 0)
+		result = temporal_copy(temp);
+	else if (temp->duration == TEMPORALINST) 
 		result = (Temporal *)tnumberinst_minus_ranges((TemporalInst *)temp,
-			normranges, newcount);
+			normbounds, boundcount);
 	else if (temp->duration == TEMPORALI) 
 		result = (Temporal *)tnumberi_minus_ranges((TemporalI *)temp,
-			normranges, newcount);
+			normbounds, boundcount);
 	else if (temp->duration == TEMPORALSEQ) 
 		result = (Temporal *)tnumberseq_minus_ranges((TemporalSeq *)temp,
-			normranges, newcount);
+			normbounds, boundcount);
 	else if (temp->duration == TEMPORALS) 
 		result = (Temporal *)tnumbers_minus_ranges((TemporalS *)temp,
-			normranges, newcount);
+			normbounds, boundcount);
 
+	pfree(normbounds);
 	pfree(ranges);
 	if (count > 1)
 	{
@@ -2866,6 +3991,21 @@ temporal_at_timestamp_internal(Temporal *temp, TimestampTz t)
 	return result;
 }
 
+/**
+ * @brief Get the temporal value of the argument, restricted when possible 
+ *		to the instants needed for a query over the period instead of 
+ *		detoasting the whole value
+ * @return NULL if the temporal value certainly does not overlap the period
+ */
+Temporal *
+temporal_getarg_slice(FunctionCallInfo fcinfo, int i, Period *p)
+{
+	TemporalSeq *seq;
+	if (temporalseq_fetch_slice(PG_GETARG_DATUM(i), p, &seq))
+		return (Temporal *) seq;
+	return PG_GETARG_TEMPORAL(i);
+}
+
 PG_FUNCTION_INFO_V1(temporal_at_timestamp);
 /**
  * @brief Restricts the temporal value to a timestamp
@@ -2873,8 +4013,12 @@ PG_FUNCTION_INFO_V1(temporal_at_timestamp);
 PGDLLEXPORT Datum
 temporal_at_timestamp(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+	Period p;
+	period_set(&p, t, t, true, true);
+	Temporal *temp = temporal_getarg_slice(fcinfo, 0, &p);
+	if (temp == NULL)
+		PG_RETURN_NULL();
 	TemporalInst *result = temporal_at_timestamp_internal(temp, t);
 	PG_FREE_IF_COPY(temp, 0);
 	if (result == NULL)
@@ -2914,8 +4058,15 @@ PG_FUNCTION_INFO_V1(temporal_value_at_timestamp);
 PGDLLEXPORT Datum
 temporal_value_at_timestamp(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+	Period p;
+	period_set(&p, t, t, true, true);
+	/* Read the whole value through the cache so that the other functions
+	 * of the query reuse it, or only a slice when the cache is disabled */
+	Temporal *temp = (detoast_cache_size > 0) ?
+		PG_GETARG_TEMPORAL_CACHED(0) : temporal_getarg_slice(fcinfo, 0, &p);
+	if (temp == NULL)
+		PG_RETURN_NULL();
 	bool found = false;
 	Datum result = 0;
 	ensure_valid_duration(temp->duration);
@@ -2927,7 +4078,6 @@ temporal_value_at_timestamp(PG_FUNCTION_ARGS)
 		found = temporalseq_value_at_timestamp((TemporalSeq *)temp, t, &result);
 	else if (temp->duration == TEMPORALS) 
 		found = temporals_value_at_timestamp((TemporalS *)temp, t, &result);
-	PG_FREE_IF_COPY(temp, 0);
 	if (!found)
 		PG_RETURN_NULL();
 	PG_RETURN_DATUM(result);
@@ -2993,15 +4143,13 @@ temporal_minus_timestampset(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
-PG_FUNCTION_INFO_V1(temporal_at_period);
 /**
  * @brief Restricts the temporal value to a period
+ *		(dispatch function)
  */
-PGDLLEXPORT Datum
-temporal_at_period(PG_FUNCTION_ARGS)
+Temporal *
+temporal_at_period_internal(Temporal *temp, Period *p)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	Period *p = PG_GETARG_PERIOD(1);
 	Temporal *result = NULL;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST) 
@@ -3016,7 +4164,37 @@ temporal_at_period(PG_FUNCTION_ARGS)
 	else if (temp->duration == TEMPORALS) 
 		result = (Temporal *)temporals_at_period(
 			(TemporalS *)temp, p);
-	PG_FREE_IF_COPY(temp, 0);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(temporal_at_period);
+/**
+ * @brief Restricts the temporal value to a period
+ */
+PGDLLEXPORT Datum
+temporal_at_period(PG_FUNCTION_ARGS)
+{
+	Period *p = PG_GETARG_PERIOD(1);
+	/* Fetch the argument in the memory context of a view of the result,
+	 * which then keeps the instants of the argument alive */
+	MemoryContext objcxt = AllocSetContextCreate(CurrentMemoryContext,
+		"expanded temporal sequence", ALLOCSET_START_SMALL_SIZES);
+	MemoryContext oldcxt = MemoryContextSwitchTo(objcxt);
+	Temporal *temp = temporal_getarg_slice(fcinfo, 0, p);
+	MemoryContextSwitchTo(oldcxt);
+	if (temp == NULL)
+	{
+		MemoryContextDelete(objcxt);
+		PG_RETURN_NULL();
+	}
+	/* Views are only made of copies of the argument, otherwise the 
+	 * instants of the result would not be owned by the view */
+	Datum view;
+	if ((Pointer) temp != DatumGetPointer(PG_GETARG_DATUM(0)) &&
+		expanded_temporal_at_period(temp, p, objcxt, &view))
+		PG_RETURN_DATUM(view);
+	Temporal *result = temporal_at_period_internal(temp, p);
+	MemoryContextDelete(objcxt);
 	if (result == NULL)
 		PG_RETURN_NULL();	
 	PG_RETURN_POINTER(result);
@@ -3229,6 +4407,56 @@ temporal_intersects_periodset(PG_FUNCTION_ARGS)
 	PG_RETURN_BOOL(result);
 }
 
+/**
+ * @brief Returns the number of seconds between the timestamp and the nearest
+ *		timestamp at which the temporal value is defined (internal function)
+ */
+double
+temporal_timestamp_distance_internal(Temporal *temp, TimestampTz t)
+{
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST || temp->duration == TEMPORALSEQ)
+	{
+		Period p;
+		temporal_period(&p, temp);
+		return period_timestamp_distance_internal(&p, t);
+	}
+	PeriodSet *ps = temporal_get_time_internal(temp);
+	double result = periodset_timestamp_distance_internal(ps, t);
+	pfree(ps);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(distance_timestamp_temporal);
+/**
+ * @brief Returns the number of seconds between the timestamp and the nearest
+ *		timestamp at which the temporal value is defined
+ */
+PGDLLEXPORT Datum
+distance_timestamp_temporal(PG_FUNCTION_ARGS)
+{
+	TimestampTz t = PG_GETARG_TIMESTAMPTZ(0);
+	Temporal *temp = PG_GETARG_TEMPORAL(1);
+	double result = temporal_timestamp_distance_internal(temp, t);
+	PG_FREE_IF_COPY(temp, 1);
+	PG_RETURN_FLOAT8(result);
+}
+
+PG_FUNCTION_INFO_V1(distance_temporal_timestamp);
+/**
+ * @brief Returns the number of seconds between the nearest timestamp at 
+ *		which the temporal value is defined and the timestamp
+ */
+PGDLLEXPORT Datum
+distance_temporal_timestamp(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+	double result = temporal_timestamp_distance_internal(temp, t);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_FLOAT8(result);
+}
+
 /*****************************************************************************
  * Local aggregate functions 
  *****************************************************************************/
@@ -3260,7 +4488,7 @@ PG_FUNCTION_INFO_V1(tnumber_twavg);
 PGDLLEXPORT Datum
 tnumber_twavg(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Temporal *temp = PG_GETARG_TEMPORAL_CACHED(0);
 	double result = 0.0;
 	ensure_valid_duration(temp->duration);
 	if (temp->duration == TEMPORALINST)
@@ -3272,7 +4500,6 @@ tnumber_twavg(PG_FUNCTION_ARGS)
 		result = tnumberseq_twavg((TemporalSeq *)temp);
 	else if (temp->duration == TEMPORALS)
 		result = tnumbers_twavg((TemporalS *)temp);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_FLOAT8(result);
 }
 
@@ -3358,6 +4585,65 @@ temporal_cmp(PG_FUNCTION_ARGS)
 	PG_RETURN_INT32(result);
 }
 
+/**
+ * @brief Sortsupport comparator, which avoids the function call overhead
+ */
+static int
+temporal_fastcmp(Datum x, Datum y, SortSupport ssup)
+{
+	Temporal *t1 = DatumGetTemporal(x);
+	Temporal *t2 = DatumGetTemporal(y);
+	int result = temporal_cmp_internal(t1, t2);
+	if ((Pointer) t1 != DatumGetPointer(x))
+		pfree(t1);
+	if ((Pointer) t2 != DatumGetPointer(y))
+		pfree(t2);
+	return result;
+}
+
+/**
+ * @brief Returns the abbreviated key of a temporal value, which is the first
+ *		component of its bounding box compared by temporal_cmp, that is, 
+ *		the lower bound of the period or the minimum X value of the box. 
+ *		The bounding box of out-of-line values is fetched from the slices 
+ *		of the datum containing it.
+ */
+static Datum
+temporal_abbrev_convert(Datum original, SortSupport ssup)
+{
+	union bboxunion box;
+	Oid valuetypid;
+	int numinst;
+	memset(&box, 0, sizeof(bboxunion));
+	if (! temporal_bbox_slice1(original, &valuetypid, &box, NULL, &numinst))
+	{
+		Temporal *temp = DatumGetTemporal(original);
+		valuetypid = temp->valuetypid;
+		temporal_bbox(&box, temp);
+		if ((Pointer) temp != DatumGetPointer(original))
+			pfree(temp);
+	}
+	if (valuetypid == BOOLOID || valuetypid == TEXTOID)
+		return timestamp_abbrev_key(box.p.lower);
+	if (valuetypid == INT4OID || valuetypid == FLOAT8OID)
+		return double_abbrev_key(box.b.xmin);
+	/* Temporal points */
+	return double_abbrev_key(box.g.xmin);
+}
+
+PG_FUNCTION_INFO_V1(temporal_sortsupport);
+/**
+ * @brief Sortsupport function for the B-tree opclasses of temporal types
+ */
+PGDLLEXPORT Datum
+temporal_sortsupport(PG_FUNCTION_ARGS)
+{
+	SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+	ssup->comparator = temporal_fastcmp;
+	sortsupport_set_abbrev(ssup, temporal_abbrev_convert);
+	PG_RETURN_VOID();
+}
+
 /**
  * @brief Returns true if the two temporal values are equal 
  *		(internal function). The internal B-tree comparator 
@@ -16,15 +16,17 @@
 #include <math.h>
 #include <strings.h>
 #include <catalog/pg_collation.h>
-#include <libpq/pqformat.h>
+#include <utils/builtins.h>
 #include <utils/timestamp.h>
-#include <executor/spi.h>
+#include <utils/typcache.h>
 
 #include "period.h"
 #include "timeops.h"
 #include "temporaltypes.h"
 #include "oidcache.h"
 #include "temporal_util.h"
+#include "temporal_probes.h"
+#include "temporal_stats.h"
 #include "temporal_boolops.h"
 #include "doublen.h"
 
@@ -55,49 +57,47 @@ unset_aggregation_context(MemoryContext ctx)
 	MemoryContextSwitchTo(ctx);
 }
 
+static inline Elem *
+skiplist_elem(SkipList *list, int cur)
+{
+	return (Elem *) (list->arena + (size_t) cur * MAXIMUM_ALIGNOF);
+}
+
 static int
-skiplist_alloc(FunctionCallInfo fcinfo, SkipList *list)
+skiplist_alloc(FunctionCallInfo fcinfo, SkipList *list, int height)
 {
 	list->length ++;
-	if (! list->freecount)
+	int result = list->freed[height - 1];
+	if (result != -1)
 	{
-		/* No free list, give first available entry */
-		if (list->next >= list->capacity)
-		{
-			/* No more capacity, let's grow */
-			list->capacity <<= SKIPLIST_GROW;
-			MemoryContext ctx = set_aggregation_context(fcinfo);
-			list->elems = repalloc(list->elems, sizeof(Elem) * list->capacity);
-			unset_aggregation_context(ctx);
-		}
-		list->next ++;
-		return list->next - 1;
+		/* Reuse a freed element of the same height */
+		list->freed[height - 1] = skiplist_elem(list, result)->next[0];
+		return result;
 	}
-	else 
+	int words = SKIPLIST_ELEM_WORDS(height);
+	if (list->next + words > list->capacity)
 	{
-		list->freecount --;
-		return list->freed[list->freecount];
+		/* No more capacity, let's grow */
+		while (list->next + words > list->capacity)
+			list->capacity <<= SKIPLIST_GROW;
+		MemoryContext ctx = set_aggregation_context(fcinfo);
+		list->arena = repalloc(list->arena, 
+			(size_t) list->capacity * MAXIMUM_ALIGNOF);
+		unset_aggregation_context(ctx);
 	}
+	result = list->next;
+	list->next += words;
+	skiplist_elem(list, result)->height = height;
+	return result;
 }
 
+/* The first link of freed elements chains the free list of their height */
 static void
-skiplist_free(FunctionCallInfo fcinfo, SkipList *list, int cur)
+skiplist_free(SkipList *list, int cur)
 {
-	if (! list->freed)
-	{
-		list->freecap = SKIPLIST_INITIAL_FREELIST;
-		MemoryContext ctx = set_aggregation_context(fcinfo);
-		list->freed = palloc(sizeof(int) * list->freecap);
-		unset_aggregation_context(ctx);
-	}
-	else if (list->freecount == list->freecap)
-	{
-		list->freecap <<= 1;
-		MemoryContext ctx = set_aggregation_context(fcinfo);
-		list->freed = repalloc(list->freed, sizeof(int) * list->freecap);
-		unset_aggregation_context(ctx);
-	}
-	list->freed[list->freecount ++] = cur;
+	Elem *e = skiplist_elem(list, cur);
+	e->next[0] = list->freed[e->height - 1];
+	list->freed[e->height - 1] = cur;
 	list->length --;
 }
 
@@ -145,10 +145,11 @@ skiplist_elmpos(SkipList *list, int cur, TimestampTz t)
 		return BEFORE; /* Tail is +inf */
 	else
 	{
-		if (list->elems[cur].value->duration == TEMPORALINST)
-			return pos_timestamp_timestamp(((TemporalInst *)list->elems[cur].value)->t, t);
+		Temporal *value = skiplist_elem(list, cur)->value;
+		if (value->duration == TEMPORALINST)
+			return pos_timestamp_timestamp(((TemporalInst *)value)->t, t);
 		else
-			return pos_period_timestamp(&((TemporalSeq *)list->elems[cur].value)->period, t);
+			return pos_period_timestamp(&((TemporalSeq *)value)->period, t);
 	}
 }
 
@@ -164,7 +165,7 @@ skiplist_print(SkipList *list)
 	int cur = 0;
 	while (cur != -1)
 	{
-		Elem *e = &list->elems[cur];
+		Elem *e = skiplist_elem(list, cur);
 		len += sprintf(buf+len, "\telm%d [label=\"", cur);
 		for (int l = e->height - 1; l > 0; l --)
 		{
@@ -208,45 +209,61 @@ skiplist_make(FunctionCallInfo fcinfo, Temporal **values, int count)
 	//FIXME: tail should be a constant (e.g. 1) but is not, for ease of construction
 
 	MemoryContext oldctx = set_aggregation_context(fcinfo);
-	int capacity = SKIPLIST_INITIAL_CAPACITY;
 	count += 2; /* Account for head and tail */
-	while (capacity <= count)
-		capacity <<= 1;
-	SkipList *result = palloc0(sizeof(SkipList));
-	result->elems = palloc0(sizeof(Elem) * capacity);
 	int height = (int) ceil(log2(count - 1));
+	/* In a balanced list the i-th element has as many links as the number
+	 * of trailing zeros of i plus one. Head and tail may grow up to the
+	 * maximum level */
+	int *offsets = palloc(sizeof(int) * count);
+	int size = 0;
+	for (int i = 0; i < count; i ++)
+	{
+		offsets[i] = size;
+		size += (i == 0 || i == count - 1) ?
+			SKIPLIST_ELEM_WORDS(SKIPLIST_MAXLEVEL) :
+			SKIPLIST_ELEM_WORDS(Min(ffs(i), height));
+	}
+	int capacity = SKIPLIST_INITIAL_CAPACITY;
+	while (capacity <= size)
+		capacity <<= SKIPLIST_GROW;
+	SkipList *result = palloc0(sizeof(SkipList));
+	result->arena = palloc(sizeof(char) * capacity * MAXIMUM_ALIGNOF);
 	result->capacity = capacity;
-	result->next = count;
+	result->next = size;
 	result->length = count - 2;
+	for (int l = 0; l < SKIPLIST_MAXLEVEL; l ++)
+		result->freed[l] = -1;
 	result->extra = NULL;
 	result->extrasize = 0;
+	result->tail = offsets[count - 1];
 
-	/* Fill values first */
-	result->elems[0].value = NULL;
-	for (int i = 0; i < count - 2; i ++)
-		result->elems[i + 1].value = temporal_copy(values[i]);
-	result->elems[count - 1].value = NULL;
-	result->tail = count - 1;
-
-	/* Link the list in a balanced fashion */
-	for (int level = 0; level < height; level ++)
+	/* Fill values and link the list in a balanced fashion */
+	for (int i = 0; i < count; i ++)
 	{
-		int step = 1 << level;
-		for (int i = 0; i < count; i += step)
+		Elem *e = skiplist_elem(result, offsets[i]);
+		if (i == count - 1)
+		{
+			e->value = NULL;
+			e->height = height;
+			for (int level = 0; level < SKIPLIST_MAXLEVEL; level ++)
+				e->next[level] = - 1;
+			continue;
+		}
+		e->value = (i == 0) ? NULL : temporal_copy(values[i - 1]);
+		e->height = (i == 0) ? height : Min(ffs(i), height);
+		for (int level = 0; level < e->height; level ++)
 		{
+			int step = 1 << level;
 			int next = i + step < count ? i + step : count - 1;
-			if (i != count - 1)
-			{
-				result->elems[i].next[level] = next;
-				result->elems[i].height = level + 1;
-			}
-			else
-			{
-				result->elems[i].next[level] = - 1;
-				result->elems[i].height = height;
-			}
+			e->next[level] = offsets[next];
+		}
+		if (i == 0)
+		{
+			for (int level = height; level < SKIPLIST_MAXLEVEL; level ++)
+				e->next[level] = result->tail;
 		}
 	}
+	pfree(offsets);
 	unset_aggregation_context(oldctx);
 	return result;
 }
@@ -254,7 +271,7 @@ skiplist_make(FunctionCallInfo fcinfo, Temporal **values, int count)
 Temporal *
 skiplist_headval(SkipList *list)
 {
-	return list->elems[list->elems[0].next[0]].value;
+	return skiplist_elem(list, skiplist_elem(list, 0)->next[0])->value;
 }
 
 /*  Function not currently used
@@ -263,10 +280,10 @@ skiplist_tailval(SkipList *list)
 {
 	// Despite the look, this is pretty much O(1)
 	int cur = 0;
-	Elem *e = &list->elems[cur];
+	Elem *e = skiplist_elem(list, cur);
 	int height = e->height;
 	while (e->next[height - 1] != list->tail)
-		e = &list->elems[e->next[height - 1]];
+		e = skiplist_elem(list, e->next[height - 1]);
 	return e->value;
 }
 */
@@ -275,16 +292,77 @@ Temporal **
 skiplist_values(SkipList *list)
 {
 	Temporal **result = palloc(sizeof(Temporal *) * list->length);
-	int cur = list->elems[0].next[0];
+	int cur = skiplist_elem(list, 0)->next[0];
 	int count = 0;
 	while (cur != list->tail)
 	{
-		result[count++] = list->elems[cur].value;
-		cur = list->elems[cur].next[0];
+		Elem *e = skiplist_elem(list, cur);
+		result[count++] = e->value;
+		cur = e->next[0];
 	}
 	return result;
 }
 
+/*
+ * Link the values, which must be ordered, after the elements in update at
+ * each level. When they are inserted before the tail, the last elements by
+ * level are kept up to date for the append fast path of skiplist_splice.
+ */
+static void
+skiplist_insert(FunctionCallInfo fcinfo, SkipList *list, int *update,
+	int height, Temporal **values, int count)
+{
+	bool attail = skiplist_elem(list, update[0])->next[0] == list->tail;
+	/* The last element of the levels below top is one of the new ones */
+	int top = 0;
+	for (int i = count - 1; i >= 0; i--)
+	{
+		int rheight = random_level();
+		int new = skiplist_alloc(fcinfo, list, rheight);
+		/* The allocation may have moved the arena */
+		Elem *newelm = skiplist_elem(list, new);
+		if (rheight > height)
+		{
+			for (int l = height; l < rheight; l ++)
+				update[l] = 0;
+			/* Grow head and tail as appropriate */
+			skiplist_elem(list, 0)->height = rheight;
+			skiplist_elem(list, list->tail)->height = rheight;
+		}
+		MemoryContext ctx = set_aggregation_context(fcinfo);
+		newelm->value = temporal_copy(values[i]);
+		unset_aggregation_context(ctx);
+
+		for (int level = 0; level < rheight; level ++)
+		{
+			Elem *prev = skiplist_elem(list, update[level]);
+			newelm->next[level] = prev->next[level];
+			prev->next[level] = new;
+			if (level >= height && update[0] != list->tail)
+			{
+				newelm->next[level] = list->tail;
+			}
+		}
+		if (attail)
+		{
+			/* Values are inserted backwards, the first one of each level is 
+			 * the last one */
+			for (int level = top; level < rheight; level ++)
+				list->last[level] = new;
+			if (rheight > top)
+				top = rheight;
+		}
+		if (rheight > height)
+			height = rheight;
+	}
+	if (attail)
+	{
+		for (int level = top; level < height; level ++)
+			list->last[level] = update[level];
+	}
+	list->lastvalid = attail;
+}
+
 void
 skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
 	int count, Datum (*func)(Datum, Datum), bool crossings)
@@ -292,8 +370,10 @@ skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
 	/*
 	 * O(count*log(n)) average (unless I'm mistaken)
 	 * O(n+count*log(n)) worst case (when period spans the whole list so everything has to be deleted) 
+	 * O(count) when the values start after the last element of the list
 	 */
 	assert(list->length > 0);
+	MOBDB_STAT_INC(skiplist_splices);
 	int16 duration = skiplist_headval(list)->duration;
 	Period period;
 	if (duration == TEMPORALINST)
@@ -306,28 +386,42 @@ skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
 	int update[SKIPLIST_MAXLEVEL];
 	memset(update, 0, sizeof(update));
 	int cur = 0;
-	int height = list->elems[cur].height;
-	Elem *e = &list->elems[cur];
+	Elem *e = skiplist_elem(list, cur);
+	int height = e->height;
+
+	/*
+	 * Fast path for time-ordered input: when the values start after the last
+	 * element of the list there is nothing to aggregate and they are linked
+	 * directly before the tail without searching the list
+	 */
+	if (list->lastvalid && 
+		skiplist_elmpos(list, list->last[0], period.lower) == AFTER)
+	{
+		memcpy(update, list->last, sizeof(int) * height);
+		skiplist_insert(fcinfo, list, update, height, values, count);
+		return;
+	}
+
 	for (int level = height - 1; level >= 0; level --)
 	{
 		while (e->next[level] != -1 && 
 			skiplist_elmpos(list, e->next[level], period.lower) == AFTER)
 		{
 			cur = e->next[level];
-			e = &list->elems[cur];
+			e = skiplist_elem(list, cur);
 		}
 		update[level] = cur;
 	}
 
 	int lower = e->next[0];
 	cur = lower;
-	e = &list->elems[cur];
+	e = skiplist_elem(list, cur);
 
 	int spliced_count = 0;
 	while (skiplist_elmpos(list, cur, period.upper) == AFTER)
 	{
 		cur = e->next[0];
-		e = &list->elems[cur];
+		e = skiplist_elem(list, cur);
 		spliced_count ++;
 	}
 	int upper = cur;
@@ -343,22 +437,24 @@ skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
 	spliced_count = 0;
 	while (cur != upper && cur != -1)
 	{
+		e = skiplist_elem(list, cur);
 		for (int level = 0; level < height; level ++)
 		{
-			Elem *prev = &list->elems[update[level]];
+			Elem *prev = skiplist_elem(list, update[level]);
 			if (prev->next[level] != cur)
 				break;
 
-			prev->next[level] = list->elems[cur].next[level];
+			prev->next[level] = e->next[level];
 		}
-		spliced[spliced_count++] = list->elems[cur].value;
-		skiplist_free(fcinfo, list, cur);
-		cur = list->elems[cur].next[0];
+		spliced[spliced_count++] = e->value;
+		int next = e->next[0];
+		skiplist_free(list, cur);
+		cur = next;
 	}
 
 	/* Level down head & tail if necessary */
-	Elem *head = &list->elems[0];
-	Elem *tail = &list->elems[list->tail];
+	Elem *head = skiplist_elem(list, 0);
+	Elem *tail = skiplist_elem(list, list->tail);
 	while (head->height > 1 && head->next[head->height - 1] == list->tail)
 	{
 		head->height --;
@@ -386,36 +482,7 @@ skiplist_splice(FunctionCallInfo fcinfo, SkipList *list, Temporal **values,
 	}
 
 	/* Insert new elements */
-	for (int i = count - 1; i >= 0; i--)
-	{
-		int rheight = random_level();
-		if (rheight > height)
-		{
-			for (int l = height; l < rheight; l ++)
-				update[l] = 0;
-			/* Grow head and tail as appropriate */
-			head->height = rheight;
-			tail->height = rheight;
-		}
-		int new = skiplist_alloc(fcinfo, list);
-		Elem *newelm = &list->elems[new];
-		MemoryContext ctx = set_aggregation_context(fcinfo);
-		newelm->value = temporal_copy(values[i]);
-		unset_aggregation_context(ctx);
-		newelm->height = rheight;
-
-		for (int level = 0; level < rheight; level ++)
-		{
-			newelm->next[level] = list->elems[update[level]].next[level];
-			list->elems[update[level]].next[level] = new;
-			if (level >= height && update[0] != list->tail)
-			{
-				newelm->next[level] = list->tail;
-			}
-		}
-		if (rheight > height)
-			height = rheight;
-	}
+	skiplist_insert(fcinfo, list, update, height, values, count);
 
 	if (spliced_count != 0)
 	{
@@ -477,13 +544,21 @@ datum_max_float8(Datum l, Datum r)
 Datum
 datum_min_text(Datum l, Datum r)
 {
-	return text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) < 0 ? l : r;
+	text *txt1 = DatumGetTextP(l), *txt2 = DatumGetTextP(r);
+	/* Avoid the locale-aware comparison for repeated values */
+	if (text_eq(txt1, txt2))
+		return l;
+	return text_cmp(txt1, txt2, DEFAULT_COLLATION_OID) < 0 ? l : r;
 }
 
 Datum
 datum_max_text(Datum l, Datum r)
 {
-	return text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) > 0 ? l : r;
+	text *txt1 = DatumGetTextP(l), *txt2 = DatumGetTextP(r);
+	/* Avoid the locale-aware comparison for repeated values */
+	if (text_eq(txt1, txt2))
+		return l;
+	return text_cmp(txt1, txt2, DEFAULT_COLLATION_OID) > 0 ? l : r;
 }
 
 /* Get the sum of the two arguments */
@@ -525,45 +600,72 @@ datum_sum_double4(Datum l, Datum r)
  * Generic binary aggregate functions needed for parallelization
  *****************************************************************************/
 
-static void 
-aggstate_write(SkipList *state, StringInfo buf)
+/*
+ * The transition state is serialized as the number of values, the size of
+ * the extra state and its bytes, followed by the values themselves. Since
+ * the temporal values are flat varlenas and the state is only exchanged
+ * between the backends of a single server, they are copied as they are,
+ * each one padded to a MAXALIGN boundary so that the deserialized values
+ * can be used in place without any conversion.
+ */
+static bytea *
+aggstate_write(SkipList *state)
 {
 	Temporal **values = skiplist_values(state);
-	pq_sendint32(buf, (uint32) state->length);
-	Oid valuetypid = InvalidOid;
-	if (state->length > 0)
-		valuetypid = values[0]->valuetypid;
-	pq_sendint32(buf, valuetypid);
+	size_t size = VARHDRSZ + MAXALIGN(2 * sizeof(int64)) +
+		MAXALIGN(state->extrasize);
+	for (int i = 0; i < state->length; i ++)
+		size += MAXALIGN(VARSIZE(values[i]));
+	bytea *result = palloc0(size);
+	SET_VARSIZE(result, size);
+	char *ptr = VARDATA(result);
+	int64 header[2] = { (int64) state->length, (int64) state->extrasize };
+	memcpy(ptr, header, sizeof(header));
+	ptr += MAXALIGN(sizeof(header));
+	if (state->extrasize)
+	{
+		memcpy(ptr, state->extra, state->extrasize);
+		ptr += MAXALIGN(state->extrasize);
+	}
 	for (int i = 0; i < state->length; i ++)
 	{
-		SPI_connect();
-		temporal_write(values[i], buf);
-		SPI_finish();
+		memcpy(ptr, values[i], VARSIZE(values[i]));
+		ptr += MAXALIGN(VARSIZE(values[i]));
 	}
-	pq_sendint64(buf, state->extrasize);
-	if (state->extra)
-		pq_sendbytes(buf, state->extra, (int) state->extrasize);
 	pfree(values);
+	return result;
 }
 
 static SkipList *
-aggstate_read(FunctionCallInfo fcinfo, StringInfo buf)
-{
-	int size = pq_getmsgint(buf, 4);
-	Oid valuetypid = pq_getmsgint(buf, 4);
-	Temporal **values = palloc0(sizeof(Temporal *) * size);
-	for (int i = 0; i < size; i ++)
-		values[i] = temporal_read(buf, valuetypid);
-	SkipList *result = skiplist_make(fcinfo, values, size);
-	size_t extrasize = (size_t) pq_getmsgint64(buf);
+aggstate_read(FunctionCallInfo fcinfo, bytea *data)
+{
+	/* VARDATA is not MAXALIGNed, copy the payload to an aligned buffer */
+	size_t size = VARSIZE(data) - VARHDRSZ;
+	char *buf = palloc(size);
+	memcpy(buf, VARDATA(data), size);
+	char *ptr = buf;
+	int64 header[2];
+	memcpy(header, ptr, sizeof(header));
+	ptr += MAXALIGN(sizeof(header));
+	int count = (int) header[0];
+	size_t extrasize = (size_t) header[1];
+	void *extra = NULL;
 	if (extrasize)
 	{
-		const char *extra = pq_getmsgbytes(buf, (int) extrasize);
-		aggstate_set_extra(fcinfo, result, (void *)extra, extrasize);
+		extra = ptr;
+		ptr += MAXALIGN(extrasize);
+	}
+	Temporal **values = palloc(sizeof(Temporal *) * count);
+	for (int i = 0; i < count; i ++)
+	{
+		values[i] = (Temporal *) ptr;
+		ptr += MAXALIGN(VARSIZE(values[i]));
 	}
-	for (int i = 0; i < size; i ++)
-		pfree(values[i]);
+	SkipList *result = skiplist_make(fcinfo, values, count);
+	if (extrasize)
+		aggstate_set_extra(fcinfo, result, extra, extrasize);
 	pfree(values);
+	pfree(buf);
 	return result;
 }
 
@@ -586,10 +688,7 @@ PGDLLEXPORT Datum
 temporal_tagg_serialize(PG_FUNCTION_ARGS)
 {
 	SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
-	StringInfoData buf;
-	pq_begintypsend(&buf);
-	aggstate_write(state, &buf);
-	PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+	PG_RETURN_BYTEA_P(aggstate_write(state));
 }
 
 PG_FUNCTION_INFO_V1(temporal_tagg_deserialize);
@@ -598,14 +697,7 @@ PGDLLEXPORT Datum
 temporal_tagg_deserialize(PG_FUNCTION_ARGS)
 {
 	bytea *data = PG_GETARG_BYTEA_P(0);
-	StringInfoData buf =
-	{
-		.cursor = 0,
-		.data = VARDATA(data),
-		.len = VARSIZE(data),
-		.maxlen = VARSIZE(data)
-	};
-	SkipList *result = aggstate_read(fcinfo, &buf);
+	SkipList *result = aggstate_read(fcinfo, data);
 	PG_RETURN_POINTER(result);
 }
 
@@ -1132,26 +1224,40 @@ temporalseq_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state,
 	return result;
 }
 
-static SkipList *
-temporals_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state, 
-	TemporalS *ts, Datum (*func)(Datum, Datum), bool crossings)
+/*
+ * Generic transition function for an array of ordered and non-overlapping
+ * sequences, which are spliced at once into the state
+ */
+SkipList *
+temporalseqarr_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state, 
+	TemporalSeq **sequences, int count, Datum (*func)(Datum, Datum), 
+	bool crossings)
 {
-	TemporalSeq **sequences = temporals_sequences(ts);
 	SkipList *result;
 	if (! state)
-		result = skiplist_make(fcinfo, (Temporal **)sequences, ts->count);
+		result = skiplist_make(fcinfo, (Temporal **)sequences, count);
 	else
 	{
 		if (skiplist_headval(state)->duration != TEMPORALSEQ)
 			ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
 				errmsg("Cannot aggregate temporal values of different duration")));
 		if (MOBDB_FLAGS_GET_LINEAR(skiplist_headval(state)->flags) !=
-				MOBDB_FLAGS_GET_LINEAR(ts->flags))
+				MOBDB_FLAGS_GET_LINEAR(sequences[0]->flags))
 			ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
 				errmsg("Cannot aggregate temporal values of different interpolation")));
-		skiplist_splice(fcinfo, state, (Temporal **)sequences, ts->count, func, crossings);
+		skiplist_splice(fcinfo, state, (Temporal **)sequences, count, func, crossings);
 		result = state;
 	}
+	return result;
+}
+
+static SkipList *
+temporals_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state, 
+	TemporalS *ts, Datum (*func)(Datum, Datum), bool crossings)
+{
+	TemporalSeq **sequences = temporals_sequences(ts);
+	SkipList *result = temporalseqarr_tagg_transfn(fcinfo, state, sequences,
+		ts->count, func, crossings);
 	pfree(sequences);
 	return result;
 }
@@ -1161,6 +1267,8 @@ temporal_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state,
 	Temporal *temp, Datum (*func)(Datum, Datum), bool crossings)
 {
 	ensure_valid_duration(temp->duration);
+	MOBDB_STAT_INSTANTS(temp);
+	TRACE_MOBILITYDB_AGG_TRANSFN_START(temporal_stat_instants(temp));
 	SkipList *result = NULL;
 	if (temp->duration == TEMPORALINST) 
 		result =  temporalinst_tagg_transfn(fcinfo, state, (TemporalInst *)temp, 
@@ -1174,6 +1282,7 @@ temporal_tagg_transfn(FunctionCallInfo fcinfo, SkipList *state,
 	else if (temp->duration == TEMPORALS) 
 		result = temporals_tagg_transfn(fcinfo, state, (TemporalS *)temp, 
 			func, crossings);
+	TRACE_MOBILITYDB_AGG_TRANSFN_DONE(result == NULL ? 0 : result->length);
 	return result;
 }
 
@@ -1956,3 +2065,803 @@ tnumber_tavg_finalfn(PG_FUNCTION_ARGS)
 }
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Bucketed temporal count and sum
+ *
+ * Instead of computing the aggregate at every breakpoint of the input, the
+ * values are accumulated into time bins of a fixed width. For each bin, the
+ * count is the number of values defined at some instant of the bin and the
+ * sum adds the value of each of them at the first such instant.
+ *****************************************************************************/
+
+/* Number of the bin containing the timestamp */
+
+int64
+timebin_number(TimestampTz t, int64 size)
+{
+	return (t >= 0) ? t / size : - ((- t + size - 1) / size);
+}
+
+static TimestampTz
+timebin_start(int64 number, int64 size)
+{
+	return (TimestampTz) (number * size);
+}
+
+int64
+bucket_interval_size(Interval *interval)
+{
+	int64 result = interval->time + (int64) interval->day * USECS_PER_DAY;
+	if (interval->month != 0 || result <= 0)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The bucket interval must be positive and cannot have months")));
+	return result;
+}
+
+/*
+ * Ensure that the bins from first to last are in the state. The state is
+ * created when it is NULL and it is reallocated when it needs to grow.
+ */
+static TimeBins *
+timebins_extend(FunctionCallInfo fcinfo, TimeBins *state, int64 size, 
+	Oid valuetypid, int64 first, int64 last)
+{
+	if (state != NULL)
+	{
+		if (state->size != size)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				errmsg("Cannot aggregate values with different bucket intervals")));
+		if (first >= state->first && last < state->first + state->count)
+			return state;
+		first = Min(first, state->first);
+		last = Max(last, state->first + state->count - 1);
+	}
+	if (last - first + 1 > (int64) ((MaxAllocSize - sizeof(TimeBins)) / 
+			sizeof(TimeBin)))
+		ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+			errmsg("Too many buckets, use a larger bucket interval")));
+	int count = (int) (last - first + 1);
+	MemoryContext ctx = set_aggregation_context(fcinfo);
+	size_t memsize = offsetof(TimeBins, bins) + sizeof(TimeBin) * count;
+	TimeBins *result = palloc0(memsize);
+	unset_aggregation_context(ctx);
+	SET_VARSIZE(result, memsize);
+	result->count = count;
+	result->valuetypid = valuetypid;
+	result->size = size;
+	result->first = first;
+	if (state != NULL)
+	{
+		memcpy(&result->bins[state->first - first], state->bins, 
+			sizeof(TimeBin) * state->count);
+		pfree(state);
+	}
+	return result;
+}
+
+static void
+timebin_add(void *data, int64 number, Datum value)
+{
+	TimeBins *state = (TimeBins *) data;
+	TimeBin *bin = &state->bins[number - state->first];
+	bin->count++;
+	if (state->valuetypid == INT4OID)
+		bin->sum += (double) DatumGetInt32(value);
+	else if (state->valuetypid == FLOAT8OID)
+		bin->sum += DatumGetFloat8(value);
+}
+
+/*
+ * Call the function for each bin of a sequence after the last one for which
+ * the function was already called. The value passed to the function is the
+ * value of the sequence at the first instant of the bin at which it is
+ * defined, or 0 when withvalue is false.
+ */
+static int64
+temporalseq_timebins(TemporalSeq *seq, int64 size, bool withvalue, int64 last,
+	void (*func)(void *, int64, Datum), void *state)
+{
+	int64 first = Max(timebin_number(seq->period.lower, size), last + 1);
+	int64 upper = timebin_number(seq->period.upper, size);
+	if (! seq->period.upper_inc && 
+		seq->period.upper == timebin_start(upper, size))
+		upper--;
+	for (int64 i = first; i <= upper; i++)
+	{
+		TimestampTz t = timebin_start(i, size);
+		Datum value = 0;
+		if (withvalue)
+		{
+			if (t <= seq->period.lower)
+				value = temporalinst_value(temporalseq_inst_n(seq, 0));
+			else
+				temporalseq_value_at_timestamp(seq, t, &value);
+		}
+		func(state, i, value);
+	}
+	return Max(last, upper);
+}
+
+/* Call the function once for each bin in which the temporal value is defined */
+
+static void
+temporal_timebins(Temporal *temp, int64 size, bool withvalue,
+	void (*func)(void *, int64, Datum), void *state)
+{
+	ensure_valid_duration(temp->duration);
+	int64 last = PG_INT64_MIN;
+	if (temp->duration == TEMPORALINST)
+	{
+		TemporalInst *inst = (TemporalInst *)temp;
+		func(state, timebin_number(inst->t, size), temporalinst_value(inst));
+	}
+	else if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *)temp;
+		for (int i = 0; i < ti->count; i++)
+		{
+			TemporalInst *inst = temporali_inst_n(ti, i);
+			int64 number = timebin_number(inst->t, size);
+			if (number > last)
+			{
+				func(state, number, temporalinst_value(inst));
+				last = number;
+			}
+		}
+	}
+	else if (temp->duration == TEMPORALSEQ)
+		temporalseq_timebins((TemporalSeq *)temp, size, withvalue, last,
+			func, state);
+	else if (temp->duration == TEMPORALS)
+	{
+		TemporalS *ts = (TemporalS *)temp;
+		for (int i = 0; i < ts->count; i++)
+			last = temporalseq_timebins(temporals_seq_n(ts, i), size,
+				withvalue, last, func, state);
+	}
+}
+
+static TimeBins *
+temporal_bucket_transfn(FunctionCallInfo fcinfo, TimeBins *state, 
+	Temporal *temp, Interval *interval, Oid valuetypid)
+{
+	int64 size = bucket_interval_size(interval);
+	Period p;
+	temporal_period(&p, temp);
+	state = timebins_extend(fcinfo, state, size, valuetypid, 
+		timebin_number(p.lower, size), timebin_number(p.upper, size));
+	MOBDB_STAT_INSTANTS(temp);
+	TRACE_MOBILITYDB_AGG_TRANSFN_START(temporal_stat_instants(temp));
+	temporal_timebins(temp, size, valuetypid != InvalidOid, &timebin_add,
+		state);
+	TRACE_MOBILITYDB_AGG_TRANSFN_DONE(state->count);
+	return state;
+}
+
+PG_FUNCTION_INFO_V1(temporal_tcount_bucket_transfn);
+
+PGDLLEXPORT Datum 
+temporal_tcount_bucket_transfn(PG_FUNCTION_ARGS)
+{
+	TimeBins *state = PG_ARGISNULL(0) ? NULL : 
+		(TimeBins *) PG_GETARG_POINTER(0);
+	if (PG_ARGISNULL(1) || PG_ARGISNULL(2))
+	{
+		if (state)
+			PG_RETURN_POINTER(state);
+		else
+			PG_RETURN_NULL();
+	}
+	Temporal *temp = PG_GETARG_TEMPORAL(1);
+	Interval *interval = PG_GETARG_INTERVAL_P(2);
+	state = temporal_bucket_transfn(fcinfo, state, temp, interval, 
+		InvalidOid);
+	PG_FREE_IF_COPY(temp, 1);
+	PG_RETURN_POINTER(state);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_tsum_bucket_transfn);
+
+PGDLLEXPORT Datum 
+tnumber_tsum_bucket_transfn(PG_FUNCTION_ARGS)
+{
+	TimeBins *state = PG_ARGISNULL(0) ? NULL : 
+		(TimeBins *) PG_GETARG_POINTER(0);
+	if (PG_ARGISNULL(1) || PG_ARGISNULL(2))
+	{
+		if (state)
+			PG_RETURN_POINTER(state);
+		else
+			PG_RETURN_NULL();
+	}
+	Temporal *temp = PG_GETARG_TEMPORAL(1);
+	Interval *interval = PG_GETARG_INTERVAL_P(2);
+	ensure_numeric_base_type(temp->valuetypid);
+	state = temporal_bucket_transfn(fcinfo, state, temp, interval, 
+		temp->valuetypid);
+	PG_FREE_IF_COPY(temp, 1);
+	PG_RETURN_POINTER(state);
+}
+
+PG_FUNCTION_INFO_V1(temporal_bucket_combinefn);
+
+PGDLLEXPORT Datum 
+temporal_bucket_combinefn(PG_FUNCTION_ARGS)
+{
+	TimeBins *state1 = PG_ARGISNULL(0) ? NULL : 
+		(TimeBins *) PG_GETARG_POINTER(0);
+	TimeBins *state2 = PG_ARGISNULL(1) ? NULL :
+		(TimeBins *) PG_GETARG_POINTER(1);
+	if (! state1)
+		PG_RETURN_POINTER(state2);
+	if (! state2)
+		PG_RETURN_POINTER(state1);
+	state1 = timebins_extend(fcinfo, state1, state2->size, state1->valuetypid,
+		state2->first, state2->first + state2->count - 1);
+	TimeBin *bins = &state1->bins[state2->first - state1->first];
+	for (int i = 0; i < state2->count; i++)
+	{
+		bins[i].count += state2->bins[i].count;
+		bins[i].sum += state2->bins[i].sum;
+	}
+	PG_RETURN_POINTER(state1);
+}
+
+/*
+ * Temporal value from the values of count consecutive bins starting at the
+ * bin number first, where the bins that are not defined are skipped. Each
+ * run of consecutive defined bins results in a sequence with stepwise
+ * interpolation. Returns NULL if no bin is defined.
+ */
+static TemporalS *
+timebins_result(Datum *values, bool *defined, int count, int64 first,
+	int64 size, Oid restypid)
+{
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * (count + 1));
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * count);
+	int k = 0, l = 0;
+	for (int i = 0; i <= count; i++)
+	{
+		if (i < count && defined[i])
+			instants[k++] = temporalinst_make(values[i], 
+				timebin_start(first + i, size), restypid);
+		else if (k > 0)
+		{
+			/* End of a run, the last value lasts until the end of its bin */
+			instants[k] = temporalinst_make(temporalinst_value(instants[k - 1]),
+				timebin_start(first + i, size), restypid);
+			sequences[l++] = temporalseq_from_temporalinstarr(instants, k + 1,
+				true, false, false, true);
+			for (int j = 0; j <= k; j++)
+				pfree(instants[j]);
+			k = 0;
+		}
+	}
+	pfree(instants);
+	if (l == 0)
+	{
+		pfree(sequences);
+		return NULL;
+	}
+	TemporalS *result = temporals_from_temporalseqarr(sequences, l, false, true);
+	for (int i = 0; i < l; i++)
+		pfree(sequences[i]);
+	pfree(sequences);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(temporal_bucket_finalfn);
+
+PGDLLEXPORT Datum
+temporal_bucket_finalfn(PG_FUNCTION_ARGS)
+{
+	/* The final function is strict, we do not need to test for null values */
+	TimeBins *state = (TimeBins *) PG_GETARG_POINTER(0);
+	Oid restypid = (state->valuetypid == FLOAT8OID) ? FLOAT8OID : INT4OID;
+	Datum *values = palloc(sizeof(Datum) * state->count);
+	bool *defined = palloc(sizeof(bool) * state->count);
+	for (int i = 0; i < state->count; i++)
+	{
+		TimeBin *bin = &state->bins[i];
+		defined[i] = (bin->count > 0);
+		if (state->valuetypid == InvalidOid)
+			values[i] = Int32GetDatum((int32) bin->count);
+		else if (restypid == INT4OID)
+			values[i] = Int32GetDatum((int32) bin->sum);
+		else
+			values[i] = Float8GetDatum(bin->sum);
+	}
+	TemporalS *result = timebins_result(values, defined, state->count,
+		state->first, state->size, restypid);
+	pfree(values); pfree(defined);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+/* The states of the bucketed aggregates, including those of the approximate
+ * ones below, are flat varlenas that are serialized as is */
+
+PG_FUNCTION_INFO_V1(temporal_bucket_serialize);
+
+PGDLLEXPORT Datum
+temporal_bucket_serialize(PG_FUNCTION_ARGS)
+{
+	TimeBins *state = (TimeBins *) PG_GETARG_POINTER(0);
+	bytea *result = palloc(VARSIZE(state));
+	memcpy(result, state, VARSIZE(state));
+	PG_RETURN_BYTEA_P(result);
+}
+
+PG_FUNCTION_INFO_V1(temporal_bucket_deserialize);
+
+PGDLLEXPORT Datum
+temporal_bucket_deserialize(PG_FUNCTION_ARGS)
+{
+	bytea *data = PG_GETARG_BYTEA_P(0);
+	MemoryContext ctx = set_aggregation_context(fcinfo);
+	TimeBins *result = palloc(VARSIZE(data));
+	unset_aggregation_context(ctx);
+	memcpy(result, data, VARSIZE(data));
+	PG_RETURN_POINTER(result);
+}
+
+
+/*****************************************************************************
+ * Approximate bucketed aggregates
+ *
+ * Instead of exact per-bin values, each bin keeps a sketch of fixed size:
+ * a HyperLogLog of the keys of the values defined in the bin for the
+ * temporal distinct count, and a t-digest of the values at the first
+ * instant of the bin at which they are defined for the temporal percentiles.
+ * The memory used and the time spent per value thus only depend on the
+ * number of bins and not on the number of instants. The sketches of two
+ * states are merged bin by bin, which enables partial and parallel
+ * aggregation.
+ *****************************************************************************/
+
+/* Hash function of the type of the keys cached in fn_extra */
+
+typedef struct
+{
+	Oid typid;
+	FmgrInfo proc;
+} SketchHashCache;
+
+/* Data passed to the functions adding a value to the bins */
+
+typedef struct
+{
+	SketchBins *state;
+	Oid valuetypid;
+	uint64 hash;		/* Hash of the key of the value */
+} SketchAdd;
+
+static uint64
+sketch_key_hash(FunctionCallInfo fcinfo, int argno)
+{
+	Oid typid = get_fn_expr_argtype(fcinfo->flinfo, argno);
+	SketchHashCache *cache = (SketchHashCache *) fcinfo->flinfo->fn_extra;
+	if (cache == NULL || cache->typid != typid)
+	{
+		TypeCacheEntry *typentry = lookup_type_cache(typid,
+			TYPECACHE_HASH_EXTENDED_PROC);
+		if (! OidIsValid(typentry->hash_extended_proc))
+			ereport(ERROR, (errcode(ERRCODE_UNDEFINED_FUNCTION),
+				errmsg("Could not identify a hash function for type %s",
+					format_type_be(typid))));
+		if (cache == NULL)
+			cache = fcinfo->flinfo->fn_extra = MemoryContextAlloc(
+				fcinfo->flinfo->fn_mcxt, sizeof(SketchHashCache));
+		cache->typid = typid;
+		fmgr_info_cxt(typentry->hash_extended_proc, &cache->proc,
+			fcinfo->flinfo->fn_mcxt);
+	}
+	return DatumGetUInt64(FunctionCall2Coll(&cache->proc, PG_GET_COLLATION(),
+		PG_GETARG_DATUM(argno), UInt64GetDatum(0)));
+}
+
+/*
+ * Ensure that the bins from first to last are in the state, as for
+ * timebins_extend. The bins added are empty since their sketches are zeroed.
+ */
+static SketchBins *
+sketchbins_extend(FunctionCallInfo fcinfo, SketchBins *state, int32 kind,
+	double fraction, int64 size, int64 first, int64 last)
+{
+	size_t binsize = (kind == SKETCH_HLL) ? sizeof(HLLBin) :
+		sizeof(TDigestBin);
+	if (state != NULL)
+	{
+		if (state->size != size)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				errmsg("Cannot aggregate values with different bucket intervals")));
+		if (state->fraction != fraction)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				errmsg("Cannot aggregate values with different fractions")));
+		if (first >= state->first && last < state->first + state->count)
+			return state;
+		first = Min(first, state->first);
+		last = Max(last, state->first + state->count - 1);
+	}
+	if (last - first + 1 > (int64) ((MaxAllocSize - sizeof(SketchBins)) / 
+			binsize))
+		ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+			errmsg("Too many buckets, use a larger bucket interval")));
+	int count = (int) (last - first + 1);
+	MemoryContext ctx = set_aggregation_context(fcinfo);
+	size_t memsize = offsetof(SketchBins, bins) + binsize * count;
+	SketchBins *result = palloc0(memsize);
+	unset_aggregation_context(ctx);
+	SET_VARSIZE(result, memsize);
+	result->count = count;
+	result->kind = kind;
+	result->fraction = fraction;
+	result->size = size;
+	result->first = first;
+	if (state != NULL)
+	{
+		memcpy(&result->bins[(state->first - first) * binsize], state->bins, 
+			binsize * state->count);
+		pfree(state);
+	}
+	return result;
+}
+
+static inline HLLBin *
+sketchbins_hll(SketchBins *state, int64 number)
+{
+	return (HLLBin *) &state->bins[(number - state->first) * sizeof(HLLBin)];
+}
+
+static inline TDigestBin *
+sketchbins_tdigest(SketchBins *state, int64 number)
+{
+	return (TDigestBin *) &state->bins[(number - state->first) *
+		sizeof(TDigestBin)];
+}
+
+/*****************************************************************************/
+
+/*
+ * The first HLL_BITS bits of the hash select the register, which keeps the
+ * maximum position of the first 1 bit in the remaining bits
+ */
+static void
+hll_add(void *data, int64 number, Datum value)
+{
+	SketchAdd *add = (SketchAdd *) data;
+	HLLBin *bin = sketchbins_hll(add->state, number);
+	int index = (int) (add->hash >> (64 - HLL_BITS));
+	uint64 rest = add->hash << HLL_BITS;
+	uint8 rank = 1;
+	while (rank <= 64 - HLL_BITS &&
+		(rest & UINT64CONST(0x8000000000000000)) == 0)
+	{
+		rank++;
+		rest <<= 1;
+	}
+	if (bin->registers[index] < rank)
+		bin->registers[index] = rank;
+}
+
+/* Estimated number of distinct keys, or -1 if the bin is empty */
+
+static double
+hll_estimate(const HLLBin *bin)
+{
+	double m = HLL_REGISTERS, sum = 0;
+	int zeros = 0;
+	for (int i = 0; i < HLL_REGISTERS; i++)
+	{
+		sum += ldexp(1.0, - (int) bin->registers[i]);
+		if (bin->registers[i] == 0)
+			zeros++;
+	}
+	if (zeros == HLL_REGISTERS)
+		return -1;
+	double alpha = 0.7213 / (1.0 + 1.079 / m);
+	double result = alpha * m * m / sum;
+	/* Linear counting for small cardinalities. There is no need of a
+	 * correction for large cardinalities with hashes in 64 bits. */
+	if (result <= 2.5 * m && zeros > 0)
+		result = m * log(m / zeros);
+	return result;
+}
+
+/*****************************************************************************/
+
+static int
+tdigest_centroid_cmp(const void *a, const void *b)
+{
+	double m1 = ((const TDigestCentroid *) a)->mean;
+	double m2 = ((const TDigestCentroid *) b)->mean;
+	return (m1 < m2) ? -1 : ((m1 > m2) ? 1 : 0);
+}
+
+/*
+ * Largest quantile that a centroid starting at the quantile q may reach,
+ * which is one unit after q for the scale function
+ * k(q) = compression / (2 pi) * asin(2q - 1). This keeps the centroids
+ * small near the extreme quantiles.
+ */
+static double
+tdigest_limit(double q)
+{
+	double k = TDIGEST_COMPRESSION / (2 * M_PI) * asin(2 * q - 1) + 1;
+	if (k >= TDIGEST_COMPRESSION / 4.0)
+		return 1.0;
+	return (sin(k * 2 * M_PI / TDIGEST_COMPRESSION) + 1) / 2;
+}
+
+/*
+ * Merge the adjacent centroids while they fit within one unit of the scale
+ * function. This results in at most TDIGEST_COMPRESSION + 1 centroids since
+ * two consecutive ones span at least one unit.
+ */
+static void
+tdigest_compress(TDigestBin *bin)
+{
+	if (bin->count <= 1)
+		return;
+	qsort(bin->centroids, bin->count, sizeof(TDigestCentroid),
+		&tdigest_centroid_cmp);
+	double before = 0;
+	double limit = tdigest_limit(0) * bin->weight;
+	int k = 0;
+	for (int i = 1; i < bin->count; i++)
+	{
+		TDigestCentroid *cur = &bin->centroids[k];
+		TDigestCentroid *next = &bin->centroids[i];
+		if (before + cur->weight + next->weight <= limit)
+		{
+			cur->weight += next->weight;
+			cur->mean += (next->mean - cur->mean) * next->weight / cur->weight;
+		}
+		else
+		{
+			before += cur->weight;
+			limit = tdigest_limit(before / bin->weight) * bin->weight;
+			bin->centroids[++k] = *next;
+		}
+	}
+	bin->count = k + 1;
+}
+
+static void
+tdigest_add_centroid(TDigestBin *bin, double mean, double weight)
+{
+	if (bin->count == TDIGEST_CAPACITY)
+		tdigest_compress(bin);
+	if (bin->weight == 0)
+		bin->min = bin->max = mean;
+	else
+	{
+		bin->min = Min(bin->min, mean);
+		bin->max = Max(bin->max, mean);
+	}
+	bin->centroids[bin->count].mean = mean;
+	bin->centroids[bin->count].weight = weight;
+	bin->count++;
+	bin->weight += weight;
+}
+
+static void
+tdigest_add(void *data, int64 number, Datum value)
+{
+	SketchAdd *add = (SketchAdd *) data;
+	tdigest_add_centroid(sketchbins_tdigest(add->state, number),
+		datum_double(value, add->valuetypid), 1);
+}
+
+/* Merge the second bin into the first one */
+
+static void
+tdigest_merge(TDigestBin *bin1, const TDigestBin *bin2)
+{
+	if (bin2->weight == 0)
+		return;
+	double min = (bin1->weight == 0) ? bin2->min : Min(bin1->min, bin2->min);
+	double max = (bin1->weight == 0) ? bin2->max : Max(bin1->max, bin2->max);
+	for (int i = 0; i < bin2->count; i++)
+		tdigest_add_centroid(bin1, bin2->centroids[i].mean,
+			bin2->centroids[i].weight);
+	bin1->min = min;
+	bin1->max = max;
+}
+
+/*
+ * Estimated value at the fraction of the values of a non-empty bin, which
+ * interpolates linearly between the centers of the centroids and between
+ * the extreme values and the extreme centroids. The centroids are
+ * compressed in a copy since the state must not be modified.
+ */
+static double
+tdigest_quantile(const TDigestBin *bin, double fraction)
+{
+	TDigestBin *copy = palloc(sizeof(TDigestBin));
+	memcpy(copy, bin, sizeof(TDigestBin));
+	tdigest_compress(copy);
+	TDigestCentroid *c = copy->centroids;
+	int n = copy->count;
+	double target = fraction * copy->weight;
+	double result;
+	if (target <= c[0].weight / 2)
+		result = copy->min + (c[0].mean - copy->min) * target /
+			(c[0].weight / 2);
+	else if (target >= copy->weight - c[n - 1].weight / 2)
+		result = c[n - 1].mean + (copy->max - c[n - 1].mean) *
+			(target - copy->weight + c[n - 1].weight / 2) /
+			(c[n - 1].weight / 2);
+	else
+	{
+		double before = 0;
+		int i = 0;
+		while (before + c[i].weight + c[i + 1].weight / 2 < target)
+			before += c[i++].weight;
+		double center1 = before + c[i].weight / 2;
+		double center2 = before + c[i].weight + c[i + 1].weight / 2;
+		result = c[i].mean + (c[i + 1].mean - c[i].mean) *
+			(target - center1) / (center2 - center1);
+	}
+	pfree(copy);
+	return result;
+}
+
+/*****************************************************************************/
+
+static SketchBins *
+temporal_sketch_transfn(FunctionCallInfo fcinfo, SketchBins *state,
+	Temporal *temp, Interval *interval, int32 kind, double fraction,
+	uint64 hash)
+{
+	int64 size = bucket_interval_size(interval);
+	Period p;
+	temporal_period(&p, temp);
+	state = sketchbins_extend(fcinfo, state, kind, fraction, size, 
+		timebin_number(p.lower, size), timebin_number(p.upper, size));
+	MOBDB_STAT_INSTANTS(temp);
+	TRACE_MOBILITYDB_AGG_TRANSFN_START(temporal_stat_instants(temp));
+	SketchAdd add;
+	add.state = state;
+	add.valuetypid = temp->valuetypid;
+	add.hash = hash;
+	if (kind == SKETCH_HLL)
+		temporal_timebins(temp, size, false, &hll_add, &add);
+	else
+		temporal_timebins(temp, size, true, &tdigest_add, &add);
+	TRACE_MOBILITYDB_AGG_TRANSFN_DONE(state->count);
+	return state;
+}
+
+PG_FUNCTION_INFO_V1(temporal_tcount_distinct_transfn);
+
+PGDLLEXPORT Datum 
+temporal_tcount_distinct_transfn(PG_FUNCTION_ARGS)
+{
+	SketchBins *state = PG_ARGISNULL(0) ? NULL : 
+		(SketchBins *) PG_GETARG_POINTER(0);
+	if (PG_ARGISNULL(1) || PG_ARGISNULL(2) || PG_ARGISNULL(3))
+	{
+		if (state)
+			PG_RETURN_POINTER(state);
+		else
+			PG_RETURN_NULL();
+	}
+	Temporal *temp = PG_GETARG_TEMPORAL(1);
+	uint64 hash = sketch_key_hash(fcinfo, 2);
+	Interval *interval = PG_GETARG_INTERVAL_P(3);
+	state = temporal_sketch_transfn(fcinfo, state, temp, interval, 
+		SKETCH_HLL, 0, hash);
+	PG_FREE_IF_COPY(temp, 1);
+	PG_RETURN_POINTER(state);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_tpercentile_transfn);
+
+PGDLLEXPORT Datum 
+tnumber_tpercentile_transfn(PG_FUNCTION_ARGS)
+{
+	SketchBins *state = PG_ARGISNULL(0) ? NULL : 
+		(SketchBins *) PG_GETARG_POINTER(0);
+	if (PG_ARGISNULL(1) || PG_ARGISNULL(2) || PG_ARGISNULL(3))
+	{
+		if (state)
+			PG_RETURN_POINTER(state);
+		else
+			PG_RETURN_NULL();
+	}
+	Temporal *temp = PG_GETARG_TEMPORAL(1);
+	double fraction = PG_GETARG_FLOAT8(2);
+	Interval *interval = PG_GETARG_INTERVAL_P(3);
+	if (fraction < 0 || fraction > 1)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The fraction must be between 0 and 1")));
+	ensure_numeric_base_type(temp->valuetypid);
+	state = temporal_sketch_transfn(fcinfo, state, temp, interval, 
+		SKETCH_TDIGEST, fraction, 0);
+	PG_FREE_IF_COPY(temp, 1);
+	PG_RETURN_POINTER(state);
+}
+
+PG_FUNCTION_INFO_V1(temporal_sketch_combinefn);
+
+PGDLLEXPORT Datum 
+temporal_sketch_combinefn(PG_FUNCTION_ARGS)
+{
+	SketchBins *state1 = PG_ARGISNULL(0) ? NULL : 
+		(SketchBins *) PG_GETARG_POINTER(0);
+	SketchBins *state2 = PG_ARGISNULL(1) ? NULL :
+		(SketchBins *) PG_GETARG_POINTER(1);
+	if (! state1)
+		PG_RETURN_POINTER(state2);
+	if (! state2)
+		PG_RETURN_POINTER(state1);
+	state1 = sketchbins_extend(fcinfo, state1, state2->kind, state2->fraction,
+		state2->size, state2->first, state2->first + state2->count - 1);
+	for (int i = 0; i < state2->count; i++)
+	{
+		int64 number = state2->first + i;
+		if (state1->kind == SKETCH_HLL)
+		{
+			HLLBin *bin1 = sketchbins_hll(state1, number);
+			HLLBin *bin2 = sketchbins_hll(state2, number);
+			for (int j = 0; j < HLL_REGISTERS; j++)
+				bin1->registers[j] = Max(bin1->registers[j], bin2->registers[j]);
+		}
+		else
+			tdigest_merge(sketchbins_tdigest(state1, number),
+				sketchbins_tdigest(state2, number));
+	}
+	PG_RETURN_POINTER(state1);
+}
+
+PG_FUNCTION_INFO_V1(temporal_tcount_distinct_finalfn);
+
+PGDLLEXPORT Datum
+temporal_tcount_distinct_finalfn(PG_FUNCTION_ARGS)
+{
+	/* The final function is strict, we do not need to test for null values */
+	SketchBins *state = (SketchBins *) PG_GETARG_POINTER(0);
+	Datum *values = palloc(sizeof(Datum) * state->count);
+	bool *defined = palloc(sizeof(bool) * state->count);
+	for (int i = 0; i < state->count; i++)
+	{
+		double estimate = hll_estimate(sketchbins_hll(state, state->first + i));
+		defined[i] = (estimate >= 0);
+		values[i] = Int32GetDatum((int32) Min(rint(estimate), PG_INT32_MAX));
+	}
+	TemporalS *result = timebins_result(values, defined, state->count,
+		state->first, state->size, INT4OID);
+	pfree(values); pfree(defined);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(tnumber_tpercentile_finalfn);
+
+PGDLLEXPORT Datum
+tnumber_tpercentile_finalfn(PG_FUNCTION_ARGS)
+{
+	/* The final function is strict, we do not need to test for null values */
+	SketchBins *state = (SketchBins *) PG_GETARG_POINTER(0);
+	Datum *values = palloc(sizeof(Datum) * state->count);
+	bool *defined = palloc(sizeof(bool) * state->count);
+	for (int i = 0; i < state->count; i++)
+	{
+		TDigestBin *bin = sketchbins_tdigest(state, state->first + i);
+		defined[i] = (bin->weight > 0);
+		values[i] = defined[i] ?
+			Float8GetDatum(tdigest_quantile(bin, state->fraction)) : 0;
+	}
+	TemporalS *result = timebins_result(values, defined, state->count,
+		state->first, state->size, FLOAT8OID);
+	pfree(values); pfree(defined);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************/
@@ -61,6 +61,18 @@
  * 		- staop contains the "<" operator of the time dimension.
  * 		- stavalues stores the length of the histogram of periods for the time dimension.
  * 		- numvalues contains the number of buckets in the histogram.
+ * - Slot 5 (only for temporal numbers)
+ * 		- stakind contains the type of statistics which is STATISTIC_KIND_TBOX_HISTOGRAM.
+ * 		- staop is InvalidOid.
+ * 		- stavalues stores the boundaries of the buckets of the value dimension
+ * 		  followed by those of the time dimension.
+ * 		- stanumbers stores the fraction of the values in each bucket of the
+ * 		  two-dimensional histogram.
+ * - Next available slot, if any
+ * 		- stakind contains the type of statistics which is STATISTIC_KIND_NUM_INSTANTS_HISTOGRAM.
+ * 		- staop contains the "<" operator of float8.
+ * 		- stavalues stores the histogram of the number of instants of the values.
+ * 		- stanumbers stores the average number of instants of the values.
  *
  * Notice that some statistics may not be collected, for example, since there
  * are no most common values. In that case, the next statistics collected is
@@ -1062,6 +1074,204 @@ range_compute_stats(VacAttrStats *stats, int non_null_cnt, int *slot_idx,
 	MemoryContextSwitchTo(old_cxt);
 }
 
+/*
+ * Compute the boundaries of the buckets of a dimension of the two-dimensional
+ * histogram, which are evenly-spaced in the sorted array of the lower and
+ * upper bounds of the values so that the buckets contain approximately the 
+ * same number of bounds.
+ */
+static void
+tbox_hist_bin_edges(double *bounds, int nbounds, int num_bins, double *edges)
+{
+	int i;
+	qsort(bounds, (size_t) nbounds, sizeof(double), float8_qsort_cmp);
+	for (i = 0; i < num_bins; i++)
+		edges[i] = bounds[(int) (((int64) i * (nbounds - 1)) / num_bins)];
+	edges[num_bins] = bounds[nbounds - 1];
+}
+
+/*
+ * Compute the fraction of the extent [min, max] of a value that falls in
+ * each bucket of a dimension of the two-dimensional histogram. A value 
+ * whose extent is a single point is entirely assigned to the bucket that
+ * contains the point.
+ */
+static void
+tbox_hist_bin_ratios(const double *edges, int num_bins, double min, 
+	double max, double *ratios)
+{
+	int i;
+	for (i = 0; i < num_bins; i++)
+	{
+		if (max > min)
+			ratios[i] = Max(0.0, Min(max, edges[i + 1]) - Max(min, edges[i])) /
+				(max - min);
+		else
+			ratios[i] = (edges[i] <= min && 
+				(min < edges[i + 1] || i == num_bins - 1)) ? 1.0 : 0.0;
+	}
+}
+
+/*
+ * Compute a two-dimensional histogram of the value and time dimensions of 
+ * temporal numbers, which keeps the correlation between both dimensions
+ * that is lost by the histograms of each dimension. The buckets are the
+ * cartesian product of the buckets of both dimensions and the bounding box
+ * of each sample value is distributed among the buckets it overlaps in
+ * proportion to the overlap.
+ */
+static void
+tbox_hist_compute_stats(VacAttrStats *stats, int non_null_cnt, int *slot_idx,
+	double *xmins, double *xmaxs, double *tmins, double *tmaxs)
+{
+	int num_bins = Min(stats->attr->attstattarget, TBOX_HIST_MAX_BINS),
+		i, j, k;
+	double *bounds, *xedges, *tedges, *xratios, *tratios;
+	float4 *hist;
+	Datum *edge_values;
+	MemoryContext old_cxt;
+
+	if (num_bins < 2 || non_null_cnt < 2 || *slot_idx >= STATISTIC_NUM_SLOTS)
+		return;
+
+	/* Compute the boundaries of the buckets of each dimension */
+	bounds = palloc(sizeof(double) * non_null_cnt * 2);
+	xedges = palloc(sizeof(double) * (num_bins + 1));
+	tedges = palloc(sizeof(double) * (num_bins + 1));
+	memcpy(bounds, xmins, sizeof(double) * non_null_cnt);
+	memcpy(bounds + non_null_cnt, xmaxs, sizeof(double) * non_null_cnt);
+	tbox_hist_bin_edges(bounds, non_null_cnt * 2, num_bins, xedges);
+	memcpy(bounds, tmins, sizeof(double) * non_null_cnt);
+	memcpy(bounds + non_null_cnt, tmaxs, sizeof(double) * non_null_cnt);
+	tbox_hist_bin_edges(bounds, non_null_cnt * 2, num_bins, tedges);
+
+	/* Must copy the target values into anl_context */
+	old_cxt = MemoryContextSwitchTo(stats->anl_context);
+	hist = palloc0(sizeof(float4) * num_bins * num_bins);
+	edge_values = palloc(sizeof(Datum) * (num_bins + 1) * 2);
+	for (i = 0; i <= num_bins; i++)
+	{
+		edge_values[i] = Float8GetDatum(xedges[i]);
+		edge_values[num_bins + 1 + i] = Float8GetDatum(tedges[i]);
+	}
+	MemoryContextSwitchTo(old_cxt);
+
+	/* Distribute each sample value among the buckets it overlaps */
+	xratios = palloc(sizeof(double) * num_bins);
+	tratios = palloc(sizeof(double) * num_bins);
+	for (k = 0; k < non_null_cnt; k++)
+	{
+		tbox_hist_bin_ratios(xedges, num_bins, xmins[k], xmaxs[k], xratios);
+		tbox_hist_bin_ratios(tedges, num_bins, tmins[k], tmaxs[k], tratios);
+		for (i = 0; i < num_bins; i++)
+		{
+			if (xratios[i] == 0.0)
+				continue;
+			for (j = 0; j < num_bins; j++)
+				hist[i * num_bins + j] += (float4) (xratios[i] * tratios[j] /
+					non_null_cnt);
+		}
+	}
+
+	stats->stakind[*slot_idx] = STATISTIC_KIND_TBOX_HISTOGRAM;
+	stats->staop[*slot_idx] = InvalidOid;
+	stats->stanumbers[*slot_idx] = hist;
+	stats->numnumbers[*slot_idx] = num_bins * num_bins;
+	stats->stavalues[*slot_idx] = edge_values;
+	stats->numvalues[*slot_idx] = (num_bins + 1) * 2;
+	stats->statypid[*slot_idx] = FLOAT8OID;
+	stats->statyplen[*slot_idx] = sizeof(float8);
+	stats->statypbyval[*slot_idx] = true;
+	stats->statypalign[*slot_idx] = 'd';
+	(*slot_idx)++;
+
+	pfree(bounds); pfree(xedges); pfree(tedges);
+	pfree(xratios); pfree(tratios);
+}
+
+/*
+ * Returns the number of instants that a temporal value keeps, which
+ * measures the cost of processing it. Contrary to the function 
+ * temporals_num_instants, the instants shared by consecutive sequences 
+ * are counted twice, since they are stored twice.
+ */
+int
+temporal_stored_instants(const Temporal *temp)
+{
+	if (temp->duration == TEMPORALI)
+		return ((TemporalI *) temp)->count;
+	else if (temp->duration == TEMPORALSEQ)
+		return ((TemporalSeq *) temp)->count;
+	else if (temp->duration == TEMPORALS)
+		return ((TemporalS *) temp)->totalcount;
+	return 1;
+}
+
+/*
+ * Compute a histogram of the number of instants of the values of a column
+ * in the next available slot, if any. The average number of instants is
+ * kept in the stanumbers array of the slot.
+ */
+void
+num_instants_compute_stats(VacAttrStats *stats, int non_null_cnt, 
+	int *slot_idx, float8 *num_instants)
+{
+	int num_bins = stats->attr->attstattarget,
+		num_hist, delta, deltafrac, pos, posfrac, i;
+	Datum *hist_values;
+	float4 *avg;
+	double sum = 0.0;
+	MemoryContext old_cxt;
+
+	if (num_bins < 1 || non_null_cnt < 2 || *slot_idx >= STATISTIC_NUM_SLOTS)
+		return;
+
+	qsort(num_instants, (size_t) non_null_cnt, sizeof(float8), 
+		float8_qsort_cmp);
+	for (i = 0; i < non_null_cnt; i++)
+		sum += num_instants[i];
+
+	num_hist = non_null_cnt;
+	if (num_hist > num_bins)
+		num_hist = num_bins + 1;
+
+	/* Must copy the target values into anl_context */
+	old_cxt = MemoryContextSwitchTo(stats->anl_context);
+	hist_values = (Datum *) palloc(num_hist * sizeof(Datum));
+	avg = (float4 *) palloc(sizeof(float4));
+	avg[0] = (float4) (sum / non_null_cnt);
+	MemoryContextSwitchTo(old_cxt);
+
+	/* Copy evenly-spaced values as in the function period_compute_stats1 */
+	delta = (non_null_cnt - 1) / (num_hist - 1);
+	deltafrac = (non_null_cnt - 1) % (num_hist - 1);
+	pos = posfrac = 0;
+	for (i = 0; i < num_hist; i++)
+	{
+		hist_values[i] = Float8GetDatum(num_instants[pos]);
+		pos += delta;
+		posfrac += deltafrac;
+		if (posfrac >= (num_hist - 1))
+		{
+			/* fractional part exceeds 1, carry to integer part */
+			pos++;
+			posfrac -= (num_hist - 1);
+		}
+	}
+
+	stats->stakind[*slot_idx] = STATISTIC_KIND_NUM_INSTANTS_HISTOGRAM;
+	stats->staop[*slot_idx] = Float8LessOperator;
+	stats->stanumbers[*slot_idx] = avg;
+	stats->numnumbers[*slot_idx] = 1;
+	stats->stavalues[*slot_idx] = hist_values;
+	stats->numvalues[*slot_idx] = num_hist;
+	stats->statypid[*slot_idx] = FLOAT8OID;
+	stats->statyplen[*slot_idx] = sizeof(float8);
+	stats->statypbyval[*slot_idx] = true;
+	stats->statypalign[*slot_idx] = 'd';
+	(*slot_idx)++;
+}
+
 /* 
  * Compute statistics for all durations distinct from TemporalInst.
  * Function derived from compute_range_stats of file rangetypes_typanalyze.c 
@@ -1080,6 +1290,8 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		   *value_uppers;
 	PeriodBound *time_lowers,
 		   *time_uppers;
+	double *box_xmins, *box_xmaxs, *box_tmins, *box_tmaxs;
+	float8 *num_instants;
 	double total_width = 0;
 	Oid 	rangetypid = 0; /* make compiler quiet */
 	TypeCacheEntry *typcache;
@@ -1098,10 +1310,15 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		value_lowers = (RangeBound *) palloc(sizeof(RangeBound) * samplerows);
 		value_uppers = (RangeBound *) palloc(sizeof(RangeBound) * samplerows);
 		value_lengths = (float8 *) palloc(sizeof(float8) * samplerows);
+		box_xmins = (double *) palloc(sizeof(double) * samplerows);
+		box_xmaxs = (double *) palloc(sizeof(double) * samplerows);
+		box_tmins = (double *) palloc(sizeof(double) * samplerows);
+		box_tmaxs = (double *) palloc(sizeof(double) * samplerows);
 	}
 	time_lowers = (PeriodBound *) palloc(sizeof(PeriodBound) * samplerows);
 	time_uppers = (PeriodBound *) palloc(sizeof(PeriodBound) * samplerows);
 	time_lengths = (float8 *) palloc(sizeof(float8) * samplerows);
+	num_instants = (float8 *) palloc(sizeof(float8) * samplerows);
 
 	/* Loop over the temporal values. */
 	for (int i = 0; i < samplerows; i++)
@@ -1114,7 +1331,9 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 		Period period;
 		PeriodBound period_lower,
 				period_upper;
+		union bboxunion bbox;
 		Temporal *temp;
+		int numinst;
 	
 		/* Give backend a chance of interrupting us */
 		vacuum_delay_point();
@@ -1127,15 +1346,45 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 			continue;
 		}
 
-		total_width += VARSIZE(value);
+		/* 
+		 * Get the bounding box and the period of out-of-line values from the
+		 * slices of the datum containing them, which avoids detoasting the
+		 * whole value. In that case the value range is approximated by the
+		 * value extent of the bounding box with inclusive bounds.
+		 */
+		memset(&bbox, 0, sizeof(bbox));
+		if (temporal_bbox_slice(value, &bbox, &period, &numinst))
+		{
+			total_width += VARSIZE_ANY(DatumGetPointer(value));
+			if (valuestats)
+			{
+				Oid valuetypid = temporal_extra_data->value_type_id;
+				range = valuetypid == INT4OID ?
+					range_make(Int32GetDatum((int) bbox.b.xmin), 
+						Int32GetDatum((int) bbox.b.xmax), true, true, INT4OID) :
+					range_make(Float8GetDatum(bbox.b.xmin), 
+						Float8GetDatum(bbox.b.xmax), true, true, FLOAT8OID);
+			}
+		}
+		else
+		{
+			total_width += VARSIZE(value);
 
-		/* Get Temporal value */
-		temp = DatumGetTemporal(value);
+			/* Get Temporal value */
+			temp = DatumGetTemporal(value);
+			if (valuestats)
+			{
+				range = tnumber_value_range_internal(temp);
+				temporal_bbox(&bbox, temp);
+			}
+			temporal_period(&period, temp);
+			numinst = temporal_stored_instants(temp);
+		}
+		num_instants[non_null_cnt] = (float8) numinst;
 
 		/* Remember bounds and length for further usage in histograms */
 		if (valuestats)
 		{
-			range = tnumber_value_range_internal(temp);
 			range_deserialize(typcache, range, &range_lower, &range_upper, &isempty);
 			value_lowers[non_null_cnt] = range_lower;
 			value_uppers[non_null_cnt] = range_upper;
@@ -1147,13 +1396,21 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 				value_lengths[non_null_cnt] = DatumGetFloat8(range_upper.val) -
 					DatumGetFloat8(range_lower.val);
 		}
-		temporal_period(&period, temp);
 		period_deserialize(&period, &period_lower, &period_upper);
 		time_lowers[non_null_cnt] = period_lower;
 		time_uppers[non_null_cnt] = period_upper;
 		time_lengths[non_null_cnt] = period_to_secs(period_upper.val, 
 			period_lower.val);
 
+		/* Remember the bounding box for the two-dimensional histogram */
+		if (valuestats)
+		{
+			box_xmins[non_null_cnt] = bbox.b.xmin;
+			box_xmaxs[non_null_cnt] = bbox.b.xmax;
+			box_tmins[non_null_cnt] = (double) bbox.b.tmin / USECS_PER_SEC;
+			box_tmaxs[non_null_cnt] = (double) bbox.b.tmax / USECS_PER_SEC;
+		}
+
 		non_null_cnt++;
 	}
 
@@ -1176,6 +1433,13 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 
 		period_compute_stats1(stats, non_null_cnt, &slot_idx,
 			time_lowers, time_uppers, time_lengths);
+
+		if (valuestats)
+			tbox_hist_compute_stats(stats, non_null_cnt, &slot_idx, 
+				box_xmins, box_xmaxs, box_tmins, box_tmaxs);
+
+		num_instants_compute_stats(stats, non_null_cnt, &slot_idx, 
+			num_instants);
 	}
 	else if (null_cnt > 0)
 	{
@@ -1194,8 +1458,10 @@ temps_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
 	if (valuestats)
 	{
 		pfree(value_lowers); pfree(value_uppers); pfree(value_lengths);
+		pfree(box_xmins); pfree(box_xmaxs); pfree(box_tmins); pfree(box_tmaxs);
 	}
 	pfree(time_lowers); pfree(time_uppers); pfree(time_lengths);
+	pfree(num_instants);
 }
 
 /*****************************************************************************
@@ -3,6 +3,13 @@
  * temporal_boolops.c
  *	  Temporal Boolean operators (and, or, not).
  *
+ * Since temporal Booleans have stepwise interpolation, a normalized 
+ * sequence is a sorted list of the timestamps at which its value flips, 
+ * together with its initial value. The and/or of two sequences is thus 
+ * computed by merging their lists of timestamps, skipping the flips of a 
+ * sequence while the other one has the absorbing value (false for and, 
+ * true for or).
+ *
  * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
  * 		Universite Libre de Bruxelles
  * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
@@ -12,6 +19,9 @@
 
 #include "temporal_boolops.h"
 
+#include <utils/timestamp.h>
+
+#include "timeops.h"
 #include "temporaltypes.h"
 #include "lifting.h"
 
@@ -35,6 +45,186 @@ datum_or(Datum l, Datum r)
 	return BoolGetDatum(DatumGetBool(l) || DatumGetBool(r));
 }
 
+/*****************************************************************************
+ * Boolean operations on temporal Boolean sequences
+ *****************************************************************************/
+
+/*
+ * Returns the index of the first instant of the sequence from the index 
+ * start whose timestamp is after (or equal to if not strict) the timestamp, 
+ * or the number of instants if there is no such instant
+ */
+static int
+tboolseq_find_after(TemporalSeq *seq, int start, TimestampTz t, bool strict)
+{
+	int first = start, last = seq->count;
+	while (first < last)
+	{
+		int middle = (first + last) / 2;
+		int cmp = timestamp_cmp_internal(temporalseq_inst_n(seq, middle)->t, t);
+		if (cmp < 0 || (strict && cmp == 0))
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	return first;
+}
+
+static bool
+tboolseq_value_n(TemporalSeq *seq, int n)
+{
+	return DatumGetBool(temporalinst_value(temporalseq_inst_n(seq, n)));
+}
+
+/*
+ * Temporal and/or of two temporal Boolean sequences. Since the result 
+ * only keeps the instants at which its value flips, it is already 
+ * normalized.
+ */
+static TemporalSeq *
+tand_tor_tboolseq_tboolseq(TemporalSeq *seq1, TemporalSeq *seq2, bool and)
+{
+	Period inter;
+	if (!intersection_period_period_internal1(&inter, &seq1->period,
+		&seq2->period))
+		return NULL;
+
+	/* Values at the lower bound of the intersection */
+	int i = tboolseq_find_after(seq1, 0, inter.lower, true);
+	int j = tboolseq_find_after(seq2, 0, inter.lower, true);
+	bool value1 = tboolseq_value_n(seq1, i - 1);
+	bool value2 = tboolseq_value_n(seq2, j - 1);
+	bool absorb = ! and;
+	bool value = and ? value1 && value2 : value1 || value2;
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * 
+		(seq1->count + seq2->count + 1));
+	int k = 0;
+	instants[k++] = temporalinst_make(BoolGetDatum(value), inter.lower, 
+		BOOLOID);
+	if (timestamp_cmp_internal(inter.lower, inter.upper) == 0)
+	{
+		TemporalSeq *result = temporalseq_from_temporalinstarr_trusted(
+			instants, 1, true, true, false, false);
+		pfree(instants[0]); pfree(instants);
+		return result;
+	}
+
+	while (i < seq1->count || j < seq2->count)
+	{
+		TimestampTz t1 = (i < seq1->count) ? 
+			temporalseq_inst_n(seq1, i)->t : DT_NOEND;
+		TimestampTz t2 = (j < seq2->count) ? 
+			temporalseq_inst_n(seq2, j)->t : DT_NOEND;
+		/* The flips of a value before the next flip of an absorbing value 
+		 * do not change the result */
+		if (value1 == absorb && timestamp_cmp_internal(t1, t2) > 0)
+		{
+			int n = tboolseq_find_after(seq2, j, t1, false);
+			value2 = tboolseq_value_n(seq2, n - 1);
+			j = n;
+			t2 = (j < seq2->count) ? temporalseq_inst_n(seq2, j)->t : DT_NOEND;
+		}
+		else if (value2 == absorb && timestamp_cmp_internal(t2, t1) > 0)
+		{
+			int n = tboolseq_find_after(seq1, i, t2, false);
+			value1 = tboolseq_value_n(seq1, n - 1);
+			i = n;
+			t1 = (i < seq1->count) ? temporalseq_inst_n(seq1, i)->t : DT_NOEND;
+		}
+		TimestampTz t = Min(t1, t2);
+		if (timestamp_cmp_internal(t, inter.upper) > 0)
+			break;
+		if (t1 == t)
+			value1 = tboolseq_value_n(seq1, i++);
+		if (t2 == t)
+			value2 = tboolseq_value_n(seq2, j++);
+		if (timestamp_cmp_internal(t, inter.upper) == 0)
+			break;
+		bool newvalue = and ? value1 && value2 : value1 || value2;
+		if (newvalue != value)
+		{
+			value = newvalue;
+			instants[k++] = temporalinst_make(BoolGetDatum(value), t, BOOLOID);
+		}
+	}
+	/* The value at an exclusive upper bound is the one before it */
+	if (inter.upper_inc)
+		value = and ? value1 && value2 : value1 || value2;
+	instants[k++] = temporalinst_make(BoolGetDatum(value), inter.upper, 
+		BOOLOID);
+	TemporalSeq *result = temporalseq_from_temporalinstarr_trusted(instants, 
+		k, inter.lower_inc, inter.upper_inc, false, false);
+	for (int l = 0; l < k; l++)
+		pfree(instants[l]);
+	pfree(instants);
+	return result;
+}
+
+/*
+ * Temporal and/or of two temporal Booleans. Sequences and sequence sets 
+ * are combined by merging the lists of their flips, the other durations
+ * are synchronized with the generic lifting functions.
+ */
+static Temporal *
+tand_tor_tbool_tbool(Temporal *temp1, Temporal *temp2, bool and)
+{
+	if ((temp1->duration != TEMPORALSEQ && temp1->duration != TEMPORALS) ||
+		(temp2->duration != TEMPORALSEQ && temp2->duration != TEMPORALS))
+		return sync_tfunc2_temporal_temporal(temp1, temp2, 
+			and ? &datum_and : &datum_or, BOOLOID, false, NULL);
+
+	if (temp1->duration == TEMPORALSEQ && temp2->duration == TEMPORALSEQ)
+		return (Temporal *) tand_tor_tboolseq_tboolseq((TemporalSeq *) temp1,
+			(TemporalSeq *) temp2, and);
+
+	TemporalSeq **sequences1 = temp1->duration == TEMPORALSEQ ?
+		(TemporalSeq **) &temp1 : temporals_sequences((TemporalS *) temp1);
+	TemporalSeq **sequences2 = temp2->duration == TEMPORALSEQ ?
+		(TemporalSeq **) &temp2 : temporals_sequences((TemporalS *) temp2);
+	int count1 = temp1->duration == TEMPORALSEQ ? 1 : 
+		((TemporalS *) temp1)->count;
+	int count2 = temp2->duration == TEMPORALSEQ ? 1 : 
+		((TemporalS *) temp2)->count;
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * 
+		(count1 + count2));
+	int i = 0, j = 0, k = 0;
+	while (i < count1 && j < count2)
+	{
+		TemporalSeq *seq1 = sequences1[i];
+		TemporalSeq *seq2 = sequences2[j];
+		TemporalSeq *seq = tand_tor_tboolseq_tboolseq(seq1, seq2, and);
+		if (seq != NULL)
+			sequences[k++] = seq;
+		int cmp = timestamp_cmp_internal(seq1->period.upper, seq2->period.upper);
+		if (cmp == 0)
+		{
+			if (!seq1->period.upper_inc && seq2->period.upper_inc)
+				cmp = -1;
+			else if (seq1->period.upper_inc && !seq2->period.upper_inc)
+				cmp = 1;
+		}
+		if (cmp == 0)
+		{
+			i++; j++;
+		}
+		else if (cmp < 0)
+			i++; 
+		else 
+			j++;
+	}
+	TemporalS *result = NULL;
+	if (k > 0)
+		result = temporals_from_temporalseqarr(sequences, k, false, true);
+	for (i = 0; i < k; i++)
+		pfree(sequences[i]);
+	pfree(sequences);
+	if (temp1->duration == TEMPORALS)
+		pfree(sequences1);
+	if (temp2->duration == TEMPORALS)
+		pfree(sequences2);
+	return (Temporal *) result;
+}
+
 /*****************************************************************************
  * Temporal and
  *****************************************************************************/
@@ -72,8 +262,7 @@ tand_tbool_tbool(PG_FUNCTION_ARGS)
 {
 	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	Temporal *result = sync_tfunc2_temporal_temporal(temp1, temp2, 
-		&datum_and, BOOLOID, false, NULL);
+	Temporal *result = tand_tor_tbool_tbool(temp1, temp2, true);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
 	if (result == NULL)
@@ -118,8 +307,7 @@ tor_tbool_tbool(PG_FUNCTION_ARGS)
 {
 	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
 	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
-	Temporal *result = sync_tfunc2_temporal_temporal(temp1, temp2, 
-		&datum_or, BOOLOID, false, NULL);
+	Temporal *result = tand_tor_tbool_tbool(temp1, temp2, false);
 	PG_FREE_IF_COPY(temp1, 0);
 	PG_FREE_IF_COPY(temp2, 1);
 	if (result == NULL)
@@ -171,15 +359,13 @@ static TemporalS *
 tnot_tbools(TemporalS *ts)
 {
 	TemporalS *result = temporals_copy(ts);
-	for (int i = 0; i < ts->count; i++)
+	TemporalInstIterator it;
+	TemporalInst *inst;
+	temporalinst_iterator_init(&it, (Temporal *)result);
+	while ((inst = temporalinst_iterator_next(&it)) != NULL)
 	{
-		TemporalSeq *seq = temporals_seq_n(result, i);
-		for (int j = 0; j < seq->count; j++)
-		{
-			TemporalInst *inst = temporalseq_inst_n(seq, j);
-			Datum *value_ptr = temporalinst_value_ptr(inst);
-			*value_ptr = BoolGetDatum(!DatumGetBool(temporalinst_value(inst)));
-		}
+		Datum *value_ptr = temporalinst_value_ptr(inst);
+		*value_ptr = BoolGetDatum(!DatumGetBool(temporalinst_value(inst)));
 	}
 	return result;
 }
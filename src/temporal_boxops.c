@@ -204,6 +204,45 @@ temporal_bbox_cmp(Oid valuetypid, void *box1, void *box2)
 	return result;
 } 
 
+/*****************************************************************************
+ * Bounding boxes of the arguments of a function kept in fn_extra
+ *****************************************************************************/
+
+/*
+ * Get the cache of the bounding box of an argument of a function call.
+ * When the argument does not change across the calls of the expression, as
+ * is the case for a query constant, the box derived from it is computed
+ * only once and kept in fn_extra, which is therefore not available for
+ * other purposes in the calling function. Returns NULL when the argument
+ * may change from one call to the next.
+ */
+BoxCache *
+box_cache_fn(FunctionCallInfo fcinfo, int argno)
+{
+	FmgrInfo *flinfo = fcinfo->flinfo;
+	if (flinfo == NULL)
+		return NULL;
+	BoxCache *cache = (BoxCache *) flinfo->fn_extra;
+	if (cache == NULL)
+	{
+		cache = MemoryContextAllocZero(flinfo->fn_mcxt, sizeof(BoxCache));
+		cache->stable = get_fn_expr_arg_stable(flinfo, argno);
+		flinfo->fn_extra = cache;
+	}
+	return cache->stable ? cache : NULL;
+}
+
+/* Keep in the cache, if any, the box computed from the argument */
+void
+box_cache_set(BoxCache *cache, const void *box, size_t size, bool found)
+{
+	if (cache == NULL)
+		return;
+	memcpy(&cache->box, box, size);
+	cache->found = found;
+	cache->valid = true;
+}
+
 /*****************************************************************************
  * Compute the bounding box at the creation of temporal values
  * Only external types have precomputed bbox, internal types such as double2, 
@@ -307,9 +346,8 @@ temporalseq_make_bbox(void *box, TemporalInst **instants, int count,
 	else if (valuetypid == INT4OID || valuetypid == FLOAT8OID) 
 		tnumberinstarr_to_tbox((TBOX *)box, instants, count);
 #ifdef WITH_POSTGIS
-	/* This code is currently not used since for temporal points the bounding
-	 * box is computed from the trajectory for efficiency reasons. It is left
-	 * here in case this is no longer the case */
+	/* For temporal points whose trajectory is precomputed the bounding box
+	 * is computed from the trajectory for efficiency reasons */
 	else if (instants[0]->valuetypid == type_oid(T_GEOGRAPHY) || 
 		instants[0]->valuetypid == type_oid(T_GEOMETRY)) 
 		tpointinstarr_to_stbox((STBOX *)box, instants, count);
@@ -368,23 +406,49 @@ shift_bbox(void *box, Oid valuetypid, Interval *interval)
 	if (valuetypid == BOOLOID || valuetypid == TEXTOID)
 	{
         Period *period = (Period *)box;
-		period->lower = DatumGetTimestampTz(
-			DirectFunctionCall2(timestamptz_pl_interval,
-			TimestampTzGetDatum(period->lower), PointerGetDatum(interval)));
-		period->upper = DatumGetTimestampTz(
-			DirectFunctionCall2(timestamptz_pl_interval,
-			TimestampTzGetDatum(period->upper), PointerGetDatum(interval)));
+		period->lower = timestamp_shift(period->lower, interval);
+		period->upper = timestamp_shift(period->upper, interval);
+		return;
+	}
+	else if (valuetypid == INT4OID || valuetypid == FLOAT8OID)
+	{
+		TBOX *tbox = (TBOX *)box;
+		tbox->tmin = timestamp_shift(tbox->tmin, interval);
+		tbox->tmax = timestamp_shift(tbox->tmax, interval);
+		return;
+	}
+#ifdef WITH_POSTGIS
+	else if (valuetypid == type_oid(T_GEOGRAPHY) ||
+		valuetypid == type_oid(T_GEOMETRY))
+	{
+		STBOX *stbox = (STBOX *)box;
+		stbox->tmin = timestamp_shift(stbox->tmin, interval);
+		stbox->tmax = timestamp_shift(stbox->tmax, interval);
+		return;
+	}
+#endif
+}
+
+/*****************************************************************************
+ * Scale the time span of the bounding box of a Temporal from an origin
+ *****************************************************************************/
+
+void 
+tscale_bbox(void *box, Oid valuetypid, TimestampTz origin, double scale)
+{
+	ensure_temporal_base_type(valuetypid);
+	if (valuetypid == BOOLOID || valuetypid == TEXTOID)
+	{
+		Period *period = (Period *)box;
+		period->lower = timestamp_tscale(period->lower, origin, scale);
+		period->upper = timestamp_tscale(period->upper, origin, scale);
 		return;
 	}
 	else if (valuetypid == INT4OID || valuetypid == FLOAT8OID)
 	{
 		TBOX *tbox = (TBOX *)box;
-		tbox->tmin = DatumGetTimestampTz(
-			DirectFunctionCall2(timestamptz_pl_interval,
-			TimestampTzGetDatum(tbox->tmin), PointerGetDatum(interval)));
-		tbox->tmax = DatumGetTimestampTz(
-			DirectFunctionCall2(timestamptz_pl_interval,
-			TimestampTzGetDatum(tbox->tmax), PointerGetDatum(interval)));
+		tbox->tmin = timestamp_tscale(tbox->tmin, origin, scale);
+		tbox->tmax = timestamp_tscale(tbox->tmax, origin, scale);
 		return;
 	}
 #ifdef WITH_POSTGIS
@@ -392,12 +456,8 @@ shift_bbox(void *box, Oid valuetypid, Interval *interval)
 		valuetypid == type_oid(T_GEOMETRY))
 	{
 		STBOX *stbox = (STBOX *)box;
-		stbox->tmin = DatumGetTimestampTz(
-			DirectFunctionCall2(timestamptz_pl_interval,
-			TimestampTzGetDatum(stbox->tmin), PointerGetDatum(interval)));
-		stbox->tmax = DatumGetTimestampTz(
-			DirectFunctionCall2(timestamptz_pl_interval,
-			TimestampTzGetDatum(stbox->tmax), PointerGetDatum(interval)));
+		stbox->tmin = timestamp_tscale(stbox->tmin, origin, scale);
+		stbox->tmax = timestamp_tscale(stbox->tmax, origin, scale);
 		return;
 	}
 #endif
@@ -518,6 +578,32 @@ temporals_expand_bbox(void *box, TemporalS *ts, TemporalInst *inst)
 	return result;
 }
 
+/* Expand in place the bounding box of a sequence with an instant appended
+ * at its end */
+
+void
+temporalseq_bbox_append(void *box, TemporalInst *inst)
+{
+	ensure_temporal_base_type(inst->valuetypid);
+	if (inst->valuetypid == BOOLOID || inst->valuetypid == TEXTOID)
+	{
+		Period *period = (Period *)box;
+		period_set(period, period->lower, inst->t, period->lower_inc, true);
+	}
+	else if (inst->valuetypid == INT4OID || inst->valuetypid == FLOAT8OID)
+	{
+		TBOX box1;
+		memset(&box1, 0, sizeof(TBOX));
+		temporalinst_bbox(&box1, inst);
+		tbox_expand((TBOX *)box, &box1);
+	}
+#ifdef WITH_POSTGIS
+	else if (inst->valuetypid == type_oid(T_GEOGRAPHY) || 
+		inst->valuetypid == type_oid(T_GEOMETRY)) 
+		tpointinst_expand_stbox((STBOX *)box, inst);
+#endif
+}
+
 /*****************************************************************************
  * Transform a <Type> to a TBOX
  * The functions assume that the argument box is set to 0 before with palloc0
@@ -537,6 +623,26 @@ number_to_box(TBOX *box, Datum value, Oid valuetypid)
 	MOBDB_FLAGS_SET_T(box->flags, false);
 }
 
+/*
+ * Get the box of the range argument of a function call, which is computed
+ * only once when the argument does not change across the calls of the
+ * expression (see box_cache_fn)
+ */
+void
+range_to_tbox_fn(TBOX *box, FunctionCallInfo fcinfo, int argno)
+{
+	BoxCache *cache = box_cache_fn(fcinfo, argno);
+	if (cache != NULL && cache->valid)
+	{
+		memcpy(box, &cache->box.b, sizeof(TBOX));
+		return;
+	}
+	RangeType *range = PG_GETARG_RANGE_P(argno);
+	range_to_tbox_internal(box, range);
+	PG_FREE_IF_COPY(range, argno);
+	box_cache_set(cache, box, sizeof(TBOX), true);
+}
+
 /* Transform an integer to a box */
 
 void
@@ -613,6 +719,34 @@ range_to_tbox_internal(TBOX *box, RangeType *range)
 	MOBDB_FLAGS_SET_T(box->flags, false);
 }
 
+/* Transform a deserialized range to a box, the range is assumed to be nonempty */
+
+void
+range_bounds_to_tbox(TBOX *box, const RangeBounds *bounds)
+{
+	Oid rangetypid = bounds->typcache->type_id;
+	ensure_numrange_type(rangetypid);
+	box->xmin = -get_float8_infinity();
+	box->xmax = get_float8_infinity();
+	if (rangetypid == type_oid(T_INTRANGE))
+	{
+		if (!bounds->lower.infinite)
+			box->xmin = (double)(DatumGetInt32(bounds->lower.val));
+		/* intranges are in canonical form so their upper bound is exclusive */
+		if (!bounds->upper.infinite)
+			box->xmax = (double)(DatumGetInt32(bounds->upper.val) - 1);
+	}
+	else if (rangetypid == type_oid(T_FLOATRANGE))
+	{
+		if (!bounds->lower.infinite)
+			box->xmin = DatumGetFloat8(bounds->lower.val);
+		if (!bounds->upper.infinite)
+			box->xmax = DatumGetFloat8(bounds->upper.val);
+	}
+	MOBDB_FLAGS_SET_X(box->flags, true);
+	MOBDB_FLAGS_SET_T(box->flags, false);
+}
+
 /* Transform an integer range to a box */
 
 void
@@ -909,11 +1043,9 @@ PGDLLEXPORT Datum
 contains_bbox_period_temporal(PG_FUNCTION_ARGS) 
 {
 	Period *p = PG_GETARG_PERIOD(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(1));
 	bool result = contains_period_period_internal(p, &p1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -922,12 +1054,10 @@ PG_FUNCTION_INFO_V1(contains_bbox_temporal_period);
 PGDLLEXPORT Datum
 contains_bbox_temporal_period(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Period *p = PG_GETARG_PERIOD(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
 	bool result = contains_period_period_internal(&p1, p);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -936,14 +1066,10 @@ PG_FUNCTION_INFO_V1(contains_bbox_temporal_temporal);
 PGDLLEXPORT Datum
 contains_bbox_temporal_temporal(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	Period p1, p2;
-	temporal_period(&p1, temp1);
-	temporal_period(&p2, temp2);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&p2, PG_GETARG_DATUM(1));
 	bool result = contains_period_period_internal(&p1, &p2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -955,11 +1081,9 @@ PGDLLEXPORT Datum
 contained_bbox_period_temporal(PG_FUNCTION_ARGS) 
 {
 	Period *p = PG_GETARG_PERIOD(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(1));
 	bool result = contains_period_period_internal(&p1, p);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -968,12 +1092,10 @@ PG_FUNCTION_INFO_V1(contained_bbox_temporal_period);
 PGDLLEXPORT Datum
 contained_bbox_temporal_period(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Period *p = PG_GETARG_PERIOD(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
 	bool result = contains_period_period_internal(p, &p1);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -982,14 +1104,10 @@ PG_FUNCTION_INFO_V1(contained_bbox_temporal_temporal);
 PGDLLEXPORT Datum
 contained_bbox_temporal_temporal(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	Period p1, p2;
-	temporal_period(&p1, temp1);
-	temporal_period(&p2, temp2);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&p2, PG_GETARG_DATUM(1));
 	bool result = contains_period_period_internal(&p2, &p1);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1001,11 +1119,9 @@ PGDLLEXPORT Datum
 overlaps_bbox_period_temporal(PG_FUNCTION_ARGS) 
 {
 	Period *p = PG_GETARG_PERIOD(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(1));
 	bool result = overlaps_period_period_internal(p, &p1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1014,12 +1130,10 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_temporal_period);
 PGDLLEXPORT Datum
 overlaps_bbox_temporal_period(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Period *p = PG_GETARG_PERIOD(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
 	bool result = overlaps_period_period_internal(&p1, p);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1028,14 +1142,10 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_temporal_temporal);
 PGDLLEXPORT Datum
 overlaps_bbox_temporal_temporal(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	Period p1, p2;
-	temporal_period(&p1, temp1);
-	temporal_period(&p2, temp2);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&p2, PG_GETARG_DATUM(1));
 	bool result = overlaps_period_period_internal(&p1, &p2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1047,11 +1157,9 @@ PGDLLEXPORT Datum
 same_bbox_period_temporal(PG_FUNCTION_ARGS) 
 {
 	Period *p = PG_GETARG_PERIOD(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(1));
 	bool result = period_eq_internal(p, &p1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1060,12 +1168,10 @@ PG_FUNCTION_INFO_V1(same_bbox_temporal_period);
 PGDLLEXPORT Datum
 same_bbox_temporal_period(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Period *p = PG_GETARG_PERIOD(1);
 	Period p1;
-	temporal_period(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
 	bool result = period_eq_internal(&p1, p);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1074,14 +1180,10 @@ PG_FUNCTION_INFO_V1(same_bbox_temporal_temporal);
 PGDLLEXPORT Datum
 same_bbox_temporal_temporal(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	Period p1, p2;
-	temporal_period(&p1, temp1);
-	temporal_period(&p2, temp2);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&p2, PG_GETARG_DATUM(1));
 	bool result = period_eq_internal(&p1, &p2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1094,16 +1196,12 @@ PG_FUNCTION_INFO_V1(contains_bbox_range_tnumber);
 PGDLLEXPORT Datum
 contains_bbox_range_tnumber(PG_FUNCTION_ARGS)
 {
-	RangeType *range = PG_GETARG_RANGE_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	range_to_tbox_internal(&box1, range);
-	temporal_bbox(&box2, temp);
+	range_to_tbox_fn(&box1, fcinfo, 0);
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = contains_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(range, 0);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1112,16 +1210,12 @@ PG_FUNCTION_INFO_V1(contains_bbox_tnumber_range);
 PGDLLEXPORT Datum
 contains_bbox_tnumber_range(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	RangeType *range = PG_GETARG_RANGE_P(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
-	range_to_tbox_internal(&box2, range);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	range_to_tbox_fn(&box2, fcinfo, 1);
 	bool result = contains_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp, 0);
-	PG_FREE_IF_COPY(range, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1131,12 +1225,10 @@ PGDLLEXPORT Datum
 contains_bbox_tbox_tnumber(PG_FUNCTION_ARGS) 
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = contains_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1145,13 +1237,11 @@ PG_FUNCTION_INFO_V1(contains_bbox_tnumber_tbox);
 PGDLLEXPORT Datum
 contains_bbox_tnumber_tbox(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = contains_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1160,16 +1250,12 @@ PG_FUNCTION_INFO_V1(contains_bbox_tnumber_tnumber);
 PGDLLEXPORT Datum
 contains_bbox_tnumber_tnumber(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = contains_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 	
@@ -1180,16 +1266,12 @@ PG_FUNCTION_INFO_V1(contained_bbox_range_tnumber);
 PGDLLEXPORT Datum
 contained_bbox_range_tnumber(PG_FUNCTION_ARGS)
 {
-	RangeType *range = PG_GETARG_RANGE_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	range_to_tbox_internal(&box1, range);
-	temporal_bbox(&box2, temp);
+	range_to_tbox_fn(&box1, fcinfo, 0);
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = contained_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(range, 0);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1198,16 +1280,12 @@ PG_FUNCTION_INFO_V1(contained_bbox_tnumber_range);
 PGDLLEXPORT Datum
 contained_bbox_tnumber_range(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	RangeType *range = PG_GETARG_RANGE_P(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
-	range_to_tbox_internal(&box2, range);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	range_to_tbox_fn(&box2, fcinfo, 1);
 	bool result = contained_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp, 0);
-	PG_FREE_IF_COPY(range, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1217,12 +1295,10 @@ PGDLLEXPORT Datum
 contained_bbox_tbox_tnumber(PG_FUNCTION_ARGS) 
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = contained_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1231,13 +1307,11 @@ PG_FUNCTION_INFO_V1(contained_bbox_tnumber_tbox);
 PGDLLEXPORT Datum
 contained_bbox_tnumber_tbox(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = contained_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1246,16 +1320,12 @@ PG_FUNCTION_INFO_V1(contained_bbox_tnumber_tnumber);
 PGDLLEXPORT Datum
 contained_bbox_tnumber_tnumber(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = contained_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 	
@@ -1266,16 +1336,12 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_range_tnumber);
 PGDLLEXPORT Datum
 overlaps_bbox_range_tnumber(PG_FUNCTION_ARGS)
 {
-	RangeType *range = PG_GETARG_RANGE_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	range_to_tbox_internal(&box1, range);
-	temporal_bbox(&box2, temp);
+	range_to_tbox_fn(&box1, fcinfo, 0);
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = overlaps_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(range, 0);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1284,16 +1350,12 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tnumber_range);
 PGDLLEXPORT Datum
 overlaps_bbox_tnumber_range(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	RangeType *range = PG_GETARG_RANGE_P(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
-	range_to_tbox_internal(&box2, range);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	range_to_tbox_fn(&box2, fcinfo, 1);
 	bool result = overlaps_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp, 0);
-	PG_FREE_IF_COPY(range, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1303,12 +1365,10 @@ PGDLLEXPORT Datum
 overlaps_bbox_tbox_tnumber(PG_FUNCTION_ARGS) 
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = overlaps_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1317,13 +1377,11 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tnumber_tbox);
 PGDLLEXPORT Datum
 overlaps_bbox_tnumber_tbox(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = overlaps_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1332,16 +1390,12 @@ PG_FUNCTION_INFO_V1(overlaps_bbox_tnumber_tnumber);
 PGDLLEXPORT Datum
 overlaps_bbox_tnumber_tnumber(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = overlaps_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 	
@@ -1352,16 +1406,12 @@ PG_FUNCTION_INFO_V1(same_bbox_tnumber_range);
 PGDLLEXPORT Datum
 same_bbox_tnumber_range(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	RangeType *range = PG_GETARG_RANGE_P(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
-	range_to_tbox_internal(&box2, range);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	range_to_tbox_fn(&box2, fcinfo, 1);
 	bool result = same_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp, 0);
-	PG_FREE_IF_COPY(range, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1370,16 +1420,12 @@ PG_FUNCTION_INFO_V1(same_bbox_range_tnumber);
 PGDLLEXPORT Datum
 same_bbox_range_tnumber(PG_FUNCTION_ARGS)
 {
-	RangeType *range = PG_GETARG_RANGE_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	range_to_tbox_internal(&box1, range);
-	temporal_bbox(&box2, temp);
+	range_to_tbox_fn(&box1, fcinfo, 0);
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = same_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(range, 0);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1389,12 +1435,10 @@ PGDLLEXPORT Datum
 same_bbox_tbox_tnumber(PG_FUNCTION_ARGS) 
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = same_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1403,13 +1447,11 @@ PG_FUNCTION_INFO_V1(same_bbox_tnumber_tbox);
 PGDLLEXPORT Datum
 same_bbox_tnumber_tbox(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = same_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -1418,16 +1460,12 @@ PG_FUNCTION_INFO_V1(same_bbox_tnumber_tnumber);
 PGDLLEXPORT Datum
 same_bbox_tnumber_tnumber(PG_FUNCTION_ARGS) 
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = same_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 	
@@ -0,0 +1,132 @@
+/*****************************************************************************
+ *
+ * temporal_brin.c
+ *	  BRIN inclusion index for time types and temporal numbers
+ *
+ * The operator classes below use the generic inclusion functions of
+ * PostgreSQL, which summarize each range of pages with a value of the
+ * storage type of the operator class, namely a period for periods and a
+ * temporal box for temporal numbers. The summary of periods is computed
+ * with the generic function for adding values since the indexed type and the
+ * storage type are the same, while for temporal numbers the bounding box of
+ * each new value is computed by the function brin_tnumber_add_value.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_brin.h"
+
+#include <access/brin_tuple.h>
+#include <utils/datum.h>
+#include <utils/timestamp.h>
+
+#include "timetypes.h"
+#include "period.h"
+#include "temporaltypes.h"
+
+/*****************************************************************************
+ * Merge functions
+ *****************************************************************************/
+
+/*
+ * Returns the smallest period that contains the two periods
+ */
+
+PG_FUNCTION_INFO_V1(brin_period_merge);
+
+PGDLLEXPORT Datum
+brin_period_merge(PG_FUNCTION_ARGS)
+{
+	Period *p1 = PG_GETARG_PERIOD(0);
+	Period *p2 = PG_GETARG_PERIOD(1);
+	Period *result = period_super_union(p1, p2);
+	PG_RETURN_POINTER(result);
+}
+
+/*
+ * Increase the temporal box to include the second one
+ */
+static void
+tbox_expand_brin(TBOX *box, const TBOX *addon)
+{
+	box->xmin = Min(box->xmin, addon->xmin);
+	box->xmax = Max(box->xmax, addon->xmax);
+	box->tmin = Min(box->tmin, addon->tmin);
+	box->tmax = Max(box->tmax, addon->tmax);
+}
+
+/*
+ * Returns the smallest temporal box that contains the two boxes
+ */
+
+PG_FUNCTION_INFO_V1(brin_tbox_merge);
+
+PGDLLEXPORT Datum
+brin_tbox_merge(PG_FUNCTION_ARGS)
+{
+	TBOX *box1 = PG_GETARG_TBOX_P(0);
+	TBOX *box2 = PG_GETARG_TBOX_P(1);
+	TBOX *result = palloc(sizeof(TBOX));
+	memcpy(result, box1, sizeof(TBOX));
+	tbox_expand_brin(result, box2);
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Add value function
+ *****************************************************************************/
+
+/*
+ * Enlarges the summary of a range of pages to include the bounding box of
+ * a new temporal number. Returns true if the summary has been modified.
+ */
+
+PG_FUNCTION_INFO_V1(brin_tnumber_add_value);
+
+PGDLLEXPORT Datum
+brin_tnumber_add_value(PG_FUNCTION_ARGS)
+{
+	BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+	Datum newval = PG_GETARG_DATUM(2);
+	bool isnull = PG_GETARG_BOOL(3);
+	Temporal *temp;
+	TBOX box, *union_box;
+
+	/* Record that we saw a null if it is the first one */
+	if (isnull)
+	{
+		if (column->bv_hasnulls)
+			PG_RETURN_BOOL(false);
+		column->bv_hasnulls = true;
+		PG_RETURN_BOOL(true);
+	}
+
+	temp = DatumGetTemporal(newval);
+	memset(&box, 0, sizeof(TBOX));
+	temporal_bbox(&box, temp);
+
+	/* If the summary is empty, store the bounding box */
+	if (column->bv_allnulls)
+	{
+		column->bv_values[INCLUSION_UNION] = datumCopy(PointerGetDatum(&box),
+			false, sizeof(TBOX));
+		column->bv_values[INCLUSION_UNMERGEABLE] = BoolGetDatum(false);
+		column->bv_values[INCLUSION_CONTAINS_EMPTY] = BoolGetDatum(false);
+		column->bv_allnulls = false;
+		PG_RETURN_BOOL(true);
+	}
+
+	/* Otherwise, enlarge the stored box if it does not contain the new one */
+	union_box = DatumGetTboxP(column->bv_values[INCLUSION_UNION]);
+	if (union_box->xmin <= box.xmin && box.xmax <= union_box->xmax &&
+		union_box->tmin <= box.tmin && box.tmax <= union_box->tmax)
+		PG_RETURN_BOOL(false);
+	tbox_expand_brin(union_box, &box);
+	PG_RETURN_BOOL(true);
+}
+
+/*****************************************************************************/
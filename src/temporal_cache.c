@@ -0,0 +1,167 @@
+/*****************************************************************************
+ *
+ * temporal_cache.c
+ *	  Query-scoped cache of detoasted temporal values
+ *
+ * A query such as
+ *		SELECT valueAtTimestamp(trip, t), length(trip), twavg(speed(trip))
+ * calls several functions over the same temporal value, each of which
+ * fetches the value out of its TOAST table, decompresses it and, for
+ * compressed sequences, decodes it. The functions taking their argument
+ * through PG_GETARG_TEMPORAL_CACHED keep instead the decoded values in a
+ * small cache keyed by their TOAST pointer, so that the other calls over the
+ * same row reuse them. Only values stored out of line are cached, since
+ * the other ones are cheap to fetch and have no stable identifier.
+ *
+ * The cache is allocated in the memory context of the current portal and
+ * thus disappears at the end of the query. The values stored in a TOAST
+ * table are never updated in place, so that a TOAST pointer identifies the
+ * same value during the whole query. Its size is set by the parameter
+ * mobilitydb.detoast_cache_size, the least recently used value being
+ * evicted when the cache is full.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_cache.h"
+
+#include <access/tuptoaster.h>
+#include <utils/memutils.h>
+
+#include "temporal_stats.h"
+
+/**
+ * @brief Value of the mobilitydb.detoast_cache_size parameter, i.e., the
+ *		maximum number of temporal values kept by the cache of a query.
+ *		The value 0 disables the cache.
+ */
+int detoast_cache_size = 8;
+
+typedef struct
+{
+	Oid toastrelid;				/* Identifier of the TOAST table */
+	Oid valueid;				/* Identifier of the value in the table */
+	uint64 lastused;			/* Tick of the last access */
+	Temporal *temp;				/* Decoded value */
+} TemporalCacheEntry;
+
+typedef struct
+{
+	MemoryContext mcxt;			/* Context of the cache and its values */
+	MemoryContextCallback callback;
+	uint64 tick;
+	int count;
+	TemporalCacheEntry entries[TEMPORAL_CACHE_MAX];
+} TemporalCache;
+
+static TemporalCache *temporal_cache = NULL;
+
+/*
+ * Forget the cache when the memory context of its query is reset or deleted
+ */
+static void
+temporal_cache_reset(void *arg)
+{
+	if (temporal_cache == (TemporalCache *) arg)
+		temporal_cache = NULL;
+}
+
+static TemporalCache *
+temporal_cache_get(void)
+{
+	if (temporal_cache != NULL)
+		return temporal_cache;
+	if (PortalContext == NULL)
+		return NULL;
+	MemoryContext mcxt = AllocSetContextCreate(PortalContext,
+		"MobilityDB detoast cache", ALLOCSET_DEFAULT_SIZES);
+	TemporalCache *cache = MemoryContextAllocZero(mcxt, sizeof(TemporalCache));
+	cache->mcxt = mcxt;
+	cache->callback.func = temporal_cache_reset;
+	cache->callback.arg = cache;
+	MemoryContextRegisterResetCallback(mcxt, &cache->callback);
+	temporal_cache = cache;
+	return cache;
+}
+
+/*
+ * Get the TOAST pointer of the value, returns false if the value is not
+ * stored out of line
+ */
+static bool
+temporal_cache_key(Datum value, struct varatt_external *toast_pointer)
+{
+	struct varlena *attr = (struct varlena *) DatumGetPointer(value);
+	if (! VARATT_IS_EXTERNAL_ONDISK(attr))
+		return false;
+	VARATT_EXTERNAL_GET_POINTER(*toast_pointer, attr);
+	return true;
+}
+
+static TemporalCacheEntry *
+temporal_cache_find(TemporalCache *cache, struct varatt_external *toast_pointer)
+{
+	for (int i = 0; i < cache->count; i++)
+	{
+		TemporalCacheEntry *entry = &cache->entries[i];
+		if (entry->valueid == toast_pointer->va_valueid &&
+			entry->toastrelid == toast_pointer->va_toastrelid)
+		{
+			entry->lastused = ++cache->tick;
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Returns the decoded temporal value, fetching it from the cache or
+ *		adding it to the cache when it is stored out of line
+ */
+Temporal *
+temporal_cache_getarg(Datum value)
+{
+	struct varatt_external toast_pointer;
+	TemporalCache *cache;
+	if (detoast_cache_size == 0 || ! temporal_cache_key(value, &toast_pointer) ||
+		(cache = temporal_cache_get()) == NULL)
+		return DatumGetTemporal(value);
+
+	TemporalCacheEntry *entry = temporal_cache_find(cache, &toast_pointer);
+	if (entry != NULL)
+		return entry->temp;
+
+	/* Evict the least recently used values beyond the size of the cache */
+	while (cache->count >= detoast_cache_size)
+	{
+		int lru = 0;
+		for (int i = 1; i < cache->count; i++)
+		{
+			if (cache->entries[i].lastused < cache->entries[lru].lastused)
+				lru = i;
+		}
+		pfree(cache->entries[lru].temp);
+		cache->entries[lru] = cache->entries[--cache->count];
+	}
+
+	MemoryContext oldcontext = MemoryContextSwitchTo(cache->mcxt);
+	struct varlena *detoasted = PG_DETOAST_DATUM(value);
+	MOBDB_STAT_ADD(detoast_bytes, VARSIZE(detoasted));
+	Temporal *temp = pg_getarg_temporal((Temporal *) detoasted);
+	if ((Pointer) temp != (Pointer) detoasted)
+		pfree(detoasted);
+	MemoryContextSwitchTo(oldcontext);
+
+	entry = &cache->entries[cache->count++];
+	entry->toastrelid = toast_pointer.va_toastrelid;
+	entry->valueid = toast_pointer.va_valueid;
+	entry->lastused = ++cache->tick;
+	entry->temp = temp;
+	return temp;
+}
+
+/*****************************************************************************/
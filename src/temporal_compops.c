@@ -3,6 +3,10 @@
  * temporal_compops.c
  *	  Temporal comparison operators (=, <>, <, >, <=, >=).
  *
+ * The ever/always comparisons of two temporal values traverse the
+ * synchronized segments of the values and return as soon as a witness or a
+ * counterexample is found without building the resulting temporal Boolean.
+ *
  * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
  * 		Universite Libre de Bruxelles
  * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
@@ -13,7 +17,9 @@
 #include "temporal_compops.h"
 
 #include <utils/lsyscache.h>
+#include <utils/timestamp.h>
 
+#include "period.h"
 #include "temporaltypes.h"
 #include "temporal_util.h"
 #include "lifting.h"
@@ -369,4 +375,291 @@ tge_temporal_temporal(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Ever/always comparison of two temporal values
+ *****************************************************************************/
+
+/*
+ * Returns true if the comparison of the values of two synchronized segments
+ * takes the value witness at some instant of the segments. The values in 
+ * the interior of the segments are those at the start of the segments for 
+ * stepwise interpolation. Otherwise, since the difference of the values 
+ * is linear, its sign in the interior of the segments is determined by 
+ * the sign of the differences at the bounds.
+ */
+static bool
+tcomp_segment_find(TemporalInst *start1, TemporalInst *end1, bool linear1,
+	TemporalInst *start2, TemporalInst *end2, bool linear2,
+	bool lower_inc, bool upper_inc, Datum (*func)(Datum, Datum, Oid, Oid), 
+	bool witness)
+{
+	Oid valuetypid1 = start1->valuetypid, valuetypid2 = start2->valuetypid;
+	Datum sv1 = temporalinst_value(start1), sv2 = temporalinst_value(start2);
+	if (lower_inc && 
+		DatumGetBool(func(sv1, sv2, valuetypid1, valuetypid2)) == witness)
+		return true;
+	Datum ev1 = temporalinst_value(end1), ev2 = temporalinst_value(end2);
+	if (upper_inc &&
+		DatumGetBool(func(ev1, ev2, valuetypid1, valuetypid2)) == witness)
+		return true;
+	if (! linear1 && ! linear2)
+		return DatumGetBool(func(sv1, sv2, valuetypid1, valuetypid2)) == 
+			witness;
+
+	double start = datum_double(sv1, valuetypid1) - 
+		datum_double(sv2, valuetypid2);
+	double end = datum_double(linear1 ? ev1 : sv1, valuetypid1) - 
+		datum_double(linear2 ? ev2 : sv2, valuetypid2);
+	double signs[3];
+	int count = 0;
+	if ((start < 0 && end > 0) || (start > 0 && end < 0))
+	{
+		/* The segments cross in the interior */
+		signs[count++] = -1.0;
+		signs[count++] = 0.0;
+		signs[count++] = 1.0;
+	}
+	else if (start == 0 && end == 0)
+		signs[count++] = 0.0;
+	else
+		signs[count++] = (start < 0 || end < 0) ? -1.0 : 1.0;
+	for (int i = 0; i < count; i++)
+	{
+		if (DatumGetBool(func(Float8GetDatum(signs[i]), Float8GetDatum(0.0),
+			FLOAT8OID, FLOAT8OID)) == witness)
+			return true;
+	}
+	return false;
+}
+
+/*
+ * Returns true if the comparison of two sequences takes the value witness 
+ * at some instant of the intersection of their periods
+ */
+static bool
+tcomp_temporalseq_temporalseq_find(TemporalSeq *seq1, TemporalSeq *seq2,
+	Datum (*func)(Datum, Datum, Oid, Oid), bool witness, bool *found)
+{
+	SyncSeqCursor cursor;
+	if (!temporalseq_sync_cursor_init(&cursor, seq1, seq2))
+		return false;
+
+	*found = false;
+	/* If the two sequences intersect at an instant */
+	if (timestamp_cmp_internal(cursor.inter.lower, cursor.inter.upper) == 0)
+		*found = DatumGetBool(func(temporalinst_value(cursor.end1), 
+			temporalinst_value(cursor.end2), seq1->valuetypid, 
+			seq2->valuetypid)) == witness;
+	else
+	{
+		bool linear1 = MOBDB_FLAGS_GET_LINEAR(seq1->flags);
+		bool linear2 = MOBDB_FLAGS_GET_LINEAR(seq2->flags);
+		while (temporalseq_sync_cursor_next(&cursor))
+		{
+			if (tcomp_segment_find(cursor.start1, cursor.end1, linear1, 
+				cursor.start2, cursor.end2, linear2, cursor.lower_inc, 
+				cursor.upper_inc, func, witness))
+			{
+				*found = true;
+				break;
+			}
+		}
+	}
+	temporalseq_sync_cursor_end(&cursor);
+	return true;
+}
+
+/*
+ * Returns true if the comparison of two temporal values takes the value 
+ * witness at some instant of the intersection of their time spans. 
+ * The function returns false if the values do not intersect in time, 
+ * otherwise the answer is given in found.
+ */
+static bool
+tcomp_temporal_temporal_find(Temporal *temp1, Temporal *temp2,
+	Datum (*func)(Datum, Datum, Oid, Oid), bool witness, bool *found)
+{
+	*found = false;
+	if ((temp1->duration == TEMPORALSEQ || temp1->duration == TEMPORALS) &&
+		(temp2->duration == TEMPORALSEQ || temp2->duration == TEMPORALS))
+	{
+		/* The pairs of sequences are traversed in the order of the upper
+		 * bounds of their periods */
+		TemporalSeq **sequences1 = temp1->duration == TEMPORALSEQ ?
+			(TemporalSeq **) &temp1 : temporals_sequences((TemporalS *) temp1);
+		TemporalSeq **sequences2 = temp2->duration == TEMPORALSEQ ?
+			(TemporalSeq **) &temp2 : temporals_sequences((TemporalS *) temp2);
+		int count1 = temp1->duration == TEMPORALSEQ ? 1 : 
+			((TemporalS *) temp1)->count;
+		int count2 = temp2->duration == TEMPORALSEQ ? 1 : 
+			((TemporalS *) temp2)->count;
+		bool result = false;
+		int i = 0, j = 0;
+		while (i < count1 && j < count2 && ! *found)
+		{
+			TemporalSeq *seq1 = sequences1[i];
+			TemporalSeq *seq2 = sequences2[j];
+			if (tcomp_temporalseq_temporalseq_find(seq1, seq2, func, witness,
+				found))
+				result = true;
+			/* Advance the sequence that ends first, since the other one may
+			 * overlap the next sequences of the first operand */
+			int cmp = period_cmp_bounds(seq1->period.upper, seq2->period.upper,
+				false, false, seq1->period.upper_inc, seq2->period.upper_inc);
+			if (cmp == 0)
+			{
+				i++; j++;
+			}
+			else if (cmp < 0)
+				i++;
+			else
+				j++;
+		}
+		if (temp1->duration == TEMPORALS)
+			pfree(sequences1);
+		if (temp2->duration == TEMPORALS)
+			pfree(sequences2);
+		return result;
+	}
+
+	/* Otherwise the synchronized values are instants or instant sets */
+	Temporal *sync1, *sync2;
+	if (!synchronize_temporal_temporal(temp1, temp2, &sync1, &sync2, false))
+		return false;
+	int count = (sync1->duration == TEMPORALINST) ? 1 : 
+		((TemporalI *) sync1)->count;
+	for (int i = 0; i < count; i++)
+	{
+		TemporalInst *inst1 = (sync1->duration == TEMPORALINST) ? 
+			(TemporalInst *) sync1 : temporali_inst_n((TemporalI *) sync1, i);
+		TemporalInst *inst2 = (sync2->duration == TEMPORALINST) ? 
+			(TemporalInst *) sync2 : temporali_inst_n((TemporalI *) sync2, i);
+		if (DatumGetBool(func(temporalinst_value(inst1), 
+			temporalinst_value(inst2), inst1->valuetypid, 
+			inst2->valuetypid)) == witness)
+		{
+			*found = true;
+			break;
+		}
+	}
+	pfree(sync1); pfree(sync2);
+	return true;
+}
+
+/*
+ * Generic function for the ever/always comparisons of two temporal values.
+ * An always comparison holds if the comparison is never false.
+ */
+static Datum
+tcomp_ever_always_temporal_temporal(FunctionCallInfo fcinfo, 
+	Datum (*func)(Datum, Datum, Oid, Oid), bool ever)
+{
+	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
+	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
+	bool found;
+	bool intersect = tcomp_temporal_temporal_find(temp1, temp2, func, ever,
+		&found);
+	PG_FREE_IF_COPY(temp1, 0);
+	PG_FREE_IF_COPY(temp2, 1);
+	if (! intersect)
+		PG_RETURN_NULL();
+	PG_RETURN_BOOL(ever ? found : ! found);
+}
+
+PG_FUNCTION_INFO_V1(ever_eq_temporal_temporal);
+
+PGDLLEXPORT Datum
+ever_eq_temporal_temporal(PG_FUNCTION_ARGS)
+{
+	return tcomp_ever_always_temporal_temporal(fcinfo, &datum2_eq2, true);
+}
+
+PG_FUNCTION_INFO_V1(always_eq_temporal_temporal);
+
+PGDLLEXPORT Datum
+always_eq_temporal_temporal(PG_FUNCTION_ARGS)
+{
+	return tcomp_ever_always_temporal_temporal(fcinfo, &datum2_eq2, false);
+}
+
+PG_FUNCTION_INFO_V1(ever_ne_temporal_temporal);
+
+PGDLLEXPORT Datum
+ever_ne_temporal_temporal(PG_FUNCTION_ARGS)
+{
+	return tcomp_ever_always_temporal_temporal(fcinfo, &datum2_ne2, true);
+}
+
+PG_FUNCTION_INFO_V1(always_ne_temporal_temporal);
+
+PGDLLEXPORT Datum
+always_ne_temporal_temporal(PG_FUNCTION_ARGS)
+{
+	return tcomp_ever_always_temporal_temporal(fcinfo, &datum2_ne2, false);
+}
+
+PG_FUNCTION_INFO_V1(ever_lt_temporal_temporal);
+
+PGDLLEXPORT Datum
+ever_lt_temporal_temporal(PG_FUNCTION_ARGS)
+{
+	return tcomp_ever_always_temporal_temporal(fcinfo, &datum2_lt2, true);
+}
+
+PG_FUNCTION_INFO_V1(always_lt_temporal_temporal);
+
+PGDLLEXPORT Datum
+always_lt_temporal_temporal(PG_FUNCTION_ARGS)
+{
+	return tcomp_ever_always_temporal_temporal(fcinfo, &datum2_lt2, false);
+}
+
+PG_FUNCTION_INFO_V1(ever_le_temporal_temporal);
+
+PGDLLEXPORT Datum
+ever_le_temporal_temporal(PG_FUNCTION_ARGS)
+{
+	return tcomp_ever_always_temporal_temporal(fcinfo, &datum2_le2, true);
+}
+
+PG_FUNCTION_INFO_V1(always_le_temporal_temporal);
+
+PGDLLEXPORT Datum
+always_le_temporal_temporal(PG_FUNCTION_ARGS)
+{
+	return tcomp_ever_always_temporal_temporal(fcinfo, &datum2_le2, false);
+}
+
+PG_FUNCTION_INFO_V1(ever_gt_temporal_temporal);
+
+PGDLLEXPORT Datum
+ever_gt_temporal_temporal(PG_FUNCTION_ARGS)
+{
+	return tcomp_ever_always_temporal_temporal(fcinfo, &datum2_gt2, true);
+}
+
+PG_FUNCTION_INFO_V1(always_gt_temporal_temporal);
+
+PGDLLEXPORT Datum
+always_gt_temporal_temporal(PG_FUNCTION_ARGS)
+{
+	return tcomp_ever_always_temporal_temporal(fcinfo, &datum2_gt2, false);
+}
+
+PG_FUNCTION_INFO_V1(ever_ge_temporal_temporal);
+
+PGDLLEXPORT Datum
+ever_ge_temporal_temporal(PG_FUNCTION_ARGS)
+{
+	return tcomp_ever_always_temporal_temporal(fcinfo, &datum2_ge2, true);
+}
+
+PG_FUNCTION_INFO_V1(always_ge_temporal_temporal);
+
+PGDLLEXPORT Datum
+always_ge_temporal_temporal(PG_FUNCTION_ARGS)
+{
+	return tcomp_ever_always_temporal_temporal(fcinfo, &datum2_ge2, false);
+}
+
 /*****************************************************************************/
@@ -0,0 +1,772 @@
+/*****************************************************************************
+ *
+ * temporal_compress.c
+ *	  Compressed representation of temporal sequences.
+ *
+ * A compressed sequence keeps the header of a TemporalSeq (duration, flags,
+ * base type, number of instants, and period) followed by a bit stream in
+ * which the timestamps are encoded with delta-of-delta and the values are
+ * encoded with the XOR scheme of the Gorilla time series database
+ * (Pelkonen et al., VLDB 2015), except integers, which are encoded as
+ * zig-zag varint deltas. Compression is only available for sequences
+ * whose base type is boolean, integer, float, or point, that is, for values
+ * that can be represented with one 64-bit word per coordinate.
+ *
+ * Sequences stored in columns whose typmod fixes the duration to Sequence
+ * are instead packed: their instants are kept as fixed-size records with the
+ * timestamp followed by the words of the value, without the header of each
+ * instant and of its base value, which are filled back in when the sequence
+ * is unpacked. Packing is cheaper than compression both when the value is
+ * written and when it is read.
+ *
+ * Compressed sequences are flagged with MOBDB_FLAGS_GET_COMPRESSED and are
+ * transparently decompressed when they are fetched as function arguments
+ * (see the PG_GETARG_TEMPORAL and DatumGetTemporal macros), in the same way
+ * as PostgreSQL transparently decompresses TOASTed values.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_compress.h"
+
+#include <assert.h>
+#include <utils/timestamp.h>
+
+#include "temporaltypes.h"
+#include "oidcache.h"
+#include "temporal_util.h"
+
+#ifdef WITH_POSTGIS
+#include "tpoint.h"
+#include "tpoint_spatialfuncs.h"
+#endif
+
+/*****************************************************************************
+ * Compressed sequences
+ *****************************************************************************/
+
+/*
+ * The memory structure of a compressed TemporalSeq is as follows
+ *
+ *	-------------------------------------------------
+ *	( TemporalSeqComp )_X | ( bbox )_X | bit stream
+ *	-------------------------------------------------
+ *
+ * The first fields of the struct are identical to those of TemporalSeq so
+ * that the number of instants and the period of a compressed sequence can be
+ * read without decompressing it. The version field gives the encoding of
+ * the bit stream. In the first version, which is the one of the values
+ * compressed before the field was added and whose padding is zeroed, all the
+ * values are encoded with the XOR scheme. Since the second version the
+ * integer values are encoded as deltas. Since the third version the bounding
+ * box of the sequence is kept after the struct, so that it can also be read
+ * without decompressing the sequence. The records of a packed sequence
+ * follow the bounding box in the same way.
+ */
+
+#define TEMPORALSEQCOMP_XOR			0	/* XOR encoding of all the values */
+#define TEMPORALSEQCOMP_INTDELTA	1	/* delta encoding of integer values */
+#define TEMPORALSEQCOMP_BBOX		2	/* bounding box after the struct */
+#define TEMPORALSEQCOMP_VERSION		TEMPORALSEQCOMP_BBOX
+
+typedef struct
+{
+	int32		vl_len_;		/* varlena header (do not touch directly!) */
+	int16		duration;		/* duration */
+	int16		flags;			/* flags */
+	Oid 		valuetypid;		/* base type's OID (4 bytes) */
+	int32 		count;			/* number of TemporalInst elements */
+	Period 		period;			/* time span (24 bytes) */
+	int32		srid;			/* SRID for temporal points, 0 otherwise */
+	uint8		version;		/* version of the format */
+	/* bit stream follows */
+} TemporalSeqComp;
+
+/* Pointer to the bounding box of a compressed sequence */
+
+static void *
+temporalseqcomp_bbox_ptr(TemporalSeqComp *comp)
+{
+	assert(comp->version >= TEMPORALSEQCOMP_BBOX);
+	return (uint8 *)comp + double_pad(sizeof(TemporalSeqComp));
+}
+
+/* Offset of the bit stream or of the records of a compressed sequence */
+
+static size_t
+temporalseqcomp_data_offset(TemporalSeqComp *comp)
+{
+	size_t result = double_pad(sizeof(TemporalSeqComp));
+	if (comp->version >= TEMPORALSEQCOMP_BBOX)
+		result += double_pad(temporal_bbox_size(comp->valuetypid));
+	return result;
+}
+
+/* Pointer to the bit stream or to the records of a compressed sequence */
+
+static uint8 *
+temporalseqcomp_data_ptr(TemporalSeqComp *comp)
+{
+	return (uint8 *)comp + temporalseqcomp_data_offset(comp);
+}
+
+/*****************************************************************************
+ * Bit streams
+ *****************************************************************************/
+
+typedef struct
+{
+	uint8		*data;			/* bytes of the stream */
+	size_t		maxbytes;		/* number of allocated bytes */
+	uint64		nbits;			/* number of bits written */
+} BitWriter;
+
+typedef struct
+{
+	const uint8	*data;			/* bytes of the stream */
+	uint64		pos;			/* position of the next bit to read */
+} BitReader;
+
+static void
+bitwriter_init(BitWriter *bw, size_t maxbytes)
+{
+	bw->data = palloc0(maxbytes);
+	bw->maxbytes = maxbytes;
+	bw->nbits = 0;
+}
+
+/* Write the nbits least significant bits of value, most significant first */
+
+static void
+bitwriter_put(BitWriter *bw, uint64 value, int nbits)
+{
+	size_t needed = (size_t) ((bw->nbits + nbits + 7) / 8);
+	if (needed > bw->maxbytes)
+	{
+		size_t newsize = Max(needed, bw->maxbytes * 2);
+		bw->data = repalloc(bw->data, newsize);
+		memset(bw->data + bw->maxbytes, 0, newsize - bw->maxbytes);
+		bw->maxbytes = newsize;
+	}
+	while (nbits > 0)
+	{
+		int freebits = 8 - (int) (bw->nbits % 8);
+		int take = Min(freebits, nbits);
+		uint8 chunk = (uint8) ((value >> (nbits - take)) & ((1 << take) - 1));
+		bw->data[bw->nbits / 8] |= (uint8) (chunk << (freebits - take));
+		bw->nbits += take;
+		nbits -= take;
+	}
+}
+
+/* Read nbits from the stream */
+
+static uint64
+bitreader_get(BitReader *br, int nbits)
+{
+	uint64 result = 0;
+	while (nbits > 0)
+	{
+		int avail = 8 - (int) (br->pos % 8);
+		int take = Min(avail, nbits);
+		uint8 byte = br->data[br->pos / 8];
+		uint64 chunk = (uint64) ((byte >> (avail - take)) & ((1 << take) - 1));
+		result = (result << take) | chunk;
+		br->pos += take;
+		nbits -= take;
+	}
+	return result;
+}
+
+static int64
+sign_extend(uint64 value, int nbits)
+{
+	if (nbits < 64 && (value & (UINT64CONST(1) << (nbits - 1))))
+		value |= ~((UINT64CONST(1) << nbits) - 1);
+	return (int64) value;
+}
+
+/*****************************************************************************
+ * Delta-of-delta encoding of timestamps
+ *
+ * Timestamps are in microseconds. A delta of delta equal to 0, which is the
+ * common case for regularly sampled data, is encoded in a single bit. Other
+ * values are encoded in 12, 20, 32, or 64 bits preceded by a prefix of 2, 3,
+ * 4, and 4 bits respectively.
+ *****************************************************************************/
+
+static bool
+fits_bits(int64 value, int nbits)
+{
+	return value >= -(INT64CONST(1) << (nbits - 1)) &&
+		value < (INT64CONST(1) << (nbits - 1));
+}
+
+static void
+bitwriter_put_dod(BitWriter *bw, int64 dod)
+{
+	if (dod == 0)
+		bitwriter_put(bw, 0, 1);
+	else if (fits_bits(dod, 12))
+	{
+		bitwriter_put(bw, 0x2, 2);
+		bitwriter_put(bw, (uint64) dod, 12);
+	}
+	else if (fits_bits(dod, 20))
+	{
+		bitwriter_put(bw, 0x6, 3);
+		bitwriter_put(bw, (uint64) dod, 20);
+	}
+	else if (fits_bits(dod, 32))
+	{
+		bitwriter_put(bw, 0xE, 4);
+		bitwriter_put(bw, (uint64) dod, 32);
+	}
+	else
+	{
+		bitwriter_put(bw, 0xF, 4);
+		bitwriter_put(bw, (uint64) dod, 64);
+	}
+}
+
+static int64
+bitreader_get_dod(BitReader *br)
+{
+	if (bitreader_get(br, 1) == 0)
+		return 0;
+	if (bitreader_get(br, 1) == 0)
+		return sign_extend(bitreader_get(br, 12), 12);
+	if (bitreader_get(br, 1) == 0)
+		return sign_extend(bitreader_get(br, 20), 20);
+	if (bitreader_get(br, 1) == 0)
+		return sign_extend(bitreader_get(br, 32), 32);
+	return (int64) bitreader_get(br, 64);
+}
+
+/*****************************************************************************
+ * XOR encoding of values
+ *
+ * Each value is XORed with the previous one. Equal values are encoded in a
+ * single bit. Otherwise, the meaningful bits of the XOR are written, either
+ * reusing the window of leading and trailing zeros of the previous value or
+ * preceded by a new window encoded in 12 bits.
+ *****************************************************************************/
+
+typedef struct
+{
+	uint64		prev;			/* previous value */
+	int			lead;			/* leading zeros of the window, -1 if none */
+	int			trail;			/* trailing zeros of the window */
+} XorState;
+
+static void
+xorstate_init(XorState *state, uint64 first)
+{
+	state->prev = first;
+	state->lead = -1;
+	state->trail = 0;
+}
+
+static void
+bitwriter_put_xor(BitWriter *bw, XorState *state, uint64 value)
+{
+	uint64 x = value ^ state->prev;
+	state->prev = value;
+	if (x == 0)
+	{
+		bitwriter_put(bw, 0, 1);
+		return;
+	}
+	bitwriter_put(bw, 1, 1);
+	int lead = __builtin_clzll(x);
+	int trail = __builtin_ctzll(x);
+	if (state->lead >= 0 && lead >= state->lead && trail >= state->trail)
+	{
+		bitwriter_put(bw, 0, 1);
+		bitwriter_put(bw, x >> state->trail, 64 - state->lead - state->trail);
+	}
+	else
+	{
+		int len = 64 - lead - trail;
+		bitwriter_put(bw, 1, 1);
+		bitwriter_put(bw, (uint64) lead, 6);
+		bitwriter_put(bw, (uint64) (len - 1), 6);
+		bitwriter_put(bw, x >> trail, len);
+		state->lead = lead;
+		state->trail = trail;
+	}
+}
+
+static uint64
+bitreader_get_xor(BitReader *br, XorState *state)
+{
+	if (bitreader_get(br, 1) == 0)
+		return state->prev;
+	if (bitreader_get(br, 1) == 1)
+	{
+		int lead = (int) bitreader_get(br, 6);
+		int len = (int) bitreader_get(br, 6) + 1;
+		state->lead = lead;
+		state->trail = 64 - lead - len;
+	}
+	int len = 64 - state->lead - state->trail;
+	uint64 x = bitreader_get(br, len) << state->trail;
+	state->prev ^= x;
+	return state->prev;
+}
+
+/*****************************************************************************
+ * Delta encoding of integers
+ *
+ * Integer sequences such as counters change by small amounts, so that the 
+ * difference with the previous value is encoded instead. An unchanged value 
+ * is encoded in a single bit. Otherwise, the difference is mapped with the 
+ * zig-zag encoding to an unsigned value whose magnitude is proportional 
+ * to that of the difference, which is written as a varint, that is, in 
+ * groups of 7 bits preceded by a continuation bit.
+ *****************************************************************************/
+
+static void
+bitwriter_put_intdelta(BitWriter *bw, int64 *prev, int64 value)
+{
+	int64 delta = value - *prev;
+	*prev = value;
+	if (delta == 0)
+	{
+		bitwriter_put(bw, 0, 1);
+		return;
+	}
+	bitwriter_put(bw, 1, 1);
+	uint64 zigzag = ((uint64) delta << 1) ^ (uint64) (delta >> 63);
+	do
+	{
+		uint64 chunk = zigzag & 0x7F;
+		zigzag >>= 7;
+		bitwriter_put(bw, (zigzag ? 0x80 : 0) | chunk, 8);
+	} while (zigzag);
+}
+
+static int64
+bitreader_get_intdelta(BitReader *br, int64 *prev)
+{
+	if (bitreader_get(br, 1) == 0)
+		return *prev;
+	uint64 zigzag = 0, byte;
+	int shift = 0;
+	do
+	{
+		byte = bitreader_get(br, 8);
+		zigzag |= (byte & 0x7F) << shift;
+		shift += 7;
+	} while (byte & 0x80);
+	*prev += (int64) ((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+	return *prev;
+}
+
+/*****************************************************************************
+ * Conversion between base values and 64-bit words
+ *****************************************************************************/
+
+static uint64
+double_to_word(double d)
+{
+	uint64 result;
+	memcpy(&result, &d, sizeof(double));
+	return result;
+}
+
+static double
+word_to_double(uint64 w)
+{
+	double result;
+	memcpy(&result, &w, sizeof(double));
+	return result;
+}
+
+/* Number of 64-bit words needed for encoding a value of the sequence */
+
+static int
+temporalseq_words(TemporalSeq *seq)
+{
+#ifdef WITH_POSTGIS
+	if (seq->valuetypid == type_oid(T_GEOMETRY) ||
+		seq->valuetypid == type_oid(T_GEOGRAPHY))
+		return MOBDB_FLAGS_GET_Z(seq->flags) ? 3 : 2;
+#endif
+	return 1;
+}
+
+static void
+datum_to_words(uint64 *words, Datum value, Oid valuetypid)
+{
+	if (valuetypid == BOOLOID)
+		words[0] = DatumGetBool(value) ? 1 : 0;
+	else if (valuetypid == INT4OID)
+		words[0] = (uint64) (int64) DatumGetInt32(value);
+	else if (valuetypid == FLOAT8OID)
+		words[0] = double_to_word(DatumGetFloat8(value));
+#ifdef WITH_POSTGIS
+	else if (valuetypid == type_oid(T_GEOMETRY) ||
+		valuetypid == type_oid(T_GEOGRAPHY))
+	{
+		GSERIALIZED *gs = (GSERIALIZED *) DatumGetPointer(value);
+		if (FLAGS_GET_Z(gs->flags))
+		{
+			POINT3DZ point = gs_get_point3dz(gs);
+			words[0] = double_to_word(point.x);
+			words[1] = double_to_word(point.y);
+			words[2] = double_to_word(point.z);
+		}
+		else
+		{
+			POINT2D point = gs_get_point2d(gs);
+			words[0] = double_to_word(point.x);
+			words[1] = double_to_word(point.y);
+		}
+	}
+#endif
+}
+
+static Datum
+words_to_datum(uint64 *words, TemporalSeqComp *comp)
+{
+	Oid valuetypid = comp->valuetypid;
+	if (valuetypid == BOOLOID)
+		return BoolGetDatum(words[0] != 0);
+	if (valuetypid == INT4OID)
+		return Int32GetDatum((int32) (int64) words[0]);
+	if (valuetypid == FLOAT8OID)
+		return Float8GetDatum(word_to_double(words[0]));
+#ifdef WITH_POSTGIS
+	LWPOINT *lwpoint;
+	if (MOBDB_FLAGS_GET_Z(comp->flags))
+		lwpoint = lwpoint_make3dz(comp->srid, word_to_double(words[0]),
+			word_to_double(words[1]), word_to_double(words[2]));
+	else
+		lwpoint = lwpoint_make2d(comp->srid, word_to_double(words[0]),
+			word_to_double(words[1]));
+	if (valuetypid == type_oid(T_GEOGRAPHY))
+		FLAGS_SET_GEODETIC(lwpoint->flags, 1);
+	Datum result = PointerGetDatum(geometry_serialize((LWGEOM *) lwpoint));
+	lwpoint_free(lwpoint);
+	return result;
+#else
+	return 0; /* keep the compiler quiet */
+#endif
+}
+
+/*****************************************************************************
+ * Compression and decompression
+ *****************************************************************************/
+
+/* Can the sequence be compressed? */
+
+bool
+temporalseq_compressible(TemporalSeq *seq)
+{
+	Oid valuetypid = seq->valuetypid;
+	if (valuetypid == BOOLOID || valuetypid == INT4OID ||
+		valuetypid == FLOAT8OID)
+		return true;
+#ifdef WITH_POSTGIS
+	if (valuetypid == type_oid(T_GEOMETRY) ||
+		valuetypid == type_oid(T_GEOGRAPHY))
+		return true;
+#endif
+	return false;
+}
+
+/*
+ * Make a compressed sequence with the header and the bounding box of the
+ * sequence and room for datasize bytes of data
+ */
+static TemporalSeqComp *
+temporalseqcomp_make(TemporalSeq *seq, size_t datasize)
+{
+	size_t pdata = double_pad(sizeof(TemporalSeqComp)) +
+		double_pad(temporal_bbox_size(seq->valuetypid));
+	TemporalSeqComp *result = palloc0(pdata + datasize);
+	SET_VARSIZE(result, pdata + datasize);
+	result->duration = TEMPORALSEQ;
+	result->flags = seq->flags;
+	MOBDB_FLAGS_SET_SUMMARY(result->flags, false);
+	MOBDB_FLAGS_SET_COMPRESSED(result->flags, true);
+	result->valuetypid = seq->valuetypid;
+	result->count = seq->count;
+	result->period = seq->period;
+	result->version = TEMPORALSEQCOMP_VERSION;
+#ifdef WITH_POSTGIS
+	if (temporalseq_words(seq) > 1)
+		result->srid = tpoint_srid_internal((Temporal *) seq);
+#endif
+	temporalseq_bbox(temporalseqcomp_bbox_ptr(result), seq);
+	return result;
+}
+
+/* Compress a temporal sequence */
+
+TemporalSeq *
+temporalseq_compress(TemporalSeq *seq)
+{
+	assert(temporalseq_compressible(seq));
+	Oid valuetypid = seq->valuetypid;
+	int nwords = temporalseq_words(seq);
+	uint64 words[3];
+	XorState states[3];
+	BitWriter bw;
+	/* Initial estimate: some 2 bytes per instant and coordinate */
+	bitwriter_init(&bw, (size_t) (seq->count * (nwords + 1) * 2 + 32));
+
+	TemporalInst *inst = temporalseq_inst_n(seq, 0);
+	TimestampTz prevt = inst->t;
+	int64 prevdelta = 0;
+	bitwriter_put(&bw, (uint64) prevt, 64);
+	datum_to_words(words, temporalinst_value(inst), valuetypid);
+	for (int j = 0; j < nwords; j++)
+	{
+		bitwriter_put(&bw, words[j], 64);
+		xorstate_init(&states[j], words[j]);
+	}
+	int64 prevint = (int64) words[0];
+	for (int i = 1; i < seq->count; i++)
+	{
+		inst = temporalseq_inst_n(seq, i);
+		int64 delta = inst->t - prevt;
+		bitwriter_put_dod(&bw, delta - prevdelta);
+		prevt = inst->t;
+		prevdelta = delta;
+		datum_to_words(words, temporalinst_value(inst), valuetypid);
+		if (valuetypid == INT4OID)
+			bitwriter_put_intdelta(&bw, &prevint, (int64) words[0]);
+		else
+			for (int j = 0; j < nwords; j++)
+				bitwriter_put_xor(&bw, &states[j], words[j]);
+	}
+
+	size_t nbytes = (size_t) ((bw.nbits + 7) / 8);
+	TemporalSeqComp *result = temporalseqcomp_make(seq, nbytes);
+	memcpy(temporalseqcomp_data_ptr(result), bw.data, nbytes);
+	pfree(bw.data);
+	return (TemporalSeq *) result;
+}
+
+/* Pack a temporal sequence into fixed-size records */
+
+TemporalSeq *
+temporalseq_pack(TemporalSeq *seq)
+{
+	assert(temporalseq_compressible(seq));
+	int nwords = temporalseq_words(seq);
+	size_t stride = sizeof(uint64) * (nwords + 1);
+	TemporalSeqComp *result = temporalseqcomp_make(seq, stride * seq->count);
+	MOBDB_FLAGS_SET_PACKED(result->flags, true);
+	uint64 *records = (uint64 *) temporalseqcomp_data_ptr(result);
+	for (int i = 0; i < seq->count; i++)
+	{
+		TemporalInst *inst = temporalseq_inst_n(seq, i);
+		records[0] = (uint64) inst->t;
+		datum_to_words(&records[1], temporalinst_value(inst), seq->valuetypid);
+		records += nwords + 1;
+	}
+	return (TemporalSeq *) result;
+}
+
+/* Unpack a temporal sequence kept as fixed-size records */
+
+static TemporalSeq *
+temporalseq_unpack(TemporalSeqComp *comp)
+{
+	int nwords = temporalseq_words((TemporalSeq *) comp);
+	uint64 *records = (uint64 *) temporalseqcomp_data_ptr(comp);
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * comp->count);
+	for (int i = 0; i < comp->count; i++)
+	{
+		TimestampTz t = (TimestampTz) records[0];
+#ifdef WITH_POSTGIS
+		if (nwords > 1)
+		{
+			/* Write the coordinates directly in the instant */
+			bool hasz = MOBDB_FLAGS_GET_Z(comp->flags);
+			instants[i] = tpointinst_make(word_to_double(records[1]),
+				word_to_double(records[2]),
+				hasz ? word_to_double(records[3]) : 0, hasz,
+				MOBDB_FLAGS_GET_GEODETIC(comp->flags), comp->srid, t);
+		}
+		else
+#endif
+			instants[i] = temporalinst_make(words_to_datum(&records[1], comp),
+				t, comp->valuetypid);
+		records += nwords + 1;
+	}
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants,
+		comp->count, comp->period.lower_inc, comp->period.upper_inc,
+		MOBDB_FLAGS_GET_LINEAR(comp->flags), false);
+
+	for (int i = 0; i < comp->count; i++)
+		pfree(instants[i]);
+	pfree(instants);
+	return result;
+}
+
+/*
+ * Pack a temporal value of a column whose typmod fixes the duration to
+ * Sequence. Other values are returned unchanged.
+ */
+Temporal *
+temporal_typmod_pack(Temporal *temp, int32 typmod)
+{
+	if (typmod < 0 || TYPMOD_GET_DURATION(typmod) != TEMPORALSEQ ||
+		temp->duration != TEMPORALSEQ ||
+		MOBDB_FLAGS_GET_COMPRESSED(temp->flags) ||
+		! temporalseq_compressible((TemporalSeq *) temp))
+		return temp;
+	return (Temporal *) temporalseq_pack((TemporalSeq *) temp);
+}
+
+/* Size of the bit stream of a compressed sequence */
+
+size_t
+temporalseq_compressed_stream_size(TemporalSeq *seq)
+{
+	assert(MOBDB_FLAGS_GET_COMPRESSED(seq->flags));
+	return VARSIZE(seq) - temporalseqcomp_data_offset((TemporalSeqComp *) seq);
+}
+
+/* Size of the bounding box kept in a compressed sequence */
+
+size_t
+temporalseq_compressed_bbox_size(TemporalSeq *seq)
+{
+	assert(MOBDB_FLAGS_GET_COMPRESSED(seq->flags));
+	return temporalseqcomp_data_offset((TemporalSeqComp *) seq) -
+		double_pad(sizeof(TemporalSeqComp));
+}
+
+/*
+ * Set the first argument to the bounding box of a compressed sequence. The
+ * box is read from the header, the sequences compressed before the box was
+ * kept are decompressed unless their bounding box is their period.
+ */
+void
+temporalseq_compressed_bbox(void *box, TemporalSeq *seq)
+{
+	assert(MOBDB_FLAGS_GET_COMPRESSED(seq->flags));
+	TemporalSeqComp *comp = (TemporalSeqComp *) seq;
+	size_t bboxsize = temporal_bbox_size(comp->valuetypid);
+	if (comp->version >= TEMPORALSEQCOMP_BBOX)
+		memcpy(box, temporalseqcomp_bbox_ptr(comp), bboxsize);
+	else if (bboxsize == sizeof(Period))
+		memcpy(box, &comp->period, sizeof(Period));
+	else
+	{
+		TemporalSeq *seq1 = temporalseq_decompress(seq);
+		temporalseq_bbox(box, seq1);
+		pfree(seq1);
+	}
+}
+
+/* Decompress a temporal sequence */
+
+TemporalSeq *
+temporalseq_decompress(TemporalSeq *seq)
+{
+	assert(MOBDB_FLAGS_GET_COMPRESSED(seq->flags));
+	TemporalSeqComp *comp = (TemporalSeqComp *) seq;
+	if (MOBDB_FLAGS_GET_PACKED(comp->flags))
+		return temporalseq_unpack(comp);
+	int nwords = temporalseq_words(seq);
+	uint64 words[3];
+	XorState states[3];
+	BitReader br;
+	br.data = temporalseqcomp_data_ptr(comp);
+	br.pos = 0;
+
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * comp->count);
+	TimestampTz t = (TimestampTz) bitreader_get(&br, 64);
+	int64 delta = 0;
+	for (int j = 0; j < nwords; j++)
+	{
+		words[j] = bitreader_get(&br, 64);
+		xorstate_init(&states[j], words[j]);
+	}
+	int64 prevint = (int64) words[0];
+	bool intdelta = comp->valuetypid == INT4OID &&
+		comp->version >= TEMPORALSEQCOMP_INTDELTA;
+	for (int i = 0; i < comp->count; i++)
+	{
+		if (i > 0)
+		{
+			delta += bitreader_get_dod(&br);
+			t += delta;
+			if (intdelta)
+				words[0] = (uint64) bitreader_get_intdelta(&br, &prevint);
+			else
+				for (int j = 0; j < nwords; j++)
+					words[j] = bitreader_get_xor(&br, &states[j]);
+		}
+		Datum value = words_to_datum(words, comp);
+		instants[i] = temporalinst_make(value, t, comp->valuetypid);
+		if (nwords > 1)
+			pfree(DatumGetPointer(value));
+	}
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants,
+		comp->count, comp->period.lower_inc, comp->period.upper_inc,
+		MOBDB_FLAGS_GET_LINEAR(comp->flags), false);
+
+	for (int i = 0; i < comp->count; i++)
+		pfree(instants[i]);
+	pfree(instants);
+	return result;
+}
+
+/*****************************************************************************
+ * SQL functions
+ *****************************************************************************/
+
+PG_FUNCTION_INFO_V1(temporal_compress);
+/**
+ * @brief Returns the compressed representation of a temporal sequence.
+ * Values of other durations or base types are returned unchanged.
+ */
+PGDLLEXPORT Datum
+temporal_compress(PG_FUNCTION_ARGS)
+{
+	/* Do not use PG_GETARG_TEMPORAL, it decompresses the argument */
+	Temporal *temp = (Temporal *) PG_GETARG_VARLENA_P(0);
+	Temporal *result;
+	if (temp->duration != TEMPORALSEQ ||
+		(MOBDB_FLAGS_GET_COMPRESSED(temp->flags) &&
+			! MOBDB_FLAGS_GET_PACKED(temp->flags)) ||
+		! temporalseq_compressible((TemporalSeq *) temp))
+		result = temporal_copy(temp);
+	else if (MOBDB_FLAGS_GET_PACKED(temp->flags))
+	{
+		/* Packed sequences are unpacked before being compressed */
+		TemporalSeq *seq = temporalseq_unpack((TemporalSeqComp *) temp);
+		result = (Temporal *) temporalseq_compress(seq);
+		pfree(seq);
+	}
+	else
+		result = (Temporal *) temporalseq_compress((TemporalSeq *) temp);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_POINTER(result);
+}
+
+PG_FUNCTION_INFO_V1(temporal_is_compressed);
+/**
+ * @brief Returns true if the temporal value is compressed
+ */
+PGDLLEXPORT Datum
+temporal_is_compressed(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = (Temporal *) PG_GETARG_VARLENA_P(0);
+	bool result = MOBDB_FLAGS_GET_COMPRESSED(temp->flags);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_BOOL(result);
+}
+
+/*****************************************************************************/
@@ -0,0 +1,278 @@
+/*****************************************************************************
+ *
+ * temporal_expanded.c
+ *	  Expanded representation of temporal sequences.
+ *
+ * Appending an instant to a flat TemporalSeq requires copying the whole
+ * value. Therefore, the append function returns a read-write expanded object
+ * (see src/backend/utils/adt/expandeddatum.c in PostgreSQL) that keeps the
+ * instants in a growable array. Subsequent appends onto a read-write pointer
+ * to the object, as done by an aggregate whose transition function is 
+ * appendInstant or by nested calls of the function, modify it in place. The
+ * object is only flattened when its value is needed in flat form, e.g., when
+ * it is stored or passed to another function.
+ *
+ * The restriction of a sequence, or of a sequence set to a period that
+ * overlaps only one of its sequences, is also returned as an expanded object,
+ * which is then a view of the argument: the instants strictly inside the
+ * period are those of the argument, only the instants at the bounds of the
+ * period are allocated. The argument is fetched in the memory context of the
+ * object, which thus keeps it alive. The accessor functions that are
+ * typically applied to such restrictions, e.g., numInstants or length, read
+ * the instants of the object directly, the other functions flatten it.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_expanded.h"
+
+#include <assert.h>
+#include <utils/memutils.h>
+
+#include "temporaltypes.h"
+#include "temporal_boxops.h"
+#include "timeops.h"
+
+/*****************************************************************************
+ * Expanded object methods
+ *****************************************************************************/
+
+static Size ETS_get_flat_size(ExpandedObjectHeader *eohptr);
+static void ETS_flatten_into(ExpandedObjectHeader *eohptr,
+	void *result, Size allocated_size);
+
+static const ExpandedObjectMethods ETS_methods =
+{
+	ETS_get_flat_size,
+	ETS_flatten_into
+};
+
+/* Compute the flat value in the memory context of the object if it is not
+ * already cached. The precomputed trajectory of a temporal point is built
+ * from all the instants, which is linear in their number as the copy of
+ * the instants into the flat value. */
+
+static Temporal *
+ETS_get_flat(ExpandedTemporalSeq *eseq)
+{
+	if (eseq->flat == NULL)
+	{
+		MemoryContext oldcxt = MemoryContextSwitchTo(eseq->hdr.eoh_context);
+		TemporalSeq *seq = temporalseq_from_temporalinstarr1(eseq->instants, 
+			eseq->count, eseq->lower_inc, eseq->upper_inc, eseq->linear, false,
+			eseq->hasbbox ? &eseq->bbox : NULL);
+		if (eseq->seqset)
+		{
+			eseq->flat = (Temporal *) temporals_from_temporalseqarr(&seq, 1,
+				eseq->linear, false);
+			pfree(seq);
+		}
+		else
+			eseq->flat = (Temporal *) seq;
+		MemoryContextSwitchTo(oldcxt);
+	}
+	return eseq->flat;
+}
+
+static Size
+ETS_get_flat_size(ExpandedObjectHeader *eohptr)
+{
+	ExpandedTemporalSeq *eseq = (ExpandedTemporalSeq *) eohptr;
+	Assert(eseq->magic == ETS_MAGIC);
+	return VARSIZE(ETS_get_flat(eseq));
+}
+
+static void
+ETS_flatten_into(ExpandedObjectHeader *eohptr, void *result, 
+	Size allocated_size)
+{
+	ExpandedTemporalSeq *eseq = (ExpandedTemporalSeq *) eohptr;
+	Assert(eseq->magic == ETS_MAGIC);
+	Temporal *flat = ETS_get_flat(eseq);
+	Assert(allocated_size == VARSIZE(flat));
+	memcpy(result, flat, allocated_size);
+}
+
+/*****************************************************************************
+ * Expanded sequences
+ *****************************************************************************/
+
+/* 
+ * Expand a TemporalSeq into a read-write expanded object that is a child of
+ * the memory context. The instants of the object point into a copy of the 
+ * flat value, only the appended instants are allocated separately.
+ */
+Datum
+expand_temporalseq(TemporalSeq *seq, MemoryContext parentcontext)
+{
+	MemoryContext objcxt = AllocSetContextCreate(parentcontext,
+		"expanded temporal sequence", ALLOCSET_START_SMALL_SIZES);
+	ExpandedTemporalSeq *eseq = (ExpandedTemporalSeq *) 
+		MemoryContextAllocZero(objcxt, sizeof(ExpandedTemporalSeq));
+	EOH_init_header(&eseq->hdr, &ETS_methods, objcxt);
+	eseq->magic = ETS_MAGIC;
+
+	MemoryContext oldcxt = MemoryContextSwitchTo(objcxt);
+	eseq->fvalue = temporalseq_copy(seq);
+	eseq->valuetypid = seq->valuetypid;
+	eseq->lower_inc = seq->period.lower_inc;
+	eseq->upper_inc = seq->period.upper_inc;
+	eseq->linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	eseq->seqset = false;
+	eseq->count = seq->count;
+	eseq->maxcount = seq->count * 2;
+	eseq->instants = palloc(sizeof(TemporalInst *) * eseq->maxcount);
+	for (int i = 0; i < seq->count; i++)
+		eseq->instants[i] = temporalseq_inst_n(eseq->fvalue, i);
+	temporal_bbox(&eseq->bbox, (Temporal *)seq);
+	eseq->hasbbox = true;
+	/* The flat value is valid until the first append */
+	eseq->flat = (Temporal *) eseq->fvalue;
+	MemoryContextSwitchTo(oldcxt);
+	return EOHPGetRWDatum(&eseq->hdr);
+}
+
+/*
+ * Returns true if the instant of the expanded TemporalSeq was allocated
+ * separately, that is, if it is not an instant of the flat value
+ */
+static bool
+ETS_inst_is_copy(ExpandedTemporalSeq *eseq, TemporalInst *inst)
+{
+	char *start = (char *) eseq->fvalue;
+	return (char *) inst < start ||
+		(char *) inst >= start + VARSIZE(eseq->fvalue);
+}
+
+/*
+ * Append an instant to an expanded TemporalSeq in place. The instant is 
+ * validated and the sequence is normalized as in temporalseq_append_instant.
+ * The bounding box, if computed, is expanded with the instant, so that the
+ * flat value is built without recomputing it.
+ */
+void
+expanded_temporalseq_append_instant(ExpandedTemporalSeq *eseq,
+	TemporalInst *inst)
+{
+	Assert(eseq->magic == ETS_MAGIC);
+	assert(eseq->valuetypid == inst->valuetypid);
+	temporalseq_ensure_append(eseq->instants[eseq->count - 1], inst);
+
+	MemoryContext oldcxt = MemoryContextSwitchTo(eseq->hdr.eoh_context);
+	/* The flat value is no longer valid */
+	if (eseq->flat != NULL && eseq->flat != (Temporal *) eseq->fvalue)
+		pfree(eseq->flat);
+	eseq->flat = NULL;
+	/* The instant is the inclusive upper bound of the result */
+	eseq->upper_inc = true;
+	if (eseq->count > 1 && temporalseq_append_replaces(
+			eseq->instants[eseq->count - 2], eseq->instants[eseq->count - 1],
+			inst, eseq->linear))
+	{
+		/* The new instant replaces the last instant of the sequence */
+		eseq->count--;
+		if (ETS_inst_is_copy(eseq, eseq->instants[eseq->count]))
+			pfree(eseq->instants[eseq->count]);
+	}
+	if (eseq->count == eseq->maxcount)
+	{
+		eseq->maxcount *= 2;
+		eseq->instants = repalloc(eseq->instants, 
+			sizeof(TemporalInst *) * eseq->maxcount);
+	}
+	eseq->instants[eseq->count++] = temporalinst_copy(inst);
+	/* The instant removed by the normalization does not change the box */
+	if (eseq->hasbbox)
+		temporalseq_bbox_append(&eseq->bbox, inst);
+	MemoryContextSwitchTo(oldcxt);
+}
+
+/*****************************************************************************
+ * Views of the restriction to a period
+ *****************************************************************************/
+
+/*
+ * Make a view of the restriction of the temporal value to the period into 
+ * the memory context objcxt, which must also contain the temporal value.
+ * Returns false if the restriction cannot be represented as a view, that is,
+ * if the value is not a sequence or a sequence set with only one sequence
+ * overlapping the period, or if the restriction is empty.
+ */
+bool
+expanded_temporal_at_period(Temporal *temp, Period *p, MemoryContext objcxt,
+	Datum *result)
+{
+	TemporalSeq *seq;
+	bool seqset = false;
+	if (temp->duration == TEMPORALSEQ)
+		seq = (TemporalSeq *) temp;
+	else if (temp->duration == TEMPORALS)
+	{
+		int n = temporals_overlapping_seq((TemporalS *) temp, p);
+		if (n < 0)
+			return false;
+		seq = temporals_seq_n((TemporalS *) temp, n);
+		seqset = true;
+	}
+	else
+		return false;
+	Period inter;
+	if (!intersection_period_period_internal1(&inter, &seq->period, p))
+		return false;
+
+	ExpandedTemporalSeq *eseq = (ExpandedTemporalSeq *) 
+		MemoryContextAlloc(objcxt, sizeof(ExpandedTemporalSeq));
+	EOH_init_header(&eseq->hdr, &ETS_methods, objcxt);
+	eseq->magic = ETS_MAGIC;
+
+	MemoryContext oldcxt = MemoryContextSwitchTo(objcxt);
+	eseq->valuetypid = seq->valuetypid;
+	eseq->linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	eseq->seqset = seqset;
+	if (seq->count == 1)
+	{
+		eseq->instants = palloc(sizeof(TemporalInst *));
+		eseq->instants[0] = temporalseq_inst_n(seq, 0);
+		eseq->count = 1;
+		eseq->lower_inc = eseq->upper_inc = true;
+	}
+	else
+	{
+		int n = temporalseq_find_timestamp(seq, inter.lower);
+		/* If the lower bound of the intersecting period is exclusive */
+		if (n == -1)
+			n = 0;
+		eseq->instants = temporalseq_at_period_instants(seq, &inter, &n,
+			&eseq->count);
+		eseq->lower_inc = inter.lower_inc;
+		eseq->upper_inc = inter.upper_inc;
+	}
+	eseq->maxcount = eseq->count;
+	eseq->fvalue = seq;
+	eseq->flat = NULL;
+	/* The bounding box is computed when the view is flattened */
+	eseq->hasbbox = false;
+	MemoryContextSwitchTo(oldcxt);
+	*result = EOHPGetRWDatum(&eseq->hdr);
+	return true;
+}
+
+/*
+ * Returns the expanded sequence pointed to by the datum, or NULL if the
+ * datum is a flat temporal value
+ */
+ExpandedTemporalSeq *
+expanded_temporalseq_get(Datum value)
+{
+	if (! VARATT_IS_EXTERNAL_EXPANDED(DatumGetPointer(value)))
+		return NULL;
+	ExpandedTemporalSeq *eseq = (ExpandedTemporalSeq *) DatumGetEOHP(value);
+	Assert(eseq->magic == ETS_MAGIC);
+	return eseq;
+}
+
+/*****************************************************************************/
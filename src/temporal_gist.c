@@ -18,6 +18,7 @@
 #include "timetypes.h"
 #include "temporal.h"
 #include "oidcache.h"
+#include "temporal_stats.h"
 #include "time_gist.h"
 
 /*****************************************************************************
@@ -64,6 +65,8 @@ gist_temporal_consistent(PG_FUNCTION_ARGS)
 	else
 		result = index_internal_consistent_period(key, period, strategy);
 
+	MOBDB_STAT_INDEX(STAT_GIST_TEMPORAL, strategy, GIST_LEAF(entry), result,
+		*recheck);
 	PG_RETURN_BOOL(result);
 }
 
@@ -0,0 +1,306 @@
+/*****************************************************************************
+ *
+ * temporal_load.c
+ *	  Bulk load of temporal values from files
+ *
+ * The lines of a CSV file give the identifier of an object, a timestamp,
+ * and the values of the object at this timestamp, in any order. The file is
+ * read once and the values are accumulated per object in a hash table of
+ * growable arrays, without any intermediate table. When the file has been
+ * read, the values of each object are sorted by timestamp and a temporal
+ * sequence is returned for each object, in the order in which the objects
+ * appear in the file. The file is read by the server, so that the functions
+ * are restricted to the superusers and the members of the role
+ * pg_read_server_files.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_load.h"
+
+#include <ctype.h>
+#include <funcapi.h>
+#include <miscadmin.h>
+#include <catalog/pg_authid.h>
+#include <lib/stringinfo.h>
+#include <storage/fd.h>
+#include <utils/acl.h>
+#include <utils/builtins.h>
+#include <utils/hsearch.h>
+#include <utils/timestamp.h>
+#include <utils/tuplestore.h>
+
+#include "temporaltypes.h"
+#include "temporal_util.h"
+
+/* Values of an object read from the file */
+
+typedef struct
+{
+	char id[NAMEDATALEN];	/* Identifier of the object, key of the table */
+	int count;				/* Number of values */
+	int capacity;			/* Number of values allocated */
+	LoadPoint *points;
+} LoadObject;
+
+/*****************************************************************************/
+
+/*
+ * Read a line of the file into the buffer without the end of line. Returns
+ * false at the end of the file.
+ */
+static bool
+load_read_line(FILE *file, StringInfo buf)
+{
+	char chunk[1024];
+	resetStringInfo(buf);
+	while (fgets(chunk, sizeof(chunk), file) != NULL)
+	{
+		appendStringInfoString(buf, chunk);
+		if (buf->len > 0 && buf->data[buf->len - 1] == '\n')
+			break;
+	}
+	if (buf->len == 0)
+		return false;
+	while (buf->len > 0 && (buf->data[buf->len - 1] == '\n' ||
+		buf->data[buf->len - 1] == '\r'))
+		buf->data[--buf->len] = '\0';
+	return true;
+}
+
+/*
+ * Split a line in place into at most maxfields fields, removing the spaces
+ * and the double quotes around them. Returns the number of fields, which is
+ * maxfields + 1 when the line has more fields.
+ */
+static int
+load_split_line(char *line, char delim, char **fields, int maxfields)
+{
+	int count = 0;
+	char *start = line;
+	while (true)
+	{
+		char *end = strchr(start, delim);
+		if (end != NULL)
+			*end = '\0';
+		if (count == maxfields)
+			return maxfields + 1;
+		while (isspace((unsigned char) *start))
+			start++;
+		char *last = start + strlen(start);
+		while (last > start && isspace((unsigned char) last[-1]))
+			last--;
+		if (last - start >= 2 && *start == '"' && last[-1] == '"')
+		{
+			start++;
+			last--;
+		}
+		*last = '\0';
+		fields[count++] = start;
+		if (end == NULL)
+			return count;
+		start = end + 1;
+	}
+}
+
+static void
+load_invalid_line(const char *filename, int lineno, const char *message)
+{
+	ereport(ERROR, (errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+		errmsg("Invalid line %d of file \"%s\": %s", lineno, filename, message)));
+}
+
+static int
+load_point_cmp(const void *a, const void *b)
+{
+	const LoadPoint *p1 = (const LoadPoint *) a;
+	const LoadPoint *p2 = (const LoadPoint *) b;
+	return timestamp_cmp_internal(p1->t, p2->t);
+}
+
+/*
+ * Read a CSV file whose lines give an identifier, a timestamp, and between
+ * minvalues and maxvalues numbers, and return in the tuple store of the
+ * function a row with the identifier and a temporal sequence for each
+ * object. The instants of the sequences are built by the function make
+ * from the values read.
+ */
+void
+temporal_load_csv(FunctionCallInfo fcinfo, text *filename, bool header,
+	text *delimiter, int minvalues, int maxvalues, LoadInstMake make,
+	Datum arg)
+{
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc tupdesc;
+
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo) ||
+		!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("set-valued function called in context that cannot accept a set")));
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("function returning record called in context "
+				"that cannot accept type record")));
+	if (!is_member_of_role(GetUserId(), DEFAULT_ROLE_READ_SERVER_FILES))
+		ereport(ERROR, (errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+			errmsg("must be superuser or a member of the pg_read_server_files role to load from a file")));
+	char *delim = text_to_cstring(delimiter);
+	if (strlen(delim) != 1)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The delimiter must be a single one-byte character")));
+
+	char *fname = text_to_cstring(filename);
+	FILE *file = AllocateFile(fname, PG_BINARY_R);
+	if (file == NULL)
+		ereport(ERROR, (errcode_for_file_access(),
+			errmsg("could not open file \"%s\" for reading: %m", fname)));
+
+	HASHCTL ctl;
+	memset(&ctl, 0, sizeof(ctl));
+	ctl.keysize = NAMEDATALEN;
+	ctl.entrysize = sizeof(LoadObject);
+	ctl.hcxt = CurrentMemoryContext;
+	HTAB *table = hash_create("temporal load", 1024, &ctl,
+		HASH_ELEM | HASH_CONTEXT);
+	/* The objects in the order in which they appear in the file */
+	int nobjects = 0, maxobjects = 1024;
+	LoadObject **objects = palloc(sizeof(LoadObject *) * maxobjects);
+
+	StringInfoData line;
+	initStringInfo(&line);
+	char *fields[LOAD_MAX_VALUES + 2];
+	int nfields = -1;
+	int lineno = 0;
+	while (load_read_line(file, &line))
+	{
+		CHECK_FOR_INTERRUPTS();
+		lineno++;
+		if ((header && lineno == 1) || line.len == 0)
+			continue;
+		int n = load_split_line(line.data, delim[0], fields, maxvalues + 2);
+		if (n < minvalues + 2 || n > maxvalues + 2)
+			load_invalid_line(fname, lineno, "wrong number of fields");
+		if (nfields == -1)
+			nfields = n;
+		else if (n != nfields)
+			load_invalid_line(fname, lineno,
+				"all the lines must have the same number of fields");
+		if (strlen(fields[0]) >= NAMEDATALEN)
+			load_invalid_line(fname, lineno, "identifier too long");
+
+		LoadPoint point;
+		point.t = DatumGetTimestampTz(call_input(TIMESTAMPTZOID, fields[1]));
+		for (int i = 0; i < n - 2; i++)
+		{
+			char *end;
+			errno = 0;
+			point.values[i] = strtod(fields[i + 2], &end);
+			if (end == fields[i + 2] || *end != '\0' || errno == ERANGE)
+				load_invalid_line(fname, lineno, "invalid number");
+		}
+
+		char key[NAMEDATALEN];
+		memset(key, 0, NAMEDATALEN);
+		strcpy(key, fields[0]);
+		bool found;
+		LoadObject *object = (LoadObject *) hash_search(table, key,
+			HASH_ENTER, &found);
+		if (! found)
+		{
+			object->count = 0;
+			object->capacity = 64;
+			object->points = palloc(sizeof(LoadPoint) * object->capacity);
+			if (nobjects == maxobjects)
+			{
+				maxobjects *= 2;
+				objects = repalloc(objects, sizeof(LoadObject *) * maxobjects);
+			}
+			objects[nobjects++] = object;
+		}
+		else if (object->count == object->capacity)
+		{
+			object->capacity *= 2;
+			object->points = repalloc(object->points,
+				sizeof(LoadPoint) * object->capacity);
+		}
+		object->points[object->count++] = point;
+	}
+	if (ferror(file))
+		ereport(ERROR, (errcode_for_file_access(),
+			errmsg("could not read file \"%s\": %m", fname)));
+	FreeFile(file);
+
+	MemoryContext oldcontext =
+		MemoryContextSwitchTo(rsinfo->econtext->ecxt_per_query_memory);
+	tupdesc = BlessTupleDesc(CreateTupleDescCopy(tupdesc));
+	Tuplestorestate *tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+	MemoryContextSwitchTo(oldcontext);
+
+	int nvalues = nfields - 2;
+	TemporalInst **instants = NULL;
+	int maxinstants = 0;
+	for (int i = 0; i < nobjects; i++)
+	{
+		LoadObject *object = objects[i];
+		qsort(object->points, object->count, sizeof(LoadPoint),
+			&load_point_cmp);
+		if (object->count > maxinstants)
+		{
+			if (instants != NULL)
+				pfree(instants);
+			maxinstants = object->count;
+			instants = palloc(sizeof(TemporalInst *) * maxinstants);
+		}
+		for (int j = 0; j < object->count; j++)
+			instants[j] = make(&object->points[j], nvalues, arg);
+		TemporalSeq *seq = temporalseq_from_temporalinstarr(instants,
+			object->count, true, true, true, true);
+		Datum values[2];
+		bool isnull[2] = {false, false};
+		values[0] = CStringGetTextDatum(object->id);
+		values[1] = PointerGetDatum(seq);
+		tuplestore_putvalues(tupstore, tupdesc, values, isnull);
+		for (int j = 0; j < object->count; j++)
+			pfree(instants[j]);
+		pfree(seq);
+		pfree(object->points);
+	}
+	tuplestore_donestoring(tupstore);
+
+	if (instants != NULL)
+		pfree(instants);
+	pfree(objects);
+	pfree(line.data);
+	hash_destroy(table);
+}
+
+/*****************************************************************************/
+
+static TemporalInst *
+tfloatinst_load_make(const LoadPoint *point, int nvalues, Datum arg)
+{
+	return temporalinst_make(Float8GetDatum(point->values[0]), point->t,
+		FLOAT8OID);
+}
+
+PG_FUNCTION_INFO_V1(tfloat_load_csv);
+
+PGDLLEXPORT Datum
+tfloat_load_csv(PG_FUNCTION_ARGS)
+{
+	text *filename = PG_GETARG_TEXT_PP(0);
+	bool header = PG_GETARG_BOOL(1);
+	text *delimiter = PG_GETARG_TEXT_PP(2);
+	temporal_load_csv(fcinfo, filename, header, delimiter, 1, 1,
+		&tfloatinst_load_make, (Datum) 0);
+	PG_RETURN_NULL();
+}
+
+/*****************************************************************************/
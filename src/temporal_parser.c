@@ -17,11 +17,21 @@
 
 #include "temporal_parser.h"
 
+#include <errno.h>
+#include <math.h>
+#include <utils/datetime.h>
+#include <utils/timestamp.h>
+
 #include "periodset.h"
 #include "period.h"
 #include "timestampset.h"
 #include "temporaltypes.h"
 #include "temporal_util.h"
+#include "oidcache.h"
+
+#ifdef WITH_POSTGIS
+#include "tpoint_parser.h"
+#endif
 
 
 /*****************************************************************************/
@@ -117,6 +127,209 @@ p_comma(char **str)
 	return false;
 }
 
+/*****************************************************************************
+ * Fast path parsers for the most common input formats of the base types and
+ * of timestamps. They avoid the function manager round trip of call_input
+ * for every instant. They return false for any input they do not recognize,
+ * in which case the caller falls back to the input function of the type,
+ * which also reports the errors.
+ *****************************************************************************/
+
+/* Parse exactly n digits */
+
+static bool
+p_digits(const char **str, int n, int *result)
+{
+	int value = 0;
+	for (int i = 0; i < n; i++)
+	{
+		char c = (*str)[i];
+		if (c < '0' || c > '9')
+			return false;
+		value = value * 10 + (c - '0');
+	}
+	*str += n;
+	*result = value;
+	return true;
+}
+
+/* Is the remaining of the string only made of whitespace? */
+
+static bool
+p_end(const char *str)
+{
+	while (*str == ' ' || *str == '\t' || *str == '\n' || *str == '\r')
+		str++;
+	return *str == '\0';
+}
+
+static bool
+bool_parse_fast(const char *str, Datum *result)
+{
+	while (*str == ' ')
+		str++;
+	if (*str == 't' && (p_end(str + 1) || 
+			(strncmp(str, "true", 4) == 0 && p_end(str + 4))))
+	{
+		*result = BoolGetDatum(true);
+		return true;
+	}
+	if (*str == 'f' && (p_end(str + 1) || 
+			(strncmp(str, "false", 5) == 0 && p_end(str + 5))))
+	{
+		*result = BoolGetDatum(false);
+		return true;
+	}
+	return false;
+}
+
+static bool
+int4_parse_fast(const char *str, Datum *result)
+{
+	while (*str == ' ')
+		str++;
+	bool neg = (*str == '-');
+	if (*str == '-' || *str == '+')
+		str++;
+	int64 value = 0;
+	int ndigits = 0;
+	while (*str >= '0' && *str <= '9')
+	{
+		/* Leave the overflow checks to the input function */
+		if (++ndigits > 9)
+			return false;
+		value = value * 10 + (*str++ - '0');
+	}
+	if (ndigits == 0 || ! p_end(str))
+		return false;
+	*result = Int32GetDatum((int32) (neg ? -value : value));
+	return true;
+}
+
+static bool
+float8_parse_fast(const char *str, Datum *result)
+{
+	while (*str == ' ')
+		str++;
+	/* Leave NaN, Infinity, and hexadecimal notation to the input function */
+	const char *p = str;
+	while ((*p >= '0' && *p <= '9') || *p == '.' || *p == '-' || *p == '+' ||
+			*p == 'e' || *p == 'E')
+		p++;
+	if (p == str || ! p_end(p))
+		return false;
+	char *end;
+	errno = 0;
+	double value = strtod(str, &end);
+	if (end != p || errno != 0 || isinf(value))
+		return false;
+	*result = Float8GetDatum(value);
+	return true;
+}
+
+/*
+ * Parse a timestamp in ISO 8601 format YYYY-MM-DD[ HH:MM[:SS[.ffffff]]] 
+ * with an optional time zone Z, +HH, +HHMM, or +HH:MM. Timestamps without 
+ * time zone are interpreted in the time zone of the session.
+ */
+static bool
+timestamp_parse_fast(const char *str, TimestampTz *result)
+{
+	struct pg_tm tt, *tm = &tt;
+	fsec_t fsec = 0;
+	int tz = 0, tzhour = 0, tzmin = 0;
+	bool hastz = false;
+
+	memset(tm, 0, sizeof(struct pg_tm));
+	while (*str == ' ')
+		str++;
+	if (! p_digits(&str, 4, &tm->tm_year) || *str++ != '-' ||
+		! p_digits(&str, 2, &tm->tm_mon) || *str++ != '-' ||
+		! p_digits(&str, 2, &tm->tm_mday))
+		return false;
+	if ((*str == ' ' || *str == 'T') && str[1] >= '0' && str[1] <= '9')
+	{
+		str++;
+		if (! p_digits(&str, 2, &tm->tm_hour) || *str++ != ':' ||
+			! p_digits(&str, 2, &tm->tm_min))
+			return false;
+		if (*str == ':')
+		{
+			str++;
+			if (! p_digits(&str, 2, &tm->tm_sec))
+				return false;
+			if (*str == '.')
+			{
+				str++;
+				int scale = 100000, ndigits = 0;
+				while (*str >= '0' && *str <= '9')
+				{
+					/* Leave the rounding of the fraction to the input function */
+					if (++ndigits > 6)
+						return false;
+					fsec += (*str++ - '0') * scale;
+					scale /= 10;
+				}
+				if (ndigits == 0)
+					return false;
+			}
+		}
+	}
+	if (*str == 'Z')
+	{
+		hastz = true;
+		str++;
+	}
+	else if (*str == '+' || *str == '-')
+	{
+		hastz = true;
+		bool neg = (*str++ == '-');
+		if (! p_digits(&str, 2, &tzhour))
+			return false;
+		if (*str == ':')
+			str++;
+		if (*str >= '0' && *str <= '9' && ! p_digits(&str, 2, &tzmin))
+			return false;
+		if (tzhour > 15 || tzmin > 59)
+			return false;
+		/* Time zones are expressed in seconds west of Greenwich */
+		tz = (tzhour * SECS_PER_HOUR + tzmin * SECS_PER_MINUTE) * (neg ? 1 : -1);
+	}
+	if (! p_end(str))
+		return false;
+
+	/* Leave the corner cases such as 24:00:00 to the input function */
+	if (tm->tm_year < 1 || tm->tm_mon < 1 || tm->tm_mon > MONTHS_PER_YEAR ||
+		tm->tm_mday < 1 || 
+		tm->tm_mday > day_tab[isleap(tm->tm_year)][tm->tm_mon - 1] ||
+		tm->tm_hour > 23 || tm->tm_min > 59 || tm->tm_sec > 59)
+		return false;
+	if (! hastz)
+		tz = DetermineTimeZoneOffset(tm, session_timezone);
+	return tm2timestamp(tm, fsec, &tz, result) == 0;
+}
+
+/* 
+ * Get the value of a base type from its string representation, using the
+ * fast path parsers when possible 
+ */
+static Datum
+basetype_input(Oid basetype, char *str)
+{
+	Datum result;
+	if (basetype == BOOLOID && bool_parse_fast(str, &result))
+		return result;
+	if (basetype == INT4OID && int4_parse_fast(str, &result))
+		return result;
+	if (basetype == FLOAT8OID && float8_parse_fast(str, &result))
+		return result;
+#ifdef WITH_POSTGIS
+	if (basetype == type_oid(T_GEOMETRY) && geometry_point_parse_fast(str, &result))
+		return result;
+#endif
+	return call_input(basetype, str);
+}
+
 Datum 
 basetype_parse(char **str, Oid basetype)
 {
@@ -142,7 +355,7 @@ basetype_parse(char **str, Oid basetype)
 		ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION), 
 			errmsg("Could not parse element value")));
 	(*str)[delim] = '\0';
-	Datum result = call_input(basetype, *str);
+	Datum result = basetype_input(basetype, *str);
 	if (isttext)
 		/* Replace the double quote */
 		(*str)[delim++] = '"';
@@ -291,7 +504,9 @@ timestamp_parse(char **str)
 		delim++;
 	char bak = (*str)[delim];
 	(*str)[delim] = '\0';
-	Datum result = call_input(TIMESTAMPTZOID, *str);
+	TimestampTz result;
+	if (! timestamp_parse_fast(*str, &result))
+		result = DatumGetTimestampTz(call_input(TIMESTAMPTZOID, *str));
 	(*str)[delim] = bak;
 	*str += delim;
 	return result;
@@ -202,11 +202,9 @@ PGDLLEXPORT Datum
 before_period_temporal(PG_FUNCTION_ARGS)
 {
 	Period *p = PG_GETARG_PERIOD(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Period p1;
-	temporal_bbox(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(1));
 	bool result = before_period_period_internal(p, &p1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -216,11 +214,9 @@ PGDLLEXPORT Datum
 overbefore_period_temporal(PG_FUNCTION_ARGS)
 {
 	Period *p = PG_GETARG_PERIOD(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Period p1;
-	temporal_bbox(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(1));
 	bool result = overbefore_period_period_internal(p, &p1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -230,11 +226,9 @@ PGDLLEXPORT Datum
 after_period_temporal(PG_FUNCTION_ARGS)
 {
 	Period *p = PG_GETARG_PERIOD(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Period p1;
-	temporal_bbox(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(1));
 	bool result = after_period_period_internal(p, &p1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -244,11 +238,9 @@ PGDLLEXPORT Datum
 overafter_period_temporal(PG_FUNCTION_ARGS)
 {
 	Period *p = PG_GETARG_PERIOD(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Period p1;
-	temporal_bbox(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(1));
 	bool result = overafter_period_period_internal(p, &p1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -260,12 +252,10 @@ PG_FUNCTION_INFO_V1(before_temporal_period);
 PGDLLEXPORT Datum
 before_temporal_period(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Period *p = PG_GETARG_PERIOD(1);
 	Period p1;
-	temporal_bbox(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
 	bool result = before_period_period_internal(&p1, p);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -274,12 +264,10 @@ PG_FUNCTION_INFO_V1(overbefore_temporal_period);
 PGDLLEXPORT Datum
 overbefore_temporal_period(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Period *p = PG_GETARG_PERIOD(1);
 	Period p1;
-	temporal_bbox(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
 	bool result = overbefore_period_period_internal(&p1, p);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -288,12 +276,10 @@ PG_FUNCTION_INFO_V1(after_temporal_period);
 PGDLLEXPORT Datum
 after_temporal_period(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Period *p = PG_GETARG_PERIOD(1);
 	Period p1;
-	temporal_bbox(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
 	bool result = after_period_period_internal(&p1, p);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -302,12 +288,10 @@ PG_FUNCTION_INFO_V1(overafter_temporal_period);
 PGDLLEXPORT Datum
 overafter_temporal_period(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	Period *p = PG_GETARG_PERIOD(1);
 	Period p1;
-	temporal_bbox(&p1, temp);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
 	bool result = overafter_period_period_internal(&p1, p);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -319,14 +303,10 @@ PG_FUNCTION_INFO_V1(before_temporal_temporal);
 PGDLLEXPORT Datum
 before_temporal_temporal(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	Period p1, p2;
-	temporal_bbox(&p1, temp1);
-	temporal_bbox(&p2, temp2);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&p2, PG_GETARG_DATUM(1));
 	bool result = before_period_period_internal(&p1, &p2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -335,14 +315,10 @@ PG_FUNCTION_INFO_V1(overbefore_temporal_temporal);
 PGDLLEXPORT Datum
 overbefore_temporal_temporal(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	Period p1, p2;
-	temporal_bbox(&p1, temp1);
-	temporal_bbox(&p2, temp2);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&p2, PG_GETARG_DATUM(1));
 	bool result = overbefore_period_period_internal(&p1, &p2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -351,14 +327,10 @@ PG_FUNCTION_INFO_V1(after_temporal_temporal);
 PGDLLEXPORT Datum
 after_temporal_temporal(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	Period p1, p2;
-	temporal_bbox(&p1, temp1);
-	temporal_bbox(&p2, temp2);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&p2, PG_GETARG_DATUM(1));
 	bool result = after_period_period_internal(&p1, &p2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -367,14 +339,10 @@ PG_FUNCTION_INFO_V1(overafter_temporal_temporal);
 PGDLLEXPORT Datum
 overafter_temporal_temporal(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	Period p1, p2;
-	temporal_bbox(&p1, temp1);
-	temporal_bbox(&p2, temp2);
+	temporal_bbox_datum(&p1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&p2, PG_GETARG_DATUM(1));
 	bool result = overafter_period_period_internal(&p1, &p2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -386,16 +354,12 @@ PG_FUNCTION_INFO_V1(left_range_tnumber);
 PGDLLEXPORT Datum
 left_range_tnumber(PG_FUNCTION_ARGS)
 {
-	RangeType *range = PG_GETARG_RANGE_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	range_to_tbox_internal(&box1, range);
-	temporal_bbox(&box2, temp);
+	range_to_tbox_fn(&box1, fcinfo, 0);
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = left_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(range, 0);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -404,16 +368,12 @@ PG_FUNCTION_INFO_V1(overleft_range_tnumber);
 PGDLLEXPORT Datum
 overleft_range_tnumber(PG_FUNCTION_ARGS)
 {
-	RangeType *range = PG_GETARG_RANGE_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	range_to_tbox_internal(&box1, range);
-	temporal_bbox(&box2, temp);
+	range_to_tbox_fn(&box1, fcinfo, 0);
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = overleft_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(range, 0);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -422,16 +382,12 @@ PG_FUNCTION_INFO_V1(right_range_tnumber);
 PGDLLEXPORT Datum
 right_range_tnumber(PG_FUNCTION_ARGS)
 {
-	RangeType *range = PG_GETARG_RANGE_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	range_to_tbox_internal(&box1, range);
-	temporal_bbox(&box2, temp);
+	range_to_tbox_fn(&box1, fcinfo, 0);
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = right_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(range, 0);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -440,16 +396,12 @@ PG_FUNCTION_INFO_V1(overright_range_tnumber);
 PGDLLEXPORT Datum
 overright_range_tnumber(PG_FUNCTION_ARGS)
 {
-	RangeType *range = PG_GETARG_RANGE_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	range_to_tbox_internal(&box1, range);
-	temporal_bbox(&box2, temp);
+	range_to_tbox_fn(&box1, fcinfo, 0);
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = overright_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(range, 0);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -461,16 +413,12 @@ PG_FUNCTION_INFO_V1(left_tnumber_range);
 PGDLLEXPORT Datum
 left_tnumber_range(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	RangeType *range = PG_GETARG_RANGE_P(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
-	range_to_tbox_internal(&box2, range);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	range_to_tbox_fn(&box2, fcinfo, 1);
 	bool result = left_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp, 0);
-	PG_FREE_IF_COPY(range, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -479,16 +427,12 @@ PG_FUNCTION_INFO_V1(overleft_tnumber_range);
 PGDLLEXPORT Datum
 overleft_tnumber_range(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	RangeType *range = PG_GETARG_RANGE_P(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
-	range_to_tbox_internal(&box2, range);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	range_to_tbox_fn(&box2, fcinfo, 1);
 	bool result = overleft_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp, 0);
-	PG_FREE_IF_COPY(range, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -497,16 +441,12 @@ PG_FUNCTION_INFO_V1(right_tnumber_range);
 PGDLLEXPORT Datum
 right_tnumber_range(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	RangeType *range = PG_GETARG_RANGE_P(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
-	range_to_tbox_internal(&box2, range);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	range_to_tbox_fn(&box2, fcinfo, 1);
 	bool result = right_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp, 0);
-	PG_FREE_IF_COPY(range, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -515,16 +455,12 @@ PG_FUNCTION_INFO_V1(overright_tnumber_range);
 PGDLLEXPORT Datum
 overright_tnumber_range(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
-	RangeType *range = PG_GETARG_RANGE_P(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
-	range_to_tbox_internal(&box2, range);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	range_to_tbox_fn(&box2, fcinfo, 1);
 	bool result = overright_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp, 0);
-	PG_FREE_IF_COPY(range, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -537,12 +473,10 @@ PGDLLEXPORT Datum
 left_tbox_tnumber(PG_FUNCTION_ARGS)
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = left_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -552,12 +486,10 @@ PGDLLEXPORT Datum
 overleft_tbox_tnumber(PG_FUNCTION_ARGS)
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = overleft_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -567,12 +499,10 @@ PGDLLEXPORT Datum
 right_tbox_tnumber(PG_FUNCTION_ARGS)
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = right_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -582,12 +512,10 @@ PGDLLEXPORT Datum
 overright_tbox_tnumber(PG_FUNCTION_ARGS)
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = overright_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -597,12 +525,10 @@ PGDLLEXPORT Datum
 before_tbox_tnumber(PG_FUNCTION_ARGS)
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = before_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -612,12 +538,10 @@ PGDLLEXPORT Datum
 overbefore_tbox_tnumber(PG_FUNCTION_ARGS)
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = overbefore_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -627,12 +551,10 @@ PGDLLEXPORT Datum
 after_tbox_tnumber(PG_FUNCTION_ARGS)
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = after_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -642,12 +564,10 @@ PGDLLEXPORT Datum
 overafter_tbox_tnumber(PG_FUNCTION_ARGS)
 {
 	TBOX *box = PG_GETARG_TBOX_P(0);
-	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(1));
 	bool result = overafter_tbox_tbox_internal(box, &box1);
-	PG_FREE_IF_COPY(temp, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -659,13 +579,11 @@ PG_FUNCTION_INFO_V1(left_tnumber_tbox);
 PGDLLEXPORT Datum
 left_tnumber_tbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = left_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -674,13 +592,11 @@ PG_FUNCTION_INFO_V1(overleft_tnumber_tbox);
 PGDLLEXPORT Datum
 overleft_tnumber_tbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = overleft_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -689,13 +605,11 @@ PG_FUNCTION_INFO_V1(right_tnumber_tbox);
 PGDLLEXPORT Datum
 right_tnumber_tbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = right_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -704,13 +618,11 @@ PG_FUNCTION_INFO_V1(overright_tnumber_tbox);
 PGDLLEXPORT Datum
 overright_tnumber_tbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = overright_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -719,13 +631,11 @@ PG_FUNCTION_INFO_V1(before_tnumber_tbox);
 PGDLLEXPORT Datum
 before_tnumber_tbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = before_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -734,13 +644,11 @@ PG_FUNCTION_INFO_V1(overbefore_tnumber_tbox);
 PGDLLEXPORT Datum
 overbefore_tnumber_tbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = overbefore_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -749,13 +657,11 @@ PG_FUNCTION_INFO_V1(after_tnumber_tbox);
 PGDLLEXPORT Datum
 after_tnumber_tbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = after_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -764,13 +670,11 @@ PG_FUNCTION_INFO_V1(overafter_tnumber_tbox);
 PGDLLEXPORT Datum
 overafter_tnumber_tbox(PG_FUNCTION_ARGS)
 {
-	Temporal *temp = PG_GETARG_TEMPORAL(0);
 	TBOX *box = PG_GETARG_TBOX_P(1);
 	TBOX box1;
 	memset(&box1, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
 	bool result = overafter_tbox_tbox_internal(&box1, box);
-	PG_FREE_IF_COPY(temp, 0);
 	PG_RETURN_BOOL(result);
 }
 
@@ -782,16 +686,12 @@ PG_FUNCTION_INFO_V1(left_tnumber_tnumber);
 PGDLLEXPORT Datum
 left_tnumber_tnumber(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = left_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -800,16 +700,12 @@ PG_FUNCTION_INFO_V1(overleft_tnumber_tnumber);
 PGDLLEXPORT Datum
 overleft_tnumber_tnumber(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = overleft_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -818,16 +714,12 @@ PG_FUNCTION_INFO_V1(right_tnumber_tnumber);
 PGDLLEXPORT Datum
 right_tnumber_tnumber(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = right_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -836,16 +728,12 @@ PG_FUNCTION_INFO_V1(overright_tnumber_tnumber);
 PGDLLEXPORT Datum
 overright_tnumber_tnumber(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = overright_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -854,16 +742,12 @@ PG_FUNCTION_INFO_V1(before_tnumber_tnumber);
 PGDLLEXPORT Datum
 before_tnumber_tnumber(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = before_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -872,16 +756,12 @@ PG_FUNCTION_INFO_V1(overbefore_tnumber_tnumber);
 PGDLLEXPORT Datum
 overbefore_tnumber_tnumber(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = overbefore_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -890,16 +770,12 @@ PG_FUNCTION_INFO_V1(after_tnumber_tnumber);
 PGDLLEXPORT Datum
 after_tnumber_tnumber(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = after_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
@@ -908,16 +784,12 @@ PG_FUNCTION_INFO_V1(overafter_tnumber_tnumber);
 PGDLLEXPORT Datum
 overafter_tnumber_tnumber(PG_FUNCTION_ARGS)
 {
-	Temporal *temp1 = PG_GETARG_TEMPORAL(0);
-	Temporal *temp2 = PG_GETARG_TEMPORAL(1);
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
-	temporal_bbox(&box1, temp1);
-	temporal_bbox(&box2, temp2);
+	temporal_bbox_datum(&box1, PG_GETARG_DATUM(0));
+	temporal_bbox_datum(&box2, PG_GETARG_DATUM(1));
 	bool result = overafter_tbox_tbox_internal(&box1, &box2);
-	PG_FREE_IF_COPY(temp1, 0);
-	PG_FREE_IF_COPY(temp2, 1);
 	PG_RETURN_BOOL(result);
 }
 
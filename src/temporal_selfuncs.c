@@ -33,8 +33,10 @@
 #include <access/skey.h>
 #include <catalog/pg_collation_d.h>
 #include <executor/tuptable.h>
+#include <miscadmin.h>
 #include <optimizer/paths.h>
 #include <storage/bufmgr.h>
+#include <utils/acl.h>
 #include <utils/builtins.h>
 #include <utils/date.h>
 #include <utils/datum.h>
@@ -48,8 +50,10 @@
 #include "period.h"
 #include "periodset.h"
 #include "time_selfuncs.h"
+#include "time_analyze.h"
 #include "rangetypes_ext.h"
 #include "temporal_analyze.h"
+#include "temporal_util.h"
 #include "tpoint.h"
 
 /*****************************************************************************
@@ -1415,4 +1419,131 @@ temporal_joinsel(PG_FUNCTION_ARGS)
 	PG_RETURN_FLOAT8(DEFAULT_TEMP_SELECTIVITY);
 }
 
+/*****************************************************************************
+ * Estimated extent of a column from the statistics collected by ANALYZE
+ *****************************************************************************/
+
+/*
+ * Returns the statistics tuple of a column of a relation, or NULL if the 
+ * column has not been analyzed. The tuple must be released by the caller
+ * with ReleaseSysCache. As for the pg_stats view, NULL is also returned
+ * when the user cannot select the column, since the statistics expose
+ * values of the column.
+ */
+HeapTuple
+temporal_stats_tuple(Oid relid, text *attname, Oid *atttypid)
+{
+	char *name = text_to_cstring(attname);
+	AttrNumber attnum = get_attnum(relid, name);
+	if (attnum == InvalidAttrNumber)
+		ereport(ERROR, (errcode(ERRCODE_UNDEFINED_COLUMN),
+			errmsg("column \"%s\" of relation \"%s\" does not exist",
+				name, get_rel_name(relid))));
+	pfree(name);
+	*atttypid = get_atttype(relid, attnum);
+	if (pg_class_aclcheck(relid, GetUserId(), ACL_SELECT) != ACLCHECK_OK &&
+		pg_attribute_aclcheck(relid, attnum, GetUserId(), 
+			ACL_SELECT) != ACLCHECK_OK)
+		return NULL;
+	HeapTuple result = SearchSysCache3(STATRELATTINH, 
+		ObjectIdGetDatum(relid), Int16GetDatum(attnum), BoolGetDatum(false));
+	return HeapTupleIsValid(result) ? result : NULL;
+}
+
+/*
+ * Find the minimum and maximum values of a scalar dimension from the most
+ * common values and the histogram collected for it, which together cover
+ * the values of the sample
+ */
+bool
+temporal_stats_scalar_extent(HeapTuple stats_tuple, Oid typid, 
+	Datum *min, Datum *max)
+{
+	TypeCacheEntry *typcache = lookup_type_cache(typid, 
+		TYPECACHE_EQ_OPR | TYPECACHE_LT_OPR);
+	int kinds[] = { STATISTIC_KIND_MCV, STATISTIC_KIND_HISTOGRAM };
+	Oid oprs[] = { typcache->eq_opr, typcache->lt_opr };
+	bool result = false;
+	for (int k = 0; k < 2; k++)
+	{
+		AttStatsSlot sslot;
+		if (! get_attstatsslot(&sslot, stats_tuple, kinds[k], oprs[k], 
+				ATTSTATSSLOT_VALUES))
+			continue;
+		for (int i = 0; i < sslot.nvalues; i++)
+		{
+			if (! result || datum_lt(sslot.values[i], *min, typid))
+				*min = sslot.values[i];
+			if (! result || datum_gt(sslot.values[i], *max, typid))
+				*max = sslot.values[i];
+			result = true;
+		}
+		free_attstatsslot(&sslot);
+	}
+	return result;
+}
+
+/*
+ * Find the time extent from the statistics of a temporal column. For 
+ * instant durations these are the statistics of the timestamps, otherwise
+ * the bounds histogram of the periods whose first and last entries keep 
+ * the smallest lower bound and the largest upper bound of the sample.
+ */
+bool
+temporal_stats_time_extent(HeapTuple stats_tuple, TimestampTz *tmin, 
+	TimestampTz *tmax)
+{
+	AttStatsSlot sslot;
+	if (get_attstatsslot(&sslot, stats_tuple, 
+			STATISTIC_KIND_PERIOD_BOUNDS_HISTOGRAM, InvalidOid, 
+			ATTSTATSSLOT_VALUES))
+	{
+		*tmin = DatumGetPeriod(sslot.values[0])->lower;
+		*tmax = DatumGetPeriod(sslot.values[sslot.nvalues - 1])->upper;
+		free_attstatsslot(&sslot);
+		return true;
+	}
+	Datum min, max;
+	if (! temporal_stats_scalar_extent(stats_tuple, TIMESTAMPTZOID, 
+			&min, &max))
+		return false;
+	*tmin = DatumGetTimestampTz(min);
+	*tmax = DatumGetTimestampTz(max);
+	return true;
+}
+
+/*
+ * Returns the average number of instants of the values of a temporal column
+ * estimated from the statistics collected by ANALYZE, which measures the
+ * cost of processing the values of the column. Returns NULL if the column
+ * has not been analyzed or if the statistics were not collected.
+ */
+
+PG_FUNCTION_INFO_V1(temporal_estimated_num_instants);
+
+PGDLLEXPORT Datum
+temporal_estimated_num_instants(PG_FUNCTION_ARGS)
+{
+	Oid relid = PG_GETARG_OID(0);
+	text *attname = PG_GETARG_TEXT_P(1);
+	Oid atttypid;
+	HeapTuple stats_tuple = temporal_stats_tuple(relid, attname, &atttypid);
+	if (! temporal_type_oid(atttypid))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The column must be of a temporal type")));
+	if (stats_tuple == NULL)
+		PG_RETURN_NULL();
+
+	AttStatsSlot sslot;
+	bool found = get_attstatsslot(&sslot, stats_tuple, 
+		STATISTIC_KIND_NUM_INSTANTS_HISTOGRAM, InvalidOid, 
+		ATTSTATSSLOT_NUMBERS);
+	ReleaseSysCache(stats_tuple);
+	if (! found)
+		PG_RETURN_NULL();
+	double result = sslot.numbers[0];
+	free_attstatsslot(&sslot);
+	PG_RETURN_FLOAT8(result);
+}
+
 /*****************************************************************************/
@@ -22,6 +22,7 @@
 #include "time_gist.h"
 #include "time_spgist.h"
 #include "temporaltypes.h"
+#include "temporal_stats.h"
 
 /*****************************************************************************
  * SP-GiST inner consistent function for temporal types
@@ -312,6 +313,8 @@ spgist_temporal_leaf_consistent(PG_FUNCTION_ARGS)
 		else
 			elog(ERROR, "Unrecognized strategy number: %d", strategy);
 
+		MOBDB_STAT_INDEX(STAT_SPGIST_TEMPORAL, strategy, true, res, out->recheck);
+
 		/* If any check is failed, we have found our answer. */
 		if (!res)
 			break;
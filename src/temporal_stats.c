@@ -0,0 +1,222 @@
+/*****************************************************************************
+ *
+ * temporal_stats.c
+ *	  Counters of the work done by the core functions in a backend
+ *
+ * When the extension is compiled with WITH_STATS, the hot paths of the
+ * lifting infrastructure, of the temporal aggregates, and of the temporal
+ * spatial relationships update per-backend counters of the instants
+ * processed, the segments synchronized, the crossings computed, the calls to
+ * GEOS, the memory used by the arenas of the lifted functions, the splices
+ * of the skiplists, and the bytes of the detoasted temporal values. The
+ * function mobdb_stat_activity reports the counters since the start of the
+ * backend or the last call to mobdb_stat_reset. Without WITH_STATS the
+ * counters are never updated and the function reports zeros. With it, the
+ * counters are only updated while the setting mobilitydb.stats is on, which
+ * is the default. The counters of parallel workers are not added to those
+ * of the leader.
+ *
+ * The consistent functions of the GiST and SP-GiST operator classes also
+ * count, for each strategy, their calls and the leaf entries they return,
+ * with or without recheck, which are reported by mobdb_stat_index. The
+ * operator class cannot observe the outcome of the recheck, which is done
+ * by the executor; the number of rechecks that failed is the difference
+ * between the leaf entries returned with recheck and the rows that passed
+ * the recheck, which EXPLAIN ANALYZE reports as "Rows Removed by Index
+ * Recheck" for bitmap scans.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_stats.h"
+
+#include <access/htup_details.h>
+#include <funcapi.h>
+#include <miscadmin.h>
+#include <utils/builtins.h>
+#include <utils/tuplestore.h>
+
+#include "temporaltypes.h"
+
+/* Value of the setting mobilitydb.stats */
+bool mobdb_stats_enabled = true;
+
+#ifdef WITH_STATS
+MobdbStats mobdb_stats;
+MobdbIndexStats mobdb_index_stats[STAT_INDEX_OPCLASSES][STAT_INDEX_STRATEGIES];
+
+/* Names of the operator classes in the order of MobdbStatIndex */
+static const char *stat_index_opclass_names[STAT_INDEX_OPCLASSES] =
+{
+	"gist_period", "spgist_period", "gist_temporal", "spgist_temporal",
+	"gist_tnumber", "spgist_tnumber", "gist_tpoint", "spgist_tpoint"
+};
+#endif
+
+/*****************************************************************************/
+
+/* Number of instants of a temporal value without counting the distinct ones */
+
+uint64
+temporal_stat_instants(Temporal *temp)
+{
+	if (temp->duration == TEMPORALINST)
+		return 1;
+	if (temp->duration == TEMPORALI)
+		return ((TemporalI *) temp)->count;
+	if (temp->duration == TEMPORALSEQ)
+		return ((TemporalSeq *) temp)->count;
+	return ((TemporalS *) temp)->totalcount;
+}
+
+/*
+ * Detoast a temporal value, counting the bytes of the value when it is
+ * a copy. This function is called by the DatumGetTemporal and
+ * PG_GETARG_TEMPORAL macros when the extension is compiled with WITH_STATS.
+ */
+struct varlena *
+temporal_stat_detoast(Datum value)
+{
+	struct varlena *result = PG_DETOAST_DATUM(value);
+	if ((Pointer) result != DatumGetPointer(value))
+		MOBDB_STAT_ADD(detoast_bytes, VARSIZE(result));
+	return result;
+}
+
+/*
+ * Count a call to the consistent function of an operator class for a
+ * strategy. For the leaf entries, match and recheck are the result and the
+ * recheck flag returned by the function.
+ */
+void
+temporal_stat_index(MobdbStatIndex opclass, StrategyNumber strategy,
+	bool leaf, bool match, bool recheck)
+{
+#ifdef WITH_STATS
+	if (strategy >= STAT_INDEX_STRATEGIES)
+		strategy = 0;
+	MobdbIndexStats *stats = &mobdb_index_stats[opclass][strategy];
+	stats->calls++;
+	if (! leaf)
+		stats->internal_calls++;
+	else
+	{
+		stats->leaf_calls++;
+		if (match)
+		{
+			stats->leaf_matches++;
+			if (recheck)
+				stats->leaf_rechecks++;
+		}
+	}
+#endif
+}
+
+/*****************************************************************************/
+
+PG_FUNCTION_INFO_V1(mobdb_stat_activity);
+
+PGDLLEXPORT Datum
+mobdb_stat_activity(PG_FUNCTION_ARGS)
+{
+	TupleDesc tupdesc;
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("function returning record called in context "
+				"that cannot accept type record")));
+	tupdesc = BlessTupleDesc(tupdesc);
+
+	MobdbStats stats;
+#ifdef WITH_STATS
+	stats = mobdb_stats;
+	bool enabled = mobdb_stats_enabled;
+#else
+	memset(&stats, 0, sizeof(MobdbStats));
+	bool enabled = false;
+#endif
+	Datum values[8];
+	bool isnull[8] = {false, false, false, false, false, false, false, false};
+	values[0] = Int64GetDatum((int64) stats.instants);
+	values[1] = Int64GetDatum((int64) stats.sync_segments);
+	values[2] = Int64GetDatum((int64) stats.crossings);
+	values[3] = Int64GetDatum((int64) stats.geos_calls);
+	values[4] = Int64GetDatum((int64) stats.lifting_bytes);
+	values[5] = Int64GetDatum((int64) stats.skiplist_splices);
+	values[6] = Int64GetDatum((int64) stats.detoast_bytes);
+	values[7] = BoolGetDatum(enabled);
+	HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
+	PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
+PG_FUNCTION_INFO_V1(mobdb_stat_reset);
+
+PGDLLEXPORT Datum
+mobdb_stat_reset(PG_FUNCTION_ARGS)
+{
+#ifdef WITH_STATS
+	memset(&mobdb_stats, 0, sizeof(MobdbStats));
+	memset(mobdb_index_stats, 0, sizeof(mobdb_index_stats));
+#endif
+	PG_RETURN_VOID();
+}
+
+/*
+ * Counters of the consistent functions of the operator classes, one row per
+ * operator class and strategy that has been used since the start of the
+ * backend or the last call to mobdb_stat_reset
+ */
+PG_FUNCTION_INFO_V1(mobdb_stat_index);
+
+PGDLLEXPORT Datum
+mobdb_stat_index(PG_FUNCTION_ARGS)
+{
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo) ||
+		(rsinfo->allowedModes & SFRM_Materialize) == 0)
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("set-valued function called in context that cannot accept a set")));
+	TupleDesc tupdesc;
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("function returning record called in context "
+				"that cannot accept type record")));
+
+	MemoryContext oldcontext =
+		MemoryContextSwitchTo(rsinfo->econtext->ecxt_per_query_memory);
+	tupdesc = CreateTupleDescCopy(tupdesc);
+	Tuplestorestate *tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+	MemoryContextSwitchTo(oldcontext);
+
+#ifdef WITH_STATS
+	for (int i = 0; i < STAT_INDEX_OPCLASSES; i++)
+	{
+		for (int j = 0; j < STAT_INDEX_STRATEGIES; j++)
+		{
+			MobdbIndexStats *stats = &mobdb_index_stats[i][j];
+			if (stats->calls == 0)
+				continue;
+			Datum values[7];
+			bool isnull[7] = {false, false, false, false, false, false, false};
+			values[0] = CStringGetTextDatum(stat_index_opclass_names[i]);
+			values[1] = Int32GetDatum(j);
+			values[2] = Int64GetDatum((int64) stats->calls);
+			values[3] = Int64GetDatum((int64) stats->internal_calls);
+			values[4] = Int64GetDatum((int64) stats->leaf_calls);
+			values[5] = Int64GetDatum((int64) stats->leaf_matches);
+			values[6] = Int64GetDatum((int64) stats->leaf_rechecks);
+			tuplestore_putvalues(tupstore, tupdesc, values, isnull);
+		}
+	}
+#endif
+	tuplestore_donestoring(tupstore);
+	return (Datum) 0;
+}
+
+/*****************************************************************************/
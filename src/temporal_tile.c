@@ -0,0 +1,431 @@
+/*****************************************************************************
+ *
+ * temporal_tile.c
+ *	  Split of temporal values according to time buckets
+ *
+ * The time is split into buckets of a given duration aligned with an origin,
+ * using the same numbering of buckets as the bucketed temporal aggregates.
+ * The function timeSplit traverses a temporal value once, cutting its
+ * sequences at the boundaries of the buckets. A bucket contains its start
+ * but not its end, so that every instant of a temporal value belongs to
+ * exactly one fragment. The function timeBucket returns the start of the
+ * bucket containing a timestamp or the lower bound of a period. Since it is
+ * immutable, it can be used in partition keys and CHECK constraints.
+ *
+ * Portions Copyright (c) 2020, Esteban Zimanyi, Arthur Lesuisse,
+ *		Universite Libre de Bruxelles
+ * Portions Copyright (c) 1996-2020, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *****************************************************************************/
+
+#include "temporal_tile.h"
+
+#include <funcapi.h>
+#include <miscadmin.h>
+#include <utils/timestamp.h>
+#include <utils/tuplestore.h>
+
+#include "period.h"
+#include "temporaltypes.h"
+#include "temporal_aggfuncs.h"
+
+/* Start of the bucket containing the timestamp */
+
+static TimestampTz
+timestamp_bucket(TimestampTz t, int64 size, TimestampTz torigin)
+{
+	return torigin + timebin_number(t - torigin, size) * size;
+}
+
+PG_FUNCTION_INFO_V1(timestamp_time_bucket);
+
+PGDLLEXPORT Datum
+timestamp_time_bucket(PG_FUNCTION_ARGS)
+{
+	TimestampTz t = PG_GETARG_TIMESTAMPTZ(0);
+	Interval *duration = PG_GETARG_INTERVAL_P(1);
+	TimestampTz torigin = PG_GETARG_TIMESTAMPTZ(2);
+	int64 size = bucket_interval_size(duration);
+	PG_RETURN_TIMESTAMPTZ(timestamp_bucket(t, size, torigin));
+}
+
+PG_FUNCTION_INFO_V1(period_time_bucket);
+
+PGDLLEXPORT Datum
+period_time_bucket(PG_FUNCTION_ARGS)
+{
+	Period *p = PG_GETARG_PERIOD(0);
+	Interval *duration = PG_GETARG_INTERVAL_P(1);
+	TimestampTz torigin = PG_GETARG_TIMESTAMPTZ(2);
+	int64 size = bucket_interval_size(duration);
+	PG_RETURN_TIMESTAMPTZ(timestamp_bucket(p->lower, size, torigin));
+}
+
+/*****************************************************************************/
+
+/* Fragments of a temporal value, each one with the start of its bucket */
+
+typedef struct
+{
+	TimestampTz *buckets;
+	Temporal **fragments;
+	int count;
+	int maxcount;
+} SplitFragments;
+
+static void
+split_fragments_add(SplitFragments *state, TimestampTz bucket,
+	Temporal *fragment)
+{
+	if (state->count == state->maxcount)
+	{
+		state->maxcount *= 2;
+		state->buckets = repalloc(state->buckets,
+			sizeof(TimestampTz) * state->maxcount);
+		state->fragments = repalloc(state->fragments,
+			sizeof(Temporal *) * state->maxcount);
+	}
+	state->buckets[state->count] = bucket;
+	state->fragments[state->count++] = fragment;
+}
+
+/* Instants of the fragment of a sequence being built */
+
+typedef struct
+{
+	TemporalInst **instants;
+	bool *tofree;
+	int count;
+	bool lower_inc;
+} SplitBuffer;
+
+static void
+split_buffer_add(SplitBuffer *buf, TemporalInst *inst, bool tofree)
+{
+	buf->instants[buf->count] = inst;
+	buf->tofree[buf->count++] = tofree;
+}
+
+/* Add the fragment in the buffer to the state and empty the buffer */
+
+static void
+split_buffer_flush(SplitFragments *state, SplitBuffer *buf, TimestampTz bucket,
+	bool upper_inc, bool linear)
+{
+	/* A single instant is a fragment only when both bounds are inclusive */
+	if (buf->count > 1 || (buf->count == 1 && buf->lower_inc && upper_inc))
+	{
+		TemporalSeq *seq = temporalseq_from_temporalinstarr_trusted(
+			buf->instants, buf->count, buf->lower_inc, upper_inc, linear, true);
+		split_fragments_add(state, bucket, (Temporal *) seq);
+	}
+	for (int i = 0; i < buf->count; i++)
+		if (buf->tofree[i])
+			pfree(buf->instants[i]);
+	buf->count = 0;
+}
+
+/*
+ * Split a sequence at the boundaries of the buckets. The instants at the
+ * boundaries are computed from the segments that contain them.
+ */
+static void
+temporalseq_time_split(SplitFragments *state, TemporalSeq *seq, int64 size,
+	TimestampTz torigin)
+{
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	TimestampTz bucket = timestamp_bucket(inst1->t, size, torigin);
+	if (seq->count == 1)
+	{
+		split_fragments_add(state, bucket, (Temporal *) temporalseq_copy(seq));
+		return;
+	}
+
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	/* A segment adds at most one instant to a fragment since each cut of a
+	 * segment starts a new fragment */
+	SplitBuffer buf;
+	buf.instants = palloc(sizeof(TemporalInst *) * (seq->count + 1));
+	buf.tofree = palloc(sizeof(bool) * (seq->count + 1));
+	buf.count = 0;
+	buf.lower_inc = seq->period.lower_inc;
+	split_buffer_add(&buf, inst1, false);
+	for (int i = 1; i < seq->count; i++)
+	{
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
+		TimestampTz next = bucket + size;
+		while (next < inst2->t)
+		{
+			TemporalInst *cut = temporalseq_at_timestamp1(inst1, inst2,
+				linear, next);
+			split_buffer_add(&buf, cut, false);
+			split_buffer_flush(state, &buf, bucket, false, linear);
+			buf.lower_inc = true;
+			split_buffer_add(&buf, cut, true);
+			bucket = next;
+			next += size;
+		}
+		if (next == inst2->t)
+		{
+			/* With stepwise interpolation the fragment keeps the previous
+			 * value until its exclusive upper bound */
+			TemporalInst *last = linear ? inst2 :
+				temporalinst_make(temporalinst_value(inst1), inst2->t,
+					inst1->valuetypid);
+			split_buffer_add(&buf, last, ! linear);
+			split_buffer_flush(state, &buf, bucket, false, linear);
+			buf.lower_inc = true;
+			bucket = next;
+		}
+		split_buffer_add(&buf, inst2, false);
+		inst1 = inst2;
+	}
+	split_buffer_flush(state, &buf, bucket, seq->period.upper_inc, linear);
+	pfree(buf.instants); pfree(buf.tofree);
+}
+
+static void
+temporal_time_split(SplitFragments *state, Temporal *temp, int64 size,
+	TimestampTz torigin)
+{
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+	{
+		TemporalInst *inst = (TemporalInst *) temp;
+		split_fragments_add(state, timestamp_bucket(inst->t, size, torigin),
+			(Temporal *) temporalinst_copy(inst));
+	}
+	else if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *) temp;
+		TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
+		int k = 0;
+		TimestampTz bucket = 0; /* Make compiler quiet */
+		for (int i = 0; i < ti->count; i++)
+		{
+			TemporalInst *inst = temporali_inst_n(ti, i);
+			TimestampTz bucket1 = timestamp_bucket(inst->t, size, torigin);
+			if (k > 0 && bucket1 != bucket)
+			{
+				split_fragments_add(state, bucket, (Temporal *)
+					temporali_from_temporalinstarr(instants, k));
+				k = 0;
+			}
+			bucket = bucket1;
+			instants[k++] = inst;
+		}
+		split_fragments_add(state, bucket, (Temporal *)
+			temporali_from_temporalinstarr(instants, k));
+		pfree(instants);
+	}
+	else if (temp->duration == TEMPORALSEQ)
+		temporalseq_time_split(state, (TemporalSeq *) temp, size, torigin);
+	else /* temp->duration == TEMPORALS */
+	{
+		/* The fragments of the sequences in the same bucket are consecutive
+		 * and they are merged into a single sequence set */
+		TemporalS *ts = (TemporalS *) temp;
+		SplitFragments seqstate;
+		seqstate.count = 0;
+		seqstate.maxcount = ts->count * 2;
+		seqstate.buckets = palloc(sizeof(TimestampTz) * seqstate.maxcount);
+		seqstate.fragments = palloc(sizeof(Temporal *) * seqstate.maxcount);
+		for (int i = 0; i < ts->count; i++)
+			temporalseq_time_split(&seqstate, temporals_seq_n(ts, i), size,
+				torigin);
+		bool linear = MOBDB_FLAGS_GET_LINEAR(ts->flags);
+		for (int i = 0; i < seqstate.count; )
+		{
+			int j = i + 1;
+			while (j < seqstate.count &&
+				seqstate.buckets[j] == seqstate.buckets[i])
+				j++;
+			if (j == i + 1)
+				split_fragments_add(state, seqstate.buckets[i],
+					seqstate.fragments[i]);
+			else
+			{
+				TemporalS *fragment = temporals_from_temporalseqarr_trusted(
+					(TemporalSeq **) &seqstate.fragments[i], j - i, linear,
+					true);
+				split_fragments_add(state, seqstate.buckets[i],
+					(Temporal *) fragment);
+				for (int k = i; k < j; k++)
+					pfree(seqstate.fragments[k]);
+			}
+			i = j;
+		}
+		pfree(seqstate.buckets); pfree(seqstate.fragments);
+	}
+}
+
+/*
+ * Split a temporal value into fragments according to time buckets. The
+ * function returns one row per bucket in which the temporal value is
+ * defined, composed of the start of the bucket and the fragment of the
+ * temporal value in the bucket.
+ */
+
+PG_FUNCTION_INFO_V1(temporal_time_split_srf);
+
+PGDLLEXPORT Datum
+temporal_time_split_srf(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Interval *duration = PG_GETARG_INTERVAL_P(1);
+	TimestampTz torigin = PG_GETARG_TIMESTAMPTZ(2);
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext oldcontext;
+
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo) ||
+		!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("set-valued function called in context that cannot accept a set")));
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("function returning record called in context "
+				"that cannot accept type record")));
+	int64 size = bucket_interval_size(duration);
+
+	SplitFragments state;
+	state.count = 0;
+	state.maxcount = 16;
+	state.buckets = palloc(sizeof(TimestampTz) * state.maxcount);
+	state.fragments = palloc(sizeof(Temporal *) * state.maxcount);
+	temporal_time_split(&state, temp, size, torigin);
+
+	oldcontext = MemoryContextSwitchTo(rsinfo->econtext->ecxt_per_query_memory);
+	tupdesc = BlessTupleDesc(CreateTupleDescCopy(tupdesc));
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+	MemoryContextSwitchTo(oldcontext);
+
+	for (int i = 0; i < state.count; i++)
+	{
+		Datum values[2];
+		bool isnull[2] = {false, false};
+		values[0] = TimestampTzGetDatum(state.buckets[i]);
+		values[1] = PointerGetDatum(state.fragments[i]);
+		tuplestore_putvalues(tupstore, tupdesc, values, isnull);
+		pfree(state.fragments[i]);
+	}
+	pfree(state.buckets); pfree(state.fragments);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_NULL();
+}
+
+
+/*****************************************************************************
+ * Time sampling
+ *****************************************************************************/
+
+/*
+ * Sample a sequence at the timestamps of the grid in a single forward pass
+ * over its segments. Returns the number of instants added to the array.
+ */
+static int
+temporalseq_tsample(TemporalInst **instants, TemporalSeq *seq, int64 size,
+	TimestampTz torigin)
+{
+	TimestampTz t = timestamp_bucket(seq->period.lower, size, torigin);
+	if (t < seq->period.lower || ! seq->period.lower_inc)
+		t += size;
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	int k = 0;
+	if (seq->count == 1)
+	{
+		if (t == inst1->t)
+			instants[k++] = temporalinst_copy(inst1);
+		return k;
+	}
+
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	int i = 1;
+	TemporalInst *inst2 = temporalseq_inst_n(seq, i);
+	while (t < seq->period.upper ||
+		(t == seq->period.upper && seq->period.upper_inc))
+	{
+		while (inst2->t < t)
+		{
+			inst1 = inst2;
+			inst2 = temporalseq_inst_n(seq, ++i);
+		}
+		instants[k++] = temporalseq_at_timestamp1(inst1, inst2, linear, t);
+		t += size;
+	}
+	return k;
+}
+
+static Temporal *
+temporal_tsample_internal(Temporal *temp, int64 size, TimestampTz torigin)
+{
+	/* The sequences of a sequence set are disjoint, the number of grid
+	 * timestamps in the period of the value is thus an upper bound */
+	Period p;
+	temporal_period(&p, temp);
+	int maxcount = (int) ((p.upper - p.lower) / size) + 2;
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * maxcount);
+	int k = 0;
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST || temp->duration == TEMPORALI)
+	{
+		/* Only the instants on the grid are kept */
+		int count = temp->duration == TEMPORALINST ? 1 :
+			((TemporalI *) temp)->count;
+		for (int i = 0; i < count; i++)
+		{
+			TemporalInst *inst = temp->duration == TEMPORALINST ?
+				(TemporalInst *) temp : temporali_inst_n((TemporalI *) temp, i);
+			if (timestamp_bucket(inst->t, size, torigin) == inst->t)
+				instants[k++] = temporalinst_copy(inst);
+		}
+	}
+	else if (temp->duration == TEMPORALSEQ)
+		k = temporalseq_tsample(instants, (TemporalSeq *) temp, size, torigin);
+	else /* temp->duration == TEMPORALS */
+	{
+		TemporalS *ts = (TemporalS *) temp;
+		for (int i = 0; i < ts->count; i++)
+			k += temporalseq_tsample(&instants[k], temporals_seq_n(ts, i),
+				size, torigin);
+	}
+	Temporal *result = NULL;
+	if (k > 0)
+		result = (Temporal *) temporali_from_temporalinstarr(instants, k);
+	for (int i = 0; i < k; i++)
+		pfree(instants[i]);
+	pfree(instants);
+	return result;
+}
+
+/*
+ * Sample a temporal value at the timestamps of a regular grid, that is, at
+ * the starts of the buckets of the given duration aligned with the origin.
+ * The result is an instant set, or null if the temporal value is not
+ * defined at any timestamp of the grid. This replaces calling
+ * valueAtTimestamp for each timestamp generated with generate_series, which
+ * searches the instants of the value from scratch at every call.
+ */
+
+PG_FUNCTION_INFO_V1(temporal_tsample);
+
+PGDLLEXPORT Datum
+temporal_tsample(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	Interval *duration = PG_GETARG_INTERVAL_P(1);
+	TimestampTz torigin = PG_GETARG_TIMESTAMPTZ(2);
+	int64 size = bucket_interval_size(duration);
+	Temporal *result = temporal_tsample_internal(temp, size, torigin);
+	PG_FREE_IF_COPY(temp, 0);
+	if (result == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************/
@@ -13,19 +13,34 @@
 #include "temporal_util.h"
 
 #include <assert.h>
+#include <float.h>
+#include <math.h>
 #include <catalog/pg_collation.h>
+#include <common/int.h>
+#include <miscadmin.h>
+#include <pgtime.h>
 #include <utils/builtins.h>
+#include <utils/datetime.h>
+#include <utils/guc.h>
 #include <utils/lsyscache.h>
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
 #include <utils/varlena.h>
 
 #include "period.h"
 #include "temporal.h"
+#include "temporal_cache.h"
+#include "temporal_stats.h"
+#include "time_gist.h"
 #include "oidcache.h"
 #include "doublen.h"
 
 #ifdef WITH_POSTGIS
 #include "tpoint.h"
+#include "tpoint_gin.h"
+#include "tpoint_gist.h"
+#include "tpoint_out.h"
+#include "tpoint_distance.h"
 #include "tpoint_spatialfuncs.h"
 #endif
 
@@ -43,8 +58,50 @@ void
 _PG_init(void)
 {
 	/* elog(WARNING, "This is MobilityDB."); */
+	oidcache_init();
+	DefineCustomBoolVariable("mobilitydb.precompute_trajectory",
+		"Store the trajectory of temporal point sequences in the values.",
+		"When disabled, the trajectory of new sequences is computed when "
+		"it is needed, which reduces their size.",
+		&precompute_trajectory, true, PGC_USERSET, 0, NULL, NULL, NULL);
+	DefineCustomBoolVariable("mobilitydb.precompute_summary",
+		"Store the integral and the length of temporal sequences in the values.",
+		"When enabled, the integral, the time-weighted average and the length "
+		"of new sequences are read from the values instead of being computed.",
+		&precompute_summary, false, PGC_USERSET, 0, NULL, NULL, NULL);
+	DefineCustomIntVariable("mobilitydb.detoast_cache_size",
+		"Maximum number of temporal values kept detoasted during a query.",
+		"Temporal values stored out of line are detoasted once per query by "
+		"the functions that use the cache. The value 0 disables the cache.",
+		&detoast_cache_size, 8, 0, TEMPORAL_CACHE_MAX, PGC_USERSET, 0,
+		NULL, NULL, NULL);
+	DefineCustomIntVariable("mobilitydb.gist_max_periods",
+		"Maximum number of periods of the keys of the multi-period GiST indexes.",
+		"Larger values make the indexes larger and their scans more selective.",
+		&gist_max_periods, 8, 1, 256, PGC_USERSET, 0, NULL, NULL, NULL);
+	DefineCustomBoolVariable("mobilitydb.stats",
+		"Update the counters reported by mobdb_stat_activity and mobdb_stat_index.",
+		"The counters are only available when the extension is compiled with "
+		"WITH_STATS, otherwise this setting has no effect.",
+		&mobdb_stats_enabled, true, PGC_USERSET, 0, NULL, NULL, NULL);
 #ifdef WITH_POSTGIS
 	temporalgeom_init();
+	DefineCustomIntVariable("mobilitydb.gin_max_boxes",
+		"Maximum number of boxes indexed for each temporal point by GIN indexes.",
+		"Larger values make the indexes larger and their scans more selective.",
+		&gin_max_boxes, 16, 1, 1024, PGC_USERSET, 0, NULL, NULL, NULL);
+	DefineCustomRealVariable("mobilitydb.gist_time_weight",
+		"Units of space equivalent to one second in the GiST indexes of temporal points.",
+		"The extents of the boxes along space and time are combined with this "
+		"weight when choosing where to insert and how to split the entries.",
+		&gist_time_weight, 1.0, 0.0, DBL_MAX, PGC_USERSET, 0, NULL, NULL, NULL);
+	DefineCustomEnumVariable("mobilitydb.geodetic_distance",
+		"Model of the Earth used for distances between temporal geography points.",
+		"Distances are computed on the WGS 84 spheroid or, which is faster but "
+		"less accurate, on a sphere. Only superusers can change it since the "
+		"distance functions are immutable and may be used in indexes.",
+		&geodetic_distance, GEODETIC_SPHEROID, geodetic_distance_options,
+		PGC_SUSET, 0, NULL, NULL, NULL);
 #endif
 }
 
@@ -67,62 +124,304 @@ double_pad(size_t size)
 		return size;
 }
 
+/*
+ * Returns the position of a point on a Z-order (Morton) curve over an 
+ * extent of up to 3 dimensions. Each coordinate is quantized into 63 / ndims
+ * bits after its normalization into the extent, and the bits are 
+ * interleaved from the most significant one.
+ */
+int64
+zorder_key(const double *values, const double *mins, const double *maxs, 
+	int ndims)
+{
+	assert(ndims <= 3);
+	if (ndims == 0)
+		return 0;
+	int bits = 63 / ndims;
+	uint64 cells = ((uint64) 1 << bits) - 1;
+	uint64 coords[3];
+	for (int d = 0; d < ndims; d++)
+	{
+		double width = maxs[d] - mins[d];
+		double ratio = width > 0 ? (values[d] - mins[d]) / width : 0;
+		/* Values outside of the extent, e.g., when the extent is estimated,
+		 * are clamped to its borders */
+		if (! (ratio > 0))
+			ratio = 0;
+		else if (ratio > 1)
+			ratio = 1;
+		coords[d] = (uint64) (ratio * (double) cells);
+	}
+	uint64 result = 0;
+	for (int b = bits - 1; b >= 0; b--)
+		for (int d = 0; d < ndims; d++)
+			result = (result << 1) | ((coords[d] >> b) & 1);
+	return (int64) result;
+}
+
+/*
+ * Returns the largest float4 that is less than or equal to the double.
+ * Used for storing bounds in float4 while keeping the boxes conservative.
+ */
+float4
+float4_round_down(double d)
+{
+	float4 result = (float4) d;
+	if ((double) result <= d)
+		return result;
+	return nextafterf(result, -FLT_MAX);
+}
+
+/*
+ * Returns the smallest float4 that is greater than or equal to the double
+ */
+float4
+float4_round_up(double d)
+{
+	float4 result = (float4) d;
+	if ((double) result >= d)
+		return result;
+	return nextafterf(result, FLT_MAX);
+}
+
+/*
+ * Returns the number of seconds from tmin to tmax rounded up, or -1 when 
+ * the bounds are infinite or the number does not fit in an int32
+ */
+int32
+timestamp_span_seconds(TimestampTz tmin, TimestampTz tmax)
+{
+	if (TIMESTAMP_NOT_FINITE(tmin) || TIMESTAMP_NOT_FINITE(tmax))
+		return -1;
+	int64 secs = (tmax - tmin + USECS_PER_SEC - 1) / USECS_PER_SEC;
+	return secs > PG_INT32_MAX ? -1 : (int32) secs;
+}
+
+/*
+ * Returns the upper bound of a span computed by timestamp_span_seconds, which
+ * is greater than or equal to the original upper bound
+ */
+TimestampTz
+timestamp_span_upper(TimestampTz tmin, int32 span)
+{
+	if (span < 0)
+		return DT_NOEND;
+	return tmin + (TimestampTz) span * USECS_PER_SEC;
+}
+
+/*
+ * Shift a timestamp by an interval. An interval without months and days is
+ * a fixed number of microseconds, which is added directly instead of going
+ * through the calendar computations of timestamptz_pl_interval.
+ */
+TimestampTz
+timestamp_shift(TimestampTz t, Interval *interval)
+{
+	if (interval->month == 0 && interval->day == 0 && ! TIMESTAMP_NOT_FINITE(t))
+	{
+		TimestampTz result;
+		if (pg_add_s64_overflow(t, interval->time, &result) ||
+			! IS_VALID_TIMESTAMP(result))
+			ereport(ERROR, (errcode(ERRCODE_DATETIME_VALUE_OUT_OF_RANGE),
+				errmsg("timestamp out of range")));
+		return result;
+	}
+	return DatumGetTimestampTz(DirectFunctionCall2(timestamptz_pl_interval,
+		TimestampTzGetDatum(t), PointerGetDatum(interval)));
+}
+
+/*
+ * Scale by a factor the distance of a timestamp from an origin
+ */
+TimestampTz
+timestamp_tscale(TimestampTz t, TimestampTz origin, double scale)
+{
+	return origin + (TimestampTz) rint((double) (t - origin) * scale);
+}
+
+/*****************************************************************************
+ * Base type descriptors
+ * The properties and the comparison functions of a base type are resolved
+ * once per backend and kept in a small cache, so that functions looping over
+ * the instants of a temporal value can fetch the descriptor of its base type
+ * once instead of dispatching on the Oid for every instant.
+ *****************************************************************************/
+
+static bool
+base_byval_eq(Datum l, Datum r)
+{
+	return l == r;
+}
+
+static bool
+base_bool_lt(Datum l, Datum r)
+{
+	return DatumGetBool(l) < DatumGetBool(r);
+}
+
+static bool
+base_int4_lt(Datum l, Datum r)
+{
+	return DatumGetInt32(l) < DatumGetInt32(r);
+}
+
+static bool
+base_float8_lt(Datum l, Datum r)
+{
+	return DatumGetFloat8(l) < DatumGetFloat8(r);
+}
+
+static bool
+base_text_eq(Datum l, Datum r)
+{
+	return text_eq(DatumGetTextP(l), DatumGetTextP(r));
+}
+
+static bool
+base_text_lt(Datum l, Datum r)
+{
+	return text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) < 0;
+}
+
+static bool
+base_double2_eq(Datum l, Datum r)
+{
+	return double2_eq((double2 *)DatumGetPointer(l), (double2 *)DatumGetPointer(r));
+}
+
+static bool
+base_double3_eq(Datum l, Datum r)
+{
+	return double3_eq((double3 *)DatumGetPointer(l), (double3 *)DatumGetPointer(r));
+}
+
+static bool
+base_double4_eq(Datum l, Datum r)
+{
+	return double4_eq((double4 *)DatumGetPointer(l), (double4 *)DatumGetPointer(r));
+}
+
+#ifdef WITH_POSTGIS
+static bool
+base_geometry_lt(Datum l, Datum r)
+{
+	return DatumGetBool(call_function2(lwgeom_lt, l, r));
+}
+
+static bool
+base_geography_lt(Datum l, Datum r)
+{
+	return DatumGetBool(call_function2(geography_lt, l, r));
+}
+#endif
+
+/* The base types of the temporal types and TimestampTz */
+#define MAX_BASE_TYPES 11
+
+static BaseTypeInfo _base_types[MAX_BASE_TYPES];
+static int _base_types_count = 0;
+
+static void
+base_type_info_fill(BaseTypeInfo *info, Oid type)
+{
+	ensure_temporal_base_type_all(type);
+	memset(info, 0, sizeof(BaseTypeInfo));
+	info->type = type;
+	if (type == BOOLOID)
+	{
+		info->byval = true; info->typlen = 1;
+		info->eq = &base_byval_eq; info->lt = &base_bool_lt;
+	}
+	else if (type == INT4OID)
+	{
+		info->byval = true; info->typlen = 4;
+		info->eq = &base_byval_eq; info->lt = &base_int4_lt;
+	}
+	else if (type == FLOAT8OID)
+	{
+		info->byval = true; info->typlen = 8; info->linear = true;
+		info->eq = &base_byval_eq; info->lt = &base_float8_lt;
+	}
+	else if (type == TIMESTAMPTZOID)
+	{
+		info->byval = true; info->typlen = 8;
+		info->eq = &base_byval_eq;
+	}
+	else if (type == TEXTOID)
+	{
+		info->typlen = -1;
+		info->eq = &base_text_eq; info->lt = &base_text_lt;
+	}
+	else if (type == type_oid(T_DOUBLE2))
+	{
+		info->typlen = 16; info->linear = true;
+		info->eq = &base_double2_eq;
+	}
+	else if (type == type_oid(T_DOUBLE3))
+	{
+		info->typlen = 24; info->linear = true;
+		info->eq = &base_double3_eq;
+	}
+	else if (type == type_oid(T_DOUBLE4))
+	{
+		info->typlen = 32; info->linear = true;
+		info->eq = &base_double4_eq;
+	}
+#ifdef WITH_POSTGIS
+	else if (type == type_oid(T_GEOMETRY))
+	{
+		info->typlen = -1; info->linear = true;
+		info->eq = &datum_point_eq; info->lt = &base_geometry_lt;
+	}
+	else if (type == type_oid(T_GEOGRAPHY))
+	{
+		info->typlen = -1; info->linear = true;
+		info->eq = &datum_point_eq; info->lt = &base_geography_lt;
+	}
+#endif
+}
+
+/* Get the descriptor of a base type */
+
+const BaseTypeInfo *
+base_type_info(Oid type)
+{
+	for (int i = 0; i < _base_types_count; i++)
+		if (_base_types[i].type == type)
+			return &_base_types[i];
+	/* The Oids of the types of the extension change when it is created again
+	 * in the same session, which may fill the array */
+	if (_base_types_count == MAX_BASE_TYPES)
+		elog(ERROR, "too many base types: %u", type);
+	/* The function raises an error for unknown types */
+	base_type_info_fill(&_base_types[_base_types_count], type);
+	return &_base_types[_base_types_count++];
+}
+
 /* 
  * Is the type passed by value?
  * This function is called only for the base types of the temporal types
  * and for TimestampTz. To avoid a call of the slow function get_typbyval 
- * (which makes a lookup call), the known base types are explicitly enumerated.
+ * (which makes a lookup call), the value is taken from the descriptor.
  */
 
 bool
 get_typbyval_fast(Oid type)
 {
-	ensure_temporal_base_type_all(type);
-	bool result = false;
-	if (type == BOOLOID || type == INT4OID || type == FLOAT8OID || 
-		type == TIMESTAMPTZOID)
-		result = true;
-	else if (type == type_oid(T_DOUBLE2) || type == TEXTOID)
-		result = false;
-#ifdef WITH_POSTGIS
-	else if (type == type_oid(T_GEOMETRY) || type == type_oid(T_GEOGRAPHY) ||
-			 type == type_oid(T_DOUBLE3) || type == type_oid(T_DOUBLE4))
-		result = false;
-#endif
-	return result;
+	return base_type_info(type)->byval;
 }
 
 /* 
  * Get length of type
  * This function is called only for the base types of the temporal types
  * and for TimestampTz. To avoid a call of the slow function get_typlen 
- * (which makes a lookup call), the known base types are explicitly enumerated.
+ * (which makes a lookup call), the value is taken from the descriptor.
  */
 
 int
 get_typlen_fast(Oid type)
 {
-	ensure_temporal_base_type_all(type);
-	int result = 0;
-	if (type == BOOLOID)
-		result = 1;
-	else if (type == INT4OID)
-		result = 4;
-	else if (type == FLOAT8OID || type == TIMESTAMPTZOID)
-		result = 8;
-	else if (type == type_oid(T_DOUBLE2))
-		result = 16;
-	else if (type == TEXTOID)
-		result = -1;
-#ifdef WITH_POSTGIS
-	else if (type == type_oid(T_GEOMETRY) || type == type_oid(T_GEOGRAPHY))
-		result = -1;
-	else if (type == type_oid(T_DOUBLE3))
-		result = 24;
-	else if (type == type_oid(T_DOUBLE4))
-		result = 32;
-#endif
-	return result;
+	return base_type_info(type)->typlen;
 }
 
 /* Copy a Datum if it is passed by reference */
@@ -130,11 +429,12 @@ get_typlen_fast(Oid type)
 Datum
 datum_copy(Datum value, Oid type)
 {
+	const BaseTypeInfo *info = base_type_info(type);
 	/* For types passed by value */
-	if (get_typbyval_fast(type))
+	if (info->byval)
 		return value;
 	/* For types passed by reference */
-	int typlen = get_typlen_fast(type);
+	int typlen = info->typlen;
 	size_t value_size = typlen != -1 ? (unsigned int) typlen : VARSIZE(value);
 	void *result = palloc0(value_size);
 	memcpy(result, DatumGetPointer(value), value_size);
@@ -153,6 +453,118 @@ datum_double(Datum d, Oid valuetypid)
 	return result;
 }
 
+/*
+ * Create a short-lived memory context, child of the current one, in which
+ * the intermediate values of an operation are allocated. The caller switches
+ * back to its own context before building the result and then deletes the
+ * arena, which releases all the intermediate values at once instead of
+ * freeing them one by one.
+ *
+ * The arena is created for every call of the lifted functions, most of which
+ * are on values with a few instants, so it starts with a small block that
+ * grows with the number of intermediate values.
+ */
+
+MemoryContext
+temporal_arena_create(void)
+{
+	return AllocSetContextCreate(CurrentMemoryContext,
+		"MobilityDB temporary context", ALLOCSET_SMALL_SIZES);
+}
+
+/* Delete an arena, counting its size when the statistics are enabled */
+
+void
+temporal_arena_delete(MemoryContext arena)
+{
+#ifdef WITH_STATS
+	MemoryContextCounters totals;
+	memset(&totals, 0, sizeof(MemoryContextCounters));
+	arena->methods->stats(arena, NULL, NULL, &totals);
+	MOBDB_STAT_ADD(lifting_bytes, totals.totalspace);
+#endif
+	MemoryContextDelete(arena);
+}
+
+/*****************************************************************************
+ * Abbreviated keys for sortsupport
+ * The abbreviated key of a value is an unsigned integer whose order is the
+ * order of the leading component of the B-tree comparison of the value, for
+ * example, the lower bound of a period. Two values whose abbreviated keys
+ * differ compare in the same way as their keys, the other ones are compared
+ * with the full comparator. Abbreviated keys require 8-byte datums.
+ *****************************************************************************/
+
+/* Abbreviated key of a timestamp, which flips the sign bit */
+
+Datum
+timestamp_abbrev_key(TimestampTz t)
+{
+	return (Datum) ((uint64) t ^ ((uint64) 1 << 63));
+}
+
+/*
+ * Abbreviated key of a double, which sets the sign bit of positive values
+ * and flips all the bits of negative ones. Negative zero is mapped to zero
+ * since both compare equal. As for the comparison of the bounding boxes,
+ * NaN values are not totally ordered.
+ */
+
+Datum
+double_abbrev_key(double d)
+{
+	if (d == 0.0)
+		d = 0.0;
+	uint64 bits;
+	memcpy(&bits, &d, sizeof(uint64));
+	if (bits & ((uint64) 1 << 63))
+		bits = ~bits;
+	else
+		bits |= ((uint64) 1 << 63);
+	return (Datum) bits;
+}
+
+static int
+abbrev_key_cmp(Datum x, Datum y, SortSupport ssup)
+{
+	if (x < y)
+		return -1;
+	if (x > y)
+		return 1;
+	return 0;
+}
+
+/*
+ * Computing the keys is cheap compared to the comparisons it saves, and
+ * the values with equal keys are still compared with the full comparator,
+ * so that abbreviation is never aborted
+ */
+static bool
+abbrev_key_abort(int memtupcount, SortSupport ssup)
+{
+	return false;
+}
+
+/*
+ * Use abbreviated keys computed by the converter when the caller asks for
+ * them. The comparator already set in the argument becomes the full
+ * comparator.
+ */
+
+void
+sortsupport_set_abbrev(SortSupport ssup, Datum (*converter)(Datum, SortSupport))
+{
+#if SIZEOF_DATUM == 8
+	if (ssup->abbreviate)
+	{
+		ssup->abbrev_full_comparator = ssup->comparator;
+		ssup->comparator = abbrev_key_cmp;
+		ssup->abbrev_converter = converter;
+		ssup->abbrev_abort = abbrev_key_abort;
+	}
+#endif
+}
+
 /*****************************************************************************
  * Call PostgreSQL functions
  *****************************************************************************/
@@ -209,6 +621,145 @@ call_recv(Oid type, StringInfo buf)
 	return ReceiveFunctionCall(&recvfuncinfo, buf, basetype, -1);
 }
 
+/*****************************************************************************
+ * Text output of the base values
+ *
+ * The output functions of the temporal types write all their instants into
+ * a single buffer. The timestamps, the floats, and the points are formatted
+ * natively with the same result as their output functions, the other base
+ * types go through their output function, which is looked up once.
+ *****************************************************************************/
+
+/*
+ * Offset with respect to UTC of the session time zone between the bounds
+ * lower and upper, which is kept between the timestamps written because the
+ * instants of a temporal value are in increasing order
+ */
+static struct
+{
+	pg_tz *tz;
+	TimestampTz lower;
+	TimestampTz upper;
+	long int gmtoff;
+	int isdst;
+} tzoffset_cache = {NULL, 0, 0, 0, 0};
+
+static bool
+timestamptz_gmtoff(TimestampTz t, long int *gmtoff, int *isdst)
+{
+	if (tzoffset_cache.tz != session_timezone || t < tzoffset_cache.lower ||
+		t >= tzoffset_cache.upper)
+	{
+		/* Seconds since the Unix epoch, rounded towards minus infinity */
+		int64 secs = t / USECS_PER_SEC;
+		if (t % USECS_PER_SEC < 0)
+			secs--;
+		pg_time_t utime = (pg_time_t) secs +
+			(POSTGRES_EPOCH_JDATE - UNIX_EPOCH_JDATE) * SECS_PER_DAY;
+		long int after_gmtoff;
+		int after_isdst;
+		pg_time_t boundary;
+		int found = pg_next_dst_boundary(&utime, &tzoffset_cache.gmtoff,
+			&tzoffset_cache.isdst, &boundary, &after_gmtoff, &after_isdst,
+			session_timezone);
+		if (found < 0)
+		{
+			tzoffset_cache.tz = NULL;
+			return false;
+		}
+		tzoffset_cache.tz = session_timezone;
+		tzoffset_cache.lower = t;
+		tzoffset_cache.upper = (found == 0) ? DT_NOEND :
+			time_t_to_timestamptz(boundary);
+	}
+	*gmtoff = tzoffset_cache.gmtoff;
+	*isdst = tzoffset_cache.isdst;
+	return true;
+}
+
+/**
+ * @brief Append a timestamp to the buffer as timestamptz_out does. The
+ *		offset of the time zone is only looked up when the timestamp
+ *		crosses a daylight saving time boundary.
+ */
+void
+timestamptz_to_string_buf(StringInfo buf, TimestampTz t)
+{
+	long int gmtoff;
+	int isdst;
+	struct pg_tm tt, *tm = &tt;
+	fsec_t fsec;
+	/* The ISO style does not print the abbreviation of the time zone */
+	if (DateStyle != USE_ISO_DATES || TIMESTAMP_NOT_FINITE(t) ||
+		! timestamptz_gmtoff(t, &gmtoff, &isdst) ||
+		! IS_VALID_TIMESTAMP(t + gmtoff * USECS_PER_SEC) ||
+		timestamp2tm(t + gmtoff * USECS_PER_SEC, NULL, tm, &fsec, NULL, NULL) != 0)
+	{
+		char *str = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(t));
+		appendStringInfoString(buf, str);
+		pfree(str);
+		return;
+	}
+	tm->tm_isdst = isdst;
+	enlargeStringInfo(buf, MAXDATELEN + 1);
+	EncodeDateTime(tm, fsec, true, (int) -gmtoff, NULL, DateStyle,
+		buf->data + buf->len);
+	buf->len += strlen(buf->data + buf->len);
+}
+
+/*
+ * Output function of the last base type written that is not formatted
+ * natively
+ */
+static Oid valueout_typid = InvalidOid;
+static FmgrInfo valueout_info;
+
+/**
+ * @brief Append a base value to the buffer as the output function of its
+ *		type does
+ */
+void
+datum_to_string_buf(StringInfo buf, Oid type, Datum value)
+{
+	if (type == BOOLOID)
+		appendStringInfoChar(buf, DatumGetBool(value) ? 't' : 'f');
+	else if (type == INT4OID)
+	{
+		char str[12];
+		pg_ltoa(DatumGetInt32(value), str);
+		appendStringInfoString(buf, str);
+	}
+	else if (type == FLOAT8OID)
+	{
+		char *str = float8out_internal(DatumGetFloat8(value));
+		appendStringInfoString(buf, str);
+		pfree(str);
+	}
+	else if (type == TEXTOID)
+	{
+		text *txt = DatumGetTextPP(value);
+		appendBinaryStringInfo(buf, VARDATA_ANY(txt), VARSIZE_ANY_EXHDR(txt));
+	}
+#ifdef WITH_POSTGIS
+	else if (type == type_oid(T_GEOMETRY) || type == type_oid(T_GEOGRAPHY))
+		point_hexewkb_buf(buf, value);
+#endif
+	else
+	{
+		if (type != valueout_typid)
+		{
+			Oid outfunc;
+			bool isvarlena;
+			getTypeOutputInfo(type, &outfunc, &isvarlena);
+			fmgr_info_cxt(outfunc, &valueout_info, TopMemoryContext);
+			valueout_typid = type;
+		}
+		char *str = OutputFunctionCall(&valueout_info, value);
+		appendStringInfoString(buf, str);
+		pfree(str);
+	}
+}
+
 /* Call PostgreSQL function with 1 to 4 arguments */
 
 Datum
@@ -247,6 +798,45 @@ call_function2(PGFunction func, Datum arg1, Datum arg2)
 	return result;
 }
 
+/*
+ * Memory context of the function call information that persists across
+ * calls of call_function2_cached
+ */
+static MemoryContext fncache_context = NULL;
+
+/*
+ * Call a PostgreSQL function with a function call information that persists
+ * across calls. The function can keep a cache in it, e.g., PostGIS keeps the
+ * prepared geometries used by the functions contains, containsproperly,
+ * covers, and intersects, or the projections used by the function transform.
+ * The cache is thus built once for all the consecutive calls with the same
+ * arguments, as when a temporal point is compared at each instant or
+ * segment with a constant geometry, and it is released only at the end of
+ * the backend. The function call information is typically a static variable
+ * of the calling function.
+ */
+Datum
+call_function2_cached(FmgrInfo *flinfo, PGFunction func, Datum arg1,
+	Datum arg2)
+{
+	if (fncache_context == NULL)
+		fncache_context = AllocSetContextCreate(TopMemoryContext,
+			"MobilityDB function cache", ALLOCSET_SMALL_SIZES);
+	if (flinfo->fn_mcxt == NULL)
+		flinfo->fn_mcxt = fncache_context;
+	FunctionCallInfoData fcinfo;
+	InitFunctionCallInfoData(fcinfo, flinfo, 2, DEFAULT_COLLATION_OID,
+		NULL, NULL);
+	fcinfo.arg[0] = arg1;
+	fcinfo.argnull[0] = false;
+	fcinfo.arg[1] = arg2;
+	fcinfo.argnull[1] = false;
+	Datum result = (*func) (&fcinfo);
+	if (fcinfo.isnull)
+		elog(ERROR, "function %p returned NULL", (void *) func);
+	return result;
+}
+
 Datum
 call_function3(PGFunction func, Datum arg1, Datum arg2, Datum arg3)
 {
@@ -332,6 +922,9 @@ temporalarr_extract(ArrayType *array, int *count)
 {
 	Temporal **result;
 	deconstruct_array(array, array->elemtype, -1, false, 'd', (Datum **) &result, NULL, count);
+	/* Elements of the array may be compressed sequences */
+	for (int i = 0; i < *count; i++)
+		result[i] = pg_getarg_temporal(result[i]);
 	return result;
 }
 
@@ -491,6 +1084,46 @@ temporalseqarr_sort(TemporalSeq **sequences, int count)
 		  (qsort_comparator) &temporalseqarr_sort_cmp);
 }
 
+/*
+ * Returns the k-th smallest value of the array, which is reordered, in
+ * linear expected time. This is used instead of sorting the array when only
+ * a median is needed, e.g., in the picksplit functions of SP-GiST.
+ */
+double
+double_select(double *values, int count, int k)
+{
+	int lo = 0, hi = count - 1;
+	while (lo < hi)
+	{
+		/* The pivot is the median of the first, middle, and last values */
+		double a = values[lo], b = values[lo + (hi - lo) / 2], c = values[hi];
+		double pivot = (a < b) ? ((b < c) ? b : ((a < c) ? c : a)) :
+			((a < c) ? a : ((b < c) ? c : b));
+		int i = lo, j = hi;
+		while (i <= j)
+		{
+			while (values[i] < pivot)
+				i++;
+			while (values[j] > pivot)
+				j--;
+			if (i <= j)
+			{
+				double tmp = values[i];
+				values[i++] = values[j];
+				values[j--] = tmp;
+			}
+		}
+		/* The values between j and i are equal to the pivot */
+		if (k <= j)
+			hi = j;
+		else if (k >= i)
+			lo = i;
+		else
+			break;
+	}
+	return values[k];
+}
+
 /*****************************************************************************
  * Remove duplicate functions
  * These functions assume that the array has been sorted before 
@@ -544,6 +1177,23 @@ text_cmp(text *arg1, text *arg2, Oid collid)
 	return varstr_cmp(a1p, len1, a2p, len2, collid);
 }
 
+/*
+ * Equality of two texts. As for the function texteq in PostgreSQL, since 
+ * collations are deterministic two texts are equal if and only if they 
+ * are bytewise equal, and thus the locale-aware comparison is not needed. 
+ * Temporal texts usually have a few distinct values, so that most 
+ * comparisons between their values are decided by the lengths or by 
+ * memcmp.
+ */
+bool
+text_eq(text *arg1, text *arg2)
+{
+	int len1 = (int) VARSIZE_ANY_EXHDR(arg1);
+	int len2 = (int) VARSIZE_ANY_EXHDR(arg2);
+	return len1 == len2 && 
+		memcmp(VARDATA_ANY(arg1), VARDATA_ANY(arg2), len1) == 0;
+}
+
 /*****************************************************************************
  * Comparison functions on datums
  *****************************************************************************/
@@ -555,27 +1205,7 @@ text_cmp(text *arg1, text *arg2, Oid collid)
 bool
 datum_eq(Datum l, Datum r, Oid type)
 {
-	ensure_temporal_base_type_all(type);
-	bool result = false;
-	if (type == BOOLOID || type == INT4OID || type == FLOAT8OID)
-		result = l == r;
-	else if (type == TEXTOID)
-		result = text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) == 0;
-	else if (type == type_oid(T_DOUBLE2))
-		result = double2_eq((double2 *)DatumGetPointer(l), (double2 *)DatumGetPointer(r));
-	else if (type == type_oid(T_DOUBLE3))
-		result = double3_eq((double3 *)DatumGetPointer(l), (double3 *)DatumGetPointer(r));
-	else if (type == type_oid(T_DOUBLE4))
-		result = double4_eq((double4 *)DatumGetPointer(l), (double4 *)DatumGetPointer(r));
-#ifdef WITH_POSTGIS
-	else if (type == type_oid(T_GEOMETRY))
-		//	result = DatumGetBool(call_function2(lwgeom_eq, l, r));
-		result = datum_point_eq(l, r);
-	else if (type == type_oid(T_GEOGRAPHY))
-		//	result = DatumGetBool(call_function2(geography_eq, l, r));
-		result = datum_point_eq(l, r);
-#endif
-	return result;
+	return base_type_info(type)->eq(l, r);
 }
 
 bool
@@ -587,23 +1217,10 @@ datum_ne(Datum l, Datum r, Oid type)
 bool
 datum_lt(Datum l, Datum r, Oid type)
 {
-	ensure_temporal_base_type(type);
-	bool result = false;
-	if (type == BOOLOID)
-		result = DatumGetBool(l) < DatumGetBool(r);
-	else if (type == INT4OID)
-		result = DatumGetInt32(l) < DatumGetInt32(r);
-	else if (type == FLOAT8OID)
-		result = DatumGetFloat8(l) < DatumGetFloat8(r);
-	else if (type == TEXTOID)
-		result = text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) < 0;
-#ifdef WITH_POSTGIS
-	else if (type == type_oid(T_GEOMETRY))
-		result = DatumGetBool(call_function2(lwgeom_lt, l, r));
-	else if (type == type_oid(T_GEOGRAPHY))
-		result = DatumGetBool(call_function2(geography_lt, l, r));
-#endif
-	return result;
+	const BaseTypeInfo *info = base_type_info(type);
+	if (info->lt == NULL)
+		elog(ERROR, "unknown base type: %d", type);
+	return info->lt(l, r);
 }
 
 bool
@@ -646,7 +1263,7 @@ datum_eq2(Datum l, Datum r, Oid typel, Oid typer)
 	else if (typel == FLOAT8OID && typer == INT4OID)
 		result = DatumGetFloat8(l) == DatumGetInt32(r);
 	else if (typel == TEXTOID && typer == TEXTOID)
-		result = text_cmp(DatumGetTextP(l), DatumGetTextP(r), DEFAULT_COLLATION_OID) == 0;
+		result = text_eq(DatumGetTextP(l), DatumGetTextP(r));
 		/* This function is never called with doubleN */
 #ifdef WITH_POSTGIS
 	else if (typel == type_oid(T_GEOMETRY) && typer == type_oid(T_GEOMETRY))
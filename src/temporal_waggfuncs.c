@@ -225,111 +225,6 @@ temporal_extend(Temporal *temp, Interval *interval, bool min, int *count)
 	return result;
 }
 
-/*****************************************************************************
- * Transform a temporal numeric type into a temporal integer type with value 1 
- * extended by a time interval. 
- *****************************************************************************/
-
-static int
-temporalinst_transform_wcount(TemporalSeq **result, TemporalInst *inst, 
-	Interval *interval)
-{
-	TemporalInst *instants[2];
-	TimestampTz upper = DatumGetTimestampTz(DirectFunctionCall2(
-		timestamptz_pl_interval, TimestampTzGetDatum(inst->t), 
-		PointerGetDatum(interval)));
-	instants[0] = temporalinst_make(Int32GetDatum(1), inst->t, INT4OID);
-	instants[1] = temporalinst_make(Int32GetDatum(1), upper, INT4OID);
-	result[0] = temporalseq_from_temporalinstarr(instants, 2, true, true, 
-		false, false);
-	pfree(instants[0]);	pfree(instants[1]);
-	return 1;
-}
-
-static int
-temporali_transform_wcount(TemporalSeq **result, TemporalI *ti, Interval *interval)
-{
-	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		temporalinst_transform_wcount(&result[i], inst, interval);
-	}
-	return ti->count;
-}
-
-static int
-temporalseq_transform_wcount(TemporalSeq **result, TemporalSeq *seq, Interval *interval)
-{
-	if (seq->count == 1)
-		return temporalinst_transform_wcount(result, temporalseq_inst_n(seq, 0), interval);
-
-	TemporalInst *instants[2];
-	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
-	bool lower_inc = seq->period.lower_inc;
-	for (int i = 0; i < seq->count - 1; i++)
-	{
-		TemporalInst *inst2 = temporalseq_inst_n(seq, i + 1);
-		bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false ;
-		TimestampTz upper = DatumGetTimestampTz(DirectFunctionCall2(
-			timestamptz_pl_interval, TimestampTzGetDatum(inst2->t), 
-			PointerGetDatum(interval)));
-		instants[0] = temporalinst_make(Int32GetDatum(1), inst1->t, INT4OID);
-		instants[1] = temporalinst_make(Int32GetDatum(1), upper, INT4OID);
-		result[i] = temporalseq_from_temporalinstarr(instants, 2,
-			lower_inc, upper_inc, false, false);
-		pfree(instants[0]); pfree(instants[1]);
-		inst1 = inst2;
-		lower_inc = true;
-	}	
-	return seq->count - 1;
-}
-
-static int
-temporals_transform_wcount(TemporalSeq **result, TemporalS *ts, Interval *interval)
-{
-	int k = 0;
-	for (int i = 0; i < ts->count; i++)
-	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		k += temporalseq_transform_wcount(&result[k], seq, interval);
-	}
-	return k;
-}
-
-/* Dispatch function */
-
-static TemporalSeq **
-temporal_transform_wcount(Temporal *temp, Interval *interval, int *count)
-{
-	ensure_valid_duration(temp->duration);
-	TemporalSeq **result = NULL;
-	if (temp->duration == TEMPORALINST)
-	{
-		TemporalInst *inst = (TemporalInst *)temp;
-		result = palloc(sizeof(TemporalSeq *));
-		*count = temporalinst_transform_wcount(result, inst, interval);
-	}
-	else if (temp->duration == TEMPORALI)
-	{
-		TemporalI *ti = (TemporalI *)temp;
-		result = palloc(sizeof(TemporalSeq *) * ti->count);
-		*count = temporali_transform_wcount(result, ti, interval);
-	}
-	else if (temp->duration == TEMPORALSEQ)
-	{
-		TemporalSeq *seq = (TemporalSeq *)temp;
-		result = palloc(sizeof(TemporalSeq *) * seq->count);
-		*count = temporalseq_transform_wcount(result, seq, interval);
-	}
-	else if (temp->duration == TEMPORALS)
-	{
-		TemporalS *ts = (TemporalS *)temp;
-		result = palloc(sizeof(TemporalSeq *) * ts->totalcount);
-		*count = temporals_transform_wcount(result, ts, interval);
-	}
-	return result;
-}
-
 /*****************************************************************************/
 
 /* Transform a temporal numeric type into a temporal double and 
@@ -471,6 +366,381 @@ tnumber_transform_wavg(Temporal *temp, Interval *interval, int *count)
 	return result;
 }
 
+/*****************************************************************************
+ * Sliding window engine
+ *
+ * Extending the instants or the segments of a temporal value by the window
+ * interval yields periods whose lower and upper bounds are both ordered.
+ * The extended periods that contain a given timestamp are thus a contiguous
+ * range of them, which slides monotonically forward when sweeping the bounds
+ * in time order. The aggregate over this range is maintained with a
+ * monotone deque for the minimum and the maximum and with prefix sums for
+ * the sum and the average, which yields the result of the window aggregate
+ * of a single value without materializing the extended sequences.
+ *****************************************************************************/
+
+typedef enum
+{
+	WINDOW_MIN,
+	WINDOW_MAX,
+	WINDOW_SUM,
+	WINDOW_COUNT,
+	WINDOW_AVG
+} WindowFunc;
+
+/* Period during which an instant or a segment belongs to the window */
+
+typedef struct
+{
+	TimestampTz lower;
+	TimestampTz upper;
+	bool lower_inc;
+	bool upper_inc;
+	Datum value;
+} WindowPiece;
+
+static TimestampTz
+timestamp_pl_window(TimestampTz t, Interval *interval)
+{
+	return DatumGetTimestampTz(DirectFunctionCall2(timestamptz_pl_interval,
+		TimestampTzGetDatum(t), PointerGetDatum(interval)));
+}
+
+static int
+temporalinst_window_pieces(WindowPiece *result, TemporalInst *inst, 
+	Interval *interval)
+{
+	result[0].lower = inst->t;
+	result[0].upper = timestamp_pl_window(inst->t, interval);
+	result[0].lower_inc = result[0].upper_inc = true;
+	result[0].value = temporalinst_value(inst);
+	return 1;
+}
+
+/* The segments of a sequence are extended as in tstepwseq_extend */
+
+static int
+temporalseq_window_pieces(WindowPiece *result, TemporalSeq *seq, 
+	Interval *interval)
+{
+	if (seq->count == 1)
+		return temporalinst_window_pieces(result, temporalseq_inst_n(seq, 0), 
+			interval);
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	for (int i = 0; i < seq->count - 1; i++)
+	{
+		TemporalInst *inst2 = temporalseq_inst_n(seq, i + 1);
+		result[i].lower = inst1->t;
+		result[i].upper = timestamp_pl_window(inst2->t, interval);
+		result[i].lower_inc = (i == 0) ? seq->period.lower_inc : true;
+		result[i].upper_inc = (i == seq->count - 2) ? 
+			seq->period.upper_inc : false;
+		result[i].value = temporalinst_value(inst1);
+		inst1 = inst2;
+	}
+	return seq->count - 1;
+}
+
+/* Dispatch function */
+
+static WindowPiece *
+temporal_window_pieces(Temporal *temp, Interval *interval, int *count)
+{
+	WindowPiece *result = NULL;
+	ensure_valid_duration(temp->duration);
+	if (temp->duration == TEMPORALINST)
+	{
+		result = palloc(sizeof(WindowPiece));
+		*count = temporalinst_window_pieces(result, (TemporalInst *)temp, 
+			interval);
+	}
+	else if (temp->duration == TEMPORALI)
+	{
+		TemporalI *ti = (TemporalI *)temp;
+		result = palloc(sizeof(WindowPiece) * ti->count);
+		for (int i = 0; i < ti->count; i++)
+			temporalinst_window_pieces(&result[i], temporali_inst_n(ti, i), 
+				interval);
+		*count = ti->count;
+	}
+	else if (temp->duration == TEMPORALSEQ)
+	{
+		TemporalSeq *seq = (TemporalSeq *)temp;
+		result = palloc(sizeof(WindowPiece) * seq->count);
+		*count = temporalseq_window_pieces(result, seq, interval);
+	}
+	else if (temp->duration == TEMPORALS)
+	{
+		TemporalS *ts = (TemporalS *)temp;
+		result = palloc(sizeof(WindowPiece) * ts->totalcount);
+		int k = 0;
+		for (int i = 0; i < ts->count; i++)
+			k += temporalseq_window_pieces(&result[k], temporals_seq_n(ts, i), 
+				interval);
+		*count = k;
+	}
+	return result;
+}
+
+/* Aggregate over the sliding range of pieces */
+
+typedef struct
+{
+	WindowFunc func;
+	Oid valuetypid;
+	WindowPiece *pieces;
+	int *deque;          /* Candidate pieces for the minimum/maximum */
+	int first;
+	int last;
+	int pushed;          /* Number of pieces pushed into the deque */
+	int64 *prefix;       /* Prefix sums of integer values */
+} WindowState;
+
+static double
+window_sum(WindowState *ws, int lo, int hi)
+{
+	if (ws->valuetypid == INT4OID)
+		return (double) (ws->prefix[hi] - ws->prefix[lo]);
+	/* Add floats from left to right to obtain the same rounding as the
+	 * aggregation of the extended sequences */
+	double result = DatumGetFloat8(ws->pieces[lo].value);
+	for (int i = lo + 1; i < hi; i++)
+		result += DatumGetFloat8(ws->pieces[i].value);
+	return result;
+}
+
+/* Returns the aggregate over the pieces in [lo, hi), which is not empty */
+
+static Datum
+window_value(WindowState *ws, int lo, int hi)
+{
+	if (ws->func == WINDOW_COUNT)
+		return Int32GetDatum(hi - lo);
+	if (ws->func == WINDOW_AVG)
+		return PointerGetDatum(double2_construct(window_sum(ws, lo, hi), 
+			(double) (hi - lo)));
+	if (ws->func == WINDOW_SUM)
+	{
+		if (ws->valuetypid == INT4OID)
+			return Int32GetDatum((int32) (ws->prefix[hi] - ws->prefix[lo]));
+		return Float8GetDatum(window_sum(ws, lo, hi));
+	}
+	/* WINDOW_MIN or WINDOW_MAX */
+	for ( ; ws->pushed < hi; ws->pushed++)
+	{
+		Datum value = ws->pieces[ws->pushed].value;
+		while (ws->last > ws->first)
+		{
+			Datum back = ws->pieces[ws->deque[ws->last - 1]].value;
+			if (ws->func == WINDOW_MIN ? 
+					datum_gt(value, back, ws->valuetypid) :
+					datum_lt(value, back, ws->valuetypid))
+				break;
+			ws->last--;
+		}
+		ws->deque[ws->last++] = ws->pushed;
+	}
+	while (ws->deque[ws->first] < lo)
+		ws->first++;
+	return ws->pieces[ws->deque[ws->first]].value;
+}
+
+/* Sequences of the result being constructed */
+
+typedef struct
+{
+	Oid restypid;
+	bool linear;
+	TemporalInst **instants;
+	int ninstants;
+	bool lower_inc;
+	bool open;           /* True when the current sequence is not finished */
+	Datum cur;           /* Last value of the current sequence */
+	TemporalSeq **sequences;
+	int nsequences;
+} WindowResult;
+
+static void
+window_result_open(WindowResult *wr, TimestampTz t, Datum value, 
+	bool lower_inc)
+{
+	wr->instants[0] = temporalinst_make(value, t, wr->restypid);
+	wr->ninstants = 1;
+	wr->lower_inc = lower_inc;
+	wr->open = true;
+	wr->cur = value;
+}
+
+static void
+window_result_append(WindowResult *wr, TimestampTz t, Datum value)
+{
+	wr->instants[wr->ninstants++] = temporalinst_make(value, t, wr->restypid);
+	wr->cur = value;
+}
+
+static void
+window_result_close(WindowResult *wr, TimestampTz t, Datum value, 
+	bool upper_inc)
+{
+	window_result_append(wr, t, value);
+	wr->sequences[wr->nsequences++] = temporalseq_from_temporalinstarr(
+		wr->instants, wr->ninstants, wr->lower_inc, upper_inc, wr->linear, 
+		true);
+	for (int i = 0; i < wr->ninstants; i++)
+		pfree(wr->instants[i]);
+	wr->ninstants = 0;
+	wr->open = false;
+}
+
+static void
+window_result_instant(WindowResult *wr, TimestampTz t, Datum value)
+{
+	window_result_open(wr, t, value, true);
+	wr->sequences[wr->nsequences++] = temporalseq_from_temporalinstarr(
+		wr->instants, 1, true, true, wr->linear, false);
+	pfree(wr->instants[0]);
+	wr->ninstants = 0;
+	wr->open = false;
+}
+
+/*
+ * Sweep the bounds of the pieces in time order. At each bound the contents
+ * of the window are determined both at the bound itself and on the open 
+ * period up to the next bound, since they may differ due to the 
+ * inclusive/exclusive bounds of the pieces. The result is a set of ordered
+ * and non-overlapping sequences. With step interpolation they change value
+ * at the bounds, with linear interpolation each sequence is constant.
+ */
+static TemporalSeq **
+window_sweep(WindowPiece *pieces, int count, WindowFunc func, 
+	Oid valuetypid, bool linear, int *newcount)
+{
+	WindowState ws;
+	memset(&ws, 0, sizeof(WindowState));
+	ws.func = func;
+	ws.valuetypid = valuetypid;
+	ws.pieces = pieces;
+	if (func == WINDOW_MIN || func == WINDOW_MAX)
+		ws.deque = palloc(sizeof(int) * count);
+	else if (valuetypid == INT4OID && (func == WINDOW_SUM || func == WINDOW_AVG))
+	{
+		ws.prefix = palloc(sizeof(int64) * (count + 1));
+		ws.prefix[0] = 0;
+		for (int i = 0; i < count; i++)
+			ws.prefix[i + 1] = ws.prefix[i] + DatumGetInt32(pieces[i].value);
+	}
+
+	WindowResult wr;
+	memset(&wr, 0, sizeof(WindowResult));
+	wr.restypid = (func == WINDOW_COUNT) ? INT4OID :
+		(func == WINDOW_AVG) ? type_oid(T_DOUBLE2) : valuetypid;
+	wr.linear = linear;
+	/* There are at most 2 * count bounds, each of them adding at most one
+	 * instant to the current sequence and finishing at most two sequences */
+	wr.instants = palloc(sizeof(TemporalInst *) * 2 * count);
+	wr.sequences = palloc(sizeof(TemporalSeq *) * 4 * count);
+
+	/* Pointers delimiting the pieces in the window at and after the bound */
+	int lo_at = 0, hi_at = 0, lo_after = 0, hi_after = 0;
+	/* Indexes of the next lower and upper bounds to visit */
+	int l = 0, u = 0;
+	while (u < count)
+	{
+		TimestampTz t = (l < count && 
+			timestamp_cmp_internal(pieces[l].lower, pieces[u].upper) < 0) ?
+			pieces[l].lower : pieces[u].upper;
+		while (l < count && pieces[l].lower == t)
+			l++;
+		while (u < count && pieces[u].upper == t)
+			u++;
+
+		while (hi_at < count && (pieces[hi_at].lower < t ||
+			(pieces[hi_at].lower == t && pieces[hi_at].lower_inc)))
+			hi_at++;
+		while (lo_at < count && (pieces[lo_at].upper < t ||
+			(pieces[lo_at].upper == t && ! pieces[lo_at].upper_inc)))
+			lo_at++;
+		while (hi_after < count && pieces[hi_after].lower <= t)
+			hi_after++;
+		while (lo_after < count && pieces[lo_after].upper <= t)
+			lo_after++;
+
+		bool hasat = lo_at < hi_at;
+		bool hasafter = lo_after < hi_after;
+		Datum at = hasat ? window_value(&ws, lo_at, hi_at) : 0;
+		Datum after = hasafter ? window_value(&ws, lo_after, hi_after) : 0;
+		bool atafter = hasat && hasafter && 
+			datum_eq(at, after, wr.restypid);
+
+		if (wr.open)
+		{
+			if (! linear && atafter)
+			{
+				/* The value changes at the bound */
+				if (! datum_eq(at, wr.cur, wr.restypid))
+					window_result_append(&wr, t, at);
+				continue;
+			}
+			if (linear && hasat && datum_eq(at, wr.cur, wr.restypid))
+			{
+				if (hasafter && datum_eq(after, wr.cur, wr.restypid))
+					continue;
+				window_result_close(&wr, t, at, true);
+				if (hasafter)
+					window_result_open(&wr, t, after, false);
+				continue;
+			}
+			if (! linear && hasat)
+				window_result_close(&wr, t, at, true);
+			else
+				window_result_close(&wr, t, wr.cur, false);
+			if (! linear)
+			{
+				if (hasafter)
+					window_result_open(&wr, t, after, false);
+				continue;
+			}
+		}
+		if (atafter)
+		{
+			window_result_open(&wr, t, at, true);
+			continue;
+		}
+		if (hasat)
+			window_result_instant(&wr, t, at);
+		if (hasafter)
+			window_result_open(&wr, t, after, false);
+	}
+
+	pfree(wr.instants);
+	if (ws.deque)
+		pfree(ws.deque);
+	if (ws.prefix)
+		pfree(ws.prefix);
+	*newcount = wr.nsequences;
+	return wr.sequences;
+}
+
+/* Compute the window aggregate of a temporal value and add it to the state */
+
+static SkipList *
+temporal_wagg_sweep(FunctionCallInfo fcinfo, SkipList *state, 
+	Temporal *temp, Interval *interval, WindowFunc wfunc, bool linear,
+	Datum (*func)(Datum, Datum), bool crossings)
+{
+	int count, newcount;
+	WindowPiece *pieces = temporal_window_pieces(temp, interval, &count);
+	TemporalSeq **sequences = window_sweep(pieces, count, wfunc, 
+		temp->valuetypid, linear, &newcount);
+	SkipList *result = temporalseqarr_tagg_transfn(fcinfo, state, sequences,
+		newcount, func, crossings);
+	for (int i = 0; i < newcount; i++)
+		pfree(sequences[i]);
+	pfree(sequences);
+	pfree(pieces);
+	return result;
+}
+
 /*****************************************************************************
  * Temporal 
  *****************************************************************************/
@@ -479,9 +749,17 @@ tnumber_transform_wavg(Temporal *temp, Interval *interval, int *count)
 
 static SkipList *
 temporal_wagg_transfn(FunctionCallInfo fcinfo, SkipList *state, 
-	Temporal *temp, Interval *interval,
+	Temporal *temp, Interval *interval, WindowFunc wfunc,
 	Datum (*func)(Datum, Datum), bool min, bool crossings)
 {
+	/* Only linear sequences need the extended sequences of tlinearseq_extend */
+	if (temp->duration == TEMPORALINST || temp->duration == TEMPORALI)
+		return temporal_wagg_sweep(fcinfo, state, temp, interval, wfunc,
+			linear_interpolation(temp->valuetypid), func, crossings);
+	if (! MOBDB_FLAGS_GET_LINEAR(temp->flags))
+		return temporal_wagg_sweep(fcinfo, state, temp, interval, wfunc,
+			false, func, crossings);
+
 	int count;
 	TemporalSeq **sequences = temporal_extend(temp, interval, min, &count);
 	SkipList *result = temporalseq_tagg_transfn(fcinfo, state, sequences[0], 
@@ -514,7 +792,7 @@ tint_wmin_transfn(PG_FUNCTION_ARGS)
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Interval *interval = PG_GETARG_INTERVAL_P(2);
 	SkipList *result = temporal_wagg_transfn(fcinfo, state, temp, interval, 
-		&datum_min_int32, true, true);
+		WINDOW_MIN, &datum_min_int32, true, true);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_FREE_IF_COPY(interval, 2);
 	PG_RETURN_POINTER(result);
@@ -537,7 +815,7 @@ tfloat_wmin_transfn(PG_FUNCTION_ARGS)
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Interval *interval = PG_GETARG_INTERVAL_P(2);
 	SkipList *result = temporal_wagg_transfn(fcinfo, state, temp, interval, 
-		&datum_min_float8, true, true);
+		WINDOW_MIN, &datum_min_float8, true, true);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_FREE_IF_COPY(interval, 2);
 	PG_RETURN_POINTER(result);
@@ -562,7 +840,7 @@ tint_wmax_transfn(PG_FUNCTION_ARGS)
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Interval *interval = PG_GETARG_INTERVAL_P(2);
 	SkipList *result = temporal_wagg_transfn(fcinfo, state, temp, interval, 
-		&datum_max_int32, false, true);
+		WINDOW_MAX, &datum_max_int32, false, true);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_FREE_IF_COPY(interval, 2);
 	PG_RETURN_POINTER(result);
@@ -585,7 +863,7 @@ tfloat_wmax_transfn(PG_FUNCTION_ARGS)
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Interval *interval = PG_GETARG_INTERVAL_P(2);
 	SkipList *result = temporal_wagg_transfn(fcinfo, state, temp, interval, 
-		&datum_max_float8, false, true);
+		WINDOW_MAX, &datum_max_float8, false, true);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_FREE_IF_COPY(interval, 2);
 	PG_RETURN_POINTER(result);
@@ -610,7 +888,7 @@ tint_wsum_transfn(PG_FUNCTION_ARGS)
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Interval *interval = PG_GETARG_INTERVAL_P(2);
 	SkipList *result = temporal_wagg_transfn(fcinfo, state, temp, interval, 
-		&datum_sum_int32, true, false);
+		WINDOW_SUM, &datum_sum_int32, true, false);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_FREE_IF_COPY(interval, 2);
 	PG_RETURN_POINTER(result);
@@ -637,7 +915,7 @@ tfloat_wsum_transfn(PG_FUNCTION_ARGS)
 			errmsg("Operation not supported for temporal float sequences")));
 	Interval *interval = PG_GETARG_INTERVAL_P(2);
 	SkipList *result = temporal_wagg_transfn(fcinfo, state, temp, interval, 
-		&datum_sum_float8, true, false);
+		WINDOW_SUM, &datum_sum_float8, true, false);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_FREE_IF_COPY(interval, 2);
 	PG_RETURN_POINTER(result);
@@ -661,16 +939,8 @@ temporal_wcount_transfn(PG_FUNCTION_ARGS)
 	}
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Interval *interval = PG_GETARG_INTERVAL_P(2);
-	int count;
-	TemporalSeq **sequences = temporal_transform_wcount(temp, interval, &count);
-	SkipList *result = temporalseq_tagg_transfn(fcinfo, state, sequences[0], 
-		&datum_sum_int32, false);
-	for (int i = 1; i < count; i++)
-		result = temporalseq_tagg_transfn(fcinfo, result, sequences[i], 
-			&datum_sum_int32, false);
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+	SkipList *result = temporal_wagg_sweep(fcinfo, state, temp, interval,
+		WINDOW_COUNT, false, &datum_sum_int32, false);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_FREE_IF_COPY(interval, 2);
 	PG_RETURN_POINTER(result);
@@ -694,16 +964,21 @@ tnumber_wavg_transfn(PG_FUNCTION_ARGS)
 	}
 	Temporal *temp = PG_GETARG_TEMPORAL(1);
 	Interval *interval = PG_GETARG_INTERVAL_P(2);
-	int count;
-	TemporalSeq **sequences = tnumber_transform_wavg(temp, interval, &count);
-	SkipList *result = temporalseq_tagg_transfn(fcinfo, state, sequences[0], 
-		&datum_sum_double2, false);
-	for (int i = 1; i < count; i++)
-		result = temporalseq_tagg_transfn(fcinfo, result, sequences[i], 
+	SkipList *result;
+	if ((temp->duration == TEMPORALSEQ || temp->duration == TEMPORALS) &&
+		MOBDB_FLAGS_GET_LINEAR(temp->flags))
+	{
+		int count;
+		TemporalSeq **sequences = tnumber_transform_wavg(temp, interval, &count);
+		result = temporalseqarr_tagg_transfn(fcinfo, state, sequences, count,
 			&datum_sum_double2, false);
-	for (int i = 0; i < count; i++)
-		pfree(sequences[i]);
-	pfree(sequences);
+		for (int i = 0; i < count; i++)
+			pfree(sequences[i]);
+		pfree(sequences);
+	}
+	else
+		result = temporal_wagg_sweep(fcinfo, state, temp, interval,
+			WINDOW_AVG, true, &datum_sum_double2, false);
 	PG_FREE_IF_COPY(temp, 1);
 	PG_FREE_IF_COPY(interval, 2);
 	PG_RETURN_POINTER(result);
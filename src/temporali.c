@@ -376,36 +376,20 @@ intersection_temporali_temporali(TemporalI *ti1, TemporalI *ti2,
  * Input/output functions
  *****************************************************************************/
 
-/* Convert to string */
+/* Append the string representation to the buffer */
  
-char*
-temporali_to_string(TemporalI *ti, char *(*value_out)(Oid, Datum))
+void
+temporali_to_string_buf(StringInfo buf, TemporalI *ti,
+	void (*value_out)(StringInfo, Oid, Datum))
 {
-	char** strings = palloc(sizeof(char *) * ti->count);
-	size_t outlen = 0;
-
-	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		strings[i] = temporalinst_to_string(inst, value_out);
-		outlen += strlen(strings[i]) + 2;
-	}
-	char *result = palloc(outlen + 3);
-	result[outlen] = '\0';
-	result[0] = '{';
-	size_t pos = 1;
+	appendStringInfoChar(buf, '{');
 	for (int i = 0; i < ti->count; i++)
 	{
-		strcpy(result + pos, strings[i]);
-		pos += strlen(strings[i]);
-		result[pos++] = ',';
-		result[pos++] = ' ';
-		pfree(strings[i]);
+		if (i > 0)
+			appendBinaryStringInfo(buf, ", ", 2);
+		temporalinst_to_string_buf(buf, temporali_inst_n(ti, i), value_out);
 	}
-	result[pos - 2] = '}';
-	result[pos - 1] = '\0';
-	pfree(strings);
-	return result;
+	appendStringInfoChar(buf, '}');
 }
 
 /* Send function */
@@ -618,10 +602,11 @@ temporali_min_value(TemporalI *ti)
 		Oid valuetypid = ti->valuetypid;
 		Datum min = temporalinst_value(temporali_inst_n(ti, 0));
 		int idx = 0;
+		const BaseTypeInfo *info = base_type_info(valuetypid);
 		for (int i = 1; i < ti->count; i++)
 		{
 			Datum value = temporalinst_value(temporali_inst_n(ti, i));
-			if (datum_lt(value, min, valuetypid))
+			if (info->lt(value, min))
 			{
 				min = value;
 				idx = i;
@@ -651,10 +636,11 @@ temporali_max_value(TemporalI *ti)
 		Oid valuetypid = ti->valuetypid;
 		Datum max = temporalinst_value(temporali_inst_n(ti, 0));
 		int idx = 0;
+		const BaseTypeInfo *info = base_type_info(valuetypid);
 		for (int i = 1; i < ti->count; i++)
 		{
 			Datum value = temporalinst_value(temporali_inst_n(ti, i));
-			if (datum_gt(value, max, valuetypid))
+			if (info->lt(max, value))
 			{
 				max = value;
 				idx = i;
@@ -725,24 +711,56 @@ temporali_timestamps(TemporalI *ti)
 	return result;
 }
 
+/* Add the bytes of the instant set to the breakdown of its memory layout */
+
+void
+temporali_layout(TemporalI *ti, TemporalLayout *layout)
+{
+	layout->offsets += (ti->count + 1) * sizeof(size_t);
+	for (int i = 0; i < ti->count; i++)
+		temporalinst_layout(temporali_inst_n(ti, i), layout);
+	layout->bbox += double_pad(temporal_bbox_size(ti->valuetypid));
+}
+
 /* Shift the time span of a temporal value by an interval */
 
 TemporalI *
 temporali_shift(TemporalI *ti, Interval *interval)
 {
    	TemporalI *result = temporali_copy(ti);
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
 	for (int i = 0; i < ti->count; i++)
 	{
-		TemporalInst *inst = instants[i] = temporali_inst_n(result, i);
-		inst->t = DatumGetTimestampTz(
-			DirectFunctionCall2(timestamptz_pl_interval,
-			TimestampTzGetDatum(inst->t), PointerGetDatum(interval)));
+		TemporalInst *inst = temporali_inst_n(result, i);
+		inst->t = timestamp_shift(inst->t, interval);
 	}
-	/* Recompute the bounding box */
+	/* Shift bounding box */
 	void *bbox = temporali_bbox_ptr(result); 
-	temporali_make_bbox(bbox, instants, ti->count);
-	pfree(instants);
+	shift_bbox(bbox, ti->valuetypid, interval);
+	return result;
+}
+
+/*
+ * Scale the time span of a temporal value by a factor from an origin.
+ * The function errors when two instants are scaled to the same timestamp.
+ */
+
+TemporalI *
+temporali_tscale(TemporalI *ti, TimestampTz origin, double scale)
+{
+	TemporalI *result = temporali_copy(ti);
+	TimestampTz prev = 0; /* keep compiler quiet */
+	for (int i = 0; i < ti->count; i++)
+	{
+		TemporalInst *inst = temporali_inst_n(result, i);
+		inst->t = timestamp_tscale(inst->t, origin, scale);
+		if (i > 0 && inst->t <= prev)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("The interval is too small to scale the temporal value")));
+		prev = inst->t;
+	}
+	/* Scale bounding box */
+	void *bbox = temporali_bbox_ptr(result); 
+	tscale_bbox(bbox, ti->valuetypid, origin, scale);
 	return result;
 }
 
@@ -766,10 +784,11 @@ temporali_ever_eq(TemporalI *ti, Datum value)
 			return false;
 	}
 
+	const BaseTypeInfo *info = base_type_info(ti->valuetypid);
 	for (int i = 0; i < ti->count; i++) 
 	{
 		Datum valueinst = temporalinst_value(temporali_inst_n(ti, i));
-		if (datum_eq(valueinst, value, ti->valuetypid))
+		if (info->eq(valueinst, value))
 			return true;
 	}
 	return false;
@@ -794,10 +813,11 @@ temporali_always_eq(TemporalI *ti, Datum value)
 				(int)(box.xmax) == DatumGetFloat8(value);
 	}
 
+	const BaseTypeInfo *info = base_type_info(ti->valuetypid);
 	for (int i = 0; i < ti->count; i++) 
 	{
 		Datum valueinst = temporalinst_value(temporali_inst_n(ti, i));
-		if (datum_ne(valueinst, value, ti->valuetypid))
+		if (! info->eq(valueinst, value))
 			return false;
 	}
 	return true;
@@ -821,10 +841,11 @@ temporali_ever_lt(TemporalI *ti, Datum value)
 			return false;
 	}
 
+	const BaseTypeInfo *info = base_type_info(ti->valuetypid);
 	for (int i = 0; i < ti->count; i++) 
 	{
 		Datum valueinst = temporalinst_value(temporali_inst_n(ti, i));
-		if (datum_lt(valueinst, value, ti->valuetypid))
+		if (info->lt(valueinst, value))
 			return true;
 	}
 	return false;
@@ -846,10 +867,11 @@ temporali_ever_le(TemporalI *ti, Datum value)
 			return false;
 	}
 
+	const BaseTypeInfo *info = base_type_info(ti->valuetypid);
 	for (int i = 0; i < ti->count; i++) 
 	{
 		Datum valueinst = temporalinst_value(temporali_inst_n(ti, i));
-		if (datum_le(valueinst, value, ti->valuetypid))
+		if (info->eq(valueinst, value) || info->lt(valueinst, value))
 			return true;
 	}
 	return false;
@@ -871,10 +893,11 @@ temporali_always_lt(TemporalI *ti, Datum value)
 			return false;
 	}
 
+	const BaseTypeInfo *info = base_type_info(ti->valuetypid);
 	for (int i = 0; i < ti->count; i++) 
 	{
 		Datum valueinst = temporalinst_value(temporali_inst_n(ti, i));
-		if (! datum_lt(valueinst, value, ti->valuetypid))
+		if (! info->lt(valueinst, value))
 			return false;
 	}
 	return true;
@@ -896,10 +919,11 @@ temporali_always_le(TemporalI *ti, Datum value)
 			return false;
 	}
 
+	const BaseTypeInfo *info = base_type_info(ti->valuetypid);
 	for (int i = 0; i < ti->count; i++) 
 	{
 		Datum valueinst = temporalinst_value(temporali_inst_n(ti, i));
-		if (! datum_le(valueinst, value, ti->valuetypid))
+		if (! (info->eq(valueinst, value) || info->lt(valueinst, value)))
 			return false;
 	}
 	return true;
@@ -915,6 +939,7 @@ TemporalI *
 temporali_at_value(TemporalI *ti, Datum value)
 {
 	Oid valuetypid = ti->valuetypid;
+	const BaseTypeInfo *info = base_type_info(valuetypid);
 	/* Bounding box test */
 	if (valuetypid == INT4OID || valuetypid == FLOAT8OID)
 	{
@@ -930,8 +955,7 @@ temporali_at_value(TemporalI *ti, Datum value)
 	/* Singleton instant set */
 	if (ti->count == 1)
 	{
-		if (datum_ne(value, temporalinst_value(temporali_inst_n(ti, 0)), 
-			valuetypid))
+		if (! info->eq(value, temporalinst_value(temporali_inst_n(ti, 0))))
 			return NULL;
 		return temporali_copy(ti);
 	}
@@ -942,7 +966,7 @@ temporali_at_value(TemporalI *ti, Datum value)
 	for (int i = 0; i < ti->count; i++)
 	{
 		TemporalInst *inst = temporali_inst_n(ti, i);
-		if (datum_eq(value, temporalinst_value(inst), valuetypid)) 
+		if (info->eq(value, temporalinst_value(inst))) 
 			instants[count++] = inst;
 	}
 	TemporalI *result = (count == 0) ? NULL :
@@ -957,6 +981,7 @@ TemporalI *
 temporali_minus_value(TemporalI *ti, Datum value)
 {
 	Oid valuetypid = ti->valuetypid;
+	const BaseTypeInfo *info = base_type_info(valuetypid);
 	/* Bounding box test */
 	if (valuetypid == INT4OID || valuetypid == FLOAT8OID)
 	{
@@ -972,8 +997,7 @@ temporali_minus_value(TemporalI *ti, Datum value)
 	/* Singleton instant set */
 	if (ti->count == 1)
 	{
-		if (datum_eq(value, temporalinst_value(temporali_inst_n(ti, 0)), 
-			valuetypid))
+		if (info->eq(value, temporalinst_value(temporali_inst_n(ti, 0))))
 			return NULL;
 		return temporali_copy(ti);
 	}
@@ -984,7 +1008,7 @@ temporali_minus_value(TemporalI *ti, Datum value)
 	for (int i = 0; i < ti->count; i++)
 	{
 		TemporalInst *inst = temporali_inst_n(ti, i);
-		if (datum_ne(value, temporalinst_value(inst), valuetypid))
+		if (! info->eq(value, temporalinst_value(inst)))
 			instants[count++] = inst;
 	}
 	TemporalI *result = (count == 0) ? NULL :
@@ -1015,12 +1039,13 @@ temporali_at_values(TemporalI *ti, Datum *values, int count)
 	/* General case */
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
 	int newcount = 0;	
+	const BaseTypeInfo *info = base_type_info(ti->valuetypid);
 	for (int i = 0; i < ti->count; i++)
 	{
 		TemporalInst *inst = temporali_inst_n(ti, i);
 		for (int j = 0; j < count; j++)
 		{
-			if (datum_eq(temporalinst_value(inst), values[j], ti->valuetypid))
+			if (info->eq(temporalinst_value(inst), values[j]))
 			{
 				instants[newcount++] = inst;
 				break;
@@ -1055,13 +1080,14 @@ temporali_minus_values(TemporalI *ti, Datum *values, int count)
 	/* General case */
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
 	int newcount = 0;
+	const BaseTypeInfo *info = base_type_info(ti->valuetypid);
 	for (int i = 0; i < ti->count; i++)
 	{
 		bool found = false;
 		TemporalInst *inst = temporali_inst_n(ti, i);
 		for (int j = 0; j < count; j++)
 		{
-			if (datum_eq(temporalinst_value(inst), values[j], ti->valuetypid))
+			if (info->eq(temporalinst_value(inst), values[j]))
 			{
 				found = true;
 				break;
@@ -1079,14 +1105,14 @@ temporali_minus_values(TemporalI *ti, Datum *values, int count)
 /* Restriction to a range. */
 
 TemporalI *
-tnumberi_at_range(TemporalI *ti, RangeType *range)
+tnumberi_at_range(TemporalI *ti, const RangeBounds *bounds)
 {
 	/* Bounding box test */
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
 	temporali_bbox(&box1, ti);
-	range_to_tbox_internal(&box2, range);
+	range_bounds_to_tbox(&box2, bounds);
 	if (!overlaps_tbox_tbox_internal(&box1, &box2))
 		return NULL;
 
@@ -1100,7 +1126,7 @@ tnumberi_at_range(TemporalI *ti, RangeType *range)
 	for (int i = 0; i < ti->count; i++)
 	{
 		TemporalInst *inst = temporali_inst_n(ti, i);
-		TemporalInst *inst1 = tnumberinst_at_range(inst, range);
+		TemporalInst *inst1 = tnumberinst_at_range(inst, bounds);
 		if (inst1 != NULL)
 			instants[count++] = inst1;
 	}
@@ -1120,14 +1146,14 @@ tnumberi_at_range(TemporalI *ti, RangeType *range)
 /* Restriction to the complement of a range */
 
 TemporalI *
-tnumberi_minus_range(TemporalI *ti, RangeType *range)
+tnumberi_minus_range(TemporalI *ti, const RangeBounds *bounds)
 {
 	/* Bounding box test */
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
 	temporali_bbox(&box1, ti);
-	range_to_tbox_internal(&box2, range);
+	range_bounds_to_tbox(&box2, bounds);
 	if (!overlaps_tbox_tbox_internal(&box1, &box2))
 		return temporali_copy(ti);
 
@@ -1141,7 +1167,7 @@ tnumberi_minus_range(TemporalI *ti, RangeType *range)
 	for (int i = 0; i < ti->count; i++)
 	{
 		TemporalInst *inst = temporali_inst_n(ti, i);
-		TemporalInst *inst1 = tnumberinst_minus_range(inst, range);
+		TemporalInst *inst1 = tnumberinst_minus_range(inst, bounds);
 		if (inst1 != NULL)
 			instants[newcount++] = inst1;
 	}
@@ -1161,13 +1187,14 @@ tnumberi_minus_range(TemporalI *ti, RangeType *range)
 /* Restriction to the ranges */
 
 TemporalI *
-tnumberi_at_ranges(TemporalI *ti, RangeType **normranges, int count)
+tnumberi_at_ranges(TemporalI *ti, const RangeBounds *normbounds,
+	int count)
 {
 	/* Singleton instant set */
 	if (ti->count == 1)
 	{
 		TemporalInst *inst = temporali_inst_n(ti, 0);
-		TemporalInst *inst1 = tnumberinst_at_ranges(inst, normranges, count);
+		TemporalInst *inst1 = tnumberinst_at_ranges(inst, normbounds, count);
 		if (inst1 == NULL)
 			return NULL;
 		pfree(inst1); 
@@ -1180,15 +1207,9 @@ tnumberi_at_ranges(TemporalI *ti, RangeType **normranges, int count)
 	for (int i = 0; i < ti->count; i++)
 	{
 		TemporalInst *inst = temporali_inst_n(ti, i);
-		for (int j = 0; j < count; j++)
-		{
-			TemporalInst *inst1 = tnumberinst_at_range(inst, normranges[j]);
-			if (inst1 != NULL)
-			{
-				instants[newcount++] = inst1;
-				break;
-			}
-		}
+		TemporalInst *inst1 = tnumberinst_at_ranges(inst, normbounds, count);
+		if (inst1 != NULL)
+			instants[newcount++] = inst1;
 	}
 	if (newcount == 0) 
 	{
@@ -1206,13 +1227,14 @@ tnumberi_at_ranges(TemporalI *ti, RangeType **normranges, int count)
 /* Restriction to the complement of ranges */
 
 TemporalI *
-tnumberi_minus_ranges(TemporalI *ti, RangeType **normranges, int count)
+tnumberi_minus_ranges(TemporalI *ti, const RangeBounds *normbounds,
+	int count)
 {
 	/* Singleton instant set */
 	if (ti->count == 1)
 	{
 		TemporalInst *inst = temporali_inst_n(ti, 0);
-		TemporalInst *inst1 = tnumberinst_minus_ranges(inst, normranges, count);
+		TemporalInst *inst1 = tnumberinst_minus_ranges(inst, normbounds, count);
 		if (inst1 == NULL)
 			return NULL;
 		pfree(inst1); 
@@ -1225,15 +1247,9 @@ tnumberi_minus_ranges(TemporalI *ti, RangeType **normranges, int count)
 	for (int i = 0; i < ti->count; i++)
 	{
 		TemporalInst *inst = temporali_inst_n(ti, i);
-		for (int j = 0; j < count; j++)
-		{
-			TemporalInst *inst1 = tnumberinst_minus_range(inst, normranges[j]);
-			if (inst1 != NULL)
-			{
-				instants[newcount++] = inst1;
-				break;
-			}
-		}
+		TemporalInst *inst1 = tnumberinst_minus_ranges(inst, normbounds, count);
+		if (inst1 != NULL)
+			instants[newcount++] = inst1;
 	}
 	if (newcount == 0)
 	{
@@ -1361,6 +1377,239 @@ temporali_minus_timestamp(TemporalI *ti, TimestampTz t)
 	return result;
 }
 
+/*
+ * Selection of the instants of a TemporalI
+ *
+ * The restriction functions to timestamp sets, periods, and period sets
+ * first mark in an array of booleans the instants that belong to the result.
+ * They do this over a packed array of the timestamps of the instants with
+ * loops without branches, which the compiler can vectorize. The result is
+ * then built by copying at once each run of consecutive selected instants,
+ * without validating again the instants, which are a subset of a valid value.
+ */
+
+/* Packed array of the timestamps of the instants of a TemporalI */
+
+static TimestampTz *
+temporali_times(TemporalI *ti)
+{
+	TimestampTz *result = palloc(sizeof(TimestampTz) * ti->count);
+	for (int i = 0; i < ti->count; i++)
+		result[i] = temporali_inst_n(ti, i)->t;
+	return result;
+}
+
+/*
+ * Position of the first timestamp of the array from position from that is
+ * greater than t, or greater than or equal to t when strict is false
+ */
+
+static int
+timestamparr_bound(const TimestampTz *times, int from, int count,
+	TimestampTz t, bool strict)
+{
+	int first = from, last = count;
+	while (first < last)
+	{
+		int middle = (first + last) / 2;
+		int cmp = timestamp_cmp_internal(times[middle], t);
+		if (cmp < 0 || (strict && cmp == 0))
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	return first;
+}
+
+/*
+ * Select the instants whose timestamp is in the period, starting from
+ * position from. Return the position after the last selected instant.
+ */
+
+static int
+temporali_select_period(const TimestampTz *times, int from, int count,
+	Period *p, bool *selected, int *newcount)
+{
+	int lower = timestamparr_bound(times, from, count, p->lower, ! p->lower_inc);
+	int upper = timestamparr_bound(times, lower, count, p->upper, p->upper_inc);
+	for (int i = lower; i < upper; i++)
+		selected[i] = true;
+	*newcount += upper - lower;
+	return upper;
+}
+
+/*
+ * Select the instants whose timestamp is in the timestamp set. When the
+ * timestamp set is much smaller than the instant set, each timestamp is
+ * searched for, otherwise both arrays are merged.
+ */
+
+static int
+temporali_select_timestampset(const TimestampTz *times, int count,
+	TimestampSet *ts, bool *selected)
+{
+	const TimestampTz *times2 = timestampset_times_ptr(ts);
+	int result = 0;
+	if (ts->count * 8 < count)
+	{
+		int pos = 0;
+		for (int j = 0; j < ts->count && pos < count; j++)
+		{
+			pos = timestamparr_bound(times, pos, count, times2[j], false);
+			if (pos < count && times[pos] == times2[j])
+			{
+				selected[pos++] = true;
+				result++;
+			}
+		}
+		return result;
+	}
+
+	int i = 0, j = 0;
+	while (i < count && j < ts->count)
+	{
+		TimestampTz t1 = times[i], t2 = times2[j];
+		bool eq = (t1 == t2);
+		selected[i] |= eq;
+		result += eq;
+		i += (t1 <= t2);
+		j += (t2 <= t1);
+	}
+	return result;
+}
+
+/* Number of consecutive selected instants from position i */
+
+static int
+temporali_select_run(TemporalI *ti, const bool *selected, int i)
+{
+	int j = i;
+	while (j < ti->count && selected[j])
+		j++;
+	return j;
+}
+
+/* Size of the instants of a TemporalI from position i to position j - 1 */
+
+static size_t
+temporali_select_size(TemporalI *ti, int i, int j)
+{
+	return ti->offsets[j - 1] - ti->offsets[i] +
+		double_pad(VARSIZE(temporali_inst_n(ti, j - 1)));
+}
+
+/*
+ * Construct a TemporalI from the count instants of a TemporalI that are
+ * selected. If minus is true, the instants that are not selected are kept.
+ */
+
+static TemporalI *
+temporali_select(TemporalI *ti, bool *selected, int count, bool minus)
+{
+	if (minus)
+	{
+		for (int i = 0; i < ti->count; i++)
+			selected[i] = ! selected[i];
+		count = ti->count - count;
+	}
+	if (count == 0)
+		return NULL;
+	if (count == ti->count)
+		return temporali_copy(ti);
+
+	/* Get the bounding box size */
+	size_t bboxsize = temporal_bbox_size(ti->valuetypid);
+	size_t memsize = double_pad(bboxsize);
+	/* Add the size of the runs of selected instants */
+	int i = 0;
+	while (i < ti->count)
+	{
+		if (! selected[i])
+		{
+			i++;
+			continue;
+		}
+		int j = temporali_select_run(ti, selected, i);
+		memsize += temporali_select_size(ti, i, j);
+		i = j;
+	}
+	size_t pdata = double_pad(sizeof(TemporalI) + count * sizeof(size_t));
+	/* Create the TemporalI */
+	TemporalI *result = palloc0(pdata + memsize);
+	SET_VARSIZE(result, pdata + memsize);
+	result->count = count;
+	result->valuetypid = ti->valuetypid;
+	result->duration = TEMPORALI;
+	result->flags = ti->flags;
+	/* Copy each run of selected instants and shift their offsets */
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
+	size_t pos = 0;
+	int k = 0;
+	i = 0;
+	while (i < ti->count)
+	{
+		if (! selected[i])
+		{
+			i++;
+			continue;
+		}
+		int j = temporali_select_run(ti, selected, i);
+		size_t size = temporali_select_size(ti, i, j);
+		memcpy(((char *)result) + pdata + pos, temporali_inst_n(ti, i), size);
+		for (int l = i; l < j; l++)
+		{
+			result->offsets[k] = pos + ti->offsets[l] - ti->offsets[i];
+			instants[k] = temporali_inst_n(result, k);
+			k++;
+		}
+		pos += size;
+		i = j;
+	}
+	/* Precompute the bounding box */
+	if (bboxsize != 0)
+	{
+		void *bbox = ((char *) result) + pdata + pos;
+		temporali_make_bbox(bbox, instants, count);
+		result->offsets[count] = pos;
+	}
+	pfree(instants);
+	return result;
+}
+
+/*
+ * Restriction to a timestamp set or to its complement
+ */
+
+static TemporalI *
+temporali_restrict_timestampset(TemporalI *ti, TimestampSet *ts, bool minus)
+{
+	TimestampTz *times = temporali_times(ti);
+	bool *selected = palloc0(sizeof(bool) * ti->count);
+	int count = temporali_select_timestampset(times, ti->count, ts, selected);
+	TemporalI *result = temporali_select(ti, selected, count, minus);
+	pfree(times); pfree(selected);
+	return result;
+}
+
+/*
+ * Restriction to a period set or to its complement
+ */
+
+static TemporalI *
+temporali_restrict_periodset(TemporalI *ti, Period **periods, int count,
+	bool minus)
+{
+	TimestampTz *times = temporali_times(ti);
+	bool *selected = palloc0(sizeof(bool) * ti->count);
+	int newcount = 0, pos = 0;
+	for (int i = 0; i < count && pos < ti->count; i++)
+		pos = temporali_select_period(times, pos, ti->count, periods[i],
+			selected, &newcount);
+	TemporalI *result = temporali_select(ti, selected, newcount, minus);
+	pfree(times); pfree(selected);
+	return result;
+}
+
 /* 
  * Restriction to a timestamp set
  */
@@ -1388,27 +1637,7 @@ temporali_at_timestampset(TemporalI *ti, TimestampSet *ts)
 	}
 
 	/* General case */
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ts->count);
-	int count = 0;
-	int i = 0, j = 0;
-	while (i < ts->count && j < ti->count) 
-	{
-		TemporalInst *inst = temporali_inst_n(ti, j);
-		TimestampTz t = timestampset_time_n(ts, i);
-		if (timestamp_cmp_internal(t, inst->t) == 0)
-		{
-			instants[count++] = inst;
-			i++;
-		}
-		if (timestamp_cmp_internal(t, inst->t) < 0)
-			i++;
-		if (timestamp_cmp_internal(t, inst->t) > 0)
-			j++;
-	}	
-	TemporalI *result = (count == 0) ? NULL :
-		temporali_from_temporalinstarr(instants, count);
-	pfree(instants);
-	return result;
+	return temporali_restrict_timestampset(ti, ts, false);
 }
 
 /*
@@ -1438,25 +1667,7 @@ temporali_minus_timestampset(TemporalI *ti, TimestampSet *ts)
 	}
 
 	/* General case */
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
-	int count = 0;
-	int i = 0, j = 0;
-	while (i < ts->count && j < ti->count)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, j);
-		TimestampTz t = timestampset_time_n(ts, i);
-		if (timestamp_cmp_internal(t, inst->t) <= 0)
-			i++;
-		else /* (timestamp_cmp_internal(t, inst->t) > 0) */
-		{
-			instants[count++] = inst;
-			j++;
-		}
-	}
-	TemporalI *result = (count == 0) ? NULL :
-		temporali_from_temporalinstarr(instants, count);
-	pfree(instants);
-	return result;
+	return temporali_restrict_timestampset(ti, ts, true);
 }
 
 /* Restriction to the period */
@@ -1475,18 +1686,7 @@ temporali_at_period(TemporalI *ti, Period *period)
 		return temporali_copy(ti);
 
 	/* General case */
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
-	int count = 0;
-	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		if (contains_period_timestamp_internal(period, inst->t))
-			instants[count++] = inst;
-	}
-	TemporalI *result = (count == 0) ? NULL :
-		temporali_from_temporalinstarr(instants, count);
-	pfree(instants);
-	return result;
+	return temporali_restrict_periodset(ti, &period, 1, false);
 }
 
 /* Restriction to the complement of a period */
@@ -1505,18 +1705,7 @@ temporali_minus_period(TemporalI *ti, Period *period)
 		return NULL;
 
 	/* General case */
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
-	int count = 0;
-	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		if (!contains_period_timestamp_internal(period, inst->t))
-			instants[count++] = inst;
-	}
-	TemporalI *result = (count == 0) ? NULL : 
-		temporali_from_temporalinstarr(instants, count);
-	pfree(instants);
-	return result;
+	return temporali_restrict_periodset(ti, &period, 1, true);
 }
 
 /* Restriction to a period set */
@@ -1548,17 +1737,10 @@ temporali_at_periodset(TemporalI *ti, PeriodSet *ps)
 	}
 
 	/* General case */
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
-	int count = 0;
-	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		if (contains_periodset_timestamp_internal(ps, inst->t))
-			instants[count++] = inst;
-	}
-	TemporalI *result = (count == 0) ? NULL :
-		temporali_from_temporalinstarr(instants, count);
-	pfree(instants);
+	Period **periods = periodset_periods_internal(ps);
+	TemporalI *result = temporali_restrict_periodset(ti, periods, ps->count,
+		false);
+	pfree(periods);
 	return result;
 }
 
@@ -1591,17 +1773,10 @@ temporali_minus_periodset(TemporalI *ti, PeriodSet *ps)
 	}
 
 	/* General case */
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ti->count);
-	int count = 0;
-	for (int i = 0; i < ti->count; i++)
-	{
-		TemporalInst *inst = temporali_inst_n(ti, i);
-		if (!contains_periodset_timestamp_internal(ps, inst->t))
-			instants[count++] = inst;
-	}
-	TemporalI *result = (count == 0) ? NULL :
-		temporali_from_temporalinstarr(instants, count);
-	pfree(instants);
+	Period **periods = periodset_periods_internal(ps);
+	TemporalI *result = temporali_restrict_periodset(ti, periods, ps->count,
+		true);
+	pfree(periods);
 	return result;
 }
 
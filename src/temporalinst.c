@@ -13,6 +13,8 @@
 #include "temporalinst.h"
 
 #include <assert.h>
+#include <math.h>
+#include <access/hash.h>
 #include <libpq/pqformat.h>
 #include <utils/builtins.h>
 #include <utils/timestamp.h>
@@ -162,6 +164,28 @@ temporalinst_append_instant(TemporalInst *inst1, TemporalInst *inst2)
 	return temporali_from_temporalinstarr(instants, 2);
 }
 
+/* 
+ * Construct an array of instants that are copies of the model instant with
+ * the given timestamps. The instants are allocated in a single block, the
+ * caller overwrites their values in place and frees them by freeing the 
+ * first instant and the array.
+ */
+TemporalInst **
+temporalinstarr_from_model(TemporalInst *model, const TimestampTz *times, 
+	int count)
+{
+	size_t size = double_pad(VARSIZE(model));
+	char *block = palloc(size * count);
+	TemporalInst **result = palloc(sizeof(TemporalInst *) * count);
+	for (int i = 0; i < count; i++)
+	{
+		result[i] = (TemporalInst *) (block + i * size);
+		memcpy(result[i], model, VARSIZE(model));
+		result[i]->t = times[i];
+	}
+	return result;
+}
+
 /* Copy a temporal value */
 TemporalInst *
 temporalinst_copy(TemporalInst *inst)
@@ -176,27 +200,22 @@ temporalinst_copy(TemporalInst *inst)
  *****************************************************************************/
 
 /* 
- * Output a temporal value as a string. 
+ * Append the string representation of a temporal value to the buffer
  */
-char *
-temporalinst_to_string(TemporalInst *inst, char *(*value_out)(Oid, Datum))
+void
+temporalinst_to_string_buf(StringInfo buf, TemporalInst *inst,
+	void (*value_out)(StringInfo, Oid, Datum))
 {
-	char *t = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(inst->t));
-	char *value = value_out(inst->valuetypid, temporalinst_value(inst));
-	char *result;
 	if (inst->valuetypid == TEXTOID)
 	{
-		result = palloc(strlen(value) + strlen(t) + 4);
-		sprintf(result, "\"%s\"@%s", value, t);
+		appendStringInfoChar(buf, '"');
+		value_out(buf, inst->valuetypid, temporalinst_value(inst));
+		appendStringInfoChar(buf, '"');
 	}
 	else
-	{
-		result = palloc(strlen(value) + strlen(t) + 2);
-		sprintf(result, "%s@%s", value, t);
-	}
-	pfree(t);
-	pfree(value);
-	return result;
+		value_out(buf, inst->valuetypid, temporalinst_value(inst));
+	appendStringInfoChar(buf, '@');
+	timestamptz_to_string_buf(buf, inst->t);
 }
 
 /* 
@@ -366,6 +385,17 @@ temporalinst_timestamps(TemporalInst *inst)
 	return timestamparr_to_array(&t, 1);
 }
 
+/* Add the bytes of the instant to the breakdown of its memory layout */
+
+void
+temporalinst_layout(TemporalInst *inst, TemporalLayout *layout)
+{
+	size_t header = double_pad(sizeof(TemporalInst));
+	layout->instant_headers += header - sizeof(TimestampTz);
+	layout->timestamps += sizeof(TimestampTz);
+	layout->base_values += double_pad(VARSIZE(inst)) - header;
+}
+
 /* Instants */
 
 ArrayType *
@@ -380,9 +410,7 @@ TemporalInst *
 temporalinst_shift(TemporalInst *inst, Interval *interval)
 {
 	TemporalInst *result = temporalinst_copy(inst);
-	result->t = DatumGetTimestampTz(
-		DirectFunctionCall2(timestamptz_pl_interval,
-		TimestampTzGetDatum(inst->t), PointerGetDatum(interval)));
+	result->t = timestamp_shift(inst->t, interval);
 	return result;
 }
 
@@ -495,11 +523,10 @@ temporalinst_minus_values(TemporalInst *inst, Datum *values, int count)
 /* Restriction to the range */
 
 TemporalInst *
-tnumberinst_at_range(TemporalInst *inst, RangeType *range)
+tnumberinst_at_range(TemporalInst *inst, const RangeBounds *bounds)
 {
 	Datum d = temporalinst_value(inst);
-	TypeCacheEntry* typcache = lookup_type_cache(range->rangetypid, TYPECACHE_RANGE_INFO);
-	bool contains = range_contains_elem_internal(typcache, range, d);
+	bool contains = range_bounds_contains_elem(bounds, d);
 	if (!contains) 
 		return NULL;
 	return temporalinst_copy(inst);
@@ -508,11 +535,10 @@ tnumberinst_at_range(TemporalInst *inst, RangeType *range)
 /* Restriction to the complement of a range */
 
 TemporalInst *
-tnumberinst_minus_range(TemporalInst *inst, RangeType *range)
+tnumberinst_minus_range(TemporalInst *inst, const RangeBounds *bounds)
 {
 	Datum d = temporalinst_value(inst);
-	TypeCacheEntry* typcache = lookup_type_cache(range->rangetypid, TYPECACHE_RANGE_INFO);
-	bool contains = range_contains_elem_internal(typcache, range, d);
+	bool contains = range_bounds_contains_elem(bounds, d);
 	if (contains)
 		return NULL;
 	return temporalinst_copy(inst);
@@ -522,33 +548,25 @@ tnumberinst_minus_range(TemporalInst *inst, RangeType *range)
  * The function assumes that the ranges are normalized. */
 
 TemporalInst *
-tnumberinst_at_ranges(TemporalInst *inst, RangeType **normranges, int count)
+tnumberinst_at_ranges(TemporalInst *inst, const RangeBounds *normbounds,
+	int count)
 {
-	Datum d = temporalinst_value(inst);
-	TypeCacheEntry *typcache = lookup_type_cache(normranges[0]->rangetypid,
-		 TYPECACHE_RANGE_INFO);
-	for (int i = 0; i < count; i++)
-	{
-		if (range_contains_elem_internal(typcache, normranges[i], d))
-			return temporalinst_copy(inst);
-	}
-	return NULL;
+	if (!rangearr_bounds_contains_elem(normbounds, count,
+			temporalinst_value(inst)))
+		return NULL;
+	return temporalinst_copy(inst);
 }
 
 /* Restriction to the complement of ranges.
  * The function assumes that the ranges are normalized. */
 
 TemporalInst *
-tnumberinst_minus_ranges(TemporalInst *inst, RangeType **normranges, int count)
+tnumberinst_minus_ranges(TemporalInst *inst, const RangeBounds *normbounds,
+	int count)
 {
-	Datum d = temporalinst_value(inst);
-	TypeCacheEntry *typcache = lookup_type_cache(normranges[0]->rangetypid,
-		 TYPECACHE_RANGE_INFO);
-	for (int i = 0; i < count; i++)
-	{
-		if (range_contains_elem_internal(typcache, normranges[i], d))
-			return NULL;
-	}
+	if (rangearr_bounds_contains_elem(normbounds, count,
+			temporalinst_value(inst)))
+		return NULL;
 	return temporalinst_copy(inst);
 }
 
@@ -753,6 +771,48 @@ temporalinst_cmp(TemporalInst *inst1, TemporalInst *inst2)
  * the lower and upper bounds.
  *****************************************************************************/
 
+/*
+ * The following functions compute the same hash values as the functions
+ * hashchar, hashint4, hashint8, hashfloat8, and hashtext of PostgreSQL, so 
+ * that existing hash indexes remain valid, but they avoid the overhead of 
+ * calling them through the function manager for every instant
+ */
+
+static uint32
+hash_int8_direct(int64 val)
+{
+	/* As for hashint8, the hash of a value fitting in 32 bits is the same 
+	 * as the one computed by hashint4 */
+	uint32 lohalf = (uint32) val;
+	uint32 hihalf = (uint32) (val >> 32);
+	lohalf ^= (val >= 0) ? hihalf : ~hihalf;
+	return DatumGetUInt32(hash_uint32(lohalf));
+}
+
+static uint32
+hash_float8_direct(Datum value)
+{
+	float8 key = DatumGetFloat8(value);
+	/* Minus zero and zero have the same hash value */
+	if (key == (float8) 0)
+		return 0;
+	/* All NaNs are hashed as the canonical NaN */
+	if (isnan(key))
+		return DatumGetUInt32(call_function1(hashfloat8, value));
+	return DatumGetUInt32(hash_any((unsigned char *) &key, sizeof(key)));
+}
+
+static uint32
+hash_text_direct(Datum value)
+{
+	text *key = DatumGetTextPP(value);
+	uint32 result = DatumGetUInt32(hash_any((unsigned char *) VARDATA_ANY(key),
+		VARSIZE_ANY_EXHDR(key)));
+	if ((Pointer) key != DatumGetPointer(value))
+		pfree(key);
+	return result;
+}
+
 uint32
 temporalinst_hash(TemporalInst *inst)
 {
@@ -764,20 +824,20 @@ temporalinst_hash(TemporalInst *inst)
 	uint32 value_hash = 0; 
 	ensure_temporal_base_type(inst->valuetypid);
 	if (inst->valuetypid == BOOLOID)
-		value_hash = DatumGetUInt32(call_function1(hashchar, value));
+		value_hash = DatumGetUInt32(hash_uint32((int32) DatumGetChar(value)));
 	else if (inst->valuetypid == INT4OID)
-		value_hash = DatumGetUInt32(call_function1(hashint4, value));
+		value_hash = DatumGetUInt32(hash_uint32((uint32) DatumGetInt32(value)));
 	else if (inst->valuetypid == FLOAT8OID)
-		value_hash = DatumGetUInt32(call_function1(hashfloat8, value));
+		value_hash = hash_float8_direct(value);
 	else if (inst->valuetypid == TEXTOID)
-		value_hash = DatumGetUInt32(call_function1(hashtext, value));
+		value_hash = hash_text_direct(value);
 #ifdef WITH_POSTGIS
 	else if (inst->valuetypid == type_oid(T_GEOMETRY) || 
 		inst->valuetypid == type_oid(T_GEOGRAPHY))
 		value_hash = DatumGetUInt32(call_function1(lwgeom_hash, value));
 #endif
 	/* Apply the hash function according to the timestamp */
-	time_hash = DatumGetUInt32(call_function1(hashint8, TimestampTzGetDatum(inst->t)));
+	time_hash = hash_int8_direct(inst->t);
 
 	/* Merge hashes of value and timestamp */
 	result = value_hash;
@@ -43,22 +43,61 @@
  *	( TemporalS )_ X | offset_0 | offset_1 | offset_2 | ...
  *	--------------------------------------------------------
  *	--------------------------------------------------------
- *	( TemporalSeq_0 )_X | ( TemporalSeq_1 )_X | ( bbox )_X | 
+ *	( Period_0 | Period_1 )_X | ( TemporalSeq_0 )_X | ...
+ *	--------------------------------------------------------
+ *	--------------------------------------------------------
+ *	( TemporalSeq_1 )_X | ( bbox )_X | 
  *	--------------------------------------------------------
  *
  * where the X are unused bytes added for double padding, offset_0 and offset_1
  * are offsets for the corresponding sequences and offset_2 is the offset for the 
- * bounding box. There is no precomputed trajectory for TemporalS.
+ * bounding box. Period_0 and Period_1 are copies of the periods of the 
+ * sequences, which are kept contiguous so that searching for a timestamp or 
+ * a period does not need to access the sequences. There is no precomputed 
+ * trajectory for TemporalS.
+ *
+ * The array of periods is only present when the TEMPORALS_PERIODS flag is set
+ * in the format field. Values written in the first on-disk format do not have
+ * it, they are converted when they are read by temporals_with_periods.
  */
 
+/* Size of the array of periods of a TemporalS with count sequences */
+
+static size_t
+temporals_periods_size(int count)
+{
+	return double_pad(sizeof(Period) * count);
+}
+
+/* Start of the data of a TemporalS, after the array of periods */
+
+static char *
+temporals_data_ptr(TemporalS *ts)
+{
+	char *result = (char *)(&ts->offsets[ts->count + 1]);
+	if (ts->format & TEMPORALS_PERIODS)
+		result += temporals_periods_size(ts->count);
+	return result;
+}
+
+/* Period of the N-th TemporalSeq of a TemporalS */
+
+Period *
+temporals_period_n(TemporalS *ts, int index)
+{
+	if (! (ts->format & TEMPORALS_PERIODS))
+		return &temporals_seq_n(ts, index)->period;
+	return (Period *)(&ts->offsets[ts->count + 1]) + index;
+}
+
 /* N-th TemporalSeq of a TemporalS */
 
 TemporalSeq *
 temporals_seq_n(TemporalS *ts, int index)
 {
 	return (TemporalSeq *)(
-		(char *)(&ts->offsets[ts->count + 1]) + 	/* start of data */
-			ts->offsets[index]);					/* offset */
+		temporals_data_ptr(ts) + 	/* start of data */
+			ts->offsets[index]);	/* offset */
 }
 
 /* Pointer to the bounding box of a TemporalS */
@@ -66,8 +105,8 @@ temporals_seq_n(TemporalS *ts, int index)
 void *
 temporals_bbox_ptr(TemporalS *ts) 
 {
-	return (char *)(&ts->offsets[ts->count + 1]) +  /* start of data */
-		ts->offsets[ts->count];						/* offset */
+	return temporals_data_ptr(ts) +		/* start of data */
+		ts->offsets[ts->count];			/* offset */
 }
 
 /* Copy the bounding box of a TemporalS in the first argument */
@@ -80,27 +119,22 @@ temporals_bbox(void *box, TemporalS *ts)
 	memcpy(box, box1, bboxsize);
 }
 
-/* Construct a TemporalS from an array of TemporalSeq 
- * The normalize argument determines whether the resulting value will be
- * normalized. In particular, normalize is false when synchronizing two 
- * TemporalS before applying an operation to them */
+/* Test the validity of an array of TemporalSeq for constructing a
+ * TemporalS */
 
-TemporalS *
-temporals_from_temporalseqarr(TemporalSeq **sequences, int count, 
-	bool linear, bool normalize)
+static void
+temporals_ensure_valid(TemporalSeq **sequences, int count)
 {
 	assert(count > 0);
-	Oid valuetypid = sequences[0]->valuetypid;
-	/* Test the validity of the sequences */
 #ifdef WITH_POSTGIS
+	Oid valuetypid = sequences[0]->valuetypid;
 	bool isgeo = (valuetypid == type_oid(T_GEOMETRY) ||
 		valuetypid == type_oid(T_GEOGRAPHY));
-	bool hasz = false, isgeodetic = false;
+	bool hasz = false;
 	int srid;
 	if (isgeo)
 	{
 		hasz = MOBDB_FLAGS_GET_Z(sequences[0]->flags);
-		isgeodetic = MOBDB_FLAGS_GET_GEODETIC(sequences[0]->flags);
 		srid = tpoint_srid_internal((Temporal *) sequences[0]);
 	}
 #endif
@@ -127,14 +161,39 @@ temporals_from_temporalseqarr(TemporalSeq **sequences, int count,
 		}
 #endif
 	}
+}
 
+/* Construct a TemporalS from an array of TemporalSeq without testing their
+ * validity. This function is used for the sequences computed from valid
+ * temporal values, e.g., in the restriction functions, where the sequences
+ * are known to be ordered and disjoint.
+ * The normalize argument determines whether the resulting value will be
+ * normalized. */
+
+TemporalS *
+temporals_from_temporalseqarr_trusted(TemporalSeq **sequences, int count,
+	bool linear, bool normalize)
+{
+	assert(count > 0);
+	Oid valuetypid = sequences[0]->valuetypid;
+#ifdef WITH_POSTGIS
+	bool isgeo = (valuetypid == type_oid(T_GEOMETRY) ||
+		valuetypid == type_oid(T_GEOGRAPHY));
+	bool hasz = false, isgeodetic = false;
+	if (isgeo)
+	{
+		hasz = MOBDB_FLAGS_GET_Z(sequences[0]->flags);
+		isgeodetic = MOBDB_FLAGS_GET_GEODETIC(sequences[0]->flags);
+	}
+#endif
 	TemporalSeq **newsequences = sequences;
 	int newcount = count;
 	if (normalize && count > 1)
 		newsequences = temporalseqarr_normalize(sequences, count, &newcount);
 	/* Add the size of the struct and the offset array 
 	 * Notice that the first offset is already declared in the struct */
-	size_t pdata = double_pad(sizeof(TemporalS)) + newcount * sizeof(size_t);
+	size_t pdata = double_pad(sizeof(TemporalS)) + newcount * sizeof(size_t) +
+		temporals_periods_size(newcount);
 	size_t memsize = 0;
 	int totalcount = 0;
 	for (int i = 0; i < newcount; i++)
@@ -149,6 +208,7 @@ temporals_from_temporalseqarr(TemporalSeq **sequences, int count,
 	SET_VARSIZE(result, pdata + memsize);
 	result->count = newcount;
 	result->totalcount = totalcount;
+	result->format = TEMPORALS_PERIODS;
 	result->valuetypid = valuetypid;
 	result->duration = TEMPORALS;
 	MOBDB_FLAGS_SET_LINEAR(result->flags, linear);
@@ -163,6 +223,7 @@ temporals_from_temporalseqarr(TemporalSeq **sequences, int count,
 	size_t pos = 0;	
 	for (int i = 0; i < newcount; i++)
 	{
+		*temporals_period_n(result, i) = newsequences[i]->period;
 		memcpy(((char *) result) + pdata + pos, newsequences[i], VARSIZE(newsequences[i]));
 		result->offsets[i] = pos;
 		pos += double_pad(VARSIZE(newsequences[i]));
@@ -187,6 +248,112 @@ temporals_from_temporalseqarr(TemporalSeq **sequences, int count,
 	return result;
 }
 
+/* Construct a TemporalS from an array of TemporalSeq 
+ * The normalize argument determines whether the resulting value will be
+ * normalized. In particular, normalize is false when synchronizing two 
+ * TemporalS before applying an operation to them */
+
+TemporalS *
+temporals_from_temporalseqarr(TemporalSeq **sequences, int count, 
+	bool linear, bool normalize)
+{
+	temporals_ensure_valid(sequences, count);
+	return temporals_from_temporalseqarr_trusted(sequences, count, linear,
+		normalize);
+}
+
+/* Construct a temporal number sequence set that takes a constant value
+ * during an array of periods. The value is written directly into the
+ * instants of the result, which is built with a single allocation instead
+ * of constructing one TemporalSeq per period. Periods with equal bounds
+ * yield instantaneous sequences. The periods must be ordered, disjoint, and
+ * non-adjacent, as those computed by tnumberseq_at_value_periods. */
+
+TemporalS *
+tnumbers_from_base_periodarr(Datum value, Oid valuetypid, 
+	const Period *periods, int count, bool linear)
+{
+	assert(count > 0);
+	assert(valuetypid == INT4OID || valuetypid == FLOAT8OID);
+	double dvalue = datum_double(value, valuetypid);
+	/* Sizes of a TemporalInst, and of a TemporalSeq with 1 and 2 instants */
+	size_t instsize = double_pad(sizeof(TemporalInst)) + 
+		double_pad(sizeof(Datum));
+	size_t bboxsize = double_pad(sizeof(TBOX));
+	size_t seqpdata[2], seqsize[2];
+	for (int n = 1; n <= 2; n++)
+	{
+		seqpdata[n - 1] = double_pad(sizeof(TemporalSeq)) + 
+			(n + 1) * sizeof(size_t);
+		seqsize[n - 1] = seqpdata[n - 1] + n * instsize + bboxsize;
+	}
+	size_t pdata = double_pad(sizeof(TemporalS)) + count * sizeof(size_t) +
+		temporals_periods_size(count);
+	size_t memsize = bboxsize;
+	int totalcount = 0;
+	for (int i = 0; i < count; i++)
+	{
+		int n = (periods[i].lower == periods[i].upper) ? 1 : 2;
+		memsize += seqsize[n - 1];
+		totalcount += n;
+	}
+	TemporalS *result = palloc0(pdata + memsize);
+	SET_VARSIZE(result, pdata + memsize);
+	result->count = count;
+	result->totalcount = totalcount;
+	result->format = TEMPORALS_PERIODS;
+	result->valuetypid = valuetypid;
+	result->duration = TEMPORALS;
+	MOBDB_FLAGS_SET_LINEAR(result->flags, linear);
+	/* Initialization of the variable-length part */
+	size_t pos = 0;
+	for (int i = 0; i < count; i++)
+	{
+		const Period *p = &periods[i];
+		int n = (p->lower == p->upper) ? 1 : 2;
+		*temporals_period_n(result, i) = *p;
+		result->offsets[i] = pos;
+		TemporalSeq *seq = (TemporalSeq *)(((char *) result) + pdata + pos);
+		SET_VARSIZE(seq, seqsize[n - 1]);
+		seq->count = n;
+		seq->valuetypid = valuetypid;
+		seq->duration = TEMPORALSEQ;
+		seq->period = *p;
+		MOBDB_FLAGS_SET_LINEAR(seq->flags, linear);
+		for (int j = 0; j < n; j++)
+		{
+			TemporalInst *inst = (TemporalInst *)(((char *) seq) + 
+				seqpdata[n - 1] + j * instsize);
+			SET_VARSIZE(inst, instsize);
+			inst->duration = TEMPORALINST;
+			inst->valuetypid = valuetypid;
+			inst->t = (j == 0) ? p->lower : p->upper;
+			MOBDB_FLAGS_SET_BYVAL(inst->flags, true);
+			MOBDB_FLAGS_SET_LINEAR(inst->flags, 
+				linear_interpolation(valuetypid));
+			memcpy(((char *) inst) + double_pad(sizeof(TemporalInst)), 
+				&value, sizeof(Datum));
+			seq->offsets[j] = j * instsize;
+		}
+		seq->offsets[n] = n * instsize;
+		TBOX *box = (TBOX *) temporalseq_bbox_ptr(seq);
+		box->xmin = box->xmax = dvalue;
+		box->tmin = p->lower;
+		box->tmax = p->upper;
+		MOBDB_FLAGS_SET_X(box->flags, true);
+		MOBDB_FLAGS_SET_T(box->flags, true);
+		pos += seqsize[n - 1];
+	}
+	result->offsets[count] = pos;
+	TBOX *box = (TBOX *) temporals_bbox_ptr(result);
+	box->xmin = box->xmax = dvalue;
+	box->tmin = periods[0].lower;
+	box->tmax = periods[count - 1].upper;
+	MOBDB_FLAGS_SET_X(box->flags, true);
+	MOBDB_FLAGS_SET_T(box->flags, true);
+	return result;
+}
+
  /* Append an TemporalInst to to the last sequence of a TemporalS */
 
 TemporalS *
@@ -197,7 +364,8 @@ temporals_append_instant(TemporalS *ts, TemporalInst *inst)
 	TemporalSeq *newseq = temporalseq_append_instant(seq, inst);
 	/* Add the size of the struct and the offset array 
 	 * Notice that the first offset is already declared in the struct */
-	size_t pdata = double_pad(sizeof(TemporalS)) + ts->count * sizeof(size_t);
+	size_t pdata = double_pad(sizeof(TemporalS)) + ts->count * sizeof(size_t) +
+		temporals_periods_size(ts->count);
 	/* Get the bounding box size */
 	size_t bboxsize = temporal_bbox_size(ts->valuetypid);
 	size_t memsize = double_pad(bboxsize);
@@ -210,6 +378,7 @@ temporals_append_instant(TemporalS *ts, TemporalInst *inst)
 	SET_VARSIZE(result, pdata + memsize);
 	result->count = ts->count;
 	result->totalcount = ts->totalcount - seq->count + newseq->count;
+	result->format = TEMPORALS_PERIODS;
 	result->valuetypid = ts->valuetypid;
 	result->duration = TEMPORALS;
 	MOBDB_FLAGS_SET_LINEAR(result->flags, MOBDB_FLAGS_GET_LINEAR(ts->flags));
@@ -219,6 +388,9 @@ temporals_append_instant(TemporalS *ts, TemporalInst *inst)
 		MOBDB_FLAGS_SET_Z(result->flags, MOBDB_FLAGS_GET_Z(ts->flags));
 #endif
 	/* Initialization of the variable-length part */
+	for (int i = 0; i < ts->count - 1; i++)
+		*temporals_period_n(result, i) = *temporals_period_n(ts, i);
+	*temporals_period_n(result, ts->count - 1) = newseq->period;
 	size_t pos = 0;	
 	for (int i = 0; i < ts->count - 1; i++)
 	{
@@ -255,6 +427,25 @@ temporals_copy(TemporalS *ts)
 	return result;
 }
 
+/*
+ * Returns the sequence set with a directory of the periods of its sequences,
+ * converting the values in the first on-disk format
+ */
+
+TemporalS *
+temporals_with_periods(TemporalS *ts)
+{
+	if (ts->format & TEMPORALS_PERIODS)
+		return ts;
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
+	for (int i = 0; i < ts->count; i++)
+		sequences[i] = temporals_seq_n(ts, i);
+	TemporalS *result = temporals_from_temporalseqarr(sequences, ts->count,
+		MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
+	pfree(sequences);
+	return result;
+}
+
 /*****************************************************************************/
 
 /*
@@ -276,22 +467,22 @@ temporals_find_timestamp(TemporalS *ts, TimestampTz t, int *pos)
 {
 	int first = 0, last = ts->count - 1;
 	int middle = 0; /* make compiler quiet */
-	TemporalSeq *seq = NULL; /* make compiler quiet */
+	Period *p = NULL; /* make compiler quiet */
 	while (first <= last) 
 	{
 		middle = (first + last)/2;
-		seq = temporals_seq_n(ts, middle);
-		if (contains_period_timestamp_internal(&seq->period, t))
+		p = temporals_period_n(ts, middle);
+		if (contains_period_timestamp_internal(p, t))
 		{
 			*pos = middle;
 			return true;
 		}
-		if (timestamp_cmp_internal(t, seq->period.lower) <= 0)
+		if (timestamp_cmp_internal(t, p->lower) <= 0)
 			last = middle - 1;
 		else
 			first = middle + 1;
 	}
-	if (timestamp_cmp_internal(t, seq->period.upper) >= 0)
+	if (timestamp_cmp_internal(t, p->upper) >= 0)
 		middle++;
 	*pos = middle;
 	return false;
@@ -620,43 +811,23 @@ synchronize_temporals_temporals(TemporalS *ts1, TemporalS *ts2,
  * Input/output functions
  *****************************************************************************/
 
-/* Convert to string */
+/* Append the string representation to the buffer */
  
-char *
-temporals_to_string(TemporalS *ts, char *(*value_out)(Oid, Datum))
+void
+temporals_to_string_buf(StringInfo buf, TemporalS *ts,
+	void (*value_out)(StringInfo, Oid, Datum))
 {
-	char **strings = palloc(sizeof(char *) * ts->count);
-	size_t outlen = 0;
-	char str[20];
 	if (linear_interpolation(ts->valuetypid) && 
 		! MOBDB_FLAGS_GET_LINEAR(ts->flags))
-		sprintf(str, "Interp=Stepwise;");
-	else
-		str[0] = '\0';
-	for (int i = 0; i < ts->count; i++)
-	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		strings[i] = temporalseq_to_string(seq, true, value_out);
-		outlen += strlen(strings[i]) + 2;
-	}
-	char *result = palloc(strlen(str) + outlen + 3);
-	result[outlen] = '\0';
-	size_t pos = 0;
-	strcpy(result, str);
-	pos += strlen(str);
-	result[pos++] = '{';
+		appendStringInfoString(buf, "Interp=Stepwise;");
+	appendStringInfoChar(buf, '{');
 	for (int i = 0; i < ts->count; i++)
 	{
-		strcpy(result + pos, strings[i]);
-		pos += strlen(strings[i]);
-		result[pos++] = ',';
-		result[pos++] = ' ';
-		pfree(strings[i]);
+		if (i > 0)
+			appendBinaryStringInfo(buf, ", ", 2);
+		temporalseq_to_string_buf(buf, temporals_seq_n(ts, i), true, value_out);
 	}
-	result[pos - 2] = '}';
-	result[pos - 1] = '\0';
-	pfree(strings);
-	return result;
+	appendStringInfoChar(buf, '}');
 }
 
 /* Send function */
@@ -733,6 +904,8 @@ tfloats_to_tints(TemporalS *ts)
 	for (int i = 0; i < ts->count; i++)
 	{
 		TemporalSeq *seq = temporals_seq_n(result, i);
+		/* The values are truncated, which changes the integral */
+		MOBDB_FLAGS_SET_SUMMARY(seq->flags, false);
 		for (int j = 0; j < seq->count; j++)
 		{
 			TemporalInst *inst = temporalseq_inst_n(seq, j);
@@ -816,12 +989,11 @@ temporals_values1(TemporalS *ts, int *count)
 {
 	Datum *result = palloc(sizeof(Datum *) * ts->totalcount);
 	int k = 0;
-	for (int i = 0; i < ts->count; i++)
-	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		for (int j = 0; j < seq->count; j++)
-			result[k++] = temporalinst_value(temporalseq_inst_n(seq, j));
-	}
+	TemporalInstIterator it;
+	TemporalInst *inst;
+	temporalinst_iterator_init(&it, (Temporal *)ts);
+	while ((inst = temporalinst_iterator_next(&it)) != NULL)
+		result[k++] = temporalinst_value(inst);
 	datum_sort(result, k, ts->valuetypid);
 	*count = datum_remove_duplicates(result, k, ts->valuetypid);
 	return result;
@@ -883,10 +1055,11 @@ temporals_min_value(TemporalS *ts)
 		return Float8GetDatum(box->xmin);
 	}
 	Datum result = temporalseq_min_value(temporals_seq_n(ts, 0));
+	const BaseTypeInfo *info = base_type_info(valuetypid);
 	for (int i = 1; i < ts->count; i++)
 	{
 		Datum value = temporalseq_min_value(temporals_seq_n(ts, i));
-		if (datum_lt(value, result, valuetypid))
+		if (info->lt(value, result))
 			result = value;
 	}
 	return result;
@@ -909,10 +1082,11 @@ temporals_max_value(TemporalS *ts)
 		return Float8GetDatum(box->xmax);
 	}
 	Datum result = temporalseq_max_value(temporals_seq_n(ts, 0));
+	const BaseTypeInfo *info = base_type_info(valuetypid);
 	for (int i = 1; i < ts->count; i++)
 	{
 		Datum value = temporalseq_max_value(temporals_seq_n(ts, i));
-		if (datum_gt(value, result, valuetypid))
+		if (info->lt(result, value))
 			result = value;
 	}
 	return result;
@@ -925,10 +1099,7 @@ temporals_get_time(TemporalS *ts)
 {
 	Period **periods = palloc(sizeof(Period *) * ts->count);
 	for (int i = 0; i < ts->count; i++)
-	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		periods[i] = &seq->period;
-	}
+		periods[i] = temporals_period_n(ts, i);
 	PeriodSet *result = periodset_from_periodarr_internal(periods, 
 		ts->count, false);
 	pfree(periods);
@@ -974,10 +1145,9 @@ temporals_interval_double(TemporalS *ts)
 void
 temporals_period(Period *p, TemporalS *ts)
 {
-	TemporalSeq *start = temporals_seq_n(ts, 0);
-	TemporalSeq *end = temporals_seq_n(ts, ts->count - 1);
-	period_set(p, start->period.lower, end->period.upper, 
-		start->period.lower_inc, end->period.upper_inc);
+	Period *start = temporals_period_n(ts, 0);
+	Period *end = temporals_period_n(ts, ts->count - 1);
+	period_set(p, start->lower, end->upper, start->lower_inc, end->upper_inc);
 }
 
 /* Sequences */
@@ -1083,12 +1253,11 @@ temporals_instants_array(TemporalS *ts)
 {
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ts->totalcount);
 	int k = 0;
-	for (int i = 0; i < ts->count; i++)
-	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		for (int j = 0; j < seq->count; j++)
-			instants[k++] = temporalseq_inst_n(seq, j);
-	}
+	TemporalInstIterator it;
+	TemporalInst *inst;
+	temporalinst_iterator_init(&it, (Temporal *)ts);
+	while ((inst = temporalinst_iterator_next(&it)) != NULL)
+		instants[k++] = inst;
 	int count = temporalinstarr_remove_duplicates(instants, k);
 	ArrayType *result = temporalarr_to_array((Temporal **)instants, count);
 	pfree(instants);
@@ -1187,29 +1356,15 @@ temporals_timestamp_n(TemporalS *ts, int n, TimestampTz *result)
 TimestampTz *
 temporals_timestamps1(TemporalS *ts, int *count)
 {
-	TimestampTz **times = palloc(sizeof(TimestampTz *) * ts->count);
-	int *counttimes = palloc0(sizeof(int) * ts->count);
+	TimestampTz *result = palloc(sizeof(TimestampTz) * ts->totalcount);
 	int totaltimes = 0;
-	for (int i = 0; i < ts->count; i++)
-	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		times[i] = temporalseq_timestamps1(seq);
-		counttimes[i] = seq->count;
-		totaltimes += seq->count;
-	}
-	TimestampTz *result = palloc(sizeof(TimestampTz) * totaltimes);
-	int k = 0;
-	for (int i = 0; i < ts->count; i++)
-	{
-		for (int j = 0; j < counttimes[i]; j ++)
-			result[k++] = times[i][j];
-		pfree(times[i]);
-	}
+	TemporalInstIterator it;
+	TemporalInst *inst;
+	temporalinst_iterator_init(&it, (Temporal *)ts);
+	while ((inst = temporalinst_iterator_next(&it)) != NULL)
+		result[totaltimes++] = inst->t;
 	timestamp_sort(result, totaltimes);
 	totaltimes = timestamp_remove_duplicates(result, totaltimes);
-	
-	pfree(times); pfree(counttimes);
-	
 	*count = totaltimes;
 	return result;
 }
@@ -1224,41 +1379,74 @@ temporals_timestamps(TemporalS *ts)
 	return result;
 }
 
+/* Add the bytes of the sequence set to the breakdown of its memory layout */
+
+void
+temporals_layout(TemporalS *ts, TemporalLayout *layout)
+{
+	layout->offsets += (ts->count + 1) * sizeof(size_t);
+	if (ts->format & TEMPORALS_PERIODS)
+		layout->offsets += temporals_periods_size(ts->count);
+	for (int i = 0; i < ts->count; i++)
+		temporalseq_layout(temporals_seq_n(ts, i), layout);
+	layout->bbox += double_pad(temporal_bbox_size(ts->valuetypid));
+}
+
 /* Shift the time span of a temporal value by an interval */
 
 TemporalS *
 temporals_shift(TemporalS *ts, Interval *interval)
 {
 	TemporalS *result = temporals_copy(ts);
-	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ts->totalcount);
 	for (int i = 0; i < ts->count; i++)
 	{
-		TemporalSeq *seq = sequences[i] = temporals_seq_n(result, i);
+		TemporalSeq *seq = temporals_seq_n(result, i);
 		for (int j = 0; j < seq->count; j++)
 		{
-			TemporalInst *inst = instants[j] = temporalseq_inst_n(seq, j);
-			inst->t = DatumGetTimestampTz(
-				DirectFunctionCall2(timestamptz_pl_interval,
-				TimestampTzGetDatum(inst->t), PointerGetDatum(interval)));
+			TemporalInst *inst = temporalseq_inst_n(seq, j);
+			inst->t = timestamp_shift(inst->t, interval);
 		}
 		/* Shift period */
-		seq->period.lower = DatumGetTimestampTz(
-				DirectFunctionCall2(timestamptz_pl_interval,
-				TimestampTzGetDatum(seq->period.lower), PointerGetDatum(interval)));
-		seq->period.upper = DatumGetTimestampTz(
-				DirectFunctionCall2(timestamptz_pl_interval,
-				TimestampTzGetDatum(seq->period.upper), PointerGetDatum(interval)));
+		seq->period.lower = timestamp_shift(seq->period.lower, interval);
+		seq->period.upper = timestamp_shift(seq->period.upper, interval);
+		*temporals_period_n(result, i) = seq->period;
 		/* Shift bounding box */
 		void *bbox = temporalseq_bbox_ptr(seq); 
 		shift_bbox(bbox, seq->valuetypid, interval);
-	
 	}
 	/* Shift bounding box */
 	void *bbox = temporals_bbox_ptr(result); 
 	shift_bbox(bbox, ts->valuetypid, interval);
-	pfree(sequences);
-	pfree(instants);
+	return result;
+}
+
+/*
+ * Scale the time span of a temporal value by a factor from an origin.
+ * The function errors when two sequences are scaled so that they overlap.
+ */
+
+TemporalS *
+temporals_tscale(TemporalS *ts, TimestampTz origin, double scale)
+{
+	TemporalS *result = temporals_copy(ts);
+	for (int i = 0; i < ts->count; i++)
+	{
+		TemporalSeq *seq = temporals_seq_n(result, i);
+		temporalseq_tscale1(seq, origin, scale);
+		*temporals_period_n(result, i) = seq->period;
+		if (i > 0)
+		{
+			Period *prev = temporals_period_n(result, i - 1);
+			if (prev->upper > seq->period.lower ||
+				(prev->upper == seq->period.lower && prev->upper_inc &&
+				seq->period.lower_inc))
+				ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+					errmsg("The interval is too small to scale the temporal value")));
+		}
+	}
+	/* Scale bounding box */
+	void *bbox = temporals_bbox_ptr(result); 
+	tscale_bbox(bbox, ts->valuetypid, origin, scale);
 	return result;
 }
 
@@ -1327,9 +1515,9 @@ temporals_ever_lt(TemporalS *ts, Datum value)
 		memset(&box, 0, sizeof(TBOX));
 		temporals_bbox(&box, ts);
 		double d = datum_double(value, ts->valuetypid);
-		/* Maximum value may be non inclusive */ 
-		if (d < box.xmin)
-			return false;
+		/* The minimum value may be taken only at an exclusive bound, but
+		 * then values arbitrarily close to it are taken */ 
+		return box.xmin < d;
 	}
 
 	for (int i = 0; i < ts->count; i++) 
@@ -1355,6 +1543,8 @@ temporals_ever_le(TemporalS *ts, Datum value)
 		double d = datum_double(value, ts->valuetypid);
 		if (d < box.xmin)
 			return false;
+		if (box.xmin < d)
+			return true;
 	}
 
 	for (int i = 0; i < ts->count; i++) 
@@ -1380,6 +1570,8 @@ temporals_always_lt(TemporalS *ts, Datum value)
 		double d = datum_double(value, ts->valuetypid);
 		if (d < box.xmax)
 			return false;
+		if (box.xmax < d)
+			return true;
 	}
 
 	for (int i = 0; i < ts->count; i++) 
@@ -1403,8 +1595,7 @@ temporals_always_le(TemporalS *ts, Datum value)
 		memset(&box, 0, sizeof(TBOX));
 		temporals_bbox(&box, ts);
 		double d = datum_double(value, ts->valuetypid);
-		if (d < box.xmax)
-			return false;
+		return box.xmax <= d;
 	}
 
 	for (int i = 0; i < ts->count; i++) 
@@ -1442,6 +1633,23 @@ temporals_at_value(TemporalS *ts, Datum value)
 	if (ts->count == 1)
 		return temporalseq_at_value(temporals_seq_n(ts, 0), value);
 
+	/* Temporal numbers are restricted from the periods where they take
+	 * the value */
+	if (valuetypid == INT4OID || valuetypid == FLOAT8OID)
+	{
+		double dvalue = datum_double(value, valuetypid);
+		Period *periods = palloc(sizeof(Period) * ts->totalcount);
+		int count = 0;
+		for (int i = 0; i < ts->count; i++)
+			count = tnumberseq_at_value_periods(temporals_seq_n(ts, i), dvalue,
+				periods, count);
+		TemporalS *result = (count == 0) ? NULL :
+			tnumbers_from_base_periodarr(value, valuetypid, periods, count,
+				MOBDB_FLAGS_GET_LINEAR(ts->flags));
+		pfree(periods);
+		return result;
+	}
+
 	/* General case */
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->totalcount);
 	int k = 0;
@@ -1456,7 +1664,7 @@ temporals_at_value(TemporalS *ts, Datum value)
 		return NULL;
 	}
 	
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);	
 	for (int i = 0; i < k; i++)
 		pfree(sequences[i]);
@@ -1505,7 +1713,7 @@ temporals_minus_value(TemporalS *ts, Datum value)
 		return NULL;
 	}
 
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
 	for (int i = 0; i < k; i++)
 		pfree(sequences[i]);
@@ -1537,7 +1745,7 @@ temporals_at_values(TemporalS *ts, Datum *values, int count)
 		pfree(sequences);
 		return NULL;
 	}
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
 	for (int i = 0; i < k; i++)
 		pfree(sequences[i]);
@@ -1575,7 +1783,7 @@ temporals_minus_values(TemporalS *ts, Datum *values, int count)
 		return NULL;
 	}
 
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
 	for (int i = 0; i < k; i++)
 		pfree(sequences[i]);
@@ -1587,20 +1795,20 @@ temporals_minus_values(TemporalS *ts, Datum *values, int count)
  * Restriction to a range.
  */
 TemporalS *
-tnumbers_at_range(TemporalS *ts, RangeType *range)
+tnumbers_at_range(TemporalS *ts, const RangeBounds *bounds)
 {
 	/* Bounding box test */
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
 	temporals_bbox(&box1, ts);
-	range_to_tbox_internal(&box2, range);
+	range_bounds_to_tbox(&box2, bounds);
 	if (!overlaps_tbox_tbox_internal(&box1, &box2))
 		return NULL;
 
 	/* Singleton sequence set */
 	if (ts->count == 1)
-		return tnumberseq_at_range(temporals_seq_n(ts, 0), range);
+		return tnumberseq_at_range(temporals_seq_n(ts, 0), bounds);
 
 	/* General case */
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->totalcount);
@@ -1608,14 +1816,14 @@ tnumbers_at_range(TemporalS *ts, RangeType *range)
 	for (int i = 0; i < ts->count; i++)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts, i);
-		k += tnumberseq_at_range2(&sequences[k], seq, range);
+		k += tnumberseq_at_range2(&sequences[k], seq, bounds);
 	}
 	if (k == 0)
 	{
 		pfree(sequences);
 		return NULL;
 	}
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
 	for (int i = 0; i < k; i++)
 		pfree(sequences[i]);
@@ -1627,20 +1835,20 @@ tnumbers_at_range(TemporalS *ts, RangeType *range)
  * Restriction to the complement of range.
  */
 TemporalS *
-tnumbers_minus_range(TemporalS *ts, RangeType *range)
+tnumbers_minus_range(TemporalS *ts, const RangeBounds *bounds)
 {
 	/* Bounding box test */
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
 	temporals_bbox(&box1, ts);
-	range_to_tbox_internal(&box2, range);
+	range_bounds_to_tbox(&box2, bounds);
 	if (!overlaps_tbox_tbox_internal(&box1, &box2))
 		return temporals_copy(ts);
 
 	/* Singleton sequence set */
 	if (ts->count == 1)
-		return tnumberseq_minus_range(temporals_seq_n(ts, 0), range);
+		return tnumberseq_minus_range(temporals_seq_n(ts, 0), bounds);
 
 	/* General case */
 	int maxcount;
@@ -1653,14 +1861,14 @@ tnumbers_minus_range(TemporalS *ts, RangeType *range)
 	for (int i = 0; i < ts->count; i++)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts, i);
-		k += tnumberseq_minus_range1(&sequences[k], seq, range);
+		k += tnumberseq_minus_range1(&sequences[k], seq, bounds);
 	}
 	if (k == 0)
 	{
 		pfree(sequences);
 		return NULL;
 	}
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
 	for (int i = 0; i < k; i++)
 		pfree(sequences[i]);
@@ -1673,11 +1881,12 @@ tnumbers_minus_range(TemporalS *ts, RangeType *range)
  * The function assumes that the ranges are normalized.
  */
 TemporalS *
-tnumbers_at_ranges(TemporalS *ts, RangeType **ranges, int count)
+tnumbers_at_ranges(TemporalS *ts, const RangeBounds *normbounds,
+	int count)
 {
 	/* Singleton sequence set */
 	if (ts->count == 1)
-		return tnumberseq_at_ranges(temporals_seq_n(ts, 0), ranges, count);
+		return tnumberseq_at_ranges(temporals_seq_n(ts, 0), normbounds, count);
 
 	/* General case */
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->totalcount * count);
@@ -1685,14 +1894,14 @@ tnumbers_at_ranges(TemporalS *ts, RangeType **ranges, int count)
 	for (int i = 0; i < ts->count; i++)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts, i);
-		k += tnumberseq_at_ranges1(&sequences[k], seq, ranges, count);
+		k += tnumberseq_at_ranges1(&sequences[k], seq, normbounds, count);
 	}
 	if (k == 0)
 	{
 		pfree(sequences);
 		return NULL;
 	}
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
 	for (int i = 0; i < k; i++)
 		pfree(sequences[i]);
@@ -1705,11 +1914,12 @@ tnumbers_at_ranges(TemporalS *ts, RangeType **ranges, int count)
  * The function assumes that the ranges are normalized.
  */
 TemporalS *
-tnumbers_minus_ranges(TemporalS *ts, RangeType **ranges, int count)
+tnumbers_minus_ranges(TemporalS *ts, const RangeBounds *normbounds,
+	int count)
 {
 	/* Singleton sequence set */
 	if (ts->count == 1)
-		return tnumberseq_minus_ranges(temporals_seq_n(ts, 0), ranges, count);
+		return tnumberseq_minus_ranges(temporals_seq_n(ts, 0), normbounds, count);
 
 	/* General case */
 	int maxcount;
@@ -1722,14 +1932,14 @@ tnumbers_minus_ranges(TemporalS *ts, RangeType **ranges, int count)
 	for (int i = 0; i < ts->count; i++)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts, i);
-		k += tnumberseq_minus_ranges1(&sequences[k], seq, ranges, count);
+		k += tnumberseq_minus_ranges1(&sequences[k], seq, normbounds, count);
 	}
 	if (k == 0)
 	{
 		pfree(sequences);
 		return NULL;
 	}
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
 	for (int i = 0; i < k; i++)
 		pfree(sequences[i]);
@@ -1745,14 +1955,42 @@ temporalseqarr_remove_duplicates(TemporalSeq **sequences, int count)
 	assert(count != 0);
 	int newcount = 0;
 	for (int i = 1; i < count; i++) 
+	{
 		if (! temporalseq_eq(sequences[newcount], sequences[i]))
 			sequences[++ newcount] = sequences[i];
+		else
+			pfree(sequences[i]);
+	}
 	return newcount + 1;
 }
 
 static TemporalS *
 temporals_at_minmax(TemporalS *ts, Datum value)
 {
+	Oid valuetypid = ts->valuetypid;
+	if (valuetypid == INT4OID || valuetypid == FLOAT8OID)
+	{
+		double dvalue = datum_double(value, valuetypid);
+		Period *periods = palloc(sizeof(Period) * ts->totalcount);
+		int count = 0;
+		for (int i = 0; i < ts->count; i++)
+			count = tnumberseq_at_value_periods(temporals_seq_n(ts, i), dvalue,
+				periods, count);
+		/* If minimum/maximum is at an exclusive bound. The same instant may
+		 * be the upper bound of a sequence and the lower bound of the next
+		 * one, in which case the two periods are merged */
+		if (count == 0)
+		{
+			for (int i = 0; i < ts->count; i++)
+				count = tnumberseq_minmax_bound_periods(temporals_seq_n(ts, i),
+					dvalue, periods, count);
+		}
+		TemporalS *result = tnumbers_from_base_periodarr(value, valuetypid,
+			periods, count, MOBDB_FLAGS_GET_LINEAR(ts->flags));
+		pfree(periods);
+		return result;
+	}
+
 	TemporalS *result = temporals_at_value(ts, value);
 	/* If minimum/maximum is at an exclusive bound */
 	if (result == NULL)
@@ -1769,9 +2007,9 @@ temporals_at_minmax(TemporalS *ts, Datum value)
 		 * e.g., .... min@t) (min@t .... */
 		temporalseqarr_sort(sequences, k);
 		int count = temporalseqarr_remove_duplicates(sequences, k);
-		result = temporals_from_temporalseqarr(sequences, count,
+		result = temporals_from_temporalseqarr_trusted(sequences, count,
 			MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
-		for (int i = 0; i < k; i++)
+		for (int i = 0; i < count; i++)
 			pfree(sequences[i]);
 		pfree(sequences);	
 	}
@@ -1867,7 +2105,7 @@ temporals_minus_timestamp(TemporalS *ts, TimestampTz t)
 	}
 	/* k is never equal to 0 since in that case it is a singleton sequence set 
 	   and it has been dealt by temporalseq_minus_timestamp above */
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
 	for (int i = 0; i < k; i++)
 		pfree(sequences[i]);
@@ -1912,24 +2150,15 @@ temporals_at_timestampset(TemporalS *ts1, TimestampSet *ts2)
 
 	/* General case */
 	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ts2->count);
+	int n;
+	temporals_find_timestamp(ts1, p2->lower, &n);
 	int count = 0;
-	int i = 0, j = 0;
-	while (i < ts2->count && j < ts1->count)
+	for (int i = n; i < ts1->count; i++)
 	{
-		TemporalSeq *seq = temporals_seq_n(ts1, j);
-		TimestampTz t = timestampset_time_n(ts2, i);
-		if (contains_period_timestamp_internal(&seq->period, t))
-		{
-			instants[count++] = temporalseq_at_timestamp(seq, t);
-			i++;
-		}
-		else
-		{
-			if (timestamp_cmp_internal(t, seq->period.lower) <= 0)
-				i++;
-			if (timestamp_cmp_internal(t, seq->period.upper) >= 0)
-				j++;
-		}
+		TemporalSeq *seq = temporals_seq_n(ts1, i);
+		if (timestamp_cmp_internal(p2->upper, seq->period.lower) < 0)
+			break;
+		count += temporalseq_at_timestampset1(&instants[count], seq, ts2);
 	}
 	if (count == 0)
 	{
@@ -1938,7 +2167,7 @@ temporals_at_timestampset(TemporalS *ts1, TimestampSet *ts2)
 	}
 
 	TemporalI *result = temporali_from_temporalinstarr(instants, count);
-	for (i = 0; i < count; i++)
+	for (int i = 0; i < count; i++)
 		pfree(instants[i]);
 	pfree(instants);
 	return result;
@@ -1977,7 +2206,7 @@ temporals_minus_timestampset(TemporalS *ts1, TimestampSet *ts2)
 		return NULL;
 	}
 
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts1->flags), true);
 	for (int i = 0; i < k; i++)
 		pfree(sequences[i]);
@@ -1985,6 +2214,39 @@ temporals_minus_timestampset(TemporalS *ts1, TimestampSet *ts2)
 	return result;
 }
 
+/*
+ * Position of the only sequence of the sequence set that overlaps the 
+ * period, -1 if no sequence or several sequences overlap it
+ */
+int
+temporals_overlapping_seq(TemporalS *ts, Period *p)
+{
+	/* Bounding box test */
+	Period p1;
+	temporals_period(&p1, ts);
+	if (!overlaps_period_period_internal(&p1, p))
+		return -1;
+
+	int n;
+	temporals_find_timestamp(ts, p->lower, &n);
+	int result = -1;
+	for (int i = n; i < ts->count; i++)
+	{
+		Period *period = temporals_period_n(ts, i);
+		if (overlaps_period_period_internal(p, period))
+		{
+			if (result >= 0)
+				return -1;
+			result = i;
+		}
+		if (timestamp_cmp_internal(p->upper, period->upper) < 0 ||
+			(timestamp_cmp_internal(p->upper, period->upper) == 0 &&
+			 period->upper_inc))
+			break;
+	}
+	return result;
+}
+
 /*
  * Restriction to a period.
  */
@@ -2001,7 +2263,7 @@ temporals_at_period(TemporalS *ts, Period *p)
 	if (ts->count == 1)
 	{
 		TemporalSeq *seq = temporalseq_at_period(temporals_seq_n(ts, 0), p);
-		return temporals_from_temporalseqarr(&seq, 1,
+		return temporals_from_temporalseqarr_trusted(&seq, 1,
 			MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
 	}
 
@@ -2014,17 +2276,17 @@ temporals_at_period(TemporalS *ts, Period *p)
 	int k = 0, l = 0;
 	for (int i = n; i < ts->count; i++)
 	{
-		TemporalSeq *seq = temporals_seq_n(ts, i);
-		if (contains_period_period_internal(p, &seq->period))
-				sequences[k++] = seq;
-		else if (overlaps_period_period_internal(p, &seq->period))
+		Period *period = temporals_period_n(ts, i);
+		if (contains_period_period_internal(p, period))
+				sequences[k++] = temporals_seq_n(ts, i);
+		else if (overlaps_period_period_internal(p, period))
 		{
-			TemporalSeq *newseq = temporalseq_at_period(seq, p);
+			TemporalSeq *newseq = temporalseq_at_period(temporals_seq_n(ts, i), p);
 			sequences[k++] = tofree[l++] = newseq;
 		}
-		if (timestamp_cmp_internal(p->upper, seq->period.upper) < 0 ||
-			(timestamp_cmp_internal(p->upper, seq->period.upper) == 0 &&
-			 seq->period.upper_inc))
+		if (timestamp_cmp_internal(p->upper, period->upper) < 0 ||
+			(timestamp_cmp_internal(p->upper, period->upper) == 0 &&
+			 period->upper_inc))
 			break;
 	}
 	if (k == 0)
@@ -2034,7 +2296,7 @@ temporals_at_period(TemporalS *ts, Period *p)
 	}
 	/* Since both the temporals and the period are normalized it is not 
 	   necessary to normalize the result of the projection */	
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
 	for (int i = 0; i < l; i++)
 		pfree(tofree[i]);
@@ -2089,28 +2351,18 @@ temporals_at_periodset(TemporalS *ts, PeriodSet *ps)
 		return temporalseq_at_periodset(temporals_seq_n(ts, 0), ps);
 
 	/* General case */
-	TimestampTz t = Max(p1.lower, p2->lower);
-	int n1, n2;
-	temporals_find_timestamp(ts, t, &n1);
-	periodset_find_timestamp(ps, t, &n2);
-	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * (ts->count + ps->count - n1 - n2));
-	int i = n1, j = n2, k = 0;
-	while (i < ts->count && j < ps->count)
+	int n;
+	temporals_find_timestamp(ts, p2->lower, &n);
+	/* Each sequence of the result is the restriction of a sequence to a
+	   period, and at most (ts->count + ps->count - 1) pairs overlap */
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * (ts->count + ps->count));
+	int k = 0;
+	for (int i = n; i < ts->count; i++)
 	{
 		TemporalSeq *seq = temporals_seq_n(ts, i);
-		Period *p = periodset_per_n(ps, j);
-		TemporalSeq *seq1 = temporalseq_at_period(seq, p);
-		if (seq1 != NULL)
-			sequences[k++] = seq1;
-		int cmp = timestamp_cmp_internal(seq->period.upper, p->upper);
-		if (cmp == 0 && seq->period.upper_inc == p->upper_inc)
-		{
-			i++; j++;
-		}
-		else if (cmp < 0 || (cmp == 0 && ! seq->period.upper_inc && p->upper_inc))
-			i++;
-		else 
-			j++;
+		if (timestamp_cmp_internal(p2->upper, seq->period.lower) < 0)
+			break;
+		k += temporalseq_at_periodset1(&sequences[k], seq, ps);
 	}
 	if (k == 0)
 	{
@@ -2119,9 +2371,9 @@ temporals_at_periodset(TemporalS *ts, PeriodSet *ps)
 	}
 	/* Since both the temporals and the periodset are normalized it is not 
 	   necessary to normalize the result of the projection */
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
-	for (i = 0; i < k; i++)
+	for (int i = 0; i < k; i++)
 		pfree(sequences[i]);
 	pfree(sequences); 
 	return result;
@@ -2188,7 +2440,7 @@ temporals_minus_periodset(TemporalS *ts, PeriodSet *ps)
 	}
 	/* Since both the temporals and the periodset are normalized it is not 
 	   necessary to normalize the result of the difference */
-	TemporalS *result = temporals_from_temporalseqarr(sequences, k,
+	TemporalS *result = temporals_from_temporalseqarr_trusted(sequences, k,
 		MOBDB_FLAGS_GET_LINEAR(ts->flags), false);
 	for (i = 0; i < k; i++)
 		pfree(sequences[i]);
@@ -14,8 +14,10 @@
 
 #include <assert.h>
 #include <access/hash.h>
+#include <access/tuptoaster.h>
 #include <libpq/pqformat.h>
 #include <utils/builtins.h>
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
 
 #include "timestampset.h"
@@ -27,6 +29,9 @@
 #include "oidcache.h"
 #include "temporal_util.h"
 #include "temporal_boxops.h"
+#include "temporal_compress.h"
+#include "temporal_probes.h"
+#include "temporal_stats.h"
 #include "rangetypes_ext.h"
 
 #ifdef WITH_POSTGIS
@@ -56,6 +61,11 @@
  * bounding box and offset_3 is the offset for the precomputed trajectory. 
  * Precomputed trajectories are only kept for temporal points of sequence 
  * duration.
+ *
+ * When the sequence has the flag MOBDB_FLAGS_GET_SUMMARY, which is only
+ * possible for temporal numbers and temporal points, a TemporalSeqSummary
+ * follows the bounding box in the space given by offset_2, i.e., before the
+ * precomputed trajectory.
  */
 
 /* N-th TemporalInst of a TemporalSeq */
@@ -77,11 +87,76 @@ temporalseq_bbox_ptr(TemporalSeq *seq)
 		seq->offsets[seq->count];						/* offset */
 }
 
+/* Pointer to the summary of a TemporalSeq, or NULL if it has none */
+
+TemporalSeqSummary *
+temporalseq_summary_ptr(TemporalSeq *seq)
+{
+	if (! MOBDB_FLAGS_GET_SUMMARY(seq->flags))
+		return NULL;
+	return (TemporalSeqSummary *) ((char *) temporalseq_bbox_ptr(seq) +
+		double_pad(temporal_bbox_size(seq->valuetypid)));
+}
+
+/* Does a sequence of the base type have a summary? */
+
+static bool
+temporalseq_summary_type(Oid valuetypid, bool linear)
+{
+	if (valuetypid == INT4OID || valuetypid == FLOAT8OID)
+		return true;
+#ifdef WITH_POSTGIS
+	if (linear && (valuetypid == type_oid(T_GEOMETRY) ||
+		valuetypid == type_oid(T_GEOGRAPHY)))
+		return true;
+#endif
+	return false;
+}
+
+/* 
+ * Compute the summary of a TemporalSeq and set its flag. The space of the
+ * summary must have been allocated after the bounding box.
+ */
+static void
+temporalseq_set_summary(TemporalSeq *seq)
+{
+	TemporalSeqSummary summary;
+	memset(&summary, 0, sizeof(TemporalSeqSummary));
+	if (seq->valuetypid == INT4OID || seq->valuetypid == FLOAT8OID)
+		summary.integral = tnumberseq_integral(seq);
+#ifdef WITH_POSTGIS
+	else
+		summary.length = tpointseq_length(seq);
+#endif
+	MOBDB_FLAGS_SET_SUMMARY(seq->flags, true);
+	memcpy(temporalseq_summary_ptr(seq), &summary, sizeof(TemporalSeqSummary));
+}
+
+/* 
+ * Recompute the summary, if any, of a TemporalSeq whose values have been
+ * changed in place, e.g., a copy whose points are given another SRID.
+ * The flag is cleared first since the functions computing the summary
+ * return the stored one.
+ */
+void
+temporalseq_update_summary(TemporalSeq *seq)
+{
+	if (! MOBDB_FLAGS_GET_SUMMARY(seq->flags))
+		return;
+	MOBDB_FLAGS_SET_SUMMARY(seq->flags, false);
+	temporalseq_set_summary(seq);
+}
+
 /* Copy the bounding box of a TemporalSeq in the first argument */
 
 void 
 temporalseq_bbox(void *box, TemporalSeq *seq) 
 {
+	if (MOBDB_FLAGS_GET_COMPRESSED(seq->flags))
+	{
+		temporalseq_compressed_bbox(box, seq);
+		return;
+	}
 	void *box1 = temporalseq_bbox_ptr(seq);
 	size_t bboxsize = temporal_bbox_size(seq->valuetypid);
 	memcpy(box, box1, bboxsize);
@@ -375,6 +450,38 @@ temporalinst_collinear(TemporalInst *inst1, TemporalInst *inst2,
 	return false;
 }
 
+/*
+ * Remove the redundant instants of a linear sequence of floats or 2D points
+ * given the raw arrays of their coordinates and timestamps. The argument y
+ * is NULL for floats. The kept instants are compacted at the beginning of
+ * the result array.
+ * Since the tests are made on plain doubles, they do not need to dispatch
+ * on the base type nor to interpolate the values with PostGIS functions.
+ * Two points are collinear when both of their coordinates are collinear,
+ * which is the same test as the one in point_collinear. Instants with
+ * the same value are collinear and thus need not be tested separately.
+ */
+static int
+temporalinstarr_normalize_linear(TemporalInst **instants, const double *x,
+	const double *y, const TimestampTz *t, int count, TemporalInst **result)
+{
+	int i1 = 0, i2 = 1, k = 1;
+	result[0] = instants[0];
+	for (int i = 2; i < count; i++)
+	{
+		if (! float_collinear(x[i1], x[i2], x[i], t[i1], t[i2], t[i]) ||
+			(y != NULL &&
+			 ! float_collinear(y[i1], y[i2], y[i], t[i1], t[i2], t[i])))
+		{
+			result[k++] = instants[i2];
+			i1 = i2;
+		}
+		i2 = i;
+	}
+	result[k++] = instants[i2];
+	return k;
+}
+
 /*
  * Normalize an array of instants.
  * The function assumes that there are at least 2 instants.
@@ -387,6 +494,39 @@ temporalinstarr_normalize(TemporalInst **instants, bool linear, int count,
 {
 	Oid valuetypid = instants[0]->valuetypid;
 	TemporalInst **result = palloc(sizeof(TemporalInst *) * count);
+	/* Linear sequences of floats and 2D points are normalized on the raw
+	 * arrays of their values */
+	bool ispoint2d = false;
+#ifdef WITH_POSTGIS
+	ispoint2d = valuetypid == type_oid(T_GEOMETRY) &&
+		! MOBDB_FLAGS_GET_Z(instants[0]->flags);
+#endif
+	if (linear && (valuetypid == FLOAT8OID || ispoint2d))
+	{
+		double *x = palloc(sizeof(double) * count);
+		double *y = ispoint2d ? palloc(sizeof(double) * count) : NULL;
+		TimestampTz *t = palloc(sizeof(TimestampTz) * count);
+		for (int i = 0; i < count; i++)
+		{
+			t[i] = instants[i]->t;
+#ifdef WITH_POSTGIS
+			if (ispoint2d)
+			{
+				POINT2D point = datum_get_point2d(temporalinst_value(instants[i]));
+				x[i] = point.x;
+				y[i] = point.y;
+			}
+			else
+#endif
+				x[i] = DatumGetFloat8(temporalinst_value(instants[i]));
+		}
+		*newcount = temporalinstarr_normalize_linear(instants, x, y, t,
+			count, result);
+		pfree(x); pfree(t);
+		if (y != NULL)
+			pfree(y);
+		return result;
+	}
 	/* Remove redundant instants */ 
 	TemporalInst *inst1 = instants[0];
 	Datum value1 = temporalinst_value(inst1);
@@ -394,6 +534,7 @@ temporalinstarr_normalize(TemporalInst **instants, bool linear, int count,
 	Datum value2 = temporalinst_value(inst2);
 	result[0] = inst1;
 	int k = 1;
+	const BaseTypeInfo *info = base_type_info(valuetypid);
 	for (int i = 2; i < count; i++)
 	{
 		TemporalInst *inst3 = instants[i];
@@ -402,12 +543,12 @@ temporalinstarr_normalize(TemporalInst **instants, bool linear, int count,
 			/* stepwise sequences and 2 consecutive instants that have the same value 
 				... 1@t1, 1@t2, 2@t3, ... -> ... 1@t1, 2@t3, ...
 			*/
-			(!linear && datum_eq(value1, value2, valuetypid))
+			(!linear && info->eq(value1, value2))
 			||
 			/* 3 consecutive float/point instants that have the same value 
 				... 1@t1, 1@t2, 1@t3, ... -> ... 1@t1, 1@t3, ...
 			*/
-			(linear && datum_eq(value1, value2, valuetypid) && datum_eq(value2, value3, valuetypid))
+			(linear && info->eq(value1, value2) && info->eq(value2, value3))
 			||
 			/* collinear float/point instants
 				... 1@t1, 2@t2, 3@t3, ... -> ... 1@t1, 3@t3, ...
@@ -564,15 +705,13 @@ temporalseqarr_normalize(TemporalSeq **sequences, int count, int *newcount)
 
 /*****************************************************************************/
 
-/* Construct a TemporalSeq from an array of TemporalInst and the bounds.
- * Depending on the value of the normalize argument, the resulting sequence
- * will be normalized. */
-TemporalSeq *
-temporalseq_from_temporalinstarr(TemporalInst **instants, int count, 
-   bool lower_inc, bool upper_inc, bool linear, bool normalize)
+/* Test the validity of an array of TemporalInst and the bounds for
+ * constructing a TemporalSeq */
+static void
+temporalseq_ensure_valid(TemporalInst **instants, int count,
+	bool lower_inc, bool upper_inc, bool linear)
 {
 	Oid valuetypid = instants[0]->valuetypid;
-	/* Test the validity of the instants and the bounds */
 	assert(count > 0);
 	if (count == 1 && (!lower_inc || !upper_inc))
 		ereport(ERROR, (errcode(ERRCODE_RESTRICT_VIOLATION), 
@@ -580,12 +719,11 @@ temporalseq_from_temporalinstarr(TemporalInst **instants, int count,
 #ifdef WITH_POSTGIS
 	bool isgeo = (valuetypid == type_oid(T_GEOMETRY) ||
 		valuetypid == type_oid(T_GEOGRAPHY));
-	bool hasz = false, isgeodetic = false;
+	bool hasz = false;
 	int srid;
 	if (isgeo)
 	{
 		hasz = MOBDB_FLAGS_GET_Z(instants[0]->flags);
-		isgeodetic = MOBDB_FLAGS_GET_GEODETIC(instants[0]->flags);
 		srid = tpoint_srid_internal((Temporal *) instants[0]);
 	}
 #endif
@@ -615,7 +753,34 @@ temporalseq_from_temporalinstarr(TemporalInst **instants, int count,
 			temporalinst_value(instants[count - 2]), valuetypid))
 		ereport(ERROR, (errcode(ERRCODE_RESTRICT_VIOLATION), 
 			errmsg("Invalid end value for temporal sequence")));
+}
 
+/* Construct a TemporalSeq from an array of TemporalInst and the bounds
+ * without testing their validity. This function is used for the instants
+ * computed from valid temporal values, e.g., in the restriction functions,
+ * where the timestamps are known to be increasing and the SRID and the
+ * dimensionality are known to be the same.
+ * Depending on the value of the normalize argument, the resulting sequence
+ * will be normalized. The bounding box is computed from the instants unless
+ * it is given in the last argument. */
+TemporalSeq *
+temporalseq_from_temporalinstarr1(TemporalInst **instants, int count,
+   bool lower_inc, bool upper_inc, bool linear, bool normalize,
+   const void *bbox)
+{
+	Oid valuetypid = instants[0]->valuetypid;
+	assert(count > 0);
+	TRACE_MOBILITYDB_SEQ_MAKE_START(count);
+#ifdef WITH_POSTGIS
+	bool isgeo = (valuetypid == type_oid(T_GEOMETRY) ||
+		valuetypid == type_oid(T_GEOGRAPHY));
+	bool hasz = false, isgeodetic = false;
+	if (isgeo)
+	{
+		hasz = MOBDB_FLAGS_GET_Z(instants[0]->flags);
+		isgeodetic = MOBDB_FLAGS_GET_GEODETIC(instants[0]->flags);
+	}
+#endif
 	/* Normalize the array of instants */
 	TemporalInst **newinstants = instants;
 	int newcount = count;
@@ -624,6 +789,11 @@ temporalseq_from_temporalinstarr(TemporalInst **instants, int count,
 	/* Get the bounding box size */
 	size_t bboxsize = temporal_bbox_size(valuetypid);
 	size_t memsize = double_pad(bboxsize);
+	/* Add the size of the summary */
+	bool summary = precompute_summary && bboxsize != 0 &&
+		temporalseq_summary_type(valuetypid, linear);
+	if (summary)
+		memsize += double_pad(sizeof(TemporalSeqSummary));
 	/* Add the size of composing instants */
 	for (int i = 0; i < newcount; i++)
 		memsize += double_pad(VARSIZE(newinstants[i]));
@@ -633,7 +803,8 @@ temporalseq_from_temporalinstarr(TemporalInst **instants, int count,
 	Datum traj = 0; /* keep compiler quiet */
 	if (isgeo)
 	{
-		trajectory = type_has_precomputed_trajectory(valuetypid);  
+		trajectory = type_has_precomputed_trajectory(valuetypid) &&
+			precompute_trajectory;
 		if (trajectory)
 		{
 			/* A trajectory is a geometry/geography, a point, a multipoint, 
@@ -660,16 +831,29 @@ temporalseq_from_temporalinstarr(TemporalInst **instants, int count,
 	{
 		MOBDB_FLAGS_SET_Z(result->flags, hasz);
 		MOBDB_FLAGS_SET_GEODETIC(result->flags, isgeodetic);
+		MOBDB_FLAGS_SET_NOTRAJ(result->flags, ! trajectory);
 	}
 #endif
-	/* Initialization of the variable-length part */
+	/* Initialization of the variable-length part. The instants that are
+	 * consecutive in memory, e.g., those taken from another sequence, are
+	 * copied with a single memcpy */
 	size_t pos = 0;
-	for (int i = 0; i < newcount; i++)
+	for (int i = 0; i < newcount; )
 	{
-		memcpy(((char *)result) + pdata + pos, newinstants[i], 
-			VARSIZE(newinstants[i]));
-		result->offsets[i] = pos;
-		pos += double_pad(VARSIZE(newinstants[i]));
+		char *start = (char *) newinstants[i];
+		size_t runsize = 0;
+		int j = i;
+		do
+		{
+			result->offsets[j] = pos + runsize;
+			runsize += double_pad(VARSIZE(newinstants[j]));
+			j++;
+		} while (j < newcount && (char *) newinstants[j] == start + runsize);
+		/* The padding after the last instant of the run is not copied */
+		memcpy(((char *)result) + pdata + pos, start, runsize -
+			double_pad(VARSIZE(newinstants[j - 1])) + VARSIZE(newinstants[j - 1]));
+		pos += runsize;
+		i = j;
 	}
 	/*
 	 * Precompute the bounding box 
@@ -680,21 +864,25 @@ temporalseq_from_temporalinstarr(TemporalInst **instants, int count,
 	 */
 	if (bboxsize != 0)
 	{
-		void *bbox = ((char *) result) + pdata + pos;
+		void *resbbox = ((char *) result) + pdata + pos;
+		if (bbox != NULL)
+			memcpy(resbbox, bbox, bboxsize);
 #ifdef WITH_POSTGIS
-		if (trajectory)
+		else if (trajectory)
 		{
-			geo_to_stbox_internal(bbox, (GSERIALIZED *)DatumGetPointer(traj));
-			((STBOX *)bbox)->tmin = result->period.lower;
-			((STBOX *)bbox)->tmax = result->period.upper;
-			MOBDB_FLAGS_SET_T(((STBOX *)bbox)->flags, true);
+			geo_to_stbox_internal(resbbox, (GSERIALIZED *)DatumGetPointer(traj));
+			((STBOX *)resbbox)->tmin = result->period.lower;
+			((STBOX *)resbbox)->tmax = result->period.upper;
+			MOBDB_FLAGS_SET_T(((STBOX *)resbbox)->flags, true);
 		}
-		else
 #endif
-			temporalseq_make_bbox(bbox, newinstants, newcount, 
+		else
+			temporalseq_make_bbox(resbbox, newinstants, newcount, 
 				lower_inc, upper_inc);
 		result->offsets[newcount] = pos;
 		pos += double_pad(bboxsize);
+		if (summary)
+			pos += double_pad(sizeof(TemporalSeqSummary));
 	}
 #ifdef WITH_POSTGIS
 	if (isgeo && trajectory)
@@ -706,21 +894,43 @@ temporalseq_from_temporalinstarr(TemporalInst **instants, int count,
 	}
 #endif
 
+	/* The summary is computed once the sequence is complete */
+	if (summary)
+		temporalseq_set_summary(result);
+
 	if (normalize && count > 2)
 		pfree(newinstants);
 
+	TRACE_MOBILITYDB_SEQ_MAKE_DONE(result->count, VARSIZE(result));
 	return result;
 }
 
-/* Append a TemporalInst to a TemporalSeq */
+TemporalSeq *
+temporalseq_from_temporalinstarr_trusted(TemporalInst **instants, int count,
+   bool lower_inc, bool upper_inc, bool linear, bool normalize)
+{
+	return temporalseq_from_temporalinstarr1(instants, count, lower_inc,
+		upper_inc, linear, normalize, NULL);
+}
 
+/* Construct a TemporalSeq from an array of TemporalInst and the bounds.
+ * Depending on the value of the normalize argument, the resulting sequence
+ * will be normalized. */
 TemporalSeq *
-temporalseq_append_instant(TemporalSeq *seq, TemporalInst *inst)
+temporalseq_from_temporalinstarr(TemporalInst **instants, int count, 
+   bool lower_inc, bool upper_inc, bool linear, bool normalize)
 {
-	Oid valuetypid = seq->valuetypid;
+	temporalseq_ensure_valid(instants, count, lower_inc, upper_inc, linear);
+	return temporalseq_from_temporalinstarr_trusted(instants, count,
+		lower_inc, upper_inc, linear, normalize);
+}
 
-	/* Test the validity of the instant */
-	TemporalInst *inst1 = temporalseq_inst_n(seq, seq->count - 1);
+/* Ensure that an instant can be appended to a TemporalSeq whose last 
+ * instant is inst1 */
+
+void
+temporalseq_ensure_append(TemporalInst *inst1, TemporalInst *inst)
+{
 	if (timestamp_cmp_internal(inst1->t, inst->t) >= 0)
 		{
 			char *t1 = call_output(TIMESTAMPTZOID, TimestampTzGetDatum(inst1->t));
@@ -729,55 +939,123 @@ temporalseq_append_instant(TemporalSeq *seq, TemporalInst *inst)
 				errmsg("Timestamps for temporal value must be increasing: %s, %s", t1, t2)));
 		}
 #ifdef WITH_POSTGIS
-	bool isgeo = false;
-	if (valuetypid == type_oid(T_GEOMETRY) ||
-		valuetypid == type_oid(T_GEOGRAPHY))
+	if (inst1->valuetypid == type_oid(T_GEOMETRY) ||
+		inst1->valuetypid == type_oid(T_GEOGRAPHY))
 	{
-		isgeo = true;
 		if (tpoint_srid_internal((Temporal *)inst) != 
-			tpoint_srid_internal((Temporal *)seq))
+			tpoint_srid_internal((Temporal *)inst1))
 			ereport(ERROR, (errcode(ERRCODE_RESTRICT_VIOLATION), 
 				errmsg("All geometries composing a temporal point must be of the same SRID")));
-		if (MOBDB_FLAGS_GET_Z(inst->flags) != MOBDB_FLAGS_GET_Z(seq->flags))
+		if (MOBDB_FLAGS_GET_Z(inst->flags) != MOBDB_FLAGS_GET_Z(inst1->flags))
 			ereport(ERROR, (errcode(ERRCODE_RESTRICT_VIOLATION), 
 				errmsg("All geometries composing a temporal point must be of the same dimensionality")));
 	}
 #endif
+}
+
+/* Does an instant appended to a TemporalSeq replace its last instant inst2,
+ * where inst1 is the instant before inst2, in order to keep the sequence 
+ * normalized? */
+
+bool
+temporalseq_append_replaces(TemporalInst *inst1, TemporalInst *inst2, 
+	TemporalInst *inst, bool linear)
+{
+	Oid valuetypid = inst1->valuetypid;
+	Datum value1 = temporalinst_value(inst1);
+	Datum value2 = temporalinst_value(inst2);
+	Datum value3 = temporalinst_value(inst);
+	return
+		/* stepwise sequences and 2 consecutive instants that have the same value 
+			... 1@t1, 1@t2, 2@t3, ... -> ... 1@t1, 2@t3, ...
+		*/
+		(! linear && datum_eq(value1, value2, valuetypid))
+		||
+		/* 3 consecutive float/point instants that have the same value 
+			... 1@t1, 1@t2, 1@t3, ... -> ... 1@t1, 1@t3, ...
+		*/
+		(datum_eq(value1, value2, valuetypid) && datum_eq(value2, value3, valuetypid))
+		||
+		/* collinear float/point instants that have the same duration
+			... 1@t1, 2@t2, 3@t3, ... -> ... 1@t1, 3@t3, ...
+		*/
+		(linear && datum_collinear(valuetypid, value1, value2, value3, inst1->t, inst2->t, inst->t));
+}
+
+/* 
+ * Set the summary of a sequence resulting from appending the instant inst
+ * to a sequence whose last instant is inst1 and whose summary is summary1.
+ * The contribution of the new segment is added in the same way as in the
+ * functions computing the summary from scratch, which are only called when
+ * the previous sequence has no summary, when the new instant replaced its
+ * last instant, or for temporal geography points whose length is that of
+ * their trajectory.
+ */
+static void
+temporalseq_append_summary(TemporalSeq *seq, TemporalSeqSummary *summary1,
+	TemporalInst *inst1, TemporalInst *inst, bool added)
+{
+	if (summary1 == NULL || ! added)
+	{
+		temporalseq_set_summary(seq);
+		return;
+	}
+	TemporalSeqSummary summary = *summary1;
+	if (seq->valuetypid == INT4OID || seq->valuetypid == FLOAT8OID)
+	{
+		double value1 = datum_double(temporalinst_value(inst1), seq->valuetypid);
+		double duration = (double) (inst->t - inst1->t);
+		if (MOBDB_FLAGS_GET_LINEAR(seq->flags))
+			summary.integral += (value1 + datum_double(temporalinst_value(inst),
+				seq->valuetypid)) * duration / 2.0;
+		else
+			summary.integral += value1 * duration;
+	}
+#ifdef WITH_POSTGIS
+	else if (seq->valuetypid == type_oid(T_GEOMETRY))
+		summary.length += tpointseg_length(inst1, inst);
+	else
+	{
+		temporalseq_set_summary(seq);
+		return;
+	}
+#endif
+	MOBDB_FLAGS_SET_SUMMARY(seq->flags, true);
+	memcpy(temporalseq_summary_ptr(seq), &summary, sizeof(TemporalSeqSummary));
+}
+
+/* Append a TemporalInst to a TemporalSeq */
+
+TemporalSeq *
+temporalseq_append_instant(TemporalSeq *seq, TemporalInst *inst)
+{
+	Oid valuetypid = seq->valuetypid;
+
+	/* Test the validity of the instant */
+	TemporalInst *inst1 = temporalseq_inst_n(seq, seq->count - 1);
+	temporalseq_ensure_append(inst1, inst);
+#ifdef WITH_POSTGIS
+	bool isgeo = (valuetypid == type_oid(T_GEOMETRY) ||
+		valuetypid == type_oid(T_GEOGRAPHY));
+#endif
 
 	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
 	/* Normalize the result */
 	int newcount = seq->count + 1;
-	if (seq->count > 1)
-	{
-		inst1 = temporalseq_inst_n(seq, seq->count - 2);
-		Datum value1 = temporalinst_value(inst1);
-		TemporalInst *inst2 = temporalseq_inst_n(seq, seq->count - 1);
-		Datum value2 = temporalinst_value(inst2);
-		Datum value3 = temporalinst_value(inst);
-		if (
-			/* stepwise sequences and 2 consecutive instants that have the same value 
-				... 1@t1, 1@t2, 2@t3, ... -> ... 1@t1, 2@t3, ...
-			*/
-			(! linear && datum_eq(value1, value2, valuetypid))
-			||
-			/* 3 consecutive float/point instants that have the same value 
-				... 1@t1, 1@t2, 1@t3, ... -> ... 1@t1, 1@t3, ...
-			*/
-			(datum_eq(value1, value2, valuetypid) && datum_eq(value2, value3, valuetypid))
-			||
-			/* collinear float/point instants that have the same duration
-				... 1@t1, 2@t2, 3@t3, ... -> ... 1@t1, 3@t3, ...
-			*/
-			(linear && datum_collinear(valuetypid, value1, value2, value3, inst1->t, inst2->t, inst->t))
-			)
-		{
-			/* The new instant replaces the last instant of the sequence */
-			newcount--;
-		} 
-	}
+	if (seq->count > 1 && temporalseq_append_replaces(
+			temporalseq_inst_n(seq, seq->count - 2), 
+			temporalseq_inst_n(seq, seq->count - 1), inst, linear))
+		/* The new instant replaces the last instant of the sequence */
+		newcount--;
 	/* Get the bounding box size */
 	size_t bboxsize = temporal_bbox_size(valuetypid);
 	size_t memsize = double_pad(bboxsize);
+	/* Add the size of the summary, which is kept if the sequence has one */
+	TemporalSeqSummary *summary1 = temporalseq_summary_ptr(seq);
+	bool summary = (summary1 != NULL || precompute_summary) &&
+		bboxsize != 0 && temporalseq_summary_type(valuetypid, linear);
+	if (summary)
+		memsize += double_pad(sizeof(TemporalSeqSummary));
 	/* Add the size of composing instants */
 	for (int i = 0; i < newcount - 1; i++)
 		memsize += double_pad(VARSIZE(temporalseq_inst_n(seq, i)));
@@ -788,7 +1066,8 @@ temporalseq_append_instant(TemporalSeq *seq, TemporalInst *inst)
 	Datum traj = 0; /* keep compiler quiet */
 	if (isgeo)
 	{
-		trajectory = type_has_precomputed_trajectory(valuetypid);  
+		/* The trajectory is only expanded if it was precomputed */
+		trajectory = ! MOBDB_FLAGS_GET_NOTRAJ(seq->flags);
 		if (trajectory)
 		{
 			bool replace = newcount != seq->count + 1;
@@ -811,7 +1090,10 @@ temporalseq_append_instant(TemporalSeq *seq, TemporalInst *inst)
 	MOBDB_FLAGS_SET_LINEAR(result->flags, MOBDB_FLAGS_GET_LINEAR(seq->flags));
 #ifdef WITH_POSTGIS
 	if (isgeo)
+	{
 		MOBDB_FLAGS_SET_Z(result->flags, MOBDB_FLAGS_GET_Z(seq->flags));
+		MOBDB_FLAGS_SET_NOTRAJ(result->flags, ! trajectory);
+	}
 #endif
 	/* Initialization of the variable-length part */
 	size_t pos = 0;
@@ -832,6 +1114,9 @@ temporalseq_append_instant(TemporalSeq *seq, TemporalInst *inst)
 		void *bbox = ((char *) result) + pdata + pos;
 		temporalseq_expand_bbox(bbox, seq, inst);
 		result->offsets[newcount] = pos;
+		pos += double_pad(bboxsize);
+		if (summary)
+			pos += double_pad(sizeof(TemporalSeqSummary));
 	}
 #ifdef WITH_POSTGIS
 	if (isgeo && trajectory)
@@ -842,6 +1127,10 @@ temporalseq_append_instant(TemporalSeq *seq, TemporalInst *inst)
 		pfree(DatumGetPointer(traj));
 	}
 #endif
+	if (summary)
+		temporalseq_append_summary(result, summary1,
+			temporalseq_inst_n(seq, seq->count - 1), inst,
+			newcount == seq->count + 1);
 	return result;
 }
 
@@ -855,32 +1144,214 @@ temporalseq_copy(TemporalSeq *seq)
 	return result;
 }
 
-/* Binary search of a timestamptz in a TemporalSeq */
+/* 
+ * Search of the segment of a TemporalSeq containing a timestamptz. 
+ * The function returns the index of the first instant of the segment, or -1
+ * if the timestamp is not contained in the sequence. When the timestamp is 
+ * equal to an instant that is not the last one, the segment starting at the 
+ * instant is returned.
+ * Interpolation search steps, which probe the position expected if the 
+ * instants were evenly spaced, alternate with binary search steps. Regularly 
+ * sampled sequences are therefore solved in a couple of probes, while the 
+ * number of probes remains logarithmic for arbitrary sequences.
+ */
 
 int
 temporalseq_find_timestamp(TemporalSeq *seq, TimestampTz t) 
 {
+	if (seq->count < 2)
+		return -1;
+	int cmp = timestamp_cmp_internal(t, seq->period.lower);
+	if (cmp < 0 || (cmp == 0 && ! seq->period.lower_inc))
+		return -1;
+	cmp = timestamp_cmp_internal(t, seq->period.upper);
+	if (cmp > 0 || (cmp == 0 && ! seq->period.upper_inc))
+		return -1;
+	if (cmp == 0)
+		return seq->count - 2;
+
+	/* Invariant: the timestamps of the instants first and last satisfy
+	 * tfirst <= t < tlast */
 	int first = 0;
-	int last = seq->count - 2;
-	int middle = (first + last)/2;
-	while (first <= last) 
-	{
-		TemporalInst *inst1 = temporalseq_inst_n(seq, middle);
-		TemporalInst *inst2 = temporalseq_inst_n(seq, middle + 1);
-		bool lower_inc = (middle == 0) ? seq->period.lower_inc : true;
-		bool upper_inc = (middle == seq->count - 2) ? seq->period.upper_inc : false;
-		if ((timestamp_cmp_internal(inst1->t, t) < 0 && 
-			timestamp_cmp_internal(t, inst2->t) < 0) ||
-			(lower_inc && timestamp_cmp_internal(inst1->t, t) == 0) ||
-			(upper_inc && timestamp_cmp_internal(inst2->t, t) == 0))
-			return middle;
-		if (timestamp_cmp_internal(t, inst1->t) <= 0)
-			last = middle - 1;
+	int last = seq->count - 1;
+	TimestampTz tfirst = seq->period.lower;
+	TimestampTz tlast = seq->period.upper;
+	bool interpolate = true;
+	while (last - first > 1) 
+	{
+		int middle;
+		if (interpolate)
+		{
+			middle = first + (int) ((double) (t - tfirst) / 
+				(double) (tlast - tfirst) * (last - first));
+			if (middle <= first)
+				middle = first + 1;
+			else if (middle >= last)
+				middle = last - 1;
+		}
+		else
+			middle = (first + last) / 2;
+		TimestampTz tmiddle = temporalseq_inst_n(seq, middle)->t;
+		if (timestamp_cmp_internal(tmiddle, t) <= 0)
+		{
+			first = middle;
+			tfirst = tmiddle;
+			/* Check whether the guess is the right segment */
+			if (interpolate && middle + 1 < last)
+			{
+				TimestampTz tnext = temporalseq_inst_n(seq, middle + 1)->t;
+				if (timestamp_cmp_internal(t, tnext) < 0)
+					return middle;
+				first = middle + 1;
+				tfirst = tnext;
+			}
+		}
 		else
-			first = middle + 1;	
-		middle = (first + last)/2;
+		{
+			last = middle;
+			tlast = tmiddle;
+			/* Check whether the guess is the right segment */
+			if (interpolate && middle - 1 > first)
+			{
+				TimestampTz tprev = temporalseq_inst_n(seq, middle - 1)->t;
+				if (timestamp_cmp_internal(tprev, t) <= 0)
+					return middle - 1;
+				last = middle - 1;
+				tlast = tprev;
+			}
+		}
+		interpolate = ! interpolate;
 	}
-	return -1;
+	return first;
+}
+
+/*****************************************************************************
+ * Partial detoasting
+ *****************************************************************************/
+
+/* Timestamp of the n-th instant of a TemporalSeq stored out of line, where
+ * datastart is the offset of the variable-length data in the datum */
+
+static TimestampTz
+temporalseq_slice_timestamp(Datum value, size_t datastart, size_t *offsets,
+	int n)
+{
+	struct varlena *slice = PG_DETOAST_DATUM_SLICE(value, datastart + 
+		offsets[n] + offsetof(TemporalInst, t) - VARHDRSZ, sizeof(TimestampTz));
+	MOBDB_STAT_ADD(detoast_bytes, VARSIZE(slice));
+	TimestampTz result;
+	memcpy(&result, VARDATA(slice), sizeof(TimestampTz));
+	pfree(slice);
+	return result;
+}
+
+/*
+ * Fetch from a temporal sequence stored out of line the minimal subsequence
+ * covering the intersection of its period and the period p. Only the slices
+ * of the datum that are needed are read: the header, the offsets, the 
+ * timestamps visited by the binary searches, and the instants of the 
+ * subsequence. Since PostgreSQL decompresses the whole datum for fetching a
+ * slice of a compressed value, this requires the column to be stored with
+ * STORAGE EXTERNAL.
+ * The function returns false if the datum does not satisfy these conditions,
+ * in which case the caller must detoast the whole value. Otherwise, the 
+ * subsequence is returned in the last argument, or NULL if the temporal 
+ * value does not overlap the period.
+ */
+bool
+temporalseq_fetch_slice(Datum value, Period *p, TemporalSeq **result)
+{
+	struct varlena *attr = (struct varlena *) DatumGetPointer(value);
+	if (! VARATT_IS_EXTERNAL_ONDISK(attr))
+		return false;
+	struct varatt_external toast_pointer;
+	VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+	if (VARATT_EXTERNAL_IS_COMPRESSED(toast_pointer))
+		return false;
+
+	/* Header of the datum */
+	TemporalSeq *header = (TemporalSeq *) PG_DETOAST_DATUM_SLICE(value, 0,
+		offsetof(TemporalSeq, offsets) - VARHDRSZ);
+	MOBDB_STAT_ADD(detoast_bytes, VARSIZE(header));
+	if (header->duration != TEMPORALSEQ || 
+		MOBDB_FLAGS_GET_COMPRESSED(header->flags) ||
+		temporal_bbox_size(header->valuetypid) == 0)
+	{
+		pfree(header);
+		return false;
+	}
+	/* Bounding box test */
+	if (!overlaps_period_period_internal(&header->period, p))
+	{
+		pfree(header);
+		*result = NULL;
+		return true;
+	}
+	TimestampTz lower = timestamp_cmp_internal(p->lower, header->period.lower) > 0 ?
+		p->lower : header->period.lower;
+	TimestampTz upper = timestamp_cmp_internal(p->upper, header->period.upper) < 0 ?
+		p->upper : header->period.upper;
+
+	/* Offsets of the instants followed by the offset of the bounding box */
+	int count = header->count;
+	struct varlena *slice = PG_DETOAST_DATUM_SLICE(value,
+		offsetof(TemporalSeq, offsets) - VARHDRSZ, (count + 1) * sizeof(size_t));
+	MOBDB_STAT_ADD(detoast_bytes, VARSIZE(slice));
+	size_t *offsets = palloc((count + 1) * sizeof(size_t));
+	memcpy(offsets, VARDATA(slice), (count + 1) * sizeof(size_t));
+	pfree(slice);
+	size_t datastart = offsetof(TemporalSeq, offsets) + 
+		(count + 2) * sizeof(size_t);
+
+	/* Last instant whose timestamp is less than or equal to lower */
+	int first = 0, last = count - 1;
+	if (timestamp_cmp_internal(lower, header->period.lower) > 0)
+	{
+		while (first < last)
+		{
+			int middle = (first + last + 1) / 2;
+			if (timestamp_cmp_internal(temporalseq_slice_timestamp(value, 
+					datastart, offsets, middle), lower) <= 0)
+				first = middle;
+			else
+				last = middle - 1;
+		}
+	}
+	int n1 = first;
+	/* First instant whose timestamp is greater than or equal to upper */
+	first = n1; last = count - 1;
+	if (timestamp_cmp_internal(upper, header->period.upper) < 0)
+	{
+		while (first < last)
+		{
+			int middle = (first + last) / 2;
+			if (timestamp_cmp_internal(temporalseq_slice_timestamp(value, 
+					datastart, offsets, middle), upper) >= 0)
+				last = middle;
+			else
+				first = middle + 1;
+		}
+	}
+	int n2 = last;
+
+	/* Fetch the instants of the subsequence into an aligned buffer */
+	size_t size = offsets[n2 + 1] - offsets[n1];
+	slice = PG_DETOAST_DATUM_SLICE(value, 
+		datastart + offsets[n1] - VARHDRSZ, size);
+	MOBDB_STAT_ADD(detoast_bytes, VARSIZE(slice));
+	char *data = palloc(size);
+	memcpy(data, VARDATA(slice), size);
+	pfree(slice);
+	int newcount = n2 - n1 + 1;
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * newcount);
+	for (int i = 0; i < newcount; i++)
+		instants[i] = (TemporalInst *) (data + offsets[n1 + i] - offsets[n1]);
+	*result = temporalseq_from_temporalinstarr(instants, newcount,
+		n1 == 0 ? header->period.lower_inc : true,
+		n2 == count - 1 ? header->period.upper_inc : true,
+		MOBDB_FLAGS_GET_LINEAR(header->flags), false);
+	pfree(instants); pfree(data); pfree(offsets); pfree(header);
+	return true;
 }
 
 /*****************************************************************************
@@ -1026,26 +1497,24 @@ synchronize_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 	 * where X are values added for synchronization and C are values added
 	 * for the crossings
 	 */
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
 	TemporalInst *inst1 = temporalseq_inst_n(seq1, 0);
 	TemporalInst *inst2 = temporalseq_inst_n(seq2, 0);
-	TemporalInst *tofreeinst = NULL;
-	int i = 0, j = 0, k = 0, l = 0;
+	int i = 0, j = 0, k = 0;
 	if (timestamp_cmp_internal(inst1->t, inter->lower) < 0)
 	{
-		inst1 = tofreeinst = temporalseq_at_timestamp(seq1, inter->lower);
+		inst1 = temporalseq_at_timestamp(seq1, inter->lower);
 		i = temporalseq_find_timestamp(seq1, inter->lower);
 	}
 	else if (timestamp_cmp_internal(inst2->t, inter->lower) < 0)
 	{
-		inst2 = tofreeinst = temporalseq_at_timestamp(seq2, inter->lower);
+		inst2 = temporalseq_at_timestamp(seq2, inter->lower);
 		j = temporalseq_find_timestamp(seq2, inter->lower);
 	}
 	int count = (seq1->count - i + seq2->count - j) * 2;
 	TemporalInst **instants1 = palloc(sizeof(TemporalInst *) * count);
 	TemporalInst **instants2 = palloc(sizeof(TemporalInst *) * count);
-	TemporalInst **tofree = palloc(sizeof(TemporalInst *) * count * 2);
-	if (tofreeinst != NULL)
-		tofree[l++] = tofreeinst;
 	while (i < seq1->count && j < seq2->count &&
 		(timestamp_cmp_internal(inst1->t, inter->upper) <= 0 ||
 		timestamp_cmp_internal(inst2->t, inter->upper) <= 0))
@@ -1059,13 +1528,11 @@ synchronize_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 		{
 			i++;
 			inst2 = temporalseq_at_timestamp(seq2, inst1->t);
-			tofree[l++] = inst2;
 		}
 		else 
 		{
 			j++;
 			inst1 = temporalseq_at_timestamp(seq1, inst2->t);
-			tofree[l++] = inst1;
 		}
 		/* If not the first instant add potential crossing before adding
 		   the new instants */
@@ -1075,9 +1542,9 @@ synchronize_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 			if (temporalseq_intersect_at_timestamp(instants1[k - 1],
 				inst1, linear1, instants2[k - 1], inst2, linear2, &crosstime))
 			{
-				instants1[k] = tofree[l++] = temporalseq_at_timestamp1(
+				instants1[k] = temporalseq_at_timestamp1(
 					instants1[k - 1], inst1, linear1, crosstime);
-				instants2[k] = tofree[l++] = temporalseq_at_timestamp1(
+				instants2[k] = temporalseq_at_timestamp1(
 					instants2[k - 1], inst2, linear2, crosstime);
 				k++;
 			}
@@ -1098,7 +1565,6 @@ synchronize_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 		{
 			instants1[k - 1] = temporalinst_make(temporalinst_value(instants1[k - 2]),
 				instants1[k - 1]->t, instants1[k - 1]->valuetypid); 
-			tofree[l++] = instants1[k - 1];
 		}
 	}
 	if (! inter->upper_inc && k > 1 && ! linear2)
@@ -1108,21 +1574,169 @@ synchronize_temporalseq_temporalseq(TemporalSeq *seq1, TemporalSeq *seq2,
 		{
 			instants2[k - 1] = temporalinst_make(temporalinst_value(instants2[k - 2]),
 				instants2[k - 1]->t, instants2[k - 1]->valuetypid); 
-			tofree[l++] = instants2[k - 1];
 		}
 	}
+	MemoryContextSwitchTo(oldctx);
 	*sync1 = temporalseq_from_temporalinstarr(instants1, k, 
 		inter->lower_inc, inter->upper_inc, linear1, false);
 	*sync2 = temporalseq_from_temporalinstarr(instants2, k, 
 		inter->lower_inc, inter->upper_inc, linear2, false);
-	
-	for (i = 0; i < l; i++)
-		pfree(tofree[i]);
-	pfree(instants1); pfree(instants2); pfree(tofree); pfree(inter);
+	temporal_arena_delete(arena);
+	pfree(inter);
+
+	return true;
+}
+
+/*****************************************************************************
+ * Cursor over the synchronized segments of two TemporalSeq values. Instead 
+ * of materializing the synchronized sequences as done by the function above,
+ * the cursor computes on demand the pairs of segments defined over the same 
+ * instants, so that a lifted function can consume them while only the 
+ * instants of the current segments are kept in memory. The instants are 
+ * those that synchronize_temporalseq_temporalseq would compute without 
+ * crossings. A typical use is as follows
+ *
+ *	SyncSeqCursor cursor;
+ *	if (temporalseq_sync_cursor_init(&cursor, seq1, seq2))
+ *	{
+ *		if (cursor.inter.lower == cursor.inter.upper)
+ *			... single synchronized instants given by cursor.end1/end2 ...
+ *		while (temporalseq_sync_cursor_next(&cursor))
+ *			... segments from cursor.start1/start2 to cursor.end1/end2 ...
+ *		temporalseq_sync_cursor_end(&cursor);
+ *	}
+ *****************************************************************************/
+
+/* Advance the cursor to the next synchronized instants */
+
+static void
+temporalseq_sync_cursor_step(SyncSeqCursor *cursor)
+{
+	TemporalSeq *seq1 = cursor->seq1, *seq2 = cursor->seq2;
+	TemporalInst *inst1 = temporalseq_inst_n(seq1, cursor->i);
+	TemporalInst *inst2 = temporalseq_inst_n(seq2, cursor->j);
+	cursor->freeend1 = cursor->freeend2 = false;
+	int cmp = timestamp_cmp_internal(inst1->t, inst2->t);
+	if (cmp == 0)
+	{
+		cursor->i++; cursor->j++;
+	}
+	else if (cmp < 0)
+	{
+		/* The instant is within the segment ending at inst2 */
+		cursor->i++;
+		inst2 = temporalseq_at_timestamp1(temporalseq_inst_n(seq2, 
+			cursor->j - 1), inst2, MOBDB_FLAGS_GET_LINEAR(seq2->flags), 
+			inst1->t);
+		cursor->freeend2 = true;
+	}
+	else
+	{
+		cursor->j++;
+		inst1 = temporalseq_at_timestamp1(temporalseq_inst_n(seq1, 
+			cursor->i - 1), inst1, MOBDB_FLAGS_GET_LINEAR(seq1->flags), 
+			inst2->t);
+		cursor->freeend1 = true;
+	}
+	cursor->end1 = inst1;
+	cursor->end2 = inst2;
+	cursor->last = (cursor->i == seq1->count || cursor->j == seq2->count);
+}
+
+/*
+ * Initialize the cursor with the synchronized instants at the start of the
+ * intersection of the periods of the sequences, which are given by end1 and 
+ * end2. Returns false if the sequences do not overlap in time. 
+ */
+bool
+temporalseq_sync_cursor_init(SyncSeqCursor *cursor, TemporalSeq *seq1, 
+	TemporalSeq *seq2)
+{
+	if (!intersection_period_period_internal1(&cursor->inter, &seq1->period,
+		&seq2->period))
+		return false;
+
+	cursor->seq1 = seq1;
+	cursor->seq2 = seq2;
+	cursor->first = true;
+	cursor->start1 = cursor->start2 = NULL;
+	cursor->freestart1 = cursor->freestart2 = false;
+	cursor->freeend1 = cursor->freeend2 = false;
+	cursor->lower_inc = cursor->upper_inc = false;
+	TimestampTz lower = cursor->inter.lower;
+	/* If the two sequences intersect at an instant */
+	if (timestamp_cmp_internal(lower, cursor->inter.upper) == 0)
+	{
+		cursor->end1 = temporalseq_at_timestamp(seq1, lower);
+		cursor->end2 = temporalseq_at_timestamp(seq2, lower);
+		cursor->freeend1 = cursor->freeend2 = true;
+		cursor->last = true;
+		return true;
+	}
 
+	/* One of the sequences starts at the lower bound of the intersection */
+	TemporalInst *inst1 = temporalseq_inst_n(seq1, 0);
+	TemporalInst *inst2 = temporalseq_inst_n(seq2, 0);
+	cursor->i = cursor->j = 1;
+	if (timestamp_cmp_internal(inst1->t, lower) < 0)
+	{
+		inst1 = temporalseq_at_timestamp(seq1, lower);
+		cursor->freeend1 = true;
+		cursor->i = temporalseq_find_timestamp(seq1, lower) + 1;
+	}
+	else if (timestamp_cmp_internal(inst2->t, lower) < 0)
+	{
+		inst2 = temporalseq_at_timestamp(seq2, lower);
+		cursor->freeend2 = true;
+		cursor->j = temporalseq_find_timestamp(seq2, lower) + 1;
+	}
+	cursor->end1 = inst1;
+	cursor->end2 = inst2;
+	cursor->last = (cursor->i == seq1->count || cursor->j == seq2->count);
 	return true;
 }
 
+/*
+ * Move the cursor to the next pair of synchronized segments, which go from
+ * start1/start2 to end1/end2 with the bounds lower_inc and upper_inc.
+ * Returns false when there are no more segments.
+ */
+bool
+temporalseq_sync_cursor_next(SyncSeqCursor *cursor)
+{
+	if (cursor->last)
+		return false;
+	if (cursor->freestart1)
+		pfree(cursor->start1);
+	if (cursor->freestart2)
+		pfree(cursor->start2);
+	cursor->start1 = cursor->end1;
+	cursor->start2 = cursor->end2;
+	cursor->freestart1 = cursor->freeend1;
+	cursor->freestart2 = cursor->freeend2;
+	temporalseq_sync_cursor_step(cursor);
+	cursor->lower_inc = cursor->first ? cursor->inter.lower_inc : true;
+	cursor->upper_inc = cursor->last ? cursor->inter.upper_inc : false;
+	cursor->first = false;
+	MOBDB_STAT_INC(sync_segments);
+	return true;
+}
+
+/* Free the instants interpolated by the cursor */
+
+void
+temporalseq_sync_cursor_end(SyncSeqCursor *cursor)
+{
+	if (cursor->freestart1)
+		pfree(cursor->start1);
+	if (cursor->freestart2)
+		pfree(cursor->start2);
+	if (cursor->freeend1)
+		pfree(cursor->end1);
+	if (cursor->freeend2)
+		pfree(cursor->end2);
+}
+
 /*****************************************************************************
  * Functions that find the single timestamptz at which two temporal segments
  * intersect or have a turning point, that is, a local minimum/maximum.
@@ -1313,43 +1927,23 @@ temporalseq_intersect_at_timestamp(TemporalInst *start1, TemporalInst *end1, boo
  * Input/output functions
  *****************************************************************************/
 
-/* Convert to string */
+/* Append the string representation to the buffer */
  
-char *
-temporalseq_to_string(TemporalSeq *seq, bool component, char *(*value_out)(Oid, Datum))
+void
+temporalseq_to_string_buf(StringInfo buf, TemporalSeq *seq, bool component,
+	void (*value_out)(StringInfo, Oid, Datum))
 {
-	char **strings = palloc(sizeof(char *) * seq->count);
-	size_t outlen = 0;
-	char str[20];
 	if (! component && linear_interpolation(seq->valuetypid) && 
 		!MOBDB_FLAGS_GET_LINEAR(seq->flags))
-		sprintf(str, "Interp=Stepwise;");
-	else
-		str[0] = '\0';
-	for (int i = 0; i < seq->count; i++)
-	{
-		TemporalInst *inst = temporalseq_inst_n(seq, i);
-		strings[i] = temporalinst_to_string(inst, value_out);
-		outlen += strlen(strings[i]) + 2;
-	}
-	char *result = palloc(strlen(str) + outlen + 3);
-	result[outlen] = '\0';
-	size_t pos = 0;
-	strcpy(result, str);
-	pos += strlen(str);
-	result[pos++] = seq->period.lower_inc ? (char) '[' : (char) '(';
+		appendStringInfoString(buf, "Interp=Stepwise;");
+	appendStringInfoChar(buf, seq->period.lower_inc ? '[' : '(');
 	for (int i = 0; i < seq->count; i++)
 	{
-		strcpy(result + pos, strings[i]);
-		pos += strlen(strings[i]);
-		result[pos++] = ',';
-		result[pos++] = ' ';
-		pfree(strings[i]);
+		if (i > 0)
+			appendBinaryStringInfo(buf, ", ", 2);
+		temporalinst_to_string_buf(buf, temporalseq_inst_n(seq, i), value_out);
 	}
-	result[pos - 2] = seq->period.upper_inc ? (char) ']' : (char) ')';
-	result[pos - 1] = '\0';
-	pfree(strings);
-	return result;
+	appendStringInfoChar(buf, seq->period.upper_inc ? ']' : ')');
 }
 
 /* Send function */
@@ -1423,6 +2017,8 @@ tfloatseq_to_tintseq(TemporalSeq *seq)
 	TemporalSeq *result = temporalseq_copy(seq);
 	result->valuetypid = INT4OID;
 	MOBDB_FLAGS_SET_LINEAR(result->flags, false);
+	/* The values are truncated, which changes the integral */
+	MOBDB_FLAGS_SET_SUMMARY(result->flags, false);
 	for (int i = 0; i < seq->count; i++)
 	{
 		TemporalInst *inst = temporalseq_inst_n(result, i);
@@ -1650,10 +2246,11 @@ temporalseq_min_value(TemporalSeq *seq)
 		return Float8GetDatum(box->xmin);
 	}
 	Datum result = temporalinst_value(temporalseq_inst_n(seq, 0));
+	const BaseTypeInfo *info = base_type_info(seq->valuetypid);
 	for (int i = 1; i < seq->count; i++)
 	{
 		Datum value = temporalinst_value(temporalseq_inst_n(seq, i));
-		if (datum_lt(value, result, seq->valuetypid))
+		if (info->lt(value, result))
 			result = value;
 	}
 	return result;
@@ -1675,10 +2272,11 @@ temporalseq_max_value(TemporalSeq *seq)
 		return Float8GetDatum(box->xmax);
 	}
 	Datum result = temporalinst_value(temporalseq_inst_n(seq, 0));
+	const BaseTypeInfo *info = base_type_info(seq->valuetypid);
 	for (int i = 1; i < seq->count; i++)
 	{
 		Datum value = temporalinst_value(temporalseq_inst_n(seq, i));
-		if (datum_gt(value, result, seq->valuetypid))
+		if (info->lt(result, value))
 			result = value;
 	}
 	return result;
@@ -1727,7 +2325,7 @@ temporalseq_instants_array(TemporalSeq *seq)
 TimestampTz
 temporalseq_start_timestamp(TemporalSeq *seq)
 {
-	return (temporalseq_inst_n(seq, 0))->t;
+	return seq->period.lower;
 }
 
 /* End timestamptz */
@@ -1735,7 +2333,7 @@ temporalseq_start_timestamp(TemporalSeq *seq)
 TimestampTz
 temporalseq_end_timestamp(TemporalSeq *seq)
 {
-	return (temporalseq_inst_n(seq, seq->count - 1))->t;
+	return seq->period.upper;
 }
 
 /* Timestamps */
@@ -1749,6 +2347,30 @@ temporalseq_timestamps1(TemporalSeq *seq)
 	return result;	
 }
 
+/* Values of a temporal number sequence as a contiguous array of doubles.
+ * Hot loops may then stream over this array and the one returned by
+ * temporalseq_timestamps1 instead of accessing the instants one by one */
+
+double *
+tnumberseq_values_double(TemporalSeq *seq)
+{
+	ensure_numeric_base_type(seq->valuetypid);
+	double *result = palloc(sizeof(double) * seq->count);
+	if (seq->valuetypid == INT4OID)
+	{
+		for (int i = 0; i < seq->count; i++) 
+			result[i] = (double)(DatumGetInt32(temporalinst_value(
+				temporalseq_inst_n(seq, i))));
+	}
+	else
+	{
+		for (int i = 0; i < seq->count; i++) 
+			result[i] = DatumGetFloat8(temporalinst_value(
+				temporalseq_inst_n(seq, i)));
+	}
+	return result;	
+}
+
 ArrayType *
 temporalseq_timestamps(TemporalSeq *seq)
 {
@@ -1758,31 +2380,99 @@ temporalseq_timestamps(TemporalSeq *seq)
 	return result;	
 }
 
+/* 
+ * Add the bytes of the sequence to the breakdown of its memory layout.
+ * The bit stream of a compressed sequence, which encodes both the
+ * timestamps and the values, is counted as base values, and the bounding
+ * box kept in its header as bounding box.
+ */
+void
+temporalseq_layout(TemporalSeq *seq, TemporalLayout *layout)
+{
+	if (MOBDB_FLAGS_GET_COMPRESSED(seq->flags))
+	{
+		layout->base_values += temporalseq_compressed_stream_size(seq);
+		layout->bbox += temporalseq_compressed_bbox_size(seq);
+		return;
+	}
+	layout->offsets += (seq->count + 2) * sizeof(size_t);
+	for (int i = 0; i < seq->count; i++)
+		temporalinst_layout(temporalseq_inst_n(seq, i), layout);
+	layout->bbox += double_pad(temporal_bbox_size(seq->valuetypid));
+	if (MOBDB_FLAGS_GET_SUMMARY(seq->flags))
+		layout->bbox += double_pad(sizeof(TemporalSeqSummary));
+#ifdef WITH_POSTGIS
+	if ((seq->valuetypid == type_oid(T_GEOMETRY) ||
+		seq->valuetypid == type_oid(T_GEOGRAPHY)) &&
+		! MOBDB_FLAGS_GET_NOTRAJ(seq->flags))
+		layout->trajectory += double_pad(VARSIZE(DatumGetPointer(
+			tpointseq_trajectory(seq))));
+#endif
+}
+
 /* Shift the time span of a temporal value by an interval */
 
 TemporalSeq *
 temporalseq_shift(TemporalSeq *seq, Interval *interval)
 {
+	/* The trajectory and the summary do not depend on time and are kept */
 	TemporalSeq *result = temporalseq_copy(seq);
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * seq->count);
 	for (int i = 0; i < seq->count; i++)
 	{
-		TemporalInst *inst = instants[i] = temporalseq_inst_n(result, i);
-		inst->t = DatumGetTimestampTz(
-			DirectFunctionCall2(timestamptz_pl_interval,
-			TimestampTzGetDatum(inst->t), PointerGetDatum(interval)));
+		TemporalInst *inst = temporalseq_inst_n(result, i);
+		inst->t = timestamp_shift(inst->t, interval);
 	}
 	/* Shift period */
-	result->period.lower = DatumGetTimestampTz(
-			DirectFunctionCall2(timestamptz_pl_interval,
-			TimestampTzGetDatum(seq->period.lower), PointerGetDatum(interval)));
-	result->period.upper = DatumGetTimestampTz(
-			DirectFunctionCall2(timestamptz_pl_interval,
-			TimestampTzGetDatum(seq->period.upper), PointerGetDatum(interval)));
+	result->period.lower = timestamp_shift(seq->period.lower, interval);
+	result->period.upper = timestamp_shift(seq->period.upper, interval);
 	/* Shift bounding box */
 	void *bbox = temporalseq_bbox_ptr(result); 
 	shift_bbox(bbox, seq->valuetypid, interval);
-	pfree(instants);
+	return result;
+}
+
+/*
+ * Scale in place the time span of a temporal value by a factor from an
+ * origin. The function errors when two instants are scaled to the same
+ * timestamp.
+ */
+
+void
+temporalseq_tscale1(TemporalSeq *seq, TimestampTz origin, double scale)
+{
+	for (int i = 0; i < seq->count; i++)
+	{
+		TemporalInst *inst = temporalseq_inst_n(seq, i);
+		inst->t = timestamp_tscale(inst->t, origin, scale);
+		if (i > 0 && inst->t <= temporalseq_inst_n(seq, i - 1)->t)
+			ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), 
+				errmsg("The interval is too small to scale the temporal value")));
+	}
+	/* Scale period */
+	seq->period.lower = timestamp_tscale(seq->period.lower, origin, scale);
+	seq->period.upper = timestamp_tscale(seq->period.upper, origin, scale);
+	/* Scale bounding box */
+	void *bbox = temporalseq_bbox_ptr(seq); 
+	tscale_bbox(bbox, seq->valuetypid, origin, scale);
+	/* The integral of temporal numbers depends on time and is recomputed */
+	TemporalSeqSummary *summary = temporalseq_summary_ptr(seq);
+	if (summary != NULL && 
+		(seq->valuetypid == INT4OID || seq->valuetypid == FLOAT8OID))
+	{
+		MOBDB_FLAGS_SET_SUMMARY(seq->flags, false);
+		double integral = tnumberseq_integral(seq);
+		MOBDB_FLAGS_SET_SUMMARY(seq->flags, true);
+		summary->integral = integral;
+	}
+}
+
+/* Scale the time span of a temporal value by a factor from an origin */
+
+TemporalSeq *
+temporalseq_tscale(TemporalSeq *seq, TimestampTz origin, double scale)
+{
+	TemporalSeq *result = temporalseq_copy(seq);
+	temporalseq_tscale1(result, origin, scale);
 	return result;
 }
 
@@ -1832,14 +2522,25 @@ temporalseq_ever_eq(TemporalSeq *seq, Datum value)
 		double d = datum_double(value, seq->valuetypid);
 		if (d < box.xmin || box.xmax < d)
 			return false;
+		/* The minimum and maximum values are always taken by a sequence 
+		 * with stepwise interpolation, while a sequence with linear 
+		 * interpolation takes all values between them */
+		if (! MOBDB_FLAGS_GET_LINEAR(seq->flags))
+		{
+			if (d == box.xmin || d == box.xmax)
+				return true;
+		}
+		else if (box.xmin < d && d < box.xmax)
+			return true;
 	}
 
 	if (! MOBDB_FLAGS_GET_LINEAR(seq->flags) || seq->count == 1)
 	{
+		const BaseTypeInfo *info = base_type_info(seq->valuetypid);
 		for (int i = 0; i < seq->count; i++) 
 		{
 			Datum valueinst = temporalinst_value(temporalseq_inst_n(seq, i));
-			if (datum_eq(valueinst, value, seq->valuetypid))
+			if (info->eq(valueinst, value))
 				return true;
 		}
 		return false;
@@ -1871,21 +2572,18 @@ temporalseq_always_eq(TemporalSeq *seq, Datum value)
 		TBOX box;
 		memset(&box, 0, sizeof(TBOX));
 		temporalseq_bbox(&box, seq);
-		if (seq->valuetypid == INT4OID)
-			return box.xmin == box.xmax &&
-				(int)(box.xmax) == DatumGetInt32(value);
-		else
-			return box.xmin == box.xmax &&
-				(int)(box.xmax) == DatumGetFloat8(value);
+		double d = datum_double(value, seq->valuetypid);
+		return box.xmin == box.xmax && box.xmax == d;
 	}
 
 	/* The following test assumes that the sequence is in normal form */
 	if (seq->count > 2)
 		return false;
+	const BaseTypeInfo *info = base_type_info(seq->valuetypid);
 	for (int i = 0; i < seq->count; i++) 
 	{
 		Datum valueinst = temporalinst_value(temporalseq_inst_n(seq, i));
-		if (datum_ne(valueinst, value, seq->valuetypid))
+		if (! info->eq(valueinst, value))
 			return false;
 	}
 	return true;
@@ -1925,7 +2623,7 @@ tempcontseq_always_lt1(Datum value1, Datum value2, Oid valuetypid,
 {
 	/* Constant segment */
 	if (datum_eq(value1, value2, valuetypid))
-		return datum_lt(value1, value1, valuetypid);
+		return datum_lt(value1, value, valuetypid);
 	/* Increasing segment */
 	if (datum_lt(value1, value2, valuetypid))
 		return datum_lt(value2, value, valuetypid) ||
@@ -1962,17 +2660,18 @@ temporalseq_ever_lt(TemporalSeq *seq, Datum value)
 		memset(&box, 0, sizeof(TBOX));
 		temporalseq_bbox(&box, seq);
 		double d = datum_double(value, seq->valuetypid);
-		/* Maximum value may be non inclusive */ 
-		if (d < box.xmin)
-			return false;
+		/* The minimum value may be taken only at an exclusive bound, but
+		 * then values arbitrarily close to it are taken */ 
+		return box.xmin < d;
 	}
 
 	if (! MOBDB_FLAGS_GET_LINEAR(seq->flags) || seq->count == 1)
 	{
+		const BaseTypeInfo *info = base_type_info(seq->valuetypid);
 		for (int i = 0; i < seq->count; i++) 
 		{
 			Datum valueinst = temporalinst_value(temporalseq_inst_n(seq, i));
-			if (datum_lt(valueinst, value, seq->valuetypid))
+			if (info->lt(valueinst, value))
 				return true;
 		}
 		return false;
@@ -2007,14 +2706,20 @@ temporalseq_ever_le(TemporalSeq *seq, Datum value)
 		double d = datum_double(value, seq->valuetypid);
 		if (d < box.xmin)
 			return false;
+		/* Only when d is equal to the minimum value of a sequence with 
+		 * linear interpolation it must be verified whether this value is 
+		 * taken only at an exclusive bound */
+		if (box.xmin < d || ! MOBDB_FLAGS_GET_LINEAR(seq->flags))
+			return true;
 	}
 
 	if (! MOBDB_FLAGS_GET_LINEAR(seq->flags) || seq->count == 1)
 	{
+		const BaseTypeInfo *info = base_type_info(seq->valuetypid);
 		for (int i = 0; i < seq->count; i++) 
 		{
 			Datum valueinst = temporalinst_value(temporalseq_inst_n(seq, i));
-			if (datum_le(valueinst, value, seq->valuetypid))
+			if (info->eq(valueinst, value) || info->lt(valueinst, value))
 				return true;
 		}
 		return false;
@@ -2048,17 +2753,22 @@ temporalseq_always_lt(TemporalSeq *seq, Datum value)
 		memset(&box, 0, sizeof(TBOX));
 		temporalseq_bbox(&box, seq);
 		double d = datum_double(value, seq->valuetypid);
-		/* Minimum value may be non inclusive */ 
 		if (d < box.xmax)
 			return false;
+		/* Only when d is equal to the maximum value of a sequence with 
+		 * linear interpolation it must be verified whether this value is 
+		 * taken only at an exclusive bound */
+		if (box.xmax < d || ! MOBDB_FLAGS_GET_LINEAR(seq->flags))
+			return box.xmax < d;
 	}
 
 	if (! MOBDB_FLAGS_GET_LINEAR(seq->flags) || seq->count == 1)
 	{
+		const BaseTypeInfo *info = base_type_info(seq->valuetypid);
 		for (int i = 0; i < seq->count; i++) 
 		{
 			Datum valueinst = temporalinst_value(temporalseq_inst_n(seq, i));
-			if (! datum_lt(valueinst, value, seq->valuetypid))
+			if (! info->lt(valueinst, value))
 				return false;
 		}
 		return true;
@@ -2092,16 +2802,16 @@ temporalseq_always_le(TemporalSeq *seq, Datum value)
 		memset(&box, 0, sizeof(TBOX));
 		temporalseq_bbox(&box, seq);
 		double d = datum_double(value, seq->valuetypid);
-		if (d < box.xmax)
-			return false;
+		return box.xmax <= d;
 	}
 
 	if (! MOBDB_FLAGS_GET_LINEAR(seq->flags) || seq->count == 1)
 	{
+		const BaseTypeInfo *info = base_type_info(seq->valuetypid);
 		for (int i = 0; i < seq->count; i++) 
 		{
 			Datum valueinst = temporalinst_value(temporalseq_inst_n(seq, i));
-			if (! datum_le(valueinst, value, seq->valuetypid))
+			if (! (info->eq(valueinst, value) || info->lt(valueinst, value)))
 				return false;
 		}
 		return true;
@@ -2247,7 +2957,7 @@ temporalseq_at_value1(TemporalInst *inst1, TemporalInst *inst2,
 		TemporalInst *instants[2];
 		instants[0] = inst1;
 		instants[1] = inst2;
-		TemporalSeq *result = temporalseq_from_temporalinstarr(instants, 2,
+		TemporalSeq *result = temporalseq_from_temporalinstarr_trusted(instants, 2,
 			lower_inc, upper_inc, linear, false);
 		return result;
 	}
@@ -2262,14 +2972,14 @@ temporalseq_at_value1(TemporalInst *inst1, TemporalInst *inst2,
 			TemporalInst *instants[2];
 			instants[0] = inst1;
 			instants[1] = temporalinst_make(value1, inst2->t, valuetypid);
-			result = temporalseq_from_temporalinstarr(instants, 2,
+			result = temporalseq_from_temporalinstarr_trusted(instants, 2,
 				lower_inc, false, linear, false);
 			pfree(instants[1]);
 		}
 		else if (upper_inc && datum_eq(value, value2, valuetypid))
 		{
 			/* <x@t1 value@t2] */
-			result = temporalseq_from_temporalinstarr(&inst2, 1,
+			result = temporalseq_from_temporalinstarr_trusted(&inst2, 1,
 				true, true, linear, false);
 		}
 		return result;
@@ -2280,14 +2990,14 @@ temporalseq_at_value1(TemporalInst *inst1, TemporalInst *inst2,
 	{
 		if (!lower_inc)
 			return NULL;
-		return temporalseq_from_temporalinstarr(&inst1, 1,
+		return temporalseq_from_temporalinstarr_trusted(&inst1, 1,
 				true, true, linear, false);
 	}
 	if (datum_eq(value2, value, valuetypid))
 	{
 		if (!upper_inc)
 			return NULL;
-		return temporalseq_from_temporalinstarr(&inst2, 1, 
+		return temporalseq_from_temporalinstarr_trusted(&inst2, 1, 
 				true, true, linear, false);
 	}
 	
@@ -2297,12 +3007,135 @@ temporalseq_at_value1(TemporalInst *inst1, TemporalInst *inst2,
 		return NULL;
 	
 	TemporalInst *inst = temporalinst_make(value, t, valuetypid);
-	TemporalSeq *result = temporalseq_from_temporalinstarr(&inst, 1, 
+	TemporalSeq *result = temporalseq_from_temporalinstarr_trusted(&inst, 1, 
 		true, true, linear, false);
 	pfree(inst);
 	return result;
 }
 
+/*
+ * Append a period to an array of periods. The period is merged with the
+ * last one of the array when they are adjacent, as it is done when
+ * normalizing the resulting fragments. The function returns the new number
+ * of periods.
+ */
+static int
+periodarr_append_merge(Period *periods, int count, TimestampTz lower,
+	TimestampTz upper, bool lower_inc, bool upper_inc)
+{
+	if (count > 0)
+	{
+		Period *last = &periods[count - 1];
+		if (last->upper == lower && (last->upper_inc || lower_inc))
+		{
+			last->upper = upper;
+			last->upper_inc = upper_inc;
+			return count;
+		}
+	}
+	period_set(&periods[count], lower, upper, lower_inc, upper_inc);
+	return count + 1;
+}
+
+/*
+ * Periods during which a temporal number takes a value, computed in a single
+ * pass over the raw arrays of the values and the timestamps of its instants.
+ * The crossings of the linear segments are computed analytically as in
+ * tlinearseq_timestamp_at_value. The periods are appended to the array 
+ * starting at position count and the function returns the new number of
+ * periods.
+ */
+static int
+tnumberseq_at_value_kernel(const double *values, const TimestampTz *times,
+	int n, bool lower_inc, bool upper_inc, bool linear, double value,
+	Period *periods, int count)
+{
+	if (n == 1)
+	{
+		if (values[0] == value)
+			count = periodarr_append_merge(periods, count, times[0], times[0],
+				true, true);
+		return count;
+	}
+	for (int i = 1; i < n; i++)
+	{
+		double value1 = values[i - 1], value2 = values[i];
+		TimestampTz t1 = times[i - 1], t2 = times[i];
+		bool lower_inc1 = (i == 1) ? lower_inc : true;
+		bool upper_inc1 = (i == n - 1) ? upper_inc : false;
+		/* Constant segment (stepwise or linear interpolation) */
+		if (value1 == value2)
+		{
+			if (value1 == value)
+				count = periodarr_append_merge(periods, count, t1, t2,
+					lower_inc1, upper_inc1);
+		}
+		/* Stepwise interpolation */
+		else if (! linear)
+		{
+			if (value1 == value)
+				count = periodarr_append_merge(periods, count, t1, t2,
+					lower_inc1, false);
+			else if (upper_inc1 && value2 == value)
+				count = periodarr_append_merge(periods, count, t2, t2,
+					true, true);
+		}
+		/* Linear interpolation: Test of bounds */
+		else if (value1 == value)
+		{
+			if (lower_inc1)
+				count = periodarr_append_merge(periods, count, t1, t1,
+					true, true);
+		}
+		else if (value2 == value)
+		{
+			if (upper_inc1)
+				count = periodarr_append_merge(periods, count, t2, t2,
+					true, true);
+		}
+		/* Linear interpolation: Crossing */
+		else
+		{
+			double min = Min(value1, value2);
+			double max = Max(value1, value2);
+			if (value < min || value > max)
+				continue;
+			double fraction = value1 < value2 ?
+				(value - min) / (max - min) : 1 - (value - min) / (max - min);
+			if (fabs(fraction) < EPSILON || fabs(fraction - 1.0) < EPSILON)
+				continue;
+			TimestampTz t = t1 + (long) ((double) (t2 - t1) * fraction);
+			count = periodarr_append_merge(periods, count, t, t, true, true);
+		}
+	}
+	return count;
+}
+
+/*
+ * Periods during which a temporal number sequence takes a value. The 
+ * periods are appended to the array starting at position count, which must
+ * have space for seq->count additional periods, and the function returns
+ * the new number of periods. A period adjacent to the last one of the array,
+ * e.g., computed from the previous sequence of a TemporalS, is merged with it.
+ */
+int
+tnumberseq_at_value_periods(TemporalSeq *seq, double value, Period *periods,
+	int count)
+{
+	/* Bounding box test */
+	TBOX *box = (TBOX *) temporalseq_bbox_ptr(seq);
+	if (value < box->xmin || value > box->xmax)
+		return count;
+
+	double *values = tnumberseq_values_double(seq);
+	TimestampTz *times = temporalseq_timestamps1(seq);
+	count = tnumberseq_at_value_kernel(values, times, seq->count,
+		seq->period.lower_inc, seq->period.upper_inc,
+		MOBDB_FLAGS_GET_LINEAR(seq->flags), value, periods, count);
+	pfree(values); pfree(times);
+	return count;
+}
+
 /* 
    Restriction to a value.
    This function is called for each sequence of a TemporalS.
@@ -2355,6 +3188,20 @@ temporalseq_at_value2(TemporalSeq **result, TemporalSeq *seq, Datum value)
 TemporalS *
 temporalseq_at_value(TemporalSeq *seq, Datum value)
 {
+	/* Temporal numbers are restricted from the periods where they take
+	 * the value */
+	if (seq->valuetypid == INT4OID || seq->valuetypid == FLOAT8OID)
+	{
+		Period *periods = palloc(sizeof(Period) * seq->count);
+		int count = tnumberseq_at_value_periods(seq, 
+			datum_double(value, seq->valuetypid), periods, 0);
+		TemporalS *result = (count == 0) ? NULL :
+			tnumbers_from_base_periodarr(value, seq->valuetypid, periods,
+				count, MOBDB_FLAGS_GET_LINEAR(seq->flags));
+		pfree(periods);
+		return result;
+	}
+
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * seq->count);
 	int count = temporalseq_at_value2(sequences, seq, value);
 	if (count == 0)
@@ -2392,7 +3239,7 @@ tlinearseq_minus_value1(TemporalSeq **result,
 
 		instants[0] = inst1;
 		instants[1] = inst2;
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
+		result[0] = temporalseq_from_temporalinstarr_trusted(instants, 2,
 			lower_inc, upper_inc, true, false);
 		return 1;
 	}
@@ -2402,7 +3249,7 @@ tlinearseq_minus_value1(TemporalSeq **result,
 	{
 		instants[0] = inst1;
 		instants[1] = inst2;
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
+		result[0] = temporalseq_from_temporalinstarr_trusted(instants, 2,
 			false, upper_inc, true, false);
 		return 1;
 	}
@@ -2410,7 +3257,7 @@ tlinearseq_minus_value1(TemporalSeq **result,
 	{
 		instants[0] = inst1;
 		instants[1] = inst2;
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
+		result[0] = temporalseq_from_temporalinstarr_trusted(instants, 2,
 			lower_inc, false, true, false);
 		return 1;
 	}
@@ -2421,17 +3268,17 @@ tlinearseq_minus_value1(TemporalSeq **result,
 	{
 		instants[0] = inst1;
 		instants[1] = inst2;
-		result[0] = temporalseq_from_temporalinstarr(instants, 2,
+		result[0] = temporalseq_from_temporalinstarr_trusted(instants, 2,
 			lower_inc, upper_inc, true, false);
 		return 1;
 	}
 	instants[0] = inst1;
 	instants[1] = temporalinst_make(value, t, valuetypid);
-	result[0] = temporalseq_from_temporalinstarr(instants, 2,
+	result[0] = temporalseq_from_temporalinstarr_trusted(instants, 2,
 			lower_inc, false, true, false);
 	instants[0] = instants[1];
 	instants[1] = inst2;
-	result[1] = temporalseq_from_temporalinstarr(instants, 2,
+	result[1] = temporalseq_from_temporalinstarr_trusted(instants, 2,
 			false, upper_inc, true, false);
 	pfree(instants[0]);
 	return 2;
@@ -2490,7 +3337,7 @@ temporalseq_minus_value2(TemporalSeq **result, TemporalSeq *seq, Datum value)
 					instants[j] = temporalinst_make(temporalinst_value(instants[j - 1]),
 						inst->t, valuetypid);
 					bool upper_inc = (i == seq->count - 2) ? seq->period.upper_inc : false;
-					result[k++] = temporalseq_from_temporalinstarr(instants, j + 1,
+					result[k++] = temporalseq_from_temporalinstarr_trusted(instants, j + 1,
 						lower_inc, upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
 					pfree(instants[j]);
 					j = 0;
@@ -2501,7 +3348,7 @@ temporalseq_minus_value2(TemporalSeq **result, TemporalSeq *seq, Datum value)
 				instants[j++] = inst;
 		}
 		if (j > 0)
-			result[k++] = temporalseq_from_temporalinstarr(instants, j,
+			result[k++] = temporalseq_from_temporalinstarr_trusted(instants, j,
 				lower_inc, seq->period.upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
 		pfree(instants);
 	}
@@ -2668,48 +3515,65 @@ temporalseq_minus_values(TemporalSeq *seq, Datum *values, int count)
 	return result;
 }
 
-/* Restriction to the range for a segment */
+/*
+ * Restriction to the range for a segment.
+ * The range is given deserialized so that the function does not read it
+ * again for each segment of a sequence.
+ */
 
 static TemporalSeq *
 tnumberseq_at_range1(TemporalInst *inst1, TemporalInst *inst2, 
-	bool lower_incl, bool upper_incl, bool linear, RangeType *range)
+	bool lower_incl, bool upper_incl, bool linear, const RangeBounds *bounds)
 {
-	TypeCacheEntry *typcache = lookup_type_cache(range->rangetypid, TYPECACHE_RANGE_INFO);
 	Datum value1 = temporalinst_value(inst1);
 	Datum value2 = temporalinst_value(inst2);
 	Oid valuetypid = inst1->valuetypid;
 	/* Discrete base type or constant segment */
 	if (!linear || datum_eq(value1, value2, valuetypid))
 	{
-		if (!range_contains_elem_internal(typcache, range, value1)) 
+		if (!range_bounds_contains_elem(bounds, value1)) 
 			return NULL;
 
 		TemporalInst *instants[2];
 		instants[0] = inst1;
 		instants[1] = linear ? inst2 : 
 			temporalinst_make(value1, inst2->t, valuetypid);
-		TemporalSeq *result = temporalseq_from_temporalinstarr(instants, 2,
+		TemporalSeq *result = temporalseq_from_temporalinstarr_trusted(instants, 2,
 			lower_incl, upper_incl, linear, false);
 		return result;
 	}
 
 	/* Ensure data type with linear interpolation */
 	assert(valuetypid == FLOAT8OID);
-	RangeType *valuerange = (DatumGetFloat8(value1) < DatumGetFloat8(value2)) ?
-		range_make(value1, value2, lower_incl, upper_incl, FLOAT8OID) :
-		range_make(value2, value1, upper_incl, lower_incl, FLOAT8OID);	
-	RangeType *intersect = DatumGetRangeTypeP(call_function2(range_intersect, 
-		RangeTypePGetDatum(valuerange), RangeTypePGetDatum(range)));
-	if (RangeIsEmpty(intersect))
-	{
-		pfree(valuerange);
-		pfree(intersect);
+	if (bounds->empty)
 		return NULL;
+	/* Bounds of the range of values of the segment */
+	RangeBound lower1, upper1;
+	lower1.infinite = upper1.infinite = false;
+	lower1.lower = true;
+	upper1.lower = false;
+	if (DatumGetFloat8(value1) < DatumGetFloat8(value2))
+	{
+		lower1.val = value1; lower1.inclusive = lower_incl;
+		upper1.val = value2; upper1.inclusive = upper_incl;
+	}
+	else
+	{
+		lower1.val = value2; lower1.inclusive = upper_incl;
+		upper1.val = value1; upper1.inclusive = lower_incl;
 	}
+	/* Intersection of the two ranges as in range_intersect */
+	RangeBound lower2 = bounds->lower, upper2 = bounds->upper;
+	RangeBound *lower = (range_cmp_bounds(bounds->typcache, &lower1, 
+		&lower2) >= 0) ? &lower1 : &lower2;
+	RangeBound *upper = (range_cmp_bounds(bounds->typcache, &upper1, 
+		&upper2) <= 0) ? &upper1 : &upper2;
+	if (range_cmp_bounds(bounds->typcache, lower, upper) > 0)
+		return NULL;
 
 	TemporalSeq *result;
-	Datum lowervalue = lower_datum(intersect);
-	Datum uppervalue = upper_datum(intersect);
+	Datum lowervalue = lower->val;
+	Datum uppervalue = upper->val;
 	/* Intersection range is a single value */
 	if (datum_eq(lowervalue, uppervalue, valuetypid))
 	{
@@ -2718,7 +3582,7 @@ tnumberseq_at_range1(TemporalInst *inst1, TemporalInst *inst2,
 			linear, true, true, lowervalue);
 		/* We are sure that newseq is an instant sequence */
 		TemporalInst *inst = temporalseq_inst_n(newseq, 0);
-		result = temporalseq_from_temporalinstarr(&inst, 1,
+		result = temporalseq_from_temporalinstarr_trusted(&inst, 1,
 			true, true, linear, false);
 		pfree(newseq); 
 	}
@@ -2740,9 +3604,9 @@ tnumberseq_at_range1(TemporalInst *inst1, TemporalInst *inst2,
 			instants[0] = temporalseq_inst_n(newseq1, 0);
 			instants[1] = temporalseq_inst_n(newseq2, 0);
 			lower_incl1 = (timestamp_cmp_internal(time1, inst1->t) == 0) ? 
-				lower_incl && lower_inc(intersect) : lower_inc(intersect);
+				lower_incl && lower->inclusive : lower->inclusive;
 			upper_incl1 = (timestamp_cmp_internal(time2, inst2->t) == 0) ? 
-				upper_incl && upper_inc(intersect) : upper_inc(intersect);
+				upper_incl && upper->inclusive : upper->inclusive;
 		}
 		else
 		{
@@ -2750,15 +3614,14 @@ tnumberseq_at_range1(TemporalInst *inst1, TemporalInst *inst2,
 			instants[0] = temporalseq_inst_n(newseq2, 0);
 			instants[1] = temporalseq_inst_n(newseq1, 0);
 			lower_incl1 = (timestamp_cmp_internal(time2, inst1->t) == 0) ? 
-				lower_incl && upper_inc(intersect) : upper_inc(intersect);
+				lower_incl && upper->inclusive : upper->inclusive;
 			upper_incl1 = (timestamp_cmp_internal(time1, inst1->t) == 0) ? 
-				upper_incl && lower_inc(intersect) : lower_inc(intersect);
+				upper_incl && lower->inclusive : lower->inclusive;
 		}
-		result = temporalseq_from_temporalinstarr(instants, 2,
+		result = temporalseq_from_temporalinstarr_trusted(instants, 2,
 			lower_incl1, upper_incl1, linear, false);
 		pfree(newseq1); pfree(newseq2); 
 	}
-	pfree(valuerange); pfree(intersect); 
 
 	return result;
 }
@@ -2768,14 +3631,15 @@ tnumberseq_at_range1(TemporalInst *inst1, TemporalInst *inst2,
  * This function is called for each sequence of a TemporalS.
  */
 int 
-tnumberseq_at_range2(TemporalSeq **result, TemporalSeq *seq, RangeType *range)
+tnumberseq_at_range2(TemporalSeq **result, TemporalSeq *seq,
+	const RangeBounds *bounds)
 {
 	/* Bounding box test */
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
 	temporalseq_bbox(&box1, seq);
-	range_to_tbox_internal(&box2, range);
+	range_bounds_to_tbox(&box2, bounds);
 	if (!overlaps_tbox_tbox_internal(&box1, &box2))
 		return 0;
 
@@ -2795,7 +3659,7 @@ tnumberseq_at_range2(TemporalSeq **result, TemporalSeq *seq, RangeType *range)
 		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
 		bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
 		TemporalSeq *seq1 = tnumberseq_at_range1(inst1, inst2, 
-			lower_inc, upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), range);
+			lower_inc, upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), bounds);
 		if (seq1 != NULL) 
 			result[k++] = seq1;
 		inst1 = inst2;
@@ -2805,10 +3669,10 @@ tnumberseq_at_range2(TemporalSeq **result, TemporalSeq *seq, RangeType *range)
 }
 
 TemporalS *
-tnumberseq_at_range(TemporalSeq *seq, RangeType *range)
+tnumberseq_at_range(TemporalSeq *seq, const RangeBounds *bounds)
 {
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * seq->count);
-	int count = tnumberseq_at_range2(sequences, seq, range);
+	int count = tnumberseq_at_range2(sequences, seq, bounds);
 	if (count == 0)
 		return NULL;
 
@@ -2825,14 +3689,15 @@ tnumberseq_at_range(TemporalSeq *seq, RangeType *range)
  * This function is called for each sequence of a TemporalS.
  */
 int
-tnumberseq_minus_range1(TemporalSeq **result, TemporalSeq *seq, RangeType *range)
+tnumberseq_minus_range1(TemporalSeq **result, TemporalSeq *seq,
+	const RangeBounds *bounds)
 {
 	/* Bounding box test */
 	TBOX box1, box2;
 	memset(&box1, 0, sizeof(TBOX));
 	memset(&box2, 0, sizeof(TBOX));
 	temporalseq_bbox(&box1, seq);
-	range_to_tbox_internal(&box2, range);
+	range_bounds_to_tbox(&box2, bounds);
 	if (!overlaps_tbox_tbox_internal(&box1, &box2))
 	{
 		result[0] = temporalseq_copy(seq);
@@ -2847,7 +3712,7 @@ tnumberseq_minus_range1(TemporalSeq **result, TemporalSeq *seq, RangeType *range
 	 * General case
 	 * Compute first tnumberseq_at_range, then compute its complement.
 	 */
-	TemporalS *ts = tnumberseq_at_range(seq, range);
+	TemporalS *ts = tnumberseq_at_range(seq, bounds);
 	if (ts == NULL)
 	{
 		result[0] = temporalseq_copy(seq);
@@ -2868,7 +3733,7 @@ tnumberseq_minus_range1(TemporalSeq **result, TemporalSeq *seq, RangeType *range
 }
 
 TemporalS *
-tnumberseq_minus_range(TemporalSeq *seq, RangeType *range)
+tnumberseq_minus_range(TemporalSeq *seq, const RangeBounds *bounds)
 {
 	int maxcount;
 	if (! MOBDB_FLAGS_GET_LINEAR(seq->flags))
@@ -2876,7 +3741,7 @@ tnumberseq_minus_range(TemporalSeq *seq, RangeType *range)
 	else 
 		maxcount = seq->count * 2;
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * maxcount);
-	int count = tnumberseq_minus_range1(sequences, seq, range);
+	int count = tnumberseq_minus_range1(sequences, seq, bounds);
 	if (count == 0)
 	{
 		pfree(sequences);
@@ -2894,16 +3759,21 @@ tnumberseq_minus_range(TemporalSeq *seq, RangeType *range)
 /* 
  * Restriction to an array of ranges 
  * This function is called for each sequence of a TemporalS.
+ * The ranges are normalized, that is, sorted and disjoint. For each segment,
+ * the ranges that may intersect the values of the segment are located by a
+ * binary search and only these ranges are tested. The fragments are emitted
+ * in the order of the ranges for a segment increasing in value and in the
+ * reverse order otherwise, so that the result is ordered by time.
  */
 int
 tnumberseq_at_ranges1(TemporalSeq **result, TemporalSeq *seq, 
-	RangeType **normranges, int count)
+	const RangeBounds *normbounds, int count)
 {
 	/* Instantaneous sequence */
 	if (seq->count == 1)
 	{
 		TemporalInst *inst = temporalseq_inst_n(seq, 0);
-		TemporalInst *inst1 = tnumberinst_at_ranges(inst, normranges, count);
+		TemporalInst *inst1 = tnumberinst_at_ranges(inst, normbounds, count);
 		if (inst1 == NULL)
 			return 0;
 		pfree(inst1); 
@@ -2912,35 +3782,56 @@ tnumberseq_at_ranges1(TemporalSeq **result, TemporalSeq *seq,
 	}
 
 	/* General case */
+	TypeCacheEntry *typcache = normbounds[0].typcache;
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
 	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
 	bool lower_inc = seq->period.lower_inc;
+	RangeBound lower, upper;
+	lower.infinite = upper.infinite = false;
+	lower.inclusive = upper.inclusive = true;
+	lower.lower = true;
+	upper.lower = false;
 	int k = 0;	
 	for (int i = 1; i < seq->count; i++)
 	{
 		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
 		bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-		for (int j = 0; j < count; j++)
+		/* Values taken by the segment, only the first one when stepwise */
+		Datum value1 = temporalinst_value(inst1);
+		Datum value2 = linear ? temporalinst_value(inst2) : value1;
+		bool increasing = ! linear ||
+			DatumGetFloat8(value1) <= DatumGetFloat8(value2);
+		lower.val = increasing ? value1 : value2;
+		upper.val = increasing ? value2 : value1;
+		int first = rangearr_bounds_find(normbounds, count, &lower);
+		int last = first;
+		while (last < count)
+		{
+			RangeBound rlower = normbounds[last].lower;
+			if (range_cmp_bounds(typcache, &rlower, &upper) > 0)
+				break;
+			last++;
+		}
+		for (int j = first; j < last; j++)
 		{
+			int pos = increasing ? j : first + last - 1 - j;
 			TemporalSeq *seq1 = tnumberseq_at_range1(inst1, inst2, 
-				lower_inc, upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), normranges[j]);
+				lower_inc, upper_inc, linear, &normbounds[pos]);
 			if (seq1 != NULL) 
 				result[k++] = seq1;
 		}
 		inst1 = inst2;
 		lower_inc = true;
 	}
-	if (k == 0) 
-		return 0;
-	
-	temporalseqarr_sort(result, k);
 	return k;
 }
 
 TemporalS *
-tnumberseq_at_ranges(TemporalSeq *seq, RangeType **normranges, int count)
+tnumberseq_at_ranges(TemporalSeq *seq, const RangeBounds *normbounds,
+	int count)
 {
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * seq->count * count);
-	int newcount = tnumberseq_at_ranges1(sequences, seq, normranges, count);
+	int newcount = tnumberseq_at_ranges1(sequences, seq, normbounds, count);
 	if (newcount == 0)
 	{
 		pfree(sequences);
@@ -2959,13 +3850,14 @@ tnumberseq_at_ranges(TemporalSeq *seq, RangeType **normranges, int count)
  * This function is called for each sequence of a TemporalS.
  */
 int 
-tnumberseq_minus_ranges1(TemporalSeq **result, TemporalSeq *seq, RangeType **normranges, int count)
+tnumberseq_minus_ranges1(TemporalSeq **result, TemporalSeq *seq,
+	const RangeBounds *normbounds, int count)
 {
 	/* Instantaneous sequence */
 	if (seq->count == 1)
 	{
 		TemporalInst *inst = temporalseq_inst_n(seq, 0);
-		TemporalInst *inst1 = tnumberinst_minus_ranges(inst, normranges, count);
+		TemporalInst *inst1 = tnumberinst_minus_ranges(inst, normbounds, count);
 		if (inst1 == NULL)
 			return 0;
 
@@ -2978,7 +3870,7 @@ tnumberseq_minus_ranges1(TemporalSeq **result, TemporalSeq *seq, RangeType **nor
 	 * General case
 	 * Compute first the tnumberseq_at_ranges, then compute its complement.
 	 */
-	TemporalS *ts = tnumberseq_at_ranges(seq, normranges, count);
+	TemporalS *ts = tnumberseq_at_ranges(seq, normbounds, count);
 	if (ts == NULL)
 	{
 		result[0] = temporalseq_copy(seq);
@@ -2997,7 +3889,8 @@ tnumberseq_minus_ranges1(TemporalSeq **result, TemporalSeq *seq, RangeType **nor
 }	
 
 TemporalS *
-tnumberseq_minus_ranges(TemporalSeq *seq, RangeType **normranges, int count)
+tnumberseq_minus_ranges(TemporalSeq *seq, const RangeBounds *normbounds,
+	int count)
 {
 	int maxcount;
 	if (! MOBDB_FLAGS_GET_LINEAR(seq->flags))
@@ -3005,7 +3898,7 @@ tnumberseq_minus_ranges(TemporalSeq *seq, RangeType **normranges, int count)
 	else 
 		maxcount = seq->count * count * 2;
 	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * maxcount);
-	int newcount = tnumberseq_minus_ranges1(sequences, seq, normranges, 
+	int newcount = tnumberseq_minus_ranges1(sequences, seq, normbounds, 
 		count);
 	if (newcount == 0) 
 		return NULL;
@@ -3018,6 +3911,44 @@ tnumberseq_minus_ranges(TemporalSeq *seq, RangeType **normranges, int count)
 	return result;
 }
 
+/*
+ * Periods of the exclusive bounds of a temporal number sequence at which it
+ * takes its minimum/maximum value. This function is called when the
+ * minimum/maximum is not reached elsewhere in the sequence. The periods are
+ * appended as in tnumberseq_at_value_periods.
+ */
+int
+tnumberseq_minmax_bound_periods(TemporalSeq *seq, double value,
+	Period *periods, int count)
+{
+	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
+	TemporalInst *inst2 = temporalseq_inst_n(seq, seq->count - 1);
+	if (datum_double(temporalinst_value(inst1), seq->valuetypid) == value)
+		count = periodarr_append_merge(periods, count, inst1->t, inst1->t,
+			true, true);
+	if (datum_double(temporalinst_value(inst2), seq->valuetypid) == value)
+		count = periodarr_append_merge(periods, count, inst2->t, inst2->t,
+			true, true);
+	return count;
+}
+
+/* Restriction to the minimum/maximum value of a temporal number */
+
+static TemporalS *
+tnumberseq_at_minmax(TemporalSeq *seq, Datum value)
+{
+	double dvalue = datum_double(value, seq->valuetypid);
+	Period *periods = palloc(sizeof(Period) * seq->count);
+	int count = tnumberseq_at_value_periods(seq, dvalue, periods, 0);
+	/* If minimum/maximum is at an exclusive bound */
+	if (count == 0)
+		count = tnumberseq_minmax_bound_periods(seq, dvalue, periods, 0);
+	TemporalS *result = tnumbers_from_base_periodarr(value, seq->valuetypid,
+		periods, count, MOBDB_FLAGS_GET_LINEAR(seq->flags));
+	pfree(periods);
+	return result;
+}
+
 /* Restriction to the minimum value */
 
 int
@@ -3034,21 +3965,21 @@ temporalseq_at_minmax(TemporalSeq **result, TemporalSeq *seq, Datum value)
 		if (datum_eq(value, value1, seq->valuetypid) &&
 			datum_eq(value, value2, seq->valuetypid))
 		{
-			result[0] = temporalseq_from_temporalinstarr(&inst1, 1, true, true, 
+			result[0] = temporalseq_from_temporalinstarr_trusted(&inst1, 1, true, true, 
 				MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
-			result[1] = temporalseq_from_temporalinstarr(&inst2, 1, true, true, 
+			result[1] = temporalseq_from_temporalinstarr_trusted(&inst2, 1, true, true, 
 				MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
 			count = 2;
 		}
 		else if (datum_eq(value, value1, seq->valuetypid))
 		{
-			result[0] = temporalseq_from_temporalinstarr(&inst1, 1, true, true, 
+			result[0] = temporalseq_from_temporalinstarr_trusted(&inst1, 1, true, true, 
 				MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
 			count = 1;
 		}
 		else if (datum_eq(value, value2, seq->valuetypid))
 		{
-			result[0] = temporalseq_from_temporalinstarr(&inst2, 1, true, true, 
+			result[0] = temporalseq_from_temporalinstarr_trusted(&inst2, 1, true, true, 
 				MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
 			count = 1;
 		}
@@ -3060,6 +3991,8 @@ TemporalS *
 temporalseq_at_min(TemporalSeq *seq)
 {
 	Datum xmin = temporalseq_min_value(seq);
+	if (seq->valuetypid == INT4OID || seq->valuetypid == FLOAT8OID)
+		return tnumberseq_at_minmax(seq, xmin);
 	TemporalSeq *sequences[2];
 	int count = temporalseq_at_minmax(sequences, seq, xmin);
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
@@ -3084,6 +4017,8 @@ TemporalS *
 temporalseq_at_max(TemporalSeq *seq)
 {
 	Datum xmax = temporalseq_max_value(seq);
+	if (seq->valuetypid == INT4OID || seq->valuetypid == FLOAT8OID)
+		return tnumberseq_at_minmax(seq, xmax);
 	TemporalSeq *sequences[2];
 	int count = temporalseq_at_minmax(sequences, seq, xmax);
 	TemporalS *result = temporals_from_temporalseqarr(sequences, count,
@@ -3297,14 +4232,14 @@ temporalseq_minus_timestamp1(TemporalSeq **result, TemporalSeq *seq,
 			if (linear)
 			{
 				instants[n] = inst1;
-				result[k++] = temporalseq_from_temporalinstarr(instants, n + 1, 
+				result[k++] = temporalseq_from_temporalinstarr_trusted(instants, n + 1, 
 					seq->period.lower_inc, false, MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
 			}
 			else
 			{
 				instants[n] = temporalinst_make(temporalinst_value(instants[n - 1]), t,
 					inst1->valuetypid);
-				result[k++] = temporalseq_from_temporalinstarr(instants, n + 1, 
+				result[k++] = temporalseq_from_temporalinstarr_trusted(instants, n + 1, 
 					seq->period.lower_inc, false, MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
 				pfree(instants[n]);
 			}
@@ -3316,7 +4251,7 @@ temporalseq_minus_timestamp1(TemporalSeq **result, TemporalSeq *seq,
 				temporalseq_at_timestamp1(inst1, inst2, true, t) :
 				temporalinst_make(temporalinst_value(inst1), t,
 					inst1->valuetypid);
-			result[k++] = temporalseq_from_temporalinstarr(instants, n + 2, 
+			result[k++] = temporalseq_from_temporalinstarr_trusted(instants, n + 2, 
 				seq->period.lower_inc, false, MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
 			pfree(instants[n + 1]);
 		}
@@ -3330,7 +4265,7 @@ temporalseq_minus_timestamp1(TemporalSeq **result, TemporalSeq *seq,
 			MOBDB_FLAGS_GET_LINEAR(seq->flags), t);
 		for (int i = 1; i < seq->count - n; i++)
 			instants[i] = temporalseq_inst_n(seq, i + n);
-		result[k++] = temporalseq_from_temporalinstarr(instants, seq->count - n, 
+		result[k++] = temporalseq_from_temporalinstarr_trusted(instants, seq->count - n, 
 			false, seq->period.upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
 		pfree(instants[0]);
 	}
@@ -3357,45 +4292,66 @@ temporalseq_minus_timestamp(TemporalSeq *seq, TimestampTz t)
 
 /* 
  * Restriction to a timestampset.
+ * This function is called for each sequence of a TemporalS.
+ * The instants of the sequence and the timestamps are traversed with a
+ * single forward merge: the segment containing a timestamp is searched
+ * from the segment containing the previous one.
  */
-TemporalI *
-temporalseq_at_timestampset(TemporalSeq *seq, TimestampSet *ts)
+int
+temporalseq_at_timestampset1(TemporalInst **result, TemporalSeq *seq,
+	TimestampSet *ts)
 {
 	/* Bounding box test */
 	Period *p = timestampset_bbox(ts);
 	if (!overlaps_period_period_internal(&seq->period, p))
-		return NULL;
+		return 0;
 	
 	/* Instantaneous sequence */
 	TemporalInst *inst = temporalseq_inst_n(seq, 0);
 	if (seq->count == 1)
 	{
 		if (!contains_timestampset_timestamp_internal(ts, inst->t))
-			return NULL;
-		return temporali_from_temporalinstarr(&inst, 1);
+			return 0;
+		result[0] = temporalinst_copy(inst);
+		return 1;
 	}
 
 	/* General case */
-	TimestampTz t = Max(seq->period.lower, p->lower);
-	int n;
-	timestampset_find_timestamp(ts, t, &n);
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * (ts->count - n));
-	int k = 0;
-	for (int i = n; i < ts->count; i++) 
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	int j;
+	timestampset_find_timestamp(ts, seq->period.lower, &j);
+	int n = 0, k = 0;
+	for (; j < ts->count; j++) 
 	{
-		t = timestampset_time_n(ts, i);
-		inst = temporalseq_at_timestamp(seq, t);
-		if (inst != NULL)
-			instants[k++] = inst;
+		TimestampTz t = timestampset_time_n(ts, j);
+		if (!contains_period_timestamp_internal(&seq->period, t))
+		{
+			if (timestamp_cmp_internal(t, seq->period.upper) >= 0)
+				break;
+			continue;
+		}
+		while (n < seq->count - 2 &&
+			timestamp_cmp_internal(temporalseq_inst_n(seq, n + 1)->t, t) <= 0)
+			n++;
+		result[k++] = temporalseq_at_timestamp1(temporalseq_inst_n(seq, n),
+			temporalseq_inst_n(seq, n + 1), linear, t);
 	}
-	if (k == 0)
+	return k;
+}
+
+TemporalI *
+temporalseq_at_timestampset(TemporalSeq *seq, TimestampSet *ts)
+{
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * ts->count);
+	int count = temporalseq_at_timestampset1(instants, seq, ts);
+	if (count == 0)
 	{
 		pfree(instants);
 		return NULL;
 	}
 
-	TemporalI *result = temporali_from_temporalinstarr(instants, k);
-	for (int i = 0; i < k; i++)
+	TemporalI *result = temporali_from_temporalinstarr(instants, count);
+	for (int i = 0; i < count; i++)
 		pfree(instants[i]);
 	pfree(instants);
 	return result;
@@ -3428,22 +4384,16 @@ temporalseq_minus_timestampset1(TemporalSeq **result, TemporalSeq *seq,
 		return 1;
 	}
 
-	/* General case */
-	TemporalSeq *tail = temporalseq_copy(seq);
-	int k = 0;
-	for (int i = 0; i < ts->count; i++)
-	{
-		TimestampTz t = timestampset_time_n(ts, i);
-		if (contains_period_timestamp_internal(&tail->period, t))
-		{
-			int count = temporalseq_minus_timestamp1(&result[k], tail, t);
-			/* result may contain one or two sequences */
-			k += count - 1;
-			pfree(tail);
-			tail = result[k];
-		}
-	}
-	result[k++] = tail;
+	/*
+	 * General case
+	 * Restrict the sequence in a single pass to the periods between the
+	 * timestamps instead of splitting a copy of the sequence at each one.
+	 */
+	PeriodSet *ps = minus_period_timestampset_internal(&seq->period, ts);
+	if (ps == NULL)
+		return 0;
+	int k = temporalseq_at_periodset1(result, seq, ps);
+	pfree(ps);
 	return k;
 }
 
@@ -3466,76 +4416,109 @@ temporalseq_minus_timestampset(TemporalSeq *seq, TimestampSet *ts)
 }
 
 /*
- * Restriction to a period.
+ * Instants of the restriction to a period contained in the period of the
+ * sequence. The first and the last instants are allocated, the other ones
+ * are those of the sequence.
+ * The segment containing the lower bound of the period is at position n or
+ * after it. On exit n is the position of the segment containing the upper
+ * bound of the period, so that the restriction to an ordered list of
+ * periods traverses the sequence only once.
  */
-TemporalSeq *
-temporalseq_at_period(TemporalSeq *seq, Period *p)
+TemporalInst **
+temporalseq_at_period_instants(TemporalSeq *seq, const Period *inter, int *n,
+	int *count)
 {
-	/* Bounding box test */
-	if (!overlaps_period_period_internal(&seq->period, p))
-		return NULL;
-
-	/* Instantaneous sequence */
-	if (seq->count == 1)
-		return temporalseq_copy(seq);
-
-	/* General case */
-	Period *inter = intersection_period_period_internal(&seq->period, p);
+	bool linear = MOBDB_FLAGS_GET_LINEAR(seq->flags);
+	while (*n < seq->count - 2 &&
+		timestamp_cmp_internal(temporalseq_inst_n(seq, *n + 1)->t, 
+			inter->lower) <= 0)
+		(*n)++;
+	TemporalInst *inst1 = temporalseq_inst_n(seq, *n);
+	TemporalInst *inst2 = temporalseq_inst_n(seq, *n + 1);
 	/* Intersecting period is instantaneous */
 	if (timestamp_cmp_internal(inter->lower, inter->upper) == 0)
 	{
-		TemporalInst *inst = temporalseq_at_timestamp(seq, inter->lower);
-		TemporalSeq *result = temporalseq_from_temporalinstarr(&inst, 1,
-			true, true, MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
-		pfree(inst); pfree(inter);
-		return result;		
+		TemporalInst **instants = palloc(sizeof(TemporalInst *));
+		instants[0] = temporalseq_at_timestamp1(inst1, inst2, linear,
+			inter->lower);
+		*count = 1;
+		return instants;
 	}
-	
-	int n = temporalseq_find_timestamp(seq, inter->lower);
-	/* If the lower bound of the intersecting period is exclusive */
-	if (n == -1)
-		n = 0;
-	TemporalInst **instants = palloc(sizeof(TemporalInst *) * (seq->count - n));
+
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * 
+		(seq->count - *n + 1));
 	/* Compute the value at the beginning of the intersecting period */
-	TemporalInst *inst1 = temporalseq_inst_n(seq, n);
-	TemporalInst *inst2 = temporalseq_inst_n(seq, n + 1);
-	instants[0] = temporalseq_at_timestamp1(inst1, inst2, 
-		MOBDB_FLAGS_GET_LINEAR(seq->flags), inter->lower);
+	instants[0] = temporalseq_at_timestamp1(inst1, inst2, linear, 
+		inter->lower);
 	int k = 1;
-	for (int i = n+2; i < seq->count; i++)
+	/* Add the instants strictly inside the intersecting period */
+	while (*n < seq->count - 2 &&
+		timestamp_cmp_internal(inst2->t, inter->upper) < 0)
 	{
-		/* If the end of the intersecting period is between inst1 and inst2 */
-		if (timestamp_cmp_internal(inst1->t, inter->upper) <= 0 &&
-			timestamp_cmp_internal(inter->upper, inst2->t) <= 0)
-			break;
-
+		instants[k++] = inst2;
+		(*n)++;
 		inst1 = inst2;
-		inst2 = temporalseq_inst_n(seq, i);
-		/* If the intersecting period contains inst1 */
-		if (timestamp_cmp_internal(inter->lower, inst1->t) <= 0 &&
-			timestamp_cmp_internal(inst1->t, inter->upper) <= 0)
-			instants[k++] = inst1;
+		inst2 = temporalseq_inst_n(seq, *n + 1);
 	}
 	/* The last two values of sequences with stepwise interpolation and 
 	   exclusive upper bound must be equal */
-	if (MOBDB_FLAGS_GET_LINEAR(seq->flags) || inter->upper_inc)
-		instants[k++] = temporalseq_at_timestamp1(inst1, inst2, 
-			MOBDB_FLAGS_GET_LINEAR(seq->flags), inter->upper);
+	if (linear || inter->upper_inc)
+		instants[k++] = temporalseq_at_timestamp1(inst1, inst2, linear,
+			inter->upper);
 	else
 	{	
 		Datum value = temporalinst_value(instants[k - 1]);
 		instants[k++] = temporalinst_make(value, inter->upper, seq->valuetypid);
 	}
+	*count = k;
+	return instants;
+}
+
+/*
+ * Restriction to a period contained in the period of the sequence, where n
+ * is as in temporalseq_at_period_instants
+ */
+static TemporalSeq *
+temporalseq_at_period1(TemporalSeq *seq, const Period *inter, int *n)
+{
+	int count;
+	TemporalInst **instants = temporalseq_at_period_instants(seq, inter, n,
+		&count);
 	/* Since by definition the sequence is normalized it is not necessary to
 	   normalize the projection of the sequence to the period */
-	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, k,
-		inter->lower_inc, inter->upper_inc, MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
-
-	pfree(instants[0]); pfree(instants[k - 1]); pfree(instants); pfree(inter);
-	
+	TemporalSeq *result = temporalseq_from_temporalinstarr_trusted(instants,
+		count, inter->lower_inc, inter->upper_inc,
+		MOBDB_FLAGS_GET_LINEAR(seq->flags), false);
+	pfree(instants[0]);
+	if (count > 1)
+		pfree(instants[count - 1]);
+	pfree(instants);
 	return result;
 }
 
+/*
+ * Restriction to a period.
+ */
+TemporalSeq *
+temporalseq_at_period(TemporalSeq *seq, Period *p)
+{
+	/* Bounding box test */
+	Period inter;
+	if (!intersection_period_period_internal1(&inter, &seq->period, p))
+		return NULL;
+
+	/* Instantaneous sequence */
+	if (seq->count == 1)
+		return temporalseq_copy(seq);
+
+	/* General case */
+	int n = temporalseq_find_timestamp(seq, inter.lower);
+	/* If the lower bound of the intersecting period is exclusive */
+	if (n == -1)
+		n = 0;
+	return temporalseq_at_period1(seq, &inter, &n);
+}
+
 /*
  * Restriction to the complement of a period.
  */
@@ -3604,15 +4587,16 @@ temporalseq_at_periodset1(TemporalSeq **result, TemporalSeq *seq, PeriodSet *ps)
 	}
 
 	/* General case */
-	int n;
-	periodset_find_timestamp(ps, seq->period.lower, &n);
-	int k = 0;
-	for (int i = n; i < ps->count; i++)
-	{
-		p = periodset_per_n(ps, i);
-		TemporalSeq *seq1 = temporalseq_at_period(seq, p);
-		if (seq1 != NULL)
-			result[k++] = seq1;
+	int j;
+	periodset_find_timestamp(ps, seq->period.lower, &j);
+	/* Position of the segment reached by the merge */
+	int n = 0, k = 0;
+	for (; j < ps->count; j++)
+	{
+		p = periodset_per_n(ps, j);
+		Period inter;
+		if (intersection_period_period_internal1(&inter, &seq->period, p))
+			result[k++] = temporalseq_at_period1(seq, &inter, &n);
 		if (timestamp_cmp_internal(seq->period.upper, p->upper) < 0)
 			break;
 	}
@@ -3779,15 +4763,12 @@ temporalseq_intersects_periodset(TemporalSeq *seq, PeriodSet *ps)
 double
 tstepwseq_integral(TemporalSeq *seq)
 {
+	TimestampTz *times = temporalseq_timestamps1(seq);
+	double *values = tnumberseq_values_double(seq);
 	double result = 0;
-	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
 	for (int i = 1; i < seq->count; i++)
-	{
-		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
-		result += datum_double(temporalinst_value(inst1), inst1->valuetypid) *
-			(double) (inst2->t - inst1->t);
-		inst1 = inst2;
-	}
+		result += values[i - 1] * (double) (times[i] - times[i - 1]);
+	pfree(times); pfree(values);
 	return result;
 }
 
@@ -3796,24 +4777,22 @@ tstepwseq_integral(TemporalSeq *seq)
 double
 tlinearseq_integral(TemporalSeq *seq)
 {
+	TimestampTz *times = temporalseq_timestamps1(seq);
+	double *values = tnumberseq_values_double(seq);
 	double result = 0;
-	TemporalInst *inst1 = temporalseq_inst_n(seq, 0);
 	for (int i = 1; i < seq->count; i++)
-	{
-		TemporalInst *inst2 = temporalseq_inst_n(seq, i);
-		double min = Min(DatumGetFloat8(temporalinst_value(inst1)), 
-			DatumGetFloat8(temporalinst_value(inst2)));
-		double max = Max(DatumGetFloat8(temporalinst_value(inst1)), 
-			DatumGetFloat8(temporalinst_value(inst2)));
-		result += (max + min) * (double) (inst2->t - inst1->t) / 2.0;
-		inst1 = inst2;
-	}
+		result += (values[i - 1] + values[i]) * 
+			(double) (times[i] - times[i - 1]) / 2.0;
+	pfree(times); pfree(values);
 	return result;
 }
 
 double
 tnumberseq_integral(TemporalSeq *seq)
 {
+	TemporalSeqSummary *summary = temporalseq_summary_ptr(seq);
+	if (summary != NULL)
+		return summary->integral;
 	if (MOBDB_FLAGS_GET_LINEAR(seq->flags))
 		return tlinearseq_integral(seq);
 	else
@@ -3841,6 +4820,16 @@ tnumberseq_twavg(TemporalSeq *seq)
  * The functions assume that the arguments are of the same temptypid
  *****************************************************************************/
 
+/* Flags of a sequence that are compared, the summary is not part of the value */
+
+static int16
+temporalseq_cmp_flags(TemporalSeq *seq)
+{
+	int16 result = seq->flags;
+	MOBDB_FLAGS_SET_SUMMARY(result, false);
+	return result;
+}
+
 /* 
  * Equality operator
  * The internal B-tree comparator is not used to increase efficiency
@@ -3849,7 +4838,8 @@ bool
 temporalseq_eq(TemporalSeq *seq1, TemporalSeq *seq2)
 {
 	/* If number of sequences, flags, or periods are not equal */
-	if (seq1->count != seq2->count || seq1->flags != seq2->flags ||
+	if (seq1->count != seq2->count ||
+			temporalseq_cmp_flags(seq1) != temporalseq_cmp_flags(seq2) ||
 			! period_eq_internal(&seq1->period, &seq2->period)) 
 		return false;
 
@@ -3899,9 +4889,9 @@ temporalseq_cmp(TemporalSeq *seq1, TemporalSeq *seq2)
 	else if (seq2->count < seq1->count) /* seq2 has less instants than seq1 */
 		return 1;
 	/* Compare flags */
-	if (seq1->flags < seq2->flags)
+	if (temporalseq_cmp_flags(seq1) < temporalseq_cmp_flags(seq2))
 		return -1;
-	if (seq1->flags > seq2->flags)
+	if (temporalseq_cmp_flags(seq1) > temporalseq_cmp_flags(seq2))
 		return 1;
 	/* The two values are equal */
 	return 0;
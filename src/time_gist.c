@@ -14,6 +14,7 @@
 #include "time_gist.h"
 
 #include <access/gist.h>
+#include <utils/builtins.h>
 #include <utils/timestamp.h>
 
 #include "timetypes.h"
@@ -23,6 +24,7 @@
 #include "timeops.h"
 #include "temporal.h"
 #include "oidcache.h"
+#include "temporal_stats.h"
 
 /*****************************************************************************/
 
@@ -659,6 +661,8 @@ gist_period_consistent(PG_FUNCTION_ARGS)
 	else
 		result = index_internal_consistent_period(key, period, strategy);
 
+	MOBDB_STAT_INDEX(STAT_GIST_PERIOD, strategy, GIST_LEAF(entry), result,
+		*recheck);
 	PG_RETURN_BOOL(result);
 	
 }
@@ -855,4 +859,371 @@ gist_period_fetch(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(entry);
 }
 
-/*****************************************************************************/
\ No newline at end of file
+/*****************************************************************************
+ * Distance method for time types
+ *****************************************************************************/
+
+/*
+ * The GiST distance method for the distance operator <-> between a time type
+ * or a temporal type and a timestamp. The distances of the leaf keys are
+ * lower bounds since the keys are the bounding periods of the values, and
+ * must be rechecked.
+ */
+PG_FUNCTION_INFO_V1(gist_period_distance);
+
+PGDLLEXPORT Datum
+gist_period_distance(PG_FUNCTION_ARGS)
+{
+	GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+	bool *recheck = (bool *) PG_GETARG_POINTER(4);
+	Period *key = DatumGetPeriod(entry->key);
+
+	if (GIST_LEAF(entry))
+		*recheck = true;
+
+	if (key == NULL)
+		PG_RETURN_FLOAT8(get_float8_infinity());
+
+	PG_RETURN_FLOAT8(period_timestamp_distance_internal(key, t));
+}
+
+/*****************************************************************************
+ * Multi-period keys for period sets
+ *
+ * The bounding period of a period set with large gaps between its periods
+ * overlaps every query falling in these gaps. The operator class
+ * gist_periodset_multi_ops below indexes instead each period set by a key
+ * that is a period set with at most gist_max_periods periods, obtained by
+ * merging the periods separated by the smallest gaps. The keys of the
+ * internal pages are built in the same way from the keys of their children.
+ * Since every key covers the values below it, the operators that are not
+ * based on the bounding period are tested against all the periods of the
+ * keys, the other ones are tested against the bounding period of the keys.
+ *****************************************************************************/
+
+/**
+ * @brief Value of the mobilitydb.gist_max_periods parameter which states the
+ *		maximum number of periods of the keys of the multi-period GiST indexes.
+ *		Changing it only affects the keys built afterwards.
+ */
+int gist_max_periods = 8;
+
+/* Gap between two consecutive periods of a key */
+
+typedef struct
+{
+	double gap;			/* Duration of the gap in seconds */
+	int i;				/* Index of the period before the gap */
+} PeriodGap;
+
+static int
+period_gap_cmp(const void *a, const void *b)
+{
+	const PeriodGap *g1 = (const PeriodGap *) a;
+	const PeriodGap *g2 = (const PeriodGap *) b;
+	if (g1->gap != g2->gap)
+		return (g1->gap < g2->gap) ? -1 : 1;
+	return (g1->i < g2->i) ? -1 : ((g1->i > g2->i) ? 1 : 0);
+}
+
+/*
+ * Build a key from an array of ordered and disjoint periods, merging the
+ * periods separated by the smallest gaps until there are at most
+ * gist_max_periods periods
+ */
+static PeriodSet *
+multiperiod_make(const Period *periods, int count)
+{
+	if (count <= gist_max_periods)
+		return periodset_from_periods_internal(periods, count);
+
+	PeriodGap *gaps = palloc(sizeof(PeriodGap) * (count - 1));
+	for (int i = 0; i < count - 1; i++)
+	{
+		gaps[i].gap = period_to_secs(periods[i + 1].lower, periods[i].upper);
+		gaps[i].i = i;
+	}
+	qsort(gaps, count - 1, sizeof(PeriodGap), period_gap_cmp);
+	/* merged[i] states whether periods i and i + 1 are merged */
+	bool *merged = palloc0(sizeof(bool) * count);
+	for (int i = 0; i < count - gist_max_periods; i++)
+		merged[gaps[i].i] = true;
+
+	Period *newperiods = palloc(sizeof(Period) * gist_max_periods);
+	int k = 0;
+	int start = 0;
+	for (int i = 0; i < count; i++)
+	{
+		if (merged[i])
+			continue;
+		period_set(&newperiods[k++], periods[start].lower, periods[i].upper,
+			periods[start].lower_inc, periods[i].upper_inc);
+		start = i + 1;
+	}
+	PeriodSet *result = periodset_from_periods_internal(newperiods, k);
+	pfree(gaps); pfree(merged); pfree(newperiods);
+	return result;
+}
+
+/*
+ * Build the key covering the keys of the array
+ */
+static PeriodSet *
+multiperiod_union(PeriodSet **keys, int count)
+{
+	int totalcount = 0;
+	for (int i = 0; i < count; i++)
+		totalcount += keys[i]->count;
+	Period **periods = palloc(sizeof(Period *) * totalcount);
+	int k = 0;
+	for (int i = 0; i < count; i++)
+		for (int j = 0; j < keys[i]->count; j++)
+			periods[k++] = periodset_per_n(keys[i], j);
+	int newcount;
+	Period **normperiods = periodarr_normalize(periods, totalcount, &newcount);
+	Period *newperiods = palloc(sizeof(Period) * newcount);
+	for (int i = 0; i < newcount; i++)
+	{
+		newperiods[i] = *normperiods[i];
+		pfree(normperiods[i]);
+	}
+	PeriodSet *result = multiperiod_make(newperiods, newcount);
+	pfree(periods); pfree(normperiods); pfree(newperiods);
+	return result;
+}
+
+/*
+ * Duration in seconds covered by the periods of a key
+ */
+static double
+multiperiod_secs(PeriodSet *key)
+{
+	double result = 0.0;
+	for (int i = 0; i < key->count; i++)
+	{
+		Period *p = periodset_per_n(key, i);
+		result += period_to_secs(p->upper, p->lower);
+	}
+	return result;
+}
+
+/*
+ * Consistent method for period sets using multi-period keys
+ */
+PG_FUNCTION_INFO_V1(gist_periodset_multi_consistent);
+
+PGDLLEXPORT Datum
+gist_periodset_multi_consistent(PG_FUNCTION_ARGS)
+{
+	GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+	Oid 		subtype = PG_GETARG_OID(3);
+	bool	   *recheck = (bool *) PG_GETARG_POINTER(4),
+				result;
+	PeriodSet  *key = DatumGetPeriodSet(entry->key);
+	Period	   *bbox = periodset_bbox(key),
+				period;
+	/* These operators are tested against all the periods of the key */
+	bool		multi = (strategy == RTOverlapStrategyNumber ||
+					strategy == RTContainsStrategyNumber);
+
+	if (subtype == TIMESTAMPTZOID)
+	{
+		TimestampTz query = PG_GETARG_TIMESTAMPTZ(1);
+		if (multi)
+			result = contains_periodset_timestamp_internal(key, query);
+		period_set(&period, query, query, true, true);
+	}
+	else if (subtype == type_oid(T_TIMESTAMPSET))
+	{
+		TimestampSet *query = PG_GETARG_TIMESTAMPSET(1);
+		if (strategy == RTOverlapStrategyNumber)
+			result = overlaps_timestampset_periodset_internal(query, key);
+		else if (strategy == RTContainsStrategyNumber)
+			result = contains_periodset_timestampset_internal(key, query);
+		period = *timestampset_bbox(query);
+		PG_FREE_IF_COPY(query, 1);
+	}
+	else if (subtype == type_oid(T_PERIOD))
+	{
+		Period *query = PG_GETARG_PERIOD(1);
+		if (strategy == RTOverlapStrategyNumber)
+			result = overlaps_period_periodset_internal(query, key);
+		else if (strategy == RTContainsStrategyNumber)
+			result = contains_periodset_period_internal(key, query);
+		period = *query;
+	}
+	else if (subtype == type_oid(T_PERIODSET))
+	{
+		PeriodSet *query = PG_GETARG_PERIODSET(1);
+		if (strategy == RTOverlapStrategyNumber)
+			result = overlaps_periodset_periodset_internal(key, query);
+		else if (strategy == RTContainsStrategyNumber)
+			result = contains_periodset_periodset_internal(key, query);
+		period = *periodset_bbox(query);
+		PG_FREE_IF_COPY(query, 1);
+	}
+	else
+		elog(ERROR, "unrecognized subtype: %u", subtype);
+
+	/* The keys with merged gaps are lossy for the operators above, the
+	 * bounding period of a key is the one of the values below it */
+	if (multi)
+		*recheck = true;
+	else if (GIST_LEAF(entry))
+	{
+		*recheck = index_period_bbox_recheck(strategy);
+		result = index_leaf_consistent_time(bbox, &period, strategy);
+	}
+	else
+	{
+		*recheck = index_period_bbox_recheck(strategy);
+		result = index_internal_consistent_period(bbox, &period, strategy);
+	}
+
+	MOBDB_STAT_INDEX(STAT_GIST_PERIOD, strategy, GIST_LEAF(entry), result,
+		*recheck);
+	PG_RETURN_BOOL(result);
+}
+
+/*
+ * Union method for period sets using multi-period keys
+ */
+PG_FUNCTION_INFO_V1(gist_periodset_multi_union);
+
+PGDLLEXPORT Datum
+gist_periodset_multi_union(PG_FUNCTION_ARGS)
+{
+	GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+	PeriodSet **keys = palloc(sizeof(PeriodSet *) * entryvec->n);
+	for (int i = 0; i < entryvec->n; i++)
+		keys[i] = DatumGetPeriodSet(entryvec->vector[i].key);
+	PeriodSet *result = multiperiod_union(keys, entryvec->n);
+	pfree(keys);
+	PG_RETURN_POINTER(result);
+}
+
+/*
+ * GiST compress method for period sets using multi-period keys
+ */
+PG_FUNCTION_INFO_V1(gist_periodset_multi_compress);
+
+PGDLLEXPORT Datum
+gist_periodset_multi_compress(PG_FUNCTION_ARGS)
+{
+	GISTENTRY  *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+
+	if (entry->leafkey)
+	{
+		GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+		PeriodSet *ps = DatumGetPeriodSet(entry->key);
+		PeriodSet *key = multiperiod_make(periodset_per_n(ps, 0), ps->count);
+		gistentryinit(*retval, PointerGetDatum(key),
+			entry->rel, entry->page, entry->offset, false);
+		PG_RETURN_POINTER(retval);
+	}
+
+	PG_RETURN_POINTER(entry);
+}
+
+/*
+ * GiST penalty method for period sets using multi-period keys, which is the
+ * duration in seconds that the original key must be extended with
+ */
+PG_FUNCTION_INFO_V1(gist_periodset_multi_penalty);
+
+PGDLLEXPORT Datum
+gist_periodset_multi_penalty(PG_FUNCTION_ARGS)
+{
+	GISTENTRY  *origentry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	GISTENTRY  *newentry = (GISTENTRY *) PG_GETARG_POINTER(1);
+	float	   *penalty = (float *) PG_GETARG_POINTER(2);
+	PeriodSet  *keys[2];
+
+	keys[0] = DatumGetPeriodSet(origentry->key);
+	keys[1] = DatumGetPeriodSet(newentry->key);
+	PeriodSet *unionkey = multiperiod_union(keys, 2);
+	*penalty = (float4) (multiperiod_secs(unionkey) - multiperiod_secs(keys[0]));
+	pfree(unionkey);
+
+	PG_RETURN_POINTER(penalty);
+}
+
+/*
+ * GiST picksplit method for period sets using multi-period keys. The entries
+ * are distributed with the double sorting split of their bounding periods.
+ */
+PG_FUNCTION_INFO_V1(gist_periodset_multi_picksplit);
+
+PGDLLEXPORT Datum
+gist_periodset_multi_picksplit(PG_FUNCTION_ARGS)
+{
+	GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+	GIST_SPLITVEC *v = (GIST_SPLITVEC *) PG_GETARG_POINTER(1);
+	OffsetNumber maxoff = (OffsetNumber) (entryvec->n - 1);
+	size_t nbytes = (maxoff + 1) * sizeof(OffsetNumber);
+	v->spl_left = (OffsetNumber *) palloc(nbytes);
+	v->spl_right = (OffsetNumber *) palloc(nbytes);
+
+	GistEntryVector *bboxvec = palloc(GEVHDRSZ +
+		sizeof(GISTENTRY) * entryvec->n);
+	bboxvec->n = entryvec->n;
+	for (OffsetNumber i = FirstOffsetNumber; i <= maxoff; i = OffsetNumberNext(i))
+	{
+		GISTENTRY *ent = &entryvec->vector[i];
+		gistentryinit(bboxvec->vector[i],
+			PointerGetDatum(periodset_bbox(DatumGetPeriodSet(ent->key))),
+			ent->rel, ent->page, ent->offset, false);
+	}
+	gist_period_double_sorting_split(bboxvec, v);
+
+	/* Replace the bounding periods of the groups by multi-period keys */
+	PeriodSet **keys = palloc(sizeof(PeriodSet *) * maxoff);
+	for (int i = 0; i < v->spl_nleft; i++)
+		keys[i] = DatumGetPeriodSet(entryvec->vector[v->spl_left[i]].key);
+	v->spl_ldatum = PointerGetDatum(multiperiod_union(keys, v->spl_nleft));
+	for (int i = 0; i < v->spl_nright; i++)
+		keys[i] = DatumGetPeriodSet(entryvec->vector[v->spl_right[i]].key);
+	v->spl_rdatum = PointerGetDatum(multiperiod_union(keys, v->spl_nright));
+	pfree(keys); pfree(bboxvec);
+
+	PG_RETURN_POINTER(v);
+}
+
+/*
+ * Equality comparator for period sets using multi-period keys
+ */
+PG_FUNCTION_INFO_V1(gist_periodset_multi_same);
+
+PGDLLEXPORT Datum
+gist_periodset_multi_same(PG_FUNCTION_ARGS)
+{
+	PeriodSet *ps1 = PG_GETARG_PERIODSET(0);
+	PeriodSet *ps2 = PG_GETARG_PERIODSET(1);
+	bool	   *result = (bool *) PG_GETARG_POINTER(2);
+	*result = periodset_eq_internal(ps1, ps2);
+	PG_RETURN_POINTER(result);
+}
+
+/*
+ * Distance method for period sets using multi-period keys. The distances
+ * of the keys are lower bounds of the distances of the values below them.
+ */
+PG_FUNCTION_INFO_V1(gist_periodset_multi_distance);
+
+PGDLLEXPORT Datum
+gist_periodset_multi_distance(PG_FUNCTION_ARGS)
+{
+	GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+	bool *recheck = (bool *) PG_GETARG_POINTER(4);
+	PeriodSet *key = DatumGetPeriodSet(entry->key);
+
+	if (GIST_LEAF(entry))
+		*recheck = true;
+
+	PG_RETURN_FLOAT8(periodset_timestamp_distance_internal(key, t));
+}
+
+/*****************************************************************************/
@@ -20,6 +20,7 @@
 #include <access/htup_details.h>
 #include <utils/lsyscache.h>
 #include <catalog/pg_statistic.h>
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
 
 #include "timestampset.h"
@@ -71,7 +72,8 @@ get_time_cachedop(Oid operator, CachedOp *cachedOp)
 }
 
 static double
-calc_periodsel(VariableStatData *vardata, Period *constval, Oid operator)
+calc_periodsel(VariableStatData *vardata, Period *constval, PeriodSet *constps,
+	Oid operator)
 {
 	double		hist_selec;
 	double		selec;
@@ -113,7 +115,10 @@ calc_periodsel(VariableStatData *vardata, Period *constval, Oid operator)
 	 * returning the default estimate, because this still takes into
 	 * account the fraction of NULL tuples, if we had statistics for them.
 	 */
-	hist_selec = calc_period_hist_selectivity(vardata, constval, cachedOp);
+	if (constps != NULL)
+		hist_selec = calc_periodset_hist_selectivity(vardata, constps, cachedOp);
+	else
+		hist_selec = calc_period_hist_selectivity(vardata, constval, cachedOp);
 	if (hist_selec < 0.0)
 		hist_selec = default_period_selectivity(operator);
 
@@ -128,6 +133,186 @@ calc_periodsel(VariableStatData *vardata, Period *constval, Oid operator)
 	return selec;
 }
 
+/*****************************************************************************
+ * Cache of the histograms of period bounds and lengths
+ *
+ * The planner estimates the selectivity of every restriction clause of a
+ * query and the same column is typically restricted by many clauses. To
+ * avoid fetching the statistics slots and deserializing the periods of the
+ * histogram for each clause, the decoded histograms of the most recently
+ * used columns are kept in a memory context that is a child of the one used
+ * for planning, and thus are freed at the end of the planning cycle. The
+ * entries are identified by the statistics tuple, including its transaction
+ * id, so that an entry is never used after the statistics are updated.
+ *****************************************************************************/
+
+#define PERIOD_HIST_CACHE_SIZE	8
+
+typedef struct
+{
+	Oid			relid;			/* Relation of the statistics tuple */
+	AttrNumber	attnum;			/* Attribute of the statistics tuple */
+	bool		inherit;		/* Statistics include child tables */
+	ItemPointerData tid;		/* Location of the statistics tuple */
+	TransactionId xmin;			/* Transaction that created the tuple */
+	int			nhist;			/* Number of values of the bounds histograms */
+	PeriodBound *hist_lower;	/* Histogram of lower bounds */
+	PeriodBound *hist_upper;	/* Histogram of upper bounds */
+	bool		length_loaded;	/* The length histogram has been looked up */
+	int			nlength;		/* Number of values of the length histogram */
+	Datum	   *length;			/* Histogram of lengths */
+} PeriodHistCacheEntry;
+
+typedef struct
+{
+	MemoryContext cxt;
+	MemoryContextCallback callback;
+	int			next;			/* Next entry to be replaced */
+	int			count;
+	PeriodHistCacheEntry entries[PERIOD_HIST_CACHE_SIZE];
+} PeriodHistCache;
+
+static PeriodHistCache *period_hist_cache = NULL;
+
+/* Forget the cache when its memory context is deleted */
+static void
+period_hist_cache_reset(void *arg)
+{
+	period_hist_cache = NULL;
+}
+
+static PeriodHistCache *
+period_hist_cache_get(void)
+{
+	if (period_hist_cache == NULL)
+	{
+		MemoryContext cxt = AllocSetContextCreate(CurrentMemoryContext,
+			"Period histogram cache", ALLOCSET_SMALL_SIZES);
+		PeriodHistCache *cache = MemoryContextAllocZero(cxt,
+			sizeof(PeriodHistCache));
+		cache->cxt = cxt;
+		cache->callback.func = period_hist_cache_reset;
+		cache->callback.arg = NULL;
+		MemoryContextRegisterResetCallback(cxt, &cache->callback);
+		period_hist_cache = cache;
+	}
+	return period_hist_cache;
+}
+
+static bool
+period_hist_cache_match(PeriodHistCacheEntry *entry, HeapTuple statsTuple)
+{
+	Form_pg_statistic stats = (Form_pg_statistic) GETSTRUCT(statsTuple);
+	return entry->relid == stats->starelid &&
+		entry->attnum == stats->staattnum &&
+		entry->inherit == stats->stainherit &&
+		ItemPointerEquals(&entry->tid, &statsTuple->t_self) &&
+		entry->xmin == HeapTupleHeaderGetXmin(statsTuple->t_data);
+}
+
+/*
+ * Get the histograms of period bounds of a column, and of period lengths if
+ * length is true. Returns NULL if the column has no histogram of period
+ * bounds. When the length histogram is requested but the column has none,
+ * the field nlength of the result is 0.
+ */
+static PeriodHistCacheEntry *
+period_hist_lookup(VariableStatData *vardata, bool length)
+{
+	HeapTuple statsTuple = vardata->statsTuple;
+	PeriodHistCacheEntry *entry = NULL;
+	AttStatsSlot hslot;
+
+	if (!HeapTupleIsValid(statsTuple))
+		return NULL;
+
+	/* Tuples built by a statistics hook have no location and are not cached */
+	bool cacheable = ItemPointerIsValid(&statsTuple->t_self);
+	PeriodHistCache *cache = NULL;
+	if (cacheable)
+	{
+		cache = period_hist_cache_get();
+		for (int i = 0; i < cache->count; i++)
+		{
+			if (period_hist_cache_match(&cache->entries[i], statsTuple))
+			{
+				entry = &cache->entries[i];
+				break;
+			}
+		}
+	}
+
+	if (entry == NULL)
+	{
+		if (!get_attstatsslot(&hslot, statsTuple,
+				STATISTIC_KIND_PERIOD_BOUNDS_HISTOGRAM, InvalidOid,
+				ATTSTATSSLOT_VALUES))
+			return NULL;
+
+		MemoryContext oldcxt = NULL;
+		if (cacheable)
+		{
+			entry = &cache->entries[cache->next];
+			if (cache->next < cache->count)
+			{
+				/* Replace the least recently created entry */
+				pfree(entry->hist_lower);
+				pfree(entry->hist_upper);
+				if (entry->length != NULL)
+					pfree(entry->length);
+			}
+			else
+				cache->count++;
+			cache->next = (cache->next + 1) % PERIOD_HIST_CACHE_SIZE;
+			oldcxt = MemoryContextSwitchTo(cache->cxt);
+		}
+		else
+			entry = palloc(sizeof(PeriodHistCacheEntry));
+
+		Form_pg_statistic stats = (Form_pg_statistic) GETSTRUCT(statsTuple);
+		entry->relid = stats->starelid;
+		entry->attnum = stats->staattnum;
+		entry->inherit = stats->stainherit;
+		entry->tid = statsTuple->t_self;
+		entry->xmin = HeapTupleHeaderGetXmin(statsTuple->t_data);
+		entry->nhist = hslot.nvalues;
+		entry->hist_lower = palloc(sizeof(PeriodBound) * hslot.nvalues);
+		entry->hist_upper = palloc(sizeof(PeriodBound) * hslot.nvalues);
+		for (int i = 0; i < hslot.nvalues; i++)
+			period_deserialize(DatumGetPeriod(hslot.values[i]),
+				&entry->hist_lower[i], &entry->hist_upper[i]);
+		entry->length_loaded = false;
+		entry->nlength = 0;
+		entry->length = NULL;
+		if (cacheable)
+			MemoryContextSwitchTo(oldcxt);
+		free_attstatsslot(&hslot);
+	}
+
+	if (length && !entry->length_loaded)
+	{
+		AttStatsSlot lslot;
+		if (get_attstatsslot(&lslot, statsTuple,
+				STATISTIC_KIND_PERIOD_LENGTH_HISTOGRAM, InvalidOid,
+				ATTSTATSSLOT_VALUES))
+		{
+			MemoryContext oldcxt = cacheable ?
+				MemoryContextSwitchTo(cache->cxt) : NULL;
+			entry->nlength = lslot.nvalues;
+			entry->length = palloc(sizeof(Datum) * lslot.nvalues);
+			for (int i = 0; i < lslot.nvalues; i++)
+				entry->length[i] = Float8GetDatum(DatumGetFloat8(lslot.values[i]));
+			if (cacheable)
+				MemoryContextSwitchTo(oldcxt);
+			free_attstatsslot(&lslot);
+		}
+		entry->length_loaded = true;
+	}
+	return entry;
+}
+
+/*****************************************************************************/
+
 /*
  * Calculate period operator selectivity using histograms of period bounds.
  *
@@ -137,50 +322,23 @@ double
 calc_period_hist_selectivity(VariableStatData *vardata, Period *constval,
 	CachedOp cachedOp)
 {
-	AttStatsSlot hslot, lslot;
+	PeriodHistCacheEntry *hist;
 	PeriodBound *hist_lower, *hist_upper;
 	PeriodBound	const_lower, const_upper;
 	double		hist_selec;
-	int			nhist, i;
-
-	if (!(HeapTupleIsValid(vardata->statsTuple) &&
-		  get_attstatsslot(&hslot, vardata->statsTuple,
-						   STATISTIC_KIND_PERIOD_BOUNDS_HISTOGRAM, 
-						   InvalidOid, ATTSTATSSLOT_VALUES)))
-		return -1.0;
-	/*
-	 * Convert histogram of periods into histograms of its lower and upper
-	 * bounds.
-	 */
-	nhist = hslot.nvalues;
-	hist_lower = (PeriodBound *) palloc(sizeof(PeriodBound) * nhist);
-	hist_upper = (PeriodBound *) palloc(sizeof(PeriodBound) * nhist);
-	for (i = 0; i < nhist; i++)
-		period_deserialize(DatumGetPeriod(hslot.values[i]),
-						   &hist_lower[i], &hist_upper[i]);
+	int			nhist;
 
 	/* @> and @< also need a histogram of period lengths */
-	if (cachedOp == CONTAINS_OP || cachedOp == CONTAINED_OP)
-	{
-		if (!(HeapTupleIsValid(vardata->statsTuple) &&
-			  get_attstatsslot(&lslot, vardata->statsTuple,
-							   STATISTIC_KIND_PERIOD_LENGTH_HISTOGRAM, 
-							   InvalidOid, ATTSTATSSLOT_VALUES)))
-		{
-			free_attstatsslot(&hslot);
-			return -1.0;
-		}
-
-		/* check that it's a histogram, not just a dummy entry */
-		if (lslot.nvalues < 2)
-		{
-			free_attstatsslot(&lslot);
-			free_attstatsslot(&hslot);
-			return -1.0;
-		}
-	}
-	else
-		memset(&lslot, 0, sizeof(lslot));
+	bool length = (cachedOp == CONTAINS_OP || cachedOp == CONTAINED_OP);
+	hist = period_hist_lookup(vardata, length);
+	if (hist == NULL)
+		return -1.0;
+	/* check that it's a histogram, not just a dummy entry */
+	if (length && hist->nlength < 2)
+		return -1.0;
+	nhist = hist->nhist;
+	hist_lower = hist->hist_lower;
+	hist_upper = hist->hist_upper;
 
 	/* Extract the bounds of the constant value. */
 	period_deserialize(constval, &const_lower, &const_upper);
@@ -249,10 +407,10 @@ calc_period_hist_selectivity(VariableStatData *vardata, Period *constval,
 	}
 	else if (cachedOp == CONTAINS_OP)
 		hist_selec = calc_period_hist_selectivity_contains(&const_lower,
-			&const_upper, hist_lower, nhist, lslot.values, lslot.nvalues);
+			&const_upper, hist_lower, nhist, hist->length, hist->nlength);
 	else if (cachedOp == CONTAINED_OP)
 		hist_selec = calc_period_hist_selectivity_contained(&const_lower,
-			&const_upper, hist_lower, nhist, lslot.values, lslot.nvalues);
+			&const_upper, hist_lower, nhist, hist->length, hist->nlength);
 	else if (cachedOp == ADJACENT_OP)
 		hist_selec = calc_period_hist_selectivity_adjacent(&const_lower,
 			&const_upper, hist_lower, hist_upper,nhist);
@@ -262,12 +420,71 @@ calc_period_hist_selectivity(VariableStatData *vardata, Period *constval,
 		hist_selec = -1.0;  /* keep compiler quiet */
 	}
 
-	free_attstatsslot(&lslot);
-	free_attstatsslot(&hslot);
-
 	return hist_selec;
 }
 
+/*
+ * Calculate the selectivity of an operator with a period set constant using
+ * histograms of period bounds.
+ *
+ * The bounding period of the constant gives the estimate of the operators
+ * that only depend on the bounds of the constant. A value is contained in
+ * the period set when it is contained in one of its composing periods, which
+ * are disjoint events. A value overlaps the period set when it overlaps its
+ * bounding period without being contained in one of the gaps between the
+ * composing periods.
+ *
+ * This estimate is for the portion of values that are not NULL.
+ */
+double
+calc_periodset_hist_selectivity(VariableStatData *vardata, PeriodSet *ps,
+	CachedOp cachedOp)
+{
+	double selec;
+
+	if (ps->count == 1 || (cachedOp != OVERLAPS_OP && cachedOp != CONTAINED_OP))
+		return calc_period_hist_selectivity(vardata, periodset_bbox(ps),
+			cachedOp);
+
+	if (cachedOp == CONTAINED_OP)
+	{
+		selec = 0.0;
+		for (int i = 0; i < ps->count; i++)
+		{
+			double sel = calc_period_hist_selectivity(vardata,
+				periodset_per_n(ps, i), CONTAINED_OP);
+			if (sel < 0.0)
+				return -1.0;
+			selec += sel;
+		}
+		return selec;
+	}
+
+	selec = calc_period_hist_selectivity(vardata, periodset_bbox(ps),
+		OVERLAPS_OP);
+	if (selec < 0.0)
+		return selec;
+	/* Without a length histogram keep the estimate of the bounding period */
+	PeriodHistCacheEntry *hist = period_hist_lookup(vardata, true);
+	if (hist == NULL || hist->nlength < 2)
+		return selec;
+	for (int i = 0; i < ps->count - 1; i++)
+	{
+		Period *p1 = periodset_per_n(ps, i);
+		Period *p2 = periodset_per_n(ps, i + 1);
+		PeriodBound lower, upper;
+		lower.val = p1->upper;
+		lower.inclusive = ! p1->upper_inc;
+		lower.lower = true;
+		upper.val = p2->lower;
+		upper.inclusive = ! p2->lower_inc;
+		upper.lower = false;
+		selec -= calc_period_hist_selectivity_contained(&lower, &upper,
+			hist->hist_lower, hist->nhist, hist->length, hist->nlength);
+	}
+	return Max(selec, 0.0);
+}
+
 /*
  * Binary search on an array of period bounds. Returns greatest index of period
  * bound in array which is less(less or equal) than given period bound. If all
@@ -826,6 +1043,73 @@ double calc_period_hist_selectivity_adjacent(PeriodBound *lower, PeriodBound *up
 	return selec1 + selec2;
 }
 
+/*
+ * Estimate the fraction of pairs of values for which a bound of the first
+ * value is less than a bound of the second one, given the histograms of 
+ * these bounds. Since the bins of the second histogram hold the same number
+ * of values, the fraction is the average over these bins of the fraction of
+ * bounds of the first histogram that are less than the bounds of the bin,
+ * which is obtained by linear interpolation between the bin boundaries.
+ */
+static double
+calc_period_hist_joinsel_lt(PeriodBound *hist1, int nhist1, 
+	PeriodBound *hist2, int nhist2)
+{
+	double selec = 0.0, prev, cur;
+	int i;
+
+	prev = calc_period_hist_selectivity_scalar(&hist2[0], hist1, nhist1, false);
+	for (i = 1; i < nhist2; i++)
+	{
+		cur = calc_period_hist_selectivity_scalar(&hist2[i], hist1, nhist1, false);
+		selec += (prev + cur) / 2.0;
+		prev = cur;
+	}
+	return selec / (double) (nhist2 - 1);
+}
+
+/*
+ * Calculate the join selectivity of the overlaps operator between two 
+ * columns using their histograms of period bounds.
+ *
+ * A && B <=> NOT (A <<# B OR A #>> B), that is, the fraction of pairs is
+ * one minus the fraction of pairs where upper(A) < lower(B) and the 
+ * fraction of pairs where upper(B) < lower(A), which are mutually exclusive.
+ *
+ * This estimate is for the portion of values that are not NULL. Returns -1
+ * if any of the columns has no histogram.
+ */
+double
+calc_period_hist_joinselectivity(VariableStatData *vardata1, 
+	VariableStatData *vardata2)
+{
+	PeriodHistCacheEntry *hist1, *hist2;
+	double selec;
+
+	hist1 = period_hist_lookup(vardata1, false);
+	/* Check that it is a histogram, not just a dummy entry */
+	if (hist1 == NULL || hist1->nhist < 2)
+		return -1.0;
+	hist2 = period_hist_lookup(vardata2, false);
+	if (hist2 == NULL || hist2->nhist < 2)
+		return -1.0;
+	/*
+	 * The entry of the first column may have been replaced when looking up
+	 * the second one, while looking it up again never replaces the entry of 
+	 * the second column
+	 */
+	hist1 = period_hist_lookup(vardata1, false);
+
+	selec = calc_period_hist_joinsel_lt(hist1->hist_upper, hist1->nhist, 
+		hist2->hist_lower, hist2->nhist);
+	selec += calc_period_hist_joinsel_lt(hist2->hist_upper, hist2->nhist, 
+		hist1->hist_lower, hist1->nhist);
+	selec = 1.0 - selec;
+
+	CLAMP_PROBABILITY(selec);
+	return selec;
+}
+
 /*
  * periodsel -- restriction selectivity for period operators
  */
@@ -843,6 +1127,7 @@ periodsel(PG_FUNCTION_ARGS)
 	bool		varonleft;
 	Selectivity selec;
 	Period  *constperiod = NULL;
+	PeriodSet *constps = NULL;
 
 	/*
 	 * If expression is not (variable op something) or (something op
@@ -925,11 +1210,11 @@ periodsel(PG_FUNCTION_ARGS)
 	}
 	else if (timetypid == type_oid(T_PERIODSET))
 	{
-		/* the right argument is a constant PERIODSET. We convert it into
-		 * a period, which is its bounding box.
+		/* the right argument is a constant PERIODSET. Its bounding box is
+		 * used for the operators that only depend on its bounds.
 		 */
-		constperiod =  periodset_bbox(
-				DatumGetPeriodSet(((Const *) other)->constvalue));
+		constps = DatumGetPeriodSet(((Const *) other)->constvalue);
+		constperiod = periodset_bbox(constps);
 	}
 
 	/*
@@ -939,7 +1224,7 @@ periodsel(PG_FUNCTION_ARGS)
 	 * PERIOD_ELEM_CONTAINED_OP.
 	 */
 	if (constperiod)
-		selec = calc_periodsel(&vardata, constperiod, operator);
+		selec = calc_periodsel(&vardata, constperiod, constps, operator);
 	else
 		selec = default_period_selectivity(operator);
 
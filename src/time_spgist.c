@@ -24,6 +24,7 @@
 #include "time_gist.h"
 #include "temporaltypes.h"
 #include "oidcache.h"
+#include "temporal_stats.h"
 
 /*****************************************************************************
  * SP-GiST config functions
@@ -34,12 +35,14 @@ PG_FUNCTION_INFO_V1(spgist_period_config);
 PGDLLEXPORT Datum
 spgist_period_config(PG_FUNCTION_ARGS)
 {
+	spgConfigIn *in = (spgConfigIn *) PG_GETARG_POINTER(0);
 	spgConfigOut *cfg = (spgConfigOut *) PG_GETARG_POINTER(1);
 
 	cfg->prefixType = type_oid(T_PERIOD);
 	cfg->labelType = VOIDOID;	/* We don't need node labels. */
 	cfg->leafType = type_oid(T_PERIOD);
-	cfg->canReturnData = false;
+	/* The leaf values are exact only for period columns */
+	cfg->canReturnData = (in->attType == type_oid(T_PERIOD));
 	cfg->longValuesOK = false;
 	
 	PG_RETURN_VOID();
@@ -498,6 +501,8 @@ spgist_period_leaf_consistent(PG_FUNCTION_ARGS)
 
 		res = index_leaf_consistent_time(key, query, strategy);
 
+		MOBDB_STAT_INDEX(STAT_SPGIST_PERIOD, strategy, true, res, out->recheck);
+
 		/* If any check is failed, we have found our answer. */
 		if (!res)
 			break;
@@ -13,6 +13,7 @@
 #include "timeops.h"
 
 #include <assert.h>
+#include <utils/builtins.h>
 #include <utils/timestamp.h>
 
 #include "period.h"
@@ -33,6 +34,112 @@ time_type_oid(Oid timetypid)
 		timetypid == type_oid(T_PERIOD) || timetypid == type_oid(T_PERIODSET));
 }
 
+/*****************************************************************************
+ * Galloping search used by the merge joins of the set operations
+ *****************************************************************************/
+
+/*
+ * Returns true if the period ends before the bound, that is, if they do not
+ * share any instant
+ */
+static bool
+period_ends_before(const Period *p, TimestampTz t, bool inclusive)
+{
+	int cmp = timestamp_cmp_internal(p->upper, t);
+	return cmp < 0 || (cmp == 0 && ! (p->upper_inc && inclusive));
+}
+
+/*
+ * Returns the position of the first period of the period set, starting from
+ * the given position, that does not end before the bound. The periods to skip
+ * are found with steps of increasing size followed by a binary search, so
+ * that joining a small set with a large one only visits a logarithmic number
+ * of periods of the large set between two matches.
+ */
+static int
+periodset_gallop(PeriodSet *ps, int from, TimestampTz t, bool inclusive)
+{
+	if (from >= ps->count ||
+		! period_ends_before(periodset_per_n(ps, from), t, inclusive))
+		return from;
+	/* The period at lo ends before the bound, the one at hi does not */
+	int lo = from, hi = from + 1, step = 1;
+	while (hi < ps->count &&
+		period_ends_before(periodset_per_n(ps, hi), t, inclusive))
+	{
+		lo = hi;
+		step *= 2;
+		hi = lo + step;
+	}
+	if (hi > ps->count)
+		hi = ps->count;
+	while (hi - lo > 1)
+	{
+		int middle = lo + (hi - lo) / 2;
+		if (period_ends_before(periodset_per_n(ps, middle), t, inclusive))
+			lo = middle;
+		else
+			hi = middle;
+	}
+	return hi;
+}
+
+/*
+ * Returns true if the n-th timestamp of the timestamp set is before the
+ * timestamp, or also equal to it if strict is true
+ */
+static bool
+timestampset_time_before(TimestampSet *ts, int n, TimestampTz t, bool strict)
+{
+	int cmp = timestamp_cmp_internal(timestampset_time_n(ts, n), t);
+	return cmp < 0 || (strict && cmp == 0);
+}
+
+/*
+ * Returns the position of the first timestamp of the timestamp set, starting
+ * from the given position, that is greater than or equal to the timestamp,
+ * or strictly greater if strict is true
+ */
+static int
+timestampset_gallop(TimestampSet *ts, int from, TimestampTz t, bool strict)
+{
+	if (from >= ts->count || ! timestampset_time_before(ts, from, t, strict))
+		return from;
+	int lo = from, hi = from + 1, step = 1;
+	while (hi < ts->count && timestampset_time_before(ts, hi, t, strict))
+	{
+		lo = hi;
+		step *= 2;
+		hi = lo + step;
+	}
+	if (hi > ts->count)
+		hi = ts->count;
+	while (hi - lo > 1)
+	{
+		int middle = lo + (hi - lo) / 2;
+		if (timestampset_time_before(ts, middle, t, strict))
+			lo = middle;
+		else
+			hi = middle;
+	}
+	return hi;
+}
+
+/*
+ * Set the period to the given bounds if they define a non-empty period.
+ * Returns the number of periods set, that is, 0 or 1.
+ */
+static int
+period_piece(Period *p, TimestampTz lower, TimestampTz upper, bool lower_inc,
+	bool upper_inc)
+{
+	int cmp = timestamp_cmp_internal(lower, upper);
+	if (cmp > 0 || (cmp == 0 && ! (lower_inc && upper_inc)))
+		return 0;
+	period_set(p, lower, upper, lower_inc, upper_inc);
+	return 1;
+}
+
 /*****************************************************************************/
 /* contains? */
 
@@ -69,20 +176,15 @@ contains_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet *ts2
 	if (!contains_period_period_internal(p1, p2))
 		return false;
 
-	int i = 0, j = 0;
-	while (j < ts2->count)
+	int i = 0;
+	for (int j = 0; j < ts2->count; j++)
 	{
-		TimestampTz t1 = timestampset_time_n(ts1, i);
-		TimestampTz t2 = timestampset_time_n(ts2, j);
-		int cmp = timestamp_cmp_internal(t1, t2);
-		if (cmp == 0)
-		{
-			i++; j++;
-		}
-		else if (cmp < 0)
-			i++;
-		else
+		TimestampTz t = timestampset_time_n(ts2, j);
+		i = timestampset_gallop(ts1, i, t, false);
+		if (i == ts1->count ||
+			timestamp_cmp_internal(timestampset_time_n(ts1, i), t) != 0)
 			return false;
+		i++;
 	}
 	return true;
 }
@@ -103,14 +205,12 @@ contains_timestampset_timestampset(PG_FUNCTION_ARGS)
 bool
 contains_period_timestamp_internal(Period *p, TimestampTz t)
 {
-	int cmp = timestamp_cmp_internal(p->lower, t);
-	if (cmp > 0 || (cmp == 0 && ! p->lower_inc))
+	/* The timestamps are compared directly so that the function is small
+	 * enough to be inlined, also by the JIT */
+	if (p->lower > t || (p->lower == t && ! p->lower_inc))
 		return false;
-
-	cmp = timestamp_cmp_internal(p->upper, t);
-	if (cmp < 0 || (cmp == 0 && ! p->upper_inc))
+	if (p->upper < t || (p->upper == t && ! p->upper_inc))
 		return false;
-
 	return true;
 }
 
@@ -150,14 +250,7 @@ bool
 contains_period_period_internal(Period *p1, Period *p2)
 {
 	/* We must have lower1 <= lower2 and upper1 >= upper2 */
-	if (period_cmp_bounds(p1->lower, p2->lower, true, true,
-			p1->lower_inc, p2->lower_inc) > 0)
-		return false;
-	if (period_cmp_bounds(p1->upper, p2->upper, false, false,
-			p1->upper_inc, p2->upper_inc) < 0)
-		return false;
-
-	return true;
+	return period_contains_period(p1, p2);
 }
 
 PG_FUNCTION_INFO_V1(contains_period_period);
@@ -208,17 +301,15 @@ contains_periodset_timestampset_internal(PeriodSet *ps, TimestampSet *ts)
 	int i = 0, j = 0;
 	while (j < ts->count)
 	{
-		Period *p = periodset_per_n(ps, i);
 		TimestampTz t = timestampset_time_n(ts, j);
-		if (contains_period_timestamp_internal(p, t))
-			j++;
-		else
-		{
-			if (timestamp_cmp_internal(t, p->upper) > 0)
-				i++;
-			else
-				return false;
-		}
+		i = periodset_gallop(ps, i, t, true);
+		if (i == ps->count)
+			return false;
+		Period *p = periodset_per_n(ps, i);
+		if (!contains_period_timestamp_internal(p, t))
+			return false;
+		/* Skip all the timestamps contained in the period */
+		j = timestampset_gallop(ts, j + 1, p->upper, p->upper_inc);
 	}
 	return true;
 }
@@ -290,34 +381,18 @@ contains_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2)
 	if (!contains_period_period_internal(p1, p2))
 		return false;
 
-	int i = 0, j = 0;
-	while (i < ps1->count && j < ps2->count)
+	int i = 0;
+	for (int j = 0; j < ps2->count; j++)
 	{
-		p1 = periodset_per_n(ps1, i);
 		p2 = periodset_per_n(ps2, j);
-		if (before_period_period_internal(p1, p2))
-			i++;
-		else if (before_period_period_internal(p2, p1))
+		i = periodset_gallop(ps1, i, p2->lower, p2->lower_inc);
+		if (i == ps1->count)
+			return false;
+		p1 = periodset_per_n(ps1, i);
+		if (!contains_period_period_internal(p1, p2))
 			return false;
-		else
-		{
-			/* p1 and p2 overlap */
-			if (contains_period_period_internal(p1, p2))
-			{
-				if (timestamp_cmp_internal(p1->upper, p2->upper) == 0)
-				{
-					i++; j++;
-				}
-				else
-					j++;
-			}
-			else
-				return false;
-		}
 	}
-	/* if j == ps2->count every period in p2 is contained in a period of p1 
-	   but p1 may have additional periods */
-	return (j == ps2->count);
+	return true;
 }
 
 PG_FUNCTION_INFO_V1(contains_periodset_periodset);
@@ -468,18 +543,20 @@ overlaps_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet *ts2
 		return false;
 
 	int i = 0, j = 0;
-	while (i < ts1->count && j < ts2->count)
+	while (true)
 	{
-		TimestampTz t1 = timestampset_time_n(ts1, i);
 		TimestampTz t2 = timestampset_time_n(ts2, j);
+		i = timestampset_gallop(ts1, i, t2, false);
+		if (i == ts1->count)
+			return false;
+		TimestampTz t1 = timestampset_time_n(ts1, i);
 		if (timestamp_cmp_internal(t1, t2) == 0)
 			return true;
-		if (timestamp_cmp_internal(t1, t2) < 0)
-			i++;
-		else
-			j++;
+		/* t2 < t1 */
+		j = timestampset_gallop(ts2, j + 1, t1, false);
+		if (j == ts2->count)
+			return false;
 	}
-	return false;
 }
 
 PG_FUNCTION_INFO_V1(overlaps_timestampset_timestampset);
@@ -576,19 +653,8 @@ overlaps_period_timestampset(PG_FUNCTION_ARGS)
 bool
 overlaps_period_period_internal(Period *p1, Period *p2)
 {
-	if (period_cmp_bounds(p1->lower, p2->lower, true, true,
-			p1->lower_inc, p2->lower_inc) >= 0 &&
-		period_cmp_bounds(p1->lower, p2->upper, true, false,
-			p1->lower_inc, p2->upper_inc) <= 0)
-		return true;
-
-	if (period_cmp_bounds(p2->lower, p1->lower, true, true,
-			p2->lower_inc, p1->lower_inc) >= 0 &&
-		period_cmp_bounds(p2->lower, p1->upper, true, false,
-			p2->lower_inc, p1->upper_inc) <= 0)
-		return true;
-
-	return false;
+	/* We must have lower1 <= upper2 and lower2 <= upper1 */
+	return period_overlaps_period(p1, p2);
 }
 
 PG_FUNCTION_INFO_V1(overlaps_period_period);
@@ -671,22 +737,20 @@ overlaps_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2)
 		return false;
 
 	int i = 0, j = 0;
-	while (i < ps1->count && j < ps2->count)
+	while (true)
 	{
-		p1 = periodset_per_n(ps1, i);
 		p2 = periodset_per_n(ps2, j);
+		i = periodset_gallop(ps1, i, p2->lower, p2->lower_inc);
+		if (i == ps1->count)
+			return false;
+		p1 = periodset_per_n(ps1, i);
 		if (overlaps_period_period_internal(p1, p2))
 			return true;
-		if (timestamp_cmp_internal(p1->upper, p2->upper) == 0)
-		{
-			i++; j++;
-		}
-		else if (timestamp_cmp_internal(p1->upper, p2->upper) < 0)
-			i++;
-		else
-			j++;
+		/* p2 is before p1 */
+		j = periodset_gallop(ps2, j + 1, p1->lower, p1->lower_inc);
+		if (j == ps2->count)
+			return false;
 	}
-	return false;
 }
 
 PG_FUNCTION_INFO_V1(overlaps_periodset_periodset);
@@ -727,8 +791,7 @@ before_timestamp_timestampset(PG_FUNCTION_ARGS)
 bool
 before_timestamp_period_internal(TimestampTz t, Period *p)
 {
-	return (period_cmp_bounds(t, p->lower, false, true,
-		true, p->lower_inc) < 0);
+	return (t < p->lower || (t == p->lower && ! p->lower_inc));
 }
 
 PG_FUNCTION_INFO_V1(before_timestamp_period);
@@ -745,8 +808,7 @@ bool
 before_timestamp_periodset_internal(TimestampTz t, PeriodSet *ps)
 {
 	Period *p = periodset_per_n(ps, 0);
-	return (period_cmp_bounds(t, p->lower, false, true,
-		true, p->lower_inc) < 0);
+	return (t < p->lower || (t == p->lower && ! p->lower_inc));
 }
 
 PG_FUNCTION_INFO_V1(before_timestamp_periodset);
@@ -825,8 +887,7 @@ before_timestampset_periodset_internal(TimestampSet *ts, PeriodSet *ps)
 {
 	Period *p = periodset_per_n(ps, 0);
 	TimestampTz t = timestampset_time_n(ts, ts->count - 1);
-	return (period_cmp_bounds(p->lower, t, true, false,
-		p->lower_inc, true) > 0);
+	return (p->lower > t || (p->lower == t && ! p->lower_inc));
 }
 
 PG_FUNCTION_INFO_V1(before_timestampset_periodset);
@@ -845,8 +906,7 @@ before_timestampset_periodset(PG_FUNCTION_ARGS)
 bool
 before_period_timestamp_internal(Period *p, TimestampTz t)
 {
-	return (period_cmp_bounds(p->upper, t, false, true,
-		p->upper_inc, true) < 0);
+	return (p->upper < t || (p->upper == t && ! p->upper_inc));
 }
 
 PG_FUNCTION_INFO_V1(before_period_timestamp);
@@ -919,8 +979,7 @@ bool
 before_periodset_timestamp_internal(PeriodSet *ps, TimestampTz t)
 {
 	Period *p = periodset_per_n(ps, ps->count - 1);
-	return (period_cmp_bounds(p->upper, t, false, true,
-		p->upper_inc, true) < 0);
+	return (p->upper < t || (p->upper == t && ! p->upper_inc));
 }
 
 PG_FUNCTION_INFO_V1(before_periodset_timestamp);
@@ -940,8 +999,7 @@ before_periodset_timestampset_internal(PeriodSet *ps, TimestampSet *ts)
 {
 	Period *p = periodset_per_n(ps, ps->count - 1);
 	TimestampTz t = timestampset_time_n(ts, 0);
-	return (period_cmp_bounds(p->upper, t, false, true,
-		p->upper_inc, true) < 0);
+	return (p->upper < t || (p->upper == t && ! p->upper_inc));
 }
 
 PG_FUNCTION_INFO_V1(before_periodset_timestampset);
@@ -1024,8 +1082,7 @@ after_timestamp_timestampset(PG_FUNCTION_ARGS)
 bool
 after_timestamp_period_internal(TimestampTz t, Period *p)
 {
-	return (period_cmp_bounds(t, p->upper, true, false,
-		true, p->upper_inc) > 0);
+	return (t > p->upper || (t == p->upper && ! p->upper_inc));
 }
 
 PG_FUNCTION_INFO_V1(after_timestamp_period);
@@ -1042,8 +1099,7 @@ bool
 after_timestamp_periodset_internal(TimestampTz t, PeriodSet *ps)
 {
 	Period *p = periodset_per_n(ps, ps->count - 1);
-	return (period_cmp_bounds(t, p->upper, true, false,
-		true, p->upper_inc) > 0);
+	return (t > p->upper || (t == p->upper && ! p->upper_inc));
 }
 
 PG_FUNCTION_INFO_V1(after_timestamp_periodset);
@@ -1124,8 +1180,7 @@ after_timestampset_periodset_internal(TimestampSet *ts, PeriodSet *ps)
 {
 	Period *p = periodset_per_n(ps, ps->count - 1);
 	TimestampTz t = timestampset_time_n(ts, 0);
-	return (period_cmp_bounds(p->upper, t, false, true,
-		p->upper_inc, true) < 0);
+	return (p->upper < t || (p->upper == t && ! p->upper_inc));
 }
 
 PG_FUNCTION_INFO_V1(after_timestampset_periodset);
@@ -1144,8 +1199,7 @@ after_timestampset_periodset(PG_FUNCTION_ARGS)
 bool
 after_period_timestamp_internal(Period *p, TimestampTz t)
 {
-	return (period_cmp_bounds(p->lower, t, true, false,
-		p->lower_inc, true) > 0);
+	return (p->lower > t || (p->lower == t && ! p->lower_inc));
 }
 
 PG_FUNCTION_INFO_V1(after_period_timestamp);
@@ -1218,8 +1272,7 @@ bool
 after_periodset_timestamp_internal(PeriodSet *ps, TimestampTz t)
 {
 	Period *p = periodset_per_n(ps, 0);
-	return (period_cmp_bounds(p->lower, t, true, false,
-		p->lower_inc, true) > 0);
+	return (p->lower > t || (p->lower == t && ! p->lower_inc));
 }
 
 PG_FUNCTION_INFO_V1(after_periodset_timestamp);
@@ -1239,8 +1292,7 @@ after_periodset_timestampset_internal(PeriodSet *ps, TimestampSet *ts)
 {
 	Period *p = periodset_per_n(ps, 0);
 	TimestampTz t = timestampset_time_n(ts, ts->count - 1);
-	return (period_cmp_bounds(p->lower, t, true, false,
-		p->lower_inc, true) > 0);
+	return (p->lower > t || (p->lower == t && ! p->lower_inc));
 }
 
 PG_FUNCTION_INFO_V1(after_periodset_timestampset);
@@ -1323,8 +1375,7 @@ overbefore_timestamp_timestampset(PG_FUNCTION_ARGS)
 bool
 overbefore_timestamp_period_internal(TimestampTz t, Period *p)
 {
-	return (period_cmp_bounds(t, p->upper, false, false,
-			true, p->upper_inc) <= 0);
+	return (t < p->upper || (t == p->upper && p->upper_inc));
 }
 
 PG_FUNCTION_INFO_V1(overbefore_timestamp_period);
@@ -1341,8 +1392,7 @@ bool
 overbefore_timestamp_periodset_internal(TimestampTz t, PeriodSet *ps)
 {
 	Period *p = periodset_per_n(ps, ps->count - 1);
-	return (period_cmp_bounds(t, p->upper, false, false,
-			true, p->upper_inc) <= 0);
+	return (t < p->upper || (t == p->upper && p->upper_inc));
 }
 
 PG_FUNCTION_INFO_V1(overbefore_timestamp_periodset);
@@ -1440,8 +1490,7 @@ overbefore_timestampset_periodset(PG_FUNCTION_ARGS)
 bool
 overbefore_period_timestamp_internal(Period *p, TimestampTz t)
 {
-	return (period_cmp_bounds(p->upper, t, false, false,
-			p->upper_inc, true) <= 0);
+	return (p->upper <= t);
 }
 
 PG_FUNCTION_INFO_V1(overbefore_period_timestamp);
@@ -1515,8 +1564,7 @@ bool
 overbefore_periodset_timestamp_internal(PeriodSet *ps, TimestampTz t)
 {
 	Period *p = periodset_per_n(ps, ps->count - 1);
-	return (period_cmp_bounds(p->upper, t, false, false,
-			p->upper_inc, true) <= 0);
+	return (p->upper <= t);
 }
 
 PG_FUNCTION_INFO_V1(overbefore_periodset_timestamp);
@@ -1619,8 +1667,7 @@ overafter_timestamp_timestampset(PG_FUNCTION_ARGS)
 bool
 overafter_timestamp_period_internal(TimestampTz t, Period *p)
 {
-	return (period_cmp_bounds(t, p->lower, true, true,
-			true, p->lower_inc) >= 0);
+	return (t > p->lower || (t == p->lower && p->lower_inc));
 }
 
 PG_FUNCTION_INFO_V1(overafter_timestamp_period);
@@ -1637,8 +1684,7 @@ bool
 overafter_timestamp_periodset_internal(TimestampTz t, PeriodSet *ps)
 {
 	Period *p = periodset_per_n(ps, 0);
-	return (period_cmp_bounds(t, p->lower, true, true,
-			true, p->lower_inc) >= 0);
+	return (t > p->lower || (t == p->lower && p->lower_inc));
 }
 
 PG_FUNCTION_INFO_V1(overafter_timestamp_periodset);
@@ -1736,8 +1782,7 @@ overafter_timestampset_periodset(PG_FUNCTION_ARGS)
 bool
 overafter_period_timestamp_internal(Period *p, TimestampTz t)
 {
-	return (period_cmp_bounds(p->lower, t, true, true,
-			p->lower_inc, true) >= 0);
+	return (p->lower >= t);
 }
 
 PG_FUNCTION_INFO_V1(overafter_period_timestamp);
@@ -1810,8 +1855,7 @@ bool
 overafter_periodset_timestamp_internal(PeriodSet *ps, TimestampTz t)
 {
 	Period *p = periodset_per_n(ps, 0);
-	return (period_cmp_bounds(p->lower, t, true, true,
-			p->lower_inc, true) >= 0);
+	return (p->lower >= t);
 }
 
 PG_FUNCTION_INFO_V1(overafter_periodset_timestamp);
@@ -2633,137 +2677,53 @@ union_periodset_period(PG_FUNCTION_ARGS)
 PeriodSet *
 union_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2)
 {
-	Period **periods = palloc(sizeof(Period *) * (ps1->count + ps2->count));
-	
-	/* If the period sets do not overlap */
-	if (!overlaps_periodset_periodset_internal(ps1, ps2))
+	/* The periods are merged by increasing lower bound and each one is
+	 * either appended or merged with the last period of the result */
+	Period *periods = palloc(sizeof(Period) * (ps1->count + ps2->count));
+	int i = 0, j = 0, k = 0;
+	while (i < ps1->count || j < ps2->count)
 	{
-		int i = 0, j = 0, k = 0;
-		while (i < ps1->count && j < ps2->count)
+		Period *p;
+		if (j == ps2->count)
+			p = periodset_per_n(ps1, i++);
+		else if (i == ps1->count)
+			p = periodset_per_n(ps2, j++);
+		else
 		{
 			Period *p1 = periodset_per_n(ps1, i);
 			Period *p2 = periodset_per_n(ps2, j);
-			if (before_period_period_internal(p1, p2))
-			{
-				periods[k++] = p1;
-				i++;
-			}
-			else
-			{
-				periods[k++] = p2;
-				j++;
-			}
-		}
-		PeriodSet *result = periodset_from_periodarr_internal(periods, k, false);
-		pfree(periods);
-		return result;
-	}
-
-	Period **mustfree = palloc(sizeof(Period *) * Max(ps1->count, ps2->count));
-	int i = 0, j = 0, k = 0, l = 0;
-	while (i < ps1->count && j < ps2->count)
-	{
-		Period *p1 = periodset_per_n(ps1, i);
-		Period *p2 = periodset_per_n(ps2, j);
-		/* The periods do not overlap, copy the earliest period */
-		if (!overlaps_period_period_internal(p1, p2))
-		{
-			if (before_period_period_internal(p1, p2))
+			if (period_cmp_bounds(p1->lower, p2->lower, true, true,
+				p1->lower_inc, p2->lower_inc) <= 0)
 			{
-				periods[k++] = p1;
+				p = p1;
 				i++;
 			}
 			else
 			{
-				periods[k++] = p2;
+				p = p2;
 				j++;
 			}
 		}
-		else
+		if (k > 0)
 		{
-			/* Find all periods in ps1 that overlap with periods in ps2
-				   i				 i
-				|-----|  |-----|  |-----|  |-----|	 
-					 |-----|  |-----| 
-						j		j
-			*/
-			Period *q1 = NULL, *q2 = NULL; /* keep compiler quiet */
-			/* remember whether i or j was the last value incremented */
-			bool ilastinc = false, jlastinc = false;
-			while (i < ps1->count && j < ps2->count)
+			Period *last = &periods[k - 1];
+			int cmp = timestamp_cmp_internal(last->upper, p->lower);
+			if (cmp > 0 || (cmp == 0 && (last->upper_inc || p->lower_inc)))
 			{
-				q1 = periodset_per_n(ps1, i);
-				q2 = periodset_per_n(ps2, j);
-				if (overlaps_period_period_internal(q1, q2))
+				/* The periods overlap or are adjacent */
+				if (period_cmp_bounds(p->upper, last->upper, false, false,
+					p->upper_inc, last->upper_inc) > 0)
 				{
-					if (timestamp_cmp_internal(q1->upper, q2->upper) == 0)
-					{
-						i++; j++;
-						ilastinc = true; jlastinc = true;
-
-					}
-					else if (timestamp_cmp_internal(q1->upper, q2->upper) < 0)
-					{
-						i++;
-						ilastinc = true; jlastinc = false;
-					}
-					else
-					{
-						j++;
-						ilastinc = false; jlastinc = true;
-					}
+					last->upper = p->upper;
+					last->upper_inc = p->upper_inc;
 				}
-				else
-					break;
-			}
-			/* Put after the value of last counter to be incremented */
-			if (ilastinc)
-				q1 = periodset_per_n(ps1, --i);
-			if (jlastinc)
-				q2 = periodset_per_n(ps2, --j);
-			/* Compute the union of the overlapping periods */
-			TimestampTz lower, upper;
-			bool lower_inc, upper_inc;
-			if (period_cmp_bounds(p1->lower, p2->lower, true, true,
-				p1->lower_inc, p2->lower_inc) < 0)
-			{
-				lower = p1->lower;
-				lower_inc = p1->lower_inc;
-			}
-			else
-			{
-				lower = p2->lower;
-				lower_inc = p2->lower_inc;
+				continue;
 			}
-			if (period_cmp_bounds(q1->upper, q2->upper, false, false,
-				q1->upper_inc, q2->upper_inc) > 0)
-			{
-				upper = q1->upper;
-				upper_inc = q1->upper_inc;
-			}
-			else
-			{
-				upper = q2->upper;
-				upper_inc = q2->upper_inc;
-			}
-			Period *p3 = period_make(lower, upper, lower_inc, upper_inc);
-			periods[k++] = p3;
-			mustfree[l++] = p3;
-			i++; j++;
 		}
+		periods[k++] = *p;
 	}
-	while (i < ps1->count)
-		periods[k++] = periodset_per_n(ps1, i++);
-	while (j < ps2->count)
-		periods[k++] = periodset_per_n(ps2, j++);
-	/* k is never equal to 0 since the periodsets are not empty*/
-	PeriodSet *result = periodset_from_periodarr_internal(periods, k, true);
-
+	PeriodSet *result = periodset_from_periods_internal(periods, k);
 	pfree(periods);
-	for (i = 0; i < l; i++)
-		pfree(mustfree[i]);
-	pfree(mustfree);
-
 	return result;
 }
 
@@ -2861,21 +2821,22 @@ intersection_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet
 	if (!overlaps_period_period_internal(p1, p2))
 		return NULL;
 
-	TimestampTz *times = palloc(sizeof(TimestampTz) * (ts1->count + ts2->count));
+	TimestampTz *times = palloc(sizeof(TimestampTz) * Min(ts1->count, ts2->count));
 	int i = 0, j = 0, k = 0;
 	while (i < ts1->count && j < ts2->count)
 	{
 		TimestampTz t1 = timestampset_time_n(ts1, i);
 		TimestampTz t2 = timestampset_time_n(ts2, j);
-		if (timestamp_cmp_internal(t1, t2) == 0)
+		int cmp = timestamp_cmp_internal(t1, t2);
+		if (cmp == 0)
 		{
 			times[k++] = t1;
 			i++; j++;
 		}
-		else if (timestamp_cmp_internal(t1, t2) < 0)
-			i++;
+		else if (cmp < 0)
+			i = timestampset_gallop(ts1, i + 1, t2, false);
 		else
-			j++;
+			j = timestampset_gallop(ts2, j + 1, t1, false);
 	}
 	if (k == 0)
 	{
@@ -3046,43 +3007,52 @@ intersection_period_timestampset(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
-Period *
-intersection_period_period_internal(Period *p1, Period *p2)
+/*
+ * Intersection of two periods without allocating the result. Returns false
+ * if the periods do not overlap.
+ */
+bool
+intersection_period_period_internal1(Period *result, const Period *p1,
+	const Period *p2)
 {
-	TimestampTz lower;
-	TimestampTz upper;
-	bool lower_inc;
-	bool upper_inc;
-
 	/* Bounding box test */
-	if (!overlaps_period_period_internal(p1, p2))
-		return NULL;
+	if (!overlaps_period_period_internal((Period *) p1, (Period *) p2))
+		return false;
 
 	if (period_cmp_bounds(p1->lower, p2->lower, true, true,
 		p1->lower_inc, p2->lower_inc) >= 0)
 	{
-		lower = p1->lower;
-		lower_inc = p1->lower_inc;
+		result->lower = p1->lower;
+		result->lower_inc = p1->lower_inc;
 	}
 	else
 	{
-		lower = p2->lower;
-		lower_inc = p2->lower_inc;
+		result->lower = p2->lower;
+		result->lower_inc = p2->lower_inc;
 	}
 
 	if (period_cmp_bounds(p1->upper, p2->upper, false, false,
 		p1->upper_inc, p2->upper_inc) <= 0)
 	{
-		upper = p1->upper;
-		upper_inc = p1->upper_inc;
+		result->upper = p1->upper;
+		result->upper_inc = p1->upper_inc;
 	}
 	else
 	{
-		upper = p2->upper;
-		upper_inc = p2->upper_inc;
+		result->upper = p2->upper;
+		result->upper_inc = p2->upper_inc;
 	}
+	return true;
+}
 
-	return period_make(lower, upper, lower_inc, upper_inc);
+Period *
+intersection_period_period_internal(Period *p1, Period *p2)
+{
+	Period inter;
+	if (!intersection_period_period_internal1(&inter, p1, p2))
+		return NULL;
+	return period_make(inter.lower, inter.upper, inter.lower_inc,
+		inter.upper_inc);
 }
 
 PG_FUNCTION_INFO_V1(intersection_period_period);
@@ -3205,26 +3175,36 @@ intersection_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2)
 	if (!overlaps_period_period_internal(p1, p2))
 		return NULL;
 
-	Period *inter = intersection_period_period_internal(p1, p2);
-	int n1, n2;
-	periodset_find_timestamp(ps1, inter->lower, &n1);
-	periodset_find_timestamp(ps2, inter->lower, &n2);
-	pfree(inter);
-	Period **periods = palloc(sizeof(Period *) * (ps1->count + ps2->count - n1 - n2));
-	int i = n1, j = n2, k = 0;
+	/* The intersection of two normalized period sets is normalized */
+	Period *periods = palloc(sizeof(Period) * (ps1->count + ps2->count));
+	int i = 0, j = 0, k = 0;
 	while (i < ps1->count && j < ps2->count)
 	{
 		p1 = periodset_per_n(ps1, i);
 		p2 = periodset_per_n(ps2, j);
-		inter = intersection_period_period_internal(p1, p2);
-		if (inter != NULL)
-			periods[k++] = inter;
-		int cmp = timestamp_cmp_internal(p1->upper, p2->upper);
-		if (cmp == 0 && p1->upper_inc == p2->upper_inc)
+		if (before_period_period_internal(p1, p2))
+		{
+			i = periodset_gallop(ps1, i + 1, p2->lower, p2->lower_inc);
+			continue;
+		}
+		if (before_period_period_internal(p2, p1))
+		{
+			j = periodset_gallop(ps2, j + 1, p1->lower, p1->lower_inc);
+			continue;
+		}
+		/* The periods overlap */
+		Period *lower = period_cmp_bounds(p1->lower, p2->lower, true, true,
+			p1->lower_inc, p2->lower_inc) >= 0 ? p1 : p2;
+		int cmp = period_cmp_bounds(p1->upper, p2->upper, false, false,
+			p1->upper_inc, p2->upper_inc);
+		Period *upper = cmp <= 0 ? p1 : p2;
+		period_set(&periods[k++], lower->lower, upper->upper,
+			lower->lower_inc, upper->upper_inc);
+		if (cmp == 0)
 		{
 			i++; j++;
 		}
-		else if (cmp < 0 || (cmp == 0 && ! p1->upper_inc && p2->upper_inc))
+		else if (cmp < 0)
 			i++;
 		else
 			j++;
@@ -3235,9 +3215,7 @@ intersection_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2)
 		return NULL;
 	}
 
-	PeriodSet *result = periodset_from_periodarr_internal(periods, k, true);
-	for (i = 0; i < k; i++)
-		pfree(periods[i]);
+	PeriodSet *result = periodset_from_periods_internal(periods, k);
 	pfree(periods);
 	return result;
 }
@@ -3369,22 +3347,14 @@ minus_timestampset_timestampset_internal(TimestampSet *ts1, TimestampSet *ts2)
 		return timestampset_copy(ts1);
 
 	TimestampTz *times = palloc(sizeof(TimestampTz) * ts1->count);
-	int i = 0, j = 0, k = 0;
-	while (i < ts1->count && j < ts2->count)
+	int j = 0, k = 0;
+	for (int i = 0; i < ts1->count; i++)
 	{
-		TimestampTz t1 = timestampset_time_n(ts1, i);
-		TimestampTz t2 = timestampset_time_n(ts2, j);
-		if (timestamp_cmp_internal(t1, t2) == 0)
-		{
-			i++; j++;
-		}
-		if (timestamp_cmp_internal(t1, t2) < 0)
-		{
-			times[k++] = t1;
-			i++;
-		}
-		else
-			j++;
+		TimestampTz t = timestampset_time_n(ts1, i);
+		j = timestampset_gallop(ts2, j, t, false);
+		if (j == ts2->count ||
+			timestamp_cmp_internal(timestampset_time_n(ts2, j), t) != 0)
+			times[k++] = t;
 	}
 	if (k == 0)
 	{
@@ -4015,40 +3985,43 @@ minus_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2)
 	if (!overlaps_period_period_internal(p1, p2))
 		return periodset_copy(ps1);
 
-	Period **periods = palloc(sizeof(Period *) * (ps1->count + ps2->count));
-	int i = 0, j = 0, k = 0;
-	while (i < ps1->count && j < ps2->count)
+	/* Each period of ps2 splits at most one period of ps1 */
+	Period *periods = palloc(sizeof(Period) * (ps1->count + ps2->count));
+	int j = 0, k = 0;
+	for (int i = 0; i < ps1->count; i++)
 	{
 		p1 = periodset_per_n(ps1, i);
-		p2 = periodset_per_n(ps2, j);
-		/* The periods do not overlap, copy the first period */
-		if (!overlaps_period_period_internal(p1, p2))
-		{
-			periods[k++] = period_copy(p1);
-			i++;
-		}
-		else
-		{
-			/* Find all periods in ps2 that overlap with p1
-							  i
-				|------------------------|  
+		j = periodset_gallop(ps2, j, p1->lower, p1->lower_inc);
+		/* Remove from p1 the periods of ps2 that overlap with it
+				|------------------------|
 					 |-----|  |-----|	  |---|
-						j					l
-			*/
-			int l;
-			for (l = j; l < ps2->count; l++)
+						j					
+		*/
+		TimestampTz lower = p1->lower;
+		bool lower_inc = p1->lower_inc;
+		bool covered = false;
+		while (j < ps2->count)
+		{
+			p2 = periodset_per_n(ps2, j);
+			if (before_period_period_internal(p1, p2))
+				break;
+			k += period_piece(&periods[k], lower, p2->lower, lower_inc,
+				! p2->lower_inc);
+			/* The last period of ps2 may also overlap with the next period
+			 * of ps1 */
+			if (period_cmp_bounds(p2->upper, p1->upper, false, false,
+				p2->upper_inc, p1->upper_inc) >= 0)
 			{
-				Period *p3 = periodset_per_n(ps2, l);
-				if (!overlaps_period_period_internal(p1, p3))
-					break;
+				covered = true;
+				break;
 			}
-			int count = l - j;
-			/* Compute the difference of the overlapping periods */
-			k += minus_period_periodset_internal1(&periods[k], p1,
-				ps2, j, count);
-			i++;
-			j = l;
+			lower = p2->upper;
+			lower_inc = ! p2->upper_inc;
+			j++;
 		}
+		if (! covered)
+			k += period_piece(&periods[k], lower, p1->upper, lower_inc,
+				p1->upper_inc);
 	}
 	if (k == 0)
 	{
@@ -4056,9 +4029,7 @@ minus_periodset_periodset_internal(PeriodSet *ps1, PeriodSet *ps2)
 		return NULL;
 	}
 
-	PeriodSet *result = periodset_from_periodarr_internal(periods, k, false);
-	for (i = 0; i < k; i++)
-		pfree(periods[i]);
+	PeriodSet *result = periodset_from_periods_internal(periods, k);
 	pfree(periods);
 	return result;
 }
@@ -4078,4 +4049,122 @@ minus_periodset_periodset(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Distance
+ * The distance between a time value and a timestamp is the number of seconds
+ * between the timestamp and the nearest timestamp of the time value, which
+ * is 0 when the time value contains the timestamp. The bounds of the periods
+ * are considered as inclusive.
+ *****************************************************************************/
+
+double
+period_timestamp_distance_internal(const Period *p, TimestampTz t)
+{
+	if (t < p->lower)
+		return ((double) (p->lower - t)) / USECS_PER_SEC;
+	if (t > p->upper)
+		return ((double) (t - p->upper)) / USECS_PER_SEC;
+	return 0.0;
+}
+
+double
+timestampset_timestamp_distance_internal(TimestampSet *ts, TimestampTz t)
+{
+	int loc;
+	if (timestampset_find_timestamp(ts, t, &loc))
+		return 0.0;
+	double result = get_float8_infinity();
+	if (loc > 0)
+		result = ((double) (t - timestampset_time_n(ts, loc - 1))) /
+			USECS_PER_SEC;
+	if (loc < ts->count)
+		result = Min(result, ((double) (timestampset_time_n(ts, loc) - t)) /
+			USECS_PER_SEC);
+	return result;
+}
+
+double
+periodset_timestamp_distance_internal(PeriodSet *ps, TimestampTz t)
+{
+	int loc;
+	if (periodset_find_timestamp(ps, t, &loc))
+		return 0.0;
+	double result = get_float8_infinity();
+	if (loc > 0)
+		result = period_timestamp_distance_internal(
+			periodset_per_n(ps, loc - 1), t);
+	if (loc < ps->count)
+		result = Min(result, period_timestamp_distance_internal(
+			periodset_per_n(ps, loc), t));
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(distance_timestamp_timestampset);
+
+PGDLLEXPORT Datum
+distance_timestamp_timestampset(PG_FUNCTION_ARGS)
+{
+	TimestampTz t = PG_GETARG_TIMESTAMPTZ(0);
+	TimestampSet *ts = PG_GETARG_TIMESTAMPSET(1);
+	double result = timestampset_timestamp_distance_internal(ts, t);
+	PG_FREE_IF_COPY(ts, 1);
+	PG_RETURN_FLOAT8(result);
+}
+
+PG_FUNCTION_INFO_V1(distance_timestamp_period);
+
+PGDLLEXPORT Datum
+distance_timestamp_period(PG_FUNCTION_ARGS)
+{
+	TimestampTz t = PG_GETARG_TIMESTAMPTZ(0);
+	Period *p = PG_GETARG_PERIOD(1);
+	PG_RETURN_FLOAT8(period_timestamp_distance_internal(p, t));
+}
+
+PG_FUNCTION_INFO_V1(distance_timestamp_periodset);
+
+PGDLLEXPORT Datum
+distance_timestamp_periodset(PG_FUNCTION_ARGS)
+{
+	TimestampTz t = PG_GETARG_TIMESTAMPTZ(0);
+	PeriodSet *ps = PG_GETARG_PERIODSET(1);
+	double result = periodset_timestamp_distance_internal(ps, t);
+	PG_FREE_IF_COPY(ps, 1);
+	PG_RETURN_FLOAT8(result);
+}
+
+PG_FUNCTION_INFO_V1(distance_timestampset_timestamp);
+
+PGDLLEXPORT Datum
+distance_timestampset_timestamp(PG_FUNCTION_ARGS)
+{
+	TimestampSet *ts = PG_GETARG_TIMESTAMPSET(0);
+	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+	double result = timestampset_timestamp_distance_internal(ts, t);
+	PG_FREE_IF_COPY(ts, 0);
+	PG_RETURN_FLOAT8(result);
+}
+
+PG_FUNCTION_INFO_V1(distance_period_timestamp);
+
+PGDLLEXPORT Datum
+distance_period_timestamp(PG_FUNCTION_ARGS)
+{
+	Period *p = PG_GETARG_PERIOD(0);
+	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+	PG_RETURN_FLOAT8(period_timestamp_distance_internal(p, t));
+}
+
+PG_FUNCTION_INFO_V1(distance_periodset_timestamp);
+
+PGDLLEXPORT Datum
+distance_periodset_timestamp(PG_FUNCTION_ARGS)
+{
+	PeriodSet *ps = PG_GETARG_PERIODSET(0);
+	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+	double result = periodset_timestamp_distance_internal(ps, t);
+	PG_FREE_IF_COPY(ps, 0);
+	PG_RETURN_FLOAT8(result);
+}
+
 /******************************************************************************/
@@ -28,33 +28,25 @@
 /* 
  * The memory structure of a TimestampSet with, e.g., 3 timestamps is as follows
  *
- *  --------------------------------------------------------------------
- *	( TimestampSet | offset_0 | offset_1 | offset_2 | offset_3 | )_X | ...
  *	--------------------------------------------------------------------
- *	------------------------------------------------------------
- *	( Timestamp_0 | Timestamp_1 | Timestamp_2 | ( bbox )_Y )_X |
- *	------------------------------------------------------------
+ *	( TimestampSet )_X | Timestamp_0 | Timestamp_1 | Timestamp_2 | bbox |
+ *	--------------------------------------------------------------------
+ *
+ * where the X are unused bytes added for double padding and bbox is the
+ * bounding box which is a Period. Since the timestamps have a fixed size,
+ * they are stored in a packed array that can be accessed directly.
  *
- * where the X are unused bytes added for double padding, the Y are unused bytes 
- * added for int4 padding, offset_0 to offset_2 are offsets for the corresponding 
- * timestamps, and offset_3 is the offset for the bounding box.
+ * As for period sets, the values in the first on-disk format, which kept an
+ * array of offsets after the header, do not have the TIME_PACKED flag set
+ * and they are converted to the packed format when they are read.
  */
- 
-/* Pointer to array of offsets of the TimestampSet */
-
-static size_t *
-timestampset_offsets_ptr(TimestampSet *ts)
-{
-	return (size_t *) (((char *)ts) + sizeof(TimestampSet));
-}
 
 /* Pointer to the first timestamp */
 
-static char * 
-timestampset_data_ptr(TimestampSet *ts)
+TimestampTz *
+timestampset_times_ptr(TimestampSet *ts)
 {
-	return (char *)ts + double_pad(sizeof(TimestampSet) + 
-		sizeof(size_t) * (ts->count + 1));
+	return (TimestampTz *) ((char *)ts + double_pad(sizeof(TimestampSet)));
 }
 
 /* N-th TimestampTz of a TimestampSet */
@@ -62,9 +54,7 @@ timestampset_data_ptr(TimestampSet *ts)
 TimestampTz
 timestampset_time_n(TimestampSet *ts, int index)
 {
-	size_t *offsets = timestampset_offsets_ptr(ts);
-	TimestampTz *result = (TimestampTz *) (timestampset_data_ptr(ts) + offsets[index]);
-	return *result;
+	return timestampset_times_ptr(ts)[index];
 }
 
 /* Bounding box of a TimestampSet */
@@ -72,8 +62,7 @@ timestampset_time_n(TimestampSet *ts, int index)
 Period *
 timestampset_bbox(TimestampSet *ts) 
 {
-	size_t *offsets = timestampset_offsets_ptr(ts);
-	return (Period *)(timestampset_data_ptr(ts) + offsets[ts->count]);
+	return (Period *) &timestampset_times_ptr(ts)[ts->count];
 }
 
 /* Construct a TimestampSet from an array of TimestampTz */
@@ -81,7 +70,6 @@ timestampset_bbox(TimestampSet *ts)
 TimestampSet *
 timestampset_from_timestamparr_internal(TimestampTz *times, int count)
 {
-	Period bbox;
 	/* Test the validity of the timestamps */
 	for (int i = 0; i < count - 1; i++)
 	{
@@ -90,27 +78,40 @@ timestampset_from_timestamparr_internal(TimestampTz *times, int count)
 				errmsg("Invalid value for timestamp set")));
 	}
 
-	size_t memsize = double_pad(sizeof(TimestampTz) * count + double_pad(sizeof(Period)));
-	/* Array of pointers containing the pointers to the component timestamps,
-	   and a pointer to the bbox */
-	size_t pdata = double_pad(sizeof(TimestampSet) + (count + 1) * sizeof(size_t));
+	size_t pdata = double_pad(sizeof(TimestampSet));
+	size_t memsize = pdata + sizeof(TimestampTz) * count + sizeof(Period);
 	/* Create the TimestampSet */
-	TimestampSet *result = palloc0(pdata + memsize);
-	SET_VARSIZE(result, pdata + memsize);
+	TimestampSet *result = palloc0(memsize);
+	SET_VARSIZE(result, memsize);
 	result->count = count;
+	result->flags = TIME_PACKED;
 
-	size_t *offsets = timestampset_offsets_ptr(result);
-	size_t pos = 0;	
-	for (int i = 0; i < count; i++)
-	{
-		memcpy(((char *) result) + pdata + pos, &times[i], sizeof(TimestampTz));
-		offsets[i] = pos;
-		pos += sizeof(TimestampTz);
-	}
+	memcpy(timestampset_times_ptr(result), times, sizeof(TimestampTz) * count);
 	/* Precompute the bounding box */
-	period_set(&bbox, times[0], times[count - 1], true, true);
-	offsets[count] = pos;
-	memcpy(((char *) result) + pdata + pos, &bbox, sizeof(Period));
+	period_set(timestampset_bbox(result), times[0], times[count - 1],
+		true, true);
+	return result;
+}
+
+/*
+ * Returns the timestamp set in the packed format, converting the values in
+ * the first on-disk format
+ */
+
+TimestampSet *
+timestampset_packed(TimestampSet *ts)
+{
+	if (ts->flags & TIME_PACKED)
+		return ts;
+	size_t *offsets = (size_t *) (((char *)ts) + sizeof(int32) * 2);
+	char *data = (char *)ts + double_pad(sizeof(int32) * 2 +
+		sizeof(size_t) * (ts->count + 1));
+	TimestampTz *times = palloc(sizeof(TimestampTz) * ts->count);
+	for (int i = 0; i < ts->count; i++)
+		memcpy(&times[i], data + offsets[i], sizeof(TimestampTz));
+	TimestampSet *result = timestampset_from_timestamparr_internal(times,
+		ts->count);
+	pfree(times);
 	return result;
 }
 
@@ -139,27 +140,23 @@ timestampset_copy(TimestampSet *ts)
 bool 
 timestampset_find_timestamp(TimestampSet *ts, TimestampTz t, int *pos) 
 {
+	TimestampTz *times = timestampset_times_ptr(ts);
 	int first = 0;
 	int last = ts->count - 1;
-	int middle = 0; /* make compiler quiet */
 	while (first <= last) 
 	{
-		middle = (first + last)/2;
-		TimestampTz t1 = timestampset_time_n(ts, middle);
-		int cmp = timestamp_cmp_internal(t, t1);
-		if (cmp == 0)
+		int middle = (first + last)/2;
+		if (times[middle] == t)
 		{
 			*pos = middle;
 			return true;
 		}
-		if (cmp < 0)
+		if (t < times[middle])
 			last = middle - 1;
 		else
 			first = middle + 1;
 	}
-	if (middle == ts->count)
-		middle++;
-	*pos = middle;
+	*pos = first;
 	return false;
 }
 
@@ -499,6 +496,42 @@ timestampset_cmp(PG_FUNCTION_ARGS)
 	PG_RETURN_INT32(cmp);
 }
 
+/* Sortsupport comparator, which avoids the function call overhead */
+static int
+timestampset_fastcmp(Datum x, Datum y, SortSupport ssup)
+{
+	TimestampSet *ts1 = DatumGetTimestampSet(x);
+	TimestampSet *ts2 = DatumGetTimestampSet(y);
+	int cmp = timestampset_cmp_internal(ts1, ts2);
+	if ((Pointer) ts1 != DatumGetPointer(x))
+		pfree(ts1);
+	if ((Pointer) ts2 != DatumGetPointer(y))
+		pfree(ts2);
+	return cmp;
+}
+
+/* The abbreviated key is the first timestamp */
+static Datum
+timestampset_abbrev_convert(Datum original, SortSupport ssup)
+{
+	TimestampSet *ts = DatumGetTimestampSet(original);
+	Datum result = timestamp_abbrev_key(timestampset_time_n(ts, 0));
+	if ((Pointer) ts != DatumGetPointer(original))
+		pfree(ts);
+	return result;
+}
+
+PG_FUNCTION_INFO_V1(timestampset_sortsupport);
+
+PGDLLEXPORT Datum
+timestampset_sortsupport(PG_FUNCTION_ARGS)
+{
+	SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+	ssup->comparator = timestampset_fastcmp;
+	sortsupport_set_abbrev(ssup, timestampset_abbrev_convert);
+	PG_RETURN_VOID();
+}
+
 /* 
  * Equality operator
  * The internal B-tree comparator is not used to increase efficiency 
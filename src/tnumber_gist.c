@@ -19,8 +19,13 @@
 
 #include "temporal.h"
 #include "oidcache.h"
+#include "period.h"
+#include "timeops.h"
+#include "tbox.h"
 #include "temporal_boxops.h"
 #include "temporal_posops.h"
+#include "temporal_stats.h"
+#include "temporal_util.h"
 
 /* Minimum accepted ratio of split */
 #define LIMIT_RATIO 0.3
@@ -231,7 +236,8 @@ typedef struct
 typedef struct
 {
 	int			entriesCount;	/* total number of entries being split */
-	TBOX		boundingBox;	/* minimum bounding box across all entries */
+	double		extent[2];		/* width of the minimum bounding box across
+								 * all entries along each axis */
 
 	/* Information about currently selected split follows */
 
@@ -256,6 +262,64 @@ typedef struct
 				upper;
 } SplitInterval;
 
+/*
+ * Bounds of the boxes of the entries being split, stored by axis so that
+ * the loops over the entries read contiguous arrays of doubles, which the
+ * compiler can vectorize, instead of dereferencing each key for each axis
+ */
+typedef struct
+{
+	int			count;
+	double	   *lower[2];		/* lower bounds along the value and time axes */
+	double	   *upper[2];		/* upper bounds along the same axes */
+} SplitBoxes;
+
+static void
+split_boxes_make(SplitBoxes *boxes, GistEntryVector *entryvec, int nentries)
+{
+	boxes->count = nentries;
+	for (int dim = 0; dim < 2; dim++)
+	{
+		boxes->lower[dim] = palloc(sizeof(double) * nentries);
+		boxes->upper[dim] = palloc(sizeof(double) * nentries);
+	}
+	for (int i = 0; i < nentries; i++)
+	{
+		TBOX *box = DatumGetTboxP(entryvec->vector[i + FirstOffsetNumber].key);
+		boxes->lower[0][i] = box->xmin;
+		boxes->upper[0][i] = box->xmax;
+		boxes->lower[1][i] = (double) box->tmin;
+		boxes->upper[1][i] = (double) box->tmax;
+	}
+}
+
+static void
+split_boxes_free(SplitBoxes *boxes)
+{
+	for (int dim = 0; dim < 2; dim++)
+	{
+		pfree(boxes->lower[dim]);
+		pfree(boxes->upper[dim]);
+	}
+}
+
+/* Width of the bounding box of all the entries along an axis */
+
+static double
+split_boxes_extent(const SplitBoxes *boxes, int dim)
+{
+	const double *lower = boxes->lower[dim];
+	const double *upper = boxes->upper[dim];
+	double		min = lower[0],
+				max = upper[0];
+	for (int i = 1; i < boxes->count; i++)
+	{
+		min = Min(min, lower[i]);
+		max = Max(max, upper[i]);
+	}
+	return max - min;
+}
+
 /*
  * Interval comparison function by lower bound of the interval;
  */
@@ -340,10 +404,7 @@ g_tbox_consider_split(ConsiderSplitContext *context, int dimNum,
 		 * overlaps. We switch dimension if find less overlap (non-negative)
 		 * or less range with same overlap.
 		 */
-		if (dimNum == 0)
-			range = context->boundingBox.xmax - context->boundingBox.xmin;
-		else
-			range = (double) (context->boundingBox.tmax - context->boundingBox.tmin);
+		range = context->extent[dimNum];
 
 		overlap = (float4) ((leftUpper - rightLower) / range);
 
@@ -461,6 +522,7 @@ gist_tbox_picksplit(PG_FUNCTION_ARGS)
 				commonEntriesCount;
 	SplitInterval *intervalsLower,
 			   *intervalsUpper;
+	SplitBoxes	boxes;
 	CommonEntry *commonEntries;
 	int			nentries;
 
@@ -474,16 +536,12 @@ gist_tbox_picksplit(PG_FUNCTION_ARGS)
 	intervalsUpper = (SplitInterval *) palloc(nentries * sizeof(SplitInterval));
 
 	/*
-	 * Calculate the overall minimum bounding box over all the entries.
+	 * Collect the bounds of the entries by axis and calculate the overall
+	 * minimum bounding box over all the entries.
 	 */
-	for (i = FirstOffsetNumber; i <= maxoff; i = OffsetNumberNext(i))
-	{
-		box = DatumGetTboxP(entryvec->vector[i].key);
-		if (i == FirstOffsetNumber)
-			context.boundingBox = *box;
-		else
-			adjustBox(&context.boundingBox, box);
-	}
+	split_boxes_make(&boxes, entryvec, nentries);
+	for (dim = 0; dim < 2; dim++)
+		context.extent[dim] = split_boxes_extent(&boxes, dim);
 
 	/*
 	 * Iterate over axes for optimal split searching.
@@ -497,19 +555,10 @@ gist_tbox_picksplit(PG_FUNCTION_ARGS)
 					i2;
 
 		/* Project each entry as an interval on the selected axis. */
-		for (i = FirstOffsetNumber; i <= maxoff; i = OffsetNumberNext(i))
+		for (i1 = 0; i1 < nentries; i1++)
 		{
-			box = DatumGetTboxP(entryvec->vector[i].key);
-			if (dim == 0)
-			{
-				intervalsLower[i - FirstOffsetNumber].lower = box->xmin;
-				intervalsLower[i - FirstOffsetNumber].upper = box->xmax;
-			}
-			else
-			{
-				intervalsLower[i - FirstOffsetNumber].lower = box->tmin;
-				intervalsLower[i - FirstOffsetNumber].upper = box->tmax;
-			}
+			intervalsLower[i1].lower = boxes.lower[dim][i1];
+			intervalsLower[i1].upper = boxes.upper[dim][i1];
 		}
 
 		/*
@@ -634,6 +683,7 @@ gist_tbox_picksplit(PG_FUNCTION_ARGS)
 	 */
 	if (context.first)
 	{
+		split_boxes_free(&boxes);
 		tbox_fallbackSplit(entryvec, v);
 		PG_RETURN_POINTER(v);
 	}
@@ -695,16 +745,8 @@ gist_tbox_picksplit(PG_FUNCTION_ARGS)
 		 * Get upper and lower bounds along selected axis.
 		 */
 		box = DatumGetTboxP(entryvec->vector[i].key);
-		if (context.dim == 0)
-		{
-			lower = box->xmin;
-			upper = box->xmax;
-		}
-		else
-		{
-			lower = box->tmin;
-			upper = box->tmax;
-		}
+		lower = boxes.lower[context.dim][i - FirstOffsetNumber];
+		upper = boxes.upper[context.dim][i - FirstOffsetNumber];
 
 		if (FLOAT8_LE(upper, context.leftUpper))
 		{
@@ -788,6 +830,7 @@ gist_tbox_picksplit(PG_FUNCTION_ARGS)
 		}
 	}
 
+	split_boxes_free(&boxes);
 	v->spl_ldatum = PointerGetDatum(leftBox);
 	v->spl_rdatum = PointerGetDatum(rightBox);
 	PG_RETURN_POINTER(v);
@@ -922,69 +965,78 @@ gist_internal_consistent_tbox(TBOX *key, TBOX *query, StrategyNumber strategy)
  * GiST consistent method for temporal numbers
  *****************************************************************************/
 
-PG_FUNCTION_INFO_V1(gist_tnumber_consistent);
-
-PGDLLEXPORT Datum
-gist_tnumber_consistent(PG_FUNCTION_ARGS)
+/*
+ * Transform the query argument of a consistent function into a box setting 
+ * which are the dimensions that must be taken into account by the operators.
+ * Returns false if the query is empty.
+ */
+static bool
+gist_tnumber_query(FunctionCallInfo fcinfo, TBOX *query)
 {
-	GISTENTRY  *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
 	StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
 	Oid subtype = PG_GETARG_OID(3);
-	bool *recheck = (bool *) PG_GETARG_POINTER(4), result;
-	TBOX *key = DatumGetTboxP(entry->key), query;
-	
-	/* 
-	 * All tests are lossy since boxes do not distinghish between inclusive  
-	 * and exclusive bounds. 
-	 */
-	*recheck = true;
-	
-	if (key == NULL)
-		PG_RETURN_BOOL(false);
-	
-	/*
-	 * Transform the query into a box setting which are the dimensions that
-	 * must be taken into account by the operators.
-	 */
 	if (subtype == type_oid(T_INTRANGE))
 	{
 		RangeType *range = PG_GETARG_RANGE_P(1);
 		if (range == NULL)
-			PG_RETURN_BOOL(false);
-		intrange_to_tbox_internal(&query, range);
+			return false;
+		intrange_to_tbox_internal(query, range);
 		PG_FREE_IF_COPY(range, 1);
 	}
 	else if (subtype == type_oid(T_FLOATRANGE))
 	{
 		RangeType *range = PG_GETARG_RANGE_P(1);
 		if (range == NULL)
-			PG_RETURN_BOOL(false);
-		floatrange_to_tbox_internal(&query, range);
+			return false;
+		floatrange_to_tbox_internal(query, range);
 		PG_FREE_IF_COPY(range, 1);
 	}
 	else if (subtype == type_oid(T_TBOX))
 	{
 		TBOX *box = PG_GETARG_TBOX_P(1);
 		if (box == NULL)
-			PG_RETURN_BOOL(false);
-		query = *box;
+			return false;
+		*query = *box;
 	}
 	else if (temporal_type_oid(subtype))
 	{
 		Temporal *temp = PG_GETARG_TEMPORAL(1);
 		if (temp == NULL)
-			PG_RETURN_BOOL(false);
-		temporal_bbox(&query, temp);
+			return false;
+		temporal_bbox(query, temp);
 		PG_FREE_IF_COPY(temp, 1);
 	}
 	else
 		elog(ERROR, "unrecognized strategy number: %d", strategy);
+	return true;
+}
+
+PG_FUNCTION_INFO_V1(gist_tnumber_consistent);
+
+PGDLLEXPORT Datum
+gist_tnumber_consistent(PG_FUNCTION_ARGS)
+{
+	GISTENTRY  *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+	bool *recheck = (bool *) PG_GETARG_POINTER(4), result;
+	TBOX *key = DatumGetTboxP(entry->key), query;
+	
+	/* 
+	 * All tests are lossy since boxes do not distinghish between inclusive  
+	 * and exclusive bounds. 
+	 */
+	*recheck = true;
+	
+	if (key == NULL || !gist_tnumber_query(fcinfo, &query))
+		PG_RETURN_BOOL(false);
 	
 	if (GIST_LEAF(entry))
 		result = index_leaf_consistent_tbox(key, &query, strategy);
 	else
 		result = gist_internal_consistent_tbox(key, &query, strategy);
 	
+	MOBDB_STAT_INDEX(STAT_GIST_TNUMBER, strategy, GIST_LEAF(entry), result,
+		*recheck);
 	PG_RETURN_BOOL(result);	
 }
 
@@ -1037,4 +1089,221 @@ gist_tbox_same(PG_FUNCTION_ARGS)
 	PG_RETURN_POINTER(result);
 }
 
+/*****************************************************************************
+ * Distance method
+ *****************************************************************************/
+
+/*
+ * The GiST distance method for the distance operator <-> between a temporal
+ * number and a timestamp. The distances of the leaf keys are lower bounds
+ * and must be rechecked.
+ */
+PG_FUNCTION_INFO_V1(gist_tnumber_distance);
+
+PGDLLEXPORT Datum
+gist_tnumber_distance(PG_FUNCTION_ARGS)
+{
+	GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+	bool *recheck = (bool *) PG_GETARG_POINTER(4);
+	TBOX *key = (TBOX *) DatumGetPointer(entry->key);
+
+	if (GIST_LEAF(entry))
+		*recheck = true;
+
+	if (key == NULL || ! MOBDB_FLAGS_GET_T(key->flags))
+		PG_RETURN_FLOAT8(get_float8_infinity());
+
+	Period p;
+	period_set(&p, key->tmin, key->tmax, true, true);
+	PG_RETURN_FLOAT8(period_timestamp_distance_internal(&p, t));
+}
+
+/*****************************************************************************
+ * GiST methods for compact keys
+ * The keys of the gist_tint_compact_ops and gist_tfloat_compact_ops operator
+ * classes are TBOXF values, which store the value bounds in float4 rounded
+ * outwards and the time span in seconds rounded up. The keys are expanded 
+ * into TBOX values by the decompress method so that the other methods are 
+ * shared with the default operator classes.
+ *****************************************************************************/
+
+static void
+tbox_to_tboxf(TBOXF *result, const TBOX *box)
+{
+	memset(result, 0, sizeof(TBOXF));
+	result->flags = box->flags;
+	if (MOBDB_FLAGS_GET_X(box->flags))
+	{
+		result->xmin = float4_round_down(box->xmin);
+		result->xmax = float4_round_up(box->xmax);
+	}
+	if (MOBDB_FLAGS_GET_T(box->flags))
+	{
+		result->tmin = box->tmin;
+		result->tspan = timestamp_span_seconds(box->tmin, box->tmax);
+	}
+}
+
+static void
+tboxf_to_tbox(TBOX *result, const TBOXF *box)
+{
+	memset(result, 0, sizeof(TBOX));
+	result->flags = box->flags;
+	result->xmin = box->xmin;
+	result->xmax = box->xmax;
+	if (MOBDB_FLAGS_GET_T(box->flags))
+	{
+		result->tmin = box->tmin;
+		result->tmax = timestamp_span_upper(box->tmin, box->tspan);
+	}
+}
+
+/*
+ * Although tboxf is an internal type, the output function is implemented 
+ * for debugging purposes.
+ */
+PG_FUNCTION_INFO_V1(tboxf_in);
+
+PGDLLEXPORT Datum
+tboxf_in(PG_FUNCTION_ARGS)
+{
+	ereport(ERROR,(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+		errmsg("function tboxf_in not implemented")));
+	PG_RETURN_POINTER(NULL);
+}
+
+PG_FUNCTION_INFO_V1(tboxf_out);
+
+PGDLLEXPORT Datum
+tboxf_out(PG_FUNCTION_ARGS)
+{
+	TBOXF *key = (TBOXF *) PG_GETARG_POINTER(0);
+	TBOX box;
+	tboxf_to_tbox(&box, key);
+	return DirectFunctionCall1(tbox_out, PointerGetDatum(&box));
+}
+
+/*
+ * Since the keys are larger than the original boxes, the tests on the leaf 
+ * pages are those of the internal pages
+ */
+PG_FUNCTION_INFO_V1(gist_tnumber_compact_consistent);
+
+PGDLLEXPORT Datum
+gist_tnumber_compact_consistent(PG_FUNCTION_ARGS)
+{
+	GISTENTRY  *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+	bool *recheck = (bool *) PG_GETARG_POINTER(4);
+	TBOX *key = DatumGetTboxP(entry->key), query;
+	
+	*recheck = true;
+	
+	if (key == NULL || !gist_tnumber_query(fcinfo, &query))
+		PG_RETURN_BOOL(false);
+	
+	PG_RETURN_BOOL(gist_internal_consistent_tbox(key, &query, strategy));
+}
+
+/*
+ * Both the leaf keys and the union keys computed by the other methods are
+ * compressed
+ */
+PG_FUNCTION_INFO_V1(gist_tnumber_compact_compress);
+
+PGDLLEXPORT Datum
+gist_tnumber_compact_compress(PG_FUNCTION_ARGS)
+{
+	GISTENTRY  *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+	TBOXF *key = palloc(sizeof(TBOXF));
+	if (entry->leafkey)
+	{
+		Temporal *temp = DatumGetTemporal(entry->key);
+		TBOX box;
+		memset(&box, 0, sizeof(TBOX));
+		temporal_bbox(&box, temp);
+		tbox_to_tboxf(key, &box);
+	}
+	else
+		tbox_to_tboxf(key, DatumGetTboxP(entry->key));
+	gistentryinit(*retval, PointerGetDatum(key),
+		entry->rel, entry->page, entry->offset, false);
+	PG_RETURN_POINTER(retval);
+}
+
+PG_FUNCTION_INFO_V1(gist_tnumber_compact_decompress);
+
+PGDLLEXPORT Datum
+gist_tnumber_compact_decompress(PG_FUNCTION_ARGS)
+{
+	GISTENTRY  *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+	TBOX *box = palloc(sizeof(TBOX));
+	tboxf_to_tbox(box, (TBOXF *) DatumGetPointer(entry->key));
+	gistentryinit(*retval, PointerGetDatum(box),
+		entry->rel, entry->page, entry->offset, false);
+	PG_RETURN_POINTER(retval);
+}
+
+/*****************************************************************************
+ * Sort key for building GiST indexes
+ * PostgreSQL 11 cannot build GiST indexes from sorted input. Sorting the 
+ * table on the key below before building the index, e.g., with
+ *   CREATE TABLE sorted AS SELECT * FROM tbl 
+ *   ORDER BY zorder(temp, estimatedTBox('tbl', 'temp'));
+ * makes consecutive insertions fall into the same pages, which reduces the
+ * time of the build and the overlap of the resulting pages.
+ *****************************************************************************/
+
+/*
+ * Returns the position of the center of the box on a Z-order curve over 
+ * the value and time dimensions of the extent
+ */
+static int64
+tbox_zorder_internal(const TBOX *box, const TBOX *extent)
+{
+	double values[2], mins[2], maxs[2];
+	int ndims = 0;
+	if (MOBDB_FLAGS_GET_X(box->flags) && MOBDB_FLAGS_GET_X(extent->flags))
+	{
+		values[ndims] = box->xmin / 2 + box->xmax / 2;
+		mins[ndims] = extent->xmin;
+		maxs[ndims++] = extent->xmax;
+	}
+	if (MOBDB_FLAGS_GET_T(box->flags) && MOBDB_FLAGS_GET_T(extent->flags))
+	{
+		values[ndims] = (double) box->tmin / 2 + (double) box->tmax / 2;
+		mins[ndims] = (double) extent->tmin;
+		maxs[ndims++] = (double) extent->tmax;
+	}
+	return zorder_key(values, mins, maxs, ndims);
+}
+
+PG_FUNCTION_INFO_V1(tbox_zorder);
+
+PGDLLEXPORT Datum
+tbox_zorder(PG_FUNCTION_ARGS)
+{
+	TBOX *box = PG_GETARG_TBOX_P(0);
+	TBOX *extent = PG_GETARG_TBOX_P(1);
+	PG_RETURN_INT64(tbox_zorder_internal(box, extent));
+}
+
+PG_FUNCTION_INFO_V1(tnumber_zorder);
+
+PGDLLEXPORT Datum
+tnumber_zorder(PG_FUNCTION_ARGS)
+{
+	Temporal *temp = PG_GETARG_TEMPORAL(0);
+	TBOX *extent = PG_GETARG_TBOX_P(1);
+	TBOX box;
+	memset(&box, 0, sizeof(TBOX));
+	temporal_bbox(&box, temp);
+	int64 result = tbox_zorder_internal(&box, extent);
+	PG_FREE_IF_COPY(temp, 0);
+	PG_RETURN_INT64(result);
+}
+
 /*****************************************************************************/
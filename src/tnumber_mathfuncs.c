@@ -15,6 +15,7 @@
 
 #include <math.h>
 #include <utils/builtins.h>
+#include <utils/memutils.h>
 
 #include "period.h"
 #include "timeops.h"
@@ -29,72 +30,68 @@
  * function.
  *****************************************************************************/
 
-/* Addition */
+/* Arithmetic operators */
 
-static Datum
-datum_add(Datum l, Datum r, Oid typel, Oid typer)
+typedef enum
 {
-	Datum result = 0;
-	if (typel == INT4OID && typer == INT4OID)
-		result = Int32GetDatum(DatumGetInt32(l) + DatumGetInt32(r));
-	else if (typel == INT4OID && typer == FLOAT8OID)
-		result = Float8GetDatum(DatumGetInt32(l) + DatumGetFloat8(r));
-	else if (typel == FLOAT8OID && typer == INT4OID)
-		result = Float8GetDatum(DatumGetFloat8(l) + DatumGetInt32(r));
-	else if (typel == FLOAT8OID && typer == FLOAT8OID)
-		result = Float8GetDatum(DatumGetFloat8(l) + DatumGetFloat8(r));
-	return result;
+	ARITH_ADD,
+	ARITH_SUB,
+	ARITH_MULT,
+	ARITH_DIV
+} TArithmetic;
+
+/*
+ * Arithmetic functions specialized for each combination of base types of
+ * the arguments. The function to apply is selected once per call with
+ * datum_arith so that the base types are not tested for every instant.
+ */
+
+#define DATUM_ARITH(name, op) \
+static Datum \
+name##_int4_int4(Datum l, Datum r, Oid typel, Oid typer) \
+{ \
+	return Int32GetDatum(DatumGetInt32(l) op DatumGetInt32(r)); \
+} \
+static Datum \
+name##_int4_float8(Datum l, Datum r, Oid typel, Oid typer) \
+{ \
+	return Float8GetDatum(DatumGetInt32(l) op DatumGetFloat8(r)); \
+} \
+static Datum \
+name##_float8_int4(Datum l, Datum r, Oid typel, Oid typer) \
+{ \
+	return Float8GetDatum(DatumGetFloat8(l) op DatumGetInt32(r)); \
+} \
+static Datum \
+name##_float8_float8(Datum l, Datum r, Oid typel, Oid typer) \
+{ \
+	return Float8GetDatum(DatumGetFloat8(l) op DatumGetFloat8(r)); \
 }
 
-/* Subtraction */
-
-static Datum
-datum_sub(Datum l, Datum r, Oid typel, Oid typer)
-{
-	Datum result = 0;
-	if (typel == INT4OID && typer == INT4OID)
-		result = Int32GetDatum(DatumGetInt32(l) - DatumGetInt32(r));
-	else if (typel == INT4OID && typer == FLOAT8OID)
-		result = Float8GetDatum(DatumGetInt32(l) - DatumGetFloat8(r));
-	else if (typel == FLOAT8OID && typer == INT4OID)
-		result = Float8GetDatum(DatumGetFloat8(l) - DatumGetInt32(r));
-	else if (typel == FLOAT8OID && typer == FLOAT8OID)
-		result = Float8GetDatum(DatumGetFloat8(l) - DatumGetFloat8(r));
-	return result;
-}
+DATUM_ARITH(datum_add, +)
+DATUM_ARITH(datum_sub, -)
+DATUM_ARITH(datum_mult, *)
+DATUM_ARITH(datum_div, /)
 
-/* Multiplication */
+typedef Datum (*datum_arith_func)(Datum, Datum, Oid, Oid);
 
-static Datum
-datum_mult(Datum l, Datum r, Oid typel, Oid typer)
+/* Indexed by operator and whether the left and right types are float8 */
+static const datum_arith_func datum_arith_funcs[4][2][2] =
 {
-	Datum result = 0;
-	if (typel == INT4OID && typer == INT4OID)
-		result = Int32GetDatum(DatumGetInt32(l) * DatumGetInt32(r));
-	else if (typel == INT4OID && typer == FLOAT8OID)
-		result = Float8GetDatum(DatumGetInt32(l) * DatumGetFloat8(r));
-	else if (typel == FLOAT8OID && typer == INT4OID)
-		result = Float8GetDatum(DatumGetFloat8(l) * DatumGetInt32(r));
-	else if (typel == FLOAT8OID && typer == FLOAT8OID)
-		result = Float8GetDatum(DatumGetFloat8(l) * DatumGetFloat8(r));
-	return result;
-}
-
-/* Division */
-
-static Datum
-datum_div(Datum l, Datum r, Oid typel, Oid typer)
+	{{&datum_add_int4_int4, &datum_add_int4_float8},
+	 {&datum_add_float8_int4, &datum_add_float8_float8}},
+	{{&datum_sub_int4_int4, &datum_sub_int4_float8},
+	 {&datum_sub_float8_int4, &datum_sub_float8_float8}},
+	{{&datum_mult_int4_int4, &datum_mult_int4_float8},
+	 {&datum_mult_float8_int4, &datum_mult_float8_float8}},
+	{{&datum_div_int4_int4, &datum_div_int4_float8},
+	 {&datum_div_float8_int4, &datum_div_float8_float8}}
+};
+
+static datum_arith_func
+datum_arith(TArithmetic op, Oid typel, Oid typer)
 {
-	Datum result = 0;
-	if (typel == INT4OID && typer == INT4OID)
-		result = Int32GetDatum(DatumGetInt32(l) / DatumGetInt32(r));
-	else if (typel == INT4OID && typer == FLOAT8OID)
-		result = Float8GetDatum(DatumGetInt32(l) / DatumGetFloat8(r));
-	else if (typel == FLOAT8OID && typer == INT4OID)
-		result = Float8GetDatum(DatumGetFloat8(l) / DatumGetInt32(r));
-	else if (typel == FLOAT8OID && typer == FLOAT8OID)
-		result = Float8GetDatum(DatumGetFloat8(l) / DatumGetFloat8(r));
-	return result;
+	return datum_arith_funcs[op][typel == FLOAT8OID][typer == FLOAT8OID];
 }
 
 /* Round to n decimal places */
@@ -152,6 +149,94 @@ tnumberseq_mult_maxmin_at_timestamp(TemporalInst *start1, TemporalInst *end1,
 	return true;	
 }
 
+/*****************************************************************************
+ * Arithmetic operators between a temporal float sequence (set) and a number.
+ * The values of the sequences are extracted into an array of doubles and
+ * the operator is applied in a loop without function calls that can be
+ * vectorized by the compiler.
+ *****************************************************************************/
+
+#define TFLOAT_ARITH_LOOP(expr) \
+	for (int i = 0; i < count; i++) \
+		values[i] = (expr)
+
+static TemporalSeq *
+tfloatseq_arith_base(TemporalSeq *seq, double d, TArithmetic op, bool invert)
+{
+	int count = seq->count;
+	double *values = tnumberseq_values_double(seq);
+	if (op == ARITH_ADD)
+		TFLOAT_ARITH_LOOP(values[i] + d);
+	else if (op == ARITH_SUB)
+	{
+		if (invert)
+			TFLOAT_ARITH_LOOP(d - values[i]);
+		else
+			TFLOAT_ARITH_LOOP(values[i] - d);
+	}
+	else if (op == ARITH_MULT)
+		TFLOAT_ARITH_LOOP(values[i] * d);
+	else /* op == ARITH_DIV */
+	{
+		if (invert)
+			TFLOAT_ARITH_LOOP(d / values[i]);
+		else
+			TFLOAT_ARITH_LOOP(values[i] / d);
+	}
+
+	MemoryContext arena = temporal_arena_create();
+	MemoryContext oldctx = MemoryContextSwitchTo(arena);
+	TemporalInst **instants = palloc(sizeof(TemporalInst *) * count);
+	for (int i = 0; i < count; i++)
+		instants[i] = temporalinst_make(Float8GetDatum(values[i]),
+			temporalseq_inst_n(seq, i)->t, FLOAT8OID);
+	MemoryContextSwitchTo(oldctx);
+	TemporalSeq *result = temporalseq_from_temporalinstarr(instants, count,
+		seq->period.lower_inc, seq->period.upper_inc,
+		MOBDB_FLAGS_GET_LINEAR(seq->flags), true);
+	temporal_arena_delete(arena);
+	pfree(values);
+	return result;
+}
+
+static TemporalS *
+tfloats_arith_base(TemporalS *ts, double d, TArithmetic op, bool invert)
+{
+	TemporalSeq **sequences = palloc(sizeof(TemporalSeq *) * ts->count);
+	for (int i = 0; i < ts->count; i++)
+		sequences[i] = tfloatseq_arith_base(temporals_seq_n(ts, i), d, 
+			op, invert);
+	TemporalS *result = temporals_from_temporalseqarr(sequences, ts->count,
+		MOBDB_FLAGS_GET_LINEAR(ts->flags), true);
+	for (int i = 0; i < ts->count; i++)
+		pfree(sequences[i]);
+	pfree(sequences);
+	return result;
+}
+
+/* Apply an arithmetic operator between a temporal number and a number */
+
+static Temporal *
+tnumber_arith_base(Temporal *temp, Datum value, TArithmetic op, 
+	Oid datumtypid, Oid valuetypid, bool invert)
+{
+	if (temp->valuetypid == FLOAT8OID && valuetypid == FLOAT8OID)
+	{
+		double d = datum_double(value, datumtypid);
+		if (temp->duration == TEMPORALSEQ)
+			return (Temporal *)tfloatseq_arith_base((TemporalSeq *)temp, d, 
+				op, invert);
+		if (temp->duration == TEMPORALS)
+			return (Temporal *)tfloats_arith_base((TemporalS *)temp, d, 
+				op, invert);
+	}
+	datum_arith_func func = invert ?
+		datum_arith(op, datumtypid, temp->valuetypid) :
+		datum_arith(op, temp->valuetypid, datumtypid);
+	return tfunc4_temporal_base(temp, value, func, datumtypid, valuetypid, 
+		invert);
+}
+
 /*****************************************************************************
  * Temporal addition
  *****************************************************************************/
@@ -172,13 +257,13 @@ add_base_temporal(PG_FUNCTION_ARGS)
 	ensure_numeric_base_type(datumtypid);
 	if (temp->valuetypid == datumtypid || temp->duration == TEMPORALINST || 
 		temp->duration == TEMPORALI)
- 		result = tfunc4_temporal_base(temp, value, 
-		 	&datum_add, datumtypid, valuetypid, true);
+ 		result = tnumber_arith_base(temp, value, ARITH_ADD,
+			datumtypid, valuetypid, true);
 	else if (datumtypid == FLOAT8OID && temp->valuetypid == INT4OID)
 	{
 		Temporal *ftemp = tint_to_tfloat_internal(temp);
-		result = tfunc4_temporal_base(ftemp, value, 
-		 	&datum_add, FLOAT8OID, FLOAT8OID, true);
+		result = tnumber_arith_base(ftemp, value, ARITH_ADD,
+			FLOAT8OID, FLOAT8OID, true);
 		pfree(ftemp);
 	}
 	PG_FREE_IF_COPY(temp, 1);
@@ -202,13 +287,13 @@ add_temporal_base(PG_FUNCTION_ARGS)
 	ensure_numeric_base_type(datumtypid);
 	if (temp->valuetypid == datumtypid || temp->duration == TEMPORALINST || 
 		temp->duration == TEMPORALI)
- 		result = tfunc4_temporal_base(temp, value,
-		 	&datum_add, datumtypid, valuetypid, false);
+ 		result = tnumber_arith_base(temp, value, ARITH_ADD,
+			datumtypid, valuetypid, false);
 	else if (datumtypid == FLOAT8OID && temp->valuetypid == INT4OID)
 	{
 		Temporal *ftemp = tint_to_tfloat_internal(temp);
-		result = tfunc4_temporal_base(ftemp, value,
-		 	&datum_add, FLOAT8OID, FLOAT8OID, false);
+		result = tnumber_arith_base(ftemp, value, ARITH_ADD,
+			FLOAT8OID, FLOAT8OID, false);
 		pfree(ftemp);
 	}
 	PG_FREE_IF_COPY(temp, 0);
@@ -242,20 +327,23 @@ add_temporal_temporal(PG_FUNCTION_ARGS)
 	{
 		Oid temptypid = get_fn_expr_rettype(fcinfo->flinfo);
 		Oid valuetypid = base_oid_from_temporal(temptypid);
- 		result = sync_tfunc4_temporal_temporal(temp1, temp2, &datum_add,
+ 		result = sync_tfunc4_temporal_temporal(temp1, temp2,
+		 	datum_arith(ARITH_ADD, temp1->valuetypid, temp2->valuetypid),
 		 	valuetypid, linear, NULL);
 	}
 	else if (temp1->valuetypid == INT4OID && temp2->valuetypid == FLOAT8OID)
 	{
 		Temporal *ftemp1 = tint_to_tfloat_internal(temp1);
-		result = sync_tfunc4_temporal_temporal(ftemp1, temp2, &datum_add,
+		result = sync_tfunc4_temporal_temporal(ftemp1, temp2,
+		 	datum_arith(ARITH_ADD, ftemp1->valuetypid, temp2->valuetypid),
 		 	FLOAT8OID, linear, NULL);
 		pfree(ftemp1);
 	}
 	else if (temp1->valuetypid == FLOAT8OID && temp2->valuetypid == INT4OID)
 	{
 		Temporal *ftemp2 = tint_to_tfloat_internal(temp2);
-		result = sync_tfunc4_temporal_temporal(temp1, ftemp2, &datum_add,
+		result = sync_tfunc4_temporal_temporal(temp1, ftemp2,
+		 	datum_arith(ARITH_ADD, temp1->valuetypid, ftemp2->valuetypid),
 		 	FLOAT8OID, linear, NULL);
 		pfree(ftemp2);
 	}
@@ -286,13 +374,13 @@ sub_base_temporal(PG_FUNCTION_ARGS)
 	ensure_numeric_base_type(datumtypid);
 	if (temp->valuetypid == datumtypid || temp->duration == TEMPORALINST || 
 		temp->duration == TEMPORALI)
- 		result = tfunc4_temporal_base(temp, value,
-		 	&datum_sub, datumtypid, valuetypid, true);
+ 		result = tnumber_arith_base(temp, value, ARITH_SUB,
+			datumtypid, valuetypid, true);
 	else if (datumtypid == FLOAT8OID && temp->valuetypid == INT4OID)
 	{
 		Temporal *ftemp = tint_to_tfloat_internal(temp);
-		result = tfunc4_temporal_base(ftemp, value,
-		 	&datum_sub, FLOAT8OID, FLOAT8OID, true);
+		result = tnumber_arith_base(ftemp, value, ARITH_SUB,
+			FLOAT8OID, FLOAT8OID, true);
 		pfree(ftemp);
 	}
 	PG_FREE_IF_COPY(temp, 1);
@@ -315,13 +403,13 @@ sub_temporal_base(PG_FUNCTION_ARGS)
 	ensure_numeric_base_type(datumtypid);
 	if (temp->valuetypid == datumtypid || temp->duration == TEMPORALINST || 
 		temp->duration == TEMPORALI)
- 		result = tfunc4_temporal_base(temp, value,
-		 	&datum_sub, datumtypid, valuetypid, false);
+ 		result = tnumber_arith_base(temp, value, ARITH_SUB,
+			datumtypid, valuetypid, false);
 	else if (datumtypid == FLOAT8OID && temp->valuetypid == INT4OID)
 	{
 		Temporal *ftemp = tint_to_tfloat_internal(temp);
-		result = tfunc4_temporal_base(ftemp, value,
-		 	&datum_add, FLOAT8OID, FLOAT8OID, false);
+		result = tnumber_arith_base(ftemp, value, ARITH_SUB,
+			FLOAT8OID, FLOAT8OID, false);
 		pfree(ftemp);
 	}
 	PG_FREE_IF_COPY(temp, 0);
@@ -355,20 +443,23 @@ sub_temporal_temporal(PG_FUNCTION_ARGS)
 	{
 		Oid temptypid = get_fn_expr_rettype(fcinfo->flinfo);
 		Oid valuetypid = base_oid_from_temporal(temptypid);
- 		result = sync_tfunc4_temporal_temporal(temp1, temp2, &datum_sub,
+ 		result = sync_tfunc4_temporal_temporal(temp1, temp2,
+		 	datum_arith(ARITH_SUB, temp1->valuetypid, temp2->valuetypid),
 		 	valuetypid, linear, NULL);
 	}
 	else if (temp1->valuetypid == INT4OID && temp2->valuetypid == FLOAT8OID)
 	{
 		Temporal *ftemp1 = tint_to_tfloat_internal(temp1);
-		result = sync_tfunc4_temporal_temporal(ftemp1, temp2, &datum_sub,
+		result = sync_tfunc4_temporal_temporal(ftemp1, temp2,
+		 	datum_arith(ARITH_SUB, ftemp1->valuetypid, temp2->valuetypid),
 		 	FLOAT8OID, linear, NULL);
 		pfree(ftemp1);
 	}
 	else if (temp1->valuetypid == FLOAT8OID && temp2->valuetypid == INT4OID)
 	{
 		Temporal *ftemp2 = tint_to_tfloat_internal(temp2);
-		result = sync_tfunc4_temporal_temporal(temp1, ftemp2, &datum_sub,
+		result = sync_tfunc4_temporal_temporal(temp1, ftemp2,
+		 	datum_arith(ARITH_SUB, temp1->valuetypid, ftemp2->valuetypid),
 		 	FLOAT8OID, linear, NULL);
 		pfree(ftemp2);
 	}
@@ -399,13 +490,13 @@ mult_base_temporal(PG_FUNCTION_ARGS)
 	ensure_numeric_base_type(datumtypid);
 	if (temp->valuetypid == datumtypid || temp->duration == TEMPORALINST || 
 		temp->duration == TEMPORALI)
- 		result = tfunc4_temporal_base(temp, value,
-		 	&datum_mult, datumtypid, valuetypid, true);
+ 		result = tnumber_arith_base(temp, value, ARITH_MULT,
+			datumtypid, valuetypid, true);
 	else if (datumtypid == FLOAT8OID && temp->valuetypid == INT4OID)
 	{
 		Temporal *ftemp = tint_to_tfloat_internal(temp);
-		result = tfunc4_temporal_base(ftemp, value,
-		 	&datum_mult, FLOAT8OID, FLOAT8OID, true);
+		result = tnumber_arith_base(ftemp, value, ARITH_MULT,
+			FLOAT8OID, FLOAT8OID, true);
 		pfree(ftemp);
 	}
 	PG_FREE_IF_COPY(temp, 1);
@@ -428,13 +519,13 @@ mult_temporal_base(PG_FUNCTION_ARGS)
 	ensure_numeric_base_type(datumtypid);
 	if (temp->valuetypid == datumtypid || temp->duration == TEMPORALINST || 
 		temp->duration == TEMPORALI)
- 		result = tfunc4_temporal_base(temp, value,
-		 	&datum_mult, datumtypid, valuetypid, false);
+ 		result = tnumber_arith_base(temp, value, ARITH_MULT,
+			datumtypid, valuetypid, false);
 	else if (datumtypid == FLOAT8OID && temp->valuetypid == INT4OID)
 	{
 		Temporal *ftemp = tint_to_tfloat_internal(temp);
-		result = tfunc4_temporal_base(ftemp, value,
-		 	&datum_mult, FLOAT8OID, FLOAT8OID, false);
+		result = tnumber_arith_base(ftemp, value, ARITH_MULT,
+			FLOAT8OID, FLOAT8OID, false);
 		pfree(ftemp);
 	}
 	PG_FREE_IF_COPY(temp, 0);
@@ -469,18 +560,22 @@ mult_temporal_temporal(PG_FUNCTION_ARGS)
 		Oid temptypid = get_fn_expr_rettype(fcinfo->flinfo);
 		Oid valuetypid = base_oid_from_temporal(temptypid);
  		result = linear ?
-			sync_tfunc4_temporal_temporal(temp1, temp2, &datum_mult,
+			sync_tfunc4_temporal_temporal(temp1, temp2,
+		 		datum_arith(ARITH_MULT, temp1->valuetypid, temp2->valuetypid),
 		 		valuetypid, linear, &tnumberseq_mult_maxmin_at_timestamp) :
-			sync_tfunc4_temporal_temporal(temp1, temp2, &datum_mult,
+			sync_tfunc4_temporal_temporal(temp1, temp2,
+		 		datum_arith(ARITH_MULT, temp1->valuetypid, temp2->valuetypid),
 		 		valuetypid, linear, NULL);
 	}
 	else if (temp1->valuetypid == INT4OID && temp2->valuetypid == FLOAT8OID)
 	{
 		Temporal *ftemp1 = tint_to_tfloat_internal(temp1);
 		result =  linear ?
-			sync_tfunc4_temporal_temporal(ftemp1, temp2, &datum_mult,
+			sync_tfunc4_temporal_temporal(ftemp1, temp2,
+		 		datum_arith(ARITH_MULT, ftemp1->valuetypid, temp2->valuetypid),
 		 		FLOAT8OID, linear, &tnumberseq_mult_maxmin_at_timestamp) :
-			sync_tfunc4_temporal_temporal(ftemp1, temp2, &datum_mult,
+			sync_tfunc4_temporal_temporal(ftemp1, temp2,
+		 		datum_arith(ARITH_MULT, ftemp1->valuetypid, temp2->valuetypid),
 		 		FLOAT8OID, linear, NULL);
 		pfree(ftemp1);
 	}
@@ -488,9 +583,11 @@ mult_temporal_temporal(PG_FUNCTION_ARGS)
 	{
 		Temporal *ftemp2 = tint_to_tfloat_internal(temp2);
 		result =  linear ?
-			sync_tfunc4_temporal_temporal(temp1, ftemp2, &datum_mult, 
+			sync_tfunc4_temporal_temporal(temp1, ftemp2,
+		 		datum_arith(ARITH_MULT, temp1->valuetypid, ftemp2->valuetypid),
 		 		FLOAT8OID, linear, &tnumberseq_mult_maxmin_at_timestamp) :
-			sync_tfunc4_temporal_temporal(temp1, ftemp2, &datum_mult, 
+			sync_tfunc4_temporal_temporal(temp1, ftemp2,
+		 		datum_arith(ARITH_MULT, temp1->valuetypid, ftemp2->valuetypid),
 		 		FLOAT8OID, linear, NULL);
 		pfree(ftemp2);
 	}
@@ -526,13 +623,13 @@ div_base_temporal(PG_FUNCTION_ARGS)
 	ensure_numeric_base_type(datumtypid);
 	if (temp->valuetypid == datumtypid || temp->duration == TEMPORALINST || 
 		temp->duration == TEMPORALI)
- 		result = tfunc4_temporal_base(temp, value,
-		 	&datum_div, datumtypid, valuetypid, true);
+ 		result = tnumber_arith_base(temp, value, ARITH_DIV,
+			datumtypid, valuetypid, true);
 	else if (datumtypid == FLOAT8OID && temp->valuetypid == INT4OID)
 	{
 		Temporal *ftemp = tint_to_tfloat_internal(temp);
-		result = tfunc4_temporal_base(ftemp, value,
-		 	&datum_div, FLOAT8OID, FLOAT8OID, true);
+		result = tnumber_arith_base(ftemp, value, ARITH_DIV,
+			FLOAT8OID, FLOAT8OID, true);
 		pfree(ftemp);
 	}
 	PG_FREE_IF_COPY(temp, 1);
@@ -560,13 +657,13 @@ div_temporal_base(PG_FUNCTION_ARGS)
 	ensure_numeric_base_type(datumtypid);
 	if (temp->valuetypid == datumtypid || temp->duration == TEMPORALINST || 
 		temp->duration == TEMPORALI)
- 		result = tfunc4_temporal_base(temp, value,
-		 	&datum_div, datumtypid, valuetypid, false);
+ 		result = tnumber_arith_base(temp, value, ARITH_DIV,
+			datumtypid, valuetypid, false);
 	else if (datumtypid == FLOAT8OID && temp->valuetypid == INT4OID)
 	{
 		Temporal *ftemp = tint_to_tfloat_internal(temp);
-		result = tfunc4_temporal_base(ftemp, value,
-		 	&datum_div, FLOAT8OID, FLOAT8OID, false);
+		result = tnumber_arith_base(ftemp, value, ARITH_DIV,
+			FLOAT8OID, FLOAT8OID, false);
 		pfree(ftemp);
 	}
 	PG_FREE_IF_COPY(temp, 0);
@@ -610,18 +707,22 @@ div_temporal_temporal(PG_FUNCTION_ARGS)
 		Oid temptypid = get_fn_expr_rettype(fcinfo->flinfo);
 		Oid valuetypid = base_oid_from_temporal(temptypid);
  		result = linear ?
-			sync_tfunc4_temporal_temporal(temp1, temp2, &datum_div,
+			sync_tfunc4_temporal_temporal(temp1, temp2,
+		 		datum_arith(ARITH_DIV, temp1->valuetypid, temp2->valuetypid),
 		 		valuetypid, linear, &tnumberseq_mult_maxmin_at_timestamp) :
-			sync_tfunc4_temporal_temporal(temp1, temp2, &datum_div,
+			sync_tfunc4_temporal_temporal(temp1, temp2,
+		 		datum_arith(ARITH_DIV, temp1->valuetypid, temp2->valuetypid),
 		 		valuetypid, linear, NULL);
 	}
 	else if (temp1->valuetypid == INT4OID && temp2->valuetypid == FLOAT8OID)
 	{
 		Temporal *ftemp1 = tint_to_tfloat_internal(temp1);
 		result =  linear ?
-			sync_tfunc4_temporal_temporal(ftemp1, temp2, &datum_div,
+			sync_tfunc4_temporal_temporal(ftemp1, temp2,
+		 		datum_arith(ARITH_DIV, ftemp1->valuetypid, temp2->valuetypid),
 		 		FLOAT8OID, linear, &tnumberseq_mult_maxmin_at_timestamp) :
-			sync_tfunc4_temporal_temporal(ftemp1, temp2, &datum_div,
+			sync_tfunc4_temporal_temporal(ftemp1, temp2,
+		 		datum_arith(ARITH_DIV, ftemp1->valuetypid, temp2->valuetypid),
 		 		FLOAT8OID, linear, NULL);
 		pfree(ftemp1);
 	}
@@ -629,9 +730,11 @@ div_temporal_temporal(PG_FUNCTION_ARGS)
 	{
 		Temporal *ftemp2 = tint_to_tfloat_internal(temp2);
 		result =  linear ?
-			sync_tfunc4_temporal_temporal(temp1, ftemp2, &datum_div,
+			sync_tfunc4_temporal_temporal(temp1, ftemp2,
+		 		datum_arith(ARITH_DIV, temp1->valuetypid, ftemp2->valuetypid),
 		 		FLOAT8OID, linear, &tnumberseq_mult_maxmin_at_timestamp) :
-			sync_tfunc4_temporal_temporal(temp1, ftemp2, &datum_div,
+			sync_tfunc4_temporal_temporal(temp1, ftemp2,
+		 		datum_arith(ARITH_DIV, temp1->valuetypid, ftemp2->valuetypid),
 		 		FLOAT8OID, linear, NULL);
 		pfree(ftemp2);
 	}
@@ -17,6 +17,7 @@
 #include <access/htup_details.h>
 #include <utils/builtins.h>
 #include <utils/selfuncs.h>
+#include <utils/syscache.h>
 #include <temporal_boxops.h>
 
 #include "period.h"
@@ -27,6 +28,7 @@
 #include "temporal.h"
 #include "temporal_analyze.h"
 #include "temporal_selfuncs.h"
+#include "temporal_util.h"
 
 /*****************************************************************************
  * Functions copied from PostgreSQL file rangetypes_selfuncs.c since they 
@@ -618,7 +620,9 @@ calc_hist_selectivity(TypeCacheEntry *typcache, VariableStatData *vardata,
  * Internal functions computing selectivity
  * The functions assume that the value and time dimensions of temporal values 
  * are independent and thus the selectivity values obtained by analyzing the 
- * histograms for each dimension can be multiplied.
+ * histograms for each dimension can be multiplied. For the bounding box
+ * operators on columns of durations distinct from TemporalInst, the product
+ * is corrected with the two-dimensional histogram of both dimensions.
  *****************************************************************************/
 
 /* Transform the constant into a TBOX */
@@ -638,11 +642,11 @@ tnumber_const_to_tbox(const Node *other, TBOX *box)
 	else if (consttype == TIMESTAMPTZOID)
 		timestamp_to_tbox_internal(box, DatumGetTimestampTz(((Const *) other)->constvalue));
 	else if (consttype == type_oid(T_TIMESTAMPSET))
-		timestampset_to_tbox_internal(box, ((TimestampSet *)((Const *) other)->constvalue));
+		timestampset_to_tbox_internal(box, DatumGetTimestampSet(((Const *) other)->constvalue));
 	else if (consttype == type_oid(T_PERIOD))
 		period_to_tbox_internal(box, (Period *) ((Const *) other)->constvalue);
 	else if (consttype == type_oid(T_PERIODSET))
-		periodset_to_tbox_internal(box, ((PeriodSet *)((Const *) other)->constvalue));
+		periodset_to_tbox_internal(box, DatumGetPeriodSet(((Const *) other)->constvalue));
 	else if (consttype == type_oid(T_TBOX))
 		memcpy(box, DatumGetTboxP(((Const *) other)->constvalue), sizeof(TBOX));
 	else if (consttype == type_oid(T_TINT) || consttype == type_oid(T_TFLOAT))
@@ -749,6 +753,91 @@ default_tnumber_selectivity(CachedOp operator)
 	}
 }
 
+/*
+ * Compute the fraction of each bucket of a dimension of the two-dimensional
+ * histogram covered by the extent [min, max] of the constant. If the extent
+ * is a single point, the bucket containing it is entirely covered.
+ */
+static void
+tbox_hist_cover_ratios(const double *edges, int num_bins, double min, 
+	double max, double *ratios)
+{
+	int i;
+	for (i = 0; i < num_bins; i++)
+	{
+		double width = edges[i + 1] - edges[i];
+		if (max <= min || width <= 0.0)
+			ratios[i] = (edges[i] <= max && min <= edges[i + 1]) ? 1.0 : 0.0;
+		else
+			ratios[i] = Max(0.0, Min(max, edges[i + 1]) - Max(min, edges[i])) /
+				width;
+	}
+}
+
+/*
+ * Estimate the correlation between the value and time dimensions of a 
+ * temporal number column with respect to the constant box using the
+ * two-dimensional histogram collected by ANALYZE. The result is the ratio
+ * between the fraction of the histogram covered by the box and the product
+ * of the fractions covered by its projections on each dimension, which is
+ * the factor by which the selectivity obtained assuming that both dimensions
+ * are independent must be corrected. Returns -1 if the column has no such
+ * histogram.
+ */
+static double
+calc_tbox_hist_correlation(VariableStatData *vardata, const TBOX *box)
+{
+	AttStatsSlot sslot;
+	int num_bins, i, j;
+	double *xedges, *tedges, *xratios, *tratios;
+	double joint = 0.0, xfrac = 0.0, tfrac = 0.0, result;
+
+	if (!(HeapTupleIsValid(vardata->statsTuple) &&
+		  get_attstatsslot(&sslot, vardata->statsTuple,
+						   STATISTIC_KIND_TBOX_HISTOGRAM, InvalidOid, 
+						   ATTSTATSSLOT_VALUES | ATTSTATSSLOT_NUMBERS)))
+		return -1.0;
+	num_bins = sslot.nvalues / 2 - 1;
+	if (num_bins < 1 || sslot.nnumbers != num_bins * num_bins)
+	{
+		free_attstatsslot(&sslot);
+		return -1.0;
+	}
+
+	xedges = palloc(sizeof(double) * (num_bins + 1));
+	tedges = palloc(sizeof(double) * (num_bins + 1));
+	for (i = 0; i <= num_bins; i++)
+	{
+		xedges[i] = DatumGetFloat8(sslot.values[i]);
+		tedges[i] = DatumGetFloat8(sslot.values[num_bins + 1 + i]);
+	}
+	xratios = palloc(sizeof(double) * num_bins);
+	tratios = palloc(sizeof(double) * num_bins);
+	tbox_hist_cover_ratios(xedges, num_bins, box->xmin, box->xmax, xratios);
+	tbox_hist_cover_ratios(tedges, num_bins, (double) box->tmin / USECS_PER_SEC,
+		(double) box->tmax / USECS_PER_SEC, tratios);
+
+	/* Sum the covered fractions of the buckets and of their projections */
+	for (i = 0; i < num_bins; i++)
+	{
+		for (j = 0; j < num_bins; j++)
+		{
+			double frac = sslot.numbers[i * num_bins + j];
+			joint += frac * xratios[i] * tratios[j];
+			xfrac += frac * xratios[i];
+			tfrac += frac * tratios[j];
+		}
+	}
+	free_attstatsslot(&sslot);
+	pfree(xedges); pfree(tedges); pfree(xratios); pfree(tratios);
+
+	/* Assume independence if the box does not cover any projection */
+	if (xfrac <= 0.0 || tfrac <= 0.0)
+		return 1.0;
+	result = joint / (xfrac * tfrac);
+	return result;
+}
+
 /* 
  * Compute selectivity for columns of TemporalInst duration 
  */
@@ -1008,6 +1097,16 @@ tnumbers_sel(PlannerInfo *root, VariableStatData *vardata, TBOX *box,
 		/* Selectivity for the time dimension */
 		if (MOBDB_FLAGS_GET_T(box->flags))
 			selec *= calc_period_hist_selectivity(vardata, &period, cachedOp);
+		/* Correct the selectivity with the correlation between the value and
+		 * time dimensions for the bounding box operators */
+		if (MOBDB_FLAGS_GET_X(box->flags) && MOBDB_FLAGS_GET_T(box->flags) &&
+			(cachedOp == OVERLAPS_OP || cachedOp == CONTAINS_OP || 
+			 cachedOp == CONTAINED_OP) && selec > 0.0)
+		{
+			double corr = calc_tbox_hist_correlation(vardata, box);
+			if (corr >= 0.0)
+				selec = Min(selec * corr, 1.0);
+		}
 	}
 	else if (cachedOp == LT_OP || cachedOp == LE_OP || 
 		cachedOp == GT_OP || cachedOp == GE_OP) 
@@ -1145,3 +1244,70 @@ tnumber_joinsel(PG_FUNCTION_ARGS)
 }
 
 /*****************************************************************************/
+
+/*
+ * Returns the extent of a temporal number column estimated from the 
+ * statistics collected by ANALYZE, which avoids scanning the table. 
+ * Returns NULL if the column has not been analyzed.
+ */
+
+PG_FUNCTION_INFO_V1(tnumber_estimated_tbox);
+
+PGDLLEXPORT Datum
+tnumber_estimated_tbox(PG_FUNCTION_ARGS)
+{
+	Oid relid = PG_GETARG_OID(0);
+	text *attname = PG_GETARG_TEXT_P(1);
+	Oid atttypid;
+	HeapTuple stats_tuple = temporal_stats_tuple(relid, attname, &atttypid);
+	if (atttypid != type_oid(T_TINT) && atttypid != type_oid(T_TFLOAT))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("The column must be a temporal number")));
+	if (stats_tuple == NULL)
+		PG_RETURN_NULL();
+
+	Oid valuetypid = base_oid_from_temporal(atttypid);
+	TBOX *result = palloc0(sizeof(TBOX));
+	AttStatsSlot sslot;
+	Datum min, max;
+	if (get_attstatsslot(&sslot, stats_tuple, STATISTIC_KIND_BOUNDS_HISTOGRAM,
+			InvalidOid, ATTSTATSSLOT_VALUES))
+	{
+		/* The first and last entries of the bounds histogram keep the 
+		 * smallest lower bound and the largest upper bound of the sample */
+		TypeCacheEntry *typcache = lookup_type_cache(sslot.valuetype, 
+			TYPECACHE_RANGE_INFO);
+		RangeBound lower, upper;
+		bool empty;
+		range_deserialize(typcache, DatumGetRangeTypeP(sslot.values[0]),
+			&lower, &upper, &empty);
+		result->xmin = datum_double(lower.val, valuetypid);
+		range_deserialize(typcache, 
+			DatumGetRangeTypeP(sslot.values[sslot.nvalues - 1]),
+			&lower, &upper, &empty);
+		result->xmax = datum_double(upper.val, valuetypid);
+		/* Integer ranges are canonicalized with an exclusive upper bound */
+		if (valuetypid == INT4OID && ! upper.inclusive)
+			result->xmax--;
+		MOBDB_FLAGS_SET_X(result->flags, true);
+		free_attstatsslot(&sslot);
+	}
+	else if (temporal_stats_scalar_extent(stats_tuple, valuetypid, &min, &max))
+	{
+		result->xmin = datum_double(min, valuetypid);
+		result->xmax = datum_double(max, valuetypid);
+		MOBDB_FLAGS_SET_X(result->flags, true);
+	}
+	if (temporal_stats_time_extent(stats_tuple, &result->tmin, &result->tmax))
+		MOBDB_FLAGS_SET_T(result->flags, true);
+	ReleaseSysCache(stats_tuple);
+
+	if (! MOBDB_FLAGS_GET_X(result->flags) && ! MOBDB_FLAGS_GET_T(result->flags))
+	{
+		pfree(result);
+		PG_RETURN_NULL();
+	}
+	PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************/
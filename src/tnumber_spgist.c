@@ -81,6 +81,8 @@
 #include "temporal.h"
 #include "oidcache.h"
 #include "temporal_boxops.h"
+#include "temporal_stats.h"
+#include "temporal_util.h"
 #include "tnumber_gist.h"
 
 /*****************************************************************************/
@@ -91,24 +93,6 @@ typedef struct
 	TBOX	right;
 } RectBox;
 
-/*
- * Comparator for qsort
- *
- * We don't need to use the floating point macros in here, because this is
- * only going to be used in a place to affect the performance of the index,
- * not the correctness.
- */
-static int
-compareDoubles(const void *a, const void *b)
-{
-	double		x = *(double *) a;
-	double		y = *(double *) b;
-
-	if (x == y)
-		return 0;
-	return (x > y) ? 1 : -1;
-}
-
 /*
  * Calculate the quadrant
  *
@@ -356,19 +340,14 @@ spgist_tnumber_picksplit(PG_FUNCTION_ARGS)
 		highTs[i] = (double) box->tmax;
 	}
 
-	qsort(lowXs, (size_t) in->nTuples, sizeof(double), compareDoubles);
-	qsort(highXs, (size_t) in->nTuples, sizeof(double), compareDoubles);
-	qsort(lowTs, (size_t) in->nTuples, sizeof(double), compareDoubles);
-	qsort(highTs, (size_t) in->nTuples, sizeof(double), compareDoubles);
-
 	median = in->nTuples / 2;
 
 	centroid = palloc0(sizeof(TBOX));
 
-	centroid->xmin = lowXs[median];
-	centroid->xmax = highXs[median];
-	centroid->tmin = (TimestampTz) lowTs[median];
-	centroid->tmax = (TimestampTz) highTs[median];
+	centroid->xmin = double_select(lowXs, in->nTuples, median);
+	centroid->xmax = double_select(highXs, in->nTuples, median);
+	centroid->tmin = (TimestampTz) double_select(lowTs, in->nTuples, median);
+	centroid->tmax = (TimestampTz) double_select(highTs, in->nTuples, median);
 
 	/* Fill the output */
 	out->hasPrefix = true;
@@ -600,6 +579,8 @@ spgist_tnumber_leaf_consistent(PG_FUNCTION_ARGS)
 		else
 			elog(ERROR, "Unrecognized strategy number: %d", strategy);
 
+		MOBDB_STAT_INDEX(STAT_SPGIST_TNUMBER, strategy, true, res, out->recheck);
+
 		/* If any check is failed, we have found our answer. */
 		if (!res)
 			break;
@@ -62,4 +62,11 @@ SELECT timestampset '{2000-01-01}' <= timestampset '{2000-01-01, 2000-01-02, 200
 SELECT timestampset '{2000-01-01}' > timestampset '{2000-01-01, 2000-01-02, 2000-01-03}';
 SELECT timestampset '{2000-01-01}' >= timestampset '{2000-01-01, 2000-01-02, 2000-01-03}';
 
+-- Values written in the format used before the packed arrays, read through
+-- a function that returns its argument unchanged (little-endian platforms)
+CREATE FUNCTION timestampset_v1(bytea) RETURNS timestampset AS 'byteasend' LANGUAGE internal IMMUTABLE STRICT;
+SELECT timestampset_v1('\x0200000000000000000000000800000000000000100000000000000000000000000000000060d71d1400000000000000000000000060d71d140000000101000000000000');
+SELECT timestampset_v1('\x0200000000000000000000000800000000000000100000000000000000000000000000000060d71d1400000000000000000000000060d71d140000000101000000000000') = timestampset '{2000-01-01, 2000-01-02}';
+DROP FUNCTION timestampset_v1(bytea);
+
 -------------------------------------------------------------------------------
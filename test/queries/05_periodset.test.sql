@@ -141,4 +141,11 @@ SELECT periodset '{[2000-01-01,2000-01-01]}' <= periodset '{(2000-01-01,2000-01-
 SELECT periodset '{[2000-01-01,2000-01-01]}' > periodset '{(2000-01-01,2000-01-02),(2000-01-02,2000-01-03),(2000-01-03,2000-01-04)}';
 SELECT periodset '{[2000-01-01,2000-01-01]}' >= periodset '{(2000-01-01,2000-01-02),(2000-01-02,2000-01-03),(2000-01-03,2000-01-04)}';
 
+-- Values written in the format used before the packed arrays, read through
+-- a function that returns its argument unchanged (little-endian platforms)
+CREATE FUNCTION periodset_v1(bytea) RETURNS periodset AS 'byteasend' LANGUAGE internal IMMUTABLE STRICT;
+SELECT periodset_v1('\x0200000000000000000000001800000000000000300000000000000000000000000000000060d71d14000000010100000000000000c0ae3b28000000002086593c00000001000000000000000000000000000000002086593c0000000100000000000000');
+SELECT periodset_v1('\x0200000000000000000000001800000000000000300000000000000000000000000000000060d71d14000000010100000000000000c0ae3b28000000002086593c00000001000000000000000000000000000000002086593c0000000100000000000000') = periodset '{[2000-01-01, 2000-01-02], [2000-01-03, 2000-01-04)}';
+DROP FUNCTION periodset_v1(bytea);
+
 -------------------------------------------------------------------------------
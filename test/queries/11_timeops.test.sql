@@ -217,4 +217,10 @@ SELECT periodset '{[2000-01-01, 2000-01-02],[2000-01-03, 2000-01-04]}' * period
 SELECT periodset '{[2000-01-01, 2000-01-03],[2000-01-04, 2000-01-05]}' * periodset '{[2000-01-01, 2000-01-03],[2000-01-04, 2000-01-05]}';
 SELECT periodset '{[2000-01-03, 2000-01-04],[2000-01-07, 2000-01-08]}' * periodset '{[2000-01-01, 2000-01-02],[2000-01-05, 2000-01-06]}';
 
+SELECT period '[2000-01-01, 2000-01-02]' <-> timestamptz '2000-01-03';
+SELECT timestamptz '2000-01-01' <-> period '[2000-01-01, 2000-01-02]';
+SELECT timestampset '{2000-01-01, 2000-01-05}' <-> timestamptz '2000-01-02';
+SELECT timestamptz '2000-01-04' <-> periodset '{[2000-01-01, 2000-01-02],[2000-01-05, 2000-01-06]}';
+SELECT distance(periodset '{[2000-01-01, 2000-01-02],[2000-01-05, 2000-01-06]}', timestamptz '2000-01-07');
+
 -------------------------------------------------------------------------------
@@ -66,6 +66,10 @@ SELECT count(*) FROM tbl_periodset_big WHERE ps &<# period '[2001-01-01, 2001-02
 SELECT count(*) FROM tbl_periodset_big WHERE ps #>> period '[2001-01-01, 2001-02-01]';
 SELECT count(*) FROM tbl_periodset_big WHERE ps #&> period '[2001-01-01, 2001-02-01]';
 
+SELECT (SELECT array_agg(d) FROM (SELECT ts <-> timestamptz '2001-06-01' AS d FROM tbl_timestampset_big ORDER BY ts <-> timestamptz '2001-06-01' LIMIT 5) t1) = (SELECT array_agg(d) FROM (SELECT ts <-> timestamptz '2001-06-01' AS d FROM tbl_timestampset_big ORDER BY (ts <-> timestamptz '2001-06-01') + 0 LIMIT 5) t2);
+SELECT (SELECT array_agg(d) FROM (SELECT p <-> timestamptz '2001-06-01' AS d FROM tbl_period_big ORDER BY p <-> timestamptz '2001-06-01' LIMIT 5) t1) = (SELECT array_agg(d) FROM (SELECT p <-> timestamptz '2001-06-01' AS d FROM tbl_period_big ORDER BY (p <-> timestamptz '2001-06-01') + 0 LIMIT 5) t2);
+SELECT (SELECT array_agg(d) FROM (SELECT ps <-> timestamptz '2001-06-01' AS d FROM tbl_periodset_big ORDER BY ps <-> timestamptz '2001-06-01' LIMIT 5) t1) = (SELECT array_agg(d) FROM (SELECT ps <-> timestamptz '2001-06-01' AS d FROM tbl_periodset_big ORDER BY (ps <-> timestamptz '2001-06-01') + 0 LIMIT 5) t2);
+
 DROP INDEX IF EXISTS tbl_timestampset_big_gist_idx;
 DROP INDEX IF EXISTS tbl_period_big_gist_idx;
 DROP INDEX IF EXISTS tbl_periodset_big_gist_idx;
@@ -115,6 +119,7 @@ SELECT count(*) FROM tbl_period_big WHERE p <<# periodset '{[2001-01-01, 2001-02
 SELECT count(*) FROM tbl_period_big WHERE p &<# periodset '{[2001-01-01, 2001-02-01]}';
 SELECT count(*) FROM tbl_period_big WHERE p #>> periodset '{[2001-01-01, 2001-02-01]}';
 SELECT count(*) FROM tbl_period_big WHERE p #&> periodset '{[2001-01-01, 2001-02-01]}';
+SELECT (SELECT array_agg(p ORDER BY p) FROM tbl_period_big WHERE p && period '[2001-06-01, 2001-07-01]') = (SELECT array_agg(p ORDER BY p) FROM tbl_period_big WHERE temporal_overlaps(p, period '[2001-06-01, 2001-07-01]'));
 
 SELECT count(*) FROM tbl_periodset_big WHERE ps && period '[2001-01-01, 2001-02-01]';
 SELECT count(*) FROM tbl_periodset_big WHERE ps @> period '[2001-01-01, 2001-02-01]';
@@ -130,6 +135,22 @@ DROP INDEX IF EXISTS tbl_periodset_big_spgist_idx;
 
 -------------------------------------------------------------------------------
 
+CREATE INDEX tbl_period_big_brin_idx ON tbl_period_big USING BRIN(p);
+
+SELECT count(*) FROM tbl_period_big WHERE p && timestampset '{2001-01-01, 2001-02-01}';
+SELECT count(*) FROM tbl_period_big WHERE p @> timestampset '{2001-01-01, 2001-02-01}';
+
+SELECT count(*) FROM tbl_period_big WHERE p && period '[2001-06-01, 2001-07-01]';
+SELECT count(*) FROM tbl_period_big WHERE p @> period '[2001-06-01, 2001-07-01]';
+SELECT count(*) FROM tbl_period_big WHERE p <@ period '[2001-06-01, 2001-07-01]';
+
+SELECT count(*) FROM tbl_period_big WHERE p && periodset '{[2001-01-01, 2001-02-01]}';
+SELECT count(*) FROM tbl_period_big WHERE p <@ periodset '{[2001-01-01, 2001-02-01]}';
+
+DROP INDEX IF EXISTS tbl_period_big_brin_idx;
+
+-------------------------------------------------------------------------------
+
 DROP TABLE IF EXISTS tbl_period_test;
 CREATE TABLE tbl_period_test AS
 SELECT period '[2000-01-01,2000-01-02]';
@@ -140,4 +161,31 @@ SELECT NULL::period UNION SELECT NULL::period;
 ANALYZE tbl_period_test;
 DROP TABLE tbl_period_test;
 
--------------------------------------------------------------------------------
\ No newline at end of file
+-------------------------------------------------------------------------------
+-- Multi-period keys
+
+CREATE TABLE tbl_periodset_gaps AS
+SELECT k, periodset(ARRAY[
+  period(timestamptz '2001-01-01' + k * interval '1 day',
+    timestamptz '2001-01-01' + k * interval '1 day' + interval '2 hours'),
+  period(timestamptz '2001-01-01' + k * interval '1 day' + interval '12 hours',
+    timestamptz '2001-01-01' + k * interval '1 day' + interval '14 hours')]) AS ps
+FROM generate_series(1, 100) AS k;
+CREATE INDEX tbl_periodset_gaps_multi_idx ON tbl_periodset_gaps USING GIST(ps gist_periodset_multi_ops);
+
+SELECT count(*) FROM tbl_periodset_gaps WHERE ps && period '[2001-01-02 06:00, 2001-01-02 08:00]';
+SELECT count(*) FROM tbl_periodset_gaps WHERE ps && period '[2001-01-02 01:00, 2001-01-02 13:00]';
+SELECT count(*) FROM tbl_periodset_gaps WHERE ps @> period '[2001-01-02 12:30, 2001-01-02 13:00]';
+SELECT count(*) FROM tbl_periodset_gaps WHERE ps @> timestamptz '2001-01-02 06:00';
+SELECT count(*) FROM tbl_periodset_gaps WHERE ps <<# period '[2001-01-11, 2001-01-12]';
+SELECT k FROM tbl_periodset_gaps ORDER BY ps <-> timestamptz '2001-01-05 06:00' LIMIT 1;
+
+SET mobilitydb.gist_max_periods = 1;
+REINDEX INDEX tbl_periodset_gaps_multi_idx;
+SELECT count(*) FROM tbl_periodset_gaps WHERE ps && period '[2001-01-02 06:00, 2001-01-02 08:00]';
+SELECT count(*) FROM tbl_periodset_gaps WHERE ps && period '[2001-01-02 06:00, 2001-01-05 08:00]';
+RESET mobilitydb.gist_max_periods;
+
+DROP TABLE tbl_periodset_gaps;
+
+-------------------------------------------------------------------------------
@@ -0,0 +1,16 @@
+﻿-------------------------------------------------------------------------------
+-- The statistics of the oid cache are local to the backend
+-------------------------------------------------------------------------------
+
+SELECT proparallel FROM pg_proc WHERE proname = 'oidcache_stats';
+
+-------------------------------------------------------------------------------
+-- Operators that are not found are looked up again
+-------------------------------------------------------------------------------
+
+SELECT count(*) >= 0 FROM tbl_tbool WHERE temp && period '[2000-01-01, 2000-01-02]';
+SELECT set_config('oidcache.misses', misses::text, false) IS NOT NULL FROM oidcache_stats();
+SELECT count(*) >= 0 FROM tbl_tbool WHERE temp && period '[2000-01-01, 2000-01-02]';
+SELECT misses > current_setting('oidcache.misses')::bigint FROM oidcache_stats();
+
+-------------------------------------------------------------------------------
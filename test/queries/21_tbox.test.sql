@@ -8,6 +8,10 @@ SELECT tbox 'TBOX((, 2000-01-01), (, 2000-01-02))'; -- Only T dimension
 
 SELECT tbox 'TBOX((2,2000-01-02),(1,2000-01-01))';
 
+SELECT zorder(tbox 'TBOX((1,2000-01-01),(1,2000-01-01))', tbox 'TBOX((1,2000-01-01),(11,2000-01-11))');
+SELECT zorder(tbox 'TBOX((11,2000-01-11),(11,2000-01-11))', tbox 'TBOX((1,2000-01-01),(11,2000-01-11))');
+SELECT zorder(tbox 'TBOX((1,2000-01-02),(3,2000-01-03))', tbox 'TBOX((1,2000-01-01),(11,2000-01-11))') < zorder(tbox 'TBOX((9,2000-01-02),(11,2000-01-03))', tbox 'TBOX((1,2000-01-01),(11,2000-01-11))');
+
 /* Errors */
 SELECT tbox 'STBOX(1, 2000-01-02)';
 SELECT tbox 'TBOX(1, 2000-01-02)';
@@ -477,6 +477,17 @@ SELECT appendInstant(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[C
 /* Errors */
 SELECT appendInstant(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-04, 1@2000-01-05]');
 
+SELECT merge(tint '1@2000-01-01', tint '1@2000-01-02');
+SELECT merge(NULL, tint '1@2000-01-01');
+SELECT merge(ARRAY[tint '[1@2000-01-01, 2@2000-01-02]', tint '[2@2000-01-02, 1@2000-01-03]']);
+SELECT merge(ARRAY[tfloat '[3@2000-01-03, 4@2000-01-04]', tfloat '[1@2000-01-01, 2@2000-01-02]']);
+SELECT merge(ARRAY[tbool 't@2000-01-02', tbool '{f@2000-01-01, t@2000-01-02}', NULL]);
+SELECT merge(ARRAY[ttext '[AAA@2000-01-01, BBB@2000-01-02]', ttext '[AAA@2000-01-01, BBB@2000-01-02]']);
+SELECT merge(temp) FROM (VALUES (tint '[1@2000-01-01, 1@2000-01-02)'), (tint '[2@2000-01-02, 2@2000-01-03]')) t(temp);
+/* Errors */
+SELECT merge(ARRAY[tint '[1@2000-01-01, 2@2000-01-02]', tint '[3@2000-01-02, 1@2000-01-03]']);
+SELECT merge(ARRAY[tint '[1@2000-01-01, 2@2000-01-03]', tint '[1@2000-01-02, 1@2000-01-04]']);
+
 -------------------------------------------------------------------------------
 -- Accessor functions
 -------------------------------------------------------------------------------
@@ -520,6 +531,10 @@ SELECT memSize(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}');
 SELECT memSize(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]');
 SELECT memSize(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}');
 
+SELECT * FROM memLayout(tbool 't@2000-01-01');
+SELECT * FROM memLayout(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]');
+SELECT * FROM memLayout(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}');
+
 /*
 SELECT tbox(tint '1@2000-01-01');
 SELECT tbox(tfloat '1.5@2000-01-01');
@@ -1056,6 +1071,17 @@ SELECT shift(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}', '5 min');
 SELECT shift(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]', '5 min');
 SELECT shift(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}', '5 min');
 
+SELECT tscale(tint '1@2000-01-01', '1 day');
+SELECT tscale(tint '{1@2000-01-01, 2@2000-01-02, 1@2000-01-03}', '1 day');
+SELECT tscale(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]', '4 days');
+SELECT tscale(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}', '2 days');
+SELECT twavg(tscale(tfloat '[1@2000-01-01, 3@2000-01-03]', '1 hour'));
+SELECT shift(tint '[1@2000-01-31, 2@2000-02-01]', '1 month');
+/* Errors */
+SELECT tscale(tint '[1@2000-01-01, 2@2000-01-02]', '-1 hour');
+SELECT tscale(tint '[1@2000-01-01, 2@2000-01-02]', '0');
+SELECT tscale(tint '[1@2000-01-01, 2@2000-01-02, 3@2000-01-03]', '1 microsecond');
+
 -------------------------------------------------------------------------------
 -- Ever/always comparison functions
 -------------------------------------------------------------------------------
@@ -1095,6 +1121,11 @@ SELECT ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04,
 
 SELECT tfloat '[1@2000-01-01, 1@2000-01-03]' ?= 1;
 SELECT tfloat '[1@2000-01-01, 2@2000-01-03]' ?= 2;
+/* Texts that only differ in case are equal for some collations but not
+   for the equality of ttext, whatever the collation of the database */
+SELECT ttext '[AAA@2000-01-01, aaa@2000-01-02]' ?= 'Aaa';
+SELECT ttext '[AAA@2000-01-01, aaa@2000-01-02]' %= 'AAA';
+SELECT atValue(ttext '{AAA@2000-01-01, aaa@2000-01-02, AAA@2000-01-03}', 'aaa');
 
 SELECT tbool 't@2000-01-01' %= true;
 SELECT tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}' %= true;
@@ -1278,6 +1309,8 @@ SELECT atValue(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]', 2);
 SELECT atValue(tfloat 'Interp=Stepwise;[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]', 2);
 SELECT atValue(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}', 2);
 SELECT atValue(tfloat 'Interp=Stepwise;{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}', 2);
+SELECT atValue(tfloat '[1@2000-01-01, 3@2000-01-03, 3@2000-01-04, 1@2000-01-06]', 2);
+SELECT atMax(tfloat '{[1@2000-01-01, 3@2000-01-03), (3@2000-01-03, 1@2000-01-05]}');
 SELECT atValue(ttext 'AAA@2000-01-01', 'AAA');
 SELECT atValue(ttext '{AAA@2000-01-01}', 'AAA');
 SELECT atValue(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}', 'AAA');
@@ -1393,6 +1426,9 @@ SELECT atRange(tfloat 'Interp=Stepwise;{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@200
 SELECT atRange(tfloat 'Interp=Stepwise;{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}', floatrange '[2,3]');
 
 SELECT atRange(tfloat '[1@2000-01-01, 2@2000-01-02]', floatrange '[2, 3]');
+SELECT atRange(tfloat '[1@2000-01-01, 3@2000-01-03]', floatrange '[2,)');
+SELECT atRange(tfloat '[1@2000-01-01, 3@2000-01-03]', floatrange 'empty');
+SELECT minusRange(tfloat '[1@2000-01-01, 3@2000-01-03]', floatrange 'empty');
 
 SELECT minusRange(tint '1@2000-01-01', intrange '[1,3]');
 SELECT minusRange(tint '{1@2000-01-01}', intrange '[1,3]');
@@ -1462,6 +1498,8 @@ SELECT minusRanges(tfloat '{1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03}', AR
 SELECT minusRanges(tfloat '[1@2000-01-01]', ARRAY[floatrange '(1, 3]']);
 SELECT minusRanges(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]', ARRAY[floatrange '[5,6]']);
 SELECT minusRanges(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}', ARRAY[floatrange '[5,6]']);
+SELECT atRanges(tfloat '[5@2000-01-01, 1@2000-01-05]', ARRAY[floatrange '[1,2]', floatrange '[3,4]']);
+SELECT minusRanges(tint '{1@2000-01-01, 2@2000-01-02, 3@2000-01-03}', ARRAY[intrange '[1,1]', intrange '[3,3]']);
 
 SELECT atMin(tint '1@2000-01-01');
 SELECT atMin(tint '{1@2000-01-01, 2@2000-01-02, 1@2000-01-03}');
@@ -1679,9 +1717,14 @@ SELECT minusTimestampSet(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03
 
 SELECT minusTimestampSet(tfloat '{1@2000-01-02}', '{2000-01-01, 2000-01-04}');
 SELECT minusTimestampSet(tfloat '{1@2000-01-02, 1@2000-01-03}', '{2000-01-01, 2000-01-04}');
+SELECT atTimestampSet(tint '{1@2000-01-01, 2@2000-01-02, 3@2000-01-03, 4@2000-01-04, 5@2000-01-05}', timestampset '{2000-01-02, 2000-01-03, 2000-01-05, 2000-01-06}');
+SELECT minusTimestampSet(tint '{1@2000-01-01, 2@2000-01-02, 3@2000-01-03, 4@2000-01-04, 5@2000-01-05}', timestampset '{2000-01-02, 2000-01-03, 2000-01-05, 2000-01-06}');
+SELECT atTimestampSet(ttext '{A@2000-01-01, BBBBBBBBBB@2000-01-02, C@2000-01-03, DDDDDDDDDDDDDDDDDDDD@2000-01-04}', timestampset '{2000-01-02, 2000-01-04}');
+SELECT minusTimestampSet(ttext '{A@2000-01-01, BBBBBBBBBB@2000-01-02, C@2000-01-03, DDDDDDDDDDDDDDDDDDDD@2000-01-04}', timestampset '{2000-01-02, 2000-01-04}');
 SELECT minusTimestampSet(tfloat '[1@2000-01-01]', timestampset '{2000-01-01}');
 SELECT minusTimestampSet(tfloat '[1@2000-01-02]', '{2000-01-01, 2000-01-03}');
 SELECT minusTimestampSet(tfloat '{[1@2000-01-01], [1@2000-01-02]}', timestampset '{2000-01-01, 2000-01-02}');
+SELECT minusTimestampSet(tint '[1@2000-01-01, 2@2000-01-02, 3@2000-01-04]', timestampset '{2000-01-02, 2000-01-03}');
 
 SELECT atPeriod(tbool 't@2000-01-01', period '[2000-01-01,2000-01-02]');
 SELECT atPeriod(tbool '{t@2000-01-01}', period '[2000-01-01,2000-01-02]');
@@ -1771,6 +1814,7 @@ SELECT atPeriodSet(tfloat '[1@2000-01-03]', '{[2000-01-01,2000-01-02],[2000-01-0
 SELECT atPeriodSet(tfloat '[1@2000-01-01,1@2000-01-02]', '{[2000-01-01,2000-01-03],[2000-01-04,2000-01-05]}');
 SELECT atPeriodSet(tfloat '{[1@2000-01-01, 1@2000-01-02]}', periodset '{[2000-01-03, 2000-01-04]}');
 SELECT atPeriodSet(tfloat '{[1@2000-01-02, 1@2000-01-03),[1@2000-01-04, 1@2000-01-05]}', periodset '{[2000-01-01, 2000-01-02),[2000-01-03, 2000-01-04)}');
+SELECT atPeriodSet(tfloat '[1@2000-01-01, 5@2000-01-05]', periodset '{[2000-01-02, 2000-01-03], (2000-01-04, 2000-01-05]}');
 
 SELECT minusPeriodSet(tbool 't@2000-01-01', periodset '{[2000-01-01,2000-01-02]}');
 SELECT minusPeriodSet(tbool '{t@2000-01-01}', periodset '{[2000-01-01,2000-01-02]}');
@@ -1804,6 +1848,8 @@ SELECT minusPeriodSet(tfloat '[1@2000-01-03]', periodset '{[2000-01-01, 2000-01-
 SELECT minusPeriodSet(tfloat '[1@2000-01-01,1@2000-01-03]', periodset '{[2000-01-02, 2000-01-03],[2000-01-04, 2000-01-05]}');
 SELECT minusPeriodSet(tfloat '{[1@2000-01-01, 1@2000-01-02]}', periodset '{[2000-01-01, 2000-01-02]}');
 SELECT minusPeriodSet(tfloat '{[1@2000-01-01, 1@2000-01-02],[1@2000-01-03, 1@2000-01-04]}', periodset '{[2000-01-01, 2000-01-02],[2000-01-03, 2000-01-04]}');
+SELECT atPeriodSet(tint '{1@2000-01-01, 2@2000-01-02, 3@2000-01-03, 4@2000-01-04, 5@2000-01-05}', periodset '{[2000-01-01, 2000-01-02], (2000-01-03, 2000-01-05)}');
+SELECT minusPeriodSet(tint '{1@2000-01-01, 2@2000-01-02, 3@2000-01-03, 4@2000-01-04, 5@2000-01-05}', periodset '{[2000-01-01, 2000-01-02], (2000-01-03, 2000-01-05)}');
 
 SELECT intersectsTimestamp(tbool 't@2000-01-01', timestamptz '2000-01-01');
 SELECT intersectsTimestamp(tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}', timestamptz '2000-01-01');
@@ -1905,6 +1951,15 @@ SELECT round(twAvg(tfloat 'Interp=Stepwise;[1.5@2000-01-01, 2.5@2000-01-02, 1.5@
 SELECT round(twAvg(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}')::numeric, 6);
 SELECT round(twAvg(tfloat 'Interp=Stepwise;{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}')::numeric, 6);
 
+-- Summary computed when the sequences are constructed
+SET mobilitydb.precompute_summary = on;
+SELECT integral(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]');
+SELECT integral(appendInstant(tint '[1@2000-01-01, 2@2000-01-02]', tint '1@2000-01-03'));
+SELECT round(twAvg(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]')::numeric, 6);
+-- The summary is dropped when the values are truncated
+SELECT integral(tfloat 'Interp=Stepwise;{[1.5@2000-01-01, 2.5@2000-01-02, 2.5@2000-01-03]}'::tint);
+RESET mobilitydb.precompute_summary;
+
 -------------------------------------------------------------------------------
 -- Comparison functions and B-tree indexing
 -------------------------------------------------------------------------------
@@ -2311,3 +2366,69 @@ SELECT ttext_hash(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]');
 SELECT ttext_hash(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}');
 
 ------------------------------------------------------------------------------
+SELECT compress(tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]') = tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]';
+SELECT compress(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]') = tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]';
+SELECT compress(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03 00:00:01.25]') = tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03 00:00:01.25]';
+SELECT compress(tfloat '(-1.125@2000-01-01, 1e10@2000-01-01 00:00:01, 3@2001-01-01)') = tfloat '(-1.125@2000-01-01, 1e10@2000-01-01 00:00:01, 3@2001-01-01)';
+SELECT compress(tint '[0@2000-01-01, 2147483647@2000-01-02, -2147483648@2000-01-03, 2147483647@2000-01-04, 5@2000-01-05, 5@2000-01-06]') = tint '[0@2000-01-01, 2147483647@2000-01-02, -2147483648@2000-01-03, 2147483647@2000-01-04, 5@2000-01-05, 5@2000-01-06]';
+SELECT compress(tint '[0@2000-01-01, 2147483647@2000-01-02, -2147483648@2000-01-03, 2147483647@2000-01-04, 5@2000-01-05, 5@2000-01-06]');
+SELECT isCompressed(compress(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]'));
+SELECT isCompressed(compress(tint '{1@2000-01-01, 2@2000-01-02, 1@2000-01-03}'));
+SELECT isCompressed(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]');
+SELECT numInstants(compress(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]'));
+SELECT tbox(compress(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]')) = tbox(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]');
+SELECT tbox(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]'::tint(Sequence)) = tbox(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]');
+SELECT period(compress(tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]'));
+SELECT startTimestamp(compress(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]'));
+SELECT endTimestamp(compress(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]'));
+SELECT numTimestamps(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]'::tfloat(Sequence));
+SELECT tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03 00:00:01.25]'::tfloat(Sequence) = tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03 00:00:01.25]';
+SELECT tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]'::tbool(Sequence) = tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]';
+SELECT numInstants(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]'::tint(Sequence));
+
+-- Nested appends are done in place on the expanded result of the inner call
+SELECT appendInstant(appendInstant(tfloat '[1.5@2000-01-01, 2.5@2000-01-02]', tfloat '1.5@2000-01-03'), tfloat '1.5@2000-01-04');
+SELECT appendInstant(appendInstant(tint '[1@2000-01-01, 2@2000-01-02]', tint '2@2000-01-03'), tint '2@2000-01-04');
+SELECT numInstants(appendInstant(appendInstant(appendInstant(tfloat '[1@2000-01-01, 2@2000-01-02]', tfloat '3@2000-01-03'), tfloat '4@2000-01-04'), tfloat '1@2000-01-05'));
+
+-- The transition value of an aggregate whose transition function is appendInstant is appended in place
+CREATE AGGREGATE appendInstantAgg(tfloat) (SFUNC = appendInstant, STYPE = tfloat, INITCOND = '[0@2000-01-01]');
+SELECT numInstants(appendInstantAgg(tfloatinst(i % 2, timestamptz '2000-01-01' + i * interval '1 day') ORDER BY i)) FROM generate_series(1, 1000) i;
+SELECT tbox(appendInstantAgg(tfloatinst(i % 2 * 5, timestamptz '2000-01-01' + i * interval '1 day') ORDER BY i)) FROM generate_series(1, 4) i;
+DROP AGGREGATE appendInstantAgg(tfloat);
+
+-- Ever/always comparisons answered from the bounding box or at the bounds
+SELECT tfloat '[1.5@2000-01-01, 1.5@2000-01-02]' %= 1.5;
+SELECT tfloat '[1@2000-01-01, 3@2000-01-02]' ?= 2.5;
+SELECT tfloat '(1@2000-01-01, 3@2000-01-02]' ?= 1;
+SELECT tfloat '(1@2000-01-01, 3@2000-01-02]' ?<= 1;
+SELECT tint '[1@2000-01-01, 3@2000-01-02, 3@2000-01-03)' ?= 3;
+SELECT tfloat '[1@2000-01-01, 1@2000-01-02, 2@2000-01-03)' %< 2;
+SELECT tfloat '[1@2000-01-01, 2@2000-01-02]' %< 2;
+SELECT tfloat '{[1@2000-01-01, 2@2000-01-02), [1@2000-01-03, 2@2000-01-04)}' %< 2;
+
+-- Input of base values and timestamps with and without the fast path parsers
+SELECT tint ' 1 @2000-01-01 08:30:15.25+02';
+SELECT tfloat '-1.5e2@2000-01-01T08:00Z';
+SELECT tbool '{yes@2000-01-01 08:00:00-05:30, f@2000-01-02}';
+SELECT tint '[1@2000-01-01 08:00:00.1234567, 2@2000-01-02 00:00:00+0130]';
+SELECT tint '1@2001-02-29';
+
+-- Sequence constructors from arrays of values and timestamps
+SELECT tfloatseq(ARRAY[1, 2.5, 3]::float8[], ARRAY[timestamptz '2000-01-01', '2000-01-02', '2000-01-03']);
+SELECT tfloatseq(ARRAY[1, 2.5, 3]::float8[], ARRAY[timestamptz '2000-01-01', '2000-01-02', '2000-01-03'], false, true, false);
+SELECT tfloatseq(ARRAY[1, 2]::float8[], ARRAY[timestamptz '2000-01-01']);
+SELECT tfloatseq(ARRAY[1, 2]::float8[], ARRAY[timestamptz '2000-01-02', '2000-01-01']);
+
+SELECT tint '[1@2000-01-01, 2@2000-01-02]' <-> timestamptz '2000-01-04';
+SELECT tfloat '{1@2000-01-01, 2@2000-01-05}' <-> timestamptz '2000-01-03';
+SELECT timestamptz '2000-01-01' <-> ttext 'AAA@2000-01-01';
+
+-- Output in other time zones and date styles
+SET timezone = 'Europe/Brussels';
+SELECT tfloat '[1@2001-03-25 00:30:00+00, 2@2001-03-25 01:30:00+00, 3@2001-10-28 00:30:00+00, 4@2001-10-28 01:30:00+00]';
+SELECT ttext '{AAA@1960-06-01 12:00:00.5+00, BBB@2001-06-01 12:00:00+00}';
+SET DateStyle = 'Postgres';
+SELECT tint '[1@2001-01-01 00:00:00+00, 2@2001-07-01 00:00:00+00]';
+RESET DateStyle;
+RESET timezone;
@@ -628,3 +628,22 @@ SELECT COUNT(*) FROM tbl_ttext t1, tbl_ttext t2
 WHERE t1.temp >= t2.temp;
 
 ------------------------------------------------------------------------------
+
+-- Partial detoasting of sequences stored out of line
+
+DROP TABLE IF EXISTS tbl_tfloatseq_ext;
+CREATE TABLE tbl_tfloatseq_ext(temp tfloat);
+ALTER TABLE tbl_tfloatseq_ext ALTER COLUMN temp SET STORAGE EXTERNAL;
+INSERT INTO tbl_tfloatseq_ext
+SELECT tfloatseq(array_agg(tfloatinst((i % 2)::float, timestamptz '2000-01-01' + i * interval '1 minute') ORDER BY i))
+FROM generate_series(1, 5000) i;
+
+SELECT valueAtTimestamp(temp, '2000-01-02 12:00:30') FROM tbl_tfloatseq_ext;
+SELECT valueAtTimestamp(temp, '2000-01-05') IS NULL FROM tbl_tfloatseq_ext;
+SELECT atTimestamp(temp, '2000-01-01') IS NULL FROM tbl_tfloatseq_ext;
+SELECT getValue(atTimestamp(temp, '2000-01-01 00:03:00')) FROM tbl_tfloatseq_ext;
+SELECT numInstants(atPeriod(temp, '[2000-01-02, 2000-01-03]')) FROM tbl_tfloatseq_ext;
+
+DROP TABLE tbl_tfloatseq_ext;
+
+------------------------------------------------------------------------------
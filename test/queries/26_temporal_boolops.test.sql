@@ -36,6 +36,7 @@ SELECT tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-
 SELECT tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}' & tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}';
 SELECT tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}' & tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]';
 SELECT tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}' & tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}';
+SELECT tbool '[f@2000-01-01, t@2000-01-05]' & tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03, f@2000-01-04, t@2000-01-05]';
 
 -------------------------------------------------------------------------------
 
@@ -68,6 +69,9 @@ SELECT tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-
 SELECT tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}' | tbool '{t@2000-01-01, f@2000-01-02, t@2000-01-03}';
 SELECT tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}' | tbool '[t@2000-01-01, f@2000-01-02, t@2000-01-03]';
 SELECT tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}' | tbool '{[t@2000-01-01, f@2000-01-02, t@2000-01-03],[t@2000-01-04, t@2000-01-05]}';
+SELECT tbool '[t@2000-01-01, t@2000-01-03)' | tbool '[f@2000-01-01, t@2000-01-02, f@2000-01-04]';
+SELECT tbool '{[f@2000-01-01, t@2000-01-02), [f@2000-01-02, f@2000-01-03]}' & tbool '{[f@2000-01-01, f@2000-01-03]}';
+SELECT tbool '[t@2000-01-01, t@2000-01-03]' | tbool '{[t@2000-01-01, f@2000-01-02), [t@2000-01-02, t@2000-01-03]}';
 
 -------------------------------------------------------------------------------
 
@@ -956,3 +956,17 @@ SELECT ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]' #>= ttext '{[AAA
 SELECT ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}' #>= ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}';
 
 -------------------------------------------------------------------------------
+
+SELECT tfloat '[1@2000-01-01, 3@2000-01-03]' ?= tfloat '[3@2000-01-01, 1@2000-01-03]';
+SELECT tfloat '[1@2000-01-01, 3@2000-01-03]' %< tfloat '[3@2000-01-01, 1@2000-01-03]';
+SELECT tfloat '[1@2000-01-01, 2@2000-01-03)' %< tfloat '[2@2000-01-01, 2@2000-01-03)';
+SELECT tint '[1@2000-01-01, 2@2000-01-02]' ?> tint '[2@2000-01-01, 1@2000-01-02]';
+SELECT tint '[1@2000-01-01, 2@2000-01-02)' ?> tint '[2@2000-01-01, 1@2000-01-02)';
+SELECT tfloat '{[1@2000-01-01, 1@2000-01-02], [5@2000-01-03, 5@2000-01-04]}' ?>= tfloat '[3@2000-01-01, 3@2000-01-04]';
+SELECT ttext '{AAA@2000-01-01, BBB@2000-01-02}' %= ttext '{AAA@2000-01-01, CCC@2000-01-03}';
+SELECT tint '[1@2000-01-01, 1@2000-01-02]' ?= tint '[1@2000-01-03, 1@2000-01-04]';
+SELECT tint '[3@2000-01-01, 3@2000-01-05]' ?= tint '{[1@2000-01-01, 1@2000-01-02], [3@2000-01-03, 3@2000-01-04]}';
+SELECT tint '[3@2000-01-01, 3@2000-01-05]' %> tint '{[1@2000-01-01, 1@2000-01-02], [5@2000-01-03, 5@2000-01-04]}';
+SELECT tint '{[3@2000-01-01, 3@2000-01-05], [7@2000-01-06, 7@2000-01-07]}' ?= tint '{[1@2000-01-01, 1@2000-01-02], [3@2000-01-03, 3@2000-01-04], [8@2000-01-06, 8@2000-01-07]}';
+
+-------------------------------------------------------------------------------
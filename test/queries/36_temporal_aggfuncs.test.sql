@@ -154,6 +154,36 @@ SELECT round(tavg(temp), 6) FROM (VALUES
 
 --------------------------------------------------
 
+SELECT tcount(temp, interval '1 day') FROM (VALUES (tint '[1@2000-01-01, 2@2000-01-03]'), (tint '{3@2000-01-02, 4@2000-01-05}')) t(temp);
+SELECT tsum(temp, interval '1 day') FROM (VALUES (tfloat '[1@2000-01-01, 3@2000-01-03]'), (tfloat '[10@2000-01-02 12:00, 20@2000-01-04 12:00]')) t(temp);
+SELECT tcountDistinct(temp, id, interval '1 day') FROM (VALUES (1, tint '[1@2000-01-01, 2@2000-01-03]'), (1, tint '{3@2000-01-02, 4@2000-01-05}'), (2, tint '[1@2000-01-02, 1@2000-01-02 12:00]')) t(id, temp);
+SELECT tpercentile(temp, 0.5, interval '1 day') FROM (VALUES (tfloat '[1@2000-01-01, 3@2000-01-03]'), (tfloat '[2@2000-01-01, 2@2000-01-02]'), (tfloat '{4@2000-01-01, 10@2000-01-02}'), (tfloat '5@2000-01-01')) t(temp);
+SELECT tpercentile(temp, 1, interval '1 day') FROM (VALUES (tint '[1@2000-01-01, 3@2000-01-02]'), (tint '[2@2000-01-01, 4@2000-01-02]')) t(temp);
+
+CREATE TABLE tbl_tfloat_estimated(temp tfloat);
+INSERT INTO tbl_tfloat_estimated SELECT format('[%s@2000-01-%s, %s@2000-01-%s]', k, k, k + 1, k + 1)::tfloat FROM generate_series(1, 10) k;
+SELECT estimatedTBox('tbl_tfloat_estimated', 'temp');
+ANALYZE tbl_tfloat_estimated;
+SELECT estimatedTBox('tbl_tfloat_estimated', 'temp');
+CREATE ROLE mobdb_estimated_user;
+SET ROLE mobdb_estimated_user;
+SELECT estimatedTBox('tbl_tfloat_estimated', 'temp');
+RESET ROLE;
+DROP ROLE mobdb_estimated_user;
+DROP TABLE tbl_tfloat_estimated;
+CREATE TABLE tbl_tfloat_estimated_ext(temp tfloat);
+ALTER TABLE tbl_tfloat_estimated_ext ALTER COLUMN temp SET STORAGE EXTERNAL;
+INSERT INTO tbl_tfloat_estimated_ext SELECT tfloatseq(array_agg(tfloatinst((k + i % 2)::float, timestamptz '2000-01-01' + k * interval '1 day' + i * interval '1 minute') ORDER BY i)) FROM generate_series(1, 3) k, generate_series(1, 2000) i GROUP BY k;
+ANALYZE tbl_tfloat_estimated_ext;
+SELECT estimatedTBox('tbl_tfloat_estimated_ext', 'temp');
+DROP TABLE tbl_tfloat_estimated_ext;
+CREATE TABLE tbl_tbool_estimated(temp tbool);
+INSERT INTO tbl_tbool_estimated SELECT tboolseq(array_agg(tboolinst(i % 2 = 0, timestamptz '2000-01-01' + i * interval '1 hour') ORDER BY i)) FROM generate_series(1, 4) k, generate_series(1, 3 * k) i GROUP BY k;
+SELECT estimatedNumInstants('tbl_tbool_estimated', 'temp');
+ANALYZE tbl_tbool_estimated;
+SELECT estimatedNumInstants('tbl_tbool_estimated', 'temp');
+DROP TABLE tbl_tbool_estimated;
+
 /* Errors */
 SELECT tsum(temp) FROM ( VALUES
 (tfloat '[1@2000-01-01, 2@2000-01-02]'), 
@@ -164,5 +194,7 @@ SELECT tsum(temp) FROM ( VALUES
 SELECT tsum(temp) FROM (VALUES
 ('Interp=Stepwise;[1@2000-01-01, 2@2000-01-03, 1@2000-01-05, 2@2000-01-07]'::tfloat), 
 ('[3@2000-01-02, 4@2000-01-06]'::tfloat)) t(temp);
+SELECT tcount(temp, interval '1 month') FROM (VALUES (tint '[1@2000-01-01, 2@2000-01-03]')) t(temp);
+SELECT tpercentile(temp, 2, interval '1 day') FROM (VALUES (tint '[1@2000-01-01, 2@2000-01-03]')) t(temp);
 
 --------------------------------------------------
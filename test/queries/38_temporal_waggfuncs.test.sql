@@ -56,6 +56,9 @@ SELECT wavg(temp, interval '5 minutes') FROM (VALUES (NULL::tfloat),('1@2000-01-
 
 SELECT wmax(temp, interval '1 day') FROM (VALUES (tfloat '[1@2000-01-01, 1@2000-01-02]'),('[1@2000-01-03, 1@2000-01-04]')) t(temp);
 
+SELECT wmax(temp, interval '2 minutes') FROM (VALUES (tint '[1@2000-01-01 00:00, 3@2000-01-01 00:02, 2@2000-01-01 00:05]')) t(temp);
+SELECT wsum(temp, interval '2 minutes') FROM (VALUES (tint '{1@2000-01-01 00:00, 2@2000-01-01 00:01}')) t(temp);
+
 /* Errors */
 SELECT wsum(temp, interval '1 day') FROM (VALUES (tfloat '[1@2000-01-01, 1@2000-01-02]'),('[1@2000-01-03, 1@2000-01-04]')) t(temp);
 
@@ -1,4 +1,10 @@
 ﻿-------------------------------------------------------------------------------
+
+set parallel_tuple_cost=0;
+set parallel_setup_cost=0;
+set force_parallel_mode=regress;
+
+-------------------------------------------------------------------------------
 -- TemporalInst
 -------------------------------------------------------------------------------
 
@@ -131,3 +137,9 @@ select numSequences(wcount(ts, interval '5 minutes'))
 from tbl_tfloats;
 
 -------------------------------------------------------------------------------
+
+set parallel_tuple_cost=100;
+set parallel_setup_cost=100;
+set force_parallel_mode=off;
+
+-------------------------------------------------------------------------------
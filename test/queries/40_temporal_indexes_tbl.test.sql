@@ -78,6 +78,13 @@ SELECT count(*) FROM tbl_ttext_big WHERE temp &<# period '[2001-01-01, 2001-02-0
 SELECT count(*) FROM tbl_ttext_big WHERE temp #>> period '[2001-01-01, 2001-02-01]';
 SELECT count(*) FROM tbl_ttext_big WHERE temp #&> period '[2001-01-01, 2001-02-01]';
 
+SELECT (SELECT sum(leaf_tuples) FROM mobdb_index_stats('tbl_tint_big_gist_idx')) = (SELECT count(*) FROM tbl_tint_big);
+
+SELECT (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tbool_big ORDER BY temp <-> timestamptz '2001-06-01' LIMIT 5) t1) = (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tbool_big ORDER BY (temp <-> timestamptz '2001-06-01') + 0 LIMIT 5) t2);
+SELECT (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tint_big ORDER BY temp <-> timestamptz '2001-06-01' LIMIT 5) t1) = (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tint_big ORDER BY (temp <-> timestamptz '2001-06-01') + 0 LIMIT 5) t2);
+SELECT (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tfloat_big ORDER BY temp <-> timestamptz '2001-06-01' LIMIT 5) t1) = (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tfloat_big ORDER BY (temp <-> timestamptz '2001-06-01') + 0 LIMIT 5) t2);
+SELECT (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_ttext_big ORDER BY temp <-> timestamptz '2001-06-01' LIMIT 5) t1) = (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_ttext_big ORDER BY (temp <-> timestamptz '2001-06-01') + 0 LIMIT 5) t2);
+
 DROP INDEX IF EXISTS tbl_tbool_big_gist_idx;
 DROP INDEX IF EXISTS tbl_tint_big_gist_idx;
 DROP INDEX IF EXISTS tbl_tfloat_big_gist_idx;
@@ -85,6 +92,69 @@ DROP INDEX IF EXISTS tbl_ttext_big_gist_idx;
 
 -------------------------------------------------------------------------------
 
+CREATE INDEX tbl_tint_big_gist_idx ON tbl_tint_big USING GIST(temp gist_tint_compact_ops);
+CREATE INDEX tbl_tfloat_big_gist_idx ON tbl_tfloat_big USING GIST(temp gist_tfloat_compact_ops);
+
+SELECT count(*) FROM tbl_tint_big WHERE temp && intrange '[1,50]';
+SELECT count(*) FROM tbl_tint_big WHERE temp @> intrange '[1,50]';
+SELECT count(*) FROM tbl_tint_big WHERE temp <@ intrange '[1,50]';
+SELECT count(*) FROM tbl_tint_big WHERE temp ~= intrange '[1,50]';
+SELECT count(*) FROM tbl_tint_big WHERE temp << intrange '[1,50]';
+SELECT count(*) FROM tbl_tint_big WHERE temp &< intrange '[1,50]';
+SELECT count(*) FROM tbl_tint_big WHERE temp >> intrange '[1,50]';
+SELECT count(*) FROM tbl_tint_big WHERE temp &> intrange '[1,50]';
+SELECT count(*) FROM tbl_tint_big WHERE temp <<# period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tint_big WHERE temp &<# period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tint_big WHERE temp #>> period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tint_big WHERE temp #&> period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tint_big WHERE temp && tint '[1@2001-01-01, 10@2001-02-01]';
+SELECT count(*) FROM tbl_tint_big WHERE temp @> tint '[1@2001-01-01, 10@2001-02-01]';
+SELECT count(*) FROM tbl_tint_big WHERE temp <@ tint '[1@2001-01-01, 10@2001-02-01]';
+SELECT count(*) FROM tbl_tint_big WHERE temp ~= tint '[1@2001-01-01, 10@2001-02-01]';
+
+SELECT count(*) FROM tbl_tfloat_big WHERE temp && floatrange '[1,50]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp @> floatrange '[1,50]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp <@ floatrange '[1,50]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp ~= floatrange '[1,50]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp << floatrange '[1,50]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp &< floatrange '[1,50]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp >> floatrange '[1,50]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp &> floatrange '[1,50]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp <<# period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp &<# period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp #>> period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp #&> period '[2001-01-01, 2001-02-01]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp && tfloat '[1@2001-01-01, 10@2001-02-01]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp @> tfloat '[1@2001-01-01, 10@2001-02-01]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp <@ tfloat '[1@2001-01-01, 10@2001-02-01]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp ~= tfloat '[1@2001-01-01, 10@2001-02-01]';
+
+SELECT (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tint_big ORDER BY temp <-> timestamptz '2001-06-01' LIMIT 5) t1) = (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tint_big ORDER BY (temp <-> timestamptz '2001-06-01') + 0 LIMIT 5) t2);
+SELECT (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tfloat_big ORDER BY temp <-> timestamptz '2001-06-01' LIMIT 5) t1) = (SELECT array_agg(d) FROM (SELECT temp <-> timestamptz '2001-06-01' AS d FROM tbl_tfloat_big ORDER BY (temp <-> timestamptz '2001-06-01') + 0 LIMIT 5) t2);
+
+DROP INDEX IF EXISTS tbl_tint_big_gist_idx;
+DROP INDEX IF EXISTS tbl_tfloat_big_gist_idx;
+
+-------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tint_big_brin_idx ON tbl_tint_big USING BRIN(temp);
+CREATE INDEX tbl_tfloat_big_brin_idx ON tbl_tfloat_big USING BRIN(temp);
+
+SELECT count(*) FROM tbl_tint_big WHERE temp && tint '[1@2001-01-01, 10@2001-02-01]';
+SELECT count(*) FROM tbl_tint_big WHERE temp @> tint '[1@2001-01-01, 10@2001-02-01]';
+SELECT count(*) FROM tbl_tint_big WHERE temp <@ tint '[1@2001-01-01, 10@2001-02-01]';
+SELECT count(*) FROM tbl_tint_big WHERE temp ~= tint '[1@2001-01-01, 10@2001-02-01]';
+
+SELECT count(*) FROM tbl_tfloat_big WHERE temp && tfloat '[1@2001-01-01, 10@2001-02-01]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp @> tfloat '[1@2001-01-01, 10@2001-02-01]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp <@ tfloat '[1@2001-01-01, 10@2001-02-01]';
+SELECT count(*) FROM tbl_tfloat_big WHERE temp ~= tfloat '[1@2001-01-01, 10@2001-02-01]';
+
+DROP INDEX IF EXISTS tbl_tint_big_brin_idx;
+DROP INDEX IF EXISTS tbl_tfloat_big_brin_idx;
+
+-------------------------------------------------------------------------------
+
 CREATE INDEX tbl_tbool_big_spgist_idx ON tbl_tbool_big USING SPGIST(temp);
 CREATE INDEX tbl_tint_big_spgist_idx ON tbl_tint_big USING SPGIST(temp);
 CREATE INDEX tbl_tfloat_big_spgist_idx ON tbl_tfloat_big USING SPGIST(temp);
@@ -146,6 +216,8 @@ SELECT count(*) FROM tbl_ttext_big WHERE temp &<# period '[2001-01-01, 2001-02-0
 SELECT count(*) FROM tbl_ttext_big WHERE temp #>> period '[2001-01-01, 2001-02-01]';
 SELECT count(*) FROM tbl_ttext_big WHERE temp #&> period '[2001-01-01, 2001-02-01]';
 
+SELECT (SELECT sum(leaf_tuples) FROM mobdb_index_stats('tbl_tint_big_spgist_idx')) = (SELECT count(*) FROM tbl_tint_big WHERE temp IS NOT NULL);
+
 DROP INDEX IF EXISTS tbl_tbool_big_spgist_idx;
 DROP INDEX IF EXISTS tbl_tint_big_spgist_idx;
 DROP INDEX IF EXISTS tbl_tfloat_big_spgist_idx;
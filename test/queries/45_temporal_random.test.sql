@@ -0,0 +1,19 @@
+-------------------------------------------------------------------------------
+
+SELECT numInstants(random_tfloat_seq(0, 100, '[2001-01-01, 2001-01-02]', 1000));
+SELECT random_tfloat_seq(0, 100, '[2001-01-01, 2001-01-02]', 100, '1 minute', 'walk', 1) =
+  random_tfloat_seq(0, 100, '[2001-01-01, 2001-01-02]', 100, '1 minute', 'walk', 1);
+SELECT random_tfloat_seq(0, 100, '[2001-01-01, 2001-01-02]', 100, '1 minute', 'walk', 1) =
+  random_tfloat_seq(0, 100, '[2001-01-01, 2001-01-02]', 100, '1 minute', 'walk', 2);
+SELECT d, minValue(temp) >= 0 AND maxValue(temp) <= 100 AND
+  period(temp) <@ period '[2001-01-01, 2001-01-02]' FROM (
+  SELECT d, random_tfloat_seq(0, 100, '[2001-01-01, 2001-01-02]', 1000, '1 minute', d, 7) AS temp
+  FROM unnest(ARRAY['uniform', 'walk', 'clustered']) d) t;
+
+/* Errors */
+SELECT random_tfloat_seq(0, 100, '[2001-01-01, 2001-01-02]', 0);
+SELECT random_tfloat_seq(0, 100, '[2001-01-01, 2001-01-02]', 10, '0 minutes');
+SELECT random_tfloat_seq(0, 100, '[2001-01-01, 2001-01-02]', 10, '1 minute', 'road');
+SELECT random_tfloat_seq(0, 100, '[2001-01-01, 2001-01-02]', 10, '1 minute', 'normal');
+
+-------------------------------------------------------------------------------
@@ -0,0 +1,25 @@
+-------------------------------------------------------------------------------
+-- The counters are only updated when the extension is compiled with WITH_STATS
+-- and the setting mobilitydb.stats is on
+-------------------------------------------------------------------------------
+
+SELECT 1 FROM mobdb_stat_reset();
+SELECT tfloat '[1@2000-01-01, 3@2000-01-03]' + tfloat '[3@2000-01-01, 1@2000-01-03]' IS NOT NULL;
+SELECT CASE WHEN enabled THEN instants >= 4 AND sync_segments >= 1 ELSE instants = 0 AND sync_segments = 0 END FROM mobdb_stat_activity();
+
+CREATE TABLE tbl_stats_period AS SELECT period(t, t + interval '1 day') AS p FROM generate_series(timestamptz '2000-01-01', '2000-12-31', '1 day') t;
+CREATE INDEX tbl_stats_period_gist_idx ON tbl_stats_period USING GIST(p);
+SET enable_seqscan = off;
+SELECT 1 FROM mobdb_stat_reset();
+SELECT count(*) FROM tbl_stats_period WHERE p && period '[2000-06-01, 2000-06-10]';
+SELECT CASE WHEN (SELECT enabled FROM mobdb_stat_activity()) THEN leaf_matches >= 10 ELSE leaf_matches IS NULL END FROM (SELECT sum(leaf_matches) AS leaf_matches FROM mobdb_stat_index() WHERE opclass = 'gist_period') t;
+RESET enable_seqscan;
+DROP TABLE tbl_stats_period;
+
+SET mobilitydb.stats = off;
+SELECT 1 FROM mobdb_stat_reset();
+SELECT tfloat '[1@2000-01-01, 3@2000-01-03]' + tfloat '[3@2000-01-01, 1@2000-01-03]' IS NOT NULL;
+SELECT NOT enabled AND instants = 0 AND sync_segments = 0 FROM mobdb_stat_activity();
+RESET mobilitydb.stats;
+
+-------------------------------------------------------------------------------
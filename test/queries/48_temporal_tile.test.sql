@@ -0,0 +1,29 @@
+-------------------------------------------------------------------------------
+
+SELECT timeBucket(timestamptz '2000-01-03 10:00:00', '1 day');
+SELECT timeBucket(timestamptz '2000-01-03 10:00:00', '1 week');
+SELECT timeBucket(timestamptz '1999-12-31 10:00:00', '1 day', '2000-01-01 06:00:00');
+SELECT timeBucket(period '[2000-01-03 10:00:00, 2000-01-05]', '1 day');
+SELECT timeBucket(timestamptz '2000-01-03', '1 month');
+
+-------------------------------------------------------------------------------
+
+SELECT bucket FROM timeSplit(tbool 't@2000-01-03 10:00:00', '1 day');
+SELECT count(*) FROM timeSplit(tint '{1@2000-01-01, 2@2000-01-01 12:00:00, 3@2000-01-02}', '1 day');
+SELECT fragment FROM timeSplit(tint '{1@2000-01-01, 2@2000-01-01 12:00:00, 3@2000-01-02}', '1 day') WHERE bucket = '2000-01-01';
+SELECT count(*) FROM timeSplit(tint '[1@2000-01-01, 2@2000-01-02 12:00:00, 2@2000-01-03)', '1 day');
+SELECT fragment FROM timeSplit(tint '[1@2000-01-01, 2@2000-01-02 12:00:00, 2@2000-01-03)', '1 day') WHERE bucket = '2000-01-02';
+SELECT count(*) FROM timeSplit(tfloat '[1@2000-01-01, 3@2000-01-03]', '1 day');
+SELECT fragment FROM timeSplit(tfloat '[1@2000-01-01, 3@2000-01-03]', '1 day') WHERE bucket = '2000-01-02';
+SELECT fragment FROM timeSplit(tfloat '[1@2000-01-01, 3@2000-01-03]', '1 day') WHERE bucket = '2000-01-03';
+SELECT fragment FROM timeSplit(tfloat '{[1@2000-01-01, 2@2000-01-01 06:00:00], [3@2000-01-01 12:00:00, 5@2000-01-02 12:00:00]}', '1 day') WHERE bucket = '2000-01-01';
+SELECT fragment FROM timeSplit(tfloat '{[1@2000-01-01, 2@2000-01-01 06:00:00], [3@2000-01-01 12:00:00, 5@2000-01-02 12:00:00]}', '1 day') WHERE bucket = '2000-01-02';
+SELECT fragment FROM timeSplit(ttext '[AAA@2000-01-01, BBB@2000-01-03]', '1 day') WHERE bucket = '2000-01-02';
+
+SELECT tsample(tfloat '[1@2000-01-01, 3@2000-01-03]', '12 hours');
+SELECT tsample(tint '[1@2000-01-01 06:00:00, 2@2000-01-02 12:00:00, 2@2000-01-03)', '1 day');
+SELECT tsample(tfloat '{[1@2000-01-01, 2@2000-01-01 06:00:00], [3@2000-01-01 12:00:00, 5@2000-01-02 12:00:00]}', '6 hours', '2000-01-01 03:00:00');
+SELECT tsample(tbool '{t@2000-01-01, f@2000-01-01 12:00:00}', '1 day');
+SELECT tsample(ttext '[AAA@2000-01-01 06:00:00, BBB@2000-01-01 18:00:00]', '1 day');
+
+-------------------------------------------------------------------------------
@@ -0,0 +1,17 @@
+-------------------------------------------------------------------------------
+
+COPY (VALUES ('b', timestamptz '2000-01-01 00:00', 1), ('a', '2000-01-01 00:00', 2),
+  ('b', '2000-01-01 00:20', 3), ('a', '2000-01-01 00:10', 1), ('b', '2000-01-01 00:10', 1))
+  TO '/tmp/tfloat_load.csv' (FORMAT CSV, HEADER);
+COPY (VALUES ('a', timestamptz '2000-01-01 00:00', 1.5), ('a', '2000-01-01 00:10', 2.5))
+  TO '/tmp/tfloat_load_noheader.csv' (FORMAT CSV, DELIMITER ';');
+
+SELECT id, temp FROM loadTFloat('/tmp/tfloat_load.csv');
+SELECT id, temp FROM loadTFloat('/tmp/tfloat_load_noheader.csv', false, ';');
+
+/* Errors */
+SELECT id, temp FROM loadTFloat('/tmp/tfloat_load.csv', true, ';');
+SELECT id, temp FROM loadTFloat('/tmp/tfloat_load.csv', true, '::');
+SELECT id, temp FROM loadTFloat('/tmp/tfloat_load_noheader.csv', false);
+
+-------------------------------------------------------------------------------
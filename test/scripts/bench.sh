@@ -0,0 +1,30 @@
+#!/bin/bash
+
+# Run the micro-benchmarks given as arguments on a temporary database.
+# The numbers of instants of the synthetic sequences can be set with the
+# environment variable BENCH_SIZES, e.g. BENCH_SIZES=1000,10000 make bench
+
+set -o pipefail
+
+BUILDDIR=$1
+shift
+SCRIPTDIR=`dirname $0`
+WORKDIR=$BUILDDIR/tmptest
+BENCH_SIZES=${BENCH_SIZES:-100,1000,10000,100000}
+PSQL="psql -h $WORKDIR/lock -X -q --set ON_ERROR_STOP=1 --set sizes={$BENCH_SIZES} postgres"
+
+$SCRIPTDIR/test.sh setup $BUILDDIR > /dev/null || exit 1
+$SCRIPTDIR/test.sh create_ext $BUILDDIR > /dev/null
+
+STATUS=0
+N=0
+for BENCHFILE in "$@"; do
+	N=$((N + 1))
+	$PSQL < $BENCHFILE 2>&1 | tee $WORKDIR/out/bench_$N.out
+	if [ "$?" != "0" ]; then
+		STATUS=1
+	fi
+done
+
+$SCRIPTDIR/test.sh teardown $BUILDDIR > /dev/null
+exit $STATUS
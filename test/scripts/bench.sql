@@ -0,0 +1,133 @@
+/*****************************************************************************
+ *
+ * bench.sql
+ *	  Micro-benchmarks of the core temporal kernels
+ *
+ * The benchmarks are run by bench.sh, which sets the variable sizes to the
+ * array of the numbers of instants of the synthetic sequences. The inputs of
+ * a kernel are inlined as constants into a prepared statement so that they
+ * are parsed and planned once, outside of the timed executions. The
+ * subqueries with OFFSET 0 prevent the planner from folding the calls to the
+ * immutable functions over these constants. Each statement is run several
+ * times and the best time is reported in nanoseconds per instant.
+ *
+ *****************************************************************************/
+
+SET client_min_messages TO WARNING;
+SELECT setseed(0.5);
+
+-------------------------------------------------------------------------------
+
+/* Timestamps of a synthetic sequence, one per minute */
+CREATE OR REPLACE FUNCTION bench_timestamps(size int, shift interval)
+	RETURNS timestamptz[] AS $$
+	SELECT array_agg(timestamptz '2001-01-01' + i * interval '1 minute' + shift
+		ORDER BY i)
+	FROM generate_series(1, size) AS i;
+$$ LANGUAGE SQL STRICT;
+
+/* Values of a synthetic sequence as a random walk starting from 0 */
+CREATE OR REPLACE FUNCTION bench_walk(size int)
+	RETURNS float[] AS $$
+	SELECT array_agg(v ORDER BY i)
+	FROM (SELECT i, sum(random() - 0.5) OVER (ORDER BY i) AS v
+		FROM generate_series(1, size) AS i) AS t;
+$$ LANGUAGE SQL STRICT;
+
+CREATE OR REPLACE FUNCTION bench_tfloatseq(size int, shift interval)
+	RETURNS tfloat AS $$
+	SELECT tfloatseq(bench_walk(size), bench_timestamps(size, shift));
+$$ LANGUAGE SQL STRICT;
+
+-------------------------------------------------------------------------------
+
+/*
+ * Run the query loops times and return the best time. The query must return
+ * a single row so that the cost of the result transfer is negligible.
+ */
+CREATE OR REPLACE FUNCTION bench_run(name text, card int, count bigint,
+	query text, loops int DEFAULT 5)
+	RETURNS TABLE(kernel text, size int, instants bigint, ms float,
+		ns_per_instant float) AS $$
+DECLARE
+	start timestamptz;
+	elapsed float;
+	best float;
+BEGIN
+	EXECUTE 'PREPARE bench_stmt AS ' || query;
+	/* Warm up the caches */
+	EXECUTE 'EXECUTE bench_stmt';
+	for i in 1..loops
+	loop
+		start = clock_timestamp();
+		EXECUTE 'EXECUTE bench_stmt';
+		elapsed = extract(epoch FROM clock_timestamp() - start);
+		if best IS NULL OR elapsed < best then
+			best = elapsed;
+		end if;
+	end loop;
+	DEALLOCATE bench_stmt;
+	kernel = name;
+	size = card;
+	instants = count;
+	ms = round((best * 1e3)::numeric, 3);
+	ns_per_instant = round((best * 1e9 / greatest(count, 1))::numeric, 1);
+	RETURN NEXT;
+END;
+$$ LANGUAGE plpgsql STRICT;
+
+-------------------------------------------------------------------------------
+
+CREATE OR REPLACE FUNCTION bench_temporal(sizes int[])
+	RETURNS TABLE(kernel text, size int, instants bigint, ms float,
+		ns_per_instant float) AS $$
+DECLARE
+	card int;
+	seq1 tfloat;
+	seq2 tfloat;
+	seqs tfloat[];
+	txt text;
+BEGIN
+	foreach card in array sizes
+	loop
+		seq1 = bench_tfloatseq(card, interval '0 seconds');
+		/* The instants of the second sequence are in the middle of the
+		 * segments of the first one */
+		seq2 = bench_tfloatseq(card, interval '30 seconds');
+		seqs = array(SELECT shift(seq1, k * interval '10 seconds')
+			FROM generate_series(1, 10) AS k);
+		txt = seq1::text;
+
+		/* temporalseq_find_timestamp, one lookup per segment */
+		RETURN QUERY SELECT * FROM bench_run('temporalseq_find_timestamp',
+			card, card - 1, format(
+			'SELECT count(valueAtTimestamp(s.seq, t)) '
+			'FROM (SELECT %L::tfloat AS seq OFFSET 0) AS s, '
+			'generate_series(timestamptz ''2001-01-01 00:01:15'', '
+			'timestamptz ''2001-01-01'' + %s * interval ''1 minute'', '
+			'interval ''1 minute'') AS t', seq1, card));
+
+		/* sync_tfunc2_temporalseq_temporalseq, instants of both arguments */
+		RETURN QUERY SELECT * FROM bench_run(
+			'sync_tfunc2_temporalseq_temporalseq', card, 2 * card, format(
+			'SELECT count(s.seq1 + s.seq2) '
+			'FROM (SELECT %L::tfloat AS seq1, %L::tfloat AS seq2 OFFSET 0) AS s',
+			seq1, seq2));
+
+		/* temporalseq_tagg_transfn, ten overlapping sequences */
+		RETURN QUERY SELECT * FROM bench_run('temporalseq_tagg_transfn',
+			card, 10 * card, format(
+			'SELECT tsum(seq) IS NOT NULL FROM unnest(%L::tfloat[]) AS seq',
+			seqs));
+
+		/* tfloat_in */
+		RETURN QUERY SELECT * FROM bench_run('tfloat_in', card, card, format(
+			'SELECT count(s.txt::tfloat) FROM (SELECT %L::text AS txt OFFSET 0) AS s',
+			txt));
+	end loop;
+END;
+$$ LANGUAGE plpgsql STRICT;
+
+SELECT * FROM bench_temporal(:'sizes');
+
+-------------------------------------------------------------------------------
@@ -47,3 +47,5 @@ foreach(file ${testfiles})
 	set_tests_properties(${TESTNAME} PROPERTIES RESOURCE_LOCK DBLOCK)
 endforeach()
 
+
+set(BENCHFILES "${PROJECT_SOURCE_DIR}/test/scripts/bench.sql")